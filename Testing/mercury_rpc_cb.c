@@ -15,6 +15,7 @@
 #    include "mercury_thread_pool.h"
 #endif
 #include "mercury_atomic.h"
+#include "mercury_crc32c.h"
 #include "mercury_rpc_cb.h"
 #include "mercury_thread_mutex.h"
 
@@ -88,6 +89,7 @@ struct hg_test_bulk_args {
     hg_size_t transfer_size;
     hg_size_t origin_offset;
     hg_size_t target_offset;
+    hg_size_t chunk_size;
 };
 
 struct hg_test_bulk_fwd_args {
@@ -96,27 +98,68 @@ struct hg_test_bulk_fwd_args {
     bulk_write_in_t in_struct;
 };
 
+struct hg_test_stream_args {
+    hg_handle_t handle;
+    hg_int32_t count;
+    hg_int32_t sent;
+};
+
+struct hg_test_relay_args {
+    hg_handle_t handle;
+    hg_handle_t fwd_handle;
+};
+
+struct hg_test_replay_args {
+    hg_handle_t handle;
+    hg_uint32_t out_size;
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
 
+static void
+hg_test_bulk_chunk_cb(void *arg, hg_size_t offset, hg_size_t size);
+
 static hg_return_t
 hg_test_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info);
 
+static hg_return_t
+hg_test_bulk_atomic_cb(const struct hg_cb_info *hg_cb_info);
+
+static hg_return_t
+hg_test_bulk_prefetch_transfer_cb(const struct hg_cb_info *hg_cb_info);
+
 static hg_return_t
 hg_test_bulk_bind_transfer_cb(const struct hg_cb_info *hg_cb_info);
 
+static hg_return_t
+hg_test_rpc_stream_respond_cb(const struct hg_cb_info *hg_cb_info);
+
+static hg_return_t
+hg_test_rpc_relay_fwd_cb(const struct hg_cb_info *hg_cb_info);
+
 static hg_return_t
 hg_test_bulk_bind_forward_fwd_cb(const struct hg_cb_info *hg_cb_info);
 
 static hg_return_t
 hg_test_perf_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info);
 
+static hg_return_t
+hg_test_replay_respond(hg_handle_t handle, hg_uint32_t out_size);
+
+static hg_return_t
+hg_test_replay_transfer_cb(const struct hg_cb_info *hg_cb_info);
+
 /*******************/
 /* Local Variables */
 /*******************/
 
 extern hg_id_t hg_test_bulk_bind_write_id_g;
+extern hg_id_t hg_test_rpc_open_id_g;
+
+/* Number of times hg_test_rpc_cached was executed */
+static hg_atomic_int32_t hg_test_rpc_cached_count_g = HG_ATOMIC_VAR_INIT(0);
 
 // extern hg_id_t hg_test_nested2_id_g;
 // hg_addr_t *hg_addr_table;
@@ -146,7 +189,6 @@ bulk_write(int fildes, const void *buf, size_t offset, size_t start_value,
     size_t i;
     int error = 0;
     const char *buf_ptr = (const char *) buf;
-    (void) fildes;
 
     if (verbose)
         HG_TEST_LOG_DEBUG("Executing bulk_write with fildes %d...", fildes);
@@ -159,10 +201,14 @@ bulk_write(int fildes, const void *buf, size_t offset, size_t start_value,
 
     /* Check bulk buf */
     for (i = offset; i < nbyte + offset; i++) {
-        if (buf_ptr[i] != (char) (i + start_value)) {
+        char expected = (fildes == HG_TEST_BULK_CODEC)
+                            ? HG_TEST_BULK_CODEC_VALUE(i, nbyte)
+                            : (char) (i + start_value);
+
+        if (buf_ptr[i] != expected) {
             HG_TEST_LOG_ERROR("Error detected in bulk transfer, buf[%zu] = %d, "
                               "was expecting %d!\n",
-                i, (char) buf_ptr[i], (char) (i + start_value));
+                i, (char) buf_ptr[i], expected);
             error = 1;
             nbyte = 0;
             break;
@@ -180,6 +226,33 @@ bulk_write(int fildes, const void *buf, size_t offset, size_t start_value,
     return nbyte;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_uint32_t *
+hg_test_bulk_crcs(hg_size_t origin_offset, hg_size_t size)
+{
+    hg_size_t count = (size + HG_TEST_BULK_CRC_CHUNK - 1) /
+                      HG_TEST_BULK_CRC_CHUNK;
+    hg_uint32_t *crcs = (hg_uint32_t *) malloc(count * sizeof(*crcs) + 1);
+    char chunk[HG_TEST_BULK_CRC_CHUNK];
+    hg_size_t i, j;
+
+    if (crcs == NULL)
+        return NULL;
+
+    /* Origin data is (char) i */
+    for (i = 0; i < count; i++) {
+        hg_size_t offset = i * HG_TEST_BULK_CRC_CHUNK;
+        hg_size_t len = (i + 1 < count) ? HG_TEST_BULK_CRC_CHUNK
+                                        : size - offset;
+
+        for (j = 0; j < len; j++)
+            chunk[j] = (char) (origin_offset + offset + j);
+        crcs[i] = hg_crc32c_update(0, chunk, (size_t) len);
+    }
+
+    return crcs;
+}
+
 /*---------------------------------------------------------------------------*/
 /* RPC callbacks */
 /*---------------------------------------------------------------------------*/
@@ -200,6 +273,14 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Only decode the leading path of rpc_open_in_t */
+static hg_return_t
+hg_test_proc_open_path(hg_proc_t proc, void *data)
+{
+    return hg_proc_hg_const_string_t(proc, &((rpc_open_in_t *) data)->path);
+}
+
 /*---------------------------------------------------------------------------*/
 HG_TEST_RPC_CB(hg_test_rpc_open, handle)
 {
@@ -211,6 +292,17 @@ HG_TEST_RPC_CB(hg_test_rpc_open, handle)
     int open_ret;
     hg_return_t ret = HG_SUCCESS;
 
+    /* Peek at the path first */
+    ret = HG_Get_input_partial(handle, hg_test_proc_open_path, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Get_input_partial() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(in_struct.path == NULL, done, ret, HG_PROTOCOL_ERROR,
+        "NULL path in partial input");
+
+    ret = HG_Free_input_partial(handle, hg_test_proc_open_path, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Free_input_partial() failed (%s)",
+        HG_Error_to_string(ret));
+
     /* Get input buffer */
     ret = HG_Get_input(handle, &in_struct);
     HG_TEST_CHECK_HG_ERROR(
@@ -278,6 +370,70 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Runs in a coroutine on the progress thread, never in the thread pool */
+hg_return_t
+hg_test_rpc_await_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    hg_handle_t fwd_handle = HG_HANDLE_NULL;
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    rpc_open_in_t in_struct;
+    rpc_open_out_t out_struct;
+    struct hg_await await;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Get input buffer */
+    ret = HG_Get_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Addr_self(hg_info->hg_class, &self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        free_input, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+
+    /* Forward to self and wait for the response without blocking progress */
+    ret = HG_Create(
+        hg_info->context, self_addr, hg_test_rpc_open_id_g, &fwd_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        free_input, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Await_init(&await);
+    HG_TEST_CHECK_HG_ERROR(free_input, ret, "HG_Await_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Forward(fwd_handle, HG_Await_cb, &await, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        free_input, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Await(&await);
+    HG_TEST_CHECK_HG_ERROR(
+        free_input, ret, "HG_Await() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Get_output(fwd_handle, &out_struct);
+    HG_TEST_CHECK_HG_ERROR(free_input, ret, "HG_Get_output() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Send response back */
+    ret = HG_Respond(handle, NULL, NULL, &out_struct);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+    (void) HG_Free_output(fwd_handle, &out_struct);
+
+free_input:
+    (void) HG_Free_input(handle, &in_struct);
+
+done:
+    if (self_addr != HG_ADDR_NULL)
+        (void) HG_Addr_free(hg_info->hg_class, self_addr);
+    if (fwd_handle != HG_HANDLE_NULL)
+        (void) HG_Destroy(fwd_handle);
+    (void) HG_Destroy(handle);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 HG_TEST_RPC_CB(hg_test_overflow, handle)
 {
@@ -314,6 +470,49 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+HG_TEST_RPC_CB(hg_test_overflow_resp, handle)
+{
+    overflow_in_t in_struct;
+    overflow_out_t out_struct;
+    hg_string_t string = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Get input buffer, which carries the response buffer of origin */
+    ret = HG_Get_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
+
+    string = (hg_string_t) malloc(in_struct.string_len + 1);
+    HG_TEST_CHECK_ERROR(
+        string == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate string");
+
+    memset(string, 'h', in_struct.string_len);
+    string[in_struct.string_len] = '\0';
+
+    /* Fill output structure */
+    out_struct.string = string;
+    out_struct.string_len = in_struct.string_len;
+
+    ret = HG_Free_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Free_input() failed (%s)", HG_Error_to_string(ret));
+
+    /* Send response back */
+    ret = HG_Respond(handle, NULL, NULL, &out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    free(string);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 HG_TEST_RPC_CB(hg_test_cancel_rpc, handle)
 {
@@ -331,6 +530,230 @@ HG_TEST_RPC_CB(hg_test_cancel_rpc, handle)
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+HG_TEST_RPC_CB(hg_test_rpc_cached, handle)
+{
+    rpc_open_in_t in_struct;
+    rpc_open_out_t out_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Get input buffer */
+    ret = HG_Get_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
+
+    /* Return number of executions, cached responses return the same count */
+    out_struct.event_id = (hg_int32_t) in_struct.handle.cookie;
+    out_struct.ret = hg_atomic_incr32(&hg_test_rpc_cached_count_g);
+
+    /* Free input */
+    ret = HG_Free_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Free_input() failed (%s)", HG_Error_to_string(ret));
+
+    /* Send response back */
+    ret = HG_Respond(handle, NULL, NULL, &out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_stream_respond_cb(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_test_stream_args *args =
+        (struct hg_test_stream_args *) hg_cb_info->arg;
+    rpc_open_out_t out_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_TEST_CHECK_ERROR_NORET(hg_cb_info->ret != HG_SUCCESS, done,
+        "Error in HG callback (%s)", HG_Error_to_string(hg_cb_info->ret));
+
+    /* Previous chunk was consumed, send next one or final response */
+    out_struct.event_id = args->sent;
+    if (args->sent < args->count) {
+        out_struct.ret = 0;
+        args->sent++;
+        ret = HG_Respond_chunk(args->handle, hg_test_rpc_stream_respond_cb,
+            args, &out_struct);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Respond_chunk() failed (%s)",
+            HG_Error_to_string(ret));
+
+        return ret;
+    }
+
+    out_struct.ret = args->count;
+    ret = HG_Respond(args->handle, NULL, NULL, &out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    free(args);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+HG_TEST_RPC_CB(hg_test_rpc_stream, handle)
+{
+    struct hg_test_stream_args *args = NULL;
+    rpc_open_in_t in_struct;
+    rpc_open_out_t out_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    args = (struct hg_test_stream_args *) malloc(
+        sizeof(struct hg_test_stream_args));
+    HG_TEST_CHECK_ERROR(
+        args == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate args");
+
+    /* Get input buffer */
+    ret = HG_Get_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
+
+    /* Cookie gives the number of chunks to stream */
+    args->handle = handle;
+    args->count = (hg_int32_t) in_struct.handle.cookie;
+    args->sent = 1;
+
+    /* Free input */
+    ret = HG_Free_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Free_input() failed (%s)", HG_Error_to_string(ret));
+
+    /* Send first chunk, next ones are sent from the respond callback */
+    out_struct.event_id = 0;
+    out_struct.ret = 0;
+    ret = HG_Respond_chunk(
+        handle, hg_test_rpc_stream_respond_cb, args, &out_struct);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Respond_chunk() failed (%s)",
+        HG_Error_to_string(ret));
+
+done:
+    ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    return ret;
+
+error:
+    free(args);
+    goto done;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_relay_fwd_cb(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_test_relay_args *args =
+        (struct hg_test_relay_args *) hg_cb_info->arg;
+    void *out_buf = NULL;
+    hg_size_t out_buf_size = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_TEST_CHECK_ERROR_NORET(hg_cb_info->ret != HG_SUCCESS, done,
+        "Error in HG callback (%s)", HG_Error_to_string(hg_cb_info->ret));
+
+    /* Relay encoded output back without decoding it */
+    ret = HG_Get_output_raw(args->fwd_handle, &out_buf, &out_buf_size);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Get_output_raw() failed (%s)",
+        HG_Error_to_string(ret));
+
+    HG_TEST_LOG_DEBUG("Relaying %zu bytes of output back", out_buf_size);
+    ret = HG_Respond_raw(args->handle, NULL, NULL, out_buf, out_buf_size);
+    HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+        "HG_Respond_raw() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    ret = HG_Destroy(args->fwd_handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Destroy(args->handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    free(args);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+HG_TEST_RPC_CB(hg_test_rpc_relay, handle)
+{
+    const struct hg_info *hg_info = NULL;
+    struct hg_test_relay_args *args = NULL;
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    void *in_buf = NULL;
+    hg_size_t in_buf_size = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    args = (struct hg_test_relay_args *) malloc(
+        sizeof(struct hg_test_relay_args));
+    HG_TEST_CHECK_ERROR(
+        args == NULL, error, ret, HG_NOMEM_ERROR, "Could not allocate args");
+    args->handle = handle;
+    args->fwd_handle = HG_HANDLE_NULL;
+
+    /* Get info from handle */
+    hg_info = HG_Get_info(handle);
+
+    /* Get encoded input, it is forwarded as is */
+    ret = HG_Get_input_raw(handle, &in_buf, &in_buf_size);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Get_input_raw() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Addr_self(hg_info->hg_class, &self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+
+    /* Relay to rpc_open on self */
+    ret = HG_Create(hg_info->context, self_addr, hg_test_rpc_open_id_g,
+        &args->fwd_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Addr_free(hg_info->hg_class, self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_free() failed (%s)", HG_Error_to_string(ret));
+    self_addr = HG_ADDR_NULL;
+
+    HG_TEST_LOG_DEBUG("Relaying %zu bytes of input to self", in_buf_size);
+    ret = HG_Forward_raw(args->fwd_handle, hg_test_rpc_relay_fwd_cb, args,
+        in_buf, in_buf_size);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Forward_raw() failed (%s)", HG_Error_to_string(ret));
+
+    return ret;
+
+error:
+    if (args && args->fwd_handle != HG_HANDLE_NULL) {
+        ret = HG_Destroy(args->fwd_handle);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS, "HG_Destroy() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+    free(args);
+
+    if (self_addr != HG_ADDR_NULL) {
+        ret = HG_Addr_free(hg_info->hg_class, self_addr);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Addr_free() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 HG_TEST_RPC_CB(hg_test_bulk_write, handle)
 {
@@ -368,6 +791,14 @@ HG_TEST_RPC_CB(hg_test_bulk_write, handle)
     bulk_args->origin_offset = in_struct.origin_offset;
     bulk_args->target_offset = in_struct.target_offset;
     bulk_args->fildes = fildes;
+    bulk_args->chunk_size = 0;
+
+    /* Compressed regions are decompressed into transfer_size bytes */
+    if (fildes == HG_TEST_BULK_CODEC) {
+        bulk_args->nbytes = bulk_args->transfer_size;
+        bulk_args->chunk_size = bulk_args->transfer_size;
+    } else if (fildes == HG_TEST_BULK_CRC)
+        bulk_args->chunk_size = bulk_args->transfer_size;
 
     ret = HG_Bulk_ref_incr(origin_bulk_handle);
     HG_TEST_CHECK_HG_ERROR(
@@ -390,12 +821,86 @@ HG_TEST_RPC_CB(hg_test_bulk_write, handle)
                       "target_offset=%zu",
         bulk_args->transfer_size, bulk_args->origin_offset,
         bulk_args->target_offset);
-    ret = HG_Bulk_transfer_id(hg_info->context, hg_test_bulk_transfer_cb,
-        bulk_args, HG_BULK_PULL, hg_info->addr, hg_info->context_id,
-        origin_bulk_handle, bulk_args->origin_offset, local_bulk_handle,
-        bulk_args->target_offset, bulk_args->transfer_size, &hg_bulk_op_id);
-    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_transfer_id() failed (%s)",
-        HG_Error_to_string(ret));
+    if (fildes == HG_TEST_BULK_ATOMIC) {
+        ret = HG_Bulk_atomic(hg_info->context, hg_test_bulk_atomic_cb,
+            bulk_args, HG_BULK_ATOMIC_FETCH_ADD, bulk_args->transfer_size, 0,
+            hg_info->addr, hg_info->context_id, origin_bulk_handle,
+            bulk_args->origin_offset, local_bulk_handle,
+            bulk_args->target_offset, &hg_bulk_op_id);
+        if (ret == HG_OPNOTSUPPORTED) {
+            struct hg_cb_info hg_cb_info = {.arg = bulk_args,
+                .ret = ret,
+                .type = HG_CB_BULK};
+
+            /* Report that atomics are not supported by this transport */
+            hg_cb_info.info.bulk.origin_handle = origin_bulk_handle;
+            hg_cb_info.info.bulk.local_handle = local_bulk_handle;
+            return hg_test_bulk_atomic_cb(&hg_cb_info);
+        }
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_atomic() failed (%s)",
+            HG_Error_to_string(ret));
+    } else if (fildes == HG_TEST_BULK_LIST) {
+        struct hg_bulk_transfer_desc transfers[4];
+        hg_size_t piece_size = bulk_args->transfer_size / 4;
+        unsigned int i;
+
+        /* Pull quarters out of order, the first two are merged */
+        for (i = 0; i < 4; i++) {
+            unsigned int piece = (i < 2) ? i : 5 - i;
+
+            transfers[i].origin_handle = origin_bulk_handle;
+            transfers[i].origin_offset =
+                bulk_args->origin_offset + piece * piece_size;
+            transfers[i].local_handle = local_bulk_handle;
+            transfers[i].local_offset =
+                bulk_args->target_offset + piece * piece_size;
+            transfers[i].size = (piece == 3)
+                                    ? bulk_args->transfer_size - 3 * piece_size
+                                    : piece_size;
+        }
+
+        /* No chunk is reported for lists */
+        bulk_args->chunk_size = bulk_args->transfer_size;
+        ret = HG_Bulk_transfer_list(hg_info->context, hg_test_bulk_transfer_cb,
+            bulk_args, HG_BULK_PULL, hg_info->addr, hg_info->context_id,
+            transfers, 4, &hg_bulk_op_id);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "HG_Bulk_transfer_list() failed (%s)", HG_Error_to_string(ret));
+#ifndef HG_HAS_XDR
+    } else if (fildes == HG_TEST_BULK_CODEC) {
+        ret = HG_Bulk_transfer_decompress(hg_info->context,
+            hg_test_bulk_transfer_cb, bulk_args, &hg_test_rle_codec_g,
+            hg_info->addr, hg_info->context_id, origin_bulk_handle,
+            local_bulk_handle, bulk_args->target_offset);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "HG_Bulk_transfer_decompress() failed (%s)",
+            HG_Error_to_string(ret));
+#endif
+    } else if (fildes == HG_TEST_BULK_CRC) {
+        hg_uint32_t *crcs = hg_test_bulk_crcs(
+            bulk_args->origin_offset, bulk_args->transfer_size);
+
+        HG_TEST_CHECK_ERROR(crcs == NULL, error, ret, HG_NOMEM_ERROR,
+            "Could not allocate CRCs");
+        ret = HG_Bulk_transfer_crc32c(hg_info->context,
+            hg_test_bulk_transfer_cb, bulk_args, hg_info->addr,
+            hg_info->context_id, origin_bulk_handle, bulk_args->origin_offset,
+            local_bulk_handle, bulk_args->target_offset,
+            bulk_args->transfer_size, HG_TEST_BULK_CRC_CHUNK, crcs,
+            &hg_bulk_op_id);
+        free(crcs);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "HG_Bulk_transfer_crc32c() failed (%s)", HG_Error_to_string(ret));
+    } else {
+        ret = HG_Bulk_transfer_progressive(hg_info->context,
+            hg_test_bulk_transfer_cb, bulk_args, hg_test_bulk_chunk_cb,
+            bulk_args, HG_BULK_PULL, hg_info->addr, hg_info->context_id,
+            origin_bulk_handle, bulk_args->origin_offset, local_bulk_handle,
+            bulk_args->target_offset, bulk_args->transfer_size, &hg_bulk_op_id);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "HG_Bulk_transfer_progressive() failed (%s)",
+            HG_Error_to_string(ret));
+    }
 
     /* Test HG_Bulk_Cancel() */
     if (fildes < 0) {
@@ -414,6 +919,53 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+HG_TEST_RPC_CB(hg_test_bulk_prefetch, handle)
+{
+    struct hg_test_bulk_args *bulk_args = NULL;
+    bulk_write_in_t in_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    bulk_args =
+        (struct hg_test_bulk_args *) malloc(sizeof(struct hg_test_bulk_args));
+    HG_TEST_CHECK_ERROR(bulk_args == NULL, error, ret, HG_NOMEM_ERROR,
+        "Could not allocate bulk_args");
+
+    /* Keep handle to pass to callback */
+    bulk_args->handle = handle;
+
+    /* Get input parameters */
+    ret = HG_Get_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
+
+    bulk_args->nbytes = HG_Bulk_get_size(in_struct.bulk_handle);
+    bulk_args->transfer_size = in_struct.transfer_size;
+    bulk_args->origin_offset = in_struct.origin_offset;
+    bulk_args->fildes = in_struct.fildes;
+
+    /* Free input */
+    ret = HG_Free_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Free_input() failed (%s)", HG_Error_to_string(ret));
+
+    /* Data is already there or being pulled */
+    ret = HG_Get_input_bulk(
+        handle, hg_test_bulk_prefetch_transfer_cb, bulk_args);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Get_input_bulk() failed (%s)",
+        HG_Error_to_string(ret));
+
+    return ret;
+
+error:
+    free(bulk_args);
+    ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 HG_TEST_RPC_CB(hg_test_bulk_bind_write, handle)
 {
@@ -593,6 +1145,18 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_test_bulk_chunk_cb(void *arg, hg_size_t offset, hg_size_t size)
+{
+    struct hg_test_bulk_args *bulk_args = (struct hg_test_bulk_args *) arg;
+
+    HG_TEST_CHECK_WARNING(offset + size > bulk_args->transfer_size,
+        "Chunk exceeds transfer size (%zu + %zu > %zu)", offset, size,
+        bulk_args->transfer_size);
+    bulk_args->chunk_size += size;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info)
@@ -615,6 +1179,12 @@ hg_test_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info)
         HG_TEST_CHECK_ERROR_NORET(hg_cb_info->ret != HG_SUCCESS, done,
             "Error in HG callback (%s)", HG_Error_to_string(hg_cb_info->ret));
 
+    /* All chunks must have been reported before completion */
+    out_struct.ret = 0;
+    HG_TEST_CHECK_ERROR_NORET(bulk_args->chunk_size != bulk_args->transfer_size,
+        done, "Chunks do not add up to transfer size (%zu != %zu)",
+        bulk_args->chunk_size, bulk_args->transfer_size);
+
     ret = HG_Bulk_access(local_bulk_handle, 0, bulk_args->nbytes,
         HG_BULK_READ_ONLY, 1, &buf, NULL, NULL);
     HG_TEST_CHECK_HG_ERROR(
@@ -652,6 +1222,96 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_prefetch_transfer_cb(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_test_bulk_args *bulk_args =
+        (struct hg_test_bulk_args *) hg_cb_info->arg;
+    hg_return_t ret = HG_SUCCESS;
+    bulk_write_out_t out_struct;
+    void *buf;
+
+    out_struct.ret = 0;
+    HG_TEST_CHECK_ERROR_NORET(hg_cb_info->ret != HG_SUCCESS, done,
+        "Error in HG callback (%s)", HG_Error_to_string(hg_cb_info->ret));
+
+    /* Entire region of origin was pulled, local handle is owned by handle */
+    ret = HG_Bulk_access(hg_cb_info->info.bulk.local_handle, 0,
+        bulk_args->nbytes, HG_BULK_READ_ONLY, 1, &buf, NULL, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Bulk_access() failed (%s)", HG_Error_to_string(ret));
+
+    out_struct.ret = bulk_write(bulk_args->fildes, buf,
+        bulk_args->origin_offset, 0, bulk_args->transfer_size, 1);
+
+done:
+    /* Send response back */
+    ret = HG_Respond(bulk_args->handle, NULL, NULL, &out_struct);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Destroy(bulk_args->handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    free(bulk_args);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_atomic_cb(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_test_bulk_args *bulk_args =
+        (struct hg_test_bulk_args *) hg_cb_info->arg;
+    hg_bulk_t local_bulk_handle = hg_cb_info->info.bulk.local_handle;
+    hg_bulk_t origin_bulk_handle = hg_cb_info->info.bulk.origin_handle;
+    hg_return_t ret = HG_SUCCESS;
+    bulk_write_out_t out_struct;
+    hg_uint64_t prev;
+    void *buf;
+
+    out_struct.ret = 0;
+    if (hg_cb_info->ret == HG_OPNOTSUPPORTED) {
+        out_struct.ret = (hg_size_t) -1;
+        goto done;
+    } else
+        HG_TEST_CHECK_ERROR_NORET(hg_cb_info->ret != HG_SUCCESS, done,
+            "Error in HG callback (%s)", HG_Error_to_string(hg_cb_info->ret));
+
+    ret = HG_Bulk_access(local_bulk_handle, bulk_args->target_offset,
+        sizeof(prev), HG_BULK_READ_ONLY, 1, &buf, NULL, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Bulk_access() failed (%s)", HG_Error_to_string(ret));
+
+    /* Send previous value back */
+    memcpy(&prev, buf, sizeof(prev));
+    out_struct.ret = (hg_size_t) prev;
+
+done:
+    ret = HG_Bulk_free(local_bulk_handle);
+    HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS, "HG_Bulk_free() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Bulk_free(origin_bulk_handle);
+    HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS, "HG_Bulk_free() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Respond(bulk_args->handle, NULL, NULL, &out_struct);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Destroy(bulk_args->handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    free(bulk_args);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_bulk_bind_transfer_cb(const struct hg_cb_info *hg_cb_info)
@@ -957,6 +1617,152 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+HG_TEST_RPC_CB(hg_test_replay, handle)
+{
+    const struct hg_info *hg_info = NULL;
+    struct hg_test_info *hg_test_info = NULL;
+    struct hg_test_replay_args *args = NULL;
+    hg_bulk_t origin_bulk_handle = HG_BULK_NULL;
+    hg_size_t size = 0;
+    replay_in_t in_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Get info from handle */
+    hg_info = HG_Get_info(handle);
+
+    /* Get test info */
+    hg_test_info = (struct hg_test_info *) HG_Class_get_data(hg_info->hg_class);
+    HG_TEST_CHECK_ERROR(
+        hg_test_info == NULL, error, ret, HG_INVALID_ARG, "NULL hg_test_info");
+
+    /* Get input struct */
+    ret = HG_Get_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
+
+    /* Pull at most what fits into the bulk buffer of the server */
+    origin_bulk_handle = in_struct.bulk_handle;
+    if (origin_bulk_handle != HG_BULK_NULL) {
+        size = in_struct.bulk_size;
+        if (size > HG_Bulk_get_size(origin_bulk_handle))
+            size = HG_Bulk_get_size(origin_bulk_handle);
+        if (size > HG_Bulk_get_size(hg_test_info->bulk_handle))
+            size = HG_Bulk_get_size(hg_test_info->bulk_handle);
+    }
+
+    if (size == 0) {
+        hg_uint32_t out_size = in_struct.out_size;
+
+        ret = HG_Free_input(handle, &in_struct);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Free_input() failed (%s)",
+            HG_Error_to_string(ret));
+
+        hg_test_replay_respond(handle, out_size);
+
+        goto error;
+    }
+
+    args = (struct hg_test_replay_args *) malloc(sizeof(*args));
+    HG_TEST_CHECK_ERROR(
+        args == NULL, error, ret, HG_NOMEM, "Could not allocate args");
+    args->handle = handle;
+    args->out_size = in_struct.out_size;
+
+    ret = HG_Bulk_ref_incr(origin_bulk_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_ref_incr() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Free_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Free_input() failed (%s)", HG_Error_to_string(ret));
+
+#ifdef HG_TEST_HAS_THREAD_POOL
+    hg_thread_mutex_lock(&hg_test_info->bulk_handle_mutex);
+#endif
+    /* Pull bulk data */
+    ret = HG_Bulk_transfer_id(hg_info->context, hg_test_replay_transfer_cb,
+        args, HG_BULK_PULL, hg_info->addr, hg_info->context_id,
+        origin_bulk_handle, 0, hg_test_info->bulk_handle, 0, size,
+        HG_OP_ID_IGNORE);
+#ifdef HG_TEST_HAS_THREAD_POOL
+    hg_thread_mutex_unlock(&hg_test_info->bulk_handle_mutex);
+#endif
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_transfer_id() failed (%s)",
+        HG_Error_to_string(ret));
+
+    return ret;
+
+error:
+    free(args);
+
+    ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_replay_respond(hg_handle_t handle, hg_uint32_t out_size)
+{
+    replay_out_t out_struct;
+    hg_return_t ret;
+
+    out_struct.buf_size = out_size;
+    out_struct.buf = NULL;
+    if (out_size > 0) {
+        out_struct.buf = HG_TEST_ALLOC(out_size);
+        HG_TEST_CHECK_ERROR(out_struct.buf == NULL, done, ret, HG_NOMEM,
+            "Could not allocate output");
+#ifdef HG_TEST_HAS_VERIFY_DATA
+        {
+            hg_uint32_t i;
+
+            for (i = 0; i < out_size; i++)
+                ((char *) out_struct.buf)[i] = (char) i;
+        }
+#endif
+    }
+
+    /* Output is encoded before HG_Respond() returns */
+    ret = HG_Respond(handle, NULL, NULL, &out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    free(out_struct.buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_replay_transfer_cb(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_test_replay_args *args =
+        (struct hg_test_replay_args *) hg_cb_info->arg;
+    hg_return_t ret;
+
+    HG_TEST_CHECK_ERROR_DONE(hg_cb_info->ret != HG_SUCCESS,
+        "Error in HG callback (%s)", HG_Error_to_string(hg_cb_info->ret));
+
+    /* Free origin handle */
+    ret = HG_Bulk_free(hg_cb_info->info.bulk.origin_handle);
+    HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS, "HG_Bulk_free() failed (%s)",
+        HG_Error_to_string(ret));
+
+    hg_test_replay_respond(args->handle, args->out_size);
+
+    ret = HG_Destroy(args->handle);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+    free(args);
+
+    return HG_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 // static hg_return_t
 // hg_test_nested1_forward_cb(const struct hg_cb_info *callback_info)
@@ -1035,9 +1841,14 @@ HG_TEST_THREAD_CB(hg_test_rpc_null)
 HG_TEST_THREAD_CB(hg_test_rpc_open)
 HG_TEST_THREAD_CB(hg_test_rpc_open_no_resp)
 HG_TEST_THREAD_CB(hg_test_overflow)
+HG_TEST_THREAD_CB(hg_test_overflow_resp)
 HG_TEST_THREAD_CB(hg_test_cancel_rpc)
+HG_TEST_THREAD_CB(hg_test_rpc_cached)
+HG_TEST_THREAD_CB(hg_test_rpc_stream)
+HG_TEST_THREAD_CB(hg_test_rpc_relay)
 
 HG_TEST_THREAD_CB(hg_test_bulk_write)
+HG_TEST_THREAD_CB(hg_test_bulk_prefetch)
 HG_TEST_THREAD_CB(hg_test_bulk_bind_write)
 HG_TEST_THREAD_CB(hg_test_bulk_bind_forward)
 
@@ -1047,6 +1858,7 @@ HG_TEST_THREAD_CB(hg_test_perf_rpc)
 HG_TEST_THREAD_CB(hg_test_perf_rpc_lat)
 HG_TEST_THREAD_CB(hg_test_perf_bulk)
 HG_TEST_THREAD_CB(hg_test_perf_bulk_read)
+HG_TEST_THREAD_CB(hg_test_replay)
 // HG_TEST_THREAD_CB(hg_test_nested1)
 // HG_TEST_THREAD_CB(hg_test_nested2)
 
@@ -21,9 +21,19 @@ hg_test_rpc_open_cb(hg_handle_t handle);
 hg_return_t
 hg_test_rpc_open_no_resp_cb(hg_handle_t handle);
 hg_return_t
+hg_test_rpc_await_cb(hg_handle_t handle);
+hg_return_t
 hg_test_overflow_cb(hg_handle_t handle);
 hg_return_t
+hg_test_overflow_resp_cb(hg_handle_t handle);
+hg_return_t
 hg_test_cancel_rpc_cb(hg_handle_t handle);
+hg_return_t
+hg_test_rpc_cached_cb(hg_handle_t handle);
+hg_return_t
+hg_test_rpc_stream_cb(hg_handle_t handle);
+hg_return_t
+hg_test_rpc_relay_cb(hg_handle_t handle);
 
 /**
  * test_bulk
@@ -31,6 +41,8 @@ hg_test_cancel_rpc_cb(hg_handle_t handle);
 hg_return_t
 hg_test_bulk_write_cb(hg_handle_t handle);
 hg_return_t
+hg_test_bulk_prefetch_cb(hg_handle_t handle);
+hg_return_t
 hg_test_bulk_bind_write_cb(hg_handle_t handle);
 hg_return_t
 hg_test_bulk_bind_forward_cb(hg_handle_t handle);
@@ -53,6 +65,12 @@ hg_test_perf_bulk_cb(hg_handle_t handle);
 hg_return_t
 hg_test_perf_bulk_read_cb(hg_handle_t handle);
 
+/**
+ * test_replay
+ */
+hg_return_t
+hg_test_replay_cb(hg_handle_t handle);
+
 /**
  * test_nested
  */
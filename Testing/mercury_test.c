@@ -16,6 +16,7 @@
 #    include <mercury_test_drc.h>
 #endif
 
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -46,6 +47,9 @@ hg_test_parse_options(
 static int
 hg_test_request_progress(unsigned int timeout, void *arg);
 
+static int
+hg_test_request_progress_fd(unsigned int timeout, void *arg);
+
 static int
 hg_test_request_trigger(unsigned int timeout, unsigned int *flag, void *arg);
 
@@ -63,6 +67,19 @@ hg_test_finalize_rpc_cb(const struct hg_cb_info *callback_info);
 static hg_return_t
 hg_test_finalize_cb(hg_handle_t handle);
 
+#ifndef HG_HAS_XDR
+static hg_return_t
+hg_test_rle_compress(
+    void *dst, hg_size_t *dst_size, const void *src, hg_size_t src_size);
+
+static hg_return_t
+hg_test_rle_decompress(
+    void *dst, hg_size_t *dst_size, const void *src, hg_size_t src_size);
+#endif
+
+static hg_return_t
+hg_test_bulk_prefetch_proc(hg_proc_t proc, void *data);
+
 static void
 hg_test_register(hg_class_t *hg_class);
 
@@ -70,6 +87,12 @@ hg_test_register(hg_class_t *hg_class);
 /* Local Variables */
 /*******************/
 
+#ifndef HG_HAS_XDR
+/* Run-length encoding codec */
+const struct hg_codec hg_test_rle_codec_g = {
+    hg_test_rle_compress, hg_test_rle_decompress};
+#endif
+
 /* Default log outlets */
 HG_LOG_SUBSYS_DECL_REGISTER(hg_test, hg);
 
@@ -82,16 +105,24 @@ extern const struct na_test_opt na_test_opt_g[];
 hg_id_t hg_test_rpc_null_id_g = 0;
 hg_id_t hg_test_rpc_open_id_g = 0;
 hg_id_t hg_test_rpc_open_id_no_resp_g = 0;
+hg_id_t hg_test_rpc_await_id_g = 0;
 hg_id_t hg_test_overflow_id_g = 0;
+hg_id_t hg_test_overflow_codec_id_g = 0;
+hg_id_t hg_test_overflow_resp_id_g = 0;
 hg_id_t hg_test_cancel_rpc_id_g = 0;
+hg_id_t hg_test_rpc_cached_id_g = 0;
+hg_id_t hg_test_rpc_stream_id_g = 0;
+hg_id_t hg_test_rpc_relay_id_g = 0;
 
 /* test_bulk */
 hg_id_t hg_test_bulk_write_id_g = 0;
+hg_id_t hg_test_bulk_prefetch_id_g = 0;
 hg_id_t hg_test_bulk_bind_write_id_g = 0;
 hg_id_t hg_test_bulk_bind_forward_id_g = 0;
 
 /* test_kill */
 hg_id_t hg_test_killed_rpc_id_g = 0;
+hg_id_t hg_test_killed_rpc_large_id_g = 0;
 
 /* test_perf */
 hg_id_t hg_test_perf_rpc_id_g = 0;
@@ -100,6 +131,9 @@ hg_id_t hg_test_perf_bulk_id_g = 0;
 hg_id_t hg_test_perf_bulk_write_id_g = 0;
 hg_id_t hg_test_perf_bulk_read_id_g = 0;
 
+/* test_replay */
+hg_id_t hg_test_replay_id_g = 0;
+
 /* test_nested */
 hg_id_t hg_test_nested1_id_g = 0;
 hg_id_t hg_test_nested2_id_g = 0;
@@ -118,6 +152,28 @@ hg_test_usage(const char *execname)
     printf("    -x, --handle        Max number of handles\n");
     printf("    -m, --memory        Use shared-memory with local targets\n");
     printf("    -t, --threads       Number of server threads\n");
+    printf("    -g, --coalesce      Max number of coalesced requests\n");
+    printf("    -A, --addr_cache    Address lookup cache TTL (in ms)\n");
+    printf("    -B, --bulk_chunk    Bulk pipeline chunk size (in bytes)\n");
+    printf("    -T, --bulk_threads  Number of self bulk copy threads\n");
+    printf("    -D, --borrow        Borrow decoded data from receive buffer\n");
+    printf("    -E, --arena         Allocate decoded data from an arena\n");
+    printf("    -I, --integrated    Complete NA operations into HG queue\n");
+    printf("    -W, --progress_threads  Number of context trigger threads\n");
+    printf("    -J, --post_adaptive Adapt number of posted requests to load\n");
+    printf("    -K, --credits       Max requests in flight per target\n");
+    printf("    -Y, --latency       Collect per-RPC latency histograms\n");
+    printf("    -X, --compact       Send compact request headers\n");
+    printf("    -F, --inline        Execute loopback RPCs inline\n");
+    printf("    -Q, --rails         Number of additional NA rails\n");
+    printf("    -U, --post_lazy     Post requests lazily on demand\n");
+    printf("    -O, --event_loop    Wait on context fd instead of progress\n");
+    printf("    -r, --bulk_cache    Max number of cached remote handles\n");
+    printf("    -y, --load_feedback Advertise target load in responses\n");
+    printf("    -j, --admit         Max active requests of admission target\n");
+    printf("    -f, --fair_share    Dispatch requests fairly per origin\n");
+    printf("    -e, --prealloc      Number of preallocated handles\n");
+    printf("    -w, --capture       Record forwards to capture file\n");
 }
 
 /*---------------------------------------------------------------------------*/
@@ -153,6 +209,82 @@ hg_test_parse_options(int argc, char *argv[], struct hg_test_info *hg_test_info)
                 hg_test_info->thread_count =
                     (unsigned int) atoi(na_test_opt_arg_g);
                 break;
+            case 'g': /* number of coalesced requests */
+                hg_test_info->coalesce_count =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'A': /* address lookup cache TTL */
+                hg_test_info->addr_cache_ttl =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'B': /* bulk pipeline chunk size */
+                hg_test_info->bulk_chunk_size =
+                    (hg_size_t) atol(na_test_opt_arg_g);
+                break;
+            case 'T': /* self bulk copy threads */
+                hg_test_info->bulk_self_thread_count =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'D': /* borrow decoded data */
+                hg_test_info->decode_borrow = HG_TRUE;
+                break;
+            case 'E': /* decode into arena */
+                hg_test_info->decode_arena = HG_TRUE;
+                break;
+            case 'I': /* integrated completion */
+                hg_test_info->integrated_completion = HG_TRUE;
+                break;
+            case 'J': /* adaptive posting */
+                hg_test_info->request_post_adaptive = HG_TRUE;
+                break;
+            case 'U': /* lazy posting */
+                hg_test_info->request_post_lazy = HG_TRUE;
+                break;
+            case 'O': /* external event loop */
+                hg_test_info->event_loop = HG_TRUE;
+                break;
+            case 'K': /* request credits */
+                hg_test_info->request_credits =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'Y': /* latency histograms */
+                hg_test_info->latency_stats = HG_TRUE;
+                break;
+            case 'X': /* compact headers */
+                hg_test_info->compact_header = HG_TRUE;
+                break;
+            case 'F': /* inline loopback RPCs */
+                hg_test_info->loopback_inline = HG_TRUE;
+                break;
+            case 'Q': /* additional NA rails */
+                hg_test_info->rail_count =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'r': /* remote bulk handle cache */
+                hg_test_info->bulk_cache_size =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'y': /* load feedback */
+                hg_test_info->load_feedback = HG_TRUE;
+                break;
+            case 'j': /* admission threshold */
+                hg_test_info->admit_active_max =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'f': /* fair-share scheduling */
+                hg_test_info->fair_share = HG_TRUE;
+                break;
+            case 'e': /* preallocated handles */
+                hg_test_info->prealloc_count =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'w': /* workload capture */
+                hg_test_info->capture_file = na_test_opt_arg_g;
+                break;
+            case 'W': /* number of context progress threads */
+                hg_test_info->progress_thread_count =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
             case 'x': /* number of handles */
                 hg_test_info->handle_max =
                     (unsigned int) atoi(na_test_opt_arg_g);
@@ -192,6 +324,38 @@ hg_test_request_progress(unsigned int timeout, void *arg)
     return HG_UTIL_SUCCESS;
 }
 
+/*---------------------------------------------------------------------------*/
+static int
+hg_test_request_progress_fd(unsigned int timeout, void *arg)
+{
+    hg_context_t *context = (hg_context_t *) arg;
+    unsigned int wait_timeout = 0;
+    struct pollfd pfd;
+
+    /* Plugin does not expose a fd */
+    pfd.fd = HG_Context_get_fd(context);
+    if (pfd.fd < 0)
+        return hg_test_request_progress(timeout, arg);
+
+    if (HG_Context_process_ready(context, &wait_timeout) != HG_SUCCESS)
+        return HG_UTIL_FAIL;
+    if (wait_timeout == 0)
+        return HG_UTIL_SUCCESS;
+
+    /* Wait as an external event loop would */
+    if (timeout < wait_timeout)
+        wait_timeout = timeout;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, (int) wait_timeout) <= 0)
+        return HG_UTIL_FAIL;
+
+    if (HG_Context_process_ready(context, &wait_timeout) != HG_SUCCESS)
+        return HG_UTIL_FAIL;
+
+    return HG_UTIL_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static int
 hg_test_request_trigger(unsigned int timeout, unsigned int *flag, void *arg)
@@ -310,6 +474,77 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+#ifndef HG_HAS_XDR
+static hg_return_t
+hg_test_rle_compress(
+    void *dst, hg_size_t *dst_size, const void *src, hg_size_t src_size)
+{
+    const unsigned char *in = (const unsigned char *) src;
+    unsigned char *out = (unsigned char *) dst;
+    hg_size_t i = 0, j = 0;
+
+    /* Encode (count, value) pairs */
+    while (i < src_size) {
+        unsigned char count = 1;
+
+        while (i + count < src_size && in[i + count] == in[i] && count < 255)
+            count++;
+        if (j + 2 > *dst_size)
+            return HG_OVERFLOW;
+        out[j++] = count;
+        out[j++] = in[i];
+        i += count;
+    }
+    *dst_size = j;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rle_decompress(
+    void *dst, hg_size_t *dst_size, const void *src, hg_size_t src_size)
+{
+    const unsigned char *in = (const unsigned char *) src;
+    unsigned char *out = (unsigned char *) dst;
+    hg_size_t i, j = 0;
+
+    for (i = 0; i + 1 < src_size; i += 2) {
+        if (j + in[i] > *dst_size)
+            return HG_PROTOCOL_ERROR;
+        memset(out + j, in[i + 1], in[i]);
+        j += in[i];
+    }
+    *dst_size = j;
+
+    return HG_SUCCESS;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_prefetch_proc(hg_proc_t proc, void *data)
+{
+    hg_int32_t fildes = 0;
+    hg_size_t sizes[3] = {0, 0, 0};
+    hg_return_t ret;
+    int i;
+
+    /* Skip leading fields of bulk_write_in_t */
+    ret = hg_proc_int32_t(proc, &fildes);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    for (i = 0; i < 3; i++) {
+        ret = hg_proc_hg_size_t(proc, &sizes[i]);
+        if (ret != HG_SUCCESS)
+            return ret;
+    }
+
+    return hg_proc_hg_bulk_t(proc, (hg_bulk_t *) data);
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 hg_test_register(hg_class_t *hg_class)
@@ -317,6 +552,9 @@ hg_test_register(hg_class_t *hg_class)
     /* test_rpc */
     hg_test_rpc_null_id_g = MERCURY_REGISTER(
         hg_class, "hg_test_rpc_null", void, void, hg_test_rpc_null_cb);
+    /* Exercise priority lanes with small latency-sensitive RPC */
+    HG_Registered_set_priority(
+        hg_class, hg_test_rpc_null_id_g, HG_PRIORITY_HIGH);
     hg_test_rpc_open_id_g = MERCURY_REGISTER(hg_class, "hg_test_rpc_open",
         rpc_open_in_t, rpc_open_out_t, hg_test_rpc_open_cb);
     hg_test_rpc_open_id_no_resp_g =
@@ -327,14 +565,56 @@ hg_test_register(hg_class_t *hg_class)
     HG_Registered_disable_response(
         hg_class, hg_test_rpc_open_id_no_resp_g, HG_TRUE);
 
+    /* Forwards rpc_open to self from a coroutine */
+    hg_test_rpc_await_id_g = MERCURY_REGISTER(hg_class, "hg_test_rpc_await",
+        rpc_open_in_t, rpc_open_out_t, hg_test_rpc_await_cb);
+    HG_Registered_enable_coroutine(hg_class, hg_test_rpc_await_id_g, HG_TRUE);
+
     hg_test_overflow_id_g = MERCURY_REGISTER(hg_class, "hg_test_overflow", void,
         overflow_out_t, hg_test_overflow_cb);
+
+    /* Disable checksum */
+    HG_Registered_disable_checksum(hg_class, hg_test_overflow_id_g, HG_TRUE);
+
+#ifndef HG_HAS_XDR
+    /* Same as overflow but compressed payload fits into eager buffer */
+    hg_test_overflow_codec_id_g = MERCURY_REGISTER(hg_class,
+        "hg_test_overflow_codec", void, overflow_out_t, hg_test_overflow_cb);
+    HG_Registered_set_codec(
+        hg_class, hg_test_overflow_codec_id_g, &hg_test_rle_codec_g, 0);
+
+    /* Overflow output of requested size */
+    hg_test_overflow_resp_id_g = MERCURY_REGISTER(hg_class,
+        "hg_test_overflow_resp", overflow_in_t, overflow_out_t,
+        hg_test_overflow_resp_cb);
+#endif
     hg_test_cancel_rpc_id_g = MERCURY_REGISTER(
         hg_class, "hg_test_cancel_rpc", void, void, hg_test_cancel_rpc_cb);
 
+    /* Idempotent RPC with cached responses */
+    hg_test_rpc_cached_id_g = MERCURY_REGISTER(hg_class, "hg_test_rpc_cached",
+        rpc_open_in_t, rpc_open_out_t, hg_test_rpc_cached_cb);
+    HG_Registered_set_response_cache(
+        hg_class, hg_test_rpc_cached_id_g, 4096, 60000);
+
+    /* Streams back chunks of output */
+    hg_test_rpc_stream_id_g = MERCURY_REGISTER(hg_class, "hg_test_rpc_stream",
+        rpc_open_in_t, rpc_open_out_t, hg_test_rpc_stream_cb);
+
+    /* Relays encoded input and output through rpc_open */
+    hg_test_rpc_relay_id_g = MERCURY_REGISTER(hg_class, "hg_test_rpc_relay",
+        rpc_open_in_t, rpc_open_out_t, hg_test_rpc_relay_cb);
+
     /* test_bulk */
     hg_test_bulk_write_id_g = MERCURY_REGISTER(hg_class, "hg_test_bulk_write",
         bulk_write_in_t, bulk_write_out_t, hg_test_bulk_write_cb);
+
+    /* Bulk data is pulled before the RPC callback is executed */
+    hg_test_bulk_prefetch_id_g =
+        MERCURY_REGISTER(hg_class, "hg_test_bulk_prefetch", bulk_write_in_t,
+            bulk_write_out_t, hg_test_bulk_prefetch_cb);
+    HG_Registered_set_prefetch(
+        hg_class, hg_test_bulk_prefetch_id_g, hg_test_bulk_prefetch_proc);
     hg_test_bulk_bind_write_id_g =
         MERCURY_REGISTER(hg_class, "hg_test_bulk_bind_write", bulk_write_in_t,
             bulk_write_out_t, hg_test_bulk_bind_write_cb);
@@ -345,6 +625,9 @@ hg_test_register(hg_class_t *hg_class)
     /* test_kill */
     hg_test_killed_rpc_id_g = MERCURY_REGISTER(
         hg_class, "hg_test_killed_rpc", void, void, hg_test_killed_rpc_cb);
+    hg_test_killed_rpc_large_id_g =
+        MERCURY_REGISTER(hg_class, "hg_test_killed_rpc_large", rpc_open_in_t,
+            void, hg_test_killed_rpc_cb);
 
     /* test_perf */
     hg_test_perf_rpc_id_g = MERCURY_REGISTER(
@@ -359,6 +642,10 @@ hg_test_register(hg_class_t *hg_class)
         MERCURY_REGISTER(hg_class, "hg_test_perf_bulk_read", bulk_write_in_t,
             void, hg_test_perf_bulk_read_cb);
 
+    /* test_replay */
+    hg_test_replay_id_g = MERCURY_REGISTER(hg_class, "hg_test_replay",
+        replay_in_t, replay_out_t, hg_test_replay_cb);
+
     /* test_nested */
     //    hg_test_nested1_id_g = MERCURY_REGISTER(hg_class, "hg_test_nested",
     //            void, void, hg_test_nested1_cb);
@@ -376,6 +663,7 @@ hg_return_t
 HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
 {
     struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    char na_rails[NA_TEST_MAX_ADDR_NAME];
     struct hg_test_context_info *hg_test_context_info;
     hg_return_t ret = HG_SUCCESS;
     na_return_t na_ret;
@@ -405,21 +693,88 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
     /* Set progress mode */
     if (hg_test_info->na_test_info.busy_wait)
         hg_init_info.na_init_info.progress_mode = NA_NO_BLOCK;
+    else if (hg_test_info->na_test_info.notify_wait)
+        hg_init_info.na_init_info.progress_mode = NA_NOTIFY_ON_WAIT;
 
         /* Set stats */
 #ifdef HG_HAS_COLLECT_STATS
     hg_init_info.stats = HG_TRUE;
 #endif
 
+    /* Let clients inspect servers */
+    hg_init_info.introspect = HG_TRUE;
+
     /* Set max contexts */
     if (hg_test_info->na_test_info.max_contexts)
         hg_init_info.na_init_info.max_contexts =
             hg_test_info->na_test_info.max_contexts;
 
+    /* Set max msg size */
+    if (hg_test_info->na_test_info.max_msg_size) {
+        hg_init_info.na_init_info.max_unexpected_size =
+            (na_size_t) hg_test_info->na_test_info.max_msg_size;
+        hg_init_info.na_init_info.max_expected_size =
+            (na_size_t) hg_test_info->na_test_info.max_msg_size;
+    }
+    hg_init_info.na_init_info.auto_msg_size =
+        hg_test_info->na_test_info.auto_msg_size;
+
+    /* Set multi-recv buffers */
+    hg_init_info.na_init_info.multi_recv_count =
+        hg_test_info->na_test_info.multi_recv;
+    hg_init_info.na_init_info.shared_recv =
+        hg_test_info->na_test_info.shared_recv;
+    hg_init_info.na_init_info.mr_cache_size =
+        hg_test_info->na_test_info.mr_cache;
+    hg_init_info.na_init_info.rma_cq_budget = hg_test_info->na_test_info.rma_cq;
+    hg_init_info.na_init_info.stage_rma = hg_test_info->na_test_info.stage_rma;
+
     /* Set auto SM mode */
     if (hg_test_info->auto_sm)
         hg_init_info.auto_sm = HG_TRUE;
 
+    /* Set request coalescing */
+    hg_init_info.request_coalesce_count = hg_test_info->coalesce_count;
+
+    /* Set address lookup cache */
+    hg_init_info.addr_cache_ttl = hg_test_info->addr_cache_ttl;
+    hg_init_info.bulk_chunk_size = hg_test_info->bulk_chunk_size;
+    hg_init_info.bulk_self_thread_count = hg_test_info->bulk_self_thread_count;
+    hg_init_info.decode_borrow = hg_test_info->decode_borrow;
+    hg_init_info.decode_arena = hg_test_info->decode_arena;
+    hg_init_info.integrated_completion = hg_test_info->integrated_completion;
+    hg_init_info.request_post_adaptive = hg_test_info->request_post_adaptive;
+    hg_init_info.request_post_lazy = hg_test_info->request_post_lazy;
+    hg_init_info.request_credits = hg_test_info->request_credits;
+    hg_init_info.latency_stats = hg_test_info->latency_stats;
+    hg_init_info.compact_header = hg_test_info->compact_header;
+    hg_init_info.loopback_inline = hg_test_info->loopback_inline;
+    hg_init_info.bulk_cache_size = hg_test_info->bulk_cache_size;
+    hg_init_info.load_feedback = hg_test_info->load_feedback;
+    hg_init_info.fair_share = hg_test_info->fair_share;
+    hg_init_info.prealloc_count = hg_test_info->prealloc_count;
+    hg_init_info.capture_file = hg_test_info->capture_file;
+
+    /* Open additional rails with the same plugin and protocol */
+    if (hg_test_info->rail_count > 0) {
+        size_t len = 0;
+        unsigned int i;
+
+        for (i = 0; i < hg_test_info->rail_count; i++) {
+            int rc = snprintf(na_rails + len, sizeof(na_rails) - len,
+                "%s%s%s%s", (i > 0) ? "," : "",
+                hg_test_info->na_test_info.comm
+                    ? hg_test_info->na_test_info.comm
+                    : "",
+                hg_test_info->na_test_info.comm ? "+" : "",
+                hg_test_info->na_test_info.protocol);
+            HG_TEST_CHECK_ERROR(rc < 0 || (size_t) rc >= sizeof(na_rails) - len,
+                done, ret, HG_OVERFLOW, "Rail string exceeds buffer size");
+            len += (size_t) rc;
+        }
+        hg_init_info.na_rails = na_rails;
+    }
+
     /* Assign NA class */
     hg_init_info.na_class = hg_test_info->na_test_info.na_class;
 
@@ -487,8 +842,10 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
     }
 
     /* Create request class */
-    hg_test_info->request_class = hg_request_init(hg_test_request_progress,
-        hg_test_request_trigger, hg_test_info->context);
+    hg_test_info->request_class =
+        hg_request_init(hg_test_info->event_loop ? hg_test_request_progress_fd
+                                                 : hg_test_request_progress,
+            hg_test_request_trigger, hg_test_info->context);
     HG_TEST_CHECK_ERROR(hg_test_info->request_class == NULL, done, ret,
         HG_FAULT, "Could not create request class");
 
@@ -604,6 +961,12 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
             hg_test_info->na_test_info.target_name, &hg_test_info->target_addr);
         HG_TEST_CHECK_HG_ERROR(
             done, ret, "HG_Addr_lookup() failed (%s)", HG_Error_to_string(ret));
+
+        /* Connect ahead of first RPC */
+        ret = HG_Addr_warmup(
+            hg_test_info->hg_class, &hg_test_info->target_addr, 1);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Addr_warmup() failed (%s)", HG_Error_to_string(ret));
     }
 
 done:
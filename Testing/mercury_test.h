@@ -17,6 +17,7 @@
 #include "mercury_bulk.h"
 #include "mercury_request.h"
 #ifdef HG_TEST_HAS_THREAD_POOL
+#    include "mercury_thread_condition.h"
 #    include "mercury_thread_mutex.h"
 #    include "mercury_thread_pool.h"
 #endif
@@ -55,8 +56,30 @@ struct hg_test_info {
 #endif
     unsigned int handle_max;
     unsigned int thread_count;
+    unsigned int coalesce_count;
+    unsigned int addr_cache_ttl;
+    hg_size_t bulk_chunk_size;
+    unsigned int bulk_self_thread_count;
     hg_bool_t auth;
     hg_bool_t auto_sm;
+    hg_bool_t decode_borrow;
+    hg_bool_t decode_arena;
+    hg_bool_t integrated_completion;
+    unsigned int progress_thread_count;
+    hg_bool_t request_post_adaptive;
+    hg_bool_t request_post_lazy;
+    hg_bool_t event_loop;
+    unsigned int request_credits;
+    hg_bool_t latency_stats;
+    hg_bool_t compact_header;
+    hg_bool_t loopback_inline;
+    unsigned int rail_count;
+    unsigned int bulk_cache_size;
+    hg_bool_t load_feedback;
+    unsigned int admit_active_max;
+    hg_bool_t fair_share;
+    unsigned int prealloc_count;
+    const char *capture_file;
 };
 
 struct hg_test_context_info {
@@ -164,6 +187,15 @@ extern HG_PRIVATE HG_LOG_OUTLET_DECL(hg_test);
         fflush(stdout);                                                        \
     } while (0)
 
+/********************/
+/* Public Variables */
+/********************/
+
+#ifndef HG_HAS_XDR
+/* Run-length encoding codec */
+extern const struct hg_codec hg_test_rle_codec_g;
+#endif
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -9,6 +9,7 @@
  */
 
 #include "mercury_test_drc.h"
+#include "mercury_auth.h"
 #include "mercury_hl.h"
 
 /****************/
@@ -21,6 +22,9 @@
 /* Ignore DRC calls (for local testing) */
 //#define HG_TEST_DRC_IGNORE
 
+/* Time to wait for another process of the node to access DRC (ms) */
+#define HG_TEST_DRC_KEY_TIMEOUT (60000)
+
 /* Convert value to string */
 #define DRC_ERROR_STRING_MACRO(def, value, string)                             \
     if (value == def)                                                          \
@@ -73,6 +77,11 @@ hg_test_drc_grant_cb(hg_handle_t handle);
 static hg_return_t
 hg_test_drc_token_acquire(struct hg_test_info *hg_test_info);
 
+/* Acquire local DRC token on behalf of the node */
+static hg_return_t
+hg_test_drc_key_acquire_cb(
+    hg_uint32_t credential, void *arg, char *key, hg_size_t *key_size);
+
 /* Request access to other job and get token */
 static hg_return_t
 hg_test_drc_token_request(struct hg_test_info *hg_test_info);
@@ -309,6 +318,28 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_drc_key_acquire_cb(
+    hg_uint32_t credential, void *arg, char *key, hg_size_t *key_size)
+{
+    struct hg_test_info *hg_test_info = (struct hg_test_info *) arg;
+    hg_return_t ret;
+    int len;
+
+    (void) credential;
+    ret = hg_test_drc_token_acquire(hg_test_info);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    len = snprintf(key, (size_t) *key_size, "%u", hg_test_info->cookie);
+    if (len < 0 || (hg_size_t) len >= *key_size)
+        return HG_OVERFLOW;
+    *key_size = (hg_size_t) len;
+
+    return HG_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_drc_token_request(struct hg_test_info *hg_test_info)
@@ -599,12 +630,20 @@ hg_test_drc_acquire(int argc, char *argv[], struct hg_test_info *hg_test_info)
         }
         hg_test_info->credential = hg_test_drc_info.credential;
     } else {
+        char key[HG_AUTH_KEY_MAX + 1] = {'\0'};
+        hg_size_t key_size = 0;
+
+        /* Only one process per node accesses DRC, others get the cookie
+         * from the node-local cache */
         hg_test_drc_info.credential = hg_test_info->credential;
-        ret = hg_test_drc_token_acquire(&hg_test_drc_info);
+        ret = HG_Auth_key_get(hg_test_info->credential,
+            hg_test_drc_key_acquire_cb, &hg_test_drc_info,
+            HG_TEST_DRC_KEY_TIMEOUT, key, &key_size);
         if (ret != HG_SUCCESS) {
             HG_TEST_LOG_ERROR("Could not acquire DRC token");
             goto done;
         }
+        hg_test_drc_info.cookie = (hg_uint32_t) strtoul(key, NULL, 10);
     }
 
     /* Copy cookie/credential info */
@@ -660,6 +699,8 @@ hg_test_drc_release(struct hg_test_info *hg_test_info)
 
     if (hg_test_info->credential) {
         printf("# Releasing credential %u\n", hg_test_info->credential);
+        /* Cached cookie is no longer valid */
+        (void) HG_Auth_key_remove(hg_test_info->credential);
         rc = drc_release(hg_test_info->credential, 0);
         if (rc != DRC_SUCCESS) { /* failed to release credential */
             HG_TEST_LOG_ERROR(
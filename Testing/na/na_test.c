@@ -98,6 +98,14 @@ na_test_usage(const char *execname)
     printf("    -l, --loop          Number of loops (default: 1)\n");
     printf("    -b, --busy          Busy wait\n");
     printf("    -V, --verbose       Print verbose output\n");
+    printf("    -M, --multi_recv    Number of multi-recv buffers (OFI only)\n");
+    printf("    -R, --shared_recv   Share unexpected recvs across contexts\n");
+    printf("    -N, --notify_wait   Only notify peers about to wait (SM)\n");
+    printf("    -G, --mr_cache      Number of cached MRs (OFI only)\n");
+    printf("    -q, --rma_cq        RMA events per progress on separate CQ "
+           "(OFI only)\n");
+    printf("    -o, --stage_rma     Stage RMA through shared memory (SM)\n");
+    printf("    -Z, --msg_size      Max msg size (\"auto\" to auto-tune)\n");
 }
 
 /*---------------------------------------------------------------------------*/
@@ -159,10 +167,31 @@ na_test_parse_options(int argc, char *argv[], struct na_test_info *na_test_info)
                 break;
             case 'C': /* number of contexts */
                 na_test_info->max_contexts =
-                    (na_uint8_t) atoi(na_test_opt_arg_g);
+                    (na_uint16_t) atoi(na_test_opt_arg_g);
                 break;
             case 'Z': /* msg size */
-                na_test_info->max_msg_size = atoi(na_test_opt_arg_g);
+                if (strcmp(na_test_opt_arg_g, "auto") == 0)
+                    na_test_info->auto_msg_size = NA_TRUE;
+                else
+                    na_test_info->max_msg_size = atoi(na_test_opt_arg_g);
+                break;
+            case 'M': /* number of multi-recv buffers */
+                na_test_info->multi_recv = (na_uint8_t) atoi(na_test_opt_arg_g);
+                break;
+            case 'R': /* shared unexpected recvs */
+                na_test_info->shared_recv = NA_TRUE;
+                break;
+            case 'N': /* notify on wait */
+                na_test_info->notify_wait = NA_TRUE;
+                break;
+            case 'G': /* MR cache size */
+                na_test_info->mr_cache = (na_uint32_t) atoi(na_test_opt_arg_g);
+                break;
+            case 'q': /* separate RMA CQ */
+                na_test_info->rma_cq = (na_uint32_t) atoi(na_test_opt_arg_g);
+                break;
+            case 'o': /* staged RMA */
+                na_test_info->stage_rma = NA_TRUE;
                 break;
             case 'V': /* verbose */
                 na_test_info->verbose = NA_TRUE;
@@ -418,11 +447,20 @@ NA_Test_init(int argc, char *argv[], struct na_test_info *na_test_info)
     if (na_test_info->busy_wait) {
         na_init_info.progress_mode = NA_NO_BLOCK;
         printf("# Initializing NA in busy wait mode\n");
+    } else if (na_test_info->notify_wait) {
+        na_init_info.progress_mode = NA_NOTIFY_ON_WAIT;
+        printf("# Initializing NA in notify on wait mode\n");
     }
     na_init_info.auth_key = na_test_info->key;
     na_init_info.max_contexts = na_test_info->max_contexts;
+    na_init_info.multi_recv_count = na_test_info->multi_recv;
+    na_init_info.shared_recv = na_test_info->shared_recv;
+    na_init_info.mr_cache_size = na_test_info->mr_cache;
+    na_init_info.rma_cq_budget = na_test_info->rma_cq;
+    na_init_info.stage_rma = na_test_info->stage_rma;
     na_init_info.max_unexpected_size = (na_size_t) na_test_info->max_msg_size;
     na_init_info.max_expected_size = (na_size_t) na_test_info->max_msg_size;
+    na_init_info.auto_msg_size = na_test_info->auto_msg_size;
 
     printf("# Using info string: %s\n", info_string);
     na_test_info->na_class =
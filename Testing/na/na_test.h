@@ -23,23 +23,30 @@
 /*************************************/
 
 struct na_test_info {
-    na_class_t *na_class;    /* NA class */
-    char *target_name;       /* Target name */
-    char *comm;              /* Comm/Plugin name */
-    char *domain;            /* Domain name */
-    char *protocol;          /* Protocol name */
-    char *hostname;          /* Hostname */
-    int port;                /* Port */
-    na_bool_t listen;        /* Listen */
-    na_bool_t mpi_static;    /* MPI static comm */
-    na_bool_t self_send;     /* Self send */
-    char *key;               /* Auth key */
-    int loop;                /* Number of loops */
-    na_bool_t busy_wait;     /* Busy wait */
-    na_uint8_t max_contexts; /* Max contexts */
-    int max_msg_size;        /* Max msg size */
-    na_bool_t verbose;       /* Verbose mode */
-    int max_number_of_peers; /* Max number of peers */
+    na_class_t *na_class;     /* NA class */
+    char *target_name;        /* Target name */
+    char *comm;               /* Comm/Plugin name */
+    char *domain;             /* Domain name */
+    char *protocol;           /* Protocol name */
+    char *hostname;           /* Hostname */
+    int port;                 /* Port */
+    na_bool_t listen;         /* Listen */
+    na_bool_t mpi_static;     /* MPI static comm */
+    na_bool_t self_send;      /* Self send */
+    char *key;                /* Auth key */
+    int loop;                 /* Number of loops */
+    na_bool_t busy_wait;      /* Busy wait */
+    na_bool_t notify_wait;    /* Notify on wait */
+    na_uint16_t max_contexts; /* Max contexts */
+    na_uint8_t multi_recv;    /* Multi-recv buffers */
+    na_bool_t shared_recv;    /* Shared unexpected recvs */
+    na_uint32_t mr_cache;     /* MR cache size */
+    na_uint32_t rma_cq;       /* RMA events per progress on RMA CQ */
+    na_bool_t stage_rma;      /* Stage RMA through shared memory */
+    int max_msg_size;         /* Max msg size */
+    na_bool_t auto_msg_size;  /* Tune msg sizes to plugin */
+    na_bool_t verbose;        /* Verbose mode */
+    int max_number_of_peers;  /* Max number of peers */
 #ifdef HG_TEST_HAS_PARALLEL
     MPI_Comm mpi_comm;         /* MPI comm */
     na_bool_t mpi_no_finalize; /* Prevent from finalizing MPI */
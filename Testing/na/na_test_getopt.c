@@ -17,7 +17,8 @@
 
 int na_test_opt_ind_g = 1;            /* token pointer */
 const char *na_test_opt_arg_g = NULL; /* flag argument (or value) */
-const char *na_test_short_opt_g = "hc:d:p:H:P:LsSk:l:bC:VaZ:z:x:mt:";
+const char *na_test_short_opt_g =
+    "hc:d:p:H:P:LsSk:l:bC:VaZ:z:x:mt:g:M:RNG:q:A:B:T:DEIW:JK:YXFQ:UOr:yj:fe:ow:";
 /* clang-format off */
 const struct na_test_opt na_test_opt_g[] = {
     {"help", no_arg, 'h'},
@@ -40,6 +41,34 @@ const struct na_test_opt na_test_opt_g[] = {
     {"handle", require_arg, 'x'},
     {"memory", no_arg, 'm'},
     {"threads", require_arg, 't'},
+    {"coalesce", require_arg, 'g'},
+    {"multi_recv", require_arg, 'M'},
+    {"shared_recv", no_arg, 'R'},
+    {"mr_cache", require_arg, 'G'},
+    {"rma_cq", require_arg, 'q'},
+    {"notify_wait", no_arg, 'N'},
+    {"addr_cache", require_arg, 'A'},
+    {"bulk_chunk", require_arg, 'B'},
+    {"bulk_threads", require_arg, 'T'},
+    {"borrow", no_arg, 'D'},
+    {"arena", no_arg, 'E'},
+    {"integrated", no_arg, 'I'},
+    {"progress_threads", require_arg, 'W'},
+    {"post_adaptive", no_arg, 'J'},
+    {"credits", require_arg, 'K'},
+    {"latency", no_arg, 'Y'},
+    {"compact", no_arg, 'X'},
+    {"inline", no_arg, 'F'},
+    {"rails", require_arg, 'Q'},
+    {"post_lazy", no_arg, 'U'},
+    {"event_loop", no_arg, 'O'},
+    {"bulk_cache", require_arg, 'r'},
+    {"load_feedback", no_arg, 'y'},
+    {"admit", require_arg, 'j'},
+    {"fair_share", no_arg, 'f'},
+    {"prealloc", require_arg, 'e'},
+    {"stage_rma", no_arg, 'o'},
+    {"capture", require_arg, 'w'},
     {NULL, 0, '\0'} /* Must add this at the end */
 };
 /* clang-format on */
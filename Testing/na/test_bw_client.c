@@ -0,0 +1,594 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "na_test.h"
+
+#include "mercury_request.h" /* For convenience */
+#include "mercury_time.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/****************/
+/* Local Macros */
+/****************/
+#define BENCHMARK_NAME "RMA bandwidth"
+#define STRING(s)      #s
+#define XSTRING(s)     STRING(s)
+#define VERSION_NAME                                                           \
+    XSTRING(0)                                                                 \
+    "." XSTRING(1) "." XSTRING(0)
+
+/* Size of the target buffer, must match server */
+#define NA_TEST_BW_REMOTE_SIZE (1 << 22)
+
+/* Sweeps: transfer size with a single op and segment, window of in-flight
+ * ops at a fixed size and segment count at a fixed size */
+#define NA_TEST_BW_MAX_SIZE     NA_TEST_BW_REMOTE_SIZE
+#define NA_TEST_BW_WINDOW_SIZE  (1 << 16)
+#define NA_TEST_BW_MAX_WINDOW   64
+#define NA_TEST_BW_SEGMENT_SIZE (1 << 20)
+#define NA_TEST_BW_MAX_SEGMENTS 256
+
+/* Bytes moved per measurement, number of iterations is bounded */
+#define NA_TEST_BW_TOTAL_SIZE (1 << 28)
+#define NA_TEST_BW_MIN_ITER   10
+#define NA_TEST_BW_MAX_ITER   10000
+#define NA_TEST_BW_SKIP       10
+#define NA_TEST_BW_REG_LOOP   10
+
+#define NDIGITS               2
+#define NWIDTH                12
+#define NA_TEST_TAG_HANDLE    110
+#define NA_TEST_TAG_DONE      111
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+typedef enum { NA_TEST_BW_PUT, NA_TEST_BW_GET } na_test_bw_op_t;
+
+struct na_test_bw_info {
+    na_class_t *na_class;
+    na_context_t *context;
+    hg_request_class_t *request_class;
+    na_addr_t target_addr;
+    na_mem_handle_t remote_handle;
+    char *local_buf;
+    na_size_t local_buf_size;
+    na_op_id_t *op_ids[NA_TEST_BW_MAX_WINDOW];
+    struct na_test_info na_test_info;
+};
+
+struct na_test_bw_window {
+    hg_request_t *request;
+    unsigned int pending;
+    na_return_t ret;
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static NA_INLINE int
+na_test_request_progress(unsigned int timeout, void *arg);
+
+static NA_INLINE int
+na_test_request_trigger(unsigned int timeout, unsigned int *flag, void *arg);
+
+static na_return_t
+na_test_target_lookup(struct na_test_bw_info *na_test_bw_info);
+
+static NA_INLINE int
+na_test_recv_expected_cb(const struct na_cb_info *na_cb_info);
+
+static NA_INLINE int
+na_test_rma_cb(const struct na_cb_info *na_cb_info);
+
+static na_return_t
+na_test_send_recv(struct na_test_bw_info *na_test_bw_info, na_tag_t tag,
+    void *reply, na_size_t reply_size);
+
+static na_return_t
+na_test_exchange_handle(struct na_test_bw_info *na_test_bw_info);
+
+static na_return_t
+na_test_local_handle_create(struct na_test_bw_info *na_test_bw_info,
+    na_size_t size, na_size_t segment_count, na_mem_handle_t *mem_handle);
+
+static na_return_t
+na_test_post_window(struct na_test_bw_info *na_test_bw_info,
+    na_test_bw_op_t op, na_mem_handle_t local_handle, na_size_t size,
+    unsigned int window, struct na_test_bw_window *na_test_bw_window);
+
+static na_return_t
+na_test_measure_bw(struct na_test_bw_info *na_test_bw_info, na_test_bw_op_t op,
+    na_size_t size, na_size_t segment_count, unsigned int window);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static const char *const na_test_bw_op_name_g[] = {"put", "get"};
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_test_request_progress(unsigned int timeout, void *arg)
+{
+    struct na_test_bw_info *na_test_bw_info = (struct na_test_bw_info *) arg;
+    unsigned int timeout_progress = 0;
+    int ret = HG_UTIL_SUCCESS;
+
+    /* Safe to block */
+    if (NA_Poll_try_wait(na_test_bw_info->na_class, na_test_bw_info->context))
+        timeout_progress = timeout;
+
+    /* Progress */
+    if (NA_Progress(na_test_bw_info->na_class, na_test_bw_info->context,
+            timeout_progress) != NA_SUCCESS)
+        ret = HG_UTIL_FAIL;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_test_request_trigger(unsigned int timeout, unsigned int *flag, void *arg)
+{
+    struct na_test_bw_info *na_test_bw_info = (struct na_test_bw_info *) arg;
+    unsigned int actual_count = 0;
+    int ret = HG_UTIL_SUCCESS;
+
+    if (NA_Trigger(na_test_bw_info->context, timeout, 1, NULL,
+            &actual_count) != NA_SUCCESS)
+        ret = HG_UTIL_FAIL;
+    *flag = (actual_count) ? HG_UTIL_TRUE : HG_UTIL_FALSE;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_test_target_lookup(struct na_test_bw_info *na_test_bw_info)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    /* Forward call to remote addr and get a new request */
+    ret = NA_Addr_lookup(na_test_bw_info->na_class,
+        na_test_bw_info->na_test_info.target_name,
+        &na_test_bw_info->target_addr);
+    if (ret != NA_SUCCESS) {
+        NA_TEST_LOG_ERROR(
+            "Could not lookup address (%s)", NA_Error_to_string(ret));
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_test_recv_expected_cb(const struct na_cb_info *na_cb_info)
+{
+    hg_request_t *request = (hg_request_t *) na_cb_info->arg;
+
+    hg_request_complete(request);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_test_rma_cb(const struct na_cb_info *na_cb_info)
+{
+    struct na_test_bw_window *na_test_bw_window =
+        (struct na_test_bw_window *) na_cb_info->arg;
+
+    if (na_cb_info->ret != NA_SUCCESS)
+        na_test_bw_window->ret = na_cb_info->ret;
+    if (--na_test_bw_window->pending == 0)
+        hg_request_complete(na_test_bw_window->request);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_test_send_recv(struct na_test_bw_info *na_test_bw_info, na_tag_t tag,
+    void *reply, na_size_t reply_size)
+{
+    char *send_buf = NULL, *recv_buf = NULL;
+    void *send_buf_data, *recv_buf_data;
+    hg_request_t *recv_request = NULL;
+    na_size_t unexpected_header_size =
+        NA_Msg_get_unexpected_header_size(na_test_bw_info->na_class);
+    na_size_t expected_header_size =
+        NA_Msg_get_expected_header_size(na_test_bw_info->na_class);
+    na_size_t send_size =
+        (unexpected_header_size) ? unexpected_header_size + 1 : 1;
+    na_size_t recv_size =
+        NA_Msg_get_max_expected_size(na_test_bw_info->na_class);
+    na_op_id_t *send_op_id;
+    na_op_id_t *recv_op_id;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Prepare send_buf */
+    send_buf =
+        NA_Msg_buf_alloc(na_test_bw_info->na_class, send_size, &send_buf_data);
+    NA_Msg_init_unexpected(na_test_bw_info->na_class, send_buf, send_size);
+
+    /* Prepare recv buf */
+    recv_buf =
+        NA_Msg_buf_alloc(na_test_bw_info->na_class, recv_size, &recv_buf_data);
+    memset(recv_buf, 0, recv_size);
+
+    send_op_id = NA_Op_create(na_test_bw_info->na_class);
+    recv_op_id = NA_Op_create(na_test_bw_info->na_class);
+
+    recv_request = hg_request_create(na_test_bw_info->request_class);
+
+    /* Post recv */
+    ret = NA_Msg_recv_expected(na_test_bw_info->na_class,
+        na_test_bw_info->context, na_test_recv_expected_cb, recv_request,
+        recv_buf, recv_size, recv_buf_data, na_test_bw_info->target_addr, 0,
+        tag, recv_op_id);
+    if (ret != NA_SUCCESS) {
+        NA_TEST_LOG_ERROR(
+            "NA_Msg_recv_expected() failed (%s)", NA_Error_to_string(ret));
+        goto done;
+    }
+
+    /* Post send */
+    ret = NA_Msg_send_unexpected(na_test_bw_info->na_class,
+        na_test_bw_info->context, NULL, NULL, send_buf, send_size,
+        send_buf_data, na_test_bw_info->target_addr, 0, tag, send_op_id);
+    if (ret != NA_SUCCESS) {
+        NA_TEST_LOG_ERROR(
+            "NA_Msg_send_unexpected() failed (%s)", NA_Error_to_string(ret));
+        goto done;
+    }
+
+    hg_request_wait(recv_request, NA_MAX_IDLE_TIME, NULL);
+
+    if (reply) {
+        if (expected_header_size + reply_size > recv_size) {
+            NA_TEST_LOG_ERROR("Reply too large (%zu)", (size_t) reply_size);
+            ret = NA_OVERFLOW;
+            goto done;
+        }
+        memcpy(reply, recv_buf + expected_header_size, reply_size);
+    }
+
+done:
+    /* Clean up resources */
+    hg_request_destroy(recv_request);
+    NA_Op_destroy(na_test_bw_info->na_class, send_op_id);
+    NA_Op_destroy(na_test_bw_info->na_class, recv_op_id);
+    NA_Msg_buf_free(na_test_bw_info->na_class, send_buf, send_buf_data);
+    NA_Msg_buf_free(na_test_bw_info->na_class, recv_buf, recv_buf_data);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_test_exchange_handle(struct na_test_bw_info *na_test_bw_info)
+{
+    na_size_t buf_size =
+        NA_Msg_get_max_expected_size(na_test_bw_info->na_class);
+    void *buf;
+    na_return_t ret;
+
+    buf = malloc(buf_size);
+    if (buf == NULL) {
+        NA_TEST_LOG_ERROR("Could not allocate handle buffer");
+        return NA_NOMEM;
+    }
+
+    /* Target replies with its serialized handle, deserialization only reads
+     * what it needs from the buffer */
+    buf_size -= NA_Msg_get_expected_header_size(na_test_bw_info->na_class);
+    ret = na_test_send_recv(
+        na_test_bw_info, NA_TEST_TAG_HANDLE, buf, buf_size);
+    if (ret != NA_SUCCESS)
+        goto done;
+
+    ret = NA_Mem_handle_deserialize(na_test_bw_info->na_class,
+        &na_test_bw_info->remote_handle, buf, buf_size);
+    if (ret != NA_SUCCESS) {
+        NA_TEST_LOG_ERROR(
+            "NA_Mem_handle_deserialize() failed (%s)", NA_Error_to_string(ret));
+        goto done;
+    }
+
+done:
+    free(buf);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_test_local_handle_create(struct na_test_bw_info *na_test_bw_info,
+    na_size_t size, na_size_t segment_count, na_mem_handle_t *mem_handle)
+{
+    struct na_segment segments[NA_TEST_BW_MAX_SEGMENTS];
+    na_size_t segment_size = size / segment_count, i;
+
+    if (segment_count == 1)
+        return NA_Mem_handle_create(na_test_bw_info->na_class,
+            na_test_bw_info->local_buf, size, NA_MEM_READWRITE, mem_handle);
+
+    /* Leave a gap after each segment so that they cannot be merged */
+    for (i = 0; i < segment_count; i++) {
+        segments[i].base =
+            (na_ptr_t) (na_test_bw_info->local_buf + 2 * i * segment_size);
+        segments[i].len = segment_size;
+    }
+
+    return NA_Mem_handle_create_segments(na_test_bw_info->na_class, segments,
+        segment_count, NA_MEM_READWRITE, mem_handle);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_test_post_window(struct na_test_bw_info *na_test_bw_info,
+    na_test_bw_op_t op, na_mem_handle_t local_handle, na_size_t size,
+    unsigned int window, struct na_test_bw_window *na_test_bw_window)
+{
+    unsigned int i;
+    na_return_t ret = NA_SUCCESS;
+
+    na_test_bw_window->pending = window;
+
+    for (i = 0; i < window; i++) {
+        na_offset_t offset = (na_offset_t) (i * size);
+
+        do {
+            if (op == NA_TEST_BW_PUT)
+                ret = NA_Put(na_test_bw_info->na_class,
+                    na_test_bw_info->context, na_test_rma_cb,
+                    na_test_bw_window, local_handle, offset,
+                    na_test_bw_info->remote_handle, offset, size,
+                    na_test_bw_info->target_addr, 0,
+                    na_test_bw_info->op_ids[i]);
+            else
+                ret = NA_Get(na_test_bw_info->na_class,
+                    na_test_bw_info->context, na_test_rma_cb,
+                    na_test_bw_window, local_handle, offset,
+                    na_test_bw_info->remote_handle, offset, size,
+                    na_test_bw_info->target_addr, 0,
+                    na_test_bw_info->op_ids[i]);
+            /* Resources exhausted, make progress and retry */
+            if (ret == NA_AGAIN)
+                hg_request_wait(na_test_bw_window->request, 0, NULL);
+        } while (ret == NA_AGAIN);
+
+        if (ret != NA_SUCCESS) {
+            NA_TEST_LOG_ERROR("Could not post %s (%s)",
+                na_test_bw_op_name_g[op], NA_Error_to_string(ret));
+            na_test_bw_window->pending -= window - i;
+            break;
+        }
+    }
+
+    /* Wait for posted ops to complete */
+    if (na_test_bw_window->pending > 0)
+        hg_request_wait(na_test_bw_window->request, NA_MAX_IDLE_TIME, NULL);
+    hg_request_reset(na_test_bw_window->request);
+
+    if (ret == NA_SUCCESS && na_test_bw_window->ret != NA_SUCCESS) {
+        NA_TEST_LOG_ERROR("%s completed with error (%s)",
+            na_test_bw_op_name_g[op],
+            NA_Error_to_string(na_test_bw_window->ret));
+        ret = na_test_bw_window->ret;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_test_measure_bw(struct na_test_bw_info *na_test_bw_info, na_test_bw_op_t op,
+    na_size_t size, na_size_t segment_count, unsigned int window)
+{
+    struct na_test_bw_window na_test_bw_window = {NULL, 0, NA_SUCCESS};
+    na_mem_handle_t local_handle = NA_MEM_HANDLE_NULL;
+    na_size_t total_size = size * window;
+    size_t loop = (size_t) na_test_bw_info->na_test_info.loop *
+                  (NA_TEST_BW_TOTAL_SIZE / total_size);
+    double time_reg = 0, time_rma = 0, bw, cpu_per_byte;
+    hg_time_t t1, t2;
+    clock_t c1, c2;
+    na_return_t ret = NA_SUCCESS;
+    size_t i;
+
+    if (loop < NA_TEST_BW_MIN_ITER)
+        loop = NA_TEST_BW_MIN_ITER;
+    if (loop > NA_TEST_BW_MAX_ITER)
+        loop = NA_TEST_BW_MAX_ITER;
+
+    /* Registration cost: create + register, deregister + free */
+    for (i = 0; i < NA_TEST_BW_REG_LOOP; i++) {
+        hg_time_get_current(&t1);
+        ret = na_test_local_handle_create(
+            na_test_bw_info, total_size, segment_count, &local_handle);
+        if (ret != NA_SUCCESS) {
+            NA_TEST_LOG_ERROR(
+                "Could not create local handle (%s)", NA_Error_to_string(ret));
+            return ret;
+        }
+        ret = NA_Mem_register(na_test_bw_info->na_class, local_handle);
+        if (ret != NA_SUCCESS) {
+            NA_TEST_LOG_ERROR(
+                "NA_Mem_register() failed (%s)", NA_Error_to_string(ret));
+            NA_Mem_handle_free(na_test_bw_info->na_class, local_handle);
+            return ret;
+        }
+        hg_time_get_current(&t2);
+        time_reg += hg_time_to_double(hg_time_subtract(t2, t1));
+
+        /* Keep last registration for transfers */
+        if (i == NA_TEST_BW_REG_LOOP - 1)
+            break;
+
+        hg_time_get_current(&t1);
+        NA_Mem_deregister(na_test_bw_info->na_class, local_handle);
+        NA_Mem_handle_free(na_test_bw_info->na_class, local_handle);
+        hg_time_get_current(&t2);
+        time_reg += hg_time_to_double(hg_time_subtract(t2, t1));
+    }
+
+    na_test_bw_window.request =
+        hg_request_create(na_test_bw_info->request_class);
+
+    /* Warm up */
+    for (i = 0; i < NA_TEST_BW_SKIP; i++) {
+        ret = na_test_post_window(na_test_bw_info, op, local_handle, size,
+            window, &na_test_bw_window);
+        if (ret != NA_SUCCESS)
+            goto done;
+    }
+
+    NA_Test_barrier(&na_test_bw_info->na_test_info);
+
+    /* Actual benchmark */
+    hg_time_get_current(&t1);
+    c1 = clock();
+    for (i = 0; i < loop; i++) {
+        ret = na_test_post_window(na_test_bw_info, op, local_handle, size,
+            window, &na_test_bw_window);
+        if (ret != NA_SUCCESS)
+            goto done;
+    }
+    c2 = clock();
+    hg_time_get_current(&t2);
+    time_rma = hg_time_to_double(hg_time_subtract(t2, t1));
+
+    bw = (double) total_size * (double) loop / time_rma / 1.0e9;
+    cpu_per_byte = (double) (c2 - c1) / CLOCKS_PER_SEC * 1.0e9 /
+                   ((double) total_size * (double) loop);
+    if (na_test_bw_info->na_test_info.mpi_comm_rank == 0)
+        fprintf(stdout, "%-*s%*zu%*zu%*u%*.*f%*.*f%*.*f\n", 6,
+            na_test_bw_op_name_g[op], NWIDTH, (size_t) size, 8,
+            (size_t) segment_count, 8, window, NWIDTH, NDIGITS, bw, NWIDTH,
+            NDIGITS, time_reg * 1.0e6 / NA_TEST_BW_REG_LOOP, NWIDTH, 4,
+            cpu_per_byte);
+
+done:
+    hg_request_destroy(na_test_bw_window.request);
+    NA_Mem_deregister(na_test_bw_info->na_class, local_handle);
+    NA_Mem_handle_free(na_test_bw_info->na_class, local_handle);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct na_test_bw_info na_test_bw_info = {0};
+    na_size_t size, segment_count, max_segments;
+    unsigned int window, i;
+    int op;
+    int ret = EXIT_SUCCESS;
+
+    /* Initialize the interface */
+    NA_Test_init(argc, argv, &na_test_bw_info.na_test_info);
+    na_test_bw_info.na_class = na_test_bw_info.na_test_info.na_class;
+    na_test_bw_info.context = NA_Context_create(na_test_bw_info.na_class);
+    na_test_bw_info.request_class = hg_request_init(
+        na_test_request_progress, na_test_request_trigger, &na_test_bw_info);
+
+    /* Lookup target addr and get its handle */
+    if (na_test_target_lookup(&na_test_bw_info) != NA_SUCCESS ||
+        na_test_exchange_handle(&na_test_bw_info) != NA_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Segmented handles are laid out with gaps */
+    na_test_bw_info.local_buf_size = 2 * NA_TEST_BW_MAX_SIZE;
+    na_test_bw_info.local_buf = (char *) malloc(na_test_bw_info.local_buf_size);
+    if (na_test_bw_info.local_buf == NULL) {
+        NA_TEST_LOG_ERROR("Could not allocate local buffer");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    memset(na_test_bw_info.local_buf, 0, na_test_bw_info.local_buf_size);
+
+    for (i = 0; i < NA_TEST_BW_MAX_WINDOW; i++)
+        na_test_bw_info.op_ids[i] = NA_Op_create(na_test_bw_info.na_class);
+
+    max_segments = NA_Mem_handle_get_max_segments(na_test_bw_info.na_class);
+    if (max_segments > NA_TEST_BW_MAX_SEGMENTS)
+        max_segments = NA_TEST_BW_MAX_SEGMENTS;
+
+    if (na_test_bw_info.na_test_info.mpi_comm_rank == 0) {
+        fprintf(stdout, "# %s v%s\n", BENCHMARK_NAME, VERSION_NAME);
+        fprintf(stdout,
+            "# Loop %d times, sizes up to %d byte(s), window up to %d op(s), "
+            "up to %zu segment(s)\n",
+            na_test_bw_info.na_test_info.loop, NA_TEST_BW_MAX_SIZE,
+            NA_TEST_BW_MAX_WINDOW, (size_t) max_segments);
+        fprintf(stdout, "# Progress mode: %s\n",
+            na_test_bw_info.na_test_info.busy_wait
+                ? "busy wait (no notifications)"
+                : na_test_bw_info.na_test_info.notify_wait
+                      ? "notify on wait"
+                      : "blocking");
+        fprintf(stdout, "# Reg: create + register + deregister + free\n");
+        fprintf(stdout, "# CPU: initiator CPU time per byte transferred\n");
+        fprintf(stdout, "%-*s%*s%*s%*s%*s%*s%*s\n", 6, "# Op", NWIDTH, "Size",
+            8, "Segs", 8, "Window", NWIDTH, "BW (GB/s)", NWIDTH, "Reg (us)",
+            NWIDTH, "CPU (ns/B)");
+        fflush(stdout);
+    }
+
+    for (op = NA_TEST_BW_PUT; op <= NA_TEST_BW_GET; op++) {
+        /* Transfer size */
+        for (size = 1; size <= NA_TEST_BW_MAX_SIZE; size *= 2)
+            if (na_test_measure_bw(&na_test_bw_info, (na_test_bw_op_t) op,
+                    size, 1, 1) != NA_SUCCESS)
+                ret = EXIT_FAILURE;
+
+        /* In-flight ops */
+        for (window = 2; window <= NA_TEST_BW_MAX_WINDOW; window *= 2)
+            if (na_test_measure_bw(&na_test_bw_info, (na_test_bw_op_t) op,
+                    NA_TEST_BW_WINDOW_SIZE, 1, window) != NA_SUCCESS)
+                ret = EXIT_FAILURE;
+
+        /* Segment count */
+        for (segment_count = 2; segment_count <= max_segments;
+             segment_count *= 2)
+            if (na_test_measure_bw(&na_test_bw_info, (na_test_bw_op_t) op,
+                    NA_TEST_BW_SEGMENT_SIZE, segment_count,
+                    1) != NA_SUCCESS)
+                ret = EXIT_FAILURE;
+    }
+
+    for (i = 0; i < NA_TEST_BW_MAX_WINDOW; i++)
+        NA_Op_destroy(na_test_bw_info.na_class, na_test_bw_info.op_ids[i]);
+    free(na_test_bw_info.local_buf);
+
+done:
+    /* Finalize interface */
+    if (na_test_bw_info.target_addr != NA_ADDR_NULL &&
+        na_test_bw_info.na_test_info.mpi_comm_rank == 0)
+        na_test_send_recv(&na_test_bw_info, NA_TEST_TAG_DONE, NULL, 0);
+    if (na_test_bw_info.remote_handle != NA_MEM_HANDLE_NULL)
+        NA_Mem_handle_free(
+            na_test_bw_info.na_class, na_test_bw_info.remote_handle);
+    NA_Addr_free(na_test_bw_info.na_class, na_test_bw_info.target_addr);
+    hg_request_finalize(na_test_bw_info.request_class, NULL);
+    NA_Context_destroy(na_test_bw_info.na_class, na_test_bw_info.context);
+    NA_Test_finalize(&na_test_bw_info.na_test_info);
+
+    return ret;
+}
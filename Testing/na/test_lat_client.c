@@ -382,6 +382,12 @@ main(int argc, char *argv[])
         fprintf(stdout, "# %s v%s\n", BENCHMARK_NAME, VERSION_NAME);
         fprintf(stdout, "# Loop %d times from size %d to %zu byte(s)\n",
             na_test_lat_info.na_test_info.loop, 1, max_size);
+        fprintf(stdout, "# Progress mode: %s\n",
+            na_test_lat_info.na_test_info.busy_wait
+                ? "busy wait (no notifications)"
+                : na_test_lat_info.na_test_info.notify_wait
+                      ? "notify on wait"
+                      : "blocking");
 #ifdef HG_TEST_HAS_VERIFY_DATA
         fprintf(stdout, "# WARNING verifying data, output will be slower\n");
 #endif
@@ -0,0 +1,1048 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_test.h"
+
+#include "mercury_atomic.h"
+#include "mercury_histogram.h"
+#include "mercury_thread.h"
+#include "mercury_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#    include <sys/resource.h>
+#endif
+
+/* Benchmark that sweeps message size, number of operations in flight,
+ * number of client threads and contexts, and number of bulk segments.
+ * Standard test options (comm, protocol, etc) are given first, benchmark
+ * options are given after "--", e.g.:
+ *   hg_bench -c ofi -p tcp -C 4 -- --mode rpc --size 1:4096 --window 1:64
+ * Results are printed as a table, CSV or JSON (use --output to keep test
+ * messages out of the results) and can be compared against the CSV results
+ * of a previous run, e.g., with an older version of mercury. */
+
+/****************/
+/* Local Macros */
+/****************/
+
+#define BENCHMARK_NAME "hg_bench"
+#define STRING(s)      #s
+#define XSTRING(s)     STRING(s)
+#define VERSION_NAME                                                           \
+    XSTRING(HG_VERSION_MAJOR)                                                  \
+    "." XSTRING(HG_VERSION_MINOR) "." XSTRING(HG_VERSION_PATCH)
+
+/* Benchmark modes */
+#define HG_BENCH_RPC   (1 << 0) /* RPC with payload of message size */
+#define HG_BENCH_WRITE (1 << 1) /* Server pulls message size from client */
+#define HG_BENCH_READ  (1 << 2) /* Server pushes message size to client */
+
+/* Default number of measured operations for each point (divided by 10 for
+ * sizes above LARGE_SIZE) */
+#define HG_BENCH_OPS_DEFAULT 10000
+#define LARGE_SIZE           8192
+
+/* Progress timeout (ms) */
+#define HG_BENCH_PROGRESS_TIMEOUT 100
+
+/* Default regression threshold (percent) */
+#define HG_BENCH_THRESHOLD_DEFAULT 10.0
+
+#define HG_BENCH_MB   (1024.0 * 1024.0)
+#define HG_BENCH_LINE (1024)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+typedef enum {
+    HG_BENCH_TEXT, /* Human-readable table */
+    HG_BENCH_CSV,  /* Comma-separated values */
+    HG_BENCH_JSON  /* JSON document */
+} hg_bench_format_t;
+
+/* Swept parameter, from min to max by powers of two */
+struct hg_bench_range {
+    unsigned long min;
+    unsigned long max;
+};
+
+struct hg_bench_options {
+    struct hg_bench_range sizes;    /* Message sizes */
+    struct hg_bench_range windows;  /* Operations in flight per thread */
+    struct hg_bench_range threads;  /* Client threads */
+    struct hg_bench_range contexts; /* Contexts (client and server) */
+    struct hg_bench_range segments; /* Bulk segments */
+    unsigned long ops;              /* Measured operations per point */
+    unsigned int modes;             /* Benchmark modes */
+    hg_bench_format_t format;       /* Output format */
+    const char *output;             /* Output file (stdout if NULL) */
+    const char *baseline;           /* Baseline CSV file */
+    double threshold;               /* Regression threshold (percent) */
+};
+
+/* Benchmark point */
+struct hg_bench_point {
+    unsigned int mode;
+    unsigned long size;
+    unsigned int window;
+    unsigned int threads;
+    unsigned int contexts;
+    unsigned int segments;
+};
+
+struct hg_bench_result {
+    struct hg_bench_point point;
+    unsigned long ops; /* Measured operations */
+    double time;       /* Elapsed time (s) */
+    double rate;       /* Operations per second */
+    double bandwidth;  /* MB/s */
+    double p50;        /* Median latency (us) */
+    double p99;        /* 99th percentile latency (us) */
+    double p999;       /* 99.9th percentile latency (us) */
+    double cpu_per_op; /* Process CPU time per operation (us) */
+};
+
+struct hg_bench_thread;
+
+/* Operation in flight */
+struct hg_bench_slot {
+    struct hg_bench_thread *thread; /* Owning thread */
+    hg_handle_t handle;             /* Handle (re-forwarded when completed) */
+    hg_time_t start;                /* Time of forward */
+};
+
+struct hg_bench_thread {
+    hg_thread_t thread;                 /* Thread */
+    const struct hg_bench_point *point; /* Current point */
+    struct hg_histogram *histogram;     /* Latencies (NULL when warming up) */
+    hg_context_t *context;              /* Context used by thread */
+    struct hg_bench_slot *slots;        /* Operations in flight */
+    void *in_struct;                    /* Input of RPCs */
+    perf_rpc_lat_in_t rpc_in;           /* Input of RPC mode */
+    bulk_write_in_t bulk_in;            /* Input of bulk modes */
+    hg_bulk_t bulk_handle;              /* Bulk handle of bulk modes */
+    char **bufs;                        /* Payload / bulk segments */
+    hg_size_t *buf_sizes;               /* Sizes of bulk segments */
+    hg_atomic_int32_t posted;           /* Number of operations posted */
+    hg_atomic_int32_t completed;        /* Number of operations completed */
+    hg_atomic_int32_t error;            /* Operation failed */
+    hg_util_int32_t op_count;           /* Number of operations to run */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static void
+hg_bench_usage(const char *execname);
+
+static int
+hg_bench_parse_range(const char *arg, struct hg_bench_range *range);
+
+static int
+hg_bench_parse_options(
+    int argc, char *argv[], struct hg_bench_options *hg_bench_options);
+
+static hg_bool_t
+hg_bench_point_next(const struct hg_bench_options *hg_bench_options,
+    struct hg_bench_point *point);
+
+static const char *
+hg_bench_mode_to_string(unsigned int mode);
+
+static double
+hg_bench_cpu_time(void);
+
+static hg_return_t
+hg_bench_thread_init(struct hg_bench_thread *hg_bench_thread,
+    struct hg_test_info *hg_test_info, const struct hg_bench_point *point,
+    unsigned int index);
+
+static void
+hg_bench_thread_finalize(struct hg_bench_thread *hg_bench_thread);
+
+static hg_return_t
+hg_bench_forward(struct hg_bench_slot *hg_bench_slot);
+
+static hg_return_t
+hg_bench_forward_cb(const struct hg_cb_info *callback_info);
+
+static HG_THREAD_RETURN_TYPE
+hg_bench_thread_cb(void *arg);
+
+static void
+hg_bench_thread_run(struct hg_bench_thread *hg_bench_thread);
+
+static hg_return_t
+hg_bench_run(struct hg_bench_thread *hg_bench_threads, unsigned int count,
+    unsigned long ops, struct hg_histogram *histogram, double *time);
+
+static hg_return_t
+hg_bench_measure(struct hg_test_info *hg_test_info, unsigned long ops,
+    const struct hg_bench_point *point, struct hg_histogram *histogram,
+    struct hg_bench_result *result);
+
+static void
+hg_bench_print_header(FILE *file, hg_bench_format_t format,
+    const struct hg_test_info *hg_test_info);
+
+static void
+hg_bench_print_result(FILE *file, hg_bench_format_t format,
+    const struct hg_bench_result *result, hg_bool_t first);
+
+static void
+hg_bench_print_footer(FILE *file, hg_bench_format_t format);
+
+static unsigned int
+hg_bench_compare(const struct hg_bench_options *hg_bench_options,
+    const struct hg_bench_result *results, unsigned int count);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+extern hg_id_t hg_test_perf_rpc_id_g;
+extern hg_id_t hg_test_perf_rpc_lat_id_g;
+extern hg_id_t hg_test_perf_bulk_write_id_g;
+extern hg_id_t hg_test_perf_bulk_read_id_g;
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_usage(const char *execname)
+{
+    printf("usage: %s [test options] -- [benchmark options]\n", execname);
+    printf("    Ranges are given as N or MIN:MAX, values are swept by powers "
+           "of two\n");
+    printf("    --mode       rpc, write, read or all, comma-separated "
+           "(default: rpc,write)\n");
+    printf("    --size       Message size range in bytes (default: 1:buf_size)"
+           "\n");
+    printf("    --window     Operations in flight per thread (default: "
+           "1:handle)\n");
+    printf("    --threads    Client thread range (default: 1)\n");
+    printf("    --contexts   Context range, at most -C (default: 1)\n");
+    printf("    --segments   Bulk segment range (default: 1)\n");
+    printf("    --ops        Measured operations per point (default: %d)\n",
+        HG_BENCH_OPS_DEFAULT);
+    printf("    --format     text, csv or json (default: text)\n");
+    printf("    --output     Output file (default: stdout)\n");
+    printf("    --baseline   CSV results of a previous run to compare to\n");
+    printf("    --threshold  Regression threshold in percent (default: %.0f)\n",
+        HG_BENCH_THRESHOLD_DEFAULT);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_bench_parse_range(const char *arg, struct hg_bench_range *range)
+{
+    char *end;
+
+    range->min = strtoul(arg, &end, 10);
+    if (end == arg)
+        return HG_UTIL_FAIL;
+    if (*end == ':') {
+        const char *max = end + 1;
+
+        range->max = strtoul(max, &end, 10);
+        if (end == max)
+            return HG_UTIL_FAIL;
+    } else
+        range->max = range->min;
+
+    return (*end == '\0' && range->min <= range->max) ? HG_UTIL_SUCCESS
+                                                      : HG_UTIL_FAIL;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_bench_parse_options(
+    int argc, char *argv[], struct hg_bench_options *hg_bench_options)
+{
+    int i;
+
+    /* Benchmark options start after "--" */
+    for (i = 1; i < argc; i++)
+        if (strcmp(argv[i], "--") == 0)
+            break;
+
+    for (i++; i < argc; i++) {
+        const char *opt = argv[i], *arg = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int rc = HG_UTIL_SUCCESS;
+
+        if (strcmp(opt, "--help") == 0 || strcmp(opt, "-h") == 0)
+            return HG_UTIL_FAIL;
+        if (arg == NULL) {
+            HG_TEST_LOG_ERROR("Missing argument for %s", opt);
+            return HG_UTIL_FAIL;
+        }
+        i++;
+
+        if (strcmp(opt, "--mode") == 0) {
+            hg_bench_options->modes = 0;
+            if (strstr(arg, "rpc"))
+                hg_bench_options->modes |= HG_BENCH_RPC;
+            if (strstr(arg, "write"))
+                hg_bench_options->modes |= HG_BENCH_WRITE;
+            if (strstr(arg, "read"))
+                hg_bench_options->modes |= HG_BENCH_READ;
+            if (strstr(arg, "all"))
+                hg_bench_options->modes =
+                    HG_BENCH_RPC | HG_BENCH_WRITE | HG_BENCH_READ;
+            if (hg_bench_options->modes == 0)
+                rc = HG_UTIL_FAIL;
+        } else if (strcmp(opt, "--size") == 0)
+            rc = hg_bench_parse_range(arg, &hg_bench_options->sizes);
+        else if (strcmp(opt, "--window") == 0)
+            rc = hg_bench_parse_range(arg, &hg_bench_options->windows);
+        else if (strcmp(opt, "--threads") == 0)
+            rc = hg_bench_parse_range(arg, &hg_bench_options->threads);
+        else if (strcmp(opt, "--contexts") == 0)
+            rc = hg_bench_parse_range(arg, &hg_bench_options->contexts);
+        else if (strcmp(opt, "--segments") == 0)
+            rc = hg_bench_parse_range(arg, &hg_bench_options->segments);
+        else if (strcmp(opt, "--ops") == 0)
+            hg_bench_options->ops = strtoul(arg, NULL, 10);
+        else if (strcmp(opt, "--format") == 0) {
+            if (strcmp(arg, "text") == 0)
+                hg_bench_options->format = HG_BENCH_TEXT;
+            else if (strcmp(arg, "csv") == 0)
+                hg_bench_options->format = HG_BENCH_CSV;
+            else if (strcmp(arg, "json") == 0)
+                hg_bench_options->format = HG_BENCH_JSON;
+            else
+                rc = HG_UTIL_FAIL;
+        } else if (strcmp(opt, "--output") == 0)
+            hg_bench_options->output = arg;
+        else if (strcmp(opt, "--baseline") == 0)
+            hg_bench_options->baseline = arg;
+        else if (strcmp(opt, "--threshold") == 0)
+            hg_bench_options->threshold = atof(arg);
+        else
+            rc = HG_UTIL_FAIL;
+
+        if (rc != HG_UTIL_SUCCESS) {
+            HG_TEST_LOG_ERROR("Invalid option %s %s", opt, arg);
+            return HG_UTIL_FAIL;
+        }
+    }
+
+    /* Ranges must not be empty (size and segments are checked by caller) */
+    if (hg_bench_options->windows.min == 0 ||
+        hg_bench_options->threads.min == 0 ||
+        hg_bench_options->contexts.min == 0 ||
+        hg_bench_options->segments.min == 0 || hg_bench_options->ops == 0) {
+        HG_TEST_LOG_ERROR("Window, threads, contexts, segments and ops must be "
+                          "greater than 0");
+        return HG_UTIL_FAIL;
+    }
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bench_point_next(const struct hg_bench_options *hg_bench_options,
+    struct hg_bench_point *point)
+{
+    /* Window varies fastest and size slowest */
+    point->window *= 2;
+    if (point->window <= hg_bench_options->windows.max)
+        return HG_TRUE;
+    point->window = (unsigned int) hg_bench_options->windows.min;
+
+    point->threads *= 2;
+    if (point->threads <= hg_bench_options->threads.max)
+        return HG_TRUE;
+    point->threads = (unsigned int) hg_bench_options->threads.min;
+
+    point->contexts *= 2;
+    if (point->contexts <= hg_bench_options->contexts.max)
+        return HG_TRUE;
+    point->contexts = (unsigned int) hg_bench_options->contexts.min;
+
+    point->segments *= 2;
+    if (point->segments <= hg_bench_options->segments.max)
+        return HG_TRUE;
+    point->segments = (unsigned int) hg_bench_options->segments.min;
+
+    point->size = (point->size > 0) ? point->size * 2 : 1;
+
+    return point->size <= hg_bench_options->sizes.max;
+}
+
+/*---------------------------------------------------------------------------*/
+static const char *
+hg_bench_mode_to_string(unsigned int mode)
+{
+    switch (mode) {
+        case HG_BENCH_RPC:
+            return "rpc";
+        case HG_BENCH_WRITE:
+            return "write";
+        case HG_BENCH_READ:
+            return "read";
+        default:
+            return "unknown";
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static double
+hg_bench_cpu_time(void)
+{
+#ifndef _WIN32
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0.0;
+
+    return (double) usage.ru_utime.tv_sec +
+           (double) usage.ru_utime.tv_usec / 1000000.0 +
+           (double) usage.ru_stime.tv_sec +
+           (double) usage.ru_stime.tv_usec / 1000000.0;
+#else
+    return 0.0;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_thread_init(struct hg_bench_thread *hg_bench_thread,
+    struct hg_test_info *hg_test_info, const struct hg_bench_point *point,
+    unsigned int index)
+{
+    hg_uint8_t context_id = (hg_uint8_t)(index % point->contexts);
+    unsigned int nbufs = (point->mode == HG_BENCH_RPC) ? 1 : point->segments;
+    hg_id_t rpc_id;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    memset(hg_bench_thread, 0, sizeof(*hg_bench_thread));
+    hg_bench_thread->point = point;
+    hg_bench_thread->bulk_handle = HG_BULK_NULL;
+    hg_bench_thread->context =
+        (context_id == 0) ? hg_test_info->context
+                          : hg_test_info->secondary_contexts[context_id - 1];
+    hg_atomic_init32(&hg_bench_thread->posted, 0);
+    hg_atomic_init32(&hg_bench_thread->completed, 0);
+    hg_atomic_init32(&hg_bench_thread->error, 0);
+
+    /* Allocate payload (RPC) or segments (bulk), each segment gets an equal
+     * share of the size and the last one the remainder */
+    hg_bench_thread->bufs = (char **) calloc(nbufs, sizeof(char *));
+    hg_bench_thread->buf_sizes = (hg_size_t *) calloc(nbufs, sizeof(hg_size_t));
+    HG_TEST_CHECK_ERROR(
+        hg_bench_thread->bufs == NULL || hg_bench_thread->buf_sizes == NULL,
+        error, ret, HG_NOMEM_ERROR, "Could not allocate buffers");
+    for (i = 0; i < nbufs; i++) {
+        hg_size_t offset = (hg_size_t) i * (point->size / nbufs), j;
+
+        hg_bench_thread->buf_sizes[i] = (i + 1 < nbufs)
+                                            ? point->size / nbufs
+                                            : point->size - offset;
+        if (hg_bench_thread->buf_sizes[i] == 0)
+            continue;
+        hg_bench_thread->bufs[i] =
+            (char *) malloc(hg_bench_thread->buf_sizes[i]);
+        HG_TEST_CHECK_ERROR(hg_bench_thread->bufs[i] == NULL, error, ret,
+            HG_NOMEM_ERROR, "Could not allocate buffer");
+
+        /* Server checks data against its offset when verifying data */
+        for (j = 0; j < hg_bench_thread->buf_sizes[i]; j++)
+            hg_bench_thread->bufs[i][j] = (char) (offset + j);
+    }
+
+    /* Fill input */
+    if (point->mode == HG_BENCH_RPC) {
+        /* Message size includes the payload size field */
+        hg_bench_thread->rpc_in.buf = hg_bench_thread->bufs[0];
+        hg_bench_thread->rpc_in.buf_size =
+            (point->size > sizeof(hg_bench_thread->rpc_in.buf_size))
+                ? (hg_uint32_t)(
+                      point->size - sizeof(hg_bench_thread->rpc_in.buf_size))
+                : 0;
+        hg_bench_thread->in_struct = &hg_bench_thread->rpc_in;
+
+        /* Use NULL RPC to skip proc encoding if size is 0 */
+        rpc_id = (point->size > 0) ? hg_test_perf_rpc_lat_id_g
+                                   : hg_test_perf_rpc_id_g;
+    } else {
+        ret = HG_Bulk_create(hg_test_info->hg_class, nbufs,
+            (void **) hg_bench_thread->bufs, hg_bench_thread->buf_sizes,
+            HG_BULK_READWRITE, &hg_bench_thread->bulk_handle);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_create() failed (%s)",
+            HG_Error_to_string(ret));
+
+        hg_bench_thread->bulk_in.fildes = 0;
+        hg_bench_thread->bulk_in.bulk_handle = hg_bench_thread->bulk_handle;
+        hg_bench_thread->in_struct = &hg_bench_thread->bulk_in;
+
+        rpc_id = (point->mode == HG_BENCH_WRITE) ? hg_test_perf_bulk_write_id_g
+                                                 : hg_test_perf_bulk_read_id_g;
+    }
+
+    /* Create handles, operations of a thread target the server context that
+     * has the same ID as its local context */
+    hg_bench_thread->slots = (struct hg_bench_slot *) calloc(
+        point->window, sizeof(struct hg_bench_slot));
+    HG_TEST_CHECK_ERROR(hg_bench_thread->slots == NULL, error, ret,
+        HG_NOMEM_ERROR, "Could not allocate slots");
+    for (i = 0; i < point->window; i++) {
+        struct hg_bench_slot *hg_bench_slot = &hg_bench_thread->slots[i];
+
+        hg_bench_slot->thread = hg_bench_thread;
+        ret = HG_Create(hg_bench_thread->context, hg_test_info->target_addr,
+            rpc_id, &hg_bench_slot->handle);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+        if (point->contexts > 1) {
+            ret = HG_Set_target_id(hg_bench_slot->handle, context_id);
+            HG_TEST_CHECK_HG_ERROR(error, ret,
+                "HG_Set_target_id() failed (%s)", HG_Error_to_string(ret));
+        }
+    }
+
+    return HG_SUCCESS;
+
+error:
+    hg_bench_thread_finalize(hg_bench_thread);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_thread_finalize(struct hg_bench_thread *hg_bench_thread)
+{
+    unsigned int nbufs = (hg_bench_thread->point->mode == HG_BENCH_RPC)
+                             ? 1
+                             : hg_bench_thread->point->segments;
+    hg_return_t ret;
+    unsigned int i;
+
+    if (hg_bench_thread->slots) {
+        for (i = 0; i < hg_bench_thread->point->window; i++) {
+            if (hg_bench_thread->slots[i].handle == HG_HANDLE_NULL)
+                continue;
+            ret = HG_Destroy(hg_bench_thread->slots[i].handle);
+            HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+                "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+        }
+        free(hg_bench_thread->slots);
+        hg_bench_thread->slots = NULL;
+    }
+
+    if (hg_bench_thread->bulk_handle != HG_BULK_NULL) {
+        ret = HG_Bulk_free(hg_bench_thread->bulk_handle);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+        hg_bench_thread->bulk_handle = HG_BULK_NULL;
+    }
+
+    if (hg_bench_thread->bufs) {
+        for (i = 0; i < nbufs; i++)
+            free(hg_bench_thread->bufs[i]);
+        free(hg_bench_thread->bufs);
+        hg_bench_thread->bufs = NULL;
+    }
+    free(hg_bench_thread->buf_sizes);
+    hg_bench_thread->buf_sizes = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_forward(struct hg_bench_slot *hg_bench_slot)
+{
+    struct hg_bench_thread *hg_bench_thread = hg_bench_slot->thread;
+    hg_return_t ret;
+
+    hg_time_get_current(&hg_bench_slot->start);
+    ret = HG_Forward(hg_bench_slot->handle, hg_bench_forward_cb, hg_bench_slot,
+        hg_bench_thread->in_struct);
+    HG_TEST_CHECK_ERROR_DONE(
+        ret != HG_SUCCESS, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_forward_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_bench_slot *hg_bench_slot =
+        (struct hg_bench_slot *) callback_info->arg;
+    struct hg_bench_thread *hg_bench_thread = hg_bench_slot->thread;
+    hg_time_t now;
+
+    hg_time_get_current(&now);
+
+    if (callback_info->ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Error in HG callback (%s)",
+            HG_Error_to_string(callback_info->ret));
+        hg_atomic_set32(&hg_bench_thread->error, 1);
+    } else if (hg_bench_thread->histogram)
+        hg_histogram_record(hg_bench_thread->histogram,
+            (hg_util_uint64_t)(
+                hg_time_to_double(hg_time_subtract(now, hg_bench_slot->start)) *
+                1000000000.0));
+
+    /* Keep the window full until all operations are posted */
+    if (!hg_atomic_get32(&hg_bench_thread->error) &&
+        hg_atomic_incr32(&hg_bench_thread->posted) <=
+            hg_bench_thread->op_count &&
+        hg_bench_forward(hg_bench_slot) != HG_SUCCESS)
+        hg_atomic_set32(&hg_bench_thread->error, 1);
+
+    /* Count completion last, thread state is reset once all operations
+     * have completed */
+    hg_atomic_incr32(&hg_bench_thread->completed);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_bench_thread_cb(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+
+    hg_bench_thread_run((struct hg_bench_thread *) arg);
+
+    return thread_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_thread_run(struct hg_bench_thread *hg_bench_thread)
+{
+    unsigned int i;
+
+    /* Fill window */
+    for (i = 0; i < hg_bench_thread->point->window; i++) {
+        if (hg_atomic_incr32(&hg_bench_thread->posted) >
+            hg_bench_thread->op_count)
+            break;
+        if (hg_bench_forward(&hg_bench_thread->slots[i]) != HG_SUCCESS) {
+            hg_atomic_set32(&hg_bench_thread->error, 1);
+            return;
+        }
+    }
+
+    /* Callbacks re-forward handles, several threads may share a context and
+     * trigger callbacks of other threads */
+    while (hg_atomic_get32(&hg_bench_thread->completed) <
+               hg_bench_thread->op_count &&
+           !hg_atomic_get32(&hg_bench_thread->error)) {
+        unsigned int actual_count = 0;
+        hg_return_t ret;
+
+        do {
+            ret = HG_Trigger(hg_bench_thread->context, 0, 1, &actual_count);
+        } while (ret == HG_SUCCESS && actual_count > 0);
+
+        if (hg_atomic_get32(&hg_bench_thread->completed) >=
+            hg_bench_thread->op_count)
+            break;
+
+        ret = HG_Progress(hg_bench_thread->context, HG_BENCH_PROGRESS_TIMEOUT);
+        if (ret != HG_SUCCESS && ret != HG_TIMEOUT) {
+            HG_TEST_LOG_ERROR(
+                "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+            hg_atomic_set32(&hg_bench_thread->error, 1);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_run(struct hg_bench_thread *hg_bench_threads, unsigned int count,
+    unsigned long ops, struct hg_histogram *histogram, double *time)
+{
+    hg_time_t t1, t2;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    /* Split operations between threads */
+    for (i = 0; i < count; i++) {
+        hg_bench_threads[i].histogram = histogram;
+        hg_bench_threads[i].op_count =
+            (hg_util_int32_t)(ops / count + ((i < ops % count) ? 1 : 0));
+        hg_atomic_set32(&hg_bench_threads[i].posted, 0);
+        hg_atomic_set32(&hg_bench_threads[i].completed, 0);
+    }
+
+    hg_time_get_current(&t1);
+
+    /* Calling thread runs the first thread */
+    for (i = 1; i < count; i++) {
+        int rc = hg_thread_create(&hg_bench_threads[i].thread,
+            hg_bench_thread_cb, &hg_bench_threads[i]);
+        HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOMEM_ERROR,
+            "hg_thread_create() failed");
+    }
+    hg_bench_thread_run(&hg_bench_threads[0]);
+
+done:
+    while (--i > 0)
+        hg_thread_join(hg_bench_threads[i].thread);
+
+    hg_time_get_current(&t2);
+    *time = hg_time_to_double(hg_time_subtract(t2, t1));
+
+    for (i = 0; i < count; i++)
+        if (hg_atomic_get32(&hg_bench_threads[i].error))
+            ret = HG_PROTOCOL_ERROR;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_measure(struct hg_test_info *hg_test_info, unsigned long ops,
+    const struct hg_bench_point *point, struct hg_histogram *histogram,
+    struct hg_bench_result *result)
+{
+    struct hg_bench_thread *hg_bench_threads;
+    unsigned long warmup_ops = (ops / 10 > point->window * point->threads)
+                                   ? ops / 10
+                                   : point->window * point->threads;
+    double cpu_time, time;
+    unsigned int i, init_count = 0;
+    hg_return_t ret;
+
+    hg_bench_threads = (struct hg_bench_thread *) calloc(
+        point->threads, sizeof(struct hg_bench_thread));
+    HG_TEST_CHECK_ERROR(hg_bench_threads == NULL, done, ret, HG_NOMEM_ERROR,
+        "Could not allocate threads");
+
+    for (init_count = 0; init_count < point->threads; init_count++) {
+        ret = hg_bench_thread_init(&hg_bench_threads[init_count], hg_test_info,
+            point, init_count);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not initialize thread");
+    }
+
+    /* Warm up */
+    ret = hg_bench_run(
+        hg_bench_threads, point->threads, warmup_ops, NULL, &time);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not warm up");
+
+    NA_Test_barrier(&hg_test_info->na_test_info);
+
+    /* Measure */
+    hg_histogram_init(histogram);
+    cpu_time = hg_bench_cpu_time();
+    ret = hg_bench_run(hg_bench_threads, point->threads, ops, histogram, &time);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not run benchmark");
+    cpu_time = hg_bench_cpu_time() - cpu_time;
+
+    result->point = *point;
+    result->ops = ops;
+    result->time = time;
+    result->rate = (double) ops / time;
+    result->bandwidth = result->rate * (double) point->size / HG_BENCH_MB;
+    result->p50 = (double) hg_histogram_percentile(histogram, 50.0) / 1000.0;
+    result->p99 = (double) hg_histogram_percentile(histogram, 99.0) / 1000.0;
+    result->p999 = (double) hg_histogram_percentile(histogram, 99.9) / 1000.0;
+    result->cpu_per_op = cpu_time * 1000000.0 / (double) ops;
+
+done:
+    for (i = 0; i < init_count; i++)
+        hg_bench_thread_finalize(&hg_bench_threads[i]);
+    free(hg_bench_threads);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_print_header(FILE *file, hg_bench_format_t format,
+    const struct hg_test_info *hg_test_info)
+{
+    switch (format) {
+        case HG_BENCH_TEXT:
+            fprintf(file, "# %s v%s (%s+%s, %d client(s))\n", BENCHMARK_NAME,
+                VERSION_NAME, hg_test_info->na_test_info.comm,
+                hg_test_info->na_test_info.protocol,
+                hg_test_info->na_test_info.mpi_comm_size);
+#ifdef HG_TEST_HAS_VERIFY_DATA
+            fprintf(file, "# WARNING verifying data, output will be slower\n");
+#endif
+            fprintf(file, "%-7s%10s%7s%8s%5s%5s%13s%11s%10s%10s%10s%10s\n",
+                "# Mode", "Size", "Win", "Thr", "Ctx", "Seg", "Rate (op/s)",
+                "BW (MB/s)", "p50 (us)", "p99 (us)", "p999 (us)", "CPU (us)");
+            break;
+        case HG_BENCH_CSV:
+            fprintf(file,
+                "mode,size,window,threads,contexts,segments,ops,time_s,"
+                "ops_per_s,mb_per_s,p50_us,p99_us,p999_us,cpu_us_per_op,"
+                "version\n");
+            break;
+        case HG_BENCH_JSON:
+            fprintf(file,
+                "{\n  \"benchmark\": \"%s\",\n  \"version\": \"%s\",\n"
+                "  \"comm\": \"%s\",\n  \"protocol\": \"%s\",\n"
+                "  \"clients\": %d,\n  \"results\": [",
+                BENCHMARK_NAME, VERSION_NAME, hg_test_info->na_test_info.comm,
+                hg_test_info->na_test_info.protocol,
+                hg_test_info->na_test_info.mpi_comm_size);
+            break;
+        default:
+            break;
+    }
+    fflush(file);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_print_result(FILE *file, hg_bench_format_t format,
+    const struct hg_bench_result *result, hg_bool_t first)
+{
+    const struct hg_bench_point *point = &result->point;
+
+    switch (format) {
+        case HG_BENCH_TEXT:
+            fprintf(file,
+                "%-7s%10lu%7u%8u%5u%5u%13.2f%11.2f%10.2f%10.2f%10.2f%10.2f\n",
+                hg_bench_mode_to_string(point->mode), point->size,
+                point->window, point->threads, point->contexts,
+                point->segments, result->rate, result->bandwidth, result->p50,
+                result->p99, result->p999, result->cpu_per_op);
+            break;
+        case HG_BENCH_CSV:
+            fprintf(file, "%s,%lu,%u,%u,%u,%u,%lu,%f,%f,%f,%f,%f,%f,%f,%s\n",
+                hg_bench_mode_to_string(point->mode), point->size,
+                point->window, point->threads, point->contexts,
+                point->segments, result->ops, result->time, result->rate,
+                result->bandwidth, result->p50, result->p99, result->p999,
+                result->cpu_per_op, VERSION_NAME);
+            break;
+        case HG_BENCH_JSON:
+            fprintf(file,
+                "%s\n    {\"mode\": \"%s\", \"size\": %lu, \"window\": %u, "
+                "\"threads\": %u, \"contexts\": %u, \"segments\": %u, "
+                "\"ops\": %lu, \"time_s\": %f, \"ops_per_s\": %f, "
+                "\"mb_per_s\": %f, \"p50_us\": %f, \"p99_us\": %f, "
+                "\"p999_us\": %f, \"cpu_us_per_op\": %f}",
+                first ? "" : ",", hg_bench_mode_to_string(point->mode),
+                point->size, point->window, point->threads, point->contexts,
+                point->segments, result->ops, result->time, result->rate,
+                result->bandwidth, result->p50, result->p99, result->p999,
+                result->cpu_per_op);
+            break;
+        default:
+            break;
+    }
+    fflush(file);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_print_footer(FILE *file, hg_bench_format_t format)
+{
+    if (format == HG_BENCH_JSON)
+        fprintf(file, "\n  ]\n}\n");
+    fflush(file);
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_bench_compare(const struct hg_bench_options *hg_bench_options,
+    const struct hg_bench_result *results, unsigned int count)
+{
+    char line[HG_BENCH_LINE];
+    unsigned int regression_count = 0;
+    FILE *file;
+
+    file = fopen(hg_bench_options->baseline, "r");
+    if (file == NULL) {
+        HG_TEST_LOG_ERROR(
+            "Could not open baseline %s", hg_bench_options->baseline);
+        return 1;
+    }
+
+    /* Compare rate and p99 latency of points that are in both runs */
+    while (fgets(line, sizeof(line), file)) {
+        char mode[16], version[64];
+        struct hg_bench_point point;
+        unsigned long ops;
+        double time, rate, bandwidth, p50, p99, p999, cpu_per_op;
+        unsigned int i;
+
+        if (sscanf(line,
+                "%15[^,],%lu,%u,%u,%u,%u,%lu,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%63s",
+                mode, &point.size, &point.window, &point.threads,
+                &point.contexts, &point.segments, &ops, &time, &rate,
+                &bandwidth, &p50, &p99, &p999, &cpu_per_op, version) != 15)
+            continue; /* Header */
+
+        for (i = 0; i < count; i++) {
+            const struct hg_bench_result *result = &results[i];
+            double rate_diff, p99_diff;
+
+            if (strcmp(mode, hg_bench_mode_to_string(result->point.mode)) ||
+                point.size != result->point.size ||
+                point.window != result->point.window ||
+                point.threads != result->point.threads ||
+                point.contexts != result->point.contexts ||
+                point.segments != result->point.segments)
+                continue;
+
+            rate_diff = (rate > 0.0) ? (result->rate - rate) * 100.0 / rate
+                                     : 0.0;
+            p99_diff = (p99 > 0.0) ? (result->p99 - p99) * 100.0 / p99 : 0.0;
+            if (rate_diff < -hg_bench_options->threshold ||
+                p99_diff > hg_bench_options->threshold) {
+                fprintf(stderr,
+                    "# Regression vs v%s: %s size=%lu window=%u threads=%u "
+                    "contexts=%u segments=%u rate %+.1f%% p99 %+.1f%%\n",
+                    version, mode, point.size, point.window, point.threads,
+                    point.contexts, point.segments, rate_diff, p99_diff);
+                regression_count++;
+            }
+            break;
+        }
+    }
+    fclose(file);
+
+    return regression_count;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = {0};
+    struct hg_bench_options hg_bench_options = {{1, 0}, {1, 0}, {1, 1},
+        {1, 1}, {1, 1}, 0, HG_BENCH_RPC | HG_BENCH_WRITE, HG_BENCH_TEXT, NULL,
+        NULL, HG_BENCH_THRESHOLD_DEFAULT};
+    struct hg_bench_result *results = NULL;
+    struct hg_histogram *histogram = NULL;
+    unsigned int result_count = 0, result_max = 0, mode;
+    unsigned long context_max = 1;
+    hg_bool_t print;
+    FILE *file = stdout;
+    hg_return_t hg_ret;
+    int ret = EXIT_SUCCESS;
+
+    hg_ret = HG_Test_init(argc, argv, &hg_test_info);
+    HG_TEST_CHECK_ERROR(
+        hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "HG_Test_init() failed");
+    print = (hg_test_info.na_test_info.mpi_comm_rank == 0);
+    if (hg_test_info.na_test_info.max_contexts > 1)
+        context_max = hg_test_info.na_test_info.max_contexts;
+
+    /* Defaults depend on test options */
+    hg_bench_options.sizes.max = hg_test_info.buf_size_max;
+    hg_bench_options.windows.max = hg_test_info.handle_max;
+    hg_bench_options.ops =
+        (unsigned long) hg_test_info.na_test_info.loop * HG_BENCH_OPS_DEFAULT;
+    if (hg_bench_parse_options(argc, argv, &hg_bench_options) !=
+        HG_UTIL_SUCCESS) {
+        if (print)
+            hg_bench_usage(argv[0]);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (hg_bench_options.contexts.max > context_max) {
+        HG_TEST_LOG_WARNING(
+            "Limiting number of contexts to %lu (use -C)", context_max);
+        hg_bench_options.contexts.max = context_max;
+        if (hg_bench_options.contexts.min > context_max)
+            hg_bench_options.contexts.min = context_max;
+    }
+    if (hg_bench_options.sizes.max > hg_test_info.buf_size_max) {
+        HG_TEST_LOG_WARNING("Limiting size to %zu (use -z)",
+            (size_t) hg_test_info.buf_size_max);
+        hg_bench_options.sizes.max = hg_test_info.buf_size_max;
+    }
+
+    if (hg_bench_options.output && print) {
+        file = fopen(hg_bench_options.output, "w");
+        HG_TEST_CHECK_ERROR(file == NULL, done, ret, EXIT_FAILURE,
+            "Could not open %s", hg_bench_options.output);
+    }
+
+    histogram = (struct hg_histogram *) malloc(sizeof(*histogram));
+    HG_TEST_CHECK_ERROR(histogram == NULL, done, ret, EXIT_FAILURE,
+        "Could not allocate histogram");
+
+    if (print)
+        hg_bench_print_header(file, hg_bench_options.format, &hg_test_info);
+
+    for (mode = HG_BENCH_RPC; mode <= HG_BENCH_READ; mode <<= 1) {
+        struct hg_bench_point point = {mode,
+            hg_bench_options.sizes.min,
+            (unsigned int) hg_bench_options.windows.min,
+            (unsigned int) hg_bench_options.threads.min,
+            (unsigned int) hg_bench_options.contexts.min,
+            (unsigned int) hg_bench_options.segments.min};
+
+        if (!(hg_bench_options.modes & mode))
+            continue;
+
+        do {
+            unsigned long ops = (point.size > LARGE_SIZE)
+                                    ? hg_bench_options.ops / 10
+                                    : hg_bench_options.ops;
+
+            /* Segments only apply to bulk modes and need one byte each */
+            if ((mode == HG_BENCH_RPC && point.segments > 1) ||
+                (mode != HG_BENCH_RPC && point.size < point.segments))
+                continue;
+            if (ops < point.threads)
+                ops = point.threads;
+
+            if (result_count == result_max) {
+                struct hg_bench_result *new_results;
+
+                result_max = result_max ? result_max * 2 : 64;
+                new_results = (struct hg_bench_result *) realloc(
+                    results, result_max * sizeof(*results));
+                HG_TEST_CHECK_ERROR(new_results == NULL, done, ret,
+                    EXIT_FAILURE, "Could not allocate results");
+                results = new_results;
+            }
+
+            hg_ret = hg_bench_measure(&hg_test_info, ops, &point, histogram,
+                &results[result_count]);
+            HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+                "hg_bench_measure() failed");
+
+            if (print)
+                hg_bench_print_result(file, hg_bench_options.format,
+                    &results[result_count], result_count == 0);
+            result_count++;
+        } while (hg_bench_point_next(&hg_bench_options, &point));
+    }
+
+    if (print) {
+        hg_bench_print_footer(file, hg_bench_options.format);
+
+        if (hg_bench_options.baseline &&
+            hg_bench_compare(&hg_bench_options, results, result_count) > 0)
+            ret = EXIT_FAILURE;
+    }
+
+done:
+    if (file != stdout && file != NULL)
+        fclose(file);
+    free(histogram);
+    free(results);
+
+    hg_ret = HG_Test_finalize(&hg_test_info);
+    HG_TEST_CHECK_ERROR_DONE(hg_ret != HG_SUCCESS, "HG_Test_finalize() failed");
+
+    return ret;
+}
@@ -12,11 +12,18 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /****************/
 /* Local Macros */
 /****************/
 
+/* Strided layout: 4 blocks of 24 bytes every 40 bytes, repeated every 176 */
+#define HG_TEST_BULK_STRIDED_BLOCK  (24)
+#define HG_TEST_BULK_STRIDED_COUNT  (4)
+#define HG_TEST_BULK_STRIDED_STRIDE (40)
+#define HG_TEST_BULK_STRIDED_GROUP  (176)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -34,11 +41,15 @@ struct forward_cb_args {
 static hg_return_t
 hg_test_bulk_forward_cb(const struct hg_cb_info *callback_info);
 
+static hg_return_t
+hg_test_bulk_atomic_forward_cb(const struct hg_cb_info *callback_info);
+
 /*******************/
 /* Local Variables */
 /*******************/
 
 extern hg_id_t hg_test_bulk_write_id_g;
+extern hg_id_t hg_test_bulk_prefetch_id_g;
 extern hg_id_t hg_test_bulk_bind_write_id_g;
 extern hg_id_t hg_test_bulk_bind_forward_id_g;
 
@@ -78,6 +89,34 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_atomic_forward_cb(const struct hg_cb_info *callback_info)
+{
+    hg_handle_t handle = callback_info->info.forward.handle;
+    struct forward_cb_args *args =
+        (struct forward_cb_args *) callback_info->arg;
+    bulk_write_out_t bulk_write_out_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_TEST_CHECK_ERROR_NORET(callback_info->ret != HG_SUCCESS, done,
+        "Error in HG callback (%s)", HG_Error_to_string(callback_info->ret));
+
+    /* Previous value replaces expected bytes */
+    ret = HG_Get_output(handle, &bulk_write_out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_output() failed (%s)", HG_Error_to_string(ret));
+    args->expected_bytes = bulk_write_out_struct.ret;
+
+    ret = HG_Free_output(handle, &bulk_write_out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Free_output() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    hg_request_complete(args->request);
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_bulk_bind_forward_cb(const struct hg_cb_info *callback_info)
@@ -192,8 +231,8 @@ done:
 static hg_return_t
 hg_test_bulk_contig(hg_class_t *hg_class, hg_context_t *context,
     hg_request_class_t *request_class, hg_bool_t bind_addr, hg_bool_t forward,
-    hg_addr_t target_addr, hg_size_t bulk_size, hg_size_t transfer_size,
-    hg_size_t origin_offset, hg_size_t target_offset)
+    hg_bool_t mem_alloc, hg_addr_t target_addr, hg_size_t bulk_size,
+    hg_size_t transfer_size, hg_size_t origin_offset, hg_size_t target_offset)
 {
     hg_request_t *request = NULL;
     hg_handle_t handle;
@@ -212,7 +251,8 @@ hg_test_bulk_contig(hg_class_t *hg_class, hg_context_t *context,
         HG_OVERFLOW, "Exceeding bulk size");
 
     /* Prepare bulk_buf */
-    bulk_buf = malloc(bulk_size);
+    bulk_buf = (mem_alloc) ? HG_Mem_alloc(hg_class, bulk_size)
+                           : malloc(bulk_size);
     HG_TEST_CHECK_ERROR(bulk_buf == NULL, done, ret, HG_NOMEM_ERROR,
         "Could not allocate bulk_buf");
 
@@ -288,7 +328,12 @@ done:
     hg_request_destroy(request);
 
     /* Free bulk data */
-    free(bulk_buf);
+    if (mem_alloc) {
+        cleanup_ret = HG_Mem_free(hg_class, bulk_buf);
+        HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+            "HG_Mem_free() failed (%s)", HG_Error_to_string(cleanup_ret));
+    } else
+        free(bulk_buf);
 
     return ret;
 }
@@ -298,20 +343,29 @@ static hg_return_t
 hg_test_bulk_seg(hg_class_t *hg_class, hg_context_t *context,
     hg_request_class_t *request_class, hg_addr_t target_addr,
     hg_size_t bulk_size, hg_size_t transfer_size, hg_size_t origin_offset,
-    hg_size_t target_offset, hg_uint32_t origin_segment_count)
+    hg_size_t target_offset, hg_uint32_t origin_segment_count,
+    hg_bool_t packed, hg_size_t view_offset, hg_int32_t fildes)
 {
     hg_request_t *request = NULL;
     hg_handle_t handle;
-    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    hg_bulk_t bulk_handle = HG_BULK_NULL, view_handle = HG_BULK_NULL;
     hg_return_t ret = HG_SUCCESS, cleanup_ret;
     struct forward_cb_args forward_cb_args;
     bulk_write_in_t bulk_write_in_struct;
     void **buf_ptrs = NULL;
     hg_size_t *buf_sizes = NULL;
+    char *bulk_buf = NULL;
     size_t i;
 
-    HG_TEST_CHECK_ERROR(origin_offset + transfer_size > bulk_size, done, ret,
-        HG_OVERFLOW, "Exceeding bulk size");
+    HG_TEST_CHECK_ERROR(view_offset + origin_offset + transfer_size > bulk_size,
+        done, ret, HG_OVERFLOW, "Exceeding bulk size");
+
+    /* Packed segments are carved out of a single buffer */
+    if (packed) {
+        bulk_buf = malloc(bulk_size);
+        HG_TEST_CHECK_ERROR(bulk_buf == NULL, done, ret, HG_NOMEM_ERROR,
+            "Could not allocate bulk_buf");
+    }
 
     /* Prepare bulk_buf */
     buf_ptrs = (void **) malloc(origin_segment_count * sizeof(void *));
@@ -326,12 +380,15 @@ hg_test_bulk_seg(hg_class_t *hg_class, hg_context_t *context,
         hg_size_t j;
 
         buf_sizes[i] = bulk_size / origin_segment_count;
-        buf_ptrs[i] = malloc(buf_sizes[i]);
+        buf_ptrs[i] =
+            (packed) ? bulk_buf + i * buf_sizes[i] : malloc(buf_sizes[i]);
         HG_TEST_CHECK_ERROR(buf_ptrs == NULL, done, ret, HG_NOMEM_ERROR,
             "Could not allocate bulk_buf");
 
+        /* Data of views starts with value 0 */
         for (j = 0; j < buf_sizes[i]; j++) {
-            ((char **) buf_ptrs)[i][j] = (char) (i * buf_sizes[i] + j);
+            ((char **) buf_ptrs)[i][j] =
+                (char) (i * buf_sizes[i] + j - view_offset);
         }
     }
 
@@ -347,12 +404,21 @@ hg_test_bulk_seg(hg_class_t *hg_class, hg_context_t *context,
     HG_TEST_CHECK_HG_ERROR(
         done, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
 
+    /* Expose window of handle */
+    if (view_offset > 0) {
+        ret = HG_Bulk_create_view(
+            bulk_handle, view_offset, bulk_size - view_offset, &view_handle);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Bulk_create_view() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
     /* Fill input structure */
-    bulk_write_in_struct.fildes = 0;
+    bulk_write_in_struct.fildes = fildes;
     bulk_write_in_struct.transfer_size = transfer_size;
     bulk_write_in_struct.origin_offset = origin_offset;
     bulk_write_in_struct.target_offset = target_offset;
-    bulk_write_in_struct.bulk_handle = bulk_handle;
+    bulk_write_in_struct.bulk_handle =
+        (view_offset > 0) ? view_handle : bulk_handle;
     HG_TEST_LOG_DEBUG("Requesting transfer_size=%zu, origin_offset=%zu, "
                       "target_offset=%zu",
         bulk_write_in_struct.transfer_size, bulk_write_in_struct.origin_offset,
@@ -375,11 +441,15 @@ hg_test_bulk_seg(hg_class_t *hg_class, hg_context_t *context,
     ret = forward_cb_args.ret;
 
 done:
-    /* Free memory handle */
+    /* Free memory handles (parent is released with the view) */
     cleanup_ret = HG_Bulk_free(bulk_handle);
     HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
         "HG_Bulk_free() failed (%s)", HG_Error_to_string(cleanup_ret));
 
+    cleanup_ret = HG_Bulk_free(view_handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Bulk_free() failed (%s)", HG_Error_to_string(cleanup_ret));
+
     cleanup_ret = HG_Destroy(handle);
     HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
         "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
@@ -388,15 +458,414 @@ done:
 
     /* Free bulk data */
     if (buf_ptrs) {
-        for (i = 0; i < origin_segment_count; i++)
+        for (i = 0; i < origin_segment_count && !packed; i++)
             free(buf_ptrs[i]);
         free(buf_ptrs);
     }
     free(buf_sizes);
+    free(bulk_buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_strided(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t target_addr,
+    hg_size_t bulk_size, hg_size_t transfer_size, hg_size_t origin_offset,
+    hg_size_t target_offset)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle;
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    struct forward_cb_args forward_cb_args;
+    bulk_write_in_t bulk_write_in_struct;
+    struct hg_bulk_stride strides[2];
+    hg_size_t group_len =
+        HG_TEST_BULK_STRIDED_BLOCK * HG_TEST_BULK_STRIDED_COUNT;
+    hg_size_t group_count = bulk_size / group_len, extent;
+    char *bulk_buf = NULL;
+    size_t i;
+
+    HG_TEST_CHECK_ERROR(
+        origin_offset + transfer_size > group_count * group_len, done, ret,
+        HG_OVERFLOW, "Exceeding bulk size");
+
+    /* Blocks are interleaved with data that must not be transferred */
+    extent = (group_count - 1) * HG_TEST_BULK_STRIDED_GROUP +
+             (HG_TEST_BULK_STRIDED_COUNT - 1) * HG_TEST_BULK_STRIDED_STRIDE +
+             HG_TEST_BULK_STRIDED_BLOCK;
+    bulk_buf = malloc(extent);
+    HG_TEST_CHECK_ERROR(bulk_buf == NULL, done, ret, HG_NOMEM_ERROR,
+        "Could not allocate bulk_buf");
+    memset(bulk_buf, 0xff, extent);
+
+    for (i = 0; i < group_count * group_len; i++) {
+        size_t block = i / HG_TEST_BULK_STRIDED_BLOCK;
+
+        bulk_buf[(block / HG_TEST_BULK_STRIDED_COUNT) *
+                     HG_TEST_BULK_STRIDED_GROUP +
+                 (block % HG_TEST_BULK_STRIDED_COUNT) *
+                     HG_TEST_BULK_STRIDED_STRIDE +
+                 i % HG_TEST_BULK_STRIDED_BLOCK] = (char) i;
+    }
+
+    request = hg_request_create(request_class);
+
+    ret = HG_Create(context, target_addr, hg_test_bulk_write_id_g, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Register memory */
+    strides[0].count = HG_TEST_BULK_STRIDED_COUNT;
+    strides[0].stride = HG_TEST_BULK_STRIDED_STRIDE;
+    strides[1].count = group_count;
+    strides[1].stride = HG_TEST_BULK_STRIDED_GROUP;
+    ret = HG_Bulk_create_strided(hg_class, bulk_buf, HG_TEST_BULK_STRIDED_BLOCK,
+        strides, 2, HG_BULK_READ_ONLY, &bulk_handle);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Bulk_create_strided() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(
+        HG_Bulk_get_size(bulk_handle) != group_count * group_len, done, ret,
+        HG_FAULT, "Invalid strided bulk size");
+
+    /* Fill input structure */
+    bulk_write_in_struct.fildes = 0;
+    bulk_write_in_struct.transfer_size = transfer_size;
+    bulk_write_in_struct.origin_offset = origin_offset;
+    bulk_write_in_struct.target_offset = target_offset;
+    bulk_write_in_struct.bulk_handle = bulk_handle;
+    HG_TEST_LOG_DEBUG("Requesting transfer_size=%zu, origin_offset=%zu, "
+                      "target_offset=%zu",
+        bulk_write_in_struct.transfer_size, bulk_write_in_struct.origin_offset,
+        bulk_write_in_struct.target_offset);
+
+    /* Forward call to remote addr and get a new request */
+    HG_TEST_LOG_DEBUG(
+        "Forwarding call with op id: %u...", hg_test_bulk_write_id_g);
+    forward_cb_args.request = request;
+    forward_cb_args.expected_bytes = transfer_size;
+    forward_cb_args.ret = HG_SUCCESS;
+    ret = HG_Forward(handle, hg_test_bulk_forward_cb, &forward_cb_args,
+        &bulk_write_in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    /* Assign ret from CB */
+    ret = forward_cb_args.ret;
+
+done:
+    cleanup_ret = HG_Bulk_free(bulk_handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Bulk_free() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    hg_request_destroy(request);
+
+    free(bulk_buf);
 
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_atomic(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t target_addr,
+    hg_uint64_t operand)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle;
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    struct forward_cb_args forward_cb_args;
+    bulk_write_in_t bulk_write_in_struct;
+    hg_uint64_t values[4] = {0, 5, 0, 0};
+    void *buf_ptr = values;
+    hg_size_t buf_size = sizeof(values);
+
+    request = hg_request_create(request_class);
+
+    ret = HG_Create(context, target_addr, hg_test_bulk_write_id_g, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Value is updated by the target */
+    ret = HG_Bulk_create(
+        hg_class, 1, &buf_ptr, &buf_size, HG_BULK_READWRITE, &bulk_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Fill input structure */
+    bulk_write_in_struct.fildes = HG_TEST_BULK_ATOMIC;
+    bulk_write_in_struct.transfer_size = operand;
+    bulk_write_in_struct.origin_offset = sizeof(hg_uint64_t);
+    bulk_write_in_struct.target_offset = 2 * sizeof(hg_uint64_t);
+    bulk_write_in_struct.bulk_handle = bulk_handle;
+
+    forward_cb_args.request = request;
+    forward_cb_args.expected_bytes = 0;
+    forward_cb_args.ret = HG_SUCCESS;
+    ret = HG_Forward(handle, hg_test_bulk_atomic_forward_cb, &forward_cb_args,
+        &bulk_write_in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    /* Assign ret from CB */
+    ret = forward_cb_args.ret;
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Atomic RPC bulk failed");
+    if (forward_cb_args.expected_bytes == (size_t) -1) {
+        HG_TEST_LOG_DEBUG("Atomics not supported by transport, skipping");
+        goto done;
+    }
+    HG_TEST_CHECK_ERROR(forward_cb_args.expected_bytes != 5 ||
+                            values[1] != 5 + operand || values[0] != 0 ||
+                            values[2] != 0,
+        done, ret, HG_FAULT,
+        "Invalid atomic result (previous %zu, value %zu)",
+        forward_cb_args.expected_bytes, (size_t) values[1]);
+
+done:
+    cleanup_ret = HG_Bulk_free(bulk_handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Bulk_free() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    hg_request_destroy(request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_crc(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t target_addr,
+    hg_size_t bulk_size, hg_size_t transfer_size, hg_size_t origin_offset,
+    hg_size_t target_offset)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    struct forward_cb_args forward_cb_args;
+    bulk_write_in_t bulk_write_in_struct;
+    char *bulk_buf = NULL;
+    size_t i;
+
+    /* Prepare bulk_buf */
+    bulk_buf = malloc(bulk_size);
+    HG_TEST_CHECK_ERROR(bulk_buf == NULL, done, ret, HG_NOMEM_ERROR,
+        "Could not allocate bulk_buf");
+    for (i = 0; i < bulk_size; i++)
+        bulk_buf[i] = (char) i;
+
+    request = hg_request_create(request_class);
+
+    ret = HG_Bulk_create(hg_class, 1, (void **) &bulk_buf, &bulk_size,
+        HG_BULK_READ_ONLY, &bulk_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Create(context, target_addr, hg_test_bulk_write_id_g, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Fill input structure */
+    bulk_write_in_struct.fildes = HG_TEST_BULK_CRC;
+    bulk_write_in_struct.transfer_size = transfer_size;
+    bulk_write_in_struct.origin_offset = origin_offset;
+    bulk_write_in_struct.target_offset = target_offset;
+    bulk_write_in_struct.bulk_handle = bulk_handle;
+
+    /* Forward call to remote addr and get a new request */
+    forward_cb_args.request = request;
+    forward_cb_args.expected_bytes = transfer_size;
+    forward_cb_args.ret = HG_SUCCESS;
+    ret = HG_Forward(handle, hg_test_bulk_forward_cb, &forward_cb_args,
+        &bulk_write_in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    /* Assign ret from CB */
+    ret = forward_cb_args.ret;
+
+done:
+    /* Free memory handle */
+    cleanup_ret = HG_Bulk_free(bulk_handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Bulk_free() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    hg_request_destroy(request);
+    free(bulk_buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_prefetch(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t target_addr,
+    hg_size_t bulk_size, hg_size_t transfer_size, hg_size_t origin_offset,
+    hg_size_t target_offset)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    struct forward_cb_args forward_cb_args;
+    bulk_write_in_t bulk_write_in_struct;
+    char *bulk_buf = NULL;
+    size_t i;
+
+    /* Prepare bulk_buf */
+    bulk_buf = malloc(bulk_size);
+    HG_TEST_CHECK_ERROR(bulk_buf == NULL, done, ret, HG_NOMEM_ERROR,
+        "Could not allocate bulk_buf");
+    for (i = 0; i < bulk_size; i++)
+        bulk_buf[i] = (char) i;
+
+    request = hg_request_create(request_class);
+
+    ret = HG_Bulk_create(hg_class, 1, (void **) &bulk_buf, &bulk_size,
+        HG_BULK_READ_ONLY, &bulk_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Create(context, target_addr, hg_test_bulk_prefetch_id_g, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Fill input structure */
+    bulk_write_in_struct.fildes = 0;
+    bulk_write_in_struct.transfer_size = transfer_size;
+    bulk_write_in_struct.origin_offset = origin_offset;
+    bulk_write_in_struct.target_offset = target_offset;
+    bulk_write_in_struct.bulk_handle = bulk_handle;
+
+    /* Forward call to remote addr and get a new request */
+    forward_cb_args.request = request;
+    forward_cb_args.expected_bytes = transfer_size;
+    forward_cb_args.ret = HG_SUCCESS;
+    ret = HG_Forward(handle, hg_test_bulk_forward_cb, &forward_cb_args,
+        &bulk_write_in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    /* Assign ret from CB */
+    ret = forward_cb_args.ret;
+
+done:
+    /* Free memory handle */
+    cleanup_ret = HG_Bulk_free(bulk_handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Bulk_free() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    hg_request_destroy(request);
+    free(bulk_buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifndef HG_HAS_XDR
+static hg_return_t
+hg_test_bulk_codec(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t target_addr,
+    hg_size_t bulk_size, hg_size_t chunk_size)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    struct forward_cb_args forward_cb_args;
+    bulk_write_in_t bulk_write_in_struct;
+    char *bulk_buf = NULL;
+    size_t i;
+
+    /* Prepare bulk_buf */
+    bulk_buf = malloc(bulk_size);
+    HG_TEST_CHECK_ERROR(bulk_buf == NULL, done, ret, HG_NOMEM_ERROR,
+        "Could not allocate bulk_buf");
+    for (i = 0; i < bulk_size; i++)
+        bulk_buf[i] = HG_TEST_BULK_CODEC_VALUE(i, bulk_size);
+
+    request = hg_request_create(request_class);
+
+    /* Compressed copy is owned by the handle */
+    ret = HG_Bulk_create_compressed(hg_class, &hg_test_rle_codec_g, bulk_buf,
+        bulk_size, chunk_size, 0, &bulk_handle);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Bulk_create_compressed() failed (%s)",
+        HG_Error_to_string(ret));
+    free(bulk_buf);
+    bulk_buf = NULL;
+    HG_TEST_CHECK_ERROR(HG_Bulk_get_size(bulk_handle) >= bulk_size, done, ret,
+        HG_FAULT, "Data was not compressed (%zu >= %zu)",
+        (size_t) HG_Bulk_get_size(bulk_handle), (size_t) bulk_size);
+
+    ret = HG_Create(context, target_addr, hg_test_bulk_write_id_g, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Fill input structure */
+    bulk_write_in_struct.fildes = HG_TEST_BULK_CODEC;
+    bulk_write_in_struct.transfer_size = bulk_size;
+    bulk_write_in_struct.origin_offset = 0;
+    bulk_write_in_struct.target_offset = 0;
+    bulk_write_in_struct.bulk_handle = bulk_handle;
+
+    /* Forward call to remote addr and get a new request */
+    forward_cb_args.request = request;
+    forward_cb_args.expected_bytes = bulk_size;
+    forward_cb_args.ret = HG_SUCCESS;
+    ret = HG_Forward(handle, hg_test_bulk_forward_cb, &forward_cb_args,
+        &bulk_write_in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    /* Assign ret from CB */
+    ret = forward_cb_args.ret;
+
+done:
+    /* Free memory handle */
+    cleanup_ret = HG_Bulk_free(bulk_handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Bulk_free() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    hg_request_destroy(request);
+    free(bulk_buf);
+
+    return ret;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_bulk_small(hg_class_t *hg_class, hg_context_t *context,
@@ -502,8 +971,8 @@ main(int argc, char *argv[])
     /* Zero size RPC bulk test */
     HG_TEST("zero size RPC bulk (size 0, offsets 0, 0)");
     hg_ret = hg_test_bulk_contig(hg_test_info.hg_class, hg_test_info.context,
-        hg_test_info.request_class, 0, 0, hg_test_info.target_addr, buf_size, 0,
-        0, 0);
+        hg_test_info.request_class, 0, 0, 0, hg_test_info.target_addr,
+        buf_size, 0, 0, 0);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "zero size RPC bulk failed");
     HG_PASSED();
@@ -511,16 +980,16 @@ main(int argc, char *argv[])
     /* Simple RPC bulk test */
     HG_TEST("contiguous RPC bulk (size BUFSIZE, offsets 0, 0)");
     hg_ret = hg_test_bulk_contig(hg_test_info.hg_class, hg_test_info.context,
-        hg_test_info.request_class, 0, 0, hg_test_info.target_addr, buf_size,
-        buf_size, 0, 0);
+        hg_test_info.request_class, 0, 0, 0, hg_test_info.target_addr,
+        buf_size, buf_size, 0, 0);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "contiguous RPC bulk failed");
     HG_PASSED();
 
     HG_TEST("contiguous RPC bulk (size BUFSIZE/4, offsets BUFSIZE/2 + 1, 0)");
     hg_ret = hg_test_bulk_contig(hg_test_info.hg_class, hg_test_info.context,
-        hg_test_info.request_class, 0, 0, hg_test_info.target_addr, buf_size,
-        buf_size / 4, buf_size / 2 + 1, 0);
+        hg_test_info.request_class, 0, 0, 0, hg_test_info.target_addr,
+        buf_size, buf_size / 4, buf_size / 2 + 1, 0);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "contiguous RPC bulk failed");
     HG_PASSED();
@@ -528,12 +997,22 @@ main(int argc, char *argv[])
     HG_TEST("contiguous RPC bulk (size BUFSIZE/8, offsets BUFSIZE/2 + 1, "
             "BUFSIZE/4)");
     hg_ret = hg_test_bulk_contig(hg_test_info.hg_class, hg_test_info.context,
-        hg_test_info.request_class, 0, 0, hg_test_info.target_addr, buf_size,
-        buf_size / 8, buf_size / 2 + 1, buf_size / 4);
+        hg_test_info.request_class, 0, 0, 0, hg_test_info.target_addr,
+        buf_size, buf_size / 8, buf_size / 2 + 1, buf_size / 4);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "contiguous RPC bulk failed");
     HG_PASSED();
 
+    /* Pre-registered memory test */
+    HG_TEST("contiguous RPC bulk on registered memory (size BUFSIZE, offsets "
+            "0, 0)");
+    hg_ret = hg_test_bulk_contig(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, 0, 0, 1, hg_test_info.target_addr,
+        buf_size, buf_size, 0, 0);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "contiguous RPC bulk on registered memory failed");
+    HG_PASSED();
+
     /* small bulk test */
     HG_TEST("small segmented RPC bulk (size 8, offsets 0, 0)");
     hg_ret = hg_test_bulk_small(hg_test_info.hg_class, hg_test_info.context,
@@ -559,7 +1038,7 @@ main(int argc, char *argv[])
     HG_TEST("segmented RPC bulk (size BUFSIZE, offsets 0, 0)");
     hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
         hg_test_info.request_class, hg_test_info.target_addr, buf_size,
-        buf_size, 0, 0, 16);
+        buf_size, 0, 0, 16, HG_FALSE, 0, 0);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "segmented RPC bulk failed");
     HG_PASSED();
@@ -567,7 +1046,7 @@ main(int argc, char *argv[])
     HG_TEST("segmented RPC bulk (size BUFSIZE/4, offsets BUFSIZE/2 + 1, 0)");
     hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
         hg_test_info.request_class, hg_test_info.target_addr, buf_size,
-        buf_size / 4, buf_size / 2 + 1, 0, 16);
+        buf_size / 4, buf_size / 2 + 1, 0, 16, HG_FALSE, 0, 0);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "segmented RPC bulk failed");
     HG_PASSED();
@@ -576,16 +1055,77 @@ main(int argc, char *argv[])
             "BUFSIZE/4)");
     hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
         hg_test_info.request_class, hg_test_info.target_addr, buf_size,
-        buf_size / 8, buf_size / 2 + 1, buf_size / 4, 16);
+        buf_size / 8, buf_size / 2 + 1, buf_size / 4, 16, HG_FALSE, 0, 0);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "segmented RPC bulk failed");
     HG_PASSED();
 
+    HG_TEST("segmented RPC bulk view (view offset BUFSIZE/4 + 3, size "
+            "BUFSIZE/4, offsets 5, 0)");
+    hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, buf_size,
+        buf_size / 4, 5, 0, 16, HG_FALSE, buf_size / 4 + 3, 0);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "segmented RPC bulk view failed");
+    HG_PASSED();
+
+    HG_TEST("segmented RPC bulk list (size BUFSIZE/4, offsets BUFSIZE/2 + 1, "
+            "BUFSIZE/8)");
+    hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, buf_size,
+        buf_size / 4, buf_size / 2 + 1, buf_size / 8, 16, HG_FALSE, 0,
+        HG_TEST_BULK_LIST);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "segmented RPC bulk list failed");
+    HG_PASSED();
+
+    HG_TEST("strided RPC bulk (size BUFSIZE/4, offsets BUFSIZE/2 + 1, "
+            "BUFSIZE/8)");
+    hg_ret = hg_test_bulk_strided(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, buf_size,
+        buf_size / 4, buf_size / 2 + 1, buf_size / 8);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "strided RPC bulk failed");
+    HG_PASSED();
+
+    HG_TEST("atomic RPC bulk (fetch-add 3, offsets 8, 16)");
+    hg_ret = hg_test_bulk_atomic(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, 3);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "atomic RPC bulk failed");
+    HG_PASSED();
+
+    HG_TEST("checksummed RPC bulk (size BUFSIZE/2, offsets BUFSIZE/4 + 1, 3)");
+    hg_ret = hg_test_bulk_crc(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, buf_size,
+        buf_size / 2, buf_size / 4 + 1, 3);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "checksummed RPC bulk failed");
+    HG_PASSED();
+
+    HG_TEST("prefetched RPC bulk (size BUFSIZE/4, offsets BUFSIZE/2 + 1, 0)");
+    hg_ret = hg_test_bulk_prefetch(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, buf_size,
+        buf_size / 4, buf_size / 2 + 1, 0);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "prefetched RPC bulk failed");
+    HG_PASSED();
+
+#ifndef HG_HAS_XDR
+    HG_TEST("compressed RPC bulk (size BUFSIZE, chunks BUFSIZE/4 + 7)");
+    hg_ret = hg_test_bulk_codec(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, buf_size,
+        buf_size / 4 + 7);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "compressed RPC bulk failed");
+    HG_PASSED();
+#endif
+
 #ifndef HG_HAS_XDR
     HG_TEST("over-segmented RPC bulk (size BUFSIZE, offsets 0, 0)");
     hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
         hg_test_info.request_class, hg_test_info.target_addr, buf_size,
-        buf_size, 0, 0, 1024);
+        buf_size, 0, 0, 1024, HG_FALSE, 0, 0);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "over-segmented RPC bulk failed");
     HG_PASSED();
@@ -594,7 +1134,7 @@ main(int argc, char *argv[])
         "over-segmented RPC bulk (size BUFSIZE/4, offsets BUFSIZE/2 + 1, 0)");
     hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
         hg_test_info.request_class, hg_test_info.target_addr, buf_size,
-        buf_size / 4, buf_size / 2 + 1, 0, 1024);
+        buf_size / 4, buf_size / 2 + 1, 0, 1024, HG_FALSE, 0, 0);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "over-segmented RPC bulk failed");
     HG_PASSED();
@@ -603,16 +1143,44 @@ main(int argc, char *argv[])
             "BUFSIZE/4)");
     hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
         hg_test_info.request_class, hg_test_info.target_addr, buf_size,
-        buf_size / 8, buf_size / 2 + 1, buf_size / 4, 1024);
+        buf_size / 8, buf_size / 2 + 1, buf_size / 4, 1024, HG_FALSE, 0, 0);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "over-segmented RPC bulk failed");
     HG_PASSED();
+
+    /* Segments share pages and exceed the number of segments that can be
+     * registered at once */
+    HG_TEST("packed over-segmented RPC bulk (size BUFSIZE, offsets 0, 0)");
+    hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, buf_size,
+        buf_size, 0, 0, 4096, HG_TRUE, 0, 0);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "packed over-segmented RPC bulk failed");
+    HG_PASSED();
+
+    HG_TEST("packed over-segmented RPC bulk (size BUFSIZE/8, offsets "
+            "BUFSIZE/2 + 1, BUFSIZE/4)");
+    hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, buf_size,
+        buf_size / 8, buf_size / 2 + 1, buf_size / 4, 4096, HG_TRUE, 0, 0);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "packed over-segmented RPC bulk failed");
+    HG_PASSED();
+
+    HG_TEST("packed over-segmented RPC bulk view (view offset BUFSIZE/2 + 1, "
+            "size BUFSIZE/8, offsets 7, BUFSIZE/4)");
+    hg_ret = hg_test_bulk_seg(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, buf_size,
+        buf_size / 8, 7, buf_size / 4, 4096, HG_TRUE, buf_size / 2 + 1, 0);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "packed over-segmented RPC bulk view failed");
+    HG_PASSED();
 #endif
 
     if (strcmp(HG_Class_get_name(hg_test_info.hg_class), "ofi") == 0) {
         HG_TEST("bind contiguous RPC bulk (size BUFSIZE, offsets 0, 0)");
         hg_ret = hg_test_bulk_contig(hg_test_info.hg_class,
-            hg_test_info.context, hg_test_info.request_class, 1, 0,
+            hg_test_info.context, hg_test_info.request_class, 1, 0, 0,
             hg_test_info.target_addr, buf_size, buf_size, 0, 0);
         HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
             "bind contiguous RPC bulk failed");
@@ -621,7 +1189,7 @@ main(int argc, char *argv[])
         HG_TEST(
             "forward bind contiguous RPC bulk (size BUFSIZE, offsets 0, 0)");
         hg_ret = hg_test_bulk_contig(hg_test_info.hg_class,
-            hg_test_info.context, hg_test_info.request_class, 1, 1,
+            hg_test_info.context, hg_test_info.request_class, 1, 1, 0,
             hg_test_info.target_addr, 3584, 3584 / 4, 0, 0);
         HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
             "bind contiguous RPC bulk failed");
@@ -16,6 +16,30 @@
 /* Dummy function that needs to be shipped */
 /* size_t bulk_write(int fildes, const void *buf, size_t nbyte); */
 
+/* fildes value requesting data to be pulled with HG_Bulk_transfer_list() */
+#define HG_TEST_BULK_LIST (2)
+
+/* fildes value requesting transfer_size to be atomically added to the value
+ * at origin_offset, the previous value is returned ((hg_size_t) -1 if atomics
+ * are not supported) */
+#define HG_TEST_BULK_ATOMIC (3)
+
+/* fildes value requesting a compressed region of transfer_size bytes to be
+ * pulled with HG_Bulk_transfer_decompress() */
+#define HG_TEST_BULK_CODEC (4)
+
+/* Data of compressed regions, the first half is made of runs and compresses,
+ * the second half does not */
+#define HG_TEST_BULK_CODEC_RUN (64)
+#define HG_TEST_BULK_CODEC_VALUE(i, size)                                      \
+    (((i) < (size) / 2) ? (char) ((i) / HG_TEST_BULK_CODEC_RUN) : (char) (i))
+
+/* fildes value requesting data to be pulled with HG_Bulk_transfer_crc32c(),
+ * CRCs are computed by the target from the expected data in chunks of
+ * HG_TEST_BULK_CRC_CHUNK */
+#define HG_TEST_BULK_CRC       (5)
+#define HG_TEST_BULK_CRC_CHUNK (4093)
+
 #ifdef HG_HAS_BOOST
 /* Generate processor and struct for required input/output structs
  * MERCURY_GEN_PROC( struct_type_name, fields )
@@ -9,15 +9,20 @@
  */
 
 #include "mercury_test.h"
+#include "test_rpc.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 /****************/
 /* Local Macros */
 /****************/
 
+/* Large enough to be sent through CMA by NA SM when msg size permits */
+#define HG_TEST_KILL_PAYLOAD_SIZE (32 * 1024)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -35,13 +40,14 @@ hg_test_rpc_forward_killed_cb(const struct hg_cb_info *callback_info);
 
 static hg_return_t
 hg_test_killed_rpc(hg_context_t *context, hg_request_class_t *request_class,
-    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback);
+    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback, void *in_struct);
 
 /*******************/
 /* Local Variables */
 /*******************/
 
 extern hg_id_t hg_test_killed_rpc_id_g;
+extern hg_id_t hg_test_killed_rpc_large_id_g;
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
@@ -65,7 +71,7 @@ done:
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_killed_rpc(hg_context_t *context, hg_request_class_t *request_class,
-    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback)
+    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback, void *in_struct)
 {
     hg_request_t *request = NULL;
     hg_handle_t handle = HG_HANDLE_NULL;
@@ -80,7 +86,7 @@ hg_test_killed_rpc(hg_context_t *context, hg_request_class_t *request_class,
 
     /* Forward call to remote addr and get a new request */
     HG_TEST_LOG_DEBUG("Forwarding RPC, op id: %u...", rpc_id);
-    ret = HG_Forward(handle, callback, request, NULL);
+    ret = HG_Forward(handle, callback, request, in_struct);
     HG_TEST_CHECK_HG_ERROR(
         done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
 
@@ -120,7 +126,7 @@ main(int argc, char *argv[])
         HG_TEST("interrupted RPC");
         hg_ret = hg_test_killed_rpc(hg_test_info.context,
             hg_test_info.request_class, hg_test_info.target_addr,
-            hg_test_killed_rpc_id_g, hg_test_rpc_forward_killed_cb);
+            hg_test_killed_rpc_id_g, hg_test_rpc_forward_killed_cb, NULL);
         HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
             "interrupted RPC test failed");
         HG_PASSED();
@@ -136,7 +142,29 @@ main(int argc, char *argv[])
         HG_TEST("attempt second interrupted RPC");
         hg_ret = hg_test_killed_rpc(hg_test_info.context,
             hg_test_info.request_class, hg_test_info.target_addr,
-            hg_test_killed_rpc_id_g, hg_test_rpc_forward_killed_cb);
+            hg_test_killed_rpc_id_g, hg_test_rpc_forward_killed_cb, NULL);
+        HG_PASSED();
+    }
+
+    if (!hg_test_info.na_test_info.self_send) {
+        rpc_open_in_t in_struct;
+        char *path = NULL;
+
+        /* Payload is not released by the receiver once it has exited */
+        HG_TEST("attempt interrupted RPC with large payload");
+        path = malloc(HG_TEST_KILL_PAYLOAD_SIZE);
+        HG_TEST_CHECK_ERROR(path == NULL, done, ret, EXIT_FAILURE,
+            "Could not allocate payload");
+        memset(path, 'a', HG_TEST_KILL_PAYLOAD_SIZE - 1);
+        path[HG_TEST_KILL_PAYLOAD_SIZE - 1] = '\0';
+        in_struct.path = path;
+        in_struct.handle.cookie = 12345;
+
+        hg_ret = hg_test_killed_rpc(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr,
+            hg_test_killed_rpc_large_id_g, hg_test_rpc_forward_killed_cb,
+            &in_struct);
+        free(path);
         HG_PASSED();
     }
 
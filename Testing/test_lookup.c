@@ -17,6 +17,8 @@
 /* Local Macros */
 /****************/
 
+#define HG_TEST_LOOKUP_BATCH_COUNT 16
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -37,6 +39,12 @@ struct hg_test_thread_args {
 static hg_return_t
 hg_test_rpc_lookup(hg_class_t *hg_class, const char *target_name);
 
+static hg_return_t
+hg_test_rpc_lookup_batch(hg_class_t *hg_class, const char *target_name);
+
+static hg_return_t
+hg_test_addr_serialize_batch(hg_class_t *hg_class, const char *target_name);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -106,6 +114,106 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_lookup_batch(hg_class_t *hg_class, const char *target_name)
+{
+    const char *target_names[HG_TEST_LOOKUP_BATCH_COUNT];
+    hg_addr_t target_addrs[HG_TEST_LOOKUP_BATCH_COUNT];
+    hg_return_t ret = HG_SUCCESS;
+    int i;
+
+    for (i = 0; i < HG_TEST_LOOKUP_BATCH_COUNT; i++)
+        target_names[i] = target_name;
+
+    ret = HG_Addr_lookup_batch(
+        hg_class, target_names, HG_TEST_LOOKUP_BATCH_COUNT, target_addrs);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Addr_lookup_batch() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Same name must resolve to the same address */
+    for (i = 1; i < HG_TEST_LOOKUP_BATCH_COUNT; i++) {
+        HG_TEST_CHECK_ERROR(
+            !HG_Addr_cmp(hg_class, target_addrs[0], target_addrs[i]), error,
+            ret, HG_FAULT, "Addresses do not match");
+    }
+
+error:
+    for (i = 0; i < HG_TEST_LOOKUP_BATCH_COUNT; i++)
+        HG_Addr_free(hg_class, target_addrs[i]);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_addr_serialize_batch(hg_class_t *hg_class, const char *target_name)
+{
+    hg_addr_t target_addrs[HG_TEST_LOOKUP_BATCH_COUNT];
+    hg_addr_t new_addrs[HG_TEST_LOOKUP_BATCH_COUNT];
+    hg_size_t buf_size, count = 0;
+    void *buf = NULL;
+    hg_return_t ret = HG_SUCCESS;
+    int i;
+
+    for (i = 0; i < HG_TEST_LOOKUP_BATCH_COUNT; i++) {
+        target_addrs[i] = HG_ADDR_NULL;
+        new_addrs[i] = HG_ADDR_NULL;
+    }
+
+    /* First address is the target, others are self addresses */
+    ret = HG_Addr_lookup2(hg_class, target_name, &target_addrs[0]);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Addr_lookup() failed (%s)", HG_Error_to_string(ret));
+    for (i = 1; i < HG_TEST_LOOKUP_BATCH_COUNT; i++) {
+        ret = HG_Addr_self(hg_class, &target_addrs[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    buf_size = HG_Addr_get_serialize_batch_size(
+        hg_class, target_addrs, HG_TEST_LOOKUP_BATCH_COUNT);
+    HG_TEST_CHECK_ERROR(buf_size == 0, error, ret, HG_FAULT,
+        "HG_Addr_get_serialize_batch_size() failed");
+    buf = malloc(buf_size);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+
+    ret = HG_Addr_serialize_batch(
+        hg_class, buf, buf_size, target_addrs, HG_TEST_LOOKUP_BATCH_COUNT);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Addr_serialize_batch() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Query number of addresses */
+    ret = HG_Addr_deserialize_batch(hg_class, buf, buf_size, NULL, &count);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "HG_Addr_deserialize_batch() failed (%s)", HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(count != HG_TEST_LOOKUP_BATCH_COUNT, error, ret,
+        HG_FAULT, "Address count (%zu) does not match (%d)", (size_t) count,
+        HG_TEST_LOOKUP_BATCH_COUNT);
+
+    ret = HG_Addr_deserialize_batch(hg_class, buf, buf_size, new_addrs, &count);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "HG_Addr_deserialize_batch() failed (%s)", HG_Error_to_string(ret));
+
+    for (i = 0; i < HG_TEST_LOOKUP_BATCH_COUNT; i++) {
+        HG_TEST_CHECK_ERROR(
+            !HG_Addr_cmp(hg_class, target_addrs[i], new_addrs[i]), error, ret,
+            HG_FAULT, "Addresses do not match");
+    }
+
+error:
+    for (i = 0; i < HG_TEST_LOOKUP_BATCH_COUNT; i++) {
+        HG_Addr_free(hg_class, target_addrs[i]);
+        HG_Addr_free(hg_class, new_addrs[i]);
+    }
+    free(buf);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 int
 main(int argc, char *argv[])
@@ -151,6 +259,20 @@ main(int argc, char *argv[])
 #endif
     HG_PASSED();
 
+    HG_TEST("batch lookup RPC");
+    hg_ret = hg_test_rpc_lookup_batch(
+        hg_test_info.hg_class, hg_test_info.na_test_info.target_name);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "batch lookup test failed");
+    HG_PASSED();
+
+    HG_TEST("batch address serialization");
+    hg_ret = hg_test_addr_serialize_batch(
+        hg_test_info.hg_class, hg_test_info.na_test_info.target_name);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "batch address serialization test failed");
+    HG_PASSED();
+
     hg_ret = HG_Addr_lookup2(hg_test_info.hg_class,
         hg_test_info.na_test_info.target_name, &hg_test_info.target_addr);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
@@ -16,9 +16,24 @@
 
 #ifdef HG_HAS_BOOST
 
+MERCURY_GEN_PROC(overflow_in_t, ((hg_uint64_t)(string_len)))
 MERCURY_GEN_PROC(
     overflow_out_t, ((hg_string_t)(string))((hg_uint64_t)(string_len)))
 #else
+/* Define overflow_in_t */
+typedef struct {
+    hg_uint64_t string_len;
+} overflow_in_t;
+
+/* Define hg_proc_overflow_in_t */
+static HG_INLINE hg_return_t
+hg_proc_overflow_in_t(hg_proc_t proc, void *data)
+{
+    overflow_in_t *struct_data = (overflow_in_t *) data;
+
+    return hg_proc_hg_uint64_t(proc, &struct_data->string_len);
+}
+
 /* Define overflow_out_t */
 typedef struct {
     hg_string_t string;
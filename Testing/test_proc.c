@@ -17,6 +17,8 @@
 /* Local Macros */
 /****************/
 
+#define HG_TEST_PROC_ARRAY_COUNT 64
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -32,6 +34,29 @@ typedef struct {
     hg_const_string_t string;
 } hg_test_proc_string_t;
 
+typedef struct {
+    hg_uint32_t val32[HG_TEST_PROC_ARRAY_COUNT];
+    hg_uint64_t val64[HG_TEST_PROC_ARRAY_COUNT];
+    double dval[HG_TEST_PROC_ARRAY_COUNT];
+} hg_test_proc_array_t;
+
+typedef struct {
+    hg_const_string_t string;
+    void *bytes;
+    hg_uint32_t bytes_size;
+} hg_test_proc_borrow_t;
+
+typedef struct {
+    hg_key_t key;
+    hg_key_t null_key;
+} hg_test_proc_key_t;
+
+#ifdef HG_HAS_BOOST
+MERCURY_GEN_POD_PROC(hg_test_proc_pod_t,
+    ((hg_uint8_t)(val8))((hg_uint64_t)(val64))((hg_int32_t)(val32))(
+        (rpc_handle_t)(handle)))
+#endif
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -74,6 +99,68 @@ hg_proc_hg_test_proc_string_t(hg_proc_t proc, void *data)
     return ret;
 }
 
+static hg_return_t
+hg_proc_hg_test_proc_array_t(hg_proc_t proc, void *data)
+{
+    hg_test_proc_array_t *struct_data = (hg_test_proc_array_t *) data;
+    hg_return_t ret = HG_SUCCESS;
+
+    ret = hg_proc_hg_uint32_array(
+        proc, struct_data->val32, HG_TEST_PROC_ARRAY_COUNT);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_hg_uint64_array(
+        proc, struct_data->val64, HG_TEST_PROC_ARRAY_COUNT);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret =
+        hg_proc_double_array(proc, struct_data->dval, HG_TEST_PROC_ARRAY_COUNT);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    return ret;
+}
+
+static hg_return_t
+hg_proc_hg_test_proc_key_t(hg_proc_t proc, void *data)
+{
+    hg_test_proc_key_t *struct_data = (hg_test_proc_key_t *) data;
+    hg_return_t ret = HG_SUCCESS;
+
+    ret = hg_proc_hg_key_t(proc, &struct_data->key);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_hg_key_t(proc, &struct_data->null_key);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    return ret;
+}
+
+static hg_return_t
+hg_proc_hg_test_proc_borrow_t(hg_proc_t proc, void *data)
+{
+    hg_test_proc_borrow_t *struct_data = (hg_test_proc_borrow_t *) data;
+    hg_return_t ret = HG_SUCCESS;
+
+    ret = hg_proc_hg_const_string_t(proc, &struct_data->string);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_hg_uint32_t(proc, &struct_data->bytes_size);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_bytes_ptr(proc, &struct_data->bytes, struct_data->bytes_size);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    return ret;
+}
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -228,6 +315,391 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_proc_key(void)
+{
+    hg_return_t ret;
+    hg_test_proc_key_t in, out;
+
+    memset(&out, 0, sizeof(out));
+    ret = hg_key_init(&in.key, "Hello");
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_key_init() failed");
+    ret = hg_key_init(&in.null_key, NULL);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_key_init() failed");
+
+    ret = hg_test_proc_generic(hg_proc_hg_test_proc_key_t, &in, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_generic() failed");
+
+    /* Hash and length are not recomputed on decode */
+    HG_TEST_CHECK_ERROR(!hg_key_equal(&in.key, &out.key), done, ret,
+        HG_PROTOCOL_ERROR, "Encoded and decoded keys do not match (%s != %s)",
+        in.key.data, out.key.data);
+    HG_TEST_CHECK_ERROR(out.key.data[out.key.len] != '\0', done, ret,
+        HG_PROTOCOL_ERROR, "Decoded key is not NUL-terminated");
+    HG_TEST_CHECK_ERROR(out.null_key.data != NULL || out.null_key.len != 0,
+        done, ret, HG_PROTOCOL_ERROR, "Decoded key is not NULL");
+
+    ret = hg_test_proc_free(hg_proc_hg_test_proc_key_t, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_free() failed");
+
+    HG_TEST_CHECK_ERROR(out.key.data != NULL, done, ret, HG_PROTOCOL_ERROR,
+        "Decoded key was not freed");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_proc_array(void)
+{
+    hg_test_proc_array_t *in = NULL, *out = NULL;
+    hg_return_t ret;
+    int i;
+
+    in = malloc(sizeof(*in));
+    HG_TEST_CHECK_ERROR(
+        in == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate array");
+    out = calloc(1, sizeof(*out));
+    HG_TEST_CHECK_ERROR(
+        out == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate array");
+
+    for (i = 0; i < HG_TEST_PROC_ARRAY_COUNT; i++) {
+        in->val32[i] = (hg_uint32_t) i * 0x01020304U;
+        in->val64[i] = (hg_uint64_t) i * 0x0102030405060708ULL;
+        in->dval[i] = (double) i / 3.0;
+    }
+
+    ret = hg_test_proc_generic(hg_proc_hg_test_proc_array_t, in, out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_generic() failed");
+
+    HG_TEST_CHECK_ERROR(memcmp(in, out, sizeof(*in)) != 0, done, ret,
+        HG_PROTOCOL_ERROR, "Encoded and decoded arrays do not match");
+
+    ret = hg_test_proc_free(hg_proc_hg_test_proc_array_t, out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_free() failed");
+
+done:
+    free(in);
+    free(out);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifndef HG_HAS_XDR
+static hg_return_t
+hg_test_proc_size(void)
+{
+    hg_test_proc_array_t *in = NULL;
+    hg_proc_t proc = HG_PROC_NULL;
+    size_t buf_size = (size_t) hg_mem_get_page_size();
+    void *buf = NULL;
+    hg_size_t encode_size;
+    hg_return_t ret;
+
+    in = calloc(1, sizeof(*in));
+    HG_TEST_CHECK_ERROR(
+        in == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate array");
+
+    ret = hg_proc_create((hg_class_t *) 1, HG_CRC32, &proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Cannot create HG proc");
+
+    buf = calloc(1, buf_size);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate buf");
+
+    /* Reference size */
+    ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_test_proc_array_t(proc, in);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc array_t struct");
+    encode_size = hg_proc_get_size_used(proc);
+
+    /* Sizing pass without buffer */
+    ret = hg_proc_reset(proc, NULL, 0, HG_SIZE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_test_proc_array_t(proc, in);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc array_t struct");
+    HG_TEST_CHECK_ERROR(hg_proc_get_size_used(proc) != encode_size, done, ret,
+        HG_PROTOCOL_ERROR, "Sizes do not match (%zu != %zu)",
+        hg_proc_get_size_used(proc), encode_size);
+
+    /* Encoding that overflows switches to sizing pass */
+    ret = hg_proc_reset(proc, buf, encode_size / 2, HG_ENCODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+    hg_proc_set_flags(proc, HG_PROC_SIZE_PASS);
+
+    ret = hg_proc_hg_test_proc_array_t(proc, in);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc array_t struct");
+    HG_TEST_CHECK_ERROR(hg_proc_get_op(proc) != HG_SIZE ||
+                            hg_proc_get_extra_buf(proc) != NULL,
+        done, ret, HG_PROTOCOL_ERROR, "Proc was not switched to HG_SIZE");
+    HG_TEST_CHECK_ERROR(hg_proc_get_size_used(proc) != encode_size, done, ret,
+        HG_PROTOCOL_ERROR, "Sizes do not match (%zu != %zu)",
+        hg_proc_get_size_used(proc), encode_size);
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+    free(in);
+
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_proc_borrow(void)
+{
+    char bytes[] = "0123456789abcdef";
+    hg_test_proc_borrow_t in = {"Hello", bytes, sizeof(bytes)},
+                          out = {NULL, NULL, 0};
+    hg_proc_t proc = HG_PROC_NULL;
+    size_t buf_size = (size_t) hg_mem_get_page_size();
+    void *buf = NULL;
+    hg_return_t ret;
+
+    ret = hg_proc_create((hg_class_t *) 1, HG_CRC32, &proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Cannot create HG proc");
+
+    buf = calloc(1, buf_size);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate buf");
+
+    ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_test_proc_borrow_t(proc, &in);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc borrow_t struct");
+
+    ret = hg_proc_flush(proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+    /* Decode in borrow mode */
+    ret = hg_proc_reset(proc, buf, buf_size, HG_DECODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+    hg_proc_set_flags(proc, HG_PROC_BORROW);
+
+    ret = hg_proc_hg_test_proc_borrow_t(proc, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc borrow_t struct");
+
+    ret = hg_proc_flush(proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+    HG_TEST_CHECK_ERROR(strcmp(in.string, out.string) != 0, done, ret,
+        HG_PROTOCOL_ERROR,
+        "Encoded and decoded strings do not match (%s != %s)", in.string,
+        out.string);
+    HG_TEST_CHECK_ERROR(in.bytes_size != out.bytes_size ||
+                            memcmp(in.bytes, out.bytes, in.bytes_size) != 0,
+        done, ret, HG_PROTOCOL_ERROR, "Encoded and decoded bytes do not match");
+#ifndef HG_HAS_XDR
+    /* Decoded data must point into the proc buffer */
+    HG_TEST_CHECK_ERROR(
+        (const char *) out.string < (char *) buf ||
+            (const char *) out.string >= (char *) buf + buf_size,
+        done, ret, HG_PROTOCOL_ERROR, "Decoded string was not borrowed");
+    HG_TEST_CHECK_ERROR(
+        (char *) out.bytes < (char *) buf ||
+            (char *) out.bytes >= (char *) buf + buf_size,
+        done, ret, HG_PROTOCOL_ERROR, "Decoded bytes were not borrowed");
+#endif
+
+    /* Free must not release borrowed data */
+    ret = hg_proc_reset(proc, buf, buf_size, HG_FREE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+    hg_proc_set_flags(proc, HG_PROC_BORROW);
+
+    ret = hg_proc_hg_test_proc_borrow_t(proc, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc borrow_t struct");
+
+    ret = hg_proc_flush(proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifndef HG_HAS_XDR
+static hg_return_t
+hg_test_proc_swap(void)
+{
+    hg_test_proc_uint_t in = {0x12, 0x1234, 0x12345678, 0x123456789abcdef0ULL},
+                        out = {0, 0, 0, 0};
+    hg_uint32_t in_array[2] = {0x12345678, 0x9abcdef0}, out_array[2] = {0, 0};
+    hg_proc_t proc = HG_PROC_NULL;
+    size_t buf_size = (size_t) hg_mem_get_page_size();
+    void *buf = NULL;
+    hg_return_t ret;
+
+    ret = hg_proc_create((hg_class_t *) 1, HG_CRC32, &proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Cannot create HG proc");
+
+    buf = calloc(1, buf_size);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate buf");
+
+    ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_test_proc_uint_t(proc, &in);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
+
+    ret = hg_proc_hg_uint32_array(proc, in_array, 2);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc array");
+
+    ret = hg_proc_flush(proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+    /* Decode as if the payload came from a peer of different byte order */
+    ret = hg_proc_reset(proc, buf, buf_size, HG_DECODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+    hg_proc_set_flags(proc, HG_PROC_SWAP);
+
+    ret = hg_proc_hg_test_proc_uint_t(proc, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
+
+    ret = hg_proc_hg_uint32_array(proc, out_array, 2);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc array");
+
+    ret = hg_proc_flush(proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+    HG_TEST_CHECK_ERROR(out.val8 != 0x12 || out.val16 != 0x3412 ||
+                            out.val32 != 0x78563412 ||
+                            out.val64 != 0xf0debc9a78563412ULL,
+        done, ret, HG_PROTOCOL_ERROR, "Decoded values were not swapped");
+    HG_TEST_CHECK_ERROR(
+        out_array[0] != 0x78563412 || out_array[1] != 0xf0debc9a, done, ret,
+        HG_PROTOCOL_ERROR, "Decoded array values were not swapped");
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_test_proc_arena_cleanup(void *arg)
+{
+    (*(int *) arg)++;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_proc_arena(void)
+{
+    char bytes[2048];
+    hg_test_proc_borrow_t in = {"Hello", bytes, sizeof(bytes)},
+                          out = {NULL, NULL, 0};
+    hg_proc_t proc = HG_PROC_NULL;
+    size_t buf_size = (size_t) hg_mem_get_page_size();
+    void *buf = NULL;
+    int cleanup_count = 0, i;
+    hg_return_t ret;
+
+    memset(bytes, 'a', sizeof(bytes));
+
+    ret = hg_proc_create((hg_class_t *) 1, HG_CRC32, &proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Cannot create HG proc");
+
+    buf = calloc(1, buf_size);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate buf");
+
+    ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_test_proc_borrow_t(proc, &in);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc borrow_t struct");
+
+    ret = hg_proc_flush(proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+    /* Decode twice so that arena memory gets reused after reset */
+    for (i = 0; i < 2; i++) {
+        ret = hg_proc_reset(proc, buf, buf_size, HG_DECODE);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+        hg_proc_set_flags(proc, HG_PROC_ARENA);
+
+        ret = hg_proc_hg_test_proc_borrow_t(proc, &out);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc borrow_t struct");
+
+        ret = hg_proc_add_cleanup(
+            proc, hg_test_proc_arena_cleanup, &cleanup_count);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not add cleanup");
+
+        ret = hg_proc_flush(proc);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+        HG_TEST_CHECK_ERROR(strcmp(in.string, out.string) != 0, done, ret,
+            HG_PROTOCOL_ERROR,
+            "Encoded and decoded strings do not match (%s != %s)", in.string,
+            out.string);
+        HG_TEST_CHECK_ERROR(in.bytes_size != out.bytes_size ||
+                                memcmp(in.bytes, out.bytes, in.bytes_size) != 0,
+            done, ret, HG_PROTOCOL_ERROR,
+            "Encoded and decoded bytes do not match");
+
+        /* Decoded data is not part of the proc buffer */
+        HG_TEST_CHECK_ERROR(
+            (const char *) out.string >= (char *) buf &&
+                (const char *) out.string < (char *) buf + buf_size,
+            done, ret, HG_PROTOCOL_ERROR, "Decoded string was borrowed");
+
+        /* Release everything at once */
+        hg_proc_arena_reset(proc);
+        HG_TEST_CHECK_ERROR(cleanup_count != i + 1, done, ret,
+            HG_PROTOCOL_ERROR, "Cleanup was not called (%d)", cleanup_count);
+    }
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_HAS_BOOST
+static hg_return_t
+hg_test_proc_pod(void)
+{
+    hg_return_t ret;
+    hg_test_proc_pod_t in = {1, 2, -3, {4}}, out = {0, 0, 0, {0}};
+
+    ret = hg_test_proc_generic(hg_proc_hg_test_proc_pod_t, &in, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_generic() failed");
+
+    HG_TEST_CHECK_ERROR(in.val8 != out.val8 || in.val64 != out.val64 ||
+                            in.val32 != out.val32 ||
+                            in.handle.cookie != out.handle.cookie,
+        done, ret, HG_PROTOCOL_ERROR,
+        "Encoded and decoded values do not match");
+
+    ret = hg_test_proc_free(hg_proc_hg_test_proc_pod_t, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_free() failed");
+
+done:
+    return ret;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 int
 main(void)
@@ -249,6 +721,61 @@ main(void)
         "string proc test failed");
     HG_PASSED();
 
+    /* key proc test */
+    HG_TEST("key proc");
+    hg_ret = hg_test_proc_key();
+    HG_TEST_CHECK_ERROR(
+        hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "key proc test failed");
+    HG_PASSED();
+
+    /* array proc test */
+    HG_TEST("array proc");
+    hg_ret = hg_test_proc_array();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "array proc test failed");
+    HG_PASSED();
+
+#ifndef HG_HAS_XDR
+    /* size proc test */
+    HG_TEST("size proc");
+    hg_ret = hg_test_proc_size();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "size proc test failed");
+    HG_PASSED();
+#endif
+
+#ifndef HG_HAS_XDR
+    /* swap proc test */
+    HG_TEST("swap proc");
+    hg_ret = hg_test_proc_swap();
+    HG_TEST_CHECK_ERROR(
+        hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "swap proc test failed");
+    HG_PASSED();
+#endif
+
+    /* borrow proc test */
+    HG_TEST("borrow proc");
+    hg_ret = hg_test_proc_borrow();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "borrow proc test failed");
+    HG_PASSED();
+
+    /* arena proc test */
+    HG_TEST("arena proc");
+    hg_ret = hg_test_proc_arena();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "arena proc test failed");
+    HG_PASSED();
+
+#ifdef HG_HAS_BOOST
+    /* POD proc test */
+    HG_TEST("POD proc");
+    hg_ret = hg_test_proc_pod();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "POD proc test failed");
+    HG_PASSED();
+#endif
+
 done:
     if (ret != EXIT_SUCCESS)
         HG_FAILED();
@@ -0,0 +1,572 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury.h"
+#include "mercury_bulk.h"
+#include "mercury_macros.h"
+#include "mercury_proc.h"
+#include "mercury_proc_bulk.h"
+#include "mercury_proc_string.h"
+
+#include "mercury_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Serialization benchmark. Each benchmark encodes, decodes and frees a
+ * representative struct through a proc, either hand-written or generated
+ * with MERCURY_GEN_PROC, in the same way as RPC arguments (including
+ * checksums if enabled), and reports the time per operation and the encoded
+ * bandwidth. No transfer takes place, an HG class is only used to create
+ * and deserialize bulk handles. Build with and without HG_HAS_XDR or
+ * HG_HAS_CHECKSUMS to compare configurations. */
+
+/****************/
+/* Local Macros */
+/****************/
+
+#define HG_BENCH_OPS_DEFAULT  (100000)
+#define HG_BENCH_INFO_DEFAULT "na+sm"
+#define HG_BENCH_BUF_SIZE     (65536) /* Encoding buffer */
+#define HG_BENCH_ARRAY_COUNT  (64)    /* Elements of arrays */
+#define HG_BENCH_STRING_LEN   (255)   /* Length of strings */
+#define HG_BENCH_BULK_COUNT   (4)     /* Segments of bulk handles */
+#define HG_BENCH_BULK_SIZE    (4096)  /* Size of bulk segments */
+#define HG_BENCH_WARMUP       (1000)
+
+#define HG_BENCH_COUNT (sizeof(hg_bench_list_g) / sizeof(hg_bench_list_g[0]))
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+typedef struct {
+    hg_uint8_t val8;
+    hg_uint16_t val16;
+    hg_uint32_t val32;
+    hg_uint64_t val64;
+} hg_bench_uint_t;
+
+typedef struct {
+    hg_uint32_t val32[HG_BENCH_ARRAY_COUNT];
+    hg_uint64_t val64[HG_BENCH_ARRAY_COUNT];
+    double dval[HG_BENCH_ARRAY_COUNT];
+} hg_bench_array_t;
+
+typedef struct {
+    hg_string_t string;
+} hg_bench_string_t;
+
+typedef struct {
+    hg_bulk_t bulk;
+    hg_uint64_t size;
+} hg_bench_bulk_t;
+
+#ifdef HG_HAS_BOOST
+MERCURY_GEN_PROC(hg_bench_uint_gen_t,
+    ((hg_uint8_t)(val8))((hg_uint16_t)(val16))((hg_uint32_t)(val32))(
+        (hg_uint64_t)(val64)))
+MERCURY_GEN_PROC(hg_bench_string_gen_t, ((hg_string_t)(string)))
+MERCURY_GEN_PROC(hg_bench_bulk_gen_t, ((hg_bulk_t)(bulk))((hg_uint64_t)(size)))
+
+/* Typical RPC input with a mix of all types */
+MERCURY_GEN_PROC(hg_bench_mixed_gen_t,
+    ((hg_uint64_t)(id))((hg_uint32_t)(flags))((hg_int32_t)(mode))(
+        (hg_string_t)(path))((hg_bulk_t)(bulk))((hg_uint64_t)(size)))
+#endif
+
+/* Benchmark of one struct */
+struct hg_bench {
+    const char *name;                   /* Name */
+    hg_proc_cb_t proc_cb;               /* Proc of struct */
+    size_t struct_size;                 /* Size of struct */
+    void (*init)(void *, hg_bulk_t);    /* Init input struct */
+    hg_bool_t bulk;                     /* Struct includes a bulk handle */
+};
+
+/* Measurements (ns per op) */
+struct hg_bench_result {
+    double encode;
+    double decode;
+    double free;
+    hg_size_t size; /* Encoded size */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static hg_return_t
+hg_proc_hg_bench_uint_t(hg_proc_t proc, void *data);
+
+static hg_return_t
+hg_proc_hg_bench_array_t(hg_proc_t proc, void *data);
+
+static hg_return_t
+hg_proc_hg_bench_string_t(hg_proc_t proc, void *data);
+
+static hg_return_t
+hg_proc_hg_bench_bulk_t(hg_proc_t proc, void *data);
+
+static void
+hg_bench_uint_init(void *data, hg_bulk_t bulk);
+
+static void
+hg_bench_array_init(void *data, hg_bulk_t bulk);
+
+static void
+hg_bench_string_init(void *data, hg_bulk_t bulk);
+
+static void
+hg_bench_bulk_init(void *data, hg_bulk_t bulk);
+
+#ifdef HG_HAS_BOOST
+static void
+hg_bench_mixed_gen_init(void *data, hg_bulk_t bulk);
+#endif
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static char hg_bench_string_g[HG_BENCH_STRING_LEN + 1];
+
+/* Generated structs have the same layout as the hand-written ones */
+static const struct hg_bench hg_bench_list_g[] = {
+    {"uint", hg_proc_hg_bench_uint_t, sizeof(hg_bench_uint_t),
+        hg_bench_uint_init, HG_FALSE},
+    {"array", hg_proc_hg_bench_array_t, sizeof(hg_bench_array_t),
+        hg_bench_array_init, HG_FALSE},
+    {"string", hg_proc_hg_bench_string_t, sizeof(hg_bench_string_t),
+        hg_bench_string_init, HG_FALSE},
+    {"bulk", hg_proc_hg_bench_bulk_t, sizeof(hg_bench_bulk_t),
+        hg_bench_bulk_init, HG_TRUE},
+#ifdef HG_HAS_BOOST
+    {"uint_gen", hg_proc_hg_bench_uint_gen_t, sizeof(hg_bench_uint_gen_t),
+        hg_bench_uint_init, HG_FALSE},
+    {"string_gen", hg_proc_hg_bench_string_gen_t,
+        sizeof(hg_bench_string_gen_t), hg_bench_string_init, HG_FALSE},
+    {"bulk_gen", hg_proc_hg_bench_bulk_gen_t, sizeof(hg_bench_bulk_gen_t),
+        hg_bench_bulk_init, HG_TRUE},
+    {"mixed_gen", hg_proc_hg_bench_mixed_gen_t, sizeof(hg_bench_mixed_gen_t),
+        hg_bench_mixed_gen_init, HG_TRUE},
+#endif
+};
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_hg_bench_uint_t(hg_proc_t proc, void *data)
+{
+    hg_bench_uint_t *struct_data = (hg_bench_uint_t *) data;
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint8_t(proc, &struct_data->val8);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_hg_uint16_t(proc, &struct_data->val16);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_hg_uint32_t(proc, &struct_data->val32);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    return hg_proc_hg_uint64_t(proc, &struct_data->val64);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_hg_bench_array_t(hg_proc_t proc, void *data)
+{
+    hg_bench_array_t *struct_data = (hg_bench_array_t *) data;
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint32_array(
+        proc, struct_data->val32, HG_BENCH_ARRAY_COUNT);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_hg_uint64_array(
+        proc, struct_data->val64, HG_BENCH_ARRAY_COUNT);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    return hg_proc_double_array(proc, struct_data->dval, HG_BENCH_ARRAY_COUNT);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_hg_bench_string_t(hg_proc_t proc, void *data)
+{
+    hg_bench_string_t *struct_data = (hg_bench_string_t *) data;
+
+    return hg_proc_hg_string_t(proc, &struct_data->string);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_hg_bench_bulk_t(hg_proc_t proc, void *data)
+{
+    hg_bench_bulk_t *struct_data = (hg_bench_bulk_t *) data;
+    hg_return_t ret;
+
+    ret = hg_proc_hg_bulk_t(proc, &struct_data->bulk);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    return hg_proc_hg_uint64_t(proc, &struct_data->size);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_uint_init(void *data, hg_bulk_t bulk)
+{
+    hg_bench_uint_t *struct_data = (hg_bench_uint_t *) data;
+
+    (void) bulk;
+    struct_data->val8 = 1;
+    struct_data->val16 = 2;
+    struct_data->val32 = 3;
+    struct_data->val64 = 4;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_array_init(void *data, hg_bulk_t bulk)
+{
+    hg_bench_array_t *struct_data = (hg_bench_array_t *) data;
+    unsigned int i;
+
+    (void) bulk;
+    for (i = 0; i < HG_BENCH_ARRAY_COUNT; i++) {
+        struct_data->val32[i] = i;
+        struct_data->val64[i] = i;
+        struct_data->dval[i] = (double) i;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_string_init(void *data, hg_bulk_t bulk)
+{
+    hg_bench_string_t *struct_data = (hg_bench_string_t *) data;
+
+    (void) bulk;
+    struct_data->string = hg_bench_string_g;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_bulk_init(void *data, hg_bulk_t bulk)
+{
+    hg_bench_bulk_t *struct_data = (hg_bench_bulk_t *) data;
+
+    struct_data->bulk = bulk;
+    struct_data->size = HG_BENCH_BULK_COUNT * HG_BENCH_BULK_SIZE;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_HAS_BOOST
+static void
+hg_bench_mixed_gen_init(void *data, hg_bulk_t bulk)
+{
+    hg_bench_mixed_gen_t *struct_data = (hg_bench_mixed_gen_t *) data;
+
+    struct_data->id = 1;
+    struct_data->flags = 2;
+    struct_data->mode = 3;
+    struct_data->path = hg_bench_string_g;
+    struct_data->bulk = bulk;
+    struct_data->size = HG_BENCH_BULK_COUNT * HG_BENCH_BULK_SIZE;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_encode(const struct hg_bench *bench, hg_proc_t proc, void *buf,
+    void *in, hg_uint32_t *checksum)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_reset(proc, buf, HG_BENCH_BUF_SIZE, HG_ENCODE);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = bench->proc_cb(proc, in);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_flush(proc);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+#ifdef HG_HAS_CHECKSUMS
+    ret = hg_proc_checksum_get(proc, checksum, sizeof(*checksum));
+#else
+    (void) checksum;
+#endif
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_decode(const struct hg_bench *bench, hg_proc_t proc, void *buf,
+    void *out, hg_uint32_t *checksum)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_reset(proc, buf, HG_BENCH_BUF_SIZE, HG_DECODE);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = bench->proc_cb(proc, out);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_flush(proc);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+#ifdef HG_HAS_CHECKSUMS
+    ret = hg_proc_checksum_verify(proc, checksum, sizeof(*checksum));
+#else
+    (void) checksum;
+#endif
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_free(const struct hg_bench *bench, hg_proc_t proc, void *buf,
+    void *out)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_reset(proc, buf, HG_BENCH_BUF_SIZE, HG_FREE);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = bench->proc_cb(proc, out);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    return hg_proc_flush(proc);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_run(const struct hg_bench *bench, hg_class_t *hg_class,
+    hg_bulk_t bulk, unsigned long ops, struct hg_bench_result *result)
+{
+    hg_proc_t proc = HG_PROC_NULL;
+    void *buf = NULL, *in = NULL, *out = NULL;
+    hg_time_ticks_t encode = 0, decode = 0, free_ticks = 0, t1, t2, t3;
+    hg_uint32_t checksum = 0;
+    unsigned long i;
+    hg_return_t ret;
+
+    /* Procs are created as for RPC arguments */
+    ret = hg_proc_create(hg_class, HG_CRC32, &proc);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Error: could not create proc\n");
+        return ret;
+    }
+
+    buf = malloc(HG_BENCH_BUF_SIZE);
+    in = calloc(1, bench->struct_size);
+    out = calloc(1, bench->struct_size);
+    if (buf == NULL || in == NULL || out == NULL) {
+        fprintf(stderr, "Error: could not allocate buffers\n");
+        ret = HG_NOMEM;
+        goto done;
+    }
+    bench->init(in, bulk);
+
+    for (i = 0; i < HG_BENCH_WARMUP + ops; i++) {
+        t1 = hg_time_get_ticks();
+        ret = hg_bench_encode(bench, proc, buf, in, &checksum);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Error: could not encode %s (%s)\n", bench->name,
+                HG_Error_to_string(ret));
+            goto done;
+        }
+        t2 = hg_time_get_ticks();
+        if (i == 0)
+            result->size = hg_proc_get_size_used(proc);
+
+        ret = hg_bench_decode(bench, proc, buf, out, &checksum);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Error: could not decode %s (%s)\n", bench->name,
+                HG_Error_to_string(ret));
+            goto done;
+        }
+        t3 = hg_time_get_ticks();
+
+        ret = hg_bench_free(bench, proc, buf, out);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Error: could not free %s (%s)\n", bench->name,
+                HG_Error_to_string(ret));
+            goto done;
+        }
+
+        if (i >= HG_BENCH_WARMUP) {
+            encode += t2 - t1;
+            decode += t3 - t2;
+            free_ticks += hg_time_get_ticks() - t3;
+        }
+    }
+
+    result->encode = (double) hg_time_ticks_to_ns(encode) / (double) ops;
+    result->decode = (double) hg_time_ticks_to_ns(decode) / (double) ops;
+    result->free = (double) hg_time_ticks_to_ns(free_ticks) / (double) ops;
+
+done:
+    hg_proc_free(proc);
+    free(buf);
+    free(in);
+    free(out);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_usage(const char *execname)
+{
+    unsigned int i;
+
+    printf("usage: %s [-n ops] [-i info_string] [benchmark...]\n", execname);
+    printf("    -n    Number of measured operations (default: %d)\n",
+        HG_BENCH_OPS_DEFAULT);
+    printf("    -i    Info string of class used for bulk handles "
+           "(default: %s)\n",
+        HG_BENCH_INFO_DEFAULT);
+    printf("    benchmarks:");
+    for (i = 0; i < HG_BENCH_COUNT; i++)
+        printf(" %s", hg_bench_list_g[i].name);
+    printf("\n");
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    hg_bool_t selected[HG_BENCH_COUNT], select_all = HG_TRUE;
+    const char *info_string = HG_BENCH_INFO_DEFAULT;
+    unsigned long ops = HG_BENCH_OPS_DEFAULT;
+    hg_class_t *hg_class = NULL;
+    hg_bulk_t bulk = HG_BULK_NULL;
+    void *bulk_bufs[HG_BENCH_BULK_COUNT];
+    hg_size_t bulk_sizes[HG_BENCH_BULK_COUNT];
+    char *bulk_buf = NULL;
+    unsigned int i;
+    int arg, ret = EXIT_SUCCESS;
+
+    memset(selected, 0, sizeof(selected));
+    for (arg = 1; arg < argc; arg++) {
+        if (strcmp(argv[arg], "-n") == 0 && arg + 1 < argc)
+            ops = strtoul(argv[++arg], NULL, 10);
+        else if (strcmp(argv[arg], "-i") == 0 && arg + 1 < argc)
+            info_string = argv[++arg];
+        else {
+            for (i = 0; i < HG_BENCH_COUNT; i++)
+                if (strcmp(argv[arg], hg_bench_list_g[i].name) == 0)
+                    break;
+            if (i == HG_BENCH_COUNT) {
+                hg_bench_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            selected[i] = HG_TRUE;
+            select_all = HG_FALSE;
+        }
+    }
+    if (ops == 0) {
+        hg_bench_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    memset(hg_bench_string_g, 'a', HG_BENCH_STRING_LEN);
+
+    /* Class is only needed to create and deserialize bulk handles */
+    hg_class = HG_Init(info_string, HG_FALSE);
+    if (hg_class == NULL) {
+        fprintf(stderr, "Error: could not initialize HG with %s\n",
+            info_string);
+        return EXIT_FAILURE;
+    }
+
+    bulk_buf = (char *) malloc(HG_BENCH_BULK_COUNT * HG_BENCH_BULK_SIZE);
+    if (bulk_buf == NULL) {
+        fprintf(stderr, "Error: could not allocate bulk buffer\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < HG_BENCH_BULK_COUNT; i++) {
+        bulk_bufs[i] = bulk_buf + i * HG_BENCH_BULK_SIZE;
+        bulk_sizes[i] = HG_BENCH_BULK_SIZE;
+    }
+    if (HG_Bulk_create(hg_class, HG_BENCH_BULK_COUNT, bulk_bufs, bulk_sizes,
+            HG_BULK_READWRITE, &bulk) != HG_SUCCESS) {
+        fprintf(stderr, "Error: could not create bulk handle\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    printf("# xdr: %s, checksums: %s, %lu ops, bulk handles of %d "
+           "segment(s) (%s)\n",
+#ifdef HG_HAS_XDR
+        "yes",
+#else
+        "no",
+#endif
+#ifdef HG_HAS_CHECKSUMS
+        "yes",
+#else
+        "no",
+#endif
+        ops, HG_BENCH_BULK_COUNT, info_string);
+    printf("%-12s%10s%14s%14s%14s%12s%12s\n", "# Benchmark", "Size (B)",
+        "Encode (ns)", "Decode (ns)", "Free (ns)", "Enc (GB/s)",
+        "Dec (GB/s)");
+
+    for (i = 0; i < HG_BENCH_COUNT; i++) {
+        struct hg_bench_result result;
+
+        if (!select_all && !selected[i])
+            continue;
+
+        memset(&result, 0, sizeof(result));
+        if (hg_bench_run(&hg_bench_list_g[i], hg_class, bulk, ops, &result) !=
+            HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            break;
+        }
+
+        /* Bytes per ns are GB/s */
+        printf("%-12s%10zu%14.1f%14.1f%14.1f%12.2f%12.2f\n",
+            hg_bench_list_g[i].name, (size_t) result.size, result.encode,
+            result.decode, result.free,
+            (double) result.size / result.encode,
+            (double) result.size / result.decode);
+        fflush(stdout);
+    }
+
+done:
+    if (bulk != HG_BULK_NULL)
+        HG_Bulk_free(bulk);
+    free(bulk_buf);
+    HG_Finalize(hg_class);
+
+    return ret;
+}
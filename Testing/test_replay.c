@@ -0,0 +1,619 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_test.h"
+
+#include "mercury_capture.h"
+#include "mercury_histogram.h"
+#include "mercury_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Replays a workload capture (see hg_init_info.capture_file and the -w test
+ * option) against a test server: records are forwarded with the same
+ * inter-arrival times and the same input, output and bulk sizes. The server
+ * cannot know the RPCs of the captured application, captured RPC IDs are
+ * therefore all mapped to a single replay RPC whose input carries the sizes
+ * to reproduce. Standard test options are given first, replay options are
+ * given after "--", e.g.:
+ *   hg_replay -c ofi -p tcp -- --capture app.hgc --speed 2 */
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Progress timeout (ms) */
+#define HG_REPLAY_PROGRESS_TIMEOUT 100
+
+/* Encoded size of the fixed fields of replay_in_t */
+#define HG_REPLAY_IN_OVERHEAD                                                  \
+    (sizeof(hg_uint32_t) + sizeof(hg_uint64_t) + sizeof(hg_uint32_t))
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+struct hg_replay_options {
+    const char *capture; /* Capture file */
+    double speed;        /* Time scale factor */
+    unsigned int window; /* Max operations in flight */
+    unsigned long limit; /* Max records replayed (0 for all) */
+};
+
+struct hg_replay;
+
+/* Operation in flight */
+struct hg_replay_slot {
+    struct hg_replay *replay; /* Owning replay */
+    hg_handle_t handle;       /* Handle (re-forwarded when completed) */
+    hg_time_t start;          /* Time of forward */
+};
+
+struct hg_replay {
+    struct hg_capture_record *records; /* Sorted records */
+    size_t count;                      /* Number of records */
+    struct hg_replay_slot *slots;      /* Operations */
+    struct hg_replay_slot **free_list; /* Stack of idle slots */
+    unsigned int free_count;           /* Number of idle slots */
+    unsigned int window;               /* Number of slots */
+    char *buf;                         /* Payload and bulk memory */
+    hg_bulk_t bulk_handle;             /* Bulk handle of buf */
+    struct hg_histogram latency;       /* Replayed latencies (ns) */
+    struct hg_histogram lag;           /* Issue lag (ns) */
+    struct hg_histogram captured;      /* Captured latencies (ns) */
+    unsigned long clamped;             /* Records with clamped sizes */
+    unsigned long errors;              /* Failed operations */
+    unsigned long completed;           /* Completed operations */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static void
+hg_replay_usage(const char *execname);
+
+static int
+hg_replay_parse_options(
+    int argc, char *argv[], struct hg_replay_options *hg_replay_options);
+
+static int
+hg_replay_record_cmp(const void *a, const void *b);
+
+static hg_return_t
+hg_replay_load(const char *path, unsigned long limit,
+    struct hg_capture_record **records_ptr, size_t *count_ptr);
+
+static hg_return_t
+hg_replay_init(struct hg_replay *hg_replay, struct hg_test_info *hg_test_info,
+    unsigned int window);
+
+static void
+hg_replay_finalize(struct hg_replay *hg_replay);
+
+static hg_return_t
+hg_replay_forward(struct hg_replay *hg_replay,
+    struct hg_test_info *hg_test_info,
+    const struct hg_capture_record *record);
+
+static hg_return_t
+hg_replay_forward_cb(const struct hg_cb_info *callback_info);
+
+static hg_return_t
+hg_replay_progress(hg_context_t *context, unsigned int timeout);
+
+static hg_return_t
+hg_replay_run(struct hg_replay *hg_replay, struct hg_test_info *hg_test_info,
+    double speed, double *time);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+extern hg_id_t hg_test_replay_id_g;
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_replay_usage(const char *execname)
+{
+    printf("usage: %s [test options] -- [replay options]\n", execname);
+    printf("    --capture    Capture file to replay (required)\n");
+    printf("    --speed      Time scale factor, 2 replays twice as fast "
+           "(default: 1)\n");
+    printf("    --window     Max operations in flight (default: handle)\n");
+    printf("    --limit      Max records replayed (default: all)\n");
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_replay_parse_options(
+    int argc, char *argv[], struct hg_replay_options *hg_replay_options)
+{
+    int i;
+
+    /* Replay options start after "--" */
+    for (i = 1; i < argc; i++)
+        if (strcmp(argv[i], "--") == 0)
+            break;
+
+    for (i++; i < argc; i++) {
+        const char *opt = argv[i], *arg = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int rc = HG_UTIL_SUCCESS;
+
+        if (strcmp(opt, "--help") == 0 || strcmp(opt, "-h") == 0)
+            return HG_UTIL_FAIL;
+        if (arg == NULL) {
+            HG_TEST_LOG_ERROR("Missing argument for %s", opt);
+            return HG_UTIL_FAIL;
+        }
+        i++;
+
+        if (strcmp(opt, "--capture") == 0)
+            hg_replay_options->capture = arg;
+        else if (strcmp(opt, "--speed") == 0)
+            hg_replay_options->speed = atof(arg);
+        else if (strcmp(opt, "--window") == 0)
+            hg_replay_options->window = (unsigned int) strtoul(arg, NULL, 10);
+        else if (strcmp(opt, "--limit") == 0)
+            hg_replay_options->limit = strtoul(arg, NULL, 10);
+        else
+            rc = HG_UTIL_FAIL;
+
+        if (rc != HG_UTIL_SUCCESS) {
+            HG_TEST_LOG_ERROR("Invalid option %s %s", opt, arg);
+            return HG_UTIL_FAIL;
+        }
+    }
+
+    if (hg_replay_options->capture == NULL) {
+        HG_TEST_LOG_ERROR("No capture file given");
+        return HG_UTIL_FAIL;
+    }
+    if (hg_replay_options->speed <= 0.0 || hg_replay_options->window == 0) {
+        HG_TEST_LOG_ERROR("Speed and window must be greater than 0");
+        return HG_UTIL_FAIL;
+    }
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_replay_record_cmp(const void *a, const void *b)
+{
+    hg_uint64_t time_a = ((const struct hg_capture_record *) a)->time,
+                time_b = ((const struct hg_capture_record *) b)->time;
+
+    return (time_a > time_b) - (time_a < time_b);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_load(const char *path, unsigned long limit,
+    struct hg_capture_record **records_ptr, size_t *count_ptr)
+{
+    struct hg_capture_header header;
+    struct hg_capture_record *records = NULL;
+    size_t count = 0, max = 0;
+    FILE *file = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    file = fopen(path, "rb");
+    HG_TEST_CHECK_ERROR(file == NULL, error, ret, HG_NOENTRY,
+        "Could not open capture file %s", path);
+
+    HG_TEST_CHECK_ERROR(fread(&header, sizeof(header), 1, file) != 1 ||
+                            strncmp(header.magic, HG_CAPTURE_MAGIC,
+                                sizeof(header.magic)) != 0,
+        error, ret, HG_PROTOCOL_ERROR, "%s is not a capture file", path);
+    HG_TEST_CHECK_ERROR(header.version != HG_CAPTURE_VERSION ||
+                            header.record_size != sizeof(*records),
+        error, ret, HG_PROTOCOL_ERROR,
+        "Unsupported capture version %u (record size %u)", header.version,
+        header.record_size);
+
+    /* Records are written in completion order, a partial record at the end
+     * of a truncated file is ignored */
+    for (;;) {
+        if (count == max) {
+            struct hg_capture_record *new_records;
+
+            max = max ? max * 2 : 1024;
+            new_records = (struct hg_capture_record *) realloc(
+                records, max * sizeof(*records));
+            HG_TEST_CHECK_ERROR(new_records == NULL, error, ret, HG_NOMEM,
+                "Could not allocate records");
+            records = new_records;
+        }
+        if (fread(&records[count], sizeof(*records), 1, file) != 1)
+            break;
+        count++;
+    }
+    HG_TEST_CHECK_ERROR(
+        count == 0, error, ret, HG_NOENTRY, "No records in %s", path);
+
+    /* Replay in forward order */
+    qsort(records, count, sizeof(*records), hg_replay_record_cmp);
+    if (limit > 0 && count > limit)
+        count = limit;
+
+    fclose(file);
+    *records_ptr = records;
+    *count_ptr = count;
+
+    return HG_SUCCESS;
+
+error:
+    if (file != NULL)
+        fclose(file);
+    free(records);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_init(struct hg_replay *hg_replay, struct hg_test_info *hg_test_info,
+    unsigned int window)
+{
+    hg_size_t buf_size = hg_test_info->buf_size_max;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    hg_replay->window = window;
+    hg_replay->bulk_handle = HG_BULK_NULL;
+    hg_histogram_init(&hg_replay->latency);
+    hg_histogram_init(&hg_replay->lag);
+    hg_histogram_init(&hg_replay->captured);
+
+    /* Payloads and bulk transfers share the same memory, the server checks
+     * data against its offset when verifying data */
+    hg_replay->buf = (char *) malloc(buf_size);
+    HG_TEST_CHECK_ERROR(hg_replay->buf == NULL, error, ret, HG_NOMEM,
+        "Could not allocate buffer");
+    for (i = 0; i < buf_size; i++)
+        hg_replay->buf[i] = (char) i;
+
+    ret = HG_Bulk_create(hg_test_info->hg_class, 1, (void **) &hg_replay->buf,
+        &buf_size, HG_BULK_READ_ONLY, &hg_replay->bulk_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    hg_replay->slots = (struct hg_replay_slot *) calloc(
+        window, sizeof(struct hg_replay_slot));
+    hg_replay->free_list = (struct hg_replay_slot **) calloc(
+        window, sizeof(struct hg_replay_slot *));
+    HG_TEST_CHECK_ERROR(
+        hg_replay->slots == NULL || hg_replay->free_list == NULL, error, ret,
+        HG_NOMEM, "Could not allocate slots");
+    for (i = 0; i < window; i++) {
+        struct hg_replay_slot *hg_replay_slot = &hg_replay->slots[i];
+
+        hg_replay_slot->replay = hg_replay;
+        ret = HG_Create(hg_test_info->context, hg_test_info->target_addr,
+            hg_test_replay_id_g, &hg_replay_slot->handle);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+        hg_replay->free_list[hg_replay->free_count++] = hg_replay_slot;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    hg_replay_finalize(hg_replay);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_replay_finalize(struct hg_replay *hg_replay)
+{
+    hg_return_t ret;
+    unsigned int i;
+
+    if (hg_replay->slots) {
+        for (i = 0; i < hg_replay->window; i++) {
+            if (hg_replay->slots[i].handle == HG_HANDLE_NULL)
+                continue;
+            ret = HG_Destroy(hg_replay->slots[i].handle);
+            HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+                "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+        }
+        free(hg_replay->slots);
+        hg_replay->slots = NULL;
+    }
+    free(hg_replay->free_list);
+    hg_replay->free_list = NULL;
+
+    if (hg_replay->bulk_handle != HG_BULK_NULL) {
+        ret = HG_Bulk_free(hg_replay->bulk_handle);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+        hg_replay->bulk_handle = HG_BULK_NULL;
+    }
+    free(hg_replay->buf);
+    hg_replay->buf = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_forward(struct hg_replay *hg_replay,
+    struct hg_test_info *hg_test_info, const struct hg_capture_record *record)
+{
+    struct hg_replay_slot *hg_replay_slot =
+        hg_replay->free_list[--hg_replay->free_count];
+    hg_uint64_t size_max = hg_test_info->buf_size_max;
+    hg_uint64_t in_size = record->in_size, bulk_size = record->bulk_size;
+    hg_uint64_t out_size = record->out_size;
+    replay_in_t in_struct;
+    hg_return_t ret;
+
+    /* Captured sizes include the fields of the replay input */
+    in_size = (in_size > HG_REPLAY_IN_OVERHEAD)
+                  ? in_size - HG_REPLAY_IN_OVERHEAD
+                  : 0;
+    if (in_size > size_max || out_size > size_max || bulk_size > size_max) {
+        hg_replay->clamped++;
+        if (in_size > size_max)
+            in_size = size_max;
+        if (out_size > size_max)
+            out_size = size_max;
+        if (bulk_size > size_max)
+            bulk_size = size_max;
+    }
+
+    in_struct.buf = hg_replay->buf;
+    in_struct.buf_size = (hg_uint32_t) in_size;
+    in_struct.out_size = (hg_uint32_t) out_size;
+    in_struct.bulk_size = bulk_size;
+    in_struct.bulk_handle =
+        (bulk_size > 0) ? hg_replay->bulk_handle : HG_BULK_NULL;
+
+    /* Captured target contexts are mapped onto the server contexts */
+    if (hg_test_info->na_test_info.max_contexts > 1) {
+        ret = HG_Set_target_id(hg_replay_slot->handle,
+            (hg_uint8_t)(record->target_id %
+                         hg_test_info->na_test_info.max_contexts));
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Set_target_id() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    hg_time_get_current(&hg_replay_slot->start);
+    ret = HG_Forward(hg_replay_slot->handle, hg_replay_forward_cb,
+        hg_replay_slot, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    hg_replay->free_list[hg_replay->free_count++] = hg_replay_slot;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_forward_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_replay_slot *hg_replay_slot =
+        (struct hg_replay_slot *) callback_info->arg;
+    struct hg_replay *hg_replay = hg_replay_slot->replay;
+    replay_out_t out_struct;
+    hg_time_t now;
+    hg_return_t ret;
+
+    hg_time_get_current(&now);
+
+    if (callback_info->ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Error in HG callback (%s)",
+            HG_Error_to_string(callback_info->ret));
+        hg_replay->errors++;
+        goto done;
+    }
+    hg_histogram_record(&hg_replay->latency,
+        (hg_util_uint64_t)(
+            hg_time_to_double(hg_time_subtract(now, hg_replay_slot->start)) *
+            1000000000.0));
+
+    /* Decode output so that its size is paid for as in the capture */
+    ret = HG_Get_output(callback_info->info.forward.handle, &out_struct);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR(
+            "HG_Get_output() failed (%s)", HG_Error_to_string(ret));
+        hg_replay->errors++;
+        goto done;
+    }
+    ret = HG_Free_output(callback_info->info.forward.handle, &out_struct);
+    HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+        "HG_Free_output() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    hg_replay->free_list[hg_replay->free_count++] = hg_replay_slot;
+    hg_replay->completed++;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_progress(hg_context_t *context, unsigned int timeout)
+{
+    unsigned int actual_count = 0;
+    hg_return_t ret;
+
+    ret = HG_Progress(context, timeout);
+    HG_TEST_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+        "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+
+    /* Trigger last so that callers see released slots before waiting */
+    do {
+        ret = HG_Trigger(context, 0, 1, &actual_count);
+    } while (ret == HG_SUCCESS && actual_count > 0);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_run(struct hg_replay *hg_replay, struct hg_test_info *hg_test_info,
+    double speed, double *time)
+{
+    hg_uint64_t origin = hg_replay->records[0].time;
+    hg_time_t start, now;
+    hg_return_t ret;
+    size_t i;
+
+    hg_time_get_current(&start);
+
+    for (i = 0; i < hg_replay->count; i++) {
+        const struct hg_capture_record *record = &hg_replay->records[i];
+        double due = (double) (record->time - origin) / 1000000000.0 / speed;
+        double elapsed;
+
+        hg_histogram_record(
+            &hg_replay->captured, (hg_util_uint64_t) record->duration * 1000);
+
+        /* Wait for the arrival time of the record and for a free slot, a
+         * full window delays the records that follow */
+        for (;;) {
+            hg_time_get_current(&now);
+            elapsed = hg_time_to_double(hg_time_subtract(now, start));
+            if (elapsed >= due && hg_replay->free_count > 0)
+                break;
+            ret = hg_replay_progress(hg_test_info->context,
+                (hg_replay->free_count == 0 ||
+                    due - elapsed > HG_REPLAY_PROGRESS_TIMEOUT / 1000.0)
+                    ? HG_REPLAY_PROGRESS_TIMEOUT
+                    : (unsigned int) ((due - elapsed) * 1000.0));
+            HG_TEST_CHECK_HG_ERROR(error, ret,
+                "hg_replay_progress() failed (%s)", HG_Error_to_string(ret));
+        }
+        hg_histogram_record(&hg_replay->lag,
+            (hg_util_uint64_t)((elapsed - due) * 1000000000.0));
+
+        ret = hg_replay_forward(hg_replay, hg_test_info, record);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "hg_replay_forward() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    while (hg_replay->completed < hg_replay->count) {
+        ret = hg_replay_progress(
+            hg_test_info->context, HG_REPLAY_PROGRESS_TIMEOUT);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "hg_replay_progress() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    hg_time_get_current(&now);
+    *time = hg_time_to_double(hg_time_subtract(now, start));
+
+    return HG_SUCCESS;
+
+error:
+    /* Wait for operations in flight before handles are destroyed */
+    while (hg_replay->free_count < hg_replay->window &&
+           hg_replay_progress(hg_test_info->context,
+               HG_REPLAY_PROGRESS_TIMEOUT) == HG_SUCCESS)
+        continue;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = {0};
+    struct hg_replay_options hg_replay_options = {NULL, 1.0, 0, 0};
+    struct hg_replay *hg_replay = NULL;
+    double time = 0.0, captured_time;
+    hg_return_t hg_ret;
+    int ret = EXIT_SUCCESS;
+
+    hg_ret = HG_Test_init(argc, argv, &hg_test_info);
+    HG_TEST_CHECK_ERROR(
+        hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "HG_Test_init() failed");
+
+    hg_replay_options.window = hg_test_info.handle_max;
+    if (hg_replay_parse_options(argc, argv, &hg_replay_options) !=
+        HG_UTIL_SUCCESS) {
+        if (hg_test_info.na_test_info.mpi_comm_rank == 0)
+            hg_replay_usage(argv[0]);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Histograms are too large for the stack */
+    hg_replay = (struct hg_replay *) calloc(1, sizeof(*hg_replay));
+    HG_TEST_CHECK_ERROR(hg_replay == NULL, done, ret, EXIT_FAILURE,
+        "Could not allocate replay");
+
+    hg_ret = hg_replay_load(hg_replay_options.capture, hg_replay_options.limit,
+        &hg_replay->records, &hg_replay->count);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "hg_replay_load() failed (%s)", HG_Error_to_string(hg_ret));
+
+    hg_ret = hg_replay_init(hg_replay, &hg_test_info, hg_replay_options.window);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "hg_replay_init() failed (%s)", HG_Error_to_string(hg_ret));
+
+    hg_ret = hg_replay_run(
+        hg_replay, &hg_test_info, hg_replay_options.speed, &time);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "hg_replay_run() failed (%s)", HG_Error_to_string(hg_ret));
+    if (hg_replay->errors > 0)
+        ret = EXIT_FAILURE;
+
+    captured_time =
+        (double) (hg_replay->records[hg_replay->count - 1].time -
+                  hg_replay->records[0].time) /
+        1000000000.0;
+    printf("# hg_replay of %s (speed %.2f, window %u)\n",
+        hg_replay_options.capture, hg_replay_options.speed,
+        hg_replay_options.window);
+    printf("%-10s %12s %12s %10s %10s %10s\n", "", "Time (s)", "Rate (op/s)",
+        "p50 (us)", "p99 (us)", "p999 (us)");
+    printf("%-10s %12.3f %12.1f %10.2f %10.2f %10.2f\n", "captured",
+        captured_time,
+        (captured_time > 0.0) ? (double) hg_replay->count / captured_time
+                              : 0.0,
+        (double) hg_histogram_percentile(&hg_replay->captured, 50.0) / 1000.0,
+        (double) hg_histogram_percentile(&hg_replay->captured, 99.0) / 1000.0,
+        (double) hg_histogram_percentile(&hg_replay->captured, 99.9) / 1000.0);
+    printf("%-10s %12.3f %12.1f %10.2f %10.2f %10.2f\n", "replayed", time,
+        (time > 0.0) ? (double) hg_replay->count / time : 0.0,
+        (double) hg_histogram_percentile(&hg_replay->latency, 50.0) / 1000.0,
+        (double) hg_histogram_percentile(&hg_replay->latency, 99.0) / 1000.0,
+        (double) hg_histogram_percentile(&hg_replay->latency, 99.9) / 1000.0);
+    printf("# %zu records, %lu errors, %lu clamped to %zu bytes (use -z), "
+           "issue lag p50 %.2f us p99 %.2f us\n",
+        hg_replay->count, hg_replay->errors, hg_replay->clamped,
+        (size_t) hg_test_info.buf_size_max,
+        (double) hg_histogram_percentile(&hg_replay->lag, 50.0) / 1000.0,
+        (double) hg_histogram_percentile(&hg_replay->lag, 99.0) / 1000.0);
+
+done:
+    if (hg_replay) {
+        hg_replay_finalize(hg_replay);
+        free(hg_replay->records);
+        free(hg_replay);
+    }
+
+    hg_ret = HG_Test_finalize(&hg_test_info);
+    HG_TEST_CHECK_ERROR_DONE(hg_ret != HG_SUCCESS, "HG_Test_finalize() failed");
+
+    return ret;
+}
@@ -10,8 +10,15 @@
 
 #include "mercury_test.h"
 
+#include "mercury_auth.h"
+#include "mercury_collective.h"
+#include "mercury_hl.h"
+#include "mercury_introspect.h"
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 /****************/
 /* Local Macros */
@@ -20,6 +27,31 @@
 /* Do not use HG_TEST_MAX_HANDLES for that and keep it fixed */
 #define NINFLIGHT (16)
 
+/* Number of targets and fan-out of collective tests */
+#define NCOLLECTIVE        (7)
+#define NCOLLECTIVE_FANOUT (2)
+
+/* Number of one-way RPCs sent back to back */
+#define NONEWAY (64)
+
+/* Number of starts of a persistent RPC */
+#define NPERSISTENT (32)
+
+/* Number of futures in flight */
+#define NFUTURE (16)
+
+/* Number of RPCs forwarded through an engine */
+#define NENGINE (16)
+
+/* Number of RPCs in flight when testing admission control */
+#define NADMIT (64)
+
+/* Number of RPCs canceled at once */
+#define NCANCEL (4)
+
+/* Size of trace context sent by instrumentation hooks */
+#define NTRACE_CTX (16)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -29,11 +61,51 @@ struct forward_cb_args {
     rpc_handle_t *rpc_handle;
 };
 
+struct overflow_resp_cb_args {
+    hg_request_t *request;
+    hg_uint64_t string_len;
+    hg_return_t ret;
+};
+
 struct lookup_cb_args {
     hg_request_t *request;
     hg_addr_t *addr_ptr;
 };
 
+struct introspect_cb_args {
+    hg_request_t *request;
+    hg_bool_t listening;
+    hg_bool_t received;
+};
+
+struct cached_cb_args {
+    hg_request_t *request;
+    hg_int32_t count;
+};
+
+struct stream_cb_args {
+    hg_request_t *request;
+    hg_int32_t chunks;
+    hg_int32_t count;
+};
+
+struct admit_cb_args {
+    hg_request_t *request;
+    hg_atomic_int32_t completed;
+    hg_atomic_int32_t rejected;
+};
+
+struct admit_target {
+    hg_context_t *context;
+    hg_handle_t handles[NADMIT];
+    unsigned int count;
+};
+
+struct hook_args {
+    hg_atomic_int32_t counts[HG_HOOK_MAX];
+    hg_atomic_int32_t trace_ctx_matched;
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -57,6 +129,21 @@ static hg_return_t
 hg_test_rpc(hg_context_t *context, hg_request_class_t *request_class,
     hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback);
 static hg_return_t
+hg_test_rpc_oneway(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id);
+static hg_return_t
+hg_test_rpc_persistent(hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, hg_id_t rpc_id);
+static hg_return_t
+hg_test_rpc_future_cb(const struct hg_cb_info *callback_info);
+static hg_return_t
+hg_test_rpc_future(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id);
+static hg_return_t
+hg_test_rpc_engine_cb(const struct hg_cb_info *callback_info);
+static hg_return_t
+hg_test_rpc_engine(hg_class_t *hg_class, hg_addr_t addr);
+static hg_return_t
 hg_test_rpc_lookup(hg_context_t *context, hg_request_class_t *request_class,
     const char *target_name, hg_id_t rpc_id, hg_cb_t callback);
 static hg_return_t
@@ -72,10 +159,72 @@ hg_test_rpc_multiple(hg_context_t *context, hg_request_class_t *request_class,
 static hg_return_t
 hg_test_overflow(hg_context_t *context, hg_request_class_t *request_class,
     hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback);
+static hg_return_t
+hg_test_rpc_forward_overflow_resp_cb(const struct hg_cb_info *callback_info);
+static hg_return_t
+hg_test_overflow_resp(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_bool_t self);
 #endif
 static hg_return_t
+hg_test_rpc_forward_cached_cb(const struct hg_cb_info *callback_info);
+static hg_return_t
+hg_test_rpc_cached(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id);
+static hg_return_t
+hg_test_rpc_stream_chunk_cb(const struct hg_cb_info *callback_info);
+static hg_return_t
+hg_test_rpc_forward_stream_cb(const struct hg_cb_info *callback_info);
+static hg_return_t
+hg_test_rpc_stream(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_int32_t count);
+static hg_return_t
 hg_test_cancel_rpc(hg_context_t *context, hg_request_class_t *request_class,
     hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback);
+static hg_return_t
+hg_test_cancel_all_rpc(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, hg_id_t rpc_id,
+    hg_cb_t callback);
+static hg_return_t
+hg_test_timeout_rpc(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback);
+static hg_return_t
+hg_test_rpc_hedged(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback, unsigned int delay);
+static hg_return_t
+hg_test_rpc_batch(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback);
+static hg_return_t
+hg_test_rpc_gather_cb(const struct hg_collective_cb_info *callback_info);
+static hg_return_t
+hg_test_rpc_gather(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id);
+static hg_return_t
+hg_test_rpc_stats(hg_class_t *hg_class, hg_context_t *context, hg_id_t rpc_id);
+static hg_return_t
+hg_test_auth_acquire_cb(
+    hg_uint32_t credential, void *arg, char *key, hg_size_t *key_size);
+static hg_return_t
+hg_test_auth_key(void);
+static hg_return_t
+hg_test_rpc_latency(hg_class_t *hg_class, hg_id_t rpc_id);
+static hg_return_t
+hg_test_rpc_load(hg_class_t *hg_class, hg_addr_t addr, hg_bool_t self);
+static hg_return_t
+hg_test_rpc_admit_rpc_cb(hg_handle_t handle);
+static hg_return_t
+hg_test_rpc_admit_cb(const struct hg_cb_info *callback_info);
+static void
+hg_test_rpc_admit_progress(
+    struct admit_target *target, struct admit_cb_args *args);
+static hg_return_t
+hg_test_rpc_admit(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, const char *comm,
+    const char *protocol, unsigned int active_max);
+static hg_return_t
+hg_test_introspect_cb(const struct hg_introspect_cb_info *callback_info);
+static hg_return_t
+hg_test_introspect(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_uint8_t target_id, hg_bool_t listening);
 
 /*******************/
 /* Local Variables */
@@ -83,9 +232,15 @@ hg_test_cancel_rpc(hg_context_t *context, hg_request_class_t *request_class,
 
 extern hg_id_t hg_test_rpc_null_id_g;
 extern hg_id_t hg_test_rpc_open_id_g;
+extern hg_id_t hg_test_rpc_await_id_g;
 extern hg_id_t hg_test_rpc_open_id_no_resp_g;
 extern hg_id_t hg_test_overflow_id_g;
+extern hg_id_t hg_test_overflow_codec_id_g;
+extern hg_id_t hg_test_overflow_resp_id_g;
 extern hg_id_t hg_test_cancel_rpc_id_g;
+extern hg_id_t hg_test_rpc_cached_id_g;
+extern hg_id_t hg_test_rpc_stream_id_g;
+extern hg_id_t hg_test_rpc_relay_id_g;
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
@@ -233,8 +388,133 @@ done:
     hg_request_complete(request);
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_forward_overflow_resp_cb(const struct hg_cb_info *callback_info)
+{
+    hg_handle_t handle = callback_info->info.forward.handle;
+    struct overflow_resp_cb_args *args =
+        (struct overflow_resp_cb_args *) callback_info->arg;
+    overflow_out_t out_struct;
+    hg_return_t ret = callback_info->ret, cleanup_ret;
+    size_t i;
+
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+
+    /* Get output */
+    ret = HG_Get_output(handle, &out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_output() failed (%s)", HG_Error_to_string(ret));
+
+    /* Output decoded from response buffer must be intact */
+    for (i = 0; i < out_struct.string_len && out_struct.string[i] == 'h'; i++)
+        continue;
+    if (i != args->string_len || out_struct.string[i] != '\0') {
+        HG_TEST_LOG_ERROR("Returned string does not match");
+        ret = HG_FAULT;
+    }
+
+    cleanup_ret = HG_Free_output(handle, &out_struct);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Free_output() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+done:
+    args->ret = ret;
+    hg_request_complete(args->request);
+    return HG_SUCCESS;
+}
 #endif
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_forward_cached_cb(const struct hg_cb_info *callback_info)
+{
+    hg_handle_t handle = callback_info->info.forward.handle;
+    struct cached_cb_args *args = (struct cached_cb_args *) callback_info->arg;
+    rpc_open_out_t rpc_open_out_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    args->count = 0;
+    HG_TEST_CHECK_ERROR_NORET(callback_info->ret != HG_SUCCESS, done,
+        "Error in HG callback (%s)", HG_Error_to_string(callback_info->ret));
+
+    /* Get output */
+    ret = HG_Get_output(handle, &rpc_open_out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_output() failed (%s)", HG_Error_to_string(ret));
+
+    args->count = rpc_open_out_struct.ret;
+
+    /* Free request */
+    ret = HG_Free_output(handle, &rpc_open_out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Free_output() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    hg_request_complete(args->request);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_stream_chunk_cb(const struct hg_cb_info *callback_info)
+{
+    hg_handle_t handle = callback_info->info.forward.handle;
+    struct stream_cb_args *args = (struct stream_cb_args *) callback_info->arg;
+    rpc_open_out_t rpc_open_out_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_TEST_CHECK_ERROR_NORET(callback_info->ret != HG_SUCCESS, done,
+        "Error in HG callback (%s)", HG_Error_to_string(callback_info->ret));
+
+    /* Chunk output is only valid within the callback */
+    ret = HG_Get_output(handle, &rpc_open_out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_output() failed (%s)", HG_Error_to_string(ret));
+
+    /* Chunks must arrive in order */
+    if (rpc_open_out_struct.event_id == args->chunks)
+        args->chunks++;
+
+    ret = HG_Free_output(handle, &rpc_open_out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Free_output() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_forward_stream_cb(const struct hg_cb_info *callback_info)
+{
+    hg_handle_t handle = callback_info->info.forward.handle;
+    struct stream_cb_args *args = (struct stream_cb_args *) callback_info->arg;
+    rpc_open_out_t rpc_open_out_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    args->count = -1;
+    HG_TEST_CHECK_ERROR_NORET(callback_info->ret != HG_SUCCESS, done,
+        "Error in HG callback (%s)", HG_Error_to_string(callback_info->ret));
+
+    /* Get final output */
+    ret = HG_Get_output(handle, &rpc_open_out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_output() failed (%s)", HG_Error_to_string(ret));
+
+    args->count = rpc_open_out_struct.ret;
+
+    ret = HG_Free_output(handle, &rpc_open_out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Free_output() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    hg_request_complete(args->request);
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_rpc_forward_cancel_cb(const struct hg_cb_info *callback_info)
@@ -254,6 +534,78 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_forward_timeout_cb(const struct hg_cb_info *callback_info)
+{
+    hg_request_t *request = (hg_request_t *) callback_info->arg;
+    hg_bool_t *timed_out = (hg_bool_t *) hg_request_get_data(request);
+
+    *timed_out = (callback_info->ret == HG_TIMEOUT);
+    HG_TEST_CHECK_ERROR_DONE(callback_info->ret != HG_TIMEOUT,
+        "Expected HG_TIMEOUT, got (%s)",
+        HG_Error_to_string(callback_info->ret));
+
+    hg_request_complete(request);
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_gather_cb(const struct hg_collective_cb_info *callback_info)
+{
+    hg_request_t *request = (hg_request_t *) callback_info->arg;
+    hg_bool_t *gathered = (hg_bool_t *) hg_request_get_data(request);
+    const rpc_open_out_t *out_structs =
+        (const rpc_open_out_t *) callback_info->out_structs;
+    hg_uint32_t i;
+
+    HG_TEST_CHECK_ERROR_NORET(callback_info->ret != HG_SUCCESS, done,
+        "Error in HG collective callback (%s), %u target(s) failed",
+        HG_Error_to_string(callback_info->ret), callback_info->failed);
+    HG_TEST_CHECK_ERROR_NORET(callback_info->count != NCOLLECTIVE, done,
+        "Expected %d results, got %u", NCOLLECTIVE, callback_info->count);
+
+    for (i = 0; i < callback_info->count; i++)
+        HG_TEST_CHECK_ERROR_NORET(out_structs[i].event_id != 100, done,
+            "Event ID of target %u is %d, expected 100", i,
+            out_structs[i].event_id);
+
+    *gathered = HG_TRUE;
+
+done:
+    hg_request_complete(request);
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_introspect_cb(const struct hg_introspect_cb_info *callback_info)
+{
+    struct introspect_cb_args *args =
+        (struct introspect_cb_args *) callback_info->arg;
+    const struct hg_introspect_info *info = callback_info->info;
+
+    HG_TEST_CHECK_ERROR_NORET(callback_info->ret != HG_SUCCESS, done,
+        "Error in HG introspect callback (%s)",
+        HG_Error_to_string(callback_info->ret));
+
+    /* Target has at least served the RPCs of previous tests */
+    HG_TEST_CHECK_ERROR_NORET(info->class_stats.handle_count == 0 ||
+                                  info->rpc_count == 0,
+        done, "No RPC was accounted by target");
+    /* Only listening targets post requests */
+    HG_TEST_CHECK_ERROR_NORET(
+        args->listening && info->context_stats.posted_count == 0, done,
+        "No request posted by target");
+
+    args->received = HG_TRUE;
+
+done:
+    hg_request_complete(args->request);
+    return HG_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_rpc_null(
@@ -351,52 +703,303 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_test_rpc_lookup(hg_context_t *context, hg_request_class_t *request_class,
-    const char *target_name, hg_id_t rpc_id, hg_cb_t callback)
+hg_test_rpc_oneway(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id)
+{
+    hg_const_string_t rpc_open_path = HG_TEST_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_t rpc_open_in_struct;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    rpc_open_in_struct.path = rpc_open_path;
+    rpc_open_in_struct.handle.cookie = 100;
+
+    /* No handle or callback, sends complete during later progress */
+    HG_TEST_LOG_DEBUG("Sending one-way rpc_open, op id: %u...", rpc_id);
+    for (i = 0; i < NONEWAY; i++) {
+        ret = HG_Send_oneway(context, addr, rpc_id, &rpc_open_in_struct);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Send_oneway() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    /* Regular RPC to the same target completes after the one-way sends */
+    ret = hg_test_rpc(context, request_class, addr, hg_test_rpc_open_id_g,
+        hg_test_rpc_forward_cb);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "hg_test_rpc() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_persistent(hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, hg_id_t rpc_id)
 {
     hg_request_t *request = NULL;
     hg_handle_t handle = HG_HANDLE_NULL;
-    hg_return_t ret = HG_SUCCESS;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
     struct forward_cb_args forward_cb_args;
     hg_const_string_t rpc_open_path = HG_TEST_TEMP_DIRECTORY "/test.h5";
     rpc_handle_t rpc_open_handle;
     rpc_open_in_t rpc_open_in_struct;
-    hg_addr_t target_addr = HG_ADDR_NULL;
-    int i;
-
-    for (i = 0; i < 32; i++) {
-        struct lookup_cb_args lookup_args;
-        unsigned int flag = 0;
+    unsigned int i;
 
-        request = hg_request_create(request_class);
+    request = hg_request_create(request_class);
 
-        /* Look up target addr using target name info */
-        lookup_args.addr_ptr = &target_addr;
-        lookup_args.request = request;
+    ret = HG_Create(context, addr, rpc_id, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
 
-        /* Forward call to remote addr and get a new request */
-        ret = HG_Addr_lookup1(context, hg_test_rpc_lookup_cb, &lookup_args,
-            target_name, HG_OP_ID_IGNORE);
-        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Addr_lookup1() failed (%s)",
-            HG_Error_to_string(ret));
+    forward_cb_args.request = request;
+    forward_cb_args.rpc_handle = &rpc_open_handle;
+    ret = HG_Forward_init(handle, hg_test_rpc_forward_cb, &forward_cb_args);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward_init() failed (%s)", HG_Error_to_string(ret));
 
-        /* Wait for request to be marked completed */
-        hg_request_wait(request, HG_MAX_IDLE_TIME, &flag);
-        HG_TEST_CHECK_ERROR(
-            flag == 0, done, ret, HG_TIMEOUT, "Operation did not complete");
+    /* Each start carries a new cookie that must come back in its response */
+    HG_TEST_LOG_DEBUG("Starting persistent rpc_open, op id: %u...", rpc_id);
+    for (i = 0; i < NPERSISTENT; i++) {
+        rpc_open_handle.cookie = 100 + i;
+        rpc_open_in_struct.path = rpc_open_path;
+        rpc_open_in_struct.handle = rpc_open_handle;
 
-        /* Reset request */
         hg_request_reset(request);
+        ret = HG_Forward_start(handle, &rpc_open_in_struct);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Forward_start() failed (%s)",
+            HG_Error_to_string(ret));
 
-        /* Create RPC request */
-        ret = HG_Create(context, target_addr, rpc_id, &handle);
-        HG_TEST_CHECK_HG_ERROR(
-            done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+        hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+    }
 
-        /* Fill input structure */
-        rpc_open_handle.cookie = 100;
-        rpc_open_in_struct.path = rpc_open_path;
-        rpc_open_in_struct.handle = rpc_open_handle;
+done:
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    hg_request_destroy(request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_future_cb(const struct hg_cb_info *callback_info)
+{
+    hg_handle_t handle = callback_info->info.forward.handle;
+    rpc_handle_t *rpc_handle = (rpc_handle_t *) callback_info->arg;
+    rpc_open_out_t rpc_open_out_struct;
+    hg_return_t ret;
+
+    if (callback_info->ret != HG_SUCCESS)
+        return callback_info->ret;
+
+    ret = HG_Get_output(handle, &rpc_open_out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_output() failed (%s)", HG_Error_to_string(ret));
+
+    if (rpc_open_out_struct.event_id != (int) rpc_handle->cookie) {
+        HG_TEST_LOG_ERROR("Cookie did not match RPC response");
+        ret = HG_FAULT;
+    }
+
+    (void) HG_Free_output(handle, &rpc_open_out_struct);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_future(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id)
+{
+    hg_handle_t handles[NFUTURE];
+    hg_future_t *futures[NFUTURE];
+    rpc_handle_t rpc_open_handles[NFUTURE];
+    hg_const_string_t rpc_open_path = HG_TEST_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_t rpc_open_in_struct;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    unsigned int i, index = NFUTURE;
+
+    for (i = 0; i < NFUTURE; i++) {
+        handles[i] = HG_HANDLE_NULL;
+        futures[i] = NULL;
+    }
+
+    HG_TEST_LOG_DEBUG("Forwarding %d rpc_open futures...", NFUTURE);
+    for (i = 0; i < NFUTURE; i++) {
+        ret = HG_Create(context, addr, rpc_id, &handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+        rpc_open_handles[i].cookie = 200 + i;
+        rpc_open_in_struct.path = rpc_open_path;
+        rpc_open_in_struct.handle = rpc_open_handles[i];
+
+        ret = HG_Hl_forward_async(
+            request_class, handles[i], &rpc_open_in_struct, &futures[i]);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Hl_forward_async() failed (%s)",
+            HG_Error_to_string(ret));
+
+        ret = HG_Hl_future_then(
+            futures[i], hg_test_rpc_future_cb, &rpc_open_handles[i]);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Hl_future_then() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    ret = HG_Hl_future_wait_any(NFUTURE, futures, HG_MAX_IDLE_TIME, &index);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Hl_future_wait_any() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(index >= NFUTURE ||
+                            !HG_Hl_future_completed(futures[index]),
+        done, ret, HG_FAULT, "Future %u did not complete", index);
+
+    ret = HG_Hl_future_wait_all(NFUTURE, futures, HG_MAX_IDLE_TIME);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Hl_future_wait_all() failed (%s)",
+        HG_Error_to_string(ret));
+
+    for (i = 0; i < NFUTURE; i++) {
+        ret = HG_Hl_future_get_return(futures[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "Future %u failed (%s)", i, HG_Error_to_string(ret));
+    }
+
+done:
+    /* Pending futures cannot be freed */
+    if (ret != HG_SUCCESS)
+        (void) HG_Hl_future_wait_all(NFUTURE, futures, HG_MAX_IDLE_TIME);
+
+    for (i = 0; i < NFUTURE; i++) {
+        if (futures[i])
+            (void) HG_Hl_future_free(futures[i]);
+        if (handles[i] == HG_HANDLE_NULL)
+            continue;
+        cleanup_ret = HG_Destroy(handles[i]);
+        HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+            "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_engine_cb(const struct hg_cb_info *callback_info)
+{
+    hg_atomic_int32_t *completed = (hg_atomic_int32_t *) callback_info->arg;
+
+    HG_TEST_CHECK_ERROR_NORET(callback_info->ret != HG_SUCCESS, done,
+        "Error in HG callback (%s)", HG_Error_to_string(callback_info->ret));
+
+    hg_atomic_incr32(completed);
+
+done:
+    (void) HG_Destroy(callback_info->info.forward.handle);
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_engine(hg_class_t *hg_class, hg_addr_t addr)
+{
+    struct hg_engine_info engine_info = {0};
+    hg_engine_t *engine = NULL;
+    hg_atomic_int32_t completed;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    int cpus[1] = {0};
+    unsigned int i;
+
+    /* Pinned progress threads hand callbacks off to a handler thread */
+    engine_info.progress_count = 2;
+    engine_info.handler_count = 1;
+    engine_info.cpus = cpus;
+    engine_info.cpu_count = 1;
+    engine_info.drain_timeout = 10000;
+    engine = HG_Engine_create(hg_class, &engine_info);
+    HG_TEST_CHECK_ERROR(engine == NULL, done, ret, HG_NOMEM,
+        "HG_Engine_create() failed");
+    hg_atomic_init32(&completed, 0);
+
+    for (i = 0; i < NENGINE; i++) {
+        hg_handle_t handle;
+
+        ret = HG_Create(HG_Engine_get_context(engine, 0), addr,
+            hg_test_rpc_null_id_g, &handle);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+        ret = HG_Forward(handle, hg_test_rpc_engine_cb, &completed, NULL);
+        if (ret != HG_SUCCESS)
+            (void) HG_Destroy(handle);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+    }
+
+done:
+    /* Forwards in flight complete before threads are stopped */
+    cleanup_ret = HG_Engine_destroy(engine);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Engine_destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    if (ret == HG_SUCCESS && hg_atomic_get32(&completed) != NENGINE) {
+        HG_TEST_LOG_ERROR("Only %d RPCs out of %d completed",
+            hg_atomic_get32(&completed), NENGINE);
+        ret = HG_FAULT;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_lookup(hg_context_t *context, hg_request_class_t *request_class,
+    const char *target_name, hg_id_t rpc_id, hg_cb_t callback)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_return_t ret = HG_SUCCESS;
+    struct forward_cb_args forward_cb_args;
+    hg_const_string_t rpc_open_path = HG_TEST_TEMP_DIRECTORY "/test.h5";
+    rpc_handle_t rpc_open_handle;
+    rpc_open_in_t rpc_open_in_struct;
+    hg_addr_t target_addr = HG_ADDR_NULL;
+    int i;
+
+    for (i = 0; i < 32; i++) {
+        struct lookup_cb_args lookup_args;
+        unsigned int flag = 0;
+
+        request = hg_request_create(request_class);
+
+        /* Look up target addr using target name info */
+        lookup_args.addr_ptr = &target_addr;
+        lookup_args.request = request;
+
+        /* Forward call to remote addr and get a new request */
+        ret = HG_Addr_lookup1(context, hg_test_rpc_lookup_cb, &lookup_args,
+            target_name, HG_OP_ID_IGNORE);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Addr_lookup1() failed (%s)",
+            HG_Error_to_string(ret));
+
+        /* Wait for request to be marked completed */
+        hg_request_wait(request, HG_MAX_IDLE_TIME, &flag);
+        HG_TEST_CHECK_ERROR(
+            flag == 0, done, ret, HG_TIMEOUT, "Operation did not complete");
+
+        /* Reset request */
+        hg_request_reset(request);
+
+        /* Create RPC request */
+        ret = HG_Create(context, target_addr, rpc_id, &handle);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+        /* Fill input structure */
+        rpc_open_handle.cookie = 100;
+        rpc_open_in_struct.path = rpc_open_path;
+        rpc_open_in_struct.handle = rpc_open_handle;
 
         /* Forward call to remote addr and get a new request */
         HG_TEST_LOG_DEBUG("Forwarding rpc_open, op id: %u...", rpc_id);
@@ -695,121 +1298,1036 @@ done:
 
     return ret;
 }
-#endif
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_test_cancel_rpc(hg_context_t *context, hg_request_class_t *request_class,
-    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback)
+hg_test_overflow_resp(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_bool_t self)
 {
     hg_request_t *request = NULL;
     hg_handle_t handle = HG_HANDLE_NULL;
+    hg_bulk_t bulk = HG_BULK_NULL;
+    struct overflow_resp_cb_args args;
+    overflow_in_t in_struct;
+    hg_size_t eager_size = HG_Class_get_output_eager_size(context->hg_class);
+    hg_size_t buf_size = eager_size * 4;
+    char *buf = NULL;
+    unsigned int flag = 0;
+    hg_bool_t in_flight = HG_FALSE;
     hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    hg_size_t i;
 
     request = hg_request_create(request_class);
 
+    buf = (char *) calloc(1, buf_size);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate buffer");
+
+    ret = HG_Bulk_create(context->hg_class, 1, (void **) &buf, &buf_size,
+        HG_BULK_READWRITE, &bulk);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
     /* Create RPC request */
     ret = HG_Create(context, addr, rpc_id, &handle);
     HG_TEST_CHECK_HG_ERROR(
         done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
 
-    /* Forward call to remote addr and get a new request */
+    /* Let target write output into buffer */
+    ret = HG_Set_output_bulk(handle, bulk);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Set_output_bulk() failed (%s)", HG_Error_to_string(ret));
+
+    /* Output does not fit into the response message */
+    in_struct.string_len = eager_size * 2;
+    args.request = request;
+    args.string_len = in_struct.string_len;
+    args.ret = HG_SUCCESS;
+
     HG_TEST_LOG_DEBUG("Forwarding RPC, op id: %u...", rpc_id);
-    ret = HG_Forward(handle, callback, request, NULL);
+    ret = HG_Forward(
+        handle, hg_test_rpc_forward_overflow_resp_cb, &args, &in_struct);
     HG_TEST_CHECK_HG_ERROR(
         done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
 
-    /* Cancel request before making progress, this ensures that the RPC has not
-     * completed yet. */
-    ret = HG_Cancel(handle);
-    HG_TEST_CHECK_HG_ERROR(
-        done, ret, "HG_Cancel() failed (%s)", HG_Error_to_string(ret));
+    /* Buffer may still be written to and request completed until the RPC
+     * completes */
+    hg_request_wait(request, HG_MAX_IDLE_TIME, &flag);
+    in_flight = (flag == 0);
+    HG_TEST_CHECK_ERROR(
+        in_flight, done, ret, HG_TIMEOUT, "Operation did not complete");
 
-    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+    ret = args.ret;
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Overflow output was not received (%s)",
+        HG_Error_to_string(ret));
+
+    /* Output was pushed to the buffer, unless target is ourself */
+    for (i = 0; i < buf_size; i++)
+        if (buf[i] == 'h')
+            break;
+    HG_TEST_CHECK_ERROR(!self && i == buf_size, done, ret, HG_FAULT,
+        "Output was not written to response buffer");
 
 done:
     cleanup_ret = HG_Destroy(handle);
     HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
         "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
 
+    /* Leave resources that are still in use */
+    if (in_flight)
+        return ret;
+
+    cleanup_ret = HG_Bulk_free(bulk);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Bulk_free() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    free(buf);
     hg_request_destroy(request);
 
     return ret;
 }
+#endif
 
 /*---------------------------------------------------------------------------*/
-int
-main(int argc, char *argv[])
+static hg_return_t
+hg_test_rpc_cached(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id)
 {
-    struct hg_test_info hg_test_info = {0};
-    hg_return_t hg_ret;
-    hg_id_t inv_id;
-    int ret = EXIT_SUCCESS;
+    hg_request_t *request = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    struct cached_cb_args cached_cb_args;
+    hg_const_string_t rpc_open_path = HG_TEST_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_t rpc_open_in_struct;
+    hg_int32_t counts[3];
+    unsigned int i;
 
-    /* Initialize the interface */
-    hg_ret = HG_Test_init(argc, argv, &hg_test_info);
-    HG_TEST_CHECK_ERROR(
-        hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "HG_Test_init() failed");
+    request = hg_request_create(request_class);
 
-    /* NULL RPC test */
-    HG_TEST("NULL RPC");
-    hg_ret = hg_test_rpc_null(hg_test_info.context, hg_test_info.request_class,
-        hg_test_info.target_addr);
-    HG_TEST_CHECK_ERROR(
-        hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "NULL RPC test failed");
-    HG_PASSED();
+    /* Create RPC request */
+    ret = HG_Create(context, addr, rpc_id, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
 
-    /* Simple RPC test */
-    HG_TEST("simple RPC");
-    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
-        hg_test_info.target_addr, hg_test_rpc_open_id_g,
-        hg_test_rpc_forward_cb);
-    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
-        "simple RPC test failed");
-    HG_PASSED();
+    /* Same input is sent twice, then a different input */
+    rpc_open_in_struct.path = rpc_open_path;
+    cached_cb_args.request = request;
+    for (i = 0; i < 3; i++) {
+        rpc_open_in_struct.handle.cookie = (i < 2) ? 200 : 201;
 
-    /* RPC test with lookup/free */
-    if (!hg_test_info.na_test_info.self_send &&
-        strcmp(HG_Class_get_name(hg_test_info.hg_class), "mpi")) {
-        hg_request_t *request = NULL;
-        struct lookup_cb_args lookup_args;
-        unsigned int flag = 0;
+        hg_request_reset(request);
+        ret = HG_Forward(handle, hg_test_rpc_forward_cached_cb,
+            &cached_cb_args, &rpc_open_in_struct);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
 
-        HG_Addr_free(hg_test_info.hg_class, hg_test_info.target_addr);
-        hg_test_info.target_addr = HG_ADDR_NULL;
+        hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+        counts[i] = cached_cb_args.count;
+    }
 
-        HG_TEST("lookup RPC");
-        hg_ret = hg_test_rpc_lookup(hg_test_info.context,
-            hg_test_info.request_class, hg_test_info.na_test_info.target_name,
-            hg_test_rpc_open_id_g, hg_test_rpc_forward_cb);
-        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
-            "lookup test failed");
-        HG_PASSED();
+    HG_TEST_CHECK_ERROR(counts[0] == 0 || counts[1] != counts[0], done, ret,
+        HG_FAULT, "Response was not cached (%d, %d)", counts[0], counts[1]);
+    HG_TEST_CHECK_ERROR(counts[2] == counts[0], done, ret, HG_FAULT,
+        "Cached response was returned for different input");
 
-        request = hg_request_create(hg_test_info.request_class);
+done:
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
 
-        /* Look up target addr using target name info */
-        lookup_args.addr_ptr = &hg_test_info.target_addr;
-        lookup_args.request = request;
+    hg_request_destroy(request);
 
-        /* Forward call to remote addr and get a new request */
-        hg_ret = HG_Addr_lookup1(hg_test_info.context, hg_test_rpc_lookup_cb,
-            &lookup_args, hg_test_info.na_test_info.target_name,
-            HG_OP_ID_IGNORE);
-        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
-            "HG_Addr_lookup1() failed (%s)", HG_Error_to_string(hg_ret));
+    return ret;
+}
 
-        /* Wait for request to be marked completed */
-        hg_request_wait(request, HG_MAX_IDLE_TIME, &flag);
-        HG_TEST_CHECK_ERROR(
-            flag == 0, done, ret, EXIT_FAILURE, "Operation did not complete");
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_stream(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_int32_t count)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    struct stream_cb_args stream_cb_args;
+    hg_const_string_t rpc_open_path = HG_TEST_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_t rpc_open_in_struct;
 
-        /* Destroy request */
-        hg_request_destroy(request);
-    }
+    request = hg_request_create(request_class);
 
-    /* RPC reset test */
-    HG_TEST("RPC reset");
+    /* Create RPC request */
+    ret = HG_Create(context, addr, rpc_id, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Cookie gives the number of chunks to stream back */
+    rpc_open_in_struct.path = rpc_open_path;
+    rpc_open_in_struct.handle.cookie = (hg_uint64_t) count;
+    stream_cb_args.request = request;
+    stream_cb_args.chunks = 0;
+    stream_cb_args.count = 0;
+
+    HG_TEST_LOG_DEBUG("Forwarding streamed rpc_open, chunks: %d...", count);
+    ret = HG_Forward_stream(handle, hg_test_rpc_stream_chunk_cb,
+        &stream_cb_args, hg_test_rpc_forward_stream_cb, &stream_cb_args,
+        &rpc_open_in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward_stream() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    HG_TEST_CHECK_ERROR(stream_cb_args.count != count ||
+                            stream_cb_args.chunks != count,
+        done, ret, HG_FAULT, "Received %d/%d chunks (expected %d)",
+        stream_cb_args.chunks, stream_cb_args.count, count);
+
+done:
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    hg_request_destroy(request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_cancel_rpc(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+
+    request = hg_request_create(request_class);
+
+    /* Create RPC request */
+    ret = HG_Create(context, addr, rpc_id, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Forward call to remote addr and get a new request */
+    HG_TEST_LOG_DEBUG("Forwarding RPC, op id: %u...", rpc_id);
+    ret = HG_Forward(handle, callback, request, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    /* Cancel request before making progress, this ensures that the RPC has not
+     * completed yet. */
+    ret = HG_Cancel(handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Cancel() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+done:
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    hg_request_destroy(request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_cancel_all_rpc(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, hg_id_t rpc_id,
+    hg_cb_t callback)
+{
+    hg_request_t *requests[NCANCEL] = {NULL};
+    hg_handle_t handles[NCANCEL] = {HG_HANDLE_NULL};
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    unsigned int i;
+
+    /* Target never responds to that RPC, canceling must complete them all */
+    for (i = 0; i < NCANCEL; i++) {
+        requests[i] = hg_request_create(request_class);
+
+        ret = HG_Create(context, addr, rpc_id, &handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+        HG_TEST_LOG_DEBUG("Forwarding RPC, op id: %u...", rpc_id);
+        ret = HG_Forward(handles[i], callback, requests[i], NULL);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    ret = HG_Addr_cancel_all(hg_class, addr, HG_FALSE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Addr_cancel_all() failed (%s)",
+        HG_Error_to_string(ret));
+
+    for (i = 0; i < NCANCEL; i++)
+        hg_request_wait(requests[i], HG_MAX_IDLE_TIME, NULL);
+
+done:
+    for (i = 0; i < NCANCEL; i++) {
+        if (handles[i] != HG_HANDLE_NULL) {
+            cleanup_ret = HG_Destroy(handles[i]);
+            HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+                "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+        }
+        if (requests[i] != NULL)
+            hg_request_destroy(requests[i]);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_timeout_rpc(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_bool_t timed_out = HG_FALSE;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+
+    request = hg_request_create(request_class);
+    hg_request_set_data(request, &timed_out);
+
+    /* Create RPC request */
+    ret = HG_Create(context, addr, rpc_id, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Target never responds to that RPC, deadline must cancel it */
+    HG_TEST_LOG_DEBUG("Forwarding RPC, op id: %u...", rpc_id);
+    ret = HG_Forward_timed(handle, callback, request, NULL, 100);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward_timed() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+    HG_TEST_CHECK_ERROR(
+        !timed_out, done, ret, HG_FAULT, "RPC did not time out");
+
+done:
+    cleanup_ret = HG_Destroy(handle);
+    HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+
+    hg_request_destroy(request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_hedged(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback, unsigned int delay)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handles[2] = {HG_HANDLE_NULL, HG_HANDLE_NULL};
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+    struct forward_cb_args forward_cb_args;
+    hg_const_string_t rpc_open_path = HG_TEST_TEMP_DIRECTORY "/test.h5";
+    rpc_handle_t rpc_open_handle;
+    rpc_open_in_t rpc_open_in_struct;
+    unsigned int i;
+
+    request = hg_request_create(request_class);
+
+    /* Primary and replica target the same server */
+    for (i = 0; i < 2; i++) {
+        ret = HG_Create(context, addr, rpc_id, &handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    /* Fill input structure */
+    rpc_open_handle.cookie = 100;
+    rpc_open_in_struct.path = rpc_open_path;
+    rpc_open_in_struct.handle = rpc_open_handle;
+
+    /* Callback is only triggered by the first response */
+    HG_TEST_LOG_DEBUG("Forwarding hedged rpc_open, delay: %u...", delay);
+    forward_cb_args.request = request;
+    forward_cb_args.rpc_handle = &rpc_open_handle;
+    ret = HG_Forward_hedged(
+        handles, 2, delay, callback, &forward_cb_args, &rpc_open_in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward_hedged() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+done:
+    for (i = 0; i < 2; i++) {
+        cleanup_ret = HG_Destroy(handles[i]);
+        HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+            "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+    }
+
+    hg_request_destroy(request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_batch(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_cb_t callback)
+{
+    hg_request_t *requests[NINFLIGHT];
+    hg_handle_t handles[NINFLIGHT];
+    struct forward_cb_args forward_cb_args[NINFLIGHT];
+    rpc_handle_t rpc_open_handles[NINFLIGHT];
+    rpc_open_in_t rpc_open_in_structs[NINFLIGHT];
+    void *args[NINFLIGHT], *in_structs[NINFLIGHT];
+    hg_const_string_t rpc_open_path = HG_TEST_TEMP_DIRECTORY "/test.h5";
+    unsigned int i, posted = 0;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+
+    for (i = 0; i < NINFLIGHT; i++) {
+        requests[i] = hg_request_create(request_class);
+        handles[i] = HG_HANDLE_NULL;
+    }
+
+    for (i = 0; i < NINFLIGHT; i++) {
+        ret = HG_Create(context, addr, rpc_id, &handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+        /* Each request carries its own cookie */
+        rpc_open_handles[i].cookie = i;
+        rpc_open_in_structs[i].path = rpc_open_path;
+        rpc_open_in_structs[i].handle = rpc_open_handles[i];
+        forward_cb_args[i].request = requests[i];
+        forward_cb_args[i].rpc_handle = &rpc_open_handles[i];
+        args[i] = &forward_cb_args[i];
+        in_structs[i] = &rpc_open_in_structs[i];
+    }
+
+    HG_TEST_LOG_DEBUG("Forwarding batch of %u rpc_open...", NINFLIGHT);
+    ret = HG_Forward_batch(
+        handles, NINFLIGHT, callback, args, in_structs, &posted);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward_batch() failed (%s)", HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(posted != NINFLIGHT, done, ret, HG_FAULT,
+        "Only %u requests posted", posted);
+
+    for (i = 0; i < NINFLIGHT; i++)
+        hg_request_wait(requests[i], HG_MAX_IDLE_TIME, NULL);
+
+done:
+    /* Wait for requests that were posted before a failure */
+    if (ret != HG_SUCCESS) {
+        for (i = 0; i < posted; i++)
+            hg_request_wait(requests[i], HG_MAX_IDLE_TIME, NULL);
+    }
+    for (i = 0; i < NINFLIGHT; i++) {
+        cleanup_ret = HG_Destroy(handles[i]);
+        HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+            "HG_Destroy() failed (%s)", HG_Error_to_string(cleanup_ret));
+        hg_request_destroy(requests[i]);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_gather(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id)
+{
+    hg_request_t *request = NULL;
+    hg_addr_t addrs[NCOLLECTIVE];
+    hg_bool_t gathered = HG_FALSE;
+    rpc_handle_t rpc_open_handle;
+    rpc_open_in_t rpc_open_in_struct;
+    hg_return_t ret = HG_SUCCESS;
+    int i;
+
+    request = hg_request_create(request_class);
+    hg_request_set_data(request, &gathered);
+
+    /* Same target several times, each relay forwards back to it */
+    for (i = 0; i < NCOLLECTIVE; i++)
+        addrs[i] = addr;
+
+    rpc_open_handle.cookie = 100;
+    rpc_open_in_struct.path = HG_TEST_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_struct.handle = rpc_open_handle;
+
+    ret = HG_Forward_gather(context, hg_test_rpc_gather_cb, request, rpc_id,
+        addrs, NCOLLECTIVE, NCOLLECTIVE_FANOUT, &rpc_open_in_struct,
+        sizeof(rpc_open_in_t), sizeof(rpc_open_out_t));
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward_gather() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+    HG_TEST_CHECK_ERROR(
+        !gathered, done, ret, HG_FAULT, "Outputs were not gathered");
+
+done:
+    hg_request_destroy(request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_introspect(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_uint8_t target_id, hg_bool_t listening)
+{
+    struct introspect_cb_args introspect_cb_args;
+    hg_return_t ret = HG_SUCCESS;
+
+    introspect_cb_args.request = hg_request_create(request_class);
+    introspect_cb_args.listening = listening;
+    introspect_cb_args.received = HG_FALSE;
+
+    ret = HG_Introspect(context, hg_test_introspect_cb, &introspect_cb_args,
+        addr, target_id);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Introspect() failed (%s)", HG_Error_to_string(ret));
+
+    hg_request_wait(introspect_cb_args.request, HG_MAX_IDLE_TIME, NULL);
+    HG_TEST_CHECK_ERROR(!introspect_cb_args.received, done, ret, HG_FAULT,
+        "Snapshot was not received");
+
+done:
+    hg_request_destroy(introspect_cb_args.request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_stats(hg_class_t *hg_class, hg_context_t *context, hg_id_t rpc_id)
+{
+    struct hg_class_stats class_stats;
+    struct hg_context_stats context_stats;
+    struct hg_rpc_stats *rpc_stats = NULL;
+    hg_uint32_t rpc_count = 0, i;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Query number of RPCs first */
+    ret = HG_Class_get_stats(hg_class, &class_stats, NULL, &rpc_count);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Class_get_stats() failed (%s)", HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(class_stats.forward_count == 0 ||
+                            class_stats.bytes_out == 0 || rpc_count == 0,
+        done, ret, HG_FAULT, "No RPC was accounted");
+
+    rpc_stats = (struct hg_rpc_stats *) malloc(rpc_count * sizeof(*rpc_stats));
+    HG_TEST_CHECK_ERROR(rpc_stats == NULL, done, ret, HG_NOMEM,
+        "Could not allocate RPC stats");
+
+    ret = HG_Class_get_stats(hg_class, NULL, rpc_stats, &rpc_count);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Class_get_stats() failed (%s)", HG_Error_to_string(ret));
+
+    for (i = 0; i < rpc_count; i++)
+        if (rpc_stats[i].id == rpc_id)
+            break;
+    HG_TEST_CHECK_ERROR(i == rpc_count || rpc_stats[i].forward_count == 0,
+        done, ret, HG_FAULT, "RPC %llu was not accounted",
+        (unsigned long long) rpc_id);
+    HG_TEST_CHECK_ERROR(rpc_stats[i].forward_count > class_stats.forward_count,
+        done, ret, HG_FAULT, "RPC count exceeds class count");
+
+    ret = HG_Context_get_stats(context, &context_stats);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Context_get_stats() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(context_stats.timer_count != 0, done, ret, HG_FAULT,
+        "Unexpected number of armed timers (%u)", context_stats.timer_count);
+    HG_TEST_CHECK_ERROR(context_stats.mem_bytes[HG_MEM_USE_BULK] == 0, done,
+        ret, HG_FAULT, "Memory of bulk op IDs was not accounted");
+    HG_TEST_CHECK_ERROR(
+        context_stats.handle_count + context_stats.handle_pool_count > 0 &&
+            context_stats.mem_bytes[HG_MEM_USE_HANDLE] == 0,
+        done, ret, HG_FAULT, "Memory of handles was not accounted");
+
+done:
+    free(rpc_stats);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_prealloc(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr)
+{
+    struct hg_context_stats before, after;
+    hg_return_t ret = HG_SUCCESS;
+
+    ret = HG_Context_get_stats(context, &before);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Context_get_stats() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_test_rpc(context, request_class, addr, hg_test_rpc_open_id_g,
+        hg_test_rpc_forward_cb);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "hg_test_rpc() failed (%s)", HG_Error_to_string(ret));
+
+    /* Handles must have been taken from the preallocated pool */
+    ret = HG_Context_get_stats(context, &after);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Context_get_stats() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(
+        after.alloc_fallback_count != before.alloc_fallback_count, done, ret,
+        HG_FAULT, "%u allocation(s) not served from pools",
+        after.alloc_fallback_count - before.alloc_fallback_count);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_auth_acquire_cb(
+    hg_uint32_t credential, void *arg, char *key, hg_size_t *key_size)
+{
+    int *acquire_count = (int *) arg;
+
+    (*acquire_count)++;
+    *key_size = (hg_size_t) snprintf(
+        key, (size_t) *key_size, "key-%u", (unsigned int) credential);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_auth_key(void)
+{
+    hg_uint32_t credential = (hg_uint32_t) getpid();
+    char key[HG_AUTH_KEY_MAX], expected[HG_AUTH_KEY_MAX];
+    hg_size_t key_size = 0;
+    int acquire_count = 0, i;
+    hg_return_t ret = HG_SUCCESS;
+
+    snprintf(expected, sizeof(expected), "key-%u", (unsigned int) credential);
+
+    /* Key is only acquired once */
+    for (i = 0; i < 2; i++) {
+        ret = HG_Auth_key_get(credential, hg_test_auth_acquire_cb,
+            &acquire_count, 0, key, &key_size);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Auth_key_get() failed (%s)",
+            HG_Error_to_string(ret));
+        HG_TEST_CHECK_ERROR(key_size != strlen(expected) ||
+                                memcmp(key, expected, key_size) != 0,
+            done, ret, HG_FAULT, "Unexpected key");
+    }
+    HG_TEST_CHECK_ERROR(acquire_count != 1, done, ret, HG_FAULT,
+        "Key was acquired %d times", acquire_count);
+
+    /* Key is acquired again once removed */
+    ret = HG_Auth_key_remove(credential);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Auth_key_remove() failed (%s)",
+        HG_Error_to_string(ret));
+    ret = HG_Auth_key_get(credential, hg_test_auth_acquire_cb, &acquire_count,
+        0, key, &key_size);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Auth_key_get() failed (%s)", HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(acquire_count != 2, done, ret, HG_FAULT,
+        "Key was not acquired again");
+
+done:
+    (void) HG_Auth_key_remove(credential);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_latency(hg_class_t *hg_class, hg_id_t rpc_id)
+{
+    struct hg_latency_stats total, wait;
+    hg_return_t ret = HG_SUCCESS;
+
+    ret = HG_Class_get_latency(
+        hg_class, rpc_id, HG_LATENCY_ORIGIN_TOTAL, &total);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Class_get_latency() failed (%s)",
+        HG_Error_to_string(ret));
+    ret = HG_Class_get_latency(hg_class, rpc_id, HG_LATENCY_ORIGIN_WAIT, &wait);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Class_get_latency() failed (%s)",
+        HG_Error_to_string(ret));
+
+    HG_TEST_CHECK_ERROR(total.count == 0, done, ret, HG_FAULT,
+        "No latency was recorded");
+    HG_TEST_CHECK_ERROR(total.min > total.p50 || total.p50 > total.p99 ||
+                            total.p99 > total.max,
+        done, ret, HG_FAULT, "Inconsistent latency percentiles");
+    HG_TEST_CHECK_ERROR(wait.count > total.count, done, ret, HG_FAULT,
+        "More wait samples than forwards");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_load(hg_class_t *hg_class, hg_addr_t addr, hg_bool_t self)
+{
+    hg_addr_t addrs[2] = {addr, addr}, selected = HG_ADDR_NULL;
+    hg_uint32_t load = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    ret = HG_Addr_get_load(hg_class, addr, &load);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Addr_get_load() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Loopback RPCs do not carry a response header */
+    HG_TEST_CHECK_ERROR(load == 0 && !self, done, ret, HG_FAULT,
+        "No load was advertised");
+
+    ret = HG_Addr_select(hg_class, addrs, 2, &selected);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Addr_select() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(selected != addr, done, ret, HG_FAULT,
+        "Selected address is not part of the group");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_admit_rpc_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    struct admit_target *target = (struct admit_target *) HG_Registered_data(
+        hg_info->hg_class, hg_info->id);
+
+    /* Hold admitted requests so that they keep counting against the limit */
+    target->handles[target->count++] = handle;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_admit_cb(const struct hg_cb_info *callback_info)
+{
+    struct admit_cb_args *args = (struct admit_cb_args *) callback_info->arg;
+
+    /* Rejected requests complete with HG_AGAIN */
+    if (callback_info->ret == HG_AGAIN)
+        hg_atomic_incr32(&args->rejected);
+    else
+        HG_TEST_CHECK_ERROR_NORET(callback_info->ret != HG_SUCCESS, done,
+            "Error in HG callback (%s)",
+            HG_Error_to_string(callback_info->ret));
+
+done:
+    (void) HG_Destroy(callback_info->info.forward.handle);
+    if (hg_atomic_incr32(&args->completed) == NADMIT)
+        hg_request_complete(args->request);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_test_rpc_admit_progress(
+    struct admit_target *target, struct admit_cb_args *args)
+{
+    unsigned int actual_count = 0;
+
+    (void) HG_Progress(target->context, 0);
+    (void) HG_Trigger(target->context, 0, NADMIT, &actual_count);
+    (void) hg_request_wait(args->request, 0, NULL);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_admit(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, const char *comm,
+    const char *protocol, unsigned int active_max)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct admit_cb_args admit_cb_args;
+    struct admit_target target;
+    hg_class_t *target_class = NULL;
+    hg_addr_t self_addr = HG_ADDR_NULL, target_addr = HG_ADDR_NULL;
+    char info_string[256], addr_string[256];
+    hg_size_t addr_string_size = sizeof(addr_string);
+    hg_time_t t1, t2;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+    int rc;
+
+    admit_cb_args.request = NULL;
+    hg_atomic_init32(&admit_cb_args.completed, 0);
+    hg_atomic_init32(&admit_cb_args.rejected, 0);
+    target.context = NULL;
+    target.count = 0;
+
+    HG_TEST_CHECK_ERROR(active_max >= NADMIT, done, ret, HG_INVALID_ARG,
+        "Admission limit must be lower than %d", NADMIT);
+
+    /* Limits are class-wide, use a separate target so that they do not
+     * apply to other tests */
+    rc = snprintf(info_string, sizeof(info_string), "%s%s%s",
+        comm ? comm : "", comm ? "+" : "", protocol);
+    HG_TEST_CHECK_ERROR(rc < 0 || (size_t) rc >= sizeof(info_string), done,
+        ret, HG_OVERFLOW, "Info string exceeds buffer size");
+
+    hg_init_info.admit_active_max = active_max;
+    target_class = HG_Init_opt(info_string, HG_TRUE, &hg_init_info);
+    HG_TEST_CHECK_ERROR(
+        target_class == NULL, done, ret, HG_FAULT, "HG_Init_opt() failed");
+
+    target.context = HG_Context_create(target_class);
+    HG_TEST_CHECK_ERROR(target.context == NULL, done, ret, HG_FAULT,
+        "HG_Context_create() failed");
+
+    ret = HG_Register_data(target_class,
+        MERCURY_REGISTER(target_class, "hg_test_rpc_null", void, void,
+            hg_test_rpc_admit_rpc_cb),
+        &target, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Register_data() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Addr_self(target_class, &self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Addr_to_string(
+        target_class, addr_string, &addr_string_size, self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Addr_to_string() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Addr_lookup2(hg_class, addr_string, &target_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Addr_lookup2() failed (%s)", HG_Error_to_string(ret));
+
+    admit_cb_args.request = hg_request_create(request_class);
+
+    /* Requests beyond the limit must be rejected by the target */
+    for (i = 0; i < NADMIT; i++) {
+        hg_handle_t handle;
+
+        ret = HG_Create(context, target_addr, hg_test_rpc_null_id_g, &handle);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+again:
+        ret = HG_Forward(handle, hg_test_rpc_admit_cb, &admit_cb_args, NULL);
+        if (ret == HG_AGAIN) {
+            hg_test_rpc_admit_progress(&target, &admit_cb_args);
+            goto again;
+        }
+        if (ret != HG_SUCCESS)
+            (void) HG_Destroy(handle);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    /* Wait for rejections while admitted requests are held */
+    hg_time_get_current_ms(&t1);
+    do {
+        hg_test_rpc_admit_progress(&target, &admit_cb_args);
+        hg_time_get_current_ms(&t2);
+    } while ((target.count < active_max ||
+                 hg_atomic_get32(&admit_cb_args.completed) <
+                     (hg_util_int32_t) (NADMIT - active_max)) &&
+             hg_time_to_ms(hg_time_subtract(t2, t1)) < HG_MAX_IDLE_TIME);
+
+    HG_TEST_LOG_DEBUG("%d RPCs out of %d rejected, %u held",
+        hg_atomic_get32(&admit_cb_args.rejected), NADMIT, target.count);
+    HG_TEST_CHECK_ERROR(target.count != active_max, done, ret, HG_FAULT,
+        "Target admitted %u RPCs, expected %u", target.count, active_max);
+
+    /* Release held requests */
+    for (i = 0; i < target.count; i++) {
+        ret = HG_Respond(target.handles[i], NULL, NULL, NULL);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    hg_time_get_current_ms(&t1);
+    do {
+        hg_test_rpc_admit_progress(&target, &admit_cb_args);
+        hg_time_get_current_ms(&t2);
+    } while (hg_atomic_get32(&admit_cb_args.completed) < NADMIT &&
+             hg_time_to_ms(hg_time_subtract(t2, t1)) < HG_MAX_IDLE_TIME);
+
+    HG_TEST_CHECK_ERROR(hg_atomic_get32(&admit_cb_args.completed) != NADMIT,
+        done, ret, HG_FAULT, "Only %d RPCs out of %d completed",
+        hg_atomic_get32(&admit_cb_args.completed), NADMIT);
+    HG_TEST_CHECK_ERROR(hg_atomic_get32(&admit_cb_args.rejected) !=
+                            (hg_util_int32_t) (NADMIT - active_max),
+        done, ret, HG_FAULT, "%d RPCs out of %d rejected, expected %u",
+        hg_atomic_get32(&admit_cb_args.rejected), NADMIT,
+        NADMIT - active_max);
+
+done:
+    for (i = 0; i < target.count; i++)
+        (void) HG_Destroy(target.handles[i]);
+    if (admit_cb_args.request != NULL)
+        hg_request_destroy(admit_cb_args.request);
+    if (target_addr != HG_ADDR_NULL)
+        (void) HG_Addr_free(hg_class, target_addr);
+    if (self_addr != HG_ADDR_NULL)
+        (void) HG_Addr_free(target_class, self_addr);
+    if (target.context != NULL)
+        (void) HG_Context_destroy(target.context);
+    if (target_class != NULL)
+        (void) HG_Finalize(target_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_test_rpc_hook_cb(
+    void *arg, hg_hook_type_t type, const struct hg_core_hook_info *info)
+{
+    struct hook_args *args = (struct hook_args *) arg;
+    hg_size_t i;
+
+    hg_atomic_incr32(&args->counts[type]);
+
+    /* Origin fills the trace context, target checks that it was carried */
+    if (type == HG_HOOK_FORWARD && info->trace_ctx)
+        memset(info->trace_ctx, 0xa5, (size_t) info->trace_ctx_size);
+    else if (type == HG_HOOK_REQUEST && info->trace_ctx_size == NTRACE_CTX) {
+        for (i = 0; i < info->trace_ctx_size; i++)
+            if (((const unsigned char *) info->trace_ctx)[i] != 0xa5)
+                return;
+        hg_atomic_incr32(&args->trace_ctx_matched);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_hooks(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, hg_bool_t self,
+    hg_bool_t compact)
+{
+    struct hook_args hook_args;
+    struct hg_core_hooks hooks;
+    hg_return_t ret = HG_SUCCESS;
+    int i;
+
+    for (i = 0; i < HG_HOOK_MAX; i++) {
+        hg_atomic_init32(&hook_args.counts[i], 0);
+        hooks.callbacks[i] = hg_test_rpc_hook_cb;
+    }
+    hg_atomic_init32(&hook_args.trace_ctx_matched, 0);
+    hooks.arg = &hook_args;
+    hooks.trace_ctx_size = NTRACE_CTX;
+
+    ret = HG_Class_set_hooks(hg_class, &hooks);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Class_set_hooks() failed (%s)", HG_Error_to_string(ret));
+
+    /* Handle must be created after hooks are set */
+    ret = hg_test_rpc(context, request_class, addr, hg_test_rpc_open_id_g,
+        hg_test_rpc_forward_cb);
+    (void) HG_Class_set_hooks(hg_class, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "hg_test_rpc() failed (%s)", HG_Error_to_string(ret));
+
+    HG_TEST_CHECK_ERROR(
+        hg_atomic_get32(&hook_args.counts[HG_HOOK_FORWARD]) != 1 ||
+            hg_atomic_get32(&hook_args.counts[HG_HOOK_FORWARD_COMPLETE]) != 1,
+        done, ret, HG_FAULT, "Forward events were not reported");
+
+    /* Target events are only seen when sending to self */
+    if (self) {
+        HG_TEST_CHECK_ERROR(
+            hg_atomic_get32(&hook_args.counts[HG_HOOK_REQUEST]) != 1 ||
+                hg_atomic_get32(&hook_args.counts[HG_HOOK_HANDLER_START]) != 1,
+            done, ret, HG_FAULT, "Target events were not reported");
+        HG_TEST_CHECK_ERROR(
+            compact && hg_atomic_get32(&hook_args.trace_ctx_matched) != 1,
+            done, ret, HG_FAULT, "Trace context was not carried");
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = {0};
+    hg_return_t hg_ret;
+    hg_id_t inv_id;
+    int ret = EXIT_SUCCESS;
+
+    /* Initialize the interface */
+    hg_ret = HG_Test_init(argc, argv, &hg_test_info);
+    HG_TEST_CHECK_ERROR(
+        hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "HG_Test_init() failed");
+
+    /* NULL RPC test */
+    HG_TEST("NULL RPC");
+    hg_ret = hg_test_rpc_null(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr);
+    HG_TEST_CHECK_ERROR(
+        hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "NULL RPC test failed");
+    HG_PASSED();
+
+    /* Simple RPC test */
+    HG_TEST("simple RPC");
+    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, hg_test_rpc_open_id_g,
+        hg_test_rpc_forward_cb);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "simple RPC test failed");
+    HG_PASSED();
+
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+    /* Coroutine RPC test */
+    HG_TEST("coroutine RPC");
+    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, hg_test_rpc_await_id_g,
+        hg_test_rpc_forward_cb);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "coroutine RPC test failed");
+    HG_PASSED();
+#endif
+
+    /* RPC test with lookup/free */
+    if (!hg_test_info.na_test_info.self_send &&
+        strcmp(HG_Class_get_name(hg_test_info.hg_class), "mpi")) {
+        hg_request_t *request = NULL;
+        struct lookup_cb_args lookup_args;
+        unsigned int flag = 0;
+
+        HG_Addr_free(hg_test_info.hg_class, hg_test_info.target_addr);
+        hg_test_info.target_addr = HG_ADDR_NULL;
+
+        HG_TEST("lookup RPC");
+        hg_ret = hg_test_rpc_lookup(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.na_test_info.target_name,
+            hg_test_rpc_open_id_g, hg_test_rpc_forward_cb);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+            "lookup test failed");
+        HG_PASSED();
+
+        request = hg_request_create(hg_test_info.request_class);
+
+        /* Look up target addr using target name info */
+        lookup_args.addr_ptr = &hg_test_info.target_addr;
+        lookup_args.request = request;
+
+        /* Forward call to remote addr and get a new request */
+        hg_ret = HG_Addr_lookup1(hg_test_info.context, hg_test_rpc_lookup_cb,
+            &lookup_args, hg_test_info.na_test_info.target_name,
+            HG_OP_ID_IGNORE);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+            "HG_Addr_lookup1() failed (%s)", HG_Error_to_string(hg_ret));
+
+        /* Wait for request to be marked completed */
+        hg_request_wait(request, HG_MAX_IDLE_TIME, &flag);
+        HG_TEST_CHECK_ERROR(
+            flag == 0, done, ret, EXIT_FAILURE, "Operation did not complete");
+
+        /* Destroy request */
+        hg_request_destroy(request);
+    }
+
+    /* RPC reset test */
+    HG_TEST("RPC reset");
     hg_ret = hg_test_rpc_reset(hg_test_info.context, hg_test_info.request_class,
         hg_test_info.target_addr, hg_test_rpc_open_id_g,
         hg_test_rpc_forward_cb);
@@ -835,6 +2353,41 @@ main(int argc, char *argv[])
         "no response RPC test failed");
     HG_PASSED();
 
+    /* One-way RPC test */
+    HG_TEST("one-way RPC");
+    hg_ret = hg_test_rpc_oneway(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_no_resp_g);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "one-way RPC test failed");
+    HG_PASSED();
+
+    /* Persistent RPC test */
+    HG_TEST("persistent RPC");
+    hg_ret = hg_test_rpc_persistent(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_g);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "persistent RPC test failed");
+    HG_PASSED();
+
+    /* Future RPC test */
+    HG_TEST("future RPC");
+    hg_ret = hg_test_rpc_future(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_g);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "future RPC test failed");
+    HG_PASSED();
+
+    /* Engine RPC test */
+    HG_TEST("engine RPC");
+    hg_ret =
+        hg_test_rpc_engine(hg_test_info.hg_class, hg_test_info.target_addr);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "engine RPC test failed");
+    HG_PASSED();
+
     /* RPC test with unregistered ID */
     inv_id =
         MERCURY_REGISTER(hg_test_info.hg_class, "unreg_id", void, void, NULL);
@@ -908,8 +2461,55 @@ main(int argc, char *argv[])
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "overflow RPC test failed");
     HG_PASSED();
+
+    /* Compressed overflow RPC test */
+    HG_TEST("compressed overflow RPC");
+    hg_ret = hg_test_overflow(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, hg_test_overflow_codec_id_g,
+        hg_test_rpc_forward_overflow_cb);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "compressed overflow RPC test failed");
+    HG_PASSED();
+
+    /* Overflow RPC test with response buffer */
+    HG_TEST("overflow RPC with response buffer");
+    hg_ret = hg_test_overflow_resp(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_overflow_resp_id_g, hg_test_info.na_test_info.self_send);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "overflow RPC with response buffer test failed");
+    HG_PASSED();
 #endif
 
+    /* Response cache test */
+    HG_TEST("cached RPC");
+    hg_ret = hg_test_rpc_cached(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_cached_id_g);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "cached RPC test failed");
+    HG_PASSED();
+
+    /* Streamed response test (self streaming is not supported) */
+    if (!hg_test_info.na_test_info.self_send) {
+        HG_TEST("streamed RPC");
+        hg_ret = hg_test_rpc_stream(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr,
+            hg_test_rpc_stream_id_g, 8);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+            "streamed RPC test failed");
+        HG_PASSED();
+    }
+
+    /* Raw relay test, server forwards pre-encoded payloads to self */
+    HG_TEST("relayed raw RPC");
+    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, hg_test_rpc_relay_id_g,
+        hg_test_rpc_forward_cb);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "relayed raw RPC test failed");
+    HG_PASSED();
+
     /* Cancel RPC test (self cancelation is not supported) */
     if (!hg_test_info.na_test_info.self_send) {
         HG_TEST("cancel RPC");
@@ -919,6 +2519,133 @@ main(int argc, char *argv[])
         HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
             "cancel RPC test failed");
         HG_PASSED();
+
+        HG_TEST("cancel all RPCs to addr");
+        hg_ret = hg_test_cancel_all_rpc(hg_test_info.hg_class,
+            hg_test_info.context, hg_test_info.request_class,
+            hg_test_info.target_addr, hg_test_cancel_rpc_id_g,
+            hg_test_rpc_forward_cancel_cb);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+            "cancel all RPCs test failed");
+        HG_PASSED();
+
+        HG_TEST("timed out RPC");
+        hg_ret = hg_test_timeout_rpc(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr,
+            hg_test_cancel_rpc_id_g, hg_test_rpc_forward_timeout_cb);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+            "timed out RPC test failed");
+        HG_PASSED();
+    }
+
+    /* Hedged RPC tests, replica sent at once or dropped after response */
+    HG_TEST("hedged RPC (no delay)");
+    hg_ret = hg_test_rpc_hedged(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_g, hg_test_rpc_forward_cb, 0);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "hedged RPC test failed");
+    HG_PASSED();
+
+    HG_TEST("hedged RPC (1s delay)");
+    hg_ret = hg_test_rpc_hedged(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_g, hg_test_rpc_forward_cb, 1000);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "hedged RPC test failed");
+    HG_PASSED();
+
+    /* Batch RPC test, all requests submitted at once */
+    HG_TEST("batch RPC");
+    hg_ret = hg_test_rpc_batch(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_g, hg_test_rpc_forward_cb);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "batch RPC test failed");
+    HG_PASSED();
+
+    /* Gather RPC test */
+    HG_TEST("gather RPC");
+    hg_ret = hg_test_rpc_gather(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_g);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "gather RPC test failed");
+    HG_PASSED();
+
+    /* Introspection test */
+    HG_TEST("introspection RPC");
+    hg_ret = hg_test_introspect(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr, 0,
+        !hg_test_info.na_test_info.self_send);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "introspection RPC test failed");
+    HG_PASSED();
+
+    /* Stats test */
+    HG_TEST("RPC stats");
+    hg_ret = hg_test_rpc_stats(
+        hg_test_info.hg_class, hg_test_info.context, hg_test_rpc_open_id_g);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "RPC stats test failed");
+    HG_PASSED();
+
+    /* Preallocation test */
+    if (hg_test_info.prealloc_count > 0) {
+        HG_TEST("allocation-free RPC");
+        hg_ret = hg_test_rpc_prealloc(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+            "allocation-free RPC test failed");
+        HG_PASSED();
+    }
+
+    /* Instrumentation hooks test */
+    HG_TEST("instrumentation hooks");
+    hg_ret = hg_test_rpc_hooks(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_info.na_test_info.self_send, hg_test_info.compact_header);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "instrumentation hooks test failed");
+    HG_PASSED();
+
+    /* Node-local auth key cache test */
+    HG_TEST("cached auth key");
+    hg_ret = hg_test_auth_key();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "cached auth key test failed");
+    HG_PASSED();
+
+    /* Latency test */
+    if (hg_test_info.latency_stats) {
+        HG_TEST("RPC latency");
+        hg_ret = hg_test_rpc_latency(
+            hg_test_info.hg_class, hg_test_rpc_open_id_g);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+            "RPC latency test failed");
+        HG_PASSED();
+    }
+
+    /* Load feedback test */
+    if (hg_test_info.load_feedback) {
+        HG_TEST("RPC load feedback");
+        hg_ret = hg_test_rpc_load(hg_test_info.hg_class,
+            hg_test_info.target_addr, hg_test_info.na_test_info.self_send);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+            "RPC load feedback test failed");
+        HG_PASSED();
+    }
+
+    /* Admission control test */
+    if (hg_test_info.admit_active_max > 0) {
+        HG_TEST("RPC admission control");
+        hg_ret = hg_test_rpc_admit(hg_test_info.hg_class,
+            hg_test_info.context, hg_test_info.request_class,
+            hg_test_info.na_test_info.comm, hg_test_info.na_test_info.protocol,
+            hg_test_info.admit_active_max);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+            "RPC admission control test failed");
+        HG_PASSED();
     }
 
 done:
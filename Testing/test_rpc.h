@@ -23,12 +23,24 @@ typedef struct {
     hg_uint32_t buf_size;
 } perf_rpc_lat_in_t;
 
+/* Replayed RPC, payload of output is returned as perf_rpc_lat_in_t */
+typedef struct {
+    void *buf;             /* Payload */
+    hg_bulk_t bulk_handle; /* Memory pulled by target (or HG_BULK_NULL) */
+    hg_uint64_t bulk_size; /* Size pulled by target */
+    hg_uint32_t buf_size;  /* Size of payload */
+    hg_uint32_t out_size;  /* Size of output payload */
+} replay_in_t;
+
+typedef perf_rpc_lat_in_t replay_out_t;
+
 #ifdef HG_HAS_BOOST
 
 /* 1. Generate processor and struct for additional struct types
- * MERCURY_GEN_STRUCT_PROC( struct_type_name, fields )
+ * MERCURY_GEN_STRUCT_PROC( struct_type_name, fields ), structs with a fixed
+ * layout can use MERCURY_GEN_POD_STRUCT_PROC( struct_type_name, fields )
  */
-MERCURY_GEN_STRUCT_PROC(rpc_handle_t, ((hg_uint64_t)(cookie)))
+MERCURY_GEN_POD_STRUCT_PROC(rpc_handle_t, ((hg_uint64_t)(cookie)))
 
 /* Dummy function that needs to be shipped (already defined) */
 /* int rpc_open(const char *path, rpc_handle_t handle, int *event_id); */
@@ -156,4 +168,55 @@ hg_proc_perf_rpc_lat_in_t(hg_proc_t proc, void *data)
     return ret;
 }
 
+/* Define hg_proc_replay_in_t */
+static HG_INLINE hg_return_t
+hg_proc_replay_in_t(hg_proc_t proc, void *data)
+{
+    replay_in_t *struct_data = (replay_in_t *) data;
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint32_t(proc, &struct_data->out_size);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_hg_uint64_t(proc, &struct_data->bulk_size);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_hg_bulk_t(proc, &struct_data->bulk_handle);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    /* Payload is not verified */
+    ret = hg_proc_hg_uint32_t(proc, &struct_data->buf_size);
+    if (ret != HG_SUCCESS || struct_data->buf_size == 0)
+        return ret;
+
+    switch (hg_proc_get_op(proc)) {
+        case HG_DECODE:
+            struct_data->buf = malloc(struct_data->buf_size);
+            if (struct_data->buf == NULL)
+                return HG_NOMEM;
+            HG_FALLTHROUGH();
+        case HG_ENCODE:
+        case HG_SIZE:
+            ret = hg_proc_raw(proc, struct_data->buf, struct_data->buf_size);
+            break;
+        case HG_FREE:
+            free(struct_data->buf);
+            break;
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+/* Define hg_proc_replay_out_t */
+static HG_INLINE hg_return_t
+hg_proc_replay_out_t(hg_proc_t proc, void *data)
+{
+    return hg_proc_perf_rpc_lat_in_t(proc, data);
+}
+
 #endif /* TEST_RPC_H */
@@ -0,0 +1,795 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_test.h"
+#include "na_test_getopt.h"
+
+#include "mercury_histogram.h"
+#include "mercury_time.h"
+
+#include <mpi.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Scaling benchmark launched with mpirun. In many-to-one mode, the first
+ * ranks are servers and the remaining ranks are clients, each client
+ * sending requests to one server. In all-to-all mode, every rank is both a
+ * client and a server and sends requests to all other ranks in turn, e.g.:
+ *   mpirun -np 65 hg_bench_scale -p ofi+tcp -s 1 -w 32
+ * Every rank makes progress on its own context until all clients are done,
+ * servers sample their posted unexpected receives to report how often they
+ * ran out of them. */
+
+/****************/
+/* Local Macros */
+/****************/
+
+#define BENCHMARK_NAME "hg_bench_scale"
+#define STRING(s)      #s
+#define XSTRING(s)     STRING(s)
+#define VERSION_NAME                                                           \
+    XSTRING(HG_VERSION_MAJOR)                                                  \
+    "." XSTRING(HG_VERSION_MINOR) "." XSTRING(HG_VERSION_PATCH)
+
+#define HG_BENCH_SCALE_ADDR_MAX       (256)
+#define HG_BENCH_SCALE_OPS_DEFAULT    (10000)
+#define HG_BENCH_SCALE_SIZE_DEFAULT   (64)
+#define HG_BENCH_SCALE_WINDOW_DEFAULT (16)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+struct hg_bench_scale_info {
+    const char *protocol;        /* NA info string */
+    unsigned long ops;           /* Operations per client and point */
+    unsigned int server_count;   /* Number of servers (many-to-one) */
+    unsigned int window_max;     /* Max operations in flight per client */
+    unsigned int size;           /* Payload size */
+    unsigned int post_init;      /* Unexpected receives posted by servers */
+    hg_bool_t all_to_all;        /* Every rank is a client and a server */
+    hg_bool_t busy;              /* Busy spin */
+    hg_bool_t verbose;           /* Print per-server results */
+    int rank;                    /* MPI rank */
+    int rank_count;              /* MPI size */
+    hg_bool_t is_server;         /* Rank handles requests */
+    hg_bool_t is_client;         /* Rank sends requests */
+    hg_class_t *hg_class;        /* HG class */
+    hg_context_t *context;       /* HG context */
+    hg_id_t rpc_id;              /* Benchmark RPC ID */
+    hg_addr_t *addrs;            /* Addresses of peers, indexed by rank */
+    unsigned int *peers;         /* Ranks that requests are sent to */
+    unsigned int peer_count;     /* Number of peers */
+};
+
+struct hg_bench_scale_client;
+
+/* Operation in flight */
+struct hg_bench_scale_slot {
+    struct hg_bench_scale_client *client; /* Owning client */
+    hg_handle_t *handles;                 /* Handles, created per peer rank */
+    hg_time_t start;                      /* Time of forward */
+};
+
+struct hg_bench_scale_client {
+    struct hg_bench_scale_info *info;   /* Benchmark info */
+    struct hg_bench_scale_slot *slots;  /* Operations in flight */
+    struct hg_histogram *histogram;     /* Latencies (NULL when warming up) */
+    perf_rpc_lat_in_t in_struct;        /* Input of requests */
+    unsigned long op_count;             /* Operations to run */
+    unsigned long posted;               /* Operations posted */
+    unsigned long completed;            /* Operations completed */
+    hg_return_t ret;                    /* Error of operations */
+};
+
+/* Server samples of posted unexpected receives */
+struct hg_bench_scale_server {
+    hg_uint64_t handled;        /* Requests handled before point */
+    unsigned long sample_count; /* Number of samples */
+    unsigned long empty_count;  /* Samples without posted receives */
+    hg_uint32_t pending_min;    /* Min number of posted receives */
+};
+
+/* Per-rank results gathered by rank 0 */
+struct hg_bench_scale_rank_result {
+    double rate;        /* Requests handled per second (-1 if not server) */
+    double pending_min; /* Min number of posted receives */
+    double empty;       /* Percent of samples without posted receives */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static void
+hg_bench_scale_usage(const char *execname);
+
+static int
+hg_bench_scale_parse_options(
+    int argc, char *argv[], struct hg_bench_scale_info *info);
+
+static hg_return_t
+hg_bench_scale_init(struct hg_bench_scale_info *info);
+
+static void
+hg_bench_scale_finalize(struct hg_bench_scale_info *info);
+
+static hg_return_t
+hg_bench_scale_rpc_cb(hg_handle_t handle);
+
+static hg_return_t
+hg_bench_scale_progress(
+    struct hg_bench_scale_info *info, struct hg_bench_scale_server *server);
+
+static hg_return_t
+hg_bench_scale_forward(struct hg_bench_scale_slot *slot);
+
+static hg_return_t
+hg_bench_scale_forward_cb(const struct hg_cb_info *callback_info);
+
+static hg_return_t
+hg_bench_scale_run(struct hg_bench_scale_info *info,
+    struct hg_bench_scale_client *client, unsigned int window,
+    unsigned long ops, struct hg_histogram *histogram,
+    struct hg_bench_scale_server *server, double *client_time,
+    double *server_time);
+
+static hg_return_t
+hg_bench_scale_measure(struct hg_bench_scale_info *info,
+    struct hg_bench_scale_client *client, unsigned int window,
+    struct hg_histogram *histogram,
+    struct hg_bench_scale_rank_result *rank_results);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+extern int na_test_opt_ind_g;         /* token pointer */
+extern const char *na_test_opt_arg_g; /* flag argument (or value) */
+
+static const char *hg_bench_scale_short_opt_g = "hp:s:w:z:n:P:abV";
+/* clang-format off */
+static const struct na_test_opt hg_bench_scale_opt_g[] = {
+    {"help", no_arg, 'h'},
+    {"protocol", require_arg, 'p'},
+    {"servers", require_arg, 's'},
+    {"window", require_arg, 'w'},
+    {"size", require_arg, 'z'},
+    {"ops", require_arg, 'n'},
+    {"posted", require_arg, 'P'},
+    {"all", no_arg, 'a'},
+    {"busy", no_arg, 'b'},
+    {"verbose", no_arg, 'V'},
+    {NULL, 0, '\0'} /* Must add this at the end */
+};
+/* clang-format on */
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_scale_usage(const char *execname)
+{
+    printf("usage: mpirun -np N %s [OPTIONS]\n", execname);
+    printf("    -h, --help      Print a description of these options\n");
+    printf("    -p, --protocol  NA info string (e.g., ofi+tcp, na+sm)\n");
+    printf("    -s, --servers   Number of server ranks (default: 1)\n");
+    printf("    -a, --all       All-to-all, every rank is client and server\n");
+    printf("    -w, --window    Max requests in flight per client, swept by "
+           "powers of two (default: %d)\n",
+        HG_BENCH_SCALE_WINDOW_DEFAULT);
+    printf("    -z, --size      Request payload size (default: %d)\n",
+        HG_BENCH_SCALE_SIZE_DEFAULT);
+    printf("    -n, --ops       Requests per client and window (default: %d)"
+           "\n",
+        HG_BENCH_SCALE_OPS_DEFAULT);
+    printf("    -P, --posted    Unexpected receives posted by servers\n");
+    printf("    -b, --busy      Busy wait\n");
+    printf("    -V, --verbose   Print results of each server\n");
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_bench_scale_parse_options(
+    int argc, char *argv[], struct hg_bench_scale_info *info)
+{
+    int opt;
+
+    while ((opt = na_test_getopt(argc, argv, hg_bench_scale_short_opt_g,
+                hg_bench_scale_opt_g)) != EOF) {
+        switch (opt) {
+            case 'p': /* protocol */
+                info->protocol = na_test_opt_arg_g;
+                break;
+            case 's': /* number of servers */
+                info->server_count = (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'w': /* max window */
+                info->window_max = (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'z': /* payload size */
+                info->size = (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'n': /* number of operations */
+                info->ops = strtoul(na_test_opt_arg_g, NULL, 10);
+                break;
+            case 'P': /* posted unexpected receives */
+                info->post_init = (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'a': /* all-to-all */
+                info->all_to_all = HG_TRUE;
+                break;
+            case 'b': /* busy */
+                info->busy = HG_TRUE;
+                break;
+            case 'V': /* verbose */
+                info->verbose = HG_TRUE;
+                break;
+            case 'h':
+            default:
+                return HG_UTIL_FAIL;
+        }
+    }
+    na_test_opt_ind_g = 1;
+
+    if (info->protocol == NULL || info->window_max == 0 || info->ops == 0)
+        return HG_UTIL_FAIL;
+    if (info->all_to_all)
+        info->server_count = (unsigned int) info->rank_count;
+    else if (info->server_count == 0 ||
+             info->server_count >= (unsigned int) info->rank_count) {
+        HG_TEST_LOG_ERROR("Need at least one server and one client rank");
+        return HG_UTIL_FAIL;
+    }
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_scale_init(struct hg_bench_scale_info *info)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    char addr_string[HG_BENCH_SCALE_ADDR_MAX] = {'\0'};
+    char *addr_strings = NULL;
+    hg_size_t addr_string_size = sizeof(addr_string);
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_return_t ret;
+    unsigned int i;
+
+    info->is_server = info->all_to_all ||
+                      (unsigned int) info->rank < info->server_count;
+    info->is_client = info->all_to_all || !info->is_server;
+
+    if (info->busy)
+        hg_init_info.na_init_info.progress_mode = NA_NO_BLOCK;
+    if (info->post_init > 0)
+        hg_init_info.request_post_init = info->post_init;
+
+    info->hg_class = HG_Init_opt(
+        info->protocol, info->is_server, &hg_init_info);
+    HG_TEST_CHECK_ERROR(info->hg_class == NULL, error, ret, HG_FAULT,
+        "HG_Init_opt() failed");
+
+    info->context = HG_Context_create(info->hg_class);
+    HG_TEST_CHECK_ERROR(info->context == NULL, error, ret, HG_FAULT,
+        "HG_Context_create() failed");
+
+    info->rpc_id = MERCURY_REGISTER(info->hg_class, "hg_bench_scale_rpc",
+        perf_rpc_lat_in_t, void, hg_bench_scale_rpc_cb);
+
+    /* Exchange server addresses */
+    if (info->is_server) {
+        ret = HG_Addr_self(info->hg_class, &self_addr);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+        ret = HG_Addr_to_string(
+            info->hg_class, addr_string, &addr_string_size, self_addr);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Addr_to_string() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+    addr_strings = (char *) malloc(
+        (size_t) info->rank_count * HG_BENCH_SCALE_ADDR_MAX);
+    HG_TEST_CHECK_ERROR(addr_strings == NULL, error, ret, HG_NOMEM_ERROR,
+        "Could not allocate addresses");
+    MPI_Allgather(addr_string, HG_BENCH_SCALE_ADDR_MAX, MPI_CHAR, addr_strings,
+        HG_BENCH_SCALE_ADDR_MAX, MPI_CHAR, MPI_COMM_WORLD);
+
+    /* Many-to-one clients send to one server, all-to-all ranks send to every
+     * other rank, starting with the next one to spread the load */
+    info->addrs = (hg_addr_t *) calloc(
+        (size_t) info->rank_count, sizeof(hg_addr_t));
+    info->peers = (unsigned int *) calloc(
+        (size_t) info->rank_count, sizeof(unsigned int));
+    HG_TEST_CHECK_ERROR(info->addrs == NULL || info->peers == NULL, error, ret,
+        HG_NOMEM_ERROR, "Could not allocate peers");
+    if (info->all_to_all) {
+        unsigned int rank_count = (unsigned int) info->rank_count;
+
+        for (i = 1; i < rank_count; i++)
+            info->peers[info->peer_count++] =
+                ((unsigned int) info->rank + i) % rank_count;
+        if (info->peer_count == 0)
+            info->peers[info->peer_count++] = (unsigned int) info->rank;
+    } else if (info->is_client)
+        info->peers[info->peer_count++] =
+            ((unsigned int) info->rank - info->server_count) %
+            info->server_count;
+
+    for (i = 0; i < info->peer_count; i++) {
+        unsigned int peer = info->peers[i];
+
+        ret = HG_Addr_lookup2(info->hg_class,
+            addr_strings + (size_t) peer * HG_BENCH_SCALE_ADDR_MAX,
+            &info->addrs[peer]);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Addr_lookup2() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    if (self_addr != HG_ADDR_NULL)
+        HG_Addr_free(info->hg_class, self_addr);
+    free(addr_strings);
+
+    return HG_SUCCESS;
+
+error:
+    if (self_addr != HG_ADDR_NULL)
+        HG_Addr_free(info->hg_class, self_addr);
+    free(addr_strings);
+    hg_bench_scale_finalize(info);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_scale_finalize(struct hg_bench_scale_info *info)
+{
+    hg_return_t ret;
+    int i;
+
+    if (info->addrs) {
+        for (i = 0; i < info->rank_count; i++)
+            if (info->addrs[i] != HG_ADDR_NULL)
+                HG_Addr_free(info->hg_class, info->addrs[i]);
+        free(info->addrs);
+        info->addrs = NULL;
+    }
+    free(info->peers);
+    info->peers = NULL;
+
+    if (info->context) {
+        ret = HG_Context_destroy(info->context);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Context_destroy() failed (%s)", HG_Error_to_string(ret));
+        info->context = NULL;
+    }
+
+    if (info->hg_class) {
+        ret = HG_Finalize(info->hg_class);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Finalize() failed (%s)", HG_Error_to_string(ret));
+        info->hg_class = NULL;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_scale_rpc_cb(hg_handle_t handle)
+{
+    perf_rpc_lat_in_t in_struct;
+    hg_return_t ret;
+
+    /* Decode input to account for its cost */
+    ret = HG_Get_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Free_input(handle, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Free_input() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Respond(handle, NULL, NULL, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    HG_Destroy(handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_scale_progress(
+    struct hg_bench_scale_info *info, struct hg_bench_scale_server *server)
+{
+    unsigned int actual_count = 0;
+    hg_return_t ret;
+
+    do {
+        ret = HG_Trigger(info->context, 0, 1, &actual_count);
+    } while (ret == HG_SUCCESS && actual_count > 0);
+
+    if (server) {
+        struct hg_context_stats stats;
+
+        ret = HG_Context_get_stats(info->context, &stats);
+        if (ret == HG_SUCCESS) {
+            server->sample_count++;
+            if (stats.pending_count == 0)
+                server->empty_count++;
+            if (stats.pending_count < server->pending_min)
+                server->pending_min = stats.pending_count;
+        }
+    }
+
+    ret = HG_Progress(info->context, info->busy ? 0 : 1);
+    HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS && ret != HG_TIMEOUT,
+        "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+
+    return (ret == HG_TIMEOUT) ? HG_SUCCESS : ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_scale_forward(struct hg_bench_scale_slot *slot)
+{
+    struct hg_bench_scale_client *client = slot->client;
+    struct hg_bench_scale_info *info = client->info;
+    unsigned int peer = info->peers[client->posted % info->peer_count];
+    hg_return_t ret;
+
+    client->posted++;
+
+    /* Slots keep a handle for each peer they sent requests to */
+    if (slot->handles[peer] == HG_HANDLE_NULL) {
+        ret = HG_Create(info->context, info->addrs[peer], info->rpc_id,
+            &slot->handles[peer]);
+        HG_TEST_CHECK_HG_ERROR(
+            done, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    hg_time_get_current(&slot->start);
+    ret = HG_Forward(slot->handles[peer], hg_bench_scale_forward_cb, slot,
+        &client->in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_scale_forward_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_bench_scale_slot *slot =
+        (struct hg_bench_scale_slot *) callback_info->arg;
+    struct hg_bench_scale_client *client = slot->client;
+    hg_time_t now;
+
+    hg_time_get_current(&now);
+    client->completed++;
+
+    if (callback_info->ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Error in HG callback (%s)",
+            HG_Error_to_string(callback_info->ret));
+        client->ret = callback_info->ret;
+        return HG_SUCCESS;
+    }
+    if (client->histogram)
+        hg_histogram_record(client->histogram,
+            (hg_util_uint64_t)(
+                hg_time_to_double(hg_time_subtract(now, slot->start)) *
+                1000000000.0));
+
+    /* Keep the window full */
+    if (client->ret == HG_SUCCESS && client->posted < client->op_count)
+        client->ret = hg_bench_scale_forward(slot);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_scale_run(struct hg_bench_scale_info *info,
+    struct hg_bench_scale_client *client, unsigned int window,
+    unsigned long ops, struct hg_histogram *histogram,
+    struct hg_bench_scale_server *server, double *client_time,
+    double *server_time)
+{
+    MPI_Request request;
+    hg_time_t t1, t2;
+    hg_return_t ret = HG_SUCCESS;
+    int done = 0;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    hg_time_get_current(&t1);
+
+    if (client) {
+        unsigned int i;
+
+        client->histogram = histogram;
+        client->op_count = ops;
+        client->posted = 0;
+        client->completed = 0;
+        client->ret = HG_SUCCESS;
+
+        for (i = 0; i < window && client->posted < client->op_count; i++) {
+            ret = hg_bench_scale_forward(&client->slots[i]);
+            HG_TEST_CHECK_HG_ERROR(error, ret, "Could not forward request");
+        }
+
+        /* Make progress until all requests of this client complete */
+        while (client->completed < client->posted) {
+            ret = hg_bench_scale_progress(info, server);
+            HG_TEST_CHECK_HG_ERROR(error, ret, "Could not make progress");
+        }
+        ret = client->ret;
+        HG_TEST_CHECK_HG_ERROR(error, ret, "Requests failed");
+    }
+    hg_time_get_current(&t2);
+    *client_time = hg_time_to_double(hg_time_subtract(t2, t1));
+
+error:
+    /* Keep making progress (e.g., to serve other clients) until all ranks
+     * are done */
+    MPI_Ibarrier(MPI_COMM_WORLD, &request);
+    while (!done) {
+        if (hg_bench_scale_progress(info, server) != HG_SUCCESS)
+            ret = HG_PROTOCOL_ERROR;
+        MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+    }
+    hg_time_get_current(&t2);
+    *server_time = hg_time_to_double(hg_time_subtract(t2, t1));
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bench_scale_measure(struct hg_bench_scale_info *info,
+    struct hg_bench_scale_client *client, unsigned int window,
+    struct hg_histogram *histogram,
+    struct hg_bench_scale_rank_result *rank_results)
+{
+    struct hg_bench_scale_server server_sample, *server = NULL;
+    struct hg_bench_scale_rank_result rank_result = {-1.0, 0.0, 0.0};
+    struct hg_class_stats stats;
+    unsigned long long counts[HG_HISTOGRAM_BUCKETS + 1],
+        total_counts[HG_HISTOGRAM_BUCKETS + 1], max, total_max = 0;
+    double client_time, server_time, client_ops, total_ops = 0.0,
+                                                 max_time = 0.0;
+    unsigned int i;
+    hg_return_t ret;
+
+    if (info->is_server) {
+        server = &server_sample;
+        memset(server, 0, sizeof(*server));
+        server->pending_min = (hg_uint32_t) -1;
+        ret = HG_Class_get_stats(info->hg_class, &stats, NULL, NULL);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Class_get_stats() failed (%s)",
+            HG_Error_to_string(ret));
+        server->handled = stats.handle_count;
+    }
+    hg_histogram_init(histogram);
+
+    ret = hg_bench_scale_run(info, client, window, info->ops, histogram,
+        server, &client_time, &server_time);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not run benchmark");
+
+    /* Aggregate rate is bounded by the slowest client */
+    client_ops = client ? (double) info->ops : 0.0;
+    if (!client)
+        client_time = 0.0;
+    MPI_Reduce(
+        &client_ops, &total_ops, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(
+        &client_time, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    /* Merge latency histograms of all clients into rank 0's histogram */
+    for (i = 0; i < HG_HISTOGRAM_BUCKETS; i++)
+        counts[i] =
+            (unsigned long long) hg_atomic_get64(&histogram->buckets[i]);
+    counts[HG_HISTOGRAM_BUCKETS] = hg_histogram_count(histogram);
+    max = hg_histogram_max(histogram);
+    MPI_Reduce(counts, total_counts, HG_HISTOGRAM_BUCKETS + 1,
+        MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&max, &total_max, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, 0,
+        MPI_COMM_WORLD);
+    if (info->rank == 0) {
+        for (i = 0; i < HG_HISTOGRAM_BUCKETS; i++)
+            hg_atomic_set64(
+                &histogram->buckets[i], (hg_util_int64_t) total_counts[i]);
+        hg_atomic_set64(&histogram->count, (hg_util_int64_t) total_counts[i]);
+        hg_atomic_set64(&histogram->max, (hg_util_int64_t) total_max);
+    }
+
+    if (server) {
+        ret = HG_Class_get_stats(info->hg_class, &stats, NULL, NULL);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Class_get_stats() failed (%s)",
+            HG_Error_to_string(ret));
+        rank_result.rate =
+            (double) (stats.handle_count - server->handled) / server_time;
+        rank_result.pending_min =
+            (server->sample_count > 0) ? (double) server->pending_min : 0.0;
+        rank_result.empty = (server->sample_count > 0)
+                                ? (double) server->empty_count * 100.0 /
+                                      (double) server->sample_count
+                                : 0.0;
+    }
+    MPI_Gather(&rank_result, 3, MPI_DOUBLE, rank_results, 3, MPI_DOUBLE, 0,
+        MPI_COMM_WORLD);
+
+    if (info->rank == 0) {
+        double rate_min = -1.0, rate_max = 0.0, pending_min = -1.0,
+               empty_max = 0.0;
+        int rank;
+
+        for (rank = 0; rank < info->rank_count; rank++) {
+            const struct hg_bench_scale_rank_result *result =
+                &rank_results[rank];
+
+            if (result->rate < 0.0)
+                continue;
+            if (rate_min < 0.0 || result->rate < rate_min)
+                rate_min = result->rate;
+            if (result->rate > rate_max)
+                rate_max = result->rate;
+            if (pending_min < 0.0 || result->pending_min < pending_min)
+                pending_min = result->pending_min;
+            if (result->empty > empty_max)
+                empty_max = result->empty;
+        }
+
+        printf("%-8u%14.2f%10.2f%10.2f%10.2f%14.2f%14.2f%9.0f%10.2f\n", window,
+            total_ops / max_time,
+            (double) hg_histogram_percentile(histogram, 50.0) / 1000.0,
+            (double) hg_histogram_percentile(histogram, 99.0) / 1000.0,
+            (double) hg_histogram_percentile(histogram, 99.9) / 1000.0,
+            rate_min, rate_max, pending_min, empty_max);
+
+        if (info->verbose)
+            for (rank = 0; rank < info->rank_count; rank++)
+                if (rank_results[rank].rate >= 0.0)
+                    printf("#   server %d: %.2f req/s, min posted %.0f, "
+                           "no posted %.2f%%\n",
+                        rank, rank_results[rank].rate,
+                        rank_results[rank].pending_min,
+                        rank_results[rank].empty);
+        fflush(stdout);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct hg_bench_scale_info info;
+    struct hg_bench_scale_client client;
+    struct hg_bench_scale_rank_result *rank_results = NULL;
+    struct hg_histogram *histogram = NULL;
+    char *payload = NULL;
+    unsigned int window, i;
+    double client_time, server_time;
+    hg_return_t hg_ret;
+    int ret = EXIT_SUCCESS;
+
+    MPI_Init(&argc, &argv);
+
+    memset(&info, 0, sizeof(info));
+    memset(&client, 0, sizeof(client));
+    info.server_count = 1;
+    info.window_max = HG_BENCH_SCALE_WINDOW_DEFAULT;
+    info.size = HG_BENCH_SCALE_SIZE_DEFAULT;
+    info.ops = HG_BENCH_SCALE_OPS_DEFAULT;
+    MPI_Comm_rank(MPI_COMM_WORLD, &info.rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &info.rank_count);
+
+    if (hg_bench_scale_parse_options(argc, argv, &info) != HG_UTIL_SUCCESS) {
+        if (info.rank == 0)
+            hg_bench_scale_usage(argv[0]);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    hg_ret = hg_bench_scale_init(&info);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "Could not initialize benchmark");
+
+    histogram = (struct hg_histogram *) malloc(sizeof(*histogram));
+    rank_results = (struct hg_bench_scale_rank_result *) malloc(
+        (size_t) info.rank_count * sizeof(*rank_results));
+    HG_TEST_CHECK_ERROR(histogram == NULL || rank_results == NULL, cleanup,
+        ret, EXIT_FAILURE, "Could not allocate results");
+
+    if (info.is_client) {
+        client.info = &info;
+        client.in_struct.buf_size = info.size;
+        if (info.size > 0) {
+            payload = (char *) malloc(info.size);
+            HG_TEST_CHECK_ERROR(payload == NULL, cleanup, ret, EXIT_FAILURE,
+                "Could not allocate payload");
+            for (i = 0; i < info.size; i++)
+                payload[i] = (char) i;
+        }
+        client.in_struct.buf = payload;
+
+        client.slots = (struct hg_bench_scale_slot *) calloc(
+            info.window_max, sizeof(struct hg_bench_scale_slot));
+        HG_TEST_CHECK_ERROR(client.slots == NULL, cleanup, ret, EXIT_FAILURE,
+            "Could not allocate slots");
+        for (i = 0; i < info.window_max; i++) {
+            client.slots[i].client = &client;
+            client.slots[i].handles = (hg_handle_t *) calloc(
+                (size_t) info.rank_count, sizeof(hg_handle_t));
+            HG_TEST_CHECK_ERROR(client.slots[i].handles == NULL, cleanup, ret,
+                EXIT_FAILURE, "Could not allocate handles");
+        }
+    }
+
+    if (info.rank == 0) {
+        printf("# %s v%s (%s, %d client(s), %u server(s), %s, %u byte(s))\n",
+            BENCHMARK_NAME, VERSION_NAME, info.protocol,
+            info.all_to_all ? info.rank_count
+                            : info.rank_count - (int) info.server_count,
+            info.server_count, info.all_to_all ? "all-to-all" : "many-to-one",
+            info.size);
+        printf("%-8s%14s%10s%10s%10s%14s%14s%9s%10s\n", "# Window",
+            "Rate (req/s)", "p50 (us)", "p99 (us)", "p999 (us)",
+            "Srv min (r/s)", "Srv max (r/s)", "Min post", "No post %");
+        fflush(stdout);
+    }
+
+    /* Warm up connections to every peer */
+    hg_ret = hg_bench_scale_run(&info, info.is_client ? &client : NULL,
+        info.window_max, (unsigned long) info.peer_count * info.window_max,
+        NULL, NULL, &client_time, &server_time);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, cleanup, ret, EXIT_FAILURE,
+        "Could not warm up");
+
+    for (window = 1; window <= info.window_max; window *= 2) {
+        hg_ret = hg_bench_scale_measure(&info, info.is_client ? &client : NULL,
+            window, histogram, rank_results);
+        HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, cleanup, ret, EXIT_FAILURE,
+            "hg_bench_scale_measure() failed");
+    }
+
+cleanup:
+    if (client.slots) {
+        for (i = 0; i < info.window_max; i++) {
+            int rank;
+
+            if (client.slots[i].handles == NULL)
+                continue;
+            for (rank = 0; rank < info.rank_count; rank++)
+                if (client.slots[i].handles[rank] != HG_HANDLE_NULL)
+                    HG_Destroy(client.slots[i].handles[rank]);
+            free(client.slots[i].handles);
+        }
+        free(client.slots);
+    }
+    free(payload);
+    free(histogram);
+    free(rank_results);
+
+    /* Servers must remain until clients are done */
+    MPI_Barrier(MPI_COMM_WORLD);
+    hg_bench_scale_finalize(&info);
+
+done:
+    MPI_Finalize();
+
+    return ret;
+}
@@ -10,6 +10,8 @@
 
 #include "mercury_test.h"
 
+#include "mercury_time.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -20,6 +22,8 @@
 #define HG_TEST_PROGRESS_TIMEOUT 100
 #define HG_TEST_TRIGGER_TIMEOUT  HG_MAX_IDLE_TIME
 
+#define HG_TEST_TRIGGER_BATCH_COUNT 64
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -90,10 +94,11 @@ hg_test_progress_work(void *arg)
         unsigned int actual_count = 0;
 
         do {
-            ret = HG_Trigger(context, 0, 1, &actual_count);
+            ret = HG_Trigger_batch(
+                context, 0, HG_TEST_TRIGGER_BATCH_COUNT, &actual_count);
         } while ((ret == HG_SUCCESS) && actual_count);
         HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, done, tret,
-            (HG_THREAD_RETURN_TYPE) 0, "HG_Trigger() failed (%s)",
+            (HG_THREAD_RETURN_TYPE) 0, "HG_Trigger_batch() failed (%s)",
             HG_Error_to_string(ret));
 
         if (hg_atomic_get32(&hg_test_context_info->finalizing)) {
@@ -138,6 +143,20 @@ main(int argc, char *argv[])
     hg_test_context_info = (struct hg_test_context_info *) HG_Context_get_data(
         hg_test_info.context);
 
+    if (hg_test_info.progress_thread_count) {
+        /* Context threads poll and trigger, only wait for finalize */
+        ret = HG_Context_set_progress_threads(
+            hg_test_info.context, hg_test_info.progress_thread_count);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS, error, rc, EXIT_FAILURE,
+            "HG_Context_set_progress_threads() failed (%s)",
+            HG_Error_to_string(ret));
+
+        while (!hg_atomic_get32(&hg_test_context_info->finalizing))
+            hg_time_sleep(hg_time_from_ms(HG_TEST_PROGRESS_TIMEOUT));
+
+        goto error;
+    }
+
 #ifdef HG_TEST_HAS_THREAD_POOL
     if (hg_test_info.na_test_info.max_contexts > 1) {
         hg_uint8_t context_count =
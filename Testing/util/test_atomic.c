@@ -191,6 +191,22 @@ main(void)
         goto done;
     }
 
+    /* Add64 test */
+    val64 = hg_atomic_add64(&atomic_int64, 5);
+    if (val64 != 2) {
+        fprintf(
+            stderr, "Error in hg_atomic_add64: atomic value is %ld\n", val64);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    val64 = hg_atomic_add64(&atomic_int64, -5);
+    if (val64 != 7) {
+        fprintf(
+            stderr, "Error in hg_atomic_add64: atomic value is %ld\n", val64);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
     /* Or64 test */
     init_val64 = hg_atomic_get64(&atomic_int64);
     val64 = hg_atomic_or64(&atomic_int64, 8);
@@ -266,6 +282,44 @@ main(void)
         goto done;
     }
 
+    /* Relaxed32 test */
+    hg_atomic_set32_relaxed(&atomic_int32, 4);
+    val32 = hg_atomic_incr32_relaxed(&atomic_int32);
+    if (val32 != 5 || hg_atomic_get32_relaxed(&atomic_int32) != 5) {
+        fprintf(stderr,
+            "Error in hg_atomic_incr32_relaxed: atomic value is %d\n", val32);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (hg_atomic_cas32_relaxed(&atomic_int32, 1, 0) == HG_UTIL_TRUE ||
+        hg_atomic_cas32_relaxed(&atomic_int32, 5, 6) == HG_UTIL_FALSE) {
+        fprintf(stderr, "Error in hg_atomic_cas32_relaxed: atomic value is "
+                        "%d, expected 6\n",
+            hg_atomic_get32(&atomic_int32));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Relaxed64 test */
+    hg_atomic_set64_relaxed(&atomic_int64, 4);
+    val64 = hg_atomic_incr64_relaxed(&atomic_int64);
+    if (val64 != 5) {
+        fprintf(stderr,
+            "Error in hg_atomic_incr64_relaxed: atomic value is %ld\n", val64);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    val64 = hg_atomic_add64_relaxed(&atomic_int64, 3);
+    if (val64 != 5 || hg_atomic_get64_relaxed(&atomic_int64) != 8) {
+        fprintf(stderr,
+            "Error in hg_atomic_add64_relaxed: atomic value is %ld\n",
+            hg_atomic_get64(&atomic_int64));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    hg_atomic_fence_acquire();
+    hg_atomic_fence_release();
+
 done:
     return ret;
 }
@@ -20,6 +20,8 @@ main(void)
     struct my_entry my_entry1 = {.value = value1};
     struct my_entry my_entry2 = {.value = value2};
     struct my_entry *my_entry_ptr;
+    void *entries[HG_TEST_QUEUE_SIZE];
+    unsigned int count, i;
 
     hg_atomic_queue = hg_atomic_queue_alloc(HG_TEST_QUEUE_SIZE);
     if (!hg_atomic_queue) {
@@ -47,6 +49,82 @@ main(void)
         goto done;
     }
 
+    /* Batched pop */
+    hg_atomic_queue_push(hg_atomic_queue, &my_entry1);
+    hg_atomic_queue_push(hg_atomic_queue, &my_entry2);
+    hg_atomic_queue_push(hg_atomic_queue, &my_entry1);
+
+    count = hg_atomic_queue_pop_mc_n(hg_atomic_queue, entries, 2);
+    if (count != 2) {
+        fprintf(stderr, "Error: expected 2 entries, got %u\n", count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (value1 != ((struct my_entry *) entries[0])->value ||
+        value2 != ((struct my_entry *) entries[1])->value) {
+        fprintf(stderr, "Error: values do not match\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    count = hg_atomic_queue_pop_mc_n(hg_atomic_queue, entries, 2);
+    if (count != 1) {
+        fprintf(stderr, "Error: expected 1 entry, got %u\n", count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    if (!hg_atomic_queue_is_empty(hg_atomic_queue)) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Batched push, one slot is always left empty */
+    for (i = 0; i < HG_TEST_QUEUE_SIZE; i++)
+        entries[i] = (i % 2) ? &my_entry2 : &my_entry1;
+
+    count = hg_atomic_queue_push_n(hg_atomic_queue, entries, 2);
+    if (count != 2) {
+        fprintf(
+            stderr, "Error: expected to push 2 entries, pushed %u\n", count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    count =
+        hg_atomic_queue_push_n(hg_atomic_queue, entries, HG_TEST_QUEUE_SIZE);
+    if (count != HG_TEST_QUEUE_SIZE - 3) {
+        fprintf(stderr, "Error: expected to push %d entries, pushed %u\n",
+            HG_TEST_QUEUE_SIZE - 3, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (hg_atomic_queue_push_n(hg_atomic_queue, entries, 1) != 0) {
+        fprintf(stderr, "Error: queue should be full\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    count =
+        hg_atomic_queue_pop_mc_n(hg_atomic_queue, entries, HG_TEST_QUEUE_SIZE);
+    if (count != HG_TEST_QUEUE_SIZE - 1) {
+        fprintf(stderr, "Error: expected %d entries, got %u\n",
+            HG_TEST_QUEUE_SIZE - 1, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < count; i++) {
+        /* Each batch started from the first entry */
+        unsigned int j = (i < 2) ? i : i - 2;
+        int expected = (j % 2) ? value2 : value1;
+
+        if (expected != ((struct my_entry *) entries[i])->value) {
+            fprintf(stderr, "Error: values do not match\n");
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
 done:
     hg_atomic_queue_free(hg_atomic_queue);
     return ret;
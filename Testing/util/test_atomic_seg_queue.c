@@ -0,0 +1,164 @@
+#include "mercury_atomic_seg_queue.h"
+#include "mercury_thread.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct my_entry {
+    int value;
+};
+
+#define HG_TEST_SEG_SIZE     16
+#define HG_TEST_NUM_ENTRIES  (HG_TEST_SEG_SIZE * 8)
+#define HG_TEST_NUM_THREADS  4
+
+struct thread_args {
+    struct hg_atomic_seg_queue *queue;
+    struct my_entry *entries;
+    hg_atomic_int32_t popped;
+};
+
+static HG_THREAD_RETURN_TYPE
+thread_cb_push_pop(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    struct thread_args *args = (struct thread_args *) arg;
+    int i;
+
+    for (i = 0; i < HG_TEST_NUM_ENTRIES; i++) {
+        if (hg_atomic_seg_queue_push(args->queue, &args->entries[i]) !=
+            HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: could not push entry\n");
+            break;
+        }
+        /* Pop every other entry to exercise segment retirement */
+        if ((i % 2) && hg_atomic_seg_queue_pop_mc(args->queue))
+            hg_atomic_incr32(&args->popped);
+    }
+
+    hg_thread_exit(thread_ret);
+    return thread_ret;
+}
+
+int
+main(void)
+{
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue;
+    struct my_entry entries[HG_TEST_NUM_ENTRIES];
+    struct my_entry *my_entry_ptr;
+    void *batch[HG_TEST_SEG_SIZE + 1];
+    hg_thread_t threads[HG_TEST_NUM_THREADS];
+    struct thread_args args;
+    unsigned int count;
+    int ret = EXIT_SUCCESS;
+    int i;
+
+    for (i = 0; i < HG_TEST_NUM_ENTRIES; i++)
+        entries[i].value = i;
+
+    hg_atomic_seg_queue = hg_atomic_seg_queue_alloc(HG_TEST_SEG_SIZE);
+    if (!hg_atomic_seg_queue) {
+        fprintf(stderr, "Error: could not allocate queue\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Push more entries than a single segment can hold */
+    for (i = 0; i < HG_TEST_NUM_ENTRIES; i++) {
+        if (hg_atomic_seg_queue_push(hg_atomic_seg_queue, &entries[i]) !=
+            HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: could not push entry %d\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    count = hg_atomic_seg_queue_count(hg_atomic_seg_queue);
+    if (count != HG_TEST_NUM_ENTRIES) {
+        fprintf(stderr, "Error: count does not match, expected %d, got %u\n",
+            HG_TEST_NUM_ENTRIES, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Batched pop across segment boundaries */
+    count = hg_atomic_seg_queue_pop_mc_n(
+        hg_atomic_seg_queue, batch, HG_TEST_SEG_SIZE + 1);
+    if (count != HG_TEST_SEG_SIZE + 1) {
+        fprintf(stderr, "Error: expected %d entries, got %u\n",
+            HG_TEST_SEG_SIZE + 1, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < (int) count; i++) {
+        if (((struct my_entry *) batch[i])->value != i) {
+            fprintf(stderr, "Error: values do not match, expected %d, got %d\n",
+                i, ((struct my_entry *) batch[i])->value);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    /* Entries must come out in order */
+    for (i = (int) count; i < HG_TEST_NUM_ENTRIES; i++) {
+        my_entry_ptr = hg_atomic_seg_queue_pop_mc(hg_atomic_seg_queue);
+        if (!my_entry_ptr || my_entry_ptr->value != i) {
+            fprintf(stderr, "Error: values do not match, expected %d, got %d\n",
+                i, my_entry_ptr ? my_entry_ptr->value : -1);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    if (!hg_atomic_seg_queue_is_empty(hg_atomic_seg_queue)) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Batched push across segment boundaries */
+    for (i = 0; i < HG_TEST_SEG_SIZE + 1; i++)
+        batch[i] = &entries[i];
+    count = hg_atomic_seg_queue_push_n(
+        hg_atomic_seg_queue, batch, HG_TEST_SEG_SIZE + 1);
+    if (count != HG_TEST_SEG_SIZE + 1) {
+        fprintf(stderr, "Error: expected to push %d entries, pushed %u\n",
+            HG_TEST_SEG_SIZE + 1, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < HG_TEST_SEG_SIZE + 1; i++) {
+        my_entry_ptr = hg_atomic_seg_queue_pop_mc(hg_atomic_seg_queue);
+        if (!my_entry_ptr || my_entry_ptr->value != i) {
+            fprintf(stderr, "Error: values do not match, expected %d, got %d\n",
+                i, my_entry_ptr ? my_entry_ptr->value : -1);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    /* Concurrent pushes and pops */
+    args.queue = hg_atomic_seg_queue;
+    args.entries = entries;
+    hg_atomic_init32(&args.popped, 0);
+    for (i = 0; i < HG_TEST_NUM_THREADS; i++)
+        hg_thread_create(&threads[i], thread_cb_push_pop, &args);
+    for (i = 0; i < HG_TEST_NUM_THREADS; i++)
+        hg_thread_join(threads[i]);
+
+    count = (unsigned int) hg_atomic_get32(&args.popped);
+    while (hg_atomic_seg_queue_pop_mc(hg_atomic_seg_queue))
+        count++;
+    if (count != HG_TEST_NUM_ENTRIES * HG_TEST_NUM_THREADS) {
+        fprintf(stderr, "Error: count does not match, expected %d, got %u\n",
+            HG_TEST_NUM_ENTRIES * HG_TEST_NUM_THREADS, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    hg_atomic_seg_queue_free(hg_atomic_seg_queue);
+    return ret;
+}
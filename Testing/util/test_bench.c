@@ -0,0 +1,556 @@
+#include "mercury_atomic.h"
+#include "mercury_atomic_queue.h"
+#include "mercury_event.h"
+#include "mercury_hash_table.h"
+#include "mercury_histogram.h"
+#include "mercury_poll.h"
+#include "mercury_thread.h"
+#include "mercury_thread_mutex.h"
+#include "mercury_thread_pool.h"
+#include "mercury_thread_rwlock.h"
+#include "mercury_thread_spin.h"
+#include "mercury_time.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Microbenchmarks of util primitives. Each benchmark runs an operation in a
+ * loop from a growing number of threads that share the primitive, and
+ * reports the aggregate rate and the latency of one operation in every
+ * HG_BENCH_SAMPLE operations (which includes the cost of reading the clock).
+ * The atomic backend is selected at configure time, build once per backend
+ * (e.g., with MERCURY_USE_OPA) to compare them. */
+
+#if defined(_WIN32)
+#    define HG_BENCH_ATOMIC_BACKEND "win32 interlocked"
+#elif defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+#    define HG_BENCH_ATOMIC_BACKEND "opa"
+#elif defined(HG_UTIL_HAS_STDATOMIC_H)
+#    define HG_BENCH_ATOMIC_BACKEND "stdatomic"
+#elif defined(__APPLE__)
+#    define HG_BENCH_ATOMIC_BACKEND "osatomic"
+#endif
+
+#define HG_BENCH_OPS_DEFAULT     (1000000)
+#define HG_BENCH_THREADS_DEFAULT (8)
+#define HG_BENCH_SAMPLE          (64)   /* Sampling interval of latency */
+#define HG_BENCH_QUEUE_SIZE      (1024) /* Atomic queue size */
+#define HG_BENCH_HASH_KEYS       (1024) /* Keys in hash table */
+#define HG_BENCH_POOL_THREADS    (4)    /* Threads of thread pool */
+#define HG_BENCH_POOL_WINDOW     (16)   /* Work posted per thread at once */
+
+struct hg_bench_thread;
+
+struct hg_bench_work {
+    struct hg_thread_work work;     /* Posted work */
+    struct hg_bench_thread *thread; /* Posting thread */
+    hg_time_ticks_t start;          /* Time of post */
+};
+
+/* Benchmark thread */
+struct hg_bench_thread {
+    struct hg_bench_work works[HG_BENCH_POOL_WINDOW]; /* Pool work */
+    struct hg_histogram histogram;                    /* Latencies (ns) */
+    hg_atomic_int32_t completed;                      /* Pool work executed */
+    hg_thread_t thread;                               /* Thread */
+    double time;                                      /* Time to completion */
+    unsigned long ops;                                /* Number of ops */
+    hg_util_uint64_t clock;                           /* Sum of clock reads */
+    int key;                                          /* Hash key */
+    int event_fd;                                     /* Poll event */
+};
+
+/* Benchmark of one operation */
+struct hg_bench {
+    const char *name;                                    /* Name */
+    void (*op)(struct hg_bench_thread *, unsigned long); /* Operation */
+    hg_util_bool_t own_latency; /* Operation records its own latency */
+};
+
+/* Shared primitives */
+static hg_atomic_int32_t hg_bench_int32_g = HG_ATOMIC_VAR_INIT(0);
+static hg_atomic_int64_t hg_bench_int64_g = HG_ATOMIC_VAR_INIT(0);
+static struct hg_atomic_queue *hg_bench_queue_g = NULL;
+static hg_hash_table_t *hg_bench_hash_table_g = NULL;
+static int hg_bench_hash_keys_g[HG_BENCH_HASH_KEYS];
+static hg_thread_rwlock_t hg_bench_rwlock_g;
+static hg_thread_spin_t hg_bench_spin_g;
+static hg_thread_mutex_t hg_bench_mutex_g;
+static hg_poll_set_t *hg_bench_poll_set_g = NULL;
+static hg_thread_pool_t *hg_bench_pool_g = NULL;
+static unsigned long hg_bench_counter_g = 0;
+
+/* Start of threads */
+static hg_atomic_int32_t hg_bench_ready_g = HG_ATOMIC_VAR_INIT(0);
+static hg_atomic_int32_t hg_bench_go_g = HG_ATOMIC_VAR_INIT(0);
+static hg_time_t hg_bench_start_g;
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_bench_int_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return *((int *) key1) == *((int *) key2);
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_bench_int_hash(hg_hash_table_key_t key)
+{
+    return *((unsigned int *) key);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_atomic_incr32(struct hg_bench_thread *thread, unsigned long i)
+{
+    (void) thread;
+    (void) i;
+    hg_atomic_incr32(&hg_bench_int32_g);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_atomic_incr64(struct hg_bench_thread *thread, unsigned long i)
+{
+    (void) thread;
+    (void) i;
+    hg_atomic_incr64(&hg_bench_int64_g);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_atomic_cas32(struct hg_bench_thread *thread, unsigned long i)
+{
+    hg_util_int32_t value;
+
+    (void) thread;
+    (void) i;
+    do {
+        value = hg_atomic_get32(&hg_bench_int32_g);
+    } while (!hg_atomic_cas32(&hg_bench_int32_g, value, value + 1));
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_queue_push_pop(struct hg_bench_thread *thread, unsigned long i)
+{
+    (void) i;
+
+    /* Queue holds at most one entry per thread, push cannot fail */
+    hg_atomic_queue_push(hg_bench_queue_g, thread);
+    while (hg_atomic_queue_pop_mc(hg_bench_queue_g) == NULL)
+        hg_thread_yield();
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_hash_lookup(struct hg_bench_thread *thread, unsigned long i)
+{
+    (void) thread;
+
+    hg_thread_rwlock_rdlock(&hg_bench_rwlock_g);
+    hg_hash_table_lookup(hg_bench_hash_table_g,
+        (hg_hash_table_key_t) &hg_bench_hash_keys_g[i % HG_BENCH_HASH_KEYS]);
+    hg_thread_rwlock_release_rdlock(&hg_bench_rwlock_g);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_hash_insert(struct hg_bench_thread *thread, unsigned long i)
+{
+    (void) i;
+
+    /* Keys of threads are not in the table */
+    hg_thread_rwlock_wrlock(&hg_bench_rwlock_g);
+    hg_hash_table_insert(hg_bench_hash_table_g,
+        (hg_hash_table_key_t) &thread->key, (hg_hash_table_value_t) thread);
+    hg_hash_table_remove(
+        hg_bench_hash_table_g, (hg_hash_table_key_t) &thread->key);
+    hg_thread_rwlock_release_wrlock(&hg_bench_rwlock_g);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_spin(struct hg_bench_thread *thread, unsigned long i)
+{
+    (void) thread;
+    (void) i;
+
+    hg_thread_spin_lock(&hg_bench_spin_g);
+    hg_bench_counter_g++;
+    hg_thread_spin_unlock(&hg_bench_spin_g);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_mutex(struct hg_bench_thread *thread, unsigned long i)
+{
+    (void) thread;
+    (void) i;
+
+    hg_thread_mutex_lock(&hg_bench_mutex_g);
+    hg_bench_counter_g++;
+    hg_thread_mutex_unlock(&hg_bench_mutex_g);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_time_current(struct hg_bench_thread *thread, unsigned long i)
+{
+    hg_time_t now;
+
+    (void) i;
+
+    hg_time_get_current(&now);
+    thread->clock += (hg_util_uint64_t) now.tv_sec;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_time_ticks(struct hg_bench_thread *thread, unsigned long i)
+{
+    (void) i;
+
+    thread->clock += hg_time_get_ticks();
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_poll(struct hg_bench_thread *thread, unsigned long i)
+{
+    struct hg_poll_event event;
+    unsigned int count = 0;
+    hg_util_bool_t signaled;
+
+    (void) i;
+
+    /* Signal own event and consume an event of any thread */
+    hg_event_set(thread->event_fd);
+    hg_poll_wait(hg_bench_poll_set_g, 0, 1, &event, &count);
+    if (count > 0)
+        hg_event_get(event.data.fd, &signaled);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_bench_pool_cb(void *arg)
+{
+    struct hg_bench_work *work = (struct hg_bench_work *) arg;
+    hg_thread_ret_t ret = 0;
+
+    /* Latency from post to execution */
+    hg_histogram_record(&work->thread->histogram,
+        hg_time_ticks_to_ns(hg_time_get_ticks() - work->start));
+    hg_atomic_incr32(&work->thread->completed);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_pool_post(struct hg_bench_thread *thread, unsigned long i)
+{
+    struct hg_bench_work *work = &thread->works[i % HG_BENCH_POOL_WINDOW];
+
+    /* Wait for work that last used this slot */
+    while ((unsigned long) hg_atomic_get32(&thread->completed) +
+               HG_BENCH_POOL_WINDOW <=
+           i)
+        hg_thread_yield();
+
+    work->start = hg_time_get_ticks();
+    hg_thread_pool_post(hg_bench_pool_g, &work->work);
+}
+
+static const struct hg_bench hg_bench_list_g[] = {
+    {"atomic_incr32", hg_bench_atomic_incr32, HG_UTIL_FALSE},
+    {"atomic_incr64", hg_bench_atomic_incr64, HG_UTIL_FALSE},
+    {"atomic_cas32", hg_bench_atomic_cas32, HG_UTIL_FALSE},
+    {"queue_push_pop", hg_bench_queue_push_pop, HG_UTIL_FALSE},
+    {"hash_lookup", hg_bench_hash_lookup, HG_UTIL_FALSE},
+    {"hash_insert", hg_bench_hash_insert, HG_UTIL_FALSE},
+    {"spin", hg_bench_spin, HG_UTIL_FALSE},
+    {"mutex", hg_bench_mutex, HG_UTIL_FALSE},
+    {"time_current", hg_bench_time_current, HG_UTIL_FALSE},
+    {"time_ticks", hg_bench_time_ticks, HG_UTIL_FALSE},
+    {"poll", hg_bench_poll, HG_UTIL_FALSE},
+    {"pool_post", hg_bench_pool_post, HG_UTIL_TRUE}};
+
+#define HG_BENCH_COUNT (sizeof(hg_bench_list_g) / sizeof(hg_bench_list_g[0]))
+
+static const struct hg_bench *hg_bench_g = NULL; /* Running benchmark */
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_bench_thread_cb(void *arg)
+{
+    struct hg_bench_thread *thread = (struct hg_bench_thread *) arg;
+    void (*op)(struct hg_bench_thread *, unsigned long) = hg_bench_g->op;
+    hg_util_bool_t sample = !hg_bench_g->own_latency;
+    hg_thread_ret_t ret = 0;
+    hg_time_ticks_t t1;
+    hg_time_t t2;
+    unsigned long i;
+
+    /* Start all threads at once */
+    hg_atomic_incr32(&hg_bench_ready_g);
+    while (!hg_atomic_get32(&hg_bench_go_g))
+        hg_thread_yield();
+
+    for (i = 0; i < thread->ops; i++) {
+        if (sample && (i % HG_BENCH_SAMPLE) == 0) {
+            t1 = hg_time_get_ticks();
+            op(thread, i);
+            hg_histogram_record(&thread->histogram,
+                hg_time_ticks_to_ns(hg_time_get_ticks() - t1));
+        } else
+            op(thread, i);
+    }
+
+    /* Pool work must be executed */
+    if (hg_bench_g->own_latency)
+        while ((unsigned long) hg_atomic_get32(&thread->completed) <
+               thread->ops)
+            hg_thread_yield();
+    hg_time_get_current(&t2);
+    thread->time = hg_time_diff(t2, hg_bench_start_g);
+
+    hg_thread_exit(ret);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_bench_run(const struct hg_bench *bench, struct hg_bench_thread *threads,
+    unsigned int thread_count, unsigned long ops, struct hg_histogram *merged)
+{
+    double time = 0.0;
+    unsigned int i, j;
+
+    hg_bench_g = bench;
+    hg_atomic_set32(&hg_bench_ready_g, 0);
+    hg_atomic_set32(&hg_bench_go_g, 0);
+    hg_histogram_init(merged);
+
+    for (i = 0; i < thread_count; i++) {
+        threads[i].ops = ops;
+        hg_atomic_set32(&threads[i].completed, 0);
+        hg_histogram_init(&threads[i].histogram);
+        if (hg_thread_create(&threads[i].thread, hg_bench_thread_cb,
+                &threads[i]) != HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: could not create thread\n");
+            hg_atomic_set32(&hg_bench_go_g, 1);
+            for (j = 0; j < i; j++)
+                hg_thread_join(threads[j].thread);
+            return EXIT_FAILURE;
+        }
+    }
+
+    while (hg_atomic_get32(&hg_bench_ready_g) != (hg_util_int32_t) thread_count)
+        hg_thread_yield();
+    hg_time_get_current(&hg_bench_start_g);
+    hg_atomic_set32(&hg_bench_go_g, 1);
+
+    for (i = 0; i < thread_count; i++) {
+        hg_thread_join(threads[i].thread);
+        if (threads[i].time > time)
+            time = threads[i].time;
+
+        /* Merge latencies of threads */
+        for (j = 0; j < HG_HISTOGRAM_BUCKETS; j++)
+            hg_atomic_set64(&merged->buckets[j],
+                hg_atomic_get64(&merged->buckets[j]) +
+                    hg_atomic_get64(&threads[i].histogram.buckets[j]));
+        hg_atomic_set64(&merged->count,
+            hg_atomic_get64(&merged->count) +
+                hg_atomic_get64(&threads[i].histogram.count));
+        if (hg_histogram_max(&threads[i].histogram) > hg_histogram_max(merged))
+            hg_atomic_set64(
+                &merged->max, hg_atomic_get64(&threads[i].histogram.max));
+    }
+
+    printf("%-16s%8u%14.2f%10llu%10llu%10llu\n", bench->name, thread_count,
+        (double) ops * thread_count / (time * 1000000.0),
+        (unsigned long long) hg_histogram_percentile(merged, 50.0),
+        (unsigned long long) hg_histogram_percentile(merged, 99.0),
+        (unsigned long long) hg_histogram_percentile(merged, 99.9));
+    fflush(stdout);
+
+    return EXIT_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_bench_init(struct hg_bench_thread *threads, unsigned int thread_count)
+{
+    unsigned int i;
+
+    hg_bench_queue_g = hg_atomic_queue_alloc(HG_BENCH_QUEUE_SIZE);
+    hg_bench_hash_table_g =
+        hg_hash_table_new(hg_bench_int_hash, hg_bench_int_equal);
+    hg_bench_poll_set_g = hg_poll_create();
+    if (hg_bench_queue_g == NULL || hg_bench_hash_table_g == NULL ||
+        hg_bench_poll_set_g == NULL) {
+        fprintf(stderr, "Error: could not allocate primitives\n");
+        return EXIT_FAILURE;
+    }
+    if (hg_thread_pool_init(HG_BENCH_POOL_THREADS, &hg_bench_pool_g) !=
+        HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Error: could not create thread pool\n");
+        return EXIT_FAILURE;
+    }
+    hg_thread_rwlock_init(&hg_bench_rwlock_g);
+    hg_thread_spin_init(&hg_bench_spin_g);
+    hg_thread_mutex_init(&hg_bench_mutex_g);
+
+    for (i = 0; i < HG_BENCH_HASH_KEYS; i++) {
+        hg_bench_hash_keys_g[i] = (int) i;
+        hg_hash_table_insert(hg_bench_hash_table_g,
+            (hg_hash_table_key_t) &hg_bench_hash_keys_g[i],
+            (hg_hash_table_value_t) &hg_bench_hash_keys_g[i]);
+    }
+
+    for (i = 0; i < thread_count; i++) {
+        struct hg_poll_event event;
+        unsigned int j;
+
+        threads[i].key = HG_BENCH_HASH_KEYS + (int) i;
+        for (j = 0; j < HG_BENCH_POOL_WINDOW; j++) {
+            threads[i].works[j].work.func = hg_bench_pool_cb;
+            threads[i].works[j].work.args = &threads[i].works[j];
+            threads[i].works[j].thread = &threads[i];
+        }
+
+        threads[i].event_fd = hg_event_create();
+        if (threads[i].event_fd < 0) {
+            fprintf(stderr, "Error: could not create event\n");
+            return EXIT_FAILURE;
+        }
+        event.events = HG_POLLIN;
+        event.data.fd = threads[i].event_fd;
+        hg_poll_add(hg_bench_poll_set_g, threads[i].event_fd, &event);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_finalize(struct hg_bench_thread *threads, unsigned int thread_count)
+{
+    unsigned int i;
+
+    for (i = 0; i < thread_count; i++) {
+        if (threads[i].event_fd < 0)
+            continue;
+        if (hg_bench_poll_set_g)
+            hg_poll_remove(hg_bench_poll_set_g, threads[i].event_fd);
+        hg_event_destroy(threads[i].event_fd);
+    }
+
+    if (hg_bench_pool_g)
+        hg_thread_pool_destroy(hg_bench_pool_g);
+    if (hg_bench_poll_set_g)
+        hg_poll_destroy(hg_bench_poll_set_g);
+    if (hg_bench_hash_table_g)
+        hg_hash_table_free(hg_bench_hash_table_g);
+    hg_atomic_queue_free(hg_bench_queue_g);
+    hg_thread_rwlock_destroy(&hg_bench_rwlock_g);
+    hg_thread_spin_destroy(&hg_bench_spin_g);
+    hg_thread_mutex_destroy(&hg_bench_mutex_g);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bench_usage(const char *execname)
+{
+    unsigned int i;
+
+    printf("usage: %s [-t max_threads] [-n ops_per_thread] [benchmark...]\n",
+        execname);
+    printf("    threads are swept by powers of two (default: 1 to %d)\n",
+        HG_BENCH_THREADS_DEFAULT);
+    printf("    benchmarks (default: all):");
+    for (i = 0; i < HG_BENCH_COUNT; i++)
+        printf(" %s", hg_bench_list_g[i].name);
+    printf("\n");
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct hg_bench_thread *threads = NULL;
+    struct hg_histogram *merged = NULL;
+    hg_util_bool_t selected[HG_BENCH_COUNT], select_all = HG_UTIL_TRUE;
+    unsigned long ops = HG_BENCH_OPS_DEFAULT;
+    unsigned int thread_max = HG_BENCH_THREADS_DEFAULT, thread_count, i;
+    int arg, ret = EXIT_SUCCESS;
+
+    memset(selected, 0, sizeof(selected));
+    for (arg = 1; arg < argc; arg++) {
+        if (strcmp(argv[arg], "-t") == 0 && arg + 1 < argc)
+            thread_max = (unsigned int) atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "-n") == 0 && arg + 1 < argc)
+            ops = strtoul(argv[++arg], NULL, 10);
+        else {
+            for (i = 0; i < HG_BENCH_COUNT; i++)
+                if (strcmp(argv[arg], hg_bench_list_g[i].name) == 0)
+                    break;
+            if (i == HG_BENCH_COUNT) {
+                hg_bench_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            selected[i] = HG_UTIL_TRUE;
+            select_all = HG_UTIL_FALSE;
+        }
+    }
+    if (thread_max == 0 || ops == 0 || thread_max > HG_BENCH_QUEUE_SIZE) {
+        hg_bench_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    threads = (struct hg_bench_thread *) malloc(
+        thread_max * sizeof(struct hg_bench_thread));
+    merged = (struct hg_histogram *) malloc(sizeof(*merged));
+    if (threads == NULL || merged == NULL) {
+        fprintf(stderr, "Error: could not allocate threads\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    memset(threads, 0, thread_max * sizeof(struct hg_bench_thread));
+    for (i = 0; i < thread_max; i++)
+        threads[i].event_fd = -1;
+
+    ret = hg_bench_init(threads, thread_max);
+    if (ret != EXIT_SUCCESS)
+        goto cleanup;
+
+    printf("# atomic backend: %s, %lu ops per thread, latency sampled every "
+           "%d ops\n",
+        HG_BENCH_ATOMIC_BACKEND, ops, HG_BENCH_SAMPLE);
+    printf("%-16s%8s%14s%10s%10s%10s\n", "# Benchmark", "Threads",
+        "Rate (Mop/s)", "p50 (ns)", "p99 (ns)", "p999 (ns)");
+
+    for (i = 0; i < HG_BENCH_COUNT && ret == EXIT_SUCCESS; i++) {
+        if (!select_all && !selected[i])
+            continue;
+        for (thread_count = 1;
+             thread_count <= thread_max && ret == EXIT_SUCCESS;
+             thread_count *= 2)
+            ret = hg_bench_run(
+                &hg_bench_list_g[i], threads, thread_count, ops, merged);
+    }
+
+cleanup:
+    hg_bench_finalize(threads, thread_max);
+
+done:
+    free(merged);
+    free(threads);
+
+    return ret;
+}
@@ -0,0 +1,96 @@
+#include "mercury_coroutine.h"
+#include "mercury_thread.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HG_TEST_NUM_YIELDS 16
+
+struct my_arg {
+    hg_coroutine_t *coroutine;
+    int count;
+};
+
+static void
+coroutine_func(void *arg)
+{
+    struct my_arg *my_arg = (struct my_arg *) arg;
+    volatile int depth[64]; /* Use some stack */
+    int i;
+
+    for (i = 0; i < HG_TEST_NUM_YIELDS; i++) {
+        depth[i % 64] = i;
+        if (hg_coroutine_self() != my_arg->coroutine)
+            return;
+        my_arg->count += depth[i % 64] - i + 1;
+        hg_coroutine_yield();
+    }
+}
+
+static HG_THREAD_RETURN_TYPE
+resume_thread(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    struct my_arg *my_arg = (struct my_arg *) arg;
+
+    /* Resume from a thread other than the one that started it */
+    hg_coroutine_resume(my_arg->coroutine);
+
+    return thread_ret;
+}
+
+int
+main(void)
+{
+    struct my_arg my_arg = {NULL, 0};
+    hg_thread_t thread;
+    int ret = EXIT_SUCCESS;
+    int i;
+
+    my_arg.coroutine = hg_coroutine_create(0);
+    if (!my_arg.coroutine) {
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+        fprintf(stderr, "Error: could not create coroutine\n");
+        ret = EXIT_FAILURE;
+#endif
+        goto done;
+    }
+
+    if (hg_coroutine_self() != NULL) {
+        fprintf(stderr, "Error: not running in a coroutine\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Run twice to check that coroutine can be re-started */
+    for (i = 0; i < 2; i++) {
+        my_arg.count = 0;
+        hg_coroutine_start(my_arg.coroutine, coroutine_func, &my_arg);
+
+        while (!hg_coroutine_done(my_arg.coroutine)) {
+            if (my_arg.count % 2) {
+                hg_thread_create(&thread, resume_thread, &my_arg);
+                hg_thread_join(thread);
+            } else
+                hg_coroutine_resume(my_arg.coroutine);
+        }
+        if (my_arg.count != HG_TEST_NUM_YIELDS) {
+            fprintf(stderr, "Error: coroutine yielded %d times, expected %d\n",
+                my_arg.count, HG_TEST_NUM_YIELDS);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    if (hg_coroutine_self() != NULL) {
+        fprintf(stderr, "Error: running coroutine was not reset\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    hg_coroutine_destroy(my_arg.coroutine);
+    return ret;
+}
@@ -0,0 +1,59 @@
+#include "mercury_crc32c.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HG_TEST_CRC32C_SIZE 1021
+
+int
+main(void)
+{
+    const char *check = "123456789";
+    unsigned char buf[HG_TEST_CRC32C_SIZE];
+    hg_util_uint32_t crc, step_crc;
+    size_t i;
+    int ret = EXIT_SUCCESS;
+
+    /* Standard check value */
+    crc = hg_crc32c_update(0, check, strlen(check));
+    if (crc != 0xe3069283) {
+        fprintf(stderr, "Error: CRC of check string is 0x%08x\n", crc);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Unaligned incremental updates must match a single update */
+    for (i = 0; i < HG_TEST_CRC32C_SIZE; i++)
+        buf[i] = (unsigned char) (i * 31 + 7);
+    crc = hg_crc32c_update(0, buf, HG_TEST_CRC32C_SIZE);
+    step_crc = 0;
+    for (i = 0; i < HG_TEST_CRC32C_SIZE; i += 13) {
+        size_t size = (HG_TEST_CRC32C_SIZE - i < 13) ? HG_TEST_CRC32C_SIZE - i
+                                                     : 13;
+
+        step_crc = hg_crc32c_update(step_crc, buf + i, size);
+    }
+    if (crc != step_crc) {
+        fprintf(stderr, "Error: incremental CRC 0x%08x != 0x%08x\n", step_crc,
+            crc);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Single bit flip must be detected */
+    buf[HG_TEST_CRC32C_SIZE / 2] ^= 0x10;
+    if (hg_crc32c_update(0, buf, HG_TEST_CRC32C_SIZE) == crc) {
+        fprintf(stderr, "Error: bit flip not detected\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    printf("CRC32C computed with %s\n",
+        hg_crc32c_hw() ? "hardware instructions" : "software");
+
+done:
+    return ret;
+}
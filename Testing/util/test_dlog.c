@@ -0,0 +1,106 @@
+#include "mercury_dlog.h"
+#include "mercury_thread.h"
+
+#include "mercury_test_config.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HG_TEST_NUM_THREADS 4
+#define HG_TEST_NUM_LOGS    32
+
+static double last_time_g = 0.0;
+static unsigned int nlogs_g = 0;
+static int error_g = 0;
+
+static void
+addlogs(struct hg_dlog *d)
+{
+    int i;
+
+    for (i = 0; i < HG_TEST_NUM_LOGS; i++)
+        hg_dlog_addlog(d, __FILE__, __LINE__, __func__, NULL, NULL);
+}
+
+static HG_THREAD_RETURN_TYPE
+thread_cb_addlog(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+
+    addlogs((struct hg_dlog *) arg);
+
+    hg_thread_exit(thread_ret);
+    return thread_ret;
+}
+
+static int
+check_log_func(FILE *stream, const char *format, ...)
+{
+    va_list ap;
+    double time;
+
+    (void) stream;
+    if (strncmp(format, "# [%lf]", strlen("# [%lf]")) != 0)
+        return 0;
+
+    va_start(ap, format);
+    time = va_arg(ap, double);
+    va_end(ap);
+
+    /* Entries of all threads must be merged by time */
+    if (time < last_time_g)
+        error_g = 1;
+    last_time_g = time;
+    nlogs_g++;
+
+    return 0;
+}
+
+int
+main(void)
+{
+    hg_thread_t threads[HG_TEST_NUM_THREADS];
+    struct hg_dlog *d;
+    int ret = EXIT_SUCCESS;
+    int i;
+
+    d = hg_dlog_alloc("test", HG_TEST_NUM_LOGS * 2, 0);
+    if (!d) {
+        fprintf(stderr, "Error: could not allocate dlog\n");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < HG_TEST_NUM_THREADS; i++)
+        hg_thread_create(&threads[i], thread_cb_addlog, d);
+    addlogs(d);
+    for (i = 0; i < HG_TEST_NUM_THREADS; i++)
+        hg_thread_join(threads[i]);
+
+    hg_dlog_dump(d, check_log_func, stderr, 0);
+    if (error_g ||
+        nlogs_g != (HG_TEST_NUM_THREADS + 1) * HG_TEST_NUM_LOGS) {
+        fprintf(stderr, "Error: dumped %u entries (ordered=%d)\n", nlogs_g,
+            !error_g);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Reset log of all threads */
+    hg_dlog_resetlog(d);
+    hg_dlog_addlog(d, __FILE__, __LINE__, __func__, NULL, NULL);
+    last_time_g = 0.0;
+    nlogs_g = 0;
+    hg_dlog_dump(d, check_log_func, stderr, 0);
+    if (nlogs_g != 1) {
+        fprintf(stderr, "Error: dumped %u entries after reset\n", nlogs_g);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    hg_dlog_free(d);
+
+    return ret;
+}
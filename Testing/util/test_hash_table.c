@@ -5,6 +5,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#define HG_TEST_HASH_TABLE_KEYS (1000)
+
 static int
 int_equal(hg_hash_table_key_t vlocation1, hg_hash_table_key_t vlocation2)
 {
@@ -30,7 +32,56 @@ int_hash_value_free(hg_hash_table_value_t value)
 }
 
 /*---------------------------------------------------------------------------*/
+static int
+test_grow(int concurrent)
+{
+    static int keys[HG_TEST_HASH_TABLE_KEYS];
+    hg_hash_table_t *hash_table;
+    unsigned int i;
+    int ret = EXIT_SUCCESS;
+
+    hash_table = concurrent ? hg_hash_table_new_concurrent(int_hash, int_equal)
+                            : hg_hash_table_new(int_hash, int_equal);
+
+    /* Insert enough keys to resize the table several times */
+    for (i = 0; i < HG_TEST_HASH_TABLE_KEYS; i++) {
+        keys[i] = (int) i;
+        hg_hash_table_insert(hash_table, &keys[i], &keys[i]);
+    }
+
+    /* Remove every other key */
+    for (i = 0; i < HG_TEST_HASH_TABLE_KEYS; i += 2) {
+        if (!hg_hash_table_remove(hash_table, &keys[i])) {
+            fprintf(stderr, "Error: could not remove key %u\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    if (HG_TEST_HASH_TABLE_KEYS / 2 != hg_hash_table_num_entries(hash_table)) {
+        fprintf(stderr, "Error: was expecting %d entries, got %u\n",
+            HG_TEST_HASH_TABLE_KEYS / 2, hg_hash_table_num_entries(hash_table));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
 
+    for (i = 0; i < HG_TEST_HASH_TABLE_KEYS; i++) {
+        int *value = (int *) hg_hash_table_lookup(hash_table, &keys[i]);
+        int *expected = (i % 2 == 0) ? HG_HASH_TABLE_NULL : &keys[i];
+
+        if (value != expected) {
+            fprintf(stderr, "Error: unexpected value for key %u\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+done:
+    hg_hash_table_free(hash_table);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
 int
 main(int argc, char *argv[])
 {
@@ -96,6 +147,14 @@ main(int argc, char *argv[])
         goto done;
     }
 
+    ret = test_grow(0);
+    if (ret != EXIT_SUCCESS)
+        goto done;
+
+    ret = test_grow(1);
+    if (ret != EXIT_SUCCESS)
+        goto done;
+
 done:
     hg_hash_table_free(hash_table);
     return ret;
@@ -0,0 +1,93 @@
+#include "mercury_histogram.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HG_TEST_NUM_VALUES 1000
+
+int
+main(void)
+{
+    struct hg_histogram *histogram;
+    hg_util_uint64_t value, prev = 0;
+    unsigned int i;
+    int ret = EXIT_SUCCESS;
+
+    histogram = (struct hg_histogram *) malloc(sizeof(*histogram));
+    if (!histogram) {
+        fprintf(stderr, "Error: could not allocate histogram\n");
+        return EXIT_FAILURE;
+    }
+    hg_histogram_init(histogram);
+
+    if (hg_histogram_percentile(histogram, 50.0) != 0 ||
+        hg_histogram_min(histogram) != 0) {
+        fprintf(stderr, "Error: empty histogram is not empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Buckets must be contiguous and contain their own lower bound */
+    for (i = 0; i < HG_HISTOGRAM_BUCKETS; i++) {
+        value = hg_histogram_bucket_value(i);
+        if ((i > 0 && value <= prev) || hg_histogram_bucket(value) != i ||
+            (value > 0 && hg_histogram_bucket(value - 1) != i - 1)) {
+            fprintf(stderr, "Error: invalid bounds for bucket %u (%llu)\n", i,
+                (unsigned long long) value);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        prev = value;
+    }
+    if (hg_histogram_bucket(HG_HISTOGRAM_MAX + 1) != HG_HISTOGRAM_BUCKETS - 1) {
+        fprintf(stderr, "Error: large values are not clamped\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Values 1 to 1000 */
+    for (i = 1; i <= HG_TEST_NUM_VALUES; i++)
+        hg_histogram_record(histogram, i);
+
+    if (hg_histogram_count(histogram) != HG_TEST_NUM_VALUES ||
+        hg_histogram_min(histogram) != 1 ||
+        hg_histogram_max(histogram) != HG_TEST_NUM_VALUES) {
+        fprintf(stderr, "Error: count=%llu, min=%llu, max=%llu\n",
+            (unsigned long long) hg_histogram_count(histogram),
+            (unsigned long long) hg_histogram_min(histogram),
+            (unsigned long long) hg_histogram_max(histogram));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (hg_histogram_mean(histogram) != (HG_TEST_NUM_VALUES + 1) / 2.0) {
+        fprintf(stderr, "Error: mean is %f\n", hg_histogram_mean(histogram));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Percentiles are within the relative precision of buckets */
+    value = hg_histogram_percentile(histogram, 50.0);
+    if (value < 500 || value > 500 + 500 / HG_HISTOGRAM_SUB_COUNT) {
+        fprintf(stderr, "Error: p50 is %llu\n", (unsigned long long) value);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    value = hg_histogram_percentile(histogram, 99.0);
+    if (value < 990 || value > 990 + 990 / HG_HISTOGRAM_SUB_COUNT) {
+        fprintf(stderr, "Error: p99 is %llu\n", (unsigned long long) value);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (hg_histogram_percentile(histogram, 100.0) != HG_TEST_NUM_VALUES) {
+        fprintf(stderr, "Error: p100 is not max\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    free(histogram);
+
+    return ret;
+}
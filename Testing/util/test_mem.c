@@ -0,0 +1,115 @@
+#include "mercury_mem.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#    include <unistd.h>
+#endif
+
+#define HG_TEST_SHM_NAME "hg_test_mem"
+
+static int
+test_huge_alloc(size_t size)
+{
+    unsigned char *buf;
+    size_t i;
+
+    buf = (unsigned char *) hg_mem_huge_alloc(size, 0);
+    if (!buf) {
+        fprintf(stderr, "Error: could not allocate %zu bytes\n", size);
+        return EXIT_FAILURE;
+    }
+    if ((size_t) buf % (size_t) hg_mem_get_page_size() != 0) {
+        fprintf(stderr, "Error: buffer is not page aligned\n");
+        hg_mem_huge_free(buf, size);
+        return EXIT_FAILURE;
+    }
+
+    /* Memory must be zeroed */
+    for (i = 0; i < size; i++) {
+        if (buf[i] != 0) {
+            fprintf(stderr, "Error: buffer is not zeroed at %zu\n", i);
+            hg_mem_huge_free(buf, size);
+            return EXIT_FAILURE;
+        }
+    }
+    memset(buf, 0xff, size);
+    hg_mem_huge_free(buf, size);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+test_shm_map(size_t size)
+{
+    char name[64];
+    unsigned char *buf, *buf2;
+    int ret = EXIT_SUCCESS;
+
+#ifdef _WIN32
+    snprintf(name, sizeof(name), HG_TEST_SHM_NAME "_%zu", size);
+#else
+    snprintf(name, sizeof(name), HG_TEST_SHM_NAME "_%d_%zu", (int) getpid(),
+        size);
+#endif
+
+    buf = (unsigned char *) hg_mem_shm_map(name, size, HG_UTIL_TRUE);
+    if (!buf) {
+        fprintf(stderr, "Error: could not create shm region %s\n", name);
+        return EXIT_FAILURE;
+    }
+    buf[0] = 1;
+    buf[size - 1] = 2;
+
+    /* Opening an existing region only maps part of it */
+    buf2 = (unsigned char *) hg_mem_shm_map(
+        name, (size_t) hg_mem_get_page_size(), HG_UTIL_FALSE);
+    if (!buf2) {
+        fprintf(stderr, "Error: could not open shm region %s\n", name);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (buf2[0] != 1) {
+        fprintf(stderr, "Error: shm region is not shared\n");
+        ret = EXIT_FAILURE;
+    }
+    if (hg_mem_shm_unmap(NULL, buf2, (size_t) hg_mem_get_page_size()) !=
+        HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Error: could not unmap shm region %s\n", name);
+        ret = EXIT_FAILURE;
+    }
+
+done:
+    if (hg_mem_shm_unmap(name, buf, size) != HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Error: could not remove shm region %s\n", name);
+        ret = EXIT_FAILURE;
+    }
+
+    return ret;
+}
+
+int
+main(void)
+{
+    size_t huge_page_size = (size_t) hg_mem_get_huge_page_size();
+
+    if (hg_mem_get_huge_page_size() <= 0) {
+        fprintf(stderr, "Error: invalid huge page size\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Small, single and odd-sized multi huge page allocations */
+    if (test_huge_alloc(100) != EXIT_SUCCESS ||
+        test_huge_alloc(huge_page_size) != EXIT_SUCCESS ||
+        test_huge_alloc(2 * huge_page_size + 100) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    if (test_shm_map((size_t) hg_mem_get_page_size()) != EXIT_SUCCESS ||
+        test_shm_map(2 * huge_page_size) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
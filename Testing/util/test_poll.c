@@ -13,7 +13,7 @@ main(void)
     struct hg_poll_event events[2];
     unsigned int nevents = 0;
     hg_util_bool_t signaled = HG_UTIL_FALSE;
-    int event_fd1, event_fd2, ret = EXIT_SUCCESS;
+    int event_fd1, event_fd2, i, ret = EXIT_SUCCESS;
 
     poll_set = hg_poll_create();
     event_fd1 = hg_event_create();
@@ -133,6 +133,46 @@ main(void)
         goto done;
     }
 
+    /* Events that the poll set may consume */
+    hg_poll_remove(poll_set, event_fd2);
+    events[1].events = HG_POLLIN | HG_POLLEVENT;
+    events[1].data.u32 = 2;
+    hg_poll_add(poll_set, event_fd2, &events[1]);
+
+    for (i = 0; i < 2; i++) {
+        /* Set event */
+        hg_event_set(event_fd2);
+
+        /* Reset progressed */
+        nevents = 0;
+
+        /* Wait with timeout */
+        hg_poll_wait(poll_set, 1000, 2, events, &nevents);
+        if (nevents != 1 || events[0].data.u32 != 2) {
+            /* We expect success */
+            fprintf(stderr, "Error: did not progress event\n");
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        if (!(events[0].events & HG_POLLEVENT)) {
+            hg_event_get(event_fd2, &signaled);
+            if (!signaled) {
+                /* We expect success */
+                fprintf(stderr, "Error: should have been signaled\n");
+                ret = EXIT_FAILURE;
+                goto done;
+            }
+        }
+
+        /* Event is consumed either way */
+        hg_event_get(event_fd2, &signaled);
+        if (signaled) {
+            fprintf(stderr, "Error: should not have been signaled\n");
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
 done:
     hg_poll_remove(poll_set, event_fd1);
     hg_poll_remove(poll_set, event_fd2);
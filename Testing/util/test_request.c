@@ -78,6 +78,36 @@ main(int argc, char *argv[])
     }
 
     hg_request_destroy(request);
+
+    /* Only second request completes */
+    if (ret == EXIT_SUCCESS) {
+        hg_request_t *requests[2];
+        int index;
+
+        requests[0] = hg_request_create(request_class);
+        requests[1] = hg_request_create(request_class);
+        request = requests[1];
+        hg_request_set_data(request, &user_data);
+        user_data = 0;
+        progressed = triggered = 0;
+        hg_request_waitany(2, requests, timeout, &index);
+
+        if (index != 1 || !user_data) {
+            fprintf(stderr, "Completed request index is %d\n", index);
+            ret = EXIT_FAILURE;
+        }
+
+        /* Nothing left to complete */
+        hg_request_waitany(1, requests, 10, &index);
+        if (index != -1) {
+            fprintf(stderr, "Completed request index is %d\n", index);
+            ret = EXIT_FAILURE;
+        }
+
+        hg_request_destroy(requests[0]);
+        hg_request_destroy(requests[1]);
+    }
+
     hg_request_finalize(request_class, NULL);
 
     return ret;
@@ -6,8 +6,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#define HG_TEST_MUTEX_LOOP_COUNT (100000)
+
 static hg_thread_mutex_t thread_mutex;
 static int thread_value = 0;
+static int thread_count_value = 0;
 
 static HG_THREAD_RETURN_TYPE
 thread_cb_mutex(void *arg)
@@ -27,11 +30,32 @@ thread_cb_mutex(void *arg)
     return thread_ret;
 }
 
+static HG_THREAD_RETURN_TYPE
+thread_cb_mutex_contended(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    int i;
+
+    (void) arg;
+
+    /* Short critical sections so that both spin and sleep paths are hit */
+    for (i = 0; i < HG_TEST_MUTEX_LOOP_COUNT; i++) {
+        hg_thread_mutex_lock(&thread_mutex);
+        thread_count_value++;
+        hg_thread_mutex_unlock(&thread_mutex);
+    }
+
+    hg_thread_exit(thread_ret);
+    return thread_ret;
+}
+
 int
 main(int argc, char *argv[])
 {
     hg_thread_t thread1, thread2;
+    hg_thread_t thread[HG_TEST_NUM_THREADS_DEFAULT];
     int ret = EXIT_SUCCESS;
+    int i;
 
     (void) argc;
     (void) argv;
@@ -50,6 +74,17 @@ main(int argc, char *argv[])
         ret = EXIT_FAILURE;
     }
 
+    for (i = 0; i < HG_TEST_NUM_THREADS_DEFAULT; i++)
+        hg_thread_create(&thread[i], thread_cb_mutex_contended, NULL);
+    for (i = 0; i < HG_TEST_NUM_THREADS_DEFAULT; i++)
+        hg_thread_join(thread[i]);
+
+    if (thread_count_value !=
+        HG_TEST_NUM_THREADS_DEFAULT * HG_TEST_MUTEX_LOOP_COUNT) {
+        fprintf(stderr, "Error: value is %d\n", thread_count_value);
+        ret = EXIT_FAILURE;
+    }
+
     hg_thread_mutex_destroy(&thread_mutex);
     return ret;
 }
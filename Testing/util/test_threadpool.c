@@ -28,12 +28,17 @@ myfunc(void *args)
 
 static unsigned int ncalls = 0;
 static hg_thread_mutex_t mymutex;
+static hg_thread_pool_t *thread_pool;
 
 static HG_THREAD_RETURN_TYPE
 myfunc(void *args)
 {
     hg_thread_ret_t ret = 0;
-    (void) args;
+    struct hg_thread_work *nested_work = (struct hg_thread_work *) args;
+
+    /* Work posted from a worker goes to its own deque */
+    if (nested_work)
+        hg_thread_pool_post(thread_pool, nested_work);
 
     hg_thread_mutex_lock(&mymutex);
     ncalls++;
@@ -47,8 +52,8 @@ int
 main(int argc, char *argv[])
 {
     int i;
-    hg_thread_pool_t *thread_pool;
     struct hg_thread_work work[POOL_NUM_POSTS];
+    struct hg_thread_work nested_work[POOL_NUM_POSTS];
     int ret = EXIT_SUCCESS;
 
     (void) argc;
@@ -57,8 +62,10 @@ main(int argc, char *argv[])
     hg_thread_pool_init(HG_TEST_NUM_THREADS_DEFAULT, &thread_pool);
 
     for (i = 0; i < POOL_NUM_POSTS; i++) {
+        nested_work[i].func = myfunc;
+        nested_work[i].args = NULL;
         work[i].func = myfunc;
-        work[i].args = NULL;
+        work[i].args = &nested_work[i];
         hg_thread_pool_post(thread_pool, &work[i]);
     }
 
@@ -66,9 +73,9 @@ main(int argc, char *argv[])
     hg_thread_pool_destroy(thread_pool);
     hg_thread_mutex_destroy(&mymutex);
 
-    if (ncalls != POOL_NUM_POSTS) {
+    if (ncalls != 2 * POOL_NUM_POSTS) {
         fprintf(stderr, "Did not execute all the operations posted (%u/%d)\n",
-            ncalls, POOL_NUM_POSTS);
+            ncalls, 2 * POOL_NUM_POSTS);
         ret = EXIT_FAILURE;
     }
     return ret;
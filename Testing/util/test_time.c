@@ -11,6 +11,8 @@ main(int argc, char *argv[])
 {
     hg_time_t t1, t2, diff1, diff2;
     hg_time_t sleep_time = {1, 0};
+    hg_time_ticks_t ticks1, ticks2;
+    hg_util_uint64_t ticks_ns;
     double epsilon = 1e-9;
     double t1_double, t2_double;
     int ret = EXIT_SUCCESS;
@@ -21,9 +23,11 @@ main(int argc, char *argv[])
     printf("Current time: %s\n", hg_time_stamp());
 
     hg_time_get_current(&t1);
+    ticks1 = hg_time_get_ticks();
 
     hg_time_sleep(sleep_time);
 
+    ticks2 = hg_time_get_ticks();
     hg_time_get_current(&t2);
 
     /* Should have slept at least sleep_time */
@@ -63,6 +67,28 @@ main(int argc, char *argv[])
         goto done;
     }
 
+    /* Fast clock must agree with the monotonic clock (within 1%) */
+    if (ticks2 <= ticks1) {
+        fprintf(stderr, "Error: ticks1 >= ticks2\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    ticks_ns = hg_time_ticks_to_ns(ticks2 - ticks1);
+    if (fabs((double) ticks_ns * 1e-9 - hg_time_diff(t2, t1)) >
+        0.01 * hg_time_diff(t2, t1)) {
+        fprintf(stderr, "Error: %llu ns elapsed in ticks, %lf s expected\n",
+            (unsigned long long) ticks_ns, hg_time_diff(t2, t1));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (llabs((long long) hg_time_ticks_from_ns(ticks_ns) -
+              (long long) (ticks2 - ticks1)) >
+        (long long) (ticks2 - ticks1) / 1000) {
+        fprintf(stderr, "Error: ns to ticks does not match ticks to ns\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
 done:
     return ret;
 }
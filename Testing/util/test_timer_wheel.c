@@ -0,0 +1,130 @@
+#include "mercury_timer_wheel.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HG_TEST_NUM_TIMERS 64
+
+struct my_timer {
+    struct hg_timer timer;
+    hg_util_uint64_t timeout;
+    hg_util_uint64_t fired_at;
+    int fired;
+};
+
+static struct hg_timer_wheel *wheel_g = NULL;
+static hg_util_uint64_t now_g = 0;
+
+static void
+timer_cb(struct hg_timer *timer, void *arg)
+{
+    struct my_timer *my_timer = (struct my_timer *) arg;
+
+    (void) timer;
+    my_timer->fired++;
+    my_timer->fired_at = now_g;
+}
+
+static void
+timer_cb_rearm(struct hg_timer *timer, void *arg)
+{
+    struct my_timer *my_timer = (struct my_timer *) arg;
+
+    my_timer->fired++;
+    if (my_timer->fired < 3)
+        hg_timer_wheel_add(wheel_g, timer, 1);
+}
+
+int
+main(void)
+{
+    struct my_timer timers[HG_TEST_NUM_TIMERS];
+    struct my_timer cancel_timer, rearm_timer;
+    unsigned int count = 0;
+    int ret = EXIT_SUCCESS;
+    int i;
+
+    now_g = 1000;
+    wheel_g = hg_timer_wheel_create(now_g);
+    if (!wheel_g) {
+        fprintf(stderr, "Error: could not create wheel\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Timeouts spread across all levels */
+    for (i = 0; i < HG_TEST_NUM_TIMERS; i++) {
+        timers[i].timeout = (hg_util_uint64_t) i * (hg_util_uint64_t) i * 97;
+        timers[i].fired = 0;
+        hg_timer_init(&timers[i].timer, timer_cb, &timers[i]);
+        hg_timer_wheel_add(wheel_g, &timers[i].timer, timers[i].timeout);
+    }
+
+    hg_timer_init(&cancel_timer.timer, timer_cb, &cancel_timer);
+    cancel_timer.fired = 0;
+    hg_timer_wheel_add(wheel_g, &cancel_timer.timer, 100);
+    hg_timer_wheel_del(wheel_g, &cancel_timer.timer);
+
+    if (hg_timer_wheel_count(wheel_g) != HG_TEST_NUM_TIMERS) {
+        fprintf(stderr, "Error: expected %d timers, got %u\n",
+            HG_TEST_NUM_TIMERS, hg_timer_wheel_count(wheel_g));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Advance by irregular steps */
+    while (count < HG_TEST_NUM_TIMERS) {
+        hg_util_uint64_t next = hg_timer_wheel_next(wheel_g);
+
+        if (next == 0) {
+            fprintf(stderr, "Error: next timeout should not be 0\n");
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        now_g += (next > 37) ? 37 : next;
+        count += hg_timer_wheel_advance(wheel_g, now_g);
+    }
+
+    for (i = 0; i < HG_TEST_NUM_TIMERS; i++) {
+        hg_util_uint64_t expected =
+            1000 + (timers[i].timeout ? timers[i].timeout : 1);
+
+        if (timers[i].fired != 1 || timers[i].fired_at != expected) {
+            fprintf(stderr,
+                "Error: timer %d fired %d time(s) at %llu, expected %llu\n", i,
+                timers[i].fired, (unsigned long long) timers[i].fired_at,
+                (unsigned long long) expected);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    if (cancel_timer.fired) {
+        fprintf(stderr, "Error: canceled timer fired\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Re-arm timers from callback, wheel idle for a long time before */
+    now_g += 1000000;
+    hg_timer_wheel_advance(wheel_g, now_g);
+    hg_timer_init(&rearm_timer.timer, timer_cb_rearm, &rearm_timer);
+    rearm_timer.fired = 0;
+    hg_timer_wheel_add(wheel_g, &rearm_timer.timer, 10);
+    now_g += 100;
+    count = hg_timer_wheel_advance(wheel_g, now_g);
+    if (count != 3 || rearm_timer.fired != 3 ||
+        hg_timer_wheel_count(wheel_g) != 0) {
+        fprintf(stderr, "Error: re-armed timer fired %d time(s)\n",
+            rearm_timer.fired);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    if (wheel_g)
+        hg_timer_wheel_destroy(wheel_g);
+    return ret;
+}
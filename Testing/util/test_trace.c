@@ -0,0 +1,80 @@
+#include "mercury_trace.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define HG_TEST_TRACE_PREFIX HG_TEST_TEMP_DIRECTORY "/hg_test_trace"
+
+/* Enough events to span several mapped windows */
+#define HG_TEST_NUM_EVENTS (1 << 20)
+
+int
+main(void)
+{
+    struct hg_trace *trace;
+    struct hg_trace_header header;
+    struct hg_trace_event event, prev;
+    char name[1024];
+    FILE *fp = NULL;
+    unsigned int i;
+    int ret = EXIT_SUCCESS;
+
+    trace = hg_trace_create(HG_TEST_TRACE_PREFIX);
+    if (!trace) {
+        fprintf(stderr, "Error: could not create trace\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < HG_TEST_NUM_EVENTS; i++)
+        hg_trace_record(trace, i % 8, i, 2 * i, 1, 3, 4);
+    hg_trace_destroy(trace);
+
+    snprintf(name, sizeof(name), "%s-%d-0.hgt", HG_TEST_TRACE_PREFIX,
+        (int) getpid());
+    fp = fopen(name, "r");
+    if (!fp) {
+        fprintf(stderr, "Error: could not open %s\n", name);
+        return EXIT_FAILURE;
+    }
+
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        strcmp(header.magic, HG_TRACE_MAGIC) != 0 ||
+        header.event_size != sizeof(event) ||
+        header.count != HG_TEST_NUM_EVENTS) {
+        fprintf(stderr, "Error: invalid trace header\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    fseek(fp, (long) header.data_offset, SEEK_SET);
+    memset(&prev, 0, sizeof(prev));
+    for (i = 0; i < HG_TEST_NUM_EVENTS; i++) {
+        if (fread(&event, sizeof(event), 1, fp) != 1) {
+            fprintf(stderr, "Error: could not read event %u\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        if (event.id != i || event.arg != 2 * i || event.type != i % 8 ||
+            event.context_id != 1 || event.tag != 3 || event.size != 4 ||
+            event.time < prev.time) {
+            fprintf(stderr, "Error: invalid event %u\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        prev = event;
+    }
+    if (fread(&event, sizeof(event), 1, fp) != 0) {
+        fprintf(stderr, "Error: trace has extra events\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    fclose(fp);
+    unlink(name);
+
+    return ret;
+}
@@ -8,15 +8,28 @@
  * found at the root of the source code distribution tree.
  */
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#    define _GNU_SOURCE
+#endif
 #include "mercury.h"
 #include "mercury_bulk.h"
+#include "mercury_bulk_proc.h"
+#include "mercury_capture.h"
+#include "mercury_class_proc.h"
 #include "mercury_error.h"
+#include "mercury_private.h"
 #include "mercury_proc.h"
 #include "mercury_proc_bulk.h"
+#include "mercury_string_object.h"
 
+#include "mercury_coroutine.h"
 #include "mercury_hash_string.h"
+#include "mercury_hash_table.h"
 #include "mercury_mem.h"
+#include "mercury_thread.h"
+#include "mercury_thread_mutex.h"
 #include "mercury_thread_spin.h"
+#include "mercury_time.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -32,6 +45,37 @@
 #define HG_HANDLE_CLASS(handle)                                                \
     ((struct hg_private_class *) ((handle)->info.hg_class))
 
+/* Size classes of pooled extra payload buffers (8 KB to 256 KB) */
+#define HG_EXTRA_POOL_MIN_SHIFT   (13)
+#define HG_EXTRA_POOL_MAX_SHIFT   (18)
+#define HG_EXTRA_POOL_CLASS_COUNT                                              \
+    (HG_EXTRA_POOL_MAX_SHIFT - HG_EXTRA_POOL_MIN_SHIFT + 1)
+#define HG_EXTRA_POOL_CLASS_SIZE(size_class)                                   \
+    ((hg_size_t) 1 << (HG_EXTRA_POOL_MIN_SHIFT + (size_class)))
+
+/* Max number of unused buffers kept per size class */
+#define HG_EXTRA_POOL_CACHE_MAX (4)
+
+/* Pools of buffers exposed to remote peers and of buffers pulled into */
+#define HG_EXTRA_POOL_READ_ONLY (0)
+#define HG_EXTRA_POOL_READWRITE (1)
+#define HG_EXTRA_POOL_TYPE_COUNT (2)
+
+/* Timeout (ms) after which shard threads check whether they must exit */
+#define HG_SHARD_PROGRESS_TIMEOUT (100)
+
+/* Max number of callbacks triggered at once by shard threads */
+#define HG_SHARD_TRIGGER_COUNT (64)
+
+/* Max number of idle handler coroutines kept for re-use */
+#define HG_COROUTINE_CACHE_MAX (64)
+
+/* Status of bulk data prefetched on RPC arrival */
+#define HG_PREFETCH_NONE     (0) /* Nothing prefetched */
+#define HG_PREFETCH_INFLIGHT (1) /* Transfer not completed yet */
+#define HG_PREFETCH_WAITING  (2) /* Callback set, transfer not completed */
+#define HG_PREFETCH_DONE     (3) /* Transfer completed */
+
 /* Name of this subsystem */
 #define HG_SUBSYS_NAME        hg_
 #define HG_SUBSYS_NAME_STRING HG_UTIL_STRINGIFY(HG_SUBSYS_NAME)
@@ -40,13 +84,91 @@
 /* Local Type and Struct Definition */
 /************************************/
 
+/* Registered extra payload buffer */
+struct hg_extra_buf {
+    struct hg_extra_buf *next; /* Next unused buffer in pool */
+    void *buf;                 /* Buffer */
+    hg_bulk_t bulk;            /* Bulk handle registering buffer */
+    unsigned int type;         /* Pool type */
+    unsigned int size_class;   /* Size class index */
+};
+
+/* Pool of registered extra payload buffers, unused buffers are kept in LIFO
+ * lists so that recently used (cache-hot) buffers are re-used first */
+struct hg_extra_pool {
+    struct hg_extra_buf
+        *heads[HG_EXTRA_POOL_TYPE_COUNT][HG_EXTRA_POOL_CLASS_COUNT];
+    unsigned int counts[HG_EXTRA_POOL_TYPE_COUNT][HG_EXTRA_POOL_CLASS_COUNT];
+    hg_thread_spin_t lock; /* Pool lock */
+};
+
+/* Table of interned keys */
+struct hg_key_table {
+    hg_hash_table_t *table; /* Interned keys (key -> key, lock-free lookups) */
+    hg_thread_mutex_t lock; /* Insertion lock */
+    hg_uint32_t max;        /* Max number of keys */
+};
+
+/* Context serving one shard of the RPC service */
+/* Coroutine executing an RPC callback */
+struct hg_handler_coroutine {
+    struct hg_handler_coroutine *next; /* Next idle coroutine in cache */
+    struct hg_private_class *hg_class; /* Class */
+    hg_coroutine_t *coroutine;         /* Coroutine */
+    hg_rpc_cb_t rpc_cb;                /* RPC callback */
+    hg_handle_t handle;                /* Handle */
+    struct hg_await *await;            /* Await the callback yielded in */
+    hg_thread_spin_t lock;             /* Lock of await hand-off */
+    hg_bool_t waiting;                 /* Suspended until await completes */
+};
+
+struct hg_shard {
+    hg_context_t *context;           /* Shard context */
+    struct hg_private_class *hg_class; /* Class of shard */
+    hg_thread_t thread;              /* Thread polling and triggering */
+    hg_bool_t started;               /* Thread was started */
+};
+
 /* HG class */
 struct hg_private_class {
     struct hg_class hg_class; /* Must remain as first field */
     hg_return_t (*handle_create)(hg_handle_t, void *); /* handle_create */
     void *handle_create_arg;                           /* handle_create arg */
     hg_thread_spin_t register_lock;                    /* Register lock */
+    struct hg_extra_pool extra_pool;                   /* Extra payload pool */
+    struct hg_key_table key_table;                     /* Interned keys */
+    struct hg_shard *shards;                           /* Shard contexts */
+    hg_atomic_int32_t shard_exit;                      /* Shard threads exit */
+    hg_uint8_t shard_count;                            /* Number of shards */
     hg_bool_t bulk_eager;                              /* Eager bulk proc */
+    hg_bool_t decode_borrow;                           /* Borrow decoded data */
+    hg_bool_t decode_arena;                            /* Decode into arena */
+    struct hg_handler_coroutine *coroutine_cache;      /* Idle coroutines */
+    unsigned int coroutine_cache_count;                /* Idle count */
+    hg_thread_spin_t coroutine_lock;                   /* Cache lock */
+    struct hg_capture *capture;                        /* Workload capture */
+};
+
+/* Cached response of an idempotent RPC */
+struct hg_response_cache_entry {
+    HG_QUEUE_ENTRY(hg_response_cache_entry) entry; /* Entry in expiry queue */
+    hg_uint64_t key;  /* Hash of encoded input */
+    hg_time_t expire; /* Expiration time */
+    void *in_buf;     /* Copy of encoded input */
+    hg_size_t in_size;  /* Size of encoded input */
+    void *out_buf;      /* Copy of encoded output (with HG header) */
+    hg_size_t out_size; /* Size of encoded output */
+};
+
+/* Cache of encoded responses, entries share the same TTL so that the queue
+ * is ordered by expiration time and oldest entries are evicted first */
+struct hg_response_cache {
+    HG_QUEUE_HEAD(hg_response_cache_entry) queue; /* Entries by expiration */
+    hg_hash_table_t *table; /* Key -> entry */
+    hg_thread_mutex_t lock; /* Cache lock */
+    hg_size_t size;         /* Size of cached entries */
+    hg_size_t max_size;     /* Max size of cached entries */
+    unsigned int ttl;       /* Time to live of entries (ms) */
 };
 
 /* Info for function map */
@@ -57,6 +179,24 @@ struct hg_proc_info {
     void *data;                    /* User data */
     void (*free_callback)(void *); /* User data free callback */
     hg_bool_t no_response;         /* RPC response not expected */
+    hg_bool_t no_checksum;         /* RPC payload not checksummed */
+    const struct hg_codec *codec;  /* Payload codec */
+    hg_size_t codec_threshold;     /* Min payload size for compression */
+    hg_bool_t coroutine;           /* RPC callback runs in coroutine */
+    struct hg_response_cache *response_cache; /* Response cache */
+    hg_proc_cb_t prefetch_proc_cb; /* Decodes bulk handle to prefetch */
+};
+
+/* Bulk data prefetched on RPC arrival */
+struct hg_prefetch {
+    hg_cb_t callback;              /* User callback */
+    void *arg;                     /* User callback args */
+    hg_bulk_t origin_bulk;         /* Bulk handle of origin */
+    hg_bulk_t local_bulk;          /* Bulk handle of local buffer */
+    struct hg_extra_buf *pool_buf; /* Pooled local buffer */
+    void *buf;                     /* Allocated local buffer */
+    hg_return_t ret;               /* Transfer return code */
+    hg_atomic_int32_t status;      /* Transfer status */
 };
 
 /* HG handle */
@@ -64,19 +204,52 @@ struct hg_private_handle {
     struct hg_handle handle;    /* Must remain as first field */
     struct hg_header hg_header; /* Header for input/output */
     hg_cb_t forward_cb;         /* Forward callback */
+    hg_cb_t chunk_cb;           /* Response chunk callback */
     hg_cb_t respond_cb;         /* Respond callback */
     hg_return_t (*extra_bulk_transfer_cb)(
         hg_core_handle_t);        /* Bulk transfer callback */
     void *forward_arg;            /* Forward callback args */
+    void *chunk_arg;              /* Response chunk callback args */
     void *respond_arg;            /* Respond callback args */
     void *in_extra_buf;           /* Extra input buffer */
     void *out_extra_buf;          /* Extra output buffer */
+    struct hg_extra_buf *in_extra_pool_buf;  /* Pooled extra input buffer */
+    struct hg_extra_buf *out_extra_pool_buf; /* Pooled extra output buffer */
     hg_proc_t in_proc;            /* Proc for input */
     hg_proc_t out_proc;           /* Proc for output */
     hg_bulk_t in_extra_bulk;      /* Extra input bulk handle */
     hg_bulk_t out_extra_bulk;     /* Extra output bulk handle */
+    hg_bulk_t resp_bulk;          /* Response buffer of origin */
     hg_size_t in_extra_buf_size;  /* Extra input buffer size */
     hg_size_t out_extra_buf_size; /* Extra output buffer size */
+    hg_size_t extra_mem_size;     /* Extra buffer memory accounted */
+    hg_size_t out_payload_size;   /* Output payload size */
+    struct hg_prefetch prefetch;  /* Prefetched bulk data */
+    hg_uint64_t response_key;     /* Hash of input for response cache */
+    hg_bool_t response_cacheable; /* Response can be added to cache */
+    hg_bool_t persistent;         /* Forward set up by HG_Forward_init() */
+    hg_time_ticks_t capture_ticks; /* Forward time (0 if not captured) */
+    hg_size_t capture_in_size;     /* Encoded input size */
+    hg_size_t capture_bulk_size;   /* Bulk memory exposed by input */
+};
+
+/* Call forwarded to several targets, first successful response wins */
+struct hg_hedge {
+    hg_cb_t callback;            /* User callback */
+    void *arg;                   /* User callback args */
+    hg_atomic_int32_t ref_count; /* Forwards not completed yet */
+    hg_atomic_int32_t failed;    /* Forwards that did not succeed */
+    hg_atomic_int32_t completed; /* User callback was triggered */
+    unsigned int count;          /* Number of handles */
+    hg_handle_t handles[];       /* Handles of forwards */
+};
+
+/* Arrays passed to the core when forwarding or responding in batch */
+struct hg_batch {
+    hg_core_handle_t *core_handles; /* Core handles */
+    void **args;                    /* Handles passed to core callbacks */
+    hg_size_t *payload_sizes;       /* Encoded payload sizes */
+    hg_uint8_t *flags;              /* Core flags */
 };
 
 /* HG op id */
@@ -104,6 +277,75 @@ struct hg_op_id {
 static void
 hg_proc_info_free(void *arg);
 
+/**
+ * Create response cache.
+ */
+static struct hg_response_cache *
+hg_response_cache_create(hg_size_t max_size, unsigned int ttl);
+
+/**
+ * Free response cache.
+ */
+static void
+hg_response_cache_free(struct hg_response_cache *hg_response_cache);
+
+/**
+ * Hash encoded input.
+ */
+static HG_INLINE hg_uint64_t
+hg_response_cache_hash(const void *buf, hg_size_t size);
+
+/**
+ * Hash function for response cache.
+ */
+static unsigned int
+hg_response_cache_key_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare function for response cache.
+ */
+static int
+hg_response_cache_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Remove expired entries and entries exceeding the cache size (must be called
+ * with cache lock).
+ */
+static void
+hg_response_cache_evict(struct hg_response_cache *hg_response_cache,
+    const hg_time_t *now, hg_size_t size);
+
+/**
+ * Copy cached output matching encoded input into output buffer.
+ */
+static hg_bool_t
+hg_response_cache_get(struct hg_response_cache *hg_response_cache,
+    hg_uint64_t key, const void *in_buf, hg_size_t in_size, void *out_buf,
+    hg_size_t out_buf_size, hg_size_t *out_size);
+
+/**
+ * Add encoded output to cache.
+ */
+static void
+hg_response_cache_put(struct hg_response_cache *hg_response_cache,
+    hg_uint64_t key, const void *in_buf, hg_size_t in_size,
+    const void *out_buf, hg_size_t out_size);
+
+/**
+ * Add encoded response of handle to cache if it can be cached.
+ */
+static void
+hg_response_cache_store(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_size_t payload_size);
+
+/**
+ * Respond from cache if encoded input was already seen, otherwise mark
+ * response as cacheable.
+ */
+static hg_bool_t
+hg_response_cache_respond(struct hg_private_handle *hg_handle,
+    struct hg_response_cache *hg_response_cache);
+
 /**
  * Alloc function for private data.
  */
@@ -162,6 +404,98 @@ hg_set_struct(struct hg_private_handle *hg_handle,
     const struct hg_proc_info *hg_proc_info, hg_op_t op, void *struct_ptr,
     hg_size_t *payload_size, hg_bool_t *more_data);
 
+/**
+ * Proc input/output structure, preceded by the response buffer descriptor of
+ * the origin if the header indicates one.
+ */
+static HG_INLINE hg_return_t
+hg_proc_struct(struct hg_private_handle *hg_handle, hg_op_t op, hg_proc_t proc,
+    hg_proc_cb_t proc_cb, void *struct_ptr);
+
+/**
+ * Get output payload that the target wrote to the response buffer.
+ */
+static hg_return_t
+hg_get_resp_payload(struct hg_private_handle *hg_handle, hg_size_t resp_size,
+    void **buf_ptr, hg_size_t *buf_size_ptr);
+
+/**
+ * Proc flags that depend on the target of the handle.
+ */
+static HG_INLINE hg_uint8_t
+hg_set_struct_target_flags(struct hg_private_handle *hg_handle);
+
+/**
+ * Save time and sizes of a forward if the class captures its workload.
+ */
+static HG_INLINE void
+hg_capture_forward(struct hg_private_handle *hg_handle, hg_size_t in_size,
+    hg_size_t bulk_size);
+
+/**
+ * Record completed forward to the capture file.
+ */
+static void
+hg_capture_forward_complete(
+    struct hg_private_handle *hg_handle, hg_return_t ret);
+
+/**
+ * Get encoded input/output payload that follows the HG header.
+ */
+static hg_return_t
+hg_get_raw(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_op_t op, void **buf_ptr,
+    hg_size_t *buf_size_ptr);
+
+/**
+ * Set pre-encoded input/output payload and encode HG header.
+ */
+static hg_return_t
+hg_set_raw(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_op_t op, const void *raw_buf,
+    hg_size_t raw_buf_size, hg_size_t *payload_size);
+
+/**
+ * Copy encoded input of hg_handle into hedge_handle if both share the same
+ * encoding, otherwise encode it again.
+ */
+static hg_return_t
+hg_hedge_set_input(struct hg_private_handle *hg_handle,
+    struct hg_private_handle *hedge_handle,
+    const struct hg_proc_info *hg_proc_info, void *in_struct,
+    hg_size_t *payload_size, hg_bool_t *more_data);
+
+/**
+ * Forward callback of hedged calls.
+ */
+static hg_return_t
+hg_hedge_forward_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Release hedge once all its forwards have completed.
+ */
+static void
+hg_hedge_release(struct hg_hedge *hedge);
+
+#ifndef HG_HAS_XDR
+/**
+ * Compress payload into buf. Compressed size is set to 0 if data could not be
+ * compressed into less than both payload size and buf size.
+ */
+static hg_return_t
+hg_compress_payload(const struct hg_codec *codec, const void *payload,
+    hg_size_t payload_size, void *buf, hg_size_t buf_size,
+    hg_size_t *comp_size);
+
+/**
+ * Decompress payload into a newly allocated buffer.
+ */
+static hg_return_t
+hg_decompress_payload(const struct hg_codec *codec, const void *buf,
+    hg_size_t buf_size, const struct hg_header_comp *hg_header_comp,
+    void **payload, hg_size_t *payload_size);
+#endif
+
 /**
  * Free allocated members from input/output structure.
  */
@@ -182,18 +516,210 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
 static HG_INLINE hg_return_t
 hg_get_extra_payload_cb(const struct hg_cb_info *callback_info);
 
+/**
+ * Push extra output payload into the response buffer of origin and respond
+ * once the transfer has completed.
+ */
+static hg_return_t
+hg_put_resp_payload(struct hg_private_handle *hg_handle,
+    hg_size_t payload_size, hg_bool_t *pushed);
+
+/**
+ * Put response payload bulk transfer callback.
+ */
+static hg_return_t
+hg_put_resp_payload_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Start pulling bulk data of input before the RPC callback is executed.
+ */
+static void
+hg_prefetch_start(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info);
+
+/**
+ * Prefetch bulk transfer callback.
+ */
+static hg_return_t
+hg_prefetch_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Execute user callback of prefetched bulk data.
+ */
+static void
+hg_prefetch_complete(struct hg_private_handle *hg_handle);
+
+/**
+ * Free prefetched bulk data.
+ */
+static void
+hg_prefetch_free(struct hg_private_handle *hg_handle);
+
+/**
+ * Account for extra payload memory, fails if that exceeds the memory limit of
+ * the context.
+ */
+static hg_return_t
+hg_extra_mem_acquire(struct hg_private_handle *hg_handle, hg_size_t size);
+
 /**
  * Free allocated extra payload.
  */
 static void
 hg_free_extra_payload(struct hg_private_handle *hg_handle);
 
+/**
+ * Get registered buffer of at least size bytes from extra payload pool.
+ * Returns NULL if size exceeds the largest size class.
+ */
+static struct hg_extra_buf *
+hg_extra_pool_get(struct hg_private_class *hg_class, unsigned int type,
+    hg_size_t size);
+
+/**
+ * Return registered buffer to extra payload pool.
+ */
+static void
+hg_extra_pool_put(
+    struct hg_private_class *hg_class, struct hg_extra_buf *hg_extra_buf);
+
+/**
+ * Release registered buffer.
+ */
+static void
+hg_extra_buf_free(struct hg_extra_buf *hg_extra_buf);
+
+/**
+ * Free all unused buffers of extra payload pool.
+ */
+static void
+hg_extra_pool_finalize(struct hg_private_class *hg_class);
+
+/**
+ * Execute RPC callback in a coroutine.
+ */
+static hg_return_t
+hg_handler_coroutine_run(struct hg_private_class *hg_class, hg_rpc_cb_t rpc_cb,
+    hg_handle_t handle);
+
+/**
+ * Entry point of handler coroutines.
+ */
+static void
+hg_handler_coroutine_entry(void *arg);
+
+/**
+ * Resume handler coroutine until it completes or until it waits for an
+ * operation that has not completed yet.
+ */
+static void
+hg_handler_coroutine_resume(struct hg_handler_coroutine *hg_handler_coroutine);
+
+/**
+ * Release handler coroutine once its RPC callback has returned.
+ */
+static void
+hg_handler_coroutine_release(
+    struct hg_handler_coroutine *hg_handler_coroutine);
+
+/**
+ * Free all idle handler coroutines.
+ */
+static void
+hg_handler_coroutine_finalize(struct hg_private_class *hg_class);
+
+/**
+ * Hash interned key.
+ */
+static unsigned int
+hg_key_table_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare interned keys.
+ */
+static int
+hg_key_table_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Create intern table.
+ */
+static hg_return_t
+hg_key_table_init(struct hg_private_class *hg_class, hg_uint32_t max);
+
+/**
+ * Destroy intern table and interned keys.
+ */
+static void
+hg_key_table_finalize(struct hg_private_class *hg_class);
+
+/**
+ * Create shard contexts and start their threads.
+ */
+static hg_return_t
+hg_shards_start(struct hg_private_class *hg_class, hg_uint8_t shard_count);
+
+/**
+ * Stop shard threads and destroy shard contexts.
+ */
+static hg_return_t
+hg_shards_stop(struct hg_private_class *hg_class);
+
+/**
+ * Shard thread, polls and triggers its own context.
+ */
+static HG_THREAD_RETURN_TYPE
+hg_shard_thread(void *arg);
+
 /**
  * Forward callback.
  */
 static HG_INLINE hg_return_t
 hg_core_forward_cb(const struct hg_core_cb_info *callback_info);
 
+/**
+ * Set callbacks and encode input of a forward.
+ */
+static hg_return_t
+hg_forward_prepare(hg_handle_t handle, hg_cb_t callback, void *arg,
+    hg_cb_t chunk_callback, void *chunk_arg, void *in_struct,
+    hg_uint8_t *flags_ptr, hg_size_t *payload_size_ptr);
+
+/**
+ * Forward call, chunk callback is only set for streamed responses.
+ */
+static hg_return_t
+hg_forward(hg_handle_t handle, hg_cb_t callback, void *arg,
+    hg_cb_t chunk_callback, void *chunk_arg, void *in_struct,
+    unsigned int timeout);
+
+/**
+ * Set callback and encode output of a response. Responses whose payload
+ * does not fit are pushed to origin and sent once the transfer completes,
+ * \sent_ptr is then set.
+ */
+static hg_return_t
+hg_respond_prepare(hg_handle_t handle, hg_cb_t callback, void *arg,
+    void *out_struct, hg_uint8_t *flags_ptr, hg_size_t *payload_size_ptr,
+    hg_bool_t *sent_ptr);
+
+/**
+ * Allocate arrays of a batch of \count handles.
+ */
+static hg_return_t
+hg_batch_alloc(struct hg_batch *hg_batch, unsigned int count);
+
+/**
+ * Free arrays of a batch.
+ */
+static void
+hg_batch_free(struct hg_batch *hg_batch);
+
+/**
+ * Response chunk callback.
+ */
+static hg_return_t
+hg_core_chunk_cb(const struct hg_core_cb_info *callback_info);
+
 /**
  * Respond callback.
  */
@@ -220,59 +746,305 @@ hg_proc_info_free(void *arg)
 
     if (hg_proc_info->free_callback)
         hg_proc_info->free_callback(hg_proc_info->data);
+    hg_response_cache_free(hg_proc_info->response_cache);
     free(hg_proc_info);
 }
 
 /*---------------------------------------------------------------------------*/
-static struct hg_private_handle *
-hg_handle_create(struct hg_private_class *hg_class)
+static struct hg_response_cache *
+hg_response_cache_create(hg_size_t max_size, unsigned int ttl)
 {
-    struct hg_private_handle *hg_handle = NULL;
-    hg_return_t ret;
+    struct hg_response_cache *hg_response_cache = NULL;
 
-    /* Create private data to wrap callbacks etc */
-    hg_handle =
-        (struct hg_private_handle *) malloc(sizeof(struct hg_private_handle));
+    hg_response_cache =
+        (struct hg_response_cache *) malloc(sizeof(struct hg_response_cache));
     HG_CHECK_ERROR_NORET(
-        hg_handle == NULL, error, "Could not allocate handle private data");
-
-    memset(hg_handle, 0, sizeof(struct hg_private_handle));
-    hg_handle->handle.info.hg_class = (hg_class_t *) hg_class;
-    hg_header_init(&hg_handle->hg_header, HG_UNDEF);
-
-    /* CRC32 is enough for small size buffers */
-    ret =
-        hg_proc_create((hg_class_t *) hg_class, HG_CRC32, &hg_handle->in_proc);
-    HG_CHECK_HG_ERROR(error, ret, "Cannot create HG proc");
+        hg_response_cache == NULL, error, "Could not allocate response cache");
 
-    ret =
-        hg_proc_create((hg_class_t *) hg_class, HG_CRC32, &hg_handle->out_proc);
-    HG_CHECK_HG_ERROR(error, ret, "Cannot create HG proc");
+    HG_QUEUE_INIT(&hg_response_cache->queue);
+    hg_response_cache->table = hg_hash_table_new(
+        hg_response_cache_key_hash, hg_response_cache_key_equal);
+    HG_CHECK_ERROR_NORET(hg_response_cache->table == NULL, error,
+        "Could not create response cache table");
+    hg_thread_mutex_init(&hg_response_cache->lock);
+    hg_response_cache->size = 0;
+    hg_response_cache->max_size = max_size;
+    hg_response_cache->ttl = ttl;
 
-    return hg_handle;
+    return hg_response_cache;
 
 error:
-    hg_handle_free(hg_handle);
+    free(hg_response_cache);
     return NULL;
 }
 
 /*---------------------------------------------------------------------------*/
 static void
-hg_handle_free(void *arg)
+hg_response_cache_free(struct hg_response_cache *hg_response_cache)
 {
-    struct hg_private_handle *hg_handle = (struct hg_private_handle *) arg;
-
-    if (!hg_handle)
+    if (!hg_response_cache)
         return;
 
-    if (hg_handle->handle.data_free_callback)
-        hg_handle->handle.data_free_callback(hg_handle->handle.data);
-    if (hg_handle->in_proc != HG_PROC_NULL)
-        hg_proc_free(hg_handle->in_proc);
-    if (hg_handle->out_proc != HG_PROC_NULL)
-        hg_proc_free(hg_handle->out_proc);
-    hg_header_finalize(&hg_handle->hg_header);
-    free(hg_handle);
+    while (!HG_QUEUE_IS_EMPTY(&hg_response_cache->queue)) {
+        struct hg_response_cache_entry *entry =
+            HG_QUEUE_FIRST(&hg_response_cache->queue);
+
+        HG_QUEUE_POP_HEAD(&hg_response_cache->queue, entry);
+        free(entry);
+    }
+    hg_hash_table_free(hg_response_cache->table);
+    hg_thread_mutex_destroy(&hg_response_cache->lock);
+    free(hg_response_cache);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_uint64_t
+hg_response_cache_hash(const void *buf, hg_size_t size)
+{
+    const unsigned char *p = (const unsigned char *) buf;
+    hg_uint64_t hash = 14695981039346656037ULL; /* FNV-1a */
+    hg_size_t i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_response_cache_key_hash(hg_hash_table_key_t key)
+{
+    hg_uint64_t hash = *(const hg_uint64_t *) key;
+
+    return (unsigned int) (hash ^ (hash >> 32));
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_response_cache_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return *(const hg_uint64_t *) key1 == *(const hg_uint64_t *) key2;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_response_cache_evict(struct hg_response_cache *hg_response_cache,
+    const hg_time_t *now, hg_size_t size)
+{
+    while (!HG_QUEUE_IS_EMPTY(&hg_response_cache->queue)) {
+        struct hg_response_cache_entry *entry =
+            HG_QUEUE_FIRST(&hg_response_cache->queue);
+
+        if (!hg_time_less(entry->expire, *now) &&
+            hg_response_cache->size + size <= hg_response_cache->max_size)
+            break;
+
+        HG_QUEUE_POP_HEAD(&hg_response_cache->queue, entry);
+        hg_hash_table_remove(
+            hg_response_cache->table, (hg_hash_table_key_t) &entry->key);
+        hg_response_cache->size -= entry->in_size + entry->out_size;
+        free(entry);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_response_cache_get(struct hg_response_cache *hg_response_cache,
+    hg_uint64_t key, const void *in_buf, hg_size_t in_size, void *out_buf,
+    hg_size_t out_buf_size, hg_size_t *out_size)
+{
+    struct hg_response_cache_entry *entry;
+    hg_bool_t found = HG_FALSE;
+    hg_time_t now;
+
+    hg_time_get_current_ms(&now);
+
+    hg_thread_mutex_lock(&hg_response_cache->lock);
+    hg_response_cache_evict(hg_response_cache, &now, 0);
+
+    entry = (struct hg_response_cache_entry *) hg_hash_table_lookup(
+        hg_response_cache->table, (hg_hash_table_key_t) &key);
+    if (entry && entry->in_size == in_size &&
+        memcmp(entry->in_buf, in_buf, in_size) == 0 &&
+        entry->out_size <= out_buf_size) {
+        memcpy(out_buf, entry->out_buf, entry->out_size);
+        *out_size = entry->out_size;
+        found = HG_TRUE;
+    }
+    hg_thread_mutex_unlock(&hg_response_cache->lock);
+
+    return found;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_response_cache_put(struct hg_response_cache *hg_response_cache,
+    hg_uint64_t key, const void *in_buf, hg_size_t in_size,
+    const void *out_buf, hg_size_t out_size)
+{
+    struct hg_response_cache_entry *entry;
+    hg_time_t now;
+
+    if (in_size + out_size > hg_response_cache->max_size)
+        return;
+
+    /* Input and output are copied along with the entry */
+    entry = (struct hg_response_cache_entry *) malloc(
+        sizeof(struct hg_response_cache_entry) + in_size + out_size);
+    HG_CHECK_ERROR_NORET(
+        entry == NULL, done, "Could not allocate response cache entry");
+    entry->key = key;
+    entry->in_buf = entry + 1;
+    entry->in_size = in_size;
+    memcpy(entry->in_buf, in_buf, in_size);
+    entry->out_buf = (char *) entry->in_buf + in_size;
+    entry->out_size = out_size;
+    memcpy(entry->out_buf, out_buf, out_size);
+
+    hg_time_get_current_ms(&now);
+    entry->expire = hg_time_add(now, hg_time_from_ms(hg_response_cache->ttl));
+
+    hg_thread_mutex_lock(&hg_response_cache->lock);
+    hg_response_cache_evict(hg_response_cache, &now, in_size + out_size);
+
+    /* Keep existing entry (concurrent miss or hash collision) */
+    if (hg_hash_table_lookup(
+            hg_response_cache->table, (hg_hash_table_key_t) &entry->key) ||
+        !hg_hash_table_insert(hg_response_cache->table,
+            (hg_hash_table_key_t) &entry->key, (hg_hash_table_value_t) entry)) {
+        hg_thread_mutex_unlock(&hg_response_cache->lock);
+        free(entry);
+        goto done;
+    }
+    HG_QUEUE_PUSH_TAIL(&hg_response_cache->queue, entry, entry);
+    hg_response_cache->size += in_size + out_size;
+    hg_thread_mutex_unlock(&hg_response_cache->lock);
+
+done:
+    return;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_response_cache_store(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_size_t payload_size)
+{
+    hg_core_handle_t core_handle = hg_handle->handle.core_handle;
+    void *in_buf, *out_buf;
+    hg_size_t in_buf_size, in_size, out_buf_size;
+
+    if (!hg_proc_info->response_cache || !hg_handle->response_cacheable)
+        return;
+
+    if (HG_Core_get_input(core_handle, &in_buf, &in_buf_size) == HG_SUCCESS &&
+        HG_Core_get_input_payload_size(core_handle, &in_size) == HG_SUCCESS &&
+        HG_Core_get_output(core_handle, &out_buf, &out_buf_size) == HG_SUCCESS)
+        hg_response_cache_put(hg_proc_info->response_cache,
+            hg_handle->response_key, in_buf, in_size, out_buf, payload_size);
+    hg_handle->response_cacheable = HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_response_cache_respond(struct hg_private_handle *hg_handle,
+    struct hg_response_cache *hg_response_cache)
+{
+    hg_core_handle_t core_handle = hg_handle->handle.core_handle;
+    void *in_buf, *out_buf;
+    hg_size_t in_buf_size, in_size, out_buf_size, out_size;
+    hg_return_t ret;
+
+    hg_handle->response_cacheable = HG_FALSE;
+
+    /* Inputs that required an extra transfer are not cached */
+    if (hg_handle->in_extra_buf)
+        return HG_FALSE;
+
+    ret = HG_Core_get_input(core_handle, &in_buf, &in_buf_size);
+    if (ret != HG_SUCCESS)
+        return HG_FALSE;
+    ret = HG_Core_get_input_payload_size(core_handle, &in_size);
+    if (ret != HG_SUCCESS)
+        return HG_FALSE;
+    hg_handle->response_key = hg_response_cache_hash(in_buf, in_size);
+
+    ret = HG_Core_get_output(core_handle, &out_buf, &out_buf_size);
+    if (ret != HG_SUCCESS)
+        return HG_FALSE;
+
+    if (!hg_response_cache_get(hg_response_cache, hg_handle->response_key,
+            in_buf, in_size, out_buf, out_buf_size, &out_size)) {
+        hg_handle->response_cacheable = HG_TRUE;
+        return HG_FALSE;
+    }
+
+    /* Send cached response, skipping RPC callback and output proc */
+    hg_handle->respond_cb = NULL;
+    ret = HG_Core_respond(
+        core_handle, hg_core_respond_cb, hg_handle, 0, out_size);
+    HG_CHECK_ERROR_NORET(ret != HG_SUCCESS, done,
+        "Could not respond from cache (%s)", HG_Error_to_string(ret));
+
+done:
+    /* Release handle as the RPC callback would have done */
+    HG_Core_destroy(core_handle);
+
+    return HG_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_private_handle *
+hg_handle_create(struct hg_private_class *hg_class)
+{
+    struct hg_private_handle *hg_handle = NULL;
+    hg_return_t ret;
+
+    /* Create private data to wrap callbacks etc */
+    hg_handle =
+        (struct hg_private_handle *) malloc(sizeof(struct hg_private_handle));
+    HG_CHECK_ERROR_NORET(
+        hg_handle == NULL, error, "Could not allocate handle private data");
+
+    memset(hg_handle, 0, sizeof(struct hg_private_handle));
+    hg_handle->handle.info.hg_class = (hg_class_t *) hg_class;
+    hg_header_init(&hg_handle->hg_header, HG_UNDEF);
+
+    /* CRC32 is enough for small size buffers */
+    ret =
+        hg_proc_create((hg_class_t *) hg_class, HG_CRC32, &hg_handle->in_proc);
+    HG_CHECK_HG_ERROR(error, ret, "Cannot create HG proc");
+
+    ret =
+        hg_proc_create((hg_class_t *) hg_class, HG_CRC32, &hg_handle->out_proc);
+    HG_CHECK_HG_ERROR(error, ret, "Cannot create HG proc");
+
+    return hg_handle;
+
+error:
+    hg_handle_free(hg_handle);
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_handle_free(void *arg)
+{
+    struct hg_private_handle *hg_handle = (struct hg_private_handle *) arg;
+
+    if (!hg_handle)
+        return;
+
+    if (hg_handle->handle.data_free_callback)
+        hg_handle->handle.data_free_callback(hg_handle->handle.data);
+    if (hg_handle->in_proc != HG_PROC_NULL)
+        hg_proc_free(hg_handle->in_proc);
+    if (hg_handle->out_proc != HG_PROC_NULL)
+        hg_proc_free(hg_handle->out_proc);
+    hg_header_finalize(&hg_handle->hg_header);
+    free(hg_handle);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -359,6 +1131,14 @@ hg_more_data_free_cb(hg_core_handle_t core_handle)
         return;
 
     hg_free_extra_payload(hg_handle);
+
+    /* Response buffer is attached until the handle is reset */
+    if (hg_handle->resp_bulk != HG_BULK_NULL) {
+        HG_Bulk_free(hg_handle->resp_bulk);
+        hg_handle->resp_bulk = HG_BULK_NULL;
+    }
+
+    hg_prefetch_free(hg_handle);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -379,7 +1159,21 @@ hg_core_rpc_cb(hg_core_handle_t core_handle)
     HG_CHECK_ERROR(hg_proc_info->rpc_cb == NULL, error, ret, HG_INVALID_ARG,
         "No RPC callback registered");
 
-    ret = hg_proc_info->rpc_cb((hg_handle_t) hg_handle);
+    /* Idempotent RPCs may be answered without executing the callback */
+    if (hg_proc_info->response_cache &&
+        hg_response_cache_respond(hg_handle, hg_proc_info->response_cache))
+        return HG_SUCCESS;
+
+    /* Overlap pull of bulk data with queueing of the RPC callback */
+    if (hg_proc_info->prefetch_proc_cb)
+        hg_prefetch_start(hg_handle, hg_proc_info);
+
+    if (hg_proc_info->coroutine) {
+        ret = hg_handler_coroutine_run(HG_HANDLE_CLASS(&hg_handle->handle),
+            hg_proc_info->rpc_cb, (hg_handle_t) hg_handle);
+        HG_CHECK_HG_ERROR(error, ret, "Could not run RPC callback coroutine");
+    } else
+        ret = hg_proc_info->rpc_cb((hg_handle_t) hg_handle);
 
     return ret;
 
@@ -418,9 +1212,13 @@ hg_get_struct(struct hg_private_handle *hg_handle,
 {
     hg_proc_t proc = HG_PROC_NULL;
     hg_proc_cb_t proc_cb = NULL;
-    void *buf, *extra_buf;
-    hg_size_t buf_size, extra_buf_size;
+    hg_uint8_t proc_flags = 0;
+    void *buf, **extra_buf;
+    hg_size_t buf_size, *extra_buf_size;
     struct hg_header *hg_header = &hg_handle->hg_header;
+#ifndef HG_HAS_XDR
+    struct hg_header_comp *hg_header_comp = NULL;
+#endif
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash *hg_header_hash = NULL;
 #endif
@@ -442,8 +1240,15 @@ hg_get_struct(struct hg_private_handle *hg_handle,
                 hg_handle->handle.core_handle, &buf, &buf_size);
             HG_CHECK_HG_ERROR(done, ret, "Could not get input buffer");
 
-            extra_buf = hg_handle->in_extra_buf;
-            extra_buf_size = hg_handle->in_extra_buf_size;
+#ifndef HG_HAS_XDR
+            hg_header_comp = &hg_header->msg.input.comp;
+
+            /* Sender uses a different byte order */
+            if (HG_Core_is_input_swapped(hg_handle->handle.core_handle))
+                proc_flags |= HG_PROC_SWAP;
+#endif
+            extra_buf = &hg_handle->in_extra_buf;
+            extra_buf_size = &hg_handle->in_extra_buf_size;
             break;
         case HG_OUTPUT:
             /* Cannot respond if no_response flag set */
@@ -464,8 +1269,15 @@ hg_get_struct(struct hg_private_handle *hg_handle,
                 hg_handle->handle.core_handle, &buf, &buf_size);
             HG_CHECK_HG_ERROR(done, ret, "Could not get output buffer");
 
-            extra_buf = hg_handle->out_extra_buf;
-            extra_buf_size = hg_handle->out_extra_buf_size;
+#ifndef HG_HAS_XDR
+            hg_header_comp = &hg_header->msg.output.comp;
+
+            /* Sender uses a different byte order */
+            if (HG_Core_is_output_swapped(hg_handle->handle.core_handle))
+                proc_flags |= HG_PROC_SWAP;
+#endif
+            extra_buf = &hg_handle->out_extra_buf;
+            extra_buf_size = &hg_handle->out_extra_buf_size;
             break;
         default:
             HG_GOTO_ERROR(done, ret, HG_INVALID_ARG, "Invalid HG op");
@@ -480,11 +1292,30 @@ hg_get_struct(struct hg_private_handle *hg_handle,
     ret = hg_header_proc(HG_DECODE, buf, buf_size, hg_header);
     HG_CHECK_HG_ERROR(done, ret, "Could not process header");
 
+#ifndef HG_HAS_XDR
+    /* Decompress payload into an extra buffer, which is kept until the
+     * handle is reset */
+    if (*extra_buf == NULL && hg_header_comp->size != 0) {
+        ret = hg_extra_mem_acquire(hg_handle, hg_header_comp->orig_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not account for payload");
+
+        ret = hg_decompress_payload(hg_proc_info->codec,
+            (char *) buf + header_offset, buf_size - header_offset,
+            hg_header_comp, extra_buf, extra_buf_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not decompress payload");
+    }
+#endif
+
     /* If the payload did not fit into the core buffer and we have an extra
      * buffer set, use that buffer directly */
-    if (extra_buf) {
-        buf = extra_buf;
-        buf_size = extra_buf_size;
+    if (*extra_buf) {
+        buf = *extra_buf;
+        buf_size = *extra_buf_size;
+    } else if (op == HG_OUTPUT && hg_header->msg.output.resp_size != 0) {
+        /* Target wrote the payload into our response buffer */
+        ret = hg_get_resp_payload(
+            hg_handle, hg_header->msg.output.resp_size, &buf, &buf_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get response payload");
     } else {
         /* Include our own header offset */
         buf = (char *) buf + header_offset;
@@ -495,8 +1326,28 @@ hg_get_struct(struct hg_private_handle *hg_handle,
     ret = hg_proc_reset(proc, buf, buf_size, HG_DECODE);
     HG_CHECK_HG_ERROR(done, ret, "Could not reset proc");
 
+    /* Let decoded data point into the buffer, which is kept until
+     * free_struct is called */
+    if (HG_HANDLE_CLASS(&hg_handle->handle)->decode_borrow)
+        proc_flags |= HG_PROC_BORROW;
+
+    /* Allocate decoded data from the proc arena, which is reset when
+     * free_struct is called */
+    if (HG_HANDLE_CLASS(&hg_handle->handle)->decode_arena)
+        proc_flags |= HG_PROC_ARENA;
+
+    /* Look up decoded keys in the intern table */
+    if (HG_HANDLE_CLASS(&hg_handle->handle)->key_table.table)
+        proc_flags |= HG_PROC_INTERN;
+
+    /* Skip checksum if disabled for that RPC */
+    if (hg_proc_info->no_checksum)
+        proc_flags |= HG_PROC_NO_CHECKSUM;
+
+    hg_proc_set_flags(proc, proc_flags);
+
     /* Decode parameters */
-    ret = proc_cb(proc, struct_ptr);
+    ret = hg_proc_struct(hg_handle, op, proc, proc_cb, struct_ptr);
     HG_CHECK_HG_ERROR(done, ret, "Could not decode parameters");
 
     /* Flush proc */
@@ -505,9 +1356,11 @@ hg_get_struct(struct hg_private_handle *hg_handle,
 
 #ifdef HG_HAS_CHECKSUMS
     /* Compare checksum with header hash */
-    ret = hg_proc_checksum_verify(
-        proc, &hg_header_hash->payload, sizeof(hg_header_hash->payload));
-    HG_CHECK_HG_ERROR(done, ret, "Error in proc checksum verify");
+    if (!hg_proc_info->no_checksum) {
+        ret = hg_proc_checksum_verify(
+            proc, &hg_header_hash->payload, sizeof(hg_header_hash->payload));
+        HG_CHECK_HG_ERROR(done, ret, "Error in proc checksum verify");
+    }
 #endif
 
     /* Increment ref count on handle so that it remains valid until free_struct
@@ -530,7 +1383,12 @@ hg_set_struct(struct hg_private_handle *hg_handle,
     void *buf, **extra_buf;
     hg_size_t buf_size, *extra_buf_size;
     hg_bulk_t *extra_bulk;
+    struct hg_extra_buf **extra_pool_buf, *hg_extra_buf = NULL;
     struct hg_header *hg_header = &hg_handle->hg_header;
+#ifndef HG_HAS_XDR
+    struct hg_header_comp *hg_header_comp = NULL;
+    hg_size_t comp_size = 0;
+#endif
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash *hg_header_hash = NULL;
 #endif
@@ -555,6 +1413,10 @@ hg_set_struct(struct hg_private_handle *hg_handle,
             extra_buf = &hg_handle->in_extra_buf;
             extra_buf_size = &hg_handle->in_extra_buf_size;
             extra_bulk = &hg_handle->in_extra_bulk;
+            extra_pool_buf = &hg_handle->in_extra_pool_buf;
+#ifndef HG_HAS_XDR
+            hg_header_comp = &hg_header->msg.input.comp;
+#endif
             break;
         case HG_OUTPUT:
             /* Cannot respond if no_response flag set */
@@ -578,6 +1440,10 @@ hg_set_struct(struct hg_private_handle *hg_handle,
             extra_buf = &hg_handle->out_extra_buf;
             extra_buf_size = &hg_handle->out_extra_buf_size;
             extra_bulk = &hg_handle->out_extra_bulk;
+            extra_pool_buf = &hg_handle->out_extra_pool_buf;
+#ifndef HG_HAS_XDR
+            hg_header_comp = &hg_header->msg.output.comp;
+#endif
             break;
         default:
             HG_GOTO_ERROR(done, ret, HG_INVALID_ARG, "Invalid HG op");
@@ -591,6 +1457,12 @@ hg_set_struct(struct hg_private_handle *hg_handle,
     /* Reset header */
     hg_header_reset(hg_header, op);
 
+    /* Let target write output that does not fit into the response message
+     * directly into the response buffer */
+    if (op == HG_INPUT && hg_handle->resp_bulk != HG_BULK_NULL &&
+        !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr))
+        hg_header->msg.input.flags |= HG_HEADER_RESP_BULK;
+
     /* Include our own header offset */
     buf = (char *) buf + header_offset;
     buf_size -= header_offset;
@@ -599,22 +1471,54 @@ hg_set_struct(struct hg_private_handle *hg_handle,
     ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
     HG_CHECK_HG_ERROR(done, ret, "Could not reset proc");
 
-#ifdef NA_HAS_SM
-    /* Determine if we need special handling for SM */
-    if (HG_Core_addr_get_na_sm(hg_handle->handle.core_handle->info.addr) !=
-        NA_ADDR_NULL)
-        proc_flags |= HG_PROC_SM;
-#endif
+    /* Special handling for SM and eager bulk transfers */
+    proc_flags |= hg_set_struct_target_flags(hg_handle);
 
-    /* Attempt to use eager bulk transfers when appropriate */
-    if (HG_HANDLE_CLASS(&hg_handle->handle)->bulk_eager &&
-        !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr))
-        proc_flags |= HG_PROC_BULK_EAGER;
+    /* Skip checksum if disabled for that RPC */
+    if (hg_proc_info->no_checksum)
+        proc_flags |= HG_PROC_NO_CHECKSUM;
 
+#ifndef HG_HAS_XDR
+    /* Compute total size if parameters do not fit */
+    hg_proc_set_flags(proc, proc_flags | HG_PROC_SIZE_PASS);
+#else
     hg_proc_set_flags(proc, proc_flags);
+#endif
 
     /* Encode parameters */
-    ret = proc_cb(proc, struct_ptr);
+    ret = hg_proc_struct(hg_handle, op, proc, proc_cb, struct_ptr);
+
+#ifndef HG_HAS_XDR
+    /* Parameters did not fit, encode them again into an extra buffer that is
+     * allocated once, or taken from the pool of registered buffers. If the
+     * proc failed to compute the size (e.g., it does not support HG_SIZE),
+     * fall back to growing the extra buffer. */
+    if (hg_proc_get_op(proc) == HG_SIZE) {
+        hg_size_t total_size = hg_proc_get_size_used(proc);
+        hg_bool_t sized = (ret == HG_SUCCESS);
+
+        if (sized)
+            hg_extra_buf =
+                hg_extra_pool_get(HG_HANDLE_CLASS(&hg_handle->handle),
+                    HG_EXTRA_POOL_READ_ONLY, total_size);
+
+        if (hg_extra_buf)
+            ret = hg_proc_reset(proc, hg_extra_buf->buf,
+                HG_EXTRA_POOL_CLASS_SIZE(hg_extra_buf->size_class), HG_ENCODE);
+        else
+            ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+        HG_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+        hg_proc_set_flags(proc, proc_flags);
+
+        if (sized && !hg_extra_buf) {
+            ret = hg_proc_set_size(proc, total_size);
+            HG_CHECK_HG_ERROR(done, ret, "Could not set proc size");
+        }
+
+        ret = hg_proc_struct(hg_handle, op, proc, proc_cb, struct_ptr);
+    }
+#endif
     HG_CHECK_HG_ERROR(done, ret, "Could not encode parameters");
 
     /* Flush proc */
@@ -623,9 +1527,50 @@ hg_set_struct(struct hg_private_handle *hg_handle,
 
 #ifdef HG_HAS_CHECKSUMS
     /* Set checksum in header */
-    ret = hg_proc_checksum_get(
-        proc, &hg_header_hash->payload, sizeof(hg_header_hash->payload));
-    HG_CHECK_HG_ERROR(done, ret, "Error in getting proc checksum");
+    if (!hg_proc_info->no_checksum) {
+        ret = hg_proc_checksum_get(
+            proc, &hg_header_hash->payload, sizeof(hg_header_hash->payload));
+        HG_CHECK_HG_ERROR(done, ret, "Error in getting proc checksum");
+    }
+#endif
+
+    /* Sizes are captured before compression */
+    if (op == HG_INPUT)
+        hg_capture_forward(hg_handle, hg_proc_get_size_used(proc),
+            hg_proc_get_bulk_size(proc));
+
+#ifndef HG_HAS_XDR
+    /* Compress payload if requested, if compressed data fits into the core
+     * buffer, the extra payload is no longer needed */
+    if (hg_proc_info->codec &&
+        hg_proc_get_size_used(proc) >= hg_proc_info->codec_threshold) {
+        hg_size_t orig_size = hg_proc_get_size_used(proc);
+        const void *payload = buf;
+
+        if (hg_extra_buf)
+            payload = hg_extra_buf->buf;
+        else if (hg_proc_get_extra_buf(proc))
+            payload = hg_proc_get_extra_buf(proc);
+
+        ret = hg_compress_payload(hg_proc_info->codec, payload, orig_size,
+            buf, buf_size, &comp_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not compress payload");
+
+        if (comp_size) {
+            hg_header_comp->size = (hg_uint32_t) comp_size;
+            hg_header_comp->orig_size = (hg_uint32_t) orig_size;
+
+            if (hg_extra_buf) {
+                hg_extra_pool_put(
+                    HG_HANDLE_CLASS(&hg_handle->handle), hg_extra_buf);
+                hg_extra_buf = NULL;
+            }
+
+            /* Release extra buffer of proc */
+            ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+            HG_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+        }
+    }
 #endif
 
     /* The proc object may have allocated an extra buffer at this point.
@@ -634,43 +1579,58 @@ hg_set_struct(struct hg_private_handle *hg_handle,
      * for the extra buffer so that the target can pull that buffer and use
      * it to retrieve the data.
      */
-    if (hg_proc_get_extra_buf(proc)) {
+    if (hg_proc_get_extra_buf(proc) || hg_extra_buf) {
         /* Potentially free previous payload if handle was not reset */
         hg_free_extra_payload(hg_handle);
 #ifdef HG_HAS_XDR
         HG_GOTO_ERROR(done, ret, HG_OVERFLOW,
             "Arguments overflow is not supported with XDR");
 #endif
-        /* Create a bulk descriptor only of the size that is used */
-        *extra_buf = hg_proc_get_extra_buf(proc);
-        *extra_buf_size = hg_proc_get_size_used(proc);
-
-        /* Prevent buffer from being freed when proc_reset is called */
-        hg_proc_set_extra_buf_is_mine(proc, HG_TRUE);
+        ret = hg_extra_mem_acquire(hg_handle, hg_proc_get_size_used(proc));
+        HG_CHECK_HG_ERROR(done, ret, "Could not account for extra payload");
+
+        if (hg_extra_buf && hg_proc_get_extra_buf(proc)) {
+            /* Payload grew past the pooled buffer, use the proc's buffer */
+            hg_extra_pool_put(
+                HG_HANDLE_CLASS(&hg_handle->handle), hg_extra_buf);
+            hg_extra_buf = NULL;
+        }
 
-        /* Create bulk descriptor */
-        ret = HG_Bulk_create(hg_handle->handle.info.hg_class, 1, extra_buf,
-            extra_buf_size, HG_BULK_READ_ONLY, extra_bulk);
-        HG_CHECK_HG_ERROR(done, ret, "Could not create bulk data handle");
+        if (hg_extra_buf) {
+            /* Pooled buffer is already registered, only expose the size that
+             * is used so that the target pulls the exact payload */
+            *extra_buf = hg_extra_buf->buf;
+            *extra_buf_size = hg_proc_get_size_used(proc);
+
+            ret = hg_bulk_set_size(hg_extra_buf->bulk, *extra_buf_size);
+            HG_CHECK_HG_ERROR(done, ret, "Could not set bulk handle size");
+            *extra_bulk = hg_extra_buf->bulk;
+
+            /* Buffer is now owned by the handle */
+            *extra_pool_buf = hg_extra_buf;
+            hg_extra_buf = NULL;
+        } else {
+            /* Create a bulk descriptor only of the size that is used */
+            *extra_buf = hg_proc_get_extra_buf(proc);
+            *extra_buf_size = hg_proc_get_size_used(proc);
+
+            /* Prevent buffer from being freed when proc_reset is called */
+            hg_proc_set_extra_buf_is_mine(proc, HG_TRUE);
+
+            /* Create bulk descriptor */
+            ret = HG_Bulk_create(hg_handle->handle.info.hg_class, 1, extra_buf,
+                extra_buf_size, HG_BULK_READ_ONLY, extra_bulk);
+            HG_CHECK_HG_ERROR(done, ret, "Could not create bulk data handle");
+        }
 
         /* Reset proc */
         ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
         HG_CHECK_HG_ERROR(done, ret, "Could not reset proc");
 
-        /* Reset proc flags */
-        proc_flags = 0;
-
-#ifdef NA_HAS_SM
-        /* Determine if we need special handling for SM */
-        if (HG_Core_addr_get_na_sm(hg_handle->handle.core_handle->info.addr) !=
-            NA_ADDR_NULL)
-            proc_flags |= HG_PROC_SM;
-#endif
-
-        /* Attempt to use eager bulk transfers when appropriate */
-        if (HG_HANDLE_CLASS(&hg_handle->handle)->bulk_eager &&
-            !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr))
-            proc_flags |= HG_PROC_BULK_EAGER;
+        /* Reset proc flags, extra bulk handle is not part of the payload
+         * checksum */
+        proc_flags =
+            HG_PROC_NO_CHECKSUM | hg_set_struct_target_flags(hg_handle);
 
         hg_proc_set_flags(proc, proc_flags);
 
@@ -700,9 +1660,153 @@ hg_set_struct(struct hg_private_handle *hg_handle,
     *payload_size = buf_size;
 #else
     /* Only send the actual size of the data, not the entire buffer */
-    *payload_size = hg_proc_get_size_used(proc) + header_offset;
+    *payload_size =
+        (comp_size ? comp_size : hg_proc_get_size_used(proc)) + header_offset;
+#endif
+
+done:
+    /* Pooled buffer was not consumed */
+    if (hg_extra_buf)
+        hg_extra_pool_put(HG_HANDLE_CLASS(&hg_handle->handle), hg_extra_buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifndef HG_HAS_XDR
+static hg_return_t
+hg_compress_payload(const struct hg_codec *codec, const void *payload,
+    hg_size_t payload_size, void *buf, hg_size_t buf_size,
+    hg_size_t *comp_size)
+{
+    void *tmp_buf = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    *comp_size = 0;
+
+    /* Header sizes are 32-bit */
+    if (payload_size == 0 || payload_size > UINT32_MAX)
+        goto done;
+
+    /* Payload must be moved out of the way if it was encoded into buf */
+    if (payload == buf) {
+        tmp_buf = malloc((size_t) payload_size);
+        HG_CHECK_ERROR(tmp_buf == NULL, done, ret, HG_NOMEM,
+            "Could not allocate compression buffer");
+        memcpy(tmp_buf, payload, (size_t) payload_size);
+        payload = tmp_buf;
+    }
+
+    /* Only keep compressed data if it is smaller */
+    *comp_size = (buf_size < payload_size) ? buf_size : payload_size - 1;
+    ret = codec->compress(buf, comp_size, payload, payload_size);
+    if (ret == HG_OVERFLOW) {
+        /* Not compressible, restore original payload */
+        if (tmp_buf)
+            memcpy(buf, tmp_buf, (size_t) payload_size);
+        *comp_size = 0;
+        ret = HG_SUCCESS;
+    }
+    HG_CHECK_HG_ERROR(done, ret, "Could not compress payload");
+
+done:
+    free(tmp_buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_decompress_payload(const struct hg_codec *codec, const void *buf,
+    hg_size_t buf_size, const struct hg_header_comp *hg_header_comp,
+    void **payload, hg_size_t *payload_size)
+{
+    hg_size_t orig_size = hg_header_comp->orig_size;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(codec == NULL, error, ret, HG_PROTOCOL_ERROR,
+        "Received compressed payload but no codec was set");
+    HG_CHECK_ERROR(hg_header_comp->size > buf_size, error, ret,
+        HG_PROTOCOL_ERROR, "Compressed payload size exceeds buffer size");
+
+    *payload = hg_mem_aligned_alloc(
+        (size_t) hg_mem_get_page_size(), (size_t) orig_size);
+    HG_CHECK_ERROR(*payload == NULL, error, ret, HG_NOMEM,
+        "Could not allocate decompression buffer");
+    *payload_size = orig_size;
+
+    ret = codec->decompress(
+        *payload, payload_size, buf, (hg_size_t) hg_header_comp->size);
+    HG_CHECK_HG_ERROR(error, ret, "Could not decompress payload");
+    HG_CHECK_ERROR(*payload_size != orig_size, error, ret, HG_PROTOCOL_ERROR,
+        "Decompressed size (%zu) does not match expected size (%zu)",
+        *payload_size, orig_size);
+
+    return ret;
+
+error:
+    hg_mem_aligned_free(*payload);
+    *payload = NULL;
+    *payload_size = 0;
+
+    return ret;
+}
 #endif
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_proc_struct(struct hg_private_handle *hg_handle, hg_op_t op, hg_proc_t proc,
+    hg_proc_cb_t proc_cb, void *struct_ptr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (op == HG_INPUT &&
+        (hg_handle->hg_header.msg.input.flags & HG_HEADER_RESP_BULK)) {
+        /* Input may be decoded more than once */
+        if (hg_proc_get_op(proc) == HG_DECODE &&
+            hg_handle->resp_bulk != HG_BULK_NULL) {
+            HG_Bulk_free(hg_handle->resp_bulk);
+            hg_handle->resp_bulk = HG_BULK_NULL;
+        }
+
+        ret = hg_proc_hg_bulk_t(proc, &hg_handle->resp_bulk);
+        HG_CHECK_HG_ERROR(done, ret, "Could not process response bulk handle");
+
+        /* Arena releases its reference when input is freed, the handle keeps
+         * its own until it is reset */
+        if (hg_proc_get_op(proc) == HG_DECODE && HG_PROC_IS_ARENA(proc) &&
+            hg_handle->resp_bulk != HG_BULK_NULL) {
+            ret = HG_Bulk_ref_incr(hg_handle->resp_bulk);
+            HG_CHECK_HG_ERROR(
+                done, ret, "Could not take reference to response bulk handle");
+        }
+    }
+
+    ret = proc_cb(proc, struct_ptr);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_get_resp_payload(struct hg_private_handle *hg_handle, hg_size_t resp_size,
+    void **buf_ptr, hg_size_t *buf_size_ptr)
+{
+    hg_uint32_t count = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(hg_handle->resp_bulk == HG_BULK_NULL, done, ret,
+        HG_PROTOCOL_ERROR, "Output was written to a missing response buffer");
+    HG_CHECK_ERROR(resp_size > HG_Bulk_get_size(hg_handle->resp_bulk), done,
+        ret, HG_PROTOCOL_ERROR, "Output exceeds response buffer size");
+
+    ret = HG_Bulk_access(hg_handle->resp_bulk, 0, resp_size,
+        HG_BULK_READWRITE, 1, buf_ptr, buf_size_ptr, &count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not access response buffer");
+    HG_CHECK_ERROR(count != 1, done, ret, HG_PROTOCOL_ERROR,
+        "Response buffer is not contiguous");
+
 done:
     return ret;
 }
@@ -750,7 +1854,13 @@ hg_free_struct(struct hg_private_handle *hg_handle,
     HG_CHECK_ERROR(proc_cb == NULL, done, ret, HG_FAULT,
         "No proc set, proc must be set in HG_Register()");
 
-#ifdef HG_HAS_XDR
+    /* Release everything that was decoded at once */
+    if (HG_HANDLE_CLASS(&hg_handle->handle)->decode_arena) {
+        hg_proc_arena_reset(proc);
+        goto destroy;
+    }
+
+#ifdef HG_HAS_XDR
     /* Include our own header offset */
     buf = (char *) buf + header_offset;
     buf_size -= header_offset;
@@ -760,10 +1870,15 @@ hg_free_struct(struct hg_private_handle *hg_handle,
     ret = hg_proc_reset(proc, buf, buf_size, HG_FREE);
     HG_CHECK_HG_ERROR(done, ret, "Could not reset proc");
 
+    /* Borrowed data must not be freed */
+    if (HG_HANDLE_CLASS(&hg_handle->handle)->decode_borrow)
+        hg_proc_set_flags(proc, HG_PROC_BORROW);
+
     /* Free memory allocated during decode operation */
     ret = proc_cb(proc, struct_ptr);
     HG_CHECK_HG_ERROR(done, ret, "Could not free allocated parameters");
 
+destroy:
     /* Decrement ref count or free */
     ret = HG_Core_destroy(hg_handle->handle.core_handle);
     HG_CHECK_HG_ERROR(done, ret, "Could not decrement handle ref count");
@@ -786,6 +1901,7 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
     hg_size_t header_offset = hg_header_get_size(op);
     hg_size_t page_size = (hg_size_t) hg_mem_get_page_size();
     hg_bulk_t local_handle = HG_BULK_NULL;
+    struct hg_extra_buf **extra_pool_buf;
     hg_return_t ret = HG_SUCCESS;
 
     switch (op) {
@@ -802,6 +1918,7 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
             extra_buf = &hg_handle->in_extra_buf;
             extra_buf_size = &hg_handle->in_extra_buf_size;
             extra_bulk = &hg_handle->in_extra_bulk;
+            extra_pool_buf = &hg_handle->in_extra_pool_buf;
             break;
         case HG_OUTPUT:
             /* Use custom header offset */
@@ -816,6 +1933,7 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
             extra_buf = &hg_handle->out_extra_buf;
             extra_buf_size = &hg_handle->out_extra_buf_size;
             extra_bulk = &hg_handle->out_extra_bulk;
+            extra_pool_buf = &hg_handle->out_extra_pool_buf;
             break;
         default:
             HG_GOTO_ERROR(done, ret, HG_INVALID_ARG, "Invalid HG op");
@@ -828,6 +1946,9 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
     ret = hg_proc_reset(proc, buf, buf_size, HG_DECODE);
     HG_CHECK_HG_ERROR(done, ret, "Could not reset proc");
 
+    /* Extra bulk handle is not part of the payload checksum */
+    hg_proc_set_flags(proc, HG_PROC_NO_CHECKSUM);
+
     /* Decode extra bulk handle */
     ret = hg_proc_hg_bulk_t(proc, extra_bulk);
     HG_CHECK_HG_ERROR(done, ret, "Could not process extra bulk handle");
@@ -835,15 +1956,30 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
     ret = hg_proc_flush(proc);
     HG_CHECK_HG_ERROR(done, ret, "Error in proc flush");
 
-    /* Create a new local handle to read the data */
+    /* Use a registered buffer from the pool to read the data if possible */
     *extra_buf_size = HG_Bulk_get_size(*extra_bulk);
-    *extra_buf = hg_mem_aligned_alloc(page_size, *extra_buf_size);
-    HG_CHECK_ERROR(*extra_buf == NULL, done, ret, HG_NOMEM,
-        "Could not allocate extra payload buffer");
+    ret = hg_extra_mem_acquire(hg_handle, *extra_buf_size);
+    HG_CHECK_HG_ERROR(done, ret, "Could not account for extra payload");
+
+    *extra_pool_buf = hg_extra_pool_get(HG_HANDLE_CLASS(&hg_handle->handle),
+        HG_EXTRA_POOL_READWRITE, *extra_buf_size);
+    if (*extra_pool_buf) {
+        *extra_buf = (*extra_pool_buf)->buf;
+        local_handle = (*extra_pool_buf)->bulk;
+
+        /* Local handle reference is released once transfer is posted */
+        ret = HG_Bulk_ref_incr(local_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not increment bulk handle ref");
+    } else {
+        /* Create a new local handle to read the data */
+        *extra_buf = hg_mem_aligned_alloc(page_size, *extra_buf_size);
+        HG_CHECK_ERROR(*extra_buf == NULL, done, ret, HG_NOMEM,
+            "Could not allocate extra payload buffer");
 
-    ret = HG_Bulk_create(hg_handle->handle.info.hg_class, 1, extra_buf,
-        extra_buf_size, HG_BULK_READWRITE, &local_handle);
-    HG_CHECK_HG_ERROR(done, ret, "Could not create HG bulk handle");
+        ret = HG_Bulk_create(hg_handle->handle.info.hg_class, 1, extra_buf,
+            extra_buf_size, HG_BULK_READWRITE, &local_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not create HG bulk handle");
+    }
 
     /* Read bulk data here and wait for the data to be here  */
     hg_handle->extra_bulk_transfer_cb = done_cb;
@@ -879,325 +2015,2371 @@ done:
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-hg_free_extra_payload(struct hg_private_handle *hg_handle)
+static hg_return_t
+hg_put_resp_payload(struct hg_private_handle *hg_handle,
+    hg_size_t payload_size, hg_bool_t *pushed)
 {
-    /* Free extra bulk buf if there was any */
-    if (hg_handle->in_extra_buf) {
-        HG_Bulk_free(hg_handle->in_extra_bulk);
-        hg_handle->in_extra_bulk = HG_BULK_NULL;
-        hg_mem_aligned_free(hg_handle->in_extra_buf);
-        hg_handle->in_extra_buf = NULL;
-        hg_handle->in_extra_buf_size = 0;
-    }
+    hg_core_handle_t core_handle = hg_handle->handle.core_handle;
+    const struct hg_core_info *hg_core_info = HG_Core_get_info(core_handle);
+    hg_return_t ret = HG_SUCCESS;
 
-    if (hg_handle->out_extra_buf) {
-        HG_Bulk_free(hg_handle->out_extra_bulk);
-        hg_handle->out_extra_bulk = HG_BULK_NULL;
-        hg_mem_aligned_free(hg_handle->out_extra_buf);
-        hg_handle->out_extra_buf = NULL;
-        hg_handle->out_extra_buf_size = 0;
+    *pushed = HG_FALSE;
+
+    /* Payload must fit into the response buffer and the header field */
+    if (hg_handle->resp_bulk == HG_BULK_NULL ||
+        hg_handle->out_extra_bulk == HG_BULK_NULL ||
+        HG_Core_addr_is_self(hg_core_info->addr) ||
+        hg_handle->out_extra_buf_size > UINT32_MAX ||
+        hg_handle->out_extra_buf_size > HG_Bulk_get_size(hg_handle->resp_bulk))
+        goto done;
+
+    /* Keep payload size to fall back to a regular response */
+    hg_handle->out_payload_size = payload_size;
+
+    /* Handle must remain valid until the transfer completes */
+    HG_Core_ref_incr(core_handle);
+
+    ret = HG_Bulk_transfer_id(hg_handle->handle.info.context,
+        hg_put_resp_payload_cb, hg_handle, HG_BULK_PUSH,
+        (hg_addr_t) hg_core_info->addr, hg_core_info->context_id,
+        hg_handle->resp_bulk, 0, hg_handle->out_extra_bulk, 0,
+        hg_handle->out_extra_buf_size, HG_OP_ID_IGNORE);
+    if (ret != HG_SUCCESS) {
+        HG_Core_destroy(core_handle);
+        HG_GOTO_ERROR(done, ret, ret, "Could not transfer response payload");
     }
+
+    *pushed = HG_TRUE;
+
+done:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_forward_cb(const struct hg_core_cb_info *callback_info)
+static hg_return_t
+hg_put_resp_payload_cb(const struct hg_cb_info *callback_info)
 {
     struct hg_private_handle *hg_handle =
         (struct hg_private_handle *) callback_info->arg;
+    hg_core_handle_t core_handle = hg_handle->handle.core_handle;
+    struct hg_header *hg_header = &hg_handle->hg_header;
+    hg_size_t payload_size = hg_handle->out_payload_size;
+    hg_uint8_t flags = HG_CORE_MORE_DATA;
+    void *buf;
+    hg_size_t buf_size;
     hg_return_t ret = HG_SUCCESS;
 
-    /* Execute callback */
-    if (hg_handle->forward_cb) {
-        struct hg_cb_info hg_cb_info;
+    /* Only the header is sent, otherwise let origin pull the payload, whose
+     * bulk descriptor is still encoded in the output buffer */
+    if (callback_info->ret == HG_SUCCESS &&
+        HG_Core_get_output(core_handle, &buf, &buf_size) == HG_SUCCESS) {
+        hg_header->msg.output.resp_size =
+            (hg_uint32_t) hg_handle->out_extra_buf_size;
+        if (hg_header_proc(HG_ENCODE, buf, buf_size, hg_header) ==
+            HG_SUCCESS) {
+            payload_size = hg_header_get_size(HG_OUTPUT) +
+                           hg_handle->handle.info.hg_class->out_offset;
+            flags = 0;
+        }
+    }
 
-        hg_cb_info.arg = hg_handle->forward_arg;
-        hg_cb_info.ret = callback_info->ret;
-        hg_cb_info.type = callback_info->type;
-        hg_cb_info.info.forward.handle = (hg_handle_t) hg_handle;
+    ret = HG_Core_respond(
+        core_handle, hg_core_respond_cb, hg_handle, flags, payload_size);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not respond (%s)", HG_Error_to_string(ret));
 
-        hg_handle->forward_cb(&hg_cb_info);
-    }
+done:
+    /* Release reference taken when transfer was posted */
+    HG_Core_destroy(core_handle);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_respond_cb(const struct hg_core_cb_info *callback_info)
+static void
+hg_prefetch_start(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info)
 {
-    struct hg_private_handle *hg_handle =
-        (struct hg_private_handle *) callback_info->arg;
-    hg_return_t ret = HG_SUCCESS;
+    const struct hg_core_info *hg_core_info =
+        HG_Core_get_info(hg_handle->handle.core_handle);
+    struct hg_prefetch *hg_prefetch = &hg_handle->prefetch;
+    struct hg_proc_info prefetch_info = *hg_proc_info;
+    hg_bulk_t origin_bulk = HG_BULK_NULL;
+    hg_size_t size;
+    hg_return_t ret;
 
-    /* Execute callback */
-    if (hg_handle->respond_cb) {
-        struct hg_cb_info hg_cb_info;
+    /* Decode bulk handle from a prefix of the input */
+    prefetch_info.in_proc_cb = hg_proc_info->prefetch_proc_cb;
+    prefetch_info.no_checksum = HG_TRUE;
+    ret = hg_get_struct(hg_handle, &prefetch_info, HG_INPUT, &origin_bulk);
+    HG_CHECK_HG_ERROR(done, ret, "Could not decode bulk handle to prefetch");
 
-        hg_cb_info.arg = hg_handle->respond_arg;
-        hg_cb_info.ret = callback_info->ret;
-        hg_cb_info.type = callback_info->type;
-        hg_cb_info.info.respond.handle = (hg_handle_t) hg_handle;
+    /* Keep origin handle once partial input is freed */
+    if (origin_bulk != HG_BULK_NULL &&
+        HG_Bulk_ref_incr(origin_bulk) == HG_SUCCESS)
+        hg_prefetch->origin_bulk = origin_bulk;
 
-        hg_handle->respond_cb(&hg_cb_info);
+    ret = hg_free_struct(hg_handle, &prefetch_info, HG_INPUT, &origin_bulk);
+    HG_CHECK_HG_ERROR(error, ret, "Could not free bulk handle to prefetch");
+
+    if (hg_prefetch->origin_bulk == HG_BULK_NULL)
+        goto done;
+    size = HG_Bulk_get_size(hg_prefetch->origin_bulk);
+
+    /* Pull into a registered buffer from the pool if possible */
+    hg_prefetch->pool_buf = hg_extra_pool_get(
+        HG_HANDLE_CLASS(&hg_handle->handle), HG_EXTRA_POOL_READWRITE, size);
+    if (hg_prefetch->pool_buf) {
+        hg_prefetch->local_bulk = hg_prefetch->pool_buf->bulk;
+
+        ret = HG_Bulk_ref_incr(hg_prefetch->local_bulk);
+        HG_CHECK_HG_ERROR(error, ret, "Could not increment bulk handle ref");
+    } else {
+        hg_prefetch->buf =
+            hg_mem_aligned_alloc((hg_size_t) hg_mem_get_page_size(), size);
+        HG_CHECK_ERROR(hg_prefetch->buf == NULL, error, ret, HG_NOMEM,
+            "Could not allocate prefetch buffer");
+
+        ret = HG_Bulk_create(hg_handle->handle.info.hg_class, 1,
+            &hg_prefetch->buf, &size, HG_BULK_READWRITE,
+            &hg_prefetch->local_bulk);
+        HG_CHECK_HG_ERROR(error, ret, "Could not create HG bulk handle");
     }
 
-    return ret;
+    hg_atomic_set32(&hg_prefetch->status, HG_PREFETCH_INFLIGHT);
+
+    /* Handle must remain valid until the transfer completes */
+    HG_Core_ref_incr(hg_handle->handle.core_handle);
+
+    ret = HG_Bulk_transfer_id(hg_handle->handle.info.context, hg_prefetch_cb,
+        hg_handle, HG_BULK_PULL, (hg_addr_t) hg_core_info->addr,
+        hg_core_info->context_id, hg_prefetch->origin_bulk, 0,
+        hg_prefetch->local_bulk, 0, size, HG_OP_ID_IGNORE);
+    if (ret != HG_SUCCESS) {
+        HG_Core_destroy(hg_handle->handle.core_handle);
+        HG_GOTO_ERROR(error, ret, ret, "Could not transfer bulk data");
+    }
+
+done:
+    return;
+
+error:
+    /* RPC callback pulls the data itself */
+    hg_prefetch_free(hg_handle);
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Version_get(unsigned int *major, unsigned int *minor, unsigned int *patch)
+static hg_return_t
+hg_prefetch_cb(const struct hg_cb_info *callback_info)
 {
-    hg_return_t ret = HG_SUCCESS;
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) callback_info->arg;
+    struct hg_prefetch *hg_prefetch = &hg_handle->prefetch;
 
-    if (major)
-        *major = HG_VERSION_MAJOR;
-    if (minor)
-        *minor = HG_VERSION_MINOR;
-    if (patch)
-        *patch = HG_VERSION_PATCH;
+    hg_prefetch->ret = callback_info->ret;
 
-    return ret;
+    /* Execute user callback if it was set while transfer was in flight */
+    if (!hg_atomic_cas32(
+            &hg_prefetch->status, HG_PREFETCH_INFLIGHT, HG_PREFETCH_DONE)) {
+        hg_atomic_set32(&hg_prefetch->status, HG_PREFETCH_DONE);
+        hg_prefetch_complete(hg_handle);
+    }
+
+    /* Release reference taken when transfer was posted */
+    HG_Core_destroy(hg_handle->handle.core_handle);
+
+    return HG_SUCCESS;
 }
 
 /*---------------------------------------------------------------------------*/
-const char *
-HG_Error_to_string(hg_return_t errnum)
+static void
+hg_prefetch_complete(struct hg_private_handle *hg_handle)
 {
-    return hg_return_name[errnum];
+    struct hg_prefetch *hg_prefetch = &hg_handle->prefetch;
+    struct hg_cb_info hg_cb_info;
+
+    hg_cb_info.arg = hg_prefetch->arg;
+    hg_cb_info.ret = hg_prefetch->ret;
+    hg_cb_info.type = HG_CB_BULK;
+    hg_cb_info.info.bulk.origin_handle = hg_prefetch->origin_bulk;
+    hg_cb_info.info.bulk.local_handle = hg_prefetch->local_bulk;
+    hg_cb_info.info.bulk.op = HG_BULK_PULL;
+
+    if (hg_prefetch->callback)
+        hg_prefetch->callback(&hg_cb_info);
 }
 
 /*---------------------------------------------------------------------------*/
-hg_class_t *
-HG_Init(const char *na_info_string, hg_bool_t na_listen)
+static void
+hg_prefetch_free(struct hg_private_handle *hg_handle)
 {
-    return HG_Init_opt(na_info_string, na_listen, NULL);
+    struct hg_prefetch *hg_prefetch = &hg_handle->prefetch;
+
+    if (hg_prefetch->origin_bulk != HG_BULK_NULL) {
+        HG_Bulk_free(hg_prefetch->origin_bulk);
+        hg_prefetch->origin_bulk = HG_BULK_NULL;
+    }
+    if (hg_prefetch->local_bulk != HG_BULK_NULL) {
+        HG_Bulk_free(hg_prefetch->local_bulk);
+        hg_prefetch->local_bulk = HG_BULK_NULL;
+    }
+    if (hg_prefetch->pool_buf) {
+        hg_extra_pool_put(HG_HANDLE_CLASS(&hg_handle->handle),
+            hg_prefetch->pool_buf);
+        hg_prefetch->pool_buf = NULL;
+    }
+    if (hg_prefetch->buf) {
+        hg_mem_aligned_free(hg_prefetch->buf);
+        hg_prefetch->buf = NULL;
+    }
+    hg_prefetch->callback = NULL;
+    hg_prefetch->arg = NULL;
+    hg_atomic_set32(&hg_prefetch->status, HG_PREFETCH_NONE);
 }
 
 /*---------------------------------------------------------------------------*/
-hg_class_t *
-HG_Init_opt(const char *na_info_string, hg_bool_t na_listen,
-    const struct hg_init_info *hg_init_info)
+static hg_return_t
+hg_extra_mem_acquire(struct hg_private_handle *hg_handle, hg_size_t size)
 {
-    struct hg_private_class *hg_class = NULL;
+    hg_core_context_t *core_context =
+        hg_handle->handle.info.context->core_context;
+    hg_return_t ret;
 
-    /* Make sure error return codes match */
-    assert(HG_CANCELED == (hg_return_t) NA_CANCELED);
+    ret = hg_core_context_mem_acquire(core_context, HG_MEM_USE_OVERFLOW, size);
+    if (ret == HG_SUCCESS)
+        hg_handle->extra_mem_size += size;
 
-    hg_class = malloc(sizeof(struct hg_private_class));
-    HG_CHECK_ERROR_NORET(
-        hg_class == NULL, error, "Could not allocate HG class");
+    return ret;
+}
 
-    memset(hg_class, 0, sizeof(struct hg_private_class));
-    hg_thread_spin_init(&hg_class->register_lock);
+/*---------------------------------------------------------------------------*/
+static void
+hg_free_extra_payload(struct hg_private_handle *hg_handle)
+{
+    struct hg_private_class *hg_class = HG_HANDLE_CLASS(&hg_handle->handle);
 
-    /* Save bulk eager information */
-    if (hg_init_info) {
-        hg_class->bulk_eager = !hg_init_info->no_bulk_eager;
-    } else {
-        hg_class->bulk_eager = HG_TRUE;
+    if (hg_handle->extra_mem_size) {
+        hg_core_context_mem_release(
+            hg_handle->handle.info.context->core_context, HG_MEM_USE_OVERFLOW,
+            hg_handle->extra_mem_size);
+        hg_handle->extra_mem_size = 0;
     }
 
-    hg_class->hg_class.core_class =
-        HG_Core_init_opt(na_info_string, na_listen, hg_init_info);
-    HG_CHECK_ERROR_NORET(hg_class->hg_class.core_class == NULL, error,
-        "Could not create HG core class");
-
-    /* Set more data callback */
-    HG_Core_set_more_data_callback(
-        hg_class->hg_class.core_class, hg_more_data_cb, hg_more_data_free_cb);
-
-    return (hg_class_t *) hg_class;
+    /* Free extra bulk buf if there was any, pooled buffers keep their own
+     * bulk handle */
+    if (hg_handle->in_extra_buf) {
+        if (hg_handle->in_extra_pool_buf) {
+            if (hg_handle->in_extra_bulk != hg_handle->in_extra_pool_buf->bulk)
+                HG_Bulk_free(hg_handle->in_extra_bulk);
+            hg_extra_pool_put(hg_class, hg_handle->in_extra_pool_buf);
+            hg_handle->in_extra_pool_buf = NULL;
+        } else {
+            HG_Bulk_free(hg_handle->in_extra_bulk);
+            hg_mem_aligned_free(hg_handle->in_extra_buf);
+        }
+        hg_handle->in_extra_bulk = HG_BULK_NULL;
+        hg_handle->in_extra_buf = NULL;
+        hg_handle->in_extra_buf_size = 0;
+    }
 
-error:
-    if (hg_class) {
-        hg_thread_spin_destroy(&hg_class->register_lock);
-        free(hg_class);
+    if (hg_handle->out_extra_buf) {
+        if (hg_handle->out_extra_pool_buf) {
+            if (hg_handle->out_extra_bulk !=
+                hg_handle->out_extra_pool_buf->bulk)
+                HG_Bulk_free(hg_handle->out_extra_bulk);
+            hg_extra_pool_put(hg_class, hg_handle->out_extra_pool_buf);
+            hg_handle->out_extra_pool_buf = NULL;
+        } else {
+            HG_Bulk_free(hg_handle->out_extra_bulk);
+            hg_mem_aligned_free(hg_handle->out_extra_buf);
+        }
+        hg_handle->out_extra_bulk = HG_BULK_NULL;
+        hg_handle->out_extra_buf = NULL;
+        hg_handle->out_extra_buf_size = 0;
     }
-    return NULL;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Finalize(hg_class_t *hg_class)
+static struct hg_extra_buf *
+hg_extra_pool_get(
+    struct hg_private_class *hg_class, unsigned int type, hg_size_t size)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
-    hg_return_t ret = HG_SUCCESS;
+    struct hg_extra_pool *hg_extra_pool = &hg_class->extra_pool;
+    struct hg_extra_buf *hg_extra_buf = NULL;
+    unsigned int size_class = 0;
+    hg_size_t buf_size;
+    hg_return_t ret;
 
-    ret = HG_Core_finalize(private_class->hg_class.core_class);
-    HG_CHECK_HG_ERROR(done, ret, "Could not finalize HG core class");
+    /* Round up to power of two size class */
+    while (HG_EXTRA_POOL_CLASS_SIZE(size_class) < size)
+        if (++size_class == HG_EXTRA_POOL_CLASS_COUNT)
+            goto done;
+    buf_size = HG_EXTRA_POOL_CLASS_SIZE(size_class);
+
+    hg_thread_spin_lock(&hg_extra_pool->lock);
+    hg_extra_buf = hg_extra_pool->heads[type][size_class];
+    if (hg_extra_buf) {
+        hg_extra_pool->heads[type][size_class] = hg_extra_buf->next;
+        hg_extra_pool->counts[type][size_class]--;
+    }
+    hg_thread_spin_unlock(&hg_extra_pool->lock);
 
-    hg_thread_spin_destroy(&private_class->register_lock);
-    free(private_class);
+    if (hg_extra_buf) {
+        /* Expose the entire buffer again */
+        ret = hg_bulk_set_size(hg_extra_buf->bulk, buf_size);
+        HG_CHECK_HG_ERROR(error, ret, "Could not reset bulk handle size");
+        goto done;
+    }
+
+    /* Nothing to re-use, register a new buffer */
+    hg_extra_buf = (struct hg_extra_buf *) malloc(sizeof(*hg_extra_buf));
+    HG_CHECK_ERROR_NORET(
+        hg_extra_buf == NULL, done, "Could not allocate extra buffer entry");
+    hg_extra_buf->next = NULL;
+    hg_extra_buf->bulk = HG_BULK_NULL;
+    hg_extra_buf->type = type;
+    hg_extra_buf->size_class = size_class;
+
+    hg_extra_buf->buf =
+        hg_mem_aligned_alloc((size_t) hg_mem_get_page_size(), buf_size);
+    HG_CHECK_ERROR_NORET(
+        hg_extra_buf->buf == NULL, error, "Could not allocate extra buffer");
+
+    ret = HG_Bulk_create((hg_class_t *) hg_class, 1, &hg_extra_buf->buf,
+        &buf_size,
+        (type == HG_EXTRA_POOL_READ_ONLY) ? HG_BULK_READ_ONLY
+                                          : HG_BULK_READWRITE,
+        &hg_extra_buf->bulk);
+    HG_CHECK_HG_ERROR(error, ret, "Could not create HG bulk handle");
 
 done:
-    return ret;
+    return hg_extra_buf;
+
+error:
+    hg_extra_buf_free(hg_extra_buf);
+
+    return NULL;
 }
 
 /*---------------------------------------------------------------------------*/
-void
-HG_Cleanup(void)
+static void
+hg_extra_pool_put(
+    struct hg_private_class *hg_class, struct hg_extra_buf *hg_extra_buf)
 {
-    HG_Core_cleanup();
+    struct hg_extra_pool *hg_extra_pool = &hg_class->extra_pool;
+    unsigned int type = hg_extra_buf->type,
+                 size_class = hg_extra_buf->size_class;
+
+    hg_thread_spin_lock(&hg_extra_pool->lock);
+    if (hg_extra_pool->counts[type][size_class] < HG_EXTRA_POOL_CACHE_MAX) {
+        hg_extra_buf->next = hg_extra_pool->heads[type][size_class];
+        hg_extra_pool->heads[type][size_class] = hg_extra_buf;
+        hg_extra_pool->counts[type][size_class]++;
+        hg_extra_buf = NULL;
+    }
+    hg_thread_spin_unlock(&hg_extra_pool->lock);
+
+    /* Pool is full */
+    if (hg_extra_buf)
+        hg_extra_buf_free(hg_extra_buf);
 }
 
 /*---------------------------------------------------------------------------*/
-void
-HG_Set_log_level(const char *level)
+static void
+hg_extra_buf_free(struct hg_extra_buf *hg_extra_buf)
 {
-    hg_log_set_subsys_level(HG_SUBSYS_NAME_STRING, hg_log_name_to_level(level));
+    HG_Bulk_free(hg_extra_buf->bulk);
+    hg_mem_aligned_free(hg_extra_buf->buf);
+    free(hg_extra_buf);
 }
 
 /*---------------------------------------------------------------------------*/
-void
-HG_Set_log_subsys(const char *subsys)
+static void
+hg_extra_pool_finalize(struct hg_private_class *hg_class)
 {
-    hg_log_set_subsys(subsys);
+    struct hg_extra_pool *hg_extra_pool = &hg_class->extra_pool;
+    unsigned int i, j;
+
+    for (i = 0; i < HG_EXTRA_POOL_TYPE_COUNT; i++) {
+        for (j = 0; j < HG_EXTRA_POOL_CLASS_COUNT; j++) {
+            while (hg_extra_pool->heads[i][j]) {
+                struct hg_extra_buf *hg_extra_buf = hg_extra_pool->heads[i][j];
+
+                hg_extra_pool->heads[i][j] = hg_extra_buf->next;
+                hg_extra_buf_free(hg_extra_buf);
+            }
+            hg_extra_pool->counts[i][j] = 0;
+        }
+    }
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Class_set_handle_create_callback(hg_class_t *hg_class,
-    hg_return_t (*callback)(hg_handle_t, void *), void *arg)
+static hg_return_t
+hg_handler_coroutine_run(struct hg_private_class *hg_class, hg_rpc_cb_t rpc_cb,
+    hg_handle_t handle)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
+    struct hg_handler_coroutine *hg_handler_coroutine;
     hg_return_t ret = HG_SUCCESS;
+    int rc;
 
-    HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+    hg_thread_spin_lock(&hg_class->coroutine_lock);
+    hg_handler_coroutine = hg_class->coroutine_cache;
+    if (hg_handler_coroutine) {
+        hg_class->coroutine_cache = hg_handler_coroutine->next;
+        hg_class->coroutine_cache_count--;
+    }
+    hg_thread_spin_unlock(&hg_class->coroutine_lock);
+
+    if (!hg_handler_coroutine) {
+        hg_handler_coroutine = (struct hg_handler_coroutine *) calloc(
+            1, sizeof(*hg_handler_coroutine));
+        HG_CHECK_ERROR(hg_handler_coroutine == NULL, done, ret, HG_NOMEM,
+            "Could not allocate handler coroutine");
+        hg_handler_coroutine->hg_class = hg_class;
+        hg_thread_spin_init(&hg_handler_coroutine->lock);
+
+        hg_handler_coroutine->coroutine =
+            hg_coroutine_create(HG_COROUTINE_STACK_SIZE);
+        HG_CHECK_ERROR(hg_handler_coroutine->coroutine == NULL, error, ret,
+            HG_NOMEM, "Could not create coroutine");
+    }
 
-    private_class->handle_create = callback;
-    private_class->handle_create_arg = arg;
+    hg_handler_coroutine->rpc_cb = rpc_cb;
+    hg_handler_coroutine->handle = handle;
+    hg_handler_coroutine->await = NULL;
+    hg_handler_coroutine->waiting = HG_FALSE;
+
+    rc = hg_coroutine_start(hg_handler_coroutine->coroutine,
+        hg_handler_coroutine_entry, hg_handler_coroutine);
+    HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_FAULT,
+        "Could not start coroutine");
+
+    hg_handler_coroutine_resume(hg_handler_coroutine);
 
 done:
     return ret;
+
+error:
+    hg_coroutine_destroy(hg_handler_coroutine->coroutine);
+    hg_thread_spin_destroy(&hg_handler_coroutine->lock);
+    free(hg_handler_coroutine);
+
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_context_t *
-HG_Context_create(hg_class_t *hg_class)
+static void
+hg_handler_coroutine_entry(void *arg)
 {
-    return HG_Context_create_id(hg_class, 0);
+    struct hg_handler_coroutine *hg_handler_coroutine =
+        (struct hg_handler_coroutine *) arg;
+    hg_return_t ret;
+
+    ret = hg_handler_coroutine->rpc_cb(hg_handler_coroutine->handle);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+        "Error while executing RPC callback (%s)", HG_Error_to_string(ret));
 }
 
 /*---------------------------------------------------------------------------*/
-hg_context_t *
-HG_Context_create_id(hg_class_t *hg_class, hg_uint8_t id)
+static void
+hg_handler_coroutine_resume(struct hg_handler_coroutine *hg_handler_coroutine)
 {
-    struct hg_context *hg_context = NULL;
+    for (;;) {
+        hg_bool_t completed;
 
-    HG_CHECK_ERROR_NORET(hg_class == NULL, error, "NULL HG class");
+        (void) hg_coroutine_resume(hg_handler_coroutine->coroutine);
+        if (hg_coroutine_done(hg_handler_coroutine->coroutine)) {
+            hg_handler_coroutine_release(hg_handler_coroutine);
+            return;
+        }
 
-    hg_context = malloc(sizeof(struct hg_context));
-    HG_CHECK_ERROR_NORET(
-        hg_context == NULL, error, "Could not allocate HG context");
+        /* Callback yielded in HG_Await(), the completion callback resumes it
+         * unless the operation completed in the meantime. Waiting can only
+         * be set once the coroutine has been switched out. */
+        hg_thread_spin_lock(&hg_handler_coroutine->lock);
+        completed = hg_handler_coroutine->await->completed;
+        if (!completed)
+            hg_handler_coroutine->waiting = HG_TRUE;
+        hg_thread_spin_unlock(&hg_handler_coroutine->lock);
+        if (!completed)
+            return;
+    }
+}
 
-    memset(hg_context, 0, sizeof(struct hg_context));
-    hg_context->hg_class = hg_class;
-    hg_context->core_context =
-        HG_Core_context_create_id(hg_class->core_class, id);
-    HG_CHECK_ERROR_NORET(hg_context->core_context == NULL, error,
-        "Could not create context for ID %u", id);
+/*---------------------------------------------------------------------------*/
+static void
+hg_handler_coroutine_release(struct hg_handler_coroutine *hg_handler_coroutine)
+{
+    struct hg_private_class *hg_class = hg_handler_coroutine->hg_class;
+
+    hg_thread_spin_lock(&hg_class->coroutine_lock);
+    if (hg_class->coroutine_cache_count < HG_COROUTINE_CACHE_MAX) {
+        hg_handler_coroutine->next = hg_class->coroutine_cache;
+        hg_class->coroutine_cache = hg_handler_coroutine;
+        hg_class->coroutine_cache_count++;
+        hg_handler_coroutine = NULL;
+    }
+    hg_thread_spin_unlock(&hg_class->coroutine_lock);
 
-    /* Set handle create callback */
-    HG_Core_context_set_handle_create_callback(
-        hg_context->core_context, hg_handle_create_cb, hg_context);
+    if (hg_handler_coroutine) {
+        hg_coroutine_destroy(hg_handler_coroutine->coroutine);
+        hg_thread_spin_destroy(&hg_handler_coroutine->lock);
+        free(hg_handler_coroutine);
+    }
+}
 
-    /* If we are listening, start posting requests */
-    if (HG_Core_class_is_listening(hg_class->core_class)) {
-        hg_return_t ret = HG_Core_context_post(hg_context->core_context);
-        HG_CHECK_HG_ERROR(error, ret, "Could not post context requests (%s)",
+/*---------------------------------------------------------------------------*/
+static void
+hg_handler_coroutine_finalize(struct hg_private_class *hg_class)
+{
+    while (hg_class->coroutine_cache) {
+        struct hg_handler_coroutine *hg_handler_coroutine =
+            hg_class->coroutine_cache;
+
+        hg_class->coroutine_cache = hg_handler_coroutine->next;
+        hg_coroutine_destroy(hg_handler_coroutine->coroutine);
+        hg_thread_spin_destroy(&hg_handler_coroutine->lock);
+        free(hg_handler_coroutine);
+    }
+    hg_class->coroutine_cache_count = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_key_table_hash(hg_hash_table_key_t key)
+{
+    return (unsigned int) ((hg_key_t *) key)->hash;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_key_table_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return hg_key_equal((hg_key_t *) key1, (hg_key_t *) key2);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_key_table_init(struct hg_private_class *hg_class, hg_uint32_t max)
+{
+    struct hg_key_table *hg_key_table = &hg_class->key_table;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_key_table->table =
+        hg_hash_table_new_concurrent(hg_key_table_hash, hg_key_table_equal);
+    HG_CHECK_ERROR(hg_key_table->table == NULL, done, ret, HG_NOMEM,
+        "Could not allocate intern table");
+    /* Keys and strings are allocated together */
+    hg_hash_table_register_free_functions(hg_key_table->table, free, NULL);
+    hg_thread_mutex_init(&hg_key_table->lock);
+    hg_key_table->max = max;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_key_table_finalize(struct hg_private_class *hg_class)
+{
+    struct hg_key_table *hg_key_table = &hg_class->key_table;
+
+    if (!hg_key_table->table)
+        return;
+
+    hg_hash_table_free(hg_key_table->table);
+    hg_key_table->table = NULL;
+    hg_thread_mutex_destroy(&hg_key_table->lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_shards_start(struct hg_private_class *hg_class, hg_uint8_t shard_count)
+{
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint8_t i;
+
+    hg_class->shards =
+        (struct hg_shard *) calloc(shard_count, sizeof(struct hg_shard));
+    HG_CHECK_ERROR(hg_class->shards == NULL, error, ret, HG_NOMEM,
+        "Could not allocate shards");
+    hg_class->shard_count = shard_count;
+    hg_atomic_init32(&hg_class->shard_exit, 0);
+
+    for (i = 0; i < shard_count; i++) {
+        struct hg_shard *hg_shard = &hg_class->shards[i];
+        int rc;
+
+        /* Context ID is the shard ID that origins steer requests to */
+        hg_shard->context = HG_Context_create_id((hg_class_t *) hg_class, i);
+        HG_CHECK_ERROR(hg_shard->context == NULL, error, ret, HG_NOMEM,
+            "Could not create context for shard %u", i);
+        hg_shard->hg_class = hg_class;
+
+        rc = hg_thread_create(&hg_shard->thread, hg_shard_thread, hg_shard);
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+            "Could not create thread for shard %u", i);
+        hg_shard->started = HG_TRUE;
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+        {
+            na_int32_t numa_node = NA_Get_numa_node(
+                HG_Core_class_get_na(hg_class->hg_class.core_class));
+            hg_cpu_set_t cpu_mask, numa_mask;
+            int cpu = i;
+
+            /* Shards use the cores of the NUMA node of NA resources in turn */
+            if (numa_node >= 0 && hg_thread_get_numa_cpus((int) numa_node,
+                                      &numa_mask) == HG_UTIL_SUCCESS) {
+                int n = i % CPU_COUNT(&numa_mask);
+
+                for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                    if (CPU_ISSET(cpu, &numa_mask) && n-- == 0)
+                        break;
+            }
+
+            /* Each shard runs on its own core, failing is not fatal */
+            CPU_ZERO(&cpu_mask);
+            CPU_SET(cpu, &cpu_mask);
+            rc = hg_thread_setaffinity(hg_shard->thread, &cpu_mask);
+            HG_CHECK_WARNING(rc != HG_UTIL_SUCCESS,
+                "Could not pin thread of shard %u to core %d", i, cpu);
+        }
+#endif
+    }
+
+    return ret;
+
+error:
+    hg_shards_stop(hg_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_shards_stop(struct hg_private_class *hg_class)
+{
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint8_t i;
+
+    if (!hg_class->shards)
+        return ret;
+
+    hg_atomic_set32(&hg_class->shard_exit, 1);
+
+    for (i = 0; i < hg_class->shard_count; i++) {
+        struct hg_shard *hg_shard = &hg_class->shards[i];
+
+        if (hg_shard->started) {
+            int rc = hg_thread_join(hg_shard->thread);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_PROTOCOL_ERROR,
+                "Could not join thread of shard %u", i);
+            hg_shard->started = HG_FALSE;
+        }
+        if (hg_shard->context) {
+            ret = HG_Context_destroy(hg_shard->context);
+            HG_CHECK_HG_ERROR(done, ret,
+                "Could not destroy context of shard %u (%s)", i,
+                HG_Error_to_string(ret));
+            hg_shard->context = NULL;
+        }
+    }
+
+    free(hg_class->shards);
+    hg_class->shards = NULL;
+    hg_class->shard_count = 0;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_shard_thread(void *arg)
+{
+    struct hg_shard *hg_shard = (struct hg_shard *) arg;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+
+    while (!hg_atomic_get32(&hg_shard->hg_class->shard_exit)) {
+        unsigned int actual_count = 0;
+        hg_return_t ret;
+
+        do {
+            ret = HG_Trigger(hg_shard->context, 0, HG_SHARD_TRIGGER_COUNT,
+                &actual_count);
+        } while ((ret == HG_SUCCESS) && actual_count);
+        HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
+            "Could not trigger callbacks (%s)", HG_Error_to_string(ret));
+
+        ret = HG_Progress(hg_shard->context, HG_SHARD_PROGRESS_TIMEOUT);
+        HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
+            "Could not make progress (%s)", HG_Error_to_string(ret));
+    }
+
+done:
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+const char *
+hg_class_intern_key(hg_class_t *hg_class, const char *data, hg_uint32_t len,
+    hg_uint64_t hash)
+{
+    struct hg_key_table *hg_key_table =
+        &((struct hg_private_class *) hg_class)->key_table;
+    hg_key_t lookup_key = {data, hash, len, HG_FALSE}, *key;
+
+    if (!hg_key_table->table)
+        return NULL;
+
+    /* Most lookups are expected to hit, keys are never removed before the
+     * table is freed so that lookups do not need the lock */
+    key = (hg_key_t *) hg_hash_table_lookup(hg_key_table->table, &lookup_key);
+    if (key != HG_HASH_TABLE_NULL)
+        return key->data;
+
+    hg_thread_mutex_lock(&hg_key_table->lock);
+    key = (hg_key_t *) hg_hash_table_lookup(hg_key_table->table, &lookup_key);
+    if (key != HG_HASH_TABLE_NULL)
+        goto unlock;
+
+    /* Table is full, keys are decoded as usual */
+    if (hg_hash_table_num_entries(hg_key_table->table) >= hg_key_table->max) {
+        key = NULL;
+        goto unlock;
+    }
+
+    key = (hg_key_t *) malloc(sizeof(*key) + (size_t) len + 1);
+    HG_CHECK_ERROR_NORET(key == NULL, unlock, "Could not allocate key");
+    memcpy((char *) (key + 1), data, len);
+    ((char *) (key + 1))[len] = '\0';
+    key->data = (const char *) (key + 1);
+    key->hash = hash;
+    key->len = len;
+    key->is_owned = HG_FALSE;
+
+    if (!hg_hash_table_insert(hg_key_table->table, key, key)) {
+        HG_LOG_ERROR("Could not insert key into intern table");
+        free(key);
+        key = NULL;
+    }
+
+unlock:
+    hg_thread_mutex_unlock(&hg_key_table->lock);
+
+    return (key) ? key->data : NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_get_raw(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_op_t op, void **buf_ptr,
+    hg_size_t *buf_size_ptr)
+{
+    hg_core_handle_t core_handle = hg_handle->handle.core_handle;
+    struct hg_header *hg_header = &hg_handle->hg_header;
+    void *buf, **extra_buf;
+    hg_size_t buf_size, payload_size, *extra_buf_size;
+    hg_size_t header_offset = hg_header_get_size(op);
+    hg_bool_t swapped;
+#ifndef HG_HAS_XDR
+    struct hg_header_comp *hg_header_comp;
+#endif
+    hg_return_t ret = HG_SUCCESS;
+
+    if (op == HG_INPUT) {
+        ret = HG_Core_get_input(core_handle, &buf, &buf_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get input buffer");
+        ret = HG_Core_get_input_payload_size(core_handle, &payload_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get input payload size");
+        swapped = HG_Core_is_input_swapped(core_handle);
+        extra_buf = &hg_handle->in_extra_buf;
+        extra_buf_size = &hg_handle->in_extra_buf_size;
+#ifndef HG_HAS_XDR
+        hg_header_comp = &hg_header->msg.input.comp;
+#endif
+    } else {
+        HG_CHECK_ERROR(hg_proc_info->no_response, done, ret, HG_OPNOTSUPPORTED,
+            "No output was produced on that RPC (no response)");
+        ret = HG_Core_get_output(core_handle, &buf, &buf_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get output buffer");
+        ret = HG_Core_get_output_payload_size(core_handle, &payload_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get output payload size");
+        swapped = HG_Core_is_output_swapped(core_handle);
+        extra_buf = &hg_handle->out_extra_buf;
+        extra_buf_size = &hg_handle->out_extra_buf_size;
+#ifndef HG_HAS_XDR
+        hg_header_comp = &hg_header->msg.output.comp;
+#endif
+    }
+
+    /* Payload of a sender with a different byte order cannot be relayed */
+    HG_CHECK_ERROR(swapped, done, ret, HG_OPNOTSUPPORTED,
+        "Payload was encoded with a different byte order");
+
+    hg_header_reset(hg_header, op);
+    ret = hg_header_proc(HG_DECODE, buf, buf_size, hg_header);
+    HG_CHECK_HG_ERROR(done, ret, "Could not process header");
+
+    /* Response buffer of origin cannot be relayed along with the payload */
+    HG_CHECK_ERROR(op == HG_INPUT &&
+                       (hg_header->msg.input.flags & HG_HEADER_RESP_BULK),
+        done, ret, HG_OPNOTSUPPORTED,
+        "Payload is preceded by a response buffer descriptor");
+
+#ifndef HG_HAS_XDR
+    /* Compressed payload is expanded into the extra buffer */
+    if (*extra_buf == NULL && hg_header_comp->size != 0) {
+        ret = hg_extra_mem_acquire(hg_handle, hg_header_comp->orig_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not account for payload");
+
+        ret = hg_decompress_payload(hg_proc_info->codec,
+            (char *) buf + header_offset, buf_size - header_offset,
+            hg_header_comp, extra_buf, extra_buf_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not decompress payload");
+    }
+#endif
+
+    /* Payload that did not fit was already pulled into the extra buffer */
+    if (*extra_buf) {
+        *buf_ptr = *extra_buf;
+        *buf_size_ptr = *extra_buf_size;
+    } else if (op == HG_OUTPUT && hg_header->msg.output.resp_size != 0) {
+        ret = hg_get_resp_payload(
+            hg_handle, hg_header->msg.output.resp_size, buf_ptr, buf_size_ptr);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get response payload");
+    } else {
+        HG_CHECK_ERROR(payload_size < header_offset, done, ret,
+            HG_PROTOCOL_ERROR, "Payload is smaller than HG header");
+        *buf_ptr = (char *) buf + header_offset;
+        *buf_size_ptr = payload_size - header_offset;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_set_raw(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_op_t op, const void *raw_buf,
+    hg_size_t raw_buf_size, hg_size_t *payload_size)
+{
+    hg_core_handle_t core_handle = hg_handle->handle.core_handle;
+    struct hg_header *hg_header = &hg_handle->hg_header;
+    hg_proc_t proc;
+    void *buf, *payload;
+    hg_size_t buf_size, header_offset = hg_header_get_size(op), user_offset;
+#ifdef HG_HAS_CHECKSUMS
+    struct hg_header_hash *hg_header_hash;
+#endif
+    hg_return_t ret = HG_SUCCESS;
+
+    if (op == HG_INPUT) {
+        user_offset = hg_handle->handle.info.hg_class->in_offset;
+        proc = hg_handle->in_proc;
+#ifdef HG_HAS_CHECKSUMS
+        hg_header_hash = &hg_header->msg.input.hash;
+#endif
+        ret = HG_Core_get_input(core_handle, &buf, &buf_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get input buffer");
+    } else {
+        HG_CHECK_ERROR(hg_proc_info->no_response, done, ret, HG_OPNOTSUPPORTED,
+            "No output was produced on that RPC (no response)");
+        user_offset = hg_handle->handle.info.hg_class->out_offset;
+        proc = hg_handle->out_proc;
+#ifdef HG_HAS_CHECKSUMS
+        hg_header_hash = &hg_header->msg.output.hash;
+#endif
+        ret = HG_Core_get_output(core_handle, &buf, &buf_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get output buffer");
+    }
+    HG_CHECK_ERROR(raw_buf_size > buf_size - header_offset, done, ret,
+        HG_MSGSIZE, "Raw payload does not fit into buffer (%zu > %zu)",
+        (size_t) raw_buf_size, (size_t) (buf_size - header_offset));
+    HG_CHECK_ERROR(raw_buf_size < user_offset, done, ret, HG_INVALID_ARG,
+        "Raw payload is smaller than user header offset");
+
+    /* Nothing to copy if payload was encoded in place */
+    payload = (char *) buf + header_offset;
+    if (payload != raw_buf)
+        memcpy(payload, raw_buf, raw_buf_size);
+
+    /* Raw payload is sent as is, only its checksum is computed */
+    hg_header_reset(hg_header, op);
+    ret = hg_proc_reset(proc, (char *) payload + user_offset,
+        raw_buf_size - user_offset, HG_ENCODE);
+    HG_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+    hg_proc_set_flags(
+        proc, (hg_proc_info->no_checksum) ? HG_PROC_NO_CHECKSUM : 0);
+    if (raw_buf_size > user_offset) {
+        HG_CHECK_ERROR(
+            hg_proc_save_ptr(proc, raw_buf_size - user_offset) == NULL, done,
+            ret, HG_FAULT, "Could not skip raw payload");
+    }
+    ret = hg_proc_flush(proc);
+    HG_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+#ifdef HG_HAS_CHECKSUMS
+    if (!hg_proc_info->no_checksum) {
+        ret = hg_proc_checksum_get(
+            proc, &hg_header_hash->payload, sizeof(hg_header_hash->payload));
+        HG_CHECK_HG_ERROR(done, ret, "Error in getting proc checksum");
+    }
+#endif
+
+    ret = hg_header_proc(HG_ENCODE, buf, buf_size, hg_header);
+    HG_CHECK_HG_ERROR(done, ret, "Could not process header");
+
+#ifdef HG_HAS_XDR
+    /* XDR requires entire buffer payload */
+    *payload_size = buf_size;
+#else
+    *payload_size = raw_buf_size + header_offset;
+#endif
+
+    if (op == HG_INPUT)
+        hg_capture_forward(hg_handle, raw_buf_size - user_offset, 0);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_capture_forward(struct hg_private_handle *hg_handle, hg_size_t in_size,
+    hg_size_t bulk_size)
+{
+    if (!HG_HANDLE_CLASS(&hg_handle->handle)->capture)
+        return;
+
+    hg_handle->capture_ticks = hg_time_get_ticks();
+    hg_handle->capture_in_size = in_size;
+    hg_handle->capture_bulk_size = bulk_size;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_capture_forward_complete(
+    struct hg_private_handle *hg_handle, hg_return_t ret)
+{
+    struct hg_capture *capture = HG_HANDLE_CLASS(&hg_handle->handle)->capture;
+    const struct hg_info *hg_info = &hg_handle->handle.info;
+    struct hg_capture_record record;
+    char addr_string[256];
+    hg_size_t addr_string_size = sizeof(addr_string), out_size = 0;
+    hg_time_ticks_t now = hg_time_get_ticks();
+
+    memset(&record, 0, sizeof(record));
+    record.time = hg_capture_time(capture, hg_handle->capture_ticks);
+    record.id = hg_info->id;
+    record.bulk_size = hg_handle->capture_bulk_size;
+    record.in_size = (hg_uint32_t) hg_handle->capture_in_size;
+    if (ret == HG_SUCCESS &&
+        HG_Core_get_output_payload_size(hg_handle->handle.core_handle,
+            &out_size) == HG_SUCCESS)
+        record.out_size = (hg_uint32_t) out_size;
+
+    /* Targets are only told apart, not identified */
+    if (HG_Addr_to_string(hg_info->hg_class, addr_string, &addr_string_size,
+            hg_info->addr) == HG_SUCCESS)
+        record.target = (hg_uint32_t) hg_hash_string(addr_string);
+    record.duration = (hg_uint32_t)(
+        hg_time_ticks_to_ns(now - hg_handle->capture_ticks) / 1000);
+    record.target_id = (hg_uint8_t) hg_info->context_id;
+    record.ret = (hg_uint8_t) ret;
+
+    hg_capture_record(capture, &record);
+    hg_handle->capture_ticks = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_uint8_t
+hg_set_struct_target_flags(struct hg_private_handle *hg_handle)
+{
+    hg_uint8_t proc_flags = 0;
+
+#ifdef NA_HAS_SM
+    /* Determine if we need special handling for SM */
+    if (HG_Core_addr_get_na_sm(hg_handle->handle.core_handle->info.addr) !=
+        NA_ADDR_NULL)
+        proc_flags |= HG_PROC_SM;
+#endif
+
+    /* Attempt to use eager bulk transfers when appropriate */
+    if (HG_HANDLE_CLASS(&hg_handle->handle)->bulk_eager &&
+        !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr))
+        proc_flags |= HG_PROC_BULK_EAGER;
+
+    return proc_flags;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_hedge_set_input(struct hg_private_handle *hg_handle,
+    struct hg_private_handle *hedge_handle,
+    const struct hg_proc_info *hg_proc_info, void *in_struct,
+    hg_size_t *payload_size, hg_bool_t *more_data)
+{
+    void *buf, *hedge_buf;
+    hg_size_t buf_size, hedge_buf_size;
+    hg_return_t ret;
+
+    ret = HG_Core_get_input(hg_handle->handle.core_handle, &buf, &buf_size);
+    HG_CHECK_HG_ERROR(done, ret, "Could not get input buffer");
+
+    ret = HG_Core_get_input(
+        hedge_handle->handle.core_handle, &hedge_buf, &hedge_buf_size);
+    HG_CHECK_HG_ERROR(done, ret, "Could not get input buffer");
+
+    /* Extra payloads and response buffers are owned by a single handle, and
+     * SM or self targets encode bulk handles differently, encode input again
+     * in that case */
+    if (*more_data || *payload_size > hedge_buf_size ||
+        (hg_handle->hg_header.msg.input.flags & HG_HEADER_RESP_BULK) ||
+        hg_set_struct_target_flags(hg_handle) !=
+            hg_set_struct_target_flags(hedge_handle)) {
+        *more_data = HG_FALSE;
+        ret = hg_set_struct(hedge_handle, hg_proc_info, HG_INPUT, in_struct,
+            payload_size, more_data);
+        HG_CHECK_HG_ERROR(done, ret, "Could not set input");
+        goto done;
+    }
+
+    /* Encoded payload includes the HG header */
+    memcpy(hedge_buf, buf, *payload_size);
+    hedge_handle->hg_header = hg_handle->hg_header;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_hedge_forward_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_hedge *hedge = (struct hg_hedge *) callback_info->arg;
+
+    /* First success completes the call, failures are only reported once all
+     * forwards have failed */
+    if ((callback_info->ret == HG_SUCCESS ||
+            hg_atomic_incr32(&hedge->failed) ==
+                (hg_util_int32_t) hedge->count) &&
+        hg_atomic_cas32(&hedge->completed, 0, 1)) {
+        struct hg_cb_info hg_cb_info = *callback_info;
+        unsigned int i;
+
+        /* Forwards that are still pending are no longer needed, delayed ones
+         * have not been sent yet */
+        for (i = 0; i < hedge->count; i++) {
+            hg_return_t ret;
+
+            if (hedge->handles[i] == callback_info->info.forward.handle ||
+                HG_Core_addr_is_self(hedge->handles[i]->core_handle->info.addr))
+                continue;
+            ret = HG_Core_cancel(hedge->handles[i]->core_handle);
+            if (ret != HG_SUCCESS)
+                HG_LOG_DEBUG("Could not cancel hedged handle (%s)",
+                    HG_Error_to_string(ret));
+        }
+
+        if (hedge->callback) {
+            hg_cb_info.arg = hedge->arg;
+            hedge->callback(&hg_cb_info);
+        }
+    }
+
+    if (hg_atomic_decr32(&hedge->ref_count) == 0)
+        hg_hedge_release(hedge);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_hedge_release(struct hg_hedge *hedge)
+{
+    unsigned int i;
+
+    for (i = 0; i < hedge->count; i++) {
+        hg_return_t ret = HG_Destroy(hedge->handles[i]);
+        HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not destroy handle (%s)",
             HG_Error_to_string(ret));
     }
+    free(hedge);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_forward_cb(const struct hg_core_cb_info *callback_info)
+{
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) callback_info->arg;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (hg_handle->capture_ticks)
+        hg_capture_forward_complete(hg_handle, callback_info->ret);
+
+    /* Execute callback */
+    if (hg_handle->forward_cb) {
+        struct hg_cb_info hg_cb_info;
+
+        hg_cb_info.arg = hg_handle->forward_arg;
+        hg_cb_info.ret = callback_info->ret;
+        hg_cb_info.type = callback_info->type;
+        hg_cb_info.info.forward.handle = (hg_handle_t) hg_handle;
+
+        hg_handle->forward_cb(&hg_cb_info);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_chunk_cb(const struct hg_core_cb_info *callback_info)
+{
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) callback_info->arg;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Execute callback, chunks of plain forwards are dropped */
+    if (hg_handle->chunk_cb) {
+        struct hg_cb_info hg_cb_info;
+
+        hg_cb_info.arg = hg_handle->chunk_arg;
+        hg_cb_info.ret = callback_info->ret;
+        hg_cb_info.type = callback_info->type;
+        hg_cb_info.info.forward.handle = (hg_handle_t) hg_handle;
+
+        hg_handle->chunk_cb(&hg_cb_info);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_respond_cb(const struct hg_core_cb_info *callback_info)
+{
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) callback_info->arg;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Execute callback */
+    if (hg_handle->respond_cb) {
+        struct hg_cb_info hg_cb_info;
+
+        hg_cb_info.arg = hg_handle->respond_arg;
+        hg_cb_info.ret = callback_info->ret;
+        hg_cb_info.type = callback_info->type;
+        hg_cb_info.info.respond.handle = (hg_handle_t) hg_handle;
+
+        hg_handle->respond_cb(&hg_cb_info);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Version_get(unsigned int *major, unsigned int *minor, unsigned int *patch)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (major)
+        *major = HG_VERSION_MAJOR;
+    if (minor)
+        *minor = HG_VERSION_MINOR;
+    if (patch)
+        *patch = HG_VERSION_PATCH;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+const char *
+HG_Error_to_string(hg_return_t errnum)
+{
+    return hg_return_name[errnum];
+}
+
+/*---------------------------------------------------------------------------*/
+hg_class_t *
+HG_Init(const char *na_info_string, hg_bool_t na_listen)
+{
+    return HG_Init_opt(na_info_string, na_listen, NULL);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_class_t *
+HG_Init_opt(const char *na_info_string, hg_bool_t na_listen,
+    const struct hg_init_info *hg_init_info)
+{
+    struct hg_private_class *hg_class = NULL;
+
+    /* Make sure error return codes match */
+    assert(HG_CANCELED == (hg_return_t) NA_CANCELED);
+
+    hg_class = malloc(sizeof(struct hg_private_class));
+    HG_CHECK_ERROR_NORET(
+        hg_class == NULL, error, "Could not allocate HG class");
+
+    memset(hg_class, 0, sizeof(struct hg_private_class));
+    hg_thread_spin_init(&hg_class->register_lock);
+    hg_thread_spin_init(&hg_class->extra_pool.lock);
+    hg_thread_spin_init(&hg_class->coroutine_lock);
+
+    /* Save bulk eager information */
+    if (hg_init_info) {
+        hg_class->bulk_eager = !hg_init_info->no_bulk_eager;
+        hg_class->decode_borrow = hg_init_info->decode_borrow;
+        hg_class->decode_arena = hg_init_info->decode_arena;
+
+        if (hg_init_info->key_intern_max) {
+            hg_return_t ret =
+                hg_key_table_init(hg_class, hg_init_info->key_intern_max);
+            HG_CHECK_ERROR_NORET(
+                ret != HG_SUCCESS, error, "Could not initialize intern table");
+        }
+
+        if (hg_init_info->capture_file) {
+            hg_return_t ret = hg_capture_create(
+                hg_init_info->capture_file, &hg_class->capture);
+            HG_CHECK_HG_ERROR(error, ret, "Could not create capture file");
+        }
+    } else {
+        hg_class->bulk_eager = HG_TRUE;
+    }
+
+    hg_class->hg_class.core_class =
+        HG_Core_init_opt(na_info_string, na_listen, hg_init_info);
+    HG_CHECK_ERROR_NORET(hg_class->hg_class.core_class == NULL, error,
+        "Could not create HG core class");
+
+    /* Set more data callback */
+    HG_Core_set_more_data_callback(
+        hg_class->hg_class.core_class, hg_more_data_cb, hg_more_data_free_cb);
+
+    /* Targets must be able to relay collective operations */
+    {
+        hg_return_t ret = hg_collective_register((hg_class_t *) hg_class);
+        HG_CHECK_HG_ERROR(error, ret, "Could not register collective relay");
+    }
+
+    /* Remote tools may query stats of listening classes, the class itself
+     * may also query them through loopback */
+    if (hg_init_info && hg_init_info->introspect &&
+        (na_listen || !hg_init_info->no_loopback)) {
+        hg_return_t ret = hg_introspect_register((hg_class_t *) hg_class);
+        HG_CHECK_HG_ERROR(error, ret, "Could not register introspection RPC");
+    }
+
+    /* Serve RPCs from one context per shard */
+    if (hg_init_info && hg_init_info->shard_count > 0 && na_listen) {
+        hg_return_t ret = hg_shards_start(hg_class, hg_init_info->shard_count);
+        HG_CHECK_HG_ERROR(error, ret, "Could not start shards (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    return (hg_class_t *) hg_class;
+
+error:
+    if (hg_class) {
+        if (hg_class->hg_class.core_class) {
+            hg_return_t ret =
+                HG_Core_finalize(hg_class->hg_class.core_class);
+            HG_CHECK_ERROR_DONE(
+                ret != HG_SUCCESS, "Could not finalize HG core class");
+        }
+        hg_thread_spin_destroy(&hg_class->register_lock);
+        hg_thread_spin_destroy(&hg_class->extra_pool.lock);
+        hg_thread_spin_destroy(&hg_class->coroutine_lock);
+        hg_key_table_finalize(hg_class);
+        hg_capture_destroy(hg_class->capture);
+        free(hg_class);
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Finalize(hg_class_t *hg_class)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Shard contexts must be destroyed before the class */
+    ret = hg_shards_stop(private_class);
+    HG_CHECK_HG_ERROR(done, ret, "Could not stop shards");
+
+    /* Pooled buffers must be deregistered before NA is finalized */
+    hg_extra_pool_finalize(private_class);
+
+    ret = HG_Core_finalize(private_class->hg_class.core_class);
+    HG_CHECK_HG_ERROR(done, ret, "Could not finalize HG core class");
+
+    hg_handler_coroutine_finalize(private_class);
+
+    hg_thread_spin_destroy(&private_class->register_lock);
+    hg_thread_spin_destroy(&private_class->extra_pool.lock);
+    hg_thread_spin_destroy(&private_class->coroutine_lock);
+    hg_key_table_finalize(private_class);
+    hg_capture_destroy(private_class->capture);
+    free(private_class);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+HG_Cleanup(void)
+{
+    HG_Core_cleanup();
+}
+
+/*---------------------------------------------------------------------------*/
+void
+HG_Set_log_level(const char *level)
+{
+    hg_log_set_subsys_level(HG_SUBSYS_NAME_STRING, hg_log_name_to_level(level));
+}
+
+/*---------------------------------------------------------------------------*/
+void
+HG_Set_log_subsys(const char *subsys)
+{
+    hg_log_set_subsys(subsys);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Class_set_handle_create_callback(hg_class_t *hg_class,
+    hg_return_t (*callback)(hg_handle_t, void *), void *arg)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    private_class->handle_create = callback;
+    private_class->handle_create_arg = arg;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_context_t *
+HG_Class_get_shard_context(hg_class_t *hg_class, hg_uint8_t shard_id)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_context_t *context = NULL;
+
+    HG_CHECK_ERROR_NORET(hg_class == NULL, done, "NULL HG class");
+    HG_CHECK_ERROR_NORET(shard_id >= private_class->shard_count, done,
+        "Invalid shard ID (%u)", shard_id);
+
+    context = private_class->shards[shard_id].context;
+
+done:
+    return context;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_context_t *
+HG_Context_create(hg_class_t *hg_class)
+{
+    return HG_Context_create_id(hg_class, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_context_t *
+HG_Context_create_id(hg_class_t *hg_class, hg_uint8_t id)
+{
+    struct hg_context *hg_context = NULL;
+
+    HG_CHECK_ERROR_NORET(hg_class == NULL, error, "NULL HG class");
+
+    hg_context = malloc(sizeof(struct hg_context));
+    HG_CHECK_ERROR_NORET(
+        hg_context == NULL, error, "Could not allocate HG context");
+
+    memset(hg_context, 0, sizeof(struct hg_context));
+    hg_context->hg_class = hg_class;
+    hg_context->core_context =
+        HG_Core_context_create_id(hg_class->core_class, id);
+    HG_CHECK_ERROR_NORET(hg_context->core_context == NULL, error,
+        "Could not create context for ID %u", id);
+
+    /* Set handle create callback */
+    HG_Core_context_set_handle_create_callback(
+        hg_context->core_context, hg_handle_create_cb, hg_context);
+
+    /* If we are listening, start posting requests */
+    if (HG_Core_class_is_listening(hg_class->core_class)) {
+        hg_return_t ret = HG_Core_context_post(hg_context->core_context);
+        HG_CHECK_HG_ERROR(error, ret, "Could not post context requests (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    return hg_context;
+
+error:
+    if (hg_context) {
+        if (hg_context->core_context) {
+            hg_return_t ret = HG_Core_context_destroy(hg_context->core_context);
+            HG_CHECK_ERROR_DONE(
+                ret != HG_SUCCESS, "Could not destroy HG core context");
+        }
+        free(hg_context);
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_destroy(hg_context_t *context)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
+
+    ret = HG_Core_context_destroy(context->core_context);
+    HG_CHECK_HG_ERROR(done, ret, "Could not destroy HG core context (%s)",
+        HG_Error_to_string(ret));
+
+    free(context);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_set_progress_threads(
+    hg_context_t *context, unsigned int thread_count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
+
+    ret = HG_Core_context_set_progress_threads(
+        context->core_context, thread_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not set progress threads (%s)",
+        HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_id_t
+HG_Register_name(hg_class_t *hg_class, const char *func_name,
+    hg_proc_cb_t in_proc_cb, hg_proc_cb_t out_proc_cb, hg_rpc_cb_t rpc_cb)
+{
+    hg_id_t id = 0;
+    hg_return_t ret;
+
+    HG_CHECK_ERROR_NORET(hg_class == NULL, done, "NULL HG class");
+    HG_CHECK_ERROR_NORET(func_name == NULL, done, "NULL string");
+
+    /* Generate an ID from the function name */
+    id = hg_hash_string(func_name);
+
+    /* Register RPC */
+    ret = HG_Register(hg_class, id, in_proc_cb, out_proc_cb, rpc_cb);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not register RPC ID (%s)", HG_Error_to_string(ret));
+
+done:
+    return id;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_name(
+    hg_class_t *hg_class, const char *func_name, hg_id_t *id, hg_bool_t *flag)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_id_t rpc_id = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_ERROR(func_name == NULL, done, ret, HG_INVALID_ARG, "NULL string");
+
+    /* Generate an ID from the function name */
+    rpc_id = hg_hash_string(func_name);
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    ret = HG_Core_registered(private_class->hg_class.core_class, rpc_id, flag);
+    HG_CHECK_HG_ERROR(unlock, ret, "Could not check for registered RPC ID (%s)",
+        HG_Error_to_string(ret));
+
+    if (id)
+        *id = rpc_id;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Register(hg_class_t *hg_class, hg_id_t id, hg_proc_cb_t in_proc_cb,
+    hg_proc_cb_t out_proc_cb, hg_rpc_cb_t rpc_cb)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_bool_t registered = HG_FALSE;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Check if already registered */
+    ret = HG_Core_registered(hg_class->core_class, id, &registered);
+    HG_CHECK_HG_ERROR(error, ret, "Could not check for registered RPC ID (%s)",
+        HG_Error_to_string(ret));
+
+    /* Register RPC (register only RPC callback if already registered) */
+    ret = HG_Core_register(hg_class->core_class, id, hg_core_rpc_cb);
+    HG_CHECK_HG_ERROR(
+        error, ret, "Could not register RPC ID (%s)", HG_Error_to_string(ret));
+
+    if (!registered) {
+        hg_proc_info =
+            (struct hg_proc_info *) malloc(sizeof(struct hg_proc_info));
+        HG_CHECK_ERROR(hg_proc_info == NULL, error, ret, HG_NOMEM,
+            "Could not allocate proc info");
+        memset(hg_proc_info, 0, sizeof(struct hg_proc_info));
+
+        /* Attach proc info to RPC ID */
+        ret = HG_Core_register_data(
+            hg_class->core_class, id, hg_proc_info, hg_proc_info_free);
+        HG_CHECK_HG_ERROR(error, ret, "Could not set proc info (%s)",
+            HG_Error_to_string(ret));
+        registered = HG_TRUE;
+    } else {
+        /* Retrieve proc function from function map */
+        hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+            hg_class->core_class, id);
+        HG_CHECK_ERROR(hg_proc_info == NULL, error, ret, HG_FAULT,
+            "Could not get registered data");
+    }
+    hg_proc_info->rpc_cb = rpc_cb;
+    hg_proc_info->in_proc_cb = in_proc_cb;
+    hg_proc_info->out_proc_cb = out_proc_cb;
+
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+
+error:
+    if (registered)
+        HG_Core_deregister(hg_class->core_class, id);
+    else
+        free(hg_proc_info);
+    hg_thread_spin_unlock(&private_class->register_lock);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Deregister(hg_class_t *hg_class, hg_id_t id)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+    ret = HG_Core_deregister(hg_class->core_class, id);
+    hg_thread_spin_unlock(&private_class->register_lock);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not deregister RPC ID (%s)", HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered(hg_class_t *hg_class, hg_id_t id, hg_bool_t *flag)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+    ret = HG_Core_registered(hg_class->core_class, id, flag);
+    hg_thread_spin_unlock(&private_class->register_lock);
+    HG_CHECK_HG_ERROR(done, ret, "Could not check for registered RPC ID (s)",
+        HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_proc_cb(hg_class_t *hg_class, hg_id_t id, hg_bool_t *flag,
+    hg_proc_cb_t *in_proc_cb, hg_proc_cb_t *out_proc_cb)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    ret = HG_Core_registered(hg_class->core_class, id, flag);
+    HG_CHECK_HG_ERROR(unlock, ret, "Could not check for registered RPC ID (%s)",
+        HG_Error_to_string(ret));
+
+    if (*flag) {
+        /* if RPC is registered, retrieve pointers */
+        hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+            hg_class->core_class, id);
+        HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_FAULT,
+            "Could not get registered data");
+
+        if (in_proc_cb)
+            *in_proc_cb = hg_proc_info->in_proc_cb;
+        if (out_proc_cb)
+            *out_proc_cb = hg_proc_info->out_proc_cb;
+    }
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Register_data(
+    hg_class_t *hg_class, hg_id_t id, void *data, void (*free_callback)(void *))
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
+        "Could not get registered data");
+
+    hg_proc_info->data = data;
+    hg_proc_info->free_callback = free_callback;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void *
+HG_Registered_data(hg_class_t *hg_class, hg_id_t id)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    void *data = NULL;
+
+    HG_CHECK_ERROR_NORET(hg_class == NULL, done, "NULL HG class");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR_NORET(
+        hg_proc_info == NULL, unlock, "Could not get registered data");
+
+    data = hg_proc_info->data;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return data;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_disable_response(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t disable)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
+        "Could not get registered data");
+
+    hg_proc_info->no_response = disable;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_disabled_response(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t *disabled)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_ERROR(disabled == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to disabled flag");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
+        "Could not get registered data");
+
+    *disabled = hg_proc_info->no_response;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_enable_coroutine(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t enable)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+#ifndef HG_UTIL_HAS_UCONTEXT_H
+    HG_CHECK_ERROR(enable, done, ret, HG_OPNOTSUPPORTED,
+        "Coroutines are not supported on this system");
+#endif
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
+        "Could not get registered data");
+
+    hg_proc_info->coroutine = enable;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Await_init(struct hg_await *await)
+{
+    hg_coroutine_t *coroutine = hg_coroutine_self();
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        await == NULL, done, ret, HG_INVALID_ARG, "NULL await pointer");
+    HG_CHECK_ERROR(coroutine == NULL, done, ret, HG_OPNOTSUPPORTED,
+        "Not called from a coroutine RPC callback");
+
+    memset(&await->info, 0, sizeof(await->info));
+    await->coroutine = hg_coroutine_get_arg(coroutine);
+    await->completed = HG_FALSE;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Await_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_await *await = (struct hg_await *) callback_info->arg;
+    struct hg_handler_coroutine *hg_handler_coroutine =
+        (struct hg_handler_coroutine *) await->coroutine;
+    hg_bool_t resume = HG_FALSE;
+
+    hg_thread_spin_lock(&hg_handler_coroutine->lock);
+    await->info = *callback_info;
+    await->completed = HG_TRUE;
+    if (hg_handler_coroutine->waiting &&
+        hg_handler_coroutine->await == await) {
+        hg_handler_coroutine->waiting = HG_FALSE;
+        resume = HG_TRUE;
+    }
+    hg_thread_spin_unlock(&hg_handler_coroutine->lock);
+
+    /* Coroutine was suspended on this operation, resume it from here */
+    if (resume)
+        hg_handler_coroutine_resume(hg_handler_coroutine);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Await(struct hg_await *await)
+{
+    struct hg_handler_coroutine *hg_handler_coroutine;
+    hg_bool_t completed;
+    hg_return_t ret = HG_SUCCESS;
+    int rc;
+
+    HG_CHECK_ERROR(
+        await == NULL, done, ret, HG_INVALID_ARG, "NULL await pointer");
+    hg_handler_coroutine = (struct hg_handler_coroutine *) await->coroutine;
+    HG_CHECK_ERROR(hg_handler_coroutine == NULL ||
+                       hg_coroutine_self() != hg_handler_coroutine->coroutine,
+        done, ret, HG_INVALID_ARG, "Await was not initialized by caller");
+
+    hg_thread_spin_lock(&hg_handler_coroutine->lock);
+    hg_handler_coroutine->await = await;
+    completed = await->completed;
+    hg_thread_spin_unlock(&hg_handler_coroutine->lock);
+
+    if (!completed) {
+        /* Yield back to progress, resumed by HG_Await_cb() */
+        rc = hg_coroutine_yield();
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_FAULT,
+            "Could not yield coroutine");
+    }
+
+    ret = await->info.ret;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_set_priority(
+    hg_class_t *hg_class, hg_id_t id, hg_priority_t priority)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_registered_set_priority(hg_class->core_class, id, priority);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not set priority (%s)", HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_priority(
+    hg_class_t *hg_class, hg_id_t id, hg_priority_t *priority)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_registered_priority(hg_class->core_class, id, priority);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not get priority (%s)", HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_disable_checksum(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t disable)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
+        "Could not get registered data");
+
+    hg_proc_info->no_checksum = disable;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_disabled_checksum(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t *disabled)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_ERROR(disabled == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to disabled flag");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
+        "Could not get registered data");
+
+    *disabled = hg_proc_info->no_checksum;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_set_codec(hg_class_t *hg_class, hg_id_t id,
+    const struct hg_codec *codec, hg_size_t threshold)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_ERROR(codec && (!codec->compress || !codec->decompress), done,
+        ret, HG_INVALID_ARG, "Codec callbacks are not set");
+#ifdef HG_HAS_XDR
+    HG_CHECK_ERROR(codec != NULL, done, ret, HG_OPNOTSUPPORTED,
+        "Payload compression is not supported with XDR");
+#endif
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
+        "Could not get registered data");
+
+    hg_proc_info->codec = codec;
+    hg_proc_info->codec_threshold = threshold;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_set_response_cache(
+    hg_class_t *hg_class, hg_id_t id, hg_size_t max_size, unsigned int ttl)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    struct hg_response_cache *hg_response_cache = NULL, *old_cache = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    if (max_size > 0 && ttl > 0) {
+        hg_response_cache = hg_response_cache_create(max_size, ttl);
+        HG_CHECK_ERROR(hg_response_cache == NULL, done, ret, HG_NOMEM,
+            "Could not create response cache");
+    }
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
+        "Could not get registered data");
+    HG_CHECK_ERROR(hg_proc_info->no_response && hg_response_cache, unlock,
+        ret, HG_OPNOTSUPPORTED, "Cannot cache responses of RPC (no response)");
+
+    old_cache = hg_proc_info->response_cache;
+    hg_proc_info->response_cache = hg_response_cache;
+    hg_response_cache = NULL;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+    /* NB. caller must ensure that no RPC is being processed */
+    hg_response_cache_free(old_cache);
+    hg_response_cache_free(hg_response_cache);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_set_prefetch(
+    hg_class_t *hg_class, hg_id_t id, hg_proc_cb_t proc_cb)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    hg_thread_spin_lock(&private_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
+        "Could not get registered data");
+
+    hg_proc_info->prefetch_proc_cb = proc_cb;
+
+unlock:
+    hg_thread_spin_unlock(&private_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_lookup1(hg_context_t *context, hg_cb_t callback, void *arg,
+    const char *name, hg_op_id_t *op_id)
+{
+    struct hg_op_id *hg_op_id = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    (void) op_id;
+
+    /* Allocate op_id */
+    hg_op_id = (struct hg_op_id *) malloc(sizeof(struct hg_op_id));
+    HG_CHECK_ERROR(hg_op_id == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG operation ID");
+
+    hg_op_id->context = context;
+    hg_op_id->type = HG_CB_LOOKUP;
+    hg_op_id->callback = callback;
+    hg_op_id->arg = arg;
+    hg_op_id->info.lookup.hg_addr = HG_ADDR_NULL;
+
+    ret = HG_Core_addr_lookup1(context->core_context, hg_core_addr_lookup_cb,
+        hg_op_id, name, HG_CORE_OP_ID_IGNORE);
+    HG_CHECK_HG_ERROR(
+        error, ret, "Could not lookup %s (%s)", name, HG_Error_to_string(ret));
+
+    return ret;
+
+error:
+    free(hg_op_id);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_lookup2(hg_class_t *hg_class, const char *name, hg_addr_t *addr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_lookup2(
+        hg_class->core_class, name, (hg_core_addr_t *) addr);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not lookup %s (%s)", name, HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_lookup_batch(hg_class_t *hg_class, const char *const names[],
+    hg_size_t count, hg_addr_t addrs[])
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_lookup_batch(
+        hg_class->core_class, names, count, (hg_core_addr_t *) addrs);
+    HG_CHECK_HG_ERROR(done, ret, "Could not lookup %zu addresses (%s)",
+        (size_t) count, HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_free(hg_class_t *hg_class, hg_addr_t addr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_free((hg_core_addr_t) addr);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not free addr (%s)", HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_set_remove(hg_class_t *hg_class, hg_addr_t addr)
+{
+    hg_return_t ret = HG_SUCCESS;
 
-    return hg_context;
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
 
-error:
-    if (hg_context) {
-        if (hg_context->core_context) {
-            hg_return_t ret = HG_Core_context_destroy(hg_context->core_context);
-            HG_CHECK_ERROR_DONE(
-                ret != HG_SUCCESS, "Could not destroy HG core context");
-        }
-        free(hg_context);
-    }
-    return NULL;
+    ret = HG_Core_addr_set_remove((hg_core_addr_t) addr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not set addr to be removed (%s)",
+        HG_Error_to_string(ret));
+
+done:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Context_destroy(hg_context_t *context)
+HG_Addr_cancel_all(hg_class_t *hg_class, hg_addr_t addr, hg_bool_t remove)
 {
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
 
-    ret = HG_Core_context_destroy(context->core_context);
-    HG_CHECK_HG_ERROR(done, ret, "Could not destroy HG core context (%s)",
+    ret = HG_Core_addr_cancel_all((hg_core_addr_t) addr, remove);
+    HG_CHECK_HG_ERROR(done, ret, "Could not cancel forwards to addr (%s)",
         HG_Error_to_string(ret));
 
-    free(context);
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_warmup(hg_class_t *hg_class, const hg_addr_t addrs[], hg_size_t count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_warmup((const hg_core_addr_t *) addrs, count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not warm up %zu addresses (%s)",
+        (size_t) count, HG_Error_to_string(ret));
 
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_id_t
-HG_Register_name(hg_class_t *hg_class, const char *func_name,
-    hg_proc_cb_t in_proc_cb, hg_proc_cb_t out_proc_cb, hg_rpc_cb_t rpc_cb)
+hg_return_t
+HG_Addr_get_load(hg_class_t *hg_class, hg_addr_t addr, hg_uint32_t *load)
 {
-    hg_id_t id = 0;
-    hg_return_t ret;
+    hg_return_t ret = HG_SUCCESS;
 
-    HG_CHECK_ERROR_NORET(hg_class == NULL, done, "NULL HG class");
-    HG_CHECK_ERROR_NORET(func_name == NULL, done, "NULL string");
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
 
-    /* Generate an ID from the function name */
-    id = hg_hash_string(func_name);
+    ret = HG_Core_addr_get_load((hg_core_addr_t) addr, load);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not get load (%s)", HG_Error_to_string(ret));
 
-    /* Register RPC */
-    ret = HG_Register(hg_class, id, in_proc_cb, out_proc_cb, rpc_cb);
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_select(hg_class_t *hg_class, const hg_addr_t addrs[], hg_size_t count,
+    hg_addr_t *addr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_select(hg_class->core_class,
+        (const hg_core_addr_t *) addrs, count, (hg_core_addr_t *) addr);
     HG_CHECK_HG_ERROR(
-        done, ret, "Could not register RPC ID (%s)", HG_Error_to_string(ret));
+        done, ret, "Could not select address (%s)", HG_Error_to_string(ret));
 
 done:
-    return id;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered_name(
-    hg_class_t *hg_class, const char *func_name, hg_id_t *id, hg_bool_t *flag)
+HG_Addr_self(hg_class_t *hg_class, hg_addr_t *addr)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
-    hg_id_t rpc_id = 0;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
         hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
-    HG_CHECK_ERROR(func_name == NULL, done, ret, HG_INVALID_ARG, "NULL string");
 
-    /* Generate an ID from the function name */
-    rpc_id = hg_hash_string(func_name);
+    ret = HG_Core_addr_self(hg_class->core_class, (hg_core_addr_t *) addr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not retrieve self addr (%s)",
+        HG_Error_to_string(ret));
 
-    hg_thread_spin_lock(&private_class->register_lock);
+done:
+    return ret;
+}
 
-    ret = HG_Core_registered(private_class->hg_class.core_class, rpc_id, flag);
-    HG_CHECK_HG_ERROR(unlock, ret, "Could not check for registered RPC ID (%s)",
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_dup(hg_class_t *hg_class, hg_addr_t addr, hg_addr_t *new_addr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_dup((hg_core_addr_t) addr, (hg_core_addr_t *) new_addr);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not dup addr (%s)", HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+HG_Addr_cmp(hg_class_t *hg_class, hg_addr_t addr1, hg_addr_t addr2)
+{
+    hg_bool_t ret = HG_FALSE;
+
+    HG_CHECK_ERROR_NORET(hg_class == NULL, done, "NULL HG class");
+
+    ret = HG_Core_addr_cmp((hg_core_addr_t) addr1, (hg_core_addr_t) addr2);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_to_string(
+    hg_class_t *hg_class, char *buf, hg_size_t *buf_size, hg_addr_t addr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_to_string(buf, buf_size, (hg_core_addr_t) addr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not convert addr to string (%s)",
         HG_Error_to_string(ret));
 
-    if (id)
-        *id = rpc_id;
+done:
+    return ret;
+}
 
-unlock:
-    hg_thread_spin_unlock(&private_class->register_lock);
+/*---------------------------------------------------------------------------*/
+hg_size_t
+HG_Addr_get_serialize_batch_size(
+    hg_class_t *hg_class, const hg_addr_t addrs[], hg_size_t count)
+{
+    hg_size_t ret = 0;
+
+    HG_CHECK_ERROR_NORET(hg_class == NULL, done, "NULL HG class");
+
+    ret = HG_Core_addr_get_serialize_batch_size(
+        (const hg_core_addr_t *) addrs, count);
 
 done:
     return ret;
@@ -1205,84 +4387,139 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Register(hg_class_t *hg_class, hg_id_t id, hg_proc_cb_t in_proc_cb,
-    hg_proc_cb_t out_proc_cb, hg_rpc_cb_t rpc_cb)
+HG_Addr_serialize_batch(hg_class_t *hg_class, void *buf, hg_size_t buf_size,
+    const hg_addr_t addrs[], hg_size_t count)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
-    struct hg_proc_info *hg_proc_info = NULL;
-    hg_bool_t registered = HG_FALSE;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
         hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
 
-    hg_thread_spin_lock(&private_class->register_lock);
+    ret = HG_Core_addr_serialize_batch(
+        buf, buf_size, (const hg_core_addr_t *) addrs, count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not serialize %zu addresses (%s)",
+        (size_t) count, HG_Error_to_string(ret));
 
-    /* Check if already registered */
-    ret = HG_Core_registered(hg_class->core_class, id, &registered);
-    HG_CHECK_HG_ERROR(error, ret, "Could not check for registered RPC ID (%s)",
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_deserialize_batch(hg_class_t *hg_class, const void *buf,
+    hg_size_t buf_size, hg_addr_t addrs[], hg_size_t *count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_deserialize_batch(hg_class->core_class, buf, buf_size,
+        (hg_core_addr_t *) addrs, count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not deserialize addresses (%s)",
         HG_Error_to_string(ret));
 
-    /* Register RPC (register only RPC callback if already registered) */
-    ret = HG_Core_register(hg_class->core_class, id, hg_core_rpc_cb);
-    HG_CHECK_HG_ERROR(
-        error, ret, "Could not register RPC ID (%s)", HG_Error_to_string(ret));
+done:
+    return ret;
+}
 
-    if (!registered) {
-        hg_proc_info =
-            (struct hg_proc_info *) malloc(sizeof(struct hg_proc_info));
-        HG_CHECK_ERROR(hg_proc_info == NULL, error, ret, HG_NOMEM,
-            "Could not allocate proc info");
-        memset(hg_proc_info, 0, sizeof(struct hg_proc_info));
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Create(
+    hg_context_t *context, hg_addr_t addr, hg_id_t id, hg_handle_t *handle)
+{
+    struct hg_private_handle *hg_handle = NULL;
+    hg_core_handle_t core_handle;
+    hg_return_t ret = HG_SUCCESS;
 
-        /* Attach proc info to RPC ID */
-        ret = HG_Core_register_data(
-            hg_class->core_class, id, hg_proc_info, hg_proc_info_free);
-        HG_CHECK_HG_ERROR(error, ret, "Could not set proc info (%s)",
-            HG_Error_to_string(ret));
-        registered = HG_TRUE;
-    } else {
-        /* Retrieve proc function from function map */
-        hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-            hg_class->core_class, id);
-        HG_CHECK_ERROR(hg_proc_info == NULL, error, ret, HG_FAULT,
-            "Could not get registered data");
-    }
-    hg_proc_info->rpc_cb = rpc_cb;
-    hg_proc_info->in_proc_cb = in_proc_cb;
-    hg_proc_info->out_proc_cb = out_proc_cb;
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
+
+    /* Create HG core handle (calls handle_create_cb) */
+    ret = HG_Core_create(
+        context->core_context, (hg_core_addr_t) addr, id, &core_handle);
+    if (ret == HG_NOENTRY)
+        goto done; /* silence error if invalid ID is used */
+    HG_CHECK_HG_ERROR(done, ret, "Cannot create HG handle with ID %lu (%s)", id,
+        HG_Error_to_string(ret));
+
+    /* Get data and HG info */
+    hg_handle = (struct hg_private_handle *) HG_Core_get_data(core_handle);
+    hg_handle->handle.info.addr = addr;
+    hg_handle->handle.info.id = id;
+
+    *handle = (hg_handle_t) hg_handle;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Destroy(hg_handle_t handle)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (handle == HG_HANDLE_NULL)
+        goto done;
+
+    ret = HG_Core_destroy(handle->core_handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not set handle to be destroyed (%s)",
+        HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Reset(hg_handle_t handle, hg_addr_t addr, hg_id_t id)
+{
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+
+    /* Call core reset */
+    ret = HG_Core_reset(handle->core_handle, (hg_core_addr_t) addr, id);
+    HG_CHECK_HG_ERROR(done, ret, "Could not reset core HG handle (%s)",
+        HG_Error_to_string(ret));
 
-    hg_thread_spin_unlock(&private_class->register_lock);
+    /* Set info */
+    private_handle->handle.info.addr = addr;
+    private_handle->handle.info.id = id;
+    private_handle->handle.info.context_id = 0;
+    private_handle->persistent = HG_FALSE;
 
 done:
     return ret;
-
-error:
-    if (registered)
-        HG_Core_deregister(hg_class->core_class, id);
-    else
-        free(hg_proc_info);
-    hg_thread_spin_unlock(&private_class->register_lock);
-    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Deregister(hg_class_t *hg_class, hg_id_t id)
+HG_Get_input(hg_handle_t handle, void *in_struct)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(in_struct == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to input struct");
 
-    hg_thread_spin_lock(&private_class->register_lock);
-    ret = HG_Core_deregister(hg_class->core_class, id);
-    hg_thread_spin_unlock(&private_class->register_lock);
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_ERROR(
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
+
+    /* Get input struct */
+    ret = hg_get_struct(
+        (struct hg_private_handle *) handle, hg_proc_info, HG_INPUT, in_struct);
     HG_CHECK_HG_ERROR(
-        done, ret, "Could not deregister RPC ID (%s)", HG_Error_to_string(ret));
+        done, ret, "Could not get input (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
@@ -1290,20 +4527,27 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered(hg_class_t *hg_class, hg_id_t id, hg_bool_t *flag)
+HG_Free_input(hg_handle_t handle, void *in_struct)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(in_struct == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to input struct");
 
-    hg_thread_spin_lock(&private_class->register_lock);
-    ret = HG_Core_registered(hg_class->core_class, id, flag);
-    hg_thread_spin_unlock(&private_class->register_lock);
-    HG_CHECK_HG_ERROR(done, ret, "Could not check for registered RPC ID (s)",
-        HG_Error_to_string(ret));
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_ERROR(
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
+
+    /* Free input struct */
+    ret = hg_free_struct(
+        (struct hg_private_handle *) handle, hg_proc_info, HG_INPUT, in_struct);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not free input (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
@@ -1311,38 +4555,35 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered_proc_cb(hg_class_t *hg_class, hg_id_t id, hg_bool_t *flag,
-    hg_proc_cb_t *in_proc_cb, hg_proc_cb_t *out_proc_cb)
+HG_Get_input_partial(hg_handle_t handle, hg_proc_cb_t proc_cb, void *in_struct)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
-    struct hg_proc_info *hg_proc_info = NULL;
+    const struct hg_proc_info *hg_proc_info;
+    struct hg_proc_info partial_info;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
-
-    hg_thread_spin_lock(&private_class->register_lock);
-
-    ret = HG_Core_registered(hg_class->core_class, id, flag);
-    HG_CHECK_HG_ERROR(unlock, ret, "Could not check for registered RPC ID (%s)",
-        HG_Error_to_string(ret));
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(
+        proc_cb == NULL, done, ret, HG_INVALID_ARG, "NULL proc callback");
+    HG_CHECK_ERROR(in_struct == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to input struct");
 
-    if (*flag) {
-        /* if RPC is registered, retrieve pointers */
-        hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-            hg_class->core_class, id);
-        HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_FAULT,
-            "Could not get registered data");
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_ERROR(
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
 
-        if (in_proc_cb)
-            *in_proc_cb = hg_proc_info->in_proc_cb;
-        if (out_proc_cb)
-            *out_proc_cb = hg_proc_info->out_proc_cb;
-    }
+    /* Decode with the given proc, a prefix cannot be checksummed */
+    partial_info = *hg_proc_info;
+    partial_info.in_proc_cb = proc_cb;
+    partial_info.no_checksum = HG_TRUE;
 
-unlock:
-    hg_thread_spin_unlock(&private_class->register_lock);
+    /* Get partial input struct */
+    ret = hg_get_struct((struct hg_private_handle *) handle, &partial_info,
+        HG_INPUT, in_struct);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not get partial input (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
@@ -1350,88 +4591,97 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Register_data(
-    hg_class_t *hg_class, hg_id_t id, void *data, void (*free_callback)(void *))
+HG_Free_input_partial(
+    hg_handle_t handle, hg_proc_cb_t proc_cb, void *in_struct)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
-    struct hg_proc_info *hg_proc_info = NULL;
+    const struct hg_proc_info *hg_proc_info;
+    struct hg_proc_info partial_info;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
-
-    hg_thread_spin_lock(&private_class->register_lock);
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(
+        proc_cb == NULL, done, ret, HG_INVALID_ARG, "NULL proc callback");
+    HG_CHECK_ERROR(in_struct == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to input struct");
 
-    /* Retrieve proc function from function map */
-    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-        hg_class->core_class, id);
-    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
-        "Could not get registered data");
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_ERROR(
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
 
-    hg_proc_info->data = data;
-    hg_proc_info->free_callback = free_callback;
+    partial_info = *hg_proc_info;
+    partial_info.in_proc_cb = proc_cb;
 
-unlock:
-    hg_thread_spin_unlock(&private_class->register_lock);
+    /* Free partial input struct */
+    ret = hg_free_struct((struct hg_private_handle *) handle, &partial_info,
+        HG_INPUT, in_struct);
+    HG_CHECK_HG_ERROR(done, ret, "Could not free partial input (%s)",
+        HG_Error_to_string(ret));
 
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-void *
-HG_Registered_data(hg_class_t *hg_class, hg_id_t id)
+hg_return_t
+HG_Get_input_bulk(hg_handle_t handle, hg_cb_t callback, void *arg)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
-    struct hg_proc_info *hg_proc_info = NULL;
-    void *data = NULL;
-
-    HG_CHECK_ERROR_NORET(hg_class == NULL, done, "NULL HG class");
+    struct hg_prefetch *hg_prefetch;
+    hg_return_t ret = HG_SUCCESS;
 
-    hg_thread_spin_lock(&private_class->register_lock);
+    HG_CHECK_ERROR(
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    hg_prefetch = &((struct hg_private_handle *) handle)->prefetch;
+
+    switch (hg_atomic_get32(&hg_prefetch->status)) {
+        case HG_PREFETCH_NONE:
+            HG_GOTO_ERROR(done, ret, HG_NOENTRY, "No bulk data was prefetched");
+        case HG_PREFETCH_WAITING:
+            HG_GOTO_ERROR(done, ret, HG_BUSY,
+                "Prefetched bulk data was already requested");
+        default:
+            break;
+    }
 
-    /* Retrieve proc function from function map */
-    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-        hg_class->core_class, id);
-    HG_CHECK_ERROR_NORET(
-        hg_proc_info == NULL, unlock, "Could not get registered data");
+    hg_prefetch->callback = callback;
+    hg_prefetch->arg = arg;
 
-    data = hg_proc_info->data;
+    /* Callback is executed on completion if transfer is still in flight */
+    if (hg_atomic_cas32(
+            &hg_prefetch->status, HG_PREFETCH_INFLIGHT, HG_PREFETCH_WAITING))
+        goto done;
 
-unlock:
-    hg_thread_spin_unlock(&private_class->register_lock);
+    hg_prefetch_complete((struct hg_private_handle *) handle);
 
 done:
-    return data;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered_disable_response(
-    hg_class_t *hg_class, hg_id_t id, hg_bool_t disable)
+HG_Get_output(hg_handle_t handle, void *out_struct)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
-    struct hg_proc_info *hg_proc_info = NULL;
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
-
-    hg_thread_spin_lock(&private_class->register_lock);
-
-    /* Retrieve proc function from function map */
-    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-        hg_class->core_class, id);
-    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
-        "Could not get registered data");
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(out_struct == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to output struct");
 
-    hg_proc_info->no_response = disable;
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_ERROR(
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
 
-unlock:
-    hg_thread_spin_unlock(&private_class->register_lock);
+    /* Get output struct */
+    ret = hg_get_struct((struct hg_private_handle *) handle, hg_proc_info,
+        HG_OUTPUT, out_struct);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not get output (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
@@ -1439,31 +4689,27 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered_disabled_response(
-    hg_class_t *hg_class, hg_id_t id, hg_bool_t *disabled)
+HG_Free_output(hg_handle_t handle, void *out_struct)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
-    struct hg_proc_info *hg_proc_info = NULL;
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
-    HG_CHECK_ERROR(disabled == NULL, done, ret, HG_INVALID_ARG,
-        "NULL pointer to disabled flag");
-
-    hg_thread_spin_lock(&private_class->register_lock);
-
-    /* Retrieve proc function from function map */
-    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-        hg_class->core_class, id);
-    HG_CHECK_ERROR(hg_proc_info == NULL, unlock, ret, HG_NOENTRY,
-        "Could not get registered data");
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(out_struct == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to output struct");
 
-    *disabled = hg_proc_info->no_response;
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_ERROR(
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
 
-unlock:
-    hg_thread_spin_unlock(&private_class->register_lock);
+    /* Free output struct */
+    ret = hg_free_struct((struct hg_private_handle *) handle, hg_proc_info,
+        HG_OUTPUT, out_struct);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not free output (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
@@ -1471,53 +4717,57 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_lookup1(hg_context_t *context, hg_cb_t callback, void *arg,
-    const char *name, hg_op_id_t *op_id)
+HG_Get_input_buf(hg_handle_t handle, void **in_buf, hg_size_t *in_buf_size)
 {
-    struct hg_op_id *hg_op_id = NULL;
+    hg_size_t buf_size, header_offset = hg_header_get_size(HG_INPUT);
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
-    (void) op_id;
-
-    /* Allocate op_id */
-    hg_op_id = (struct hg_op_id *) malloc(sizeof(struct hg_op_id));
-    HG_CHECK_ERROR(hg_op_id == NULL, error, ret, HG_NOMEM,
-        "Could not allocate HG operation ID");
-
-    hg_op_id->context = context;
-    hg_op_id->type = HG_CB_LOOKUP;
-    hg_op_id->callback = callback;
-    hg_op_id->arg = arg;
-    hg_op_id->info.lookup.hg_addr = HG_ADDR_NULL;
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(
+        in_buf == NULL, done, ret, HG_INVALID_ARG, "NULL input buffer pointer");
 
-    ret = HG_Core_addr_lookup1(context->core_context, hg_core_addr_lookup_cb,
-        hg_op_id, name, HG_CORE_OP_ID_IGNORE);
+    /* Get core input buffer */
+    /* Note: any extra header information will be transmitted with the
+     * control message, not the extra_buf, if the RPC exceeds the eager size
+     * limit.
+     */
+    ret = HG_Core_get_input(handle->core_handle, in_buf, &buf_size);
     HG_CHECK_HG_ERROR(
-        error, ret, "Could not lookup %s (%s)", name, HG_Error_to_string(ret));
-
-    return ret;
+        done, ret, "Could not get input buffer (%s)", HG_Error_to_string(ret));
 
-error:
-    free(hg_op_id);
+    *in_buf = (char *) *in_buf + header_offset;
+    if (in_buf_size)
+        *in_buf_size = buf_size - header_offset;
 
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_lookup2(hg_class_t *hg_class, const char *name, hg_addr_t *addr)
+HG_Get_output_buf(hg_handle_t handle, void **out_buf, hg_size_t *out_buf_size)
 {
+    hg_size_t buf_size, header_offset = hg_header_get_size(HG_OUTPUT);
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(out_buf == NULL, done, ret, HG_INVALID_ARG,
+        "NULL output buffer pointer");
 
-    ret = HG_Core_addr_lookup2(
-        hg_class->core_class, name, (hg_core_addr_t *) addr);
+    /* Get core output buffer */
+    /* Note: any extra header information will be transmitted with the
+     * control message, not the extra_buf, if the response exceeds the eager
+     * size limit.
+     */
+    ret = HG_Core_get_output(handle->core_handle, out_buf, &buf_size);
     HG_CHECK_HG_ERROR(
-        done, ret, "Could not lookup %s (%s)", name, HG_Error_to_string(ret));
+        done, ret, "Could not get output buffer (%s)", HG_Error_to_string(ret));
+
+    *out_buf = (char *) *out_buf + header_offset;
+    if (out_buf_size)
+        *out_buf_size = buf_size - header_offset;
 
 done:
     return ret;
@@ -1525,16 +4775,22 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_free(hg_class_t *hg_class, hg_addr_t addr)
+HG_Get_input_extra_buf(
+    hg_handle_t handle, void **in_buf, hg_size_t *in_buf_size)
 {
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(
+        in_buf == NULL, done, ret, HG_INVALID_ARG, "NULL input buffer pointer");
 
-    ret = HG_Core_addr_free((hg_core_addr_t) addr);
-    HG_CHECK_HG_ERROR(
-        done, ret, "Could not free addr (%s)", HG_Error_to_string(ret));
+    /* No offset if extra buffer since only the user payload is copied */
+    *in_buf = private_handle->in_extra_buf;
+    if (in_buf_size)
+        *in_buf_size = private_handle->in_extra_buf_size;
 
 done:
     return ret;
@@ -1542,16 +4798,22 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_set_remove(hg_class_t *hg_class, hg_addr_t addr)
+HG_Get_output_extra_buf(
+    hg_handle_t handle, void **out_buf, hg_size_t *out_buf_size)
 {
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(out_buf == NULL, done, ret, HG_INVALID_ARG,
+        "NULL output buffer pointer");
 
-    ret = HG_Core_addr_set_remove((hg_core_addr_t) addr);
-    HG_CHECK_HG_ERROR(done, ret, "Could not set addr to be removed (%s)",
-        HG_Error_to_string(ret));
+    /* No offset if extra buffer since only the user payload is copied */
+    *out_buf = private_handle->out_extra_buf;
+    if (out_buf_size)
+        *out_buf_size = private_handle->out_extra_buf_size;
 
 done:
     return ret;
@@ -1559,16 +4821,25 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_self(hg_class_t *hg_class, hg_addr_t *addr)
+HG_Get_input_raw(hg_handle_t handle, void **in_buf, hg_size_t *in_buf_size)
 {
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(in_buf == NULL || in_buf_size == NULL, done, ret,
+        HG_INVALID_ARG, "NULL input buffer pointer");
 
-    ret = HG_Core_addr_self(hg_class->core_class, (hg_core_addr_t *) addr);
-    HG_CHECK_HG_ERROR(done, ret, "Could not retrieve self addr (%s)",
-        HG_Error_to_string(ret));
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_ERROR(
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
+
+    ret = hg_get_raw((struct hg_private_handle *) handle, hg_proc_info,
+        HG_INPUT, in_buf, in_buf_size);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not get raw input (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
@@ -1576,30 +4847,53 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_dup(hg_class_t *hg_class, hg_addr_t addr, hg_addr_t *new_addr)
+HG_Get_output_raw(hg_handle_t handle, void **out_buf, hg_size_t *out_buf_size)
 {
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(out_buf == NULL || out_buf_size == NULL, done, ret,
+        HG_INVALID_ARG, "NULL output buffer pointer");
 
-    ret = HG_Core_addr_dup((hg_core_addr_t) addr, (hg_core_addr_t *) new_addr);
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_ERROR(
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
+
+    ret = hg_get_raw((struct hg_private_handle *) handle, hg_proc_info,
+        HG_OUTPUT, out_buf, out_buf_size);
     HG_CHECK_HG_ERROR(
-        done, ret, "Could not dup addr (%s)", HG_Error_to_string(ret));
+        done, ret, "Could not get raw output (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_bool_t
-HG_Addr_cmp(hg_class_t *hg_class, hg_addr_t addr1, hg_addr_t addr2)
+hg_return_t
+HG_Set_output_bulk(hg_handle_t handle, hg_bulk_t bulk)
 {
-    hg_bool_t ret = HG_FALSE;
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
+    hg_return_t ret = HG_SUCCESS;
 
-    HG_CHECK_ERROR_NORET(hg_class == NULL, done, "NULL HG class");
+    HG_CHECK_ERROR(
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(bulk != HG_BULK_NULL && HG_Bulk_get_segment_count(bulk) != 1,
+        done, ret, HG_INVALID_ARG,
+        "Response buffer must consist of a single segment");
 
-    ret = HG_Core_addr_cmp((hg_core_addr_t) addr1, (hg_core_addr_t) addr2);
+    if (bulk != HG_BULK_NULL) {
+        ret = HG_Bulk_ref_incr(bulk);
+        HG_CHECK_HG_ERROR(done, ret, "Could not increment bulk handle ref");
+    }
+
+    /* Release previously attached buffer */
+    if (private_handle->resp_bulk != HG_BULK_NULL)
+        HG_Bulk_free(private_handle->resp_bulk);
+    private_handle->resp_bulk = bulk;
 
 done:
     return ret;
@@ -1607,73 +4901,45 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_to_string(
-    hg_class_t *hg_class, char *buf, hg_size_t *buf_size, hg_addr_t addr)
+HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct)
 {
-    hg_return_t ret = HG_SUCCESS;
-
-    HG_CHECK_ERROR(
-        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
-
-    ret = HG_Core_addr_to_string(buf, buf_size, (hg_core_addr_t) addr);
-    HG_CHECK_HG_ERROR(done, ret, "Could not convert addr to string (%s)",
-        HG_Error_to_string(ret));
-
-done:
-    return ret;
+    return HG_Forward_timed(handle, callback, arg, in_struct, 0);
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Create(
-    hg_context_t *context, hg_addr_t addr, hg_id_t id, hg_handle_t *handle)
+HG_Forward_timed(hg_handle_t handle, hg_cb_t callback, void *arg,
+    void *in_struct, unsigned int timeout)
 {
-    struct hg_private_handle *hg_handle = NULL;
-    hg_core_handle_t core_handle;
-    hg_return_t ret = HG_SUCCESS;
-
-    HG_CHECK_ERROR(
-        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
-
-    /* Create HG core handle (calls handle_create_cb) */
-    ret = HG_Core_create(
-        context->core_context, (hg_core_addr_t) addr, id, &core_handle);
-    if (ret == HG_NOENTRY)
-        goto done; /* silence error if invalid ID is used */
-    HG_CHECK_HG_ERROR(done, ret, "Cannot create HG handle with ID %lu (%s)", id,
-        HG_Error_to_string(ret));
-
-    /* Get data and HG info */
-    hg_handle = (struct hg_private_handle *) HG_Core_get_data(core_handle);
-    hg_handle->handle.info.addr = addr;
-    hg_handle->handle.info.id = id;
-
-    *handle = (hg_handle_t) hg_handle;
-
-done:
-    return ret;
+    return hg_forward(handle, callback, arg, NULL, NULL, in_struct, timeout);
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Destroy(hg_handle_t handle)
+HG_Forward_init(hg_handle_t handle, hg_cb_t callback, void *arg)
 {
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
     hg_return_t ret = HG_SUCCESS;
 
-    if (handle == HG_HANDLE_NULL)
-        goto done;
+    HG_CHECK_ERROR(
+        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
 
-    ret = HG_Core_destroy(handle->core_handle);
-    HG_CHECK_HG_ERROR(done, ret, "Could not set handle to be destroyed (%s)",
+    ret = HG_Core_forward_init(handle->core_handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not init persistent forward (%s)",
         HG_Error_to_string(ret));
 
+    private_handle->forward_cb = callback;
+    private_handle->forward_arg = arg;
+    private_handle->persistent = HG_TRUE;
+
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Reset(hg_handle_t handle, hg_addr_t addr, hg_id_t id)
+HG_Forward_start(hg_handle_t handle, void *in_struct)
 {
     struct hg_private_handle *private_handle =
         (struct hg_private_handle *) handle;
@@ -1681,32 +4947,40 @@ HG_Reset(hg_handle_t handle, hg_addr_t addr, hg_id_t id)
 
     HG_CHECK_ERROR(
         handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_ERROR(!private_handle->persistent, done, ret, HG_INVALID_ARG,
+        "Handle was not set up with HG_Forward_init()");
 
-    /* Call core reset */
-    ret = HG_Core_reset(handle->core_handle, (hg_core_addr_t) addr, id);
-    HG_CHECK_HG_ERROR(done, ret, "Could not reset core HG handle (%s)",
-        HG_Error_to_string(ret));
-
-    /* Set info */
-    private_handle->handle.info.addr = addr;
-    private_handle->handle.info.id = id;
-    private_handle->handle.info.context_id = 0;
+    ret = hg_forward(handle, private_handle->forward_cb,
+        private_handle->forward_arg, NULL, NULL, in_struct, 0);
 
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Get_input(hg_handle_t handle, void *in_struct)
+static hg_return_t
+hg_forward_prepare(hg_handle_t handle, hg_cb_t callback, void *arg,
+    hg_cb_t chunk_callback, void *chunk_arg, void *in_struct,
+    hg_uint8_t *flags_ptr, hg_size_t *payload_size_ptr)
 {
-    const struct hg_proc_info *hg_proc_info;
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
+    const struct hg_proc_info *hg_proc_info = NULL;
+    hg_size_t payload_size = 0;
+    hg_bool_t more_data = HG_FALSE;
+    hg_uint8_t flags = 0;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
         handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_ERROR(in_struct == NULL, done, ret, HG_INVALID_ARG,
-        "NULL pointer to input struct");
+    HG_CHECK_ERROR(handle->info.addr == HG_ADDR_NULL, done, ret, HG_INVALID_ARG,
+        "NULL target addr");
+
+    /* Set callback data */
+    private_handle->forward_cb = callback;
+    private_handle->forward_arg = arg;
+    private_handle->chunk_cb = chunk_callback;
+    private_handle->chunk_arg = chunk_arg;
 
     /* Retrieve RPC data */
     hg_proc_info =
@@ -1714,11 +4988,49 @@ HG_Get_input(hg_handle_t handle, void *in_struct)
     HG_CHECK_ERROR(
         hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
 
-    /* Get input struct */
-    ret = hg_get_struct(
-        (struct hg_private_handle *) handle, hg_proc_info, HG_INPUT, in_struct);
+    /* Set input struct */
+    ret = hg_set_struct(private_handle, hg_proc_info, HG_INPUT, in_struct,
+        &payload_size, &more_data);
     HG_CHECK_HG_ERROR(
-        done, ret, "Could not get input (%s)", HG_Error_to_string(ret));
+        done, ret, "Could not set input (%s)", HG_Error_to_string(ret));
+
+    /* Set more data flag on handle so that handle_more_callback is triggered */
+    if (more_data)
+        flags |= HG_CORE_MORE_DATA;
+
+    /* Set no response flag if no response required */
+    if (hg_proc_info->no_response)
+        flags |= HG_CORE_NO_RESPONSE;
+
+    *flags_ptr = flags;
+    *payload_size_ptr = payload_size;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_forward(hg_handle_t handle, hg_cb_t callback, void *arg,
+    hg_cb_t chunk_callback, void *chunk_arg, void *in_struct,
+    unsigned int timeout)
+{
+    hg_size_t payload_size = 0;
+    hg_uint8_t flags = 0;
+    hg_return_t ret;
+
+    ret = hg_forward_prepare(handle, callback, arg, chunk_callback, chunk_arg,
+        in_struct, &flags, &payload_size);
+    if (ret != HG_SUCCESS)
+        goto done;
+
+    /* Send request */
+    ret = HG_Core_forward_timed(handle->core_handle, hg_core_forward_cb, handle,
+        flags, payload_size, timeout);
+    if (ret == HG_AGAIN)
+        goto done;
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not forward call (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
@@ -1726,27 +5038,21 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Free_input(hg_handle_t handle, void *in_struct)
+HG_Forward_stream(hg_handle_t handle, hg_cb_t chunk_callback, void *chunk_arg,
+    hg_cb_t callback, void *arg, void *in_struct)
 {
-    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
         handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_ERROR(in_struct == NULL, done, ret, HG_INVALID_ARG,
-        "NULL pointer to input struct");
 
-    /* Retrieve RPC data */
-    hg_proc_info =
-        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
-    HG_CHECK_ERROR(
-        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
+    ret = HG_Core_set_chunk_callback(
+        handle->core_handle, hg_core_chunk_cb, handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not set chunk callback (%s)",
+        HG_Error_to_string(ret));
 
-    /* Free input struct */
-    ret = hg_free_struct(
-        (struct hg_private_handle *) handle, hg_proc_info, HG_INPUT, in_struct);
-    HG_CHECK_HG_ERROR(
-        done, ret, "Could not free input (%s)", HG_Error_to_string(ret));
+    ret = hg_forward(
+        handle, callback, arg, chunk_callback, chunk_arg, in_struct, 0);
 
 done:
     return ret;
@@ -1754,15 +5060,27 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Get_output(hg_handle_t handle, void *out_struct)
+HG_Forward_raw(hg_handle_t handle, hg_cb_t callback, void *arg,
+    const void *in_buf, hg_size_t in_buf_size)
 {
-    const struct hg_proc_info *hg_proc_info;
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
+    const struct hg_proc_info *hg_proc_info = NULL;
+    hg_size_t payload_size = 0;
+    hg_uint8_t flags = 0;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
         handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_ERROR(out_struct == NULL, done, ret, HG_INVALID_ARG,
-        "NULL pointer to output struct");
+    HG_CHECK_ERROR(handle->info.addr == HG_ADDR_NULL, done, ret, HG_INVALID_ARG,
+        "NULL target addr");
+    HG_CHECK_ERROR(
+        in_buf == NULL, done, ret, HG_INVALID_ARG, "NULL input buffer");
+
+    /* Set callback data */
+    private_handle->forward_cb = callback;
+    private_handle->forward_arg = arg;
+    private_handle->chunk_cb = NULL;
 
     /* Retrieve RPC data */
     hg_proc_info =
@@ -1770,11 +5088,21 @@ HG_Get_output(hg_handle_t handle, void *out_struct)
     HG_CHECK_ERROR(
         hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
 
-    /* Get output struct */
-    ret = hg_get_struct((struct hg_private_handle *) handle, hg_proc_info,
-        HG_OUTPUT, out_struct);
+    /* Set pre-encoded input */
+    ret = hg_set_raw(private_handle, hg_proc_info, HG_INPUT, in_buf,
+        in_buf_size, &payload_size);
     HG_CHECK_HG_ERROR(
-        done, ret, "Could not get output (%s)", HG_Error_to_string(ret));
+        done, ret, "Could not set raw input (%s)", HG_Error_to_string(ret));
+
+    /* Set no response flag if no response required */
+    if (hg_proc_info->no_response)
+        flags |= HG_CORE_NO_RESPONSE;
+
+    /* Send request */
+    ret = HG_Core_forward(
+        handle->core_handle, hg_core_forward_cb, handle, flags, payload_size);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not forward call (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
@@ -1782,15 +5110,26 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Free_output(hg_handle_t handle, void *out_struct)
+HG_Send_oneway(hg_context_t *context, hg_addr_t addr, hg_id_t id,
+    void *in_struct)
 {
-    const struct hg_proc_info *hg_proc_info;
-    hg_return_t ret = HG_SUCCESS;
+    struct hg_private_handle *private_handle;
+    const struct hg_proc_info *hg_proc_info = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_size_t payload_size = 0;
+    hg_bool_t more_data = HG_FALSE;
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
 
-    HG_CHECK_ERROR(
-        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_ERROR(out_struct == NULL, done, ret, HG_INVALID_ARG,
-        "NULL pointer to output struct");
+    HG_CHECK_ERROR(addr == HG_ADDR_NULL, done, ret, HG_INVALID_ARG,
+        "NULL target addr");
+
+    /* Handle is taken from the context pool and released once sent */
+    ret = HG_Create(context, addr, id, &handle);
+    if (ret == HG_NOENTRY)
+        goto done;
+    HG_CHECK_HG_ERROR(done, ret, "Could not create handle (%s)",
+        HG_Error_to_string(ret));
+    private_handle = (struct hg_private_handle *) handle;
 
     /* Retrieve RPC data */
     hg_proc_info =
@@ -1798,115 +5137,223 @@ HG_Free_output(hg_handle_t handle, void *out_struct)
     HG_CHECK_ERROR(
         hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
 
-    /* Free output struct */
-    ret = hg_free_struct((struct hg_private_handle *) handle, hg_proc_info,
-        HG_OUTPUT, out_struct);
+    /* Input must fit into the message buffer, nothing is kept on the origin
+     * that the target could pull from */
+    ret = hg_set_struct(private_handle, hg_proc_info, HG_INPUT, in_struct,
+        &payload_size, &more_data);
     HG_CHECK_HG_ERROR(
-        done, ret, "Could not free output (%s)", HG_Error_to_string(ret));
+        done, ret, "Could not set input (%s)", HG_Error_to_string(ret));
+    HG_CHECK_ERROR(more_data, done, ret, HG_MSGSIZE,
+        "Input does not fit into one-way message");
+
+    /* No callback is executed on completion, the send may be coalesced with
+     * other requests to the same target */
+    ret = HG_Core_forward(
+        handle->core_handle, NULL, NULL, HG_CORE_NO_RESPONSE, payload_size);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not forward call (%s)", HG_Error_to_string(ret));
 
 done:
+    /* Posted send keeps its own reference */
+    cleanup_ret = HG_Destroy(handle);
+    HG_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+        "Could not destroy handle (%s)", HG_Error_to_string(cleanup_ret));
+
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Get_input_buf(hg_handle_t handle, void **in_buf, hg_size_t *in_buf_size)
+HG_Forward_hedged(hg_handle_t *handles, unsigned int count,
+    unsigned int delay, hg_cb_t callback, void *arg, void *in_struct)
 {
-    hg_size_t buf_size, header_offset = hg_header_get_size(HG_INPUT);
+    struct hg_private_handle *private_handle;
+    const struct hg_proc_info *hg_proc_info = NULL;
+    struct hg_hedge *hedge = NULL;
+    hg_size_t payload_size = 0;
+    hg_bool_t more_data = HG_FALSE;
+    unsigned int i, posted = 0;
     hg_return_t ret = HG_SUCCESS;
 
+    HG_CHECK_ERROR(handles == NULL || count == 0, done, ret, HG_INVALID_ARG,
+        "NULL handles");
+    for (i = 0; i < count; i++) {
+        HG_CHECK_ERROR(handles[i] == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG,
+            "NULL HG handle");
+        HG_CHECK_ERROR(handles[i]->info.addr == HG_ADDR_NULL, done, ret,
+            HG_INVALID_ARG, "NULL target addr");
+        HG_CHECK_ERROR(handles[i]->info.id != handles[0]->info.id, done, ret,
+            HG_INVALID_ARG, "Hedged handles must share the same RPC ID");
+    }
+    private_handle = (struct hg_private_handle *) handles[0];
+
+    /* Retrieve RPC data */
+    hg_proc_info = (const struct hg_proc_info *) HG_Core_get_rpc_data(
+        handles[0]->core_handle);
     HG_CHECK_ERROR(
-        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_ERROR(
-        in_buf == NULL, done, ret, HG_INVALID_ARG, "NULL input buffer pointer");
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
+    HG_CHECK_ERROR(hg_proc_info->no_response, done, ret, HG_INVALID_ARG,
+        "Cannot hedge RPCs that have no response");
+
+    hedge = (struct hg_hedge *) malloc(
+        sizeof(struct hg_hedge) + count * sizeof(hg_handle_t));
+    HG_CHECK_ERROR(hedge == NULL, done, ret, HG_NOMEM,
+        "Could not allocate hedged call");
+    hedge->callback = callback;
+    hedge->arg = arg;
+    hedge->count = count;
+    /* One reference per forward and one released once all are posted */
+    hg_atomic_init32(&hedge->ref_count, (hg_util_int32_t) count + 1);
+    hg_atomic_init32(&hedge->failed, 0);
+    hg_atomic_init32(&hedge->completed, 0);
+    for (i = 0; i < count; i++) {
+        hedge->handles[i] = handles[i];
+        HG_Core_ref_incr(handles[i]->core_handle);
+    }
 
-    /* Get core input buffer */
-    /* Note: any extra header information will be transmitted with the
-     * control message, not the extra_buf, if the RPC exceeds the eager size
-     * limit.
-     */
-    ret = HG_Core_get_input(handle->core_handle, in_buf, &buf_size);
+    /* Encode input once */
+    ret = hg_set_struct(private_handle, hg_proc_info, HG_INPUT, in_struct,
+        &payload_size, &more_data);
     HG_CHECK_HG_ERROR(
-        done, ret, "Could not get input buffer (%s)", HG_Error_to_string(ret));
+        error, ret, "Could not set input (%s)", HG_Error_to_string(ret));
+
+    for (i = 0; i < count; i++) {
+        struct hg_private_handle *hedge_handle =
+            (struct hg_private_handle *) handles[i];
+        hg_size_t hedge_payload_size = payload_size;
+        hg_bool_t hedge_more_data = more_data;
+        hg_return_t forward_ret = HG_SUCCESS;
+
+        /* No need to send replicas if the call has already completed */
+        if (i > 0 && hg_atomic_get32(&hedge->completed))
+            forward_ret = HG_CANCELED;
+        else if (i > 0)
+            forward_ret = hg_hedge_set_input(private_handle, hedge_handle,
+                hg_proc_info, in_struct, &hedge_payload_size,
+                &hedge_more_data);
+        if (forward_ret == HG_SUCCESS) {
+            hedge_handle->forward_cb = hg_hedge_forward_cb;
+            hedge_handle->forward_arg = hedge;
+            forward_ret = HG_Core_forward_delayed(handles[i]->core_handle,
+                hg_core_forward_cb, hedge_handle,
+                hedge_more_data ? HG_CORE_MORE_DATA : 0, hedge_payload_size,
+                (i > 0) ? delay : 0);
+        }
+        if (forward_ret == HG_SUCCESS) {
+            posted++;
+            continue;
+        }
+        HG_LOG_DEBUG("Could not forward hedged handle %u (%s)", i,
+            HG_Error_to_string(forward_ret));
 
-    *in_buf = (char *) *in_buf + header_offset;
-    if (in_buf_size)
-        *in_buf_size = buf_size - header_offset;
+        /* Handle will not complete, count it as failed */
+        hg_atomic_incr32(&hedge->failed);
+        hg_atomic_decr32(&hedge->ref_count);
+        ret = forward_ret;
+    }
+    HG_CHECK_ERROR_NORET(posted == 0, error,
+        "Could not forward any of the hedged handles (%s)",
+        HG_Error_to_string(ret));
+    ret = HG_SUCCESS;
+
+    if (hg_atomic_decr32(&hedge->ref_count) == 0)
+        hg_hedge_release(hedge);
 
 done:
     return ret;
+
+error:
+    hg_hedge_release(hedge);
+
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Get_output_buf(hg_handle_t handle, void **out_buf, hg_size_t *out_buf_size)
+HG_Forward_batch(hg_handle_t *handles, unsigned int count, hg_cb_t callback,
+    void **args, void **in_structs, unsigned int *posted_ptr)
 {
-    hg_size_t buf_size, header_offset = hg_header_get_size(HG_OUTPUT);
+    struct hg_batch hg_batch = {NULL, NULL, NULL, NULL};
+    unsigned int n = 0, posted = 0;
     hg_return_t ret = HG_SUCCESS;
 
-    HG_CHECK_ERROR(
-        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_ERROR(out_buf == NULL, done, ret, HG_INVALID_ARG,
-        "NULL output buffer pointer");
+    HG_CHECK_ERROR(handles == NULL || in_structs == NULL, done, ret,
+        HG_INVALID_ARG, "NULL handles or input structures");
+    if (count == 0)
+        goto done;
 
-    /* Get core output buffer */
-    /* Note: any extra header information will be transmitted with the
-     * control message, not the extra_buf, if the response exceeds the eager
-     * size limit.
-     */
-    ret = HG_Core_get_output(handle->core_handle, out_buf, &buf_size);
-    HG_CHECK_HG_ERROR(
-        done, ret, "Could not get output buffer (%s)", HG_Error_to_string(ret));
+    ret = hg_batch_alloc(&hg_batch, count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not allocate batch");
 
-    *out_buf = (char *) *out_buf + header_offset;
-    if (out_buf_size)
-        *out_buf_size = buf_size - header_offset;
+    /* Encode all inputs first so that requests are sent back to back */
+    for (n = 0; n < count; n++) {
+        ret = hg_forward_prepare(handles[n], callback, args ? args[n] : NULL,
+            NULL, NULL, in_structs[n], &hg_batch.flags[n],
+            &hg_batch.payload_sizes[n]);
+        if (ret != HG_SUCCESS)
+            break;
+        hg_batch.core_handles[n] = handles[n]->core_handle;
+        hg_batch.args[n] = handles[n];
+    }
+
+    /* Requests whose input was encoded are still sent */
+    if (n > 0) {
+        hg_return_t core_ret = HG_Core_forward_batch(hg_batch.core_handles, n,
+            hg_core_forward_cb, hg_batch.args, hg_batch.flags,
+            hg_batch.payload_sizes, &posted);
+        if (ret == HG_SUCCESS)
+            ret = core_ret;
+    }
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not forward batch (%s)", HG_Error_to_string(ret));
 
 done:
+    hg_batch_free(&hg_batch);
+    if (posted_ptr)
+        *posted_ptr = posted;
+
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Get_input_extra_buf(
-    hg_handle_t handle, void **in_buf, hg_size_t *in_buf_size)
+HG_Respond_raw(hg_handle_t handle, hg_cb_t callback, void *arg,
+    const void *out_buf, hg_size_t out_buf_size)
 {
     struct hg_private_handle *private_handle =
         (struct hg_private_handle *) handle;
+    const struct hg_proc_info *hg_proc_info;
+    hg_size_t payload_size;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
         handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
     HG_CHECK_ERROR(
-        in_buf == NULL, done, ret, HG_INVALID_ARG, "NULL input buffer pointer");
+        out_buf == NULL, done, ret, HG_INVALID_ARG, "NULL output buffer");
 
-    /* No offset if extra buffer since only the user payload is copied */
-    *in_buf = private_handle->in_extra_buf;
-    if (in_buf_size)
-        *in_buf_size = private_handle->in_extra_buf_size;
+    /* Set callback data */
+    private_handle->respond_cb = callback;
+    private_handle->respond_arg = arg;
 
-done:
-    return ret;
-}
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_ERROR(
+        hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
 
-/*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Get_output_extra_buf(
-    hg_handle_t handle, void **out_buf, hg_size_t *out_buf_size)
-{
-    struct hg_private_handle *private_handle =
-        (struct hg_private_handle *) handle;
-    hg_return_t ret = HG_SUCCESS;
+    /* Set pre-encoded output */
+    ret = hg_set_raw(private_handle, hg_proc_info, HG_OUTPUT, out_buf,
+        out_buf_size, &payload_size);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not set raw output (%s)", HG_Error_to_string(ret));
 
-    HG_CHECK_ERROR(
-        handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_ERROR(out_buf == NULL, done, ret, HG_INVALID_ARG,
-        "NULL output buffer pointer");
+    hg_response_cache_store(private_handle, hg_proc_info, payload_size);
 
-    /* No offset if extra buffer since only the user payload is copied */
-    *out_buf = private_handle->out_extra_buf;
-    if (out_buf_size)
-        *out_buf_size = private_handle->out_extra_buf_size;
+    /* Send response back */
+    ret = HG_Core_respond(
+        handle->core_handle, hg_core_respond_cb, handle, 0, payload_size);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not respond (%s)", HG_Error_to_string(ret));
 
 done:
     return ret;
@@ -1914,24 +5361,22 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct)
+HG_Respond_chunk(
+    hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct)
 {
     struct hg_private_handle *private_handle =
         (struct hg_private_handle *) handle;
-    const struct hg_proc_info *hg_proc_info = NULL;
-    hg_size_t payload_size = 0;
+    const struct hg_proc_info *hg_proc_info;
+    hg_size_t payload_size;
     hg_bool_t more_data = HG_FALSE;
-    hg_uint8_t flags = 0;
     hg_return_t ret = HG_SUCCESS;
 
     HG_CHECK_ERROR(
         handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_ERROR(handle->info.addr == HG_ADDR_NULL, done, ret, HG_INVALID_ARG,
-        "NULL target addr");
 
     /* Set callback data */
-    private_handle->forward_cb = callback;
-    private_handle->forward_arg = arg;
+    private_handle->respond_cb = callback;
+    private_handle->respond_arg = arg;
 
     /* Retrieve RPC data */
     hg_proc_info =
@@ -1939,35 +5384,32 @@ HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct)
     HG_CHECK_ERROR(
         hg_proc_info == NULL, done, ret, HG_FAULT, "Could not get proc info");
 
-    /* Set input struct */
-    ret = hg_set_struct(private_handle, hg_proc_info, HG_INPUT, in_struct,
+    /* Set output struct */
+    ret = hg_set_struct(private_handle, hg_proc_info, HG_OUTPUT, out_struct,
         &payload_size, &more_data);
     HG_CHECK_HG_ERROR(
-        done, ret, "Could not set input (%s)", HG_Error_to_string(ret));
-
-    /* Set more data flag on handle so that handle_more_callback is triggered */
-    if (more_data)
-        flags |= HG_CORE_MORE_DATA;
+        done, ret, "Could not set output (%s)", HG_Error_to_string(ret));
+    HG_CHECK_ERROR(more_data, done, ret, HG_MSGSIZE,
+        "Response chunks must fit into the output buffer");
 
-    /* Set no response flag if no response required */
-    if (hg_proc_info->no_response)
-        flags |= HG_CORE_NO_RESPONSE;
+    /* Only the final response would be cached */
+    private_handle->response_cacheable = HG_FALSE;
 
-    /* Send request */
-    ret = HG_Core_forward(
-        handle->core_handle, hg_core_forward_cb, handle, flags, payload_size);
-    if (ret == HG_AGAIN)
-        goto done;
-    HG_CHECK_HG_ERROR(
-        done, ret, "Could not forward call (%s)", HG_Error_to_string(ret));
+    /* Send chunk back */
+    ret = HG_Core_respond_chunk(
+        handle->core_handle, hg_core_respond_cb, handle, payload_size);
+    HG_CHECK_HG_ERROR(done, ret, "Could not send response chunk (%s)",
+        HG_Error_to_string(ret));
 
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct)
+static hg_return_t
+hg_respond_prepare(hg_handle_t handle, hg_cb_t callback, void *arg,
+    void *out_struct, hg_uint8_t *flags_ptr, hg_size_t *payload_size_ptr,
+    hg_bool_t *sent_ptr)
 {
     struct hg_private_handle *private_handle =
         (struct hg_private_handle *) handle;
@@ -1977,6 +5419,8 @@ HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct)
     hg_uint8_t flags = 0;
     hg_return_t ret = HG_SUCCESS;
 
+    *sent_ptr = HG_FALSE;
+
     HG_CHECK_ERROR(
         handle == HG_HANDLE_NULL, done, ret, HG_INVALID_ARG, "NULL HG handle");
 
@@ -1996,10 +5440,45 @@ HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct)
     HG_CHECK_HG_ERROR(
         done, ret, "Could not set output (%s)", HG_Error_to_string(ret));
 
+    /* Push payload that did not fit directly into the response buffer of
+     * origin, response is sent once the transfer has completed */
+    if (more_data) {
+        ret = hg_put_resp_payload(private_handle, payload_size, sent_ptr);
+        HG_CHECK_HG_ERROR(done, ret, "Could not put response payload (%s)",
+            HG_Error_to_string(ret));
+        if (*sent_ptr)
+            goto done;
+    }
+
     /* Set more data flag on handle so that handle_more_callback is triggered */
     if (more_data)
         flags |= HG_CORE_MORE_DATA;
 
+    /* Cache encoded response if it fits into the core buffer */
+    if (!more_data)
+        hg_response_cache_store(private_handle, hg_proc_info, payload_size);
+
+    *flags_ptr = flags;
+    *payload_size_ptr = payload_size;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct)
+{
+    hg_size_t payload_size = 0;
+    hg_uint8_t flags = 0;
+    hg_bool_t sent;
+    hg_return_t ret;
+
+    ret = hg_respond_prepare(handle, callback, arg, out_struct, &flags,
+        &payload_size, &sent);
+    if (ret != HG_SUCCESS || sent)
+        goto done;
+
     /* Send response back */
     ret = HG_Core_respond(
         handle->core_handle, hg_core_respond_cb, handle, flags, payload_size);
@@ -2010,6 +5489,103 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Respond_batch(hg_handle_t *handles, unsigned int count, hg_cb_t callback,
+    void **args, void **out_structs, unsigned int *posted_ptr)
+{
+    struct hg_batch hg_batch = {NULL, NULL, NULL, NULL};
+    unsigned int i = 0, n = 0, posted = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handles == NULL || out_structs == NULL, done, ret,
+        HG_INVALID_ARG, "NULL handles or output structures");
+    if (count == 0)
+        goto done;
+
+    ret = hg_batch_alloc(&hg_batch, count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not allocate batch");
+
+    /* Encode all outputs first, responses that are pushed to origin are sent
+     * on their own once their transfer completes */
+    for (i = 0; i < count; i++) {
+        hg_bool_t sent;
+
+        ret = hg_respond_prepare(handles[i], callback, args ? args[i] : NULL,
+            out_structs[i], &hg_batch.flags[n], &hg_batch.payload_sizes[n],
+            &sent);
+        if (ret != HG_SUCCESS)
+            break;
+        if (sent)
+            continue;
+        hg_batch.core_handles[n] = handles[i]->core_handle;
+        hg_batch.args[n] = handles[i];
+        n++;
+    }
+
+    /* Responses whose output was encoded are still sent */
+    if (n > 0) {
+        hg_return_t core_ret = HG_Core_respond_batch(hg_batch.core_handles, n,
+            hg_core_respond_cb, hg_batch.args, hg_batch.flags,
+            hg_batch.payload_sizes, &posted);
+        if (ret == HG_SUCCESS)
+            ret = core_ret;
+    }
+
+    /* Handles responded in order stop at the first one that failed */
+    if (posted < n)
+        for (i = 0; handles[i]->core_handle != hg_batch.core_handles[posted];
+             i++)
+            continue;
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not respond in batch (%s)", HG_Error_to_string(ret));
+
+done:
+    hg_batch_free(&hg_batch);
+    if (posted_ptr)
+        *posted_ptr = i;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_batch_alloc(struct hg_batch *hg_batch, unsigned int count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_batch->core_handles =
+        (hg_core_handle_t *) malloc(count * sizeof(hg_core_handle_t));
+    hg_batch->args = (void **) malloc(count * sizeof(void *));
+    hg_batch->payload_sizes = (hg_size_t *) malloc(count * sizeof(hg_size_t));
+    hg_batch->flags = (hg_uint8_t *) malloc(count * sizeof(hg_uint8_t));
+    HG_CHECK_ERROR(hg_batch->core_handles == NULL || hg_batch->args == NULL ||
+                       hg_batch->payload_sizes == NULL ||
+                       hg_batch->flags == NULL,
+        error, ret, HG_NOMEM, "Could not allocate batch arrays");
+
+    return ret;
+
+error:
+    hg_batch_free(hg_batch);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_batch_free(struct hg_batch *hg_batch)
+{
+    free(hg_batch->core_handles);
+    free(hg_batch->args);
+    free(hg_batch->payload_sizes);
+    free(hg_batch->flags);
+    hg_batch->core_handles = NULL;
+    hg_batch->args = NULL;
+    hg_batch->payload_sizes = NULL;
+    hg_batch->flags = NULL;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Progress(hg_context_t *context, unsigned int timeout)
@@ -2027,6 +5603,35 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+int
+HG_Context_get_fd(const hg_context_t *context)
+{
+    HG_CHECK_ERROR_NORET(context == NULL, error, "NULL HG context");
+
+    return HG_Core_context_get_fd(context->core_context);
+
+error:
+    return -1;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_process_ready(hg_context_t *context, unsigned int *timeout_ptr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
+
+    ret = HG_Core_context_process_ready(context->core_context, timeout_ptr);
+    HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_AGAIN, done,
+        "Could not make progress on context (%s)", HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Trigger(hg_context_t *context, unsigned int timeout, unsigned int max_count,
@@ -2047,6 +5652,26 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Trigger_batch(hg_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
+
+    ret = HG_Core_trigger_batch(
+        context->core_context, timeout, max_count, actual_count);
+    HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
+        "Could not trigger operations from context (%s)",
+        HG_Error_to_string(ret));
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Cancel(hg_handle_t handle)
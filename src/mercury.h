@@ -234,6 +234,49 @@ HG_Class_set_data(
 static HG_INLINE void *
 HG_Class_get_data(const hg_class_t *hg_class);
 
+/**
+ * Set instrumentation hooks of a given class. See HG_Core_class_set_hooks()
+ * for details, the HG handle of an event can be retrieved from
+ * HG_Core_get_data(info->handle).
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param hooks [IN]            pointer to hooks (copied, may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Class_set_hooks(hg_class_t *hg_class, const struct hg_core_hooks *hooks);
+
+/**
+ * Retrieve statistics of a given class, globally and for each registered
+ * RPC. See HG_Core_class_get_stats() for details.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param stats [OUT]           pointer to class stats (may be NULL)
+ * \param rpc_stats [OUT]       array of RPC stats (may be NULL)
+ * \param rpc_count [IN/OUT]    pointer to number of RPC stats (may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Class_get_stats(hg_class_t *hg_class, struct hg_class_stats *stats,
+    struct hg_rpc_stats *rpc_stats, hg_uint32_t *rpc_count);
+
+/**
+ * Retrieve a latency summary of stage \stage of RPC \id. See
+ * HG_Core_class_get_latency() for details.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param stage [IN]            latency stage
+ * \param stats [OUT]           pointer to latency summary
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Class_get_latency(hg_class_t *hg_class, hg_id_t id,
+    hg_latency_stage_t stage, struct hg_latency_stats *stats);
+
 /**
  * Set callback to be called on HG handle creation. Handles are created
  * both on HG_Create() and HG_Context_create() calls. This allows upper layers
@@ -250,6 +293,21 @@ HG_PUBLIC hg_return_t
 HG_Class_set_handle_create_callback(hg_class_t *hg_class,
     hg_return_t (*callback)(hg_handle_t, void *), void *arg);
 
+/**
+ * Retrieve the context that serves a shard of the RPC service when the class
+ * was initialized with a shard count (see hg_init_info.shard_count). These
+ * contexts are created by HG_Init_opt(), progressed and triggered by their
+ * own thread, and destroyed by HG_Finalize(). Callbacks of RPCs received on
+ * a shard are executed by the thread of that shard.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param shard_id [IN]         shard ID (also the context ID)
+ *
+ * \return Pointer to HG context or NULL if class is not sharded
+ */
+HG_PUBLIC hg_context_t *
+HG_Class_get_shard_context(hg_class_t *hg_class, hg_uint8_t shard_id);
+
 /**
  * Create a new context. Must be destroyed by calling HG_Context_destroy().
  *
@@ -294,6 +352,26 @@ HG_Context_create_id(hg_class_t *hg_class, hg_uint8_t id);
 HG_PUBLIC hg_return_t
 HG_Context_destroy(hg_context_t *context);
 
+/**
+ * Start progress threads on context: one thread polls the context and hands
+ * completions to \thread_count threads that trigger them. RPC callbacks may
+ * therefore be executed concurrently and the application should not call
+ * HG_Trigger() on that context. Threads that are already running are stopped
+ * first, passing a \thread_count of 0 only stops them. Threads are also
+ * stopped when the context is destroyed.
+ *
+ * \remark Concurrent calls to HG_Progress() on the same context are safe,
+ * only one thread polls at a time while others wait for completions.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param thread_count [IN]     number of trigger threads
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Context_set_progress_threads(
+    hg_context_t *context, unsigned int thread_count);
+
 /**
  * Retrieve the class used to create the given context.
  *
@@ -338,6 +416,17 @@ HG_Context_set_data(
 static HG_INLINE void *
 HG_Context_get_data(const hg_context_t *context);
 
+/**
+ * Retrieve current queue depths and posted buffer levels of a given context.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param stats [OUT]           pointer to context stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Context_get_stats(hg_context_t *context, struct hg_context_stats *stats);
+
 /**
  * Dynamically register a function func_name as an RPC as well as the
  * RPC callback executed when the RPC request ID associated to func_name is
@@ -490,6 +579,184 @@ HG_PUBLIC hg_return_t
 HG_Registered_disabled_response(
     hg_class_t *hg_class, hg_id_t id, hg_bool_t *disabled);
 
+/**
+ * Execute the RPC callback of a given RPC ID in a coroutine. The callback
+ * runs on the thread that triggers it but may call HG_Await() to yield back
+ * to progress until an operation that it posted completes, it is then
+ * resumed from the completion callback of that operation. Callbacks must not
+ * return before all the operations that they awaited have completed.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param enable [IN]           boolean (HG_TRUE to enable
+ *                                       HG_FALSE to disable)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_enable_coroutine(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t enable);
+
+/**
+ * Initialize \await from a coroutine RPC callback before posting the
+ * operation that it awaits. HG_Await_cb() must then be passed as the
+ * operation callback with \await as argument, for instance:
+ *     HG_Await_init(&await);
+ *     HG_Forward(handle, HG_Await_cb, &await, &in_struct);
+ *     ret = HG_Await(&await);
+ *
+ * \param await [IN/OUT]        pointer to await struct
+ *
+ * \return HG_SUCCESS or HG_OPNOTSUPPORTED if not called from a coroutine
+ */
+HG_PUBLIC hg_return_t
+HG_Await_init(struct hg_await *await);
+
+/**
+ * Completion callback of awaited operations.
+ *
+ * \param callback_info [IN]    pointer to callback info
+ *
+ * \return HG_SUCCESS
+ */
+HG_PUBLIC hg_return_t
+HG_Await_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Yield back to progress until the operation of \await has completed.
+ * Callback info of the operation is available in await->info on return.
+ *
+ * \param await [IN/OUT]        pointer to await struct
+ *
+ * \return return value of the awaited operation
+ */
+HG_PUBLIC hg_return_t
+HG_Await(struct hg_await *await);
+
+/**
+ * Set priority of a given RPC ID, this is typically called right after
+ * HG_Register(). Callbacks of RPCs with a higher priority are executed first
+ * by HG_Trigger(), so that latency-sensitive RPCs are not delayed by floods
+ * of other completions. Lower priorities are still periodically given a turn.
+ * By default, all RPCs have HG_PRIORITY_NORMAL priority.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param priority [IN]         priority
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_set_priority(
+    hg_class_t *hg_class, hg_id_t id, hg_priority_t priority);
+
+/**
+ * Get priority of a given RPC ID.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param priority [OUT]        pointer to priority
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_priority(
+    hg_class_t *hg_class, hg_id_t id, hg_priority_t *priority);
+
+/**
+ * Disable checksum of RPC arguments for a given RPC ID. This avoids the cost
+ * of computing and verifying a checksum for RPCs whose integrity is already
+ * guaranteed by the transport. The setting must be identical on the origin
+ * and on the target. This has no effect if mercury was built without checksum
+ * support. By default, checksums of all RPCs are computed.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param disable [IN]          boolean (HG_TRUE to disable
+ *                                       HG_FALSE to re-enable)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_disable_checksum(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t disable);
+
+/**
+ * Check if checksum is disabled for a given RPC ID
+ * (i.e., HG_Registered_disable_checksum() has been called for this RPC ID).
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param disabled [OUT]        boolean (HG_TRUE if disabled
+ *                                       HG_FALSE if enabled)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_disabled_checksum(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t *disabled);
+
+/**
+ * Compress encoded input and output parameters of a given RPC ID with codec
+ * when their size is at least threshold bytes. Compressed parameters that fit
+ * into the eager buffer do not require an extra bulk transfer. Compressed
+ * data is only sent if it is smaller than the original data. The same codec
+ * must be set on the origin and on the target. Setting a NULL codec disables
+ * compression, which is the default. Compression is not supported with XDR.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param codec [IN]            pointer to codec (must remain valid while the
+ *                              RPC ID is registered)
+ * \param threshold [IN]        minimum size of parameters to compress
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_set_codec(hg_class_t *hg_class, hg_id_t id,
+    const struct hg_codec *codec, hg_size_t threshold);
+
+/**
+ * Cache encoded responses of a given idempotent RPC ID on the target. When
+ * the encoded input of a request matches a cached entry, the cached output is
+ * sent back directly without executing the RPC callback or encoding the
+ * output again. Entries expire after \ttl ms and oldest entries are evicted
+ * once \max_size bytes (inputs and outputs) are cached. Only responses that
+ * fit into the eager buffer are cached and outputs must not depend on the
+ * origin (e.g., they must not contain bulk handles). Setting a \max_size or
+ * \ttl of 0 disables caching, which is the default. Must not be called while
+ * RPCs of that ID are being processed.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param max_size [IN]         max size of cached entries
+ * \param ttl [IN]              time to live of cached entries (ms)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_set_response_cache(
+    hg_class_t *hg_class, hg_id_t id, hg_size_t max_size, unsigned int ttl);
+
+/**
+ * Prefetch bulk data of a given RPC ID on the target. When a request arrives,
+ * a prefix of the input is decoded with \proc_cb, which must store the bulk
+ * handle of the origin into the hg_bulk_t that its data argument points to,
+ * and the entire region of that bulk handle is pulled before the RPC callback
+ * is executed. The RPC callback then retrieves the data with
+ * HG_Get_input_bulk() instead of issuing the transfer itself. Setting a NULL
+ * \proc_cb disables prefetching, which is the default.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param proc_cb [IN]          proc callback decoding the bulk handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_set_prefetch(
+    hg_class_t *hg_class, hg_id_t id, hg_proc_cb_t proc_cb);
+
 /**
  * Lookup an addr from a peer address/name. Addresses need to be
  * freed by calling HG_Addr_free(). After completion, user callback is
@@ -527,6 +794,24 @@ HG_Addr_lookup1(hg_context_t *context, hg_cb_t callback, void *arg,
 HG_PUBLIC hg_return_t
 HG_Addr_lookup2(hg_class_t *hg_class, const char *name, hg_addr_t *addr);
 
+/**
+ * Lookup count addrs from an array of peer addresses/names, e.g., to connect
+ * to all peers at startup. Names are resolved at once when the NA plugin
+ * supports it, which is much cheaper than calling HG_Addr_lookup2() for each
+ * name. Addresses need to be freed by calling HG_Addr_free(). If an error is
+ * returned, no address is returned.
+ *
+ * \param hg_class [IN/OUT]     pointer to HG class
+ * \param names [IN]            array of lookup names
+ * \param count [IN]            number of names
+ * \param addrs [OUT]           array of abstract addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_lookup_batch(hg_class_t *hg_class, const char *const names[],
+    hg_size_t count, hg_addr_t addrs[]);
+
 /**
  * Free the addr.
  *
@@ -552,6 +837,72 @@ HG_Addr_free(hg_class_t *hg_class, hg_addr_t addr);
 HG_PUBLIC hg_return_t
 HG_Addr_set_remove(hg_class_t *hg_class, hg_addr_t addr);
 
+/**
+ * Cancel all forwards that are in flight to addr at once, e.g., when the
+ * peer is known to have failed. Each canceled forward completes with
+ * HG_CANCELED as if HG_Cancel() had been called on its handle. Forwards
+ * issued while canceling and local forwards are not canceled. If \remove is
+ * set, addr is also set to be removed (see HG_Addr_set_remove()).
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addr [IN]             abstract address
+ * \param remove [IN]           also set address to be removed
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_cancel_all(hg_class_t *hg_class, hg_addr_t addr, hg_bool_t remove);
+
+/**
+ * Start establishing connections to count addrs ahead of time (e.g., at job
+ * start, after HG_Addr_lookup_batch()) so that the first RPC to each peer
+ * does not pay connection setup. Connections are set up in parallel and
+ * complete asynchronously as progress is made; RPCs may be forwarded to these
+ * addresses at any time. Transports that do not need or do not support it
+ * ignore this call.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_warmup(hg_class_t *hg_class, const hg_addr_t addrs[], hg_size_t count);
+
+/**
+ * Get the last load advertised by the target of addr in a response, i.e., the
+ * number of requests that it was processing when it responded. Targets only
+ * advertise their load if hg_init_info::load_feedback is set, 0 is returned
+ * if no load was advertised yet.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addr [IN]             abstract address
+ * \param load [OUT]            pointer to returned load
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_get_load(hg_class_t *hg_class, hg_addr_t addr, hg_uint32_t *load);
+
+/**
+ * Select a target among count replicas using the power of two choices: two
+ * distinct addrs are picked at random and the one that advertised the lowest
+ * load (see HG_Addr_get_load()) is returned. Since loads are refreshed by
+ * every response, selection follows load changes within one RPC. The
+ * returned address is not duplicated.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ * \param addr [OUT]            pointer to selected address
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_select(hg_class_t *hg_class, const hg_addr_t addrs[], hg_size_t count,
+    hg_addr_t *addr);
+
 /**
  * Access self address. Address must be freed with HG_Addr_free().
  *
@@ -607,6 +958,59 @@ HG_PUBLIC hg_return_t
 HG_Addr_to_string(
     hg_class_t *hg_class, char *buf, hg_size_t *buf_size, hg_addr_t addr);
 
+/**
+ * Get size required to serialize count addresses with
+ * HG_Addr_serialize_batch().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return Non-negative value
+ */
+HG_PUBLIC hg_size_t
+HG_Addr_get_serialize_batch_size(
+    hg_class_t *hg_class, const hg_addr_t addrs[], hg_size_t count);
+
+/**
+ * Serialize count addresses into a buffer, e.g., to exchange an address book
+ * at startup. Addresses share a single header and are stored as fixed-width
+ * entries, which is more compact and much cheaper to deserialize than
+ * addresses serialized one by one. Only the addresses of the main NA class
+ * are serialized (shared-memory addresses are not included).
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param buf [IN/OUT]          pointer to destination buffer
+ * \param buf_size [IN]         buffer size
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_serialize_batch(hg_class_t *hg_class, void *buf, hg_size_t buf_size,
+    const hg_addr_t addrs[], hg_size_t count);
+
+/**
+ * Deserialize addresses from a buffer filled by HG_Addr_serialize_batch().
+ * Addresses are resolved at once when the NA plugin supports it (e.g., with a
+ * single AV insertion). If addrs is NULL, only the number of addresses is
+ * returned in count. Otherwise count must hold the size of the addrs array
+ * and is set to the number of addresses returned. Addresses need to be freed
+ * by calling HG_Addr_free(). If an error is returned, no address is returned.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param buf [IN]              pointer to buffer used for deserialization
+ * \param buf_size [IN]         buffer size
+ * \param addrs [OUT]           array of abstract addresses
+ * \param count [IN/OUT]        pointer to number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_deserialize_batch(hg_class_t *hg_class, const void *buf,
+    hg_size_t buf_size, hg_addr_t addrs[], hg_size_t *count);
+
 /**
  * Initiate a new HG RPC using the specified function ID and the local/remote
  * target defined by addr. The HG handle created can be used to query input
@@ -734,6 +1138,56 @@ HG_Get_input(hg_handle_t handle, void *in_struct);
 HG_PUBLIC hg_return_t
 HG_Free_input(hg_handle_t handle, void *in_struct);
 
+/**
+ * Decode only a prefix of the input using proc_cb instead of the input proc
+ * that was registered, for instance to make a routing decision from the
+ * leading fields without deserializing the whole payload. The prefix is not
+ * checksummed. The input can later be decoded in full with HG_Get_input(),
+ * or passed on unmodified using HG_Get_input_buf(). Partial input must be
+ * freed using HG_Free_input_partial() with the same proc_cb before
+ * HG_Get_input() is called on that handle.
+ *
+ * \param handle [IN]           HG handle
+ * \param proc_cb [IN]          proc callback decoding a prefix of the input
+ * \param in_struct [IN/OUT]    pointer to partial input structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Get_input_partial(hg_handle_t handle, hg_proc_cb_t proc_cb, void *in_struct);
+
+/**
+ * Free resources allocated when deserializing a prefix of the input with
+ * HG_Get_input_partial().
+ *
+ * \param handle [IN]           HG handle
+ * \param proc_cb [IN]          proc callback passed to HG_Get_input_partial()
+ * \param in_struct [IN/OUT]    pointer to partial input structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Free_input_partial(
+    hg_handle_t handle, hg_proc_cb_t proc_cb, void *in_struct);
+
+/**
+ * Get bulk data that was pulled on arrival of the request (see
+ * HG_Registered_set_prefetch()). If the transfer has already completed,
+ * callback is executed before this call returns, otherwise it is executed
+ * once the transfer completes, as for HG_Bulk_transfer(). The local bulk
+ * handle passed to the callback holds the data, which remains valid until
+ * the handle is destroyed. Returns HG_NOENTRY if no data was prefetched, in
+ * which case the data must be pulled with HG_Bulk_transfer().
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Get_input_bulk(hg_handle_t handle, hg_cb_t callback, void *arg);
+
 /**
  * Get output from handle (requires registration of output proc to deserialize
  * parameters). Output must be freed using HG_Free_output().
@@ -846,6 +1300,40 @@ HG_PUBLIC hg_return_t
 HG_Get_output_extra_buf(
     hg_handle_t handle, void **out_buf, hg_size_t *out_buf_size);
 
+/**
+ * Get encoded input payload that was received, i.e., the exact bytes that
+ * follow the HG header, so that it can be relayed with HG_Forward_raw()
+ * without being decoded and encoded again. Compressed payloads are expanded
+ * and payloads that did not fit into an eager buffer are returned from the
+ * extra buffer. The payload remains valid until the handle is reset or
+ * destroyed.
+ *
+ * \remark Checksums are not verified.
+ *
+ * \param handle [IN]           HG handle
+ * \param in_buf [OUT]          pointer to encoded input
+ * \param in_buf_size [OUT]     pointer to encoded input size
+ *
+ * \return HG_SUCCESS or corresponding HG error code (HG_OPNOTSUPPORTED if
+ * origin uses a different byte order)
+ */
+HG_PUBLIC hg_return_t
+HG_Get_input_raw(hg_handle_t handle, void **in_buf, hg_size_t *in_buf_size);
+
+/**
+ * Get encoded output payload that was received so that it can be relayed
+ * with HG_Respond_raw(). See HG_Get_input_raw().
+ *
+ * \param handle [IN]           HG handle
+ * \param out_buf [OUT]         pointer to encoded output
+ * \param out_buf_size [OUT]    pointer to encoded output size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Get_output_raw(
+    hg_handle_t handle, void **out_buf, hg_size_t *out_buf_size);
+
 /**
  * Set target context ID that will receive and process the RPC request
  * (ID is defined on target context creation, see HG_Context_create_id()).
@@ -858,6 +1346,44 @@ HG_Get_output_extra_buf(
 static HG_INLINE hg_return_t
 HG_Set_target_id(hg_handle_t handle, hg_uint8_t id);
 
+/**
+ * Set key used to pick the target shard of the RPC request when the class
+ * is initialized with a shard count (see hg_init_info.shard_count). RPCs
+ * that share the same RPC ID and key are sent to the same target context,
+ * setting an explicit target ID takes precedence.
+ *
+ * \param handle [IN]           HG handle
+ * \param key [IN]              shard key
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Set_shard_key(hg_handle_t handle, hg_uint64_t key);
+
+/**
+ * Attach a registered buffer that the target may directly write the response
+ * into when the output does not fit into the response message. This saves
+ * the round-trip that is otherwise needed for the origin to pull the
+ * response payload. The descriptor of the buffer is sent along with the input
+ * and is only used if the target decodes it with HG_Get_input(), if the
+ * output is larger than the buffer, the response is transferred as usual.
+ * The bulk handle must be created with HG_BULK_READWRITE or
+ * HG_BULK_WRITE_ONLY and consist of a single segment, an additional reference
+ * is taken and released when the handle is reset or destroyed. Passing
+ * HG_BULK_NULL detaches a previously attached buffer.
+ *
+ * \remark Output that is written to the response buffer is decoded from that
+ * buffer when calling HG_Get_output(), the buffer must therefore not be
+ * modified until HG_Free_output() is called.
+ *
+ * \param handle [IN]           HG handle
+ * \param bulk [IN]             bulk handle of response buffer
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Set_output_bulk(hg_handle_t handle, hg_bulk_t bulk);
+
 /**
  * Forward a call to a local/remote target using an existing HG handle.
  * Input structure can be passed and parameters serialized using a previously
@@ -880,6 +1406,170 @@ HG_Set_target_id(hg_handle_t handle, hg_uint8_t id);
 HG_PUBLIC hg_return_t
 HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct);
 
+/**
+ * Forward a call like HG_Forward() with a deadline of \timeout ms. If no
+ * response has been received by then, the call is canceled and the user
+ * callback is triggered with HG_TIMEOUT. Deadlines are checked while making
+ * progress on the context of the handle.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param in_struct [IN]        pointer to input structure
+ * \param timeout [IN]          timeout (in milliseconds), 0 means no deadline
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_timed(hg_handle_t handle, hg_cb_t callback, void *arg,
+    void *in_struct, unsigned int timeout);
+
+/**
+ * Set up a persistent forward for calls that are repeatedly sent to the
+ * target of \handle. The call is then issued with HG_Forward_start(), as many
+ * times as needed, each start waiting for the previous call to complete.
+ * Starts reuse the tag and request header of the first one instead of
+ * setting them up again. The setup is released by HG_Reset() and
+ * HG_Destroy().
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_init(hg_handle_t handle, hg_cb_t callback, void *arg);
+
+/**
+ * Start a call set up by HG_Forward_init() with a new input. The callback
+ * passed to HG_Forward_init() is triggered on completion.
+ *
+ * \param handle [IN]           HG handle
+ * \param in_struct [IN]        pointer to input structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_start(hg_handle_t handle, void *in_struct);
+
+/**
+ * Forward the same call to several targets to cut tail latency. The call is
+ * forwarded to handles[0] first and to the remaining handles (replicas) once
+ * \delay ms have elapsed, or immediately if \delay is 0. The input structure
+ * is encoded once and the encoded buffer is shared by all handles, unless
+ * it exceeds the eager size or their targets require a different encoding
+ * (e.g., SM or self targets).
+ *
+ * The user callback is triggered once, by the first forward that succeeds;
+ * info.forward.handle then refers to that handle and HG_Get_output() must
+ * be called on it. Other forwards are canceled, replicas that were not sent
+ * yet are dropped. If all forwards fail, the callback is triggered with the
+ * return code of the last one. Handles must be created for the same RPC ID
+ * and remain referenced until all forwards complete, they can be destroyed
+ * by the user as soon as the callback has been triggered.
+ *
+ * \param handles [IN]          array of HG handles, primary first
+ * \param count [IN]            number of handles
+ * \param delay [IN]            delay (in milliseconds) before sending replicas
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param in_struct [IN]        pointer to input structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_hedged(hg_handle_t *handles, unsigned int count,
+    unsigned int delay, hg_cb_t callback, void *arg, void *in_struct);
+
+/**
+ * Forward several calls at once, e.g., to fan an operation out to many
+ * servers. Inputs are all encoded first, request tags are reserved for the
+ * whole batch and requests are then submitted to NA as a single batch so
+ * that plugins which support it ring the NIC once. Each handle otherwise
+ * behaves as with HG_Forward(): \callback is triggered once per handle with
+ * \args[i] as argument and HG_Get_output() must be called on that handle.
+ * Handles must belong to the same context and may target different
+ * addresses and RPCs. Calls are forwarded in order and forwarding stops at
+ * the first failure: handles before it complete as usual, the others are not
+ * forwarded.
+ *
+ * \param handles [IN]          array of HG handles
+ * \param count [IN]            number of handles
+ * \param callback [IN]         pointer to function callback
+ * \param args [IN]             array of data passed to callback (may be NULL)
+ * \param in_structs [IN]       array of pointers to input structures
+ * \param posted_ptr [OUT]      number of handles forwarded before the first
+ *                              failure (may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_batch(hg_handle_t *handles, unsigned int count, hg_cb_t callback,
+    void **args, void **in_structs, unsigned int *posted_ptr);
+
+/**
+ * Forward a call like HG_Forward() to a target that streams its response.
+ * Each chunk sent by the target with HG_Respond_chunk() triggers
+ * \chunk_callback, in which the chunk must be decoded with HG_Get_output()
+ * and released with HG_Free_output(). The target only sends the next chunk
+ * once that callback has returned. The final response triggers \callback.
+ *
+ * \param handle [IN]           HG handle
+ * \param chunk_callback [IN]   pointer to function callback for chunks
+ * \param chunk_arg [IN]        pointer to data passed to chunk callback
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param in_struct [IN]        pointer to input structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_stream(hg_handle_t handle, hg_cb_t chunk_callback, void *chunk_arg,
+    hg_cb_t callback, void *arg, void *in_struct);
+
+/**
+ * Send a one-way call to \addr without creating a user handle. The input is
+ * encoded into a message buffer taken from the context pool and must fit
+ * into it, no response is sent back by the target and no callback is
+ * triggered on completion. When request coalescing is enabled, one-way calls
+ * to the same target are sent together.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param addr [IN]             target address
+ * \param id [IN]               registered function ID
+ * \param in_struct [IN]        pointer to input structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code (HG_MSGSIZE if input
+ * does not fit)
+ */
+HG_PUBLIC hg_return_t
+HG_Send_oneway(hg_context_t *context, hg_addr_t addr, hg_id_t id,
+    void *in_struct);
+
+/**
+ * Forward a call with pre-encoded input, e.g., obtained through
+ * HG_Get_input_raw() on a handle received by a forwarding tier, bypassing
+ * input procs. The input is copied into the eager buffer of the handle
+ * unless it already points to it (see HG_Get_input_buf()), only its checksum
+ * is computed. The input must fit into that buffer and must have been
+ * encoded for the same kind of target (bulk handles are encoded differently
+ * for local targets). The response is decoded as usual, or relayed with
+ * HG_Get_output_raw().
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param in_buf [IN]           pointer to encoded input
+ * \param in_buf_size [IN]      encoded input size
+ *
+ * \return HG_SUCCESS or corresponding HG error code (HG_MSGSIZE if input
+ * does not fit)
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_raw(hg_handle_t handle, hg_cb_t callback, void *arg,
+    const void *in_buf, hg_size_t in_buf_size);
+
 /**
  * Respond back to origin using an existing HG handle.
  * Output structure can be passed and parameters serialized using a previously
@@ -901,6 +1591,63 @@ HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct);
 HG_PUBLIC hg_return_t
 HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct);
 
+/**
+ * Respond on several handles at once, e.g., when a server answers requests
+ * that it processed together. Outputs are all encoded first and responses
+ * are then submitted to NA as a single batch. Each handle otherwise behaves
+ * as with HG_Respond(): \callback is triggered once per handle with \args[i]
+ * as argument. Handles must belong to the same context. Responses are sent
+ * in order and sending stops at the first failure.
+ *
+ * \param handles [IN]          array of HG handles
+ * \param count [IN]            number of handles
+ * \param callback [IN]         pointer to function callback
+ * \param args [IN]             array of data passed to callback (may be NULL)
+ * \param out_structs [IN]      array of pointers to output structures
+ * \param posted_ptr [OUT]      number of handles that were responded before
+ *                              the first failure (may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Respond_batch(hg_handle_t *handles, unsigned int count, hg_cb_t callback,
+    void **args, void **out_structs, unsigned int *posted_ptr);
+
+/**
+ * Respond back to origin with pre-encoded output, bypassing output procs.
+ * See HG_Forward_raw() for restrictions.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param out_buf [IN]          pointer to encoded output
+ * \param out_buf_size [IN]     encoded output size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Respond_raw(hg_handle_t handle, hg_cb_t callback, void *arg,
+    const void *out_buf, hg_size_t out_buf_size);
+
+/**
+ * Send one chunk of a streamed response, the response is terminated by
+ * HG_Respond(). Chunks are delivered in order to the chunk callback of
+ * HG_Forward_stream() and must fit into the output buffer. Only one chunk
+ * is in flight at a time: the next chunk or the final response can only be
+ * sent once \callback has been triggered, i.e., once the origin has consumed
+ * the chunk. Not supported on calls forwarded to self.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param out_struct [IN]       pointer to output structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Respond_chunk(
+    hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct);
+
 /**
  * Try to progress RPC execution for at most timeout until timeout is reached or
  * any completion has occurred.
@@ -916,6 +1663,35 @@ HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct);
 HG_PUBLIC hg_return_t
 HG_Progress(hg_context_t *context, unsigned int timeout);
 
+/**
+ * Get a fd that becomes readable when progress can be made on context, so
+ * that context can be driven from an external event loop (epoll, libuv, etc)
+ * instead of calling HG_Progress(). The fd must only be watched for
+ * readability and must not be read from.
+ *
+ * \param context [IN]          pointer to HG context
+ *
+ * \return Non-negative fd on success or negative if context has no fd
+ */
+HG_PUBLIC int
+HG_Context_get_fd(const hg_context_t *context);
+
+/**
+ * Make non-blocking progress on context once its fd is readable and arm
+ * notifications of the fd, which may be watched in edge-triggered mode.
+ * Callbacks must still be executed with HG_Trigger(). \timeout_ptr is set to
+ * the time (in milliseconds) that the event loop may wait on the fd before
+ * calling this function again, 0 meaning that it must not wait.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param timeout_ptr [OUT]     pointer to max time to wait on the fd
+ *
+ * \return HG_SUCCESS, HG_AGAIN if another thread is progressing context or
+ * corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Context_process_ready(hg_context_t *context, unsigned int *timeout_ptr);
+
 /**
  * Execute at most max_count callbacks. If timeout is non-zero, wait up to
  * timeout before returning. Function can return when at least one or more
@@ -932,6 +1708,23 @@ HG_PUBLIC hg_return_t
 HG_Trigger(hg_context_t *context, unsigned int timeout, unsigned int max_count,
     unsigned int *actual_count);
 
+/**
+ * Execute at most max_count callbacks, same as HG_Trigger() except that
+ * completed operations are dequeued in batches and their callbacks executed
+ * back to back. Prefer this call when a single thread triggers a context that
+ * completes many small operations.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param max_count [IN]        maximum number of callbacks triggered
+ * \param actual_count [IN]     actual number of callbacks triggered
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Trigger_batch(hg_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count);
+
 /**
  * Cancel an ongoing operation.
  *
@@ -1049,6 +1842,30 @@ HG_Class_get_data(const hg_class_t *hg_class)
     return HG_Core_class_get_data(hg_class->core_class);
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Class_set_hooks(hg_class_t *hg_class, const struct hg_core_hooks *hooks)
+{
+    return HG_Core_class_set_hooks(hg_class->core_class, hooks);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Class_get_stats(hg_class_t *hg_class, struct hg_class_stats *stats,
+    struct hg_rpc_stats *rpc_stats, hg_uint32_t *rpc_count)
+{
+    return HG_Core_class_get_stats(
+        hg_class->core_class, stats, rpc_stats, rpc_count);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Class_get_latency(hg_class_t *hg_class, hg_id_t id,
+    hg_latency_stage_t stage, struct hg_latency_stats *stats)
+{
+    return HG_Core_class_get_latency(hg_class->core_class, id, stage, stats);
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_class_t *
 HG_Context_get_class(const hg_context_t *context)
@@ -1078,6 +1895,13 @@ HG_Context_get_data(const hg_context_t *context)
     return HG_Core_context_get_data(context->core_context);
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Context_get_stats(hg_context_t *context, struct hg_context_stats *stats)
+{
+    return HG_Core_context_get_stats(context->core_context, stats);
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_return_t
 HG_Ref_incr(hg_handle_t handle)
@@ -1125,6 +1949,13 @@ HG_Set_target_id(hg_handle_t handle, hg_uint8_t id)
     return HG_Core_set_target_id(handle->core_handle, id);
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Set_shard_key(hg_handle_t handle, hg_uint64_t key)
+{
+    return HG_Core_set_shard_key(handle->core_handle, key);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,600 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_HPP
+#define MERCURY_HPP
+
+#if __cplusplus < 201703L
+#    error "mercury.hpp requires C++17"
+#endif
+
+#include "mercury.h"
+#include "mercury_proc.h"
+#include "mercury_proc_bulk.h"
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Header-only C++ layer over mercury.h. Procs of aggregate structs are
+ * derived at compile time from their fields, which can be:
+ *   - arithmetic and enum types
+ *   - std::string (copied) and std::string_view (decoded in place, valid
+ *     until HG_Free_input() / HG_Free_output() is called)
+ *   - std::vector of any supported type, arrays of arithmetic types are
+ *     processed at once
+ *   - hg_bulk_t
+ *   - nested aggregates of the above (up to HG_CXX_MAX_FIELDS fields)
+ * Fields are encoded one after the other in host byte order, as procs
+ * generated by MERCURY_GEN_PROC() do. Aggregates that only contain
+ * arithmetic types and have no padding are therefore encoded with a single
+ * copy unless byte order differs between peers.
+ *
+ * An RPC is described by a type providing its name and input/output types
+ * (void if none):
+ *
+ *   struct sum_rpc {
+ *       static constexpr const char *name = "sum";
+ *       using input = sum_in_t;
+ *       using output = sum_out_t;
+ *   };
+ *
+ *   hg_id_t id = hg::register_rpc<sum_rpc>(hg_class, sum_rpc_cb);
+ *   hg::handle handle;
+ *   hg::handle::create(context, addr, id, handle);
+ *   hg::forward<sum_rpc>(handle, in, forward_cb, arg);
+ */
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/* Max number of fields of aggregates */
+#define HG_CXX_MAX_FIELDS (16)
+
+namespace hg {
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/**
+ * Owning reference to an HG handle. Copies take an additional reference
+ * (see HG_Ref_incr()), the handle is destroyed when the last reference is
+ * released.
+ */
+class handle {
+public:
+    handle() noexcept = default;
+
+    /* Adopt reference to existing handle */
+    explicit handle(hg_handle_t handle) noexcept : handle_(handle) {}
+
+    handle(const handle &other) noexcept : handle_(other.handle_)
+    {
+        if (handle_ != HG_HANDLE_NULL)
+            (void) HG_Ref_incr(handle_);
+    }
+
+    handle(handle &&other) noexcept : handle_(other.release()) {}
+
+    ~handle() { reset(); }
+
+    handle &
+    operator=(handle other) noexcept
+    {
+        std::swap(handle_, other.handle_);
+        return *this;
+    }
+
+    /**
+     * Create a new handle, see HG_Create().
+     */
+    static hg_return_t
+    create(hg_context_t *context, hg_addr_t addr, hg_id_t id, handle &handle)
+    {
+        hg_handle_t hg_handle = HG_HANDLE_NULL;
+        hg_return_t ret = HG_Create(context, addr, id, &hg_handle);
+
+        if (ret == HG_SUCCESS)
+            handle = hg::handle(hg_handle);
+
+        return ret;
+    }
+
+    hg_handle_t
+    get() const noexcept
+    {
+        return handle_;
+    }
+
+    operator hg_handle_t() const noexcept { return handle_; }
+
+    explicit operator bool() const noexcept
+    {
+        return handle_ != HG_HANDLE_NULL;
+    }
+
+    /* Release ownership without destroying handle */
+    hg_handle_t
+    release() noexcept
+    {
+        return std::exchange(handle_, HG_HANDLE_NULL);
+    }
+
+    void
+    reset() noexcept
+    {
+        if (handle_ != HG_HANDLE_NULL)
+            (void) HG_Destroy(release());
+    }
+
+private:
+    hg_handle_t handle_ = HG_HANDLE_NULL;
+};
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+/**
+ * Process value. Overloaded for every supported type.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param value [IN/OUT]        value
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+template<typename T>
+std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>, hg_return_t>
+proc(hg_proc_t proc, T &value);
+
+template<typename T>
+std::enable_if_t<std::is_aggregate_v<T>, hg_return_t>
+proc(hg_proc_t proc, T &value);
+
+inline hg_return_t
+proc(hg_proc_t proc, std::string &value);
+
+inline hg_return_t
+proc(hg_proc_t proc, std::string_view &value);
+
+template<typename T, typename Alloc>
+hg_return_t
+proc(hg_proc_t proc, std::vector<T, Alloc> &value);
+
+inline hg_return_t
+proc(hg_proc_t proc, hg_bulk_t &value);
+
+/**
+ * Proc callback of type T that can be passed to HG_Register(), NULL if T is
+ * void.
+ */
+template<typename T>
+constexpr hg_proc_cb_t
+proc_cb() noexcept;
+
+/**
+ * Register RPC described by Rpc, see HG_Register_name().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param rpc_cb [IN]           RPC callback
+ *
+ * \return unique ID associated to the registered function
+ */
+template<typename Rpc>
+hg_id_t
+register_rpc(hg_class_t *hg_class, hg_rpc_cb_t rpc_cb);
+
+/**
+ * Forward RPC described by Rpc, see HG_Forward(). \in is only accessed
+ * during the call.
+ */
+template<typename Rpc, typename In = typename Rpc::input>
+std::enable_if_t<!std::is_void_v<In>, hg_return_t>
+forward(hg_handle_t handle, const In &in, hg_cb_t callback, void *arg);
+
+template<typename Rpc>
+std::enable_if_t<std::is_void_v<typename Rpc::input>, hg_return_t>
+forward(hg_handle_t handle, hg_cb_t callback, void *arg);
+
+/**
+ * Respond to RPC described by Rpc, see HG_Respond(). \out is only accessed
+ * during the call.
+ */
+template<typename Rpc, typename Out = typename Rpc::output>
+std::enable_if_t<!std::is_void_v<Out>, hg_return_t>
+respond(hg_handle_t handle, const Out &out, hg_cb_t callback, void *arg);
+
+template<typename Rpc>
+std::enable_if_t<std::is_void_v<typename Rpc::output>, hg_return_t>
+respond(hg_handle_t handle, hg_cb_t callback, void *arg);
+
+/**
+ * Decode input / output of RPC described by Rpc, see HG_Get_input() and
+ * HG_Get_output(). Must be released with free_input() / free_output().
+ */
+template<typename Rpc>
+hg_return_t
+get_input(hg_handle_t handle, typename Rpc::input &in);
+
+template<typename Rpc>
+hg_return_t
+free_input(hg_handle_t handle, typename Rpc::input &in);
+
+template<typename Rpc>
+hg_return_t
+get_output(hg_handle_t handle, typename Rpc::output &out);
+
+template<typename Rpc>
+hg_return_t
+free_output(hg_handle_t handle, typename Rpc::output &out);
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+namespace detail {
+
+/* Convertible to any type, used to count fields of aggregates */
+struct any_field {
+    template<typename T>
+    operator T() const;
+};
+
+/* Number of fields of aggregate T, counted by adding initializers until T
+ * can no longer be brace-initialized */
+template<typename T, typename... Fields>
+constexpr std::size_t
+field_count(long)
+{
+    return sizeof...(Fields);
+}
+
+template<typename T, typename... Fields>
+constexpr auto
+field_count(int) -> decltype(T{Fields{}..., any_field{}}, std::size_t{})
+{
+    return field_count<T, Fields..., any_field>(0);
+}
+
+/* Call f with references to all fields of aggregate value */
+#define HG_CXX_VISIT(n, ...)                                                   \
+    else if constexpr (count == n)                                             \
+    {                                                                          \
+        auto &[__VA_ARGS__] = value;                                           \
+        return f(__VA_ARGS__);                                                 \
+    }
+
+template<typename T, typename F>
+constexpr decltype(auto)
+visit_fields(T &value, F &&f)
+{
+    constexpr std::size_t count = field_count<T>(0);
+    static_assert(count <= HG_CXX_MAX_FIELDS, "Too many fields in aggregate");
+
+    if constexpr (count == 0)
+        return f();
+    HG_CXX_VISIT(1, f1)
+    HG_CXX_VISIT(2, f1, f2)
+    HG_CXX_VISIT(3, f1, f2, f3)
+    HG_CXX_VISIT(4, f1, f2, f3, f4)
+    HG_CXX_VISIT(5, f1, f2, f3, f4, f5)
+    HG_CXX_VISIT(6, f1, f2, f3, f4, f5, f6)
+    HG_CXX_VISIT(7, f1, f2, f3, f4, f5, f6, f7)
+    HG_CXX_VISIT(8, f1, f2, f3, f4, f5, f6, f7, f8)
+    HG_CXX_VISIT(9, f1, f2, f3, f4, f5, f6, f7, f8, f9)
+    HG_CXX_VISIT(10, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10)
+    HG_CXX_VISIT(11, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11)
+    HG_CXX_VISIT(12, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12)
+    HG_CXX_VISIT(13, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13)
+    HG_CXX_VISIT(
+        14, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14)
+    HG_CXX_VISIT(
+        15, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15)
+    HG_CXX_VISIT(16, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13,
+        f14, f15, f16)
+}
+
+#undef HG_CXX_VISIT
+
+template<typename T>
+constexpr bool
+is_plain() noexcept;
+
+/* Total size of fields if all fields are plain, 0 otherwise */
+struct plain_visitor {
+    template<typename... Fields>
+    std::integral_constant<std::size_t,
+        (is_plain<std::remove_cv_t<Fields>>() && ...)
+            ? (sizeof(Fields) + ... + 0)
+            : 0>
+    operator()(Fields &...) const;
+};
+
+/* Plain types are arithmetic types and aggregates of them without padding,
+ * their encoding is the same as their memory representation */
+template<typename T>
+constexpr bool
+is_plain() noexcept
+{
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+        return !std::is_same_v<T, long double>;
+    else if constexpr (std::is_aggregate_v<T> && !std::is_array_v<T> &&
+                       std::is_trivially_copyable_v<T>)
+        return decltype(visit_fields(std::declval<T &>(),
+                   plain_visitor{}))::value == sizeof(T);
+    else
+        return false;
+}
+
+/* Copy memory representation of plain types, only valid if byte order is
+ * the same on both ends */
+inline hg_return_t
+proc_plain(hg_proc_t proc, void *data, hg_size_t size)
+{
+#ifdef HG_HAS_XDR
+    (void) proc;
+    (void) data;
+    (void) size;
+
+    return HG_OPNOTSUPPORTED;
+#else
+    if (HG_PROC_IS_SWAP(proc))
+        return HG_OPNOTSUPPORTED;
+
+    return hg_proc_bytes(proc, data, size);
+#endif
+}
+
+template<typename T>
+hg_return_t
+proc_cb(hg_proc_t proc, void *data)
+{
+    return hg::proc(proc, *static_cast<T *>(data));
+}
+
+} // namespace detail
+
+/*---------------------------------------------------------------------------*/
+template<typename T>
+std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>, hg_return_t>
+proc(hg_proc_t proc, T &value)
+{
+    static_assert(!std::is_same_v<T, long double>,
+        "long double cannot be processed");
+
+    if constexpr (std::is_same_v<T, float>)
+        return hg_proc_float_array(proc, &value, 1);
+    else if constexpr (std::is_same_v<T, double>)
+        return hg_proc_double_array(proc, &value, 1);
+    else if constexpr (sizeof(T) == sizeof(hg_uint8_t))
+        return hg_proc_hg_uint8_t(proc, &value);
+    else if constexpr (sizeof(T) == sizeof(hg_uint16_t))
+        return hg_proc_hg_uint16_t(proc, &value);
+    else if constexpr (sizeof(T) == sizeof(hg_uint32_t))
+        return hg_proc_hg_uint32_t(proc, &value);
+    else {
+        static_assert(sizeof(T) == sizeof(hg_uint64_t), "Unsupported size");
+        return hg_proc_hg_uint64_t(proc, &value);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename T>
+std::enable_if_t<std::is_aggregate_v<T>, hg_return_t>
+proc(hg_proc_t proc, T &value)
+{
+    if constexpr (detail::is_plain<T>()) {
+        /* Fast path, single copy of all fields */
+        if (detail::proc_plain(proc, &value, sizeof(T)) == HG_SUCCESS)
+            return HG_SUCCESS;
+    }
+
+    return detail::visit_fields(value, [proc](auto &...fields) {
+        hg_return_t ret = HG_SUCCESS;
+
+        (void) ((ret = hg::proc(proc, fields), ret == HG_SUCCESS) && ...);
+
+        return ret;
+    });
+}
+
+/*---------------------------------------------------------------------------*/
+inline hg_return_t
+proc(hg_proc_t proc, std::string &value)
+{
+    hg_uint64_t size = value.size();
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint64_t(proc, &size);
+    if (ret != HG_SUCCESS || hg_proc_get_op(proc) == HG_FREE)
+        return ret;
+
+    if (hg_proc_get_op(proc) == HG_DECODE)
+        value.resize(size);
+
+    return hg_proc_bytes(proc, value.data(), size);
+}
+
+/*---------------------------------------------------------------------------*/
+inline hg_return_t
+proc(hg_proc_t proc, std::string_view &value)
+{
+    hg_uint64_t size = value.size();
+    hg_return_t ret;
+    void *buf;
+
+    ret = hg_proc_hg_uint64_t(proc, &size);
+    if (ret != HG_SUCCESS || hg_proc_get_op(proc) == HG_FREE)
+        return ret;
+
+    /* Decoded string points into the proc buffer */
+    buf = hg_proc_save_ptr(proc, size);
+    if (buf == NULL && size > 0)
+        return HG_NOMEM;
+
+    if (hg_proc_get_op(proc) == HG_ENCODE)
+        std::memcpy(buf, value.data(), size);
+    else if (hg_proc_get_op(proc) == HG_DECODE)
+        value = std::string_view(static_cast<const char *>(buf), size);
+
+    return hg_proc_restore_ptr(proc, buf, size);
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename T, typename Alloc>
+hg_return_t
+proc(hg_proc_t proc, std::vector<T, Alloc> &value)
+{
+    hg_uint64_t count = value.size();
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint64_t(proc, &count);
+    if (ret != HG_SUCCESS || hg_proc_get_op(proc) == HG_FREE)
+        return ret;
+
+    if (hg_proc_get_op(proc) == HG_DECODE)
+        value.resize(count);
+
+    /* Process arrays of fixed-width types at once */
+    if constexpr (std::is_same_v<T, float>)
+        return hg_proc_float_array(proc, value.data(), count);
+    else if constexpr (std::is_same_v<T, double>)
+        return hg_proc_double_array(proc, value.data(), count);
+    else if constexpr (std::is_integral_v<T> && sizeof(T) == 1)
+        return hg_proc_bytes(proc, value.data(), count);
+    else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
+        return hg_proc_hg_uint32_array(proc, value.data(), count);
+    else if constexpr (std::is_integral_v<T> && sizeof(T) == 8)
+        return hg_proc_hg_uint64_array(proc, value.data(), count);
+    else {
+        if constexpr (detail::is_plain<T>()) {
+            if (detail::proc_plain(proc, value.data(), count * sizeof(T)) ==
+                HG_SUCCESS)
+                return HG_SUCCESS;
+        }
+
+        for (auto &elem : value) {
+            ret = hg::proc(proc, elem);
+            if (ret != HG_SUCCESS)
+                break;
+        }
+
+        return ret;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+inline hg_return_t
+proc(hg_proc_t proc, hg_bulk_t &value)
+{
+    return hg_proc_hg_bulk_t(proc, &value);
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename T>
+constexpr hg_proc_cb_t
+proc_cb() noexcept
+{
+    if constexpr (std::is_void_v<T>)
+        return nullptr;
+    else
+        return &detail::proc_cb<T>;
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename Rpc>
+hg_id_t
+register_rpc(hg_class_t *hg_class, hg_rpc_cb_t rpc_cb)
+{
+    return HG_Register_name(hg_class, Rpc::name,
+        proc_cb<typename Rpc::input>(), proc_cb<typename Rpc::output>(),
+        rpc_cb);
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename Rpc, typename In>
+std::enable_if_t<!std::is_void_v<In>, hg_return_t>
+forward(hg_handle_t handle, const In &in, hg_cb_t callback, void *arg)
+{
+    static_assert(std::is_same_v<In, typename Rpc::input>,
+        "Input type does not match RPC");
+
+    return HG_Forward(handle, callback, arg, const_cast<In *>(&in));
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename Rpc>
+std::enable_if_t<std::is_void_v<typename Rpc::input>, hg_return_t>
+forward(hg_handle_t handle, hg_cb_t callback, void *arg)
+{
+    return HG_Forward(handle, callback, arg, nullptr);
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename Rpc, typename Out>
+std::enable_if_t<!std::is_void_v<Out>, hg_return_t>
+respond(hg_handle_t handle, const Out &out, hg_cb_t callback, void *arg)
+{
+    static_assert(std::is_same_v<Out, typename Rpc::output>,
+        "Output type does not match RPC");
+
+    return HG_Respond(handle, callback, arg, const_cast<Out *>(&out));
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename Rpc>
+std::enable_if_t<std::is_void_v<typename Rpc::output>, hg_return_t>
+respond(hg_handle_t handle, hg_cb_t callback, void *arg)
+{
+    return HG_Respond(handle, callback, arg, nullptr);
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename Rpc>
+hg_return_t
+get_input(hg_handle_t handle, typename Rpc::input &in)
+{
+    return HG_Get_input(handle, &in);
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename Rpc>
+hg_return_t
+free_input(hg_handle_t handle, typename Rpc::input &in)
+{
+    return HG_Free_input(handle, &in);
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename Rpc>
+hg_return_t
+get_output(hg_handle_t handle, typename Rpc::output &out)
+{
+    return HG_Get_output(handle, &out);
+}
+
+/*---------------------------------------------------------------------------*/
+template<typename Rpc>
+hg_return_t
+free_output(hg_handle_t handle, typename Rpc::output &out)
+{
+    return HG_Free_output(handle, &out);
+}
+
+} // namespace hg
+
+#endif /* MERCURY_HPP */
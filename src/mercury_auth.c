@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_auth.h"
+#include "mercury.h"
+#include "mercury_error.h"
+
+#include "mercury_atomic.h"
+#include "mercury_mem.h"
+#include "mercury_time.h"
+
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#    include <unistd.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Max length of segment names */
+#define HG_AUTH_NAME_MAX (64)
+
+/* Polling interval while another process acquires the key (ms) */
+#define HG_AUTH_POLL_INTERVAL (1)
+
+/* Segment states */
+#define HG_AUTH_EMPTY     (0)
+#define HG_AUTH_ACQUIRING (1)
+#define HG_AUTH_READY     (2)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Shared segment, zero-filled when created */
+struct hg_auth_segment {
+    hg_atomic_int32_t state;   /* Segment state */
+    hg_uint32_t key_size;      /* Key size */
+    char key[HG_AUTH_KEY_MAX]; /* Key */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Generate segment name of credential.
+ */
+static void
+hg_auth_name(hg_uint32_t credential, char *name);
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_auth_name(hg_uint32_t credential, char *name)
+{
+    /* Users may share credentials but not segments */
+#ifdef _WIN32
+    snprintf(name, HG_AUTH_NAME_MAX, "hg_auth-%u", (unsigned int) credential);
+#else
+    snprintf(name, HG_AUTH_NAME_MAX, "hg_auth-%u-%u", (unsigned int) getuid(),
+        (unsigned int) credential);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Auth_key_get(hg_uint32_t credential, hg_auth_acquire_cb_t acquire_cb,
+    void *arg, unsigned int timeout, char *key, hg_size_t *key_size)
+{
+    char name[HG_AUTH_NAME_MAX];
+    struct hg_auth_segment *segment = NULL;
+    hg_time_t deadline, now;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(acquire_cb == NULL, done, ret, HG_INVALID_ARG,
+        "NULL acquire callback");
+    HG_CHECK_ERROR(key == NULL || key_size == NULL, done, ret, HG_INVALID_ARG,
+        "NULL key pointer");
+
+    hg_auth_name(credential, name);
+    segment = (struct hg_auth_segment *) hg_mem_shm_map(
+        name, sizeof(*segment), HG_TRUE);
+    if (segment == NULL) {
+        /* Not cached but key can still be acquired */
+        HG_LOG_WARNING("Could not map auth key segment %s", name);
+        *key_size = HG_AUTH_KEY_MAX;
+        return acquire_cb(credential, arg, key, key_size);
+    }
+
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout));
+
+    for (;;) {
+        hg_util_int32_t state = hg_atomic_get32(&segment->state);
+
+        if (state == HG_AUTH_READY) {
+            *key_size = segment->key_size;
+            memcpy(key, segment->key, (size_t) segment->key_size);
+            break;
+        }
+
+        /* First process to get there acquires the key */
+        if (state == HG_AUTH_EMPTY &&
+            hg_atomic_cas32(
+                &segment->state, HG_AUTH_EMPTY, HG_AUTH_ACQUIRING)) {
+            *key_size = HG_AUTH_KEY_MAX;
+            ret = acquire_cb(credential, arg, key, key_size);
+            if (ret != HG_SUCCESS || *key_size > HG_AUTH_KEY_MAX) {
+                /* Let another process retry */
+                hg_atomic_set32(&segment->state, HG_AUTH_EMPTY);
+                HG_CHECK_HG_ERROR(done, ret, "Could not acquire auth key (%s)",
+                    HG_Error_to_string(ret));
+                HG_GOTO_ERROR(done, ret, HG_OVERFLOW,
+                    "Auth key too large (%zu)", (size_t) *key_size);
+            }
+            segment->key_size = (hg_uint32_t) *key_size;
+            memcpy(segment->key, key, (size_t) *key_size);
+            hg_atomic_fence_release();
+            hg_atomic_set32(&segment->state, HG_AUTH_READY);
+            break;
+        }
+
+        /* Do not wait forever on a process that died while acquiring */
+        hg_time_get_current_ms(&now);
+        if (!hg_time_less(now, deadline)) {
+            HG_LOG_WARNING("Timed out waiting for auth key of credential %u",
+                (unsigned int) credential);
+            *key_size = HG_AUTH_KEY_MAX;
+            ret = acquire_cb(credential, arg, key, key_size);
+            break;
+        }
+        hg_time_sleep(hg_time_from_ms(HG_AUTH_POLL_INTERVAL));
+    }
+
+done:
+    if (segment != NULL)
+        (void) hg_mem_shm_unmap(NULL, segment, sizeof(*segment));
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Auth_key_remove(hg_uint32_t credential)
+{
+    char name[HG_AUTH_NAME_MAX];
+    hg_return_t ret = HG_SUCCESS;
+    int rc;
+
+    hg_auth_name(credential, name);
+    rc = hg_mem_shm_unmap(name, NULL, 0);
+    HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
+        "Could not remove auth key segment %s", name);
+
+done:
+    return ret;
+}
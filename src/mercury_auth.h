@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_AUTH_H
+#define MERCURY_AUTH_H
+
+#include "mercury_types.h"
+
+/* Node-local cache of authorization keys (e.g., Cray DRC cookies passed as
+ * na_init_info::auth_key). Keys are stored in a shared-memory segment named
+ * after the credential so that only the first process of a node acquires the
+ * key from the credential service, other processes of the node, including
+ * processes launched later, read it from the segment. Segments are only
+ * accessible by the user that created them and persist until
+ * HG_Auth_key_remove() is called. */
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/* Callback acquiring the key of credential, the key must be copied to key
+ * (at most HG_AUTH_KEY_MAX bytes) and its size returned in key_size */
+typedef hg_return_t (*hg_auth_acquire_cb_t)(
+    hg_uint32_t credential, void *arg, char *key, hg_size_t *key_size);
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/* Max size of cached keys */
+#define HG_AUTH_KEY_MAX (256)
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Get the key of credential from the node-local cache. If no process of the
+ * node has acquired it yet, acquire_cb is called to acquire it and the key is
+ * added to the cache; processes that concurrently request the same credential
+ * wait for it for up to timeout ms, after which they call acquire_cb
+ * themselves. Keys that could not be acquired are not cached.
+ *
+ * \param credential [IN]       credential ID
+ * \param acquire_cb [IN]       pointer to key acquisition callback
+ * \param arg [IN]              pointer to data passed to acquire_cb
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param key [OUT]             buffer of HG_AUTH_KEY_MAX bytes
+ * \param key_size [OUT]        pointer to returned key size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Auth_key_get(hg_uint32_t credential, hg_auth_acquire_cb_t acquire_cb,
+    void *arg, unsigned int timeout, char *key, hg_size_t *key_size);
+
+/**
+ * Remove the cached key of credential, e.g., once the credential has been
+ * released.
+ *
+ * \param credential [IN]       credential ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Auth_key_remove(hg_uint32_t credential);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_AUTH_H */
@@ -15,12 +15,22 @@
 #include "mercury_private.h"
 
 #include "mercury_atomic.h"
+#include "mercury_atomic_seg_queue.h"
+#include "mercury_crc32c.h"
+#include "mercury_hash_table.h"
 #include "mercury_list.h"
-#include "mercury_thread_condition.h"
-#include "mercury_thread_spin.h"
+#include "mercury_mem.h"
+#include "mercury_probe.h"
+#include "mercury_queue.h"
+#include "mercury_thread.h"
+#include "mercury_thread_mutex.h"
+#include "mercury_thread_pool.h"
 
 #include <stdlib.h>
 #include <string.h>
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
 
 /****************/
 /* Local Macros */
@@ -29,6 +39,46 @@
 /* Limit for number of segments statically allocated */
 #define HG_BULK_STATIC_MAX (8)
 
+/* Number of op IDs cached per thread */
+#define HG_BULK_OP_MAGAZINE_SIZE (16)
+
+/* Segment size of op ID free queue */
+#define HG_BULK_OP_POOL_QUEUE_SIZE (256)
+
+/* Max number of op IDs created when extending pool */
+#define HG_BULK_OP_POOL_EXTEND_MAX (1024)
+
+/* Max number of extra NA op IDs kept by op IDs from pool */
+#define HG_BULK_NA_OP_IDS_RETAIN_MAX (256)
+
+/* Number of cached serializations (with and without SM handles) */
+#define HG_BULK_SERIALIZE_CACHE_MAX (2)
+
+/* Serialized handles are cached once they have been serialized that many
+ * times */
+#define HG_BULK_SERIALIZE_CACHE_THRESHOLD (2)
+
+/* Default number of operations in flight for pipelined transfers */
+#define HG_BULK_PIPELINE_WINDOW_DEFAULT (HG_BULK_STATIC_MAX)
+
+/* Min size of each stripe of a transfer striped across NA rails */
+#define HG_BULK_RAIL_STRIPE_MIN (1 << 16)
+
+/* Min size of each piece of an offloaded self transfer */
+#define HG_BULK_SELF_PIECE_MIN (1 << 16)
+
+/* Self transfers that large bypass caches (larger than last-level caches) */
+#define HG_BULK_SELF_NT_SIZE (1 << 26)
+
+/* Size classes of registered memory pool (powers of two, 4 KB to 1 MB) */
+#define HG_BULK_MEM_SHIFT_MIN   (12)
+#define HG_BULK_MEM_SHIFT_MAX   (20)
+#define HG_BULK_MEM_CLASS_COUNT                                                \
+    (HG_BULK_MEM_SHIFT_MAX - HG_BULK_MEM_SHIFT_MIN + 1)
+
+/* Size of registered regions that pool blocks are carved from */
+#define HG_BULK_MEM_REGION_SIZE (1 << 22)
+
 /* Additional internal bulk flags (can hold up to 8 bits) */
 #define HG_BULK_ALLOC (1 << 4) /* memory is allocated */
 #define HG_BULK_BIND  (1 << 5) /* address is bound to segment */
@@ -88,6 +138,51 @@
     (count > HG_BULK_STATIC_MAX && !(flags & HG_BULK_REGV)) ? (x)->handles.d   \
                                                             : (x)->handles.s
 
+/* Segment shares NA memory handle of previous segment (merged registration) */
+#define HG_BULK_MEM_HANDLE_SHARED(handles, i)                                  \
+    ((i) > 0 && (handles)[i] != NA_MEM_HANDLE_NULL &&                          \
+        (handles)[i] == (handles)[(i) - 1])
+
+/* Offset of segment within its NA memory handle from offset of previous
+ * segment */
+#define HG_BULK_MEM_HANDLE_OFFSET_NEXT(segments, handles, i, offset)           \
+    (HG_BULK_MEM_HANDLE_SHARED(handles, i)                                     \
+            ? (offset) +                                                       \
+                  (hg_size_t) ((segments)[i].base - (segments)[(i) - 1].base)  \
+            : 0)
+
+/* Round address up to page boundary */
+#define HG_BULK_PAGE_CEIL(addr, page_size)                                     \
+    (((addr) + (hg_ptr_t) (page_size) - 1) & ~((hg_ptr_t) (page_size) - 1))
+
+#define HG_BULK_SERIALIZE_CACHE_INDEX(flags) (((flags) & HG_BULK_SM) ? 1 : 0)
+
+/* Handle segments reside on a device */
+#define HG_BULK_IS_DEVICE(x)                                                   \
+    ((x)->attr.mem_type != HG_MEM_TYPE_UNKNOWN &&                              \
+        (x)->attr.mem_type != HG_MEM_TYPE_HOST)
+
+/* Handle describes a strided region */
+#define HG_BULK_IS_STRIDED(x) ((x)->desc.info.stride_count > 0)
+
+/* Device memory can only be accessed through the default NA class, data of
+ * strided handles is never sent eagerly */
+#define HG_BULK_SERIALIZE_FLAGS(x, flags)                                      \
+    (HG_BULK_IS_DEVICE(x)                                                      \
+            ? ((flags) & ~(HG_BULK_EAGER | HG_BULK_SM) & 0xff)                 \
+            : (HG_BULK_IS_STRIDED(x) ? ((flags) & ~HG_BULK_EAGER & 0xff)       \
+                                     : ((flags) & 0xff)))
+
+/* Rails are only sent if the transfer does not go through SM */
+#define HG_BULK_SERIALIZE_HAS_RAILS(x, flags)                                  \
+    ((x)->desc.info.rail_count > 0 && !((flags) & HG_BULK_SM))
+
+/* Serialized handle embeds data (contents of handle may change) */
+#define HG_BULK_SERIALIZE_IS_EAGER(x, flags)                                   \
+    (((flags) & HG_BULK_EAGER) &&                                              \
+        ((x)->desc.info.flags & HG_BULK_READ_ONLY) &&                          \
+        !((x)->desc.info.flags & HG_BULK_VIRT))
+
 #define HG_BULK_NA_OP_IDS(x)                                                   \
     ((x)->op_count > HG_BULK_STATIC_MAX) ? (x)->na_op_ids.d : (x)->na_op_ids.s
 
@@ -161,6 +256,25 @@ struct hg_bulk_na_mem_desc {
     } handles;                                 /* NA mem handles */
 };
 
+/* Layout of a strided region (unused levels have a count of 1) */
+struct hg_bulk_strided {
+    hg_size_t block_len;                           /* Size of blocks */
+    struct hg_bulk_stride dims[HG_BULK_STRIDE_MAX]; /* Levels */
+};
+
+/* NA rail of a single-segment handle (see hg_init_info.na_rails) */
+struct hg_bulk_rail {
+    na_addr_t na_addr;             /* Origin rail address (NULL if local) */
+    na_mem_handle_t na_mem_handle; /* NA memory handle */
+    na_size_t serialize_size;      /* Serialize size of memory handle */
+};
+
+/* Serialized HG bulk handle */
+struct hg_bulk_serialize_cache {
+    hg_size_t size; /* Size of serialized handle */
+    char buf[];     /* Serialized handle (remain last) */
+};
+
 /* HG bulk handle */
 struct hg_bulk {
     struct hg_bulk_desc desc;                /* Bulk descriptor   */
@@ -173,17 +287,27 @@ struct hg_bulk {
 #ifdef NA_HAS_SM
     na_class_t *na_sm_class; /* NA SM class */
 #endif
+    struct hg_bulk_rail *rails;  /* NA rails (desc.info.rail_count) */
     hg_core_addr_t addr;         /* Addr (valid if bound to handle) */
     void *serialize_ptr;         /* Cached serialization buffer */
     hg_size_t serialize_size;    /* Cached serialization size */
+    hg_atomic_int64_t
+        serialize_cache[HG_BULK_SERIALIZE_CACHE_MAX]; /* Serialized forms */
+    hg_atomic_int32_t serialize_count; /* Number of serializations */
     hg_atomic_int32_t ref_count; /* Reference count */
+    struct hg_bulk_attr attr;    /* Memory attributes (local only) */
+    struct hg_bulk_strided strided; /* Layout (desc.info.stride_count) */
+    struct hg_bulk *parent;      /* Parent handle (views only) */
     hg_uint8_t context_id;       /* Context ID (valid if bound to handle) */
+    hg_bool_t eager_ref;         /* Eager data points to serialization buf */
+    hg_bool_t cached;            /* Shared through remote handle cache */
 };
 
 /* HG bulk NA op IDs (not a union as we re-use op IDs) */
 typedef struct {
     na_op_id_t *s[HG_BULK_STATIC_MAX]; /* Static array */
     na_op_id_t **d;                    /* Dynamic array */
+    hg_uint32_t d_count;               /* Number of dynamic op IDs */
 } hg_bulk_na_op_id_t;
 
 /* HG Bulk op ID */
@@ -191,16 +315,25 @@ struct hg_bulk_op_id {
     struct hg_completion_entry
         hg_completion_entry;              /* Entry in completion queue */
     struct hg_cb_info callback_info;      /* Callback info struct */
-    HG_LIST_ENTRY(hg_bulk_op_id) pending; /* Pending list entry */
     struct hg_bulk_op_pool *op_pool;      /* Pool that op ID belongs to */
     hg_cb_t callback;                     /* Pointer to function */
     hg_bulk_na_op_id_t na_op_ids;         /* NA operations IDs */
 #ifdef NA_HAS_SM
     hg_bulk_na_op_id_t na_sm_op_ids; /* NA SM operations IDs */
 #endif
+    na_op_id_t *na_rail_op_ids[HG_CORE_RAIL_MAX]; /* NA rail op IDs */
+    hg_uint32_t rail_op_count; /* Number of operations posted on rails */
     hg_core_context_t *core_context;      /* Context */
     na_class_t *na_class;                 /* NA class */
     na_context_t *na_context;             /* NA context */
+    struct hg_bulk_pipeline *pipeline;    /* Pipeline (if pipelined) */
+    struct hg_bulk_list_entry *list;      /* Entries (if list transfer) */
+    hg_uint32_t list_count;               /* Number of list entries */
+    hg_bulk_progress_cb_t progress_cb;    /* Partial progress callback */
+    void *progress_arg;                   /* Partial progress callback arg */
+    hg_bulk_chunk_cb_t chunk_cb;          /* Chunk completion callback */
+    void *chunk_arg;                      /* Chunk completion callback arg */
+    hg_size_t size;                       /* Size of transfer */
     hg_atomic_int32_t status;             /* Operation status */
     hg_atomic_int32_t op_completed_count; /* Number of operations completed */
     hg_atomic_int32_t ref_count;          /* Refcount */
@@ -209,15 +342,67 @@ struct hg_bulk_op_id {
     hg_bool_t reuse;                      /* Re-use op ID once ref_count is 0 */
 };
 
+/* Per-thread cache of op IDs */
+struct hg_bulk_op_magazine {
+    struct hg_bulk_op_id *op_ids[HG_BULK_OP_MAGAZINE_SIZE]; /* Cached IDs */
+    HG_LIST_ENTRY(hg_bulk_op_magazine) entry; /* Entry in pool list */
+    unsigned int count;                       /* Number of cached IDs */
+};
+
 /* Pool of op IDs */
 struct hg_bulk_op_pool {
-    hg_thread_mutex_t extend_mutex;           /* To extend pool */
-    hg_thread_cond_t extend_cond;             /* To extend pool */
-    hg_core_context_t *core_context;          /* Context */
-    HG_LIST_HEAD(hg_bulk_op_id) pending_list; /* Pending op IDs */
-    hg_thread_spin_t pending_list_lock;       /* Pending list lock */
-    unsigned long count;                      /* Number of op IDs */
-    hg_bool_t extending;                      /* When extending the pool */
+    hg_thread_mutex_t extend_mutex;         /* To extend pool/add magazines */
+    hg_core_context_t *core_context;        /* Context */
+    struct hg_atomic_seg_queue *free_queue; /* Free op IDs */
+    HG_LIST_HEAD(hg_bulk_op_magazine) magazines; /* Magazines of threads */
+    hg_thread_key_t magazine_key;           /* Key to magazine of thread */
+    unsigned long count;                    /* Number of op IDs */
+};
+
+/* Registered memory region */
+struct hg_bulk_mem_region {
+    HG_LIST_ENTRY(hg_bulk_mem_region) entry; /* Entry in pool list */
+    char *base;                              /* Base address */
+    hg_size_t size;                          /* Size of region */
+    na_mem_handle_t na_mem_handle;           /* NA memory handle */
+#ifdef NA_HAS_SM
+    na_mem_handle_t na_sm_mem_handle; /* NA SM memory handle */
+#endif
+    int size_class; /* Size class of blocks (-1 if single allocation) */
+};
+
+/* Pool of registered memory */
+struct hg_bulk_mem_pool {
+    hg_thread_mutex_t mutex;                     /* Pool lock */
+    hg_core_class_t *core_class;                 /* Core class */
+    HG_LIST_HEAD(hg_bulk_mem_region) regions;    /* Registered regions */
+    void *free_lists[HG_BULK_MEM_CLASS_COUNT];   /* Free blocks per class */
+    hg_atomic_int32_t region_count;              /* Number of regions */
+};
+
+/* Serialized form of remote handle, used as cache key */
+struct hg_bulk_cache_key {
+    const void *buf; /* Serialized handle */
+    hg_size_t size;  /* Size of serialized handle */
+};
+
+/* Cached remote handle */
+struct hg_bulk_cache_entry {
+    HG_QUEUE_ENTRY(hg_bulk_cache_entry) entry; /* Entry in eviction queue */
+    struct hg_bulk_cache_key key;              /* Key (points to buf) */
+    struct hg_bulk *hg_bulk;                   /* Deserialized handle */
+    hg_bool_t referenced;                      /* Hit since last eviction */
+    char buf[];                                /* Key data (remain last) */
+};
+
+/* Cache of deserialized remote handles, entries are evicted in insertion
+ * order unless they were hit since they were last considered (CLOCK) */
+struct hg_bulk_cache {
+    hg_thread_mutex_t mutex;                  /* Cache lock */
+    hg_hash_table_t *table;                   /* Key -> entry */
+    HG_QUEUE_HEAD(hg_bulk_cache_entry) queue; /* Eviction queue */
+    hg_uint32_t count;                        /* Number of entries */
+    hg_uint32_t max_count;                    /* Max number of entries */
 };
 
 /* Wrapper on top of memcpy */
@@ -232,6 +417,73 @@ typedef na_return_t (*na_bulk_op_t)(na_class_t *na_class, na_context_t *context,
     na_offset_t remote_offset, na_size_t data_size, na_addr_t remote_addr,
     na_uint8_t remote_id, na_op_id_t *op_id);
 
+/* Position within a list of segments */
+struct hg_bulk_cursor {
+    const struct hg_bulk_segment *segments; /* Segments */
+    na_mem_handle_t *mem_handles;           /* NA memory handles */
+    struct hg_bulk_segment segment;         /* Segment if contiguous */
+    hg_uint32_t count;                      /* Number of segments */
+    hg_uint32_t index;                      /* Current segment index */
+    hg_size_t offset;                       /* Offset within segment */
+    hg_size_t handle_offset;                /* Offset of segment in handle */
+    const struct hg_bulk_strided *strided;  /* Layout (offset within blocks) */
+};
+
+/* Pipeline slot (one per NA operation in flight) */
+struct hg_bulk_pipeline_slot {
+    struct hg_bulk_op_id *hg_bulk_op_id; /* Op ID that slot belongs to */
+    na_op_id_t *na_op_id;                /* NA op ID of slot */
+    hg_size_t offset;                    /* Offset of chunk in transfer */
+    hg_size_t size;                      /* Size of chunk in flight */
+};
+
+/* Pipelined transfer state */
+struct hg_bulk_pipeline {
+    hg_thread_mutex_t mutex;       /* Protect cursors and counters */
+    struct hg_bulk_cursor origin;  /* Origin cursor */
+    struct hg_bulk_cursor local;   /* Local cursor */
+    na_bulk_op_t na_bulk_op;       /* NA operation */
+    na_addr_t na_origin_addr;      /* NA origin addr */
+    hg_size_t chunk_size;          /* Max size of operations */
+    hg_size_t remaining;           /* Size left to issue */
+    hg_size_t transferred;         /* Size transferred */
+    hg_uint32_t inflight;          /* Number of operations in flight */
+    hg_uint32_t slot_count;        /* Number of slots */
+    hg_uint8_t origin_id;          /* Origin context ID */
+    struct hg_bulk_pipeline_slot slots[]; /* Slots (remain last) */
+};
+
+/* Entry of a list transfer (after merging of adjacent ranges) */
+struct hg_bulk_list_entry {
+    struct hg_bulk *origin;  /* Origin handle */
+    struct hg_bulk *local;   /* Local handle */
+    hg_size_t origin_offset; /* Offset in origin segments */
+    hg_size_t local_offset;  /* Offset in local segments */
+    hg_size_t size;          /* Size of transfer */
+    hg_uint32_t op_count;    /* Number of NA operations (0 if copied) */
+};
+
+/* Piece of a self transfer copied by a thread of the self copy pool */
+struct hg_bulk_self_piece {
+    struct hg_thread_work thread_work;   /* Thread pool work */
+    struct hg_bulk_self_copy *self_copy; /* Copy that piece belongs to */
+    hg_size_t offset;                    /* Offset of piece in transfer */
+    hg_size_t size;                      /* Size of piece */
+};
+
+/* Self transfer offloaded to the self copy pool */
+struct hg_bulk_self_copy {
+    struct hg_bulk_op_id *hg_bulk_op_id;           /* Op ID of transfer */
+    const struct hg_bulk_segment *origin_segments; /* Origin segments */
+    const struct hg_bulk_segment *local_segments;  /* Local segments */
+    hg_bulk_copy_op_t copy_op;                     /* Copy operation */
+    hg_size_t origin_offset;                       /* Origin offset */
+    hg_size_t local_offset;                        /* Local offset */
+    hg_uint32_t origin_count;                      /* Origin segment count */
+    hg_uint32_t local_count;                       /* Local segment count */
+    struct hg_bulk_self_piece pieces[];            /* Pieces (remain last) */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -241,7 +493,8 @@ typedef na_return_t (*na_bulk_op_t)(na_class_t *na_class, na_context_t *context,
  */
 static hg_return_t
 hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
-    const hg_size_t *lens, hg_uint8_t flags, struct hg_bulk **hg_bulk_ptr);
+    const hg_size_t *lens, hg_uint8_t flags, const struct hg_bulk_attr *attr,
+    struct hg_bulk **hg_bulk_ptr);
 
 /**
  * Free handle.
@@ -249,13 +502,55 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
 static hg_return_t
 hg_bulk_free(struct hg_bulk *hg_bulk);
 
+/**
+ * Create view of handle.
+ */
+static hg_return_t
+hg_bulk_create_view(struct hg_bulk *hg_bulk_parent, hg_size_t offset,
+    hg_size_t size, struct hg_bulk **hg_bulk_ptr);
+
+/**
+ * Share window of NA memory descriptors with a view.
+ */
+static void
+hg_bulk_view_na_mem_descs(struct hg_bulk_na_mem_desc *view_mem_descs,
+    struct hg_bulk_na_mem_desc *parent_mem_descs, hg_uint32_t parent_count,
+    hg_uint8_t flags, hg_uint32_t first, hg_uint32_t count);
+
 /**
  * Create NA memory descriptors.
  */
 static hg_return_t
 hg_bulk_create_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
-    na_class_t *na_class, struct hg_bulk_segment *segments, hg_uint32_t count,
-    hg_uint8_t flags);
+    na_class_t *na_class, struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    struct hg_bulk_segment *segments, hg_uint32_t count, hg_uint8_t flags,
+    const struct hg_bulk_attr *attr);
+
+/**
+ * Get offset of segment within its NA memory handle.
+ */
+static hg_size_t
+hg_bulk_mem_handle_offset(const struct hg_bulk_segment *segments,
+    const na_mem_handle_t *mem_handles, hg_size_t index);
+
+/**
+ * Get index of the only non-empty segment of handle, if any.
+ */
+static hg_bool_t
+hg_bulk_get_contig_segment(
+    const struct hg_bulk *hg_bulk, hg_uint32_t *index_ptr);
+
+/**
+ * Register single segment of handle on NA rails.
+ */
+static hg_return_t
+hg_bulk_create_rails(struct hg_bulk *hg_bulk, hg_uint8_t flags);
+
+/**
+ * Free NA rails of handle.
+ */
+static hg_return_t
+hg_bulk_free_rails(struct hg_bulk *hg_bulk);
 
 /**
  * Free NA memory descriptors.
@@ -269,16 +564,16 @@ hg_bulk_free_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
  */
 static hg_return_t
 hg_bulk_register(na_class_t *na_class, void *base, na_size_t len,
-    unsigned long flags, na_mem_handle_t *mem_handle_ptr,
-    na_size_t *serialize_size_ptr);
+    unsigned long flags, const struct hg_bulk_attr *attr,
+    na_mem_handle_t *mem_handle_ptr, na_size_t *serialize_size_ptr);
 
 /**
  * Register multiple segments.
  */
 static hg_return_t
 hg_bulk_register_segments(na_class_t *na_class, struct na_segment *segments,
-    na_size_t count, unsigned long flags, na_mem_handle_t *mem_handle_ptr,
-    na_size_t *serialize_size_ptr);
+    na_size_t count, unsigned long flags, const struct hg_bulk_attr *attr,
+    na_mem_handle_t *mem_handle_ptr, na_size_t *serialize_size_ptr);
 
 /**
  * Deregister segment.
@@ -286,6 +581,38 @@ hg_bulk_register_segments(na_class_t *na_class, struct na_segment *segments,
 static hg_return_t
 hg_bulk_deregister(na_class_t *na_class, na_mem_handle_t mem_handle);
 
+/**
+ * Allocate and register new region of pool (pool lock must be held).
+ */
+static hg_return_t
+hg_bulk_mem_region_create(struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    hg_size_t size, int size_class,
+    struct hg_bulk_mem_region **hg_bulk_mem_region_ptr);
+
+/**
+ * Deregister and free region of pool (pool lock must be held).
+ */
+static void
+hg_bulk_mem_region_destroy(struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    struct hg_bulk_mem_region *hg_bulk_mem_region);
+
+/**
+ * Find region of pool that contains [base, base + len) (pool lock must be
+ * held).
+ */
+static struct hg_bulk_mem_region *
+hg_bulk_mem_region_find(struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    const char *base, hg_size_t len);
+
+/**
+ * Create NA memory handle for segment if it lies within a registered region
+ * of the pool, handle is left to NA_MEM_HANDLE_NULL otherwise.
+ */
+static hg_return_t
+hg_bulk_mem_pool_get_handle(struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    na_class_t *na_class, void *base, na_size_t len, unsigned long flags,
+    na_mem_handle_t *mem_handle_ptr, na_size_t *serialize_size_ptr);
+
 /**
  * Get serialize size.
  */
@@ -299,6 +626,36 @@ static hg_size_t
 hg_bulk_get_serialize_size_mem_descs(
     struct hg_bulk_na_mem_desc *na_mem_descs, hg_uint32_t count);
 
+/**
+ * Get serialize size of NA rails.
+ */
+static hg_size_t
+hg_bulk_get_serialize_size_rails(struct hg_bulk *hg_bulk);
+
+/**
+ * Get cached serialized handle for flags if any.
+ */
+static HG_INLINE struct hg_bulk_serialize_cache *
+hg_bulk_serialize_cache_get(struct hg_bulk *hg_bulk, hg_uint8_t flags)
+{
+    return (struct hg_bulk_serialize_cache *) hg_atomic_get64(
+        &hg_bulk->serialize_cache[HG_BULK_SERIALIZE_CACHE_INDEX(flags)]);
+}
+
+/**
+ * Keep copy of serialized handle for flags.
+ */
+static void
+hg_bulk_serialize_cache_set(struct hg_bulk *hg_bulk, hg_uint8_t flags,
+    const void *buf, hg_size_t buf_size);
+
+/**
+ * Drop cached serialized handles, must be called whenever the serialized
+ * form of the handle changes.
+ */
+static void
+hg_bulk_serialize_cache_invalidate(struct hg_bulk *hg_bulk);
+
 /**
  * Serialize bulk handle.
  */
@@ -315,11 +672,39 @@ hg_bulk_serialize_mem_descs(na_class_t *na_class, char **buf_ptr,
     const struct hg_bulk_segment *segments, hg_uint32_t count);
 
 /**
- * Deserialize bulk handle.
+ * Serialize NA rails (addresses and memory handles).
+ */
+static hg_return_t
+hg_bulk_serialize_rails(
+    char **buf_ptr, hg_size_t *buf_size_left, struct hg_bulk *hg_bulk);
+
+/**
+ * Deserialize bulk handle. If \eager_ref is set, eager data is not copied and
+ * segments point directly to \buf.
  */
 static hg_return_t
 hg_bulk_deserialize(hg_core_class_t *core_class, struct hg_bulk **hg_bulk_ptr,
-    const void *buf, hg_size_t buf_size);
+    const void *buf, hg_size_t buf_size, hg_bool_t eager_ref);
+
+/**
+ * Hash cache key.
+ */
+static unsigned int
+hg_bulk_cache_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare cache keys.
+ */
+static int
+hg_bulk_cache_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Get handle from cache or deserialize it and add it to the cache.
+ */
+static hg_return_t
+hg_bulk_cache_get(struct hg_bulk_cache *hg_bulk_cache,
+    hg_core_class_t *core_class, struct hg_bulk **hg_bulk_ptr, const void *buf,
+    hg_size_t buf_size);
 
 /**
  * Deserialize NA memory descriptors.
@@ -329,6 +714,13 @@ hg_bulk_deserialize_mem_descs(na_class_t *na_class, const char **buf_ptr,
     hg_size_t *buf_size_left, struct hg_bulk_na_mem_desc *na_mem_descs,
     const struct hg_bulk_segment *segments, hg_uint32_t count);
 
+/**
+ * Deserialize NA rails, rails that are not known locally are skipped.
+ */
+static hg_return_t
+hg_bulk_deserialize_rails(
+    const char **buf_ptr, hg_size_t *buf_size_left, struct hg_bulk *hg_bulk);
+
 /**
  * Access bulk handle and get segment addresses/sizes.
  */
@@ -358,6 +750,19 @@ hg_bulk_op_create(
 static hg_return_t
 hg_bulk_op_destroy(struct hg_bulk_op_id *hg_bulk_op_id);
 
+/**
+ * Create count new operation IDs and add them to the pool.
+ */
+static hg_return_t
+hg_bulk_op_pool_extend(
+    struct hg_bulk_op_pool *hg_bulk_op_pool, unsigned long count);
+
+/**
+ * Get magazine of calling thread (allocated on first use, may be NULL).
+ */
+static struct hg_bulk_op_magazine *
+hg_bulk_op_magazine_get(struct hg_bulk_op_pool *hg_bulk_op_pool);
+
 /**
  * Retrive bulk operation ID from pool.
  */
@@ -365,16 +770,86 @@ static hg_return_t
 hg_bulk_op_pool_get(struct hg_bulk_op_pool *hg_bulk_op_pool,
     struct hg_bulk_op_id **hg_bulk_op_id_ptr);
 
+/**
+ * Release bulk operation ID to magazine of thread or free queue of pool if
+ * magazine is NULL or full.
+ */
+static void
+hg_bulk_op_pool_release(struct hg_bulk_op_pool *hg_bulk_op_pool,
+    struct hg_bulk_op_magazine *hg_bulk_op_magazine,
+    struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Destroy extra NA op IDs.
+ */
+static hg_return_t
+hg_bulk_na_op_ids_free(
+    na_class_t *na_class, hg_bulk_na_op_id_t *hg_bulk_na_op_ids);
+
+/**
+ * Check arguments and start bulk transfer.
+ */
+static hg_return_t
+hg_bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_progress_cb_t progress_cb, void *progress_arg,
+    hg_bulk_chunk_cb_t chunk_cb, void *chunk_arg, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_op_id_t *op_id);
+
 /**
  * Bulk transfer.
  */
 static hg_return_t
 hg_bulk_transfer(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
-    hg_bulk_op_t op, struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
+    hg_bulk_progress_cb_t progress_cb, void *progress_arg,
+    hg_bulk_chunk_cb_t chunk_cb, void *chunk_arg, hg_bulk_op_t op,
+    struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
     struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
     struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
     hg_op_id_t *op_id);
 
+/**
+ * Bulk transfer of a list of ranges under a single op ID.
+ */
+static hg_return_t
+hg_bulk_transfer_list(hg_core_context_t *core_context, hg_cb_t callback,
+    void *arg, hg_bulk_op_t op, struct hg_core_addr *origin_addr,
+    hg_uint8_t origin_id, const struct hg_bulk_transfer_desc *transfers,
+    hg_uint32_t count, hg_op_id_t *op_id);
+
+/**
+ * Initialize cursors of list entry.
+ */
+static void
+hg_bulk_list_entry_cursors(const struct hg_bulk_list_entry *entry,
+    struct hg_bulk_cursor *origin, struct hg_bulk_cursor *local);
+
+/**
+ * Release handles and entries of list transfer.
+ */
+static hg_return_t
+hg_bulk_list_release(struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Locate 64-bit value at offset, returning its address and the NA memory
+ * handle and offset that expose it.
+ */
+static hg_return_t
+hg_bulk_atomic_locate(struct hg_bulk *hg_bulk, na_mem_handle_t *mem_handles,
+    hg_size_t offset, void **ptr, na_mem_handle_t *mem_handle,
+    na_offset_t *mem_offset);
+
+/**
+ * Bulk atomic.
+ */
+static hg_return_t
+hg_bulk_atomic(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
+    hg_bulk_atomic_op_t op, hg_uint64_t operand, hg_uint64_t compare,
+    struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
+    struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
+    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_op_id_t *op_id);
+
 /**
  * Bulk transfer to self.
  */
@@ -418,6 +893,43 @@ hg_bulk_memcpy_get(hg_ptr_t local_address, hg_size_t local_offset,
         (const void *) (remote_address + remote_offset), data_size);
 }
 
+/**
+ * Non-temporal memcpy.
+ */
+static void
+hg_bulk_memcpy_nt(void *dest, const void *src, size_t n);
+
+/**
+ * Memcpy that bypasses caches.
+ */
+static void
+hg_bulk_memcpy_put_nt(hg_ptr_t local_address, hg_size_t local_offset,
+    hg_ptr_t remote_address, hg_size_t remote_offset, hg_size_t data_size);
+
+/**
+ * Memcpy that bypasses caches.
+ */
+static void
+hg_bulk_memcpy_get_nt(hg_ptr_t local_address, hg_size_t local_offset,
+    hg_ptr_t remote_address, hg_size_t remote_offset, hg_size_t data_size);
+
+/**
+ * Split self transfer across threads of the self copy pool.
+ */
+static hg_return_t
+hg_bulk_transfer_self_offload(hg_thread_pool_t *pool,
+    hg_uint32_t thread_count, hg_bulk_copy_op_t copy_op,
+    const struct hg_bulk_segment *origin_segments, hg_uint32_t origin_count,
+    hg_size_t origin_offset, const struct hg_bulk_segment *local_segments,
+    hg_uint32_t local_count, hg_size_t local_offset, hg_size_t size,
+    struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Copy piece of offloaded self transfer.
+ */
+static HG_THREAD_RETURN_TYPE
+hg_bulk_self_piece_copy(void *arg);
+
 /**
  * Bulk transfer over NA.
  */
@@ -426,13 +938,84 @@ hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t na_origin_addr,
     hg_uint8_t origin_id, const struct hg_bulk_segment *origin_segments,
     hg_uint32_t origin_count, na_mem_handle_t *origin_mem_handles,
     hg_uint8_t origin_flags, hg_size_t origin_offset,
+    const struct hg_bulk_strided *origin_strided,
     const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
     na_mem_handle_t *local_mem_handles, hg_uint8_t local_flags,
+    hg_size_t local_offset, const struct hg_bulk_strided *local_strided,
+    hg_size_t size, struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Pipelined bulk transfer over NA.
+ */
+static hg_return_t
+hg_bulk_transfer_pipeline(na_bulk_op_t na_bulk_op, na_addr_t na_origin_addr,
+    hg_uint8_t origin_id, const struct hg_bulk_cursor *origin,
+    const struct hg_bulk_cursor *local, hg_size_t size, hg_size_t chunk_size,
+    hg_uint32_t max_inflight, hg_bulk_na_op_id_t *hg_bulk_na_op_ids,
+    struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Bulk transfer striped across default NA class and NA rails.
+ */
+static hg_return_t
+hg_bulk_transfer_rails(hg_bulk_op_t op, na_addr_t na_origin_addr,
+    hg_uint8_t origin_id, struct hg_bulk *hg_bulk_origin,
+    hg_size_t origin_offset, struct hg_bulk *hg_bulk_local,
+    hg_size_t local_offset, hg_size_t size, hg_uint32_t stripe_count,
+    struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Initialize cursor at offset. Cursors of strided regions use the single
+ * segment of the region and keep track of the offset within its blocks.
+ */
+static void
+hg_bulk_cursor_init(struct hg_bulk_cursor *cursor,
+    const struct hg_bulk_segment *segments, hg_uint32_t count,
+    na_mem_handle_t *mem_handles, hg_bool_t contig,
+    const struct hg_bulk_strided *strided, hg_size_t offset, hg_size_t size);
+
+/**
+ * Get size of contiguous data at cursor and its offset within the current
+ * segment of the cursor.
+ */
+static HG_INLINE hg_size_t
+hg_bulk_cursor_next(struct hg_bulk_cursor *cursor, hg_size_t *segment_offset);
+
+/**
+ * Translate offset within the blocks of a strided region into an offset
+ * within the region.
+ */
+static HG_INLINE hg_size_t
+hg_bulk_strided_translate(
+    const struct hg_bulk_strided *strided, hg_size_t offset);
+
+/**
+ * Bulk transfer to self of strided regions.
+ */
+static hg_return_t
+hg_bulk_transfer_self_strided(hg_bulk_op_t op, struct hg_bulk *hg_bulk_origin,
+    hg_size_t origin_offset, struct hg_bulk *hg_bulk_local,
     hg_size_t local_offset, hg_size_t size,
     struct hg_bulk_op_id *hg_bulk_op_id);
 
 /**
- * Get number of required operations to transfer data.
+ * Post next chunk of pipelined transfer using slot.
+ */
+static na_return_t
+hg_bulk_pipeline_post(struct hg_bulk_op_id *hg_bulk_op_id,
+    struct hg_bulk_pipeline_slot *slot);
+
+/**
+ * Get NA op IDs for count operations, allocating extra op IDs if needed.
+ */
+static hg_return_t
+hg_bulk_na_op_ids_get(struct hg_bulk_op_id *hg_bulk_op_id,
+    hg_bulk_na_op_id_t *hg_bulk_na_op_ids, hg_uint32_t count,
+    na_op_id_t ***na_op_ids_ptr);
+
+/**
+ * Get number of required operations to transfer data. Operations are not
+ * larger than chunk_size if chunk_size is not 0.
  */
 static hg_uint32_t
 hg_bulk_transfer_get_op_count(const struct hg_bulk_segment *origin_segments,
@@ -440,7 +1023,7 @@ hg_bulk_transfer_get_op_count(const struct hg_bulk_segment *origin_segments,
     hg_size_t origin_segment_start_offset,
     const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
     hg_size_t local_segment_start_index, hg_size_t local_segment_start_offset,
-    hg_size_t size);
+    hg_size_t size, hg_size_t chunk_size);
 
 /**
  * Transfer segments.
@@ -492,6 +1075,19 @@ hg_bulk_na_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
 static int
 hg_bulk_transfer_cb(const struct na_cb_info *callback_info);
 
+/**
+ * Pipelined transfer callback.
+ */
+static int
+hg_bulk_transfer_pipeline_cb(const struct na_cb_info *callback_info);
+
+/**
+ * Report bulk event \type to instrumentation hook if one is set.
+ */
+static HG_INLINE void
+hg_bulk_hook(struct hg_bulk_op_id *hg_bulk_op_id, hg_hook_type_t type,
+    hg_bulk_op_t op, hg_size_t size, hg_return_t ret);
+
 /**
  * Complete operation ID.
  */
@@ -510,7 +1106,8 @@ hg_bulk_cancel(struct hg_bulk_op_id *hg_bulk_op_id);
 
 static hg_return_t
 hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
-    const hg_size_t *lens, hg_uint8_t flags, struct hg_bulk **hg_bulk_ptr)
+    const hg_size_t *lens, hg_uint8_t flags, const struct hg_bulk_attr *attr,
+    struct hg_bulk **hg_bulk_ptr)
 {
     struct hg_bulk *hg_bulk = NULL;
     struct hg_bulk_segment *segments;
@@ -534,6 +1131,22 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
     hg_bulk->desc.info.flags = flags;
     hg_atomic_init32(&hg_bulk->ref_count, 1);
 
+    if (attr) {
+        hg_bulk->attr = *attr;
+
+        /* Device memory is only registered with the default NA class and
+         * cannot be allocated internally */
+        if (HG_BULK_IS_DEVICE(hg_bulk)) {
+            HG_CHECK_ERROR(bufs == NULL, error, ret, HG_INVALID_ARG,
+                "Device memory must be provided");
+#ifdef NA_HAS_SM
+            na_sm_class = NULL;
+            hg_bulk->na_sm_class = NULL;
+#endif
+        } else
+            attr = NULL;
+    }
+
     if (count > HG_BULK_STATIC_MAX) {
         /* Allocate segments */
         hg_bulk->desc.segments.d = (struct hg_bulk_segment *) calloc(
@@ -605,7 +1218,7 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
         /* Register segments */
         ret =
             hg_bulk_register_segments(na_class, (struct na_segment *) segments,
-                count, flags, &hg_bulk->na_mem_descs.handles.s[0],
+                count, flags, attr, &hg_bulk->na_mem_descs.handles.s[0],
                 &hg_bulk->na_mem_descs.serialize_sizes.s[0]);
         HG_CHECK_HG_ERROR(error, ret, "Could not register segments");
 
@@ -613,7 +1226,7 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
         if (na_sm_class) {
             /* Register segments */
             ret = hg_bulk_register_segments(na_sm_class,
-                (struct na_segment *) segments, count, flags,
+                (struct na_segment *) segments, count, flags, NULL,
                 &hg_bulk->na_sm_mem_descs.handles.s[0],
                 &hg_bulk->na_sm_mem_descs.serialize_sizes.s[0]);
             HG_CHECK_HG_ERROR(
@@ -621,21 +1234,31 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
         }
 #endif
     } else {
-        /* Register segments individually */
-        ret = hg_bulk_create_na_mem_descs(
-            &hg_bulk->na_mem_descs, na_class, segments, count, flags);
+        /* Register segments individually (pool only holds host memory) */
+        struct hg_bulk_mem_pool *hg_bulk_mem_pool =
+            attr ? NULL : hg_core_class_get_bulk_mem_pool(core_class);
+
+        ret = hg_bulk_create_na_mem_descs(&hg_bulk->na_mem_descs, na_class,
+            hg_bulk_mem_pool, segments, count, flags, attr);
         HG_CHECK_HG_ERROR(error, ret, "Could not create NA mem descriptors");
 
 #ifdef NA_HAS_SM
         if (na_sm_class) {
-            ret = hg_bulk_create_na_mem_descs(
-                &hg_bulk->na_sm_mem_descs, na_sm_class, segments, count, flags);
+            ret = hg_bulk_create_na_mem_descs(&hg_bulk->na_sm_mem_descs,
+                na_sm_class, hg_bulk_mem_pool, segments, count, flags, NULL);
             HG_CHECK_HG_ERROR(
                 error, ret, "Could not create NA SM mem descriptors");
         }
 #endif
     }
 
+    /* Contiguous host handles are also registered on rails for striping */
+    if (HG_Core_class_get_na_rail_count(core_class) > 0 && !attr &&
+        hg_bulk_get_contig_segment(hg_bulk, NULL)) {
+        ret = hg_bulk_create_rails(hg_bulk, flags);
+        HG_CHECK_HG_ERROR(error, ret, "Could not register segment on rails");
+    }
+
     *hg_bulk_ptr = hg_bulk;
 
     return ret;
@@ -660,6 +1283,20 @@ hg_bulk_free(struct hg_bulk *hg_bulk)
     if (hg_atomic_decr32(&hg_bulk->ref_count))
         goto done;
 
+    /* Views only hold a reference to the memory of their parent */
+    if (hg_bulk->parent) {
+        struct hg_bulk *hg_bulk_parent = hg_bulk->parent;
+
+        if (hg_bulk->desc.info.flags & HG_BULK_BIND) {
+            ret = HG_Core_addr_free(hg_bulk->addr);
+            HG_CHECK_HG_ERROR(done, ret, "Could not free addr");
+        }
+        hg_bulk_serialize_cache_invalidate(hg_bulk);
+        free(hg_bulk);
+
+        return hg_bulk_free(hg_bulk_parent);
+    }
+
     /* Deregister segments */
     if (hg_bulk->desc.info.flags & HG_BULK_REGV ||
         (hg_bulk->desc.info.segment_count == 1)) {
@@ -693,6 +1330,11 @@ hg_bulk_free(struct hg_bulk *hg_bulk)
 #endif
     }
 
+    if (hg_bulk->rails) {
+        ret = hg_bulk_free_rails(hg_bulk);
+        HG_CHECK_HG_ERROR(done, ret, "Could not free rails");
+    }
+
     /* Free addr if any was attached to handle */
     if (hg_bulk->desc.info.flags & HG_BULK_BIND) {
         ret = HG_Core_addr_free(hg_bulk->addr);
@@ -714,6 +1356,8 @@ hg_bulk_free(struct hg_bulk *hg_bulk)
     if (hg_bulk->desc.info.segment_count > HG_BULK_STATIC_MAX)
         free(segments);
 
+    hg_bulk_serialize_cache_invalidate(hg_bulk);
+
     free(hg_bulk);
 
 done:
@@ -722,20 +1366,174 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_create_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
-    na_class_t *na_class, struct hg_bulk_segment *segments, hg_uint32_t count,
-    hg_uint8_t flags)
+hg_bulk_create_view(struct hg_bulk *hg_bulk_parent, hg_size_t offset,
+    hg_size_t size, struct hg_bulk **hg_bulk_ptr)
 {
-    na_mem_handle_t *na_mem_handles;
-    na_size_t *na_mem_serialize_sizes;
+    struct hg_bulk *hg_bulk = NULL;
+    struct hg_bulk_segment *parent_segments;
+    hg_uint32_t parent_count = hg_bulk_parent->desc.info.segment_count;
+    hg_uint8_t parent_flags = hg_bulk_parent->desc.info.flags;
+    na_mem_handle_t *parent_handles;
+#ifdef NA_HAS_SM
+    na_mem_handle_t *parent_sm_handles = HG_BULK_MEM_HANDLES(
+        &hg_bulk_parent->na_sm_mem_descs, parent_count, parent_flags);
+#endif
+    hg_size_t start, end, first_offset = 0;
+    hg_uint32_t first = 0, last;
     hg_return_t ret = HG_SUCCESS;
-    hg_uint32_t i;
 
-    if (count > HG_BULK_STATIC_MAX) {
-        /* Allocate NA memory handles */
-        na_mem_descs->handles.d =
-            (na_mem_handle_t *) calloc(count, sizeof(na_mem_handle_t));
-        HG_CHECK_ERROR(na_mem_descs->handles.d == NULL, error, ret, HG_NOMEM,
+    /* Parent is referenced by view */
+    hg_atomic_incr32_relaxed(&hg_bulk_parent->ref_count);
+
+    /* Eager data must not move once segments are shared */
+    ret = hg_bulk_release_eager_ref(hg_bulk_parent);
+    HG_CHECK_HG_ERROR(error, ret, "Could not release eager data of parent");
+
+    parent_segments = HG_BULK_SEGMENTS(hg_bulk_parent);
+    parent_handles = HG_BULK_MEM_HANDLES(
+        &hg_bulk_parent->na_mem_descs, parent_count, parent_flags);
+
+    /* Offsets are relative to the segments of the parent */
+    start = hg_bulk_parent->desc.info.offset + offset;
+    end = start + size;
+
+    /* Single registration, window must start at first segment */
+    if (!(parent_flags & HG_BULK_REGV) && parent_count > 1) {
+        hg_bulk_offset_translate(
+            parent_segments, parent_count, start, &first, &first_offset);
+        first_offset = start - first_offset;
+
+        /* NA offsets are relative to the first segment of a registration */
+        while (HG_BULK_MEM_HANDLE_SHARED(parent_handles, first)
+#ifdef NA_HAS_SM
+               || (hg_bulk_parent->na_sm_class &&
+                      HG_BULK_MEM_HANDLE_SHARED(parent_sm_handles, first))
+#endif
+        ) {
+            first--;
+            first_offset -= parent_segments[first].len;
+        }
+    }
+
+    /* Last segment that contains the region */
+    for (last = first, start -= first_offset, end -= first_offset;
+         last < parent_count - 1 && parent_segments[last].len < end; last++)
+        end -= parent_segments[last].len;
+
+    hg_bulk = (struct hg_bulk *) malloc(sizeof(struct hg_bulk));
+    HG_CHECK_ERROR(
+        hg_bulk == NULL, error, ret, HG_NOMEM, "Could not allocate handle");
+
+    memset(hg_bulk, 0, sizeof(struct hg_bulk));
+    hg_bulk->core_class = hg_bulk_parent->core_class;
+    hg_bulk->na_class = hg_bulk_parent->na_class;
+#ifdef NA_HAS_SM
+    hg_bulk->na_sm_class = hg_bulk_parent->na_sm_class;
+#endif
+    hg_bulk->attr = hg_bulk_parent->attr;
+    hg_bulk->parent = hg_bulk_parent;
+    hg_bulk->desc.info.len = size;
+    hg_bulk->desc.info.offset = start;
+    hg_bulk->desc.info.segment_count = last - first + 1;
+    hg_bulk->desc.info.flags =
+        parent_flags & (~(HG_BULK_ALLOC | HG_BULK_BIND) & 0xff);
+    /* Offsets of strided views remain relative to the blocks of the parent */
+    hg_bulk->desc.info.stride_count = hg_bulk_parent->desc.info.stride_count;
+    hg_bulk->strided = hg_bulk_parent->strided;
+    hg_atomic_init32(&hg_bulk->ref_count, 1);
+
+    /* Segments of large windows are referenced in place */
+    if (hg_bulk->desc.info.segment_count > HG_BULK_STATIC_MAX)
+        hg_bulk->desc.segments.d = &parent_segments[first];
+    else
+        memcpy(hg_bulk->desc.segments.s, &parent_segments[first],
+            hg_bulk->desc.info.segment_count * sizeof(struct hg_bulk_segment));
+
+    hg_bulk_view_na_mem_descs(&hg_bulk->na_mem_descs,
+        &hg_bulk_parent->na_mem_descs, parent_count, parent_flags, first,
+        hg_bulk->desc.info.segment_count);
+#ifdef NA_HAS_SM
+    if (hg_bulk->na_sm_class)
+        hg_bulk_view_na_mem_descs(&hg_bulk->na_sm_mem_descs,
+            &hg_bulk_parent->na_sm_mem_descs, parent_count, parent_flags, first,
+            hg_bulk->desc.info.segment_count);
+#endif
+
+    /* View remains bound to the address of its parent */
+    if (parent_flags & HG_BULK_BIND) {
+        ret = HG_Core_addr_dup(hg_bulk_parent->addr, &hg_bulk->addr);
+        HG_CHECK_HG_ERROR(error, ret, "Could not duplicate address");
+        hg_bulk->context_id = hg_bulk_parent->context_id;
+        hg_bulk->desc.info.flags |= HG_BULK_BIND;
+    }
+
+    *hg_bulk_ptr = hg_bulk;
+
+    return ret;
+
+error:
+    if (hg_bulk)
+        hg_bulk_free(hg_bulk);
+    else
+        hg_bulk_free(hg_bulk_parent);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_view_na_mem_descs(struct hg_bulk_na_mem_desc *view_mem_descs,
+    struct hg_bulk_na_mem_desc *parent_mem_descs, hg_uint32_t parent_count,
+    hg_uint8_t flags, hg_uint32_t first, hg_uint32_t count)
+{
+    na_mem_handle_t *parent_handles;
+    na_size_t *parent_serialize_sizes;
+
+    /* Single registration */
+    if ((flags & HG_BULK_REGV) || parent_count == 1) {
+        view_mem_descs->handles.s[0] = parent_mem_descs->handles.s[0];
+        view_mem_descs->serialize_sizes.s[0] =
+            parent_mem_descs->serialize_sizes.s[0];
+        return;
+    }
+
+    if (parent_count > HG_BULK_STATIC_MAX) {
+        parent_handles = parent_mem_descs->handles.d;
+        parent_serialize_sizes = parent_mem_descs->serialize_sizes.d;
+    } else {
+        parent_handles = parent_mem_descs->handles.s;
+        parent_serialize_sizes = parent_mem_descs->serialize_sizes.s;
+    }
+
+    if (count > HG_BULK_STATIC_MAX) {
+        view_mem_descs->handles.d = &parent_handles[first];
+        view_mem_descs->serialize_sizes.d = &parent_serialize_sizes[first];
+    } else {
+        memcpy(view_mem_descs->handles.s, &parent_handles[first],
+            count * sizeof(na_mem_handle_t));
+        memcpy(view_mem_descs->serialize_sizes.s,
+            &parent_serialize_sizes[first], count * sizeof(na_size_t));
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_create_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
+    na_class_t *na_class, struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    struct hg_bulk_segment *segments, hg_uint32_t count, hg_uint8_t flags,
+    const struct hg_bulk_attr *attr)
+{
+    na_mem_handle_t *na_mem_handles;
+    na_size_t *na_mem_serialize_sizes;
+    hg_ptr_t page_size = (hg_ptr_t) hg_mem_get_page_size();
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint32_t i, j, k;
+
+    if (count > HG_BULK_STATIC_MAX) {
+        /* Allocate NA memory handles */
+        na_mem_descs->handles.d =
+            (na_mem_handle_t *) calloc(count, sizeof(na_mem_handle_t));
+        HG_CHECK_ERROR(na_mem_descs->handles.d == NULL, error, ret, HG_NOMEM,
             "Could not allocate mem handle array");
 
         /* Allocate serialize sizes */
@@ -751,16 +1549,56 @@ hg_bulk_create_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
         na_mem_serialize_sizes = na_mem_descs->serialize_sizes.s;
     }
 
-    for (i = 0; i < count; i++) {
+    for (i = 0; i < count; i = j) {
+        hg_ptr_t region_end;
+
         /* Skip null segments */
-        if (segments[i].base == (hg_ptr_t) NULL)
+        if (segments[i].base == (hg_ptr_t) NULL) {
+            j = i + 1;
             continue;
+        }
+
+        /* Following segments that start within the last page of the region
+         * (or right after it) are merged into the same registration */
+        region_end = segments[i].base + segments[i].len;
+        for (j = i + 1; j < count; j++) {
+            hg_ptr_t segment_end = segments[j].base + segments[j].len;
+
+            if (segments[j].base == (hg_ptr_t) NULL ||
+                segments[j].base < segments[i].base ||
+                segments[j].base > HG_BULK_PAGE_CEIL(region_end, page_size))
+                break;
+            if (segment_end > region_end)
+                region_end = segment_end;
+        }
+
+        /* Memory from HG_Mem_alloc() is already registered */
+        na_mem_handles[i] = NA_MEM_HANDLE_NULL;
+        if (hg_bulk_mem_pool) {
+            ret = hg_bulk_mem_pool_get_handle(hg_bulk_mem_pool, na_class,
+                (void *) segments[i].base,
+                (na_size_t) (region_end - segments[i].base), flags,
+                &na_mem_handles[i], &na_mem_serialize_sizes[i]);
+            HG_CHECK_HG_ERROR(error, ret, "Could not get pool mem handle");
+        }
+
+        /* Register segment or region */
+        if (na_mem_handles[i] == NA_MEM_HANDLE_NULL) {
+            ret = hg_bulk_register(na_class, (void *) segments[i].base,
+                (na_size_t) (region_end - segments[i].base), flags, attr,
+                &na_mem_handles[i], &na_mem_serialize_sizes[i]);
+            HG_CHECK_HG_ERROR(error, ret, "Could not register segment");
+        }
+
+        if (j - i > 1)
+            HG_LOG_DEBUG("Merged %u segments into one registration", j - i);
 
-        /* Register segment */
-        ret = hg_bulk_register(na_class, (void *) segments[i].base,
-            segments[i].len, flags, &na_mem_handles[i],
-            &na_mem_serialize_sizes[i]);
-        HG_CHECK_HG_ERROR(error, ret, "Could not register segment");
+        /* Merged segments share handle, serialize size of 0 tells remote
+         * side to re-use previous handle */
+        for (k = i + 1; k < j; k++) {
+            na_mem_handles[k] = na_mem_handles[i];
+            na_mem_serialize_sizes[k] = 0;
+        }
     }
 
     return ret;
@@ -769,6 +1607,113 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_bulk_mem_handle_offset(const struct hg_bulk_segment *segments,
+    const na_mem_handle_t *mem_handles, hg_size_t index)
+{
+    hg_size_t start = index;
+
+    /* Find first segment of merged registration */
+    while (HG_BULK_MEM_HANDLE_SHARED(mem_handles, start))
+        start--;
+
+    return (hg_size_t) (segments[index].base - segments[start].base);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bulk_get_contig_segment(
+    const struct hg_bulk *hg_bulk, hg_uint32_t *index_ptr)
+{
+    const struct hg_bulk_segment *segments = hg_bulk->desc.segments.s;
+    hg_uint32_t i, index = 0, nonempty = 0;
+
+    /* Only look at handles that do not need a segment array */
+    if (hg_bulk->desc.info.segment_count > HG_BULK_STATIC_MAX)
+        return HG_FALSE;
+
+    for (i = 0; i < hg_bulk->desc.info.segment_count; i++) {
+        if (segments[i].len == 0)
+            continue;
+        index = i;
+        nonempty++;
+    }
+    if (nonempty != 1 || segments[index].base == (hg_ptr_t) NULL)
+        return HG_FALSE;
+
+    if (index_ptr)
+        *index_ptr = index;
+
+    return HG_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_create_rails(struct hg_bulk *hg_bulk, hg_uint8_t flags)
+{
+    const struct hg_bulk_segment *segment;
+    unsigned int rail_count =
+        HG_Core_class_get_na_rail_count(hg_bulk->core_class);
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint32_t index = 0;
+    unsigned int i;
+
+    (void) hg_bulk_get_contig_segment(hg_bulk, &index);
+    segment = &hg_bulk->desc.segments.s[index];
+
+    hg_bulk->rails =
+        (struct hg_bulk_rail *) calloc(rail_count, sizeof(struct hg_bulk_rail));
+    HG_CHECK_ERROR(hg_bulk->rails == NULL, done, ret, HG_NOMEM,
+        "Could not allocate rail array");
+    hg_bulk->desc.info.rail_count = (hg_uint8_t) rail_count;
+
+    for (i = 0; i < rail_count; i++) {
+        ret = hg_bulk_register(
+            HG_Core_class_get_na_rail(hg_bulk->core_class, i),
+            (void *) segment->base, (na_size_t) segment->len, flags, NULL,
+            &hg_bulk->rails[i].na_mem_handle,
+            &hg_bulk->rails[i].serialize_size);
+        HG_CHECK_HG_ERROR(
+            done, ret, "Could not register segment on rail %u", i);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_free_rails(struct hg_bulk *hg_bulk)
+{
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    for (i = 0; i < hg_bulk->desc.info.rail_count; i++) {
+        na_class_t *na_rail_class =
+            HG_Core_class_get_na_rail(hg_bulk->core_class, i);
+
+        if (hg_bulk->rails[i].na_mem_handle != NA_MEM_HANDLE_NULL) {
+            ret = hg_bulk_deregister(
+                na_rail_class, hg_bulk->rails[i].na_mem_handle);
+            HG_CHECK_HG_ERROR(done, ret, "Could not deregister rail segment");
+        }
+
+        if (hg_bulk->rails[i].na_addr != NA_ADDR_NULL) {
+            na_return_t na_ret =
+                NA_Addr_free(na_rail_class, hg_bulk->rails[i].na_addr);
+            HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret,
+                (hg_return_t) na_ret, "Could not free rail address (%s)",
+                NA_Error_to_string(na_ret));
+        }
+    }
+    free(hg_bulk->rails);
+    hg_bulk->rails = NULL;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_free_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
@@ -787,7 +1732,9 @@ hg_bulk_free_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
         hg_uint32_t i;
 
         for (i = 0; i < count; i++) {
-            if (na_mem_handles[i] == NA_MEM_HANDLE_NULL)
+            /* Shared handles are deregistered once */
+            if (na_mem_handles[i] == NA_MEM_HANDLE_NULL ||
+                HG_BULK_MEM_HANDLE_SHARED(na_mem_handles, i))
                 continue;
 
             ret = hg_bulk_deregister(na_class, na_mem_handles[i]);
@@ -809,6 +1756,8 @@ hg_bulk_bind(struct hg_bulk *hg_bulk, hg_core_context_t *core_context)
 
     HG_CHECK_ERROR(hg_bulk->addr != HG_CORE_ADDR_NULL, done, ret,
         HG_INVALID_ARG, "Handle is already bound to an existing address");
+    HG_CHECK_ERROR(hg_bulk->cached, done, ret, HG_PERMISSION,
+        "Cannot bind handle shared through remote handle cache");
 
     /* Retrieve self address */
     ret = HG_Core_addr_self(hg_bulk->core_class, &hg_bulk->addr);
@@ -820,6 +1769,9 @@ hg_bulk_bind(struct hg_bulk *hg_bulk, hg_core_context_t *core_context)
     /* Set flags */
     hg_bulk->desc.info.flags |= HG_BULK_BIND;
 
+    /* Address information must now be serialized */
+    hg_bulk_serialize_cache_invalidate(hg_bulk);
+
 done:
     return ret;
 }
@@ -827,8 +1779,8 @@ done:
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_register(na_class_t *na_class, void *base, na_size_t len,
-    unsigned long flags, na_mem_handle_t *mem_handle_ptr,
-    na_size_t *serialize_size_ptr)
+    unsigned long flags, const struct hg_bulk_attr *attr,
+    na_mem_handle_t *mem_handle_ptr, na_size_t *serialize_size_ptr)
 {
     na_mem_handle_t mem_handle = NA_MEM_HANDLE_NULL;
     na_size_t serialize_size = 0;
@@ -842,7 +1794,11 @@ hg_bulk_register(na_class_t *na_class, void *base, na_size_t len,
         "NA_Mem_handle_create() failed (%s)", NA_Error_to_string(na_ret));
 
     /* Register NA memory handle */
-    na_ret = NA_Mem_register(na_class, mem_handle);
+    if (attr)
+        na_ret = NA_Mem_register_attr(na_class, mem_handle,
+            (na_mem_type_t) attr->mem_type, (na_uint64_t) attr->device);
+    else
+        na_ret = NA_Mem_register(na_class, mem_handle);
     HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
         "NA_Mem_register() failed (%s)", NA_Error_to_string(na_ret));
     registered = HG_TRUE;
@@ -874,8 +1830,8 @@ error:
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_register_segments(na_class_t *na_class, struct na_segment *segments,
-    na_size_t count, unsigned long flags, na_mem_handle_t *mem_handle_ptr,
-    na_size_t *serialize_size_ptr)
+    na_size_t count, unsigned long flags, const struct hg_bulk_attr *attr,
+    na_mem_handle_t *mem_handle_ptr, na_size_t *serialize_size_ptr)
 {
     na_mem_handle_t mem_handle = NA_MEM_HANDLE_NULL;
     na_size_t serialize_size = 0;
@@ -891,7 +1847,11 @@ hg_bulk_register_segments(na_class_t *na_class, struct na_segment *segments,
         NA_Error_to_string(na_ret));
 
     /* Register NA memory handle */
-    na_ret = NA_Mem_register(na_class, mem_handle);
+    if (attr)
+        na_ret = NA_Mem_register_attr(na_class, mem_handle,
+            (na_mem_type_t) attr->mem_type, (na_uint64_t) attr->device);
+    else
+        na_ret = NA_Mem_register(na_class, mem_handle);
     HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
         "NA_Mem_register() failed (%s)", NA_Error_to_string(na_ret));
     registered = HG_TRUE;
@@ -939,16 +1899,197 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_mem_region_create(struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    hg_size_t size, int size_class,
+    struct hg_bulk_mem_region **hg_bulk_mem_region_ptr)
+{
+    struct hg_bulk_mem_region *hg_bulk_mem_region = NULL;
+    na_class_t *na_class = HG_Core_class_get_na(hg_bulk_mem_pool->core_class);
+#ifdef NA_HAS_SM
+    na_class_t *na_sm_class =
+        HG_Core_class_get_na_sm(hg_bulk_mem_pool->core_class);
+#endif
+    na_size_t serialize_size;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_bulk_mem_region = (struct hg_bulk_mem_region *) calloc(
+        1, sizeof(struct hg_bulk_mem_region));
+    HG_CHECK_ERROR(hg_bulk_mem_region == NULL, error, ret, HG_NOMEM,
+        "Could not allocate memory region");
+    hg_bulk_mem_region->size = size;
+    hg_bulk_mem_region->size_class = size_class;
+
+    /* Place region on the NUMA node of the NIC */
+    hg_bulk_mem_region->base =
+        (char *) hg_mem_huge_alloc(size, NA_Get_numa_node(na_class));
+    HG_CHECK_ERROR(hg_bulk_mem_region->base == NULL, error, ret, HG_NOMEM,
+        "Could not allocate %zu bytes of registered memory", size);
+
+    ret = hg_bulk_register(na_class, hg_bulk_mem_region->base, size,
+        HG_BULK_READWRITE, NULL, &hg_bulk_mem_region->na_mem_handle,
+        &serialize_size);
+    HG_CHECK_HG_ERROR(error, ret, "Could not register memory region");
+
+#ifdef NA_HAS_SM
+    if (na_sm_class) {
+        ret = hg_bulk_register(na_sm_class, hg_bulk_mem_region->base, size,
+            HG_BULK_READWRITE, NULL, &hg_bulk_mem_region->na_sm_mem_handle,
+            &serialize_size);
+        HG_CHECK_HG_ERROR(
+            error, ret, "Could not register memory region with SM");
+    }
+#endif
+
+    HG_LIST_INSERT_HEAD(&hg_bulk_mem_pool->regions, hg_bulk_mem_region, entry);
+    hg_atomic_incr32(&hg_bulk_mem_pool->region_count);
+
+    HG_LOG_DEBUG("Created memory region (%p) of %zu bytes",
+        (void *) hg_bulk_mem_region->base, size);
+
+    *hg_bulk_mem_region_ptr = hg_bulk_mem_region;
+
+    return ret;
+
+error:
+    if (hg_bulk_mem_region) {
+        if (hg_bulk_mem_region->na_mem_handle != NA_MEM_HANDLE_NULL)
+            (void) hg_bulk_deregister(
+                na_class, hg_bulk_mem_region->na_mem_handle);
+        if (hg_bulk_mem_region->base)
+            hg_mem_huge_free(hg_bulk_mem_region->base, size);
+        free(hg_bulk_mem_region);
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_mem_region_destroy(struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    struct hg_bulk_mem_region *hg_bulk_mem_region)
+{
+    hg_return_t ret;
+
+    HG_LIST_REMOVE(hg_bulk_mem_region, entry);
+    hg_atomic_decr32(&hg_bulk_mem_pool->region_count);
+
+    ret = hg_bulk_deregister(
+        HG_Core_class_get_na(hg_bulk_mem_pool->core_class),
+        hg_bulk_mem_region->na_mem_handle);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not deregister region");
+
+#ifdef NA_HAS_SM
+    if (hg_bulk_mem_region->na_sm_mem_handle != NA_MEM_HANDLE_NULL) {
+        ret = hg_bulk_deregister(
+            HG_Core_class_get_na_sm(hg_bulk_mem_pool->core_class),
+            hg_bulk_mem_region->na_sm_mem_handle);
+        HG_CHECK_ERROR_DONE(
+            ret != HG_SUCCESS, "Could not deregister region with SM");
+    }
+#endif
+
+    HG_LOG_DEBUG("Destroyed memory region (%p) of %zu bytes",
+        (void *) hg_bulk_mem_region->base, hg_bulk_mem_region->size);
+
+    hg_mem_huge_free(hg_bulk_mem_region->base, hg_bulk_mem_region->size);
+    free(hg_bulk_mem_region);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_bulk_mem_region *
+hg_bulk_mem_region_find(struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    const char *base, hg_size_t len)
+{
+    struct hg_bulk_mem_region *hg_bulk_mem_region;
+
+    HG_LIST_FOREACH (hg_bulk_mem_region, &hg_bulk_mem_pool->regions, entry) {
+        if (base >= hg_bulk_mem_region->base &&
+            base + len <= hg_bulk_mem_region->base + hg_bulk_mem_region->size)
+            return hg_bulk_mem_region;
+    }
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_mem_pool_get_handle(struct hg_bulk_mem_pool *hg_bulk_mem_pool,
+    na_class_t *na_class, void *base, na_size_t len, unsigned long flags,
+    na_mem_handle_t *mem_handle_ptr, na_size_t *serialize_size_ptr)
+{
+    struct hg_bulk_mem_region *hg_bulk_mem_region;
+    na_mem_handle_t parent_handle, mem_handle = NA_MEM_HANDLE_NULL;
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+
+    /* Avoid locking if nothing was allocated */
+    if (hg_atomic_get32(&hg_bulk_mem_pool->region_count) == 0)
+        return ret;
+
+    hg_thread_mutex_lock(&hg_bulk_mem_pool->mutex);
+
+    hg_bulk_mem_region =
+        hg_bulk_mem_region_find(hg_bulk_mem_pool, (const char *) base, len);
+    if (hg_bulk_mem_region == NULL)
+        goto done;
+
+#ifdef NA_HAS_SM
+    if (na_class != HG_Core_class_get_na(hg_bulk_mem_pool->core_class))
+        parent_handle = hg_bulk_mem_region->na_sm_mem_handle;
+    else
+#endif
+        parent_handle = hg_bulk_mem_region->na_mem_handle;
+
+    /* Plugins that cannot share registrations fall back to registering */
+    na_ret = NA_Mem_handle_create_sub(
+        na_class, parent_handle, base, len, flags, &mem_handle);
+    if (na_ret == NA_OPNOTSUPPORTED)
+        goto done;
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "NA_Mem_handle_create_sub() failed (%s)", NA_Error_to_string(na_ret));
+
+    *serialize_size_ptr =
+        NA_Mem_handle_get_serialize_size(na_class, mem_handle);
+    HG_CHECK_ERROR(*serialize_size_ptr == 0, error, ret, HG_PROTOCOL_ERROR,
+        "NA_Mem_handle_get_serialize_size() failed");
+
+    *mem_handle_ptr = mem_handle;
+
+done:
+    hg_thread_mutex_unlock(&hg_bulk_mem_pool->mutex);
+
+    return ret;
+
+error:
+    hg_thread_mutex_unlock(&hg_bulk_mem_pool->mutex);
+    (void) NA_Mem_handle_free(na_class, mem_handle);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_size_t
 hg_bulk_get_serialize_size(struct hg_bulk *hg_bulk, hg_uint8_t flags)
 {
     hg_size_t ret = 0;
 
+    if (!HG_BULK_SERIALIZE_IS_EAGER(hg_bulk, flags)) {
+        struct hg_bulk_serialize_cache *cache =
+            hg_bulk_serialize_cache_get(hg_bulk, flags);
+        if (cache)
+            return cache->size;
+    }
+
     /* Descriptor info + segments */
     ret = sizeof(hg_bulk->desc.info) +
           hg_bulk->desc.info.segment_count * sizeof(struct hg_bulk_segment);
 
+    /* Strided layout */
+    if (HG_BULK_IS_STRIDED(hg_bulk))
+        ret += sizeof(hg_size_t) +
+               hg_bulk->desc.info.stride_count * sizeof(struct hg_bulk_stride);
+
     /* Memory handles */
     if ((hg_bulk->desc.info.flags & HG_BULK_REGV) ||
         (hg_bulk->desc.info.segment_count == 1)) {
@@ -978,6 +2119,10 @@ hg_bulk_get_serialize_size(struct hg_bulk *hg_bulk, hg_uint8_t flags)
 #endif
     }
 
+    /* Rail addresses and memory handles */
+    if (HG_BULK_SERIALIZE_HAS_RAILS(hg_bulk, flags))
+        ret += hg_bulk_get_serialize_size_rails(hg_bulk);
+
     /* Address information (context ID + serialize size + address) */
     if (hg_bulk->desc.info.flags & HG_BULK_BIND) {
         unsigned long addr_flags = 0;
@@ -990,11 +2135,17 @@ hg_bulk_get_serialize_size(struct hg_bulk *hg_bulk, hg_uint8_t flags)
                HG_Core_addr_get_serialize_size(hg_bulk->addr, addr_flags);
     }
 
-    /* Eager mode (in eager mode, the actual data will be copied) */
+    /* Eager mode (in eager mode, the actual data will be copied, segments
+     * of views are copied entirely) */
     if ((flags & HG_BULK_EAGER) &&
         (hg_bulk->desc.info.flags & HG_BULK_READ_ONLY) &&
-        !(hg_bulk->desc.info.flags & HG_BULK_VIRT))
-        ret += hg_bulk->desc.info.len;
+        !(hg_bulk->desc.info.flags & HG_BULK_VIRT)) {
+        const struct hg_bulk_segment *segments = HG_BULK_SEGMENTS(hg_bulk);
+        hg_uint32_t i;
+
+        for (i = 0; i < hg_bulk->desc.info.segment_count; i++)
+            ret += segments[i].len;
+    }
 
     return ret;
 }
@@ -1027,6 +2178,30 @@ hg_bulk_get_serialize_size_mem_descs(
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_bulk_get_serialize_size_rails(struct hg_bulk *hg_bulk)
+{
+    hg_size_t ret = 0;
+    unsigned int i;
+
+    for (i = 0; i < hg_bulk->desc.info.rail_count; i++) {
+        na_addr_t na_addr = (hg_bulk->rails[i].na_addr != NA_ADDR_NULL)
+                                ? hg_bulk->rails[i].na_addr
+                                : HG_Core_class_get_na_rail_self(
+                                      hg_bulk->core_class, i);
+
+        /* Serialize sizes + address + memory handle */
+        ret += 2 * sizeof(na_size_t) +
+               NA_Addr_get_serialize_size(
+                   HG_Core_class_get_na_rail(hg_bulk->core_class, i),
+                   na_addr) +
+               hg_bulk->rails[i].serialize_size;
+    }
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_serialize(
@@ -1036,8 +2211,23 @@ hg_bulk_serialize(
     char *buf_ptr = (char *) buf;
     hg_size_t buf_size_left = buf_size;
     struct hg_bulk_desc_info desc_info = hg_bulk->desc.info;
+    hg_bool_t cacheable = !HG_BULK_SERIALIZE_IS_EAGER(hg_bulk, flags);
     hg_return_t ret = HG_SUCCESS;
 
+    /* Re-use previous serialization if handle has not changed */
+    if (cacheable) {
+        struct hg_bulk_serialize_cache *cache =
+            hg_bulk_serialize_cache_get(hg_bulk, flags);
+
+        if (cache) {
+            HG_CHECK_ERROR(buf_size < cache->size, done, ret, HG_OVERFLOW,
+                "Buffer size too small for serializing parameter");
+            HG_LOG_DEBUG("Using cached serialization of bulk handle");
+            memcpy(buf, cache->buf, cache->size);
+            goto done;
+        }
+    }
+
     /* Always reset bulk alloc flag (only local) */
     desc_info.flags &= (~HG_BULK_ALLOC & 0xff);
 
@@ -1058,6 +2248,10 @@ hg_bulk_serialize(
         desc_info.flags &= (~HG_BULK_SM & 0xff);
 #endif
 
+    /* Rails are not used over SM */
+    if (!HG_BULK_SERIALIZE_HAS_RAILS(hg_bulk, flags))
+        desc_info.rail_count = 0;
+
     HG_LOG_DEBUG("Serializing bulk handle with %u segment(s), len is %zu bytes",
         hg_bulk->desc.info.segment_count, hg_bulk->desc.info.len);
 
@@ -1069,6 +2263,15 @@ hg_bulk_serialize(
     HG_BULK_ENCODE_ARRAY(done, ret, buf_ptr, buf_size_left, segments,
         struct hg_bulk_segment, desc_info.segment_count);
 
+    /* Strided layout */
+    if (desc_info.stride_count > 0) {
+        HG_BULK_ENCODE(done, ret, buf_ptr, buf_size_left,
+            &hg_bulk->strided.block_len, hg_size_t);
+        HG_BULK_ENCODE_ARRAY(done, ret, buf_ptr, buf_size_left,
+            hg_bulk->strided.dims, struct hg_bulk_stride,
+            desc_info.stride_count);
+    }
+
     /* TODO if eager or self flag, skip mem handles ? */
 
     /* Add the NA memory handles */
@@ -1133,6 +2336,14 @@ hg_bulk_serialize(
 #endif
     }
 
+    /* Add rail addresses and memory handles */
+    if (desc_info.rail_count > 0) {
+        HG_LOG_DEBUG("Serializing %u NA rail(s)", desc_info.rail_count);
+
+        ret = hg_bulk_serialize_rails(&buf_ptr, &buf_size_left, hg_bulk);
+        HG_CHECK_HG_ERROR(done, ret, "Could not serialize NA rails");
+    }
+
     /* Address information */
     if (desc_info.flags & HG_BULK_BIND) {
         hg_size_t serialize_size;
@@ -1177,10 +2388,59 @@ hg_bulk_serialize(
         }
     }
 
+    /* Handles that are serialized repeatedly keep their serialized form */
+    if (cacheable && hg_atomic_incr32(&hg_bulk->serialize_count) >=
+                         HG_BULK_SERIALIZE_CACHE_THRESHOLD)
+        hg_bulk_serialize_cache_set(
+            hg_bulk, flags, buf, (hg_size_t) (buf_ptr - (char *) buf));
+
 done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_serialize_cache_set(struct hg_bulk *hg_bulk, hg_uint8_t flags,
+    const void *buf, hg_size_t buf_size)
+{
+    hg_atomic_int64_t *cache_ptr =
+        &hg_bulk->serialize_cache[HG_BULK_SERIALIZE_CACHE_INDEX(flags)];
+    struct hg_bulk_serialize_cache *cache;
+
+    if (hg_atomic_get64(cache_ptr))
+        return;
+
+    /* Caching is best effort, failures are not reported */
+    cache = (struct hg_bulk_serialize_cache *) malloc(
+        sizeof(struct hg_bulk_serialize_cache) + buf_size);
+    if (cache == NULL)
+        return;
+    cache->size = buf_size;
+    memcpy(cache->buf, buf, buf_size);
+
+    /* Another thread may have published its copy first */
+    if (!hg_atomic_cas64(cache_ptr, 0, (hg_util_int64_t) cache))
+        free(cache);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_serialize_cache_invalidate(struct hg_bulk *hg_bulk)
+{
+    unsigned int i;
+
+    for (i = 0; i < HG_BULK_SERIALIZE_CACHE_MAX; i++) {
+        hg_util_int64_t cache;
+
+        do {
+            cache = hg_atomic_get64(&hg_bulk->serialize_cache[i]);
+        } while (cache && !hg_atomic_cas64(&hg_bulk->serialize_cache[i],
+                              cache, 0));
+        free((void *) cache);
+    }
+    hg_atomic_set32(&hg_bulk->serialize_count, 0);
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_serialize_mem_descs(na_class_t *na_class, char **buf_ptr,
@@ -1207,8 +2467,9 @@ hg_bulk_serialize_mem_descs(na_class_t *na_class, char **buf_ptr,
     for (i = 0; i < count; i++) {
         na_return_t na_ret;
 
-        /* Skip null segments */
-        if (segments[i].base == (hg_ptr_t) NULL)
+        /* Skip null segments and shared handles */
+        if (segments[i].base == (hg_ptr_t) NULL ||
+            na_mem_serialize_sizes[i] == 0)
             continue;
 
         na_ret = NA_Mem_handle_serialize(
@@ -1227,11 +2488,58 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_deserialize(hg_core_class_t *core_class, struct hg_bulk **hg_bulk_ptr,
-    const void *buf, hg_size_t buf_size)
+hg_bulk_serialize_rails(
+    char **buf_ptr, hg_size_t *buf_size_left, struct hg_bulk *hg_bulk)
 {
-    struct hg_bulk *hg_bulk = NULL;
-    struct hg_bulk_segment *segments;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    for (i = 0; i < hg_bulk->desc.info.rail_count; i++) {
+        na_class_t *na_rail_class =
+            HG_Core_class_get_na_rail(hg_bulk->core_class, i);
+        /* Local handles are reached through self address of rail */
+        na_addr_t na_addr =
+            (hg_bulk->rails[i].na_addr != NA_ADDR_NULL)
+                ? hg_bulk->rails[i].na_addr
+                : HG_Core_class_get_na_rail_self(hg_bulk->core_class, i);
+        na_size_t addr_serialize_size =
+            NA_Addr_get_serialize_size(na_rail_class, na_addr);
+        na_return_t na_ret;
+
+        HG_BULK_ENCODE(done, ret, *buf_ptr, *buf_size_left,
+            &addr_serialize_size, na_size_t);
+
+        na_ret = NA_Addr_serialize(
+            na_rail_class, *buf_ptr, *buf_size_left, na_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not serialize rail address (%s)",
+            NA_Error_to_string(na_ret));
+        *buf_ptr += addr_serialize_size;
+        *buf_size_left -= addr_serialize_size;
+
+        HG_BULK_ENCODE(done, ret, *buf_ptr, *buf_size_left,
+            &hg_bulk->rails[i].serialize_size, na_size_t);
+
+        na_ret = NA_Mem_handle_serialize(na_rail_class, *buf_ptr,
+            *buf_size_left, hg_bulk->rails[i].na_mem_handle);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not serialize rail memory handle (%s)",
+            NA_Error_to_string(na_ret));
+        *buf_ptr += hg_bulk->rails[i].serialize_size;
+        *buf_size_left -= hg_bulk->rails[i].serialize_size;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_deserialize(hg_core_class_t *core_class, struct hg_bulk **hg_bulk_ptr,
+    const void *buf, hg_size_t buf_size, hg_bool_t eager_ref)
+{
+    struct hg_bulk *hg_bulk = NULL;
+    struct hg_bulk_segment *segments;
     const char *buf_ptr = (const char *) buf;
     hg_size_t buf_size_left = buf_size;
     hg_return_t ret = HG_SUCCESS;
@@ -1277,6 +2585,26 @@ hg_bulk_deserialize(hg_core_class_t *core_class, struct hg_bulk **hg_bulk_ptr,
     HG_BULK_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left, segments,
         struct hg_bulk_segment, hg_bulk->desc.info.segment_count);
 
+    /* Strided layout */
+    if (HG_BULK_IS_STRIDED(hg_bulk)) {
+        hg_uint8_t i;
+
+        HG_CHECK_ERROR(hg_bulk->desc.info.stride_count > HG_BULK_STRIDE_MAX ||
+                           hg_bulk->desc.info.segment_count != 1,
+            error, ret, HG_PROTOCOL_ERROR, "Invalid strided layout");
+        for (i = 0; i < HG_BULK_STRIDE_MAX; i++) {
+            hg_bulk->strided.dims[i].count = 1;
+            hg_bulk->strided.dims[i].stride = 0;
+        }
+        HG_BULK_DECODE(error, ret, buf_ptr, buf_size_left,
+            &hg_bulk->strided.block_len, hg_size_t);
+        HG_BULK_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left,
+            hg_bulk->strided.dims, struct hg_bulk_stride,
+            hg_bulk->desc.info.stride_count);
+        HG_CHECK_ERROR(hg_bulk->strided.block_len == 0, error, ret,
+            HG_PROTOCOL_ERROR, "Invalid strided block length");
+    }
+
     /* Get the NA memory handles */
     if (hg_bulk->desc.info.flags & HG_BULK_REGV ||
         (hg_bulk->desc.info.segment_count == 1)) {
@@ -1339,6 +2667,15 @@ hg_bulk_deserialize(hg_core_class_t *core_class, struct hg_bulk **hg_bulk_ptr,
 #endif
     }
 
+    /* Get rail addresses and memory handles */
+    if (hg_bulk->desc.info.rail_count > 0) {
+        HG_LOG_DEBUG(
+            "Deserializing %u NA rail(s)", hg_bulk->desc.info.rail_count);
+
+        ret = hg_bulk_deserialize_rails(&buf_ptr, &buf_size_left, hg_bulk);
+        HG_CHECK_HG_ERROR(error, ret, "Could not deserialize NA rails");
+    }
+
     /* Address information */
     if (hg_bulk->desc.info.flags & HG_BULK_BIND) {
         hg_size_t serialize_size;
@@ -1366,19 +2703,31 @@ hg_bulk_deserialize(hg_core_class_t *core_class, struct hg_bulk **hg_bulk_ptr,
 
         HG_LOG_DEBUG("Deserializing eager bulk data, %u segment(s)",
             hg_bulk->desc.info.segment_count);
-        hg_bulk->desc.info.flags |= HG_BULK_ALLOC;
-        for (i = 0; i < hg_bulk->desc.info.segment_count; i++) {
-            if (!segments[i].len)
-                continue;
+        if (eager_ref) {
+            /* Data is left in place, buffer must remain valid until
+             * hg_bulk_release_eager_ref() is called */
+            hg_bulk->eager_ref = HG_TRUE;
+            for (i = 0; i < hg_bulk->desc.info.segment_count; i++) {
+                HG_CHECK_ERROR(buf_size_left < segments[i].len, error, ret,
+                    HG_OVERFLOW, "Buffer size too small (%zu)", buf_size_left);
+                segments[i].base = (hg_ptr_t) buf_ptr;
+                buf_ptr += segments[i].len;
+                buf_size_left -= segments[i].len;
+            }
+        } else {
+            hg_bulk->desc.info.flags |= HG_BULK_ALLOC;
+            for (i = 0; i < hg_bulk->desc.info.segment_count; i++) {
+                if (!segments[i].len)
+                    continue;
 
-            /* Override base address to store data */
-            segments[i].base = (hg_ptr_t) calloc(1, segments[i].len);
-            HG_CHECK_ERROR(segments[i].base == (hg_ptr_t) NULL, error, ret,
-                HG_NOMEM, "Could not allocate segment");
-            ;
+                /* Override base address to store data */
+                segments[i].base = (hg_ptr_t) calloc(1, segments[i].len);
+                HG_CHECK_ERROR(segments[i].base == (hg_ptr_t) NULL, error,
+                    ret, HG_NOMEM, "Could not allocate segment");
 
-            HG_BULK_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left,
-                (void *) segments[i].base, char, segments[i].len);
+                HG_BULK_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left,
+                    (void *) segments[i].base, char, segments[i].len);
+            }
         }
     } else
         /* Addresses are virtual and do not point to physical memory */
@@ -1397,6 +2746,128 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_bulk_cache_hash(hg_hash_table_key_t key)
+{
+    const struct hg_bulk_cache_key *hg_bulk_cache_key =
+        (const struct hg_bulk_cache_key *) key;
+
+    return (unsigned int) hg_crc32c_update(
+        0, hg_bulk_cache_key->buf, (size_t) hg_bulk_cache_key->size);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_bulk_cache_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    const struct hg_bulk_cache_key *hg_bulk_cache_key1 =
+        (const struct hg_bulk_cache_key *) key1;
+    const struct hg_bulk_cache_key *hg_bulk_cache_key2 =
+        (const struct hg_bulk_cache_key *) key2;
+
+    return hg_bulk_cache_key1->size == hg_bulk_cache_key2->size &&
+           memcmp(hg_bulk_cache_key1->buf, hg_bulk_cache_key2->buf,
+               (size_t) hg_bulk_cache_key1->size) == 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_cache_get(struct hg_bulk_cache *hg_bulk_cache,
+    hg_core_class_t *core_class, struct hg_bulk **hg_bulk_ptr, const void *buf,
+    hg_size_t buf_size)
+{
+    struct hg_bulk_cache_key key = {.buf = buf, .size = buf_size};
+    struct hg_bulk_cache_entry *entry, *new_entry = NULL;
+    HG_QUEUE_HEAD(hg_bulk_cache_entry)
+    evicted = HG_QUEUE_HEAD_INITIALIZER(evicted);
+    struct hg_bulk *hg_bulk = NULL;
+    hg_return_t ret;
+
+    hg_thread_mutex_lock(&hg_bulk_cache->mutex);
+    entry = (struct hg_bulk_cache_entry *) hg_hash_table_lookup(
+        hg_bulk_cache->table, (hg_hash_table_key_t) &key);
+    if (entry != HG_HASH_TABLE_NULL) {
+        entry->referenced = HG_TRUE;
+        hg_atomic_incr32_relaxed(&entry->hg_bulk->ref_count);
+        *hg_bulk_ptr = entry->hg_bulk;
+        hg_thread_mutex_unlock(&hg_bulk_cache->mutex);
+        return HG_SUCCESS;
+    }
+    hg_thread_mutex_unlock(&hg_bulk_cache->mutex);
+
+    /* Deserialize outside of lock, another thread may add the same handle */
+    ret = hg_bulk_deserialize(core_class, &hg_bulk, buf, buf_size, HG_FALSE);
+    HG_CHECK_HG_ERROR(done, ret, "Could not deserialize handle");
+
+    /* Handle is still returned if it cannot be cached */
+    new_entry = (struct hg_bulk_cache_entry *) malloc(
+        sizeof(struct hg_bulk_cache_entry) + buf_size);
+    if (new_entry == NULL) {
+        *hg_bulk_ptr = hg_bulk;
+        goto done;
+    }
+    memcpy(new_entry->buf, buf, (size_t) buf_size);
+    new_entry->key.buf = new_entry->buf;
+    new_entry->key.size = buf_size;
+    new_entry->hg_bulk = hg_bulk;
+    new_entry->referenced = HG_FALSE;
+
+    hg_thread_mutex_lock(&hg_bulk_cache->mutex);
+    entry = (struct hg_bulk_cache_entry *) hg_hash_table_lookup(
+        hg_bulk_cache->table, (hg_hash_table_key_t) &key);
+    if (entry != HG_HASH_TABLE_NULL) {
+        /* Lost the race, use cached handle */
+        entry->referenced = HG_TRUE;
+        hg_atomic_incr32_relaxed(&entry->hg_bulk->ref_count);
+        *hg_bulk_ptr = entry->hg_bulk;
+        hg_thread_mutex_unlock(&hg_bulk_cache->mutex);
+        hg_bulk_free(hg_bulk);
+        free(new_entry);
+        goto done;
+    }
+    *hg_bulk_ptr = hg_bulk;
+    if (!hg_hash_table_insert(hg_bulk_cache->table,
+            (hg_hash_table_key_t) &new_entry->key,
+            (hg_hash_table_value_t) new_entry)) {
+        hg_thread_mutex_unlock(&hg_bulk_cache->mutex);
+        free(new_entry);
+        goto done;
+    }
+
+    /* Cached handles are shared and keep one reference */
+    hg_bulk->cached = HG_TRUE;
+    hg_atomic_incr32_relaxed(&hg_bulk->ref_count);
+    HG_QUEUE_PUSH_TAIL(&hg_bulk_cache->queue, new_entry, entry);
+    hg_bulk_cache->count++;
+
+    /* Entries hit since last pass get a second chance */
+    while (hg_bulk_cache->count > hg_bulk_cache->max_count) {
+        entry = HG_QUEUE_FIRST(&hg_bulk_cache->queue);
+        HG_QUEUE_POP_HEAD(&hg_bulk_cache->queue, entry);
+        if (entry->referenced) {
+            entry->referenced = HG_FALSE;
+            HG_QUEUE_PUSH_TAIL(&hg_bulk_cache->queue, entry, entry);
+            continue;
+        }
+        hg_hash_table_remove(
+            hg_bulk_cache->table, (hg_hash_table_key_t) &entry->key);
+        hg_bulk_cache->count--;
+        HG_QUEUE_PUSH_TAIL(&evicted, entry, entry);
+    }
+    hg_thread_mutex_unlock(&hg_bulk_cache->mutex);
+
+    /* Handles remain valid until users release them */
+    while ((entry = HG_QUEUE_FIRST(&evicted)) != NULL) {
+        HG_QUEUE_POP_HEAD(&evicted, entry);
+        hg_bulk_free(entry->hg_bulk);
+        free(entry);
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_deserialize_mem_descs(na_class_t *na_class, const char **buf_ptr,
@@ -1439,6 +2910,16 @@ hg_bulk_deserialize_mem_descs(na_class_t *na_class, const char **buf_ptr,
         if (segments[i].base == (hg_ptr_t) NULL)
             continue;
 
+        /* Segment is part of the registration of previous segment */
+        if (na_mem_serialize_sizes[i] == 0) {
+            HG_CHECK_ERROR(
+                i == 0 || na_mem_handles[i - 1] == NA_MEM_HANDLE_NULL, error,
+                ret, HG_PROTOCOL_ERROR,
+                "No previous memory handle to share for segment %u", i);
+            na_mem_handles[i] = na_mem_handles[i - 1];
+            continue;
+        }
+
         na_ret = NA_Mem_handle_deserialize(
             na_class, &na_mem_handles[i], *buf_ptr, *buf_size_left);
         HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
@@ -1455,6 +2936,67 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_deserialize_rails(
+    const char **buf_ptr, hg_size_t *buf_size_left, struct hg_bulk *hg_bulk)
+{
+    unsigned int remote_count = hg_bulk->desc.info.rail_count,
+                 rail_count = HG_BULK_MIN(remote_count,
+                     HG_Core_class_get_na_rail_count(hg_bulk->core_class));
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    /* Rails that are not known locally are skipped */
+    hg_bulk->desc.info.rail_count = (hg_uint8_t) rail_count;
+    if (rail_count > 0) {
+        hg_bulk->rails = (struct hg_bulk_rail *) calloc(
+            rail_count, sizeof(struct hg_bulk_rail));
+        HG_CHECK_ERROR(hg_bulk->rails == NULL, done, ret, HG_NOMEM,
+            "Could not allocate rail array");
+    }
+
+    for (i = 0; i < remote_count; i++) {
+        na_class_t *na_rail_class =
+            HG_Core_class_get_na_rail(hg_bulk->core_class, i);
+        na_size_t addr_serialize_size, mem_serialize_size;
+        na_return_t na_ret;
+
+        HG_BULK_DECODE(done, ret, *buf_ptr, *buf_size_left,
+            &addr_serialize_size, na_size_t);
+        HG_CHECK_ERROR(*buf_size_left < addr_serialize_size, done, ret,
+            HG_OVERFLOW, "Buffer size too small (%zu)", *buf_size_left);
+        if (i < rail_count) {
+            na_ret = NA_Addr_deserialize(na_rail_class,
+                &hg_bulk->rails[i].na_addr, *buf_ptr, *buf_size_left);
+            HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret,
+                (hg_return_t) na_ret, "Could not deserialize rail address (%s)",
+                NA_Error_to_string(na_ret));
+        }
+        *buf_ptr += addr_serialize_size;
+        *buf_size_left -= addr_serialize_size;
+
+        HG_BULK_DECODE(done, ret, *buf_ptr, *buf_size_left,
+            &mem_serialize_size, na_size_t);
+        HG_CHECK_ERROR(*buf_size_left < mem_serialize_size, done, ret,
+            HG_OVERFLOW, "Buffer size too small (%zu)", *buf_size_left);
+        if (i < rail_count) {
+            hg_bulk->rails[i].serialize_size = mem_serialize_size;
+            na_ret = NA_Mem_handle_deserialize(na_rail_class,
+                &hg_bulk->rails[i].na_mem_handle, *buf_ptr, *buf_size_left);
+            HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret,
+                (hg_return_t) na_ret,
+                "Could not deserialize rail memory handle (%s)",
+                NA_Error_to_string(na_ret));
+        }
+        *buf_ptr += mem_serialize_size;
+        *buf_size_left -= mem_serialize_size;
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 void *
 hg_bulk_get_serialize_cached_ptr(struct hg_bulk *hg_bulk)
@@ -1474,10 +3016,119 @@ void
 hg_bulk_set_serialize_cached_ptr(
     struct hg_bulk *hg_bulk, void *buf, na_size_t buf_size)
 {
+    /* Shared handles must not point to the buffer of a single RPC */
+    if (hg_bulk->cached)
+        return;
+
     hg_bulk->serialize_ptr = buf;
     hg_bulk->serialize_size = buf_size;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_bulk_set_size(struct hg_bulk *hg_bulk, hg_size_t size)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(hg_bulk->desc.info.segment_count != 1, done, ret,
+        HG_INVALID_ARG, "Handle must have a single segment");
+    HG_CHECK_ERROR(hg_bulk->eager_ref, done, ret, HG_INVALID_ARG,
+        "Cannot resize handle that references eager data");
+
+    if (hg_bulk->desc.info.len == size)
+        goto done;
+
+    hg_bulk->desc.info.len = size;
+    hg_bulk->desc.segments.s[0].len = size;
+
+    /* Serialized form has changed */
+    hg_bulk_serialize_cache_invalidate(hg_bulk);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_bulk_deserialize_eager_ref(hg_class_t *hg_class, hg_bulk_t *handle,
+    const void *buf, hg_size_t buf_size)
+{
+    struct hg_bulk_cache *hg_bulk_cache =
+        hg_core_class_get_bulk_cache(hg_class->core_class);
+
+    /* Handles that do not embed data are the same for every RPC that
+     * reuses the same exposed buffer */
+    if (hg_bulk_cache != NULL && buf_size >= sizeof(struct hg_bulk_desc_info)) {
+        struct hg_bulk_desc_info desc_info;
+
+        memcpy(&desc_info, buf, sizeof(desc_info));
+        if (!(desc_info.flags & HG_BULK_EAGER))
+            return hg_bulk_cache_get(hg_bulk_cache, hg_class->core_class,
+                (struct hg_bulk **) handle, buf, buf_size);
+    }
+
+    return hg_bulk_deserialize(hg_class->core_class, (struct hg_bulk **) handle,
+        buf, buf_size, HG_TRUE);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_bulk_release_eager_ref(struct hg_bulk *hg_bulk)
+{
+    struct hg_bulk_segment *segments = HG_BULK_SEGMENTS(hg_bulk);
+    void **bases = NULL;
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint32_t i;
+
+    if (!hg_bulk->eager_ref)
+        goto done;
+
+    /* Handle is about to be freed, data is no longer needed */
+    if (hg_atomic_get32(&hg_bulk->ref_count) == 1) {
+        hg_bulk->eager_ref = HG_FALSE;
+        goto done;
+    }
+
+    HG_LOG_DEBUG("Copying eager bulk data out of serialization buffer");
+
+    /* Copy all segments first so that handle is left untouched on failure */
+    bases = (void **) calloc(hg_bulk->desc.info.segment_count, sizeof(void *));
+    HG_CHECK_ERROR(
+        bases == NULL, error, ret, HG_NOMEM, "Could not allocate base array");
+
+    for (i = 0; i < hg_bulk->desc.info.segment_count; i++) {
+        if (!segments[i].len)
+            continue;
+
+        bases[i] = malloc(segments[i].len);
+        HG_CHECK_ERROR(bases[i] == NULL, error, ret, HG_NOMEM,
+            "Could not allocate segment");
+        memcpy(bases[i], (const void *) segments[i].base, segments[i].len);
+    }
+
+    for (i = 0; i < hg_bulk->desc.info.segment_count; i++)
+        segments[i].base = (hg_ptr_t) bases[i];
+    hg_bulk->desc.info.flags |= HG_BULK_ALLOC;
+    hg_bulk->eager_ref = HG_FALSE;
+
+    /* Segment addresses have changed */
+    hg_bulk_serialize_cache_invalidate(hg_bulk);
+
+    free(bases);
+
+done:
+    return ret;
+
+error:
+    if (bases) {
+        for (i = 0; i < hg_bulk->desc.info.segment_count; i++)
+            free(bases[i]);
+        free(bases);
+    }
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 hg_bulk_access(struct hg_bulk *hg_bulk, hg_size_t offset, hg_size_t size,
@@ -1493,8 +3144,30 @@ hg_bulk_access(struct hg_bulk *hg_bulk, hg_size_t offset, hg_size_t size,
     /* TODO use flags */
     (void) flags;
 
-    hg_bulk_offset_translate(segments, hg_bulk->desc.info.segment_count, offset,
-        &segment_index, &segment_offset);
+    /* Blocks of strided regions are returned in order */
+    if (HG_BULK_IS_STRIDED(hg_bulk)) {
+        struct hg_bulk_cursor cursor;
+
+        hg_bulk_cursor_init(&cursor, segments, 1, NULL, HG_FALSE,
+            &hg_bulk->strided, hg_bulk->desc.info.offset + offset, size);
+        while ((remaining_size > 0) && (count < max_count)) {
+            hg_size_t len = hg_bulk_cursor_next(&cursor, &segment_offset);
+
+            len = HG_BULK_MIN(remaining_size, len);
+            if (buf_ptrs)
+                buf_ptrs[count] =
+                    (void *) (segments[0].base + (hg_ptr_t) segment_offset);
+            if (buf_sizes)
+                buf_sizes[count] = len;
+            cursor.offset += len;
+            remaining_size -= len;
+            count++;
+        }
+        goto done;
+    }
+
+    hg_bulk_offset_translate(segments, hg_bulk->desc.info.segment_count,
+        hg_bulk->desc.info.offset + offset, &segment_index, &segment_offset);
 
     while ((remaining_size > 0) && (count < max_count)) {
         hg_ptr_t base;
@@ -1526,6 +3199,7 @@ hg_bulk_access(struct hg_bulk *hg_bulk, hg_size_t offset, hg_size_t size,
         count++;
     }
 
+done:
     if (actual_count)
         *actual_count = count;
 }
@@ -1643,36 +3317,10 @@ hg_bulk_op_destroy(struct hg_bulk_op_id *hg_bulk_op_id)
         goto done;
     }
 
-    /* We may have used extra op IDs if this NA class was used */
-    if (hg_bulk_op_id->na_class &&
-        hg_bulk_op_id->op_count > HG_BULK_STATIC_MAX) {
-        na_op_id_t **na_op_ids = NULL;
-#ifdef NA_HAS_SM
-        if (hg_bulk_op_id->na_class ==
-            hg_bulk_op_id->core_context->core_class->na_sm_class)
-            na_op_ids = hg_bulk_op_id->na_sm_op_ids.d;
-        else
-#endif
-            na_op_ids = hg_bulk_op_id->na_op_ids.d;
-
-        if (na_op_ids) {
-            for (i = 0; i < hg_bulk_op_id->op_count; i++) {
-                na_return_t na_ret;
-
-                if (na_op_ids[i] == NULL)
-                    continue;
-
-                na_ret = NA_Op_destroy(hg_bulk_op_id->na_class, na_op_ids[i]);
-                HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret,
-                    (hg_return_t) na_ret, "NA_Op_destroy() failed (%s)",
-                    NA_Error_to_string(na_ret));
-            }
-            free(na_op_ids);
-            hg_bulk_op_id->na_op_ids.d = NULL;
-#ifdef NA_HAS_SM
-            hg_bulk_op_id->na_sm_op_ids.d = NULL;
-#endif
-        }
+    if (hg_bulk_op_id->pipeline) {
+        hg_thread_mutex_destroy(&hg_bulk_op_id->pipeline->mutex);
+        free(hg_bulk_op_id->pipeline);
+        hg_bulk_op_id->pipeline = NULL;
     }
 
     /* Repost handle if we were listening, otherwise destroy it */
@@ -1685,10 +3333,25 @@ hg_bulk_op_destroy(struct hg_bulk_op_id *hg_bulk_op_id)
         /* Reset status */
         hg_atomic_set32(&hg_bulk_op_id->status, HG_BULK_OP_COMPLETED);
 
-        hg_thread_spin_lock(&hg_bulk_op_id->op_pool->pending_list_lock);
-        HG_LIST_INSERT_HEAD(
-            &hg_bulk_op_id->op_pool->pending_list, hg_bulk_op_id, pending);
-        hg_thread_spin_unlock(&hg_bulk_op_id->op_pool->pending_list_lock);
+        /* Extra NA op IDs are kept for the next transfer unless too many */
+        if (hg_bulk_op_id->na_op_ids.d_count > HG_BULK_NA_OP_IDS_RETAIN_MAX) {
+            ret = hg_bulk_na_op_ids_free(
+                hg_bulk_op_id->core_context->core_class->na_class,
+                &hg_bulk_op_id->na_op_ids);
+            HG_CHECK_HG_ERROR(done, ret, "Could not free NA op IDs");
+        }
+#ifdef NA_HAS_SM
+        if (hg_bulk_op_id->na_sm_op_ids.d_count >
+            HG_BULK_NA_OP_IDS_RETAIN_MAX) {
+            ret = hg_bulk_na_op_ids_free(
+                hg_bulk_op_id->core_context->core_class->na_sm_class,
+                &hg_bulk_op_id->na_sm_op_ids);
+            HG_CHECK_HG_ERROR(done, ret, "Could not free NA op IDs");
+        }
+#endif
+
+        hg_bulk_op_pool_release(hg_bulk_op_id->op_pool,
+            hg_bulk_op_magazine_get(hg_bulk_op_id->op_pool), hg_bulk_op_id);
     } else {
         HG_LOG_DEBUG("Freeing bulk op ID (%p)", hg_bulk_op_id);
 
@@ -1722,6 +3385,32 @@ hg_bulk_op_destroy(struct hg_bulk_op_id *hg_bulk_op_id)
         }
 #endif
 
+        ret = hg_bulk_na_op_ids_free(
+            hg_bulk_op_id->core_context->core_class->na_class,
+            &hg_bulk_op_id->na_op_ids);
+        HG_CHECK_HG_ERROR(done, ret, "Could not free NA op IDs");
+#ifdef NA_HAS_SM
+        ret = hg_bulk_na_op_ids_free(
+            hg_bulk_op_id->core_context->core_class->na_sm_class,
+            &hg_bulk_op_id->na_sm_op_ids);
+        HG_CHECK_HG_ERROR(done, ret, "Could not free NA op IDs");
+#endif
+
+        for (i = 0; i < HG_CORE_RAIL_MAX; i++) {
+            na_return_t na_ret;
+
+            if (hg_bulk_op_id->na_rail_op_ids[i] == NULL)
+                continue;
+
+            na_ret = NA_Op_destroy(
+                HG_Core_class_get_na_rail(
+                    hg_bulk_op_id->core_context->core_class, i),
+                hg_bulk_op_id->na_rail_op_ids[i]);
+            HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret,
+                (hg_return_t) na_ret, "NA_Op_destroy() failed (%s)",
+                NA_Error_to_string(na_ret));
+        }
+
         free(hg_bulk_op_id);
     }
 
@@ -1736,7 +3425,7 @@ hg_bulk_op_pool_create(hg_core_context_t *core_context, unsigned int init_count,
 {
     struct hg_bulk_op_pool *hg_bulk_op_pool = NULL;
     hg_return_t ret = HG_SUCCESS;
-    unsigned int i;
+    int rc;
 
     HG_LOG_DEBUG("Creating pool with %u bulk op IDs", init_count);
 
@@ -1744,29 +3433,24 @@ hg_bulk_op_pool_create(hg_core_context_t *core_context, unsigned int init_count,
         (struct hg_bulk_op_pool *) malloc(sizeof(struct hg_bulk_op_pool));
     HG_CHECK_ERROR(hg_bulk_op_pool == NULL, error, ret, HG_NOMEM,
         "Could not allocate bulk op pool");
+    memset(hg_bulk_op_pool, 0, sizeof(struct hg_bulk_op_pool));
 
     hg_thread_mutex_init(&hg_bulk_op_pool->extend_mutex);
-    hg_thread_cond_init(&hg_bulk_op_pool->extend_cond);
     hg_bulk_op_pool->core_context = core_context;
-    HG_LIST_INIT(&hg_bulk_op_pool->pending_list);
-    hg_thread_spin_init(&hg_bulk_op_pool->pending_list_lock);
-    hg_bulk_op_pool->count = init_count;
-    hg_bulk_op_pool->extending = HG_FALSE;
+    HG_LIST_INIT(&hg_bulk_op_pool->magazines);
+    hg_bulk_op_pool->count = 0;
 
-    for (i = 0; i < init_count; i++) {
-        struct hg_bulk_op_id *hg_bulk_op_id = NULL;
-
-        ret = hg_bulk_op_create(core_context, &hg_bulk_op_id);
-        HG_CHECK_HG_ERROR(error, ret, "Could not create bulk op ID");
+    rc = hg_thread_key_create(&hg_bulk_op_pool->magazine_key);
+    HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error_free, ret, HG_NOMEM,
+        "Could not create magazine key");
 
-        hg_bulk_op_id->reuse = HG_TRUE;
-        hg_bulk_op_id->op_pool = hg_bulk_op_pool;
+    hg_bulk_op_pool->free_queue =
+        hg_atomic_seg_queue_alloc(HG_BULK_OP_POOL_QUEUE_SIZE);
+    HG_CHECK_ERROR(hg_bulk_op_pool->free_queue == NULL, error, ret, HG_NOMEM,
+        "Could not allocate free queue");
 
-        hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
-        HG_LIST_INSERT_HEAD(
-            &hg_bulk_op_pool->pending_list, hg_bulk_op_id, pending);
-        hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
-    }
+    ret = hg_bulk_op_pool_extend(hg_bulk_op_pool, init_count);
+    HG_CHECK_HG_ERROR(error, ret, "Could not extend bulk op pool");
 
     HG_LOG_DEBUG("Created bulk op ID pool (%p)", hg_bulk_op_pool);
 
@@ -1778,137 +3462,921 @@ error:
     if (hg_bulk_op_pool)
         hg_bulk_op_pool_destroy(hg_bulk_op_pool);
     return ret;
+
+error_free:
+    hg_thread_mutex_destroy(&hg_bulk_op_pool->extend_mutex);
+    free(hg_bulk_op_pool);
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_bulk_op_pool_destroy(struct hg_bulk_op_pool *hg_bulk_op_pool)
 {
+    struct hg_bulk_op_magazine *hg_bulk_op_magazine;
     struct hg_bulk_op_id *hg_bulk_op_id = NULL;
     hg_return_t ret = HG_SUCCESS;
 
     HG_LOG_DEBUG("Free bulk op ID pool (%p)", hg_bulk_op_pool);
 
-    hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
-
-    hg_bulk_op_id = HG_LIST_FIRST(&hg_bulk_op_pool->pending_list);
-
-    while (hg_bulk_op_id) {
-        struct hg_bulk_op_id *hg_bulk_op_id_next =
-            HG_LIST_NEXT(hg_bulk_op_id, pending);
-        HG_LIST_REMOVE(hg_bulk_op_id, pending);
-
-        /* Prevent re-initialization */
-        hg_bulk_op_id->reuse = HG_FALSE;
+    hg_core_context_mem_release(hg_bulk_op_pool->core_context, HG_MEM_USE_BULK,
+        hg_bulk_op_pool->count * sizeof(struct hg_bulk_op_id));
+
+    /* No other thread may use the pool at this point, move op IDs cached
+     * by threads back to the free queue */
+    while ((hg_bulk_op_magazine = HG_LIST_FIRST(&hg_bulk_op_pool->magazines))) {
+        HG_LIST_REMOVE(hg_bulk_op_magazine, entry);
+        while (hg_bulk_op_magazine->count > 0) {
+            hg_bulk_op_id =
+                hg_bulk_op_magazine->op_ids[--hg_bulk_op_magazine->count];
+            hg_bulk_op_id->reuse = HG_FALSE;
+            ret = hg_bulk_op_destroy(hg_bulk_op_id);
+            HG_CHECK_HG_ERROR(done, ret, "Could not destroy bulk op ID");
+        }
+        free(hg_bulk_op_magazine);
+    }
 
-        /* Destroy op IDs */
-        ret = hg_bulk_op_destroy(hg_bulk_op_id);
-        HG_CHECK_HG_ERROR(unlock, ret, "Could not destroy bulk op ID");
+    if (hg_bulk_op_pool->free_queue) {
+        while ((hg_bulk_op_id = (struct hg_bulk_op_id *)
+                    hg_atomic_seg_queue_pop_mc(hg_bulk_op_pool->free_queue))) {
+            /* Prevent re-initialization */
+            hg_bulk_op_id->reuse = HG_FALSE;
 
-        hg_bulk_op_id = hg_bulk_op_id_next;
+            /* Destroy op IDs */
+            ret = hg_bulk_op_destroy(hg_bulk_op_id);
+            HG_CHECK_HG_ERROR(done, ret, "Could not destroy bulk op ID");
+        }
+        hg_atomic_seg_queue_free(hg_bulk_op_pool->free_queue);
     }
-    hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
 
+    hg_thread_key_delete(hg_bulk_op_pool->magazine_key);
     hg_thread_mutex_destroy(&hg_bulk_op_pool->extend_mutex);
-    hg_thread_cond_destroy(&hg_bulk_op_pool->extend_cond);
-    hg_thread_spin_destroy(&hg_bulk_op_pool->pending_list_lock);
 
     free(hg_bulk_op_pool);
 
-    return ret;
-
-unlock:
-    hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
-
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_bulk_op_pool_get(struct hg_bulk_op_pool *hg_bulk_op_pool,
-    struct hg_bulk_op_id **hg_bulk_op_id_ptr)
+hg_return_t
+hg_bulk_mem_pool_create(hg_core_class_t *core_class,
+    struct hg_bulk_mem_pool **hg_bulk_mem_pool_ptr)
 {
-    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    struct hg_bulk_mem_pool *hg_bulk_mem_pool = NULL;
     hg_return_t ret = HG_SUCCESS;
 
-    while (!hg_bulk_op_id) {
-        unsigned int i;
+    hg_bulk_mem_pool =
+        (struct hg_bulk_mem_pool *) calloc(1, sizeof(struct hg_bulk_mem_pool));
+    HG_CHECK_ERROR(hg_bulk_mem_pool == NULL, done, ret, HG_NOMEM,
+        "Could not allocate registered memory pool");
 
-        hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
-        if ((hg_bulk_op_id = HG_LIST_FIRST(&hg_bulk_op_pool->pending_list)))
-            HG_LIST_REMOVE(hg_bulk_op_id, pending);
-        hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
+    /* Regions are only allocated and registered on first use */
+    hg_thread_mutex_init(&hg_bulk_mem_pool->mutex);
+    hg_bulk_mem_pool->core_class = core_class;
+    HG_LIST_INIT(&hg_bulk_mem_pool->regions);
+    hg_atomic_init32(&hg_bulk_mem_pool->region_count, 0);
 
-        if (hg_bulk_op_id)
-            break;
+    *hg_bulk_mem_pool_ptr = hg_bulk_mem_pool;
 
-        /* Create another batch of IDs if empty */
-        hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
-        if (hg_bulk_op_pool->extending) {
-            hg_thread_cond_wait(
-                &hg_bulk_op_pool->extend_cond, &hg_bulk_op_pool->extend_mutex);
-            continue;
-        }
-        hg_bulk_op_pool->extending = HG_TRUE;
-        hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+done:
+    return ret;
+}
 
-        /* Only a single thread can extend the pool */
-        for (i = 0; i < hg_bulk_op_pool->count; i++) {
-            struct hg_bulk_op_id *new_op_id = NULL;
+/*---------------------------------------------------------------------------*/
+void
+hg_bulk_mem_pool_destroy(struct hg_bulk_mem_pool *hg_bulk_mem_pool)
+{
+    struct hg_bulk_mem_region *hg_bulk_mem_region;
 
-            ret = hg_bulk_op_create(hg_bulk_op_pool->core_context, &new_op_id);
-            HG_CHECK_HG_ERROR(error, ret, "Could not create bulk op ID");
+    if (hg_bulk_mem_pool == NULL)
+        return;
 
-            new_op_id->reuse = HG_TRUE;
-            new_op_id->op_pool = hg_bulk_op_pool;
+    while ((hg_bulk_mem_region = HG_LIST_FIRST(&hg_bulk_mem_pool->regions)))
+        hg_bulk_mem_region_destroy(hg_bulk_mem_pool, hg_bulk_mem_region);
 
-            hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
-            HG_LIST_INSERT_HEAD(
-                &hg_bulk_op_pool->pending_list, new_op_id, pending);
-            hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
-        }
-        hg_bulk_op_pool->count *= 2;
+    hg_thread_mutex_destroy(&hg_bulk_mem_pool->mutex);
+    free(hg_bulk_mem_pool);
+}
 
-        hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
-        hg_bulk_op_pool->extending = HG_FALSE;
-        hg_thread_cond_broadcast(&hg_bulk_op_pool->extend_cond);
-        hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
-    }
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_bulk_cache_create(
+    hg_uint32_t max_count, struct hg_bulk_cache **hg_bulk_cache_ptr)
+{
+    struct hg_bulk_cache *hg_bulk_cache = NULL;
+    hg_return_t ret = HG_SUCCESS;
 
-    *hg_bulk_op_id_ptr = hg_bulk_op_id;
+    hg_bulk_cache =
+        (struct hg_bulk_cache *) calloc(1, sizeof(struct hg_bulk_cache));
+    HG_CHECK_ERROR(hg_bulk_cache == NULL, error, ret, HG_NOMEM,
+        "Could not allocate remote handle cache");
+
+    hg_bulk_cache->table =
+        hg_hash_table_new(hg_bulk_cache_hash, hg_bulk_cache_equal);
+    HG_CHECK_ERROR(hg_bulk_cache->table == NULL, error, ret, HG_NOMEM,
+        "Could not allocate remote handle cache table");
+    hg_thread_mutex_init(&hg_bulk_cache->mutex);
+    HG_QUEUE_INIT(&hg_bulk_cache->queue);
+    hg_bulk_cache->max_count = max_count;
+
+    *hg_bulk_cache_ptr = hg_bulk_cache;
 
     return ret;
 
 error:
-    hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
-    hg_bulk_op_pool->extending = HG_FALSE;
-    hg_thread_cond_broadcast(&hg_bulk_op_pool->extend_cond);
-    hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+    free(hg_bulk_cache);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_bulk_transfer(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
-    hg_bulk_op_t op, struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
-    struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
-    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
-    hg_op_id_t *op_id)
+void
+hg_bulk_cache_destroy(struct hg_bulk_cache *hg_bulk_cache)
+{
+    struct hg_bulk_cache_entry *entry;
+
+    if (hg_bulk_cache == NULL)
+        return;
+
+    while ((entry = HG_QUEUE_FIRST(&hg_bulk_cache->queue)) != NULL) {
+        HG_QUEUE_POP_HEAD(&hg_bulk_cache->queue, entry);
+        hg_bulk_free(entry->hg_bulk);
+        free(entry);
+    }
+
+    hg_hash_table_free(hg_bulk_cache->table);
+    hg_thread_mutex_destroy(&hg_bulk_cache->mutex);
+    free(hg_bulk_cache);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_op_pool_extend(
+    struct hg_bulk_op_pool *hg_bulk_op_pool, unsigned long count)
+{
+    hg_return_t ret = HG_SUCCESS;
+    unsigned long i;
+
+    for (i = 0; i < count; i++) {
+        struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+
+        ret = hg_bulk_op_create(hg_bulk_op_pool->core_context, &hg_bulk_op_id);
+        HG_CHECK_HG_ERROR(done, ret, "Could not create bulk op ID");
+
+        hg_bulk_op_id->reuse = HG_TRUE;
+        hg_bulk_op_id->op_pool = hg_bulk_op_pool;
+        hg_core_context_mem_acquire(hg_bulk_op_pool->core_context,
+            HG_MEM_USE_BULK, sizeof(struct hg_bulk_op_id));
+        hg_bulk_op_pool->count++;
+
+        /* New op IDs are shared through the free queue */
+        hg_bulk_op_pool_release(hg_bulk_op_pool, NULL, hg_bulk_op_id);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_bulk_op_magazine *
+hg_bulk_op_magazine_get(struct hg_bulk_op_pool *hg_bulk_op_pool)
+{
+    struct hg_bulk_op_magazine *hg_bulk_op_magazine =
+        (struct hg_bulk_op_magazine *) hg_thread_getspecific(
+            hg_bulk_op_pool->magazine_key);
+
+    if (likely(hg_bulk_op_magazine))
+        goto done;
+
+    /* First use of the pool by this thread */
+    hg_bulk_op_magazine = (struct hg_bulk_op_magazine *) malloc(
+        sizeof(struct hg_bulk_op_magazine));
+    if (hg_bulk_op_magazine == NULL)
+        goto done;
+    hg_bulk_op_magazine->count = 0;
+
+    if (hg_thread_setspecific(hg_bulk_op_pool->magazine_key,
+            hg_bulk_op_magazine) != HG_UTIL_SUCCESS) {
+        free(hg_bulk_op_magazine);
+        hg_bulk_op_magazine = NULL;
+        goto done;
+    }
+
+    /* Keep track of magazine so that it can be released with the pool */
+    hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
+    HG_LIST_INSERT_HEAD(
+        &hg_bulk_op_pool->magazines, hg_bulk_op_magazine, entry);
+    hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+
+done:
+    return hg_bulk_op_magazine;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_op_pool_get(struct hg_bulk_op_pool *hg_bulk_op_pool,
+    struct hg_bulk_op_id **hg_bulk_op_id_ptr)
+{
+    struct hg_bulk_op_magazine *hg_bulk_op_magazine =
+        hg_bulk_op_magazine_get(hg_bulk_op_pool);
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    while (!hg_bulk_op_id) {
+        if (hg_bulk_op_magazine) {
+            /* Refill magazine from free queue if empty */
+            if (hg_bulk_op_magazine->count == 0)
+                hg_bulk_op_magazine->count =
+                    hg_atomic_seg_queue_pop_mc_n(hg_bulk_op_pool->free_queue,
+                        (void **) hg_bulk_op_magazine->op_ids,
+                        HG_BULK_OP_MAGAZINE_SIZE / 2);
+            if (hg_bulk_op_magazine->count > 0)
+                hg_bulk_op_id =
+                    hg_bulk_op_magazine->op_ids[--hg_bulk_op_magazine->count];
+        } else
+            hg_bulk_op_id = (struct hg_bulk_op_id *) hg_atomic_seg_queue_pop_mc(
+                hg_bulk_op_pool->free_queue);
+
+        if (hg_bulk_op_id)
+            break;
+
+        /* Create another batch of IDs if empty, other threads that found the
+         * queue empty retry once the pool has been extended */
+        hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
+        if (hg_atomic_seg_queue_is_empty(hg_bulk_op_pool->free_queue)) {
+            /* Double size of pool up to a max number of new op IDs */
+            unsigned long count = (hg_bulk_op_pool->count > 0)
+                                      ? hg_bulk_op_pool->count
+                                      : HG_BULK_OP_MAGAZINE_SIZE;
+
+            hg_core_context_alloc_fallback(
+                hg_bulk_op_pool->core_context, "bulk op IDs");
+            ret = hg_bulk_op_pool_extend(hg_bulk_op_pool,
+                HG_BULK_MIN(count, HG_BULK_OP_POOL_EXTEND_MAX));
+        }
+        hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+        HG_CHECK_HG_ERROR(done, ret, "Could not extend bulk op pool");
+    }
+
+    *hg_bulk_op_id_ptr = hg_bulk_op_id;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_op_pool_release(struct hg_bulk_op_pool *hg_bulk_op_pool,
+    struct hg_bulk_op_magazine *hg_bulk_op_magazine,
+    struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    void *op_ids[HG_BULK_OP_MAGAZINE_SIZE / 2 + 1];
+    unsigned int count = 0, n;
+
+    if (hg_bulk_op_magazine) {
+        if (hg_bulk_op_magazine->count < HG_BULK_OP_MAGAZINE_SIZE) {
+            hg_bulk_op_magazine->op_ids[hg_bulk_op_magazine->count++] =
+                hg_bulk_op_id;
+            return;
+        }
+        /* Magazine is full, also return half of it to the free queue */
+        while (count < HG_BULK_OP_MAGAZINE_SIZE / 2)
+            op_ids[count++] =
+                hg_bulk_op_magazine->op_ids[--hg_bulk_op_magazine->count];
+    }
+    op_ids[count++] = hg_bulk_op_id;
+
+    /* Entries are pushed at once */
+    n = hg_atomic_seg_queue_push_n(hg_bulk_op_pool->free_queue, op_ids, count);
+    for (; n < count; n++) {
+        hg_bulk_op_id = (struct hg_bulk_op_id *) op_ids[n];
+        HG_LOG_ERROR("Could not release bulk op ID (%p)", hg_bulk_op_id);
+        hg_bulk_op_id->reuse = HG_FALSE;
+        hg_atomic_set32(&hg_bulk_op_id->ref_count, 1);
+        hg_bulk_op_destroy(hg_bulk_op_id);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_progress_cb_t progress_cb, void *progress_arg,
+    hg_bulk_chunk_cb_t chunk_cb, void *chunk_arg, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_op_id_t *op_id)
+{
+    struct hg_bulk *hg_bulk_origin = (struct hg_bulk *) origin_handle;
+    struct hg_bulk *hg_bulk_local = (struct hg_bulk *) local_handle;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
+
+    /* Origin handle sanity checks */
+    HG_CHECK_ERROR(hg_bulk_origin == NULL, done, ret, HG_INVALID_ARG,
+        "NULL origin handle passed");
+    HG_CHECK_ERROR((origin_offset + size) > hg_bulk_origin->desc.info.len, done,
+        ret, HG_INVALID_ARG,
+        "Exceeding size of memory exposed by origin handle (%zu + %zu > %zu)",
+        origin_offset, size, hg_bulk_origin->desc.info.len);
+    HG_CHECK_ERROR(hg_bulk_origin->addr != HG_CORE_ADDR_NULL, done, ret,
+        HG_INVALID_ARG,
+        "Address information embedded into origin_handle, use "
+        "HG_Bulk_bind_transfer() instead");
+
+    /* Local handle sanity checks */
+    HG_CHECK_ERROR(hg_bulk_local == NULL, done, ret, HG_INVALID_ARG,
+        "NULL origin handle passed");
+    HG_CHECK_ERROR((local_offset + size) > hg_bulk_local->desc.info.len, done,
+        ret, HG_INVALID_ARG,
+        "Exceeding size of memory exposed by local handle (%zu + %zu > %zu)",
+        local_offset, size, hg_bulk_local->desc.info.len);
+
+    /* Check permission flags */
+    HG_BULK_CHECK_FLAGS(op, hg_bulk_origin->desc.info.flags,
+        hg_bulk_local->desc.info.flags, done, ret);
+
+    HG_LOG_DEBUG(
+        "Transferring data between bulk handle (%p) and bulk handle (%p)",
+        hg_bulk_origin, hg_bulk_local);
+
+    /* Do bulk transfer */
+    ret = hg_bulk_transfer(context->core_context, callback, arg, progress_cb,
+        progress_arg, chunk_cb, chunk_arg, op, (hg_core_addr_t) origin_addr,
+        origin_id, hg_bulk_origin, origin_offset, hg_bulk_local, local_offset,
+        size, op_id);
+    HG_CHECK_HG_ERROR(done, ret, "Could not start transfer of bulk data");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
+    hg_bulk_progress_cb_t progress_cb, void *progress_arg,
+    hg_bulk_chunk_cb_t chunk_cb, void *chunk_arg, hg_bulk_op_t op,
+    struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
+    struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
+    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
+    hg_op_id_t *op_id)
+{
+    const struct hg_bulk_segment *origin_segments =
+        HG_BULK_SEGMENTS(hg_bulk_origin);
+    const struct hg_bulk_segment *local_segments =
+        HG_BULK_SEGMENTS(hg_bulk_local);
+    hg_uint32_t origin_count = hg_bulk_origin->desc.info.segment_count,
+                local_count = hg_bulk_local->desc.info.segment_count;
+    uint8_t origin_flags = hg_bulk_origin->desc.info.flags;
+    uint8_t local_flags = hg_bulk_local->desc.info.flags;
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    struct hg_bulk_op_pool *hg_bulk_op_pool =
+        hg_core_context_get_bulk_op_pool(core_context);
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Regions of views start within their first segment */
+    origin_offset += hg_bulk_origin->desc.info.offset;
+    local_offset += hg_bulk_local->desc.info.offset;
+
+    /* Get a new OP ID from context */
+    if (hg_bulk_op_pool) {
+        ret = hg_bulk_op_pool_get(hg_bulk_op_pool, &hg_bulk_op_id);
+        HG_CHECK_HG_ERROR(error, ret, "Could not get bulk op ID");
+    } else {
+        ret = hg_bulk_op_create(core_context, &hg_bulk_op_id);
+        HG_CHECK_HG_ERROR(error, ret, "Could not create bulk op ID");
+    }
+
+    hg_bulk_op_id->callback = callback;
+    hg_bulk_op_id->callback_info.arg = arg;
+    hg_bulk_op_id->callback_info.info.bulk.origin_handle = hg_bulk_origin;
+    hg_atomic_incr32_relaxed(&hg_bulk_origin->ref_count);
+    hg_bulk_op_id->callback_info.info.bulk.local_handle = hg_bulk_local;
+    hg_atomic_incr32_relaxed(&hg_bulk_local->ref_count);
+    hg_bulk_op_id->callback_info.info.bulk.op = op;
+    hg_bulk_op_id->progress_cb = progress_cb;
+    hg_bulk_op_id->progress_arg = progress_arg;
+    hg_bulk_op_id->chunk_cb = chunk_cb;
+    hg_bulk_op_id->chunk_arg = chunk_arg;
+    hg_bulk_op_id->size = size;
+
+    /* Reset status */
+    hg_atomic_set32(&hg_bulk_op_id->status, 0);
+    hg_bulk_op_id->err_ret = HG_SUCCESS;
+
+    /* Expected op count */
+    hg_bulk_op_id->op_count = (size > 0) ? 1 : 0; /* Default */
+    hg_bulk_op_id->rail_op_count = 0;
+    hg_atomic_set32(&hg_bulk_op_id->op_completed_count, 0);
+
+    if (size == 0) {
+        /* Complete immediately */
+        ret = hg_bulk_complete(hg_bulk_op_id, HG_TRUE);
+        HG_CHECK_HG_ERROR(error, ret, "Could not complete bulk operation");
+    } else if (HG_Core_addr_is_self(origin_addr) ||
+               ((origin_flags & HG_BULK_EAGER) && (op != HG_BULK_PUSH))) {
+        HG_CHECK_ERROR(HG_BULK_IS_DEVICE(hg_bulk_origin) ||
+                           HG_BULK_IS_DEVICE(hg_bulk_local),
+            error, ret, HG_OPNOTSUPPORTED,
+            "Device memory cannot be copied locally");
+
+        hg_bulk_op_id->na_class = NULL;
+        hg_bulk_op_id->na_context = NULL;
+
+        /* When doing eager transfers, use self code path to copy data locally
+         */
+        hg_bulk_hook(hg_bulk_op_id, HG_HOOK_BULK_START, op, size, HG_SUCCESS);
+        if (HG_BULK_IS_STRIDED(hg_bulk_origin) ||
+            HG_BULK_IS_STRIDED(hg_bulk_local))
+            ret = hg_bulk_transfer_self_strided(op, hg_bulk_origin,
+                origin_offset, hg_bulk_local, local_offset, size,
+                hg_bulk_op_id);
+        else
+            ret = hg_bulk_transfer_self(op, origin_segments, origin_count,
+                origin_offset, local_segments, local_count, local_offset, size,
+                hg_bulk_op_id);
+    } else {
+        struct hg_bulk_na_mem_desc *origin_mem_descs, *local_mem_descs;
+        na_mem_handle_t *origin_mem_handles, *local_mem_handles;
+        na_addr_t na_origin_addr = NA_ADDR_NULL;
+        hg_uint32_t stripe_count = 1, max_inflight;
+        hg_size_t chunk_size;
+
+#ifdef NA_HAS_SM
+        /* Use SM if we can */
+        if (hg_bulk_origin->desc.info.flags & HG_BULK_SM) {
+            HG_LOG_DEBUG("Using NA SM class for this transfer");
+            HG_CHECK_ERROR(HG_BULK_IS_DEVICE(hg_bulk_local), error, ret,
+                HG_OPNOTSUPPORTED,
+                "Device memory cannot be transferred through SM");
+
+            hg_bulk_op_id->na_class = hg_bulk_origin->na_sm_class;
+            hg_bulk_op_id->na_context = HG_Core_context_get_na_sm(core_context);
+            na_origin_addr = HG_Core_addr_get_na_sm(origin_addr);
+            origin_mem_descs = &hg_bulk_origin->na_sm_mem_descs;
+            local_mem_descs = &hg_bulk_local->na_sm_mem_descs;
+        } else {
+#endif
+            HG_LOG_DEBUG("Using default NA class for this transfer");
+
+            hg_bulk_op_id->na_class = hg_bulk_origin->na_class;
+            hg_bulk_op_id->na_context = HG_Core_context_get_na(core_context);
+            na_origin_addr = HG_Core_addr_get_na(origin_addr);
+            origin_mem_descs = &hg_bulk_origin->na_mem_descs;
+            local_mem_descs = &hg_bulk_local->na_mem_descs;
+#ifdef NA_HAS_SM
+        }
+#endif
+
+        /* Large transfers between handles registered on rails are striped,
+         * unless the transfer would be pipelined in chunks */
+        hg_core_class_get_bulk_pipeline(
+            core_context->core_class, &chunk_size, &max_inflight);
+        if (!(origin_flags & HG_BULK_SM) &&
+            !HG_BULK_IS_STRIDED(hg_bulk_origin) &&
+            !HG_BULK_IS_STRIDED(hg_bulk_local) && hg_bulk_origin->rails &&
+            hg_bulk_origin->rails[0].na_addr != NA_ADDR_NULL &&
+            hg_bulk_local->rails && (chunk_size == 0 || size <= chunk_size)) {
+            stripe_count = (hg_uint32_t) HG_BULK_MIN(
+                               hg_bulk_origin->desc.info.rail_count,
+                               hg_bulk_local->desc.info.rail_count) +
+                           1;
+            if ((hg_size_t) stripe_count * HG_BULK_RAIL_STRIPE_MIN > size)
+                stripe_count = (hg_uint32_t) (size / HG_BULK_RAIL_STRIPE_MIN);
+        }
+
+        if (stripe_count > 1)
+            ret = hg_bulk_transfer_rails(op, na_origin_addr, origin_id,
+                hg_bulk_origin, origin_offset, hg_bulk_local, local_offset,
+                size, stripe_count, hg_bulk_op_id);
+        else {
+            origin_mem_handles = HG_BULK_MEM_HANDLES(
+                origin_mem_descs, origin_count, origin_flags);
+            local_mem_handles =
+                HG_BULK_MEM_HANDLES(local_mem_descs, local_count, local_flags);
+
+            ret = hg_bulk_transfer_na(op, na_origin_addr, origin_id,
+                origin_segments, origin_count, origin_mem_handles,
+                origin_flags, origin_offset,
+                HG_BULK_IS_STRIDED(hg_bulk_origin) ? &hg_bulk_origin->strided
+                                                   : NULL,
+                local_segments, local_count, local_mem_handles, local_flags,
+                local_offset,
+                HG_BULK_IS_STRIDED(hg_bulk_local) ? &hg_bulk_local->strided
+                                                  : NULL,
+                size, hg_bulk_op_id);
+        }
+    }
+
+    /* Assign op_id */
+    if (op_id && op_id != HG_OP_ID_IGNORE)
+        *op_id = (hg_op_id_t) hg_bulk_op_id;
+
+    return ret;
+
+error:
+    if (hg_bulk_op_id) {
+        hg_return_t hg_ret = hg_bulk_op_destroy(hg_bulk_op_id);
+        HG_CHECK_ERROR_DONE(hg_ret != HG_SUCCESS, "Could not destroy op ID");
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_list(hg_core_context_t *core_context, hg_cb_t callback,
+    void *arg, hg_bulk_op_t op, struct hg_core_addr *origin_addr,
+    hg_uint8_t origin_id, const struct hg_bulk_transfer_desc *transfers,
+    hg_uint32_t count, hg_op_id_t *op_id)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    struct hg_bulk_op_pool *hg_bulk_op_pool =
+        hg_core_context_get_bulk_op_pool(core_context);
+    struct hg_bulk *hg_bulk_origin = NULL, *hg_bulk_local = NULL;
+    struct hg_bulk_list_entry *list = NULL;
+    hg_bulk_na_op_id_t *hg_bulk_na_op_ids = NULL;
+    na_addr_t na_origin_addr = NA_ADDR_NULL;
+    hg_bool_t self = HG_Core_addr_is_self(origin_addr);
+    hg_bulk_copy_op_t copy_op;
+    na_bulk_op_t na_bulk_op;
+    hg_uint32_t list_count = 0, op_count = 0, i;
+    hg_size_t size = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    switch (op) {
+        case HG_BULK_PUSH:
+            copy_op = hg_bulk_memcpy_put;
+            na_bulk_op = hg_bulk_na_put;
+            break;
+        case HG_BULK_PULL:
+            copy_op = hg_bulk_memcpy_get;
+            na_bulk_op = hg_bulk_na_get;
+            break;
+        default:
+            HG_GOTO_ERROR(error, ret, HG_INVALID_ARG, "Unknown bulk operation");
+    }
+
+    /* Get a new OP ID from context */
+    if (hg_bulk_op_pool) {
+        ret = hg_bulk_op_pool_get(hg_bulk_op_pool, &hg_bulk_op_id);
+        HG_CHECK_HG_ERROR(error, ret, "Could not get bulk op ID");
+    } else {
+        ret = hg_bulk_op_create(core_context, &hg_bulk_op_id);
+        HG_CHECK_HG_ERROR(error, ret, "Could not create bulk op ID");
+    }
+    hg_bulk_op_id->na_class = NULL;
+    hg_bulk_op_id->na_context = NULL;
+
+    list = (struct hg_bulk_list_entry *) malloc(
+        count * sizeof(struct hg_bulk_list_entry));
+    HG_CHECK_ERROR(list == NULL, error, ret, HG_NOMEM,
+        "Could not allocate list entries");
+    hg_bulk_op_id->list = list;
+    hg_bulk_op_id->list_count = 0;
+
+    /* Merge entries that extend the previous range on both sides, entries
+     * keep a reference to their handles until completion */
+    for (i = 0; i < count; i++) {
+        struct hg_bulk *origin = (struct hg_bulk *) transfers[i].origin_handle;
+        struct hg_bulk *local = (struct hg_bulk *) transfers[i].local_handle;
+        hg_size_t origin_offset =
+            transfers[i].origin_offset + origin->desc.info.offset;
+        hg_size_t local_offset =
+            transfers[i].local_offset + local->desc.info.offset;
+        struct hg_bulk_list_entry *entry;
+
+        if (transfers[i].size == 0)
+            continue;
+        size += transfers[i].size;
+
+        if (list_count > 0) {
+            entry = &list[list_count - 1];
+            if (entry->origin == origin && entry->local == local &&
+                entry->origin_offset + entry->size == origin_offset &&
+                entry->local_offset + entry->size == local_offset) {
+                entry->size += transfers[i].size;
+                continue;
+            }
+        }
+
+        entry = &list[list_count++];
+        entry->origin = origin;
+        hg_atomic_incr32_relaxed(&origin->ref_count);
+        entry->local = local;
+        hg_atomic_incr32_relaxed(&local->ref_count);
+        entry->origin_offset = origin_offset;
+        entry->local_offset = local_offset;
+        entry->size = transfers[i].size;
+        entry->op_count = 0;
+        hg_bulk_op_id->list_count = list_count;
+    }
+
+    /* Ranges that are not copied locally must all use the same NA class */
+    for (i = 0; i < list_count; i++) {
+        struct hg_bulk_list_entry *entry = &list[i];
+        hg_uint8_t origin_flags = entry->origin->desc.info.flags;
+        struct hg_bulk_cursor origin, local;
+
+        if (self || ((origin_flags & HG_BULK_EAGER) && (op != HG_BULK_PUSH))) {
+            HG_CHECK_ERROR(HG_BULK_IS_DEVICE(entry->origin) ||
+                               HG_BULK_IS_DEVICE(entry->local),
+                error, ret, HG_OPNOTSUPPORTED,
+                "Device memory cannot be copied locally");
+            continue;
+        }
+
+        if (hg_bulk_origin == NULL) {
+            hg_bulk_origin = entry->origin;
+            hg_bulk_local = entry->local;
+#ifdef NA_HAS_SM
+            if (origin_flags & HG_BULK_SM) {
+                hg_bulk_op_id->na_class = hg_bulk_origin->na_sm_class;
+                hg_bulk_op_id->na_context =
+                    HG_Core_context_get_na_sm(core_context);
+                na_origin_addr = HG_Core_addr_get_na_sm(origin_addr);
+                hg_bulk_na_op_ids = &hg_bulk_op_id->na_sm_op_ids;
+            } else {
+#endif
+                hg_bulk_op_id->na_class = hg_bulk_origin->na_class;
+                hg_bulk_op_id->na_context =
+                    HG_Core_context_get_na(core_context);
+                na_origin_addr = HG_Core_addr_get_na(origin_addr);
+                hg_bulk_na_op_ids = &hg_bulk_op_id->na_op_ids;
+#ifdef NA_HAS_SM
+            }
+#endif
+        }
+        HG_CHECK_ERROR((origin_flags ^ hg_bulk_origin->desc.info.flags) &
+                           HG_BULK_SM,
+            error, ret, HG_INVALID_ARG,
+            "Origin handles of list must use the same transport");
+        HG_CHECK_ERROR(
+            (origin_flags & HG_BULK_SM) && HG_BULK_IS_DEVICE(entry->local),
+            error, ret, HG_OPNOTSUPPORTED,
+            "Device memory cannot be transferred through SM");
+
+        hg_bulk_list_entry_cursors(entry, &origin, &local);
+        entry->op_count = hg_bulk_transfer_get_op_count(origin.segments,
+            origin.count, origin.index, origin.offset, local.segments,
+            local.count, local.index, local.offset, entry->size, 0);
+        HG_CHECK_ERROR(entry->op_count == 0, error, ret, HG_INVALID_ARG,
+            "Could not get bulk op_count");
+        op_count += entry->op_count;
+    }
+
+    /* Report handles of first NA range, or first range if all are copied */
+    if (hg_bulk_origin == NULL) {
+        hg_bulk_origin = (list_count > 0)
+                             ? list[0].origin
+                             : (struct hg_bulk *) transfers[0].origin_handle;
+        hg_bulk_local = (list_count > 0)
+                            ? list[0].local
+                            : (struct hg_bulk *) transfers[0].local_handle;
+    }
+
+    hg_bulk_op_id->callback = callback;
+    hg_bulk_op_id->callback_info.arg = arg;
+    hg_bulk_op_id->callback_info.info.bulk.origin_handle = hg_bulk_origin;
+    hg_atomic_incr32_relaxed(&hg_bulk_origin->ref_count);
+    hg_bulk_op_id->callback_info.info.bulk.local_handle = hg_bulk_local;
+    hg_atomic_incr32_relaxed(&hg_bulk_local->ref_count);
+    hg_bulk_op_id->callback_info.info.bulk.op = op;
+    hg_bulk_op_id->progress_cb = NULL;
+    hg_bulk_op_id->progress_arg = NULL;
+    hg_bulk_op_id->chunk_cb = NULL;
+    hg_bulk_op_id->chunk_arg = NULL;
+    hg_bulk_op_id->size = size;
+
+    /* Reset status */
+    hg_atomic_set32(&hg_bulk_op_id->status, 0);
+    hg_bulk_op_id->err_ret = HG_SUCCESS;
+
+    hg_bulk_op_id->op_count = op_count;
+    hg_bulk_op_id->rail_op_count = 0;
+    hg_atomic_set32(&hg_bulk_op_id->op_completed_count, 0);
+
+    /* Local copies are done before NA operations can complete */
+    for (i = 0; i < list_count; i++) {
+        struct hg_bulk_list_entry *entry = &list[i];
+        hg_uint32_t origin_segment_start_index, local_segment_start_index;
+        hg_size_t origin_segment_start_offset, local_segment_start_offset;
+
+        if (entry->op_count > 0)
+            continue;
+
+        hg_bulk_offset_translate(HG_BULK_SEGMENTS(entry->origin),
+            entry->origin->desc.info.segment_count, entry->origin_offset,
+            &origin_segment_start_index, &origin_segment_start_offset);
+        hg_bulk_offset_translate(HG_BULK_SEGMENTS(entry->local),
+            entry->local->desc.info.segment_count, entry->local_offset,
+            &local_segment_start_index, &local_segment_start_offset);
+
+        hg_bulk_transfer_segments_self(copy_op,
+            HG_BULK_SEGMENTS(entry->origin),
+            entry->origin->desc.info.segment_count, origin_segment_start_index,
+            origin_segment_start_offset, HG_BULK_SEGMENTS(entry->local),
+            entry->local->desc.info.segment_count, local_segment_start_index,
+            local_segment_start_offset, entry->size);
+    }
+
+    if (op_count == 0) {
+        /* Complete immediately */
+        ret = hg_bulk_complete(hg_bulk_op_id, HG_TRUE);
+        HG_CHECK_HG_ERROR(error, ret, "Could not complete bulk operation");
+    } else {
+        na_op_id_t **na_op_ids;
+        hg_uint32_t posted = 0;
+        na_return_t na_ret;
+
+        HG_PROBE3(mercury, bulk_transfer, hg_bulk_op_id, op, size);
+        hg_bulk_hook(hg_bulk_op_id, HG_HOOK_BULK_START, op, size, HG_SUCCESS);
+        HG_LOG_DEBUG("Transferring %u range(s) through NA in %u operation(s)",
+            list_count, op_count);
+
+        ret = hg_bulk_na_op_ids_get(
+            hg_bulk_op_id, hg_bulk_na_op_ids, op_count, &na_op_ids);
+        HG_CHECK_HG_ERROR(error, ret, "Could not get NA op IDs");
+
+        /* Let plugin submit operations of all ranges at once */
+        (void) NA_Op_batch_begin(
+            hg_bulk_op_id->na_class, hg_bulk_op_id->na_context);
+
+        for (i = 0; i < list_count && ret == HG_SUCCESS; i++) {
+            struct hg_bulk_list_entry *entry = &list[i];
+            struct hg_bulk_cursor origin, local;
+
+            if (entry->op_count == 0)
+                continue;
+
+            hg_bulk_list_entry_cursors(entry, &origin, &local);
+            ret = hg_bulk_transfer_segments_na(hg_bulk_op_id->na_class,
+                hg_bulk_op_id->na_context, na_bulk_op, hg_bulk_transfer_cb,
+                hg_bulk_op_id, na_origin_addr, origin_id, origin.segments,
+                origin.count, origin.mem_handles, origin.index, origin.offset,
+                local.segments, local.count, local.mem_handles, local.index,
+                local.offset, entry->size, &na_op_ids[posted],
+                entry->op_count);
+            posted += entry->op_count;
+        }
+
+        na_ret =
+            NA_Op_batch_end(hg_bulk_op_id->na_class, hg_bulk_op_id->na_context);
+        HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
+            "Could not end batch of operations (%s)",
+            NA_Error_to_string(na_ret));
+        HG_CHECK_HG_ERROR(error, ret, "Could not transfer data segments");
+    }
+
+    /* Assign op_id */
+    if (op_id && op_id != HG_OP_ID_IGNORE)
+        *op_id = (hg_op_id_t) hg_bulk_op_id;
+
+    return ret;
+
+error:
+    if (hg_bulk_op_id) {
+        hg_return_t hg_ret = hg_bulk_list_release(hg_bulk_op_id);
+        HG_CHECK_ERROR_DONE(
+            hg_ret != HG_SUCCESS, "Could not release list entries");
+
+        hg_ret = hg_bulk_op_destroy(hg_bulk_op_id);
+        HG_CHECK_ERROR_DONE(hg_ret != HG_SUCCESS, "Could not destroy op ID");
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_list_entry_cursors(const struct hg_bulk_list_entry *entry,
+    struct hg_bulk_cursor *origin, struct hg_bulk_cursor *local)
+{
+    hg_uint32_t origin_count = entry->origin->desc.info.segment_count,
+                local_count = entry->local->desc.info.segment_count;
+    hg_uint8_t origin_flags = entry->origin->desc.info.flags,
+               local_flags = entry->local->desc.info.flags;
+    struct hg_bulk_na_mem_desc *origin_mem_descs, *local_mem_descs;
+
+#ifdef NA_HAS_SM
+    if (origin_flags & HG_BULK_SM) {
+        origin_mem_descs = &entry->origin->na_sm_mem_descs;
+        local_mem_descs = &entry->local->na_sm_mem_descs;
+    } else {
+#endif
+        origin_mem_descs = &entry->origin->na_mem_descs;
+        local_mem_descs = &entry->local->na_mem_descs;
+#ifdef NA_HAS_SM
+    }
+#endif
+
+    hg_bulk_cursor_init(origin, HG_BULK_SEGMENTS(entry->origin), origin_count,
+        HG_BULK_MEM_HANDLES(origin_mem_descs, origin_count, origin_flags),
+        (origin_flags & HG_BULK_REGV) || origin_count == 1, NULL,
+        entry->origin_offset, entry->size);
+    hg_bulk_cursor_init(local, HG_BULK_SEGMENTS(entry->local), local_count,
+        HG_BULK_MEM_HANDLES(local_mem_descs, local_count, local_flags),
+        (local_flags & HG_BULK_REGV) || local_count == 1, NULL,
+        entry->local_offset, entry->size);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_list_release(struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint32_t i;
+
+    for (i = 0; i < hg_bulk_op_id->list_count; i++) {
+        ret = hg_bulk_free(hg_bulk_op_id->list[i].origin);
+        HG_CHECK_HG_ERROR(done, ret, "Could not free origin handle");
+
+        ret = hg_bulk_free(hg_bulk_op_id->list[i].local);
+        HG_CHECK_HG_ERROR(done, ret, "Could not free local handle");
+    }
+
+done:
+    free(hg_bulk_op_id->list);
+    hg_bulk_op_id->list = NULL;
+    hg_bulk_op_id->list_count = 0;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_atomic_locate(struct hg_bulk *hg_bulk, na_mem_handle_t *mem_handles,
+    hg_size_t offset, void **ptr, na_mem_handle_t *mem_handle,
+    na_offset_t *mem_offset)
+{
+    const struct hg_bulk_segment *segments = HG_BULK_SEGMENTS(hg_bulk);
+    hg_uint32_t count = hg_bulk->desc.info.segment_count;
+    const struct hg_bulk_strided *strided =
+        HG_BULK_IS_STRIDED(hg_bulk) ? &hg_bulk->strided : NULL;
+    struct hg_bulk_cursor cursor;
+    hg_size_t segment_offset;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Address of value within its segment */
+    hg_bulk_cursor_init(&cursor, segments, count, NULL, HG_FALSE, strided,
+        offset, sizeof(hg_uint64_t));
+    HG_CHECK_ERROR(hg_bulk_cursor_next(&cursor, &segment_offset) <
+                       sizeof(hg_uint64_t),
+        done, ret, HG_INVALID_ARG, "Atomic value must not span segments");
+    *ptr = (char *) cursor.segments[cursor.index].base + segment_offset;
+    HG_CHECK_ERROR(((hg_ptr_t) *ptr & 7) != 0, done, ret, HG_INVALID_ARG,
+        "Atomic value is not 8-byte aligned");
+
+    /* Memory handle exposing it, offsets of virtually contiguous handles are
+     * relative to the start of the handle */
+    if (mem_handles) {
+        hg_bulk_cursor_init(&cursor, segments, count, mem_handles,
+            !strided && ((hg_bulk->desc.info.flags & HG_BULK_REGV) ||
+                            count == 1),
+            strided, offset, sizeof(hg_uint64_t));
+        (void) hg_bulk_cursor_next(&cursor, &segment_offset);
+        *mem_handle = cursor.mem_handles[cursor.index];
+        *mem_offset = (na_offset_t) (cursor.handle_offset + segment_offset);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_atomic(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
+    hg_bulk_atomic_op_t op, hg_uint64_t operand, hg_uint64_t compare,
+    struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
+    struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
+    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_op_id_t *op_id)
 {
-    const struct hg_bulk_segment *origin_segments =
-        HG_BULK_SEGMENTS(hg_bulk_origin);
-    const struct hg_bulk_segment *local_segments =
-        HG_BULK_SEGMENTS(hg_bulk_local);
-    hg_uint32_t origin_count = hg_bulk_origin->desc.info.segment_count,
-                local_count = hg_bulk_local->desc.info.segment_count;
-    uint8_t origin_flags = hg_bulk_origin->desc.info.flags;
-    uint8_t local_flags = hg_bulk_local->desc.info.flags;
     struct hg_bulk_op_id *hg_bulk_op_id = NULL;
     struct hg_bulk_op_pool *hg_bulk_op_pool =
         hg_core_context_get_bulk_op_pool(core_context);
+    void *origin_ptr = NULL, *local_ptr = NULL;
+    na_atomic_op_t na_op;
     hg_return_t ret = HG_SUCCESS;
 
+    switch (op) {
+        case HG_BULK_ATOMIC_FETCH_ADD:
+            na_op = NA_ATOMIC_FETCH_ADD;
+            break;
+        case HG_BULK_ATOMIC_COMPARE_SWAP:
+            na_op = NA_ATOMIC_COMPARE_SWAP;
+            break;
+        case HG_BULK_ATOMIC_SWAP:
+            na_op = NA_ATOMIC_SWAP;
+            break;
+        default:
+            HG_GOTO_ERROR(
+                error, ret, HG_INVALID_ARG, "Unknown atomic operation");
+    }
+
+    /* Regions of views start within their first segment */
+    origin_offset += hg_bulk_origin->desc.info.offset;
+    local_offset += hg_bulk_local->desc.info.offset;
+
     /* Get a new OP ID from context */
     if (hg_bulk_op_pool) {
         ret = hg_bulk_op_pool_get(hg_bulk_op_pool, &hg_bulk_op_id);
@@ -1921,70 +4389,120 @@ hg_bulk_transfer(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
     hg_bulk_op_id->callback = callback;
     hg_bulk_op_id->callback_info.arg = arg;
     hg_bulk_op_id->callback_info.info.bulk.origin_handle = hg_bulk_origin;
-    hg_atomic_incr32(&hg_bulk_origin->ref_count);
+    hg_atomic_incr32_relaxed(&hg_bulk_origin->ref_count);
     hg_bulk_op_id->callback_info.info.bulk.local_handle = hg_bulk_local;
-    hg_atomic_incr32(&hg_bulk_local->ref_count);
-    hg_bulk_op_id->callback_info.info.bulk.op = op;
+    hg_atomic_incr32_relaxed(&hg_bulk_local->ref_count);
+    hg_bulk_op_id->callback_info.info.bulk.op = HG_BULK_PULL;
+    hg_bulk_op_id->progress_cb = NULL;
+    hg_bulk_op_id->progress_arg = NULL;
+    hg_bulk_op_id->chunk_cb = NULL;
+    hg_bulk_op_id->chunk_arg = NULL;
+    hg_bulk_op_id->size = sizeof(hg_uint64_t);
+    hg_bulk_op_id->na_class = NULL;
+    hg_bulk_op_id->na_context = NULL;
 
     /* Reset status */
     hg_atomic_set32(&hg_bulk_op_id->status, 0);
     hg_bulk_op_id->err_ret = HG_SUCCESS;
-
-    /* Expected op count */
-    hg_bulk_op_id->op_count = (size > 0) ? 1 : 0; /* Default */
+    hg_bulk_op_id->op_count = 1;
+    hg_bulk_op_id->rail_op_count = 0;
     hg_atomic_set32(&hg_bulk_op_id->op_completed_count, 0);
 
-    if (size == 0) {
+    HG_CHECK_ERROR(HG_BULK_IS_DEVICE(hg_bulk_origin) ||
+                       HG_BULK_IS_DEVICE(hg_bulk_local),
+        error, ret, HG_OPNOTSUPPORTED,
+        "Device memory cannot be updated atomically");
+
+    if (HG_Core_addr_is_self(origin_addr)) {
+        hg_atomic_int64_t *value;
+        hg_util_int64_t prev;
+
+        ret = hg_bulk_atomic_locate(
+            hg_bulk_origin, NULL, origin_offset, &origin_ptr, NULL, NULL);
+        HG_CHECK_HG_ERROR(error, ret, "Could not locate origin value");
+        ret = hg_bulk_atomic_locate(
+            hg_bulk_local, NULL, local_offset, &local_ptr, NULL, NULL);
+        HG_CHECK_HG_ERROR(error, ret, "Could not locate local value");
+
+        HG_LOG_DEBUG("Updating value through self");
+
+        value = (hg_atomic_int64_t *) origin_ptr;
+        switch (na_op) {
+            case NA_ATOMIC_FETCH_ADD:
+                prev = hg_atomic_add64(value, (hg_util_int64_t) operand);
+                break;
+            case NA_ATOMIC_COMPARE_SWAP:
+                do {
+                    prev = hg_atomic_get64(value);
+                } while (prev == (hg_util_int64_t) compare &&
+                         !hg_atomic_cas64(
+                             value, prev, (hg_util_int64_t) operand));
+                break;
+            case NA_ATOMIC_SWAP:
+            default:
+                do {
+                    prev = hg_atomic_get64(value);
+                } while (!hg_atomic_cas64(
+                    value, prev, (hg_util_int64_t) operand));
+                break;
+        }
+        memcpy(local_ptr, &prev, sizeof(prev));
+
         /* Complete immediately */
         ret = hg_bulk_complete(hg_bulk_op_id, HG_TRUE);
         HG_CHECK_HG_ERROR(error, ret, "Could not complete bulk operation");
-    } else if (HG_Core_addr_is_self(origin_addr) ||
-               ((origin_flags & HG_BULK_EAGER) && (op != HG_BULK_PUSH))) {
-        hg_bulk_op_id->na_class = NULL;
-        hg_bulk_op_id->na_context = NULL;
-
-        /* When doing eager transfers, use self code path to copy data locally
-         */
-        ret = hg_bulk_transfer_self(op, origin_segments, origin_count,
-            origin_offset, local_segments, local_count, local_offset, size,
-            hg_bulk_op_id);
     } else {
         struct hg_bulk_na_mem_desc *origin_mem_descs, *local_mem_descs;
-        na_mem_handle_t *origin_mem_handles, *local_mem_handles;
-        na_addr_t na_origin_addr = NA_ADDR_NULL;
+        hg_bulk_na_op_id_t *hg_bulk_na_op_ids;
+        na_mem_handle_t origin_mem_handle, local_mem_handle;
+        na_offset_t na_origin_offset, na_local_offset;
+        na_addr_t na_origin_addr;
+        na_return_t na_ret;
 
 #ifdef NA_HAS_SM
         /* Use SM if we can */
         if (hg_bulk_origin->desc.info.flags & HG_BULK_SM) {
-            HG_LOG_DEBUG("Using NA SM class for this transfer");
-
             hg_bulk_op_id->na_class = hg_bulk_origin->na_sm_class;
             hg_bulk_op_id->na_context = HG_Core_context_get_na_sm(core_context);
             na_origin_addr = HG_Core_addr_get_na_sm(origin_addr);
             origin_mem_descs = &hg_bulk_origin->na_sm_mem_descs;
             local_mem_descs = &hg_bulk_local->na_sm_mem_descs;
+            hg_bulk_na_op_ids = &hg_bulk_op_id->na_sm_op_ids;
         } else {
 #endif
-            HG_LOG_DEBUG("Using default NA class for this transfer");
-
             hg_bulk_op_id->na_class = hg_bulk_origin->na_class;
             hg_bulk_op_id->na_context = HG_Core_context_get_na(core_context);
             na_origin_addr = HG_Core_addr_get_na(origin_addr);
             origin_mem_descs = &hg_bulk_origin->na_mem_descs;
             local_mem_descs = &hg_bulk_local->na_mem_descs;
+            hg_bulk_na_op_ids = &hg_bulk_op_id->na_op_ids;
 #ifdef NA_HAS_SM
         }
 #endif
 
-        origin_mem_handles =
-            HG_BULK_MEM_HANDLES(origin_mem_descs, origin_count, origin_flags);
-        local_mem_handles =
-            HG_BULK_MEM_HANDLES(local_mem_descs, local_count, local_flags);
-
-        ret = hg_bulk_transfer_na(op, na_origin_addr, origin_id,
-            origin_segments, origin_count, origin_mem_handles, origin_flags,
-            origin_offset, local_segments, local_count, local_mem_handles,
-            local_flags, local_offset, size, hg_bulk_op_id);
+        ret = hg_bulk_atomic_locate(hg_bulk_origin,
+            HG_BULK_MEM_HANDLES(origin_mem_descs,
+                hg_bulk_origin->desc.info.segment_count,
+                hg_bulk_origin->desc.info.flags),
+            origin_offset, &origin_ptr, &origin_mem_handle, &na_origin_offset);
+        HG_CHECK_HG_ERROR(error, ret, "Could not locate origin value");
+        ret = hg_bulk_atomic_locate(hg_bulk_local,
+            HG_BULK_MEM_HANDLES(local_mem_descs,
+                hg_bulk_local->desc.info.segment_count,
+                hg_bulk_local->desc.info.flags),
+            local_offset, &local_ptr, &local_mem_handle, &na_local_offset);
+        HG_CHECK_HG_ERROR(error, ret, "Could not locate local value");
+
+        HG_LOG_DEBUG("Updating value through NA");
+
+        na_ret = NA_Atomic(hg_bulk_op_id->na_class, hg_bulk_op_id->na_context,
+            hg_bulk_transfer_cb, hg_bulk_op_id, na_op, operand, compare,
+            local_mem_handle, na_local_offset, origin_mem_handle,
+            na_origin_offset, na_origin_addr, origin_id,
+            hg_bulk_na_op_ids->s[0]);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "Could not post atomic operation (%s)",
+            NA_Error_to_string(na_ret));
     }
 
     /* Assign op_id */
@@ -2011,20 +4529,38 @@ hg_bulk_transfer_self(hg_bulk_op_t op,
 {
     hg_uint32_t origin_segment_start_index = 0, local_segment_start_index = 0;
     hg_size_t origin_segment_start_offset = 0, local_segment_start_offset = 0;
+    hg_uint8_t origin_flags =
+        hg_bulk_op_id->callback_info.info.bulk.origin_handle->desc.info.flags;
+    hg_bool_t nt = (size >= HG_BULK_SELF_NT_SIZE);
     hg_bulk_copy_op_t copy_op;
+    hg_thread_pool_t *pool;
+    hg_uint32_t thread_count;
+    hg_size_t offload_size;
     hg_return_t ret = HG_SUCCESS;
 
     switch (op) {
         case HG_BULK_PUSH:
-            copy_op = hg_bulk_memcpy_put;
+            copy_op = (nt) ? hg_bulk_memcpy_put_nt : hg_bulk_memcpy_put;
             break;
         case HG_BULK_PULL:
-            copy_op = hg_bulk_memcpy_get;
+            copy_op = (nt) ? hg_bulk_memcpy_get_nt : hg_bulk_memcpy_get;
             break;
         default:
             HG_GOTO_ERROR(done, ret, HG_INVALID_ARG, "Unknown bulk operation");
     }
 
+    /* Large copies complete asynchronously, eager transfers are completed
+     * right away to avoid deadlocks */
+    pool = hg_core_class_get_bulk_self_pool(
+        hg_bulk_op_id->core_context->core_class, &thread_count, &offload_size);
+    if (pool && size >= offload_size && !(origin_flags & HG_BULK_EAGER)) {
+        ret = hg_bulk_transfer_self_offload(pool, thread_count, copy_op,
+            origin_segments, origin_count, origin_offset, local_segments,
+            local_count, local_offset, size, hg_bulk_op_id);
+        HG_CHECK_HG_ERROR(done, ret, "Could not offload self transfer");
+        goto done;
+    }
+
     HG_LOG_DEBUG("Transferring data through self");
 
     /* Translate origin offset */
@@ -2051,6 +4587,64 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_self_strided(hg_bulk_op_t op, struct hg_bulk *hg_bulk_origin,
+    hg_size_t origin_offset, struct hg_bulk *hg_bulk_local,
+    hg_size_t local_offset, hg_size_t size, struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    struct hg_bulk_cursor origin, local;
+    hg_bulk_copy_op_t copy_op;
+    hg_size_t remaining_size = size;
+    hg_return_t ret = HG_SUCCESS;
+
+    switch (op) {
+        case HG_BULK_PUSH:
+            copy_op = hg_bulk_memcpy_put;
+            break;
+        case HG_BULK_PULL:
+            copy_op = hg_bulk_memcpy_get;
+            break;
+        default:
+            HG_GOTO_ERROR(done, ret, HG_INVALID_ARG, "Unknown bulk operation");
+    }
+
+    HG_LOG_DEBUG("Transferring strided data through self");
+
+    hg_bulk_cursor_init(&origin, HG_BULK_SEGMENTS(hg_bulk_origin),
+        hg_bulk_origin->desc.info.segment_count, NULL, HG_FALSE,
+        HG_BULK_IS_STRIDED(hg_bulk_origin) ? &hg_bulk_origin->strided : NULL,
+        origin_offset, size);
+    hg_bulk_cursor_init(&local, HG_BULK_SEGMENTS(hg_bulk_local),
+        hg_bulk_local->desc.info.segment_count, NULL, HG_FALSE,
+        HG_BULK_IS_STRIDED(hg_bulk_local) ? &hg_bulk_local->strided : NULL,
+        local_offset, size);
+
+    /* Copy blocks one at a time, blocks are expected to be large enough */
+    while (remaining_size > 0) {
+        hg_size_t origin_segment_offset, local_segment_offset;
+        hg_size_t transfer_size =
+            HG_BULK_MIN(hg_bulk_cursor_next(&origin, &origin_segment_offset),
+                hg_bulk_cursor_next(&local, &local_segment_offset));
+
+        transfer_size = HG_BULK_MIN(remaining_size, transfer_size);
+        copy_op(local.segments[local.index].base, local_segment_offset,
+            origin.segments[origin.index].base, origin_segment_offset,
+            transfer_size);
+
+        origin.offset += transfer_size;
+        local.offset += transfer_size;
+        remaining_size -= transfer_size;
+    }
+
+    /* Complete immediately */
+    ret = hg_bulk_complete(hg_bulk_op_id, HG_TRUE);
+    HG_CHECK_HG_ERROR(done, ret, "Could not complete bulk operation");
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 hg_bulk_transfer_segments_self(hg_bulk_copy_op_t copy_op,
@@ -2104,20 +4698,195 @@ hg_bulk_transfer_segments_self(hg_bulk_copy_op_t copy_op,
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_memcpy_nt(void *dest, const void *src, size_t n)
+{
+#ifdef __SSE2__
+    char *dest_ptr = (char *) dest;
+    const char *src_ptr = (const char *) src;
+    size_t head = (16 - ((hg_ptr_t) dest_ptr & 15)) & 15;
+
+    /* Streaming stores require 16-byte aligned destination */
+    head = HG_BULK_MIN(head, n);
+    memcpy(dest_ptr, src_ptr, head);
+    dest_ptr += head;
+    src_ptr += head;
+    n -= head;
+
+    for (; n >= 64; n -= 64, dest_ptr += 64, src_ptr += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i *) src_ptr);
+        __m128i b = _mm_loadu_si128((const __m128i *) (src_ptr + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *) (src_ptr + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *) (src_ptr + 48));
+
+        _mm_stream_si128((__m128i *) dest_ptr, a);
+        _mm_stream_si128((__m128i *) (dest_ptr + 16), b);
+        _mm_stream_si128((__m128i *) (dest_ptr + 32), c);
+        _mm_stream_si128((__m128i *) (dest_ptr + 48), d);
+    }
+    /* Make streaming stores visible before completion is reported */
+    _mm_sfence();
+
+    memcpy(dest_ptr, src_ptr, n);
+#else
+    memcpy(dest, src, n);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_memcpy_put_nt(hg_ptr_t local_address, hg_size_t local_offset,
+    hg_ptr_t remote_address, hg_size_t remote_offset, hg_size_t data_size)
+{
+    hg_bulk_memcpy_nt((void *) (remote_address + remote_offset),
+        (const void *) (local_address + local_offset), data_size);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_memcpy_get_nt(hg_ptr_t local_address, hg_size_t local_offset,
+    hg_ptr_t remote_address, hg_size_t remote_offset, hg_size_t data_size)
+{
+    hg_bulk_memcpy_nt((void *) (local_address + local_offset),
+        (const void *) (remote_address + remote_offset), data_size);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_self_offload(hg_thread_pool_t *pool,
+    hg_uint32_t thread_count, hg_bulk_copy_op_t copy_op,
+    const struct hg_bulk_segment *origin_segments, hg_uint32_t origin_count,
+    hg_size_t origin_offset, const struct hg_bulk_segment *local_segments,
+    hg_uint32_t local_count, hg_size_t local_offset, hg_size_t size,
+    struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    struct hg_bulk_self_copy *self_copy = NULL;
+    hg_size_t piece_size;
+    hg_uint32_t piece_count, i;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* One piece per thread unless pieces would become too small */
+    piece_count = (hg_uint32_t) HG_BULK_MIN(
+        (hg_size_t) thread_count, size / HG_BULK_SELF_PIECE_MIN);
+    if (piece_count == 0)
+        piece_count = 1;
+    piece_size = (size + piece_count - 1) / piece_count;
+
+    HG_LOG_DEBUG("Transferring data through self in %u piece(s)", piece_count);
+
+    self_copy = (struct hg_bulk_self_copy *) malloc(
+        sizeof(*self_copy) + piece_count * sizeof(self_copy->pieces[0]));
+    HG_CHECK_ERROR(self_copy == NULL, done, ret, HG_NOMEM,
+        "Could not allocate self copy");
+    self_copy->hg_bulk_op_id = hg_bulk_op_id;
+    self_copy->origin_segments = origin_segments;
+    self_copy->local_segments = local_segments;
+    self_copy->copy_op = copy_op;
+    self_copy->origin_offset = origin_offset;
+    self_copy->local_offset = local_offset;
+    self_copy->origin_count = origin_count;
+    self_copy->local_count = local_count;
+
+    /* Completion happens once all pieces are copied */
+    hg_bulk_op_id->op_count = piece_count;
+
+    for (i = 0; i < piece_count; i++) {
+        struct hg_bulk_self_piece *piece = &self_copy->pieces[i];
+
+        piece->thread_work.func = hg_bulk_self_piece_copy;
+        piece->thread_work.args = piece;
+        piece->self_copy = self_copy;
+        piece->offset = i * piece_size;
+        piece->size = HG_BULK_MIN(piece_size, size - piece->offset);
+    }
+
+    /* The last piece that completes frees self_copy, do not touch it once
+     * all pieces are posted */
+    for (i = 0; i < piece_count; i++) {
+        struct hg_bulk_self_piece *piece = &self_copy->pieces[i];
+        int rc = hg_thread_pool_post(pool, &piece->thread_work);
+
+        /* Copy in place if piece cannot be posted */
+        if (rc != HG_UTIL_SUCCESS)
+            hg_bulk_self_piece_copy(piece);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_bulk_self_piece_copy(void *arg)
+{
+    struct hg_bulk_self_piece *piece = (struct hg_bulk_self_piece *) arg;
+    struct hg_bulk_self_copy *self_copy = piece->self_copy;
+    struct hg_bulk_op_id *hg_bulk_op_id = self_copy->hg_bulk_op_id;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+
+    /* Copies cannot be interrupted but canceled transfers skip pieces that
+     * have not started yet */
+    if (!(hg_atomic_get32(&hg_bulk_op_id->status) & HG_BULK_OP_CANCELED)) {
+        hg_uint32_t origin_segment_start_index, local_segment_start_index;
+        hg_size_t origin_segment_start_offset, local_segment_start_offset;
+
+        hg_bulk_offset_translate(self_copy->origin_segments,
+            self_copy->origin_count, self_copy->origin_offset + piece->offset,
+            &origin_segment_start_index, &origin_segment_start_offset);
+        hg_bulk_offset_translate(self_copy->local_segments,
+            self_copy->local_count, self_copy->local_offset + piece->offset,
+            &local_segment_start_index, &local_segment_start_offset);
+
+        hg_bulk_transfer_segments_self(self_copy->copy_op,
+            self_copy->origin_segments, self_copy->origin_count,
+            origin_segment_start_index, origin_segment_start_offset,
+            self_copy->local_segments, self_copy->local_count,
+            local_segment_start_index, local_segment_start_offset,
+            piece->size);
+    }
+
+    if ((hg_uint32_t) hg_atomic_incr32(&hg_bulk_op_id->op_completed_count) ==
+        hg_bulk_op_id->op_count) {
+        hg_return_t ret;
+
+        free(self_copy);
+
+        /* Completion is not made from progress, notify context */
+        ret = hg_bulk_complete(hg_bulk_op_id, HG_TRUE);
+        HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+    }
+
+    return tret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t na_origin_addr,
     hg_uint8_t origin_id, const struct hg_bulk_segment *origin_segments,
     hg_uint32_t origin_count, na_mem_handle_t *origin_mem_handles,
     hg_uint8_t origin_flags, hg_size_t origin_offset,
+    const struct hg_bulk_strided *origin_strided,
     const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
     na_mem_handle_t *local_mem_handles, hg_uint8_t local_flags,
-    hg_size_t local_offset, hg_size_t size, struct hg_bulk_op_id *hg_bulk_op_id)
+    hg_size_t local_offset, const struct hg_bulk_strided *local_strided,
+    hg_size_t size, struct hg_bulk_op_id *hg_bulk_op_id)
 {
     hg_bulk_na_op_id_t *hg_bulk_na_op_ids;
     na_bulk_op_t na_bulk_op;
+    hg_bool_t origin_contig =
+        !origin_strided && ((origin_flags & HG_BULK_REGV) || origin_count == 1);
+    hg_bool_t local_contig =
+        !local_strided && ((local_flags & HG_BULK_REGV) || local_count == 1);
+    hg_size_t chunk_size;
+    hg_uint32_t max_inflight;
     hg_return_t ret = HG_SUCCESS;
 
+    hg_core_class_get_bulk_pipeline(
+        hg_bulk_op_id->core_context->core_class, &chunk_size, &max_inflight);
+    HG_PROBE3(mercury, bulk_transfer, hg_bulk_op_id, op, size);
+    hg_bulk_hook(hg_bulk_op_id, HG_HOOK_BULK_START, op, size, HG_SUCCESS);
+
     /* Map op to NA op */
     switch (op) {
         case HG_BULK_PUSH:
@@ -2138,8 +4907,8 @@ hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t na_origin_addr,
 #endif
         hg_bulk_na_op_ids = &hg_bulk_op_id->na_op_ids;
 
-    if (((origin_flags & HG_BULK_REGV) || origin_count == 1) &&
-        ((local_flags & HG_BULK_REGV) || local_count == 1)) {
+    if (origin_contig && local_contig &&
+        (chunk_size == 0 || size <= chunk_size)) {
         na_return_t na_ret;
 
         HG_LOG_DEBUG("Transferring data through NA in single operation");
@@ -2150,6 +4919,23 @@ hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t na_origin_addr,
             na_origin_addr, origin_id, hg_bulk_na_op_ids->s[0]);
         HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
             "Could not transfer data (%s)", NA_Error_to_string(na_ret));
+    } else if (chunk_size > 0 || max_inflight > 0 || hg_bulk_op_id->chunk_cb ||
+               origin_strided || local_strided) {
+        struct hg_bulk_cursor origin, local;
+
+        /* Stream operations through a window of op IDs, slots also keep
+         * track of chunk offsets for chunk_cb. Strided regions are always
+         * translated into operations as the transfer progresses. */
+        hg_bulk_cursor_init(&origin, origin_segments, origin_count,
+            origin_mem_handles, origin_contig, origin_strided, origin_offset,
+            size);
+        hg_bulk_cursor_init(&local, local_segments, local_count,
+            local_mem_handles, local_contig, local_strided, local_offset, size);
+
+        ret = hg_bulk_transfer_pipeline(na_bulk_op, na_origin_addr, origin_id,
+            &origin, &local, size, chunk_size, max_inflight, hg_bulk_na_op_ids,
+            hg_bulk_op_id);
+        HG_CHECK_HG_ERROR(done, ret, "Could not start pipelined transfer");
     } else {
         hg_uint32_t origin_segment_start_index = 0,
                     local_segment_start_index = 0;
@@ -2172,7 +4958,7 @@ hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t na_origin_addr,
         hg_bulk_op_id->op_count = hg_bulk_transfer_get_op_count(origin_segments,
             origin_count, origin_segment_start_index,
             origin_segment_start_offset, local_segments, local_count,
-            local_segment_start_index, local_segment_start_offset, size);
+            local_segment_start_index, local_segment_start_offset, size, 0);
         HG_CHECK_ERROR(hg_bulk_op_id->op_count == 0, done, ret, HG_INVALID_ARG,
             "Could not get bulk op_count");
 
@@ -2181,24 +4967,9 @@ hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t na_origin_addr,
 
         /* Create extra operation IDs if the number of operations exceeds
          * the number of pre-allocated op IDs */
-        if (hg_bulk_op_id->op_count > HG_BULK_STATIC_MAX) {
-            unsigned int i;
-
-            /* Allocate memory for NA operation IDs */
-            hg_bulk_na_op_ids->d =
-                malloc(sizeof(na_op_id_t *) * hg_bulk_op_id->op_count);
-            HG_CHECK_ERROR(hg_bulk_na_op_ids->d == NULL, done, ret, HG_NOMEM,
-                "Could not allocate memory for op_ids");
-
-            for (i = 0; i < hg_bulk_op_id->op_count; i++) {
-                hg_bulk_na_op_ids->d[i] = NA_Op_create(hg_bulk_op_id->na_class);
-                HG_CHECK_ERROR(hg_bulk_na_op_ids->d[i] == NULL, done, ret,
-                    HG_NA_ERROR, "Could not create NA op ID");
-            }
-
-            na_op_ids = hg_bulk_na_op_ids->d;
-        } else
-            na_op_ids = hg_bulk_na_op_ids->s;
+        ret = hg_bulk_na_op_ids_get(hg_bulk_op_id, hg_bulk_na_op_ids,
+            hg_bulk_op_id->op_count, &na_op_ids);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get NA op IDs");
 
         /* Do actual transfer */
         ret = hg_bulk_transfer_segments_na(hg_bulk_op_id->na_class,
@@ -2216,6 +4987,393 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_pipeline(na_bulk_op_t na_bulk_op, na_addr_t na_origin_addr,
+    hg_uint8_t origin_id, const struct hg_bulk_cursor *origin,
+    const struct hg_bulk_cursor *local, hg_size_t size, hg_size_t chunk_size,
+    hg_uint32_t max_inflight, hg_bulk_na_op_id_t *hg_bulk_na_op_ids,
+    struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    struct hg_bulk_pipeline *pipeline = NULL;
+    na_op_id_t **na_op_ids = NULL;
+    hg_uint32_t op_count, slot_count, i;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Number of slots is bounded by the number of operations */
+    if (origin->strided || local->strided) {
+        const struct hg_bulk_cursor *cursors[2] = {origin, local};
+        hg_size_t blocks = UINT32_MAX;
+
+        /* Bound by the number of blocks spanned on strided sides */
+        for (i = 0; i < 2; i++) {
+            const struct hg_bulk_strided *strided = cursors[i]->strided;
+            if (strided) {
+                hg_size_t first = cursors[i]->offset / strided->block_len,
+                          last = (cursors[i]->offset + size - 1) /
+                                 strided->block_len;
+                blocks = HG_BULK_MIN(blocks, last - first + 1);
+            }
+        }
+        op_count = (hg_uint32_t) blocks;
+    } else
+        op_count = hg_bulk_transfer_get_op_count(origin->segments,
+            origin->count, origin->index, origin->offset, local->segments,
+            local->count, local->index, local->offset, size, chunk_size);
+    HG_CHECK_ERROR(op_count == 0, error, ret, HG_INVALID_ARG,
+        "Could not get bulk op_count");
+    slot_count = (max_inflight > 0) ? max_inflight
+                                    : HG_BULK_PIPELINE_WINDOW_DEFAULT;
+    slot_count = HG_BULK_MIN(slot_count, op_count);
+
+    HG_LOG_DEBUG("Transferring data through NA in %u operation(s), %u in "
+                 "flight",
+        op_count, slot_count);
+
+    /* Slots re-use the op IDs of the bulk op ID */
+    hg_bulk_op_id->op_count = slot_count;
+    ret = hg_bulk_na_op_ids_get(
+        hg_bulk_op_id, hg_bulk_na_op_ids, slot_count, &na_op_ids);
+    HG_CHECK_HG_ERROR(error, ret, "Could not get NA op IDs");
+
+    pipeline = (struct hg_bulk_pipeline *) malloc(
+        sizeof(*pipeline) + slot_count * sizeof(pipeline->slots[0]));
+    HG_CHECK_ERROR(pipeline == NULL, error, ret, HG_NOMEM,
+        "Could not allocate bulk pipeline");
+    hg_thread_mutex_init(&pipeline->mutex);
+    pipeline->origin = *origin;
+    pipeline->local = *local;
+    /* Contiguous cursors point to their own segment */
+    if (origin->segments == &origin->segment)
+        pipeline->origin.segments = &pipeline->origin.segment;
+    if (local->segments == &local->segment)
+        pipeline->local.segments = &pipeline->local.segment;
+    pipeline->na_bulk_op = na_bulk_op;
+    pipeline->na_origin_addr = na_origin_addr;
+    pipeline->chunk_size = chunk_size;
+    pipeline->remaining = size;
+    pipeline->transferred = 0;
+    pipeline->inflight = 0;
+    pipeline->slot_count = slot_count;
+    pipeline->origin_id = origin_id;
+    for (i = 0; i < slot_count; i++) {
+        pipeline->slots[i].hg_bulk_op_id = hg_bulk_op_id;
+        pipeline->slots[i].na_op_id = na_op_ids[i];
+        pipeline->slots[i].offset = 0;
+        pipeline->slots[i].size = 0;
+    }
+    hg_bulk_op_id->pipeline = pipeline;
+
+    /* Fill window, completions that occur meanwhile wait on the mutex */
+    hg_thread_mutex_lock(&pipeline->mutex);
+    (void) NA_Op_batch_begin(
+        hg_bulk_op_id->na_class, hg_bulk_op_id->na_context);
+    for (i = 0; i < slot_count && pipeline->remaining > 0; i++) {
+        na_return_t na_ret = hg_bulk_pipeline_post(
+            hg_bulk_op_id, &pipeline->slots[i]);
+        if (na_ret != NA_SUCCESS) {
+            HG_LOG_ERROR(
+                "Could not transfer data (%s)", NA_Error_to_string(na_ret));
+            ret = (hg_return_t) na_ret;
+            break;
+        }
+    }
+    (void) NA_Op_batch_end(hg_bulk_op_id->na_class, hg_bulk_op_id->na_context);
+    if (ret != HG_SUCCESS && pipeline->inflight > 0) {
+        /* Report error once operations in flight have completed */
+        hg_atomic_or32(&hg_bulk_op_id->status, HG_BULK_OP_ERRORED);
+        hg_bulk_op_id->err_ret = ret;
+        ret = HG_SUCCESS;
+    }
+    hg_thread_mutex_unlock(&pipeline->mutex);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_rails(hg_bulk_op_t op, na_addr_t na_origin_addr,
+    hg_uint8_t origin_id, struct hg_bulk *hg_bulk_origin,
+    hg_size_t origin_offset, struct hg_bulk *hg_bulk_local,
+    hg_size_t local_offset, hg_size_t size, hg_uint32_t stripe_count,
+    struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    hg_core_context_t *core_context = hg_bulk_op_id->core_context;
+    hg_size_t stripe_size = size / stripe_count, offset = 0;
+    na_mem_handle_t local_mem_handle, origin_mem_handle;
+    hg_uint32_t local_index = 0, origin_index = 0;
+    na_bulk_op_t na_bulk_op =
+        (op == HG_BULK_PUSH) ? hg_bulk_na_put : hg_bulk_na_get;
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint32_t i;
+
+    HG_PROBE3(mercury, bulk_transfer, hg_bulk_op_id, op, size);
+    hg_bulk_hook(hg_bulk_op_id, HG_HOOK_BULK_START, op, size, HG_SUCCESS);
+    HG_LOG_DEBUG("Striping transfer of %zu bytes across %u rail(s)",
+        (size_t) size, stripe_count);
+
+    /* Both handles have a single non-empty segment, get its NA handle */
+    (void) hg_bulk_get_contig_segment(hg_bulk_local, &local_index);
+    (void) hg_bulk_get_contig_segment(hg_bulk_origin, &origin_index);
+    local_mem_handle =
+        hg_bulk_local->na_mem_descs.handles
+            .s[(hg_bulk_local->desc.info.flags & HG_BULK_REGV) ? 0
+                                                               : local_index];
+    origin_mem_handle =
+        hg_bulk_origin->na_mem_descs.handles
+            .s[(hg_bulk_origin->desc.info.flags & HG_BULK_REGV) ? 0
+                                                                : origin_index];
+
+    /* First stripe goes through default NA class, others through rails */
+    hg_bulk_op_id->op_count = stripe_count;
+    hg_bulk_op_id->rail_op_count = stripe_count - 1;
+
+    for (i = 0; i < stripe_count; i++) {
+        hg_size_t len = (i == stripe_count - 1) ? size - offset : stripe_size;
+        na_return_t na_ret;
+
+        if (i == 0)
+            na_ret = na_bulk_op(hg_bulk_op_id->na_class,
+                hg_bulk_op_id->na_context, hg_bulk_transfer_cb, hg_bulk_op_id,
+                local_mem_handle, local_offset, origin_mem_handle,
+                origin_offset, len,
+                na_origin_addr, origin_id, hg_bulk_op_id->na_op_ids.s[0]);
+        else {
+            hg_uint32_t rail = i - 1;
+            na_class_t *na_rail_class =
+                HG_Core_class_get_na_rail(core_context->core_class, rail);
+
+            /* Rail op IDs are created on first use and kept with op ID */
+            if (hg_bulk_op_id->na_rail_op_ids[rail] == NULL) {
+                hg_bulk_op_id->na_rail_op_ids[rail] =
+                    NA_Op_create(na_rail_class);
+                HG_CHECK_ERROR(hg_bulk_op_id->na_rail_op_ids[rail] == NULL,
+                    error, ret, HG_NA_ERROR, "Could not create NA op ID");
+            }
+
+            na_ret = na_bulk_op(na_rail_class,
+                HG_Core_context_get_na_rail(core_context, rail),
+                hg_bulk_transfer_cb, hg_bulk_op_id,
+                hg_bulk_local->rails[rail].na_mem_handle, local_offset + offset,
+                hg_bulk_origin->rails[rail].na_mem_handle,
+                origin_offset + offset, len,
+                hg_bulk_origin->rails[rail].na_addr, origin_id,
+                hg_bulk_op_id->na_rail_op_ids[rail]);
+        }
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "Could not transfer data (%s)", NA_Error_to_string(na_ret));
+
+        offset += len;
+    }
+
+    return ret;
+
+error:
+    if (i == 0)
+        return ret;
+
+    /* Report error once stripes in flight have completed, stripes that
+     * were not posted complete right away */
+    hg_atomic_or32(&hg_bulk_op_id->status, HG_BULK_OP_ERRORED);
+    hg_bulk_op_id->err_ret = ret;
+    for (; i < stripe_count; i++) {
+        if ((hg_uint32_t) hg_atomic_incr32(
+                &hg_bulk_op_id->op_completed_count) == stripe_count) {
+            ret = hg_bulk_complete(hg_bulk_op_id, HG_TRUE);
+            HG_CHECK_ERROR_DONE(
+                ret != HG_SUCCESS, "Could not complete operation");
+        }
+    }
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_cursor_init(struct hg_bulk_cursor *cursor,
+    const struct hg_bulk_segment *segments, hg_uint32_t count,
+    na_mem_handle_t *mem_handles, hg_bool_t contig,
+    const struct hg_bulk_strided *strided, hg_size_t offset, hg_size_t size)
+{
+    cursor->mem_handles = mem_handles;
+    cursor->index = 0;
+    cursor->strided = strided;
+
+    if (strided) {
+        /* Region is a single segment */
+        cursor->segments = segments;
+        cursor->count = 1;
+        cursor->offset = offset;
+        contig = HG_TRUE;
+    } else if (contig) {
+        /* Single handle, offsets are relative to the start of the handle */
+        cursor->segment.base = segments[0].base;
+        cursor->segment.len = offset + size;
+        cursor->segments = &cursor->segment;
+        cursor->count = 1;
+        cursor->offset = offset;
+    } else {
+        cursor->segments = segments;
+        cursor->count = count;
+        cursor->offset = 0;
+        if (offset > 0)
+            hg_bulk_offset_translate(
+                segments, count, offset, &cursor->index, &cursor->offset);
+    }
+    cursor->handle_offset = (contig || mem_handles == NULL)
+                                ? 0
+                                : hg_bulk_mem_handle_offset(
+                                      segments, mem_handles, cursor->index);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_size_t
+hg_bulk_cursor_next(struct hg_bulk_cursor *cursor, hg_size_t *segment_offset)
+{
+    const struct hg_bulk_strided *strided = cursor->strided;
+
+    if (strided) {
+        *segment_offset = hg_bulk_strided_translate(strided, cursor->offset);
+
+        return strided->block_len - cursor->offset % strided->block_len;
+    }
+
+    /* Move to next non-empty segment */
+    while (cursor->offset >= cursor->segments[cursor->index].len) {
+        cursor->index++;
+        cursor->offset = 0;
+        if (cursor->mem_handles)
+            cursor->handle_offset =
+                HG_BULK_MEM_HANDLE_OFFSET_NEXT(cursor->segments,
+                    cursor->mem_handles, cursor->index, cursor->handle_offset);
+    }
+    *segment_offset = cursor->offset;
+
+    return cursor->segments[cursor->index].len - cursor->offset;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_size_t
+hg_bulk_strided_translate(
+    const struct hg_bulk_strided *strided, hg_size_t offset)
+{
+    hg_size_t block = offset / strided->block_len;
+    hg_size_t ret = offset % strided->block_len;
+    unsigned int i;
+
+    /* Unused levels have a count of 1 and do not contribute */
+    for (i = 0; i < HG_BULK_STRIDE_MAX; i++) {
+        ret += (block % strided->dims[i].count) * strided->dims[i].stride;
+        block /= strided->dims[i].count;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+hg_bulk_pipeline_post(
+    struct hg_bulk_op_id *hg_bulk_op_id, struct hg_bulk_pipeline_slot *slot)
+{
+    struct hg_bulk_pipeline *pipeline = hg_bulk_op_id->pipeline;
+    struct hg_bulk_cursor *origin = &pipeline->origin;
+    struct hg_bulk_cursor *local = &pipeline->local;
+    hg_size_t origin_offset, local_offset, transfer_size;
+    na_return_t ret;
+
+    /* Can only transfer smallest size */
+    transfer_size = HG_BULK_MIN(hg_bulk_cursor_next(origin, &origin_offset),
+        hg_bulk_cursor_next(local, &local_offset));
+    transfer_size = HG_BULK_MIN(pipeline->remaining, transfer_size);
+    if (pipeline->chunk_size > 0)
+        transfer_size = HG_BULK_MIN(pipeline->chunk_size, transfer_size);
+
+    /* Completion may be processed by another thread before the operation
+     * returns, describe the chunk first */
+    slot->offset = hg_bulk_op_id->size - pipeline->remaining;
+    slot->size = transfer_size;
+
+    ret = pipeline->na_bulk_op(hg_bulk_op_id->na_class,
+        hg_bulk_op_id->na_context, hg_bulk_transfer_pipeline_cb, slot,
+        local->mem_handles[local->index], local->handle_offset + local_offset,
+        origin->mem_handles[origin->index],
+        origin->handle_offset + origin_offset, transfer_size,
+        pipeline->na_origin_addr, pipeline->origin_id, slot->na_op_id);
+    if (ret != NA_SUCCESS)
+        return ret;
+
+    pipeline->inflight++;
+    pipeline->remaining -= transfer_size;
+    origin->offset += transfer_size;
+    local->offset += transfer_size;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_na_op_ids_get(struct hg_bulk_op_id *hg_bulk_op_id,
+    hg_bulk_na_op_id_t *hg_bulk_na_op_ids, hg_uint32_t count,
+    na_op_id_t ***na_op_ids_ptr)
+{
+    na_op_id_t **na_op_ids;
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint32_t i;
+
+    if (count <= HG_BULK_STATIC_MAX) {
+        *na_op_ids_ptr = hg_bulk_na_op_ids->s;
+        goto done;
+    }
+
+    /* Op IDs from previous transfers are re-used if there are enough */
+    if (count <= hg_bulk_na_op_ids->d_count) {
+        *na_op_ids_ptr = hg_bulk_na_op_ids->d;
+        goto done;
+    }
+
+    /* Allocate memory for NA operation IDs, released in op_destroy() */
+    hg_core_context_alloc_fallback(hg_bulk_op_id->core_context, "NA op IDs");
+    na_op_ids = (na_op_id_t **) realloc(
+        hg_bulk_na_op_ids->d, count * sizeof(na_op_id_t *));
+    HG_CHECK_ERROR(na_op_ids == NULL, done, ret, HG_NOMEM,
+        "Could not allocate memory for op_ids");
+    hg_bulk_na_op_ids->d = na_op_ids;
+
+    for (i = hg_bulk_na_op_ids->d_count; i < count; i++) {
+        na_op_ids[i] = NA_Op_create(hg_bulk_op_id->na_class);
+        HG_CHECK_ERROR(na_op_ids[i] == NULL, done, ret, HG_NA_ERROR,
+            "Could not create NA op ID");
+        hg_bulk_na_op_ids->d_count = i + 1;
+    }
+
+    *na_op_ids_ptr = na_op_ids;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_na_op_ids_free(
+    na_class_t *na_class, hg_bulk_na_op_id_t *hg_bulk_na_op_ids)
+{
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint32_t i;
+
+    for (i = 0; i < hg_bulk_na_op_ids->d_count; i++) {
+        na_return_t na_ret = NA_Op_destroy(na_class, hg_bulk_na_op_ids->d[i]);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "NA_Op_destroy() failed (%s)", NA_Error_to_string(na_ret));
+    }
+    free(hg_bulk_na_op_ids->d);
+    hg_bulk_na_op_ids->d = NULL;
+    hg_bulk_na_op_ids->d_count = 0;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_uint32_t
 hg_bulk_transfer_get_op_count(const struct hg_bulk_segment *origin_segments,
@@ -2223,7 +5381,7 @@ hg_bulk_transfer_get_op_count(const struct hg_bulk_segment *origin_segments,
     hg_size_t origin_segment_start_offset,
     const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
     hg_size_t local_segment_start_index, hg_size_t local_segment_start_offset,
-    hg_size_t size)
+    hg_size_t size, hg_size_t chunk_size)
 {
     hg_size_t origin_segment_index = origin_segment_start_index;
     hg_size_t local_segment_index = local_segment_start_index;
@@ -2243,7 +5401,11 @@ hg_bulk_transfer_get_op_count(const struct hg_bulk_segment *origin_segments,
         transfer_size = HG_BULK_MIN(remaining_size, transfer_size);
 
         /* Increment op count */
-        count++;
+        if (chunk_size > 0 && transfer_size > chunk_size)
+            count += (hg_uint32_t)(
+                (transfer_size + chunk_size - 1) / chunk_size);
+        else
+            count++;
 
         /* Decrease remaining size from the size of data we transferred
          * and exit if everything has been transferred */
@@ -2286,10 +5448,18 @@ hg_bulk_transfer_segments_na(na_class_t *na_class, na_context_t *na_context,
     hg_size_t local_segment_index = local_segment_start_index;
     hg_size_t origin_segment_offset = origin_segment_start_offset;
     hg_size_t local_segment_offset = local_segment_start_offset;
+    hg_size_t origin_handle_offset = hg_bulk_mem_handle_offset(
+        origin_segments, origin_mem_handles, origin_segment_index);
+    hg_size_t local_handle_offset = hg_bulk_mem_handle_offset(
+        local_segments, local_mem_handles, local_segment_index);
     hg_size_t remaining_size = size;
     hg_uint32_t count = 0;
     hg_return_t ret = HG_SUCCESS;
 
+    /* Let plugin submit all operations at once */
+    if (na_op_count > 1)
+        (void) NA_Op_batch_begin(na_class, na_context);
+
     while (remaining_size > 0 && origin_segment_index < origin_count &&
            local_segment_index < local_count) {
         /* Can only transfer smallest size */
@@ -2302,9 +5472,11 @@ hg_bulk_transfer_segments_na(na_class_t *na_class, na_context_t *na_context,
         transfer_size = HG_BULK_MIN(remaining_size, transfer_size);
 
         na_ret = na_bulk_op(na_class, na_context, callback, arg,
-            local_mem_handles[local_segment_index], local_segment_offset,
-            origin_mem_handles[origin_segment_index], origin_segment_offset,
-            transfer_size, origin_addr, origin_id, na_op_ids[count]);
+            local_mem_handles[local_segment_index],
+            local_handle_offset + local_segment_offset,
+            origin_mem_handles[origin_segment_index],
+            origin_handle_offset + origin_segment_offset, transfer_size,
+            origin_addr, origin_id, na_op_ids[count]);
         HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
             "Could not transfer data (%s)", NA_Error_to_string(na_ret));
 
@@ -2325,10 +5497,15 @@ hg_bulk_transfer_segments_na(na_class_t *na_class, na_context_t *na_context,
             origin_segments[origin_segment_index].len) {
             origin_segment_index++;
             origin_segment_offset = 0;
+            origin_handle_offset = HG_BULK_MEM_HANDLE_OFFSET_NEXT(
+                origin_segments, origin_mem_handles, origin_segment_index,
+                origin_handle_offset);
         }
         if (local_segment_offset >= local_segments[local_segment_index].len) {
             local_segment_index++;
             local_segment_offset = 0;
+            local_handle_offset = HG_BULK_MEM_HANDLE_OFFSET_NEXT(local_segments,
+                local_mem_handles, local_segment_index, local_handle_offset);
         }
     }
 
@@ -2336,6 +5513,13 @@ hg_bulk_transfer_segments_na(na_class_t *na_class, na_context_t *na_context,
         "Expected %u operations, issued %u", na_op_count, count);
 
 done:
+    if (na_op_count > 1) {
+        na_return_t na_ret = NA_Op_batch_end(na_class, na_context);
+        HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
+            "Could not end batch of operations (%s)",
+            NA_Error_to_string(na_ret));
+    }
+
     return ret;
 }
 
@@ -2378,6 +5562,96 @@ hg_bulk_transfer_cb(const struct na_cb_info *callback_info)
     return (int) completed;
 }
 
+/*---------------------------------------------------------------------------*/
+static int
+hg_bulk_transfer_pipeline_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_bulk_pipeline_slot *slot =
+        (struct hg_bulk_pipeline_slot *) callback_info->arg;
+    struct hg_bulk_op_id *hg_bulk_op_id = slot->hg_bulk_op_id;
+    struct hg_bulk_pipeline *pipeline = hg_bulk_op_id->pipeline;
+    hg_bool_t completed = HG_TRUE;
+    hg_bool_t last;
+
+    if (callback_info->ret == NA_CANCELED) {
+        HG_LOG_DEBUG("NA_CANCELED event on op ID %p", hg_bulk_op_id);
+        HG_CHECK_WARNING(
+            !(hg_atomic_get32(&hg_bulk_op_id->status) & HG_BULK_OP_CANCELED),
+            "Received NA_CANCELED event on op ID that was not canceled");
+    } else if (callback_info->ret != NA_SUCCESS) {
+        HG_LOG_ERROR("NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
+
+        /* Mark handle as errored */
+        hg_atomic_or32(&hg_bulk_op_id->status, HG_BULK_OP_ERRORED);
+        if (hg_bulk_op_id->err_ret == HG_SUCCESS)
+            hg_bulk_op_id->err_ret = (hg_return_t) callback_info->ret;
+    }
+
+    /* Slot is not re-posted until inflight is decremented, chunk callbacks
+     * therefore always precede completion */
+    if (callback_info->ret == NA_SUCCESS && hg_bulk_op_id->chunk_cb)
+        hg_bulk_op_id->chunk_cb(
+            hg_bulk_op_id->chunk_arg, slot->offset, slot->size);
+
+    hg_thread_mutex_lock(&pipeline->mutex);
+    pipeline->inflight--;
+
+    if (callback_info->ret == NA_SUCCESS) {
+        pipeline->transferred += slot->size;
+
+        /* Reported under the mutex so that values are increasing */
+        if (hg_bulk_op_id->progress_cb)
+            hg_bulk_op_id->progress_cb(hg_bulk_op_id->progress_arg,
+                pipeline->transferred, hg_bulk_op_id->size);
+    }
+
+    /* Re-use slot for next chunk unless transfer was stopped */
+    if (pipeline->remaining > 0 &&
+        !(hg_atomic_get32(&hg_bulk_op_id->status) &
+            (HG_BULK_OP_CANCELED | HG_BULK_OP_ERRORED))) {
+        na_return_t na_ret = hg_bulk_pipeline_post(hg_bulk_op_id, slot);
+        if (na_ret != NA_SUCCESS) {
+            HG_LOG_ERROR(
+                "Could not transfer data (%s)", NA_Error_to_string(na_ret));
+            hg_atomic_or32(&hg_bulk_op_id->status, HG_BULK_OP_ERRORED);
+            if (hg_bulk_op_id->err_ret == HG_SUCCESS)
+                hg_bulk_op_id->err_ret = (hg_return_t) na_ret;
+        }
+    }
+    last = (pipeline->inflight == 0);
+    hg_thread_mutex_unlock(&pipeline->mutex);
+
+    /* Add HG user callback to completion queue once nothing is in flight */
+    if (last) {
+        hg_return_t ret = hg_bulk_complete(hg_bulk_op_id, HG_FALSE);
+        HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+    }
+
+    return (int) completed;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_bulk_hook(struct hg_bulk_op_id *hg_bulk_op_id, hg_hook_type_t type,
+    hg_bulk_op_t op, hg_size_t size, hg_return_t ret)
+{
+    const struct hg_core_hooks *hooks =
+        hg_core_class_get_hooks(hg_bulk_op_id->core_context->core_class);
+    struct hg_core_hook_info info;
+
+    if (!hooks->callbacks[type])
+        return;
+
+    memset(&info, 0, sizeof(info));
+    info.context = hg_bulk_op_id->core_context;
+    info.op_id = hg_bulk_op_id;
+    info.size = size;
+    info.ret = ret;
+    info.op = (int) op;
+    hooks->callbacks[type](hooks->arg, type, &info);
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_complete(struct hg_bulk_op_id *hg_bulk_op_id, hg_bool_t self_notify)
@@ -2402,9 +5676,23 @@ hg_bulk_complete(struct hg_bulk_op_id *hg_bulk_op_id, hg_bool_t self_notify)
         /* If it was errored, set callback ret accordingly */
         HG_LOG_DEBUG("Operation ID %p is errored", hg_bulk_op_id);
         callback_info->ret = hg_bulk_op_id->err_ret;
-    } else
+    } else {
         callback_info->ret = HG_SUCCESS;
 
+        /* Pipelined transfers report progress as chunks complete */
+        if (hg_bulk_op_id->progress_cb && !hg_bulk_op_id->pipeline)
+            hg_bulk_op_id->progress_cb(hg_bulk_op_id->progress_arg,
+                hg_bulk_op_id->size, hg_bulk_op_id->size);
+        if (hg_bulk_op_id->chunk_cb && !hg_bulk_op_id->pipeline &&
+            hg_bulk_op_id->size > 0)
+            hg_bulk_op_id->chunk_cb(
+                hg_bulk_op_id->chunk_arg, 0, hg_bulk_op_id->size);
+    }
+    HG_PROBE3(mercury, bulk_complete, hg_bulk_op_id, hg_bulk_op_id->size,
+        callback_info->ret);
+    hg_bulk_hook(hg_bulk_op_id, HG_HOOK_BULK_COMPLETE,
+        callback_info->info.bulk.op, hg_bulk_op_id->size, callback_info->ret);
+
     if (callback_info->info.bulk.origin_handle->desc.info.flags &
         HG_BULK_EAGER) {
         /* In the case of eager bulk transfer, directly trigger the operation
@@ -2442,6 +5730,10 @@ hg_bulk_cancel(struct hg_bulk_op_id *hg_bulk_op_id)
     if ((status & HG_BULK_OP_COMPLETED) || (status & HG_BULK_OP_ERRORED))
         goto done;
 
+    /* Offloaded self copies see the canceled status on their own */
+    if (hg_bulk_op_id->na_class == NULL)
+        goto done;
+
         /* Cancel all NA operations issued */
 #ifdef NA_HAS_SM
     if (hg_bulk_op_id->na_class ==
@@ -2451,13 +5743,33 @@ hg_bulk_cancel(struct hg_bulk_op_id *hg_bulk_op_id)
 #endif
         na_op_ids = HG_BULK_NA_OP_IDS(hg_bulk_op_id);
 
-    for (i = 0; i < hg_bulk_op_id->op_count; i++) {
+    /* Prevent slots from being re-posted while canceling */
+    if (hg_bulk_op_id->pipeline)
+        hg_thread_mutex_lock(&hg_bulk_op_id->pipeline->mutex);
+
+    for (i = 0; i < hg_bulk_op_id->op_count - hg_bulk_op_id->rail_op_count;
+         i++) {
         na_return_t na_ret = NA_Cancel(
             hg_bulk_op_id->na_class, hg_bulk_op_id->na_context, na_op_ids[i]);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, unlock, ret, (hg_return_t) na_ret,
             "Could not cancel NA op ID (%s)", NA_Error_to_string(na_ret));
     }
 
+    /* Stripes posted on rails */
+    for (i = 0; i < hg_bulk_op_id->rail_op_count; i++) {
+        hg_core_context_t *core_context = hg_bulk_op_id->core_context;
+        na_return_t na_ret = NA_Cancel(
+            HG_Core_class_get_na_rail(core_context->core_class, i),
+            HG_Core_context_get_na_rail(core_context, i),
+            hg_bulk_op_id->na_rail_op_ids[i]);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, unlock, ret, (hg_return_t) na_ret,
+            "Could not cancel NA rail op ID (%s)", NA_Error_to_string(na_ret));
+    }
+
+unlock:
+    if (hg_bulk_op_id->pipeline)
+        hg_thread_mutex_unlock(&hg_bulk_op_id->pipeline->mutex);
+
 done:
     return ret;
 }
@@ -2479,6 +5791,11 @@ hg_bulk_trigger_entry(struct hg_bulk_op_id *hg_bulk_op_id)
     ret = hg_bulk_free(hg_bulk_op_id->callback_info.info.bulk.local_handle);
     HG_CHECK_HG_ERROR(done, ret, "Could not free local handle");
 
+    if (hg_bulk_op_id->list) {
+        ret = hg_bulk_list_release(hg_bulk_op_id);
+        HG_CHECK_HG_ERROR(done, ret, "Could not release list entries");
+    }
+
     /* Release bulk op ID (can be released after callback execution since
      * op IDs are managed internally) */
     ret = hg_bulk_op_destroy(hg_bulk_op_id);
@@ -2516,15 +5833,162 @@ HG_Bulk_create(hg_class_t *hg_class, hg_uint32_t count, void **buf_ptrs,
     HG_LOG_DEBUG("Creating new bulk handle with %u segment(s)", count);
 
     ret = hg_bulk_create(hg_class->core_class, count, buf_ptrs, buf_sizes,
-        flags, (struct hg_bulk **) handle);
+        flags, NULL, (struct hg_bulk **) handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not create bulk handle");
+
+    HG_LOG_DEBUG("Created new bulk handle (%p)", *handle);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_create_attr(hg_class_t *hg_class, hg_uint32_t count, void **buf_ptrs,
+    const hg_size_t *buf_sizes, hg_uint8_t flags,
+    const struct hg_bulk_attr *attr, hg_bulk_t *handle)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_ERROR(
+        count == 0, done, ret, HG_INVALID_ARG, "Invalid number of segments");
+    HG_CHECK_ERROR(buf_sizes == NULL, done, ret, HG_INVALID_ARG,
+        "NULL segment size pointer");
+
+    switch (flags) {
+        case HG_BULK_READWRITE:
+        case HG_BULK_READ_ONLY:
+        case HG_BULK_WRITE_ONLY:
+            break;
+        default:
+            HG_GOTO_ERROR(
+                done, ret, HG_INVALID_ARG, "Unrecognized handle flag");
+    }
+
+    switch (attr ? attr->mem_type : HG_MEM_TYPE_HOST) {
+        case HG_MEM_TYPE_UNKNOWN:
+        case HG_MEM_TYPE_HOST:
+        case HG_MEM_TYPE_CUDA:
+        case HG_MEM_TYPE_ROCM:
+        case HG_MEM_TYPE_ZE:
+            break;
+        default:
+            HG_GOTO_ERROR(done, ret, HG_INVALID_ARG, "Unrecognized mem type");
+    }
+
+    HG_LOG_DEBUG("Creating new bulk handle with %u segment(s), mem type %d",
+        count, attr ? (int) attr->mem_type : (int) HG_MEM_TYPE_HOST);
+
+    ret = hg_bulk_create(hg_class->core_class, count, buf_ptrs, buf_sizes,
+        flags, attr, (struct hg_bulk **) handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not create bulk handle");
+
+    HG_LOG_DEBUG("Created new bulk handle (%p)", *handle);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_create_strided(hg_class_t *hg_class, void *base, hg_size_t block_len,
+    const struct hg_bulk_stride *strides, hg_uint32_t stride_count,
+    hg_uint8_t flags, hg_bulk_t *handle)
+{
+    struct hg_bulk *hg_bulk = NULL;
+    hg_size_t len = block_len, extent = block_len;
+    hg_uint32_t i;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_ERROR(base == NULL, done, ret, HG_INVALID_ARG, "NULL base");
+    HG_CHECK_ERROR(
+        block_len == 0, done, ret, HG_INVALID_ARG, "Invalid block length");
+    HG_CHECK_ERROR(strides == NULL || stride_count == 0 ||
+                       stride_count > HG_BULK_STRIDE_MAX,
+        done, ret, HG_INVALID_ARG, "Invalid number of stride levels (%u)",
+        stride_count);
+
+    switch (flags) {
+        case HG_BULK_READWRITE:
+        case HG_BULK_READ_ONLY:
+        case HG_BULK_WRITE_ONLY:
+            break;
+        default:
+            HG_GOTO_ERROR(
+                done, ret, HG_INVALID_ARG, "Unrecognized handle flag");
+    }
+
+    /* Each level repeats the extent of the previous levels without overlap,
+     * the region registered is the extent of the outermost level */
+    for (i = 0; i < stride_count; i++) {
+        HG_CHECK_ERROR(strides[i].count == 0, done, ret, HG_INVALID_ARG,
+            "Invalid count for stride level %u", i);
+        HG_CHECK_ERROR(strides[i].count > 1 && strides[i].stride < extent,
+            done, ret, HG_INVALID_ARG,
+            "Stride level %u overlaps (%zu < %zu)", i, strides[i].stride,
+            extent);
+        len *= strides[i].count;
+        extent += (strides[i].count - 1) * strides[i].stride;
+    }
+
+    HG_LOG_DEBUG("Creating new strided bulk handle with %u level(s), block "
+                 "length is %zu, len is %zu bytes",
+        stride_count, block_len, len);
+
+    ret = hg_bulk_create(
+        hg_class->core_class, 1, &base, &extent, flags, NULL, &hg_bulk);
     HG_CHECK_HG_ERROR(done, ret, "Could not create bulk handle");
 
+    hg_bulk->desc.info.len = len;
+    hg_bulk->desc.info.stride_count = (hg_uint8_t) stride_count;
+    hg_bulk->strided.block_len = block_len;
+    for (i = 0; i < HG_BULK_STRIDE_MAX; i++) {
+        hg_bulk->strided.dims[i].count = (i < stride_count) ? strides[i].count
+                                                            : 1;
+        hg_bulk->strided.dims[i].stride =
+            (i < stride_count) ? strides[i].stride : 0;
+    }
+
+    *handle = (hg_bulk_t) hg_bulk;
+
     HG_LOG_DEBUG("Created new bulk handle (%p)", *handle);
 
 done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_create_view(
+    hg_bulk_t handle, hg_size_t offset, hg_size_t size, hg_bulk_t *view)
+{
+    struct hg_bulk *hg_bulk = (struct hg_bulk *) handle;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(hg_bulk == NULL, done, ret, HG_INVALID_ARG,
+        "NULL bulk handle passed");
+    HG_CHECK_ERROR(view == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to view passed");
+    HG_CHECK_ERROR(size == 0, done, ret, HG_INVALID_ARG, "Invalid view size");
+    HG_CHECK_ERROR((offset + size) > hg_bulk->desc.info.len, done, ret,
+        HG_INVALID_ARG,
+        "Exceeding size of memory exposed by handle (%zu + %zu > %zu)", offset,
+        size, hg_bulk->desc.info.len);
+
+    ret = hg_bulk_create_view(hg_bulk, offset, size, (struct hg_bulk **) view);
+    HG_CHECK_HG_ERROR(done, ret, "Could not create view of bulk handle");
+
+    HG_LOG_DEBUG("Created view (%p) of bulk handle (%p) with %u segment(s)",
+        *view, handle, ((struct hg_bulk *) *view)->desc.info.segment_count);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Bulk_free(hg_bulk_t handle)
@@ -2543,6 +6007,103 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+void *
+HG_Mem_alloc(hg_class_t *hg_class, hg_size_t size)
+{
+    struct hg_bulk_mem_pool *hg_bulk_mem_pool;
+    struct hg_bulk_mem_region *hg_bulk_mem_region;
+    void *mem_ptr = NULL;
+    hg_return_t ret;
+    int shift = HG_BULK_MEM_SHIFT_MIN, size_class;
+
+    HG_CHECK_ERROR_NORET(hg_class == NULL, done, "NULL HG class");
+    HG_CHECK_ERROR_NORET(size == 0, done, "NULL size");
+
+    hg_bulk_mem_pool = hg_core_class_get_bulk_mem_pool(hg_class->core_class);
+
+    /* Round up to next size class */
+    while (shift <= HG_BULK_MEM_SHIFT_MAX && ((hg_size_t) 1 << shift) < size)
+        shift++;
+    size_class = shift - HG_BULK_MEM_SHIFT_MIN;
+
+    hg_thread_mutex_lock(&hg_bulk_mem_pool->mutex);
+
+    /* Large allocations get their own region */
+    if (shift > HG_BULK_MEM_SHIFT_MAX) {
+        ret = hg_bulk_mem_region_create(
+            hg_bulk_mem_pool, size, -1, &hg_bulk_mem_region);
+        if (ret == HG_SUCCESS)
+            mem_ptr = hg_bulk_mem_region->base;
+        goto unlock;
+    }
+
+    /* Carve new region into blocks of that class */
+    if (hg_bulk_mem_pool->free_lists[size_class] == NULL) {
+        hg_size_t block_size = (hg_size_t) 1 << shift, offset;
+
+        ret = hg_bulk_mem_region_create(hg_bulk_mem_pool,
+            HG_BULK_MEM_REGION_SIZE, size_class, &hg_bulk_mem_region);
+        if (ret != HG_SUCCESS)
+            goto unlock;
+
+        for (offset = HG_BULK_MEM_REGION_SIZE; offset > 0;) {
+            void **block = (void **) (hg_bulk_mem_region->base +
+                                      (offset -= block_size));
+            *block = hg_bulk_mem_pool->free_lists[size_class];
+            hg_bulk_mem_pool->free_lists[size_class] = block;
+        }
+    }
+
+    /* Blocks are linked through their first word */
+    mem_ptr = hg_bulk_mem_pool->free_lists[size_class];
+    hg_bulk_mem_pool->free_lists[size_class] = *(void **) mem_ptr;
+
+unlock:
+    hg_thread_mutex_unlock(&hg_bulk_mem_pool->mutex);
+
+done:
+    return mem_ptr;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Mem_free(hg_class_t *hg_class, void *mem_ptr)
+{
+    struct hg_bulk_mem_pool *hg_bulk_mem_pool;
+    struct hg_bulk_mem_region *hg_bulk_mem_region;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG class");
+    if (mem_ptr == NULL)
+        goto done;
+
+    hg_bulk_mem_pool = hg_core_class_get_bulk_mem_pool(hg_class->core_class);
+
+    hg_thread_mutex_lock(&hg_bulk_mem_pool->mutex);
+
+    hg_bulk_mem_region =
+        hg_bulk_mem_region_find(hg_bulk_mem_pool, (const char *) mem_ptr, 1);
+    HG_CHECK_ERROR(hg_bulk_mem_region == NULL, unlock, ret, HG_INVALID_ARG,
+        "Memory (%p) was not allocated by HG_Mem_alloc()", mem_ptr);
+
+    if (hg_bulk_mem_region->size_class < 0)
+        hg_bulk_mem_region_destroy(hg_bulk_mem_pool, hg_bulk_mem_region);
+    else {
+        *(void **) mem_ptr =
+            hg_bulk_mem_pool->free_lists[hg_bulk_mem_region->size_class];
+        hg_bulk_mem_pool->free_lists[hg_bulk_mem_region->size_class] =
+            mem_ptr;
+    }
+
+unlock:
+    hg_thread_mutex_unlock(&hg_bulk_mem_pool->mutex);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Bulk_ref_incr(hg_bulk_t handle)
@@ -2553,7 +6114,7 @@ HG_Bulk_ref_incr(hg_bulk_t handle)
         "NULL bulk handle passed");
 
     /* Increment ref count */
-    hg_atomic_incr32(&(((struct hg_bulk *) handle)->ref_count));
+    hg_atomic_incr32_relaxed(&(((struct hg_bulk *) handle)->ref_count));
 
 done:
     return ret;
@@ -2641,7 +6202,8 @@ HG_Bulk_get_serialize_size(hg_bulk_t handle, unsigned long flags)
     HG_CHECK_ERROR_NORET(
         handle == HG_BULK_NULL, done, "NULL bulk handle passed");
 
-    ret = hg_bulk_get_serialize_size((struct hg_bulk *) handle, flags & 0xff);
+    ret = hg_bulk_get_serialize_size((struct hg_bulk *) handle,
+        HG_BULK_SERIALIZE_FLAGS((struct hg_bulk *) handle, flags));
 
     HG_LOG_DEBUG(
         "Serialize size with flags eager=%d, sm=%d, is %zu bytes for bulk "
@@ -2667,8 +6229,9 @@ HG_Bulk_serialize(
         handle, (flags & HG_BULK_EAGER) ? HG_TRUE : HG_FALSE,
         (flags & HG_BULK_SM) ? HG_TRUE : HG_FALSE);
 
-    ret = hg_bulk_serialize(
-        buf, buf_size, flags & 0xff, (struct hg_bulk *) handle);
+    ret = hg_bulk_serialize(buf, buf_size,
+        HG_BULK_SERIALIZE_FLAGS((struct hg_bulk *) handle, flags),
+        (struct hg_bulk *) handle);
     HG_CHECK_HG_ERROR(done, ret, "Could not serialize handle");
 
 done:
@@ -2685,8 +6248,8 @@ HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
     HG_CHECK_ERROR(
         handle == NULL, done, ret, HG_INVALID_ARG, "NULL bulk handle passed");
 
-    ret = hg_bulk_deserialize(
-        hg_class->core_class, (struct hg_bulk **) handle, buf, buf_size);
+    ret = hg_bulk_deserialize(hg_class->core_class, (struct hg_bulk **) handle,
+        buf, buf_size, HG_FALSE);
     HG_CHECK_HG_ERROR(done, ret, "Could not deserialize handle");
 
     HG_LOG_DEBUG("Deserialized into new bulk handle (%p)", *handle);
@@ -2738,9 +6301,9 @@ HG_Bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
         hg_bulk_origin, hg_bulk_local);
 
     /* Do bulk transfer */
-    ret = hg_bulk_transfer(context->core_context, callback, arg, op,
-        (hg_core_addr_t) origin_addr, 0, hg_bulk_origin, origin_offset,
-        hg_bulk_local, local_offset, size, op_id);
+    ret = hg_bulk_transfer(context->core_context, callback, arg, NULL, NULL,
+        NULL, NULL, op, (hg_core_addr_t) origin_addr, 0, hg_bulk_origin,
+        origin_offset, hg_bulk_local, local_offset, size, op_id);
     HG_CHECK_HG_ERROR(done, ret, "Could not start transfer of bulk data");
 
 done:
@@ -2790,9 +6353,10 @@ HG_Bulk_bind_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
         hg_bulk_origin, hg_bulk_local);
 
     /* Do bulk transfer */
-    ret = hg_bulk_transfer(context->core_context, callback, arg, op,
-        hg_bulk_origin->addr, hg_bulk_origin->context_id, hg_bulk_origin,
-        origin_offset, hg_bulk_local, local_offset, size, op_id);
+    ret = hg_bulk_transfer(context->core_context, callback, arg, NULL, NULL,
+        NULL, NULL, op, hg_bulk_origin->addr, hg_bulk_origin->context_id,
+        hg_bulk_origin, origin_offset, hg_bulk_local, local_offset, size,
+        op_id);
     HG_CHECK_HG_ERROR(done, ret, "Could not start transfer of bulk data");
 
 done:
@@ -2805,6 +6369,113 @@ HG_Bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
     hg_bulk_op_t op, hg_addr_t origin_addr, hg_uint8_t origin_id,
     hg_bulk_t origin_handle, hg_size_t origin_offset, hg_bulk_t local_handle,
     hg_size_t local_offset, hg_size_t size, hg_op_id_t *op_id)
+{
+    return hg_bulk_transfer_id(context, callback, arg, NULL, NULL, NULL, NULL,
+        op, origin_addr, origin_id, origin_handle, origin_offset, local_handle,
+        local_offset, size, op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_progress(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_progress_cb_t progress_cb, void *progress_arg, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_op_id_t *op_id)
+{
+    return hg_bulk_transfer_id(context, callback, arg, progress_cb,
+        progress_arg, NULL, NULL, op, origin_addr, origin_id, origin_handle,
+        origin_offset, local_handle, local_offset, size, op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_progressive(hg_context_t *context, hg_cb_t callback,
+    void *arg, hg_bulk_chunk_cb_t chunk_cb, void *chunk_arg, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_op_id_t *op_id)
+{
+    return hg_bulk_transfer_id(context, callback, arg, NULL, NULL, chunk_cb,
+        chunk_arg, op, origin_addr, origin_id, origin_handle, origin_offset,
+        local_handle, local_offset, size, op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_list(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, hg_addr_t origin_addr, hg_uint8_t origin_id,
+    const struct hg_bulk_transfer_desc *transfers, hg_uint32_t count,
+    hg_op_id_t *op_id)
+{
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint32_t i;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
+    HG_CHECK_ERROR(transfers == NULL || count == 0, done, ret, HG_INVALID_ARG,
+        "Empty list of transfers");
+
+    for (i = 0; i < count; i++) {
+        struct hg_bulk *hg_bulk_origin =
+            (struct hg_bulk *) transfers[i].origin_handle;
+        struct hg_bulk *hg_bulk_local =
+            (struct hg_bulk *) transfers[i].local_handle;
+
+        /* Origin handle sanity checks */
+        HG_CHECK_ERROR(hg_bulk_origin == NULL, done, ret, HG_INVALID_ARG,
+            "NULL origin handle passed (entry %u)", i);
+        HG_CHECK_ERROR(transfers[i].origin_offset + transfers[i].size >
+                           hg_bulk_origin->desc.info.len,
+            done, ret, HG_INVALID_ARG,
+            "Exceeding size of memory exposed by origin handle (entry %u, "
+            "%zu + %zu > %zu)",
+            i, transfers[i].origin_offset, transfers[i].size,
+            hg_bulk_origin->desc.info.len);
+        HG_CHECK_ERROR(hg_bulk_origin->addr != HG_CORE_ADDR_NULL, done, ret,
+            HG_INVALID_ARG,
+            "Address information embedded into origin handle (entry %u)", i);
+
+        /* Local handle sanity checks */
+        HG_CHECK_ERROR(hg_bulk_local == NULL, done, ret, HG_INVALID_ARG,
+            "NULL local handle passed (entry %u)", i);
+        HG_CHECK_ERROR(transfers[i].local_offset + transfers[i].size >
+                           hg_bulk_local->desc.info.len,
+            done, ret, HG_INVALID_ARG,
+            "Exceeding size of memory exposed by local handle (entry %u, "
+            "%zu + %zu > %zu)",
+            i, transfers[i].local_offset, transfers[i].size,
+            hg_bulk_local->desc.info.len);
+
+        /* Strided regions are translated by the single transfer path */
+        HG_CHECK_ERROR(
+            HG_BULK_IS_STRIDED(hg_bulk_origin) ||
+                HG_BULK_IS_STRIDED(hg_bulk_local),
+            done, ret, HG_OPNOTSUPPORTED,
+            "Strided handles cannot be transferred in a list (entry %u)", i);
+
+        /* Check permission flags */
+        HG_BULK_CHECK_FLAGS(op, hg_bulk_origin->desc.info.flags,
+            hg_bulk_local->desc.info.flags, done, ret);
+    }
+
+    HG_LOG_DEBUG("Transferring list of %u range(s)", count);
+
+    ret = hg_bulk_transfer_list(context->core_context, callback, arg, op,
+        (hg_core_addr_t) origin_addr, origin_id, transfers, count, op_id);
+    HG_CHECK_HG_ERROR(done, ret, "Could not start transfer of bulk data");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_atomic(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_atomic_op_t op, hg_uint64_t operand, hg_uint64_t compare,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_op_id_t *op_id)
 {
     struct hg_bulk *hg_bulk_origin = (struct hg_bulk *) origin_handle;
     struct hg_bulk *hg_bulk_local = (struct hg_bulk *) local_handle;
@@ -2816,36 +6487,39 @@ HG_Bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
     /* Origin handle sanity checks */
     HG_CHECK_ERROR(hg_bulk_origin == NULL, done, ret, HG_INVALID_ARG,
         "NULL origin handle passed");
-    HG_CHECK_ERROR((origin_offset + size) > hg_bulk_origin->desc.info.len, done,
-        ret, HG_INVALID_ARG,
-        "Exceeding size of memory exposed by origin handle (%zu + %zu > %zu)",
-        origin_offset, size, hg_bulk_origin->desc.info.len);
+    HG_CHECK_ERROR(
+        (origin_offset + sizeof(hg_uint64_t)) > hg_bulk_origin->desc.info.len,
+        done, ret, HG_INVALID_ARG,
+        "Exceeding size of memory exposed by origin handle (%zu + 8 > %zu)",
+        origin_offset, hg_bulk_origin->desc.info.len);
     HG_CHECK_ERROR(hg_bulk_origin->addr != HG_CORE_ADDR_NULL, done, ret,
-        HG_INVALID_ARG,
-        "Address information embedded into origin_handle, use "
-        "HG_Bulk_bind_transfer() instead");
+        HG_INVALID_ARG, "Address information embedded into origin_handle");
+    HG_CHECK_ERROR((hg_bulk_origin->desc.info.flags & HG_BULK_READWRITE) !=
+                       HG_BULK_READWRITE,
+        done, ret, HG_PERMISSION,
+        "Origin handle requires read/write permission (origin=0x%x)",
+        hg_bulk_origin->desc.info.flags);
 
     /* Local handle sanity checks */
     HG_CHECK_ERROR(hg_bulk_local == NULL, done, ret, HG_INVALID_ARG,
-        "NULL origin handle passed");
-    HG_CHECK_ERROR((local_offset + size) > hg_bulk_local->desc.info.len, done,
-        ret, HG_INVALID_ARG,
-        "Exceeding size of memory exposed by local handle (%zu + %zu > %zu)",
-        local_offset, size, hg_bulk_local->desc.info.len);
-
-    /* Check permission flags */
-    HG_BULK_CHECK_FLAGS(op, hg_bulk_origin->desc.info.flags,
-        hg_bulk_local->desc.info.flags, done, ret);
-
-    HG_LOG_DEBUG(
-        "Transferring data between bulk handle (%p) and bulk handle (%p)",
+        "NULL local handle passed");
+    HG_CHECK_ERROR(
+        (local_offset + sizeof(hg_uint64_t)) > hg_bulk_local->desc.info.len,
+        done, ret, HG_INVALID_ARG,
+        "Exceeding size of memory exposed by local handle (%zu + 8 > %zu)",
+        local_offset, hg_bulk_local->desc.info.len);
+    HG_CHECK_ERROR(!(hg_bulk_local->desc.info.flags & HG_BULK_WRITE_ONLY),
+        done, ret, HG_PERMISSION,
+        "Local handle requires write permission (local=0x%x)",
+        hg_bulk_local->desc.info.flags);
+
+    HG_LOG_DEBUG("Atomic update of bulk handle (%p) into bulk handle (%p)",
         hg_bulk_origin, hg_bulk_local);
 
-    /* Do bulk transfer */
-    ret = hg_bulk_transfer(context->core_context, callback, arg, op,
-        (hg_core_addr_t) origin_addr, origin_id, hg_bulk_origin, origin_offset,
-        hg_bulk_local, local_offset, size, op_id);
-    HG_CHECK_HG_ERROR(done, ret, "Could not start transfer of bulk data");
+    ret = hg_bulk_atomic(context->core_context, callback, arg, op, operand,
+        compare, (hg_core_addr_t) origin_addr, origin_id, hg_bulk_origin,
+        origin_offset, hg_bulk_local, local_offset, op_id);
+    HG_CHECK_HG_ERROR(done, ret, "Could not start atomic operation");
 
 done:
     return ret;
@@ -17,6 +17,44 @@
 /* Public Type and Struct Definition */
 /*************************************/
 
+/* Partial progress callback, called with cumulative size transferred */
+typedef void (*hg_bulk_progress_cb_t)(
+    void *arg, hg_size_t transferred, hg_size_t size);
+
+/* Chunk completion callback, called with offset (relative to the start of
+ * the transfer) and size of the chunk that completed */
+typedef void (*hg_bulk_chunk_cb_t)(void *arg, hg_size_t offset, hg_size_t size);
+
+/* Memory types */
+typedef enum {
+    HG_MEM_TYPE_UNKNOWN = NA_MEM_TYPE_UNKNOWN, /*!< unknown (host) */
+    HG_MEM_TYPE_HOST = NA_MEM_TYPE_HOST,       /*!< host memory */
+    HG_MEM_TYPE_CUDA = NA_MEM_TYPE_CUDA,       /*!< CUDA device memory */
+    HG_MEM_TYPE_ROCM = NA_MEM_TYPE_ROCM,       /*!< ROCm device memory */
+    HG_MEM_TYPE_ZE = NA_MEM_TYPE_ZE            /*!< Level Zero device memory */
+} hg_mem_type_t;
+
+/* Bulk handle attributes */
+struct hg_bulk_attr {
+    hg_mem_type_t mem_type; /* Memory type of all segments */
+    hg_uint64_t device;     /* Device ID (ignored for host memory) */
+};
+
+/* Level of a strided bulk region */
+struct hg_bulk_stride {
+    hg_size_t count;  /* Number of elements of level */
+    hg_size_t stride; /* Distance in bytes between starts of elements */
+};
+
+/* Entry of a list of bulk transfers */
+struct hg_bulk_transfer_desc {
+    hg_bulk_t origin_handle; /* Origin bulk handle */
+    hg_size_t origin_offset; /* Offset in origin handle */
+    hg_bulk_t local_handle;  /* Local bulk handle */
+    hg_size_t local_offset;  /* Offset in local handle */
+    hg_size_t size;          /* Size of data to be transferred */
+};
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -27,6 +65,9 @@
 #define HG_BULK_WRITE_ONLY (1 << 1)
 #define HG_BULK_READWRITE  (HG_BULK_READ_ONLY | HG_BULK_WRITE_ONLY)
 
+/* Maximum number of levels of strided bulk regions */
+#define HG_BULK_STRIDE_MAX (3)
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -58,6 +99,85 @@ HG_PUBLIC hg_return_t
 HG_Bulk_create(hg_class_t *hg_class, hg_uint32_t count, void **buf_ptrs,
     const hg_size_t *buf_sizes, hg_uint8_t flags, hg_bulk_t *handle);
 
+/**
+ * Create an abstract bulk handle from memory segments that reside on a
+ * device (or on the host if attr is NULL). All segments share the same
+ * memory type and device, and buf_ptrs must be provided.
+ * \remark Device memory is only registered with the default NA class, it
+ * must therefore have been initialized with
+ * na_init_info.request_mem_device. Transfers that would require a copy by
+ * the host (self and shared-memory transfers, eager serialization) are not
+ * supported with device memory.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param count [IN]            number of segments
+ * \param buf_ptrs [IN]         array of pointers
+ * \param buf_sizes [IN]        array of sizes
+ * \param flags [IN]            permission flag:
+ *                                - HG_BULK_READWRITE
+ *                                - HG_BULK_READ_ONLY
+ *                                - HG_BULK_WRITE_ONLY
+ * \param attr [IN]             pointer to bulk attributes
+ * \param handle [OUT]          pointer to returned abstract bulk handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_create_attr(hg_class_t *hg_class, hg_uint32_t count, void **buf_ptrs,
+    const hg_size_t *buf_sizes, hg_uint8_t flags,
+    const struct hg_bulk_attr *attr, hg_bulk_t *handle);
+
+/**
+ * Create an abstract bulk handle from a strided memory region. Blocks of
+ * block_len bytes are repeated strides[0].count times every strides[0].stride
+ * bytes, the resulting elements are repeated strides[1].count times every
+ * strides[1].stride bytes and so on for up to HG_BULK_STRIDE_MAX levels.
+ * Offsets passed to transfer functions are offsets within the concatenation
+ * of all blocks. The region is registered as a single segment spanning from
+ * base to the end of the last block, and the descriptor is serialized in
+ * constant space regardless of the number of blocks.
+ * \remark Data of strided handles is never sent eagerly, and strided handles
+ * cannot be transferred with HG_Bulk_transfer_list().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param base [IN]             pointer to first block
+ * \param block_len [IN]        size of blocks
+ * \param strides [IN]          array of levels, innermost level first
+ * \param stride_count [IN]     number of levels
+ * \param flags [IN]            permission flag:
+ *                                - HG_BULK_READWRITE
+ *                                - HG_BULK_READ_ONLY
+ *                                - HG_BULK_WRITE_ONLY
+ * \param handle [OUT]          pointer to returned abstract bulk handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_create_strided(hg_class_t *hg_class, void *base, hg_size_t block_len,
+    const struct hg_bulk_stride *strides, hg_uint32_t stride_count,
+    hg_uint8_t flags, hg_bulk_t *handle);
+
+/**
+ * Create a lightweight handle that exposes the region [offset, offset + size)
+ * of an existing handle. The view shares the segments and the NA memory
+ * handles of its parent, no memory is registered, and only the segments
+ * that contain the region are serialized. The parent is kept alive until
+ * the view is freed with HG_Bulk_free(). Views of remote (deserialized)
+ * handles and of other views are also supported.
+ * \remark HG_Bulk_get_segment_count() returns the number of segments that
+ * contain the region.
+ *
+ * \param handle [IN]           abstract bulk handle
+ * \param offset [IN]           offset of region in handle
+ * \param size [IN]             size of region
+ * \param view [OUT]            pointer to returned abstract bulk handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_create_view(
+    hg_bulk_t handle, hg_size_t offset, hg_size_t size, hg_bulk_t *view);
+
 /**
  * Free bulk handle.
  *
@@ -68,6 +188,33 @@ HG_Bulk_create(hg_class_t *hg_class, hg_uint32_t count, void **buf_ptrs,
 HG_PUBLIC hg_return_t
 HG_Bulk_free(hg_bulk_t handle);
 
+/**
+ * Allocate memory from regions that are registered with the NA classes of
+ * \hg_class. Bulk handles created with HG_Bulk_create() on that memory
+ * re-use the existing registration instead of registering it again
+ * (plugins that cannot share registrations still register it). Allocations
+ * are page aligned, small sizes are rounded up to the next power of two.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param size [IN]             size of allocation
+ *
+ * \return Pointer to allocated memory or NULL in case of failure
+ */
+HG_PUBLIC void *
+HG_Mem_alloc(hg_class_t *hg_class, hg_size_t size);
+
+/**
+ * Free memory allocated by HG_Mem_alloc(). Bulk handles created on that
+ * memory must have been freed before.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param mem_ptr [IN]          pointer to memory
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Mem_free(hg_class_t *hg_class, void *mem_ptr);
+
 /**
  * Increment ref count on bulk handle.
  *
@@ -304,6 +451,243 @@ HG_Bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
     hg_bulk_t origin_handle, hg_size_t origin_offset, hg_bulk_t local_handle,
     hg_size_t local_offset, hg_size_t size, hg_op_id_t *op_id);
 
+/**
+ * Transfer data to/from origin in the same way as HG_Bulk_transfer_id() and
+ * report partial progress through progress_cb. When bulk pipelining is
+ * enabled (see hg_init_info::bulk_chunk_size), progress_cb is called each time
+ * a chunk completes, otherwise it is called once before completion. It is
+ * called from within HG_Progress() with the cumulative size transferred and
+ * must therefore not block.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param progress_cb [IN]      pointer to partial progress callback
+ * \param progress_arg [IN]     pointer to data passed to progress_cb
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset
+ * \param size [IN]             size of data to be transferred
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_transfer_progress(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_progress_cb_t progress_cb, void *progress_arg, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_op_id_t *op_id);
+
+/**
+ * Transfer data to/from origin in the same way as HG_Bulk_transfer_id() and
+ * call chunk_cb each time a chunk of the transfer has completed. Chunks are
+ * delimited by segment boundaries and, when bulk pipelining is enabled, by
+ * hg_init_info::bulk_chunk_size. Chunks may complete out of order but
+ * chunk_cb is always called for all chunks before callback is queued. It is
+ * called from within HG_Progress() and must therefore not block.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param chunk_cb [IN]         pointer to chunk completion callback
+ * \param chunk_arg [IN]        pointer to data passed to chunk_cb
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset
+ * \param size [IN]             size of data to be transferred
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_transfer_progressive(hg_context_t *context, hg_cb_t callback,
+    void *arg, hg_bulk_chunk_cb_t chunk_cb, void *chunk_arg, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_op_id_t *op_id);
+
+/**
+ * Create a read-only bulk handle exposing buf compressed with codec. Data is
+ * split into chunks of chunk_size (a default is used if 0) that are
+ * compressed independently so that they can be decompressed as they arrive;
+ * chunks that do not shrink are stored as is, and no compression is attempted
+ * if buf_size is below threshold. The compressed copy is owned by the handle,
+ * buf can therefore be released once this call returns. The handle must be
+ * pulled with HG_Bulk_transfer_decompress().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param codec [IN]            pointer to codec
+ * \param buf [IN]              pointer to data
+ * \param buf_size [IN]         size of data
+ * \param chunk_size [IN]       size of independently compressed chunks
+ * \param threshold [IN]        size under which data is not compressed
+ * \param handle [OUT]          pointer to returned abstract bulk handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_create_compressed(hg_class_t *hg_class, const struct hg_codec *codec,
+    const void *buf, hg_size_t buf_size, hg_size_t chunk_size,
+    hg_size_t threshold, hg_bulk_t *handle);
+
+/**
+ * Pull a region created with HG_Bulk_create_compressed() and decompress it
+ * into local_handle at local_offset. Compressed data is staged and each chunk
+ * is decompressed from within HG_Progress() as soon as it has been pulled,
+ * which overlaps decompression with the rest of the transfer when bulk
+ * pipelining is enabled. callback is called once all chunks have been
+ * decompressed, with HG_PROTOCOL_ERROR if the region is malformed. The
+ * operation cannot be canceled.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param codec [IN]            pointer to codec used to compress region
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle of compressed region
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_transfer_decompress(hg_context_t *context, hg_cb_t callback, void *arg,
+    const struct hg_codec *codec, hg_addr_t origin_addr, hg_uint8_t origin_id,
+    hg_bulk_t origin_handle, hg_bulk_t local_handle, hg_size_t local_offset);
+
+/**
+ * Compute CRC32C checksums of [offset, offset + size) of handle, one per
+ * chunk of chunk_size (the last chunk may be smaller). crcs must hold
+ * (size + chunk_size - 1) / chunk_size values.
+ *
+ * \param handle [IN]           abstract bulk handle
+ * \param offset [IN]           offset
+ * \param size [IN]             size of data
+ * \param chunk_size [IN]       size of checksummed chunks
+ * \param crcs [OUT]            pointer to returned CRCs
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_crc32c(hg_bulk_t handle, hg_size_t offset, hg_size_t size,
+    hg_size_t chunk_size, hg_uint32_t *crcs);
+
+/**
+ * Pull data from origin in the same way as HG_Bulk_transfer_progressive()
+ * and verify it against crcs, as computed by HG_Bulk_crc32c() on the origin
+ * data with the same chunk_size. Each chunk is verified from within
+ * HG_Progress() as soon as it has landed in local_handle, so that with bulk
+ * pipelining enabled, verification overlaps the rest of the transfer instead
+ * of requiring a separate pass. callback is called with HG_CHECKSUM_ERROR if
+ * any chunk does not match.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset
+ * \param size [IN]             size of data to be transferred
+ * \param chunk_size [IN]       size of checksummed chunks
+ * \param crcs [IN]             pointer to expected CRCs
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_transfer_crc32c(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_size_t chunk_size, const hg_uint32_t *crcs,
+    hg_op_id_t *op_id);
+
+/**
+ * Transfer data to/from origin for each entry of a list of transfers using
+ * a single operation ID. Consecutive entries that use the same handles and
+ * contiguous ranges on both sides are merged into a single transfer. All
+ * entries must use the same origin address and origin context ID, and bulk
+ * handles of a same origin must reach it through the same transport. Entries
+ * are neither pipelined nor striped across rails. Once all entries have
+ * completed, user callback is placed into a completion queue and can be
+ * triggered using HG_Trigger(); the handles reported in its callback info are
+ * the handles of one of the entries.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param transfers [IN]        array of transfer descriptors
+ * \param count [IN]            number of transfer descriptors
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_transfer_list(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, hg_addr_t origin_addr, hg_uint8_t origin_id,
+    const struct hg_bulk_transfer_desc *transfers, hg_uint32_t count,
+    hg_op_id_t *op_id);
+
+/**
+ * Atomically update the 64-bit value exposed by origin_handle at
+ * origin_offset and fetch its previous value into the 8 bytes of local_handle
+ * at local_offset. The value is updated according to op using operand (and
+ * compare for HG_BULK_ATOMIC_COMPARE_SWAP) without involving the origin
+ * process, origin_handle must therefore be created with HG_BULK_READWRITE and
+ * the value must be 8-byte aligned and contained within a single segment.
+ * After completion, user callback is placed into a completion queue and can be
+ * triggered using HG_Trigger(); the operation reported in its callback info
+ * is HG_BULK_PULL.
+ * \remark Transports that cannot update remote memory atomically return
+ * HG_OPNOTSUPPORTED (e.g., SM without XPMEM between different processes).
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param op [IN]               atomic operation:
+ *                                  - HG_BULK_ATOMIC_FETCH_ADD
+ *                                  - HG_BULK_ATOMIC_COMPARE_SWAP
+ *                                  - HG_BULK_ATOMIC_SWAP
+ * \param operand [IN]          operand of operation
+ * \param compare [IN]          value compared against (compare-swap only)
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset of value
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset of previous value
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_atomic(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_atomic_op_t op, hg_uint64_t operand, hg_uint64_t compare,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_op_id_t *op_id);
+
 /**
  * Cancel an ongoing operation.
  *
@@ -321,8 +705,11 @@ HG_Bulk_cancel(hg_op_id_t op_id);
 /* HG bulk descriptor info */
 struct hg_bulk_desc_info {
     hg_size_t len;             /* Size of region */
+    hg_size_t offset;          /* Offset of region in segments (views) */
     hg_uint32_t segment_count; /* Segment count */
     hg_uint8_t flags;          /* Flags of operation access */
+    hg_uint8_t rail_count;     /* Number of NA rails */
+    hg_uint8_t stride_count;   /* Number of stride levels (strided) */
 };
 
 /*---------------------------------------------------------------------------*/
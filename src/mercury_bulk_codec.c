@@ -0,0 +1,626 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury.h"
+#include "mercury_bulk.h"
+#include "mercury_error.h"
+#include "mercury_thread_mutex.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Default size of chunks compressed independently */
+#define HG_BULK_CODEC_CHUNK_SIZE_DEFAULT (1 << 18)
+
+/* Size of the prefix pulled first, which contains the header, the chunk
+ * table and the first chunks if they are small */
+#define HG_BULK_CODEC_PREFIX_SIZE (4096)
+
+/* Offset of chunk table */
+#define HG_BULK_CODEC_TABLE_OFFSET sizeof(struct hg_bulk_codec_header)
+
+/* Offset of first chunk */
+#define HG_BULK_CODEC_DATA_OFFSET(count)                                       \
+    (HG_BULK_CODEC_TABLE_OFFSET + (hg_size_t) (count) * sizeof(hg_uint32_t))
+
+/* Original size of chunk i */
+#define HG_BULK_CODEC_CHUNK_LEN(header, i)                                     \
+    (((i) + 1 < (header)->chunk_count)                                         \
+            ? (hg_size_t) (header)->chunk_size                                 \
+            : (header)->size - (hg_size_t) (i) * (header)->chunk_size)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Compressed regions start with this header, followed by the table of stored
+ * chunk sizes and by the chunks. Chunks whose stored size is their original
+ * size are not compressed. Like serialized bulk handles, fields are in host
+ * byte order. */
+struct hg_bulk_codec_header {
+    hg_uint64_t size;        /* Size of original data */
+    hg_uint32_t chunk_size;  /* Original size of chunks (last may be smaller) */
+    hg_uint32_t chunk_count; /* Number of chunks */
+};
+
+/* Decompressing transfer */
+struct hg_bulk_codec_op {
+    struct hg_bulk_codec_header header; /* Header of compressed region */
+    struct hg_cb_info callback_info;    /* User callback info */
+    hg_cb_t callback;                   /* User callback */
+    const struct hg_codec *codec;       /* Codec */
+    hg_context_t *context;              /* Context */
+    hg_addr_t origin_addr;              /* Origin address */
+    hg_bulk_t origin_handle;            /* Compressed region */
+    hg_bulk_t local_handle;             /* Decompressed data */
+    hg_size_t local_offset;             /* Offset of decompressed data */
+    hg_bulk_t stage_handle;             /* Staging of compressed region */
+    char *stage_buf;                    /* Staging buffer */
+    hg_size_t stage_size;               /* Size of compressed region */
+    hg_size_t pulled;                   /* Size of prefix already pulled */
+    hg_size_t data_start;               /* Offset of progressive pull */
+    hg_size_t *offsets;                 /* Offsets of chunks in stage */
+    hg_size_t *missing;                 /* Bytes of chunks not pulled yet */
+    hg_thread_mutex_t mutex;            /* Mutex protecting missing/ret */
+    hg_uint32_t decoded;                /* Number of decoded chunks */
+    hg_return_t ret;                    /* Return code */
+    hg_uint8_t origin_id;               /* Origin context ID */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Compress buf into chunks of chunk_size, dst must be large enough to hold
+ * the header, the chunk table and buf_size bytes.
+ */
+static hg_return_t
+hg_bulk_codec_compress(const struct hg_codec *codec, const void *buf,
+    hg_size_t buf_size, hg_size_t chunk_size, hg_bool_t compress, char *dst,
+    hg_size_t *dst_size);
+
+/**
+ * Pull [pulled, end) of compressed region.
+ */
+static hg_return_t
+hg_bulk_codec_pull(struct hg_bulk_codec_op *hg_bulk_codec_op, hg_size_t end,
+    hg_bool_t progressive);
+
+/**
+ * Pull callback of header and chunk table.
+ */
+static hg_return_t
+hg_bulk_codec_header_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Parse chunk table and decode chunks already pulled.
+ */
+static hg_return_t
+hg_bulk_codec_parse(struct hg_bulk_codec_op *hg_bulk_codec_op);
+
+/**
+ * Chunk callback of compressed data, decode chunks that are complete.
+ */
+static void
+hg_bulk_codec_chunk_cb(void *arg, hg_size_t offset, hg_size_t size);
+
+/**
+ * Pull callback of compressed data.
+ */
+static hg_return_t
+hg_bulk_codec_data_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Decode chunk i into local handle.
+ */
+static hg_return_t
+hg_bulk_codec_decode(struct hg_bulk_codec_op *hg_bulk_codec_op, hg_uint32_t i);
+
+/**
+ * Complete transfer and execute user callback.
+ */
+static hg_return_t
+hg_bulk_codec_complete(struct hg_bulk_codec_op *hg_bulk_codec_op);
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_codec_compress(const struct hg_codec *codec, const void *buf,
+    hg_size_t buf_size, hg_size_t chunk_size, hg_bool_t compress, char *dst,
+    hg_size_t *dst_size)
+{
+    struct hg_bulk_codec_header header;
+    hg_uint32_t *table = (hg_uint32_t *) (dst + HG_BULK_CODEC_TABLE_OFFSET);
+    hg_size_t offset;
+    hg_uint32_t i;
+    hg_return_t ret = HG_SUCCESS;
+
+    header.size = (hg_uint64_t) buf_size;
+    header.chunk_size = (hg_uint32_t) chunk_size;
+    header.chunk_count =
+        (hg_uint32_t) ((buf_size + chunk_size - 1) / chunk_size);
+    memcpy(dst, &header, sizeof(header));
+
+    offset = HG_BULK_CODEC_DATA_OFFSET(header.chunk_count);
+    for (i = 0; i < header.chunk_count; i++) {
+        const char *src = (const char *) buf + (hg_size_t) i * chunk_size;
+        hg_size_t len = HG_BULK_CODEC_CHUNK_LEN(&header, i);
+        hg_size_t comp_size = len - 1;
+        hg_uint32_t stored;
+
+        /* Only keep compressed chunks that are smaller */
+        if (compress && len > 1) {
+            ret = codec->compress(dst + offset, &comp_size, src, len);
+            if (ret == HG_OVERFLOW) {
+                comp_size = len;
+                ret = HG_SUCCESS;
+            }
+            HG_CHECK_HG_ERROR(done, ret, "Could not compress chunk %u", i);
+        } else
+            comp_size = len;
+
+        if (comp_size == len)
+            memcpy(dst + offset, src, (size_t) len);
+
+        stored = (hg_uint32_t) comp_size;
+        memcpy(&table[i], &stored, sizeof(stored));
+        offset += comp_size;
+    }
+
+    *dst_size = offset;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_codec_pull(struct hg_bulk_codec_op *hg_bulk_codec_op, hg_size_t end,
+    hg_bool_t progressive)
+{
+    hg_size_t start = hg_bulk_codec_op->pulled;
+
+    hg_bulk_codec_op->pulled = end;
+
+    if (progressive) {
+        hg_bulk_codec_op->data_start = start;
+        return HG_Bulk_transfer_progressive(hg_bulk_codec_op->context,
+            hg_bulk_codec_data_cb, hg_bulk_codec_op, hg_bulk_codec_chunk_cb,
+            hg_bulk_codec_op, HG_BULK_PULL, hg_bulk_codec_op->origin_addr,
+            hg_bulk_codec_op->origin_id, hg_bulk_codec_op->origin_handle,
+            start, hg_bulk_codec_op->stage_handle, start, end - start,
+            HG_OP_ID_IGNORE);
+    } else
+        return HG_Bulk_transfer_id(hg_bulk_codec_op->context,
+            hg_bulk_codec_header_cb, hg_bulk_codec_op, HG_BULK_PULL,
+            hg_bulk_codec_op->origin_addr, hg_bulk_codec_op->origin_id,
+            hg_bulk_codec_op->origin_handle, start,
+            hg_bulk_codec_op->stage_handle, start, end - start,
+            HG_OP_ID_IGNORE);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_codec_header_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_bulk_codec_op *hg_bulk_codec_op =
+        (struct hg_bulk_codec_op *) callback_info->arg;
+    struct hg_bulk_codec_header *header = &hg_bulk_codec_op->header;
+    hg_size_t data_offset;
+    hg_return_t ret = callback_info->ret;
+
+    HG_CHECK_HG_ERROR(error, ret, "Could not pull compressed header (%s)",
+        HG_Error_to_string(ret));
+
+    memcpy(header, hg_bulk_codec_op->stage_buf, sizeof(*header));
+    HG_CHECK_ERROR(header->chunk_count == 0 ||
+                       header->chunk_count >
+                           (header->size + header->chunk_size - 1) /
+                               header->chunk_size,
+        error, ret, HG_PROTOCOL_ERROR, "Invalid compressed header");
+    HG_CHECK_ERROR(header->size >
+                       HG_Bulk_get_size(hg_bulk_codec_op->local_handle) -
+                           hg_bulk_codec_op->local_offset,
+        error, ret, HG_OVERFLOW,
+        "Exceeding size of memory exposed by local handle (%" PRIu64 ")",
+        header->size);
+
+    /* Pull remaining part of chunk table */
+    data_offset = HG_BULK_CODEC_DATA_OFFSET(header->chunk_count);
+    HG_CHECK_ERROR(data_offset > hg_bulk_codec_op->stage_size, error, ret,
+        HG_PROTOCOL_ERROR, "Invalid compressed header");
+    if (data_offset > hg_bulk_codec_op->pulled) {
+        ret = hg_bulk_codec_pull(hg_bulk_codec_op, data_offset, HG_FALSE);
+        HG_CHECK_HG_ERROR(error, ret, "Could not pull chunk table");
+
+        return HG_SUCCESS;
+    }
+
+    ret = hg_bulk_codec_parse(hg_bulk_codec_op);
+    HG_CHECK_HG_ERROR(error, ret, "Could not parse chunk table");
+
+    /* Decode chunks as they are pulled */
+    if (hg_bulk_codec_op->pulled < hg_bulk_codec_op->stage_size) {
+        ret = hg_bulk_codec_pull(
+            hg_bulk_codec_op, hg_bulk_codec_op->stage_size, HG_TRUE);
+        HG_CHECK_HG_ERROR(error, ret, "Could not pull compressed data");
+
+        return HG_SUCCESS;
+    }
+
+    return hg_bulk_codec_complete(hg_bulk_codec_op);
+
+error:
+    hg_bulk_codec_op->ret = ret;
+
+    return hg_bulk_codec_complete(hg_bulk_codec_op);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_codec_parse(struct hg_bulk_codec_op *hg_bulk_codec_op)
+{
+    const struct hg_bulk_codec_header *header = &hg_bulk_codec_op->header;
+    const char *table =
+        hg_bulk_codec_op->stage_buf + HG_BULK_CODEC_TABLE_OFFSET;
+    hg_size_t offset = HG_BULK_CODEC_DATA_OFFSET(header->chunk_count);
+    hg_uint32_t i;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_bulk_codec_op->offsets =
+        (hg_size_t *) malloc(header->chunk_count * sizeof(hg_size_t));
+    hg_bulk_codec_op->missing =
+        (hg_size_t *) malloc(header->chunk_count * sizeof(hg_size_t));
+    HG_CHECK_ERROR(
+        hg_bulk_codec_op->offsets == NULL || hg_bulk_codec_op->missing == NULL,
+        done, ret, HG_NOMEM, "Could not allocate chunk table");
+
+    for (i = 0; i < header->chunk_count; i++) {
+        hg_uint32_t stored;
+
+        memcpy(&stored, table + i * sizeof(stored), sizeof(stored));
+        HG_CHECK_ERROR(
+            stored == 0 || stored > HG_BULK_CODEC_CHUNK_LEN(header, i), done,
+            ret, HG_PROTOCOL_ERROR, "Invalid size of chunk %u", i);
+
+        hg_bulk_codec_op->offsets[i] = offset;
+        offset += stored;
+
+        /* Part of chunk may already be in the prefix */
+        if (offset <= hg_bulk_codec_op->pulled)
+            hg_bulk_codec_op->missing[i] = 0;
+        else if (hg_bulk_codec_op->offsets[i] >= hg_bulk_codec_op->pulled)
+            hg_bulk_codec_op->missing[i] = stored;
+        else
+            hg_bulk_codec_op->missing[i] = offset - hg_bulk_codec_op->pulled;
+    }
+    HG_CHECK_ERROR(offset != hg_bulk_codec_op->stage_size, done, ret,
+        HG_PROTOCOL_ERROR, "Chunks do not add up to compressed size");
+
+    for (i = 0; i < header->chunk_count; i++) {
+        if (hg_bulk_codec_op->missing[i] > 0)
+            continue;
+        ret = hg_bulk_codec_decode(hg_bulk_codec_op, i);
+        HG_CHECK_HG_ERROR(done, ret, "Could not decode chunk %u", i);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_codec_chunk_cb(void *arg, hg_size_t offset, hg_size_t size)
+{
+    struct hg_bulk_codec_op *hg_bulk_codec_op = (struct hg_bulk_codec_op *) arg;
+    const hg_size_t *offsets = hg_bulk_codec_op->offsets;
+    hg_uint32_t count = hg_bulk_codec_op->header.chunk_count;
+    hg_size_t start = hg_bulk_codec_op->data_start + offset;
+    hg_size_t end = start + size;
+    hg_uint32_t lo = 0, hi = count;
+
+    /* Find last chunk that starts at or before start */
+    while (hi - lo > 1) {
+        hg_uint32_t mid = lo + (hi - lo) / 2;
+
+        if (offsets[mid] <= start)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    for (; lo < count && offsets[lo] < end; lo++) {
+        hg_size_t chunk_end =
+            (lo + 1 < count) ? offsets[lo + 1] : hg_bulk_codec_op->stage_size;
+        hg_size_t overlap = ((chunk_end < end) ? chunk_end : end) -
+                            ((offsets[lo] > start) ? offsets[lo] : start);
+
+        hg_bool_t ready;
+        hg_return_t ret;
+
+        if (chunk_end <= start)
+            continue;
+
+        /* Chunks may complete concurrently if several threads trigger */
+        hg_thread_mutex_lock(&hg_bulk_codec_op->mutex);
+        hg_bulk_codec_op->missing[lo] -= overlap;
+        ready = (hg_bulk_codec_op->missing[lo] == 0 &&
+                 hg_bulk_codec_op->ret == HG_SUCCESS);
+        hg_thread_mutex_unlock(&hg_bulk_codec_op->mutex);
+        if (!ready)
+            continue;
+
+        ret = hg_bulk_codec_decode(hg_bulk_codec_op, lo);
+        if (ret != HG_SUCCESS) {
+            hg_thread_mutex_lock(&hg_bulk_codec_op->mutex);
+            hg_bulk_codec_op->ret = ret;
+            hg_thread_mutex_unlock(&hg_bulk_codec_op->mutex);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_codec_data_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_bulk_codec_op *hg_bulk_codec_op =
+        (struct hg_bulk_codec_op *) callback_info->arg;
+
+    if (hg_bulk_codec_op->ret == HG_SUCCESS)
+        hg_bulk_codec_op->ret = callback_info->ret;
+    if (hg_bulk_codec_op->ret == HG_SUCCESS &&
+        hg_bulk_codec_op->decoded != hg_bulk_codec_op->header.chunk_count)
+        hg_bulk_codec_op->ret = HG_PROTOCOL_ERROR;
+
+    return hg_bulk_codec_complete(hg_bulk_codec_op);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_codec_decode(struct hg_bulk_codec_op *hg_bulk_codec_op, hg_uint32_t i)
+{
+    const struct hg_bulk_codec_header *header = &hg_bulk_codec_op->header;
+    hg_size_t len = HG_BULK_CODEC_CHUNK_LEN(header, i);
+    hg_size_t local_offset =
+        hg_bulk_codec_op->local_offset + (hg_size_t) i * header->chunk_size;
+    hg_size_t stored = ((i + 1 < header->chunk_count)
+                               ? hg_bulk_codec_op->offsets[i + 1]
+                               : hg_bulk_codec_op->stage_size) -
+                       hg_bulk_codec_op->offsets[i];
+    const char *src =
+        hg_bulk_codec_op->stage_buf + hg_bulk_codec_op->offsets[i];
+    char *tmp_buf = NULL;
+    void *dst = NULL;
+    hg_size_t dst_size = 0, done_size;
+    hg_uint32_t dst_count = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_Bulk_access(hg_bulk_codec_op->local_handle, local_offset, len,
+        HG_BULK_READWRITE, 1, &dst, &dst_size, &dst_count);
+
+    /* Chunk spans several local segments, decode it out of place */
+    if (dst_count == 0 || dst_size < len) {
+        tmp_buf = (char *) malloc((size_t) len);
+        HG_CHECK_ERROR(tmp_buf == NULL, done, ret, HG_NOMEM,
+            "Could not allocate decode buffer");
+        dst = tmp_buf;
+    }
+
+    if (stored < len) {
+        hg_size_t decoded_size = len;
+
+        ret = hg_bulk_codec_op->codec->decompress(
+            dst, &decoded_size, src, stored);
+        HG_CHECK_HG_ERROR(done, ret, "Could not decompress chunk");
+        HG_CHECK_ERROR(decoded_size != len, done, ret, HG_PROTOCOL_ERROR,
+            "Decompressed chunk size mismatch (%zu != %zu)", decoded_size, len);
+    } else if (dst != tmp_buf)
+        memcpy(dst, src, (size_t) len);
+    else
+        tmp_buf = (char *) memcpy(tmp_buf, src, (size_t) len);
+
+    /* Scatter into local segments */
+    for (done_size = 0; tmp_buf && done_size < len; done_size += dst_size) {
+        dst_count = 0;
+        HG_Bulk_access(hg_bulk_codec_op->local_handle, local_offset + done_size,
+            len - done_size, HG_BULK_READWRITE, 1, &dst, &dst_size, &dst_count);
+        HG_CHECK_ERROR(dst_count == 0 || dst_size == 0, done, ret, HG_FAULT,
+            "Could not access local handle");
+        memcpy(dst, tmp_buf + done_size, (size_t) dst_size);
+    }
+
+    hg_thread_mutex_lock(&hg_bulk_codec_op->mutex);
+    hg_bulk_codec_op->decoded++;
+    hg_thread_mutex_unlock(&hg_bulk_codec_op->mutex);
+
+done:
+    free(tmp_buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_codec_complete(struct hg_bulk_codec_op *hg_bulk_codec_op)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_bulk_codec_op->callback_info.ret = hg_bulk_codec_op->ret;
+    if (hg_bulk_codec_op->callback)
+        ret = hg_bulk_codec_op->callback(&hg_bulk_codec_op->callback_info);
+
+    HG_Bulk_free(hg_bulk_codec_op->stage_handle);
+    HG_Bulk_free(hg_bulk_codec_op->origin_handle);
+    HG_Bulk_free(hg_bulk_codec_op->local_handle);
+    free(hg_bulk_codec_op->offsets);
+    free(hg_bulk_codec_op->missing);
+    hg_thread_mutex_destroy(&hg_bulk_codec_op->mutex);
+    free(hg_bulk_codec_op);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_create_compressed(hg_class_t *hg_class, const struct hg_codec *codec,
+    const void *buf, hg_size_t buf_size, hg_size_t chunk_size,
+    hg_size_t threshold, hg_bulk_t *handle)
+{
+    hg_bulk_t hg_bulk = HG_BULK_NULL;
+    char *tmp_buf = NULL;
+    hg_size_t comp_size, chunk_count;
+    void *bulk_buf = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(hg_class == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG class");
+    HG_CHECK_ERROR(codec == NULL, error, ret, HG_INVALID_ARG, "NULL codec");
+    HG_CHECK_ERROR(buf == NULL || buf_size == 0, error, ret, HG_INVALID_ARG,
+        "No data to compress");
+    HG_CHECK_ERROR(handle == NULL, error, ret, HG_INVALID_ARG,
+        "NULL handle pointer");
+
+    if (chunk_size == 0)
+        chunk_size = HG_BULK_CODEC_CHUNK_SIZE_DEFAULT;
+    if (chunk_size > buf_size)
+        chunk_size = buf_size;
+    HG_CHECK_ERROR(chunk_size > UINT32_MAX, error, ret, HG_INVALID_ARG,
+        "Chunk size too large (%zu)", chunk_size);
+    chunk_count = (buf_size + chunk_size - 1) / chunk_size;
+    HG_CHECK_ERROR(chunk_count > UINT32_MAX, error, ret, HG_INVALID_ARG,
+        "Too many chunks (%zu)", chunk_count);
+
+    /* Chunks are never stored larger than their original size */
+    comp_size = HG_BULK_CODEC_DATA_OFFSET(chunk_count) + buf_size;
+    tmp_buf = (char *) malloc((size_t) comp_size);
+    HG_CHECK_ERROR(tmp_buf == NULL, error, ret, HG_NOMEM,
+        "Could not allocate compression buffer");
+
+    ret = hg_bulk_codec_compress(codec, buf, buf_size, chunk_size,
+        (buf_size >= threshold), tmp_buf, &comp_size);
+    HG_CHECK_HG_ERROR(error, ret, "Could not compress data");
+
+    /* Expose compressed region only */
+    ret = HG_Bulk_create(
+        hg_class, 1, NULL, &comp_size, HG_BULK_READ_ONLY, &hg_bulk);
+    HG_CHECK_HG_ERROR(error, ret, "Could not create bulk handle");
+
+    ret = HG_Bulk_access(
+        hg_bulk, 0, comp_size, HG_BULK_READWRITE, 1, &bulk_buf, NULL, NULL);
+    HG_CHECK_HG_ERROR(error, ret, "Could not access bulk handle");
+    memcpy(bulk_buf, tmp_buf, (size_t) comp_size);
+    free(tmp_buf);
+
+    *handle = hg_bulk;
+
+    return HG_SUCCESS;
+
+error:
+    if (hg_bulk != HG_BULK_NULL)
+        HG_Bulk_free(hg_bulk);
+    free(tmp_buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_decompress(hg_context_t *context, hg_cb_t callback, void *arg,
+    const struct hg_codec *codec, hg_addr_t origin_addr, hg_uint8_t origin_id,
+    hg_bulk_t origin_handle, hg_bulk_t local_handle, hg_size_t local_offset)
+{
+    struct hg_bulk_codec_op *hg_bulk_codec_op = NULL;
+    hg_size_t prefix_size;
+    void *stage_buf = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    HG_CHECK_ERROR(codec == NULL, error, ret, HG_INVALID_ARG, "NULL codec");
+    HG_CHECK_ERROR(origin_handle == HG_BULK_NULL, error, ret, HG_INVALID_ARG,
+        "NULL origin handle passed");
+    HG_CHECK_ERROR(local_handle == HG_BULK_NULL, error, ret, HG_INVALID_ARG,
+        "NULL local handle passed");
+    HG_CHECK_ERROR(
+        HG_Bulk_get_size(origin_handle) < HG_BULK_CODEC_DATA_OFFSET(1), error,
+        ret, HG_INVALID_ARG, "Origin handle is not a compressed region");
+    HG_CHECK_ERROR(local_offset > HG_Bulk_get_size(local_handle), error, ret,
+        HG_INVALID_ARG, "Exceeding size of memory exposed by local handle");
+
+    hg_bulk_codec_op =
+        (struct hg_bulk_codec_op *) calloc(1, sizeof(*hg_bulk_codec_op));
+    HG_CHECK_ERROR(hg_bulk_codec_op == NULL, error, ret, HG_NOMEM,
+        "Could not allocate decompression op");
+    hg_bulk_codec_op->callback = callback;
+    hg_bulk_codec_op->callback_info.arg = arg;
+    hg_bulk_codec_op->callback_info.type = HG_CB_BULK;
+    hg_bulk_codec_op->callback_info.info.bulk.origin_handle = origin_handle;
+    hg_bulk_codec_op->callback_info.info.bulk.local_handle = local_handle;
+    hg_bulk_codec_op->callback_info.info.bulk.op = HG_BULK_PULL;
+    hg_bulk_codec_op->codec = codec;
+    hg_bulk_codec_op->context = context;
+    hg_bulk_codec_op->origin_addr = origin_addr;
+    hg_bulk_codec_op->origin_id = origin_id;
+    hg_bulk_codec_op->origin_handle = origin_handle;
+    hg_bulk_codec_op->local_handle = local_handle;
+    hg_bulk_codec_op->local_offset = local_offset;
+    hg_bulk_codec_op->stage_size = HG_Bulk_get_size(origin_handle);
+    hg_bulk_codec_op->ret = HG_SUCCESS;
+    hg_thread_mutex_init(&hg_bulk_codec_op->mutex);
+
+    /* Compressed region is staged before being decoded */
+    ret = HG_Bulk_create(HG_Context_get_class(context), 1, NULL,
+        &hg_bulk_codec_op->stage_size, HG_BULK_READWRITE,
+        &hg_bulk_codec_op->stage_handle);
+    HG_CHECK_HG_ERROR(error, ret, "Could not create staging bulk handle");
+    ret = HG_Bulk_access(hg_bulk_codec_op->stage_handle, 0,
+        hg_bulk_codec_op->stage_size, HG_BULK_READWRITE, 1, &stage_buf, NULL,
+        NULL);
+    HG_CHECK_HG_ERROR(error, ret, "Could not access staging bulk handle");
+    hg_bulk_codec_op->stage_buf = (char *) stage_buf;
+
+    /* Handles are released on completion */
+    ret = HG_Bulk_ref_incr(origin_handle);
+    HG_CHECK_HG_ERROR(error, ret, "Could not take reference to origin handle");
+    ret = HG_Bulk_ref_incr(local_handle);
+    if (ret != HG_SUCCESS) {
+        HG_Bulk_free(origin_handle);
+        HG_GOTO_ERROR(
+            error, ret, ret, "Could not take reference to local handle");
+    }
+
+    /* Header and chunk table come first */
+    prefix_size = (hg_bulk_codec_op->stage_size < HG_BULK_CODEC_PREFIX_SIZE)
+                      ? hg_bulk_codec_op->stage_size
+                      : HG_BULK_CODEC_PREFIX_SIZE;
+    ret = hg_bulk_codec_pull(hg_bulk_codec_op, prefix_size, HG_FALSE);
+    if (ret != HG_SUCCESS) {
+        HG_Bulk_free(origin_handle);
+        HG_Bulk_free(local_handle);
+        HG_GOTO_ERROR(error, ret, ret, "Could not pull compressed header");
+    }
+
+    return HG_SUCCESS;
+
+error:
+    if (hg_bulk_codec_op) {
+        if (hg_bulk_codec_op->stage_handle != HG_BULK_NULL)
+            HG_Bulk_free(hg_bulk_codec_op->stage_handle);
+        hg_thread_mutex_destroy(&hg_bulk_codec_op->mutex);
+        free(hg_bulk_codec_op);
+    }
+
+    return ret;
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_bulk.h"
+#include "mercury_error.h"
+
+#include "mercury_crc32c.h"
+#include "mercury_thread_mutex.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Verified transfer */
+struct hg_bulk_crc_op {
+    hg_cb_t callback;          /* User callback */
+    void *arg;                 /* User callback arg */
+    hg_bulk_t local_handle;    /* Local handle */
+    hg_size_t local_offset;    /* Offset of transfer in local handle */
+    hg_size_t size;            /* Size of transfer */
+    hg_size_t chunk_size;      /* Size of checksummed chunks */
+    hg_size_t count;           /* Number of chunks */
+    hg_uint32_t *crcs;         /* Expected CRCs */
+    hg_size_t *missing;        /* Bytes of chunks not transferred yet */
+    hg_thread_mutex_t mutex;   /* Mutex protecting missing/verified */
+    hg_size_t verified;        /* Number of verified chunks */
+    hg_bool_t mismatch;        /* A chunk did not match */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Compute CRC of [offset, offset + size) of handle.
+ */
+static hg_return_t
+hg_bulk_crc_compute(
+    hg_bulk_t handle, hg_size_t offset, hg_size_t size, hg_uint32_t *crc);
+
+/**
+ * Chunk callback, verify chunks that are complete.
+ */
+static void
+hg_bulk_crc_chunk_cb(void *arg, hg_size_t offset, hg_size_t size);
+
+/**
+ * Transfer callback.
+ */
+static hg_return_t
+hg_bulk_crc_transfer_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Free verified transfer.
+ */
+static void
+hg_bulk_crc_op_free(struct hg_bulk_crc_op *hg_bulk_crc_op);
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_crc_compute(
+    hg_bulk_t handle, hg_size_t offset, hg_size_t size, hg_uint32_t *crc)
+{
+    hg_uint32_t crc_value = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Regions may span several segments */
+    while (size > 0) {
+        void *buf = NULL;
+        hg_size_t buf_size = 0;
+        hg_uint32_t count = 0;
+
+        ret = HG_Bulk_access(handle, offset, size, HG_BULK_READ_ONLY, 1, &buf,
+            &buf_size, &count);
+        HG_CHECK_HG_ERROR(done, ret, "Could not access bulk handle");
+        HG_CHECK_ERROR(count == 0 || buf_size == 0, done, ret, HG_FAULT,
+            "Could not access bulk handle at offset %zu", offset);
+
+        crc_value = hg_crc32c_update(crc_value, buf, (size_t) buf_size);
+        offset += buf_size;
+        size -= buf_size;
+    }
+
+    *crc = crc_value;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_crc_chunk_cb(void *arg, hg_size_t offset, hg_size_t size)
+{
+    struct hg_bulk_crc_op *hg_bulk_crc_op = (struct hg_bulk_crc_op *) arg;
+    hg_size_t end = offset + size, i;
+
+    for (i = offset / hg_bulk_crc_op->chunk_size;
+         i < hg_bulk_crc_op->count && i * hg_bulk_crc_op->chunk_size < end;
+         i++) {
+        hg_size_t chunk_start = i * hg_bulk_crc_op->chunk_size;
+        hg_size_t chunk_len = (i + 1 < hg_bulk_crc_op->count)
+                                  ? hg_bulk_crc_op->chunk_size
+                                  : hg_bulk_crc_op->size - chunk_start;
+        hg_size_t chunk_end = chunk_start + chunk_len;
+        hg_size_t overlap = ((chunk_end < end) ? chunk_end : end) -
+                            ((chunk_start > offset) ? chunk_start : offset);
+        hg_uint32_t crc = 0;
+        hg_bool_t ready, match;
+
+        /* Chunks may complete concurrently if several threads trigger */
+        hg_thread_mutex_lock(&hg_bulk_crc_op->mutex);
+        hg_bulk_crc_op->missing[i] -= overlap;
+        ready = (hg_bulk_crc_op->missing[i] == 0);
+        hg_thread_mutex_unlock(&hg_bulk_crc_op->mutex);
+        if (!ready)
+            continue;
+
+        /* Verify chunk while remaining chunks are in flight */
+        match = (hg_bulk_crc_compute(hg_bulk_crc_op->local_handle,
+                     hg_bulk_crc_op->local_offset + chunk_start, chunk_len,
+                     &crc) == HG_SUCCESS &&
+                 crc == hg_bulk_crc_op->crcs[i]);
+        HG_CHECK_WARNING(!match,
+            "CRC mismatch on chunk %zu (0x%08x != 0x%08x)", (size_t) i, crc,
+            hg_bulk_crc_op->crcs[i]);
+
+        hg_thread_mutex_lock(&hg_bulk_crc_op->mutex);
+        hg_bulk_crc_op->verified++;
+        if (!match)
+            hg_bulk_crc_op->mismatch = HG_TRUE;
+        hg_thread_mutex_unlock(&hg_bulk_crc_op->mutex);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_crc_transfer_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_bulk_crc_op *hg_bulk_crc_op =
+        (struct hg_bulk_crc_op *) callback_info->arg;
+    struct hg_cb_info hg_cb_info = *callback_info;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_cb_info.arg = hg_bulk_crc_op->arg;
+    if (hg_cb_info.ret == HG_SUCCESS &&
+        (hg_bulk_crc_op->mismatch ||
+            hg_bulk_crc_op->verified != hg_bulk_crc_op->count))
+        hg_cb_info.ret = HG_CHECKSUM_ERROR;
+
+    if (hg_bulk_crc_op->callback)
+        ret = hg_bulk_crc_op->callback(&hg_cb_info);
+
+    hg_bulk_crc_op_free(hg_bulk_crc_op);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_crc_op_free(struct hg_bulk_crc_op *hg_bulk_crc_op)
+{
+    hg_thread_mutex_destroy(&hg_bulk_crc_op->mutex);
+    free(hg_bulk_crc_op->crcs);
+    free(hg_bulk_crc_op->missing);
+    free(hg_bulk_crc_op);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_crc32c(hg_bulk_t handle, hg_size_t offset, hg_size_t size,
+    hg_size_t chunk_size, hg_uint32_t *crcs)
+{
+    hg_size_t i, count;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handle == HG_BULK_NULL, done, ret, HG_INVALID_ARG,
+        "NULL bulk handle passed");
+    HG_CHECK_ERROR(chunk_size == 0, done, ret, HG_INVALID_ARG,
+        "Chunk size must be non-zero");
+    HG_CHECK_ERROR(offset + size > HG_Bulk_get_size(handle), done, ret,
+        HG_OVERFLOW, "Exceeding size of memory exposed by bulk handle");
+
+    count = (size + chunk_size - 1) / chunk_size;
+    for (i = 0; i < count; i++) {
+        hg_size_t chunk_len =
+            (i + 1 < count) ? chunk_size : size - i * chunk_size;
+
+        ret = hg_bulk_crc_compute(
+            handle, offset + i * chunk_size, chunk_len, &crcs[i]);
+        HG_CHECK_HG_ERROR(done, ret, "Could not compute CRC of chunk %zu",
+            (size_t) i);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_crc32c(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_size_t chunk_size, const hg_uint32_t *crcs,
+    hg_op_id_t *op_id)
+{
+    struct hg_bulk_crc_op *hg_bulk_crc_op = NULL;
+    hg_size_t i;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(local_handle == HG_BULK_NULL, error, ret, HG_INVALID_ARG,
+        "NULL local handle passed");
+    HG_CHECK_ERROR(chunk_size == 0, error, ret, HG_INVALID_ARG,
+        "Chunk size must be non-zero");
+    HG_CHECK_ERROR(size > 0 && crcs == NULL, error, ret, HG_INVALID_ARG,
+        "NULL CRCs passed");
+
+    hg_bulk_crc_op =
+        (struct hg_bulk_crc_op *) calloc(1, sizeof(*hg_bulk_crc_op));
+    HG_CHECK_ERROR(hg_bulk_crc_op == NULL, error, ret, HG_NOMEM,
+        "Could not allocate verified transfer");
+    hg_bulk_crc_op->callback = callback;
+    hg_bulk_crc_op->arg = arg;
+    hg_bulk_crc_op->local_handle = local_handle;
+    hg_bulk_crc_op->local_offset = local_offset;
+    hg_bulk_crc_op->size = size;
+    hg_bulk_crc_op->chunk_size = chunk_size;
+    hg_bulk_crc_op->count = (size + chunk_size - 1) / chunk_size;
+    hg_thread_mutex_init(&hg_bulk_crc_op->mutex);
+
+    /* Expected CRCs are copied so that callers can release them */
+    if (hg_bulk_crc_op->count > 0) {
+        hg_bulk_crc_op->crcs = (hg_uint32_t *) malloc(
+            hg_bulk_crc_op->count * sizeof(hg_uint32_t));
+        hg_bulk_crc_op->missing =
+            (hg_size_t *) malloc(hg_bulk_crc_op->count * sizeof(hg_size_t));
+        HG_CHECK_ERROR(
+            hg_bulk_crc_op->crcs == NULL || hg_bulk_crc_op->missing == NULL,
+            error, ret, HG_NOMEM, "Could not allocate CRC table");
+        memcpy(hg_bulk_crc_op->crcs, crcs,
+            hg_bulk_crc_op->count * sizeof(hg_uint32_t));
+        for (i = 0; i < hg_bulk_crc_op->count; i++)
+            hg_bulk_crc_op->missing[i] = (i + 1 < hg_bulk_crc_op->count)
+                                             ? chunk_size
+                                             : size - i * chunk_size;
+    }
+
+    ret = HG_Bulk_transfer_progressive(context, hg_bulk_crc_transfer_cb,
+        hg_bulk_crc_op, hg_bulk_crc_chunk_cb, hg_bulk_crc_op, HG_BULK_PULL,
+        origin_addr, origin_id, origin_handle, origin_offset, local_handle,
+        local_offset, size, op_id);
+    HG_CHECK_HG_ERROR(error, ret, "Could not start transfer");
+
+    return HG_SUCCESS;
+
+error:
+    if (hg_bulk_crc_op)
+        hg_bulk_crc_op_free(hg_bulk_crc_op);
+
+    return ret;
+}
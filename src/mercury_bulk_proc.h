@@ -52,6 +52,31 @@ HG_PRIVATE void
 hg_bulk_set_serialize_cached_ptr(
     hg_bulk_t handle, void *buf, na_size_t buf_size);
 
+/**
+ * Set size of single-segment handle. Size cannot exceed the size that the
+ * handle was created with, this allows registered buffers to be re-used for
+ * payloads of different sizes.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_set_size(hg_bulk_t handle, hg_size_t size);
+
+/**
+ * Deserialize bulk handle without copying eager data, segments point directly
+ * to \buf, which must remain valid until hg_bulk_release_eager_ref() is called.
+ * Handles without eager data may be shared through the remote handle cache.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_deserialize_eager_ref(hg_class_t *hg_class, hg_bulk_t *handle,
+    const void *buf, hg_size_t buf_size);
+
+/**
+ * Release reference to serialization buffer taken by
+ * hg_bulk_deserialize_eager_ref(). If the handle is still referenced after
+ * that point, eager data is copied out of the buffer.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_release_eager_ref(hg_bulk_t handle);
+
 #ifdef __cplusplus
 }
 #endif
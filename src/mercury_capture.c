@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_capture.h"
+#include "mercury_error.h"
+#include "mercury_private.h"
+
+#include "mercury_thread_mutex.h"
+#include "mercury_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#    include <process.h>
+#    define getpid _getpid
+#else
+#    include <unistd.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Size of the stdio buffer of capture files */
+#define HG_CAPTURE_BUF_SIZE (1 << 16)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Capture file */
+struct hg_capture {
+    FILE *file;             /* Capture file */
+    char *buf;              /* stdio buffer */
+    hg_thread_mutex_t lock; /* Serializes records */
+    hg_time_ticks_t start;  /* Ticks at capture start */
+    hg_bool_t failed;       /* Write failed, records are dropped */
+};
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_capture_create(const char *path, struct hg_capture **capture_ptr)
+{
+    struct hg_capture *capture = NULL;
+    struct hg_capture_header header;
+    hg_int64_t wall_time;
+    hg_return_t ret;
+#if defined(HG_UTIL_HAS_TIME_H) && defined(HG_UTIL_HAS_CLOCK_GETTIME)
+    struct timespec wall;
+#endif
+
+    capture = (struct hg_capture *) calloc(1, sizeof(*capture));
+    HG_CHECK_ERROR(capture == NULL, error, ret, HG_NOMEM,
+        "Could not allocate capture");
+    hg_thread_mutex_init(&capture->lock);
+
+    capture->file = fopen(path, "wb");
+    HG_CHECK_ERROR(capture->file == NULL, error, ret, HG_NOENTRY,
+        "Could not open capture file %s", path);
+
+    /* Records are small, let stdio batch them */
+    capture->buf = (char *) malloc(HG_CAPTURE_BUF_SIZE);
+    if (capture->buf)
+        setvbuf(capture->file, capture->buf, _IOFBF, HG_CAPTURE_BUF_SIZE);
+
+#if defined(HG_UTIL_HAS_TIME_H) && defined(HG_UTIL_HAS_CLOCK_GETTIME)
+    clock_gettime(CLOCK_REALTIME, &wall);
+    wall_time = (hg_int64_t) wall.tv_sec * 1000000000LL + wall.tv_nsec;
+#else
+    wall_time = (hg_int64_t) time(NULL) * 1000000000LL;
+#endif
+    capture->start = hg_time_get_ticks();
+
+    memset(&header, 0, sizeof(header));
+    strncpy(header.magic, HG_CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = HG_CAPTURE_VERSION;
+    header.record_size = (hg_uint32_t) sizeof(struct hg_capture_record);
+    header.pid = (hg_uint64_t) getpid();
+    header.time_offset = wall_time;
+    HG_CHECK_ERROR(fwrite(&header, sizeof(header), 1, capture->file) != 1,
+        error, ret, HG_OTHER_ERROR, "Could not write capture header");
+
+    *capture_ptr = capture;
+
+    return HG_SUCCESS;
+
+error:
+    hg_capture_destroy(capture);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_capture_destroy(struct hg_capture *capture)
+{
+    if (capture == NULL)
+        return;
+
+    if (capture->file) {
+        HG_CHECK_WARNING(fclose(capture->file) != 0,
+            "Could not close capture file, records may be lost");
+    }
+    free(capture->buf);
+    hg_thread_mutex_destroy(&capture->lock);
+    free(capture);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_uint64_t
+hg_capture_time(struct hg_capture *capture, hg_uint64_t ticks)
+{
+    return (ticks > capture->start)
+               ? hg_time_ticks_to_ns(ticks - capture->start)
+               : 0;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_capture_record(
+    struct hg_capture *capture, const struct hg_capture_record *record)
+{
+    hg_thread_mutex_lock(&capture->lock);
+    if (!capture->failed &&
+        fwrite(record, sizeof(*record), 1, capture->file) != 1) {
+        HG_LOG_WARNING("Could not write capture record, capture stopped");
+        capture->failed = HG_TRUE;
+    }
+    hg_thread_mutex_unlock(&capture->lock);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_CAPTURE_H
+#define MERCURY_CAPTURE_H
+
+#include "mercury_types.h"
+
+/* Workload capture files (see hg_init_info.capture_file) record the shape of
+ * the RPCs forwarded by a class, one record per forward that completed, so
+ * that the same arrival pattern and sizes can later be replayed against a
+ * test server (see the hg_replay benchmark). A file starts with a header
+ * followed by fixed-size records in completion order, records are written
+ * in host byte order. Payloads themselves are never recorded. */
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+#define HG_CAPTURE_MAGIC   "HGCAPT"
+#define HG_CAPTURE_VERSION (1)
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/* Capture file header */
+struct hg_capture_header {
+    char magic[8];           /* HG_CAPTURE_MAGIC */
+    hg_uint32_t version;     /* HG_CAPTURE_VERSION */
+    hg_uint32_t record_size; /* Size of a record */
+    hg_uint64_t pid;         /* Process ID */
+    hg_int64_t time_offset;  /* Wall-clock time of capture start (ns) */
+};
+
+/* Forward record */
+struct hg_capture_record {
+    hg_uint64_t time;      /* Forward time since capture start (ns) */
+    hg_uint64_t id;        /* RPC ID */
+    hg_uint64_t bulk_size; /* Memory exposed by bulk handles of input */
+    hg_uint32_t in_size;   /* Encoded input size */
+    hg_uint32_t out_size;  /* Encoded output size (0 if no response) */
+    hg_uint32_t target;    /* Hash of target address */
+    hg_uint32_t duration;  /* Time until completion (us) */
+    hg_uint8_t target_id;  /* Target context ID */
+    hg_uint8_t ret;        /* Return code of forward */
+    hg_uint8_t reserved[6];
+};
+
+#endif /* MERCURY_CAPTURE_H */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_CLASS_PROC_H
+#define MERCURY_CLASS_PROC_H
+
+#include "mercury_types.h"
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Look up key in the class intern table and insert it if it is not already
+ * present. Returned string remains valid until the class is finalized.
+ *
+ * \return Pointer to interned string or NULL if interning is disabled or if
+ * the table is full
+ */
+HG_PRIVATE const char *
+hg_class_intern_key(hg_class_t *hg_class, const char *data, hg_uint32_t len,
+    hg_uint64_t hash);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_CLASS_PROC_H */
@@ -0,0 +1,1020 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_collective.h"
+#include "mercury_error.h"
+#include "mercury_private.h"
+#include "mercury_proc.h"
+
+#include "mercury_atomic.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Size of the buffer used to encode payloads, larger payloads are encoded
+ * into a buffer allocated by the proc */
+#define HG_COLLECTIVE_ENCODE_SIZE (4096)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Opaque sized buffer */
+struct hg_collective_buf {
+    void *buf;        /* Buffer */
+    hg_uint64_t size; /* Buffer size */
+};
+
+/* Relay input */
+struct hg_collective_in {
+    hg_uint64_t id;                  /* Forwarded RPC ID */
+    hg_uint64_t in_struct_size;      /* Size of input structure */
+    hg_uint64_t out_struct_size;     /* Size of output structure */
+    struct hg_collective_buf *addrs; /* Serialized addresses of subtree */
+    struct hg_collective_buf payload; /* Encoded input of forwarded RPC */
+    hg_uint32_t addr_count;          /* Number of addresses in subtree */
+    hg_uint32_t fanout;              /* Number of subtrees per node */
+    hg_uint8_t gather;               /* Collect outputs */
+};
+
+/* Result of one target */
+struct hg_collective_result {
+    struct hg_collective_buf out; /* Encoded output (gather only) */
+    hg_int32_t ret;               /* Return code */
+};
+
+/* Relay output, results are ordered as the subtree addresses */
+struct hg_collective_out {
+    struct hg_collective_result *results; /* Results */
+    hg_uint32_t count;                    /* Number of results */
+};
+
+/* Collective operation, on the origin or on a relaying target */
+struct hg_collective_op {
+    hg_context_t *context;                /* Context */
+    hg_handle_t handle;                   /* Relay handle (NULL on origin) */
+    hg_collective_cb_t callback;          /* Origin callback */
+    void *arg;                            /* Origin callback arg */
+    struct hg_collective_result *results; /* Results of subtree */
+    hg_id_t id;                           /* Forwarded RPC ID */
+    hg_id_t relay_id;                     /* Relay RPC ID */
+    hg_size_t in_struct_size;             /* Size of input structure */
+    hg_size_t out_struct_size;            /* Size of output structure */
+    hg_atomic_int32_t pending;            /* Pending operations */
+    hg_uint32_t count;                    /* Number of results */
+    hg_uint32_t fanout;                   /* Number of subtrees per node */
+    hg_bool_t gather;                     /* Collect outputs */
+};
+
+/* Subtree relayed to a child */
+struct hg_collective_child {
+    struct hg_collective_op *op; /* Parent operation */
+    hg_uint32_t start;           /* Index of first result of subtree */
+    hg_uint32_t count;           /* Number of results of subtree */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Proc of sized buffer.
+ */
+static hg_return_t
+hg_proc_collective_buf(hg_proc_t proc, struct hg_collective_buf *buf);
+
+/**
+ * Proc of relay input.
+ */
+static hg_return_t
+hg_proc_collective_in(hg_proc_t proc, void *data);
+
+/**
+ * Proc of relay output.
+ */
+static hg_return_t
+hg_proc_collective_out(hg_proc_t proc, void *data);
+
+/**
+ * Encode structure with proc callback into a newly allocated buffer.
+ */
+static hg_return_t
+hg_collective_encode(hg_class_t *hg_class, hg_proc_cb_t proc_cb,
+    void *struct_ptr, struct hg_collective_buf *buf);
+
+/**
+ * Decode structure with proc callback from buffer.
+ */
+static hg_return_t
+hg_collective_decode(hg_class_t *hg_class, hg_proc_cb_t proc_cb,
+    const struct hg_collective_buf *buf, void *struct_ptr);
+
+/**
+ * Free data allocated when decoding structure.
+ */
+static void
+hg_collective_free_struct(
+    hg_class_t *hg_class, hg_proc_cb_t proc_cb, void *struct_ptr);
+
+/**
+ * Create operation of \count results.
+ */
+static struct hg_collective_op *
+hg_collective_op_create(hg_context_t *context, hg_id_t id, hg_uint32_t fanout,
+    hg_bool_t gather, hg_size_t in_struct_size, hg_size_t out_struct_size,
+    hg_uint32_t count);
+
+/**
+ * Free operation.
+ */
+static void
+hg_collective_op_free(struct hg_collective_op *op);
+
+/**
+ * Relay payload to subtrees and, on relaying targets, execute RPC locally.
+ * Subtree roots are either given by \addrs or deserialized from
+ * \addr_bufs.
+ */
+static void
+hg_collective_start(struct hg_collective_op *op, const hg_addr_t *addrs,
+    struct hg_collective_buf *addr_bufs, hg_uint32_t addr_count,
+    const struct hg_collective_buf *payload);
+
+/**
+ * Execute RPC on local target.
+ */
+static hg_return_t
+hg_collective_local(
+    struct hg_collective_op *op, const struct hg_collective_buf *payload);
+
+/**
+ * Forward relay request to subtree root.
+ */
+static hg_return_t
+hg_collective_child_forward(struct hg_collective_op *op, hg_uint32_t start,
+    hg_uint32_t count, hg_addr_t addr, struct hg_collective_buf *addr_bufs,
+    const struct hg_collective_buf *payload);
+
+/**
+ * Set return code of a range of results.
+ */
+static void
+hg_collective_fail(struct hg_collective_op *op, hg_uint32_t start,
+    hg_uint32_t count, hg_return_t ret);
+
+/**
+ * Mark one pending operation as done, complete operation after the last one.
+ */
+static void
+hg_collective_op_done(struct hg_collective_op *op);
+
+/**
+ * Complete operation, respond to parent or execute origin callback.
+ */
+static void
+hg_collective_complete(struct hg_collective_op *op);
+
+/**
+ * Complete origin operation.
+ */
+static void
+hg_collective_complete_origin(struct hg_collective_op *op);
+
+/**
+ * Forward callback of local RPC.
+ */
+static hg_return_t
+hg_collective_local_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Forward callback of relay request.
+ */
+static hg_return_t
+hg_collective_child_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Respond callback of relay request.
+ */
+static hg_return_t
+hg_collective_respond_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Relay RPC callback.
+ */
+static hg_return_t
+hg_collective_relay_rpc_cb(hg_handle_t handle);
+
+/**
+ * Forward collective from origin.
+ */
+static hg_return_t
+hg_collective_forward(hg_context_t *context, hg_collective_cb_t callback,
+    void *arg, hg_id_t id, const hg_addr_t *addrs, hg_uint32_t count,
+    hg_uint32_t fanout, void *in_struct, hg_size_t in_struct_size,
+    hg_bool_t gather, hg_size_t out_struct_size);
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_collective_buf(hg_proc_t proc, struct hg_collective_buf *buf)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint64_t(proc, &buf->size);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc buffer size");
+
+    switch (hg_proc_get_op(proc)) {
+        case HG_DECODE:
+            buf->buf = NULL;
+            if (buf->size == 0)
+                break;
+            buf->buf = malloc((size_t) buf->size);
+            HG_CHECK_ERROR(buf->buf == NULL, done, ret, HG_NOMEM,
+                "Could not allocate buffer");
+            ret = hg_proc_bytes(proc, buf->buf, buf->size);
+            HG_CHECK_HG_ERROR(done, ret, "Could not proc buffer");
+            break;
+        case HG_ENCODE:
+        case HG_SIZE:
+            if (buf->size == 0)
+                break;
+            ret = hg_proc_bytes(proc, buf->buf, buf->size);
+            HG_CHECK_HG_ERROR(done, ret, "Could not proc buffer");
+            break;
+        case HG_FREE:
+            free(buf->buf);
+            buf->buf = NULL;
+            break;
+        default:
+            break;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_collective_in(hg_proc_t proc, void *data)
+{
+    struct hg_collective_in *in = (struct hg_collective_in *) data;
+    hg_uint32_t i;
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint64_t(proc, &in->id);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc RPC ID");
+    ret = hg_proc_hg_uint64_t(proc, &in->in_struct_size);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc input size");
+    ret = hg_proc_hg_uint64_t(proc, &in->out_struct_size);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc output size");
+    ret = hg_proc_hg_uint32_t(proc, &in->fanout);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc fanout");
+    ret = hg_proc_hg_uint8_t(proc, &in->gather);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc gather");
+    ret = hg_proc_hg_uint32_t(proc, &in->addr_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc address count");
+
+    if (hg_proc_get_op(proc) == HG_DECODE) {
+        in->addrs = NULL;
+        if (in->addr_count > 0) {
+            in->addrs = (struct hg_collective_buf *) calloc(
+                in->addr_count, sizeof(struct hg_collective_buf));
+            HG_CHECK_ERROR(in->addrs == NULL, done, ret, HG_NOMEM,
+                "Could not allocate addresses");
+        }
+    }
+
+    for (i = 0; i < in->addr_count; i++) {
+        ret = hg_proc_collective_buf(proc, &in->addrs[i]);
+        HG_CHECK_HG_ERROR(done, ret, "Could not proc address");
+    }
+
+    if (hg_proc_get_op(proc) == HG_FREE) {
+        free(in->addrs);
+        in->addrs = NULL;
+    }
+
+    ret = hg_proc_collective_buf(proc, &in->payload);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc payload");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_collective_out(hg_proc_t proc, void *data)
+{
+    struct hg_collective_out *out = (struct hg_collective_out *) data;
+    hg_uint32_t i;
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint32_t(proc, &out->count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc result count");
+
+    if (hg_proc_get_op(proc) == HG_DECODE) {
+        out->results = NULL;
+        if (out->count > 0) {
+            out->results = (struct hg_collective_result *) calloc(
+                out->count, sizeof(struct hg_collective_result));
+            HG_CHECK_ERROR(out->results == NULL, done, ret, HG_NOMEM,
+                "Could not allocate results");
+        }
+    }
+
+    for (i = 0; i < out->count; i++) {
+        ret = hg_proc_hg_int32_t(proc, &out->results[i].ret);
+        HG_CHECK_HG_ERROR(done, ret, "Could not proc return code");
+        ret = hg_proc_collective_buf(proc, &out->results[i].out);
+        HG_CHECK_HG_ERROR(done, ret, "Could not proc output");
+    }
+
+    if (hg_proc_get_op(proc) == HG_FREE) {
+        free(out->results);
+        out->results = NULL;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_collective_encode(hg_class_t *hg_class, hg_proc_cb_t proc_cb,
+    void *struct_ptr, struct hg_collective_buf *buf)
+{
+    hg_proc_t proc = HG_PROC_NULL;
+    void *scratch = NULL;
+    const void *data;
+    hg_return_t ret;
+
+    buf->buf = NULL;
+    buf->size = 0;
+
+    scratch = malloc(HG_COLLECTIVE_ENCODE_SIZE);
+    HG_CHECK_ERROR(
+        scratch == NULL, done, ret, HG_NOMEM, "Could not allocate buffer");
+
+    ret = hg_proc_create_set(hg_class, scratch, HG_COLLECTIVE_ENCODE_SIZE,
+        HG_ENCODE, HG_NOHASH, &proc);
+    HG_CHECK_HG_ERROR(done, ret, "Could not create proc");
+
+    ret = proc_cb(proc, struct_ptr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not encode structure");
+
+    ret = hg_proc_flush(proc);
+    HG_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+    /* Payload is in the proc's buffer if it did not fit */
+    data = hg_proc_get_extra_buf(proc) ? hg_proc_get_extra_buf(proc) : scratch;
+    buf->size = hg_proc_get_size_used(proc);
+    if (buf->size > 0) {
+        buf->buf = malloc((size_t) buf->size);
+        HG_CHECK_ERROR(buf->buf == NULL, done, ret, HG_NOMEM,
+            "Could not allocate buffer");
+        memcpy(buf->buf, data, (size_t) buf->size);
+    }
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(scratch);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_collective_decode(hg_class_t *hg_class, hg_proc_cb_t proc_cb,
+    const struct hg_collective_buf *buf, void *struct_ptr)
+{
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_return_t ret;
+
+    HG_CHECK_ERROR(buf->buf == NULL, done, ret, HG_PROTOCOL_ERROR,
+        "No payload to decode");
+
+    ret = hg_proc_create_set(
+        hg_class, buf->buf, buf->size, HG_DECODE, HG_NOHASH, &proc);
+    HG_CHECK_HG_ERROR(done, ret, "Could not create proc");
+
+    ret = proc_cb(proc, struct_ptr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not decode structure");
+
+    ret = hg_proc_flush(proc);
+    HG_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_collective_free_struct(
+    hg_class_t *hg_class, hg_proc_cb_t proc_cb, void *struct_ptr)
+{
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_return_t ret;
+
+    ret = hg_proc_create_set(hg_class, NULL, 0, HG_FREE, HG_NOHASH, &proc);
+    HG_CHECK_HG_ERROR(done, ret, "Could not create proc");
+
+    ret = proc_cb(proc, struct_ptr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not free structure");
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_collective_op *
+hg_collective_op_create(hg_context_t *context, hg_id_t id, hg_uint32_t fanout,
+    hg_bool_t gather, hg_size_t in_struct_size, hg_size_t out_struct_size,
+    hg_uint32_t count)
+{
+    hg_class_t *hg_class = HG_Context_get_class(context);
+    struct hg_collective_op *op = NULL;
+    hg_bool_t registered = HG_FALSE;
+    hg_return_t ret;
+    hg_uint32_t i;
+
+    op = (struct hg_collective_op *) calloc(1, sizeof(*op));
+    HG_CHECK_ERROR_NORET(op == NULL, error, "Could not allocate operation");
+
+    if (count > 0) {
+        op->results = (struct hg_collective_result *) calloc(
+            count, sizeof(struct hg_collective_result));
+        HG_CHECK_ERROR_NORET(
+            op->results == NULL, error, "Could not allocate results");
+    }
+    for (i = 0; i < count; i++)
+        op->results[i].ret = HG_SUCCESS;
+
+    ret = HG_Registered_name(
+        hg_class, HG_COLLECTIVE_RELAY_NAME, &op->relay_id, &registered);
+    HG_CHECK_ERROR_NORET(ret != HG_SUCCESS || !registered, error,
+        "Relay RPC is not registered");
+
+    op->context = context;
+    op->handle = HG_HANDLE_NULL;
+    op->id = id;
+    op->fanout = fanout;
+    op->gather = gather;
+    op->in_struct_size = in_struct_size;
+    op->out_struct_size = out_struct_size;
+    op->count = count;
+
+    return op;
+
+error:
+    if (op) {
+        free(op->results);
+        free(op);
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_collective_op_free(struct hg_collective_op *op)
+{
+    hg_uint32_t i;
+
+    for (i = 0; i < op->count; i++)
+        free(op->results[i].out.buf);
+    free(op->results);
+    free(op);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_collective_start(struct hg_collective_op *op, const hg_addr_t *addrs,
+    struct hg_collective_buf *addr_bufs, hg_uint32_t addr_count,
+    const struct hg_collective_buf *payload)
+{
+    hg_bool_t local = (op->handle != HG_HANDLE_NULL);
+    hg_uint32_t base = local ? 1 : 0;
+    hg_uint32_t child_count =
+        (addr_count < op->fanout) ? addr_count : op->fanout;
+    hg_uint32_t first = 0, i;
+
+    /* Hold one extra reference until all operations are issued */
+    hg_atomic_init32(&op->pending, (hg_util_int32_t) (child_count + base + 1));
+
+    if (local) {
+        hg_return_t ret = hg_collective_local(op, payload);
+        if (ret != HG_SUCCESS) {
+            hg_collective_fail(op, 0, 1, ret);
+            hg_collective_op_done(op);
+        }
+    }
+
+    /* Split remaining addresses into contiguous subtrees of equal size, the
+     * first address of each subtree being its root */
+    for (i = 0; i < child_count; i++) {
+        hg_uint32_t count =
+            addr_count / child_count + ((i < addr_count % child_count) ? 1 : 0);
+        hg_return_t ret = hg_collective_child_forward(op, base + first, count,
+            addrs ? addrs[first] : HG_ADDR_NULL, &addr_bufs[first], payload);
+        if (ret != HG_SUCCESS) {
+            hg_collective_fail(op, base + first, count, ret);
+            hg_collective_op_done(op);
+        }
+        first += count;
+    }
+
+    hg_collective_op_done(op);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_collective_local(
+    struct hg_collective_op *op, const struct hg_collective_buf *payload)
+{
+    hg_class_t *hg_class = HG_Context_get_class(op->context);
+    hg_proc_cb_t in_proc_cb = NULL;
+    hg_bool_t registered = HG_FALSE, decoded = HG_FALSE;
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    void *in_struct = NULL;
+    hg_return_t ret;
+
+    ret = HG_Registered_proc_cb(
+        hg_class, op->id, &registered, &in_proc_cb, NULL);
+    HG_CHECK_HG_ERROR(done, ret, "Could not get proc callbacks");
+    HG_CHECK_ERROR(!registered || in_proc_cb == NULL, done, ret, HG_NOENTRY,
+        "RPC ID %llu is not registered with an input proc",
+        (unsigned long long) op->id);
+
+    in_struct = calloc(1, (size_t) op->in_struct_size);
+    HG_CHECK_ERROR(in_struct == NULL, done, ret, HG_NOMEM,
+        "Could not allocate input structure");
+
+    ret = hg_collective_decode(hg_class, in_proc_cb, payload, in_struct);
+    HG_CHECK_HG_ERROR(done, ret, "Could not decode payload");
+    decoded = HG_TRUE;
+
+    ret = HG_Addr_self(hg_class, &self_addr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not get self address");
+
+    ret = HG_Create(op->context, self_addr, op->id, &handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not create handle");
+
+    /* Input is encoded before HG_Forward() returns */
+    ret = HG_Forward(handle, hg_collective_local_cb, op, in_struct);
+    HG_CHECK_HG_ERROR(done, ret, "Could not forward call");
+    handle = HG_HANDLE_NULL;
+
+done:
+    if (handle != HG_HANDLE_NULL)
+        HG_Destroy(handle);
+    if (self_addr != HG_ADDR_NULL)
+        HG_Addr_free(hg_class, self_addr);
+    if (decoded)
+        hg_collective_free_struct(hg_class, in_proc_cb, in_struct);
+    free(in_struct);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_collective_child_forward(struct hg_collective_op *op, hg_uint32_t start,
+    hg_uint32_t count, hg_addr_t addr, struct hg_collective_buf *addr_bufs,
+    const struct hg_collective_buf *payload)
+{
+    hg_class_t *hg_class = HG_Context_get_class(op->context);
+    struct hg_collective_child *child = NULL;
+    struct hg_collective_in in;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_bool_t addr_owned = HG_FALSE;
+    hg_return_t ret;
+
+    /* Relaying targets only have serialized addresses */
+    if (addr == HG_ADDR_NULL) {
+        ret = HG_Core_addr_deserialize(hg_class->core_class,
+            (hg_core_addr_t *) &addr, addr_bufs[0].buf, addr_bufs[0].size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not deserialize address");
+        addr_owned = HG_TRUE;
+    }
+
+    child = (struct hg_collective_child *) malloc(sizeof(*child));
+    HG_CHECK_ERROR(
+        child == NULL, done, ret, HG_NOMEM, "Could not allocate child");
+    child->op = op;
+    child->start = start;
+    child->count = count;
+
+    ret = HG_Create(op->context, addr, op->relay_id, &handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not create handle");
+
+    in.id = op->id;
+    in.in_struct_size = op->in_struct_size;
+    in.out_struct_size = op->out_struct_size;
+    in.fanout = op->fanout;
+    in.gather = (hg_uint8_t) op->gather;
+    in.addr_count = count - 1;
+    in.addrs = &addr_bufs[1];
+    in.payload = *payload;
+
+    ret = HG_Forward(handle, hg_collective_child_cb, child, &in);
+    HG_CHECK_HG_ERROR(done, ret, "Could not forward relay request");
+    handle = HG_HANDLE_NULL;
+    child = NULL;
+
+done:
+    if (handle != HG_HANDLE_NULL)
+        HG_Destroy(handle);
+    free(child);
+    if (addr_owned)
+        HG_Addr_free(hg_class, addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_collective_fail(struct hg_collective_op *op, hg_uint32_t start,
+    hg_uint32_t count, hg_return_t ret)
+{
+    hg_uint32_t i;
+
+    for (i = start; i < start + count; i++)
+        op->results[i].ret = (hg_int32_t) ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_collective_op_done(struct hg_collective_op *op)
+{
+    if (hg_atomic_decr32(&op->pending) == 0)
+        hg_collective_complete(op);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_collective_complete(struct hg_collective_op *op)
+{
+    struct hg_collective_out out;
+    hg_return_t ret;
+
+    if (op->handle == HG_HANDLE_NULL) {
+        hg_collective_complete_origin(op);
+        return;
+    }
+
+    out.count = op->count;
+    out.results = op->results;
+
+    ret = HG_Respond(op->handle, hg_collective_respond_cb, op, &out);
+    HG_CHECK_HG_ERROR(error, ret, "Could not respond to relay request");
+
+    return;
+
+error:
+    HG_Destroy(op->handle);
+    hg_collective_op_free(op);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_collective_complete_origin(struct hg_collective_op *op)
+{
+    hg_class_t *hg_class = HG_Context_get_class(op->context);
+    struct hg_collective_cb_info hg_collective_cb_info;
+    hg_proc_cb_t out_proc_cb = NULL;
+    hg_return_t *rets = NULL;
+    char *out_structs = NULL;
+    hg_uint32_t i;
+
+    memset(&hg_collective_cb_info, 0, sizeof(hg_collective_cb_info));
+    hg_collective_cb_info.arg = op->arg;
+    hg_collective_cb_info.ret = HG_SUCCESS;
+    hg_collective_cb_info.count = op->count;
+    hg_collective_cb_info.out_struct_size = op->out_struct_size;
+
+    if (op->count > 0) {
+        rets = (hg_return_t *) malloc(op->count * sizeof(hg_return_t));
+        HG_CHECK_ERROR(rets == NULL, done, hg_collective_cb_info.ret, HG_NOMEM,
+            "Could not allocate return codes");
+    }
+
+    if (op->gather && op->count > 0) {
+        hg_bool_t registered = HG_FALSE;
+
+        HG_Registered_proc_cb(
+            hg_class, op->id, &registered, NULL, &out_proc_cb);
+        out_structs = (char *) calloc(op->count, (size_t) op->out_struct_size);
+        HG_CHECK_ERROR(out_structs == NULL, done, hg_collective_cb_info.ret,
+            HG_NOMEM, "Could not allocate output structures");
+    }
+
+    for (i = 0; i < op->count; i++) {
+        rets[i] = (hg_return_t) op->results[i].ret;
+        if (rets[i] == HG_SUCCESS && out_structs) {
+            void *out_struct = out_structs + i * op->out_struct_size;
+
+            rets[i] = out_proc_cb ? hg_collective_decode(hg_class, out_proc_cb,
+                                        &op->results[i].out, out_struct)
+                                  : HG_NOENTRY;
+            if (rets[i] != HG_SUCCESS)
+                memset(out_struct, 0, (size_t) op->out_struct_size);
+        }
+        if (rets[i] != HG_SUCCESS) {
+            if (hg_collective_cb_info.ret == HG_SUCCESS)
+                hg_collective_cb_info.ret = rets[i];
+            hg_collective_cb_info.failed++;
+        }
+    }
+    hg_collective_cb_info.rets = rets;
+    hg_collective_cb_info.out_structs = out_structs;
+
+done:
+    if (op->callback)
+        op->callback(&hg_collective_cb_info);
+
+    if (out_structs) {
+        for (i = 0; i < op->count; i++)
+            if (rets[i] == HG_SUCCESS)
+                hg_collective_free_struct(hg_class, out_proc_cb,
+                    out_structs + i * op->out_struct_size);
+        free(out_structs);
+    }
+    free(rets);
+    hg_collective_op_free(op);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_collective_local_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_collective_op *op =
+        (struct hg_collective_op *) callback_info->arg;
+    hg_handle_t handle = callback_info->info.forward.handle;
+    hg_return_t ret = callback_info->ret;
+
+    if (ret == HG_SUCCESS && op->gather) {
+        hg_class_t *hg_class = HG_Context_get_class(op->context);
+        hg_proc_cb_t out_proc_cb = NULL;
+        hg_bool_t registered = HG_FALSE;
+        void *out_struct;
+
+        HG_Registered_proc_cb(
+            hg_class, op->id, &registered, NULL, &out_proc_cb);
+        out_struct = calloc(1, (size_t) op->out_struct_size);
+        HG_CHECK_ERROR(out_struct == NULL || out_proc_cb == NULL, done, ret,
+            HG_NOMEM, "Could not allocate output structure");
+
+        /* Re-encode output so that it can be relayed to the origin */
+        ret = HG_Get_output(handle, out_struct);
+        if (ret == HG_SUCCESS) {
+            ret = hg_collective_encode(
+                hg_class, out_proc_cb, out_struct, &op->results[0].out);
+            HG_Free_output(handle, out_struct);
+        }
+        free(out_struct);
+        HG_CHECK_HG_ERROR(done, ret, "Could not get output");
+    }
+
+done:
+    hg_collective_fail(op, 0, 1, ret);
+    HG_Destroy(handle);
+    hg_collective_op_done(op);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_collective_child_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_collective_child *child =
+        (struct hg_collective_child *) callback_info->arg;
+    struct hg_collective_op *op = child->op;
+    hg_handle_t handle = callback_info->info.forward.handle;
+    struct hg_collective_out out;
+    hg_return_t ret = callback_info->ret;
+    hg_uint32_t i;
+
+    HG_CHECK_HG_ERROR(done, ret, "Relay request failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Get_output(handle, &out);
+    HG_CHECK_HG_ERROR(done, ret, "Could not get relay output");
+
+    if (out.count == child->count) {
+        /* Take ownership of encoded outputs */
+        for (i = 0; i < out.count; i++) {
+            op->results[child->start + i] = out.results[i];
+            out.results[i].out.buf = NULL;
+        }
+    } else
+        ret = HG_PROTOCOL_ERROR;
+    HG_Free_output(handle, &out);
+    HG_CHECK_HG_ERROR(done, ret, "Relay returned %u results, expected %u",
+        out.count, child->count);
+
+done:
+    if (ret != HG_SUCCESS)
+        hg_collective_fail(op, child->start, child->count, ret);
+    HG_Destroy(handle);
+    free(child);
+    hg_collective_op_done(op);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_collective_respond_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_collective_op *op =
+        (struct hg_collective_op *) callback_info->arg;
+
+    HG_Destroy(op->handle);
+    hg_collective_op_free(op);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_collective_relay_rpc_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    struct hg_collective_op *op = NULL;
+    struct hg_collective_in in;
+    hg_return_t ret;
+
+    ret = HG_Get_input(handle, &in);
+    HG_CHECK_HG_ERROR(error, ret, "Could not get relay input");
+
+    op = hg_collective_op_create(hg_info->context, in.id, in.fanout,
+        (hg_bool_t) in.gather, in.in_struct_size, in.out_struct_size,
+        in.addr_count + 1);
+    if (op == NULL) {
+        HG_Free_input(handle, &in);
+        HG_GOTO_ERROR(error, ret, HG_NOMEM, "Could not create operation");
+    }
+    op->handle = handle;
+
+    /* Payload and addresses are re-encoded by the time relaying returns */
+    hg_collective_start(op, NULL, in.addrs, in.addr_count, &in.payload);
+
+    HG_Free_input(handle, &in);
+
+    return HG_SUCCESS;
+
+error:
+    {
+        struct hg_collective_out out = {NULL, 0};
+
+        /* Empty result set is reported as an error by the parent */
+        ret = HG_Respond(handle, NULL, NULL, &out);
+        HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not respond");
+        HG_Destroy(handle);
+    }
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_collective_forward(hg_context_t *context, hg_collective_cb_t callback,
+    void *arg, hg_id_t id, const hg_addr_t *addrs, hg_uint32_t count,
+    hg_uint32_t fanout, void *in_struct, hg_size_t in_struct_size,
+    hg_bool_t gather, hg_size_t out_struct_size)
+{
+    struct hg_collective_buf payload = {NULL, 0};
+    struct hg_collective_buf *addr_bufs = NULL;
+    struct hg_collective_op *op = NULL;
+    hg_proc_cb_t in_proc_cb = NULL, out_proc_cb = NULL;
+    hg_bool_t registered = HG_FALSE;
+    hg_class_t *hg_class;
+    hg_return_t ret;
+    hg_uint32_t i;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
+    HG_CHECK_ERROR(count > 0 && addrs == NULL, done, ret, HG_INVALID_ARG,
+        "NULL address array");
+    HG_CHECK_ERROR(in_struct_size == 0, done, ret, HG_INVALID_ARG,
+        "Input structure size must be non-zero");
+    HG_CHECK_ERROR(gather && out_struct_size == 0, done, ret, HG_INVALID_ARG,
+        "Output structure size must be non-zero");
+    hg_class = HG_Context_get_class(context);
+
+    ret = HG_Registered_proc_cb(
+        hg_class, id, &registered, &in_proc_cb, &out_proc_cb);
+    HG_CHECK_HG_ERROR(done, ret, "Could not get proc callbacks");
+    HG_CHECK_ERROR(!registered || in_proc_cb == NULL ||
+                       (gather && out_proc_cb == NULL),
+        done, ret, HG_NOENTRY, "RPC ID %llu is not registered",
+        (unsigned long long) id);
+
+    op = hg_collective_op_create(context, id,
+        fanout ? fanout : HG_COLLECTIVE_FANOUT_DEFAULT, gather, in_struct_size,
+        out_struct_size, count);
+    HG_CHECK_ERROR(
+        op == NULL, done, ret, HG_NOMEM, "Could not create operation");
+    op->callback = callback;
+    op->arg = arg;
+
+    /* Encode input once, relaying targets pass it along unchanged */
+    ret = hg_collective_encode(hg_class, in_proc_cb, in_struct, &payload);
+    HG_CHECK_HG_ERROR(done, ret, "Could not encode input");
+
+    /* Serialize addresses so that relaying targets can forward to them */
+    if (count > 0) {
+        addr_bufs = (struct hg_collective_buf *) calloc(
+            count, sizeof(struct hg_collective_buf));
+        HG_CHECK_ERROR(addr_bufs == NULL, done, ret, HG_NOMEM,
+            "Could not allocate addresses");
+    }
+    for (i = 0; i < count; i++) {
+        addr_bufs[i].size = HG_Core_addr_get_serialize_size(
+            (hg_core_addr_t) addrs[i], 0);
+        addr_bufs[i].buf = malloc((size_t) addr_bufs[i].size);
+        HG_CHECK_ERROR(addr_bufs[i].buf == NULL, done, ret, HG_NOMEM,
+            "Could not allocate address");
+        ret = HG_Core_addr_serialize(addr_bufs[i].buf, addr_bufs[i].size, 0,
+            (hg_core_addr_t) addrs[i]);
+        if (ret == HG_OPNOTSUPPORTED) {
+            /* Targets cannot relay without serialized addresses, forward to
+             * all of them directly instead */
+            op->fanout = count;
+            ret = HG_SUCCESS;
+            break;
+        }
+        HG_CHECK_HG_ERROR(done, ret, "Could not serialize address");
+    }
+
+    hg_collective_start(op, addrs, addr_bufs, count, &payload);
+    op = NULL;
+
+done:
+    if (op)
+        hg_collective_op_free(op);
+    if (addr_bufs) {
+        for (i = 0; i < count; i++)
+            free(addr_bufs[i].buf);
+        free(addr_bufs);
+    }
+    free(payload.buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_collective_register(hg_class_t *hg_class)
+{
+    hg_bool_t registered = HG_FALSE;
+    hg_return_t ret;
+
+    HG_Register_name(hg_class, HG_COLLECTIVE_RELAY_NAME, hg_proc_collective_in,
+        hg_proc_collective_out, hg_collective_relay_rpc_cb);
+
+    ret = HG_Registered_name(
+        hg_class, HG_COLLECTIVE_RELAY_NAME, NULL, &registered);
+    HG_CHECK_HG_ERROR(done, ret, "Could not check for relay RPC");
+    HG_CHECK_ERROR(
+        !registered, done, ret, HG_FAULT, "Could not register relay RPC");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Forward_bcast(hg_context_t *context, hg_collective_cb_t callback,
+    void *arg, hg_id_t id, const hg_addr_t *addrs, hg_uint32_t count,
+    hg_uint32_t fanout, void *in_struct, hg_size_t in_struct_size)
+{
+    return hg_collective_forward(context, callback, arg, id, addrs, count,
+        fanout, in_struct, in_struct_size, HG_FALSE, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Forward_gather(hg_context_t *context, hg_collective_cb_t callback,
+    void *arg, hg_id_t id, const hg_addr_t *addrs, hg_uint32_t count,
+    hg_uint32_t fanout, void *in_struct, hg_size_t in_struct_size,
+    hg_size_t out_struct_size)
+{
+    return hg_collective_forward(context, callback, arg, id, addrs, count,
+        fanout, in_struct, in_struct_size, HG_TRUE, out_struct_size);
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_COLLECTIVE_H
+#define MERCURY_COLLECTIVE_H
+
+#include "mercury.h"
+
+/* Collective operations forward an RPC to a set of targets through a k-ary
+ * tree: the origin sends the request to the roots of up to k subtrees, each
+ * root executes the RPC locally and relays the request to the roots of its
+ * own subtrees. Results are aggregated on the way back so that the origin
+ * gets a single completion. Targets must be initialized by HG_Init_opt()
+ * (which registers the internal relay RPC) and must have registered the
+ * forwarded RPC with its input/output proc callbacks. */
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/* Collective callback info */
+struct hg_collective_cb_info {
+    void *arg;                 /* User data */
+    hg_return_t ret;           /* First error returned by a target */
+    hg_uint32_t count;         /* Number of targets */
+    hg_uint32_t failed;        /* Number of targets that failed */
+    const hg_return_t *rets;   /* Return code of each target */
+    void *out_structs;         /* Output of each target (gather only) */
+    hg_size_t out_struct_size; /* Size of output structures */
+};
+
+typedef hg_return_t (*hg_collective_cb_t)(
+    const struct hg_collective_cb_info *callback_info);
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/* Default number of subtrees each node relays to */
+#define HG_COLLECTIVE_FANOUT_DEFAULT (4)
+
+/* Name of the internal relay RPC */
+#define HG_COLLECTIVE_RELAY_NAME "__hg_collective_relay"
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Forward RPC \id with input \in_struct to \count targets through a tree of
+ * relaying targets. Each node relays the request to at most \fanout
+ * subtrees so that the request reaches all targets after O(log N) hops.
+ * \callback is executed once all targets have completed, with the return
+ * code of each target ordered as \addrs. If the NA plugin cannot serialize
+ * addresses, the origin forwards to all targets directly.
+ * \remark Input structures must not reference memory local to the origin
+ * other than through bulk handles.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param id [IN]               registered function ID
+ * \param addrs [IN]            array of target addresses
+ * \param count [IN]            number of targets
+ * \param fanout [IN]           number of subtrees per node (0 for default)
+ * \param in_struct [IN]        pointer to input structure
+ * \param in_struct_size [IN]   size of input structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_bcast(hg_context_t *context, hg_collective_cb_t callback,
+    void *arg, hg_id_t id, const hg_addr_t *addrs, hg_uint32_t count,
+    hg_uint32_t fanout, void *in_struct, hg_size_t in_struct_size);
+
+/**
+ * Same as HG_Forward_bcast() but also collect the output of each target.
+ * Outputs are passed to \callback as an array of \count structures of size
+ * \out_struct_size ordered as \addrs, outputs of targets that failed are
+ * zeroed. Outputs are freed once \callback returns.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param id [IN]               registered function ID
+ * \param addrs [IN]            array of target addresses
+ * \param count [IN]            number of targets
+ * \param fanout [IN]           number of subtrees per node (0 for default)
+ * \param in_struct [IN]        pointer to input structure
+ * \param in_struct_size [IN]   size of input structure
+ * \param out_struct_size [IN]  size of output structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_gather(hg_context_t *context, hg_collective_cb_t callback,
+    void *arg, hg_id_t id, const hg_addr_t *addrs, hg_uint32_t count,
+    hg_uint32_t fanout, void *in_struct, hg_size_t in_struct_size,
+    hg_size_t out_struct_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_COLLECTIVE_H */
@@ -11,24 +11,31 @@
 #include "mercury_core.h"
 #include "mercury_private.h"
 
-#include "mercury_atomic_queue.h"
+#include "mercury_atomic_seg_queue.h"
 #include "mercury_error.h"
 #include "mercury_event.h"
+#include "mercury_hash_string.h"
 #include "mercury_hash_table.h"
+#include "mercury_histogram.h"
 #include "mercury_list.h"
 #include "mercury_mem.h"
 #include "mercury_poll.h"
+#include "mercury_probe.h"
 #include "mercury_queue.h"
+#include "mercury_thread.h"
 #include "mercury_thread_condition.h"
 #include "mercury_thread_mutex.h"
 #include "mercury_thread_pool.h"
 #include "mercury_thread_spin.h"
 #include "mercury_time.h"
+#include "mercury_timer_wheel.h"
+#include "mercury_trace.h"
 
 #ifdef NA_HAS_SM
 #    include <na_sm.h>
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -37,22 +44,102 @@
 /****************/
 
 /* Private flags */
+#define HG_CORE_CHUNK        (1 << 2) /* Response chunk, more follow */
 #define HG_CORE_SELF_FORWARD (1 << 3) /* Forward to self */
+#define HG_CORE_COALESCED    (1 << 4) /* Coalesced requests */
+#define HG_CORE_BIG_ENDIAN   (1 << 5) /* Payload in big-endian byte order */
 
-/* Size of comletion queue used for holding completed requests */
+/* Byte order flag of local payloads */
+#define HG_CORE_BYTE_ORDER (hg_core_is_big_endian() ? HG_CORE_BIG_ENDIAN : 0)
+
+/* Payload was encoded with a byte order that differs from the local one */
+#define HG_CORE_IS_SWAPPED(flags)                                              \
+    (((flags) & HG_CORE_BIG_ENDIAN) != HG_CORE_BYTE_ORDER)
+
+/* Tag of completion queue entries that are NA completions (integrated
+ * completion mode), NA completion data is always at least pointer-aligned */
+#define HG_CORE_NA_ENTRY ((uintptr_t) 1)
+
+/* Completion queue entry that stands for the next request of the fair-share
+ * scheduler of its lane */
+#define HG_CORE_FAIR_ENTRY ((void *) 2)
+
+/* Size of comletion queue segments used for holding completed requests */
 #define HG_CORE_ATOMIC_QUEUE_SIZE (1024)
 
+/* Initial number of entries in function map (must be a power of 2) */
+#define HG_CORE_FUNC_MAP_INIT_SIZE (64)
+
+/* Initial number of entries in dense RPC table */
+#define HG_CORE_RPC_TABLE_INIT_SIZE (64)
+
+/* Max number of handles kept per context for re-use */
+#define HG_CORE_HANDLE_POOL_MAX (256)
+
 /* Pre-posted requests and op IDs */
 #define HG_CORE_POST_INIT          (256)
 #define HG_CORE_POST_INCR          (256)
 #define HG_CORE_BULK_OP_INIT_COUNT (256)
 
+/* Adaptive posting: max increment reached by doubling during bursts and
+ * interval (ms) over which the number of unused posted requests is observed
+ * before trimming */
+#define HG_CORE_POST_INCR_MAX      (16384)
+#define HG_CORE_POST_TRIM_INTERVAL (1000)
+
+/* Lazy posting: requests posted on context post */
+#define HG_CORE_POST_LAZY_INIT (16)
+
 /* Timeout on finalize */
 #define HG_CORE_CLEANUP_TIMEOUT (1000)
 
 /* Max number of events for progress */
-#define HG_CORE_MAX_EVENTS        (1)
-#define HG_CORE_MAX_TRIGGER_COUNT (1)
+#define HG_CORE_MAX_EVENTS        (16)
+#define HG_CORE_MAX_TRIGGER_COUNT (16)
+
+/* Adaptive polling: number of non-blocking polls made after events were
+ * recently seen before falling back to blocking waits. Budget is doubled
+ * when busy polling finds events and halved when it does not. */
+#define HG_CORE_POLL_SPIN_MIN (16)
+#define HG_CORE_POLL_SPIN_MAX (4096)
+
+/* SM rail is considered idle after HG_CORE_SM_IDLE_THRESHOLD non-blocking
+ * polls without progress, it is then only polled every
+ * HG_CORE_SM_IDLE_INTERVAL passes until SM operations are posted again */
+#define HG_CORE_SM_IDLE_THRESHOLD (64)
+#define HG_CORE_SM_IDLE_INTERVAL  (32)
+
+/* Max number of completion entries dequeued at once by trigger_batch */
+#define HG_CORE_TRIGGER_BATCH_SIZE (64)
+
+/* Every HG_CORE_PRIORITY_QUOTA dequeues, trigger starts from a rotating
+ * priority lane instead of the highest one so that lower priorities are not
+ * starved */
+#define HG_CORE_PRIORITY_QUOTA (8)
+
+/* Number of origin buckets (power of 2) of fair-share schedulers and bytes of
+ * requests that a bucket may dispatch per round */
+#define HG_CORE_FAIR_BUCKETS (64)
+#define HG_CORE_FAIR_QUANTUM (256)
+
+/* Timeout (ms) after which progress threads check whether they must exit */
+#define HG_CORE_PROGRESS_THREAD_TIMEOUT (100)
+
+/* Max length of a line in the address cache file */
+#define HG_CORE_ADDR_CACHE_LINE_MAX (4096)
+
+/* Header tag of serialized address batches ("HGAB") */
+#define HG_CORE_ADDR_BATCH_MAGIC (0x48474142)
+
+/* Default min size of self bulk transfers offloaded to copy threads */
+#define HG_CORE_BULK_SELF_OFFLOAD_SIZE (1 << 20)
+
+/* Number of request tags that a context takes from the class at once */
+#define HG_CORE_REQUEST_TAG_BLOCK (1024)
+
+/* Number of stat shards (power of 2), threads are assigned shards
+ * round-robin so that counters are rarely updated by several threads */
+#define HG_CORE_STATS_SHARDS (16)
 
 #ifdef NA_HAS_SM
 /* Addr string format */
@@ -64,6 +151,9 @@
 #    define HG_CORE_MIN(a, b) (a < b) ? a : b
 #endif
 
+/* Max macro */
+#define HG_CORE_MAX(a, b) (((a) > (b)) ? (a) : (b))
+
 /* Op status bits */
 #define HG_CORE_OP_COMPLETED (1 << 0)
 #define HG_CORE_OP_CANCELED  (1 << 1)
@@ -97,20 +187,6 @@
 #define HG_CORE_DECODE(label, ret, buf_ptr, buf_size_left, data, type)         \
     HG_CORE_TYPE_DECODE(label, ret, buf_ptr, buf_size_left, data, sizeof(type))
 
-/* Map stat type to either 32-bit atomic or 64-bit */
-#ifdef HG_HAS_COLLECT_STATS
-#    ifndef HG_UTIL_HAS_OPA_PRIMITIVES_H
-typedef hg_atomic_int64_t hg_core_stat_t;
-#        define hg_core_stat_incr hg_atomic_incr64
-#        define hg_core_stat_get  hg_atomic_get64
-#    else
-typedef hg_atomic_int32_t hg_core_stat_t;
-#        define hg_core_stat_incr hg_atomic_incr32
-#        define hg_core_stat_get  hg_atomic_get32
-#    endif
-#    define HG_CORE_STAT_INIT HG_ATOMIC_VAR_INIT
-#endif
-
 /* Private accessors */
 #define HG_CORE_CONTEXT_CLASS(context)                                         \
     ((struct hg_core_private_class *) (context->core_context.core_class))
@@ -127,28 +203,138 @@ typedef hg_atomic_int32_t hg_core_stat_t;
 /* Local Type and Struct Definition */
 /************************************/
 
+/* Stat counters */
+typedef enum {
+    HG_CORE_STAT_FORWARD,   /* Requests forwarded */
+    HG_CORE_STAT_HANDLE,    /* Requests received */
+    HG_CORE_STAT_EXTRA,     /* Messages with extra payload */
+    HG_CORE_STAT_BYTES_IN,  /* Bytes of requests received */
+    HG_CORE_STAT_BYTES_OUT, /* Bytes of requests and responses sent */
+    HG_CORE_STAT_BULK,      /* Bulk transfers (class only) */
+    HG_CORE_STAT_REJECT,    /* Requests rejected by admission control */
+    HG_CORE_STAT_MAX
+} hg_core_stat_t;
+
+/* Stat counters of a shard, each shard has its own cache line */
+struct hg_core_stats_shard {
+    hg_atomic_int64_t counters[HG_CORE_STAT_MAX];
+} __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE)));
+
+/* Sharded stat counters, readers sum up all shards */
+struct hg_core_stats {
+    struct hg_core_stats_shard shards[HG_CORE_STATS_SHARDS];
+    struct hg_histogram *latency; /* Latency histograms (NULL if disabled) */
+};
+
+/* Latency stamps of a handle */
+typedef enum {
+    HG_CORE_STAMP_FORWARD,  /* Forward issued (origin) */
+    HG_CORE_STAMP_SENT,     /* Request sent (origin) */
+    HG_CORE_STAMP_RECV,     /* Response received (origin) */
+    HG_CORE_STAMP_RECEIVED, /* Request received (target) */
+    HG_CORE_STAMP_DISPATCH, /* Handler dispatched (target) */
+    HG_CORE_STAMP_MAX
+} hg_core_stamp_t;
+
+#define HG_CORE_STAMP_BIT(stamp) ((hg_uint8_t)(1 << (stamp)))
+
+/* Function map entry */
+struct hg_core_func_map_entry {
+    hg_atomic_int64_t rpc_info; /* RPC info (NULL if deregistered) */
+    hg_id_t id;                 /* RPC ID, set once before used */
+    hg_atomic_int32_t used;     /* Entry in use */
+};
+
+/* Function map, open addressing hash table with lock-free lookups. Entries
+ * are never moved once used, tables are replaced by larger copies when
+ * growing and previous tables are kept until the class is finalized. */
+struct hg_core_func_map {
+    struct hg_core_func_map_entry *entries; /* Table entries */
+    struct hg_core_func_map *prev;          /* Previous (retired) table */
+    unsigned int mask;                      /* Number of entries - 1 */
+    unsigned int count;                     /* Number of entries used */
+};
+
+/* Dense RPC table, RPCs are given the index of their entry + 1 when they are
+ * first registered so that requests can be dispatched without hashing. Tables
+ * are replaced by larger copies when growing and previous tables are kept
+ * until the class is finalized. */
+struct hg_core_rpc_table {
+    hg_atomic_int64_t *entries;     /* RPC info (NULL if deregistered) */
+    struct hg_core_rpc_table *prev; /* Previous (retired) table */
+    unsigned int size;              /* Number of entries */
+};
+
+/* RPC index learned from target */
+struct hg_core_rpc_index_entry {
+    hg_id_t id;        /* RPC ID (key) */
+    hg_uint16_t index; /* Index of RPC in target table */
+};
+
 /* HG class */
 struct hg_core_private_class {
     struct hg_core_class core_class; /* Must remain as first field */
 #ifdef NA_HAS_SM
     na_sm_id_t host_id; /* Host ID for local identification */
 #endif
-    hg_hash_table_t *func_map; /* Function map */
+    hg_atomic_int64_t func_map; /* Function map (struct hg_core_func_map) */
+    hg_atomic_int64_t rpc_table; /* RPC table (struct hg_core_rpc_table) */
+    unsigned int rpc_table_count; /* Number of RPC table entries used */
     hg_return_t (*more_data_acquire)(hg_core_handle_t, hg_op_t,
         hg_return_t (*done_callback)(hg_core_handle_t)); /* more_data_acquire */
     void (*more_data_release)(hg_core_handle_t);         /* more_data_release */
     na_tag_t request_max_tag;                            /* Max value for tag */
+    na_tag_t request_tag_block;                          /* Tags per block */
+    na_uint32_t request_tag_block_count;                 /* Number of blocks */
     hg_atomic_int32_t n_contexts;   /* Atomic used for number of contexts */
     hg_atomic_int32_t n_addrs;      /* Atomic used for number of addrs */
-    hg_atomic_int32_t request_tag;  /* Atomic used for tag generation */
-    hg_thread_spin_t func_map_lock; /* Function map lock */
+    hg_atomic_int32_t request_tag;  /* Last tag block given to a context */
+    hg_thread_spin_t func_map_lock; /* Function map writer lock */
     na_uint32_t progress_mode;      /* NA progress mode */
     hg_uint32_t request_post_init;  /* Init count of posted requests */
     hg_uint32_t request_post_incr;  /* Incr count of posted requests */
+    hg_uint16_t request_post_shared; /* Contexts sharing posted requests */
+    hg_bool_t request_post_adaptive; /* Grow/trim posted requests */
+    hg_bool_t request_post_lazy;     /* Post base set and grow on demand */
+    hg_uint32_t request_credits;     /* Max requests in flight per target */
+    hg_bool_t load_feedback;         /* Advertise load in responses */
+    hg_uint32_t admit_queue_max;     /* Max queued completions */
+    hg_uint32_t admit_active_max;    /* Max requests being processed */
+    hg_bool_t fair_share;            /* Dispatch requests fairly */
+    hg_uint32_t prealloc_count;      /* Objects preallocated per context */
+    hg_atomic_int32_t select_seed;   /* Seed of target selection */
+    hg_size_t mem_post_limit;        /* Memory limit of additional posts */
+    hg_size_t mem_hard_limit;        /* Memory limit of overflow payloads */
+    hg_uint32_t request_coalesce_count; /* Max count of coalesced requests */
+    hg_uint32_t request_coalesce_time;  /* Max delay of coalesced requests */
+    hg_hash_table_t *addr_cache;        /* Lookup cache (name -> addr) */
+    hg_thread_mutex_t addr_cache_mutex; /* Lookup cache mutex */
+    char *addr_cache_file;              /* Lookup cache warm-start file */
+    hg_uint32_t addr_cache_ttl;         /* Lookup cache TTL (ms) */
+    hg_uint32_t addr_cache_neg_ttl;     /* Lookup cache negative TTL (ms) */
+    hg_size_t bulk_chunk_size;          /* Max size of bulk RMA operations */
+    hg_uint32_t bulk_max_inflight;      /* Max bulk RMA ops in flight */
+    hg_thread_pool_t *bulk_self_pool;   /* Self bulk copy threads */
+    hg_uint32_t bulk_self_thread_count; /* Number of self bulk copy threads */
+    hg_size_t bulk_self_offload_size;   /* Min size of offloaded copies */
+    struct hg_bulk_mem_pool *bulk_mem_pool; /* Pool of registered memory */
+    struct hg_bulk_cache *bulk_cache;   /* Cache of remote bulk handles */
+    hg_thread_key_t trigger_slot_key;   /* Slot of NA entry being triggered */
+    struct hg_core_stats *stats;        /* Class stat counters */
+    hg_thread_key_t stats_shard_key;    /* Stat shard of thread (index + 1) */
+    hg_atomic_int32_t stats_shard_next; /* Next stat shard assigned */
+    hg_bool_t latency_stats;            /* Collect latency histograms */
+    struct hg_trace *trace;             /* Trace (NULL if disabled) */
+    struct hg_core_hooks hooks;         /* Instrumentation hooks */
+    hg_atomic_int64_t trace_next_id;    /* Last handle trace ID */
+    hg_bool_t integrated_completion;    /* NA completes into HG queues */
+    hg_uint8_t shard_count;             /* Number of RPC service shards */
     hg_bool_t na_ext_init;          /* NA externally initialized */
     hg_bool_t loopback;             /* Able to self forward */
+    hg_bool_t loopback_inline;      /* Execute self forwards inline */
+    hg_bool_t compact_header;       /* Send compact request headers */
 #ifdef HG_HAS_COLLECT_STATS
-    hg_bool_t stats; /* (Debug) Print stats at exit */
+    hg_bool_t print_stats; /* (Debug) Print stats on finalize */
 #endif
 };
 
@@ -158,21 +344,65 @@ typedef enum hg_core_poll_type {
 #ifdef NA_HAS_SM
     HG_CORE_POLL_SM,
 #endif
-    HG_CORE_POLL_NA
+    HG_CORE_POLL_NA,
+    HG_CORE_POLL_RAIL /* First rail, followed by other rails */
 } hg_core_poll_type_t;
 
+/* List of handles */
+HG_LIST_HEAD_DECL(hg_core_handle_list, hg_core_private_handle);
+
+/* List of coalesced request batches */
+HG_LIST_HEAD_DECL(hg_core_coalesce_list, hg_core_coalesce_batch);
+
+/* Deficit round-robin bucket of requests received from a set of origins */
+struct hg_core_fair_bucket {
+    HG_QUEUE_HEAD(hg_core_private_handle) queue; /* Requests to dispatch */
+    HG_QUEUE_ENTRY(hg_core_fair_bucket) active;  /* Active list entry */
+    hg_size_t deficit;                           /* Bytes left this round */
+};
+
+/* Fair-share scheduler of a completion lane */
+struct hg_core_fair_sched {
+    struct hg_core_fair_bucket buckets[HG_CORE_FAIR_BUCKETS]; /* Buckets */
+    HG_QUEUE_HEAD(hg_core_fair_bucket) active_list; /* Non-empty buckets */
+    hg_thread_spin_t lock;                          /* Scheduler lock */
+};
+
 /* HG context */
+/* Requests posted for one NA class, pending count is updated without locks
+ * when requests are received and reposted, other fields are updated under the
+ * pending list lock and read as hints */
+struct hg_core_post_pool {
+    hg_time_t window_start;          /* Start of current observation window */
+    hg_atomic_int32_t pending_count; /* Requests currently posted */
+    unsigned int posted_count;       /* Requests owned by the pool */
+    unsigned int low_water;          /* Min pending count over window */
+    unsigned int min_count;     /* Requests posted on context post */
+    unsigned int next_incr;     /* Next number of requests to add */
+};
+
 struct hg_core_private_context {
     struct hg_core_context core_context;      /* Must remain as first field */
     hg_thread_cond_t completion_queue_cond;   /* Completion queue cond */
     hg_thread_mutex_t completion_queue_mutex; /* Completion queue mutex */
-    hg_thread_mutex_t completion_queue_notify_mutex;   /* Notify mutex */
-    HG_QUEUE_HEAD(hg_completion_entry) backfill_queue; /* Backfill queue */
-    struct hg_atomic_queue *completion_queue;          /* Default queue */
+    struct hg_atomic_seg_queue
+        *completion_queues[HG_PRIORITY_MAX]; /* Completion queue lanes */
+    hg_atomic_int32_t trigger_round;         /* Dequeues (fairness) */
+    struct hg_core_fair_sched *fair_scheds;  /* Per lane (NULL if disabled) */
+#ifdef HG_HAS_DEBUG
     HG_LIST_HEAD(hg_core_private_handle) created_list; /* Created handle list */
-    HG_LIST_HEAD(hg_core_private_handle) pending_list; /* Pending handle list */
+#endif
+    HG_LIST_HEAD(hg_core_private_handle) pending_list; /* Posted handle list */
+#ifdef NA_HAS_SM
+    HG_LIST_HEAD(hg_core_private_handle) sm_pending_list; /* Posted handles */
+#endif
+    struct hg_core_handle_list handle_pool; /* Free handles for re-use */
 #ifdef NA_HAS_SM
-    HG_LIST_HEAD(hg_core_private_handle) sm_pending_list; /* Pending handles */
+    struct hg_core_handle_list sm_handle_pool; /* Free SM handles */
+#endif
+    struct hg_core_post_pool post_pool; /* Posted requests (pending_list) */
+#ifdef NA_HAS_SM
+    struct hg_core_post_pool sm_post_pool; /* Posted SM requests */
 #endif
     hg_return_t (*handle_create)(hg_core_handle_t, void *); /* Create cb */
     void *handle_create_arg;                                /* Create args */
@@ -180,12 +410,51 @@ struct hg_core_private_context {
     struct hg_poll_set *poll_set;                           /* Poll set */
     struct hg_poll_event poll_events[HG_CORE_MAX_EVENTS];   /* Poll events */
     hg_atomic_int32_t completion_queue_must_notify; /* Will notify if set */
-    hg_atomic_int32_t backfill_queue_count;         /* Backfill queue count */
     hg_atomic_int32_t n_handles;                    /* Number of handles */
-    hg_thread_spin_t created_list_lock;             /* Handle list lock */
-    hg_thread_spin_t pending_list_lock;             /* Pending list lock */
+#ifdef HG_HAS_DEBUG
+    hg_thread_spin_t created_list_lock; /* Handle list lock */
+#endif
+    hg_thread_spin_t pending_list_lock; /* Pending list lock */
+    struct hg_core_coalesce_list coalesce_list;     /* Batches being filled */
+    struct hg_core_coalesce_list coalesce_response_list; /* Responses */
+    struct hg_core_coalesce_list coalesce_pool;     /* Batches for re-use */
+    struct hg_core_handle_list coalesce_wait_list;  /* Waiting for response */
+    hg_thread_mutex_t coalesce_mutex;               /* Batch list mutex */
+    hg_atomic_int32_t coalesce_pending;             /* New batches to send */
+    hg_thread_spin_t handle_pool_lock;              /* Handle pool lock */
+    unsigned int handle_pool_count;                 /* Number of free handles */
     int completion_queue_notify;                    /* Self notification */
-    hg_bool_t finalizing;                           /* Prevent reposts */
+    unsigned int poll_spin_max;   /* Current busy poll budget (heuristic) */
+    unsigned int poll_spin_count; /* Remaining busy polls (heuristic) */
+#ifdef NA_HAS_SM
+    hg_atomic_int32_t sm_active; /* SM operations were posted */
+    unsigned int sm_idle_count;  /* SM polls without progress (heuristic) */
+#endif
+    hg_atomic_int32_t progressing;      /* A thread is polling the context */
+    hg_atomic_int32_t progress_waiters; /* Threads waiting for the poller */
+    hg_atomic_int32_t trigger_waiters;  /* Threads waiting in trigger */
+    hg_thread_t *progress_threads;      /* Poller and trigger threads */
+    unsigned int progress_thread_count; /* Number of progress threads */
+    hg_atomic_int32_t progress_threads_exit; /* Progress threads must exit */
+    struct hg_timer_wheel *timer_wheel; /* Deadlines of timed forwards */
+    struct hg_core_private_handle *timer_expired; /* Handles to cancel */
+    struct hg_core_private_handle *timer_delayed; /* Delayed handles to send */
+    hg_thread_spin_t timer_lock;                  /* Timer wheel lock */
+    hg_atomic_int32_t timer_count;                /* Armed timers */
+    hg_atomic_int64_t mem_bytes[HG_MEM_USE_MAX]; /* Memory used per use */
+    hg_atomic_int32_t mem_throttle_count;         /* Denied posts/overflows */
+    hg_atomic_int32_t alloc_fallback_count; /* Allocations not from pools */
+    hg_thread_spin_t request_tag_lock; /* Request tag lock */
+    na_tag_t request_tag;              /* Next request tag */
+    na_tag_t request_tag_end;          /* End of current tag block */
+    hg_bool_t finalizing;         /* Prevent reposts */
+};
+
+/* Entry completed while an NA completion is being triggered, it is triggered
+ * right away instead of going through the completion queue */
+struct hg_core_trigger_slot {
+    struct hg_core_private_context *context;
+    struct hg_completion_entry *hg_completion_entry;
 };
 
 /* Info for wrapping callbacks if self addr */
@@ -204,7 +473,23 @@ struct hg_core_private_addr {
     na_size_t na_sm_addr_serialize_size; /* Cached serialization size */
     na_sm_id_t host_id;                  /* NA SM Host ID */
 #endif
-    hg_atomic_int32_t ref_count; /* Reference count */
+    HG_QUEUE_HEAD(hg_core_private_handle) credit_queue; /* Waiting forwards */
+    HG_LIST_HEAD(hg_core_private_handle) forward_list;  /* Forwards in flight */
+    hg_thread_spin_t credit_lock; /* Credit and forward list lock */
+    unsigned int credits;         /* Requests allowed in flight */
+    unsigned int inflight;        /* Requests in flight */
+    hg_atomic_int32_t load;       /* Last load advertised by target */
+    hg_hash_table_t *rpc_index;   /* RPC indices learned from target */
+    hg_thread_spin_t rpc_index_lock; /* RPC index lock */
+    hg_atomic_int32_t ref_count;  /* Reference count */
+};
+
+/* HG core addr cache entry */
+struct hg_core_addr_cache_entry {
+    char *name;                        /* Lookup name (key) */
+    struct hg_core_private_addr *addr; /* Cached addr (NULL if negative) */
+    hg_time_t expire;                  /* Expiration time */
+    hg_return_t ret;                   /* Lookup error if negative */
 };
 
 /* HG core op type */
@@ -214,21 +499,70 @@ typedef enum {
     HG_CORE_NO_RESPOND,   /*!< No response completion */
     HG_CORE_FORWARD_SELF, /*!< Self forward completion */
     HG_CORE_RESPOND_SELF, /*!< Self respond completion */
-    HG_CORE_PROCESS       /*!< Process completion */
+    HG_CORE_PROCESS,      /*!< Process completion */
+    HG_CORE_FORWARD_CHUNK, /*!< Response chunk received */
+    HG_CORE_RESPOND_CHUNK  /*!< Response chunk sent and acked */
 } hg_core_op_type_t;
 
-/* HG core handle */
+/* Cold part of a HG core handle, only allocated on first use by timed
+ * forwards, more data acks, streamed responses, latency stats and tracing */
+struct hg_core_handle_ext {
+    struct hg_timer timer;                     /* Forward deadline or delay */
+    struct hg_core_private_handle *timer_next; /* Next expired handle */
+    void *ack_buf;                             /* Ack buf for more data */
+    void *ack_buf_plugin_data;                 /* Ack plugin data */
+    na_op_id_t *na_ack_op_id;                  /* Operation ID for ack */
+    hg_core_cb_t chunk_callback;               /* Response chunk callback */
+    void *chunk_arg;                           /* Response chunk callback arg */
+    hg_time_ticks_t stamps[HG_CORE_STAMP_MAX]; /* Latency stamps */
+    hg_uint64_t trace_id;                      /* Trace ID */
+    hg_uint8_t trace_ctx[HG_HOOK_TRACE_CTX_MAX]; /* Trace context sent */
+};
+
+/* HG core handle, fields used when posting and completing operations come
+ * first so that they share as few cache lines as possible */
 struct hg_core_private_handle {
     struct hg_core_handle core_handle; /* Must remain as first field */
-    struct hg_completion_entry hg_completion_entry; /* Completion queue entry */
-    HG_LIST_ENTRY(hg_core_private_handle) created;  /* Created list entry */
-    HG_LIST_ENTRY(hg_core_private_handle) pending;  /* Pending list entry */
-    struct hg_core_header in_header;                /* Input header */
-    struct hg_core_header out_header;               /* Output header */
-    na_class_t *na_class;                           /* NA class */
-    na_context_t *na_context;                       /* NA context */
-    na_addr_t na_addr;                              /* NA addr */
-    hg_core_cb_t request_callback;                  /* Request callback */
+    hg_atomic_int32_t status;          /* Handle status */
+    hg_atomic_int32_t ref_count;       /* Reference count */
+    hg_atomic_int32_t na_op_completed_count; /* Completed NA operation count */
+    hg_atomic_int32_t na_op_pending_count;   /* Posted NA operation count */
+    unsigned int na_op_count;                /* Expected NA operation count */
+    hg_core_op_type_t op_type;               /* Core operation type */
+    hg_return_t ret;           /* Return code associated to handle */
+    hg_return_t process_ret;   /* Error to respond with instead of RPC */
+    na_tag_t tag;              /* Tag used for request and response */
+    hg_uint8_t cookie;         /* Cookie */
+    hg_uint8_t stamped;        /* Stamps taken (mask) */
+    hg_bool_t repost;          /* Repost handle on completion (listen) */
+    hg_bool_t posted;          /* Unexpected recv is posted */
+    hg_bool_t listed;          /* On pending list, kept across reposts */
+    hg_bool_t trimmed;         /* Released by trimming, do not re-use */
+    hg_bool_t is_self;         /* Self processed */
+    hg_bool_t no_response;     /* Require response or not */
+    hg_bool_t coalesced;       /* Request was sent/received with others */
+    hg_bool_t coalesce_received; /* Response was received with others */
+    hg_bool_t timed;             /* Forward has a deadline */
+    hg_bool_t timed_out;         /* Deadline expired */
+    hg_bool_t delayed;           /* Forward waits for its send delay */
+    hg_bool_t credit_held;       /* Forward holds a credit of its target */
+    hg_bool_t credit_queued;     /* Forward waits for a credit */
+    hg_bool_t forward_listed;    /* On forward list of its target */
+    hg_bool_t persistent;        /* Tag and header kept across forwards */
+    hg_bool_t tag_reserved;      /* Tag reserved for next forward */
+    hg_bool_t tag_batched;       /* Tag given by batch forward */
+    hg_bool_t header_encoded;    /* Request header already encoded */
+    hg_uint8_t header_flags;     /* Flags of encoded request header */
+    na_class_t *na_class;        /* NA class */
+    na_context_t *na_context;    /* NA context */
+    na_addr_t na_addr;           /* NA addr */
+    na_op_id_t *na_send_op_id;   /* Operation ID for send */
+    na_op_id_t *na_recv_op_id;   /* Operation ID for recv */
+    void *in_buf_plugin_data;    /* Input buffer NA plugin data */
+    void *out_buf_plugin_data;   /* Output buffer NA plugin data */
+    na_size_t in_buf_used;       /* Amount of input buffer used */
+    na_size_t out_buf_used;      /* Amount of output buffer used */
+    hg_core_cb_t request_callback;  /* Request callback */
     void *request_arg;              /* Request callback arguments */
     hg_core_cb_t response_callback; /* Response callback */
     void *response_arg;             /* Response callback arguments */
@@ -238,26 +572,41 @@ struct hg_core_private_handle {
         struct hg_core_private_handle *hg_core_handle); /* respond */
     hg_return_t (*no_respond)(
         struct hg_core_private_handle *hg_core_handle); /* no_respond */
-    void *ack_buf;             /* Ack buf for more data */
-    void *in_buf_plugin_data;  /* Input buffer NA plugin data */
-    void *out_buf_plugin_data; /* Output buffer NA plugin data */
-    void *ack_buf_plugin_data; /* Ack plugin data */
-    na_op_id_t *na_send_op_id; /* Operation ID for send */
-    na_op_id_t *na_recv_op_id; /* Operation ID for recv */
-    na_op_id_t *na_ack_op_id;  /* Operation ID for ack */
-    na_size_t in_buf_used;     /* Amount of input buffer used */
-    na_size_t out_buf_used;    /* Amount of output buffer used */
-    na_tag_t tag;              /* Tag used for request and response */
-    hg_atomic_int32_t na_op_completed_count; /* Completed NA operation count */
-    hg_atomic_int32_t ref_count;             /* Reference count */
-    hg_atomic_int32_t status;                /* Handle status */
-    unsigned int na_op_count;                /* Expected NA operation count */
-    hg_core_op_type_t op_type;               /* Core operation type */
-    hg_return_t ret;       /* Return code associated to handle */
-    hg_uint8_t cookie;     /* Cookie */
-    hg_bool_t repost;      /* Repost handle on completion (listen) */
-    hg_bool_t is_self;     /* Self processed */
-    hg_bool_t no_response; /* Require response or not */
+    struct hg_completion_entry hg_completion_entry; /* Completion queue entry */
+    HG_LIST_ENTRY(hg_core_private_handle) created;  /* Created list entry */
+    HG_LIST_ENTRY(hg_core_private_handle) pending;  /* Pending list entry */
+    HG_LIST_ENTRY(hg_core_private_handle) coalesce; /* Wait list entry */
+    struct hg_core_private_handle *coalesce_next;   /* Next coalesced handle */
+    HG_QUEUE_ENTRY(hg_core_private_handle) credit;  /* Credit queue entry */
+    HG_QUEUE_ENTRY(hg_core_private_handle) fair;    /* Fair-share entry */
+    HG_LIST_ENTRY(hg_core_private_handle) target;   /* Forward list entry */
+    struct hg_core_header in_header;                /* Input header */
+    struct hg_core_header out_header;               /* Output header */
+    struct hg_core_handle_ext *ext; /* Cold fields (NULL until used) */
+};
+
+
+/* Batch of requests (resp. responses) coalesced into a single unexpected
+ * (resp. expected) message */
+struct hg_core_coalesce_batch {
+    struct hg_core_header header;                /* Coalesced message header */
+    HG_LIST_ENTRY(hg_core_coalesce_batch) entry; /* Context list entry */
+    struct hg_core_private_context *context;     /* Context */
+    hg_bool_t response;                          /* Batch of responses */
+    struct hg_core_private_addr *addr;           /* Target addr */
+    struct hg_core_private_handle *handles;      /* Coalesced handles */
+    na_class_t *na_class;                        /* NA class */
+    na_context_t *na_context;                    /* NA context */
+    na_addr_t na_addr;                           /* NA addr */
+    void *buf;                                   /* Message buffer */
+    void *buf_plugin_data;                       /* NA plugin data */
+    na_op_id_t *na_op_id;                        /* Operation ID for send */
+    na_size_t buf_size;                          /* Message buffer size */
+    na_size_t buf_used;                          /* Amount of buffer used */
+    hg_time_t start;                             /* First request time */
+    unsigned int count;                          /* Number of entries */
+    na_tag_t tag;                                /* Tag of first entry */
+    hg_uint8_t context_id;                       /* Target context ID */
 };
 
 /* HG op id */
@@ -281,28 +630,136 @@ struct hg_core_op_id {
 /********************/
 
 /**
- * Equal function for function map.
+ * Hash function for function map.
  */
-static HG_INLINE int
-hg_core_int_equal(void *vlocation1, void *vlocation2);
+static HG_INLINE unsigned int
+hg_core_func_map_hash(hg_id_t id);
 
 /**
- * Hash function for function map.
+ * Pick target shard of an RPC.
  */
-static HG_INLINE unsigned int
-hg_core_int_hash(void *vlocation);
+static HG_INLINE hg_uint8_t
+hg_core_shard_id(hg_id_t id, hg_uint64_t key, hg_uint8_t shard_count);
+
+/**
+ * Allocate function map table.
+ */
+static struct hg_core_func_map *
+hg_core_func_map_alloc(unsigned int size);
+
+/**
+ * Free function map table, previous tables and registered RPC info.
+ */
+static void
+hg_core_func_map_free(struct hg_core_func_map *hg_core_func_map);
+
+/**
+ * Lookup RPC info from function map (does not require any lock).
+ */
+static HG_INLINE struct hg_core_rpc_info *
+hg_core_func_map_lookup(
+    struct hg_core_private_class *hg_core_class, hg_id_t id);
+
+/**
+ * Insert RPC info into function map (must be called with func_map_lock).
+ */
+static hg_return_t
+hg_core_func_map_insert(struct hg_core_private_class *hg_core_class,
+    hg_id_t id, struct hg_core_rpc_info *hg_core_rpc_info);
+
+/**
+ * Remove RPC info from function map (must be called with func_map_lock).
+ */
+static struct hg_core_rpc_info *
+hg_core_func_map_remove(
+    struct hg_core_private_class *hg_core_class, hg_id_t id);
+
+/**
+ * Free RPC info.
+ */
+static void
+hg_core_rpc_info_free(struct hg_core_rpc_info *hg_core_rpc_info);
+
+/**
+ * Allocate dense RPC table.
+ */
+static struct hg_core_rpc_table *
+hg_core_rpc_table_alloc(unsigned int size);
+
+/**
+ * Free dense RPC table and previous tables (RPC info is owned by function
+ * map).
+ */
+static void
+hg_core_rpc_table_free(struct hg_core_rpc_table *hg_core_rpc_table);
+
+/**
+ * Lookup RPC info from its index (does not require any lock).
+ */
+static HG_INLINE struct hg_core_rpc_info *
+hg_core_rpc_table_lookup(
+    struct hg_core_private_class *hg_core_class, hg_uint16_t index);
+
+/**
+ * Give RPC info an index in dense RPC table (must be called with
+ * func_map_lock).
+ */
+static void
+hg_core_rpc_table_insert(struct hg_core_private_class *hg_core_class,
+    struct hg_core_rpc_info *hg_core_rpc_info);
+
+/**
+ * Clear entry of RPC info in dense RPC table, index is not reused (must be
+ * called with func_map_lock).
+ */
+static void
+hg_core_rpc_table_remove(struct hg_core_private_class *hg_core_class,
+    struct hg_core_rpc_info *hg_core_rpc_info);
+
+/**
+ * Hash function for RPC indices of addresses.
+ */
+static unsigned int
+hg_core_rpc_index_hash(hg_hash_table_key_t key);
 
 /**
- * Free function for value in function map.
+ * Compare function for RPC indices of addresses.
+ */
+static int
+hg_core_rpc_index_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Get index of RPC in table of target (0 if not known).
+ */
+static hg_uint16_t
+hg_core_addr_rpc_index_get(
+    struct hg_core_private_addr *hg_core_addr, hg_id_t id);
+
+/**
+ * Set index of RPC in table of target (0 removes it).
  */
 static void
-hg_core_func_map_value_free(hg_hash_table_value_t value);
+hg_core_addr_rpc_index_set(
+    struct hg_core_private_addr *hg_core_addr, hg_id_t id, hg_uint16_t index);
+
+/**
+ * Determine whether local byte order is big-endian.
+ */
+static HG_INLINE hg_bool_t
+hg_core_is_big_endian(void);
+
+/**
+ * Generate a new tag. Contexts take blocks of tags from the class so that
+ * contexts forwarding concurrently do not share a counter.
+ */
+static HG_INLINE na_tag_t
+hg_core_gen_request_tag(struct hg_core_private_context *context);
 
 /**
- * Generate a new tag.
+ * Generate a new tag, request_tag_lock must be held.
  */
 static HG_INLINE na_tag_t
-hg_core_gen_request_tag(struct hg_core_private_class *hg_core_class);
+hg_core_gen_request_tag_locked(struct hg_core_private_context *context);
 
 /**
  * Proc request header and verify it if decoded.
@@ -311,6 +768,13 @@ static HG_INLINE hg_return_t
 hg_core_proc_header_request(struct hg_core_handle *hg_core_handle,
     struct hg_core_header *hg_core_header, hg_proc_op_t op);
 
+/**
+ * Select header format and set header sizes of handle.
+ */
+static HG_INLINE void
+hg_core_set_header_size(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t compact);
+
 /**
  * Proc response header and verify it if decoded.
  */
@@ -331,6 +795,13 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
 static hg_return_t
 hg_core_finalize(struct hg_core_private_class *hg_core_class);
 
+/**
+ * Initialize NA rails from comma-separated list of NA info strings.
+ */
+static hg_return_t
+hg_core_rails_init(struct hg_core_private_class *hg_core_class,
+    const char *na_rails, const struct na_init_info *na_init_info);
+
 /**
  * Create context.
  */
@@ -364,6 +835,44 @@ static hg_return_t
 hg_core_context_check_pending(struct hg_core_private_context *context,
     na_class_t *na_class, na_context_t *na_context, unsigned int request_count);
 
+/**
+ * Get pool of posted requests associated to NA class.
+ */
+static HG_INLINE struct hg_core_post_pool *
+hg_core_context_post_pool(
+    struct hg_core_private_context *context, na_class_t *na_class);
+
+/**
+ * Add (or remove if negative) size bytes to memory used by context.
+ */
+static HG_INLINE void
+hg_core_context_mem_add(struct hg_core_private_context *context,
+    hg_mem_use_t use, hg_util_int64_t size);
+
+/**
+ * Get total memory used by context.
+ */
+static HG_INLINE hg_size_t
+hg_core_context_mem_used(struct hg_core_private_context *context);
+
+/**
+ * Account for a request that is no longer posted.
+ */
+static HG_INLINE void
+hg_core_post_pool_remove(struct hg_core_post_pool *hg_core_post_pool);
+
+/**
+ * Remove handle that is no longer reposted from pending list.
+ */
+static void
+hg_core_post_unlist(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Cancel posted requests that were not needed over the last interval.
+ */
+static void
+hg_core_context_trim(struct hg_core_private_context *context);
+
 /**
  * Wail until handle lists are empty.
  */
@@ -377,6 +886,88 @@ static hg_return_t
 hg_core_addr_lookup(struct hg_core_private_class *hg_core_class,
     const char *name, struct hg_core_private_addr **addr);
 
+/**
+ * Lookup addr through NA.
+ */
+static hg_return_t
+hg_core_addr_lookup_na(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr **addr);
+
+/**
+ * Lookup count addrs, names that do not need special handling are looked up
+ * at once through NA.
+ */
+static hg_return_t
+hg_core_addr_lookup_batch(struct hg_core_private_class *hg_core_class,
+    const char *const names[], hg_size_t count,
+    struct hg_core_private_addr *addrs[]);
+
+/**
+ * Hash addr cache key.
+ */
+static unsigned int
+hg_core_addr_cache_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare addr cache keys.
+ */
+static int
+hg_core_addr_cache_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Free addr cache entry.
+ */
+static void
+hg_core_addr_cache_entry_free(hg_hash_table_value_t value);
+
+/**
+ * Create addr cache and load entries from file if any.
+ */
+static hg_return_t
+hg_core_addr_cache_init(struct hg_core_private_class *hg_core_class,
+    const struct hg_init_info *hg_init_info);
+
+/**
+ * Dump addr cache entries to file if any and destroy cache.
+ */
+static void
+hg_core_addr_cache_finalize(struct hg_core_private_class *hg_core_class);
+
+/**
+ * Get addr from cache.
+ */
+static hg_bool_t
+hg_core_addr_cache_get(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr **addr, hg_return_t *ret);
+
+/**
+ * Add addr (or lookup error if addr is NULL) to cache.
+ */
+static void
+hg_core_addr_cache_put(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr *addr, hg_return_t ret);
+
+/**
+ * Remove entries that refer to addr from cache.
+ */
+static void
+hg_core_addr_cache_remove(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr *addr);
+
+/**
+ * Load addr cache entries from file.
+ */
+static hg_return_t
+hg_core_addr_cache_load(
+    struct hg_core_private_class *hg_core_class, const char *path);
+
+/**
+ * Dump addr cache entries to file.
+ */
+static hg_return_t
+hg_core_addr_cache_dump(
+    struct hg_core_private_class *hg_core_class, const char *path);
+
 /**
  * Create addr.
  */
@@ -401,6 +992,20 @@ hg_core_addr_free_na(struct hg_core_private_addr *hg_core_addr);
 static hg_return_t
 hg_core_addr_set_remove(struct hg_core_private_addr *hg_core_addr);
 
+/**
+ * Cancel all forwards in flight to addr and set addr to be removed if
+ * \remove is set.
+ */
+static hg_return_t
+hg_core_addr_cancel_all(
+    struct hg_core_private_addr *hg_core_addr, hg_bool_t remove);
+
+/**
+ * Start connecting to addr through the NA class that RPCs to addr use.
+ */
+static hg_return_t
+hg_core_addr_warmup(struct hg_core_private_addr *hg_core_addr);
+
 /**
  * Self addr.
  */
@@ -451,6 +1056,35 @@ hg_core_addr_deserialize(struct hg_core_private_class *hg_core_class,
     struct hg_core_private_addr **hg_core_addr_ptr, const void *buf,
     hg_size_t buf_size);
 
+/**
+ * Get width of the fixed-size entries of a serialized address batch.
+ */
+static na_size_t
+hg_core_addr_batch_entry_size(
+    struct hg_core_private_addr *const addrs[], hg_size_t count);
+
+/**
+ * Get serialize size of a batch of core addresses.
+ */
+static hg_size_t
+hg_core_addr_get_serialize_batch_size(
+    struct hg_core_private_addr *const addrs[], hg_size_t count);
+
+/**
+ * Serialize a batch of core addresses.
+ */
+static hg_return_t
+hg_core_addr_serialize_batch(void *buf, hg_size_t buf_size,
+    struct hg_core_private_addr *const addrs[], hg_size_t count);
+
+/**
+ * Deserialize a batch of core addresses.
+ */
+static hg_return_t
+hg_core_addr_deserialize_batch(struct hg_core_private_class *hg_core_class,
+    const void *buf, hg_size_t buf_size, struct hg_core_private_addr *addrs[],
+    hg_size_t *count_p);
+
 /**
  * Create handle.
  */
@@ -478,34 +1112,94 @@ static hg_return_t
 hg_core_free(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Allocate NA resources.
+ * Add handle to list of created handles (debug only).
  */
-static hg_return_t
-hg_core_alloc_na(struct hg_core_private_handle *hg_core_handle,
-    na_class_t *na_class, na_context_t *na_context);
+static HG_INLINE void
+hg_core_track(struct hg_core_private_context *context,
+    struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Freee NA resources.
+ * Remove handle from list of created handles (debug only).
  */
-static hg_return_t
-hg_core_free_na(struct hg_core_private_handle *hg_core_handle);
+static HG_INLINE void
+hg_core_untrack(struct hg_core_private_context *context,
+    struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Reset handle.
+ * Get cold fields of handle, allocate them on first use. Must not be called
+ * concurrently on the same handle.
  */
-static void
-hg_core_reset(struct hg_core_private_handle *hg_core_handle);
+static struct hg_core_handle_ext *
+hg_core_ext_get(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Reset handle and re-post it.
+ * Allocate and initialize ack buffer, the ack op ID is created on first use
+ * and kept until NA resources are freed.
  */
 static hg_return_t
-hg_core_reset_post(struct hg_core_private_handle *hg_core_handle);
+hg_core_ack_buf_alloc(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Set target addr / RPC ID
+ * Free ack buffer if any.
  */
-static hg_return_t
+static na_return_t
+hg_core_ack_buf_free(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Allocate NA resources.
+ */
+static hg_return_t
+hg_core_alloc_na(struct hg_core_private_handle *hg_core_handle,
+    na_class_t *na_class, na_context_t *na_context);
+
+/**
+ * Freee NA resources.
+ */
+static hg_return_t
+hg_core_free_na(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Get handle with NA resources already allocated from context pool.
+ */
+static struct hg_core_private_handle *
+hg_core_pool_get(struct hg_core_private_context *context, na_class_t *na_class);
+
+/**
+ * Put handle back to context pool. Return HG_FALSE if handle cannot be
+ * re-used.
+ */
+static hg_bool_t
+hg_core_pool_put(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Free handles from context pool.
+ */
+static hg_return_t
+hg_core_pool_destroy(struct hg_core_handle_list *handle_pool);
+
+/**
+ * Preallocate count handles into context pool.
+ */
+static hg_return_t
+hg_core_pool_prealloc(
+    struct hg_core_private_context *context, unsigned int count);
+
+/**
+ * Reset handle.
+ */
+static void
+hg_core_reset(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Reset handle and re-post it.
+ */
+static hg_return_t
+hg_core_reset_post(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Set target addr / RPC ID
+ */
+static hg_return_t
 hg_core_set_rpc(struct hg_core_private_handle *hg_core_handle,
     struct hg_core_private_addr *hg_core_addr, na_addr_t na_addr, hg_id_t id);
 
@@ -520,7 +1214,14 @@ hg_core_post(struct hg_core_private_handle *hg_core_handle);
  */
 static hg_return_t
 hg_core_forward(struct hg_core_private_handle *hg_core_handle,
-    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size);
+    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size,
+    unsigned int timeout, unsigned int delay);
+
+/**
+ * Send forward once its delay expired.
+ */
+static void
+hg_core_forward_delayed(struct hg_core_private_handle *hg_core_handle);
 
 /**
  * Forward handle locally.
@@ -534,6 +1235,18 @@ hg_core_forward_self(struct hg_core_private_handle *hg_core_handle);
 static hg_return_t
 hg_core_forward_na(struct hg_core_private_handle *hg_core_handle);
 
+/**
+ * Start a batch of NA operations on all NA contexts of context.
+ */
+static void
+hg_core_op_batch_begin(struct hg_core_private_context *context);
+
+/**
+ * End a batch of NA operations on all NA contexts of context.
+ */
+static void
+hg_core_op_batch_end(struct hg_core_private_context *context);
+
 /**
  * Send response.
  */
@@ -572,6 +1285,69 @@ hg_core_no_respond_na(struct hg_core_private_handle *hg_core_handle);
 static HG_INLINE int
 hg_core_send_input_cb(const struct na_cb_info *callback_info);
 
+/**
+ * Complete send of input.
+ */
+static int
+hg_core_send_input_complete(
+    struct hg_core_private_handle *hg_core_handle, na_return_t na_cb_ret);
+
+/**
+ * Add request or response to batch of coalesced messages.
+ */
+static hg_return_t
+hg_core_coalesce_add(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t response);
+
+/**
+ * Get batch of coalesced messages for handle.
+ */
+static struct hg_core_coalesce_batch *
+hg_core_coalesce_batch_get(struct hg_core_private_context *context,
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t response);
+
+/**
+ * Release batch of coalesced messages.
+ */
+static void
+hg_core_coalesce_batch_release(struct hg_core_private_context *context,
+    struct hg_core_coalesce_batch *hg_core_batch);
+
+/**
+ * Free batch of coalesced messages.
+ */
+static void
+hg_core_coalesce_batch_free(struct hg_core_coalesce_batch *hg_core_batch);
+
+/**
+ * Send batch of coalesced messages.
+ */
+static hg_return_t
+hg_core_coalesce_send(struct hg_core_private_context *context,
+    struct hg_core_coalesce_batch *hg_core_batch);
+
+/**
+ * Send coalesced messages callback.
+ */
+static int
+hg_core_coalesce_send_cb(const struct na_cb_info *callback_info);
+
+/**
+ * Complete coalesced messages.
+ */
+static int
+hg_core_coalesce_complete(struct hg_core_private_context *context,
+    struct hg_core_coalesce_batch *hg_core_batch, na_return_t na_cb_ret);
+
+/**
+ * Send aggregated responses and batches of coalesced requests that have been
+ * held long enough, lower timeout to the time remaining before next batch
+ * must be sent.
+ */
+static hg_return_t
+hg_core_coalesce_flush(
+    struct hg_core_private_context *context, unsigned int *timeout_ptr);
+
 /**
  * Recv input callback.
  */
@@ -585,12 +1361,38 @@ static hg_return_t
 hg_core_process_input(
     struct hg_core_private_handle *hg_core_handle, hg_bool_t *completed);
 
+/**
+ * Split coalesced requests into separate handles and process their input.
+ */
+static hg_return_t
+hg_core_process_coalesced(
+    struct hg_core_private_handle *hg_core_handle, unsigned int *count_ptr);
+
+/**
+ * Check admission thresholds, return false if request must be rejected.
+ */
+static hg_bool_t
+hg_core_admit(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Respond to request that cannot be processed without queuing it.
+ */
+static hg_return_t
+hg_core_reject(struct hg_core_private_handle *hg_core_handle);
+
 /**
  * Send output callback.
  */
 static HG_INLINE int
 hg_core_send_output_cb(const struct na_cb_info *callback_info);
 
+/**
+ * Complete send of output.
+ */
+static int
+hg_core_send_output_complete(
+    struct hg_core_private_handle *hg_core_handle, na_return_t na_cb_ret);
+
 /**
  * Recv output callback.
  */
@@ -604,12 +1406,39 @@ static hg_return_t
 hg_core_process_output(struct hg_core_private_handle *hg_core_handle,
     hg_bool_t *completed, hg_return_t (*done_callback)(hg_core_handle_t));
 
+/**
+ * Dispatch aggregated responses to the handles waiting for them and extract
+ * own response.
+ */
+static hg_return_t
+hg_core_process_output_coalesced(struct hg_core_private_handle *hg_core_handle);
+
 /**
  * Send ack for HG_CORE_MORE_DATA flag on output.
  */
 static hg_return_t
 hg_core_send_ack(hg_core_handle_t handle);
 
+/**
+ * Queue received response chunk for its callback to be triggered.
+ */
+static hg_return_t
+hg_core_chunk_add(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Once the chunk callback has been triggered, re-post recv for the next
+ * message and ack the chunk so that the target can send it.
+ */
+static hg_return_t
+hg_core_chunk_ack(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Send response chunk and post recv for its ack.
+ */
+static hg_return_t
+hg_core_respond_chunk(struct hg_core_private_handle *hg_core_handle,
+    hg_core_cb_t callback, void *arg, hg_size_t payload_size);
+
 /**
  * Send ack callback. (HG_CORE_MORE_DATA flag on output)
  */
@@ -654,398 +1483,4531 @@ static HG_INLINE hg_return_t
 hg_core_complete(hg_core_handle_t handle);
 
 /**
- * Make progress.
+ * Make progress, only one thread at a time polls the context.
  */
 static hg_return_t
 hg_core_progress(struct hg_core_private_context *context, unsigned int timeout);
 
 /**
- * Determines when it is safe to block.
+ * Poll context (called by the thread that currently polls).
  */
-static HG_INLINE hg_bool_t
-hg_core_poll_try_wait(struct hg_core_private_context *context);
+static hg_return_t
+hg_core_progress_poll(
+    struct hg_core_private_context *context, unsigned int timeout);
 
 /**
- * Poll for timeout ms on context.
+ * Make non-blocking progress on behalf of an external event loop and arm
+ * notifications of the context fd. \timeout_ptr is set to the time that the
+ * event loop may wait on the fd.
  */
 static hg_return_t
-hg_core_poll_wait(struct hg_core_private_context *context, unsigned int timeout,
-    hg_bool_t *progressed_ptr);
+hg_core_process_ready(
+    struct hg_core_private_context *context, unsigned int *timeout_ptr);
 
 /**
- * Poll context without blocking.
+ * Current time in ms.
  */
-static hg_return_t
-hg_core_poll(struct hg_core_private_context *context, unsigned int timeout,
-    hg_bool_t *progressed_ptr);
+static HG_INLINE hg_uint64_t
+hg_core_time_ms(void);
 
 /**
- * Make progress on NA layer.
+ * Arm deadline of forwarded handle unless it already completed.
  */
-static hg_return_t
-hg_core_progress_na(na_class_t *na_class, na_context_t *na_context,
-    unsigned int timeout, hg_bool_t *progressed_ptr);
+static void
+hg_core_timer_arm(
+    struct hg_core_private_handle *hg_core_handle, unsigned int timeout);
 
 /**
- * Completion queue notification callback.
+ * Disarm deadline of handle.
  */
-static HG_INLINE hg_return_t
-hg_core_progress_loopback_notify(
-    struct hg_core_private_context *context, hg_bool_t *progressed_ptr);
+static void
+hg_core_timer_disarm(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Trigger callbacks.
+ * Remove handle from the timer wheel if its forward has not been sent yet.
+ * Return HG_TRUE if handle was removed.
  */
-static hg_return_t
-hg_core_trigger(struct hg_core_private_context *context, unsigned int timeout,
-    unsigned int max_count, unsigned int *actual_count);
+static hg_bool_t
+hg_core_timer_undelay(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Trigger callback from HG lookup op ID.
+ * Timer callback, queue handle for cancelation or for sending.
  */
-static hg_return_t
-hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id);
+static void
+hg_core_timer_expire(struct hg_timer *timer, void *arg);
 
 /**
- * Trigger callback from HG core handle.
+ * Expire deadlines that are due, cancel their handles, send delayed forwards
+ * and lower \timeout so that it does not exceed the time left before the next
+ * deadline.
  */
-static hg_return_t
-hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle);
+static void
+hg_core_timer_process(
+    struct hg_core_private_context *context, unsigned int *timeout);
 
 /**
- * Cancel handle.
+ * Take a credit of the target of handle, queue handle if none is left.
+ * Return HG_FALSE if handle was queued.
  */
-static hg_return_t
-hg_core_cancel(struct hg_core_private_handle *hg_core_handle);
+static hg_bool_t
+hg_core_credit_acquire(struct hg_core_private_handle *hg_core_handle);
 
-#ifdef HG_HAS_COLLECT_STATS
 /**
- * Print stats.
+ * Give back the credit held by handle and forward queued handles that can
+ * now be sent.
  */
 static void
-hg_core_print_stats(void);
-#endif
+hg_core_credit_release(struct hg_core_private_handle *hg_core_handle);
 
-/*******************/
-/* Local Variables */
-/*******************/
+/**
+ * Remove handle from the credit queue of its target. Return HG_FALSE if
+ * handle was not queued.
+ */
+static hg_bool_t
+hg_core_credit_dequeue(struct hg_core_private_handle *hg_core_handle);
 
-#ifdef HG_HAS_COLLECT_STATS
-static hg_bool_t hg_core_print_stats_registered_g = HG_FALSE;
-static hg_core_stat_t hg_core_rpc_count_g = HG_CORE_STAT_INIT(0);
-static hg_core_stat_t hg_core_rpc_extra_count_g = HG_CORE_STAT_INIT(0);
-static hg_core_stat_t hg_core_bulk_count_g = HG_CORE_STAT_INIT(0);
-#endif
+/**
+ * Add forward to the list of forwards in flight to its target.
+ */
+static void
+hg_core_forward_list_add(struct hg_core_private_handle *hg_core_handle);
 
-/*---------------------------------------------------------------------------*/
-#ifdef HG_HAS_COLLECT_STATS
+/**
+ * Remove forward from the list of forwards in flight to its target (if it was
+ * not removed already).
+ */
 static void
-hg_core_print_stats(void)
-{
-    printf("\n================================================================="
-           "\n");
-    printf("Mercury stat report\n");
-    printf("-------------------\n");
-    printf("RPC count:            %lu\n",
-        (unsigned long) hg_core_stat_get(&hg_core_rpc_count_g));
-    printf("RPC count (overflow): %lu\n",
-        (unsigned long) hg_core_stat_get(&hg_core_rpc_extra_count_g));
-    printf("Bulk transfer count:  %lu\n",
-        (unsigned long) hg_core_stat_get(&hg_core_bulk_count_g));
-}
-#endif
+hg_core_forward_list_remove(struct hg_core_private_handle *hg_core_handle);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE int
-hg_core_int_equal(void *vlocation1, void *vlocation2)
-{
-    return *((int *) vlocation1) == *((int *) vlocation2);
-}
+/**
+ * Return the number of credits that target advertises to the origin of
+ * handle, shrinking with the number of requests that are left posted.
+ */
+static hg_uint16_t
+hg_core_credit_advertise(struct hg_core_private_handle *hg_core_handle);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE unsigned int
-hg_core_int_hash(void *vlocation)
-{
-    return *((unsigned int *) vlocation);
-}
+/**
+ * Return the number of received requests that context is processing.
+ */
+static hg_uint64_t
+hg_core_context_load(struct hg_core_private_context *context);
 
-/*---------------------------------------------------------------------------*/
-static void
-hg_core_func_map_value_free(hg_hash_table_value_t value)
-{
-    struct hg_core_rpc_info *hg_core_rpc_info =
-        (struct hg_core_rpc_info *) value;
+/**
+ * Return the load that target advertises to the origin of handle, i.e., the
+ * number of received requests that its context is processing.
+ */
+static hg_uint16_t
+hg_core_load_advertise(struct hg_core_private_handle *hg_core_handle);
 
-    if (hg_core_rpc_info->free_callback)
-        hg_core_rpc_info->free_callback(hg_core_rpc_info->data);
-    free(hg_core_rpc_info);
-}
+/**
+ * Thread that polls the context on behalf of trigger threads.
+ */
+static HG_THREAD_RETURN_TYPE
+hg_core_progress_thread(void *arg);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE na_tag_t
-hg_core_gen_request_tag(struct hg_core_private_class *hg_core_class)
-{
-    na_tag_t request_tag = 0;
+/**
+ * Thread that triggers completions of the context.
+ */
+static HG_THREAD_RETURN_TYPE
+hg_core_trigger_thread(void *arg);
 
-    /* Compare and swap tag if reached max tag */
-    if (!hg_atomic_cas32(&hg_core_class->request_tag,
-            (hg_util_int32_t) hg_core_class->request_max_tag, 0)) {
-        /* Increment tag */
-        request_tag = (na_tag_t) hg_atomic_incr32(&hg_core_class->request_tag);
-    }
+/**
+ * Start progress threads.
+ */
+static hg_return_t
+hg_core_progress_threads_start(
+    struct hg_core_private_context *context, unsigned int thread_count);
 
-    return request_tag;
-}
+/**
+ * Stop progress threads.
+ */
+static hg_return_t
+hg_core_progress_threads_stop(struct hg_core_private_context *context);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_proc_header_request(struct hg_core_handle *hg_core_handle,
-    struct hg_core_header *hg_core_header, hg_proc_op_t op)
-{
-    char *header_buf =
-        (char *) hg_core_handle->in_buf + hg_core_handle->na_in_header_offset;
-    size_t header_buf_size =
-        hg_core_handle->in_buf_size - hg_core_handle->na_in_header_offset;
-    hg_return_t ret = HG_SUCCESS;
+/**
+ * Update busy poll budget.
+ */
+static HG_INLINE void
+hg_core_poll_spin_update(struct hg_core_private_context *context,
+    hg_bool_t spinning, hg_bool_t progressed);
 
-    /* Proc request header */
-    ret = hg_core_header_request_proc(
-        op, header_buf, header_buf_size, hg_core_header);
-    HG_CHECK_HG_ERROR(done, ret, "Could not process request header");
+#ifdef NA_HAS_SM
+/**
+ * Determines whether the SM rail must be polled.
+ */
+static HG_INLINE hg_bool_t
+hg_core_poll_sm_check(struct hg_core_private_context *context);
 
-    if (op == HG_DECODE) {
-        ret = hg_core_header_request_verify(hg_core_header);
-        HG_CHECK_HG_ERROR(done, ret, "Could not verify request header");
-    }
+/**
+ * Update SM rail idle state.
+ */
+static HG_INLINE void
+hg_core_poll_sm_update(
+    struct hg_core_private_context *context, hg_bool_t progressed);
 
-done:
-    return ret;
-}
+/**
+ * Mark SM rail as active if operations are posted on it.
+ */
+static HG_INLINE void
+hg_core_poll_sm_wake(
+    struct hg_core_private_context *context, na_class_t *na_class);
+#endif
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_proc_header_response(struct hg_core_handle *hg_core_handle,
-    struct hg_core_header *hg_core_header, hg_proc_op_t op)
+/**
+ * Determines when it is safe to block.
+ */
+static HG_INLINE hg_bool_t
+hg_core_poll_try_wait(struct hg_core_private_context *context);
+
+/**
+ * Poll for timeout ms on context.
+ */
+static hg_return_t
+hg_core_poll_wait(struct hg_core_private_context *context, unsigned int timeout,
+    hg_bool_t *progressed_ptr);
+
+/**
+ * Poll context without blocking.
+ */
+static hg_return_t
+hg_core_poll(struct hg_core_private_context *context, unsigned int timeout,
+    hg_bool_t *progressed_ptr);
+
+/**
+ * Trigger completed NA callbacks.
+ */
+static hg_return_t
+hg_core_trigger_na(na_context_t *na_context, unsigned int *count_ptr);
+
+/**
+ * Make progress on NA layer.
+ */
+static hg_return_t
+hg_core_progress_na(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context, unsigned int timeout,
+    hg_bool_t *progressed_ptr);
+
+/**
+ * Queue received request to fair-share scheduler.
+ */
+static void
+hg_core_fair_push(struct hg_core_fair_sched *fair_sched,
+    struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Remove next request to dispatch from fair-share scheduler.
+ */
+static struct hg_completion_entry *
+hg_core_fair_pop(struct hg_core_fair_sched *fair_sched);
+
+/**
+ * Add entry to completion queue lane \priority and wake up waiting triggers.
+ */
+static hg_return_t
+hg_core_completion_push(struct hg_core_private_context *context, void *entry,
+    hg_priority_t priority);
+
+/**
+ * Dequeue up to \max_count entries, higher priority lanes first.
+ */
+static unsigned int
+hg_core_completion_pop(struct hg_core_private_context *context,
+    void **entries, unsigned int max_count);
+
+/**
+ * Check whether all completion queue lanes are empty.
+ */
+static hg_bool_t
+hg_core_completion_queue_is_empty(struct hg_core_private_context *context);
+
+/**
+ * Register the poller as waiting on the completion queue notification if it
+ * can safely wait.
+ */
+static HG_INLINE hg_bool_t
+hg_core_completion_wait_prepare(struct hg_core_private_context *context);
+
+/**
+ * Signal the completion queue notification if the poller is waiting.
+ */
+static HG_INLINE hg_return_t
+hg_core_completion_notify(struct hg_core_private_context *context);
+
+/**
+ * NA completion sink, adds NA completions to the HG completion queue.
+ */
+static void
+hg_core_completion_sink(void *arg, void *completion);
+
+/**
+ * Completion queue notification callback.
+ */
+static HG_INLINE hg_return_t
+hg_core_progress_loopback_notify(
+    struct hg_core_private_context *context, hg_bool_t *progressed_ptr);
+
+/**
+ * Trigger callbacks, dequeuing at most batch_size entries at once.
+ */
+static hg_return_t
+hg_core_trigger(struct hg_core_private_context *context, unsigned int timeout,
+    unsigned int max_count, unsigned int batch_size,
+    unsigned int *actual_count);
+
+/**
+ * Trigger completion entry.
+ */
+static HG_INLINE hg_return_t
+hg_core_trigger_completion_entry(
+    struct hg_completion_entry *hg_completion_entry);
+
+/**
+ * Trigger NA completion entry, returns the HG entry that it completes.
+ */
+static struct hg_completion_entry *
+hg_core_trigger_na_entry(
+    struct hg_core_private_context *context, void *na_completion_entry);
+
+/**
+ * Trigger callback from HG lookup op ID.
+ */
+static hg_return_t
+hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id);
+
+/**
+ * Trigger callback from HG core handle.
+ */
+static hg_return_t
+hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Cancel handle.
+ */
+static hg_return_t
+hg_core_cancel(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Allocate zeroed stat counters, along with latency histograms if \latency
+ * is set.
+ */
+static struct hg_core_stats *
+hg_core_stats_alloc(hg_bool_t latency);
+
+/**
+ * Free stat counters.
+ */
+static void
+hg_core_stats_free(struct hg_core_stats *hg_core_stats);
+
+/**
+ * Add \value to counter \stat of the class and of the RPC (if any), using
+ * the shard of the calling thread.
+ */
+static void
+hg_core_stats_add(struct hg_core_private_class *hg_core_class,
+    struct hg_core_rpc_info *hg_core_rpc_info, hg_core_stat_t stat,
+    hg_uint64_t value);
+
+/**
+ * Sum up counter \stat over all shards.
+ */
+static hg_uint64_t
+hg_core_stats_get(struct hg_core_stats *hg_core_stats, hg_core_stat_t stat);
+
+#ifdef HG_HAS_COLLECT_STATS
+/**
+ * Print stats.
+ */
+static void
+hg_core_print_stats(struct hg_core_private_class *hg_core_class);
+#endif
+
+/**
+ * Take latency stamp \stamp if latencies are collected.
+ */
+static void
+hg_core_stamp(
+    struct hg_core_private_handle *hg_core_handle, hg_core_stamp_t stamp);
+
+/**
+ * Record latency between stamp \from and time \now into the histogram of
+ * stage \stage if stamp \from was taken.
+ */
+static void
+hg_core_latency_record(struct hg_core_private_handle *hg_core_handle,
+    hg_latency_stage_t stage, hg_core_stamp_t from, const hg_time_ticks_t *now);
+
+/**
+ * Record origin latencies once forward callback is triggered.
+ */
+static void
+hg_core_latency_forward(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Record target latencies once response is sent.
+ */
+static void
+hg_core_latency_respond(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Record handle event \type to trace if tracing is enabled.
+ */
+static void
+hg_core_trace(struct hg_core_private_handle *hg_core_handle,
+    hg_trace_type_t type, hg_size_t size);
+
+/**
+ * Report handle event \type to instrumentation hook if one is set.
+ */
+static HG_INLINE void
+hg_core_hook(struct hg_core_private_handle *hg_core_handle,
+    hg_hook_type_t type, hg_size_t size, hg_return_t ret);
+
+/**
+ * Report operations retried by NA to instrumentation hook.
+ */
+static void
+hg_core_hook_na_retry(void *arg, na_cb_type_t type);
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_stats *
+hg_core_stats_alloc(hg_bool_t latency)
+{
+    struct hg_core_stats *hg_core_stats;
+    unsigned int i, j;
+
+    hg_core_stats = (struct hg_core_stats *) hg_mem_aligned_alloc(
+        HG_MEM_CACHE_LINE_SIZE, sizeof(struct hg_core_stats));
+    HG_CHECK_ERROR_NORET(
+        hg_core_stats == NULL, error, "Could not allocate stat counters");
+    hg_core_stats->latency = NULL;
+
+    for (i = 0; i < HG_CORE_STATS_SHARDS; i++)
+        for (j = 0; j < HG_CORE_STAT_MAX; j++)
+            hg_atomic_init64(&hg_core_stats->shards[i].counters[j], 0);
+
+    if (latency) {
+        hg_core_stats->latency = (struct hg_histogram *) malloc(
+            HG_LATENCY_MAX * sizeof(struct hg_histogram));
+        HG_CHECK_ERROR_NORET(hg_core_stats->latency == NULL, error,
+            "Could not allocate latency histograms");
+        for (i = 0; i < HG_LATENCY_MAX; i++)
+            hg_histogram_init(&hg_core_stats->latency[i]);
+    }
+
+    return hg_core_stats;
+
+error:
+    hg_core_stats_free(hg_core_stats);
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_stats_free(struct hg_core_stats *hg_core_stats)
+{
+    if (!hg_core_stats)
+        return;
+
+    free(hg_core_stats->latency);
+    hg_mem_aligned_free(hg_core_stats);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_stats_add(struct hg_core_private_class *hg_core_class,
+    struct hg_core_rpc_info *hg_core_rpc_info, hg_core_stat_t stat,
+    hg_uint64_t value)
+{
+    uintptr_t shard =
+        (uintptr_t) hg_thread_getspecific(hg_core_class->stats_shard_key);
+
+    /* First update made by that thread, assign it a shard */
+    if (shard == 0) {
+        shard = (uintptr_t) hg_atomic_incr32(&hg_core_class->stats_shard_next);
+        hg_thread_setspecific(hg_core_class->stats_shard_key, (void *) shard);
+    }
+    shard = (shard - 1) & (HG_CORE_STATS_SHARDS - 1);
+
+    /* Counters are only read as snapshots, no ordering is needed */
+    hg_atomic_add64_relaxed(
+        &hg_core_class->stats->shards[shard].counters[stat],
+        (hg_util_int64_t) value);
+    if (hg_core_rpc_info && hg_core_rpc_info->stats)
+        hg_atomic_add64_relaxed(
+            &hg_core_rpc_info->stats->shards[shard].counters[stat],
+            (hg_util_int64_t) value);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_uint64_t
+hg_core_stats_get(struct hg_core_stats *hg_core_stats, hg_core_stat_t stat)
+{
+    hg_uint64_t value = 0;
+    unsigned int i;
+
+    for (i = 0; i < HG_CORE_STATS_SHARDS; i++)
+        value += (hg_uint64_t) hg_atomic_get64(
+            &hg_core_stats->shards[i].counters[stat]);
+
+    return value;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_HAS_COLLECT_STATS
+static void
+hg_core_print_stats(struct hg_core_private_class *hg_core_class)
+{
+    struct hg_core_stats *hg_core_stats = hg_core_class->stats;
+
+    printf("\n================================================================="
+           "\n");
+    printf("Mercury stat report\n");
+    printf("-------------------\n");
+    printf("RPC count:            %llu\n",
+        (unsigned long long) (hg_core_stats_get(
+                                  hg_core_stats, HG_CORE_STAT_FORWARD) +
+                              hg_core_stats_get(
+                                  hg_core_stats, HG_CORE_STAT_HANDLE)));
+    printf("RPC count (overflow): %llu\n",
+        (unsigned long long) hg_core_stats_get(
+            hg_core_stats, HG_CORE_STAT_EXTRA));
+    printf("Bulk transfer count:  %llu\n",
+        (unsigned long long) hg_core_stats_get(
+            hg_core_stats, HG_CORE_STAT_BULK));
+    printf("Rejected requests:    %llu\n",
+        (unsigned long long) hg_core_stats_get(
+            hg_core_stats, HG_CORE_STAT_REJECT));
+    printf("Bytes received:       %llu\n",
+        (unsigned long long) hg_core_stats_get(
+            hg_core_stats, HG_CORE_STAT_BYTES_IN));
+    printf("Bytes sent:           %llu\n",
+        (unsigned long long) hg_core_stats_get(
+            hg_core_stats, HG_CORE_STAT_BYTES_OUT));
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_trace(struct hg_core_private_handle *hg_core_handle,
+    hg_trace_type_t type, hg_size_t size)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    struct hg_core_handle_ext *ext;
+
+    if (!hg_core_class->trace)
+        return;
+
+    /* Each lifecycle of a handle gets its own ID */
+    if (type == HG_TRACE_CREATE) {
+        ext = hg_core_ext_get(hg_core_handle);
+        if (!ext)
+            return;
+        ext->trace_id =
+            (hg_uint64_t) hg_atomic_incr64(&hg_core_class->trace_next_id);
+    } else if (!(ext = hg_core_handle->ext))
+        return;
+
+    hg_trace_record(hg_core_class->trace, type, ext->trace_id,
+        hg_core_handle->core_handle.info.id,
+        hg_core_handle->core_handle.info.context->id, hg_core_handle->tag,
+        (hg_util_uint32_t) size);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_hook(struct hg_core_private_handle *hg_core_handle,
+    hg_hook_type_t type, hg_size_t size, hg_return_t ret)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    struct hg_core_hook_info info;
+
+    if (!hg_core_class->hooks.callbacks[type])
+        return;
+
+    info.context = hg_core_handle->core_handle.info.context;
+    info.handle = (hg_core_handle_t) hg_core_handle;
+    info.op_id = NULL;
+    info.id = hg_core_handle->core_handle.info.id;
+    info.size = size;
+    info.ret = ret;
+    info.op = 0;
+    info.trace_ctx = hg_core_handle->in_header.trace_ctx;
+    info.trace_ctx_size = hg_core_handle->in_header.trace_ctx_size;
+    hg_core_class->hooks.callbacks[type](hg_core_class->hooks.arg, type, &info);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_hook_na_retry(void *arg, na_cb_type_t type)
+{
+    struct hg_core_private_context *context =
+        (struct hg_core_private_context *) arg;
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    struct hg_core_hook_info info;
+
+    if (!hg_core_class->hooks.callbacks[HG_HOOK_RETRY])
+        return;
+
+    memset(&info, 0, sizeof(info));
+    info.context = (hg_core_context_t *) context;
+    info.op = (int) type;
+    hg_core_class->hooks.callbacks[HG_HOOK_RETRY](
+        hg_core_class->hooks.arg, HG_HOOK_RETRY, &info);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_stamp(
+    struct hg_core_private_handle *hg_core_handle, hg_core_stamp_t stamp)
+{
+    struct hg_core_handle_ext *ext;
+
+    if (!HG_CORE_HANDLE_CLASS(hg_core_handle)->latency_stats)
+        return;
+
+    /* Only the first stamp of each side allocates, others may be taken
+     * concurrently from NA callbacks */
+    if (stamp == HG_CORE_STAMP_FORWARD || stamp == HG_CORE_STAMP_RECEIVED)
+        ext = hg_core_ext_get(hg_core_handle);
+    else
+        ext = hg_core_handle->ext;
+    if (!ext)
+        return;
+
+    ext->stamps[stamp] = hg_time_get_ticks();
+    hg_core_handle->stamped |= HG_CORE_STAMP_BIT(stamp);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_latency_record(struct hg_core_private_handle *hg_core_handle,
+    hg_latency_stage_t stage, hg_core_stamp_t from, const hg_time_ticks_t *now)
+{
+    struct hg_core_rpc_info *hg_core_rpc_info =
+        hg_core_handle->core_handle.rpc_info;
+    hg_uint64_t latency = 0;
+
+    if (!(hg_core_handle->stamped & HG_CORE_STAMP_BIT(from)) ||
+        !hg_core_rpc_info || !hg_core_rpc_info->stats ||
+        !hg_core_rpc_info->stats->latency)
+        return;
+
+    /* Stamps of concurrent NA callbacks may be taken out of order */
+    if (*now > hg_core_handle->ext->stamps[from])
+        latency = hg_time_ticks_to_ns(*now - hg_core_handle->ext->stamps[from]);
+
+    hg_histogram_record(&hg_core_rpc_info->stats->latency[stage], latency);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_latency_forward(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_time_ticks_t now;
+
+    if (!HG_CORE_HANDLE_CLASS(hg_core_handle)->latency_stats ||
+        hg_core_handle->ret != HG_SUCCESS)
+        return;
+
+    now = hg_time_get_ticks();
+    if (hg_core_handle->stamped & HG_CORE_STAMP_BIT(HG_CORE_STAMP_SENT))
+        hg_core_latency_record(hg_core_handle, HG_LATENCY_ORIGIN_SEND,
+            HG_CORE_STAMP_FORWARD,
+            &hg_core_handle->ext->stamps[HG_CORE_STAMP_SENT]);
+    if (hg_core_handle->stamped & HG_CORE_STAMP_BIT(HG_CORE_STAMP_RECV)) {
+        hg_core_latency_record(hg_core_handle, HG_LATENCY_ORIGIN_WAIT,
+            HG_CORE_STAMP_SENT,
+            &hg_core_handle->ext->stamps[HG_CORE_STAMP_RECV]);
+        hg_core_latency_record(hg_core_handle, HG_LATENCY_ORIGIN_TRIGGER,
+            HG_CORE_STAMP_RECV, &now);
+    }
+    hg_core_latency_record(
+        hg_core_handle, HG_LATENCY_ORIGIN_TOTAL, HG_CORE_STAMP_FORWARD, &now);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_latency_respond(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_time_ticks_t now;
+
+    if (!HG_CORE_HANDLE_CLASS(hg_core_handle)->latency_stats)
+        return;
+
+    now = hg_time_get_ticks();
+    hg_core_latency_record(hg_core_handle, HG_LATENCY_TARGET_HANDLER,
+        HG_CORE_STAMP_DISPATCH, &now);
+    hg_core_latency_record(
+        hg_core_handle, HG_LATENCY_TARGET_TOTAL, HG_CORE_STAMP_RECEIVED, &now);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_core_func_map_hash(hg_id_t id)
+{
+    /* Fibonacci hashing, IDs generated from strings may not be well
+     * distributed over lower bits */
+    return (unsigned int) (((hg_uint64_t) id * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_uint8_t
+hg_core_shard_id(hg_id_t id, hg_uint64_t key, hg_uint8_t shard_count)
+{
+    hg_uint64_t h = id ^ (key * 0x9E3779B97F4A7C15ULL);
+
+    /* Final mix of splitmix64 so that all bits of ID and key contribute */
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+
+    return (hg_uint8_t) (h % shard_count);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_func_map *
+hg_core_func_map_alloc(unsigned int size)
+{
+    struct hg_core_func_map *hg_core_func_map = NULL;
+    unsigned int i;
+
+    hg_core_func_map =
+        (struct hg_core_func_map *) malloc(sizeof(struct hg_core_func_map));
+    HG_CHECK_ERROR_NORET(
+        hg_core_func_map == NULL, error, "Could not allocate function map");
+
+    hg_core_func_map->entries = (struct hg_core_func_map_entry *) malloc(
+        sizeof(struct hg_core_func_map_entry) * size);
+    HG_CHECK_ERROR_NORET(hg_core_func_map->entries == NULL, error,
+        "Could not allocate function map entries");
+
+    for (i = 0; i < size; i++) {
+        hg_atomic_init64(&hg_core_func_map->entries[i].rpc_info, 0);
+        hg_core_func_map->entries[i].id = 0;
+        hg_atomic_init32(&hg_core_func_map->entries[i].used, 0);
+    }
+    hg_core_func_map->prev = NULL;
+    hg_core_func_map->mask = size - 1;
+    hg_core_func_map->count = 0;
+
+    return hg_core_func_map;
+
+error:
+    free(hg_core_func_map);
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_func_map_free(struct hg_core_func_map *hg_core_func_map)
+{
+    unsigned int i;
+
+    if (!hg_core_func_map)
+        return;
+
+    /* Only the current table owns RPC info */
+    for (i = 0; i <= hg_core_func_map->mask; i++)
+        hg_core_rpc_info_free((struct hg_core_rpc_info *) hg_atomic_get64(
+            &hg_core_func_map->entries[i].rpc_info));
+
+    while (hg_core_func_map) {
+        struct hg_core_func_map *prev = hg_core_func_map->prev;
+
+        free(hg_core_func_map->entries);
+        free(hg_core_func_map);
+        hg_core_func_map = prev;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE struct hg_core_rpc_info *
+hg_core_func_map_lookup(
+    struct hg_core_private_class *hg_core_class, hg_id_t id)
+{
+    struct hg_core_func_map *hg_core_func_map =
+        (struct hg_core_func_map *) hg_atomic_get64(&hg_core_class->func_map);
+    unsigned int i;
+
+    /* Table is never more than half full so probing always terminates */
+    for (i = hg_core_func_map_hash(id) & hg_core_func_map->mask;;
+         i = (i + 1) & hg_core_func_map->mask) {
+        struct hg_core_func_map_entry *entry = &hg_core_func_map->entries[i];
+
+        if (!hg_atomic_get32(&entry->used))
+            return NULL;
+        if (entry->id == id)
+            return (struct hg_core_rpc_info *) hg_atomic_get64(
+                &entry->rpc_info);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_func_map_insert(struct hg_core_private_class *hg_core_class,
+    hg_id_t id, struct hg_core_rpc_info *hg_core_rpc_info)
+{
+    struct hg_core_func_map *hg_core_func_map =
+        (struct hg_core_func_map *) hg_atomic_get64(&hg_core_class->func_map);
+    struct hg_core_func_map_entry *entry;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    /* Grow table if it would become more than half full, readers may still
+     * be accessing the previous table so it is only retired */
+    if (2 * (hg_core_func_map->count + 1) > hg_core_func_map->mask + 1) {
+        struct hg_core_func_map *new_func_map =
+            hg_core_func_map_alloc(2 * (hg_core_func_map->mask + 1));
+        HG_CHECK_ERROR(new_func_map == NULL, done, ret, HG_NOMEM,
+            "Could not grow function map");
+
+        for (i = 0; i <= hg_core_func_map->mask; i++) {
+            hg_util_int64_t rpc_info =
+                hg_atomic_get64(&hg_core_func_map->entries[i].rpc_info);
+            unsigned int j;
+
+            /* Deregistered entries are dropped */
+            if (!rpc_info)
+                continue;
+
+            for (j = hg_core_func_map_hash(hg_core_func_map->entries[i].id) &
+                     new_func_map->mask;
+                 hg_atomic_get32(&new_func_map->entries[j].used);
+                 j = (j + 1) & new_func_map->mask)
+                continue;
+            new_func_map->entries[j].id = hg_core_func_map->entries[i].id;
+            hg_atomic_init64(&new_func_map->entries[j].rpc_info, rpc_info);
+            hg_atomic_init32(&new_func_map->entries[j].used, 1);
+            new_func_map->count++;
+        }
+        new_func_map->prev = hg_core_func_map;
+
+        /* Publish new table */
+        hg_atomic_set64(
+            &hg_core_class->func_map, (hg_util_int64_t) new_func_map);
+        hg_core_func_map = new_func_map;
+    }
+
+    for (i = hg_core_func_map_hash(id) & hg_core_func_map->mask;;
+         i = (i + 1) & hg_core_func_map->mask) {
+        entry = &hg_core_func_map->entries[i];
+
+        if (!hg_atomic_get32(&entry->used) || entry->id == id)
+            break;
+    }
+
+    if (hg_atomic_get32(&entry->used)) {
+        /* Re-use deregistered entry */
+        HG_CHECK_ERROR(hg_atomic_get64(&entry->rpc_info) != 0, done, ret,
+            HG_INVALID_ARG, "RPC ID already registered");
+        hg_atomic_set64(&entry->rpc_info, (hg_util_int64_t) hg_core_rpc_info);
+    } else {
+        /* ID and RPC info must be visible before entry is marked as used */
+        entry->id = id;
+        hg_atomic_set64(&entry->rpc_info, (hg_util_int64_t) hg_core_rpc_info);
+        hg_atomic_set32(&entry->used, 1);
+        hg_core_func_map->count++;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_rpc_info *
+hg_core_func_map_remove(struct hg_core_private_class *hg_core_class, hg_id_t id)
+{
+    struct hg_core_func_map *hg_core_func_map =
+        (struct hg_core_func_map *) hg_atomic_get64(&hg_core_class->func_map);
+    unsigned int i;
+
+    for (i = hg_core_func_map_hash(id) & hg_core_func_map->mask;;
+         i = (i + 1) & hg_core_func_map->mask) {
+        struct hg_core_func_map_entry *entry = &hg_core_func_map->entries[i];
+
+        if (!hg_atomic_get32(&entry->used))
+            return NULL;
+        if (entry->id == id) {
+            struct hg_core_rpc_info *hg_core_rpc_info =
+                (struct hg_core_rpc_info *) hg_atomic_get64(&entry->rpc_info);
+
+            /* Entry is kept so that probing sequences remain valid */
+            hg_atomic_set64(&entry->rpc_info, 0);
+
+            return hg_core_rpc_info;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_rpc_info_free(struct hg_core_rpc_info *hg_core_rpc_info)
+{
+    if (!hg_core_rpc_info)
+        return;
+
+    if (hg_core_rpc_info->free_callback)
+        hg_core_rpc_info->free_callback(hg_core_rpc_info->data);
+    hg_core_stats_free(hg_core_rpc_info->stats);
+    free(hg_core_rpc_info);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_rpc_table *
+hg_core_rpc_table_alloc(unsigned int size)
+{
+    struct hg_core_rpc_table *hg_core_rpc_table = NULL;
+    unsigned int i;
+
+    hg_core_rpc_table =
+        (struct hg_core_rpc_table *) malloc(sizeof(struct hg_core_rpc_table));
+    HG_CHECK_ERROR_NORET(
+        hg_core_rpc_table == NULL, error, "Could not allocate RPC table");
+
+    hg_core_rpc_table->entries =
+        (hg_atomic_int64_t *) malloc(sizeof(hg_atomic_int64_t) * size);
+    HG_CHECK_ERROR_NORET(hg_core_rpc_table->entries == NULL, error,
+        "Could not allocate RPC table entries");
+
+    for (i = 0; i < size; i++)
+        hg_atomic_init64(&hg_core_rpc_table->entries[i], 0);
+    hg_core_rpc_table->prev = NULL;
+    hg_core_rpc_table->size = size;
+
+    return hg_core_rpc_table;
+
+error:
+    free(hg_core_rpc_table);
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_rpc_table_free(struct hg_core_rpc_table *hg_core_rpc_table)
+{
+    while (hg_core_rpc_table) {
+        struct hg_core_rpc_table *prev = hg_core_rpc_table->prev;
+
+        free(hg_core_rpc_table->entries);
+        free(hg_core_rpc_table);
+        hg_core_rpc_table = prev;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE struct hg_core_rpc_info *
+hg_core_rpc_table_lookup(
+    struct hg_core_private_class *hg_core_class, hg_uint16_t index)
+{
+    struct hg_core_rpc_table *hg_core_rpc_table =
+        (struct hg_core_rpc_table *) hg_atomic_get64(&hg_core_class->rpc_table);
+
+    if (index == 0 || index > hg_core_rpc_table->size)
+        return NULL;
+
+    return (struct hg_core_rpc_info *) hg_atomic_get64(
+        &hg_core_rpc_table->entries[index - 1]);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_rpc_table_insert(struct hg_core_private_class *hg_core_class,
+    struct hg_core_rpc_info *hg_core_rpc_info)
+{
+    struct hg_core_rpc_table *hg_core_rpc_table =
+        (struct hg_core_rpc_table *) hg_atomic_get64(&hg_core_class->rpc_table);
+
+    /* Indices must fit in 16 bits, other RPCs are sent with their ID */
+    hg_core_rpc_info->index = 0;
+    if (hg_core_class->rpc_table_count >= UINT16_MAX)
+        return;
+
+    /* Grow table, readers may still be accessing the previous table so it is
+     * only retired */
+    if (hg_core_class->rpc_table_count == hg_core_rpc_table->size) {
+        struct hg_core_rpc_table *new_rpc_table =
+            hg_core_rpc_table_alloc(2 * hg_core_rpc_table->size);
+        unsigned int i;
+
+        HG_CHECK_ERROR_NORET(
+            new_rpc_table == NULL, done, "Could not grow RPC table");
+
+        for (i = 0; i < hg_core_rpc_table->size; i++)
+            hg_atomic_init64(&new_rpc_table->entries[i],
+                hg_atomic_get64(&hg_core_rpc_table->entries[i]));
+        new_rpc_table->prev = hg_core_rpc_table;
+
+        /* Publish new table */
+        hg_atomic_set64(
+            &hg_core_class->rpc_table, (hg_util_int64_t) new_rpc_table);
+        hg_core_rpc_table = new_rpc_table;
+    }
+
+    hg_atomic_set64(&hg_core_rpc_table->entries[hg_core_class->rpc_table_count],
+        (hg_util_int64_t) hg_core_rpc_info);
+    hg_core_rpc_info->index = (hg_uint16_t) ++hg_core_class->rpc_table_count;
+
+done:
+    return;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_rpc_table_remove(struct hg_core_private_class *hg_core_class,
+    struct hg_core_rpc_info *hg_core_rpc_info)
+{
+    struct hg_core_rpc_table *hg_core_rpc_table =
+        (struct hg_core_rpc_table *) hg_atomic_get64(&hg_core_class->rpc_table);
+
+    if (hg_core_rpc_info->index == 0)
+        return;
+
+    hg_atomic_set64(
+        &hg_core_rpc_table->entries[hg_core_rpc_info->index - 1], 0);
+    hg_core_rpc_info->index = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_core_rpc_index_hash(hg_hash_table_key_t key)
+{
+    return hg_core_func_map_hash(*(const hg_id_t *) key);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_core_rpc_index_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return *(const hg_id_t *) key1 == *(const hg_id_t *) key2;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_uint16_t
+hg_core_addr_rpc_index_get(
+    struct hg_core_private_addr *hg_core_addr, hg_id_t id)
+{
+    struct hg_core_rpc_index_entry *entry = NULL;
+
+    hg_thread_spin_lock(&hg_core_addr->rpc_index_lock);
+    if (hg_core_addr->rpc_index)
+        entry = (struct hg_core_rpc_index_entry *) hg_hash_table_lookup(
+            hg_core_addr->rpc_index, (hg_hash_table_key_t) &id);
+    hg_thread_spin_unlock(&hg_core_addr->rpc_index_lock);
+
+    return (entry) ? entry->index : 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_rpc_index_set(
+    struct hg_core_private_addr *hg_core_addr, hg_id_t id, hg_uint16_t index)
+{
+    struct hg_core_rpc_index_entry *entry;
+
+    hg_thread_spin_lock(&hg_core_addr->rpc_index_lock);
+
+    if (!hg_core_addr->rpc_index) {
+        if (index == 0)
+            goto unlock;
+        hg_core_addr->rpc_index =
+            hg_hash_table_new(hg_core_rpc_index_hash, hg_core_rpc_index_equal);
+        HG_CHECK_ERROR_NORET(hg_core_addr->rpc_index == NULL, unlock,
+            "Could not create RPC index table");
+        hg_hash_table_register_free_functions(
+            hg_core_addr->rpc_index, NULL, free);
+    }
+
+    entry = (struct hg_core_rpc_index_entry *) hg_hash_table_lookup(
+        hg_core_addr->rpc_index, (hg_hash_table_key_t) &id);
+    if (entry) {
+        if (index)
+            entry->index = index;
+        else
+            hg_hash_table_remove(
+                hg_core_addr->rpc_index, (hg_hash_table_key_t) &id);
+    } else if (index) {
+        entry = (struct hg_core_rpc_index_entry *) malloc(
+            sizeof(struct hg_core_rpc_index_entry));
+        HG_CHECK_ERROR_NORET(
+            entry == NULL, unlock, "Could not allocate RPC index entry");
+        entry->id = id;
+        entry->index = index;
+        if (!hg_hash_table_insert(hg_core_addr->rpc_index,
+                (hg_hash_table_key_t) &entry->id,
+                (hg_hash_table_value_t) entry))
+            free(entry);
+    }
+
+unlock:
+    hg_thread_spin_unlock(&hg_core_addr->rpc_index_lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE na_tag_t
+hg_core_gen_request_tag(struct hg_core_private_context *context)
+{
+    na_tag_t request_tag;
+
+    hg_thread_spin_lock(&context->request_tag_lock);
+    request_tag = hg_core_gen_request_tag_locked(context);
+    hg_thread_spin_unlock(&context->request_tag_lock);
+
+    return request_tag;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE na_tag_t
+hg_core_gen_request_tag_locked(struct hg_core_private_context *context)
+{
+    if (context->request_tag == context->request_tag_end) {
+        struct hg_core_private_class *hg_core_class =
+            HG_CORE_CONTEXT_CLASS(context);
+        na_uint32_t block =
+            (na_uint32_t) hg_atomic_incr32(&hg_core_class->request_tag) %
+            hg_core_class->request_tag_block_count;
+
+        /* Blocks wrap around once all tags below max tag were given */
+        context->request_tag = block * hg_core_class->request_tag_block;
+        context->request_tag_end =
+            context->request_tag + hg_core_class->request_tag_block;
+    }
+
+    return context->request_tag++;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_core_is_big_endian(void)
+{
+    const hg_uint16_t value = 1;
+
+    return (*(const hg_uint8_t *) &value == 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_set_header_size(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t compact)
+{
+    /* Responses use the same format as requests */
+    hg_core_handle->in_header.compact = compact;
+    hg_core_handle->out_header.compact = compact;
+    if (compact) {
+        hg_core_handle->core_handle.in_header_size =
+            hg_core_header_request_get_compact_size(
+                hg_core_handle->core_handle.info.id,
+                hg_core_handle->in_header.index);
+        hg_core_handle->core_handle.out_header_size =
+            hg_core_header_response_get_compact_size(
+                hg_core_handle->out_header.index);
+    } else {
+        hg_core_handle->in_header.index = 0;
+        hg_core_handle->out_header.index = 0;
+        hg_core_handle->core_handle.in_header_size =
+            hg_core_header_request_get_size();
+        hg_core_handle->core_handle.out_header_size =
+            hg_core_header_response_get_size();
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_proc_header_request(struct hg_core_handle *hg_core_handle,
+    struct hg_core_header *hg_core_header, hg_proc_op_t op)
+{
+    char *header_buf =
+        (char *) hg_core_handle->in_buf + hg_core_handle->na_in_header_offset;
+    size_t header_buf_size =
+        hg_core_handle->in_buf_size - hg_core_handle->na_in_header_offset;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Proc request header */
+    ret = hg_core_header_request_proc(
+        op, header_buf, header_buf_size, hg_core_header);
+    HG_CHECK_HG_ERROR(done, ret, "Could not process request header");
+
+    if (op == HG_DECODE) {
+        ret = hg_core_header_request_verify(hg_core_header);
+        HG_CHECK_HG_ERROR(done, ret, "Could not verify request header");
+
+        hg_core_handle->in_swapped = (hg_bool_t) HG_CORE_IS_SWAPPED(
+            hg_core_header->msg.request.flags);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_proc_header_response(struct hg_core_handle *hg_core_handle,
+    struct hg_core_header *hg_core_header, hg_proc_op_t op)
+{
+    char *header_buf =
+        (char *) hg_core_handle->out_buf + hg_core_handle->na_out_header_offset;
+    size_t header_buf_size =
+        hg_core_handle->out_buf_size - hg_core_handle->na_out_header_offset;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Proc response header */
+    ret = hg_core_header_response_proc(
+        op, header_buf, header_buf_size, hg_core_header);
+    HG_CHECK_HG_ERROR(done, ret, "Could not process response header");
+
+    if (op == HG_DECODE) {
+        ret = hg_core_header_response_verify(hg_core_header);
+        HG_CHECK_HG_ERROR(done, ret, "Could not verify response header");
+
+        hg_core_handle->out_swapped = (hg_bool_t) HG_CORE_IS_SWAPPED(
+            hg_core_header->msg.response.flags);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_private_class *
+hg_core_init(const char *na_info_string, hg_bool_t na_listen,
+    const struct hg_init_info *hg_init_info)
+{
+    struct hg_core_private_class *hg_core_class = NULL;
+    na_tag_t na_max_tag;
+#ifdef NA_HAS_SM
+    na_tag_t na_sm_max_tag;
+    const char *na_class_name;
+    hg_bool_t auto_sm = HG_FALSE;
+#endif
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Create new HG class */
+    hg_core_class = (struct hg_core_private_class *) malloc(
+        sizeof(struct hg_core_private_class));
+    HG_CHECK_ERROR(hg_core_class == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG class");
+    memset(hg_core_class, 0, sizeof(struct hg_core_private_class));
+
+    /* Stat counters are always collected */
+    hg_core_class->stats = hg_core_stats_alloc(HG_FALSE);
+    HG_CHECK_ERROR(hg_core_class->stats == NULL, error, ret, HG_NOMEM,
+        "Could not allocate stat counters");
+    if (hg_thread_key_create(&hg_core_class->stats_shard_key) !=
+        HG_UTIL_SUCCESS) {
+        hg_core_stats_free(hg_core_class->stats);
+        hg_core_class->stats = NULL;
+        HG_GOTO_ERROR(error, ret, HG_NOMEM, "Could not create stat shard key");
+    }
+    hg_atomic_init32(&hg_core_class->stats_shard_next, 0);
+
+    /* Parse options */
+    if (hg_init_info) {
+        /* External NA class */
+        if (hg_init_info->na_class) {
+            hg_core_class->core_class.na_class = hg_init_info->na_class;
+            hg_core_class->na_ext_init = HG_TRUE;
+        }
+        /* request_post_incr is used only if request_post_init is non-zero */
+        if (hg_init_info->request_post_init == 0) {
+            hg_core_class->request_post_init = HG_CORE_POST_INIT;
+            hg_core_class->request_post_incr = HG_CORE_POST_INCR;
+        } else {
+            hg_core_class->request_post_init = hg_init_info->request_post_init;
+            hg_core_class->request_post_incr = hg_init_info->request_post_incr;
+        }
+        /* Adaptive posting needs a base increment to grow from, lazy posting
+         * relies on it to grow from a small base set */
+        hg_core_class->request_post_lazy = hg_init_info->request_post_lazy;
+        hg_core_class->request_post_adaptive =
+            hg_init_info->request_post_adaptive ||
+            hg_init_info->request_post_lazy;
+        if (hg_core_class->request_post_adaptive &&
+            hg_core_class->request_post_incr == 0)
+            hg_core_class->request_post_incr = HG_CORE_POST_INCR;
+        hg_core_class->request_credits = hg_init_info->request_credits;
+        hg_core_class->load_feedback = hg_init_info->load_feedback;
+        hg_core_class->admit_queue_max = hg_init_info->admit_queue_max;
+        hg_core_class->admit_active_max = hg_init_info->admit_active_max;
+        hg_core_class->fair_share = hg_init_info->fair_share;
+        hg_core_class->prealloc_count = hg_init_info->prealloc_count;
+        /* Additional posts stop at whichever limit comes first */
+        hg_core_class->mem_hard_limit = hg_init_info->mem_hard_limit;
+        hg_core_class->mem_post_limit = hg_init_info->mem_soft_limit;
+        if (hg_core_class->mem_post_limit == 0 ||
+            (hg_core_class->mem_hard_limit &&
+                hg_core_class->mem_hard_limit < hg_core_class->mem_post_limit))
+            hg_core_class->mem_post_limit = hg_core_class->mem_hard_limit;
+        hg_core_class->latency_stats = hg_init_info->latency_stats;
+        if (hg_init_info->trace_prefix) {
+            hg_core_class->trace = hg_trace_create(hg_init_info->trace_prefix);
+            HG_CHECK_ERROR(hg_core_class->trace == NULL, error, ret, HG_NOMEM,
+                "Could not create trace");
+            hg_atomic_init64(&hg_core_class->trace_next_id, 0);
+        }
+        hg_core_class->progress_mode = hg_init_info->na_init_info.progress_mode;
+        /* Context IDs are sent as 8-bit cookies in request headers */
+        HG_CHECK_ERROR(
+            hg_init_info->na_init_info.max_contexts > UINT8_MAX + 1, error, ret,
+            HG_INVALID_ARG, "HG supports at most %d contexts (requested %d)",
+            UINT8_MAX + 1, hg_init_info->na_init_info.max_contexts);
+        /* Unexpected recvs are matched across contexts */
+        if (hg_init_info->na_init_info.shared_recv &&
+            hg_init_info->na_init_info.max_contexts > 1)
+            hg_core_class->request_post_shared =
+                hg_init_info->na_init_info.max_contexts;
+#ifdef NA_HAS_SM
+        auto_sm = hg_init_info->auto_sm;
+#else
+        HG_CHECK_WARNING(hg_init_info->auto_sm,
+            "Option auto_sm requested but NA SM pluging was not compiled, "
+            "please turn ON NA_USE_SM in CMake options");
+#endif
+        hg_core_class->loopback = !hg_init_info->no_loopback;
+        hg_core_class->compact_header = hg_init_info->compact_header;
+        hg_core_class->loopback_inline = hg_init_info->loopback_inline;
+        if (hg_init_info->integrated_completion) {
+            int rc = hg_thread_key_create(&hg_core_class->trigger_slot_key);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+                "Could not create trigger slot key");
+            hg_core_class->integrated_completion = HG_TRUE;
+        }
+        hg_core_class->shard_count = hg_init_info->shard_count;
+        hg_core_class->request_coalesce_count =
+            hg_init_info->request_coalesce_count;
+        hg_core_class->request_coalesce_time =
+            hg_init_info->request_coalesce_time;
+        hg_core_class->addr_cache_ttl = hg_init_info->addr_cache_ttl;
+        hg_core_class->addr_cache_neg_ttl = hg_init_info->addr_cache_neg_ttl;
+        hg_core_class->bulk_chunk_size = hg_init_info->bulk_chunk_size;
+        hg_core_class->bulk_max_inflight = hg_init_info->bulk_max_inflight;
+        if (hg_init_info->bulk_self_thread_count > 0) {
+            int rc = hg_thread_pool_init(hg_init_info->bulk_self_thread_count,
+                &hg_core_class->bulk_self_pool);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+                "Could not create bulk self copy thread pool");
+            hg_core_class->bulk_self_thread_count =
+                hg_init_info->bulk_self_thread_count;
+            hg_core_class->bulk_self_offload_size =
+                (hg_init_info->bulk_self_offload_size > 0)
+                    ? hg_init_info->bulk_self_offload_size
+                    : HG_CORE_BULK_SELF_OFFLOAD_SIZE;
+        }
+#ifdef HG_HAS_COLLECT_STATS
+        hg_core_class->print_stats = hg_init_info->stats;
+#endif
+    } else {
+        hg_core_class->request_post_init = HG_CORE_POST_INIT;
+        hg_core_class->request_post_incr = HG_CORE_POST_INCR;
+        hg_core_class->loopback = HG_TRUE;
+    }
+
+    /* Initialize NA if not provided externally */
+    if (!hg_core_class->na_ext_init) {
+        hg_core_class->core_class.na_class = NA_Initialize_opt(
+            na_info_string, na_listen, &hg_init_info->na_init_info);
+        HG_CHECK_ERROR(hg_core_class->core_class.na_class == NULL, error, ret,
+            HG_NA_ERROR, "Could not initialize NA class");
+    }
+
+#ifdef NA_HAS_SM
+    /* Retrieve NA class name */
+    na_class_name = NA_Get_class_name(hg_core_class->core_class.na_class);
+
+    /* Check for compatibility with SM */
+    if (auto_sm && strcmp(na_class_name, "mpi") == 0) {
+        HG_LOG_WARNING(
+            "Auto SM mode is not compatible with MPI NA class, disabling");
+        auto_sm = HG_FALSE;
+    }
+    if (auto_sm && strcmp(na_class_name, "na") == 0) {
+        HG_LOG_WARNING(
+            "Auto SM mode is set but NA class is already SM, ignoring");
+        auto_sm = HG_FALSE;
+    }
+
+    /* Initialize SM plugin */
+    if (auto_sm) {
+        struct na_init_info na_sm_init_info = hg_init_info->na_init_info;
+        na_return_t na_ret;
+
+        /* Place SM resources on the node that was resolved for the NIC */
+        na_sm_init_info.numa_node =
+            NA_Get_numa_node(hg_core_class->core_class.na_class);
+
+        /* Initialize NA SM first so that tmp directories are created */
+        hg_core_class->core_class.na_sm_class =
+            NA_Initialize_opt("na+sm", na_listen, &na_sm_init_info);
+        HG_CHECK_ERROR(hg_core_class->core_class.na_sm_class == NULL, error,
+            ret, HG_NA_ERROR, "Could not initialize NA SM class");
+
+        /* Get SM host ID */
+        na_ret = NA_SM_Host_id_get(&hg_core_class->host_id);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "NA_SM_Host_id_get() failed (%s)", NA_Error_to_string(na_ret));
+    }
+#endif
+
+    /* Initialize rails that bulk transfers are striped across */
+    if (hg_init_info && hg_init_info->na_rails) {
+        ret = hg_core_rails_init(hg_core_class, hg_init_info->na_rails,
+            &hg_init_info->na_init_info);
+        HG_CHECK_HG_ERROR(error, ret, "Could not initialize NA rails");
+    }
+
+    /* Compute max request tag */
+    na_max_tag = NA_Msg_get_max_tag(hg_core_class->core_class.na_class);
+    HG_CHECK_ERROR(
+        na_max_tag == 0, error, ret, HG_NA_ERROR, "NA Max tag is not defined");
+    hg_core_class->request_max_tag = na_max_tag;
+
+#ifdef NA_HAS_SM
+    if (auto_sm) {
+        na_sm_max_tag =
+            NA_Msg_get_max_tag(hg_core_class->core_class.na_sm_class);
+        HG_CHECK_ERROR(na_sm_max_tag == 0, error, ret, HG_NA_ERROR,
+            "NA Max tag is not defined");
+        hg_core_class->request_max_tag =
+            HG_CORE_MIN(hg_core_class->request_max_tag, na_sm_max_tag);
+    }
+#endif
+
+    /* Initialize atomic for tag blocks */
+    hg_core_class->request_tag_block = HG_CORE_MIN(
+        (na_tag_t) HG_CORE_REQUEST_TAG_BLOCK, hg_core_class->request_max_tag);
+    hg_core_class->request_tag_block_count =
+        hg_core_class->request_max_tag / hg_core_class->request_tag_block;
+    hg_atomic_init32(&hg_core_class->request_tag, 0);
+
+    /* No context created yet */
+    hg_atomic_init32(&hg_core_class->n_contexts, 0);
+
+    /* No addr created yet */
+    hg_atomic_init32(&hg_core_class->n_addrs, 0);
+    hg_atomic_init32(&hg_core_class->select_seed, 0);
+
+    /* Create new function map */
+    hg_atomic_init64(&hg_core_class->func_map,
+        (hg_util_int64_t) hg_core_func_map_alloc(HG_CORE_FUNC_MAP_INIT_SIZE));
+    HG_CHECK_ERROR(hg_atomic_get64(&hg_core_class->func_map) == 0, error, ret,
+        HG_NOMEM, "Could not create function map");
+
+    /* Create dense RPC table */
+    hg_atomic_init64(&hg_core_class->rpc_table,
+        (hg_util_int64_t) hg_core_rpc_table_alloc(HG_CORE_RPC_TABLE_INIT_SIZE));
+    HG_CHECK_ERROR(hg_atomic_get64(&hg_core_class->rpc_table) == 0, error, ret,
+        HG_NOMEM, "Could not create RPC table");
+    hg_core_class->rpc_table_count = 0;
+
+    /* Initialize mutex */
+    hg_thread_spin_init(&hg_core_class->func_map_lock);
+
+    /* Create lookup cache */
+    if (hg_core_class->addr_cache_ttl) {
+        ret = hg_core_addr_cache_init(hg_core_class, hg_init_info);
+        HG_CHECK_HG_ERROR(error, ret, "Could not create address cache");
+    }
+
+    /* Create pool of registered memory */
+    ret = hg_bulk_mem_pool_create(
+        &hg_core_class->core_class, &hg_core_class->bulk_mem_pool);
+    HG_CHECK_HG_ERROR(error, ret, "Could not create registered memory pool");
+
+    /* Create cache of remote bulk handles */
+    if (hg_init_info && hg_init_info->bulk_cache_size > 0) {
+        ret = hg_bulk_cache_create(
+            hg_init_info->bulk_cache_size, &hg_core_class->bulk_cache);
+        HG_CHECK_HG_ERROR(error, ret, "Could not create bulk handle cache");
+    }
+
+    // TODO return error code
+    (void) ret;
+    return hg_core_class;
+
+error:
+    hg_core_finalize(hg_core_class);
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_finalize(struct hg_core_private_class *hg_core_class)
+{
+    hg_util_int32_t n_addrs, n_contexts;
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+    unsigned int i;
+
+    if (!hg_core_class)
+        goto done;
+
+    n_contexts = hg_atomic_get32(&hg_core_class->n_contexts);
+    HG_CHECK_ERROR(n_contexts != 0, done, ret, HG_BUSY,
+        "HG contexts must be destroyed before finalizing HG (%d remaining)",
+        n_contexts);
+
+    /* Release addresses held by lookup cache */
+    hg_core_addr_cache_finalize(hg_core_class);
+
+    /* Cached handles may hold addresses */
+    hg_bulk_cache_destroy(hg_core_class->bulk_cache);
+    hg_core_class->bulk_cache = NULL;
+
+    n_addrs = hg_atomic_get32(&hg_core_class->n_addrs);
+    HG_CHECK_ERROR(n_addrs != 0, done, ret, HG_BUSY,
+        "HG addrs must be freed before finalizing HG (%d remaining)", n_addrs);
+
+#ifdef HG_HAS_COLLECT_STATS
+    if (hg_core_class->print_stats)
+        hg_core_print_stats(hg_core_class);
+#endif
+
+    /* Delete function map */
+    hg_core_func_map_free(
+        (struct hg_core_func_map *) hg_atomic_get64(&hg_core_class->func_map));
+    hg_atomic_set64(&hg_core_class->func_map, 0);
+
+    /* Delete dense RPC table */
+    hg_core_rpc_table_free((struct hg_core_rpc_table *) hg_atomic_get64(
+        &hg_core_class->rpc_table));
+    hg_atomic_set64(&hg_core_class->rpc_table, 0);
+
+    /* Free user data */
+    if (hg_core_class->core_class.data_free_callback)
+        hg_core_class->core_class.data_free_callback(
+            hg_core_class->core_class.data);
+
+    /* Destroy mutex */
+    hg_thread_spin_destroy(&hg_core_class->func_map_lock);
+
+    /* Wait for offloaded bulk copies */
+    if (hg_core_class->bulk_self_pool)
+        hg_thread_pool_destroy(hg_core_class->bulk_self_pool);
+
+    if (hg_core_class->integrated_completion)
+        hg_thread_key_delete(hg_core_class->trigger_slot_key);
+
+    if (hg_core_class->stats) {
+        hg_thread_key_delete(hg_core_class->stats_shard_key);
+        hg_core_stats_free(hg_core_class->stats);
+    }
+
+    /* Unmap and close trace files */
+    hg_trace_destroy(hg_core_class->trace);
+
+    /* Deregister memory of pool before NA is finalized */
+    hg_bulk_mem_pool_destroy(hg_core_class->bulk_mem_pool);
+
+    if (!hg_core_class->na_ext_init) {
+        /* Finalize interface */
+        na_ret = NA_Finalize(hg_core_class->core_class.na_class);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not finalize NA interface (%s)", NA_Error_to_string(na_ret));
+        hg_core_class->core_class.na_class = NULL;
+    }
+
+#ifdef NA_HAS_SM
+    /* Finalize SM interface */
+    na_ret = NA_Finalize(hg_core_class->core_class.na_sm_class);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not finalize NA SM interface (%s)", NA_Error_to_string(na_ret));
+#endif
+
+    /* Finalize rails */
+    for (i = 0; i < hg_core_class->core_class.na_rail_count; i++) {
+        na_class_t *na_rail_class =
+            hg_core_class->core_class.na_rail_classes[i];
+
+        if (hg_core_class->core_class.na_rail_self_addrs[i] != NA_ADDR_NULL) {
+            na_ret = NA_Addr_free(
+                na_rail_class, hg_core_class->core_class.na_rail_self_addrs[i]);
+            HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret,
+                (hg_return_t) na_ret, "Could not free rail self address (%s)",
+                NA_Error_to_string(na_ret));
+        }
+        na_ret = NA_Finalize(na_rail_class);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not finalize NA rail interface (%s)",
+            NA_Error_to_string(na_ret));
+    }
+
+    /* Free HG class */
+    free(hg_core_class);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_create(hg_core_class_t *hg_core_class, hg_uint8_t id,
+    struct hg_core_private_context **context_ptr)
+{
+    struct hg_core_private_context *context = NULL;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+    int na_poll_fd;
+
+    context = (struct hg_core_private_context *) malloc(
+        sizeof(struct hg_core_private_context));
+    HG_CHECK_ERROR(
+        context == NULL, error, ret, HG_NOMEM, "Could not allocate HG context");
+
+    memset(context, 0, sizeof(struct hg_core_private_context));
+    context->core_context.core_class = hg_core_class;
+    for (i = 0; i < HG_PRIORITY_MAX; i++) {
+        context->completion_queues[i] =
+            hg_atomic_seg_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE);
+        HG_CHECK_ERROR(context->completion_queues[i] == NULL, error, ret,
+            HG_NOMEM, "Could not allocate queue");
+    }
+    hg_atomic_init32(&context->trigger_round, 0);
+    if (HG_CORE_CONTEXT_CLASS(context)->fair_share) {
+        context->fair_scheds = (struct hg_core_fair_sched *) calloc(
+            HG_PRIORITY_MAX, sizeof(struct hg_core_fair_sched));
+        HG_CHECK_ERROR(context->fair_scheds == NULL, error, ret, HG_NOMEM,
+            "Could not allocate fair-share schedulers");
+        for (i = 0; i < HG_PRIORITY_MAX; i++) {
+            unsigned int j;
+
+            for (j = 0; j < HG_CORE_FAIR_BUCKETS; j++)
+                HG_QUEUE_INIT(&context->fair_scheds[i].buckets[j].queue);
+            HG_QUEUE_INIT(&context->fair_scheds[i].active_list);
+            hg_thread_spin_init(&context->fair_scheds[i].lock);
+        }
+    }
+
+    HG_LIST_INIT(&context->pending_list);
+#ifdef NA_HAS_SM
+    HG_LIST_INIT(&context->sm_pending_list);
+#endif
+#ifdef HG_HAS_DEBUG
+    HG_LIST_INIT(&context->created_list);
+#endif
+    HG_LIST_INIT(&context->handle_pool);
+#ifdef NA_HAS_SM
+    HG_LIST_INIT(&context->sm_handle_pool);
+#endif
+    HG_LIST_INIT(&context->coalesce_list);
+    HG_LIST_INIT(&context->coalesce_response_list);
+    HG_LIST_INIT(&context->coalesce_pool);
+    HG_LIST_INIT(&context->coalesce_wait_list);
+    hg_thread_mutex_init(&context->coalesce_mutex);
+    hg_atomic_init32(&context->coalesce_pending, 0);
+
+    /* No handle created yet */
+    hg_atomic_init32(&context->n_handles, 0);
+
+    /* No thread is polling yet */
+    hg_atomic_init32(&context->progressing, 0);
+#ifdef NA_HAS_SM
+    hg_atomic_init32(&context->sm_active, 0);
+    context->sm_idle_count = 0;
+#endif
+    hg_atomic_init32(&context->progress_waiters, 0);
+    hg_atomic_init32(&context->trigger_waiters, 0);
+    hg_atomic_init32(&context->progress_threads_exit, 0);
+
+    /* Notifications of completion queue events */
+    hg_atomic_init32(&context->completion_queue_must_notify, 0);
+
+    /* Initialize completion queue mutex/cond */
+    hg_thread_mutex_init(&context->completion_queue_mutex);
+    hg_thread_cond_init(&context->completion_queue_cond);
+
+    hg_thread_spin_init(&context->pending_list_lock);
+#ifdef HG_HAS_DEBUG
+    hg_thread_spin_init(&context->created_list_lock);
+#endif
+    hg_thread_spin_init(&context->handle_pool_lock);
+
+    /* Tag block is taken on first forward */
+    hg_thread_spin_init(&context->request_tag_lock);
+    context->request_tag = 0;
+    context->request_tag_end = 0;
+
+    /* Deadlines of timed forwards */
+    hg_thread_spin_init(&context->timer_lock);
+    hg_atomic_init32(&context->timer_count, 0);
+    for (i = 0; i < HG_MEM_USE_MAX; i++)
+        hg_atomic_init64(&context->mem_bytes[i], 0);
+    hg_atomic_init32(&context->mem_throttle_count, 0);
+    hg_atomic_init32(&context->alloc_fallback_count, 0);
+    context->timer_wheel = hg_timer_wheel_create(hg_core_time_ms());
+    HG_CHECK_ERROR(context->timer_wheel == NULL, error, ret, HG_NOMEM,
+        "Could not create timer wheel");
+
+    /* Create NA context */
+    context->core_context.na_context =
+        NA_Context_create_id(hg_core_class->na_class, id);
+    HG_CHECK_ERROR(context->core_context.na_context == NULL, error, ret,
+        HG_NOMEM, "Could not create NA context");
+
+#ifdef NA_HAS_SM
+    if (hg_core_class->na_sm_class) {
+        context->core_context.na_sm_context =
+            NA_Context_create(hg_core_class->na_sm_class);
+        HG_CHECK_ERROR(context->core_context.na_sm_context == NULL, error, ret,
+            HG_NOMEM, "Could not create NA SM context");
+    }
+#endif
+
+    /* Create NA rail contexts */
+    for (i = 0; i < hg_core_class->na_rail_count; i++) {
+        context->core_context.na_rail_contexts[i] =
+            NA_Context_create(hg_core_class->na_rail_classes[i]);
+        HG_CHECK_ERROR(context->core_context.na_rail_contexts[i] == NULL,
+            error, ret, HG_NOMEM, "Could not create NA rail context");
+    }
+
+    /* Report NA retries to instrumentation hooks */
+    if (HG_CORE_CONTEXT_CLASS(context)->hooks.callbacks[HG_HOOK_RETRY]) {
+        (void) NA_Context_set_retry_callback(context->core_context.na_context,
+            hg_core_hook_na_retry, context);
+#ifdef NA_HAS_SM
+        if (context->core_context.na_sm_context)
+            (void) NA_Context_set_retry_callback(
+                context->core_context.na_sm_context, hg_core_hook_na_retry,
+                context);
+#endif
+        for (i = 0; i < hg_core_class->na_rail_count; i++)
+            (void) NA_Context_set_retry_callback(
+                context->core_context.na_rail_contexts[i],
+                hg_core_hook_na_retry, context);
+    }
+
+    /* Let NA add completions directly to the HG completion queue */
+    if (HG_CORE_CONTEXT_CLASS(context)->integrated_completion) {
+        na_return_t na_ret =
+            NA_Context_set_completion_sink(context->core_context.na_context,
+                hg_core_completion_sink, context);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "Could not set NA completion sink (%s)",
+            NA_Error_to_string(na_ret));
+#ifdef NA_HAS_SM
+        if (context->core_context.na_sm_context) {
+            na_ret = NA_Context_set_completion_sink(
+                context->core_context.na_sm_context, hg_core_completion_sink,
+                context);
+            HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret,
+                (hg_return_t) na_ret,
+                "Could not set NA SM completion sink (%s)",
+                NA_Error_to_string(na_ret));
+        }
+#endif
+        for (i = 0; i < hg_core_class->na_rail_count; i++) {
+            na_ret = NA_Context_set_completion_sink(
+                context->core_context.na_rail_contexts[i],
+                hg_core_completion_sink, context);
+            HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret,
+                (hg_return_t) na_ret,
+                "Could not set NA rail completion sink (%s)",
+                NA_Error_to_string(na_ret));
+        }
+    }
+
+    /* If NA plugin exposes fd, we will use poll set and use appropriate
+     * progress function */
+    na_poll_fd = NA_Poll_get_fd(
+        hg_core_class->na_class, context->core_context.na_context);
+
+    if (!(HG_CORE_CONTEXT_CLASS(context)->progress_mode & NA_NO_BLOCK) &&
+        (na_poll_fd > 0)) {
+        struct hg_poll_event event = {.events = HG_POLLIN, .data.u64 = 0};
+        int rc;
+
+        /* Create poll set */
+        context->poll_set = hg_poll_create();
+        HG_CHECK_ERROR(context->poll_set == NULL, error, ret, HG_NOMEM,
+            "Could not create poll set");
+
+        event.data.u32 = (hg_util_uint32_t) HG_CORE_POLL_NA;
+        rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+            "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
+
+#ifdef NA_HAS_SM
+        if (context->core_context.na_sm_context) {
+            na_poll_fd = NA_Poll_get_fd(hg_core_class->na_sm_class,
+                context->core_context.na_sm_context);
+            HG_CHECK_ERROR(na_poll_fd < 0, error, ret, HG_PROTOCOL_ERROR,
+                "Could not get NA SM poll fd");
+
+            event.data.u32 = (hg_util_uint32_t) HG_CORE_POLL_SM;
+            rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+                "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
+        }
+#endif
+
+        for (i = 0; i < hg_core_class->na_rail_count; i++) {
+            na_poll_fd = NA_Poll_get_fd(hg_core_class->na_rail_classes[i],
+                context->core_context.na_rail_contexts[i]);
+            HG_CHECK_ERROR(na_poll_fd <= 0, error, ret, HG_PROTOCOL_ERROR,
+                "Could not get NA rail poll fd");
+
+            event.data.u32 = (hg_util_uint32_t) HG_CORE_POLL_RAIL + i;
+            rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+                "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
+        }
+
+        if (HG_CORE_CONTEXT_CLASS(context)->loopback) {
+            /* Create event for completion queue notification */
+            context->completion_queue_notify = hg_event_create();
+            HG_CHECK_ERROR(context->completion_queue_notify < 0, error, ret,
+                HG_NOMEM, "Could not create event");
+
+            /* Add event to context poll set, the poll set may consume
+             * notifications itself */
+            event.events = HG_POLLIN | HG_POLLEVENT;
+            event.data.u32 = (hg_util_uint32_t) HG_CORE_POLL_LOOPBACK;
+            rc = hg_poll_add(
+                context->poll_set, context->completion_queue_notify, &event);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+                "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
+        }
+    }
+
+    /* Assign context ID */
+    context->core_context.id = id;
+
+    /* Create pool of bulk op IDs */
+    ret = hg_bulk_op_pool_create((hg_core_context_t *) context,
+        HG_CORE_MAX(HG_CORE_BULK_OP_INIT_COUNT,
+            HG_CORE_CONTEXT_CLASS(context)->prealloc_count),
+        &context->hg_bulk_op_pool);
+    HG_CHECK_HG_ERROR(error, ret, "Could not create bulk op pool");
+
+    /* Preallocate handles so that the hot path does not allocate them */
+    if (HG_CORE_CONTEXT_CLASS(context)->prealloc_count > 0) {
+        ret = hg_core_pool_prealloc(
+            context, HG_CORE_CONTEXT_CLASS(context)->prealloc_count);
+        HG_CHECK_HG_ERROR(error, ret, "Could not preallocate handles");
+    }
+
+    /* Increment context count of parent class */
+    hg_atomic_incr32(&HG_CORE_CONTEXT_CLASS(context)->n_contexts);
+
+    *context_ptr = context;
+
+    return ret;
+
+error:
+    hg_core_context_destroy(context);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_destroy(struct hg_core_private_context *context)
+{
+    hg_util_int32_t n_handles;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+    int rc;
+
+    if (!context)
+        goto done;
+
+    /* Stop progress threads first so that nothing runs concurrently */
+    ret = hg_core_progress_threads_stop(context);
+    HG_CHECK_HG_ERROR(done, ret, "Could not stop progress threads");
+
+    /* Unpost requests */
+    ret = hg_core_context_unpost(context);
+    HG_CHECK_HG_ERROR(done, ret, "Could not unpost requests");
+
+    /* Free pooled handles */
+    ret = hg_core_pool_destroy(&context->handle_pool);
+    HG_CHECK_HG_ERROR(done, ret, "Could not destroy handle pool");
+#ifdef NA_HAS_SM
+    ret = hg_core_pool_destroy(&context->sm_handle_pool);
+    HG_CHECK_HG_ERROR(done, ret, "Could not destroy SM handle pool");
+#endif
+    context->handle_pool_count = 0;
+
+    /* Free batches of coalesced requests, pending batches hold handles */
+    while (!HG_LIST_IS_EMPTY(&context->coalesce_pool)) {
+        struct hg_core_coalesce_batch *hg_core_batch =
+            HG_LIST_FIRST(&context->coalesce_pool);
+
+        HG_LIST_REMOVE(hg_core_batch, entry);
+        hg_core_coalesce_batch_free(hg_core_batch);
+    }
+
+    /* Number of handles for that context should be 0 */
+    n_handles = hg_atomic_get32(&context->n_handles);
+    if (n_handles != 0) {
+#ifdef HG_HAS_DEBUG
+        struct hg_core_private_handle *hg_core_handle = NULL;
+#endif
+        HG_LOG_ERROR("HG core handles must be freed before destroying context "
+                     "(%d remaining)",
+            n_handles);
+#ifdef HG_HAS_DEBUG
+        hg_thread_spin_lock(&context->created_list_lock);
+        HG_LIST_FOREACH (hg_core_handle, &context->created_list, created)
+            HG_LOG_DEBUG("Handle (%p) was not destroyed", hg_core_handle);
+        hg_thread_spin_unlock(&context->created_list_lock);
+#endif
+        ret = HG_BUSY;
+        goto done;
+    }
+
+    /* Check that completion queue is empty now */
+    HG_CHECK_ERROR(!hg_core_completion_queue_is_empty(context), done, ret,
+        HG_BUSY, "Completion queue should be empty");
+    for (i = 0; i < HG_PRIORITY_MAX; i++)
+        hg_atomic_seg_queue_free(context->completion_queues[i]);
+    if (context->fair_scheds) {
+        for (i = 0; i < HG_PRIORITY_MAX; i++)
+            hg_thread_spin_destroy(&context->fair_scheds[i].lock);
+        free(context->fair_scheds);
+    }
+
+    /* Destroy pool of bulk op IDs */
+    if (context->hg_bulk_op_pool) {
+        ret = hg_bulk_op_pool_destroy(context->hg_bulk_op_pool);
+        HG_CHECK_HG_ERROR(done, ret, "Could not destroy bulk op pool");
+    }
+
+    /* Stop listening for events */
+    if (context->completion_queue_notify > 0) {
+        rc =
+            hg_poll_remove(context->poll_set, context->completion_queue_notify);
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
+            "Could not remove self processing event from poll set");
+
+        rc = hg_event_destroy(context->completion_queue_notify);
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
+            "Could not destroy self processing event");
+    }
+
+    if (context->poll_set) {
+        /* If NA plugin exposes fd, remove it from poll set */
+        int na_poll_fd =
+            NA_Poll_get_fd(context->core_context.core_class->na_class,
+                context->core_context.na_context);
+        if (na_poll_fd > 0) {
+            rc = hg_poll_remove(context->poll_set, na_poll_fd);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
+                "Could not remove NA poll descriptor from poll set");
+        }
+    }
+
+#ifdef NA_HAS_SM
+    if (context->core_context.na_sm_context && context->poll_set) {
+        /* If NA plugin exposes fd, remove it from poll set */
+        int na_poll_fd =
+            NA_Poll_get_fd(context->core_context.core_class->na_sm_class,
+                context->core_context.na_sm_context);
+        if (na_poll_fd > 0) {
+            rc = hg_poll_remove(context->poll_set, na_poll_fd);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
+                "Could not remove NA poll descriptor from poll set");
+        }
+    }
+#endif
+
+    for (i = 0; i < context->core_context.core_class->na_rail_count; i++) {
+        int na_poll_fd;
+
+        if (!context->core_context.na_rail_contexts[i] || !context->poll_set)
+            continue;
+        na_poll_fd =
+            NA_Poll_get_fd(context->core_context.core_class->na_rail_classes[i],
+                context->core_context.na_rail_contexts[i]);
+        if (na_poll_fd > 0) {
+            rc = hg_poll_remove(context->poll_set, na_poll_fd);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
+                "Could not remove NA rail poll descriptor from poll set");
+        }
+    }
+
+    /* Destroy poll set */
+    if (context->poll_set) {
+        rc = hg_poll_destroy(context->poll_set);
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_FAULT,
+            "Could not destroy poll set");
+    }
+
+    /* Destroy NA context */
+    if (context->core_context.na_context) {
+        na_return_t na_ret =
+            NA_Context_destroy(context->core_context.core_class->na_class,
+                context->core_context.na_context);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not destroy NA context (%s)", NA_Error_to_string(na_ret));
+    }
+
+#ifdef NA_HAS_SM
+    /* Destroy NA SM context */
+    if (context->core_context.na_sm_context) {
+        na_return_t na_ret =
+            NA_Context_destroy(context->core_context.core_class->na_sm_class,
+                context->core_context.na_sm_context);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not destroy NA SM context");
+    }
+#endif
+
+    /* Destroy NA rail contexts */
+    for (i = 0; i < context->core_context.core_class->na_rail_count; i++) {
+        na_return_t na_ret;
+
+        if (!context->core_context.na_rail_contexts[i])
+            continue;
+        na_ret = NA_Context_destroy(
+            context->core_context.core_class->na_rail_classes[i],
+            context->core_context.na_rail_contexts[i]);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not destroy NA rail context (%s)",
+            NA_Error_to_string(na_ret));
+    }
+
+    /* Free user data */
+    if (context->core_context.data_free_callback)
+        context->core_context.data_free_callback(context->core_context.data);
+
+    /* Destroy completion queue mutex/cond */
+    hg_thread_mutex_destroy(&context->completion_queue_mutex);
+    hg_thread_cond_destroy(&context->completion_queue_cond);
+    hg_thread_spin_destroy(&context->pending_list_lock);
+#ifdef HG_HAS_DEBUG
+    hg_thread_spin_destroy(&context->created_list_lock);
+#endif
+    hg_thread_spin_destroy(&context->handle_pool_lock);
+    hg_thread_mutex_destroy(&context->coalesce_mutex);
+    hg_thread_spin_destroy(&context->timer_lock);
+    hg_thread_spin_destroy(&context->request_tag_lock);
+    if (context->timer_wheel)
+        hg_timer_wheel_destroy(context->timer_wheel);
+
+    /* Decrement context count of parent class */
+    hg_atomic_decr32(&HG_CORE_CONTEXT_CLASS(context)->n_contexts);
+
+    free(context);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_post(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context, unsigned int request_count)
+{
+    struct hg_core_post_pool *hg_core_post_pool;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int nentry = 0;
+
+    /* Create a bunch of handles and post unexpected receives */
+    for (nentry = 0; nentry < request_count; nentry++) {
+        struct hg_core_private_handle *hg_core_handle = NULL;
+        struct hg_core_private_addr *hg_core_addr = NULL;
+
+        /* Create new handle */
+        ret = hg_core_create(context, na_class, na_context, &hg_core_handle);
+        HG_CHECK_HG_ERROR(error, ret, "Could not create HG core handle");
+
+        /* Reset status */
+        hg_atomic_set32(&hg_core_handle->status, 0);
+
+        /* Create new (empty) source addresses */
+        hg_core_addr = hg_core_addr_create(HG_CORE_CONTEXT_CLASS(context));
+        HG_CHECK_ERROR(hg_core_addr == NULL, error, ret, HG_NOMEM,
+            "Could not create HG addr");
+        hg_core_handle->core_handle.info.addr = (hg_core_addr_t) hg_core_addr;
+
+        /* Repost handle on completion */
+        hg_core_handle->repost = HG_TRUE;
+
+        /* Post handle */
+        ret = hg_core_post(hg_core_handle);
+        HG_CHECK_HG_ERROR(error, ret, "Cannot post handle");
+    }
+
+    /* First post sets the count that adaptive trimming never goes below */
+    hg_thread_spin_lock(&context->pending_list_lock);
+    hg_core_post_pool = hg_core_context_post_pool(context, na_class);
+    if (hg_core_post_pool->min_count == 0) {
+        hg_core_post_pool->min_count = request_count;
+        hg_core_post_pool->next_incr =
+            HG_CORE_CONTEXT_CLASS(context)->request_post_incr;
+        hg_core_post_pool->low_water =
+            (unsigned int) hg_atomic_get32(&hg_core_post_pool->pending_count);
+        hg_time_get_current_ms(&hg_core_post_pool->window_start);
+    }
+    hg_core_post_pool->posted_count += request_count;
+    hg_thread_spin_unlock(&context->pending_list_lock);
+
+    return ret;
+
+error:
+    hg_core_context_unpost(context);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_unpost(struct hg_core_private_context *context)
+{
+    struct hg_core_private_handle *hg_core_handle;
+    unsigned int actual_count;
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+
+    /* Prevent repost of handles */
+    context->finalizing = HG_TRUE;
+
+    /* Check pending list and cancel posted handles */
+    hg_thread_spin_lock(&context->pending_list_lock);
+    HG_LIST_FOREACH (hg_core_handle, &context->pending_list, pending) {
+        if (!hg_core_handle->posted)
+            continue;
+
+        /* Prevent reposts */
+        hg_core_handle->repost = HG_FALSE;
+
+        /* Cancel handle */
+        ret = hg_core_cancel(hg_core_handle);
+        HG_CHECK_HG_ERROR(error, ret, "Could not cancel handle");
+    }
+
+#ifdef NA_HAS_SM
+    HG_LIST_FOREACH (hg_core_handle, &context->sm_pending_list, pending) {
+        if (!hg_core_handle->posted)
+            continue;
+
+        /* Prevent reposts */
+        hg_core_handle->repost = HG_FALSE;
+
+        /* Cancel handle */
+        ret = hg_core_cancel(hg_core_handle);
+        HG_CHECK_HG_ERROR(error, ret, "Could not cancel handle");
+    }
+#endif
+    hg_thread_spin_unlock(&context->pending_list_lock);
+
+    /* Trigger everything we can from NA, if something completed it will
+     * be moved to the HG context completion queue */
+    do {
+        na_ret = NA_Trigger(
+            context->core_context.na_context, 0, 1, NULL, &actual_count);
+    } while ((na_ret == NA_SUCCESS) && actual_count);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT, done, ret,
+        (hg_return_t) na_ret, "Could not trigger NA callback (%s)",
+        NA_Error_to_string(na_ret));
+
+#ifdef NA_HAS_SM
+    if (context->core_context.na_sm_context) {
+        do {
+            na_ret = NA_Trigger(
+                context->core_context.na_sm_context, 0, 1, NULL, &actual_count);
+        } while ((na_ret == NA_SUCCESS) && actual_count);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT, done, ret,
+            (hg_return_t) na_ret, "Could not trigger NA callback (%s)",
+            NA_Error_to_string(na_ret));
+    }
+#endif
+
+    /* Check that operations have completed */
+    ret = hg_core_context_lists_wait(context);
+    HG_CHECK_HG_ERROR(done, ret, "Could not wait on HG core handle list");
+
+done:
+    return ret;
+
+error:
+    hg_thread_spin_unlock(&context->pending_list_lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_check_pending(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context, unsigned int request_count)
+{
+    struct hg_core_post_pool *hg_core_post_pool =
+        hg_core_context_post_pool(context, na_class);
+    unsigned int pending_count;
+    hg_bool_t pending_empty;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Check if we need more handles, this is called on every received
+     * request so the lock is only taken when posting more */
+    pending_count =
+        (unsigned int) hg_atomic_get32(&hg_core_post_pool->pending_count);
+    pending_empty = (pending_count == 0);
+
+    if (HG_CORE_CONTEXT_CLASS(context)->request_post_adaptive) {
+        /* Lazy posting starts small, grow before posting stalls once three
+         * quarters of the requests are in use */
+        if (HG_CORE_CONTEXT_CLASS(context)->request_post_lazy &&
+            pending_count * 4 < hg_core_post_pool->posted_count)
+            pending_empty = HG_TRUE;
+
+        /* Posting stalled, grow geometrically while the burst lasts */
+        if (pending_empty) {
+            hg_thread_spin_lock(&context->pending_list_lock);
+            request_count = hg_core_post_pool->next_incr;
+            if (hg_core_post_pool->next_incr < HG_CORE_POST_INCR_MAX)
+                hg_core_post_pool->next_incr *= 2;
+            hg_thread_spin_unlock(&context->pending_list_lock);
+        }
+    }
+
+    /* Memory is over the limits, let NA queue incoming requests until
+     * handles complete and are reposted */
+    if (pending_empty && HG_CORE_CONTEXT_CLASS(context)->mem_post_limit &&
+        hg_core_context_mem_used(context) >=
+            HG_CORE_CONTEXT_CLASS(context)->mem_post_limit) {
+        hg_atomic_incr32(&context->mem_throttle_count);
+        goto done;
+    }
+
+    /* If pending list is empty, post more handles */
+    if (pending_empty) {
+        ret =
+            hg_core_context_post(context, na_class, na_context, request_count);
+        HG_CHECK_HG_ERROR(done, ret, "Could not post additional handles");
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE struct hg_core_post_pool *
+hg_core_context_post_pool(
+    struct hg_core_private_context *context, na_class_t *na_class)
+{
+#ifdef NA_HAS_SM
+    if (na_class == context->core_context.core_class->na_sm_class)
+        return &context->sm_post_pool;
+#else
+    (void) na_class;
+#endif
+    return &context->post_pool;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_context_mem_add(struct hg_core_private_context *context,
+    hg_mem_use_t use, hg_util_int64_t size)
+{
+    hg_atomic_add64_relaxed(&context->mem_bytes[use], size);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_size_t
+hg_core_context_mem_used(struct hg_core_private_context *context)
+{
+    hg_util_int64_t used = 0;
+    unsigned int i;
+
+    for (i = 0; i < HG_MEM_USE_MAX; i++)
+        used += hg_atomic_get64(&context->mem_bytes[i]);
+
+    return (hg_size_t) used;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_post_pool_remove(struct hg_core_post_pool *hg_core_post_pool)
+{
+    unsigned int pending_count =
+        (unsigned int) hg_atomic_decr32(&hg_core_post_pool->pending_count);
+
+    /* Low water mark is only a hint, concurrent updates may be lost */
+    if (pending_count < hg_core_post_pool->low_water)
+        hg_core_post_pool->low_water = pending_count;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_post_unlist(struct hg_core_private_handle *hg_core_handle)
+{
+    if (!hg_core_handle->listed)
+        return;
+
+    hg_thread_spin_lock(
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
+    HG_LIST_REMOVE(hg_core_handle, pending);
+    hg_thread_spin_unlock(
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
+    hg_core_handle->listed = HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_context_trim(struct hg_core_private_context *context)
+{
+    struct hg_core_post_pool *hg_core_post_pools[2] = {&context->post_pool,
+#ifdef NA_HAS_SM
+        &context->sm_post_pool
+#else
+        NULL
+#endif
+    };
+    hg_time_t now;
+    unsigned int i;
+
+    hg_time_get_current_ms(&now);
+
+    hg_thread_spin_lock(&context->pending_list_lock);
+    for (i = 0; i < 2 && hg_core_post_pools[i]; i++) {
+        struct hg_core_post_pool *hg_core_post_pool = hg_core_post_pools[i];
+        struct hg_core_private_handle *hg_core_handle;
+        unsigned int excess, keep, trim_count;
+
+        if (hg_core_post_pool->min_count == 0 ||
+            hg_time_diff(now, hg_core_post_pool->window_start) * 1000.0 <
+                HG_CORE_POST_TRIM_INTERVAL)
+            continue;
+
+        /* Requests that remained posted over the whole window were not
+         * needed, release half of them at a time */
+        excess = hg_core_post_pool->low_water / 2;
+        keep = (hg_core_post_pool->posted_count > excess)
+                   ? hg_core_post_pool->posted_count - excess
+                   : 0;
+        if (keep < hg_core_post_pool->min_count)
+            keep = hg_core_post_pool->min_count;
+        trim_count = (hg_core_post_pool->posted_count > keep)
+                         ? hg_core_post_pool->posted_count - keep
+                         : 0;
+
+        /* Only cancel the NA operation, the handle is freed instead of
+         * being reposted if it completes anyway */
+#ifdef NA_HAS_SM
+        if (i == 1)
+            hg_core_handle = HG_LIST_FIRST(&context->sm_pending_list);
+        else
+#endif
+            hg_core_handle = HG_LIST_FIRST(&context->pending_list);
+        for (; hg_core_handle && trim_count > 0;
+             hg_core_handle = HG_LIST_NEXT(hg_core_handle, pending)) {
+            na_return_t na_ret;
+
+            if (!hg_core_handle->repost || !hg_core_handle->posted)
+                continue;
+            hg_core_handle->repost = HG_FALSE;
+            hg_core_handle->trimmed = HG_TRUE; /* release its buffers */
+
+            na_ret = NA_Cancel(hg_core_handle->na_class,
+                hg_core_handle->na_context, hg_core_handle->na_recv_op_id);
+            HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
+                "Could not cancel recv op id (%s)", NA_Error_to_string(na_ret));
+            hg_core_post_pool->posted_count--;
+            trim_count--;
+        }
+
+        /* No stall over the window, the burst is over */
+        if (hg_core_post_pool->low_water > 0)
+            hg_core_post_pool->next_incr =
+                HG_CORE_CONTEXT_CLASS(context)->request_post_incr;
+        hg_core_post_pool->low_water =
+            (unsigned int) hg_atomic_get32(&hg_core_post_pool->pending_count);
+        hg_core_post_pool->window_start = now;
+    }
+    hg_thread_spin_unlock(&context->pending_list_lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_lists_wait(struct hg_core_private_context *context)
+{
+    hg_util_bool_t created_list_empty = HG_UTIL_FALSE;
+    hg_util_bool_t pending_list_empty = HG_UTIL_FALSE;
+#ifdef NA_HAS_SM
+    hg_util_bool_t sm_pending_list_empty = HG_UTIL_FALSE;
+#else
+    hg_util_bool_t sm_pending_list_empty = HG_UTIL_TRUE;
+#endif
+    /* Convert timeout in ms into seconds */
+    double remaining = HG_CORE_CLEANUP_TIMEOUT / 1000.0;
+    hg_return_t ret = HG_SUCCESS;
+
+    do {
+        unsigned int actual_count = 0;
+        hg_time_t t1, t2;
+        hg_return_t trigger_ret, progress_ret;
+
+        hg_time_get_current_ms(&t1);
+
+        /* Trigger everything we can from HG */
+        do {
+            trigger_ret = hg_core_trigger(context, 0, 1, 1, &actual_count);
+        } while ((trigger_ret == HG_SUCCESS) && actual_count);
+        HG_CHECK_ERROR(trigger_ret != HG_SUCCESS && trigger_ret != HG_TIMEOUT,
+            done, ret, trigger_ret, "Could not trigger entry");
+
+        created_list_empty = (hg_atomic_get32(&context->n_handles) == 0);
+        pending_list_empty =
+            (hg_atomic_get32(&context->post_pool.pending_count) == 0);
+#ifdef NA_HAS_SM
+        sm_pending_list_empty =
+            (hg_atomic_get32(&context->sm_post_pool.pending_count) == 0);
+#endif
+
+        if (created_list_empty && pending_list_empty && sm_pending_list_empty)
+            break;
+
+        progress_ret =
+            hg_core_progress(context, (unsigned int) (remaining * 1000.0));
+        HG_CHECK_ERROR(progress_ret != HG_SUCCESS && progress_ret != HG_TIMEOUT,
+            done, ret, progress_ret, "Could not make progress");
+
+        hg_time_get_current_ms(&t2);
+        remaining -= hg_time_diff(t2, t1);
+        if (remaining < 0)
+            remaining = 0;
+    } while ((int) (remaining * 1000.0) > 0 || !pending_list_empty ||
+             !sm_pending_list_empty);
+
+    HG_LOG_DEBUG("Remaining %lf, Context list status: %d, %d, %d", remaining,
+        created_list_empty, pending_list_empty, sm_pending_list_empty);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_core_context_mem_acquire(
+    struct hg_core_context *core_context, hg_mem_use_t use, hg_size_t size)
+{
+    struct hg_core_private_context *context =
+        (struct hg_core_private_context *) core_context;
+    hg_size_t hard_limit = HG_CORE_CONTEXT_CLASS(context)->mem_hard_limit;
+
+    /* Limit is checked without reserving memory, concurrent overflows may
+     * exceed it by a few payloads */
+    if (use == HG_MEM_USE_OVERFLOW && hard_limit &&
+        hg_core_context_mem_used(context) + size > hard_limit) {
+        hg_atomic_incr32(&context->mem_throttle_count);
+        return HG_NOMEM;
+    }
+    hg_core_context_mem_add(context, use, (hg_util_int64_t) size);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_context_mem_release(
+    struct hg_core_context *core_context, hg_mem_use_t use, hg_size_t size)
+{
+    hg_core_context_mem_add((struct hg_core_private_context *) core_context,
+        use, -(hg_util_int64_t) size);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_context_alloc_fallback(
+    struct hg_core_context *core_context, const char *what)
+{
+    struct hg_core_private_context *context =
+        (struct hg_core_private_context *) core_context;
+
+    hg_atomic_incr32(&context->alloc_fallback_count);
+    if (HG_CORE_CONTEXT_CLASS(context)->prealloc_count > 0)
+        HG_LOG_DEBUG("Pool exhausted, allocating %s", what);
+    (void) what;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_op_pool *
+hg_core_context_get_bulk_op_pool(struct hg_core_context *core_context)
+{
+    return ((struct hg_core_private_context *) core_context)->hg_bulk_op_pool;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_class_get_bulk_pipeline(struct hg_core_class *core_class,
+    hg_size_t *chunk_size, hg_uint32_t *max_inflight)
+{
+    struct hg_core_private_class *hg_core_class =
+        (struct hg_core_private_class *) core_class;
+
+    *chunk_size = hg_core_class->bulk_chunk_size;
+    *max_inflight = hg_core_class->bulk_max_inflight;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_thread_pool *
+hg_core_class_get_bulk_self_pool(struct hg_core_class *core_class,
+    hg_uint32_t *thread_count, hg_size_t *offload_size)
+{
+    struct hg_core_private_class *hg_core_class =
+        (struct hg_core_private_class *) core_class;
+
+    *thread_count = hg_core_class->bulk_self_thread_count;
+    *offload_size = hg_core_class->bulk_self_offload_size;
+
+    return hg_core_class->bulk_self_pool;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_mem_pool *
+hg_core_class_get_bulk_mem_pool(struct hg_core_class *core_class)
+{
+    return ((struct hg_core_private_class *) core_class)->bulk_mem_pool;
+}
+
+/*---------------------------------------------------------------------------*/
+const struct hg_core_hooks *
+hg_core_class_get_hooks(struct hg_core_class *core_class)
+{
+    return &((struct hg_core_private_class *) core_class)->hooks;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_cache *
+hg_core_class_get_bulk_cache(struct hg_core_class *core_class)
+{
+    return ((struct hg_core_private_class *) core_class)->bulk_cache;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_lookup(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr **addr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (hg_core_class->addr_cache &&
+        hg_core_addr_cache_get(hg_core_class, name, addr, &ret)) {
+        HG_LOG_DEBUG("Found \"%s\" in address cache (ret=%d)", name,
+            (int) ret);
+        return ret;
+    }
+
+    ret = hg_core_addr_lookup_na(hg_core_class, name, addr);
+
+    /* Cache result, errors are only cached if negative TTL is set */
+    if (hg_core_class->addr_cache &&
+        (ret == HG_SUCCESS || hg_core_class->addr_cache_neg_ttl))
+        hg_core_addr_cache_put(
+            hg_core_class, name, (ret == HG_SUCCESS) ? *addr : NULL, ret);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_lookup_na(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr **addr)
+{
+    struct hg_core_private_addr *hg_core_addr = NULL;
+    na_class_t **na_class_ptr = NULL;
+    na_addr_t *na_addr_ptr = NULL;
+    na_size_t *na_addr_serialize_size_ptr = NULL;
+    na_return_t na_ret;
+#ifdef NA_HAS_SM
+    char lookup_name[HG_CORE_ADDR_MAX_SIZE] = {'\0'};
+#endif
+    const char *name_str = name;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Allocate addr */
+    hg_core_addr = hg_core_addr_create(hg_core_class);
+    HG_CHECK_ERROR(
+        hg_core_addr == NULL, error, ret, HG_NOMEM, "Could not create HG addr");
+
+    /* TODO lookup could also create self addresses */
+
+#ifdef NA_HAS_SM
+    /* Parse name string */
+    if (hg_core_class->core_class.na_sm_class &&
+        strstr(name, HG_CORE_ADDR_DELIMITER)) {
+        char *lookup_names, *local_id_str;
+        char *remote_name, *local_name;
+
+        strcpy(lookup_name, name);
+
+        /* Get first part of address string with host ID */
+        strtok_r(lookup_name, HG_CORE_ADDR_DELIMITER, &lookup_names);
+
+        HG_CHECK_ERROR(strstr(name, HG_CORE_PROTO_DELIMITER) == NULL, error,
+            ret, HG_PROTOCOL_ERROR, "Malformed address format");
+
+        /* Get address SM host ID */
+        strtok_r(lookup_name, HG_CORE_PROTO_DELIMITER, &local_id_str);
+        na_ret =
+            NA_SM_String_to_host_id(local_id_str + 2, &hg_core_addr->host_id);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "NA_SM_String_to_host_id() failed (%s)",
+            NA_Error_to_string(na_ret));
+
+        /* Separate remaining two parts */
+        strtok_r(lookup_names, HG_CORE_ADDR_DELIMITER, &remote_name);
+        local_name = lookup_names;
+
+        /* Compare IDs, if they match it's local address */
+        if (NA_SM_Host_id_cmp(hg_core_addr->host_id, hg_core_class->host_id)) {
+            HG_LOG_DEBUG("This is a local address");
+            name_str = local_name;
+            na_class_ptr = &hg_core_addr->core_addr.core_class->na_sm_class;
+            na_addr_ptr = &hg_core_addr->core_addr.na_sm_addr;
+            na_addr_serialize_size_ptr =
+                &hg_core_addr->na_sm_addr_serialize_size;
+        } else {
+            /* Remote lookup */
+            name_str = remote_name;
+            na_class_ptr = &hg_core_addr->core_addr.core_class->na_class;
+            na_addr_ptr = &hg_core_addr->core_addr.na_addr;
+            na_addr_serialize_size_ptr = &hg_core_addr->na_addr_serialize_size;
+        }
+    } else {
+#endif
+        /* Remote lookup */
+        na_class_ptr = &hg_core_addr->core_addr.core_class->na_class;
+        na_addr_ptr = &hg_core_addr->core_addr.na_addr;
+        na_addr_serialize_size_ptr = &hg_core_addr->na_addr_serialize_size;
+#ifdef NA_HAS_SM
+    }
+#endif
+
+    /* Lookup adress */
+    na_ret = NA_Addr_lookup(*na_class_ptr, name_str, na_addr_ptr);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+        "Could not lookup address %s (%s)", name_str,
+        NA_Error_to_string(na_ret));
+
+    /* Cache serialize size */
+    *na_addr_serialize_size_ptr =
+        NA_Addr_get_serialize_size(*na_class_ptr, *na_addr_ptr);
+
+    *addr = hg_core_addr;
+
+    return ret;
+
+error:
+    hg_core_addr_free(hg_core_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_lookup_batch(struct hg_core_private_class *hg_core_class,
+    const char *const names[], hg_size_t count,
+    struct hg_core_private_addr *addrs[])
+{
+    const char **na_names = NULL;
+    na_addr_t *na_addrs = NULL;
+    hg_size_t *indices = NULL;
+    hg_size_t na_count = 0, i;
+    na_return_t na_ret;
+    hg_return_t ret = HG_SUCCESS;
+
+    for (i = 0; i < count; i++)
+        addrs[i] = NULL;
+
+    na_names = (const char **) malloc(count * sizeof(*na_names));
+    HG_CHECK_ERROR(na_names == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of names");
+    na_addrs = (na_addr_t *) malloc(count * sizeof(*na_addrs));
+    HG_CHECK_ERROR(na_addrs == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of NA addrs");
+    indices = (hg_size_t *) malloc(count * sizeof(*indices));
+    HG_CHECK_ERROR(indices == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of indices");
+
+    for (i = 0; i < count; i++) {
+        HG_CHECK_ERROR(names[i] == NULL, error, ret, HG_INVALID_ARG,
+            "NULL lookup name at index %zu", (size_t) i);
+
+        if (hg_core_class->addr_cache &&
+            hg_core_addr_cache_get(hg_core_class, names[i], &addrs[i], &ret)) {
+            HG_CHECK_HG_ERROR(
+                error, ret, "Cached lookup of %s failed", names[i]);
+            continue;
+        }
+
+#ifdef NA_HAS_SM
+        /* Names that may refer to an SM address must be parsed first */
+        if (hg_core_class->core_class.na_sm_class &&
+            strstr(names[i], HG_CORE_ADDR_DELIMITER)) {
+            ret = hg_core_addr_lookup(hg_core_class, names[i], &addrs[i]);
+            HG_CHECK_HG_ERROR(error, ret, "Could not lookup %s", names[i]);
+            continue;
+        }
+#endif
+
+        na_names[na_count] = names[i];
+        indices[na_count] = i;
+        na_count++;
+    }
+
+    if (na_count == 0)
+        goto done;
+
+    /* Errors are not cached since the failing name is not known */
+    na_ret = NA_Addr_lookup_batch(
+        hg_core_class->core_class.na_class, na_names, na_count, na_addrs);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+        "Could not lookup %zu addresses (%s)", (size_t) na_count,
+        NA_Error_to_string(na_ret));
+
+    for (i = 0; i < na_count; i++) {
+        struct hg_core_private_addr *hg_core_addr =
+            hg_core_addr_create(hg_core_class);
+
+        if (hg_core_addr == NULL) {
+            for (; i < na_count; i++)
+                NA_Addr_free(hg_core_class->core_class.na_class, na_addrs[i]);
+            HG_GOTO_ERROR(error, ret, HG_NOMEM, "Could not create HG addr");
+        }
+        hg_core_addr->core_addr.na_addr = na_addrs[i];
+        hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
+            hg_core_class->core_class.na_class, na_addrs[i]);
+        addrs[indices[i]] = hg_core_addr;
+
+        if (hg_core_class->addr_cache)
+            hg_core_addr_cache_put(
+                hg_core_class, na_names[i], hg_core_addr, HG_SUCCESS);
+    }
+
+done:
+    free(na_names);
+    free(na_addrs);
+    free(indices);
+
+    return ret;
+
+error:
+    for (i = 0; i < count; i++) {
+        hg_core_addr_free(addrs[i]);
+        addrs[i] = NULL;
+    }
+    free(na_names);
+    free(na_addrs);
+    free(indices);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_core_addr_cache_hash(hg_hash_table_key_t key)
+{
+    return hg_hash_string((const char *) key);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_core_addr_cache_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return strcmp((const char *) key1, (const char *) key2) == 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_cache_entry_free(hg_hash_table_value_t value)
+{
+    struct hg_core_addr_cache_entry *entry =
+        (struct hg_core_addr_cache_entry *) value;
+
+    /* Drop reference held by cache */
+    hg_core_addr_free(entry->addr);
+    free(entry->name);
+    free(entry);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_rails_init(struct hg_core_private_class *hg_core_class,
+    const char *na_rails, const struct na_init_info *na_init_info)
+{
+    char *rails, *rail, *save_ptr = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    rails = strdup(na_rails);
+    HG_CHECK_ERROR(
+        rails == NULL, done, ret, HG_NOMEM, "Could not duplicate rail list");
+
+    for (rail = strtok_r(rails, ",", &save_ptr); rail != NULL;
+         rail = strtok_r(NULL, ",", &save_ptr)) {
+        unsigned int i = hg_core_class->core_class.na_rail_count;
+        na_return_t na_ret;
+
+        HG_CHECK_ERROR(i == HG_CORE_RAIL_MAX, done, ret, HG_INVALID_ARG,
+            "Number of rails exceeds %d", HG_CORE_RAIL_MAX);
+
+        /* Peers must always be able to reach rails for RMA operations */
+        hg_core_class->core_class.na_rail_classes[i] =
+            NA_Initialize_opt(rail, NA_TRUE, na_init_info);
+        HG_CHECK_ERROR(hg_core_class->core_class.na_rail_classes[i] == NULL,
+            done, ret, HG_NA_ERROR, "Could not initialize NA rail (%s)", rail);
+        hg_core_class->core_class.na_rail_count++;
+
+        /* Rail addresses are sent along bulk handles */
+        na_ret = NA_Addr_self(hg_core_class->core_class.na_rail_classes[i],
+            &hg_core_class->core_class.na_rail_self_addrs[i]);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not get rail self address (%s)", NA_Error_to_string(na_ret));
+
+        HG_LOG_DEBUG("Initialized NA rail %u (%s)", i, rail);
+    }
+
+done:
+    free(rails);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_cache_init(struct hg_core_private_class *hg_core_class,
+    const struct hg_init_info *hg_init_info)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_core_class->addr_cache =
+        hg_hash_table_new(hg_core_addr_cache_hash, hg_core_addr_cache_equal);
+    HG_CHECK_ERROR(hg_core_class->addr_cache == NULL, done, ret, HG_NOMEM,
+        "Could not allocate address cache");
+    hg_hash_table_register_free_functions(
+        hg_core_class->addr_cache, NULL, hg_core_addr_cache_entry_free);
+    hg_thread_mutex_init(&hg_core_class->addr_cache_mutex);
+
+    if (hg_init_info->addr_cache_file) {
+        hg_core_class->addr_cache_file = strdup(hg_init_info->addr_cache_file);
+        HG_CHECK_ERROR(hg_core_class->addr_cache_file == NULL, done, ret,
+            HG_NOMEM, "Could not duplicate address cache file name");
+
+        /* File may not exist yet on first start */
+        ret = hg_core_addr_cache_load(
+            hg_core_class, hg_core_class->addr_cache_file);
+        HG_CHECK_WARNING(ret != HG_SUCCESS,
+            "Could not load address cache from %s (ret=%d)",
+            hg_core_class->addr_cache_file, (int) ret);
+        ret = HG_SUCCESS;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_cache_finalize(struct hg_core_private_class *hg_core_class)
+{
+    if (!hg_core_class->addr_cache)
+        return;
+
+    if (hg_core_class->addr_cache_file) {
+        hg_return_t ret = hg_core_addr_cache_dump(
+            hg_core_class, hg_core_class->addr_cache_file);
+        HG_CHECK_WARNING(ret != HG_SUCCESS,
+            "Could not dump address cache to %s (ret=%d)",
+            hg_core_class->addr_cache_file, (int) ret);
+        free(hg_core_class->addr_cache_file);
+        hg_core_class->addr_cache_file = NULL;
+    }
+
+    hg_hash_table_free(hg_core_class->addr_cache);
+    hg_core_class->addr_cache = NULL;
+    hg_thread_mutex_destroy(&hg_core_class->addr_cache_mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_addr_cache_get(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr **addr, hg_return_t *ret)
+{
+    struct hg_core_addr_cache_entry *entry;
+    hg_bool_t found = HG_FALSE;
+    hg_time_t now;
+
+    hg_time_get_current_ms(&now);
+
+    hg_thread_mutex_lock(&hg_core_class->addr_cache_mutex);
+
+    entry = (struct hg_core_addr_cache_entry *) hg_hash_table_lookup(
+        hg_core_class->addr_cache, (hg_hash_table_key_t) (hg_ptr_t) name);
+    if (entry == HG_HASH_TABLE_NULL)
+        goto done;
+
+    /* Entries are only evicted once they are looked up again */
+    if (hg_time_less(entry->expire, now)) {
+        hg_hash_table_remove(
+            hg_core_class->addr_cache, (hg_hash_table_key_t) entry->name);
+        goto done;
+    }
+
+    if (entry->addr) {
+        hg_atomic_incr32_relaxed(&entry->addr->ref_count);
+        *addr = entry->addr;
+    }
+    *ret = entry->ret;
+    found = HG_TRUE;
+
+done:
+    hg_thread_mutex_unlock(&hg_core_class->addr_cache_mutex);
+
+    return found;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_cache_put(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr *addr, hg_return_t ret)
+{
+    struct hg_core_addr_cache_entry *entry;
+    hg_time_t now;
+
+    entry = (struct hg_core_addr_cache_entry *) malloc(
+        sizeof(struct hg_core_addr_cache_entry));
+    HG_CHECK_ERROR_NORET(
+        entry == NULL, error, "Could not allocate address cache entry");
+    entry->name = strdup(name);
+    HG_CHECK_ERROR_NORET(
+        entry->name == NULL, error, "Could not duplicate lookup name");
+    entry->addr = addr;
+    entry->ret = ret;
+
+    hg_time_get_current_ms(&now);
+    entry->expire = hg_time_add(now,
+        hg_time_from_ms((addr) ? hg_core_class->addr_cache_ttl
+                               : hg_core_class->addr_cache_neg_ttl));
+
+    /* Cache holds its own reference */
+    if (addr)
+        hg_atomic_incr32_relaxed(&addr->ref_count);
+
+    /* Replaces (and frees) any previous entry */
+    hg_thread_mutex_lock(&hg_core_class->addr_cache_mutex);
+    if (!hg_hash_table_insert(hg_core_class->addr_cache,
+            (hg_hash_table_key_t) entry->name, (hg_hash_table_value_t) entry)) {
+        hg_thread_mutex_unlock(&hg_core_class->addr_cache_mutex);
+        HG_LOG_ERROR("Could not insert address cache entry");
+        hg_core_addr_cache_entry_free(entry);
+        return;
+    }
+    hg_thread_mutex_unlock(&hg_core_class->addr_cache_mutex);
+
+    return;
+
+error:
+    if (entry) {
+        free(entry->name);
+        free(entry);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_cache_remove(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr *addr)
+{
+    hg_hash_table_iter_t iter;
+    char *name = NULL;
+
+    hg_thread_mutex_lock(&hg_core_class->addr_cache_mutex);
+
+    /* An addr is cached at most once per name, remove after iterating */
+    do {
+        name = NULL;
+        hg_hash_table_iterate(hg_core_class->addr_cache, &iter);
+        while (hg_hash_table_iter_has_more(&iter)) {
+            struct hg_core_addr_cache_entry *entry =
+                (struct hg_core_addr_cache_entry *) hg_hash_table_iter_next(
+                    &iter);
+            if (entry->addr == addr) {
+                name = entry->name;
+                break;
+            }
+        }
+        if (name)
+            hg_hash_table_remove(
+                hg_core_class->addr_cache, (hg_hash_table_key_t) name);
+    } while (name);
+
+    hg_thread_mutex_unlock(&hg_core_class->addr_cache_mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_cache_load(
+    struct hg_core_private_class *hg_core_class, const char *path)
+{
+    char *line = NULL;
+    unsigned char *buf = NULL;
+    FILE *file = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    file = fopen(path, "r");
+    HG_CHECK_ERROR(
+        file == NULL, done, ret, HG_NOENTRY, "Could not open %s", path);
+
+    line = (char *) malloc(HG_CORE_ADDR_CACHE_LINE_MAX);
+    buf = (unsigned char *) malloc(HG_CORE_ADDR_CACHE_LINE_MAX / 2);
+    HG_CHECK_ERROR(line == NULL || buf == NULL, done, ret, HG_NOMEM,
+        "Could not allocate address cache buffers");
+
+    /* Each line is "<name> <hex serialized addr>", addresses are rebuilt
+     * from their serialized form so that names are not resolved again */
+    while (fgets(line, HG_CORE_ADDR_CACHE_LINE_MAX, file) != NULL) {
+        struct hg_core_private_addr *hg_core_addr = NULL;
+        char *name, *hex, *save_ptr = NULL;
+        size_t i, hex_len;
+        hg_return_t load_ret;
+
+        name = strtok_r(line, " \n", &save_ptr);
+        hex = strtok_r(NULL, " \n", &save_ptr);
+        if (!name || !hex)
+            continue;
+
+        hex_len = strlen(hex);
+        if (hex_len % 2)
+            continue;
+        for (i = 0; i < hex_len / 2; i++) {
+            unsigned int byte;
+
+            if (sscanf(hex + 2 * i, "%2x", &byte) != 1)
+                break;
+            buf[i] = (unsigned char) byte;
+        }
+        if (i != hex_len / 2)
+            continue;
+
+        load_ret = hg_core_addr_deserialize(
+            hg_core_class, &hg_core_addr, buf, (hg_size_t) i);
+        if (load_ret != HG_SUCCESS) {
+            HG_LOG_WARNING("Could not rebuild cached address for %s (ret=%d)",
+                name, (int) load_ret);
+            continue;
+        }
+
+        hg_core_addr_cache_put(hg_core_class, name, hg_core_addr, HG_SUCCESS);
+        hg_core_addr_free(hg_core_addr);
+    }
+
+done:
+    if (file)
+        fclose(file);
+    free(line);
+    free(buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_cache_dump(
+    struct hg_core_private_class *hg_core_class, const char *path)
+{
+    hg_hash_table_iter_t iter;
+    unsigned char *buf = NULL;
+    FILE *file = NULL;
+    hg_uint8_t flags = 0;
+    hg_time_t now;
+    hg_return_t ret = HG_SUCCESS;
+
+#ifdef NA_HAS_SM
+    if (hg_core_class->core_class.na_sm_class)
+        flags |= HG_CORE_SM;
+#endif
+
+    file = fopen(path, "w");
+    HG_CHECK_ERROR(
+        file == NULL, done, ret, HG_NOENTRY, "Could not open %s", path);
+
+    buf = (unsigned char *) malloc(HG_CORE_ADDR_CACHE_LINE_MAX / 2);
+    HG_CHECK_ERROR(
+        buf == NULL, done, ret, HG_NOMEM, "Could not allocate buffer");
+
+    hg_time_get_current_ms(&now);
+
+    /* Only valid positive entries are kept */
+    hg_thread_mutex_lock(&hg_core_class->addr_cache_mutex);
+    hg_hash_table_iterate(hg_core_class->addr_cache, &iter);
+    while (hg_hash_table_iter_has_more(&iter)) {
+        struct hg_core_addr_cache_entry *entry =
+            (struct hg_core_addr_cache_entry *) hg_hash_table_iter_next(&iter);
+        hg_size_t i, buf_size;
+
+        if (!entry->addr || hg_time_less(entry->expire, now))
+            continue;
+
+        buf_size = hg_core_addr_get_serialize_size(entry->addr, flags);
+        if (buf_size > HG_CORE_ADDR_CACHE_LINE_MAX / 2 ||
+            strlen(entry->name) + 2 * buf_size + 2 >
+                HG_CORE_ADDR_CACHE_LINE_MAX)
+            continue;
+        if (hg_core_addr_serialize(buf, buf_size, flags, entry->addr) !=
+            HG_SUCCESS)
+            continue;
+
+        fprintf(file, "%s ", entry->name);
+        for (i = 0; i < buf_size; i++)
+            fprintf(file, "%02x", buf[i]);
+        fprintf(file, "\n");
+    }
+    hg_thread_mutex_unlock(&hg_core_class->addr_cache_mutex);
+
+done:
+    if (file)
+        fclose(file);
+    free(buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_private_addr *
+hg_core_addr_create(struct hg_core_private_class *hg_core_class)
+{
+    struct hg_core_private_addr *hg_core_addr = NULL;
+
+    hg_core_addr = (struct hg_core_private_addr *) malloc(
+        sizeof(struct hg_core_private_addr));
+    HG_CHECK_ERROR_NORET(
+        hg_core_addr == NULL, done, "Could not allocate HG addr");
+
+    memset(hg_core_addr, 0, sizeof(struct hg_core_private_addr));
+    hg_core_addr->core_addr.core_class = (hg_core_class_t *) hg_core_class;
+    hg_core_addr->core_addr.na_addr = NA_ADDR_NULL;
+#ifdef NA_HAS_SM
+    hg_core_addr->core_addr.na_sm_addr = NA_ADDR_NULL;
+#endif
+    hg_core_addr->core_addr.is_self = HG_FALSE;
+    HG_QUEUE_INIT(&hg_core_addr->credit_queue);
+    HG_LIST_INIT(&hg_core_addr->forward_list);
+    hg_thread_spin_init(&hg_core_addr->credit_lock);
+    hg_core_addr->credits = hg_core_class->request_credits;
+    hg_atomic_init32(&hg_core_addr->load, 0);
+    hg_thread_spin_init(&hg_core_addr->rpc_index_lock);
+    hg_atomic_init32(&hg_core_addr->ref_count, 1);
+
+    /* Increment N addrs from HG class */
+    hg_atomic_incr32(&hg_core_class->n_addrs);
+
+done:
+    return hg_core_addr;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_free(struct hg_core_private_addr *hg_core_addr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_core_addr)
+        goto done;
+
+    if (hg_atomic_decr32(&hg_core_addr->ref_count))
+        /* Cannot free yet */
+        goto done;
+
+    /* Decrement N addrs from HG class */
+    hg_atomic_decr32(&HG_CORE_ADDR_CLASS(hg_core_addr)->n_addrs);
+
+    /* Free NA addresses */
+    ret = hg_core_addr_free_na(hg_core_addr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not free NA addresses");
+
+    hg_thread_spin_destroy(&hg_core_addr->credit_lock);
+    if (hg_core_addr->rpc_index)
+        hg_hash_table_free(hg_core_addr->rpc_index);
+    hg_thread_spin_destroy(&hg_core_addr->rpc_index_lock);
+    free(hg_core_addr);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_free_na(struct hg_core_private_addr *hg_core_addr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Free NA address */
+    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
+        na_return_t na_ret =
+            NA_Addr_free(hg_core_addr->core_addr.core_class->na_class,
+                hg_core_addr->core_addr.na_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not free NA address (%s)", NA_Error_to_string(na_ret));
+        hg_core_addr->core_addr.na_addr = NA_ADDR_NULL;
+        hg_core_addr->na_addr_serialize_size = 0;
+    }
+
+#ifdef NA_HAS_SM
+    /* Free NA SM address */
+    if (hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
+        na_return_t na_ret =
+            NA_Addr_free(hg_core_addr->core_addr.core_class->na_sm_class,
+                hg_core_addr->core_addr.na_sm_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not free NA SM address (%s)", NA_Error_to_string(na_ret));
+        hg_core_addr->core_addr.na_sm_addr = NA_ADDR_NULL;
+        hg_core_addr->na_sm_addr_serialize_size = 0;
+    }
+#endif
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_set_remove(struct hg_core_private_addr *hg_core_addr)
+{
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+
+    /* Removed addresses must no longer be returned by lookups */
+    if (HG_CORE_ADDR_CLASS(hg_core_addr)->addr_cache)
+        hg_core_addr_cache_remove(
+            HG_CORE_ADDR_CLASS(hg_core_addr), hg_core_addr);
+
+    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
+        na_ret =
+            NA_Addr_set_remove(hg_core_addr->core_addr.core_class->na_class,
+                hg_core_addr->core_addr.na_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "NA_Addr_set_remove() failed (%s)", NA_Error_to_string(na_ret));
+    }
+
+#ifdef NA_HAS_SM
+    if (hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
+        na_ret =
+            NA_Addr_set_remove(hg_core_addr->core_addr.core_class->na_sm_class,
+                hg_core_addr->core_addr.na_sm_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "NA_Addr_set_remove() failed (%s)", NA_Error_to_string(na_ret));
+    }
+#endif
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_cancel_all(
+    struct hg_core_private_addr *hg_core_addr, hg_bool_t remove)
+{
+    struct hg_core_private_handle *hg_core_handle;
+    unsigned int count = 0, i;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Only cancel forwards that are in flight now, forwards issued while
+     * canceling are left alone */
+    hg_thread_spin_lock(&hg_core_addr->credit_lock);
+    HG_LIST_FOREACH (hg_core_handle, &hg_core_addr->forward_list, target)
+        count++;
+    hg_thread_spin_unlock(&hg_core_addr->credit_lock);
+
+    HG_LOG_DEBUG("Canceling %u forwards to addr %p", count, hg_core_addr);
+
+    /* Cancelation may complete handles, do not hold the lock while canceling
+     * and keep a reference to each handle until it is canceled */
+    for (i = 0; i < count; i++) {
+        hg_return_t cancel_ret;
+
+        hg_thread_spin_lock(&hg_core_addr->credit_lock);
+        hg_core_handle = HG_LIST_FIRST(&hg_core_addr->forward_list);
+        if (hg_core_handle) {
+            HG_LIST_REMOVE(hg_core_handle, target);
+            hg_core_handle->forward_listed = HG_FALSE;
+            hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
+        }
+        hg_thread_spin_unlock(&hg_core_addr->credit_lock);
+        if (hg_core_handle == NULL)
+            break;
+
+        cancel_ret = hg_core_cancel(hg_core_handle);
+        if (cancel_ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not cancel handle %p", hg_core_handle);
+            if (ret == HG_SUCCESS)
+                ret = cancel_ret;
+        }
+
+        cancel_ret = hg_core_destroy(hg_core_handle);
+        HG_CHECK_ERROR_DONE(
+            cancel_ret != HG_SUCCESS, "Could not release handle");
+    }
+
+    /* Purge peer so that new forwards do not use a stale connection */
+    if (remove) {
+        hg_return_t remove_ret = hg_core_addr_set_remove(hg_core_addr);
+
+        HG_CHECK_ERROR_DONE(
+            remove_ret != HG_SUCCESS, "Could not set address to be removed");
+        if (ret == HG_SUCCESS)
+            ret = remove_ret;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_warmup(struct hg_core_private_addr *hg_core_addr)
+{
+    na_class_t *na_class = hg_core_addr->core_addr.core_class->na_class;
+    na_addr_t na_addr = hg_core_addr->core_addr.na_addr;
+    na_return_t na_ret;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* RPCs to self do not go through NA */
+    if (hg_core_addr->core_addr.is_self)
+        goto done;
+
+#ifdef NA_HAS_SM
+    if (hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
+        na_class = hg_core_addr->core_addr.core_class->na_sm_class;
+        na_addr = hg_core_addr->core_addr.na_sm_addr;
+    }
+#endif
+
+    na_ret = NA_Addr_warmup(na_class, &na_addr, 1);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "NA_Addr_warmup() failed (%s)", NA_Error_to_string(na_ret));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_self(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr **self_addr)
+{
+    struct hg_core_private_addr *hg_core_addr = NULL;
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+
+    hg_core_addr = hg_core_addr_create(hg_core_class);
+    HG_CHECK_ERROR(
+        hg_core_addr == NULL, error, ret, HG_NOMEM, "Could not create HG addr");
+    hg_core_addr->core_addr.is_self = HG_TRUE;
+
+    /* Get NA address */
+    na_ret = NA_Addr_self(
+        hg_core_class->core_class.na_class, &hg_core_addr->core_addr.na_addr);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+        "Could not get self address (%s)", NA_Error_to_string(na_ret));
+
+    /* Cache serialize size */
+    hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
+        hg_core_class->core_class.na_class, hg_core_addr->core_addr.na_addr);
+
+#ifdef NA_HAS_SM
+    if (hg_core_class->core_class.na_sm_class) {
+        /* Get SM address */
+        na_ret = NA_Addr_self(hg_core_class->core_class.na_sm_class,
+            &hg_core_addr->core_addr.na_sm_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "Could not get self SM address (%s)", NA_Error_to_string(na_ret));
+
+        /* Cache serialize size */
+        hg_core_addr->na_sm_addr_serialize_size =
+            NA_Addr_get_serialize_size(hg_core_class->core_class.na_sm_class,
+                hg_core_addr->core_addr.na_sm_addr);
+
+        /* Copy local host ID */
+        NA_SM_Host_id_copy(&hg_core_addr->host_id, hg_core_class->host_id);
+    }
+#endif
+
+    *self_addr = hg_core_addr;
+
+    return ret;
+
+error:
+    hg_core_addr_free(hg_core_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_dup(struct hg_core_private_addr *hg_core_addr,
+    struct hg_core_private_addr **hg_new_addr_ptr)
+{
+    struct hg_core_private_addr *hg_new_addr = NULL;
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+
+    hg_new_addr = hg_core_addr_create(HG_CORE_ADDR_CLASS(hg_core_addr));
+    HG_CHECK_ERROR(hg_new_addr == NULL, error, ret, HG_NOMEM,
+        "Could not create dup HG addr");
+    hg_new_addr->core_addr.is_self = hg_core_addr->core_addr.is_self;
+
+    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
+        na_ret = NA_Addr_dup(hg_core_addr->core_addr.core_class->na_class,
+            hg_core_addr->core_addr.na_addr, &hg_new_addr->core_addr.na_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "Could not duplicate address (%s)", NA_Error_to_string(na_ret));
+
+        /* Copy serialize size */
+        hg_new_addr->na_addr_serialize_size =
+            hg_core_addr->na_addr_serialize_size;
+    }
+
+#ifdef NA_HAS_SM
+    if (hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
+        na_ret = NA_Addr_dup(hg_core_addr->core_addr.core_class->na_sm_class,
+            hg_core_addr->core_addr.na_sm_addr,
+            &hg_new_addr->core_addr.na_sm_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "Could not duplicate address (%s)", NA_Error_to_string(na_ret));
+
+        /* Copy serialize size */
+        hg_new_addr->na_sm_addr_serialize_size =
+            hg_core_addr->na_sm_addr_serialize_size;
+
+        /* Copy local host ID */
+        NA_SM_Host_id_copy(&hg_new_addr->host_id, hg_core_addr->host_id);
+    }
+#endif
+
+    *hg_new_addr_ptr = hg_new_addr;
+
+    return ret;
+
+error:
+    hg_core_addr_free(hg_new_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_addr_cmp(
+    struct hg_core_private_addr *addr1, struct hg_core_private_addr *addr2)
+{
+    hg_bool_t ret = HG_TRUE;
+
+    /* Cannot be separate classes */
+    if (addr1->core_addr.core_class != addr2->core_addr.core_class)
+        return HG_FALSE;
+
+    /* Self addresses are always equal */
+    if (addr1->core_addr.is_self && addr2->core_addr.is_self)
+        return HG_TRUE;
+
+    /* Compare NA addresses */
+    ret &= (hg_bool_t) NA_Addr_cmp(addr1->core_addr.core_class->na_class,
+        addr1->core_addr.na_addr, addr2->core_addr.na_addr);
+
+#ifdef NA_HAS_SM
+    /* Compare NA SM addresses */
+    if (addr1->core_addr.core_class->na_sm_class)
+        ret &= (hg_bool_t) NA_Addr_cmp(addr1->core_addr.core_class->na_sm_class,
+            addr1->core_addr.na_sm_addr, addr2->core_addr.na_sm_addr);
+#endif
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_to_string(
+    char *buf, hg_size_t *buf_size, struct hg_core_private_addr *hg_core_addr)
+{
+    na_class_t *na_class = hg_core_addr->core_addr.core_class->na_class;
+    na_addr_t na_addr = hg_core_addr->core_addr.na_addr;
+    char *buf_ptr = buf;
+    hg_size_t new_buf_size = 0, buf_size_used = 0;
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+
+    new_buf_size = *buf_size;
+
+#ifdef NA_HAS_SM
+    /* When we have local and remote addresses */
+    if ((hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) &&
+        (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL)) {
+        char addr_str[HG_CORE_ADDR_MAX_SIZE];
+        char uuid_str[NA_SM_HOST_ID_LEN + 1];
+        int desc_len;
+
+        /* Convert host ID to string and generate addr string */
+        na_ret = NA_SM_Host_id_to_string(hg_core_addr->host_id, uuid_str);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "NA_SM_Host_id_to_string() failed (%s)",
+            NA_Error_to_string(na_ret));
+
+        desc_len = snprintf(addr_str, HG_CORE_ADDR_MAX_SIZE,
+            "uid://%s" HG_CORE_ADDR_DELIMITER, uuid_str);
+        HG_CHECK_ERROR(desc_len > HG_CORE_ADDR_MAX_SIZE, done, ret, HG_OVERFLOW,
+            "Exceeding max addr name");
+
+        if (buf_ptr) {
+            strcpy(buf_ptr, addr_str);
+            buf_ptr += desc_len;
+        }
+        buf_size_used += (hg_size_t) desc_len;
+        if (*buf_size > (unsigned int) desc_len)
+            new_buf_size = *buf_size - (hg_size_t) desc_len;
+
+        /* Get NA SM address string */
+        na_ret =
+            NA_Addr_to_string(hg_core_addr->core_addr.core_class->na_sm_class,
+                buf_ptr, &new_buf_size, hg_core_addr->core_addr.na_sm_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not convert SM address to string (%s)",
+            NA_Error_to_string(na_ret));
+
+        if (buf_ptr) {
+            buf_ptr[new_buf_size - 1] = *HG_CORE_ADDR_DELIMITER;
+            buf_ptr += new_buf_size;
+        }
+        buf_size_used += new_buf_size;
+        if (*buf_size > new_buf_size)
+            new_buf_size = *buf_size - new_buf_size;
+    } else if (hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
+        na_class = hg_core_addr->core_addr.core_class->na_sm_class;
+        na_addr = hg_core_addr->core_addr.na_sm_addr;
+    }
+#endif
+
+    /* Get NA address string */
+    na_ret = NA_Addr_to_string(na_class, buf_ptr, &new_buf_size, na_addr);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not convert address to string (%s)", NA_Error_to_string(na_ret));
+
+    *buf_size = new_buf_size + buf_size_used;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_core_addr_get_serialize_size(
+    struct hg_core_private_addr *hg_core_addr, hg_uint8_t flags)
+{
+    hg_size_t ret = sizeof(na_size_t);
+
+    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
+        if (hg_core_addr->na_addr_serialize_size == 0) {
+            /* Cache serialize size */
+            hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
+                hg_core_addr->core_addr.core_class->na_class,
+                hg_core_addr->core_addr.na_addr);
+        }
+
+        ret += hg_core_addr->na_addr_serialize_size;
+    }
+
+#ifdef NA_HAS_SM
+    ret += sizeof(na_size_t);
+
+    if ((flags & HG_CORE_SM) &&
+        hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
+        if (hg_core_addr->na_sm_addr_serialize_size == 0) {
+            /* Cache serialize size */
+            hg_core_addr->na_sm_addr_serialize_size =
+                NA_Addr_get_serialize_size(
+                    hg_core_addr->core_addr.core_class->na_sm_class,
+                    hg_core_addr->core_addr.na_sm_addr);
+        }
+
+        ret += hg_core_addr->na_sm_addr_serialize_size +
+               sizeof(hg_core_addr->host_id);
+    }
+#else
+    (void) flags;
+#endif
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_serialize(void *buf, hg_size_t buf_size, hg_uint8_t flags,
+    struct hg_core_private_addr *hg_core_addr)
+{
+    char *buf_ptr = (char *) buf;
+    hg_size_t buf_size_left = buf_size;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
+        na_return_t na_ret;
+
+        HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left,
+            &hg_core_addr->na_addr_serialize_size, na_size_t);
+
+        na_ret = NA_Addr_serialize(hg_core_addr->core_addr.core_class->na_class,
+            buf_ptr, buf_size_left, hg_core_addr->core_addr.na_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not serialize NA address (%s)", NA_Error_to_string(na_ret));
+        buf_ptr += hg_core_addr->na_addr_serialize_size;
+        buf_size_left -= hg_core_addr->na_addr_serialize_size;
+    } else {
+        na_size_t na_sm_addr_serialize_size = 0;
+
+        /* Encode a 0 instead of flag */
+        HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left,
+            &na_sm_addr_serialize_size, na_size_t);
+    }
+
+#ifdef NA_HAS_SM
+    if ((flags & HG_CORE_SM) &&
+        hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
+        na_return_t na_ret;
+
+        HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left,
+            &hg_core_addr->na_sm_addr_serialize_size, na_size_t);
+
+        na_ret =
+            NA_Addr_serialize(hg_core_addr->core_addr.core_class->na_sm_class,
+                buf_ptr, buf_size_left, hg_core_addr->core_addr.na_sm_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not serialize NA SM address (%s)",
+            NA_Error_to_string(na_ret));
+        buf_ptr += hg_core_addr->na_sm_addr_serialize_size;
+        buf_size_left -= hg_core_addr->na_sm_addr_serialize_size;
+    } else {
+        na_size_t na_sm_addr_serialize_size = 0;
+
+        /* Encode a 0 instead of flag */
+        HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left,
+            &na_sm_addr_serialize_size, na_size_t);
+    }
+#else
+    (void) flags;
+#endif
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_deserialize(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr **hg_core_addr_ptr, const void *buf,
+    hg_size_t buf_size)
+{
+    struct hg_core_private_addr *hg_core_addr = NULL;
+    const char *buf_ptr = (const char *) buf;
+    hg_size_t buf_size_left = buf_size;
+    hg_bool_t is_self = HG_TRUE;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Create new address */
+    hg_core_addr = hg_core_addr_create(hg_core_class);
+    HG_CHECK_ERROR(hg_core_addr == NULL, error, ret, HG_NOMEM,
+        "Could not create deserialized HG addr");
+
+    HG_CORE_DECODE(error, ret, buf_ptr, buf_size_left,
+        &hg_core_addr->na_addr_serialize_size, na_size_t);
+
+    if (hg_core_addr->na_addr_serialize_size != 0) {
+        na_return_t na_ret =
+            NA_Addr_deserialize(hg_core_class->core_class.na_class,
+                &hg_core_addr->core_addr.na_addr, buf_ptr, buf_size_left);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "Could not deserialize NA address (%s)",
+            NA_Error_to_string(na_ret));
+        buf_ptr += hg_core_addr->na_addr_serialize_size;
+        buf_size_left -= hg_core_addr->na_addr_serialize_size;
+
+        is_self &= NA_Addr_is_self(hg_core_class->core_class.na_class,
+            hg_core_addr->core_addr.na_addr);
+    }
+
+#ifdef NA_HAS_SM
+    HG_CORE_DECODE(error, ret, buf_ptr, buf_size_left,
+        &hg_core_addr->na_sm_addr_serialize_size, na_size_t);
+
+    if (hg_core_addr->na_sm_addr_serialize_size != 0) {
+        na_return_t na_ret =
+            NA_Addr_deserialize(hg_core_class->core_class.na_sm_class,
+                &hg_core_addr->core_addr.na_sm_addr, buf_ptr, buf_size_left);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "Could not deserialize NA SM address (%s)",
+            NA_Error_to_string(na_ret));
+        buf_ptr += hg_core_addr->na_sm_addr_serialize_size;
+        buf_size_left -= hg_core_addr->na_sm_addr_serialize_size;
+
+        is_self &= NA_Addr_is_self(hg_core_class->core_class.na_class,
+            hg_core_addr->core_addr.na_addr);
+    }
+#endif
+    hg_core_addr->core_addr.is_self = is_self;
+
+    *hg_core_addr_ptr = hg_core_addr;
+
+    return ret;
+
+error:
+    hg_core_addr_free(hg_core_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_size_t
+hg_core_addr_batch_entry_size(
+    struct hg_core_private_addr *const addrs[], hg_size_t count)
+{
+    na_size_t entry_size = 0;
+    hg_size_t i;
+
+    for (i = 0; i < count; i++) {
+        struct hg_core_private_addr *hg_core_addr = addrs[i];
+
+        /* Only the primary NA address is part of the batch */
+        if (hg_core_addr->core_addr.na_addr == NA_ADDR_NULL)
+            return 0;
+
+        if (hg_core_addr->na_addr_serialize_size == 0) {
+            /* Cache serialize size */
+            hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
+                hg_core_addr->core_addr.core_class->na_class,
+                hg_core_addr->core_addr.na_addr);
+        }
+        if (hg_core_addr->na_addr_serialize_size > entry_size)
+            entry_size = hg_core_addr->na_addr_serialize_size;
+    }
+
+    return entry_size;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_core_addr_get_serialize_batch_size(
+    struct hg_core_private_addr *const addrs[], hg_size_t count)
+{
+    const char *protocol =
+        NA_Get_class_protocol(addrs[0]->core_addr.core_class->na_class);
+    na_size_t entry_size = hg_core_addr_batch_entry_size(addrs, count);
+
+    if (entry_size == 0)
+        return 0;
+
+    /* Header is shared by all entries */
+    return 2 * sizeof(hg_uint32_t) + strlen(protocol) + 2 * sizeof(na_size_t) +
+           count * entry_size;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_serialize_batch(void *buf, hg_size_t buf_size,
+    struct hg_core_private_addr *const addrs[], hg_size_t count)
+{
+    na_class_t *na_class = addrs[0]->core_addr.core_class->na_class;
+    const char *protocol = NA_Get_class_protocol(na_class);
+    hg_uint32_t magic = HG_CORE_ADDR_BATCH_MAGIC;
+    hg_uint32_t protocol_len = (hg_uint32_t) strlen(protocol);
+    na_size_t na_count = (na_size_t) count;
+    na_size_t entry_size = hg_core_addr_batch_entry_size(addrs, count);
+    char *buf_ptr = (char *) buf;
+    hg_size_t buf_size_left = buf_size, i;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(entry_size == 0, done, ret, HG_INVALID_ARG,
+        "Could not get size of NA addresses");
+
+    HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left, &magic, hg_uint32_t);
+    HG_CORE_ENCODE(
+        done, ret, buf_ptr, buf_size_left, &protocol_len, hg_uint32_t);
+    HG_CORE_TYPE_ENCODE(
+        done, ret, buf_ptr, buf_size_left, protocol, protocol_len);
+    HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left, &na_count, na_size_t);
+    HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left, &entry_size, na_size_t);
+
+    HG_CHECK_ERROR(buf_size_left < count * entry_size, done, ret, HG_OVERFLOW,
+        "Buffer size too small (%zu)", buf_size_left);
+
+    /* Entries are padded to a fixed width */
+    memset(buf_ptr, 0, count * entry_size);
+    for (i = 0; i < count; i++) {
+        na_return_t na_ret;
+
+        HG_CHECK_ERROR(addrs[i]->core_addr.core_class->na_class != na_class,
+            done, ret, HG_INVALID_ARG,
+            "Address %zu does not belong to the same class", (size_t) i);
+
+        na_ret = NA_Addr_serialize(na_class, buf_ptr + i * entry_size,
+            entry_size, addrs[i]->core_addr.na_addr);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not serialize NA address %zu (%s)", (size_t) i,
+            NA_Error_to_string(na_ret));
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_deserialize_batch(struct hg_core_private_class *hg_core_class,
+    const void *buf, hg_size_t buf_size, struct hg_core_private_addr *addrs[],
+    hg_size_t *count_p)
+{
+    na_class_t *na_class = hg_core_class->core_class.na_class;
+    const char *protocol = NA_Get_class_protocol(na_class);
+    const char *buf_ptr = (const char *) buf;
+    hg_size_t buf_size_left = buf_size, count, i;
+    hg_uint32_t magic, protocol_len;
+    na_size_t na_count, entry_size;
+    na_addr_t *na_addrs = NULL;
+    na_return_t na_ret;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CORE_DECODE(done, ret, buf_ptr, buf_size_left, &magic, hg_uint32_t);
+    HG_CHECK_ERROR(magic != HG_CORE_ADDR_BATCH_MAGIC, done, ret,
+        HG_PROTOCOL_ERROR, "Buffer does not hold an address batch");
+
+    HG_CORE_DECODE(
+        done, ret, buf_ptr, buf_size_left, &protocol_len, hg_uint32_t);
+    HG_CHECK_ERROR(buf_size_left < protocol_len, done, ret, HG_OVERFLOW,
+        "Buffer size too small (%zu)", buf_size_left);
+    HG_CHECK_ERROR(protocol_len != strlen(protocol) ||
+                       strncmp(buf_ptr, protocol, protocol_len) != 0,
+        done, ret, HG_PROTONOSUPPORT,
+        "Address batch protocol does not match %s", protocol);
+    buf_ptr += protocol_len;
+    buf_size_left -= protocol_len;
+
+    HG_CORE_DECODE(done, ret, buf_ptr, buf_size_left, &na_count, na_size_t);
+    HG_CORE_DECODE(done, ret, buf_ptr, buf_size_left, &entry_size, na_size_t);
+    count = (hg_size_t) na_count;
+
+    /* Let caller query the number of addresses */
+    if (addrs == NULL) {
+        *count_p = count;
+        goto done;
+    }
+    HG_CHECK_ERROR(*count_p < count, done, ret, HG_OVERFLOW,
+        "Array of %zu addresses too small for %zu addresses", (size_t) *count_p,
+        (size_t) count);
+    HG_CHECK_ERROR(count > 0 && (entry_size == 0 ||
+                                    buf_size_left / entry_size < count),
+        done, ret, HG_OVERFLOW, "Buffer size too small (%zu)", buf_size_left);
+
+    for (i = 0; i < count; i++)
+        addrs[i] = NULL;
+    *count_p = count;
+    if (count == 0)
+        goto done;
+
+    na_addrs = (na_addr_t *) malloc(count * sizeof(*na_addrs));
+    HG_CHECK_ERROR(na_addrs == NULL, done, ret, HG_NOMEM,
+        "Could not allocate array of NA addrs");
+
+    na_ret = NA_Addr_deserialize_batch(
+        na_class, buf_ptr, entry_size, count, na_addrs);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not deserialize %zu NA addresses (%s)", (size_t) count,
+        NA_Error_to_string(na_ret));
+
+    for (i = 0; i < count; i++) {
+        struct hg_core_private_addr *hg_core_addr =
+            hg_core_addr_create(hg_core_class);
+
+        if (hg_core_addr == NULL) {
+            for (; i < count; i++)
+                NA_Addr_free(na_class, na_addrs[i]);
+            HG_GOTO_ERROR(error, ret, HG_NOMEM, "Could not create HG addr");
+        }
+        hg_core_addr->core_addr.na_addr = na_addrs[i];
+        hg_core_addr->core_addr.is_self =
+            NA_Addr_is_self(na_class, na_addrs[i]);
+        addrs[i] = hg_core_addr;
+    }
+
+done:
+    free(na_addrs);
+
+    return ret;
+
+error:
+    for (i = 0; i < count; i++) {
+        hg_core_addr_free(addrs[i]);
+        addrs[i] = NULL;
+    }
+    free(na_addrs);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_create(struct hg_core_private_context *context, na_class_t *na_class,
+    na_context_t *na_context,
+    struct hg_core_private_handle **hg_core_handle_ptr)
+{
+    struct hg_core_private_handle *hg_core_handle = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Re-use a previously freed handle if any */
+    hg_core_handle = hg_core_pool_get(context, na_class);
+    if (!hg_core_handle) {
+        hg_core_context_alloc_fallback(&context->core_context, "handle");
+
+        /* Allocate new handle */
+        hg_core_handle = hg_core_alloc(context);
+        HG_CHECK_ERROR(hg_core_handle == NULL, error, ret, HG_NOMEM,
+            "Could not allocate handle");
+
+        /* Alloc/init NA resources */
+        ret = hg_core_alloc_na(hg_core_handle, na_class, na_context);
+        HG_CHECK_HG_ERROR(error, ret, "Could not allocate NA handle ops");
+    }
+
+    /* Execute class callback on handle, this allows upper layers to
+     * allocate private data on handle creation */
+    if (context->handle_create) {
+        ret = context->handle_create(
+            (hg_core_handle_t) hg_core_handle, context->handle_create_arg);
+        HG_CHECK_HG_ERROR(error, ret, "Error in HG handle create callback");
+    }
+
+    hg_core_trace(hg_core_handle, HG_TRACE_CREATE, 0);
+
+    HG_LOG_DEBUG("Created new handle (%p)", hg_core_handle);
+
+    *hg_core_handle_ptr = hg_core_handle;
+
+    return ret;
+
+error:
+    hg_core_destroy(hg_core_handle);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_destroy(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_core_handle)
+        goto done;
+
+    if (hg_atomic_decr32(&hg_core_handle->ref_count))
+        goto done; /* Cannot free yet */
+
+    hg_core_trace(hg_core_handle, HG_TRACE_DESTROY, 0);
+
+    /* Repost handle if we were listening, otherwise destroy it */
+    if (hg_core_handle->repost &&
+        !HG_CORE_HANDLE_CONTEXT(hg_core_handle)->finalizing) {
+        HG_LOG_DEBUG("Reposting handle (%p)", hg_core_handle);
+
+        /* Repost handle */
+        ret = hg_core_reset_post(hg_core_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Cannot repost handle");
+
+        /* TODO handle error */
+    } else {
+        HG_LOG_DEBUG("Freeing handle (%p)", hg_core_handle);
+
+        /* Handle will not be reposted */
+        hg_core_post_unlist(hg_core_handle);
+
+        /* Free extra data here if needed */
+        if (HG_CORE_HANDLE_CLASS(hg_core_handle)->more_data_release)
+            HG_CORE_HANDLE_CLASS(hg_core_handle)
+                ->more_data_release((hg_core_handle_t) hg_core_handle);
+
+        /* Free user data */
+        if (hg_core_handle->core_handle.data_free_callback)
+            hg_core_handle->core_handle.data_free_callback(
+                hg_core_handle->core_handle.data);
+
+        /* Keep handle and its NA resources for re-use if possible */
+        if (hg_core_handle->na_class && hg_core_pool_put(hg_core_handle))
+            goto done;
+
+        /* Free NA resources */
+        if (hg_core_handle->na_class) {
+            ret = hg_core_free_na(hg_core_handle);
+            HG_CHECK_HG_ERROR(done, ret, "Could not free NA ressources");
+        }
+
+        /* Free handle */
+        hg_core_free(hg_core_handle);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_track(struct hg_core_private_context *context,
+    struct hg_core_private_handle *hg_core_handle)
+{
+    /* Handles are counted by n_handles, the list of created handles is only
+     * kept to report leaked handles */
+#ifdef HG_HAS_DEBUG
+    hg_thread_spin_lock(&context->created_list_lock);
+    HG_LIST_INSERT_HEAD(&context->created_list, hg_core_handle, created);
+    hg_thread_spin_unlock(&context->created_list_lock);
+#else
+    (void) context;
+    (void) hg_core_handle;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_untrack(struct hg_core_private_context *context,
+    struct hg_core_private_handle *hg_core_handle)
+{
+#ifdef HG_HAS_DEBUG
+    hg_thread_spin_lock(&context->created_list_lock);
+    HG_LIST_REMOVE(hg_core_handle, created);
+    hg_thread_spin_unlock(&context->created_list_lock);
+#else
+    (void) context;
+    (void) hg_core_handle;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_private_handle *
+hg_core_alloc(struct hg_core_private_context *context)
+{
+    struct hg_core_private_handle *hg_core_handle = NULL;
+
+    hg_core_handle = (struct hg_core_private_handle *) malloc(
+        sizeof(struct hg_core_private_handle));
+    HG_CHECK_ERROR_NORET(
+        hg_core_handle == NULL, done, "Could not allocate handle");
+
+    memset(hg_core_handle, 0, sizeof(struct hg_core_private_handle));
+    hg_core_context_mem_add(context, HG_MEM_USE_HANDLE,
+        (hg_util_int64_t) sizeof(struct hg_core_private_handle));
+
+    hg_core_handle->op_type = HG_CORE_PROCESS; /* Default */
+    hg_core_handle->core_handle.info.core_class =
+        context->core_context.core_class;
+    hg_core_handle->core_handle.info.context = &context->core_context;
+    hg_core_handle->core_handle.info.addr = HG_CORE_ADDR_NULL;
+    hg_core_handle->core_handle.info.id = 0;
+    hg_core_handle->core_handle.info.context_id = 0;
+
+    /* Default return code */
+    hg_core_handle->ret = HG_SUCCESS;
+
+    /* Add handle to handle list so that we can track it */
+    hg_core_track(context, hg_core_handle);
+
+    /* Completed by default */
+    hg_atomic_init32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+
+    /* Init in/out header */
+    hg_core_header_request_init(&hg_core_handle->in_header);
+    hg_core_header_response_init(&hg_core_handle->out_header);
+    hg_core_set_header_size(hg_core_handle, HG_FALSE);
+
+    /* Set refcount to 1 */
+    hg_atomic_init32(&hg_core_handle->ref_count, 1);
+
+    /* Increment N handles from HG context */
+    hg_atomic_incr32(&context->n_handles);
+
+done:
+    return hg_core_handle;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_free(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Remove reference to HG addr */
+    ret = hg_core_addr_free(
+        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not free address");
+
+    /* Remove handle from list */
+    hg_core_untrack(HG_CORE_HANDLE_CONTEXT(hg_core_handle), hg_core_handle);
+
+    /* Decrement N handles from HG context */
+    hg_atomic_decr32(&HG_CORE_HANDLE_CONTEXT(hg_core_handle)->n_handles);
+    hg_core_context_mem_add(HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+        HG_MEM_USE_HANDLE,
+        -(hg_util_int64_t) sizeof(struct hg_core_private_handle));
+
+    hg_core_header_request_finalize(&hg_core_handle->in_header);
+    hg_core_header_response_finalize(&hg_core_handle->out_header);
+
+    free(hg_core_handle->ext);
+    free(hg_core_handle);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_handle_ext *
+hg_core_ext_get(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_handle_ext *ext = hg_core_handle->ext;
+
+    if (ext)
+        return ext;
+
+    hg_core_context_alloc_fallback(
+        hg_core_handle->core_handle.info.context, "handle ext");
+    ext = (struct hg_core_handle_ext *) calloc(
+        1, sizeof(struct hg_core_handle_ext));
+    HG_CHECK_ERROR_NORET(ext == NULL, done, "Could not allocate handle ext");
+
+    /* Timer is only armed by timed or delayed forwards */
+    hg_timer_init(&ext->timer, hg_core_timer_expire, hg_core_handle);
+
+    hg_core_handle->ext = ext;
+
+done:
+    return ext;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_ack_buf_alloc(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_handle_ext *ext = hg_core_ext_get(hg_core_handle);
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+
+    HG_CHECK_ERROR(
+        ext == NULL, error, ret, HG_NOMEM, "Could not allocate handle ext");
+
+    /* Chunks of streamed responses are all acked with the same buffer */
+    if (ext->ack_buf)
+        return ret;
+
+    if (!ext->na_ack_op_id) {
+        ext->na_ack_op_id = NA_Op_create(hg_core_handle->na_class);
+        HG_CHECK_ERROR(ext->na_ack_op_id == NULL, error, ret, HG_NA_ERROR,
+            "Could not create NA op ID");
+    }
+
+    ext->ack_buf = NA_Msg_buf_alloc(hg_core_handle->na_class,
+        sizeof(hg_uint8_t), &ext->ack_buf_plugin_data);
+    HG_CHECK_ERROR(ext->ack_buf == NULL, error, ret, HG_NA_ERROR,
+        "Could not allocate buffer for ack");
+
+    na_ret = NA_Msg_init_expected(
+        hg_core_handle->na_class, ext->ack_buf, sizeof(hg_uint8_t));
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+        "Could not initialize ack buffer (%s)", NA_Error_to_string(na_ret));
+
+    return ret;
+
+error:
+    na_ret = hg_core_ack_buf_free(hg_core_handle);
+    HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
+        "Could not free ack buffer (%s)", NA_Error_to_string(na_ret));
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+hg_core_ack_buf_free(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_handle_ext *ext = hg_core_handle->ext;
+    na_return_t ret;
+
+    if (!ext || !ext->ack_buf)
+        return NA_SUCCESS;
+
+    ret = NA_Msg_buf_free(
+        hg_core_handle->na_class, ext->ack_buf, ext->ack_buf_plugin_data);
+    ext->ack_buf = NULL;
+    ext->ack_buf_plugin_data = NULL;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_alloc_na(struct hg_core_private_handle *hg_core_handle,
+    na_class_t *na_class, na_context_t *na_context)
+{
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+
+    /* Set NA class / context */
+    hg_core_handle->na_class = na_class;
+    hg_core_handle->na_context = na_context;
+
+    /* Initialize in/out buffers and use unexpected message size */
+    hg_core_handle->core_handle.in_buf_size =
+        NA_Msg_get_max_unexpected_size(na_class);
+    hg_core_handle->core_handle.out_buf_size =
+        NA_Msg_get_max_expected_size(na_class);
+    hg_core_handle->core_handle.na_in_header_offset =
+        NA_Msg_get_unexpected_header_size(na_class);
+    hg_core_handle->core_handle.na_out_header_offset =
+        NA_Msg_get_expected_header_size(na_class);
+
+    hg_core_handle->core_handle.in_buf =
+        NA_Msg_buf_alloc(na_class, hg_core_handle->core_handle.in_buf_size,
+            &hg_core_handle->in_buf_plugin_data);
+    HG_CHECK_ERROR(hg_core_handle->core_handle.in_buf == NULL, error, ret,
+        HG_NOMEM, "Could not allocate buffer for input");
+    hg_core_context_mem_add(HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+        HG_MEM_USE_HANDLE,
+        (hg_util_int64_t) hg_core_handle->core_handle.in_buf_size);
+
+    na_ret =
+        NA_Msg_init_unexpected(na_class, hg_core_handle->core_handle.in_buf,
+            hg_core_handle->core_handle.in_buf_size);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+        "Could not initialize input buffer (%s)", NA_Error_to_string(na_ret));
+
+    hg_core_handle->core_handle.out_buf =
+        NA_Msg_buf_alloc(na_class, hg_core_handle->core_handle.out_buf_size,
+            &hg_core_handle->out_buf_plugin_data);
+    HG_CHECK_ERROR(hg_core_handle->core_handle.out_buf == NULL, error, ret,
+        HG_NOMEM, "Could not allocate buffer for output");
+    hg_core_context_mem_add(HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+        HG_MEM_USE_HANDLE,
+        (hg_util_int64_t) hg_core_handle->core_handle.out_buf_size);
+
+    na_ret = NA_Msg_init_expected(na_class, hg_core_handle->core_handle.out_buf,
+        hg_core_handle->core_handle.out_buf_size);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+        "Could not initialize output buffer (%s)", NA_Error_to_string(na_ret));
+
+    /* Create NA operation IDs */
+    hg_core_handle->na_send_op_id = NA_Op_create(na_class);
+    HG_CHECK_ERROR(hg_core_handle->na_send_op_id == NULL, error, ret,
+        HG_NA_ERROR, "Could not create NA op ID");
+    hg_core_handle->na_recv_op_id = NA_Op_create(na_class);
+    HG_CHECK_ERROR(hg_core_handle->na_recv_op_id == NULL, error, ret,
+        HG_NA_ERROR, "Could not create NA op ID");
+
+    hg_core_handle->na_op_count = 1; /* Default (no response) */
+    hg_atomic_init32(&hg_core_handle->na_op_completed_count, 0);
+    hg_atomic_init32(&hg_core_handle->na_op_pending_count, 0);
+
+    return ret;
+
+error:
+    hg_core_free_na(hg_core_handle);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_free_na(struct hg_core_private_handle *hg_core_handle)
 {
-    char *header_buf =
-        (char *) hg_core_handle->out_buf + hg_core_handle->na_out_header_offset;
-    size_t header_buf_size =
-        hg_core_handle->out_buf_size - hg_core_handle->na_out_header_offset;
     hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
 
-    /* Proc response header */
-    ret = hg_core_header_response_proc(
-        op, header_buf, header_buf_size, hg_core_header);
-    HG_CHECK_HG_ERROR(done, ret, "Could not process response header");
+    /* Destroy NA op IDs */
+    na_ret =
+        NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_send_op_id);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not destroy send op ID (%s)", NA_Error_to_string(na_ret));
+    hg_core_handle->na_send_op_id = NULL;
 
-    if (op == HG_DECODE) {
-        ret = hg_core_header_response_verify(hg_core_header);
-        HG_CHECK_HG_ERROR(done, ret, "Could not verify response header");
+    na_ret =
+        NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_recv_op_id);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not destroy recv op ID (%s)", NA_Error_to_string(na_ret));
+    hg_core_handle->na_recv_op_id = NULL;
+
+    if (hg_core_handle->ext && hg_core_handle->ext->na_ack_op_id) {
+        na_ret = NA_Op_destroy(
+            hg_core_handle->na_class, hg_core_handle->ext->na_ack_op_id);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not destroy ack op ID (%s)", NA_Error_to_string(na_ret));
+        hg_core_handle->ext->na_ack_op_id = NULL;
     }
 
+    /* Free buffers */
+    if (hg_core_handle->core_handle.in_buf)
+        hg_core_context_mem_add(HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+            HG_MEM_USE_HANDLE,
+            -(hg_util_int64_t) hg_core_handle->core_handle.in_buf_size);
+    na_ret = NA_Msg_buf_free(hg_core_handle->na_class,
+        hg_core_handle->core_handle.in_buf, hg_core_handle->in_buf_plugin_data);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not free input buffer (%s)", NA_Error_to_string(na_ret));
+    hg_core_handle->core_handle.in_buf = NULL;
+    hg_core_handle->in_buf_plugin_data = NULL;
+
+    if (hg_core_handle->core_handle.out_buf)
+        hg_core_context_mem_add(HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+            HG_MEM_USE_HANDLE,
+            -(hg_util_int64_t) hg_core_handle->core_handle.out_buf_size);
+    na_ret = NA_Msg_buf_free(hg_core_handle->na_class,
+        hg_core_handle->core_handle.out_buf,
+        hg_core_handle->out_buf_plugin_data);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not free output buffer (%s)", NA_Error_to_string(na_ret));
+    hg_core_handle->core_handle.out_buf = NULL;
+    hg_core_handle->out_buf_plugin_data = NULL;
+
+    na_ret = hg_core_ack_buf_free(hg_core_handle);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not free ack buffer (%s)", NA_Error_to_string(na_ret));
+
+    hg_core_handle->na_class = NULL;
+    hg_core_handle->na_context = NULL;
+
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static struct hg_core_private_class *
-hg_core_init(const char *na_info_string, hg_bool_t na_listen,
-    const struct hg_init_info *hg_init_info)
+static struct hg_core_private_handle *
+hg_core_pool_get(struct hg_core_private_context *context, na_class_t *na_class)
 {
-    struct hg_core_private_class *hg_core_class = NULL;
-    na_tag_t na_max_tag;
-#ifdef NA_HAS_SM
-    na_tag_t na_sm_max_tag;
-    const char *na_class_name;
-    hg_bool_t auto_sm = HG_FALSE;
-#endif
-    hg_return_t ret = HG_SUCCESS;
-
-    /* Create new HG class */
-    hg_core_class = (struct hg_core_private_class *) malloc(
-        sizeof(struct hg_core_private_class));
-    HG_CHECK_ERROR(hg_core_class == NULL, error, ret, HG_NOMEM,
-        "Could not allocate HG class");
-    memset(hg_core_class, 0, sizeof(struct hg_core_private_class));
+    struct hg_core_handle_list *handle_pool = &context->handle_pool;
+    struct hg_core_private_handle *hg_core_handle;
 
-    /* Parse options */
-    if (hg_init_info) {
-        /* External NA class */
-        if (hg_init_info->na_class) {
-            hg_core_class->core_class.na_class = hg_init_info->na_class;
-            hg_core_class->na_ext_init = HG_TRUE;
-        }
-        /* request_post_incr is used only if request_post_init is non-zero */
-        if (hg_init_info->request_post_init == 0) {
-            hg_core_class->request_post_init = HG_CORE_POST_INIT;
-            hg_core_class->request_post_incr = HG_CORE_POST_INCR;
-        } else {
-            hg_core_class->request_post_init = hg_init_info->request_post_init;
-            hg_core_class->request_post_incr = hg_init_info->request_post_incr;
-        }
-        hg_core_class->progress_mode = hg_init_info->na_init_info.progress_mode;
 #ifdef NA_HAS_SM
-        auto_sm = hg_init_info->auto_sm;
+    if (na_class == HG_CORE_CONTEXT_CLASS(context)->core_class.na_sm_class)
+        handle_pool = &context->sm_handle_pool;
 #else
-        HG_CHECK_WARNING(hg_init_info->auto_sm,
-            "Option auto_sm requested but NA SM pluging was not compiled, "
-            "please turn ON NA_USE_SM in CMake options");
-#endif
-        hg_core_class->loopback = !hg_init_info->no_loopback;
-#ifdef HG_HAS_COLLECT_STATS
-        hg_core_class->stats = hg_init_info->stats;
-        if (hg_core_class->stats && !hg_core_print_stats_registered_g) {
-            int rc = atexit(hg_core_print_stats);
-            HG_CHECK_ERROR(rc != 0, error, ret, HG_PROTOCOL_ERROR,
-                "Could not register hg_core_print_stats");
-            hg_core_print_stats_registered_g = HG_TRUE;
-        }
+    (void) na_class;
 #endif
-    } else {
-        hg_core_class->request_post_init = HG_CORE_POST_INIT;
-        hg_core_class->request_post_incr = HG_CORE_POST_INCR;
-        hg_core_class->loopback = HG_TRUE;
-    }
 
-    /* Initialize NA if not provided externally */
-    if (!hg_core_class->na_ext_init) {
-        hg_core_class->core_class.na_class = NA_Initialize_opt(
-            na_info_string, na_listen, &hg_init_info->na_init_info);
-        HG_CHECK_ERROR(hg_core_class->core_class.na_class == NULL, error, ret,
-            HG_NA_ERROR, "Could not initialize NA class");
+    hg_thread_spin_lock(&context->handle_pool_lock);
+    hg_core_handle = HG_LIST_FIRST(handle_pool);
+    if (hg_core_handle) {
+        HG_LIST_REMOVE(hg_core_handle, created);
+        context->handle_pool_count--;
     }
+    hg_thread_spin_unlock(&context->handle_pool_lock);
 
-#ifdef NA_HAS_SM
-    /* Retrieve NA class name */
-    na_class_name = NA_Get_class_name(hg_core_class->core_class.na_class);
+    if (!hg_core_handle)
+        goto done;
 
-    /* Check for compatibility with SM */
-    if (auto_sm && strcmp(na_class_name, "mpi") == 0) {
-        HG_LOG_WARNING(
-            "Auto SM mode is not compatible with MPI NA class, disabling");
-        auto_sm = HG_FALSE;
-    }
-    if (auto_sm && strcmp(na_class_name, "na") == 0) {
-        HG_LOG_WARNING(
-            "Auto SM mode is set but NA class is already SM, ignoring");
-        auto_sm = HG_FALSE;
-    }
+    /* Add handle back to handle list so that we can track it */
+    hg_core_track(context, hg_core_handle);
 
-    /* Initialize SM plugin */
-    if (auto_sm) {
-        na_return_t na_ret;
+    /* Completed by default */
+    hg_atomic_set32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
 
-        /* Initialize NA SM first so that tmp directories are created */
-        hg_core_class->core_class.na_sm_class =
-            NA_Initialize_opt("na+sm", na_listen, &hg_init_info->na_init_info);
-        HG_CHECK_ERROR(hg_core_class->core_class.na_sm_class == NULL, error,
-            ret, HG_NA_ERROR, "Could not initialize NA SM class");
+    /* Set refcount to 1 */
+    hg_atomic_set32(&hg_core_handle->ref_count, 1);
 
-        /* Get SM host ID */
-        na_ret = NA_SM_Host_id_get(&hg_core_class->host_id);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-            "NA_SM_Host_id_get() failed (%s)", NA_Error_to_string(na_ret));
-    }
-#endif
+    /* Increment N handles from HG context */
+    hg_atomic_incr32(&context->n_handles);
 
-    /* Compute max request tag */
-    na_max_tag = NA_Msg_get_max_tag(hg_core_class->core_class.na_class);
-    HG_CHECK_ERROR(
-        na_max_tag == 0, error, ret, HG_NA_ERROR, "NA Max tag is not defined");
-    hg_core_class->request_max_tag = na_max_tag;
+done:
+    return hg_core_handle;
+}
 
-#ifdef NA_HAS_SM
-    if (auto_sm) {
-        na_sm_max_tag =
-            NA_Msg_get_max_tag(hg_core_class->core_class.na_sm_class);
-        HG_CHECK_ERROR(na_sm_max_tag == 0, error, ret, HG_NA_ERROR,
-            "NA Max tag is not defined");
-        hg_core_class->request_max_tag =
-            HG_CORE_MIN(hg_core_class->request_max_tag, na_sm_max_tag);
-    }
-#endif
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_pool_put(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_handle_list *handle_pool = &context->handle_pool;
+    hg_return_t ret;
 
-    /* Initialize atomic for tags */
-    hg_atomic_init32(&hg_core_class->request_tag, 0);
+    /* NA operation IDs cannot be re-used until all of them have completed,
+     * count is only used as a hint */
+    if (context->finalizing || hg_core_handle->trimmed ||
+        hg_atomic_get32(&hg_core_handle->na_op_pending_count) != 0 ||
+        context->handle_pool_count >=
+            HG_CORE_MAX(HG_CORE_HANDLE_POOL_MAX,
+                HG_CORE_CONTEXT_CLASS(context)->prealloc_count))
+        return HG_FALSE;
 
-    /* No context created yet */
-    hg_atomic_init32(&hg_core_class->n_contexts, 0);
+    /* Remove reference to HG addr */
+    ret = hg_core_addr_free(
+        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr);
+    HG_CHECK_HG_ERROR(error, ret, "Could not free address");
+    hg_core_handle->core_handle.info.addr = HG_CORE_ADDR_NULL;
+    hg_core_handle->core_handle.info.id = 0;
+    hg_core_handle->core_handle.rpc_info = NULL;
+    hg_core_handle->na_addr = NA_ADDR_NULL;
+    hg_core_handle->is_self = HG_FALSE;
+    hg_core_handle->repost = HG_FALSE;
 
-    /* No addr created yet */
-    hg_atomic_init32(&hg_core_class->n_addrs, 0);
+    /* User data was already freed, upper layers attach new data on create */
+    hg_core_handle->core_handle.data = NULL;
+    hg_core_handle->core_handle.data_free_callback = NULL;
 
-    /* Create new function map */
-    hg_core_class->func_map =
-        hg_hash_table_new(hg_core_int_hash, hg_core_int_equal);
-    HG_CHECK_ERROR(hg_core_class->func_map == NULL, error, ret, HG_NOMEM,
-        "Could not create function map");
+    /* Reset the handle, NA resources are kept */
+    hg_core_reset(hg_core_handle);
 
-    /* Automatically free all the values with the hash map */
-    hg_hash_table_register_free_functions(
-        hg_core_class->func_map, free, hg_core_func_map_value_free);
+    /* Remove handle from list */
+    hg_core_untrack(context, hg_core_handle);
 
-    /* Initialize mutex */
-    hg_thread_spin_init(&hg_core_class->func_map_lock);
+    /* Decrement N handles from HG context */
+    hg_atomic_decr32(&context->n_handles);
 
-    // TODO return error code
-    (void) ret;
-    return hg_core_class;
+#ifdef NA_HAS_SM
+    if (hg_core_handle->na_class ==
+        HG_CORE_CONTEXT_CLASS(context)->core_class.na_sm_class)
+        handle_pool = &context->sm_handle_pool;
+#endif
+
+    hg_thread_spin_lock(&context->handle_pool_lock);
+    HG_LIST_INSERT_HEAD(handle_pool, hg_core_handle, created);
+    context->handle_pool_count++;
+    hg_thread_spin_unlock(&context->handle_pool_lock);
+
+    return HG_TRUE;
 
 error:
-    hg_core_finalize(hg_core_class);
-    return NULL;
+    return HG_FALSE;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_finalize(struct hg_core_private_class *hg_core_class)
+hg_core_pool_prealloc(
+    struct hg_core_private_context *context, unsigned int count)
 {
-    hg_util_int32_t n_addrs, n_contexts;
     hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    HG_LOG_DEBUG("Preallocating %u handles", count);
+
+    for (i = 0; i < count; i++) {
+        struct hg_core_private_handle *hg_core_handle;
+
+        hg_core_handle = hg_core_alloc(context);
+        HG_CHECK_ERROR(hg_core_handle == NULL, done, ret, HG_NOMEM,
+            "Could not allocate handle");
+
+        /* Extension is also kept along with the handle */
+        ret = hg_core_alloc_na(hg_core_handle,
+            context->core_context.core_class->na_class,
+            context->core_context.na_context);
+        if (ret == HG_SUCCESS && hg_core_ext_get(hg_core_handle) == NULL)
+            ret = HG_NOMEM;
+        if (ret != HG_SUCCESS || !hg_core_pool_put(hg_core_handle)) {
+            hg_core_destroy(hg_core_handle);
+            HG_GOTO_ERROR(done, ret, (ret != HG_SUCCESS) ? ret : HG_OTHER_ERROR,
+                "Could not add handle to pool");
+        }
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_pool_destroy(struct hg_core_handle_list *handle_pool)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    while (!HG_LIST_IS_EMPTY(handle_pool)) {
+        struct hg_core_private_handle *hg_core_handle =
+            HG_LIST_FIRST(handle_pool);
+
+        HG_LIST_REMOVE(hg_core_handle, created);
+
+        ret = hg_core_free_na(hg_core_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not free NA ressources");
+
+        hg_core_header_request_finalize(&hg_core_handle->in_header);
+        hg_core_header_response_finalize(&hg_core_handle->out_header);
+
+        free(hg_core_handle->ext);
+        free(hg_core_handle);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_reset(struct hg_core_private_handle *hg_core_handle)
+{
     na_return_t na_ret;
 
-    if (!hg_core_class)
-        goto done;
+    /* TODO context ID must always be reset as it is not passed along with the
+     * addr */
+    hg_core_handle->core_handle.info.context_id = 0;
 
-    n_contexts = hg_atomic_get32(&hg_core_class->n_contexts);
-    HG_CHECK_ERROR(n_contexts != 0, done, ret, HG_BUSY,
-        "HG contexts must be destroyed before finalizing HG (%d remaining)",
-        n_contexts);
+    hg_core_handle->request_callback = NULL;
+    hg_core_handle->request_arg = NULL;
+    hg_core_handle->response_callback = NULL;
+    hg_core_handle->response_arg = NULL;
+    hg_core_handle->op_type = HG_CORE_PROCESS; /* Default */
+    hg_core_handle->tag = 0;
+    hg_core_handle->core_handle.shard_key = 0;
+    hg_core_handle->cookie = 0;
+    hg_core_handle->ret = HG_SUCCESS;
+    hg_core_handle->process_ret = HG_SUCCESS;
+    hg_core_handle->in_buf_used = 0;
+    hg_core_handle->out_buf_used = 0;
+    hg_core_handle->na_op_count = 1; /* Default (no response) */
+    hg_atomic_set32(&hg_core_handle->na_op_completed_count, 0);
+    hg_core_handle->no_response = HG_FALSE;
+    hg_core_handle->coalesced = HG_FALSE;
+    hg_core_handle->coalesce_received = HG_FALSE;
+    hg_core_handle->timed = HG_FALSE;
+    hg_core_handle->delayed = HG_FALSE;
+    hg_core_handle->persistent = HG_FALSE;
+    hg_core_handle->tag_reserved = HG_FALSE;
+    hg_core_handle->tag_batched = HG_FALSE;
+    hg_core_handle->header_encoded = HG_FALSE;
 
-    n_addrs = hg_atomic_get32(&hg_core_class->n_addrs);
-    HG_CHECK_ERROR(n_addrs != 0, done, ret, HG_BUSY,
-        "HG addrs must be freed before finalizing HG (%d remaining)", n_addrs);
+    /* Free extra data here if needed */
+    if (HG_CORE_HANDLE_CLASS(hg_core_handle)->more_data_release)
+        HG_CORE_HANDLE_CLASS(hg_core_handle)
+            ->more_data_release((hg_core_handle_t) hg_core_handle);
+
+    na_ret = hg_core_ack_buf_free(hg_core_handle);
+    HG_CHECK_ERROR_NORET(na_ret != NA_SUCCESS, done,
+        "Could not free ack buffer (%s)", NA_Error_to_string(na_ret));
+
+    hg_core_header_request_reset(&hg_core_handle->in_header);
+    hg_core_header_response_reset(&hg_core_handle->out_header);
+
+done:
+    return;
+}
 
-    /* Delete function map */
-    if (hg_core_class->func_map)
-        hg_hash_table_free(hg_core_class->func_map);
-    hg_core_class->func_map = NULL;
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_reset_post(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_return_t ret = HG_SUCCESS;
 
-    /* Free user data */
-    if (hg_core_class->core_class.data_free_callback)
-        hg_core_class->core_class.data_free_callback(
-            hg_core_class->core_class.data);
+    /* Reset handle info */
+    if (hg_core_handle->core_handle.info.addr != HG_CORE_ADDR_NULL) {
+        ret = hg_core_addr_free_na((struct hg_core_private_addr *)
+                                       hg_core_handle->core_handle.info.addr);
+        HG_CHECK_HG_ERROR(done, ret, "Could not free NA addresses");
+    }
+    hg_core_handle->core_handle.info.id = 0;
 
-    /* Destroy mutex */
-    hg_thread_spin_destroy(&hg_core_class->func_map_lock);
+    /* Reset the handle */
+    hg_core_reset(hg_core_handle);
 
-    if (!hg_core_class->na_ext_init) {
-        /* Finalize interface */
-        na_ret = NA_Finalize(hg_core_class->core_class.na_class);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not finalize NA interface (%s)", NA_Error_to_string(na_ret));
-        hg_core_class->core_class.na_class = NULL;
-    }
+    /* Also reset additional handle parameters */
+    hg_atomic_set32(&hg_core_handle->ref_count, 1);
+    hg_core_handle->core_handle.rpc_info = NULL;
 
-#ifdef NA_HAS_SM
-    /* Finalize SM interface */
-    na_ret = NA_Finalize(hg_core_class->core_class.na_sm_class);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-        "Could not finalize NA SM interface (%s)", NA_Error_to_string(na_ret));
-#endif
+    /* Reset status */
+    hg_atomic_set32(&hg_core_handle->status, 0);
 
-    /* Free HG class */
-    free(hg_core_class);
+    hg_core_trace(hg_core_handle, HG_TRACE_CREATE, 0);
+
+    /* Safe to repost */
+    ret = hg_core_post(hg_core_handle);
+    HG_CHECK_HG_ERROR(done, ret, "Cannot post handle");
 
 done:
     return ret;
@@ -1053,265 +6015,351 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_context_create(hg_core_class_t *hg_core_class, hg_uint8_t id,
-    struct hg_core_private_context **context_ptr)
+hg_core_set_rpc(struct hg_core_private_handle *hg_core_handle,
+    struct hg_core_private_addr *hg_core_addr, na_addr_t na_addr, hg_id_t id)
 {
-    struct hg_core_private_context *context = NULL;
     hg_return_t ret = HG_SUCCESS;
-    int na_poll_fd;
-
-    context = (struct hg_core_private_context *) malloc(
-        sizeof(struct hg_core_private_context));
-    HG_CHECK_ERROR(
-        context == NULL, error, ret, HG_NOMEM, "Could not allocate HG context");
 
-    memset(context, 0, sizeof(struct hg_core_private_context));
-    context->core_context.core_class = hg_core_class;
-    context->completion_queue =
-        hg_atomic_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE);
-    HG_CHECK_ERROR(context->completion_queue == NULL, error, ret, HG_NOMEM,
-        "Could not allocate queue");
+    /* We allow for NULL addr to be passed at creation time, this allows
+     * for pool of handles to be created and later re-used after a call to
+     * HG_Core_reset() */
+    if (hg_core_addr && (hg_core_handle->core_handle.info.addr !=
+                            (hg_core_addr_t) hg_core_addr)) {
+        if (hg_core_handle->core_handle.info.addr != HG_CORE_ADDR_NULL) {
+            ret = hg_core_addr_free((struct hg_core_private_addr *)
+                                        hg_core_handle->core_handle.info.addr);
+            HG_CHECK_HG_ERROR(done, ret, "Could not free address");
+        }
+        hg_core_handle->core_handle.info.addr = (hg_core_addr_t) hg_core_addr;
+        hg_atomic_incr32_relaxed(&hg_core_addr->ref_count);
 
-    HG_QUEUE_INIT(&context->backfill_queue);
-    hg_atomic_init32(&context->backfill_queue_count, 0);
-    HG_LIST_INIT(&context->pending_list);
-#ifdef NA_HAS_SM
-    HG_LIST_INIT(&context->sm_pending_list);
-#endif
-    HG_LIST_INIT(&context->created_list);
+        /* Set NA addr to use */
+        hg_core_handle->na_addr = na_addr;
 
-    /* No handle created yet */
-    hg_atomic_init32(&context->n_handles, 0);
+        /* Set forward call depending on address self */
+        hg_core_handle->is_self =
+            HG_CORE_HANDLE_CLASS(hg_core_handle)->loopback &&
+            hg_core_addr->core_addr.is_self;
 
-    /* Notifications of completion queue events */
-    hg_atomic_init32(&context->completion_queue_must_notify, 0);
-    hg_thread_mutex_init(&context->completion_queue_notify_mutex);
+        hg_core_handle->forward =
+            hg_core_handle->is_self ? hg_core_forward_self : hg_core_forward_na;
+    }
 
-    /* Initialize completion queue mutex/cond */
-    hg_thread_mutex_init(&context->completion_queue_mutex);
-    hg_thread_cond_init(&context->completion_queue_cond);
+    /* We also allow for NULL RPC id to be passed (same reason as above) */
+    if (id && hg_core_handle->core_handle.info.id != id) {
+        struct hg_core_rpc_info *hg_core_rpc_info;
 
-    hg_thread_spin_init(&context->pending_list_lock);
-    hg_thread_spin_init(&context->created_list_lock);
+        /* Retrieve ID function from function map */
+        hg_core_rpc_info =
+            hg_core_func_map_lookup(HG_CORE_HANDLE_CLASS(hg_core_handle), id);
+        if (!hg_core_rpc_info)
+            HG_GOTO_DONE(done, ret, HG_NOENTRY);
 
-    /* Create NA context */
-    context->core_context.na_context =
-        NA_Context_create_id(hg_core_class->na_class, id);
-    HG_CHECK_ERROR(context->core_context.na_context == NULL, error, ret,
-        HG_NOMEM, "Could not create NA context");
+        hg_core_handle->core_handle.info.id = id;
 
-#ifdef NA_HAS_SM
-    if (hg_core_class->na_sm_class) {
-        context->core_context.na_sm_context =
-            NA_Context_create(hg_core_class->na_sm_class);
-        HG_CHECK_ERROR(context->core_context.na_sm_context == NULL, error, ret,
-            HG_NOMEM, "Could not create NA SM context");
+        /* Cache RPC info */
+        hg_core_handle->core_handle.rpc_info = hg_core_rpc_info;
     }
-#endif
-
-    /* If NA plugin exposes fd, we will use poll set and use appropriate
-     * progress function */
-    na_poll_fd = NA_Poll_get_fd(
-        hg_core_class->na_class, context->core_context.na_context);
 
-    if (!(HG_CORE_CONTEXT_CLASS(context)->progress_mode & NA_NO_BLOCK) &&
-        (na_poll_fd > 0)) {
-        struct hg_poll_event event = {.events = HG_POLLIN, .data.u64 = 0};
-        int rc;
+    /* Header size of compact requests depends on the RPC ID or on its index
+     * if it was previously learned from the target */
+    hg_core_handle->in_header.index =
+        (HG_CORE_HANDLE_CLASS(hg_core_handle)->compact_header &&
+            hg_core_handle->core_handle.info.addr &&
+            hg_core_handle->core_handle.rpc_info)
+            ? hg_core_addr_rpc_index_get(
+                  (struct hg_core_private_addr *)
+                      hg_core_handle->core_handle.info.addr,
+                  hg_core_handle->core_handle.info.id)
+            : 0;
+    hg_core_handle->out_header.index = 0;
+    hg_core_set_header_size(
+        hg_core_handle, HG_CORE_HANDLE_CLASS(hg_core_handle)->compact_header);
+
+    /* Reserve room for the trace context of instrumentation hooks, which can
+     * only be carried by compact headers */
+    if (hg_core_handle->in_header.compact &&
+        HG_CORE_HANDLE_CLASS(hg_core_handle)->hooks.trace_ctx_size) {
+        hg_core_handle->in_header.trace_ctx_size =
+            HG_CORE_HANDLE_CLASS(hg_core_handle)->hooks.trace_ctx_size;
+        hg_core_handle->core_handle.in_header_size +=
+            hg_core_header_request_get_ext_size(
+                hg_core_handle->in_header.trace_ctx_size);
+    } else
+        hg_core_handle->in_header.trace_ctx_size = 0;
 
-        /* Create poll set */
-        context->poll_set = hg_poll_create();
-        HG_CHECK_ERROR(context->poll_set == NULL, error, ret, HG_NOMEM,
-            "Could not create poll set");
+done:
+    return ret;
+}
 
-        event.data.u32 = (hg_util_uint32_t) HG_CORE_POLL_NA;
-        rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
-        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-            "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_post(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_post_pool *hg_core_post_pool =
+        hg_core_context_post_pool(context, hg_core_handle->na_class);
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
 
+    /* Handles stay on the pending list while they are reposted so that only
+     * their first post takes the lock */
+    if (!hg_core_handle->listed) {
+        hg_thread_spin_lock(&context->pending_list_lock);
 #ifdef NA_HAS_SM
-        if (context->core_context.na_sm_context) {
-            na_poll_fd = NA_Poll_get_fd(hg_core_class->na_sm_class,
-                context->core_context.na_sm_context);
-            HG_CHECK_ERROR(na_poll_fd < 0, error, ret, HG_PROTOCOL_ERROR,
-                "Could not get NA SM poll fd");
-
-            event.data.u32 = (hg_util_uint32_t) HG_CORE_POLL_SM;
-            rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
-            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-                "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
-        }
+        if (hg_core_handle->na_class ==
+            hg_core_handle->core_handle.info.core_class->na_sm_class)
+            HG_LIST_INSERT_HEAD(
+                &context->sm_pending_list, hg_core_handle, pending);
+        else
 #endif
-
-        if (HG_CORE_CONTEXT_CLASS(context)->loopback) {
-            /* Create event for completion queue notification */
-            context->completion_queue_notify = hg_event_create();
-            HG_CHECK_ERROR(context->completion_queue_notify < 0, error, ret,
-                HG_NOMEM, "Could not create event");
-
-            /* Add event to context poll set */
-            event.data.u32 = (hg_util_uint32_t) HG_CORE_POLL_LOOPBACK;
-            rc = hg_poll_add(
-                context->poll_set, context->completion_queue_notify, &event);
-            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-                "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
-        }
+            HG_LIST_INSERT_HEAD(
+                &context->pending_list, hg_core_handle, pending);
+        hg_thread_spin_unlock(&context->pending_list_lock);
+        hg_core_handle->listed = HG_TRUE;
     }
+    hg_core_handle->posted = HG_TRUE;
+    hg_atomic_incr32(&hg_core_post_pool->pending_count);
 
-    /* Assign context ID */
-    context->core_context.id = id;
-
-    /* Create pool of bulk op IDs */
-    ret = hg_bulk_op_pool_create((hg_core_context_t *) context,
-        HG_CORE_BULK_OP_INIT_COUNT, &context->hg_bulk_op_pool);
-    HG_CHECK_HG_ERROR(error, ret, "Could not create bulk op pool");
+    /* Post a new unexpected receive */
+    hg_atomic_incr32(&hg_core_handle->na_op_pending_count);
+    na_ret = NA_Msg_recv_unexpected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_recv_input_cb, hg_core_handle,
+        hg_core_handle->core_handle.in_buf,
+        hg_core_handle->core_handle.in_buf_size,
+        hg_core_handle->in_buf_plugin_data, hg_core_handle->na_recv_op_id);
+    if (na_ret != NA_SUCCESS)
+        hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+        "Could not post unexpected recv for input buffer (%s)",
+        NA_Error_to_string(na_ret));
 
-    /* Increment context count of parent class */
-    hg_atomic_incr32(&HG_CORE_CONTEXT_CLASS(context)->n_contexts);
+    hg_core_trace(hg_core_handle, HG_TRACE_POST, 0);
 
-    *context_ptr = context;
+    HG_LOG_DEBUG("Posted handle (%p)", hg_core_handle);
 
     return ret;
 
 error:
-    hg_core_context_destroy(context);
+    hg_core_handle->posted = HG_FALSE;
+    hg_core_post_pool_remove(hg_core_post_pool);
+    hg_core_post_unlist(hg_core_handle);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_context_destroy(struct hg_core_private_context *context)
+hg_core_forward(struct hg_core_private_handle *hg_core_handle,
+    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size,
+    unsigned int timeout, unsigned int delay)
 {
-    hg_util_int32_t n_handles;
-    hg_bool_t empty;
+    hg_util_int32_t status;
+    hg_size_t header_size;
     hg_return_t ret = HG_SUCCESS;
-    int rc;
 
-    if (!context)
-        goto done;
+    /* Make sure any internal cancelation has been processed on this handle
+     * before re-using it */
+    status = hg_atomic_get32(&hg_core_handle->status);
+    while ((status & HG_CORE_OP_CANCELED) && !(status & HG_CORE_OP_COMPLETED)) {
+        int cb_ret[HG_CORE_MAX_TRIGGER_COUNT] = {0};
+        unsigned int trigger_count = 0;
+        na_return_t na_ret;
 
-    /* Unpost requests */
-    ret = hg_core_context_unpost(context);
-    HG_CHECK_HG_ERROR(done, ret, "Could not unpost requests");
+        na_ret = NA_Trigger(hg_core_handle->na_context, 0,
+            HG_CORE_MAX_TRIGGER_COUNT, cb_ret, &trigger_count);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT, done, ret,
+            (hg_return_t) na_ret, "Could not trigger NA callback (%s)",
+            NA_Error_to_string(na_ret));
 
-    /* Number of handles for that context should be 0 */
-    n_handles = hg_atomic_get32(&context->n_handles);
-    if (n_handles != 0) {
-#ifdef HG_HAS_DEBUG
-        struct hg_core_private_handle *hg_core_handle = NULL;
-#endif
-        HG_LOG_ERROR("HG core handles must be freed before destroying context "
-                     "(%d remaining)",
-            n_handles);
-#ifdef HG_HAS_DEBUG
-        hg_thread_spin_lock(&context->created_list_lock);
-        HG_LIST_FOREACH (hg_core_handle, &context->created_list, created)
-            HG_LOG_DEBUG("Handle (%p) was not destroyed", hg_core_handle);
-        hg_thread_spin_unlock(&context->created_list_lock);
-#endif
-        ret = HG_BUSY;
-        goto done;
+        status = hg_atomic_get32(&hg_core_handle->status);
+    }
+    HG_CHECK_ERROR(
+        !(status & HG_CORE_OP_COMPLETED) || (status & HG_CORE_OP_QUEUED), done,
+        ret, HG_BUSY, "Attempting to use handle that was not completed");
+
+    /* Increment ref_count on handle to allow for destroy to be pre-emptively
+     * called */
+    hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
+
+    /* Reset op counts */
+    hg_core_handle->na_op_count = 1; /* Default (no response) */
+    hg_atomic_set32(&hg_core_handle->na_op_completed_count, 0);
+
+    /* Reset status */
+    hg_atomic_set32(&hg_core_handle->status, 0);
+
+    /* Index forward so that it can be canceled along with others to the same
+     * target */
+    if (!hg_core_handle->is_self)
+        hg_core_forward_list_add(hg_core_handle);
+
+    /* A late response to a failed persistent forward may still carry its tag,
+     * get a new one */
+    if (hg_core_handle->ret != HG_SUCCESS)
+        hg_core_handle->tag_reserved = HG_FALSE;
+
+    /* Reset handle ret */
+    hg_core_handle->ret = HG_SUCCESS;
+
+    /* Local forwards cannot be canceled so they cannot time out either */
+    hg_core_handle->timed = (timeout > 0 && !hg_core_handle->is_self);
+    hg_core_handle->timed_out = HG_FALSE;
+    hg_core_handle->delayed = (delay > 0 && !hg_core_handle->is_self);
+    if (hg_core_handle->timed || hg_core_handle->delayed) {
+        HG_CHECK_ERROR(hg_core_ext_get(hg_core_handle) == NULL, error, ret,
+            HG_NOMEM, "Could not allocate handle ext");
+    }
+
+    /* Let the forward hook fill the trace context that is sent along */
+    if (hg_core_handle->in_header.trace_ctx_size) {
+        struct hg_core_handle_ext *ext = hg_core_ext_get(hg_core_handle);
+
+        HG_CHECK_ERROR(ext == NULL, error, ret, HG_NOMEM,
+            "Could not allocate handle ext");
+        hg_core_handle->in_header.trace_ctx = ext->trace_ctx;
+        memset(ext->trace_ctx, 0, hg_core_handle->in_header.trace_ctx_size);
     }
+    hg_core_hook(hg_core_handle, HG_HOOK_FORWARD, payload_size, HG_SUCCESS);
 
-    /* Check that atomic completion queue is empty now */
-    HG_CHECK_ERROR(!hg_atomic_queue_is_empty(context->completion_queue), done,
-        ret, HG_BUSY, "Completion queue should be empty");
-    hg_atomic_queue_free(context->completion_queue);
+    /* Set header size */
+    header_size = hg_core_handle->core_handle.in_header_size +
+                  hg_core_handle->core_handle.na_in_header_offset;
 
-    /* Check that backfill completion queue is empty now */
-    hg_thread_mutex_lock(&context->completion_queue_mutex);
-    empty = HG_QUEUE_IS_EMPTY(&context->backfill_queue);
-    hg_thread_mutex_unlock(&context->completion_queue_mutex);
+    /* Set the actual size of the msg that needs to be transmitted */
+    hg_core_handle->in_buf_used = header_size + payload_size;
     HG_CHECK_ERROR(
-        !empty, done, ret, HG_BUSY, "Completion queue should be empty");
+        hg_core_handle->in_buf_used > hg_core_handle->core_handle.in_buf_size,
+        error, ret, HG_MSGSIZE, "Exceeding input buffer size");
 
-    /* Destroy pool of bulk op IDs */
-    if (context->hg_bulk_op_pool) {
-        ret = hg_bulk_op_pool_destroy(context->hg_bulk_op_pool);
-        HG_CHECK_HG_ERROR(done, ret, "Could not destroy bulk op pool");
-    }
+    /* Parse flags */
+    if (flags & HG_CORE_NO_RESPONSE)
+        hg_core_handle->no_response = HG_TRUE;
+    if (hg_core_handle->is_self)
+        flags |= HG_CORE_SELF_FORWARD;
+    flags |= HG_CORE_BYTE_ORDER;
 
-    /* Stop listening for events */
-    if (context->completion_queue_notify > 0) {
-        rc =
-            hg_poll_remove(context->poll_set, context->completion_queue_notify);
-        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
-            "Could not remove self processing event from poll set");
+    /* Set callback, keep request and response callbacks separate so that
+     * they do not get overwritten when forwarding to ourself */
+    hg_core_handle->request_callback = callback;
+    hg_core_handle->request_arg = arg;
 
-        rc = hg_event_destroy(context->completion_queue_notify);
-        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
-            "Could not destroy self processing event");
+    /* Persistent forwards only encode their header again if flags changed or
+     * if it carries a trace context */
+    if (!hg_core_handle->header_encoded ||
+        hg_core_handle->header_flags != flags ||
+        hg_core_handle->in_header.trace_ctx_size) {
+        /* Set header */
+        hg_core_handle->in_header.msg.request.id =
+            hg_core_handle->core_handle.info.id;
+        hg_core_handle->in_header.msg.request.flags = flags;
+        /* Set the cookie as origin context ID, so that when the cookie is
+         * unpacked by the target and assigned to HG info context_id, the NA
+         * layer knows which context ID it needs to send the response to. */
+        hg_core_handle->in_header.msg.request.cookie =
+            hg_core_handle->core_handle.info.context->id;
+
+        /* Encode request header */
+        ret = hg_core_proc_header_request(&hg_core_handle->core_handle,
+            &hg_core_handle->in_header, HG_ENCODE);
+        HG_CHECK_HG_ERROR(error, ret, "Could not encode header");
+
+        hg_core_handle->header_encoded = hg_core_handle->persistent;
+        hg_core_handle->header_flags = flags;
     }
 
-    if (context->poll_set) {
-        /* If NA plugin exposes fd, remove it from poll set */
-        int na_poll_fd =
-            NA_Poll_get_fd(context->core_context.core_class->na_class,
-                context->core_context.na_context);
-        if (na_poll_fd > 0) {
-            rc = hg_poll_remove(context->poll_set, na_poll_fd);
-            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
-                "Could not remove NA poll descriptor from poll set");
-        }
+    hg_core_handle->stamped = 0;
+    hg_core_stamp(hg_core_handle, HG_CORE_STAMP_FORWARD);
+    hg_core_trace(
+        hg_core_handle, HG_TRACE_FORWARD, hg_core_handle->in_buf_used);
+    hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+        hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_FORWARD, 1);
+    hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+        hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_BYTES_OUT,
+        hg_core_handle->in_buf_used);
+    if (flags & HG_CORE_MORE_DATA)
+        hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+            hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_EXTRA, 1);
+
+    /* Delayed forwards are sent by progress once their delay expires, they
+     * take a credit at that point */
+    if (hg_core_handle->delayed) {
+        hg_core_timer_arm(hg_core_handle, delay);
+        goto done;
     }
 
-#ifdef NA_HAS_SM
-    if (context->core_context.na_sm_context && context->poll_set) {
-        /* If NA plugin exposes fd, remove it from poll set */
-        int na_poll_fd =
-            NA_Poll_get_fd(context->core_context.core_class->na_sm_class,
-                context->core_context.na_sm_context);
-        if (na_poll_fd > 0) {
-            rc = hg_poll_remove(context->poll_set, na_poll_fd);
-            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOENTRY,
-                "Could not remove NA poll descriptor from poll set");
-        }
+    /* If addr is self, forward locally, otherwise send the encoded buffer
+     * through NA and pre-post response. Forwards that exceed the credits of
+     * the target are sent once earlier requests complete. */
+    if (HG_CORE_HANDLE_CLASS(hg_core_handle)->request_credits == 0 ||
+        hg_core_handle->is_self || hg_core_credit_acquire(hg_core_handle)) {
+        ret = hg_core_handle->forward(hg_core_handle);
+        HG_CHECK_HG_ERROR(error, ret, "Could not forward buffer");
     }
-#endif
 
-    /* Destroy poll set */
-    if (context->poll_set) {
-        rc = hg_poll_destroy(context->poll_set);
-        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_FAULT,
-            "Could not destroy poll set");
-    }
+    /* Arm deadline once operations are posted so that expiring it cancels
+     * them */
+    if (hg_core_handle->timed)
+        hg_core_timer_arm(hg_core_handle, timeout);
 
-    /* Destroy NA context */
-    if (context->core_context.na_context) {
-        na_return_t na_ret =
-            NA_Context_destroy(context->core_context.core_class->na_class,
-                context->core_context.na_context);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not destroy NA context (%s)", NA_Error_to_string(na_ret));
-    }
+done:
+    return ret;
 
-#ifdef NA_HAS_SM
-    /* Destroy NA SM context */
-    if (context->core_context.na_sm_context) {
-        na_return_t na_ret =
-            NA_Context_destroy(context->core_context.core_class->na_sm_class,
-                context->core_context.na_sm_context);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not destroy NA SM context");
+error:
+    if (hg_core_handle->credit_held)
+        hg_core_credit_release(hg_core_handle);
+    if (hg_core_handle->forward_listed)
+        hg_core_forward_list_remove(hg_core_handle);
+    hg_core_handle->tag_batched = HG_FALSE;
+
+    /* Handle is no longer in use (ignore if still processing cancelation) */
+    if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED)) {
+        hg_atomic_set32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+
+        /* Rollback ref_count taken above */
+        hg_atomic_decr32(&hg_core_handle->ref_count);
     }
-#endif
 
-    /* Free user data */
-    if (context->core_context.data_free_callback)
-        context->core_context.data_free_callback(context->core_context.data);
+    return ret;
+}
 
-    /* Destroy completion queue mutex/cond */
-    hg_thread_mutex_destroy(&context->completion_queue_notify_mutex);
-    hg_thread_mutex_destroy(&context->completion_queue_mutex);
-    hg_thread_cond_destroy(&context->completion_queue_cond);
-    hg_thread_spin_destroy(&context->pending_list_lock);
-    hg_thread_spin_destroy(&context->created_list_lock);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_forward_delayed(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_return_t ret = HG_SUCCESS;
 
-    /* Decrement context count of parent class */
-    hg_atomic_decr32(&HG_CORE_CONTEXT_CLASS(context)->n_contexts);
+    /* Nothing is posted if handle was canceled while being dequeued */
+    if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED) &&
+        (HG_CORE_HANDLE_CLASS(hg_core_handle)->request_credits == 0 ||
+            hg_core_credit_acquire(hg_core_handle))) {
+        ret = hg_core_handle->forward(hg_core_handle);
+        if (ret == HG_SUCCESS)
+            return;
+        HG_LOG_ERROR("Could not forward buffer (ret=%d)", ret);
+    } else if (hg_core_handle->credit_queued)
+        return;
+
+    /* Report error or cancelation through the callback of the forward */
+    hg_core_handle->ret = ret;
+    hg_core_handle->op_type = HG_CORE_FORWARD;
+    ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete handle");
+}
 
-    free(context);
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_forward_self(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+
+    /* Post operation to self processing pool */
+    ret = hg_core_process_self(hg_core_handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not self process handle");
 
 done:
     return ret;
@@ -1319,727 +6367,1153 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_context_post(struct hg_core_private_context *context,
-    na_class_t *na_class, na_context_t *na_context, unsigned int request_count)
+hg_core_forward_na(struct hg_core_private_handle *hg_core_handle)
 {
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_HANDLE_CLASS(hg_core_handle);
     hg_return_t ret = HG_SUCCESS;
-    unsigned int nentry = 0;
+    na_return_t na_ret;
 
-    /* Create a bunch of handles and post unexpected receives */
-    for (nentry = 0; nentry < request_count; nentry++) {
-        struct hg_core_private_handle *hg_core_handle = NULL;
-        struct hg_core_private_addr *hg_core_addr = NULL;
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_FORWARD;
+#ifdef NA_HAS_SM
+    hg_core_poll_sm_wake(
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle), hg_core_handle->na_class);
+#endif
 
-        /* Create new handle */
-        ret = hg_core_create(context, na_class, na_context, &hg_core_handle);
-        HG_CHECK_HG_ERROR(error, ret, "Could not create HG core handle");
+    /* Steer request to a target shard if none was explicitly set */
+    if (hg_core_class->shard_count > 1 &&
+        hg_core_handle->core_handle.info.context_id == 0)
+        hg_core_handle->core_handle.info.context_id = hg_core_shard_id(
+            hg_core_handle->core_handle.info.id,
+            hg_core_handle->core_handle.shard_key,
+            hg_core_class->shard_count);
+
+    /* Generate tag, persistent forwards keep theirs and batched forwards
+     * were given one along with the rest of their batch */
+    if (hg_core_handle->tag_batched) {
+        hg_core_handle->tag_batched = HG_FALSE;
+        hg_core_handle->tag_reserved = hg_core_handle->persistent;
+    } else if (!hg_core_handle->tag_reserved) {
+        hg_core_handle->tag =
+            hg_core_gen_request_tag(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
+        hg_core_handle->tag_reserved = hg_core_handle->persistent;
+    }
+    HG_PROBE4(mercury, forward, hg_core_handle,
+        hg_core_handle->core_handle.info.id, hg_core_handle->tag,
+        hg_core_handle->in_buf_used);
 
-        /* Reset status */
-        hg_atomic_set32(&hg_core_handle->status, 0);
+    /* Pre-post recv (output) if response is expected */
+    if (!hg_core_handle->no_response) {
+        hg_atomic_incr32(&hg_core_handle->na_op_pending_count);
+        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_recv_output_cb, hg_core_handle,
+            hg_core_handle->core_handle.out_buf,
+            hg_core_handle->core_handle.out_buf_size,
+            hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
+            hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+            hg_core_handle->na_recv_op_id);
+        if (na_ret != NA_SUCCESS)
+            hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+            "Could not post recv for output buffer (%s)",
+            NA_Error_to_string(na_ret));
 
-        /* Create new (empty) source addresses */
-        hg_core_addr = hg_core_addr_create(HG_CORE_CONTEXT_CLASS(context));
-        HG_CHECK_ERROR(hg_core_addr == NULL, error, ret, HG_NOMEM,
-            "Could not create HG addr");
-        hg_core_handle->core_handle.info.addr = (hg_core_addr_t) hg_core_addr;
+        /* Increment number of expected NA operations */
+        hg_core_handle->na_op_count++;
+    }
 
-        /* Repost handle on completion */
-        hg_core_handle->repost = HG_TRUE;
+    /* Mark handle as posted */
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_POSTED);
 
-        /* Post handle */
-        ret = hg_core_post(hg_core_handle);
-        HG_CHECK_HG_ERROR(error, ret, "Cannot post handle");
+    /* Small requests may be sent together with other requests to the same
+     * target, requests that require an extra bulk transfer are not */
+    if (hg_core_class->request_coalesce_count > 1 &&
+        !(hg_core_handle->in_header.msg.request.flags & HG_CORE_MORE_DATA) &&
+        hg_core_handle->in_buf_used + hg_core_header_coalesce_get_size() +
+                hg_core_header_request_get_size() <=
+            hg_core_handle->core_handle.in_buf_size) {
+        ret = hg_core_coalesce_add(hg_core_handle, HG_FALSE);
+        HG_CHECK_HG_ERROR(cancel, ret, "Could not coalesce request");
+        goto done;
     }
 
+    /* Post send (input) */
+    hg_atomic_incr32(&hg_core_handle->na_op_pending_count);
+    na_ret = NA_Msg_send_unexpected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_send_input_cb, hg_core_handle,
+        hg_core_handle->core_handle.in_buf, hg_core_handle->in_buf_used,
+        hg_core_handle->in_buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        hg_core_handle->na_send_op_id);
+    if (na_ret != NA_SUCCESS)
+        hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, cancel, ret, (hg_return_t) na_ret,
+        "Could not post send for input buffer (%s)",
+        NA_Error_to_string(na_ret));
+
+done:
     return ret;
 
-error:
-    hg_core_context_unpost(context);
+cancel:
+    if (!hg_core_handle->no_response)
+        hg_core_handle->na_op_count--;
+
+    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_POSTED);
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+
+    /* Cancel the above posted recv op */
+    na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
+        hg_core_handle->na_recv_op_id);
+    HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
+        "Could not cancel recv op id (%s)", NA_Error_to_string(na_ret));
 
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_op_batch_begin(struct hg_core_private_context *context)
+{
+    struct hg_core_context *core_context = &context->core_context;
+    unsigned int i;
+
+    (void) NA_Op_batch_begin(
+        core_context->core_class->na_class, core_context->na_context);
+#ifdef NA_HAS_SM
+    if (core_context->core_class->na_sm_class)
+        (void) NA_Op_batch_begin(
+            core_context->core_class->na_sm_class, core_context->na_sm_context);
+#endif
+    for (i = 0; i < core_context->core_class->na_rail_count; i++)
+        (void) NA_Op_batch_begin(core_context->core_class->na_rail_classes[i],
+            core_context->na_rail_contexts[i]);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_op_batch_end(struct hg_core_private_context *context)
+{
+    struct hg_core_context *core_context = &context->core_context;
+    na_return_t na_ret;
+    unsigned int i;
+
+    /* Errors of held operations are reported through their callbacks */
+    na_ret = NA_Op_batch_end(
+        core_context->core_class->na_class, core_context->na_context);
+    HG_CHECK_WARNING(na_ret != NA_SUCCESS, "Could not end batch (%s)",
+        NA_Error_to_string(na_ret));
+#ifdef NA_HAS_SM
+    if (core_context->core_class->na_sm_class) {
+        na_ret = NA_Op_batch_end(
+            core_context->core_class->na_sm_class, core_context->na_sm_context);
+        HG_CHECK_WARNING(na_ret != NA_SUCCESS, "Could not end SM batch (%s)",
+            NA_Error_to_string(na_ret));
+    }
+#endif
+    for (i = 0; i < core_context->core_class->na_rail_count; i++) {
+        na_ret = NA_Op_batch_end(core_context->core_class->na_rail_classes[i],
+            core_context->na_rail_contexts[i]);
+        HG_CHECK_WARNING(na_ret != NA_SUCCESS, "Could not end rail batch (%s)",
+            NA_Error_to_string(na_ret));
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_context_unpost(struct hg_core_private_context *context)
+hg_core_respond(struct hg_core_private_handle *hg_core_handle,
+    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size,
+    hg_return_t ret_code)
 {
-    struct hg_core_private_handle *hg_core_handle;
-    unsigned int actual_count;
+    hg_size_t header_size;
     hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
 
-    /* Prevent repost of handles */
-    context->finalizing = HG_TRUE;
+    /* Cannot respond if no_response flag set */
+    HG_CHECK_ERROR(hg_core_handle->no_response, done, ret, HG_OPNOTSUPPORTED,
+        "Sending response was disabled on that RPC");
 
-    /* Check pending list and cancel posted handles */
-    hg_thread_spin_lock(&context->pending_list_lock);
-    HG_LIST_FOREACH (hg_core_handle, &context->pending_list, pending) {
-        /* Prevent reposts */
-        hg_core_handle->repost = HG_FALSE;
+    /* Reset status */
+    hg_atomic_set32(&hg_core_handle->status, 0);
 
-        /* Cancel handle */
-        ret = hg_core_cancel(hg_core_handle);
-        HG_CHECK_HG_ERROR(error, ret, "Could not cancel handle");
-    }
+    /* Reset handle ret */
+    hg_core_handle->ret = HG_SUCCESS;
 
-#ifdef NA_HAS_SM
-    HG_LIST_FOREACH (hg_core_handle, &context->sm_pending_list, pending) {
-        /* Prevent reposts */
-        hg_core_handle->repost = HG_FALSE;
+    /* Set header size */
+    header_size = hg_core_handle->core_handle.out_header_size +
+                  hg_core_handle->core_handle.na_out_header_offset;
+
+    /* Set the actual size of the msg that needs to be transmitted */
+    hg_core_handle->out_buf_used = header_size + payload_size;
+    HG_CHECK_ERROR(
+        hg_core_handle->out_buf_used > hg_core_handle->core_handle.out_buf_size,
+        error, ret, HG_MSGSIZE, "Exceeding output buffer size");
+
+    /* Set callback, keep request and response callbacks separate so that
+     * they do not get overwritten when forwarding to ourself */
+    hg_core_handle->response_callback = callback;
+    hg_core_handle->response_arg = arg;
 
-        /* Cancel handle */
-        ret = hg_core_cancel(hg_core_handle);
-        HG_CHECK_HG_ERROR(error, ret, "Could not cancel handle");
-    }
-#endif
-    hg_thread_spin_unlock(&context->pending_list_lock);
+    /* Set header */
+    hg_core_handle->out_header.msg.response.ret_code = ret_code;
+    hg_core_handle->out_header.msg.response.flags =
+        (hg_uint8_t)(flags | HG_CORE_BYTE_ORDER);
+    hg_core_handle->out_header.msg.response.cookie = hg_core_handle->cookie;
+    hg_core_handle->out_header.msg.response.credits =
+        (HG_CORE_HANDLE_CLASS(hg_core_handle)->request_credits > 0)
+            ? hg_core_credit_advertise(hg_core_handle)
+            : 0;
+    hg_core_handle->out_header.msg.response.load =
+        (HG_CORE_HANDLE_CLASS(hg_core_handle)->load_feedback)
+            ? hg_core_load_advertise(hg_core_handle)
+            : 0;
 
-    /* Trigger everything we can from NA, if something completed it will
-     * be moved to the HG context completion queue */
-    do {
-        na_ret = NA_Trigger(
-            context->core_context.na_context, 0, 1, NULL, &actual_count);
-    } while ((na_ret == NA_SUCCESS) && actual_count);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT, done, ret,
-        (hg_return_t) na_ret, "Could not trigger NA callback (%s)",
-        NA_Error_to_string(na_ret));
+    /* Encode response header */
+    ret = hg_core_proc_header_response(
+        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_ENCODE);
+    HG_CHECK_HG_ERROR(error, ret, "Could not encode header");
 
-#ifdef NA_HAS_SM
-    if (context->core_context.na_sm_context) {
-        do {
-            na_ret = NA_Trigger(
-                context->core_context.na_sm_context, 0, 1, NULL, &actual_count);
-        } while ((na_ret == NA_SUCCESS) && actual_count);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT, done, ret,
-            (hg_return_t) na_ret, "Could not trigger NA callback (%s)",
-            NA_Error_to_string(na_ret));
-    }
-#endif
+    hg_core_latency_respond(hg_core_handle);
+    hg_core_trace(
+        hg_core_handle, HG_TRACE_RESPOND, hg_core_handle->out_buf_used);
+    hg_core_hook(hg_core_handle, HG_HOOK_RESPOND, hg_core_handle->out_buf_used,
+        ret_code);
+    hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+        hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_BYTES_OUT,
+        hg_core_handle->out_buf_used);
+    if (flags & HG_CORE_MORE_DATA)
+        hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+            hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_EXTRA, 1);
 
-    /* Check that operations have completed */
-    ret = hg_core_context_lists_wait(context);
-    HG_CHECK_HG_ERROR(done, ret, "Could not wait on HG core handle list");
+    /* If addr is self, forward locally, otherwise send the encoded buffer
+     * through NA and pre-post response */
+    ret = hg_core_handle->respond(hg_core_handle);
+    HG_CHECK_HG_ERROR(error, ret, "Could not respond");
 
 done:
     return ret;
 
 error:
-    hg_thread_spin_unlock(&context->pending_list_lock);
+    /* Handle is no longer in use */
+    if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED))
+        hg_atomic_set32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+
+    /* Decrement refcount on handle */
+    hg_atomic_decr32(&hg_core_handle->ref_count);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_context_check_pending(struct hg_core_private_context *context,
-    na_class_t *na_class, na_context_t *na_context, unsigned int request_count)
+static HG_INLINE hg_return_t
+hg_core_respond_self(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_bool_t pending_empty = HG_FALSE;
     hg_return_t ret = HG_SUCCESS;
 
-    /* Check if we need more handles */
-    hg_thread_spin_lock(&context->pending_list_lock);
-
-#ifdef NA_HAS_SM
-    if (na_class == context->core_context.core_class->na_sm_class) {
-        pending_empty = HG_LIST_IS_EMPTY(&context->sm_pending_list);
-    } else
-#endif
-        pending_empty = HG_LIST_IS_EMPTY(&context->pending_list);
-
-    hg_thread_spin_unlock(&context->pending_list_lock);
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_RESPOND_SELF;
 
-    /* If pending list is empty, post more handles */
-    if (pending_empty) {
-        ret =
-            hg_core_context_post(context, na_class, na_context, request_count);
-        HG_CHECK_HG_ERROR(done, ret, "Could not post additional handles");
-    }
+    /* Complete and add to completion queue */
+    ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not complete handle");
 
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_context_lists_wait(struct hg_core_private_context *context)
+static HG_INLINE hg_return_t
+hg_core_no_respond_self(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_util_bool_t created_list_empty = HG_UTIL_FALSE;
-    hg_util_bool_t pending_list_empty = HG_UTIL_FALSE;
-#ifdef NA_HAS_SM
-    hg_util_bool_t sm_pending_list_empty = HG_UTIL_FALSE;
-#else
-    hg_util_bool_t sm_pending_list_empty = HG_UTIL_TRUE;
-#endif
-    /* Convert timeout in ms into seconds */
-    double remaining = HG_CORE_CLEANUP_TIMEOUT / 1000.0;
     hg_return_t ret = HG_SUCCESS;
 
-    do {
-        unsigned int actual_count = 0;
-        hg_time_t t1, t2;
-        hg_return_t trigger_ret, progress_ret;
-
-        hg_time_get_current_ms(&t1);
-
-        /* Trigger everything we can from HG */
-        do {
-            trigger_ret = hg_core_trigger(context, 0, 1, &actual_count);
-        } while ((trigger_ret == HG_SUCCESS) && actual_count);
-        HG_CHECK_ERROR(trigger_ret != HG_SUCCESS && trigger_ret != HG_TIMEOUT,
-            done, ret, trigger_ret, "Could not trigger entry");
-
-        hg_thread_spin_lock(&context->created_list_lock);
-        created_list_empty = HG_LIST_IS_EMPTY(&context->created_list);
-        hg_thread_spin_unlock(&context->created_list_lock);
-
-        hg_thread_spin_lock(&context->pending_list_lock);
-        pending_list_empty = HG_LIST_IS_EMPTY(&context->pending_list);
-#ifdef NA_HAS_SM
-        sm_pending_list_empty = HG_LIST_IS_EMPTY(&context->sm_pending_list);
-#endif
-        hg_thread_spin_unlock(&context->pending_list_lock);
-
-        if (created_list_empty && pending_list_empty && sm_pending_list_empty)
-            break;
-
-        progress_ret =
-            hg_core_progress(context, (unsigned int) (remaining * 1000.0));
-        HG_CHECK_ERROR(progress_ret != HG_SUCCESS && progress_ret != HG_TIMEOUT,
-            done, ret, progress_ret, "Could not make progress");
-
-        hg_time_get_current_ms(&t2);
-        remaining -= hg_time_diff(t2, t1);
-    } while ((int) (remaining * 1000.0) > 0 || !pending_list_empty ||
-             !sm_pending_list_empty);
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
 
-    HG_LOG_DEBUG("Remaining %lf, Context list status: %d, %d, %d", remaining,
-        created_list_empty, pending_list_empty, sm_pending_list_empty);
+    /* Complete and add to completion queue */
+    ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not complete handle");
 
 done:
     return ret;
 }
 
-/*---------------------------------------------------------------------------*/
-struct hg_bulk_op_pool *
-hg_core_context_get_bulk_op_pool(struct hg_core_context *core_context)
-{
-    return ((struct hg_core_private_context *) core_context)->hg_bulk_op_pool;
-}
-
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_addr_lookup(struct hg_core_private_class *hg_core_class,
-    const char *name, struct hg_core_private_addr **addr)
+hg_core_respond_na(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_addr *hg_core_addr = NULL;
-    na_class_t **na_class_ptr = NULL;
-    na_addr_t *na_addr_ptr = NULL;
-    na_size_t *na_addr_serialize_size_ptr = NULL;
-    na_return_t na_ret;
-#ifdef NA_HAS_SM
-    char lookup_name[HG_CORE_ADDR_MAX_SIZE] = {'\0'};
-#endif
-    const char *name_str = name;
     hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+    hg_bool_t ack_recv_posted = HG_FALSE;
 
-    /* Allocate addr */
-    hg_core_addr = hg_core_addr_create(hg_core_class);
-    HG_CHECK_ERROR(
-        hg_core_addr == NULL, error, ret, HG_NOMEM, "Could not create HG addr");
-
-    /* TODO lookup could also create self addresses */
+    /* Increment number of expected NA operations */
+    hg_core_handle->na_op_count++;
 
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_RESPOND;
 #ifdef NA_HAS_SM
-    /* Parse name string */
-    if (hg_core_class->core_class.na_sm_class &&
-        strstr(name, HG_CORE_ADDR_DELIMITER)) {
-        char *lookup_names, *local_id_str;
-        char *remote_name, *local_name;
-
-        strcpy(lookup_name, name);
+    hg_core_poll_sm_wake(
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle), hg_core_handle->na_class);
+#endif
+    HG_PROBE4(mercury, respond, hg_core_handle,
+        hg_core_handle->core_handle.info.id, hg_core_handle->tag,
+        hg_core_handle->out_buf_used);
 
-        /* Get first part of address string with host ID */
-        strtok_r(lookup_name, HG_CORE_ADDR_DELIMITER, &lookup_names);
+    /* More data on output requires an ack once it is processed */
+    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_MORE_DATA) {
+        ret = hg_core_ack_buf_alloc(hg_core_handle);
+        HG_CHECK_HG_ERROR(error, ret, "Could not allocate ack buffer");
 
-        HG_CHECK_ERROR(strstr(name, HG_CORE_PROTO_DELIMITER) == NULL, error,
-            ret, HG_PROTOCOL_ERROR, "Malformed address format");
+        /* Increment number of expected NA operations */
+        hg_core_handle->na_op_count++;
 
-        /* Get address SM host ID */
-        strtok_r(lookup_name, HG_CORE_PROTO_DELIMITER, &local_id_str);
-        na_ret =
-            NA_SM_String_to_host_id(local_id_str + 2, &hg_core_addr->host_id);
+        /* Pre-post recv (ack) if more data is expected */
+        hg_atomic_incr32(&hg_core_handle->na_op_pending_count);
+        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_recv_ack_cb, hg_core_handle,
+            hg_core_handle->ext->ack_buf, sizeof(hg_uint8_t),
+            hg_core_handle->ext->ack_buf_plugin_data, hg_core_handle->na_addr,
+            hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+            hg_core_handle->ext->na_ack_op_id);
+        if (na_ret != NA_SUCCESS)
+            hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
         HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-            "NA_SM_String_to_host_id() failed (%s)",
+            "Could not post recv for ack buffer (%s)",
             NA_Error_to_string(na_ret));
+        ack_recv_posted = HG_TRUE;
+    }
 
-        /* Separate remaining two parts */
-        strtok_r(lookup_names, HG_CORE_ADDR_DELIMITER, &remote_name);
-        local_name = lookup_names;
+    /* Mark handle as posted */
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_POSTED);
 
-        /* Compare IDs, if they match it's local address */
-        if (NA_SM_Host_id_cmp(hg_core_addr->host_id, hg_core_class->host_id)) {
-            HG_LOG_DEBUG("This is a local address");
-            name_str = local_name;
-            na_class_ptr = &hg_core_addr->core_addr.core_class->na_sm_class;
-            na_addr_ptr = &hg_core_addr->core_addr.na_sm_addr;
-            na_addr_serialize_size_ptr =
-                &hg_core_addr->na_sm_addr_serialize_size;
-        } else {
-            /* Remote lookup */
-            name_str = remote_name;
-            na_class_ptr = &hg_core_addr->core_addr.core_class->na_class;
-            na_addr_ptr = &hg_core_addr->core_addr.na_addr;
-            na_addr_serialize_size_ptr = &hg_core_addr->na_addr_serialize_size;
-        }
-    } else {
-#endif
-        /* Remote lookup */
-        na_class_ptr = &hg_core_addr->core_addr.core_class->na_class;
-        na_addr_ptr = &hg_core_addr->core_addr.na_addr;
-        na_addr_serialize_size_ptr = &hg_core_addr->na_addr_serialize_size;
-#ifdef NA_HAS_SM
+    /* Origin of coalesced requests can also receive aggregated responses */
+    if (hg_core_handle->coalesced && !ack_recv_posted &&
+        hg_core_handle->out_buf_used + 2 * hg_core_header_coalesce_get_size() +
+                hg_core_header_response_get_size() <=
+            hg_core_handle->core_handle.out_buf_size) {
+        ret = hg_core_coalesce_add(hg_core_handle, HG_TRUE);
+        HG_CHECK_HG_ERROR(error, ret, "Could not aggregate response");
+        return ret;
     }
-#endif
 
-    /* Lookup adress */
-    na_ret = NA_Addr_lookup(*na_class_ptr, name_str, na_addr_ptr);
+    /* Post expected send (output) */
+    hg_atomic_incr32(&hg_core_handle->na_op_pending_count);
+    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_send_output_cb, hg_core_handle,
+        hg_core_handle->core_handle.out_buf, hg_core_handle->out_buf_used,
+        hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        hg_core_handle->na_send_op_id);
+    if (na_ret != NA_SUCCESS)
+        hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
+    /* Expected sends should always succeed after retry */
     HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-        "Could not lookup address %s (%s)", name_str,
+        "Could not post send for output buffer (%s)",
         NA_Error_to_string(na_ret));
 
-    /* Cache serialize size */
-    *na_addr_serialize_size_ptr =
-        NA_Addr_get_serialize_size(*na_class_ptr, *na_addr_ptr);
+    return ret;
 
-    *addr = hg_core_addr;
+error:
+    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_POSTED);
+
+    if (ack_recv_posted) {
+        hg_core_handle->na_op_count--;
+
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+
+        /* Cancel the above posted recv ack op */
+        na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
+            hg_core_handle->ext->na_ack_op_id);
+        HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
+            "Could not cancel ack op id (%s)", NA_Error_to_string(na_ret));
+    }
+    na_ret = hg_core_ack_buf_free(hg_core_handle);
+    HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS, "Could not free ack buffer (%s)",
+        NA_Error_to_string(na_ret));
 
     return ret;
+}
 
-error:
-    hg_core_addr_free(hg_core_addr);
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_no_respond_na(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_NO_RESPOND;
+
+    ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not complete operation");
 
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static struct hg_core_private_addr *
-hg_core_addr_create(struct hg_core_private_class *hg_core_class)
+static HG_INLINE int
+hg_core_send_input_cb(const struct na_cb_info *callback_info)
 {
-    struct hg_core_private_addr *hg_core_addr = NULL;
-
-    hg_core_addr = (struct hg_core_private_addr *) malloc(
-        sizeof(struct hg_core_private_addr));
-    HG_CHECK_ERROR_NORET(
-        hg_core_addr == NULL, done, "Could not allocate HG addr");
-
-    memset(hg_core_addr, 0, sizeof(struct hg_core_private_addr));
-    hg_core_addr->core_addr.core_class = (hg_core_class_t *) hg_core_class;
-    hg_core_addr->core_addr.na_addr = NA_ADDR_NULL;
-#ifdef NA_HAS_SM
-    hg_core_addr->core_addr.na_sm_addr = NA_ADDR_NULL;
-#endif
-    hg_core_addr->core_addr.is_self = HG_FALSE;
-    hg_atomic_init32(&hg_core_addr->ref_count, 1);
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
 
-    /* Increment N addrs from HG class */
-    hg_atomic_incr32(&hg_core_class->n_addrs);
+    /* NA operation is no longer in use */
+    hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
 
-done:
-    return hg_core_addr;
+    return hg_core_send_input_complete(hg_core_handle, callback_info->ret);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_free(struct hg_core_private_addr *hg_core_addr)
+static int
+hg_core_send_input_complete(
+    struct hg_core_private_handle *hg_core_handle, na_return_t na_cb_ret)
 {
-    hg_return_t ret = HG_SUCCESS;
+    hg_bool_t completed = HG_TRUE;
+    hg_return_t ret;
 
-    if (!hg_core_addr)
-        goto done;
+    if (na_cb_ret == NA_SUCCESS) {
+        hg_core_stamp(hg_core_handle, HG_CORE_STAMP_SENT);
+        hg_core_trace(
+            hg_core_handle, HG_TRACE_SEND, hg_core_handle->in_buf_used);
+    }
 
-    if (hg_atomic_decr32(&hg_core_addr->ref_count))
-        /* Cannot free yet */
-        goto done;
+    /* If canceled, mark handle as canceled */
+    if (na_cb_ret == NA_CANCELED) {
+        HG_CHECK_WARNING(
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
+        HG_CHECK_WARNING(
+            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
+            "Received NA_CANCELED event on handle that was not canceled");
+    } else if (na_cb_ret != NA_SUCCESS) {
+        hg_util_int32_t status;
 
-    /* Decrement N addrs from HG class */
-    hg_atomic_decr32(&HG_CORE_ADDR_CLASS(hg_core_addr)->n_addrs);
+        HG_LOG_ERROR(
+            "NA callback returned error (%s)", NA_Error_to_string(na_cb_ret));
 
-    /* Free NA addresses */
-    ret = hg_core_addr_free_na(hg_core_addr);
-    HG_CHECK_HG_ERROR(done, ret, "Could not free NA addresses");
+        /* Mark handle as errored */
+        status = hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
 
-    free(hg_core_addr);
+        if (!(status & HG_CORE_OP_CANCELED) && !hg_core_handle->no_response) {
+            na_return_t na_ret;
+
+            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+
+            /* Cancel posted recv for response */
+            na_ret = NA_Cancel(hg_core_handle->na_class,
+                hg_core_handle->na_context, hg_core_handle->na_recv_op_id);
+            HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret,
+                (hg_return_t) na_ret, "Could not cancel recv op id (%s)",
+                NA_Error_to_string(na_ret));
+        }
+    }
 
 done:
-    return ret;
+    ret = hg_core_complete_na(hg_core_handle, &completed);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+
+    return (int) completed;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_addr_free_na(struct hg_core_private_addr *hg_core_addr)
+hg_core_coalesce_add(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t response)
 {
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_coalesce_list *list = (response)
+                                             ? &context->coalesce_response_list
+                                             : &context->coalesce_list;
+    struct hg_core_coalesce_batch *hg_core_batch = NULL,
+                                  *hg_core_full_batch = NULL;
+    struct hg_core_header_coalesce header;
+    na_size_t size, reserved_size;
+    void *buf;
+    hg_bool_t new_batch = HG_FALSE;
     hg_return_t ret = HG_SUCCESS;
 
-    /* Free NA address */
-    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
-        na_return_t na_ret =
-            NA_Addr_free(hg_core_addr->core_addr.core_class->na_class,
-                hg_core_addr->core_addr.na_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not free NA address (%s)", NA_Error_to_string(na_ret));
-        hg_core_addr->core_addr.na_addr = NA_ADDR_NULL;
-        hg_core_addr->na_addr_serialize_size = 0;
+    /* Each entry is prefixed with a coalesce header, responses are also
+     * terminated by an empty one as expected recvs do not report their size */
+    if (response) {
+        buf = (char *) hg_core_handle->core_handle.out_buf +
+              hg_core_handle->core_handle.na_out_header_offset;
+        size = hg_core_handle->out_buf_used -
+               hg_core_handle->core_handle.na_out_header_offset;
+        reserved_size = 2 * hg_core_header_coalesce_get_size();
+    } else {
+        buf = (char *) hg_core_handle->core_handle.in_buf +
+              hg_core_handle->core_handle.na_in_header_offset;
+        size = hg_core_handle->in_buf_used -
+               hg_core_handle->core_handle.na_in_header_offset;
+        reserved_size = hg_core_header_coalesce_get_size();
     }
 
-#ifdef NA_HAS_SM
-    /* Free NA SM address */
-    if (hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
-        na_return_t na_ret =
-            NA_Addr_free(hg_core_addr->core_addr.core_class->na_sm_class,
-                hg_core_addr->core_addr.na_sm_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not free NA SM address (%s)", NA_Error_to_string(na_ret));
-        hg_core_addr->core_addr.na_sm_addr = NA_ADDR_NULL;
-        hg_core_addr->na_sm_addr_serialize_size = 0;
+    hg_thread_mutex_lock(&context->coalesce_mutex);
+
+    /* Look for a batch to the same target, target handles that process
+     * coalesced requests each have their own copy of the source address */
+    HG_LIST_FOREACH (hg_core_batch, list, entry) {
+        if (hg_core_batch->na_class == hg_core_handle->na_class &&
+            hg_core_batch->context_id ==
+                hg_core_handle->core_handle.info.context_id &&
+            (response ? NA_Addr_cmp(hg_core_batch->na_class,
+                            hg_core_batch->na_addr, hg_core_handle->na_addr)
+                      : hg_core_batch->addr ==
+                            (struct hg_core_private_addr *)
+                                hg_core_handle->core_handle.info.addr))
+            break;
     }
-#endif
 
-done:
-    return ret;
-}
+    /* Batch cannot hold that entry, send it as is */
+    if (hg_core_batch &&
+        hg_core_batch->buf_used + reserved_size + size >
+            hg_core_batch->buf_size) {
+        HG_LIST_REMOVE(hg_core_batch, entry);
+        hg_core_full_batch = hg_core_batch;
+        hg_core_batch = NULL;
+    }
 
-/*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_set_remove(struct hg_core_private_addr *hg_core_addr)
-{
-    hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
+    if (!hg_core_batch) {
+        hg_core_batch =
+            hg_core_coalesce_batch_get(context, hg_core_handle, response);
+        HG_CHECK_ERROR(hg_core_batch == NULL, unlock, ret, HG_NOMEM,
+            "Could not get batch of coalesced messages");
+        HG_LIST_INSERT_HEAD(list, hg_core_batch, entry);
+        new_batch = HG_TRUE;
+    }
 
-    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
-        na_ret =
-            NA_Addr_set_remove(hg_core_addr->core_addr.core_class->na_class,
-                hg_core_addr->core_addr.na_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "NA_Addr_set_remove() failed (%s)", NA_Error_to_string(na_ret));
+    /* Append entry */
+    header.size = (hg_uint32_t) size;
+    header.tag = (hg_uint32_t) hg_core_handle->tag;
+    ret = hg_core_header_coalesce_proc(HG_ENCODE,
+        (char *) hg_core_batch->buf + hg_core_batch->buf_used,
+        hg_core_batch->buf_size - hg_core_batch->buf_used, &header);
+    HG_CHECK_HG_ERROR(unlock, ret, "Could not encode coalesce header");
+    hg_core_batch->buf_used += hg_core_header_coalesce_get_size();
+
+    memcpy((char *) hg_core_batch->buf + hg_core_batch->buf_used, buf, size);
+    hg_core_batch->buf_used += size;
+
+    hg_core_handle->coalesce_next = hg_core_batch->handles;
+    hg_core_batch->handles = hg_core_handle;
+
+    /* Response to that request may come along with other responses */
+    if (!response && !hg_core_handle->no_response) {
+        HG_LIST_INSERT_HEAD(
+            &context->coalesce_wait_list, hg_core_handle, coalesce);
+        hg_core_handle->coalesced = HG_TRUE;
     }
 
-#ifdef NA_HAS_SM
-    if (hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
-        na_ret =
-            NA_Addr_set_remove(hg_core_addr->core_addr.core_class->na_sm_class,
-                hg_core_addr->core_addr.na_sm_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "NA_Addr_set_remove() failed (%s)", NA_Error_to_string(na_ret));
+    /* Send request batch once it is full, it can no longer be found
+     * afterwards. Responses are only limited by the buffer size. */
+    hg_core_batch->count++;
+    if (response || hg_core_batch->count <
+                        HG_CORE_CONTEXT_CLASS(context)->request_coalesce_count)
+        hg_core_batch = NULL;
+    else {
+        HG_LIST_REMOVE(hg_core_batch, entry);
+        new_batch = HG_FALSE;
+    }
+
+unlock:
+    hg_thread_mutex_unlock(&context->coalesce_mutex);
+
+    /* Make sure progress does not block without flushing new batch */
+    if (new_batch) {
+        hg_atomic_set32(&context->coalesce_pending, 1);
+
+        if (context->completion_queue_notify > 0) {
+            hg_return_t notify_ret = hg_core_completion_notify(context);
+            HG_CHECK_ERROR_DONE(notify_ret != HG_SUCCESS,
+                "Could not signal completion queue");
+        }
+    }
+
+    /* Entry is now part of a batch, errors are reported on completion */
+    if (hg_core_full_batch) {
+        hg_return_t send_ret =
+            hg_core_coalesce_send(context, hg_core_full_batch);
+        HG_CHECK_ERROR_DONE(
+            send_ret != HG_SUCCESS, "Could not send coalesced messages");
+    }
+    if (ret == HG_SUCCESS && hg_core_batch) {
+        hg_return_t send_ret = hg_core_coalesce_send(context, hg_core_batch);
+        HG_CHECK_ERROR_DONE(
+            send_ret != HG_SUCCESS, "Could not send coalesced messages");
     }
-#endif
 
-done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_self(struct hg_core_private_class *hg_core_class,
-    struct hg_core_private_addr **self_addr)
+static struct hg_core_coalesce_batch *
+hg_core_coalesce_batch_get(struct hg_core_private_context *context,
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t response)
 {
-    struct hg_core_private_addr *hg_core_addr = NULL;
-    hg_return_t ret = HG_SUCCESS;
+    struct hg_core_coalesce_batch *hg_core_batch = NULL;
     na_return_t na_ret;
 
-    hg_core_addr = hg_core_addr_create(hg_core_class);
-    HG_CHECK_ERROR(
-        hg_core_addr == NULL, error, ret, HG_NOMEM, "Could not create HG addr");
-    hg_core_addr->core_addr.is_self = HG_TRUE;
-
-    /* Get NA address */
-    na_ret = NA_Addr_self(
-        hg_core_class->core_class.na_class, &hg_core_addr->core_addr.na_addr);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-        "Could not get self address (%s)", NA_Error_to_string(na_ret));
-
-    /* Cache serialize size */
-    hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
-        hg_core_class->core_class.na_class, hg_core_addr->core_addr.na_addr);
-
-#ifdef NA_HAS_SM
-    if (hg_core_class->core_class.na_sm_class) {
-        /* Get SM address */
-        na_ret = NA_Addr_self(hg_core_class->core_class.na_sm_class,
-            &hg_core_addr->core_addr.na_sm_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-            "Could not get self SM address (%s)", NA_Error_to_string(na_ret));
+    /* Re-use previous batch if possible */
+    HG_LIST_FOREACH (hg_core_batch, &context->coalesce_pool, entry) {
+        if (hg_core_batch->na_class == hg_core_handle->na_class &&
+            hg_core_batch->response == response) {
+            HG_LIST_REMOVE(hg_core_batch, entry);
+            break;
+        }
+    }
 
-        /* Cache serialize size */
-        hg_core_addr->na_sm_addr_serialize_size =
-            NA_Addr_get_serialize_size(hg_core_class->core_class.na_sm_class,
-                hg_core_addr->core_addr.na_sm_addr);
+    if (!hg_core_batch) {
+        hg_core_batch = (struct hg_core_coalesce_batch *) malloc(
+            sizeof(struct hg_core_coalesce_batch));
+        HG_CHECK_ERROR_NORET(hg_core_batch == NULL, error,
+            "Could not allocate batch of coalesced messages");
+        memset(hg_core_batch, 0, sizeof(struct hg_core_coalesce_batch));
+
+        hg_core_batch->context = context;
+        hg_core_batch->na_class = hg_core_handle->na_class;
+        hg_core_batch->response = response;
+
+        /* Use same size as input/output buffers */
+        if (response) {
+            hg_core_header_response_init(&hg_core_batch->header);
+            hg_core_batch->buf_size = hg_core_handle->core_handle.out_buf_size;
+        } else {
+            hg_core_header_request_init(&hg_core_batch->header);
+            hg_core_batch->buf_size = hg_core_handle->core_handle.in_buf_size;
+        }
+        hg_core_batch->buf = NA_Msg_buf_alloc(hg_core_batch->na_class,
+            hg_core_batch->buf_size, &hg_core_batch->buf_plugin_data);
+        HG_CHECK_ERROR_NORET(hg_core_batch->buf == NULL, error,
+            "Could not allocate buffer for coalesced messages");
+
+        na_ret = (response)
+                     ? NA_Msg_init_expected(hg_core_batch->na_class,
+                           hg_core_batch->buf, hg_core_batch->buf_size)
+                     : NA_Msg_init_unexpected(hg_core_batch->na_class,
+                           hg_core_batch->buf, hg_core_batch->buf_size);
+        HG_CHECK_ERROR_NORET(na_ret != NA_SUCCESS, error,
+            "Could not initialize buffer (%s)", NA_Error_to_string(na_ret));
+
+        hg_core_batch->na_op_id = NA_Op_create(hg_core_batch->na_class);
+        HG_CHECK_ERROR_NORET(hg_core_batch->na_op_id == NULL, error,
+            "Could not create NA op ID");
+    }
 
-        /* Copy local host ID */
-        NA_SM_Host_id_copy(&hg_core_addr->host_id, hg_core_class->host_id);
+    /* Set header now, each entry keeps its own header and tag. Aggregated
+     * responses are sent with the tag of the first response. */
+    if (response) {
+        /* Origin decodes aggregated responses in the format it requested */
+        hg_core_header_response_reset(&hg_core_batch->header);
+        hg_core_batch->header.compact = hg_core_handle->out_header.compact;
+        hg_core_batch->header.msg.response.flags = HG_CORE_COALESCED;
+        hg_core_batch->header.msg.response.cookie = hg_core_handle->cookie;
+        hg_core_batch->buf_used =
+            hg_core_handle->core_handle.na_out_header_offset +
+            ((hg_core_batch->header.compact)
+                    ? hg_core_header_response_get_compact_size(0)
+                    : hg_core_header_response_get_size());
+    } else {
+        hg_core_header_request_reset(&hg_core_batch->header);
+        hg_core_batch->header.compact = HG_FALSE;
+        hg_core_batch->header.msg.request.flags = HG_CORE_COALESCED;
+        hg_core_batch->header.msg.request.cookie = context->core_context.id;
+        hg_core_batch->buf_used =
+            hg_core_handle->core_handle.na_in_header_offset +
+            hg_core_header_request_get_size();
     }
-#endif
+    hg_core_batch->tag = hg_core_handle->tag;
 
-    *self_addr = hg_core_addr;
+    /* Keep a reference to the target address until batch is sent */
+    hg_core_batch->addr =
+        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr;
+    hg_atomic_incr32_relaxed(&hg_core_batch->addr->ref_count);
+    hg_core_batch->na_context = hg_core_handle->na_context;
+    hg_core_batch->na_addr = hg_core_handle->na_addr;
+    hg_core_batch->context_id = hg_core_handle->core_handle.info.context_id;
+    hg_core_batch->handles = NULL;
+    hg_core_batch->count = 0;
+    hg_time_get_current_ms(&hg_core_batch->start);
 
-    return ret;
+    return hg_core_batch;
 
 error:
-    hg_core_addr_free(hg_core_addr);
+    hg_core_coalesce_batch_free(hg_core_batch);
+    return NULL;
+}
 
-    return ret;
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_coalesce_batch_release(struct hg_core_private_context *context,
+    struct hg_core_coalesce_batch *hg_core_batch)
+{
+    hg_return_t ret;
+
+    ret = hg_core_addr_free(hg_core_batch->addr);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not free address");
+    hg_core_batch->addr = NULL;
+    hg_core_batch->na_addr = NA_ADDR_NULL;
+
+    hg_thread_mutex_lock(&context->coalesce_mutex);
+    HG_LIST_INSERT_HEAD(&context->coalesce_pool, hg_core_batch, entry);
+    hg_thread_mutex_unlock(&context->coalesce_mutex);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_dup(struct hg_core_private_addr *hg_core_addr,
-    struct hg_core_private_addr **hg_new_addr_ptr)
+static void
+hg_core_coalesce_batch_free(struct hg_core_coalesce_batch *hg_core_batch)
 {
-    struct hg_core_private_addr *hg_new_addr = NULL;
-    hg_return_t ret = HG_SUCCESS;
     na_return_t na_ret;
 
-    hg_new_addr = hg_core_addr_create(HG_CORE_ADDR_CLASS(hg_core_addr));
-    HG_CHECK_ERROR(hg_new_addr == NULL, error, ret, HG_NOMEM,
-        "Could not create dup HG addr");
-    hg_new_addr->core_addr.is_self = hg_core_addr->core_addr.is_self;
+    if (!hg_core_batch)
+        return;
 
-    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
-        na_ret = NA_Addr_dup(hg_core_addr->core_addr.core_class->na_class,
-            hg_core_addr->core_addr.na_addr, &hg_new_addr->core_addr.na_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-            "Could not duplicate address (%s)", NA_Error_to_string(na_ret));
+    if (hg_core_batch->na_op_id) {
+        na_ret =
+            NA_Op_destroy(hg_core_batch->na_class, hg_core_batch->na_op_id);
+        HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
+            "Could not destroy op ID (%s)", NA_Error_to_string(na_ret));
+    }
 
-        /* Copy serialize size */
-        hg_new_addr->na_addr_serialize_size =
-            hg_core_addr->na_addr_serialize_size;
+    if (hg_core_batch->buf) {
+        na_ret = NA_Msg_buf_free(hg_core_batch->na_class, hg_core_batch->buf,
+            hg_core_batch->buf_plugin_data);
+        HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS, "Could not free buffer (%s)",
+            NA_Error_to_string(na_ret));
     }
 
-#ifdef NA_HAS_SM
-    if (hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
-        na_ret = NA_Addr_dup(hg_core_addr->core_addr.core_class->na_sm_class,
-            hg_core_addr->core_addr.na_sm_addr,
-            &hg_new_addr->core_addr.na_sm_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-            "Could not duplicate address (%s)", NA_Error_to_string(na_ret));
+    if (hg_core_batch->response)
+        hg_core_header_response_finalize(&hg_core_batch->header);
+    else
+        hg_core_header_request_finalize(&hg_core_batch->header);
+    free(hg_core_batch);
+}
 
-        /* Copy serialize size */
-        hg_new_addr->na_sm_addr_serialize_size =
-            hg_core_addr->na_sm_addr_serialize_size;
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_coalesce_send(struct hg_core_private_context *context,
+    struct hg_core_coalesce_batch *hg_core_batch)
+{
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
 
-        /* Copy local host ID */
-        NA_SM_Host_id_copy(&hg_new_addr->host_id, hg_core_addr->host_id);
-    }
+#ifdef NA_HAS_SM
+    hg_core_poll_sm_wake(context, hg_core_batch->na_class);
 #endif
 
-    *hg_new_addr_ptr = hg_new_addr;
+    if (hg_core_batch->response) {
+        na_size_t na_header_offset =
+            NA_Msg_get_expected_header_size(hg_core_batch->na_class);
+        struct hg_core_header_coalesce header = {0, 0};
+
+        /* Terminate list of responses */
+        ret = hg_core_header_coalesce_proc(HG_ENCODE,
+            (char *) hg_core_batch->buf + hg_core_batch->buf_used,
+            hg_core_batch->buf_size - hg_core_batch->buf_used, &header);
+        HG_CHECK_HG_ERROR(error, ret, "Could not encode coalesce header");
+        hg_core_batch->buf_used += hg_core_header_coalesce_get_size();
+
+        ret = hg_core_header_response_proc(HG_ENCODE,
+            (char *) hg_core_batch->buf + na_header_offset,
+            hg_core_batch->buf_size - na_header_offset, &hg_core_batch->header);
+        HG_CHECK_HG_ERROR(error, ret, "Could not encode header");
+
+        HG_LOG_DEBUG("Sending %u aggregated responses (%zu bytes)",
+            hg_core_batch->count, (size_t) hg_core_batch->buf_used);
+
+        na_ret = NA_Msg_send_expected(hg_core_batch->na_class,
+            hg_core_batch->na_context, hg_core_coalesce_send_cb, hg_core_batch,
+            hg_core_batch->buf, hg_core_batch->buf_used,
+            hg_core_batch->buf_plugin_data, hg_core_batch->na_addr,
+            hg_core_batch->context_id, hg_core_batch->tag,
+            hg_core_batch->na_op_id);
+    } else {
+        na_size_t na_header_offset =
+            NA_Msg_get_unexpected_header_size(hg_core_batch->na_class);
+
+        ret = hg_core_header_request_proc(HG_ENCODE,
+            (char *) hg_core_batch->buf + na_header_offset,
+            hg_core_batch->buf_size - na_header_offset, &hg_core_batch->header);
+        HG_CHECK_HG_ERROR(error, ret, "Could not encode header");
+
+        HG_LOG_DEBUG("Sending %u coalesced requests (%zu bytes)",
+            hg_core_batch->count, (size_t) hg_core_batch->buf_used);
+
+        na_ret = NA_Msg_send_unexpected(hg_core_batch->na_class,
+            hg_core_batch->na_context, hg_core_coalesce_send_cb, hg_core_batch,
+            hg_core_batch->buf, hg_core_batch->buf_used,
+            hg_core_batch->buf_plugin_data, hg_core_batch->na_addr,
+            hg_core_batch->context_id, hg_core_gen_request_tag(context),
+            hg_core_batch->na_op_id);
+    }
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+        "Could not post send for coalesced messages (%s)",
+        NA_Error_to_string(na_ret));
 
     return ret;
 
 error:
-    hg_core_addr_free(hg_new_addr);
+    hg_core_coalesce_complete(context, hg_core_batch, NA_PROTOCOL_ERROR);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_bool_t
-hg_core_addr_cmp(
-    struct hg_core_private_addr *addr1, struct hg_core_private_addr *addr2)
+static int
+hg_core_coalesce_send_cb(const struct na_cb_info *callback_info)
 {
-    hg_bool_t ret = HG_TRUE;
-
-    /* Cannot be separate classes */
-    if (addr1->core_addr.core_class != addr2->core_addr.core_class)
-        return HG_FALSE;
+    struct hg_core_coalesce_batch *hg_core_batch =
+        (struct hg_core_coalesce_batch *) callback_info->arg;
 
-    /* Self addresses are always equal */
-    if (addr1->core_addr.is_self && addr2->core_addr.is_self)
-        return HG_TRUE;
+    return hg_core_coalesce_complete(
+        hg_core_batch->context, hg_core_batch, callback_info->ret);
+}
 
-    /* Compare NA addresses */
-    ret &= (hg_bool_t) NA_Addr_cmp(addr1->core_addr.core_class->na_class,
-        addr1->core_addr.na_addr, addr2->core_addr.na_addr);
+/*---------------------------------------------------------------------------*/
+static int
+hg_core_coalesce_complete(struct hg_core_private_context *context,
+    struct hg_core_coalesce_batch *hg_core_batch, na_return_t na_cb_ret)
+{
+    struct hg_core_private_handle *hg_core_handle = hg_core_batch->handles;
+    int count = 0;
+
+    /* Complete send of each entry */
+    while (hg_core_handle) {
+        struct hg_core_private_handle *next = hg_core_handle->coalesce_next;
+
+        hg_core_handle->coalesce_next = NULL;
+        count += (hg_core_batch->response)
+                     ? hg_core_send_output_complete(hg_core_handle, na_cb_ret)
+                     : hg_core_send_input_complete(hg_core_handle, na_cb_ret);
+        hg_core_handle = next;
+    }
+    hg_core_batch->handles = NULL;
 
-#ifdef NA_HAS_SM
-    /* Compare NA SM addresses */
-    if (addr1->core_addr.core_class->na_sm_class)
-        ret &= (hg_bool_t) NA_Addr_cmp(addr1->core_addr.core_class->na_sm_class,
-            addr1->core_addr.na_sm_addr, addr2->core_addr.na_sm_addr);
-#endif
+    hg_core_coalesce_batch_release(context, hg_core_batch);
 
-    return ret;
+    return count;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_addr_to_string(
-    char *buf, hg_size_t *buf_size, struct hg_core_private_addr *hg_core_addr)
+hg_core_coalesce_flush(
+    struct hg_core_private_context *context, unsigned int *timeout_ptr)
 {
-    na_class_t *na_class = hg_core_addr->core_addr.core_class->na_class;
-    na_addr_t na_addr = hg_core_addr->core_addr.na_addr;
-    char *buf_ptr = buf;
-    hg_size_t new_buf_size = 0, buf_size_used = 0;
+    struct hg_core_coalesce_list send_list;
+    struct hg_core_coalesce_batch *hg_core_batch;
+    unsigned int flush_time =
+        HG_CORE_CONTEXT_CLASS(context)->request_coalesce_time;
+    hg_time_t now;
     hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
-
-    new_buf_size = *buf_size;
 
-#ifdef NA_HAS_SM
-    /* When we have local and remote addresses */
-    if ((hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) &&
-        (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL)) {
-        char addr_str[HG_CORE_ADDR_MAX_SIZE];
-        char uuid_str[NA_SM_HOST_ID_LEN + 1];
-        int desc_len;
+    HG_LIST_INIT(&send_list);
+    if (flush_time)
+        hg_time_get_current_ms(&now);
 
-        /* Convert host ID to string and generate addr string */
-        na_ret = NA_SM_Host_id_to_string(hg_core_addr->host_id, uuid_str);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "NA_SM_Host_id_to_string() failed (%s)",
-            NA_Error_to_string(na_ret));
+    hg_thread_mutex_lock(&context->coalesce_mutex);
+    hg_atomic_set32(&context->coalesce_pending, 0);
 
-        desc_len = snprintf(addr_str, HG_CORE_ADDR_MAX_SIZE,
-            "uid://%s" HG_CORE_ADDR_DELIMITER, uuid_str);
-        HG_CHECK_ERROR(desc_len > HG_CORE_ADDR_MAX_SIZE, done, ret, HG_OVERFLOW,
-            "Exceeding max addr name");
+    /* Responses are aggregated within a single progress cycle */
+    while (!HG_LIST_IS_EMPTY(&context->coalesce_response_list)) {
+        hg_core_batch = HG_LIST_FIRST(&context->coalesce_response_list);
+        HG_LIST_REMOVE(hg_core_batch, entry);
+        HG_LIST_INSERT_HEAD(&send_list, hg_core_batch, entry);
+    }
 
-        if (buf_ptr) {
-            strcpy(buf_ptr, addr_str);
-            buf_ptr += desc_len;
+    hg_core_batch = HG_LIST_FIRST(&context->coalesce_list);
+    while (hg_core_batch) {
+        struct hg_core_coalesce_batch *next =
+            HG_LIST_NEXT(hg_core_batch, entry);
+
+        if (flush_time) {
+            unsigned int elapsed =
+                hg_time_to_ms(hg_time_subtract(now, hg_core_batch->start));
+
+            /* Do not wait past the time batch must be sent */
+            if (elapsed < flush_time) {
+                if (*timeout_ptr > flush_time - elapsed)
+                    *timeout_ptr = flush_time - elapsed;
+                hg_core_batch = next;
+                continue;
+            }
         }
-        buf_size_used += (hg_size_t) desc_len;
-        if (*buf_size > (unsigned int) desc_len)
-            new_buf_size = *buf_size - (hg_size_t) desc_len;
-
-        /* Get NA SM address string */
-        na_ret =
-            NA_Addr_to_string(hg_core_addr->core_addr.core_class->na_sm_class,
-                buf_ptr, &new_buf_size, hg_core_addr->core_addr.na_sm_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not convert SM address to string (%s)",
-            NA_Error_to_string(na_ret));
 
-        if (buf_ptr) {
-            buf_ptr[new_buf_size - 1] = *HG_CORE_ADDR_DELIMITER;
-            buf_ptr += new_buf_size;
-        }
-        buf_size_used += new_buf_size;
-        if (*buf_size > new_buf_size)
-            new_buf_size = *buf_size - new_buf_size;
-    } else if (hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
-        na_class = hg_core_addr->core_addr.core_class->na_sm_class;
-        na_addr = hg_core_addr->core_addr.na_sm_addr;
+        HG_LIST_REMOVE(hg_core_batch, entry);
+        HG_LIST_INSERT_HEAD(&send_list, hg_core_batch, entry);
+        hg_core_batch = next;
     }
-#endif
+    hg_thread_mutex_unlock(&context->coalesce_mutex);
 
-    /* Get NA address string */
-    na_ret = NA_Addr_to_string(na_class, buf_ptr, &new_buf_size, na_addr);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-        "Could not convert address to string (%s)", NA_Error_to_string(na_ret));
+    while (!HG_LIST_IS_EMPTY(&send_list)) {
+        hg_return_t send_ret;
 
-    *buf_size = new_buf_size + buf_size_used;
+        hg_core_batch = HG_LIST_FIRST(&send_list);
+        HG_LIST_REMOVE(hg_core_batch, entry);
+
+        /* Errors are reported to each entry */
+        send_ret = hg_core_coalesce_send(context, hg_core_batch);
+        HG_CHECK_ERROR_DONE(
+            send_ret != HG_SUCCESS, "Could not send coalesced messages");
+    }
 
-done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_size_t
-hg_core_addr_get_serialize_size(
-    struct hg_core_private_addr *hg_core_addr, hg_uint8_t flags)
+static int
+hg_core_recv_input_cb(const struct na_cb_info *callback_info)
 {
-    hg_size_t ret = sizeof(na_size_t);
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
+    const struct na_cb_info_recv_unexpected *na_cb_info_recv_unexpected =
+        &callback_info->info.recv_unexpected;
+    hg_bool_t completed = HG_TRUE;
+    hg_return_t ret;
 
-    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
-        if (hg_core_addr->na_addr_serialize_size == 0) {
-            /* Cache serialize size */
-            hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
-                hg_core_addr->core_addr.core_class->na_class,
-                hg_core_addr->core_addr.na_addr);
+    /* NA operation is no longer in use */
+    hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
+
+    /* Handle is no longer posted, it remains on the pending list until it is
+     * no longer reposted */
+    hg_core_handle->posted = HG_FALSE;
+    hg_core_post_pool_remove(hg_core_context_post_pool(
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle), hg_core_handle->na_class));
+
+    /* If canceled, mark handle as canceled */
+    if (callback_info->ret == NA_CANCELED) {
+        HG_CHECK_WARNING(
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
+        /* Handles trimmed by adaptive posting are only canceled in NA */
+        HG_CHECK_WARNING(
+            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED) &&
+                hg_core_handle->repost,
+            "Received NA_CANCELED event on handle that was not canceled");
+
+        /* Do not add handle to completion queue if it was not posted */
+        if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_POSTED)) {
+            /* Mark handle as completed */
+            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+
+            /* Clean up handle */
+            ret = hg_core_destroy(hg_core_handle);
+            HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not destroy handle");
+
+            return (int) completed;
         }
+    } else if (callback_info->ret != NA_SUCCESS) {
+        HG_LOG_ERROR("NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
 
-        ret += hg_core_addr->na_addr_serialize_size;
-    }
+        /* Mark handle as errored */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    } else {
+        if (HG_CORE_HANDLE_CLASS(hg_core_handle)->request_post_incr > 0) {
+            /* Check pending list and repost more handles if needed */
+            ret = hg_core_context_check_pending(
+                HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+                hg_core_handle->na_class, hg_core_handle->na_context,
+                HG_CORE_HANDLE_CLASS(hg_core_handle)->request_post_incr);
+            HG_CHECK_HG_ERROR(
+                done, ret, "Could not check and repost pending requests");
+        }
 
+        /* Fill unexpected info */
+        hg_core_handle->na_addr = na_cb_info_recv_unexpected->source;
 #ifdef NA_HAS_SM
-    ret += sizeof(na_size_t);
+        if (hg_core_handle->na_class ==
+            hg_core_handle->core_handle.info.core_class->na_sm_class) {
+            HG_LOG_DEBUG("Using NA SM class for this handle");
+            hg_core_handle->core_handle.info.addr->na_sm_addr =
+                hg_core_handle->na_addr;
+        } else
+#endif
+            hg_core_handle->core_handle.info.addr->na_addr =
+                hg_core_handle->na_addr;
+        hg_core_handle->tag = na_cb_info_recv_unexpected->tag;
+        HG_CHECK_ERROR_NORET(na_cb_info_recv_unexpected->actual_buf_size >
+                                 hg_core_handle->core_handle.in_buf_size,
+            done, "Actual transfer size is too large for unexpected recv");
+        hg_core_handle->in_buf_used =
+            na_cb_info_recv_unexpected->actual_buf_size;
 
-    if ((flags & HG_CORE_SM) &&
-        hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
-        if (hg_core_addr->na_sm_addr_serialize_size == 0) {
-            /* Cache serialize size */
-            hg_core_addr->na_sm_addr_serialize_size =
-                NA_Addr_get_serialize_size(
-                    hg_core_addr->core_addr.core_class->na_sm_class,
-                    hg_core_addr->core_addr.na_sm_addr);
+        HG_LOG_DEBUG("Processing input for handle %p, tag=%u, buf_size=%d",
+            hg_core_handle, hg_core_handle->tag, hg_core_handle->in_buf_used);
+        HG_PROBE3(mercury, recv_input, hg_core_handle, hg_core_handle->tag,
+            hg_core_handle->in_buf_used);
+
+        /* Process input information */
+        ret = hg_core_process_input(hg_core_handle, &completed);
+        HG_CHECK_HG_ERROR(done, ret, "Could not process input");
+
+        /* Coalesced requests are processed on separate handles, handle that
+         * was used for receiving can be reposted right away */
+        if (hg_core_handle->in_header.msg.request.flags & HG_CORE_COALESCED) {
+            unsigned int count = 0;
+
+            ret = hg_core_process_coalesced(hg_core_handle, &count);
+            HG_CHECK_ERROR_DONE(
+                ret != HG_SUCCESS, "Could not process coalesced requests");
+
+            /* Mark handle as completed */
+            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+
+            /* Clean up handle */
+            ret = hg_core_destroy(hg_core_handle);
+            HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not destroy handle");
+
+            return (int) count;
         }
 
-        ret += hg_core_addr->na_sm_addr_serialize_size +
-               sizeof(hg_core_addr->host_id);
+        /* Requests that cannot be processed are answered right away instead
+         * of going through the completion queue */
+        if (completed && hg_core_handle->process_ret != HG_SUCCESS) {
+            ret = hg_core_reject(hg_core_handle);
+            HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not reject request");
+
+            return 0;
+        }
     }
-#else
-    (void) flags;
-#endif
 
-    return ret;
+done:
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_PROCESS;
+
+    /* Complete operation */
+    ret = hg_core_complete_na(hg_core_handle, &completed);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+
+    return (int) completed;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_addr_serialize(void *buf, hg_size_t buf_size, hg_uint8_t flags,
-    struct hg_core_private_addr *hg_core_addr)
+hg_core_process_input(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t *completed)
 {
-    char *buf_ptr = (char *) buf;
-    hg_size_t buf_size_left = buf_size;
     hg_return_t ret = HG_SUCCESS;
 
-    if (hg_core_addr->core_addr.na_addr != NA_ADDR_NULL) {
-        na_return_t na_ret;
+    /* Get and verify input header */
+    ret = hg_core_proc_header_request(
+        &hg_core_handle->core_handle, &hg_core_handle->in_header, HG_DECODE);
+    HG_CHECK_HG_ERROR(done, ret, "Could not get request header");
 
-        HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left,
-            &hg_core_addr->na_addr_serialize_size, na_size_t);
+    /* Requests are each processed separately */
+    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_COALESCED) {
+        hg_core_set_header_size(
+            hg_core_handle, hg_core_handle->in_header.compact);
+        hg_core_handle->core_handle.in_header_size =
+            hg_core_handle->in_header.size;
+        *completed = HG_FALSE;
+        goto done;
+    }
 
-        na_ret = NA_Addr_serialize(hg_core_addr->core_addr.core_class->na_class,
-            buf_ptr, buf_size_left, hg_core_addr->core_addr.na_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not serialize NA address (%s)", NA_Error_to_string(na_ret));
-        buf_ptr += hg_core_addr->na_addr_serialize_size;
-        buf_size_left -= hg_core_addr->na_addr_serialize_size;
+    /* Look up RPC info early so that stats can be accounted per RPC */
+    if (hg_core_handle->in_header.index) {
+        struct hg_core_rpc_info *hg_core_rpc_info = hg_core_rpc_table_lookup(
+            HG_CORE_HANDLE_CLASS(hg_core_handle),
+            hg_core_handle->in_header.index);
+
+        /* Only the low bits of the RPC ID are sent along with the index, a
+         * mismatch means that the origin is using a stale index */
+        if (hg_core_rpc_info &&
+            (hg_core_rpc_info->id & 0xff) ==
+                (hg_core_handle->in_header.msg.request.id & 0xff))
+            hg_core_handle->core_handle.info.id = hg_core_rpc_info->id;
+        else {
+            hg_core_rpc_info = NULL;
+            hg_core_handle->core_handle.info.id = 0;
+        }
+        hg_core_handle->core_handle.rpc_info = hg_core_rpc_info;
     } else {
-        na_size_t na_sm_addr_serialize_size = 0;
-
-        /* Encode a 0 instead of flag */
-        HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left,
-            &na_sm_addr_serialize_size, na_size_t);
+        hg_core_handle->core_handle.info.id =
+            hg_core_handle->in_header.msg.request.id;
+        hg_core_handle->core_handle.rpc_info =
+            hg_core_func_map_lookup(HG_CORE_HANDLE_CLASS(hg_core_handle),
+                hg_core_handle->core_handle.info.id);
     }
 
-#ifdef NA_HAS_SM
-    if ((flags & HG_CORE_SM) &&
-        hg_core_addr->core_addr.na_sm_addr != NA_ADDR_NULL) {
-        na_return_t na_ret;
+    /* Respond with the header format used by the origin, which learns the
+     * index of the RPC from the first compact response */
+    hg_core_handle->out_header.index =
+        (hg_core_handle->in_header.compact &&
+            !hg_core_handle->in_header.index &&
+            hg_core_handle->core_handle.rpc_info)
+            ? hg_core_handle->core_handle.rpc_info->index
+            : 0;
+    hg_core_set_header_size(hg_core_handle, hg_core_handle->in_header.compact);
+    hg_core_handle->core_handle.in_header_size = hg_core_handle->in_header.size;
+    hg_core_handle->stamped &=
+        (hg_uint8_t) ~(HG_CORE_STAMP_BIT(HG_CORE_STAMP_RECEIVED) |
+                       HG_CORE_STAMP_BIT(HG_CORE_STAMP_DISPATCH));
+    hg_core_stamp(hg_core_handle, HG_CORE_STAMP_RECEIVED);
+    hg_core_trace(hg_core_handle, HG_TRACE_RECV, hg_core_handle->in_buf_used);
+    hg_core_hook(hg_core_handle, HG_HOOK_REQUEST, hg_core_handle->in_buf_used,
+        HG_SUCCESS);
+    hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+        hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_HANDLE, 1);
+    hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+        hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_BYTES_IN,
+        hg_core_handle->in_buf_used);
+    hg_core_handle->cookie = hg_core_handle->in_header.msg.request.cookie;
+    /* TODO assign target ID from cookie directly for now */
+    hg_core_handle->core_handle.info.context_id = hg_core_handle->cookie;
 
-        HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left,
-            &hg_core_addr->na_sm_addr_serialize_size, na_size_t);
+    /* Parse flags */
+    hg_core_handle->no_response =
+        hg_core_handle->in_header.msg.request.flags & HG_CORE_NO_RESPONSE;
+    hg_core_handle->respond =
+        hg_core_handle->in_header.msg.request.flags & HG_CORE_SELF_FORWARD
+            ? hg_core_respond_self
+            : hg_core_respond_na;
+    hg_core_handle->no_respond =
+        hg_core_handle->in_header.msg.request.flags & HG_CORE_SELF_FORWARD
+            ? hg_core_no_respond_self
+            : hg_core_no_respond_na;
 
-        na_ret =
-            NA_Addr_serialize(hg_core_addr->core_addr.core_class->na_sm_class,
-                buf_ptr, buf_size_left, hg_core_addr->core_addr.na_sm_addr);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not serialize NA SM address (%s)",
-            NA_Error_to_string(na_ret));
-        buf_ptr += hg_core_addr->na_sm_addr_serialize_size;
-        buf_size_left -= hg_core_addr->na_sm_addr_serialize_size;
-    } else {
-        na_size_t na_sm_addr_serialize_size = 0;
+    HG_LOG_DEBUG(
+        "Processed input for handle %p, ID=%llu, cookie=%d, no_response=%d",
+        hg_core_handle, hg_core_handle->core_handle.info.id,
+        hg_core_handle->cookie, hg_core_handle->no_response);
 
-        /* Encode a 0 instead of flag */
-        HG_CORE_ENCODE(done, ret, buf_ptr, buf_size_left,
-            &na_sm_addr_serialize_size, na_size_t);
+    /* Reject request before acquiring extra payload if target is overloaded,
+     * requests forwarded to self and batches of coalesced requests are not
+     * subject to admission control */
+    if (!(hg_core_handle->in_header.msg.request.flags &
+            (HG_CORE_SELF_FORWARD | HG_CORE_COALESCED)) &&
+        !hg_core_admit(hg_core_handle)) {
+        HG_LOG_DEBUG("Rejecting request on handle %p", hg_core_handle);
+        hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+            hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_REJECT, 1);
+        hg_core_handle->process_ret = HG_AGAIN;
+        *completed = HG_TRUE;
+        goto done;
     }
-#else
-    (void) flags;
-#endif
+
+    /* Must let upper layer get extra payload if HG_CORE_MORE_DATA is set */
+    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_MORE_DATA) {
+        HG_CHECK_ERROR(!HG_CORE_HANDLE_CLASS(hg_core_handle)->more_data_acquire,
+            done, ret, HG_OPNOTSUPPORTED,
+            "No callback defined for acquiring more data");
+        HG_LOG_DEBUG(
+            "Must acquire more input data for handle %p", hg_core_handle);
+        hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+            hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_EXTRA, 1);
+        ret = HG_CORE_HANDLE_CLASS(hg_core_handle)
+                  ->more_data_acquire((hg_core_handle_t) hg_core_handle,
+                      HG_INPUT, hg_core_complete);
+        if (ret != HG_SUCCESS) {
+            /* Payload could not be acquired (e.g., memory limit of context was
+             * reached), let the origin know instead of executing the RPC */
+            HG_LOG_WARNING("Could not acquire more input data (%d)", ret);
+            hg_core_handle->process_ret = ret;
+            ret = HG_SUCCESS;
+            *completed = HG_TRUE;
+        } else
+            *completed = HG_FALSE;
+    } else
+        *completed = HG_TRUE;
 
 done:
     return ret;
@@ -2047,427 +7521,493 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_addr_deserialize(struct hg_core_private_class *hg_core_class,
-    struct hg_core_private_addr **hg_core_addr_ptr, const void *buf,
-    hg_size_t buf_size)
+hg_core_process_coalesced(
+    struct hg_core_private_handle *hg_core_handle, unsigned int *count_ptr)
 {
-    struct hg_core_private_addr *hg_core_addr = NULL;
-    const char *buf_ptr = (const char *) buf;
-    hg_size_t buf_size_left = buf_size;
-    hg_bool_t is_self = HG_TRUE;
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_private_handle *hg_core_sub_handle = NULL;
+    na_size_t na_header_offset =
+        hg_core_handle->core_handle.na_in_header_offset;
+    na_size_t header_size = na_header_offset + hg_core_handle->in_header.size;
+    char *buf = (char *) hg_core_handle->core_handle.in_buf + header_size;
+    na_size_t buf_size;
+    unsigned int count = 0;
     hg_return_t ret = HG_SUCCESS;
 
-    /* Create new address */
-    hg_core_addr = hg_core_addr_create(hg_core_class);
-    HG_CHECK_ERROR(hg_core_addr == NULL, error, ret, HG_NOMEM,
-        "Could not create deserialized HG addr");
+    HG_CHECK_ERROR(hg_core_handle->in_buf_used < header_size, done, ret,
+        HG_PROTOCOL_ERROR, "Invalid size of coalesced requests");
+    buf_size = hg_core_handle->in_buf_used - header_size;
 
-    HG_CORE_DECODE(error, ret, buf_ptr, buf_size_left,
-        &hg_core_addr->na_addr_serialize_size, na_size_t);
+    while (buf_size > 0) {
+        struct hg_core_header_coalesce header;
+        hg_bool_t completed = HG_TRUE;
+        na_return_t na_ret;
 
-    if (hg_core_addr->na_addr_serialize_size != 0) {
-        na_return_t na_ret =
-            NA_Addr_deserialize(hg_core_class->core_class.na_class,
-                &hg_core_addr->core_addr.na_addr, buf_ptr, buf_size_left);
+        ret = hg_core_header_coalesce_proc(HG_DECODE, buf, buf_size, &header);
+        HG_CHECK_HG_ERROR(done, ret, "Could not decode coalesce header");
+        buf += hg_core_header_coalesce_get_size();
+        buf_size -= hg_core_header_coalesce_get_size();
+        HG_CHECK_ERROR(header.size > buf_size ||
+                           na_header_offset + header.size >
+                               hg_core_handle->core_handle.in_buf_size,
+            done, ret, HG_PROTOCOL_ERROR, "Invalid size of coalesced request");
+
+        /* Create new handle to process request */
+        ret = hg_core_create(context, hg_core_handle->na_class,
+            hg_core_handle->na_context, &hg_core_sub_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not create HG core handle");
+        hg_atomic_set32(&hg_core_sub_handle->status, 0);
+        hg_core_sub_handle->coalesced = HG_TRUE;
+
+        /* Source address must remain valid once handle is reposted */
+        hg_core_sub_handle->core_handle.info.addr =
+            (hg_core_addr_t) hg_core_addr_create(
+                HG_CORE_HANDLE_CLASS(hg_core_handle));
+        HG_CHECK_ERROR(
+            hg_core_sub_handle->core_handle.info.addr == HG_CORE_ADDR_NULL,
+            error, ret, HG_NOMEM, "Could not create HG core address");
+        na_ret = NA_Addr_dup(hg_core_handle->na_class, hg_core_handle->na_addr,
+            &hg_core_sub_handle->na_addr);
         HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-            "Could not deserialize NA address (%s)",
-            NA_Error_to_string(na_ret));
-        buf_ptr += hg_core_addr->na_addr_serialize_size;
-        buf_size_left -= hg_core_addr->na_addr_serialize_size;
-
-        is_self &= NA_Addr_is_self(hg_core_class->core_class.na_class,
-            hg_core_addr->core_addr.na_addr);
-    }
-
+            "Could not duplicate address (%s)", NA_Error_to_string(na_ret));
 #ifdef NA_HAS_SM
-    HG_CORE_DECODE(error, ret, buf_ptr, buf_size_left,
-        &hg_core_addr->na_sm_addr_serialize_size, na_size_t);
+        if (hg_core_handle->na_class ==
+            hg_core_handle->core_handle.info.core_class->na_sm_class)
+            hg_core_sub_handle->core_handle.info.addr->na_sm_addr =
+                hg_core_sub_handle->na_addr;
+        else
+#endif
+            hg_core_sub_handle->core_handle.info.addr->na_addr =
+                hg_core_sub_handle->na_addr;
+        hg_core_sub_handle->tag = header.tag;
+
+        /* Copy request along with its header */
+        memcpy((char *) hg_core_sub_handle->core_handle.in_buf +
+                   na_header_offset,
+            buf, header.size);
+        hg_core_sub_handle->in_buf_used = na_header_offset + header.size;
+        buf += header.size;
+        buf_size -= header.size;
 
-    if (hg_core_addr->na_sm_addr_serialize_size != 0) {
-        na_return_t na_ret =
-            NA_Addr_deserialize(hg_core_class->core_class.na_sm_class,
-                &hg_core_addr->core_addr.na_sm_addr, buf_ptr, buf_size_left);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-            "Could not deserialize NA SM address (%s)",
-            NA_Error_to_string(na_ret));
-        buf_ptr += hg_core_addr->na_sm_addr_serialize_size;
-        buf_size_left -= hg_core_addr->na_sm_addr_serialize_size;
+        /* Process input information */
+        ret = hg_core_process_input(hg_core_sub_handle, &completed);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not process input");
+
+            /* Mark handle as errored */
+            hg_atomic_or32(&hg_core_sub_handle->status, HG_CORE_OP_ERRORED);
+        } else if (completed && hg_core_sub_handle->process_ret != HG_SUCCESS) {
+            ret = hg_core_reject(hg_core_sub_handle);
+            HG_CHECK_HG_ERROR(done, ret, "Could not reject request");
+            continue;
+        }
 
-        is_self &= NA_Addr_is_self(hg_core_class->core_class.na_class,
-            hg_core_addr->core_addr.na_addr);
+        /* Set operation type for trigger */
+        hg_core_sub_handle->op_type = HG_CORE_PROCESS;
+
+        /* Complete operation */
+        ret = hg_core_complete_na(hg_core_sub_handle, &completed);
+        HG_CHECK_HG_ERROR(done, ret, "Could not complete operation");
+        if (completed)
+            count++;
     }
-#endif
-    hg_core_addr->core_addr.is_self = is_self;
 
-    *hg_core_addr_ptr = hg_core_addr;
+done:
+    *count_ptr = count;
 
     return ret;
 
 error:
-    hg_core_addr_free(hg_core_addr);
+    hg_core_destroy(hg_core_sub_handle);
+    *count_ptr = count;
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_create(struct hg_core_private_context *context, na_class_t *na_class,
-    na_context_t *na_context,
-    struct hg_core_private_handle **hg_core_handle_ptr)
+static hg_bool_t
+hg_core_admit(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_handle *hg_core_handle = NULL;
-    hg_return_t ret = HG_SUCCESS;
-
-    /* Allocate new handle */
-    hg_core_handle = hg_core_alloc(context);
-    HG_CHECK_ERROR(hg_core_handle == NULL, error, ret, HG_NOMEM,
-        "Could not allocate handle");
-
-    /* Alloc/init NA resources */
-    ret = hg_core_alloc_na(hg_core_handle, na_class, na_context);
-    HG_CHECK_HG_ERROR(error, ret, "Could not allocate NA handle ops");
-
-    /* Execute class callback on handle, this allows upper layers to
-     * allocate private data on handle creation */
-    if (context->handle_create) {
-        ret = context->handle_create(
-            (hg_core_handle_t) hg_core_handle, context->handle_create_arg);
-        HG_CHECK_HG_ERROR(error, ret, "Error in HG handle create callback");
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+
+    if (hg_core_class->admit_queue_max > 0) {
+        unsigned int queue_count = 0;
+        unsigned int i;
+
+        for (i = 0; i < HG_PRIORITY_MAX; i++)
+            queue_count +=
+                hg_atomic_seg_queue_count(context->completion_queues[i]);
+        if (queue_count >= hg_core_class->admit_queue_max)
+            return HG_FALSE;
     }
 
-    HG_LOG_DEBUG("Created new handle (%p)", hg_core_handle);
-
-    *hg_core_handle_ptr = hg_core_handle;
-
-    return ret;
+    /* Load already accounts for this request */
+    if (hg_core_class->admit_active_max > 0 &&
+        hg_core_context_load(context) > hg_core_class->admit_active_max)
+        return HG_FALSE;
 
-error:
-    hg_core_destroy(hg_core_handle);
-    return ret;
+    return HG_TRUE;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_destroy(struct hg_core_private_handle *hg_core_handle)
+hg_core_reject(struct hg_core_private_handle *hg_core_handle)
 {
     hg_return_t ret = HG_SUCCESS;
 
-    if (!hg_core_handle)
-        goto done;
-
-    if (hg_atomic_decr32(&hg_core_handle->ref_count))
-        goto done; /* Cannot free yet */
-
-    /* Repost handle if we were listening, otherwise destroy it */
-    if (hg_core_handle->repost &&
-        !HG_CORE_HANDLE_CONTEXT(hg_core_handle)->finalizing) {
-        HG_LOG_DEBUG("Reposting handle (%p)", hg_core_handle);
-
-        /* Repost handle */
-        ret = hg_core_reset_post(hg_core_handle);
-        HG_CHECK_HG_ERROR(done, ret, "Cannot repost handle");
+    /* Receive has completed, the handle is released once the response is
+     * sent as if it had been processed */
+    hg_atomic_incr32(&hg_core_handle->na_op_completed_count);
+    hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
 
-        /* TODO handle error */
+    if (hg_core_handle->no_response) {
+        ret = hg_core_handle->no_respond(hg_core_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not complete handle");
     } else {
-        HG_LOG_DEBUG("Freeing handle (%p)", hg_core_handle);
-
-        /* Free extra data here if needed */
-        if (HG_CORE_HANDLE_CLASS(hg_core_handle)->more_data_release)
-            HG_CORE_HANDLE_CLASS(hg_core_handle)
-                ->more_data_release((hg_core_handle_t) hg_core_handle);
-
-        /* Free user data */
-        if (hg_core_handle->core_handle.data_free_callback)
-            hg_core_handle->core_handle.data_free_callback(
-                hg_core_handle->core_handle.data);
-
-        /* Free NA resources */
-        if (hg_core_handle->na_class) {
-            ret = hg_core_free_na(hg_core_handle);
-            HG_CHECK_HG_ERROR(done, ret, "Could not free NA ressources");
-        }
+        hg_size_t header_size =
+            hg_core_handle->core_handle.out_header_size +
+            hg_core_handle->core_handle.na_out_header_offset;
 
-        /* Free handle */
-        hg_core_free(hg_core_handle);
+        ret = hg_core_respond(hg_core_handle, NULL, NULL, 0, header_size,
+            hg_core_handle->process_ret);
+        HG_CHECK_HG_ERROR(done, ret, "Could not respond");
     }
 
 done:
+    /* Repost handle once response completes */
+    if (hg_core_destroy(hg_core_handle) != HG_SUCCESS)
+        HG_LOG_ERROR("Could not destroy handle");
+
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static struct hg_core_private_handle *
-hg_core_alloc(struct hg_core_private_context *context)
+static HG_INLINE int
+hg_core_send_output_cb(const struct na_cb_info *callback_info)
 {
-    struct hg_core_private_handle *hg_core_handle = NULL;
-
-    hg_core_handle = (struct hg_core_private_handle *) malloc(
-        sizeof(struct hg_core_private_handle));
-    HG_CHECK_ERROR_NORET(
-        hg_core_handle == NULL, done, "Could not allocate handle");
-
-    memset(hg_core_handle, 0, sizeof(struct hg_core_private_handle));
-
-    hg_core_handle->op_type = HG_CORE_PROCESS; /* Default */
-    hg_core_handle->core_handle.info.core_class =
-        context->core_context.core_class;
-    hg_core_handle->core_handle.info.context = &context->core_context;
-    hg_core_handle->core_handle.info.addr = HG_CORE_ADDR_NULL;
-    hg_core_handle->core_handle.info.id = 0;
-    hg_core_handle->core_handle.info.context_id = 0;
-
-    /* Default return code */
-    hg_core_handle->ret = HG_SUCCESS;
-
-    /* Add handle to handle list so that we can track it */
-    hg_thread_spin_lock(
-        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->created_list_lock);
-    HG_LIST_INSERT_HEAD(&HG_CORE_HANDLE_CONTEXT(hg_core_handle)->created_list,
-        hg_core_handle, created);
-    hg_thread_spin_unlock(
-        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->created_list_lock);
-
-    /* Completed by default */
-    hg_atomic_init32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
-
-    /* Init in/out header */
-    hg_core_header_request_init(&hg_core_handle->in_header);
-    hg_core_header_response_init(&hg_core_handle->out_header);
-
-    /* Set refcount to 1 */
-    hg_atomic_init32(&hg_core_handle->ref_count, 1);
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
 
-    /* Increment N handles from HG context */
-    hg_atomic_incr32(&context->n_handles);
+    /* NA operation is no longer in use */
+    hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
 
-done:
-    return hg_core_handle;
+    return hg_core_send_output_complete(hg_core_handle, callback_info->ret);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_free(struct hg_core_private_handle *hg_core_handle)
+static int
+hg_core_send_output_complete(
+    struct hg_core_private_handle *hg_core_handle, na_return_t na_cb_ret)
 {
-    hg_return_t ret = HG_SUCCESS;
-
-    /* Remove reference to HG addr */
-    ret = hg_core_addr_free(
-        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr);
-    HG_CHECK_HG_ERROR(done, ret, "Could not free address");
+    hg_bool_t completed = HG_TRUE;
+    hg_return_t ret;
 
-    /* Remove handle from list */
-    hg_thread_spin_lock(
-        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->created_list_lock);
-    HG_LIST_REMOVE(hg_core_handle, created);
-    hg_thread_spin_unlock(
-        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->created_list_lock);
+    if (na_cb_ret == NA_SUCCESS)
+        hg_core_trace(
+            hg_core_handle, HG_TRACE_SEND, hg_core_handle->out_buf_used);
 
-    /* Decrement N handles from HG context */
-    hg_atomic_decr32(&HG_CORE_HANDLE_CONTEXT(hg_core_handle)->n_handles);
+    /* If canceled, mark handle as canceled */
+    if (na_cb_ret == NA_CANCELED) {
+        HG_CHECK_WARNING(
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
+        HG_CHECK_WARNING(
+            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
+            "Received NA_CANCELED event on handle that was not canceled");
+    } else if (na_cb_ret != NA_SUCCESS) {
+        HG_LOG_ERROR(
+            "NA callback returned error (%s)", NA_Error_to_string(na_cb_ret));
 
-    hg_core_header_request_finalize(&hg_core_handle->in_header);
-    hg_core_header_response_finalize(&hg_core_handle->out_header);
+        /* Mark handle as errored */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    }
 
-    free(hg_core_handle);
+    /* done: */
+    /* Complete operation */
+    ret = hg_core_complete_na(hg_core_handle, &completed);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
 
-done:
-    return ret;
+    return (int) completed;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_alloc_na(struct hg_core_private_handle *hg_core_handle,
-    na_class_t *na_class, na_context_t *na_context)
+static HG_INLINE int
+hg_core_recv_output_cb(const struct na_cb_info *callback_info)
 {
-    hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
+    hg_bool_t completed = HG_TRUE;
+    hg_return_t ret;
 
-    /* Set NA class / context */
-    hg_core_handle->na_class = na_class;
-    hg_core_handle->na_context = na_context;
+    /* NA operation is no longer in use */
+    hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
 
-    /* Initialize in/out buffers and use unexpected message size */
-    hg_core_handle->core_handle.in_buf_size =
-        NA_Msg_get_max_unexpected_size(na_class);
-    hg_core_handle->core_handle.out_buf_size =
-        NA_Msg_get_max_expected_size(na_class);
-    hg_core_handle->core_handle.na_in_header_offset =
-        NA_Msg_get_unexpected_header_size(na_class);
-    hg_core_handle->core_handle.na_out_header_offset =
-        NA_Msg_get_expected_header_size(na_class);
+    /* No longer waiting for an aggregated response */
+    if (hg_core_handle->coalesced) {
+        struct hg_core_private_context *context =
+            HG_CORE_HANDLE_CONTEXT(hg_core_handle);
 
-    hg_core_handle->core_handle.in_buf =
-        NA_Msg_buf_alloc(na_class, hg_core_handle->core_handle.in_buf_size,
-            &hg_core_handle->in_buf_plugin_data);
-    HG_CHECK_ERROR(hg_core_handle->core_handle.in_buf == NULL, error, ret,
-        HG_NOMEM, "Could not allocate buffer for input");
+        hg_thread_mutex_lock(&context->coalesce_mutex);
+        if (hg_core_handle->coalesced) {
+            HG_LIST_REMOVE(hg_core_handle, coalesce);
+            hg_core_handle->coalesced = HG_FALSE;
+        }
+        hg_thread_mutex_unlock(&context->coalesce_mutex);
+    }
+
+    /* Recv was canceled after response was received along with others */
+    if (hg_core_handle->coalesce_received) {
+        HG_LOG_DEBUG("Processing aggregated output for handle %p, tag=%u",
+            hg_core_handle, hg_core_handle->tag);
+        hg_core_stamp(hg_core_handle, HG_CORE_STAMP_RECV);
+        hg_core_trace(hg_core_handle, HG_TRACE_RECV, 0);
+
+        /* Process output information */
+        ret = hg_core_process_output(
+            hg_core_handle, &completed, hg_core_send_ack);
+        HG_CHECK_HG_ERROR(done, ret, "Could not process output");
+    } else if (callback_info->ret == NA_CANCELED) {
+        HG_CHECK_WARNING(
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
+        HG_CHECK_WARNING(
+            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
+            "Received NA_CANCELED event on handle that was not canceled");
+
+        /* Do not add handle to completion queue if it was not posted */
+        if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_POSTED)) {
+            /* Mark handle as completed */
+            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
 
-    na_ret =
-        NA_Msg_init_unexpected(na_class, hg_core_handle->core_handle.in_buf,
-            hg_core_handle->core_handle.in_buf_size);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-        "Could not initialize input buffer (%s)", NA_Error_to_string(na_ret));
+            /* Clean up handle */
+            ret = hg_core_destroy(hg_core_handle);
+            HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not destroy handle");
 
-    hg_core_handle->core_handle.out_buf =
-        NA_Msg_buf_alloc(na_class, hg_core_handle->core_handle.out_buf_size,
-            &hg_core_handle->out_buf_plugin_data);
-    HG_CHECK_ERROR(hg_core_handle->core_handle.out_buf == NULL, error, ret,
-        HG_NOMEM, "Could not allocate buffer for output");
+            return (int) completed;
+        }
+    } else if (callback_info->ret != NA_SUCCESS) {
+        HG_LOG_ERROR("NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
 
-    na_ret = NA_Msg_init_expected(na_class, hg_core_handle->core_handle.out_buf,
-        hg_core_handle->core_handle.out_buf_size);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-        "Could not initialize output buffer (%s)", NA_Error_to_string(na_ret));
+        /* Mark handle as errored */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    } else {
+        HG_LOG_DEBUG("Processing output for handle %p, tag=%u", hg_core_handle,
+            hg_core_handle->tag);
+        hg_core_handle->out_buf_used =
+            callback_info->info.recv_expected.actual_buf_size;
+        hg_core_stamp(hg_core_handle, HG_CORE_STAMP_RECV);
+        hg_core_trace(hg_core_handle, HG_TRACE_RECV, 0);
 
-    /* Create NA operation IDs */
-    hg_core_handle->na_send_op_id = NA_Op_create(na_class);
-    HG_CHECK_ERROR(hg_core_handle->na_send_op_id == NULL, error, ret,
-        HG_NA_ERROR, "Could not create NA op ID");
-    hg_core_handle->na_recv_op_id = NA_Op_create(na_class);
-    HG_CHECK_ERROR(hg_core_handle->na_recv_op_id == NULL, error, ret,
-        HG_NA_ERROR, "Could not create NA op ID");
-    hg_core_handle->na_ack_op_id = NA_Op_create(na_class);
-    HG_CHECK_ERROR(hg_core_handle->na_ack_op_id == NULL, error, ret,
-        HG_NA_ERROR, "Could not create NA op ID");
+        /* Process output information */
+        ret = hg_core_process_output(
+            hg_core_handle, &completed, hg_core_send_ack);
+        HG_CHECK_HG_ERROR(done, ret, "Could not process output");
 
-    hg_core_handle->na_op_count = 1; /* Default (no response) */
-    hg_atomic_init32(&hg_core_handle->na_op_completed_count, 0);
+        /* Recv is re-posted once the chunk is consumed, it does not count as
+         * a completed operation */
+        if (hg_core_handle->out_header.msg.response.flags & HG_CORE_CHUNK) {
+            ret = hg_core_chunk_add(hg_core_handle);
+            HG_CHECK_HG_ERROR(done, ret, "Could not queue response chunk");
 
-    return ret;
+            return 1;
+        }
+    }
 
-error:
-    hg_core_free_na(hg_core_handle);
-    return ret;
+done:
+    /* Complete operation */
+    ret = hg_core_complete_na(hg_core_handle, &completed);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+
+    return (int) completed;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_free_na(struct hg_core_private_handle *hg_core_handle)
+hg_core_process_output(struct hg_core_private_handle *hg_core_handle,
+    hg_bool_t *completed, hg_return_t (*done_callback)(hg_core_handle_t))
 {
     hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
-
-    /* Destroy NA op IDs */
-    na_ret =
-        NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_send_op_id);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-        "Could not destroy send op ID (%s)", NA_Error_to_string(na_ret));
-    hg_core_handle->na_send_op_id = NULL;
-
-    na_ret =
-        NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_recv_op_id);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-        "Could not destroy recv op ID (%s)", NA_Error_to_string(na_ret));
-    hg_core_handle->na_recv_op_id = NULL;
-
-    na_ret =
-        NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_ack_op_id);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-        "Could not destroy ack op ID (%s)", NA_Error_to_string(na_ret));
-    hg_core_handle->na_ack_op_id = NULL;
-
-    /* Free buffers */
-    na_ret = NA_Msg_buf_free(hg_core_handle->na_class,
-        hg_core_handle->core_handle.in_buf, hg_core_handle->in_buf_plugin_data);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-        "Could not free input buffer (%s)", NA_Error_to_string(na_ret));
-    hg_core_handle->core_handle.in_buf = NULL;
-    hg_core_handle->in_buf_plugin_data = NULL;
 
-    na_ret = NA_Msg_buf_free(hg_core_handle->na_class,
-        hg_core_handle->core_handle.out_buf,
-        hg_core_handle->out_buf_plugin_data);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-        "Could not free output buffer (%s)", NA_Error_to_string(na_ret));
-    hg_core_handle->core_handle.out_buf = NULL;
-    hg_core_handle->out_buf_plugin_data = NULL;
+    /* Get and verify output header */
+    ret = hg_core_proc_header_response(
+        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_DECODE);
+    HG_CHECK_HG_ERROR(done, ret, "Could not decode header");
 
-    if (hg_core_handle->ack_buf) {
-        na_ret = NA_Msg_buf_free(hg_core_handle->na_class,
-            hg_core_handle->ack_buf, hg_core_handle->ack_buf_plugin_data);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not free ack buffer (%s)", NA_Error_to_string(na_ret));
-        hg_core_handle->ack_buf = NULL;
-        hg_core_handle->ack_buf_plugin_data = NULL;
+    /* Responses to other requests may have been sent along with ours */
+    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_COALESCED) {
+        ret = hg_core_process_output_coalesced(hg_core_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not process aggregated responses");
     }
+    hg_core_handle->core_handle.out_header_size =
+        hg_core_handle->out_header.size;
 
-    hg_core_handle->na_class = NULL;
-    hg_core_handle->na_context = NULL;
+    /* Get return code from header */
+    hg_core_handle->ret =
+        (hg_return_t) hg_core_handle->out_header.msg.response.ret_code;
 
-done:
-    return ret;
-}
+    /* Remember index of RPC in target table, forget it if it is stale */
+    if (hg_core_handle->out_header.index ||
+        (hg_core_handle->in_header.index && hg_core_handle->ret == HG_NOENTRY))
+        hg_core_addr_rpc_index_set((struct hg_core_private_addr *)
+                                       hg_core_handle->core_handle.info.addr,
+            hg_core_handle->core_handle.info.id,
+            hg_core_handle->out_header.index);
+
+    /* Remember load advertised by target for target selection */
+    if (hg_core_handle->out_header.msg.response.load > 0)
+        hg_atomic_set32(&((struct hg_core_private_addr *)
+                                 hg_core_handle->core_handle.info.addr)
+                              ->load,
+            (hg_util_int32_t) hg_core_handle->out_header.msg.response.load);
+
+    /* Follow credits advertised by target */
+    if (hg_core_handle->out_header.msg.response.credits > 0 &&
+        HG_CORE_HANDLE_CLASS(hg_core_handle)->request_credits > 0) {
+        struct hg_core_private_addr *hg_core_addr =
+            (struct hg_core_private_addr *)
+                hg_core_handle->core_handle.info.addr;
+
+        hg_thread_spin_lock(&hg_core_addr->credit_lock);
+        hg_core_addr->credits =
+            hg_core_handle->out_header.msg.response.credits;
+        hg_thread_spin_unlock(&hg_core_addr->credit_lock);
+    }
 
-/*---------------------------------------------------------------------------*/
-static void
-hg_core_reset(struct hg_core_private_handle *hg_core_handle)
-{
-    /* TODO context ID must always be reset as it is not passed along with the
-     * addr */
-    hg_core_handle->core_handle.info.context_id = 0;
+    /* Parse flags */
 
-    hg_core_handle->request_callback = NULL;
-    hg_core_handle->request_arg = NULL;
-    hg_core_handle->response_callback = NULL;
-    hg_core_handle->response_arg = NULL;
-    hg_core_handle->op_type = HG_CORE_PROCESS; /* Default */
-    hg_core_handle->tag = 0;
-    hg_core_handle->cookie = 0;
-    hg_core_handle->ret = HG_SUCCESS;
-    hg_core_handle->in_buf_used = 0;
-    hg_core_handle->out_buf_used = 0;
-    hg_core_handle->na_op_count = 1; /* Default (no response) */
-    hg_atomic_set32(&hg_core_handle->na_op_completed_count, 0);
-    hg_core_handle->no_response = HG_FALSE;
+    HG_LOG_DEBUG("Processed output for handle %p, ID=%llu, ret=%d",
+        hg_core_handle, hg_core_handle->core_handle.info.id,
+        hg_core_handle->ret);
 
-    /* Free extra data here if needed */
-    if (HG_CORE_HANDLE_CLASS(hg_core_handle)->more_data_release)
-        HG_CORE_HANDLE_CLASS(hg_core_handle)
-            ->more_data_release((hg_core_handle_t) hg_core_handle);
+    /* Must let upper layer get extra payload if HG_CORE_MORE_DATA is set */
+    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_MORE_DATA) {
+        HG_CHECK_ERROR(!HG_CORE_HANDLE_CLASS(hg_core_handle)->more_data_acquire,
+            done, ret, HG_OPNOTSUPPORTED,
+            "No callback defined for acquiring more data");
+        HG_LOG_DEBUG(
+            "Must acquire more input data for handle %p", hg_core_handle);
+        hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+            hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_EXTRA, 1);
 
-    if (hg_core_handle->ack_buf) {
-        na_return_t na_ret = NA_Msg_buf_free(hg_core_handle->na_class,
-            hg_core_handle->ack_buf, hg_core_handle->ack_buf_plugin_data);
-        HG_CHECK_ERROR_NORET(na_ret != NA_SUCCESS, done,
-            "Could not free ack buffer (%s)", NA_Error_to_string(na_ret));
-        hg_core_handle->ack_buf = NULL;
-        hg_core_handle->ack_buf_plugin_data = NULL;
-    }
+        /* Account for the ack before the recv completes, the send of the
+         * input may complete after it and must not complete the handle */
+        if (done_callback == hg_core_send_ack)
+            hg_core_handle->na_op_count++;
 
-    hg_core_header_request_reset(&hg_core_handle->in_header);
-    hg_core_header_response_reset(&hg_core_handle->out_header);
+        ret = HG_CORE_HANDLE_CLASS(hg_core_handle)
+                  ->more_data_acquire((hg_core_handle_t) hg_core_handle,
+                      HG_OUTPUT, done_callback);
+        if (ret != HG_SUCCESS) {
+            /* Payload could not be acquired (e.g., memory limit of context was
+             * reached), complete with error, target still expects an ack */
+            HG_LOG_WARNING("Could not acquire more output data (%d)", ret);
+            hg_core_handle->ret = ret;
+            ret = done_callback((hg_core_handle_t) hg_core_handle);
+            HG_CHECK_HG_ERROR(done, ret, "Could not complete handle");
+        }
+        *completed = HG_FALSE;
+    } else
+        *completed = HG_TRUE;
 
 done:
-    return;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_reset_post(struct hg_core_private_handle *hg_core_handle)
+hg_core_process_output_coalesced(struct hg_core_private_handle *hg_core_handle)
 {
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    na_size_t na_header_offset =
+        hg_core_handle->core_handle.na_out_header_offset;
+    na_size_t header_size = na_header_offset + hg_core_handle->out_header.size;
+    char *buf = (char *) hg_core_handle->core_handle.out_buf + header_size;
+    na_size_t buf_size = hg_core_handle->core_handle.out_buf_size - header_size;
+    char *own_buf = NULL;
+    na_size_t own_size = 0;
     hg_return_t ret = HG_SUCCESS;
 
-    /* Reset handle info */
-    if (hg_core_handle->core_handle.info.addr != HG_CORE_ADDR_NULL) {
-        ret = hg_core_addr_free_na((struct hg_core_private_addr *)
-                                       hg_core_handle->core_handle.info.addr);
-        HG_CHECK_HG_ERROR(done, ret, "Could not free NA addresses");
-    }
-    hg_core_handle->core_handle.info.id = 0;
+    /* List of responses is terminated by an empty entry */
+    for (;;) {
+        struct hg_core_private_handle *hg_core_coalesced_handle = NULL;
+        struct hg_core_header_coalesce header;
+        na_return_t na_ret;
 
-    /* Reset the handle */
-    hg_core_reset(hg_core_handle);
+        ret = hg_core_header_coalesce_proc(HG_DECODE, buf, buf_size, &header);
+        HG_CHECK_HG_ERROR(done, ret, "Could not decode coalesce header");
+        buf += hg_core_header_coalesce_get_size();
+        buf_size -= hg_core_header_coalesce_get_size();
+        if (header.size == 0)
+            break;
+        HG_CHECK_ERROR(header.size > buf_size, done, ret, HG_PROTOCOL_ERROR,
+            "Invalid size of aggregated response");
+
+        if (header.tag == hg_core_handle->tag) {
+            own_buf = buf;
+            own_size = header.size;
+            buf += header.size;
+            buf_size -= header.size;
+            continue;
+        }
 
-    /* Also reset additional handle parameters */
-    hg_atomic_set32(&hg_core_handle->ref_count, 1);
-    hg_core_handle->core_handle.rpc_info = NULL;
+        /* Look for handle waiting for that response */
+        hg_thread_mutex_lock(&context->coalesce_mutex);
+        HG_LIST_FOREACH (
+            hg_core_coalesced_handle, &context->coalesce_wait_list, coalesce) {
+            if (hg_core_coalesced_handle->tag == header.tag &&
+                hg_core_coalesced_handle->na_class == hg_core_handle->na_class)
+                break;
+        }
+        if (hg_core_coalesced_handle) {
+            HG_LIST_REMOVE(hg_core_coalesced_handle, coalesce);
+            hg_core_coalesced_handle->coalesced = HG_FALSE;
+        }
+        hg_thread_mutex_unlock(&context->coalesce_mutex);
+
+        if (!hg_core_coalesced_handle) {
+            HG_LOG_WARNING(
+                "No handle waiting for response with tag %u", header.tag);
+        } else if (na_header_offset + header.size >
+                   hg_core_coalesced_handle->core_handle.out_buf_size) {
+            HG_LOG_ERROR("Aggregated response exceeds output buffer size");
+        } else {
+            memcpy((char *) hg_core_coalesced_handle->core_handle.out_buf +
+                       na_header_offset,
+                buf, header.size);
+            hg_core_coalesced_handle->out_buf_used =
+                na_header_offset + header.size;
+            hg_core_coalesced_handle->coalesce_received = HG_TRUE;
+
+            /* Response is processed once pre-posted recv is released */
+            na_ret = NA_Cancel(hg_core_coalesced_handle->na_class,
+                hg_core_coalesced_handle->na_context,
+                hg_core_coalesced_handle->na_recv_op_id);
+            HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
+                "Could not cancel recv op id (%s)", NA_Error_to_string(na_ret));
+        }
+        buf += header.size;
+        buf_size -= header.size;
+    }
 
-    /* Reset status */
-    hg_atomic_set32(&hg_core_handle->status, 0);
+    HG_CHECK_ERROR(own_buf == NULL, done, ret, HG_PROTOCOL_ERROR,
+        "Own response is missing from aggregated responses");
 
-    /* Safe to repost */
-    ret = hg_core_post(hg_core_handle);
-    HG_CHECK_HG_ERROR(done, ret, "Cannot post handle");
+    /* Replace aggregated responses with own response and decode it */
+    memmove((char *) hg_core_handle->core_handle.out_buf + na_header_offset,
+        own_buf, own_size);
+    hg_core_handle->out_buf_used = na_header_offset + own_size;
+
+    ret = hg_core_proc_header_response(
+        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_DECODE);
+    HG_CHECK_HG_ERROR(done, ret, "Could not decode header");
 
 done:
     return ret;
@@ -2475,375 +8015,453 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_set_rpc(struct hg_core_private_handle *hg_core_handle,
-    struct hg_core_private_addr *hg_core_addr, na_addr_t na_addr, hg_id_t id)
+hg_core_send_ack(hg_core_handle_t handle)
 {
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
     hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
 
-    /* We allow for NULL addr to be passed at creation time, this allows
-     * for pool of handles to be created and later re-used after a call to
-     * HG_Core_reset() */
-    if (hg_core_addr && (hg_core_handle->core_handle.info.addr !=
-                            (hg_core_addr_t) hg_core_addr)) {
-        if (hg_core_handle->core_handle.info.addr != HG_CORE_ADDR_NULL) {
-            ret = hg_core_addr_free((struct hg_core_private_addr *)
-                                        hg_core_handle->core_handle.info.addr);
-            HG_CHECK_HG_ERROR(done, ret, "Could not free address");
-        }
-        hg_core_handle->core_handle.info.addr = (hg_core_addr_t) hg_core_addr;
-        hg_atomic_incr32(&hg_core_addr->ref_count);
+    /* Allocate buffer for ack, expected NA operations were already
+     * incremented by caller */
+    ret = hg_core_ack_buf_alloc(hg_core_handle);
+    HG_CHECK_HG_ERROR(error, ret, "Could not allocate ack buffer");
 
-        /* Set NA addr to use */
-        hg_core_handle->na_addr = na_addr;
+    /* Post expected send (ack) */
+    hg_atomic_incr32(&hg_core_handle->na_op_pending_count);
+    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_send_ack_cb, hg_core_handle,
+        hg_core_handle->ext->ack_buf, sizeof(hg_uint8_t),
+        hg_core_handle->ext->ack_buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        hg_core_handle->ext->na_ack_op_id);
+    if (na_ret != NA_SUCCESS)
+        hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
+    /* Expected sends should always succeed after retry */
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+        "Could not post send for ack buffer (%s)", NA_Error_to_string(na_ret));
 
-        /* Set forward call depending on address self */
-        hg_core_handle->is_self =
-            HG_CORE_HANDLE_CLASS(hg_core_handle)->loopback &&
-            hg_core_addr->core_addr.is_self;
+    return ret;
 
-        hg_core_handle->forward =
-            hg_core_handle->is_self ? hg_core_forward_self : hg_core_forward_na;
-    }
+error:
+    na_ret = hg_core_ack_buf_free(hg_core_handle);
+    HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS, "Could not free ack buffer (%s)",
+        NA_Error_to_string(na_ret));
 
-    /* We also allow for NULL RPC id to be passed (same reason as above) */
-    if (id && hg_core_handle->core_handle.info.id != id) {
-        struct hg_core_rpc_info *hg_core_rpc_info;
+    return ret;
+}
 
-        /* Retrieve ID function from function map */
-        hg_thread_spin_lock(
-            &HG_CORE_HANDLE_CLASS(hg_core_handle)->func_map_lock);
-        hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(
-            HG_CORE_HANDLE_CLASS(hg_core_handle)->func_map,
-            (hg_hash_table_key_t) &id);
-        hg_thread_spin_unlock(
-            &HG_CORE_HANDLE_CLASS(hg_core_handle)->func_map_lock);
-        if (!hg_core_rpc_info)
-            HG_GOTO_DONE(done, ret, HG_NOENTRY);
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_chunk_add(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_completion_entry *hg_completion_entry =
+        &hg_core_handle->hg_completion_entry;
 
-        hg_core_handle->core_handle.info.id = id;
+    /* Reference is released once the chunk callback has been triggered */
+    hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_QUEUED);
+    hg_core_handle->op_type = HG_CORE_FORWARD_CHUNK;
 
-        /* Cache RPC info */
-        hg_core_handle->core_handle.rpc_info = hg_core_rpc_info;
-    }
+    hg_completion_entry->op_type = HG_RPC;
+    hg_completion_entry->op_id.hg_core_handle =
+        (hg_core_handle_t) hg_core_handle;
 
-done:
-    return ret;
+    return hg_core_completion_add(hg_core_handle->core_handle.info.context,
+        hg_completion_entry, HG_FALSE);
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_post(struct hg_core_private_handle *hg_core_handle)
+hg_core_chunk_ack(struct hg_core_private_handle *hg_core_handle)
 {
+    hg_bool_t completed = HG_TRUE;
     hg_return_t ret = HG_SUCCESS;
     na_return_t na_ret;
 
-#ifdef NA_HAS_SM
-    if (hg_core_handle->na_class ==
-        hg_core_handle->core_handle.info.core_class->na_sm_class) {
-        hg_thread_spin_lock(
-            &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
-        HG_LIST_INSERT_HEAD(
-            &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->sm_pending_list,
-            hg_core_handle, pending);
-        hg_thread_spin_unlock(
-            &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
-    } else {
-#endif
-        hg_thread_spin_lock(
-            &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
-        HG_LIST_INSERT_HEAD(
-            &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list,
-            hg_core_handle, pending);
-        hg_thread_spin_unlock(
-            &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
-#ifdef NA_HAS_SM
-    }
-#endif
-
-    /* Post a new unexpected receive */
-    na_ret = NA_Msg_recv_unexpected(hg_core_handle->na_class,
-        hg_core_handle->na_context, hg_core_recv_input_cb, hg_core_handle,
-        hg_core_handle->core_handle.in_buf,
-        hg_core_handle->core_handle.in_buf_size,
-        hg_core_handle->in_buf_plugin_data, hg_core_handle->na_recv_op_id);
+    hg_core_handle->op_type = HG_CORE_FORWARD;
+
+    /* Recv is no longer posted, complete it here if handle was canceled
+     * while the chunk was queued */
+    if (hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED)
+        goto complete;
+
+    hg_atomic_incr32(&hg_core_handle->na_op_pending_count);
+    na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_recv_output_cb, hg_core_handle,
+        hg_core_handle->core_handle.out_buf,
+        hg_core_handle->core_handle.out_buf_size,
+        hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        hg_core_handle->na_recv_op_id);
+    if (na_ret != NA_SUCCESS)
+        hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
     HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-        "Could not post unexpected recv for input buffer (%s)",
+        "Could not post recv for output buffer (%s)",
         NA_Error_to_string(na_ret));
 
-    HG_LOG_DEBUG("Posted handle (%p)", hg_core_handle);
+    /* Target waits for the ack before sending the next message */
+    hg_core_handle->na_op_count++;
+    ret = hg_core_send_ack((hg_core_handle_t) hg_core_handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not send ack for response chunk");
 
+done:
     return ret;
 
 error:
-    hg_thread_spin_lock(
-        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
-    HG_LIST_REMOVE(hg_core_handle, pending);
-    hg_thread_spin_unlock(
-        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+
+complete:
+    (void) hg_core_complete_na(hg_core_handle, &completed);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_forward(struct hg_core_private_handle *hg_core_handle,
-    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size)
+hg_core_respond_chunk(struct hg_core_private_handle *hg_core_handle,
+    hg_core_cb_t callback, void *arg, hg_size_t payload_size)
 {
-    hg_util_int32_t status;
     hg_size_t header_size;
     hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
 
-    /* Make sure any internal cancelation has been processed on this handle
-     * before re-using it */
-    status = hg_atomic_get32(&hg_core_handle->status);
-    while ((status & HG_CORE_OP_CANCELED) && !(status & HG_CORE_OP_COMPLETED)) {
-        int cb_ret[HG_CORE_MAX_TRIGGER_COUNT] = {0};
-        unsigned int trigger_count = 0;
-        na_return_t na_ret;
-
-        na_ret = NA_Trigger(hg_core_handle->na_context, 0,
-            HG_CORE_MAX_TRIGGER_COUNT, cb_ret, &trigger_count);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT, done, ret,
-            (hg_return_t) na_ret, "Could not trigger NA callback (%s)",
-            NA_Error_to_string(na_ret));
-
-        status = hg_atomic_get32(&hg_core_handle->status);
-    }
-    HG_CHECK_ERROR(
-        !(status & HG_CORE_OP_COMPLETED) || (status & HG_CORE_OP_QUEUED), done,
-        ret, HG_BUSY, "Attempting to use handle that was not completed");
+    /* Chunks are sent through NA as expected messages */
+    HG_CHECK_ERROR(hg_core_handle->no_response, done, ret, HG_OPNOTSUPPORTED,
+        "Sending response was disabled on that RPC");
+    HG_CHECK_ERROR(hg_core_handle->is_self, done, ret, HG_OPNOTSUPPORTED,
+        "Response chunks cannot be sent to self");
 
-    /* Increment ref_count on handle to allow for destroy to be pre-emptively
-     * called */
-    hg_atomic_incr32(&hg_core_handle->ref_count);
+    /* Set header size */
+    header_size = hg_core_handle->core_handle.out_header_size +
+                  hg_core_handle->core_handle.na_out_header_offset;
 
-#ifdef HG_HAS_COLLECT_STATS
-    /* Increment counter */
-    hg_core_stat_incr(&hg_core_rpc_count_g);
-#endif
+    /* Set the actual size of the msg that needs to be transmitted */
+    HG_CHECK_ERROR(header_size + payload_size >
+                       hg_core_handle->core_handle.out_buf_size,
+        done, ret, HG_MSGSIZE, "Exceeding output buffer size");
+    hg_core_handle->out_buf_used = header_size + payload_size;
 
-    /* Reset op counts */
-    hg_core_handle->na_op_count = 1; /* Default (no response) */
-    hg_atomic_set32(&hg_core_handle->na_op_completed_count, 0);
+    ret = hg_core_ack_buf_alloc(hg_core_handle);
+    HG_CHECK_HG_ERROR(done, ret, "Could not allocate ack buffer");
 
     /* Reset status */
     hg_atomic_set32(&hg_core_handle->status, 0);
-
-    /* Reset handle ret */
     hg_core_handle->ret = HG_SUCCESS;
+    hg_core_handle->response_callback = callback;
+    hg_core_handle->response_arg = arg;
 
-    /* Set header size */
-    header_size = hg_core_header_request_get_size() +
-                  hg_core_handle->core_handle.na_in_header_offset;
+    /* Set header, credits and load are only advertised by the final
+     * response */
+    hg_core_handle->out_header.msg.response.ret_code = HG_SUCCESS;
+    hg_core_handle->out_header.msg.response.flags =
+        (hg_uint8_t)(HG_CORE_CHUNK | HG_CORE_BYTE_ORDER);
+    hg_core_handle->out_header.msg.response.cookie = hg_core_handle->cookie;
+    hg_core_handle->out_header.msg.response.credits = 0;
+    hg_core_handle->out_header.msg.response.load = 0;
 
-    /* Set the actual size of the msg that needs to be transmitted */
-    hg_core_handle->in_buf_used = header_size + payload_size;
-    HG_CHECK_ERROR(
-        hg_core_handle->in_buf_used > hg_core_handle->core_handle.in_buf_size,
-        error, ret, HG_MSGSIZE, "Exceeding input buffer size");
+    /* Encode response header */
+    ret = hg_core_proc_header_response(
+        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_ENCODE);
+    HG_CHECK_HG_ERROR(error, ret, "Could not encode header");
 
-    /* Parse flags */
-    if (flags & HG_CORE_NO_RESPONSE)
-        hg_core_handle->no_response = HG_TRUE;
-    if (hg_core_handle->is_self)
-        flags |= HG_CORE_SELF_FORWARD;
+    hg_core_trace(
+        hg_core_handle, HG_TRACE_RESPOND, hg_core_handle->out_buf_used);
+    hg_core_stats_add(HG_CORE_HANDLE_CLASS(hg_core_handle),
+        hg_core_handle->core_handle.rpc_info, HG_CORE_STAT_BYTES_OUT,
+        hg_core_handle->out_buf_used);
+
+    /* Chunk completes once it is sent and acked, reference is released once
+     * its callback has been triggered */
+    hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
+    hg_core_handle->op_type = HG_CORE_RESPOND_CHUNK;
+    hg_core_handle->na_op_count += 2;
+#ifdef NA_HAS_SM
+    hg_core_poll_sm_wake(
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle), hg_core_handle->na_class);
+#endif
 
-    /* Set callback, keep request and response callbacks separate so that
-     * they do not get overwritten when forwarding to ourself */
-    hg_core_handle->request_callback = callback;
-    hg_core_handle->request_arg = arg;
+    /* Pre-post recv (ack) */
+    hg_atomic_incr32(&hg_core_handle->na_op_pending_count);
+    na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_recv_ack_cb, hg_core_handle,
+        hg_core_handle->ext->ack_buf, sizeof(hg_uint8_t),
+        hg_core_handle->ext->ack_buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        hg_core_handle->ext->na_ack_op_id);
+    if (na_ret != NA_SUCCESS)
+        hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, release, ret, (hg_return_t) na_ret,
+        "Could not post recv for ack buffer (%s)", NA_Error_to_string(na_ret));
 
-    /* Set header */
-    hg_core_handle->in_header.msg.request.id =
-        hg_core_handle->core_handle.info.id;
-    hg_core_handle->in_header.msg.request.flags = flags;
-    /* Set the cookie as origin context ID, so that when the cookie is unpacked
-     * by the target and assigned to HG info context_id, the NA layer knows
-     * which context ID it needs to send the response to. */
-    hg_core_handle->in_header.msg.request.cookie =
-        hg_core_handle->core_handle.info.context->id;
-
-    /* Encode request header */
-    ret = hg_core_proc_header_request(
-        &hg_core_handle->core_handle, &hg_core_handle->in_header, HG_ENCODE);
-    HG_CHECK_HG_ERROR(error, ret, "Could not encode header");
+    /* Mark handle as posted */
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_POSTED);
 
-    /* If addr is self, forward locally, otherwise send the encoded buffer
-     * through NA and pre-post response */
-    ret = hg_core_handle->forward(hg_core_handle);
-    HG_CHECK_HG_ERROR(error, ret, "Could not forward buffer");
+    /* Post expected send (chunk) */
+    hg_atomic_incr32(&hg_core_handle->na_op_pending_count);
+    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_send_output_cb, hg_core_handle,
+        hg_core_handle->core_handle.out_buf, hg_core_handle->out_buf_used,
+        hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        hg_core_handle->na_send_op_id);
+    if (na_ret != NA_SUCCESS)
+        hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, cancel, ret, (hg_return_t) na_ret,
+        "Could not post send for response chunk (%s)",
+        NA_Error_to_string(na_ret));
 
 done:
     return ret;
 
-error:
-    /* Handle is no longer in use (ignore if still processing cancelation) */
-    if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED)) {
-        hg_atomic_set32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+cancel:
+    /* Ack recv completes the chunk with an error once canceled */
+    hg_core_handle->na_op_count--;
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+    na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
+        hg_core_handle->ext->na_ack_op_id);
+    HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS, "Could not cancel ack op id (%s)",
+        NA_Error_to_string(na_ret));
 
-        /* Rollback ref_count taken above */
-        hg_atomic_decr32(&hg_core_handle->ref_count);
-    }
+    return ret;
+
+release:
+    hg_core_handle->na_op_count -= 2;
+    hg_atomic_decr32(&hg_core_handle->ref_count);
+
+error:
+    hg_atomic_set32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_forward_self(struct hg_core_private_handle *hg_core_handle)
+static HG_INLINE int
+hg_core_send_ack_cb(const struct na_cb_info *callback_info)
 {
-    hg_return_t ret = HG_SUCCESS;
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
+    hg_bool_t completed = HG_TRUE;
+    hg_return_t ret;
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+    /* NA operation is no longer in use */
+    hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
 
-    /* Post operation to self processing pool */
-    ret = hg_core_process_self(hg_core_handle);
-    HG_CHECK_HG_ERROR(done, ret, "Could not self process handle");
+    /* If canceled, mark handle as canceled */
+    if (callback_info->ret == NA_CANCELED) {
+        HG_CHECK_WARNING(
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
+        HG_CHECK_WARNING(
+            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
+            "Received NA_CANCELED event on handle that was not canceled");
+    } else if (callback_info->ret != NA_SUCCESS) {
+        HG_LOG_ERROR("NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
 
-done:
-    return ret;
+        /* Mark handle as errored */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    } else {
+        hg_core_trace(hg_core_handle, HG_TRACE_ACK, 0);
+    }
+
+    /* done: */
+    /* Complete operation */
+    ret = hg_core_complete_na(hg_core_handle, &completed);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+
+    return (int) completed;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_forward_na(struct hg_core_private_handle *hg_core_handle)
+static HG_INLINE int
+hg_core_recv_ack_cb(const struct na_cb_info *callback_info)
 {
-    hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
+    hg_bool_t completed = HG_TRUE;
+    hg_return_t ret;
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_FORWARD;
+    /* NA operation is no longer in use */
+    hg_atomic_decr32(&hg_core_handle->na_op_pending_count);
 
-    /* Generate tag */
-    hg_core_handle->tag =
-        hg_core_gen_request_tag(HG_CORE_HANDLE_CLASS(hg_core_handle));
+    /* If canceled, mark handle as canceled */
+    if (callback_info->ret == NA_CANCELED) {
+        HG_CHECK_WARNING(
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
+        HG_CHECK_WARNING(
+            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
+            "Received NA_CANCELED event on handle that was not canceled");
 
-    /* Pre-post recv (output) if response is expected */
-    if (!hg_core_handle->no_response) {
-        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
-            hg_core_handle->na_context, hg_core_recv_output_cb, hg_core_handle,
-            hg_core_handle->core_handle.out_buf,
-            hg_core_handle->core_handle.out_buf_size,
-            hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
-            hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
-            hg_core_handle->na_recv_op_id);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
-            "Could not post recv for output buffer (%s)",
-            NA_Error_to_string(na_ret));
+        /* Do not add handle to completion queue if it was not posted */
+        if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_POSTED)) {
+            /* Mark handle as completed */
+            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
 
-        /* Increment number of expected NA operations */
-        hg_core_handle->na_op_count++;
+            /* Clean up handle */
+            ret = hg_core_destroy(hg_core_handle);
+            HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not destroy handle");
+
+            return (int) completed;
+        }
+    } else if (callback_info->ret != NA_SUCCESS) {
+        HG_LOG_ERROR("NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
+
+        /* Mark handle as errored */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    } else {
+        hg_core_trace(hg_core_handle, HG_TRACE_ACK, 0);
     }
 
-    /* Mark handle as posted */
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_POSTED);
+    /* done: */
+    /* Complete operation */
+    ret = hg_core_complete_na(hg_core_handle, &completed);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
 
-    /* Post send (input) */
-    na_ret = NA_Msg_send_unexpected(hg_core_handle->na_class,
-        hg_core_handle->na_context, hg_core_send_input_cb, hg_core_handle,
-        hg_core_handle->core_handle.in_buf, hg_core_handle->in_buf_used,
-        hg_core_handle->in_buf_plugin_data, hg_core_handle->na_addr,
-        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
-        hg_core_handle->na_send_op_id);
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, cancel, ret, (hg_return_t) na_ret,
-        "Could not post send for input buffer (%s)",
-        NA_Error_to_string(na_ret));
+    return (int) completed;
+}
 
-done:
-    return ret;
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_self_cb(const struct hg_core_cb_info *callback_info)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->info.respond.handle;
+    hg_return_t ret;
+    hg_bool_t completed = HG_TRUE;
 
-cancel:
-    if (!hg_core_handle->no_response)
-        hg_core_handle->na_op_count--;
+    /* First execute response callback */
+    if (hg_core_handle->response_callback) {
+        struct hg_core_cb_info hg_core_cb_info;
 
-    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_POSTED);
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+        hg_core_cb_info.arg = hg_core_handle->response_arg;
+        hg_core_cb_info.ret = HG_SUCCESS; /* TODO report failure */
+        hg_core_cb_info.type = HG_CB_RESPOND;
+        hg_core_cb_info.info.respond.handle = (hg_core_handle_t) hg_core_handle;
 
-    /* Cancel the above posted recv op */
-    na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
-        hg_core_handle->na_recv_op_id);
-    HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
-        "Could not cancel recv op id (%s)", NA_Error_to_string(na_ret));
+        hg_core_handle->response_callback(&hg_core_cb_info);
+    }
+
+    /* Assign forward callback back to handle */
+    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+
+    /* Increment refcount and push handle back to completion queue */
+    hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
+
+    /* Process output */
+    ret = hg_core_process_output(hg_core_handle, &completed, hg_core_complete);
+    HG_CHECK_HG_ERROR(done, ret, "Could not process output");
+
+    /* Mark as completed */
+    if (completed) {
+        ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not complete operation");
+    }
 
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_respond(struct hg_core_private_handle *hg_core_handle,
-    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size,
-    hg_return_t ret_code)
+hg_core_process_self(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_size_t header_size;
+    hg_bool_t completed = HG_FALSE;
     hg_return_t ret = HG_SUCCESS;
 
-    /* Cannot respond if no_response flag set */
-    HG_CHECK_ERROR(hg_core_handle->no_response, done, ret, HG_OPNOTSUPPORTED,
-        "Sending response was disabled on that RPC");
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_PROCESS;
 
-    /* Reset status */
-    hg_atomic_set32(&hg_core_handle->status, 0);
+    /* Process input */
+    ret = hg_core_process_input(hg_core_handle, &completed);
+    HG_CHECK_HG_ERROR(done, ret, "Could not process input");
 
-    /* Reset handle ret */
-    hg_core_handle->ret = HG_SUCCESS;
+    /* Mark as completed */
+    if (completed) {
+        ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not complete operation");
+    }
 
-    /* Set header size */
-    header_size = hg_core_header_response_get_size() +
-                  hg_core_handle->core_handle.na_out_header_offset;
+done:
+    return ret;
+}
 
-    /* Set the actual size of the msg that needs to be transmitted */
-    hg_core_handle->out_buf_used = header_size + payload_size;
-    HG_CHECK_ERROR(
-        hg_core_handle->out_buf_used > hg_core_handle->core_handle.out_buf_size,
-        error, ret, HG_MSGSIZE, "Exceeding output buffer size");
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_process(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_rpc_info *hg_core_rpc_info;
+    hg_return_t ret = HG_SUCCESS;
 
-    /* Set callback, keep request and response callbacks separate so that
-     * they do not get overwritten when forwarding to ourself */
-    hg_core_handle->response_callback = callback;
-    hg_core_handle->response_arg = arg;
+    /* Input could not be acquired, respond with error */
+    if (hg_core_handle->process_ret != HG_SUCCESS) {
+        ret = hg_core_handle->process_ret;
+        goto done;
+    }
 
-    /* Set header */
-    hg_core_handle->out_header.msg.response.ret_code = ret_code;
-    hg_core_handle->out_header.msg.response.flags = flags;
-    hg_core_handle->out_header.msg.response.cookie = hg_core_handle->cookie;
+    /* Retrieve exe function, RPC info was already looked up from the header
+     * when processing input */
+    hg_core_rpc_info = hg_core_handle->core_handle.rpc_info;
+    if (!hg_core_rpc_info)
+        hg_core_rpc_info =
+            hg_core_func_map_lookup(HG_CORE_HANDLE_CLASS(hg_core_handle),
+                hg_core_handle->core_handle.info.id);
+    if (!hg_core_rpc_info) {
+        HG_LOG_WARNING("Could not find RPC ID in function map");
+        ret = HG_NOENTRY;
+        goto done;
+    }
 
-    /* Encode response header */
-    ret = hg_core_proc_header_response(
-        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_ENCODE);
-    HG_CHECK_HG_ERROR(error, ret, "Could not encode header");
+    HG_CHECK_ERROR(hg_core_rpc_info->rpc_cb == NULL, done, ret, HG_INVALID_ARG,
+        "No RPC callback registered");
 
-    /* If addr is self, forward locally, otherwise send the encoded buffer
-     * through NA and pre-post response */
-    ret = hg_core_handle->respond(hg_core_handle);
-    HG_CHECK_HG_ERROR(error, ret, "Could not respond");
+    /* Cache RPC info */
+    hg_core_handle->core_handle.rpc_info = hg_core_rpc_info;
 
-done:
-    return ret;
+    /* Increment ref count here so that a call to HG_Destroy in user's RPC
+     * callback does not free the handle but only schedules its completion */
+    hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
 
-error:
-    /* Handle is no longer in use */
-    if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED))
-        hg_atomic_set32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+    hg_core_stamp(hg_core_handle, HG_CORE_STAMP_DISPATCH);
+    if (hg_core_handle->stamped & HG_CORE_STAMP_BIT(HG_CORE_STAMP_DISPATCH))
+        hg_core_latency_record(hg_core_handle, HG_LATENCY_TARGET_QUEUE,
+            HG_CORE_STAMP_RECEIVED,
+            &hg_core_handle->ext->stamps[HG_CORE_STAMP_DISPATCH]);
 
-    /* Decrement refcount on handle */
-    hg_atomic_decr32(&hg_core_handle->ref_count);
+    /* Execute RPC callback */
+    hg_core_hook(hg_core_handle, HG_HOOK_HANDLER_START,
+        hg_core_handle->in_buf_used, HG_SUCCESS);
+    ret = hg_core_rpc_info->rpc_cb((hg_core_handle_t) hg_core_handle);
+    hg_core_hook(hg_core_handle, HG_HOOK_HANDLER_END, 0, ret);
+    HG_CHECK_HG_ERROR(done, ret, "Error while executing RPC callback");
 
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_return_t
-hg_core_respond_self(struct hg_core_private_handle *hg_core_handle)
+hg_core_complete_na(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t *completed)
 {
     hg_return_t ret = HG_SUCCESS;
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_RESPOND_SELF;
+    /* Add handle to completion queue when expected operations have completed */
+    if (hg_atomic_incr32(&hg_core_handle->na_op_completed_count) ==
+            (hg_util_int32_t) hg_core_handle->na_op_count &&
+        *completed) {
+        /* Mark as completed */
+        ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not complete operation");
 
-    /* Complete and add to completion queue */
-    ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
-    HG_CHECK_HG_ERROR(done, ret, "Could not complete handle");
+        /* Increment number of entries added to completion queue */
+        *completed = HG_TRUE;
+    } else
+        *completed = HG_FALSE;
 
 done:
     return ret;
@@ -2851,875 +8469,1088 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_return_t
-hg_core_no_respond_self(struct hg_core_private_handle *hg_core_handle)
+hg_core_complete(hg_core_handle_t handle)
 {
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
+    struct hg_core_context *context = hg_core_handle->core_handle.info.context;
+    struct hg_completion_entry *hg_completion_entry =
+        &hg_core_handle->hg_completion_entry;
     hg_return_t ret = HG_SUCCESS;
+    hg_util_int32_t status;
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+    /* Mark op id as completed before checking for cancelation, also mark the
+     * operation as queued to track when it will be released from the completion
+     * queue. */
+    status = hg_atomic_or32(
+        &hg_core_handle->status, HG_CORE_OP_COMPLETED | HG_CORE_OP_QUEUED);
 
-    /* Complete and add to completion queue */
-    ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
-    HG_CHECK_HG_ERROR(done, ret, "Could not complete handle");
+    /* Deadline no longer applies */
+    if (hg_core_handle->timed)
+        hg_core_timer_disarm(hg_core_handle);
+
+    /* Let next forwards to the same target go */
+    if (hg_core_handle->credit_held)
+        hg_core_credit_release(hg_core_handle);
+
+    /* Forward is no longer in flight once its response is complete */
+    if (hg_core_handle->forward_listed &&
+        hg_core_handle->op_type != HG_CORE_FORWARD_CHUNK)
+        hg_core_forward_list_remove(hg_core_handle);
+
+    /* Check for current status before completing */
+    if (status & HG_CORE_OP_CANCELED) {
+        /* If it was canceled while being processed, set callback ret
+         * accordingly */
+        HG_LOG_DEBUG("Handle %p was canceled", hg_core_handle);
+        hg_core_handle->ret =
+            hg_core_handle->timed_out ? HG_TIMEOUT : HG_CANCELED;
+    } else if (status & HG_CORE_OP_ERRORED) {
+        /* If it was errored, set callback ret accordingly */
+        HG_LOG_DEBUG("Handle %p is errored", hg_core_handle);
+        hg_core_handle->ret = HG_NA_ERROR;
+    }
+
+    hg_completion_entry->op_type = HG_RPC;
+    hg_completion_entry->op_id.hg_core_handle = handle;
+
+    ret = hg_core_completion_add(
+        context, hg_completion_entry, hg_core_handle->is_self);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not add HG completion entry to completion queue");
 
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_respond_na(struct hg_core_private_handle *hg_core_handle)
+hg_return_t
+hg_core_completion_add(struct hg_core_context *context,
+    struct hg_completion_entry *hg_completion_entry, hg_bool_t self_notify)
 {
+    struct hg_core_private_context *private_context =
+        (struct hg_core_private_context *) context;
+    hg_priority_t priority = HG_PRIORITY_NORMAL;
     hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
-    hg_bool_t ack_recv_posted = HG_FALSE;
-
-    /* Increment number of expected NA operations */
-    hg_core_handle->na_op_count++;
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_RESPOND;
-
-    /* More data on output requires an ack once it is processed */
-    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_MORE_DATA) {
-        hg_core_handle->ack_buf = NA_Msg_buf_alloc(hg_core_handle->na_class,
-            sizeof(hg_uint8_t), &hg_core_handle->ack_buf_plugin_data);
-        HG_CHECK_ERROR(hg_core_handle->ack_buf == NULL, error, ret, HG_NA_ERROR,
-            "Could not allocate buffer for ack");
-
-        na_ret = NA_Msg_init_expected(hg_core_handle->na_class,
-            hg_core_handle->ack_buf, sizeof(hg_uint8_t));
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-            "Could not initialize ack buffer (%s)", NA_Error_to_string(na_ret));
-
-        /* Increment number of expected NA operations */
-        hg_core_handle->na_op_count++;
-
-        /* Pre-post recv (ack) if more data is expected */
-        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
-            hg_core_handle->na_context, hg_core_recv_ack_cb, hg_core_handle,
-            hg_core_handle->ack_buf, sizeof(hg_uint8_t),
-            hg_core_handle->ack_buf_plugin_data, hg_core_handle->na_addr,
-            hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
-            hg_core_handle->na_ack_op_id);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-            "Could not post recv for ack buffer (%s)",
-            NA_Error_to_string(na_ret));
-        ack_recv_posted = HG_TRUE;
+    if (hg_completion_entry->op_type == HG_BULK)
+        hg_core_stats_add(HG_CORE_CONTEXT_CLASS(private_context), NULL,
+            HG_CORE_STAT_BULK, 1);
+
+    /* Loopback RPCs may bypass the completion queue, their callbacks are then
+     * executed by the thread that completes them */
+    if (self_notify && hg_completion_entry->op_type == HG_RPC &&
+        HG_CORE_CONTEXT_CLASS(private_context)->loopback_inline) {
+        struct hg_core_private_handle *hg_core_handle =
+            (struct hg_core_private_handle *)
+                hg_completion_entry->op_id.hg_core_handle;
+
+        ret = hg_core_trigger_entry(hg_core_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not execute loopback callback");
+
+        /* Callback may have completed a request that another thread waits
+         * for while blocked in progress */
+        goto notify;
     }
 
-    /* Mark handle as posted */
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_POSTED);
-
-    /* Post expected send (output) */
-    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
-        hg_core_handle->na_context, hg_core_send_output_cb, hg_core_handle,
-        hg_core_handle->core_handle.out_buf, hg_core_handle->out_buf_used,
-        hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
-        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
-        hg_core_handle->na_send_op_id);
-    /* Expected sends should always succeed after retry */
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-        "Could not post send for output buffer (%s)",
-        NA_Error_to_string(na_ret));
-
-    return ret;
+    /* Entry is completed by an NA completion that is being triggered by this
+     * thread, let the trigger execute it directly */
+    if (HG_CORE_CONTEXT_CLASS(private_context)->integrated_completion) {
+        struct hg_core_trigger_slot *slot =
+            (struct hg_core_trigger_slot *) hg_thread_getspecific(
+                HG_CORE_CONTEXT_CLASS(private_context)->trigger_slot_key);
+
+        if (slot && slot->context == private_context &&
+            slot->hg_completion_entry == NULL) {
+            slot->hg_completion_entry = hg_completion_entry;
+            goto done;
+        }
+    }
 
-error:
-    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_POSTED);
+    /* Completions of RPCs go to the lane of their RPC, bulk transfers and
+     * lookups use the default one */
+    if (hg_completion_entry->op_type == HG_RPC) {
+        struct hg_core_rpc_info *hg_core_rpc_info =
+            hg_completion_entry->op_id.hg_core_handle->rpc_info;
 
-    if (ack_recv_posted) {
-        hg_core_handle->na_op_count--;
+        if (hg_core_rpc_info)
+            priority = hg_core_rpc_info->priority;
+    }
 
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+    /* Received requests wait in the fair-share scheduler, the lane only
+     * holds a placeholder that is replaced by the request to dispatch when
+     * it is dequeued */
+    if (private_context->fair_scheds &&
+        hg_completion_entry->op_type == HG_RPC &&
+        ((struct hg_core_private_handle *)
+                hg_completion_entry->op_id.hg_core_handle)
+                ->op_type == HG_CORE_PROCESS) {
+        hg_core_fair_push(&private_context->fair_scheds[priority],
+            (struct hg_core_private_handle *)
+                hg_completion_entry->op_id.hg_core_handle);
+        ret = hg_core_completion_push(
+            private_context, HG_CORE_FAIR_ENTRY, priority);
+    } else
+        ret = hg_core_completion_push(
+            private_context, hg_completion_entry, priority);
+    HG_CHECK_HG_ERROR(done, ret, "Could not push completion entry");
 
-        /* Cancel the above posted recv ack op */
-        na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
-            hg_core_handle->na_ack_op_id);
-        HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
-            "Could not cancel ack op id (%s)", NA_Error_to_string(na_ret));
-    }
-    if (hg_core_handle->ack_buf) {
-        na_ret = NA_Msg_buf_free(hg_core_handle->na_class,
-            hg_core_handle->ack_buf, hg_core_handle->ack_buf_plugin_data);
-        HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
-            "Could not free ack buffer (%s)", NA_Error_to_string(na_ret));
-        hg_core_handle->ack_buf = NULL;
-        hg_core_handle->ack_buf_plugin_data = NULL;
+notify:
+    if (self_notify && private_context->completion_queue_notify > 0) {
+        ret = hg_core_completion_notify(private_context);
+        HG_CHECK_HG_ERROR(done, ret, "Could not signal completion queue");
     }
 
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_no_respond_na(struct hg_core_private_handle *hg_core_handle)
+static hg_return_t
+hg_core_completion_push(struct hg_core_private_context *context, void *entry,
+    hg_priority_t priority)
 {
     hg_return_t ret = HG_SUCCESS;
+    int rc;
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_NO_RESPOND;
+    /* Queue grows as needed so this can only fail if we run out of memory */
+    rc = hg_atomic_seg_queue_push(context->completion_queues[priority], entry);
+    HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOMEM,
+        "Could not push completion entry");
 
-    ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
-    HG_CHECK_HG_ERROR(done, ret, "Could not complete operation");
+    /* Callback is pushed to the completion queue when something completes
+     * so wake up anyone waiting in trigger, threads waiting for the poller
+     * also wait on that cond so wake up everyone in that case. Waiters
+     * register before checking the queue, the fence orders our push before
+     * that check so that the mutex is only taken when someone may sleep */
+    hg_atomic_fence();
+    if (hg_atomic_get32(&context->progress_waiters)) {
+        hg_thread_mutex_lock(&context->completion_queue_mutex);
+        hg_thread_cond_broadcast(&context->completion_queue_cond);
+        hg_thread_mutex_unlock(&context->completion_queue_mutex);
+    } else if (hg_atomic_get32(&context->trigger_waiters)) {
+        hg_thread_mutex_lock(&context->completion_queue_mutex);
+        hg_thread_cond_signal(&context->completion_queue_cond);
+        hg_thread_mutex_unlock(&context->completion_queue_mutex);
+    }
 
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE int
-hg_core_send_input_cb(const struct na_cb_info *callback_info)
+static unsigned int
+hg_core_completion_pop(struct hg_core_private_context *context,
+    void **entries, unsigned int max_count)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
-    hg_bool_t completed = HG_TRUE;
-    hg_return_t ret;
-
-    /* If canceled, mark handle as canceled */
-    if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_WARNING(
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
-        HG_CHECK_WARNING(
-            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
-            "Received NA_CANCELED event on handle that was not canceled");
-    } else if (callback_info->ret != NA_SUCCESS) {
-        hg_util_int32_t status;
-
-        HG_LOG_ERROR("NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+    unsigned int round =
+        (unsigned int) hg_atomic_incr32(&context->trigger_round);
+    unsigned int first = 0, lane = 0, i, n = 0;
+
+    /* Give lower priorities their turn once in a while */
+    if (round % HG_CORE_PRIORITY_QUOTA == 0)
+        first = (round / HG_CORE_PRIORITY_QUOTA) % HG_PRIORITY_MAX;
+
+    /* Entries of a single lane are dequeued at once */
+    for (i = 0; i < HG_PRIORITY_MAX && n == 0; i++) {
+        struct hg_atomic_seg_queue *queue;
+
+        lane = (first + i) % HG_PRIORITY_MAX;
+        queue = context->completion_queues[lane];
+        if (max_count > 1)
+            n = hg_atomic_seg_queue_pop_mc_n(queue, entries, max_count);
+        else {
+            entries[0] = hg_atomic_seg_queue_pop_mc(queue);
+            n = (entries[0] != NULL) ? 1 : 0;
+        }
+    }
 
-        /* Mark handle as errored */
-        status = hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    /* Each placeholder takes the request that the scheduler picks */
+    if (context->fair_scheds)
+        for (i = 0; i < n; i++)
+            if (entries[i] == HG_CORE_FAIR_ENTRY)
+                entries[i] = hg_core_fair_pop(&context->fair_scheds[lane]);
 
-        if (!(status & HG_CORE_OP_CANCELED) && !hg_core_handle->no_response) {
-            na_return_t na_ret;
+    return n;
+}
 
-            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_fair_push(struct hg_core_fair_sched *fair_sched,
+    struct hg_core_private_handle *hg_core_handle)
+{
+    /* Source address identifies the origin */
+    unsigned int index =
+        hg_core_func_map_hash((hg_id_t) (uintptr_t) hg_core_handle->na_addr) &
+        (HG_CORE_FAIR_BUCKETS - 1);
+    struct hg_core_fair_bucket *bucket = &fair_sched->buckets[index];
+
+    hg_thread_spin_lock(&fair_sched->lock);
+    /* Bucket gets its quantum when it joins the round */
+    if (HG_QUEUE_IS_EMPTY(&bucket->queue)) {
+        bucket->deficit = HG_CORE_FAIR_QUANTUM;
+        HG_QUEUE_PUSH_TAIL(&fair_sched->active_list, bucket, active);
+    }
+    HG_QUEUE_PUSH_TAIL(&bucket->queue, hg_core_handle, fair);
+    hg_thread_spin_unlock(&fair_sched->lock);
+}
 
-            /* Cancel posted recv for response */
-            na_ret = NA_Cancel(hg_core_handle->na_class,
-                hg_core_handle->na_context, hg_core_handle->na_recv_op_id);
-            HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret,
-                (hg_return_t) na_ret, "Could not cancel recv op id (%s)",
-                NA_Error_to_string(na_ret));
+/*---------------------------------------------------------------------------*/
+static struct hg_completion_entry *
+hg_core_fair_pop(struct hg_core_fair_sched *fair_sched)
+{
+    struct hg_core_private_handle *hg_core_handle = NULL;
+    struct hg_core_fair_bucket *bucket;
+
+    hg_thread_spin_lock(&fair_sched->lock);
+    /* There is one placeholder per queued request so the scheduler cannot be
+     * empty */
+    while ((bucket = HG_QUEUE_FIRST(&fair_sched->active_list)) != NULL) {
+        hg_core_handle = HG_QUEUE_FIRST(&bucket->queue);
+
+        /* Bucket used up its quantum, move it to the end of the round */
+        if (bucket->deficit < hg_core_handle->in_buf_used) {
+            bucket->deficit += HG_CORE_FAIR_QUANTUM;
+            HG_QUEUE_POP_HEAD(&fair_sched->active_list, active);
+            HG_QUEUE_PUSH_TAIL(&fair_sched->active_list, bucket, active);
+            continue;
         }
-    }
 
-done:
-    ret = hg_core_complete_na(hg_core_handle, &completed);
-    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+        bucket->deficit -= hg_core_handle->in_buf_used;
+        HG_QUEUE_POP_HEAD(&bucket->queue, fair);
+        if (HG_QUEUE_IS_EMPTY(&bucket->queue))
+            HG_QUEUE_POP_HEAD(&fair_sched->active_list, active);
+        break;
+    }
+    hg_thread_spin_unlock(&fair_sched->lock);
 
-    return (int) completed;
+    return (hg_core_handle) ? &hg_core_handle->hg_completion_entry : NULL;
 }
 
 /*---------------------------------------------------------------------------*/
-static int
-hg_core_recv_input_cb(const struct na_cb_info *callback_info)
+static hg_bool_t
+hg_core_completion_queue_is_empty(struct hg_core_private_context *context)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
-    const struct na_cb_info_recv_unexpected *na_cb_info_recv_unexpected =
-        &callback_info->info.recv_unexpected;
-    hg_bool_t completed = HG_TRUE;
-    hg_return_t ret;
+    unsigned int i;
 
-    /* Remove handle from pending list */
-    hg_thread_spin_lock(
-        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
-    HG_LIST_REMOVE(hg_core_handle, pending);
-    hg_thread_spin_unlock(
-        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->pending_list_lock);
+    for (i = 0; i < HG_PRIORITY_MAX; i++)
+        if (!hg_atomic_seg_queue_is_empty(context->completion_queues[i]))
+            return HG_FALSE;
 
-    /* If canceled, mark handle as canceled */
-    if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_WARNING(
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
-        HG_CHECK_WARNING(
-            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
-            "Received NA_CANCELED event on handle that was not canceled");
+    return HG_TRUE;
+}
 
-        /* Do not add handle to completion queue if it was not posted */
-        if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_POSTED)) {
-            /* Mark handle as completed */
-            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_core_completion_wait_prepare(struct hg_core_private_context *context)
+{
+    /* Register before checking that nothing is pending, notifiers push
+     * before checking the flag so that one of us always sees the other */
+    hg_atomic_set32(&context->completion_queue_must_notify, 1);
+    hg_atomic_fence();
 
-            /* Clean up handle */
-            ret = hg_core_destroy(hg_core_handle);
-            HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not destroy handle");
+    if (hg_core_poll_try_wait(context))
+        return HG_TRUE;
 
-            return (int) completed;
-        }
-    } else if (callback_info->ret != NA_SUCCESS) {
-        HG_LOG_ERROR("NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+    hg_atomic_set32(&context->completion_queue_must_notify, 0);
 
-        /* Mark handle as errored */
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
-    } else {
-        if (HG_CORE_HANDLE_CLASS(hg_core_handle)->request_post_incr > 0) {
-            /* Check pending list and repost more handles if needed */
-            ret = hg_core_context_check_pending(
-                HG_CORE_HANDLE_CONTEXT(hg_core_handle),
-                hg_core_handle->na_class, hg_core_handle->na_context,
-                HG_CORE_HANDLE_CLASS(hg_core_handle)->request_post_incr);
-            HG_CHECK_HG_ERROR(
-                done, ret, "Could not check and repost pending requests");
-        }
+    return HG_FALSE;
+}
 
-        /* Fill unexpected info */
-        hg_core_handle->na_addr = na_cb_info_recv_unexpected->source;
-#ifdef NA_HAS_SM
-        if (hg_core_handle->na_class ==
-            hg_core_handle->core_handle.info.core_class->na_sm_class) {
-            HG_LOG_DEBUG("Using NA SM class for this handle");
-            hg_core_handle->core_handle.info.addr->na_sm_addr =
-                hg_core_handle->na_addr;
-        } else
-#endif
-            hg_core_handle->core_handle.info.addr->na_addr =
-                hg_core_handle->na_addr;
-        hg_core_handle->tag = na_cb_info_recv_unexpected->tag;
-        HG_CHECK_ERROR_NORET(na_cb_info_recv_unexpected->actual_buf_size >
-                                 hg_core_handle->core_handle.in_buf_size,
-            done, "Actual transfer size is too large for unexpected recv");
-        hg_core_handle->in_buf_used =
-            na_cb_info_recv_unexpected->actual_buf_size;
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_completion_notify(struct hg_core_private_context *context)
+{
+    hg_return_t ret = HG_SUCCESS;
+    int rc;
 
-        HG_LOG_DEBUG("Processing input for handle %p, tag=%u, buf_size=%d",
-            hg_core_handle, hg_core_handle->tag, hg_core_handle->in_buf_used);
+    /* Pairs with the fence of hg_core_completion_wait_prepare() */
+    hg_atomic_fence();
 
-        /* Process input information */
-        ret = hg_core_process_input(hg_core_handle, &completed);
-        HG_CHECK_HG_ERROR(done, ret, "Could not process input");
+    /* Do not bother notifying if it's not needed as any event call will
+     * increase latency, only the first notifier signals a waiting poller */
+    if (hg_atomic_get32(&context->completion_queue_must_notify) &&
+        hg_atomic_cas32(&context->completion_queue_must_notify, 1, 0)) {
+        rc = hg_event_set(context->completion_queue_notify);
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_FAULT,
+            "Could not signal completion queue");
     }
 
 done:
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_PROCESS;
+    return ret;
+}
 
-    /* Complete operation */
-    ret = hg_core_complete_na(hg_core_handle, &completed);
-    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_completion_sink(void *arg, void *completion)
+{
+    hg_return_t ret;
 
-    return (int) completed;
+    /* Progress returns on its own since the completion is added from NA
+     * progress, no need to notify */
+    ret = hg_core_completion_push((struct hg_core_private_context *) arg,
+        (void *) ((uintptr_t) completion | HG_CORE_NA_ENTRY),
+        HG_PRIORITY_NORMAL);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not add NA completion");
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_process_input(
-    struct hg_core_private_handle *hg_core_handle, hg_bool_t *completed)
+hg_core_progress(struct hg_core_private_context *context, unsigned int timeout)
 {
-    hg_return_t ret = HG_SUCCESS;
-
-#ifdef HG_HAS_COLLECT_STATS
-    /* Increment counter */
-    hg_core_stat_incr(&hg_core_rpc_count_g);
-#endif
+    double remaining =
+        timeout / 1000.0; /* Convert timeout in ms into seconds */
 
-    /* Get and verify input header */
-    ret = hg_core_proc_header_request(
-        &hg_core_handle->core_handle, &hg_core_handle->in_header, HG_DECODE);
-    HG_CHECK_HG_ERROR(done, ret, "Could not get request header");
+    for (;;) {
+        hg_time_t t1, t2;
+        hg_bool_t empty;
 
-    /* Get operation ID from header */
-    hg_core_handle->core_handle.info.id =
-        hg_core_handle->in_header.msg.request.id;
-    hg_core_handle->cookie = hg_core_handle->in_header.msg.request.cookie;
-    /* TODO assign target ID from cookie directly for now */
-    hg_core_handle->core_handle.info.context_id = hg_core_handle->cookie;
+        /* Elect a single poller, concurrent pollers would only serialize on
+         * the poll set and NA progress */
+        if (hg_atomic_cas32(&context->progressing, 0, 1)) {
+            hg_return_t ret;
 
-    /* Parse flags */
-    hg_core_handle->no_response =
-        hg_core_handle->in_header.msg.request.flags & HG_CORE_NO_RESPONSE;
-    hg_core_handle->respond =
-        hg_core_handle->in_header.msg.request.flags & HG_CORE_SELF_FORWARD
-            ? hg_core_respond_self
-            : hg_core_respond_na;
-    hg_core_handle->no_respond =
-        hg_core_handle->in_header.msg.request.flags & HG_CORE_SELF_FORWARD
-            ? hg_core_no_respond_self
-            : hg_core_no_respond_na;
+            /* Release posted requests that are no longer needed */
+            if (HG_CORE_CONTEXT_CLASS(context)->request_post_adaptive)
+                hg_core_context_trim(context);
 
-    HG_LOG_DEBUG(
-        "Processed input for handle %p, ID=%llu, cookie=%d, no_response=%d",
-        hg_core_handle, hg_core_handle->core_handle.info.id,
-        hg_core_handle->cookie, hg_core_handle->no_response);
+            ret = hg_core_progress_poll(
+                context, (unsigned int) (remaining * 1000.0));
 
-    /* Must let upper layer get extra payload if HG_CORE_MORE_DATA is set */
-    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_MORE_DATA) {
-        HG_CHECK_ERROR(!HG_CORE_HANDLE_CLASS(hg_core_handle)->more_data_acquire,
-            done, ret, HG_OPNOTSUPPORTED,
-            "No callback defined for acquiring more data");
-        HG_LOG_DEBUG(
-            "Must acquire more input data for handle %p", hg_core_handle);
-#ifdef HG_HAS_COLLECT_STATS
-        /* Increment counter */
-        hg_core_stat_incr(&hg_core_rpc_extra_count_g);
-#endif
-        ret = HG_CORE_HANDLE_CLASS(hg_core_handle)
-                  ->more_data_acquire((hg_core_handle_t) hg_core_handle,
-                      HG_INPUT, hg_core_complete);
-        HG_CHECK_HG_ERROR(
-            done, ret, "Error in HG core handle more data acquire callback");
-        *completed = HG_FALSE;
-    } else
-        *completed = HG_TRUE;
+            /* Decrement is an atomic RMW so that waiters either see that we
+             * are no longer polling or get woken up */
+            hg_atomic_decr32(&context->progressing);
+            if (hg_atomic_get32(&context->progress_waiters)) {
+                hg_thread_mutex_lock(&context->completion_queue_mutex);
+                hg_thread_cond_broadcast(&context->completion_queue_cond);
+                hg_thread_mutex_unlock(&context->completion_queue_mutex);
+            }
 
-done:
-    return ret;
-}
+            return ret;
+        }
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE int
-hg_core_send_output_cb(const struct na_cb_info *callback_info)
-{
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
-    hg_bool_t completed = HG_TRUE;
-    hg_return_t ret;
+        /* Another thread is polling, completions it makes are ours to
+         * trigger, wait until something completes or the poller leaves */
+        hg_time_get_current_ms(&t1);
 
-    /* If canceled, mark handle as canceled */
-    if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_WARNING(
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
-        HG_CHECK_WARNING(
-            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
-            "Received NA_CANCELED event on handle that was not canceled");
-    } else if (callback_info->ret != NA_SUCCESS) {
-        HG_LOG_ERROR("NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+        hg_thread_mutex_lock(&context->completion_queue_mutex);
+        hg_atomic_incr32(&context->progress_waiters);
+        hg_atomic_fence();
+        empty = hg_core_completion_queue_is_empty(context);
+        if (empty && (int) (remaining * 1000.0) > 0 &&
+            hg_atomic_get32(&context->progressing))
+            hg_thread_cond_timedwait(&context->completion_queue_cond,
+                &context->completion_queue_mutex,
+                (unsigned int) (remaining * 1000.0));
+        hg_atomic_decr32(&context->progress_waiters);
+        hg_thread_mutex_unlock(&context->completion_queue_mutex);
+
+        if (!empty)
+            return HG_SUCCESS;
+        if ((int) (remaining * 1000.0) <= 0)
+            return HG_TIMEOUT;
 
-        /* Mark handle as errored */
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+        /* Queue is checked again on the next iteration, never poll with a
+         * negative timeout if we are elected then */
+        hg_time_get_current_ms(&t2);
+        remaining -= hg_time_diff(t2, t1);
+        if (remaining < 0)
+            remaining = 0;
     }
-
-    /* done: */
-    /* Complete operation */
-    ret = hg_core_complete_na(hg_core_handle, &completed);
-    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
-
-    return (int) completed;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE int
-hg_core_recv_output_cb(const struct na_cb_info *callback_info)
+static hg_return_t
+hg_core_progress_poll(
+    struct hg_core_private_context *context, unsigned int timeout)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
-    hg_bool_t completed = HG_TRUE;
+    double remaining =
+        timeout / 1000.0; /* Convert timeout in ms into seconds */
     hg_return_t ret;
 
-    /* If canceled, mark handle as canceled */
-    if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_WARNING(
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
-        HG_CHECK_WARNING(
-            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
-            "Received NA_CANCELED event on handle that was not canceled");
+    do {
+        hg_time_t t1, t2;
+        hg_bool_t safe_wait = HG_FALSE, progressed = HG_FALSE,
+                  spinning = HG_FALSE;
+        unsigned int poll_timeout = 0, coalesce_timeout = timeout;
 
-        /* Do not add handle to completion queue if it was not posted */
-        if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_POSTED)) {
-            /* Mark handle as completed */
-            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+        if (timeout)
+            hg_time_get_current_ms(&t1);
 
-            /* Clean up handle */
-            ret = hg_core_destroy(hg_core_handle);
-            HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not destroy handle");
+        /* Cancel timed forwards whose deadline expired */
+        if (hg_atomic_get32(&context->timer_count))
+            hg_core_timer_process(context, &coalesce_timeout);
 
-            return (int) completed;
+        /* Send batches of coalesced messages that are due */
+        if (HG_CORE_CONTEXT_CLASS(context)->request_coalesce_count > 1 ||
+            hg_atomic_get32(&context->coalesce_pending)) {
+            ret = hg_core_coalesce_flush(context, &coalesce_timeout);
+            HG_CHECK_HG_ERROR(error, ret, "Could not flush coalesced requests");
         }
-    } else if (callback_info->ret != NA_SUCCESS) {
-        HG_LOG_ERROR("NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
 
-        /* Mark handle as errored */
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
-    } else {
-        HG_LOG_DEBUG("Processing output for handle %p, tag=%u", hg_core_handle,
-            hg_core_handle->tag);
+        /* Events were recently seen, busy poll instead of blocking */
+        if (timeout && context->poll_spin_count > 0) {
+            context->poll_spin_count--;
+            spinning = HG_TRUE;
+        } else if (context->poll_set && timeout) {
+            /* Bypass notifications if timeout is 0 to prevent system calls,
+             * we need to be notified when doing blocking progress */
+            if (hg_core_completion_wait_prepare(context)) {
+                safe_wait = HG_TRUE;
+                poll_timeout = (unsigned int) (remaining * 1000.0);
+            }
+        } else if (!HG_CORE_CONTEXT_CLASS(context)->loopback && timeout &&
+                   hg_core_poll_try_wait(context)) {
+            /* This is the case for NA plugins that don't expose a fd */
+            poll_timeout = (unsigned int) (remaining * 1000.0);
+        }
+
+        /* Do not wait past the time pending batches must be sent or the
+         * next deadline */
+        if (poll_timeout > coalesce_timeout)
+            poll_timeout = coalesce_timeout;
+
+        /* Only enter blocking wait if it is safe to */
+        if (safe_wait) {
+            ret = hg_core_poll_wait(context, poll_timeout, &progressed);
+            HG_CHECK_HG_ERROR(
+                error, ret, "Could not make blocking progress on context");
+        } else {
+            ret = hg_core_poll(context, poll_timeout, &progressed);
+            HG_CHECK_HG_ERROR(
+                error, ret, "Could not make non-blocking progress on context");
+        }
 
-        /* Process output information */
-        ret = hg_core_process_output(
-            hg_core_handle, &completed, hg_core_send_ack);
-        HG_CHECK_HG_ERROR(done, ret, "Could not process output");
-    }
+        if (timeout)
+            hg_core_poll_spin_update(context, spinning, progressed);
 
-done:
-    /* Complete operation */
-    ret = hg_core_complete_na(hg_core_handle, &completed);
-    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+        /* We progressed or we have something to trigger */
+        if (progressed ||
+            !hg_core_completion_queue_is_empty(context))
+            return HG_SUCCESS;
 
-    return (int) completed;
+        if (timeout) {
+            hg_time_get_current_ms(&t2);
+            remaining -= hg_time_diff(t2, t1);
+        }
+    } while ((int) (remaining * 1000.0) > 0);
+
+    return HG_TIMEOUT;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_process_output(struct hg_core_private_handle *hg_core_handle,
-    hg_bool_t *completed, hg_return_t (*done_callback)(hg_core_handle_t))
+hg_core_process_ready(
+    struct hg_core_private_context *context, unsigned int *timeout_ptr)
 {
+    unsigned int timeout = HG_MAX_IDLE_TIME;
+    hg_bool_t progressed = HG_FALSE;
     hg_return_t ret = HG_SUCCESS;
 
-    /* Get and verify output header */
-    ret = hg_core_proc_header_response(
-        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_DECODE);
-    HG_CHECK_HG_ERROR(done, ret, "Could not decode header");
-
-    /* Get return code from header */
-    hg_core_handle->ret =
-        (hg_return_t) hg_core_handle->out_header.msg.response.ret_code;
+    /* Another thread is polling, it consumes events of the fd */
+    if (!hg_atomic_cas32(&context->progressing, 0, 1)) {
+        *timeout_ptr = 0;
+        return HG_AGAIN;
+    }
 
-    /* Parse flags */
+    /* Release posted requests that are no longer needed */
+    if (HG_CORE_CONTEXT_CLASS(context)->request_post_adaptive)
+        hg_core_context_trim(context);
 
-    HG_LOG_DEBUG("Processed output for handle %p, ID=%llu, ret=%d",
-        hg_core_handle, hg_core_handle->core_handle.info.id,
-        hg_core_handle->ret);
+    /* Cancel timed forwards whose deadline expired */
+    if (hg_atomic_get32(&context->timer_count))
+        hg_core_timer_process(context, &timeout);
 
-    /* Must let upper layer get extra payload if HG_CORE_MORE_DATA is set */
-    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_MORE_DATA) {
-        HG_CHECK_ERROR(!HG_CORE_HANDLE_CLASS(hg_core_handle)->more_data_acquire,
-            done, ret, HG_OPNOTSUPPORTED,
-            "No callback defined for acquiring more data");
-        HG_LOG_DEBUG(
-            "Must acquire more input data for handle %p", hg_core_handle);
+    /* Send batches of coalesced messages that are due */
+    if (HG_CORE_CONTEXT_CLASS(context)->request_coalesce_count > 1 ||
+        hg_atomic_get32(&context->coalesce_pending)) {
+        ret = hg_core_coalesce_flush(context, &timeout);
+        HG_CHECK_HG_ERROR(done, ret, "Could not flush coalesced requests");
+    }
 
-        ret = HG_CORE_HANDLE_CLASS(hg_core_handle)
-                  ->more_data_acquire((hg_core_handle_t) hg_core_handle,
-                      HG_OUTPUT, done_callback);
+    if (context->poll_set) {
+        /* Consume pending events so that the fd is no longer readable */
+        ret = hg_core_poll_wait(context, 0, &progressed);
         HG_CHECK_HG_ERROR(
-            done, ret, "Error in HG core handle more data acquire callback");
-        *completed = HG_FALSE;
-    } else
-        *completed = HG_TRUE;
+            done, ret, "Could not make non-blocking progress on context");
+    }
+
+    /* Progress NA operations that do not signal the fd, such as SM */
+    ret = hg_core_poll(context, 0, &progressed);
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not make non-blocking progress on context");
+
+    /* Completions queued from now on must signal the fd, unless the event
+     * loop cannot safely wait yet */
+    if (!context->poll_set || !hg_core_completion_wait_prepare(context))
+        timeout = 0;
 
 done:
+    hg_atomic_decr32(&context->progressing);
+    if (hg_atomic_get32(&context->progress_waiters)) {
+        hg_thread_mutex_lock(&context->completion_queue_mutex);
+        hg_thread_cond_broadcast(&context->completion_queue_cond);
+        hg_thread_mutex_unlock(&context->completion_queue_mutex);
+    }
+
+    *timeout_ptr = (ret == HG_SUCCESS) ? timeout : 0;
+
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_send_ack(hg_core_handle_t handle)
+static HG_INLINE hg_uint64_t
+hg_core_time_ms(void)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) handle;
-    hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
-
-    /* Increment number of expected NA operations */
-    hg_core_handle->na_op_count++;
+    hg_time_t now;
 
-    /* Allocate buffer for ack */
-    hg_core_handle->ack_buf = NA_Msg_buf_alloc(hg_core_handle->na_class,
-        sizeof(hg_uint8_t), &hg_core_handle->ack_buf_plugin_data);
-    HG_CHECK_ERROR(hg_core_handle->ack_buf == NULL, error, ret, HG_NA_ERROR,
-        "Could not allocate buffer for ack");
+    hg_time_get_current_ms(&now);
 
-    na_ret = NA_Msg_init_expected(
-        hg_core_handle->na_class, hg_core_handle->ack_buf, sizeof(hg_uint8_t));
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-        "Could not initialize ack buffer (%s)", NA_Error_to_string(na_ret));
+    /* hg_time_to_ms() would wrap around after ~49 days */
+    return (hg_uint64_t) (hg_time_to_double(now) * 1000.0);
+}
 
-    /* Post expected send (ack) */
-    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
-        hg_core_handle->na_context, hg_core_send_ack_cb, hg_core_handle,
-        hg_core_handle->ack_buf, sizeof(hg_uint8_t),
-        hg_core_handle->ack_buf_plugin_data, hg_core_handle->na_addr,
-        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
-        hg_core_handle->na_ack_op_id);
-    /* Expected sends should always succeed after retry */
-    HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
-        "Could not post send for ack buffer (%s)", NA_Error_to_string(na_ret));
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_timer_arm(
+    struct hg_core_private_handle *hg_core_handle, unsigned int timeout)
+{
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+
+    /* Completion disarms the timer under the same lock, if the handle has
+     * already completed there is nothing to arm */
+    hg_thread_spin_lock(&context->timer_lock);
+    if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED)) {
+        hg_timer_wheel_add(
+            context->timer_wheel, &hg_core_handle->ext->timer, timeout);
+        hg_atomic_incr32(&context->timer_count);
+    }
+    hg_thread_spin_unlock(&context->timer_lock);
+}
 
-    return ret;
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_timer_disarm(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
 
-error:
-    if (hg_core_handle->ack_buf) {
-        na_ret = NA_Msg_buf_free(hg_core_handle->na_class,
-            hg_core_handle->ack_buf, hg_core_handle->ack_buf_plugin_data);
-        HG_CHECK_ERROR_DONE(na_ret != NA_SUCCESS,
-            "Could not free ack buffer (%s)", NA_Error_to_string(na_ret));
-        hg_core_handle->ack_buf = NULL;
-        hg_core_handle->ack_buf_plugin_data = NULL;
+    hg_thread_spin_lock(&context->timer_lock);
+    if (hg_core_handle->ext->timer.armed) {
+        hg_timer_wheel_del(context->timer_wheel, &hg_core_handle->ext->timer);
+        hg_atomic_decr32(&context->timer_count);
     }
-    return ret;
+    hg_thread_spin_unlock(&context->timer_lock);
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE int
-hg_core_send_ack_cb(const struct na_cb_info *callback_info)
+static hg_bool_t
+hg_core_timer_undelay(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
-    hg_bool_t completed = HG_TRUE;
-    hg_return_t ret;
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    hg_bool_t undelayed = HG_FALSE;
 
-    /* If canceled, mark handle as canceled */
-    if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_WARNING(
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
-        HG_CHECK_WARNING(
-            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
-            "Received NA_CANCELED event on handle that was not canceled");
-    } else if (callback_info->ret != NA_SUCCESS) {
-        HG_LOG_ERROR("NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+    if (!hg_core_handle->delayed)
+        return HG_FALSE;
 
-        /* Mark handle as errored */
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    /* Once expired, the handle is sent or completed by the progress that
+     * dequeued it */
+    hg_thread_spin_lock(&context->timer_lock);
+    if (hg_core_handle->delayed && hg_core_handle->ext->timer.armed) {
+        hg_timer_wheel_del(context->timer_wheel, &hg_core_handle->ext->timer);
+        hg_atomic_decr32(&context->timer_count);
+        hg_core_handle->delayed = HG_FALSE;
+        undelayed = HG_TRUE;
     }
+    hg_thread_spin_unlock(&context->timer_lock);
 
-    /* done: */
-    /* Complete operation */
-    ret = hg_core_complete_na(hg_core_handle, &completed);
-    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
-
-    return (int) completed;
+    return undelayed;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE int
-hg_core_recv_ack_cb(const struct na_cb_info *callback_info)
+static hg_bool_t
+hg_core_credit_acquire(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
-    hg_bool_t completed = HG_TRUE;
-    hg_return_t ret;
-
-    /* If canceled, mark handle as canceled */
-    if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_WARNING(
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_DEBUG("NA_CANCELED event on handle %p", hg_core_handle);
-        HG_CHECK_WARNING(
-            !(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED),
-            "Received NA_CANCELED event on handle that was not canceled");
-
-        /* Do not add handle to completion queue if it was not posted */
-        if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_POSTED)) {
-            /* Mark handle as completed */
-            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+    struct hg_core_private_addr *hg_core_addr =
+        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr;
+    hg_bool_t acquired;
+
+    /* Queue behind forwards that are already waiting to preserve ordering */
+    hg_thread_spin_lock(&hg_core_addr->credit_lock);
+    acquired = (hg_core_addr->inflight < hg_core_addr->credits &&
+                HG_QUEUE_IS_EMPTY(&hg_core_addr->credit_queue));
+    if (acquired)
+        hg_core_addr->inflight++;
+    else
+        HG_QUEUE_PUSH_TAIL(
+            &hg_core_addr->credit_queue, hg_core_handle, credit);
+    hg_core_handle->credit_held = acquired;
+    hg_core_handle->credit_queued = !acquired;
+    hg_thread_spin_unlock(&hg_core_addr->credit_lock);
 
-            /* Clean up handle */
-            ret = hg_core_destroy(hg_core_handle);
-            HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not destroy handle");
+    return acquired;
+}
 
-            return (int) completed;
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_credit_release(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_private_addr *hg_core_addr =
+        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr;
+
+    hg_thread_spin_lock(&hg_core_addr->credit_lock);
+    hg_core_addr->inflight--;
+    hg_core_handle->credit_held = HG_FALSE;
+    hg_thread_spin_unlock(&hg_core_addr->credit_lock);
+
+    /* Credits may have been raised by the target, send as many forwards as
+     * they allow, forward() is called outside of the lock as it may complete
+     * handles */
+    for (;;) {
+        struct hg_core_private_handle *next = NULL;
+        hg_return_t ret;
+
+        hg_thread_spin_lock(&hg_core_addr->credit_lock);
+        if (hg_core_addr->inflight < hg_core_addr->credits &&
+            !HG_QUEUE_IS_EMPTY(&hg_core_addr->credit_queue)) {
+            next = HG_QUEUE_FIRST(&hg_core_addr->credit_queue);
+            HG_QUEUE_POP_HEAD(&hg_core_addr->credit_queue, credit);
+            next->credit_queued = HG_FALSE;
+            next->credit_held = HG_TRUE;
+            hg_core_addr->inflight++;
         }
-    } else if (callback_info->ret != NA_SUCCESS) {
-        HG_LOG_ERROR("NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+        hg_thread_spin_unlock(&hg_core_addr->credit_lock);
+        if (next == NULL)
+            break;
 
-        /* Mark handle as errored */
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
-    }
+        ret = next->forward(next);
+        if (ret == HG_SUCCESS)
+            continue;
 
-    /* done: */
-    /* Complete operation */
-    ret = hg_core_complete_na(hg_core_handle, &completed);
-    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete operation");
+        HG_LOG_ERROR("Could not forward buffer (ret=%d)", ret);
 
-    return (int) completed;
+        /* Give credit back without recursing and report error through the
+         * callback of the forward */
+        hg_thread_spin_lock(&hg_core_addr->credit_lock);
+        hg_core_addr->inflight--;
+        next->credit_held = HG_FALSE;
+        hg_thread_spin_unlock(&hg_core_addr->credit_lock);
+
+        next->ret = ret;
+        next->op_type = HG_CORE_FORWARD;
+        ret = hg_core_complete((hg_core_handle_t) next);
+        HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not complete handle");
+    }
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_self_cb(const struct hg_core_cb_info *callback_info)
+static hg_bool_t
+hg_core_credit_dequeue(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->info.respond.handle;
-    hg_return_t ret;
-    hg_bool_t completed = HG_TRUE;
-
-    /* First execute response callback */
-    if (hg_core_handle->response_callback) {
-        struct hg_core_cb_info hg_core_cb_info;
+    struct hg_core_private_addr *hg_core_addr =
+        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr;
+    hg_bool_t queued;
 
-        hg_core_cb_info.arg = hg_core_handle->response_arg;
-        hg_core_cb_info.ret = HG_SUCCESS; /* TODO report failure */
-        hg_core_cb_info.type = HG_CB_RESPOND;
-        hg_core_cb_info.info.respond.handle = (hg_core_handle_t) hg_core_handle;
+    if (hg_core_addr == NULL)
+        return HG_FALSE;
 
-        hg_core_handle->response_callback(&hg_core_cb_info);
+    hg_thread_spin_lock(&hg_core_addr->credit_lock);
+    queued = hg_core_handle->credit_queued;
+    if (queued) {
+        HG_QUEUE_REMOVE(&hg_core_addr->credit_queue, hg_core_handle,
+            hg_core_private_handle, credit);
+        hg_core_handle->credit_queued = HG_FALSE;
     }
+    hg_thread_spin_unlock(&hg_core_addr->credit_lock);
 
-    /* Assign forward callback back to handle */
-    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+    return queued;
+}
 
-    /* Increment refcount and push handle back to completion queue */
-    hg_atomic_incr32(&hg_core_handle->ref_count);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_forward_list_add(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_private_addr *hg_core_addr =
+        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr;
 
-    /* Process output */
-    ret = hg_core_process_output(hg_core_handle, &completed, hg_core_complete);
-    HG_CHECK_HG_ERROR(done, ret, "Could not process output");
+    if (hg_core_addr == NULL)
+        return;
 
-    /* Mark as completed */
-    if (completed) {
-        ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
-        HG_CHECK_HG_ERROR(done, ret, "Could not complete operation");
+    hg_thread_spin_lock(&hg_core_addr->credit_lock);
+    if (!hg_core_handle->forward_listed) {
+        HG_LIST_INSERT_HEAD(
+            &hg_core_addr->forward_list, hg_core_handle, target);
+        hg_core_handle->forward_listed = HG_TRUE;
     }
-
-done:
-    return ret;
+    hg_thread_spin_unlock(&hg_core_addr->credit_lock);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_process_self(struct hg_core_private_handle *hg_core_handle)
+static void
+hg_core_forward_list_remove(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_bool_t completed = HG_FALSE;
-    hg_return_t ret = HG_SUCCESS;
-
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_PROCESS;
-
-    /* Process input */
-    ret = hg_core_process_input(hg_core_handle, &completed);
-    HG_CHECK_HG_ERROR(done, ret, "Could not process input");
+    struct hg_core_private_addr *hg_core_addr =
+        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr;
 
-    /* Mark as completed */
-    if (completed) {
-        ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
-        HG_CHECK_HG_ERROR(done, ret, "Could not complete operation");
+    /* May have been removed by a concurrent cancelation of all forwards */
+    hg_thread_spin_lock(&hg_core_addr->credit_lock);
+    if (hg_core_handle->forward_listed) {
+        HG_LIST_REMOVE(hg_core_handle, target);
+        hg_core_handle->forward_listed = HG_FALSE;
     }
-
-done:
-    return ret;
+    hg_thread_spin_unlock(&hg_core_addr->credit_lock);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_process(struct hg_core_private_handle *hg_core_handle)
+static hg_uint16_t
+hg_core_credit_advertise(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_rpc_info *hg_core_rpc_info;
-    hg_return_t ret = HG_SUCCESS;
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_post_pool *hg_core_post_pool =
+        hg_core_context_post_pool(context, hg_core_handle->na_class);
+    hg_uint64_t credits = HG_CORE_HANDLE_CLASS(hg_core_handle)->request_credits;
+    unsigned int pending_count, posted_count;
+
+    pending_count =
+        (unsigned int) hg_atomic_get32(&hg_core_post_pool->pending_count);
+    posted_count = hg_core_post_pool->posted_count;
+
+    /* Throttle origins proportionally once less than a quarter of the
+     * requests remain posted */
+    if (posted_count > 0 && pending_count * 4 < posted_count)
+        credits = credits * pending_count * 4 / posted_count;
+
+    if (credits == 0)
+        credits = 1;
+    else if (credits > UINT16_MAX)
+        credits = UINT16_MAX;
+
+    return (hg_uint16_t) credits;
+}
 
-    /* Retrieve exe function from function map */
-    hg_thread_spin_lock(&HG_CORE_HANDLE_CLASS(hg_core_handle)->func_map_lock);
-    hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(
-        HG_CORE_HANDLE_CLASS(hg_core_handle)->func_map,
-        (hg_hash_table_key_t) &hg_core_handle->core_handle.info.id);
-    hg_thread_spin_unlock(&HG_CORE_HANDLE_CLASS(hg_core_handle)->func_map_lock);
-    if (!hg_core_rpc_info) {
-        HG_LOG_WARNING("Could not find RPC ID in function map");
-        ret = HG_NOENTRY;
-        goto done;
+/*---------------------------------------------------------------------------*/
+static hg_uint64_t
+hg_core_context_load(struct hg_core_private_context *context)
+{
+    struct hg_core_post_pool *post_pools[] = {&context->post_pool,
+#ifdef NA_HAS_SM
+        &context->sm_post_pool
+#endif
+    };
+    hg_uint64_t load = 0;
+    size_t i;
+
+    /* Posted requests that are no longer pending have been received and are
+     * still being processed */
+    for (i = 0; i < sizeof(post_pools) / sizeof(post_pools[0]); i++) {
+        unsigned int pending_count = (unsigned int) hg_atomic_get32(
+            &post_pools[i]->pending_count);
+        unsigned int posted_count = post_pools[i]->posted_count;
+
+        if (posted_count > pending_count)
+            load += posted_count - pending_count;
     }
 
-    HG_CHECK_ERROR(hg_core_rpc_info->rpc_cb == NULL, done, ret, HG_INVALID_ARG,
-        "No RPC callback registered");
-
-    /* Cache RPC info */
-    hg_core_handle->core_handle.rpc_info = hg_core_rpc_info;
-
-    /* Increment ref count here so that a call to HG_Destroy in user's RPC
-     * callback does not free the handle but only schedules its completion */
-    hg_atomic_incr32(&hg_core_handle->ref_count);
-
-    /* Execute RPC callback */
-    ret = hg_core_rpc_info->rpc_cb((hg_core_handle_t) hg_core_handle);
-    HG_CHECK_HG_ERROR(done, ret, "Error while executing RPC callback");
-
-done:
-    return ret;
+    return load;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_complete_na(
-    struct hg_core_private_handle *hg_core_handle, hg_bool_t *completed)
+static hg_uint16_t
+hg_core_load_advertise(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_return_t ret = HG_SUCCESS;
-
-    /* Add handle to completion queue when expected operations have completed */
-    if (hg_atomic_incr32(&hg_core_handle->na_op_completed_count) ==
-            (hg_util_int32_t) hg_core_handle->na_op_count &&
-        *completed) {
-        /* Mark as completed */
-        ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
-        HG_CHECK_HG_ERROR(done, ret, "Could not complete operation");
+    hg_uint64_t load =
+        hg_core_context_load(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
 
-        /* Increment number of entries added to completion queue */
-        *completed = HG_TRUE;
-    } else
-        *completed = HG_FALSE;
+    if (load == 0)
+        load = 1;
+    else if (load > UINT16_MAX)
+        load = UINT16_MAX;
 
-done:
-    return ret;
+    return (hg_uint16_t) load;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_complete(hg_core_handle_t handle)
+static void
+hg_core_timer_expire(struct hg_timer *timer, void *arg)
 {
     struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) handle;
-    struct hg_core_context *context = hg_core_handle->core_handle.info.context;
-    struct hg_completion_entry *hg_completion_entry =
-        &hg_core_handle->hg_completion_entry;
-    hg_return_t ret = HG_SUCCESS;
-    hg_util_int32_t status;
+        (struct hg_core_private_handle *) arg;
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+
+    (void) timer;
+
+    /* Called with timer lock held. Delayed forwards hold their reference
+     * until they complete */
+    if (hg_core_handle->delayed) {
+        hg_atomic_decr32(&context->timer_count);
+        hg_core_handle->delayed = HG_FALSE;
+        hg_core_handle->ext->timer_next = context->timer_delayed;
+        context->timer_delayed = hg_core_handle;
+        return;
+    }
 
-    /* Mark op id as completed before checking for cancelation, also mark the
-     * operation as queued to track when it will be released from the completion
-     * queue. */
-    status = hg_atomic_or32(
-        &hg_core_handle->status, HG_CORE_OP_COMPLETED | HG_CORE_OP_QUEUED);
+    /* Handle has not completed yet so the
+     * reference taken by forward is still held, take another one so that it
+     * remains valid until it is canceled */
+    hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
+    hg_atomic_decr32(&context->timer_count);
+    hg_core_handle->timed_out = HG_TRUE;
+    hg_core_handle->ext->timer_next = context->timer_expired;
+    context->timer_expired = hg_core_handle;
+}
 
-    /* Check for current status before completing */
-    if (status & HG_CORE_OP_CANCELED) {
-        /* If it was canceled while being processed, set callback ret
-         * accordingly */
-        HG_LOG_DEBUG("Handle %p was canceled", hg_core_handle);
-        hg_core_handle->ret = HG_CANCELED;
-    } else if (status & HG_CORE_OP_ERRORED) {
-        /* If it was errored, set callback ret accordingly */
-        HG_LOG_DEBUG("Handle %p is errored", hg_core_handle);
-        hg_core_handle->ret = HG_NA_ERROR;
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_timer_process(
+    struct hg_core_private_context *context, unsigned int *timeout)
+{
+    struct hg_core_private_handle *hg_core_handle, *delayed_handle;
+    hg_uint64_t next;
+
+    hg_thread_spin_lock(&context->timer_lock);
+    hg_timer_wheel_advance(context->timer_wheel, hg_core_time_ms());
+    next = hg_timer_wheel_next(context->timer_wheel);
+    hg_core_handle = context->timer_expired;
+    context->timer_expired = NULL;
+    delayed_handle = context->timer_delayed;
+    context->timer_delayed = NULL;
+    hg_thread_spin_unlock(&context->timer_lock);
+
+    if (next < *timeout)
+        *timeout = (unsigned int) next;
+
+    /* Send outside of the lock as well */
+    while (delayed_handle) {
+        struct hg_core_private_handle *next_handle =
+            delayed_handle->ext->timer_next;
+
+        HG_LOG_DEBUG("Handle (%p) delay expired", delayed_handle);
+        hg_core_forward_delayed(delayed_handle);
+
+        delayed_handle = next_handle;
     }
 
-    hg_completion_entry->op_type = HG_RPC;
-    hg_completion_entry->op_id.hg_core_handle = handle;
+    /* Cancel outside of the lock as it calls into NA */
+    while (hg_core_handle) {
+        struct hg_core_private_handle *next_handle =
+            hg_core_handle->ext->timer_next;
+        hg_return_t ret;
 
-    ret = hg_core_completion_add(
-        context, hg_completion_entry, hg_core_handle->is_self);
-    HG_CHECK_HG_ERROR(
-        done, ret, "Could not add HG completion entry to completion queue");
+        HG_LOG_DEBUG("Handle (%p) timed out", hg_core_handle);
 
-done:
-    return ret;
+        ret = hg_core_cancel(hg_core_handle);
+        HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not cancel handle");
+
+        ret = hg_core_destroy(hg_core_handle);
+        HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not release handle");
+
+        hg_core_handle = next_handle;
+    }
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-hg_core_completion_add(struct hg_core_context *context,
-    struct hg_completion_entry *hg_completion_entry, hg_bool_t self_notify)
+static HG_THREAD_RETURN_TYPE
+hg_core_progress_thread(void *arg)
 {
-    struct hg_core_private_context *private_context =
-        (struct hg_core_private_context *) context;
-    hg_return_t ret = HG_SUCCESS;
-    int rc;
+    struct hg_core_private_context *context =
+        (struct hg_core_private_context *) arg;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+
+    while (!hg_atomic_get32(&context->progress_threads_exit)) {
+        hg_return_t ret =
+            hg_core_progress(context, HG_CORE_PROGRESS_THREAD_TIMEOUT);
+        HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
+            "Could not make progress");
+    }
 
-#ifdef HG_HAS_COLLECT_STATS
-    /* Increment counter */
-    if (hg_completion_entry->op_type == HG_BULK)
-        hg_core_stat_incr(&hg_core_bulk_count_g);
-#endif
+done:
+    return tret;
+}
 
-    rc = hg_atomic_queue_push(
-        private_context->completion_queue, hg_completion_entry);
-    if (rc != HG_UTIL_SUCCESS) {
-        /* Queue is full */
-        hg_thread_mutex_lock(&private_context->completion_queue_mutex);
-        HG_QUEUE_PUSH_TAIL(
-            &private_context->backfill_queue, hg_completion_entry, entry);
-        hg_atomic_incr32(&private_context->backfill_queue_count);
-        hg_thread_mutex_unlock(&private_context->completion_queue_mutex);
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_core_trigger_thread(void *arg)
+{
+    struct hg_core_private_context *context =
+        (struct hg_core_private_context *) arg;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+
+    while (!hg_atomic_get32(&context->progress_threads_exit)) {
+        unsigned int actual_count = 0;
+        hg_return_t ret = hg_core_trigger(context,
+            HG_CORE_PROGRESS_THREAD_TIMEOUT, HG_CORE_TRIGGER_BATCH_SIZE,
+            HG_CORE_TRIGGER_BATCH_SIZE, &actual_count);
+        HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
+            "Could not trigger callbacks");
     }
 
-    /* Callback is pushed to the completion queue when something completes
-     * so wake up anyone waiting in trigger */
-    hg_thread_mutex_lock(&private_context->completion_queue_mutex);
-    hg_thread_cond_signal(&private_context->completion_queue_cond);
-    hg_thread_mutex_unlock(&private_context->completion_queue_mutex);
+done:
+    return tret;
+}
 
-    if (self_notify && private_context->completion_queue_notify > 0) {
-        hg_thread_mutex_lock(&private_context->completion_queue_notify_mutex);
-        /* Do not bother notifying if it's not needed as any event call will
-         * increase latency */
-        if (hg_atomic_get32(&private_context->completion_queue_must_notify)) {
-            rc = hg_event_set(private_context->completion_queue_notify);
-            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_FAULT,
-                "Could not signal completion queue");
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_progress_threads_start(
+    struct hg_core_private_context *context, unsigned int thread_count)
+{
+    na_int32_t numa_node =
+        NA_Get_numa_node(context->core_context.core_class->na_class);
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    /* One poller plus trigger threads */
+    context->progress_threads =
+        (hg_thread_t *) malloc((thread_count + 1) * sizeof(hg_thread_t));
+    HG_CHECK_ERROR(context->progress_threads == NULL, done, ret, HG_NOMEM,
+        "Could not allocate progress threads");
+    hg_atomic_set32(&context->progress_threads_exit, 0);
+
+    for (i = 0; i <= thread_count; i++) {
+        int rc = hg_thread_create(&context->progress_threads[i],
+            (i == 0) ? hg_core_progress_thread : hg_core_trigger_thread,
+            context);
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+            "Could not create progress thread");
+        context->progress_thread_count++;
+
+        /* Keep threads on the node of the NA resources they progress */
+        if (numa_node >= 0) {
+            hg_cpu_set_t cpu_mask;
+
+            rc = hg_thread_get_numa_cpus((int) numa_node, &cpu_mask);
+            if (rc == HG_UTIL_SUCCESS)
+                rc = hg_thread_setaffinity(
+                    context->progress_threads[i], &cpu_mask);
+            HG_CHECK_WARNING(rc != HG_UTIL_SUCCESS,
+                "Could not bind progress thread to NUMA node %d",
+                (int) numa_node);
         }
-        hg_thread_mutex_unlock(&private_context->completion_queue_notify_mutex);
     }
 
 done:
     return ret;
+
+error:
+    hg_core_progress_threads_stop(context);
+
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_progress(struct hg_core_private_context *context, unsigned int timeout)
+hg_core_progress_threads_stop(struct hg_core_private_context *context)
 {
-    double remaining =
-        timeout / 1000.0; /* Convert timeout in ms into seconds */
-    hg_return_t ret;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
 
-    do {
-        hg_time_t t1, t2;
-        hg_bool_t safe_wait = HG_FALSE, progressed = HG_FALSE;
-        unsigned int poll_timeout = 0;
+    if (context->progress_threads == NULL)
+        goto done;
 
-        if (timeout)
-            hg_time_get_current_ms(&t1);
+    /* Threads check for exit at least every HG_CORE_PROGRESS_THREAD_TIMEOUT,
+     * wake up trigger threads right away */
+    hg_atomic_set32(&context->progress_threads_exit, 1);
+    hg_thread_mutex_lock(&context->completion_queue_mutex);
+    hg_thread_cond_broadcast(&context->completion_queue_cond);
+    hg_thread_mutex_unlock(&context->completion_queue_mutex);
 
-        /* Bypass notifications if timeout is 0 to prevent system calls */
-        if (context->poll_set && timeout) {
-            hg_thread_mutex_lock(&context->completion_queue_notify_mutex);
+    for (i = 0; i < context->progress_thread_count; i++) {
+        int rc = hg_thread_join(context->progress_threads[i]);
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_PROTOCOL_ERROR,
+            "Could not join progress thread");
+    }
 
-            if (hg_core_poll_try_wait(context)) {
-                safe_wait = HG_TRUE;
-                poll_timeout = (unsigned int) (remaining * 1000.0);
+    free(context->progress_threads);
+    context->progress_threads = NULL;
+    context->progress_thread_count = 0;
 
-                /* We need to be notified when doing blocking progress */
-                hg_atomic_set32(&context->completion_queue_must_notify, 1);
-            }
-            hg_thread_mutex_unlock(&context->completion_queue_notify_mutex);
-        } else if (!HG_CORE_CONTEXT_CLASS(context)->loopback && timeout &&
-                   hg_core_poll_try_wait(context)) {
-            /* This is the case for NA plugins that don't expose a fd */
-            poll_timeout = (unsigned int) (remaining * 1000.0);
-        }
+done:
+    return ret;
+}
 
-        /* Only enter blocking wait if it is safe to */
-        if (safe_wait) {
-            ret = hg_core_poll_wait(context, poll_timeout, &progressed);
-            HG_CHECK_HG_ERROR(
-                error, ret, "Could not make blocking progress on context");
-        } else {
-            ret = hg_core_poll(context, poll_timeout, &progressed);
-            HG_CHECK_HG_ERROR(
-                error, ret, "Could not make non-blocking progress on context");
-        }
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_poll_spin_update(struct hg_core_private_context *context,
+    hg_bool_t spinning, hg_bool_t progressed)
+{
+    if (progressed) {
+        /* Busy polling paid off, poll longer next time */
+        if (spinning && context->poll_spin_max < HG_CORE_POLL_SPIN_MAX)
+            context->poll_spin_max *= 2;
+        else if (context->poll_spin_max < HG_CORE_POLL_SPIN_MIN)
+            context->poll_spin_max = HG_CORE_POLL_SPIN_MIN;
+        context->poll_spin_count = context->poll_spin_max;
+    } else if (spinning && context->poll_spin_count == 0 &&
+               context->poll_spin_max > HG_CORE_POLL_SPIN_MIN) {
+        /* Busy polling was wasted, next blocking wait comes sooner */
+        context->poll_spin_max /= 2;
+    }
+}
 
-        /* We progressed or we have something to trigger */
-        if (progressed ||
-            !hg_atomic_queue_is_empty(context->completion_queue) ||
-            (hg_atomic_get32(&context->backfill_queue_count) > 0))
-            return HG_SUCCESS;
+/*---------------------------------------------------------------------------*/
+#ifdef NA_HAS_SM
+static HG_INLINE hg_bool_t
+hg_core_poll_sm_check(struct hg_core_private_context *context)
+{
+    /* SM operations were posted since last poll */
+    if (hg_atomic_get32(&context->sm_active)) {
+        hg_atomic_set32(&context->sm_active, 0);
+        context->sm_idle_count = 0;
+        return HG_TRUE;
+    }
 
-        if (timeout) {
-            hg_time_get_current_ms(&t2);
-            remaining -= hg_time_diff(t2, t1);
-        }
-    } while ((int) (remaining * 1000.0) > 0);
+    if (context->sm_idle_count < HG_CORE_SM_IDLE_THRESHOLD)
+        return HG_TRUE;
 
-    return HG_TIMEOUT;
+    /* Rail is idle, only look for new peers from time to time */
+    if (++context->sm_idle_count <
+        HG_CORE_SM_IDLE_THRESHOLD + HG_CORE_SM_IDLE_INTERVAL)
+        return HG_FALSE;
+    context->sm_idle_count = HG_CORE_SM_IDLE_THRESHOLD;
 
-error:
-    return ret;
+    return HG_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_poll_sm_update(
+    struct hg_core_private_context *context, hg_bool_t progressed)
+{
+    if (progressed)
+        context->sm_idle_count = 0;
+    else if (context->sm_idle_count < HG_CORE_SM_IDLE_THRESHOLD)
+        context->sm_idle_count++;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_poll_sm_wake(
+    struct hg_core_private_context *context, na_class_t *na_class)
+{
+    if (na_class == HG_CORE_CONTEXT_CLASS(context)->core_class.na_sm_class &&
+        !hg_atomic_get32(&context->sm_active))
+        hg_atomic_set32(&context->sm_active, 1);
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_bool_t
 hg_core_poll_try_wait(struct hg_core_private_context *context)
 {
-    /* Something is in one of the completion queues */
-    if (!hg_atomic_queue_is_empty(context->completion_queue) ||
-        (hg_atomic_get32(&context->backfill_queue_count) > 0))
+    unsigned int i;
+
+    /* Something is in the completion queue */
+    if (!hg_core_completion_queue_is_empty(context))
+        return HG_FALSE;
+
+    /* New batches of coalesced messages must be sent */
+    if (hg_atomic_get32(&context->coalesce_pending))
         return HG_FALSE;
 
 #ifdef NA_HAS_SM
@@ -3733,6 +9564,12 @@ hg_core_poll_try_wait(struct hg_core_private_context *context)
             context->core_context.na_context))
         return HG_FALSE;
 
+    for (i = 0; i < context->core_context.core_class->na_rail_count; i++)
+        if (!NA_Poll_try_wait(
+                context->core_context.core_class->na_rail_classes[i],
+                context->core_context.na_rail_contexts[i]))
+            return HG_FALSE;
+
     return HG_TRUE;
 }
 
@@ -3768,6 +9605,11 @@ hg_core_poll_wait(struct hg_core_private_context *context, unsigned int timeout,
         switch (context->poll_events[i].data.u32) {
             case HG_CORE_POLL_LOOPBACK:
                 HG_LOG_DEBUG("HG_CORE_POLL_LOOPBACK event");
+                if (context->poll_events[i].events & HG_POLLEVENT) {
+                    /* Notification was already consumed */
+                    progressed_event = HG_TRUE;
+                    break;
+                }
                 ret = hg_core_progress_loopback_notify(
                     context, &progressed_event);
                 HG_CHECK_HG_ERROR(
@@ -3778,25 +9620,40 @@ hg_core_poll_wait(struct hg_core_private_context *context, unsigned int timeout,
                 HG_LOG_DEBUG("HG_CORE_POLL_SM event");
 
                 /* TODO force epoll_wait */
-                ret = hg_core_progress_na(
+                ret = hg_core_progress_na(context,
                     HG_CORE_CONTEXT_CLASS(context)->core_class.na_sm_class,
                     context->core_context.na_sm_context, 0, &progressed_event);
                 HG_CHECK_HG_ERROR(done, ret, "hg_core_progress_na() failed");
+                context->sm_idle_count = 0;
                 break;
 #endif
             case HG_CORE_POLL_NA:
                 HG_LOG_DEBUG("HG_CORE_POLL_NA event");
 
                 /* TODO force epoll_wait */
-                ret = hg_core_progress_na(
+                ret = hg_core_progress_na(context,
                     HG_CORE_CONTEXT_CLASS(context)->core_class.na_class,
                     context->core_context.na_context, 0, &progressed_event);
                 HG_CHECK_HG_ERROR(done, ret, "hg_core_progress_na() failed");
                 break;
-            default:
-                HG_GOTO_ERROR(done, ret, HG_INVALID_ARG,
-                    "Invalid type of poll event (%d)",
+            default: {
+                struct hg_core_class *core_class =
+                    &HG_CORE_CONTEXT_CLASS(context)->core_class;
+                /* Values below HG_CORE_POLL_RAIL wrap around */
+                hg_util_uint32_t rail =
+                    context->poll_events[i].data.u32 - HG_CORE_POLL_RAIL;
+
+                HG_CHECK_ERROR(rail >= core_class->na_rail_count, done, ret,
+                    HG_INVALID_ARG, "Invalid type of poll event (%d)",
                     (int) context->poll_events[i].data.u32);
+                HG_LOG_DEBUG("HG_CORE_POLL_RAIL event (rail %u)", rail);
+
+                ret = hg_core_progress_na(context,
+                    core_class->na_rail_classes[rail],
+                    context->core_context.na_rail_contexts[rail], 0,
+                    &progressed_event);
+                HG_CHECK_HG_ERROR(done, ret, "hg_core_progress_na() failed");
+            }
         }
         progressed |= progressed_event;
     }
@@ -3813,16 +9670,28 @@ hg_core_poll(struct hg_core_private_context *context, unsigned int timeout,
     hg_bool_t *progressed_ptr)
 {
     hg_bool_t progressed = HG_FALSE, progressed_na = HG_FALSE;
-    unsigned int progress_timeout;
+    unsigned int progress_timeout, i;
     hg_return_t ret;
 
 #ifdef NA_HAS_SM
-    /* Poll over SM first if set */
+    /* Poll over SM first if set, an idle SM rail is not progressed on every
+     * pass so that remote traffic does not pay for it, its completions are
+     * still triggered */
     if (context->core_context.na_sm_context) {
-        ret = hg_core_progress_na(
-            HG_CORE_CONTEXT_CLASS(context)->core_class.na_sm_class,
-            context->core_context.na_sm_context, 0, &progressed_na);
-        HG_CHECK_HG_ERROR(done, ret, "hg_core_progress_na() failed");
+        if (hg_core_poll_sm_check(context)) {
+            ret = hg_core_progress_na(context,
+                HG_CORE_CONTEXT_CLASS(context)->core_class.na_sm_class,
+                context->core_context.na_sm_context, 0, &progressed_na);
+            HG_CHECK_HG_ERROR(done, ret, "hg_core_progress_na() failed");
+            hg_core_poll_sm_update(context, progressed_na);
+        } else {
+            unsigned int count = 0;
+
+            ret = hg_core_trigger_na(
+                context->core_context.na_sm_context, &count);
+            HG_CHECK_HG_ERROR(done, ret, "hg_core_trigger_na() failed");
+            progressed_na = (hg_bool_t) (count > 0);
+        }
 
         progressed |= progressed_na;
 
@@ -3834,10 +9703,22 @@ hg_core_poll(struct hg_core_private_context *context, unsigned int timeout,
     }
 #endif
 
+    /* Poll over rails */
+    for (i = 0; i < HG_CORE_CONTEXT_CLASS(context)->core_class.na_rail_count;
+         i++) {
+        ret = hg_core_progress_na(context,
+            HG_CORE_CONTEXT_CLASS(context)->core_class.na_rail_classes[i],
+            context->core_context.na_rail_contexts[i], 0, &progressed_na);
+        HG_CHECK_HG_ERROR(done, ret, "hg_core_progress_na() failed");
+
+        progressed |= progressed_na;
+        progress_timeout = 0;
+    }
+
     /* Poll over defaut NA */
-    ret =
-        hg_core_progress_na(HG_CORE_CONTEXT_CLASS(context)->core_class.na_class,
-            context->core_context.na_context, progress_timeout, &progressed_na);
+    ret = hg_core_progress_na(context,
+        HG_CORE_CONTEXT_CLASS(context)->core_class.na_class,
+        context->core_context.na_context, progress_timeout, &progressed_na);
     HG_CHECK_HG_ERROR(done, ret, "hg_core_progress_na() failed");
 
     *progressed_ptr = progressed | progressed_na;
@@ -3848,53 +9729,81 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_progress_na(na_class_t *na_class, na_context_t *na_context,
-    unsigned int timeout, hg_bool_t *progressed_ptr)
+hg_core_trigger_na(na_context_t *na_context, unsigned int *count_ptr)
+{
+    unsigned int actual_count = 0, count = 0;
+    hg_return_t ret = HG_SUCCESS;
+    na_return_t na_ret;
+
+    /* Trigger everything we can from NA, if something completed it will
+     * be moved to the HG context completion queue */
+    do {
+        int cb_ret[HG_CORE_MAX_TRIGGER_COUNT] = {0};
+        unsigned int i;
+
+        na_ret = NA_Trigger(
+            na_context, 0, HG_CORE_MAX_TRIGGER_COUNT, cb_ret, &actual_count);
+
+        /* Return value of callback is completion count */
+        for (i = 0; i < actual_count; i++)
+            count += (unsigned int) cb_ret[i];
+    } while ((na_ret == NA_SUCCESS) && actual_count);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT, done, ret,
+        (hg_return_t) na_ret, "Could not trigger NA callback (%s)",
+        NA_Error_to_string(na_ret));
+
+    *count_ptr = count;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_progress_na(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context, unsigned int timeout,
+    hg_bool_t *progressed_ptr)
 {
     double remaining =
         timeout / 1000.0; /* Convert timeout in ms into seconds */
-    unsigned int completed_count = 0;
+    unsigned int completed_count = 0, harvest_count = 0;
     hg_bool_t progressed = HG_FALSE;
     hg_return_t ret = HG_SUCCESS;
 
     do {
-        unsigned int actual_count = 0;
+        unsigned int count = 0, progress_timeout;
         na_return_t na_ret;
         hg_time_t t1, t2;
 
         if (timeout)
             hg_time_get_current_ms(&t1);
 
-        /* Trigger everything we can from NA, if something completed it will
-         * be moved to the HG context completion queue */
-        do {
-            int cb_ret[HG_CORE_MAX_TRIGGER_COUNT] = {0};
-            unsigned int i;
-
-            na_ret = NA_Trigger(na_context, 0, HG_CORE_MAX_TRIGGER_COUNT,
-                cb_ret, &actual_count);
+        ret = hg_core_trigger_na(na_context, &count);
+        HG_CHECK_HG_ERROR(done, ret, "hg_core_trigger_na() failed");
 
-            /* Return value of callback is completion count */
-            for (i = 0; i < actual_count; i++)
-                completed_count += (unsigned int) cb_ret[i];
-        } while ((na_ret == NA_SUCCESS) && actual_count);
-        HG_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT, done, ret,
-            (hg_return_t) na_ret, "Could not trigger NA callback (%s)",
-            NA_Error_to_string(na_ret));
+        /* Completions that NA added directly to the HG completion queue */
+        if (HG_CORE_CONTEXT_CLASS(context)->integrated_completion &&
+            !hg_core_completion_queue_is_empty(context))
+            count++;
+        completed_count += count;
 
-        /* Progressed */
         if (completed_count) {
+            /* Progressed, keep harvesting completions that are already
+             * available (without blocking) until none is left or we reach
+             * HG_CORE_MAX_EVENTS */
             progressed = HG_TRUE;
-            break;
+            if (!count || ++harvest_count >= HG_CORE_MAX_EVENTS)
+                break;
+            progress_timeout = 0;
+        } else {
+            /* Make sure that timeout of 0 enters progress */
+            if (timeout && ((int) (remaining * 1000.0) <= 0))
+                break;
+            progress_timeout = (unsigned int) (remaining * 1000.0);
         }
 
-        /* Make sure that timeout of 0 enters progress */
-        if (timeout && ((int) (remaining * 1000.0) <= 0))
-            break;
-
         /* Otherwise try to make progress on NA */
-        na_ret = NA_Progress(
-            na_class, na_context, (unsigned int) (remaining * 1000.0));
+        na_ret = NA_Progress(na_class, na_context, progress_timeout);
         if (na_ret == NA_TIMEOUT)
             break;
         else
@@ -3935,7 +9844,8 @@ done:
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_core_trigger(struct hg_core_private_context *context, unsigned int timeout,
-    unsigned int max_count, unsigned int *actual_count)
+    unsigned int max_count, unsigned int batch_size,
+    unsigned int *actual_count)
 {
     double remaining =
         timeout / 1000.0; /* Convert timeout in ms into seconds */
@@ -3943,98 +9853,160 @@ hg_core_trigger(struct hg_core_private_context *context, unsigned int timeout,
     hg_return_t ret = HG_SUCCESS;
 
     while (count < max_count) {
-        struct hg_completion_entry *hg_completion_entry = NULL;
+        struct hg_completion_entry
+            *hg_completion_entries[HG_CORE_TRIGGER_BATCH_SIZE];
+        unsigned int i, n;
 
-        hg_completion_entry = hg_atomic_queue_pop_mc(context->completion_queue);
-        if (!hg_completion_entry) {
-            /* Check backfill queue */
-            if (hg_atomic_get32(&context->backfill_queue_count)) {
-                hg_thread_mutex_lock(&context->completion_queue_mutex);
-                hg_completion_entry = HG_QUEUE_FIRST(&context->backfill_queue);
-                HG_QUEUE_POP_HEAD(&context->backfill_queue, entry);
-                hg_atomic_decr32(&context->backfill_queue_count);
-                hg_thread_mutex_unlock(&context->completion_queue_mutex);
-                if (!hg_completion_entry)
-                    continue; /* Give another change to grab it */
-            } else {
-                hg_time_t t1, t2;
+        n = max_count - count;
+        if (n > batch_size)
+            n = batch_size;
+        n = hg_core_completion_pop(
+            context, (void **) hg_completion_entries, n);
 
-                /* If something was already processed leave */
-                if (count)
-                    break;
+        if (n == 0) {
+            hg_time_t t1, t2;
 
-                /* Timeout is 0 so leave */
-                if ((int) (remaining * 1000.0) <= 0) {
-                    ret = HG_TIMEOUT;
-                    break;
-                }
+            /* If something was already processed leave */
+            if (count)
+                break;
+
+            /* Timeout is 0 so leave */
+            if ((int) (remaining * 1000.0) <= 0) {
+                ret = HG_TIMEOUT;
+                break;
+            }
 
-                hg_time_get_current_ms(&t1);
+            hg_time_get_current_ms(&t1);
 
-                hg_thread_mutex_lock(&context->completion_queue_mutex);
+            /* Mutex/cond are only used to block when there is nothing to
+             * trigger */
+            hg_thread_mutex_lock(&context->completion_queue_mutex);
+
+            /* Register before checking the queue so that pushes see us (see
+             * hg_core_completion_push()) */
+            hg_atomic_incr32(&context->trigger_waiters);
+            hg_atomic_fence();
+
+            /* Otherwise wait remaining ms */
+            if (hg_core_completion_queue_is_empty(context) &&
+                (hg_thread_cond_timedwait(&context->completion_queue_cond,
+                     &context->completion_queue_mutex,
+                     (unsigned int) (remaining * 1000.0)) !=
+                    HG_UTIL_SUCCESS)) {
+                /* Timeout occurred so leave */
+                ret = HG_TIMEOUT;
+            }
 
-                /* Otherwise wait remaining ms */
-                if (hg_atomic_queue_is_empty(context->completion_queue) &&
-                    !hg_atomic_get32(&context->backfill_queue_count) &&
-                    (hg_thread_cond_timedwait(&context->completion_queue_cond,
-                         &context->completion_queue_mutex,
-                         (unsigned int) (remaining * 1000.0)) !=
-                        HG_UTIL_SUCCESS)) {
-                    /* Timeout occurred so leave */
-                    ret = HG_TIMEOUT;
-                }
+            hg_atomic_decr32(&context->trigger_waiters);
+            hg_thread_mutex_unlock(&context->completion_queue_mutex);
+            if (ret == HG_TIMEOUT)
+                break;
 
-                hg_thread_mutex_unlock(&context->completion_queue_mutex);
-                if (ret == HG_TIMEOUT)
-                    break;
+            hg_time_get_current_ms(&t2);
+            remaining -= hg_time_diff(t2, t1);
+            continue; /* Give another change to grab it */
+        }
 
-                hg_time_get_current_ms(&t2);
-                remaining -= hg_time_diff(t2, t1);
-                continue; /* Give another change to grab it */
+        /* Entries that were dequeued must all be triggered, keep first error
+         * only. Operations that callbacks post (e.g., responses) are submitted
+         * together */
+        if (n > 1)
+            (void) NA_Op_batch_begin(context->core_context.core_class->na_class,
+                context->core_context.na_context);
+        for (i = 0; i < n; i++) {
+            struct hg_completion_entry *hg_completion_entry =
+                hg_completion_entries[i];
+            hg_return_t trigger_ret;
+
+            /* NA completion, trigger the HG entry that it completes (if any)
+             * right away */
+            if ((uintptr_t) hg_completion_entry & HG_CORE_NA_ENTRY) {
+                hg_completion_entry =
+                    hg_core_trigger_na_entry(context, hg_completion_entry);
+                if (hg_completion_entry == NULL)
+                    continue;
             }
+
+            trigger_ret = hg_core_trigger_completion_entry(hg_completion_entry);
+            if (trigger_ret != HG_SUCCESS && ret == HG_SUCCESS)
+                ret = trigger_ret;
         }
+        if (n > 1)
+            (void) NA_Op_batch_end(context->core_context.core_class->na_class,
+                context->core_context.na_context);
+        count += n;
+        HG_CHECK_HG_ERROR(done, ret, "Could not trigger completion entries");
+    }
+
+    if (actual_count)
+        *actual_count = count;
 
-        /* Completion queue should not be empty now */
-        HG_CHECK_ERROR(hg_completion_entry == NULL, done, ret, HG_FAULT,
-            "NULL completion entry");
+done:
+    return ret;
+}
 
-        /* Trigger entry */
-        switch (hg_completion_entry->op_type) {
-            case HG_ADDR:
-                ret = hg_core_trigger_lookup_entry(
-                    hg_completion_entry->op_id.hg_core_op_id);
-                HG_CHECK_HG_ERROR(
-                    done, ret, "Could not trigger addr completion entry");
-                break;
-            case HG_RPC:
-                ret = hg_core_trigger_entry(
-                    (struct hg_core_private_handle *)
-                        hg_completion_entry->op_id.hg_core_handle);
-                HG_CHECK_HG_ERROR(
-                    done, ret, "Could not trigger RPC completion entry");
-                break;
-            case HG_BULK:
-                ret = hg_bulk_trigger_entry(
-                    hg_completion_entry->op_id.hg_bulk_op_id);
-                HG_CHECK_HG_ERROR(
-                    done, ret, "Could not trigger bulk completion entry");
-                break;
-            default:
-                HG_GOTO_ERROR(done, ret, HG_INVALID_ARG,
-                    "Invalid type of completion entry (%d)",
-                    (int) hg_completion_entry->op_type);
-        }
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_trigger_completion_entry(
+    struct hg_completion_entry *hg_completion_entry)
+{
+    hg_return_t ret = HG_SUCCESS;
 
-        count++;
-    }
+    /* Completion queue should not be empty now */
+    HG_CHECK_ERROR(hg_completion_entry == NULL, done, ret, HG_FAULT,
+        "NULL completion entry");
 
-    if (actual_count)
-        *actual_count = count;
+    /* Trigger entry */
+    switch (hg_completion_entry->op_type) {
+        case HG_ADDR:
+            ret = hg_core_trigger_lookup_entry(
+                hg_completion_entry->op_id.hg_core_op_id);
+            HG_CHECK_HG_ERROR(
+                done, ret, "Could not trigger addr completion entry");
+            break;
+        case HG_RPC:
+            ret = hg_core_trigger_entry(
+                (struct hg_core_private_handle *)
+                    hg_completion_entry->op_id.hg_core_handle);
+            HG_CHECK_HG_ERROR(
+                done, ret, "Could not trigger RPC completion entry");
+            break;
+        case HG_BULK:
+            ret = hg_bulk_trigger_entry(
+                hg_completion_entry->op_id.hg_bulk_op_id);
+            HG_CHECK_HG_ERROR(
+                done, ret, "Could not trigger bulk completion entry");
+            break;
+        default:
+            HG_GOTO_ERROR(done, ret, HG_INVALID_ARG,
+                "Invalid type of completion entry (%d)",
+                (int) hg_completion_entry->op_type);
+    }
 
 done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static struct hg_completion_entry *
+hg_core_trigger_na_entry(
+    struct hg_core_private_context *context, void *na_completion_entry)
+{
+    hg_thread_key_t key = HG_CORE_CONTEXT_CLASS(context)->trigger_slot_key;
+    struct hg_core_trigger_slot slot = {
+        .context = context, .hg_completion_entry = NULL};
+    void *prev_slot = hg_thread_getspecific(key);
+
+    /* Execute NA callbacks, the HG entry that they complete (if any) is
+     * stored into the slot rather than added to the completion queue */
+    hg_thread_setspecific(key, &slot);
+    (void) NA_Trigger_completion(
+        (void *) ((uintptr_t) na_completion_entry & ~HG_CORE_NA_ENTRY));
+    hg_thread_setspecific(key, prev_slot);
+
+    return slot.hg_completion_entry;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id)
@@ -4067,6 +10039,9 @@ hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle)
     hg_return_t ret = HG_SUCCESS;
 
     hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_QUEUED);
+    hg_core_trace(hg_core_handle, HG_TRACE_TRIGGER, 0);
+    HG_PROBE3(mercury, trigger, hg_core_handle,
+        hg_core_handle->core_handle.info.id, hg_core_handle->op_type);
 
     if (hg_core_handle->op_type == HG_CORE_PROCESS) {
 
@@ -4076,13 +10051,13 @@ hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle)
 
         /* Take another reference to make sure the handle only gets freed
          * after the response is sent */
-        hg_atomic_incr32(&hg_core_handle->ref_count);
+        hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
 
         /* Run RPC callback */
         ret = hg_core_process(hg_core_handle);
         if (ret != HG_SUCCESS && !hg_core_handle->no_response) {
             hg_size_t header_size =
-                hg_core_header_response_get_size() +
+                hg_core_handle->core_handle.out_header_size +
                 hg_core_handle->core_handle.na_out_header_offset;
 
             /* Respond in case of error */
@@ -4105,6 +10080,9 @@ hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle)
             case HG_CORE_FORWARD_SELF:
                 HG_FALLTHROUGH();
             case HG_CORE_FORWARD:
+                hg_core_latency_forward(hg_core_handle);
+                hg_core_hook(hg_core_handle, HG_HOOK_FORWARD_COMPLETE,
+                    hg_core_handle->out_buf_used, hg_core_handle->ret);
                 hg_cb = hg_core_handle->request_callback;
                 hg_core_cb_info.arg = hg_core_handle->request_arg;
                 hg_core_cb_info.type = HG_CB_FORWARD;
@@ -4125,6 +10103,23 @@ hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle)
                 hg_core_cb_info.info.respond.handle =
                     (hg_core_handle_t) hg_core_handle;
                 break;
+            case HG_CORE_FORWARD_CHUNK:
+                hg_cb = hg_core_handle->ext
+                            ? hg_core_handle->ext->chunk_callback
+                            : NULL;
+                hg_core_cb_info.arg =
+                    hg_core_handle->ext ? hg_core_handle->ext->chunk_arg : NULL;
+                hg_core_cb_info.type = HG_CB_FORWARD;
+                hg_core_cb_info.info.forward.handle =
+                    (hg_core_handle_t) hg_core_handle;
+                break;
+            case HG_CORE_RESPOND_CHUNK:
+                hg_cb = hg_core_handle->response_callback;
+                hg_core_cb_info.arg = hg_core_handle->response_arg;
+                hg_core_cb_info.type = HG_CB_RESPOND;
+                hg_core_cb_info.info.respond.handle =
+                    (hg_core_handle_t) hg_core_handle;
+                break;
             case HG_CORE_NO_RESPOND:
                 /* Nothing */
                 break;
@@ -4139,6 +10134,12 @@ hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle)
          * the user may carry the handle in the callback. */
         if (hg_cb)
             hg_cb(&hg_core_cb_info);
+
+        /* Chunk has been consumed, let the target send the next message */
+        if (hg_core_handle->op_type == HG_CORE_FORWARD_CHUNK) {
+            ret = hg_core_chunk_ack(hg_core_handle);
+            HG_CHECK_HG_ERROR(done, ret, "Could not ack response chunk");
+        }
     }
 
 done:
@@ -4164,6 +10165,16 @@ hg_core_cancel(struct hg_core_private_handle *hg_core_handle)
     if ((status & HG_CORE_OP_COMPLETED) || (status & HG_CORE_OP_ERRORED))
         goto done;
 
+    /* Nothing was posted yet if forward is still waiting for its delay or for
+     * a credit */
+    if (hg_core_timer_undelay(hg_core_handle) ||
+        hg_core_credit_dequeue(hg_core_handle)) {
+        hg_core_handle->op_type = HG_CORE_FORWARD;
+        ret = hg_core_complete((hg_core_handle_t) hg_core_handle);
+        HG_CHECK_HG_ERROR(done, ret, "Could not complete handle");
+        goto done;
+    }
+
     /* Cancel all NA operations issued */
     if (hg_core_handle->na_recv_op_id != NULL) {
         na_return_t na_ret = NA_Cancel(hg_core_handle->na_class,
@@ -4179,9 +10190,9 @@ hg_core_cancel(struct hg_core_private_handle *hg_core_handle)
             "Could not cancel send op id (%s)", NA_Error_to_string(na_ret));
     }
 
-    if (hg_core_handle->na_ack_op_id != NULL) {
+    if (hg_core_handle->ext && hg_core_handle->ext->na_ack_op_id != NULL) {
         na_return_t na_ret = NA_Cancel(hg_core_handle->na_class,
-            hg_core_handle->na_context, hg_core_handle->na_ack_op_id);
+            hg_core_handle->na_context, hg_core_handle->ext->na_ack_op_id);
         HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
             "Could not cancel ack op id (%s)", NA_Error_to_string(na_ret));
     }
@@ -4270,6 +10281,149 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_class_set_hooks(
+    hg_core_class_t *hg_core_class, const struct hg_core_hooks *hooks)
+{
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_ERROR(hooks && hooks->trace_ctx_size > HG_HOOK_TRACE_CTX_MAX,
+        done, ret, HG_INVALID_ARG, "Trace context size exceeds maximum (%d)",
+        HG_HOOK_TRACE_CTX_MAX);
+
+    if (hooks)
+        private_class->hooks = *hooks;
+    else
+        memset(&private_class->hooks, 0, sizeof(struct hg_core_hooks));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_class_get_stats(hg_core_class_t *hg_core_class,
+    struct hg_class_stats *stats, struct hg_rpc_stats *rpc_stats,
+    hg_uint32_t *rpc_count)
+{
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
+
+    if (stats) {
+        stats->forward_count =
+            hg_core_stats_get(private_class->stats, HG_CORE_STAT_FORWARD);
+        stats->handle_count =
+            hg_core_stats_get(private_class->stats, HG_CORE_STAT_HANDLE);
+        stats->extra_count =
+            hg_core_stats_get(private_class->stats, HG_CORE_STAT_EXTRA);
+        stats->bytes_in =
+            hg_core_stats_get(private_class->stats, HG_CORE_STAT_BYTES_IN);
+        stats->bytes_out =
+            hg_core_stats_get(private_class->stats, HG_CORE_STAT_BYTES_OUT);
+        stats->bulk_count =
+            hg_core_stats_get(private_class->stats, HG_CORE_STAT_BULK);
+        stats->reject_count =
+            hg_core_stats_get(private_class->stats, HG_CORE_STAT_REJECT);
+    }
+
+    if (rpc_count) {
+        struct hg_core_func_map *hg_core_func_map;
+        hg_uint32_t max_count = rpc_stats ? *rpc_count : 0, count = 0;
+        unsigned int i;
+
+        /* Writer lock prevents RPC info from being freed while reading */
+        hg_thread_spin_lock(&private_class->func_map_lock);
+        hg_core_func_map = (struct hg_core_func_map *) hg_atomic_get64(
+            &private_class->func_map);
+        for (i = 0; i <= hg_core_func_map->mask; i++) {
+            struct hg_core_func_map_entry *entry =
+                &hg_core_func_map->entries[i];
+            struct hg_core_rpc_info *hg_core_rpc_info =
+                (struct hg_core_rpc_info *) hg_atomic_get64(&entry->rpc_info);
+            struct hg_rpc_stats *rpc_stat;
+
+            if (!hg_core_rpc_info)
+                continue;
+            if (count++ >= max_count)
+                continue;
+
+            rpc_stat = &rpc_stats[count - 1];
+            rpc_stat->id = entry->id;
+            rpc_stat->forward_count = hg_core_stats_get(
+                hg_core_rpc_info->stats, HG_CORE_STAT_FORWARD);
+            rpc_stat->handle_count = hg_core_stats_get(
+                hg_core_rpc_info->stats, HG_CORE_STAT_HANDLE);
+            rpc_stat->extra_count = hg_core_stats_get(
+                hg_core_rpc_info->stats, HG_CORE_STAT_EXTRA);
+            rpc_stat->bytes_in = hg_core_stats_get(
+                hg_core_rpc_info->stats, HG_CORE_STAT_BYTES_IN);
+            rpc_stat->bytes_out = hg_core_stats_get(
+                hg_core_rpc_info->stats, HG_CORE_STAT_BYTES_OUT);
+            rpc_stat->reject_count = hg_core_stats_get(
+                hg_core_rpc_info->stats, HG_CORE_STAT_REJECT);
+        }
+        hg_thread_spin_unlock(&private_class->func_map_lock);
+
+        *rpc_count = count;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_class_get_latency(hg_core_class_t *hg_core_class, hg_id_t id,
+    hg_latency_stage_t stage, struct hg_latency_stats *stats)
+{
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_rpc_info *hg_core_rpc_info;
+    struct hg_histogram *histogram;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_ERROR(stage >= HG_LATENCY_MAX, done, ret, HG_INVALID_ARG,
+        "Invalid latency stage (%d)", (int) stage);
+    HG_CHECK_ERROR(stats == NULL, done, ret, HG_INVALID_ARG, "NULL stats");
+    HG_CHECK_ERROR(!private_class->latency_stats, done, ret, HG_OPNOTSUPPORTED,
+        "Latency stats were not enabled (see hg_init_info.latency_stats)");
+
+    /* Writer lock prevents RPC info from being freed while reading */
+    hg_thread_spin_lock(&private_class->func_map_lock);
+    hg_core_rpc_info = hg_core_func_map_lookup(private_class, id);
+    if (!hg_core_rpc_info) {
+        hg_thread_spin_unlock(&private_class->func_map_lock);
+        HG_GOTO_ERROR(done, ret, HG_NOENTRY,
+            "Could not find RPC ID (%llu) in function map",
+            (unsigned long long) id);
+    }
+
+    histogram = &hg_core_rpc_info->stats->latency[stage];
+    stats->count = hg_histogram_count(histogram);
+    stats->min = hg_histogram_min(histogram);
+    stats->max = hg_histogram_max(histogram);
+    stats->mean = (hg_uint64_t) hg_histogram_mean(histogram);
+    stats->p50 = hg_histogram_percentile(histogram, 50.0);
+    stats->p90 = hg_histogram_percentile(histogram, 90.0);
+    stats->p99 = hg_histogram_percentile(histogram, 99.0);
+    stats->p999 = hg_histogram_percentile(histogram, 99.9);
+    hg_thread_spin_unlock(&private_class->func_map_lock);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_core_context_t *
 HG_Core_context_create(hg_core_class_t *hg_core_class)
@@ -4344,26 +10498,121 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_context_set_progress_threads(
+    hg_core_context_t *context, unsigned int thread_count)
+{
+    struct hg_core_private_context *private_context =
+        (struct hg_core_private_context *) context;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG core context");
+
+    /* Stop current threads if any */
+    ret = hg_core_progress_threads_stop(private_context);
+    HG_CHECK_HG_ERROR(done, ret, "Could not stop progress threads");
+
+    if (thread_count == 0)
+        goto done;
+
+    ret = hg_core_progress_threads_start(private_context, thread_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not start progress threads");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_context_get_stats(
+    hg_core_context_t *context, struct hg_context_stats *stats)
+{
+    struct hg_core_private_context *private_context =
+        (struct hg_core_private_context *) context;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG core context");
+    HG_CHECK_ERROR(stats == NULL, done, ret, HG_INVALID_ARG, "NULL stats");
+
+    stats->completion_count = 0;
+    for (i = 0; i < HG_PRIORITY_MAX; i++)
+        stats->completion_count += hg_atomic_seg_queue_count(
+            private_context->completion_queues[i]);
+
+    stats->handle_count =
+        (hg_uint32_t) hg_atomic_get32(&private_context->n_handles);
+
+    hg_thread_spin_lock(&private_context->handle_pool_lock);
+    stats->handle_pool_count = private_context->handle_pool_count;
+    hg_thread_spin_unlock(&private_context->handle_pool_lock);
+
+    hg_thread_spin_lock(&private_context->pending_list_lock);
+    stats->posted_count = private_context->post_pool.posted_count;
+    stats->pending_count = (hg_uint32_t) hg_atomic_get32(
+        &private_context->post_pool.pending_count);
+#ifdef NA_HAS_SM
+    stats->posted_count += private_context->sm_post_pool.posted_count;
+    stats->pending_count += (hg_uint32_t) hg_atomic_get32(
+        &private_context->sm_post_pool.pending_count);
+#endif
+    hg_thread_spin_unlock(&private_context->pending_list_lock);
+
+    stats->timer_count =
+        (hg_uint32_t) hg_atomic_get32(&private_context->timer_count);
+
+    for (i = 0; i < HG_MEM_USE_MAX; i++)
+        stats->mem_bytes[i] =
+            (hg_uint64_t) hg_atomic_get64(&private_context->mem_bytes[i]);
+    stats->mem_throttle_count =
+        (hg_uint32_t) hg_atomic_get32(&private_context->mem_throttle_count);
+    stats->alloc_fallback_count =
+        (hg_uint32_t) hg_atomic_get32(&private_context->alloc_fallback_count);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_context_post(hg_core_context_t *context)
 {
+    struct hg_core_private_class *hg_core_class;
     hg_return_t ret = HG_SUCCESS;
     hg_bool_t posted = HG_FALSE;
-    unsigned int request_count;
+    unsigned int request_count, na_request_count;
 
     HG_CHECK_ERROR(
         context == NULL, error, ret, HG_INVALID_ARG, "NULL HG core context");
+    hg_core_class = (struct hg_core_private_class *) context->core_class;
 
     /* Get request count from init info */
-    request_count = ((struct hg_core_private_class *) context->core_class)
-                        ->request_post_init;
+    request_count = hg_core_class->request_post_init;
     HG_CHECK_ERROR(request_count == 0, error, ret, HG_INVALID_ARG,
         "Request count must be greater than 0");
-    HG_LOG_DEBUG("Posting %u requests on context (%p)", request_count, context);
+
+    /* Idle contexts only hold a base set of requests, more are posted as
+     * they get used */
+    if (hg_core_class->request_post_lazy &&
+        request_count > HG_CORE_POST_LAZY_INIT)
+        request_count = HG_CORE_POST_LAZY_INIT;
+
+    /* Requests posted on one context may serve any other context, split them
+     * so that the total number of posted requests remains the same */
+    na_request_count = request_count;
+    if (hg_core_class->request_post_shared > 1) {
+        na_request_count /= hg_core_class->request_post_shared;
+        if (na_request_count == 0)
+            na_request_count = 1;
+    }
+    HG_LOG_DEBUG(
+        "Posting %u requests on context (%p)", na_request_count, context);
 
     ret = hg_core_context_post((struct hg_core_private_context *) context,
-        context->core_class->na_class, context->na_context, request_count);
+        context->core_class->na_class, context->na_context, na_request_count);
     HG_CHECK_HG_ERROR(error, ret, "Could not post requests on context");
     posted = HG_TRUE;
 
@@ -4394,54 +10643,53 @@ HG_Core_register(
 {
     struct hg_core_private_class *private_class =
         (struct hg_core_private_class *) hg_core_class;
-    hg_id_t *func_key = NULL;
     struct hg_core_rpc_info *hg_core_rpc_info = NULL;
     hg_return_t ret = HG_SUCCESS;
-    int hash_ret;
 
     HG_CHECK_ERROR(hg_core_class == NULL, error, ret, HG_INVALID_ARG,
         "NULL HG core class");
 
-    // TODO use RW lock
-
     /* Check if registered and set RPC CB */
     hg_thread_spin_lock(&private_class->func_map_lock);
-    hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(
-        private_class->func_map, (hg_hash_table_key_t) &id);
+    hg_core_rpc_info = hg_core_func_map_lookup(private_class, id);
     if (hg_core_rpc_info && rpc_cb)
         hg_core_rpc_info->rpc_cb = rpc_cb;
     hg_thread_spin_unlock(&private_class->func_map_lock);
 
     if (!hg_core_rpc_info) {
-        /* Allocate the key */
-        func_key = (hg_id_t *) malloc(sizeof(hg_id_t));
-        HG_CHECK_ERROR(func_key == NULL, error, ret, HG_NOMEM,
-            "Could not allocate ID key");
-        *func_key = id;
-
         /* Fill info and store it into the function map */
         hg_core_rpc_info =
             (struct hg_core_rpc_info *) malloc(sizeof(struct hg_core_rpc_info));
         HG_CHECK_ERROR(hg_core_rpc_info == NULL, error, ret, HG_NOMEM,
             "Could not allocate HG info");
 
+        hg_core_rpc_info->id = id;
+        hg_core_rpc_info->index = 0;
         hg_core_rpc_info->rpc_cb = rpc_cb;
         hg_core_rpc_info->data = NULL;
         hg_core_rpc_info->free_callback = NULL;
+        hg_core_rpc_info->priority = HG_PRIORITY_NORMAL;
+        hg_core_rpc_info->stats =
+            hg_core_stats_alloc(private_class->latency_stats);
+        HG_CHECK_ERROR(hg_core_rpc_info->stats == NULL, error, ret, HG_NOMEM,
+            "Could not allocate RPC stat counters");
 
         hg_thread_spin_lock(&private_class->func_map_lock);
-        hash_ret = hg_hash_table_insert(private_class->func_map,
-            (hg_hash_table_key_t) func_key, hg_core_rpc_info);
+        ret = hg_core_func_map_insert(private_class, id, hg_core_rpc_info);
+        if (ret == HG_SUCCESS)
+            hg_core_rpc_table_insert(private_class, hg_core_rpc_info);
         hg_thread_spin_unlock(&private_class->func_map_lock);
-        HG_CHECK_ERROR(hash_ret == 0, error, ret, HG_INVALID_ARG,
+        HG_CHECK_HG_ERROR(error, ret,
             "Could not insert RPC ID into function map (already registered?)");
     }
 
     return ret;
 
 error:
-    free(func_key);
-    free(hg_core_rpc_info);
+    if (hg_core_rpc_info) {
+        hg_core_stats_free(hg_core_rpc_info->stats);
+        free(hg_core_rpc_info);
+    }
 
     return ret;
 }
@@ -4452,19 +10700,22 @@ HG_Core_deregister(hg_core_class_t *hg_core_class, hg_id_t id)
 {
     struct hg_core_private_class *private_class =
         (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_rpc_info *hg_core_rpc_info;
     hg_return_t ret = HG_SUCCESS;
-    int hash_ret;
 
     HG_CHECK_ERROR(
         hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
 
     hg_thread_spin_lock(&private_class->func_map_lock);
-    hash_ret = hg_hash_table_remove(
-        private_class->func_map, (hg_hash_table_key_t) &id);
+    hg_core_rpc_info = hg_core_func_map_remove(private_class, id);
+    if (hg_core_rpc_info)
+        hg_core_rpc_table_remove(private_class, hg_core_rpc_info);
     hg_thread_spin_unlock(&private_class->func_map_lock);
-    HG_CHECK_ERROR(hash_ret == 0, done, ret, HG_NOENTRY,
+    HG_CHECK_ERROR(hg_core_rpc_info == NULL, done, ret, HG_NOENTRY,
         "Could not deregister RPC ID from function map");
 
+    hg_core_rpc_info_free(hg_core_rpc_info);
+
 done:
     return ret;
 }
@@ -4481,10 +10732,7 @@ HG_Core_registered(hg_core_class_t *hg_core_class, hg_id_t id, hg_bool_t *flag)
         hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
     HG_CHECK_ERROR(flag == NULL, done, ret, HG_INVALID_ARG, "NULL flag");
 
-    hg_thread_spin_lock(&private_class->func_map_lock);
-    *flag = (hg_bool_t)(hg_hash_table_lookup(private_class->func_map,
-                            (hg_hash_table_key_t) &id) != HG_HASH_TABLE_NULL);
-    hg_thread_spin_unlock(&private_class->func_map_lock);
+    *flag = (hg_bool_t)(hg_core_func_map_lookup(private_class, id) != NULL);
 
 done:
     return ret;
@@ -4503,10 +10751,7 @@ HG_Core_register_data(hg_core_class_t *hg_core_class, hg_id_t id, void *data,
     HG_CHECK_ERROR(
         hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
 
-    hg_thread_spin_lock(&private_class->func_map_lock);
-    hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(
-        private_class->func_map, (hg_hash_table_key_t) &id);
-    hg_thread_spin_unlock(&private_class->func_map_lock);
+    hg_core_rpc_info = hg_core_func_map_lookup(private_class, id);
     HG_CHECK_ERROR(hg_core_rpc_info == NULL, done, ret, HG_NOENTRY,
         "Could not find RPC ID in function map");
 
@@ -4530,10 +10775,7 @@ HG_Core_registered_data(hg_core_class_t *hg_core_class, hg_id_t id)
 
     HG_CHECK_ERROR_NORET(hg_core_class == NULL, done, "NULL HG core class");
 
-    hg_thread_spin_lock(&private_class->func_map_lock);
-    hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(
-        private_class->func_map, (hg_hash_table_key_t) &id);
-    hg_thread_spin_unlock(&private_class->func_map_lock);
+    hg_core_rpc_info = hg_core_func_map_lookup(private_class, id);
     HG_CHECK_ERROR_NORET(hg_core_rpc_info == NULL, done,
         "Could not find RPC ID in function map");
 
@@ -4543,6 +10785,56 @@ done:
     return data;
 }
 
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_registered_set_priority(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_priority_t priority)
+{
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_rpc_info *hg_core_rpc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_ERROR((unsigned int) priority >= HG_PRIORITY_MAX, done, ret,
+        HG_INVALID_ARG, "Invalid priority (%d)", (int) priority);
+
+    hg_core_rpc_info = hg_core_func_map_lookup(private_class, id);
+    HG_CHECK_ERROR(hg_core_rpc_info == NULL, done, ret, HG_NOENTRY,
+        "Could not find RPC ID in function map");
+
+    hg_core_rpc_info->priority = priority;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_registered_priority(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_priority_t *priority)
+{
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_rpc_info *hg_core_rpc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_ERROR(priority == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to priority");
+
+    hg_core_rpc_info = hg_core_func_map_lookup(private_class, id);
+    HG_CHECK_ERROR(hg_core_rpc_info == NULL, done, ret, HG_NOENTRY,
+        "Could not find RPC ID in function map");
+
+    *priority = hg_core_rpc_info->priority;
+
+done:
+    return ret;
+}
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_addr_lookup1(hg_core_context_t *context, hg_core_cb_t callback,
@@ -4626,6 +10918,31 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_lookup_batch(hg_core_class_t *hg_core_class,
+    const char *const names[], hg_size_t count, hg_core_addr_t addrs[])
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_ERROR(
+        names == NULL, done, ret, HG_INVALID_ARG, "NULL array of names");
+    HG_CHECK_ERROR(
+        addrs == NULL, done, ret, HG_INVALID_ARG, "NULL array of addresses");
+
+    HG_LOG_DEBUG("Looking up %zu addresses", (size_t) count);
+
+    ret = hg_core_addr_lookup_batch(
+        (struct hg_core_private_class *) hg_core_class, names, count,
+        (struct hg_core_private_addr **) addrs);
+    HG_CHECK_HG_ERROR(done, ret, "Could not lookup addresses");
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_addr_free(hg_core_addr_t addr)
@@ -4647,11 +10964,113 @@ HG_Core_addr_set_remove(hg_core_addr_t addr)
 {
     hg_return_t ret = HG_SUCCESS;
 
-    HG_CHECK_ERROR(addr == HG_CORE_ADDR_NULL, done, ret, HG_INVALID_ARG,
-        "NULL HG core address");
+    HG_CHECK_ERROR(addr == HG_CORE_ADDR_NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core address");
+
+    ret = hg_core_addr_set_remove((struct hg_core_private_addr *) addr);
+    HG_CHECK_HG_ERROR(done, ret, "Could not set address to be removed");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_cancel_all(hg_core_addr_t addr, hg_bool_t remove)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(addr == HG_CORE_ADDR_NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core address");
+
+    ret = hg_core_addr_cancel_all((struct hg_core_private_addr *) addr, remove);
+    HG_CHECK_HG_ERROR(done, ret, "Could not cancel forwards to address");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_warmup(const hg_core_addr_t addrs[], hg_size_t count)
+{
+    hg_size_t i;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(addrs == NULL && count > 0, done, ret, HG_INVALID_ARG,
+        "NULL array of addresses");
+
+    HG_LOG_DEBUG("Warming up %zu addresses", (size_t) count);
+
+    for (i = 0; i < count; i++) {
+        if (addrs[i] == HG_CORE_ADDR_NULL)
+            continue;
+        ret = hg_core_addr_warmup((struct hg_core_private_addr *) addrs[i]);
+        HG_CHECK_HG_ERROR(
+            done, ret, "Could not warm up address %zu", (size_t) i);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_get_load(hg_core_addr_t addr, hg_uint32_t *load)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        addr == HG_CORE_ADDR_NULL, done, ret, HG_INVALID_ARG, "NULL addr");
+    HG_CHECK_ERROR(load == NULL, done, ret, HG_INVALID_ARG, "NULL load");
+
+    *load = (hg_uint32_t) hg_atomic_get32(
+        &((struct hg_core_private_addr *) addr)->load);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_select(hg_core_class_t *hg_core_class,
+    const hg_core_addr_t addrs[], hg_size_t count, hg_core_addr_t *addr)
+{
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_private_addr *first, *second;
+    hg_util_uint32_t x;
+    hg_size_t i, j;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_ERROR(
+        addrs == NULL || count == 0, done, ret, HG_INVALID_ARG, "No addresses");
+    HG_CHECK_ERROR(addr == NULL, done, ret, HG_INVALID_ARG, "NULL addr");
 
-    ret = hg_core_addr_set_remove((struct hg_core_private_addr *) addr);
-    HG_CHECK_HG_ERROR(done, ret, "Could not set address to be removed");
+    if (count == 1) {
+        *addr = addrs[0];
+        goto done;
+    }
+
+    /* Mix a shared counter so that concurrent callers sample different
+     * pairs of distinct targets */
+    x = (hg_util_uint32_t) hg_atomic_incr32(&private_class->select_seed) *
+        0x9e3779b9;
+    x ^= x >> 16;
+    x *= 0x85ebca6b;
+    x ^= x >> 13;
+    i = x % count;
+    j = (i + 1 + (x / count) % (count - 1)) % count;
+
+    /* Power of two choices, targets that never advertised a load are
+     * considered idle */
+    first = (struct hg_core_private_addr *) addrs[i];
+    second = (struct hg_core_private_addr *) addrs[j];
+    *addr = (hg_atomic_get32(&second->load) < hg_atomic_get32(&first->load))
+                ? addrs[j]
+                : addrs[i];
 
 done:
     return ret;
@@ -4809,6 +11228,84 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_size_t
+HG_Core_addr_get_serialize_batch_size(
+    const hg_core_addr_t addrs[], hg_size_t count)
+{
+    hg_size_t i, ret = 0;
+
+    HG_CHECK_ERROR_NORET(
+        addrs == NULL || count == 0, done, "NULL array of addresses");
+    for (i = 0; i < count; i++)
+        HG_CHECK_ERROR_NORET(addrs[i] == HG_CORE_ADDR_NULL, done,
+            "NULL HG core address at index %zu", (size_t) i);
+
+    ret = hg_core_addr_get_serialize_batch_size(
+        (struct hg_core_private_addr *const *) addrs, count);
+
+    HG_LOG_DEBUG("Serialize size is %zu bytes for %zu addresses", ret,
+        (size_t) count);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_serialize_batch(void *buf, hg_size_t buf_size,
+    const hg_core_addr_t addrs[], hg_size_t count)
+{
+    hg_size_t i;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        buf == NULL, done, ret, HG_INVALID_ARG, "NULL pointer to buffer");
+    HG_CHECK_ERROR(
+        buf_size == 0, done, ret, HG_INVALID_ARG, "NULL buffer size");
+    HG_CHECK_ERROR(addrs == NULL || count == 0, done, ret, HG_INVALID_ARG,
+        "NULL array of addresses");
+    for (i = 0; i < count; i++)
+        HG_CHECK_ERROR(addrs[i] == HG_CORE_ADDR_NULL, done, ret,
+            HG_INVALID_ARG, "NULL HG core address at index %zu", (size_t) i);
+
+    HG_LOG_DEBUG("Serializing %zu addresses", (size_t) count);
+
+    ret = hg_core_addr_serialize_batch(
+        buf, buf_size, (struct hg_core_private_addr *const *) addrs, count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not serialize addresses");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_deserialize_batch(hg_core_class_t *hg_core_class, const void *buf,
+    hg_size_t buf_size, hg_core_addr_t addrs[], hg_size_t *count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        hg_core_class == NULL, done, ret, HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_ERROR(
+        buf == NULL, done, ret, HG_INVALID_ARG, "NULL pointer to buffer");
+    HG_CHECK_ERROR(
+        buf_size == 0, done, ret, HG_INVALID_ARG, "NULL buffer size");
+    HG_CHECK_ERROR(
+        count == NULL, done, ret, HG_INVALID_ARG, "NULL pointer to count");
+
+    ret = hg_core_addr_deserialize_batch(
+        (struct hg_core_private_class *) hg_core_class, buf, buf_size,
+        (struct hg_core_private_addr **) addrs, count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not deserialize addresses");
+
+    HG_LOG_DEBUG("Deserialized %zu addresses", (size_t) *count);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_create(hg_core_context_t *context, hg_core_addr_t addr, hg_id_t id,
@@ -4972,7 +11469,7 @@ HG_Core_ref_incr(hg_core_handle_t handle)
 
     HG_CHECK_ERROR(hg_core_handle == NULL, done, ret, HG_INVALID_ARG,
         "NULL HG core handle");
-    hg_atomic_incr32(&hg_core_handle->ref_count);
+    hg_atomic_incr32_relaxed(&hg_core_handle->ref_count);
 
 done:
     return ret;
@@ -4994,6 +11491,53 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_get_input_payload_size(hg_core_handle_t handle, hg_size_t *payload_size)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
+    hg_size_t header_offset;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handle == HG_CORE_HANDLE_NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core handle");
+    HG_CHECK_ERROR(payload_size == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to payload size");
+
+    header_offset = handle->in_header_size + handle->na_in_header_offset;
+    *payload_size = (hg_core_handle->in_buf_used > header_offset)
+                        ? hg_core_handle->in_buf_used - header_offset
+                        : 0;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_get_output_payload_size(
+    hg_core_handle_t handle, hg_size_t *payload_size)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
+    hg_size_t header_offset;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handle == HG_CORE_HANDLE_NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core handle");
+    HG_CHECK_ERROR(payload_size == NULL, done, ret, HG_INVALID_ARG,
+        "NULL pointer to payload size");
+
+    header_offset = handle->out_header_size + handle->na_out_header_offset;
+    *payload_size = (hg_core_handle->out_buf_used > header_offset)
+                        ? hg_core_handle->out_buf_used - header_offset
+                        : 0;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_forward(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
@@ -5012,13 +11556,206 @@ HG_Core_forward(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
         "Forwarding handle (%p), payload size is %zu", handle, payload_size);
 
     ret = hg_core_forward((struct hg_core_private_handle *) handle, callback,
-        arg, flags, payload_size);
+        arg, flags, payload_size, 0, 0);
+    HG_CHECK_HG_ERROR(done, ret, "Could not forward handle");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_forward_timed(hg_core_handle_t handle, hg_core_cb_t callback,
+    void *arg, hg_uint8_t flags, hg_size_t payload_size, unsigned int timeout)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handle == HG_CORE_HANDLE_NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core handle");
+    HG_CHECK_ERROR(handle->info.addr == HG_CORE_ADDR_NULL, done, ret,
+        HG_INVALID_ARG, "NULL target addr");
+    HG_CHECK_ERROR(
+        handle->info.id == 0, done, ret, HG_INVALID_ARG, "NULL RPC ID");
+
+    HG_LOG_DEBUG("Forwarding handle (%p), payload size is %zu, timeout is %u",
+        handle, payload_size, timeout);
+
+    ret = hg_core_forward((struct hg_core_private_handle *) handle, callback,
+        arg, flags, payload_size, timeout, 0);
+    HG_CHECK_HG_ERROR(done, ret, "Could not forward handle");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_forward_delayed(hg_core_handle_t handle, hg_core_cb_t callback,
+    void *arg, hg_uint8_t flags, hg_size_t payload_size, unsigned int delay)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handle == HG_CORE_HANDLE_NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core handle");
+    HG_CHECK_ERROR(handle->info.addr == HG_CORE_ADDR_NULL, done, ret,
+        HG_INVALID_ARG, "NULL target addr");
+    HG_CHECK_ERROR(
+        handle->info.id == 0, done, ret, HG_INVALID_ARG, "NULL RPC ID");
+
+    HG_LOG_DEBUG("Forwarding handle (%p), payload size is %zu, delay is %u",
+        handle, payload_size, delay);
+
+    ret = hg_core_forward((struct hg_core_private_handle *) handle, callback,
+        arg, flags, payload_size, 0, delay);
     HG_CHECK_HG_ERROR(done, ret, "Could not forward handle");
 
 done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_forward_batch(hg_core_handle_t *handles, unsigned int count,
+    hg_core_cb_t callback, void **args, const hg_uint8_t *flags,
+    const hg_size_t *payload_sizes, unsigned int *posted_ptr)
+{
+    struct hg_core_private_context *context = NULL;
+    unsigned int i, posted = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handles == NULL || args == NULL || flags == NULL ||
+                       payload_sizes == NULL,
+        done, ret, HG_INVALID_ARG, "NULL batch arrays");
+    for (i = 0; i < count; i++) {
+        HG_CHECK_ERROR(handles[i] == HG_CORE_HANDLE_NULL, done, ret,
+            HG_INVALID_ARG, "NULL HG core handle");
+        HG_CHECK_ERROR(handles[i]->info.addr == HG_CORE_ADDR_NULL, done, ret,
+            HG_INVALID_ARG, "NULL target addr");
+        HG_CHECK_ERROR(
+            handles[i]->info.id == 0, done, ret, HG_INVALID_ARG, "NULL RPC ID");
+        HG_CHECK_ERROR(handles[i]->info.context != handles[0]->info.context,
+            done, ret, HG_INVALID_ARG,
+            "Batched handles must share the same context");
+    }
+    if (count == 0)
+        goto done;
+    context = (struct hg_core_private_context *) handles[0]->info.context;
+
+    HG_LOG_DEBUG("Forwarding batch of %u handles", count);
+
+    /* Reserve tags of the batch at once, forwards that do not go through NA
+     * or that keep their tag do not need one and handles still in use get
+     * theirs when forwarded (if they can be) */
+    hg_thread_spin_lock(&context->request_tag_lock);
+    for (i = 0; i < count; i++) {
+        struct hg_core_private_handle *hg_core_handle =
+            (struct hg_core_private_handle *) handles[i];
+        hg_util_int32_t status = hg_atomic_get32(&hg_core_handle->status);
+
+        if (hg_core_handle->is_self || hg_core_handle->tag_reserved ||
+            !(status & HG_CORE_OP_COMPLETED) ||
+            (status & (HG_CORE_OP_QUEUED | HG_CORE_OP_CANCELED)))
+            continue;
+        hg_core_handle->tag = hg_core_gen_request_tag_locked(context);
+        hg_core_handle->tag_batched = HG_TRUE;
+    }
+    hg_thread_spin_unlock(&context->request_tag_lock);
+
+    hg_core_op_batch_begin(context);
+    for (i = 0; i < count; i++) {
+        ret = hg_core_forward((struct hg_core_private_handle *) handles[i],
+            callback, args[i], flags[i], payload_sizes[i], 0, 0);
+        if (ret != HG_SUCCESS)
+            break;
+        posted++;
+    }
+    hg_core_op_batch_end(context);
+
+    /* Tags of handles that were not forwarded are not used */
+    for (i = posted; i < count; i++)
+        ((struct hg_core_private_handle *) handles[i])->tag_batched = HG_FALSE;
+    HG_CHECK_HG_ERROR(
+        done, ret, "Could not forward handle %u of batch", posted);
+
+done:
+    if (posted_ptr)
+        *posted_ptr = posted;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_forward_init(hg_core_handle_t handle)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handle == HG_CORE_HANDLE_NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core handle");
+    HG_CHECK_ERROR(handle->info.addr == HG_CORE_ADDR_NULL, done, ret,
+        HG_INVALID_ARG, "NULL target addr");
+    HG_CHECK_ERROR(
+        handle->info.id == 0, done, ret, HG_INVALID_ARG, "NULL RPC ID");
+    HG_CHECK_ERROR(!(hg_atomic_get32(&hg_core_handle->status) &
+                       HG_CORE_OP_COMPLETED),
+        done, ret, HG_BUSY, "Attempting to use handle that was not completed");
+
+    HG_LOG_DEBUG("Making handle (%p) persistent", handle);
+
+    /* Tag and header are set by the first forward */
+    hg_core_handle->persistent = HG_TRUE;
+    hg_core_handle->tag_reserved = HG_FALSE;
+    hg_core_handle->header_encoded = HG_FALSE;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_set_chunk_callback(
+    hg_core_handle_t handle, hg_core_cb_t callback, void *arg)
+{
+    struct hg_core_handle_ext *ext;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handle == HG_CORE_HANDLE_NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core handle");
+
+    ext = hg_core_ext_get((struct hg_core_private_handle *) handle);
+    HG_CHECK_ERROR(
+        ext == NULL, done, ret, HG_NOMEM, "Could not allocate handle ext");
+
+    ext->chunk_callback = callback;
+    ext->chunk_arg = arg;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_respond_chunk(hg_core_handle_t handle, hg_core_cb_t callback,
+    void *arg, hg_size_t payload_size)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handle == HG_CORE_HANDLE_NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core handle");
+
+    HG_LOG_DEBUG("Sending response chunk on handle (%p), payload size is %zu",
+        handle, payload_size);
+
+    ret = hg_core_respond_chunk((struct hg_core_private_handle *) handle,
+        callback, arg, payload_size);
+    HG_CHECK_HG_ERROR(done, ret, "Could not send response chunk");
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_respond(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
@@ -5041,6 +11778,51 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_respond_batch(hg_core_handle_t *handles, unsigned int count,
+    hg_core_cb_t callback, void **args, const hg_uint8_t *flags,
+    const hg_size_t *payload_sizes, unsigned int *posted_ptr)
+{
+    struct hg_core_private_context *context = NULL;
+    unsigned int i, posted = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(handles == NULL || args == NULL || flags == NULL ||
+                       payload_sizes == NULL,
+        done, ret, HG_INVALID_ARG, "NULL batch arrays");
+    for (i = 0; i < count; i++) {
+        HG_CHECK_ERROR(handles[i] == HG_CORE_HANDLE_NULL, done, ret,
+            HG_INVALID_ARG, "NULL HG core handle");
+        HG_CHECK_ERROR(handles[i]->info.context != handles[0]->info.context,
+            done, ret, HG_INVALID_ARG,
+            "Batched handles must share the same context");
+    }
+    if (count == 0)
+        goto done;
+    context = (struct hg_core_private_context *) handles[0]->info.context;
+
+    HG_LOG_DEBUG("Responding on batch of %u handles", count);
+
+    hg_core_op_batch_begin(context);
+    for (i = 0; i < count; i++) {
+        ret = hg_core_respond((struct hg_core_private_handle *) handles[i],
+            callback, args[i], flags[i], payload_sizes[i], HG_SUCCESS);
+        if (ret != HG_SUCCESS)
+            break;
+        posted++;
+    }
+    hg_core_op_batch_end(context);
+    HG_CHECK_HG_ERROR(done, ret, "Could not respond on handle %u of batch",
+        posted);
+
+done:
+    if (posted_ptr)
+        *posted_ptr = posted;
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_progress(hg_core_context_t *context, unsigned int timeout)
@@ -5061,6 +11843,45 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+int
+HG_Core_context_get_fd(const hg_core_context_t *context)
+{
+    const struct hg_core_private_context *private_context =
+        (const struct hg_core_private_context *) context;
+
+    HG_CHECK_ERROR_NORET(context == NULL, error, "NULL HG core context");
+    HG_CHECK_ERROR_NORET(private_context->poll_set == NULL, error,
+        "Context does not expose a fd (NA plugin has no fd or progress mode "
+        "is NA_NO_BLOCK)");
+
+    return hg_poll_get_fd(private_context->poll_set);
+
+error:
+    return -1;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_context_process_ready(
+    hg_core_context_t *context, unsigned int *timeout_ptr)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG core context");
+    HG_CHECK_ERROR(
+        timeout_ptr == NULL, done, ret, HG_INVALID_ARG, "NULL timeout pointer");
+
+    ret = hg_core_process_ready(
+        (struct hg_core_private_context *) context, timeout_ptr);
+    HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_AGAIN, done,
+        "Could not make progress");
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_trigger(hg_core_context_t *context, unsigned int timeout,
@@ -5072,7 +11893,26 @@ HG_Core_trigger(hg_core_context_t *context, unsigned int timeout,
         context == NULL, done, ret, HG_INVALID_ARG, "NULL HG core context");
 
     ret = hg_core_trigger((struct hg_core_private_context *) context, timeout,
-        max_count, actual_count);
+        max_count, 1, actual_count);
+    HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
+        "Could not trigger callbacks");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_trigger_batch(hg_core_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(
+        context == NULL, done, ret, HG_INVALID_ARG, "NULL HG core context");
+
+    ret = hg_core_trigger((struct hg_core_private_context *) context, timeout,
+        max_count, HG_CORE_TRIGGER_BATCH_SIZE, actual_count);
     HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
         "Could not trigger callbacks");
 
@@ -64,6 +64,33 @@ typedef hg_return_t (*hg_core_rpc_cb_t)(hg_core_handle_t handle);
 typedef hg_return_t (*hg_core_cb_t)(
     const struct hg_core_cb_info *callback_info);
 
+/* Event passed to instrumentation hooks */
+struct hg_core_hook_info {
+    hg_core_context_t *context; /* HG core context */
+    hg_core_handle_t handle;    /* HG handle (NULL for bulk/retry events) */
+    void *op_id;                /* Bulk op ID (bulk events only) */
+    hg_id_t id;                 /* RPC ID (0 if none) */
+    hg_size_t size;             /* Byte count (0 if none) */
+    hg_return_t ret;            /* Return code of completion events */
+    int op;                     /* Bulk op or retried NA op type */
+    void *trace_ctx;            /* Trace context of request (NULL if none) */
+    hg_size_t trace_ctx_size;   /* Size of trace context */
+};
+
+/* Instrumentation hook callback */
+typedef void (*hg_core_hook_cb_t)(
+    void *arg, hg_hook_type_t type, const struct hg_core_hook_info *info);
+
+/* Instrumentation hooks, events with a NULL callback are not reported */
+struct hg_core_hooks {
+    hg_core_hook_cb_t callbacks[HG_HOOK_MAX]; /* Callback per event type */
+    void *arg;                                /* Argument of callbacks */
+    /* Size of trace context that origins fill in on HG_HOOK_FORWARD and that
+     * targets receive with request events (compact headers only, at most
+     * HG_HOOK_TRACE_CTX_MAX, 0 if none) */
+    hg_size_t trace_ctx_size;
+};
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -209,6 +236,40 @@ static HG_INLINE na_class_t *
 HG_Core_class_get_na_sm(const hg_core_class_t *hg_core_class);
 #endif
 
+/**
+ * Obtain the number of NA rails (see hg_init_info.na_rails).
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ *
+ * \return Number of rails
+ */
+static HG_INLINE unsigned int
+HG_Core_class_get_na_rail_count(const hg_core_class_t *hg_core_class);
+
+/**
+ * Obtain the underlying NA class of a rail.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param index [IN]            rail index
+ *
+ * \return Pointer to NA class or NULL if not a valid rail
+ */
+static HG_INLINE na_class_t *
+HG_Core_class_get_na_rail(
+    const hg_core_class_t *hg_core_class, unsigned int index);
+
+/**
+ * Obtain the NA self address of a rail.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param index [IN]            rail index
+ *
+ * \return NA address or NA_ADDR_NULL if not a valid rail
+ */
+static HG_INLINE na_addr_t
+HG_Core_class_get_na_rail_self(
+    const hg_core_class_t *hg_core_class, unsigned int index);
+
 /**
  * Obtain the maximum eager size for sending RPC inputs.
  *
@@ -255,6 +316,66 @@ HG_Core_class_set_data(
 static HG_INLINE void *
 HG_Core_class_get_data(const hg_core_class_t *hg_core_class);
 
+/**
+ * Set instrumentation hooks of a given class, which external profilers and
+ * tracing systems can use to follow RPCs through their internal events.
+ * Events are reported synchronously from the thread where they occur and
+ * callbacks must not block. On HG_HOOK_FORWARD, origins can write up to
+ * hooks->trace_ctx_size bytes to info->trace_ctx, which are carried in the
+ * request header and passed to request events of the target so that
+ * distributed traces connect across processes (compact headers only). Hooks
+ * must be set before contexts and handles are created, passing NULL removes
+ * them.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param hooks [IN]            pointer to hooks (copied, may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_class_set_hooks(
+    hg_core_class_t *hg_core_class, const struct hg_core_hooks *hooks);
+
+/**
+ * Retrieve statistics of a given class. Counters are always collected and
+ * sharded across threads so that updating them does not require any
+ * synchronization between threads, they can be read at any time.
+ * When \rpc_count is not NULL, it must point to the number of entries of
+ * \rpc_stats on input and is set on output to the number of registered RPCs
+ * (at most that many entries of \rpc_stats are filled).
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param stats [OUT]           pointer to class stats (may be NULL)
+ * \param rpc_stats [OUT]       array of RPC stats (may be NULL)
+ * \param rpc_count [IN/OUT]    pointer to number of RPC stats (may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_class_get_stats(hg_core_class_t *hg_core_class,
+    struct hg_class_stats *stats, struct hg_rpc_stats *rpc_stats,
+    hg_uint32_t *rpc_count);
+
+/**
+ * Retrieve a latency summary of stage \stage of RPC \id. Latencies are
+ * recorded into log-linear histograms (relative precision of 12.5%) when the
+ * class is initialized with hg_init_info.latency_stats. Origin stages
+ * separate the time spent before the request is sent, waiting for the
+ * response and waiting for the callback to be triggered, target stages
+ * separate the time spent waiting for the handler to be dispatched and the
+ * time spent in the handler until it responds.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               registered function ID
+ * \param stage [IN]            latency stage
+ * \param stats [OUT]           pointer to latency summary
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_class_get_latency(hg_core_class_t *hg_core_class, hg_id_t id,
+    hg_latency_stage_t stage, struct hg_latency_stats *stats);
+
 /**
  * Create a new context. Must be destroyed by calling HG_Core_context_destroy().
  *
@@ -321,6 +442,18 @@ static HG_INLINE na_context_t *
 HG_Core_context_get_na_sm(const hg_core_context_t *context);
 #endif
 
+/**
+ * Retrieve the underlying NA context of a rail.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param index [IN]            rail index
+ *
+ * \return the associated context or NULL if not a valid rail
+ */
+static HG_INLINE na_context_t *
+HG_Core_context_get_na_rail(
+    const hg_core_context_t *context, unsigned int index);
+
 /**
  * Retrieve context ID from context.
  *
@@ -355,6 +488,18 @@ HG_Core_context_set_data(
 static HG_INLINE void *
 HG_Core_context_get_data(const hg_core_context_t *context);
 
+/**
+ * Retrieve current queue depths and posted buffer levels of a given context.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param stats [OUT]           pointer to context stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_context_get_stats(
+    hg_core_context_t *context, struct hg_context_stats *stats);
+
 /**
  * Set callback to be called on HG core handle creation. Handles are created
  * both on HG_Core_create() and HG_Core_context_post() calls. This allows
@@ -371,6 +516,25 @@ HG_PUBLIC hg_return_t
 HG_Core_context_set_handle_create_callback(hg_core_context_t *context,
     hg_return_t (*callback)(hg_core_handle_t, void *), void *arg);
 
+/**
+ * Start progress threads on context: one thread polls the context and hands
+ * completions to \thread_count threads that trigger them. Callbacks may
+ * therefore be executed concurrently. Threads that are already running are
+ * stopped first, passing a \thread_count of 0 only stops them. Threads are
+ * also stopped when the context is destroyed.
+ *
+ * \remark Concurrent calls to HG_Core_progress() on the same context are
+ * safe, only one thread polls at a time while others wait for completions.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param thread_count [IN]     number of trigger threads
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_context_set_progress_threads(
+    hg_core_context_t *context, unsigned int thread_count);
+
 /**
  * Post requests associated to context in order to receive incoming RPCs.
  * Requests are automatically re-posted after completion until the context is
@@ -453,6 +617,36 @@ HG_Core_register_data(hg_core_class_t *hg_core_class, hg_id_t id, void *data,
 HG_PUBLIC void *
 HG_Core_registered_data(hg_core_class_t *hg_core_class, hg_id_t id);
 
+/**
+ * Set priority of a given RPC ID. Completions of RPCs are queued in one lane
+ * per priority and HG_Core_trigger() executes the callbacks of higher
+ * priority lanes first, while still periodically giving lower priority lanes
+ * a turn. Bulk transfer completions use HG_PRIORITY_NORMAL.
+ * By default, all RPCs have HG_PRIORITY_NORMAL priority.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               registered function ID
+ * \param priority [IN]         priority
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_registered_set_priority(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_priority_t priority);
+
+/**
+ * Get priority of a given RPC ID.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               registered function ID
+ * \param priority [OUT]        pointer to priority
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_registered_priority(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_priority_t *priority);
+
 /**
  * Lookup an addr from a peer address/name. Addresses need to be
  * freed by calling HG_Core_addr_free(). After completion, user callback is
@@ -484,6 +678,23 @@ HG_PUBLIC hg_return_t
 HG_Core_addr_lookup2(
     hg_core_class_t *hg_core_class, const char *name, hg_core_addr_t *addr);
 
+/**
+ * Lookup count addrs from an array of peer addresses/names. Names are
+ * resolved at once when the NA plugin supports it. Addresses need to be
+ * freed by calling HG_Core_addr_free(). If an error is returned, no address
+ * is returned.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param names [IN]            array of lookup names
+ * \param count [IN]            number of names
+ * \param addrs [OUT]           array of abstract addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_lookup_batch(hg_core_class_t *hg_core_class,
+    const char *const names[], hg_size_t count, hg_core_addr_t addrs[]);
+
 /**
  * Free the addr from the list of peers.
  *
@@ -507,6 +718,53 @@ HG_Core_addr_free(hg_core_addr_t addr);
 HG_PUBLIC hg_return_t
 HG_Core_addr_set_remove(hg_core_addr_t addr);
 
+/**
+ * Cancel all forwards in flight to addr, see HG_Addr_cancel_all().
+ *
+ * \param addr [IN]             abstract address
+ * \param remove [IN]           also set address to be removed
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_cancel_all(hg_core_addr_t addr, hg_bool_t remove);
+
+/**
+ * Start establishing connections to count addrs, see HG_Addr_warmup().
+ *
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_warmup(const hg_core_addr_t addrs[], hg_size_t count);
+
+/**
+ * Get last load advertised by target, see HG_Addr_get_load().
+ *
+ * \param addr [IN]             abstract address
+ * \param load [OUT]            pointer to returned load
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_get_load(hg_core_addr_t addr, hg_uint32_t *load);
+
+/**
+ * Select least loaded of two random addrs, see HG_Addr_select().
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ * \param addr [OUT]            pointer to selected address
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_select(hg_core_class_t *hg_core_class,
+    const hg_core_addr_t addrs[], hg_size_t count, hg_core_addr_t *addr);
+
 /**
  * Obtain the underlying NA address from an HG address.
  *
@@ -630,6 +888,53 @@ HG_PUBLIC hg_return_t
 HG_Core_addr_deserialize(hg_core_class_t *hg_core_class, hg_core_addr_t *addr,
     const void *buf, hg_size_t buf_size);
 
+/**
+ * Get size required to serialize count addresses at once.
+ *
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return Non-negative value
+ */
+HG_PUBLIC hg_size_t
+HG_Core_addr_get_serialize_batch_size(
+    const hg_core_addr_t addrs[], hg_size_t count);
+
+/**
+ * Serialize count addresses into a buffer. Addresses share a single header
+ * and are stored as fixed-width entries. Only the primary NA addresses are
+ * serialized.
+ *
+ * \param buf [IN/OUT]          pointer to destination buffer
+ * \param buf_size [IN]         buffer size
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_serialize_batch(void *buf, hg_size_t buf_size,
+    const hg_core_addr_t addrs[], hg_size_t count);
+
+/**
+ * Deserialize addresses from a buffer filled by HG_Core_addr_serialize_batch().
+ * If addrs is NULL, only the number of addresses is returned in count.
+ * Otherwise count must hold the size of addrs and is set to the number of
+ * addresses returned. Addresses need to be freed by calling
+ * HG_Core_addr_free(). If an error is returned, no address is returned.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param buf [IN]              pointer to buffer used for deserialization
+ * \param buf_size [IN]         buffer size
+ * \param addrs [OUT]           array of abstract addresses
+ * \param count [IN/OUT]        pointer to number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_deserialize_batch(hg_core_class_t *hg_core_class, const void *buf,
+    hg_size_t buf_size, hg_core_addr_t addrs[], hg_size_t *count);
+
 /**
  * Initiate a new HG RPC using the specified function ID and the local/remote
  * target defined by addr. The HG handle created can be used to query input
@@ -754,6 +1059,42 @@ HG_Core_get_rpc_data(hg_core_handle_t handle);
 static HG_INLINE hg_return_t
 HG_Core_set_target_id(hg_core_handle_t handle, hg_uint8_t id);
 
+/**
+ * Set key used to pick the target shard of the RPC request when the class
+ * is initialized with a shard count (see hg_init_info.shard_count). RPCs
+ * that share the same RPC ID and key are sent to the same target context,
+ * setting an explicit target ID takes precedence.
+ *
+ * \param handle [IN]           HG handle
+ * \param key [IN]              shard key
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Core_set_shard_key(hg_core_handle_t handle, hg_uint64_t key);
+
+/**
+ * Determine whether the received input was encoded by a peer whose byte order
+ * differs from the local byte order.
+ *
+ * \param handle [IN]           HG handle
+ *
+ * \return HG_TRUE if input payload must be byte-swapped, HG_FALSE otherwise
+ */
+static HG_INLINE hg_bool_t
+HG_Core_is_input_swapped(hg_core_handle_t handle);
+
+/**
+ * Determine whether the received output was encoded by a peer whose byte
+ * order differs from the local byte order.
+ *
+ * \param handle [IN]           HG handle
+ *
+ * \return HG_TRUE if output payload must be byte-swapped, HG_FALSE otherwise
+ */
+static HG_INLINE hg_bool_t
+HG_Core_is_output_swapped(hg_core_handle_t handle);
+
 /**
  * Get input buffer from handle that can be used for serializing/deserializing
  * parameters.
@@ -782,6 +1123,32 @@ static HG_INLINE hg_return_t
 HG_Core_get_output(
     hg_core_handle_t handle, void **out_buf, hg_size_t *out_buf_size);
 
+/**
+ * Get size of the input payload that was received (or that is being
+ * forwarded), not including the request header.
+ *
+ * \param handle [IN]           HG handle
+ * \param payload_size [OUT]    pointer to payload size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_get_input_payload_size(
+    hg_core_handle_t handle, hg_size_t *payload_size);
+
+/**
+ * Get size of the output payload that was received (or that is being
+ * sent back), not including the response header.
+ *
+ * \param handle [IN]           HG handle
+ * \param payload_size [OUT]    pointer to payload size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_get_output_payload_size(
+    hg_core_handle_t handle, hg_size_t *payload_size);
+
 /**
  * Forward a call using an existing HG handle. Input and output buffers can be
  * queried from the handle to serialize/deserialize parameters.
@@ -802,6 +1169,83 @@ HG_PUBLIC hg_return_t
 HG_Core_forward(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
     hg_uint8_t flags, hg_size_t payload_size);
 
+/**
+ * Forward a call like HG_Core_forward() with a deadline of \timeout ms. If no
+ * response has been received by then, the call is canceled and its callback
+ * returns HG_TIMEOUT. Deadlines are serviced by HG_Core_progress() on the
+ * context of the handle with a resolution of 1 ms. Calls forwarded to self
+ * cannot be canceled and have no deadline.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param flags [IN]            forward flags
+ * \param payload_size [IN]     size of payload to send
+ * \param timeout [IN]          timeout (in milliseconds), 0 means no deadline
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_forward_timed(hg_core_handle_t handle, hg_core_cb_t callback,
+    void *arg, hg_uint8_t flags, hg_size_t payload_size, unsigned int timeout);
+
+/**
+ * Forward a call like HG_Core_forward() once \delay ms have elapsed. The
+ * encoded request is kept in the handle and sent by HG_Core_progress() on
+ * the context of the handle. Canceling the handle before the delay expires
+ * completes it with HG_CANCELED without sending anything. Calls forwarded to
+ * self are sent immediately.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param flags [IN]            forward flags
+ * \param payload_size [IN]     size of payload to send
+ * \param delay [IN]            delay (in milliseconds), 0 means no delay
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_forward_delayed(hg_core_handle_t handle, hg_core_cb_t callback,
+    void *arg, hg_uint8_t flags, hg_size_t payload_size, unsigned int delay);
+
+/**
+ * Make handle persistent for repeated calls to the same target. Subsequent
+ * forwards keep the tag reserved by the first one and only encode the request
+ * header again if their flags change. A forward that did not complete
+ * successfully releases the tag so that a late response cannot be matched by
+ * the next one. Persistence is cleared by HG_Core_reset().
+ *
+ * \param handle [IN]           HG handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_forward_init(hg_core_handle_t handle);
+
+/**
+ * Forward \count handles of the same context like HG_Core_forward(), each
+ * with its own payload. Request tags are reserved for the whole batch at once
+ * and the sends are submitted to NA as a single batch (see
+ * NA_Op_batch_begin()). Handles are forwarded in order and forwarding stops
+ * at the first failure: handles before it complete through \callback, the
+ * others are left untouched.
+ *
+ * \param handles [IN]          array of HG handles
+ * \param count [IN]            number of handles
+ * \param callback [IN]         pointer to function callback
+ * \param args [IN]             array of data passed to callback
+ * \param flags [IN]            array of forward flags
+ * \param payload_sizes [IN]    array of payload sizes
+ * \param posted_ptr [OUT]      number of handles forwarded (may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_forward_batch(hg_core_handle_t *handles, unsigned int count,
+    hg_core_cb_t callback, void **args, const hg_uint8_t *flags,
+    const hg_size_t *payload_sizes, unsigned int *posted_ptr);
+
 /**
  * Respond back to the origin. The output buffer, which can be used to encode
  * the response, must first be queried using HG_Core_get_output().
@@ -819,6 +1263,62 @@ HG_PUBLIC hg_return_t
 HG_Core_respond(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
     hg_uint8_t flags, hg_size_t payload_size);
 
+/**
+ * Respond on \count handles of the same context like HG_Core_respond(), the
+ * responses are submitted to NA as a single batch. Handles are responded in
+ * order and responding stops at the first failure.
+ *
+ * \param handles [IN]          array of HG handles
+ * \param count [IN]            number of handles
+ * \param callback [IN]         pointer to function callback
+ * \param args [IN]             array of data passed to callback
+ * \param flags [IN]            array of respond flags
+ * \param payload_sizes [IN]    array of payload sizes
+ * \param posted_ptr [OUT]      number of responses sent (may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_respond_batch(hg_core_handle_t *handles, unsigned int count,
+    hg_core_cb_t callback, void **args, const hg_uint8_t *flags,
+    const hg_size_t *payload_sizes, unsigned int *posted_ptr);
+
+/**
+ * Set callback triggered on the origin for each response chunk that the
+ * target sends with HG_Core_respond_chunk() before its final response. The
+ * chunk can be read from the output buffer within the callback only, the next
+ * chunk is only sent by the target once the callback has returned. The
+ * callback remains set for subsequent forwards of that handle.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_set_chunk_callback(
+    hg_core_handle_t handle, hg_core_cb_t callback, void *arg);
+
+/**
+ * Send a chunk of a streamed response back to the origin, the response must
+ * be terminated by HG_Core_respond(). The output buffer is re-used by each
+ * chunk: the callback is placed into a completion queue once the origin has
+ * consumed the chunk, the next chunk or the final response can only be sent
+ * once that callback has been triggered. Not supported on calls forwarded to
+ * self.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param payload_size [IN]     size of payload to send
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_respond_chunk(hg_core_handle_t handle, hg_core_cb_t callback,
+    void *arg, hg_size_t payload_size);
+
 /**
  * Try to progress RPC execution for at most timeout until timeout is reached or
  * any completion has occurred.
@@ -834,6 +1334,44 @@ HG_Core_respond(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
 HG_PUBLIC hg_return_t
 HG_Core_progress(hg_core_context_t *context, unsigned int timeout);
 
+/**
+ * Get a fd that becomes readable when progress can be made on context, so
+ * that context can be driven from an external event loop (epoll, libuv, etc)
+ * instead of calling HG_Core_progress(). The fd aggregates the NA plugin fds
+ * and completion notifications of the context. It must only be watched for
+ * readability and must not be read from.
+ *
+ * \param context [IN]          pointer to HG core context
+ *
+ * \return Non-negative fd on success or negative if context has no fd (NA
+ * plugin does not expose one or NA_NO_BLOCK progress mode was requested)
+ */
+HG_PUBLIC int
+HG_Core_context_get_fd(const hg_core_context_t *context);
+
+/**
+ * Make non-blocking progress on context once its fd (see
+ * HG_Core_context_get_fd()) is readable, then arm notifications of the fd.
+ * Readiness is consumed by the call, the fd may therefore be watched in
+ * edge-triggered mode. Callbacks of completed operations must still be
+ * executed with HG_Core_trigger().
+ *
+ * On return, \timeout_ptr is set to the time (in milliseconds) that the event
+ * loop may wait on the fd before calling this function again, whether the fd
+ * became readable or not (deadlines of timed forwards, coalesced messages).
+ * A value of 0 means that the event loop must not wait: either callbacks are
+ * ready to be triggered or progress must be made again.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param timeout_ptr [OUT]     pointer to max time to wait on the fd
+ *
+ * \return HG_SUCCESS, HG_AGAIN if another thread is progressing context or
+ * corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_context_process_ready(
+    hg_core_context_t *context, unsigned int *timeout_ptr);
+
 /**
  * Execute at most max_count callbacks. If timeout is non-zero, wait up to
  * timeout before returning. Function can return when at least one or more
@@ -850,6 +1388,25 @@ HG_PUBLIC hg_return_t
 HG_Core_trigger(hg_core_context_t *context, unsigned int timeout,
     unsigned int max_count, unsigned int *actual_count);
 
+/**
+ * Execute at most max_count callbacks, same as HG_Core_trigger() except that
+ * completed operations are dequeued in batches and their callbacks executed
+ * back to back, which reduces the number of atomic operations required per
+ * callback. Callbacks of operations that were dequeued are always executed
+ * before returning, a single call may therefore not be shared as evenly
+ * between threads triggering the same context.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param max_count [IN]        maximum number of callbacks triggered
+ * \param actual_count [IN]     actual number of callbacks triggered
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_trigger_batch(hg_core_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count);
+
 /**
  * Cancel an ongoing operation.
  *
@@ -870,6 +1427,9 @@ struct hg_core_class {
 #ifdef NA_HAS_SM
     na_class_t *na_sm_class; /* NA SM class */
 #endif
+    na_class_t *na_rail_classes[HG_CORE_RAIL_MAX];  /* NA rail classes */
+    na_addr_t na_rail_self_addrs[HG_CORE_RAIL_MAX]; /* Rail self addresses */
+    unsigned int na_rail_count;                     /* Number of rails */
     void *data;                         /* User data */
     void (*data_free_callback)(void *); /* User data free callback */
 };
@@ -881,6 +1441,7 @@ struct hg_core_context {
 #ifdef NA_HAS_SM
     na_context_t *na_sm_context; /* NA SM context */
 #endif
+    na_context_t *na_rail_contexts[HG_CORE_RAIL_MAX]; /* NA rail contexts */
     void *data;                         /* User data */
     void (*data_free_callback)(void *); /* User data free callback */
     hg_uint8_t id;                      /* Context ID */
@@ -898,9 +1459,13 @@ struct hg_core_addr {
 
 /* HG core RPC registration info */
 struct hg_core_rpc_info {
+    hg_id_t id;                    /* RPC ID */
+    hg_uint16_t index;             /* Index in RPC table (0 if none) */
     hg_core_rpc_cb_t rpc_cb;       /* RPC callback */
     void *data;                    /* User data */
     void (*free_callback)(void *); /* User data free callback */
+    hg_priority_t priority;        /* Completion priority */
+    struct hg_core_stats *stats;   /* Stat counters */
 };
 
 /* HG core handle */
@@ -915,6 +1480,11 @@ struct hg_core_handle {
     na_size_t out_buf_size;             /* Output buffer size */
     na_size_t na_in_header_offset;      /* Input NA header offset */
     na_size_t na_out_header_offset;     /* Output NA header offset */
+    na_size_t in_header_size;           /* Input HG core header size */
+    na_size_t out_header_size;          /* Output HG core header size */
+    hg_uint64_t shard_key;              /* Key used to pick target shard */
+    hg_bool_t in_swapped;               /* Input uses other byte order */
+    hg_bool_t out_swapped;              /* Output uses other byte order */
 };
 
 /*---------------------------------------------------------------------------*/
@@ -954,6 +1524,33 @@ HG_Core_class_get_na_sm(const hg_core_class_t *hg_core_class)
 }
 #endif
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+HG_Core_class_get_na_rail_count(const hg_core_class_t *hg_core_class)
+{
+    return hg_core_class->na_rail_count;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE na_class_t *
+HG_Core_class_get_na_rail(
+    const hg_core_class_t *hg_core_class, unsigned int index)
+{
+    return (index < hg_core_class->na_rail_count)
+               ? hg_core_class->na_rail_classes[index]
+               : NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE na_addr_t
+HG_Core_class_get_na_rail_self(
+    const hg_core_class_t *hg_core_class, unsigned int index)
+{
+    return (index < hg_core_class->na_rail_count)
+               ? hg_core_class->na_rail_self_addrs[index]
+               : NA_ADDR_NULL;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_size_t
 HG_Core_class_get_input_eager_size(const hg_core_class_t *hg_core_class)
@@ -1018,6 +1615,16 @@ HG_Core_context_get_na_sm(const hg_core_context_t *context)
 }
 #endif
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE na_context_t *
+HG_Core_context_get_na_rail(
+    const hg_core_context_t *context, unsigned int index)
+{
+    return (index < context->core_class->na_rail_count)
+               ? context->na_rail_contexts[index]
+               : NULL;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_uint8_t
 HG_Core_context_get_id(const hg_core_context_t *context)
@@ -1107,13 +1714,36 @@ HG_Core_set_target_id(hg_core_handle_t handle, hg_uint8_t id)
     return HG_SUCCESS;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Core_set_shard_key(hg_core_handle_t handle, hg_uint64_t key)
+{
+    handle->shard_key = key;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+HG_Core_is_input_swapped(hg_core_handle_t handle)
+{
+    return handle->in_swapped;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+HG_Core_is_output_swapped(hg_core_handle_t handle)
+{
+    return handle->out_swapped;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_return_t
 HG_Core_get_input(
     hg_core_handle_t handle, void **in_buf, hg_size_t *in_buf_size)
 {
     hg_size_t header_offset =
-        hg_core_header_request_get_size() + handle->na_in_header_offset;
+        handle->in_header_size + handle->na_in_header_offset;
 
     /* Space must be left for request header */
     *in_buf = (char *) handle->in_buf + header_offset;
@@ -1128,7 +1758,7 @@ HG_Core_get_output(
     hg_core_handle_t handle, void **out_buf, hg_size_t *out_buf_size)
 {
     hg_size_t header_offset =
-        hg_core_header_response_get_size() + handle->na_out_header_offset;
+        handle->out_header_size + handle->na_out_header_offset;
 
     /* Space must be left for response header */
     *out_buf = (char *) handle->out_buf + header_offset;
@@ -49,12 +49,11 @@
 #define hg_core_header_proc_hg_int8_t_dec(x)                                   \
     (hg_int8_t) hg_core_header_proc_hg_uint8_t_dec((hg_uint8_t) x)
 
-/* Update checksum */
+/* Update checksum once with all the header bytes processed so far */
 #ifdef HG_HAS_CHECKSUMS
-#    define HG_CORE_HEADER_CHECKSUM_UPDATE(hg_header, data, type)              \
-        mchecksum_update(hg_header->checksum, &data, sizeof(type))
-#else
-#    define HG_CORE_HEADER_CHECKSUM_UPDATE(hg_header, data, type)
+#    define HG_CORE_HEADER_CHECKSUM_UPDATE(hg_header, buf, buf_ptr)            \
+        mchecksum_update(hg_header->checksum, buf,                             \
+            (size_t)((const char *) buf_ptr - (const char *) buf))
 #endif
 
 /* Proc type */
@@ -71,12 +70,9 @@
         buf_ptr = (char *) buf_ptr + sizeof(type);                             \
     } while (0)
 
-/* Proc */
+/* Proc (checksum is computed over the encoded header) */
 #define HG_CORE_HEADER_PROC(hg_header, buf_ptr, data, type, op)                \
-    do {                                                                       \
-        HG_CORE_HEADER_PROC_TYPE(buf_ptr, data, type, op);                     \
-        HG_CORE_HEADER_CHECKSUM_UPDATE(hg_header, data, type);                 \
-    } while (0)
+    HG_CORE_HEADER_PROC_TYPE(buf_ptr, data, type, op)
 
 /************************************/
 /* Local Type and Struct Definition */
@@ -88,10 +84,115 @@
 extern const char *
 HG_Error_to_string(hg_return_t errnum);
 
+/**
+ * Encode/decode a varint (7 bits per byte, least significant group first).
+ */
+static HG_INLINE hg_return_t
+hg_core_header_proc_varint(
+    hg_proc_op_t op, void **buf_ptr, const void *buf_end, hg_uint64_t *value);
+
+/**
+ * Encode/decode extension fields of a compact request header, fields of
+ * unknown type are skipped.
+ */
+static hg_return_t
+hg_core_header_proc_ext(hg_proc_op_t op, void **buf_ptr, const void *buf_end,
+    struct hg_core_header *hg_core_header);
+
 /*******************/
 /* Local Variables */
 /*******************/
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_header_proc_varint(
+    hg_proc_op_t op, void **buf_ptr, const void *buf_end, hg_uint64_t *value)
+{
+    hg_uint8_t *ptr = (hg_uint8_t *) *buf_ptr;
+    size_t avail = (size_t) ((const hg_uint8_t *) buf_end - ptr);
+    hg_return_t ret = HG_SUCCESS;
+    size_t i;
+
+    if (op == HG_ENCODE) {
+        hg_uint64_t v = *value;
+
+        HG_CHECK_ERROR(avail < hg_core_header_varint_get_size(v), done, ret,
+            HG_OVERFLOW, "Invalid buffer size");
+        for (i = 0; v >= 0x80; i++, v >>= 7)
+            ptr[i] = (hg_uint8_t) ((v & 0x7f) | 0x80);
+        ptr[i++] = (hg_uint8_t) v;
+    } else {
+        hg_uint64_t v = 0;
+
+        for (i = 0;; i++) {
+            HG_CHECK_ERROR(i >= avail || i >= HG_CORE_HEADER_VARINT_MAX, done,
+                ret, HG_PROTOCOL_ERROR, "Invalid varint");
+            v |= (hg_uint64_t) (ptr[i] & 0x7f) << (7 * i);
+            if (!(ptr[i] & 0x80))
+                break;
+        }
+        i++;
+        *value = v;
+    }
+    *buf_ptr = ptr + i;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_header_proc_ext(hg_proc_op_t op, void **buf_ptr, const void *buf_end,
+    struct hg_core_header *hg_core_header)
+{
+    hg_uint64_t ext_size = 0, field_size = 0;
+    hg_uint8_t type;
+    char *ext_end;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (op == HG_ENCODE) {
+        field_size = hg_core_header->trace_ctx_size;
+        ext_size = sizeof(hg_uint8_t) +
+                   hg_core_header_varint_get_size(field_size) + field_size;
+    }
+    ret = hg_core_header_proc_varint(op, buf_ptr, buf_end, &ext_size);
+    HG_CHECK_HG_ERROR(done, ret, "Could not process extension size");
+    HG_CHECK_ERROR(ext_size > (hg_uint64_t) ((const char *) buf_end -
+                                             (char *) *buf_ptr),
+        done, ret, HG_PROTOCOL_ERROR, "Invalid extension size");
+    ext_end = (char *) *buf_ptr + ext_size;
+
+    if (op == HG_ENCODE) {
+        type = HG_CORE_HEADER_EXT_TRACE_CTX;
+        HG_CORE_HEADER_PROC_TYPE(*buf_ptr, type, hg_uint8_t, op);
+        ret = hg_core_header_proc_varint(op, buf_ptr, ext_end, &field_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not process extension field size");
+        memcpy(*buf_ptr, hg_core_header->trace_ctx, (size_t) field_size);
+        *buf_ptr = ext_end;
+        goto done;
+    }
+
+    hg_core_header->trace_ctx = NULL;
+    hg_core_header->trace_ctx_size = 0;
+    while ((char *) *buf_ptr < ext_end) {
+        HG_CORE_HEADER_PROC_TYPE(*buf_ptr, type, hg_uint8_t, op);
+        ret = hg_core_header_proc_varint(op, buf_ptr, ext_end, &field_size);
+        HG_CHECK_HG_ERROR(done, ret, "Could not process extension field size");
+        HG_CHECK_ERROR(
+            field_size > (hg_uint64_t) (ext_end - (char *) *buf_ptr), done,
+            ret, HG_PROTOCOL_ERROR, "Invalid extension field size");
+        if (type == HG_CORE_HEADER_EXT_TRACE_CTX &&
+            field_size <= HG_HOOK_TRACE_CTX_MAX) {
+            hg_core_header->trace_ctx = *buf_ptr;
+            hg_core_header->trace_ctx_size = (size_t) field_size;
+        }
+        *buf_ptr = (char *) *buf_ptr + field_size;
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 void
 hg_core_header_request_init(struct hg_core_header *hg_core_header)
@@ -146,6 +247,9 @@ hg_core_header_request_reset(struct hg_core_header *hg_core_header)
         &hg_core_header->msg.request, 0, sizeof(struct hg_core_header_request));
     hg_core_header->msg.request.hg = HG_CORE_IDENTIFIER;
     hg_core_header->msg.request.protocol = HG_CORE_PROTOCOL_VERSION;
+    hg_core_header->trace_ctx = NULL;
+    hg_core_header->trace_ctx_size = 0;
+    hg_core_header->index = 0;
 #ifdef HG_HAS_CHECKSUMS
     mchecksum_reset(hg_core_header->checksum);
 #endif
@@ -157,6 +261,7 @@ hg_core_header_response_reset(struct hg_core_header *hg_core_header)
 {
     memset(&hg_core_header->msg.response, 0,
         sizeof(struct hg_core_header_response));
+    hg_core_header->index = 0;
 #ifdef HG_HAS_CHECKSUMS
     mchecksum_reset(hg_core_header->checksum);
 #endif
@@ -168,17 +273,24 @@ hg_core_header_request_proc(hg_proc_op_t op, void *buf, size_t buf_size,
     struct hg_core_header *hg_core_header)
 {
     void *buf_ptr = buf;
+    const void *buf_end = (const char *) buf + buf_size;
     struct hg_core_header_request *header = &hg_core_header->msg.request;
     hg_return_t ret = HG_SUCCESS;
 
-    HG_CHECK_ERROR(buf_size < sizeof(struct hg_core_header_request), done, ret,
-        HG_INVALID_ARG, "Invalid buffer size");
+    HG_CHECK_ERROR(buf_size < 4 * sizeof(hg_uint8_t) + HG_CORE_HEADER_HASH_SIZE,
+        done, ret, HG_INVALID_ARG, "Invalid buffer size");
 
 #ifdef HG_HAS_CHECKSUMS
     /* Reset header checksum first */
     mchecksum_reset(hg_core_header->checksum);
 #endif
 
+    /* Protocol version tells which format is used */
+    if (op == HG_ENCODE)
+        header->protocol = (hg_core_header->compact)
+                               ? HG_CORE_PROTOCOL_VERSION_COMPACT
+                               : HG_CORE_PROTOCOL_VERSION;
+
     /* HG byte */
     HG_CORE_HEADER_PROC(hg_core_header, buf_ptr, header->hg, hg_uint8_t, op);
 
@@ -186,18 +298,85 @@ hg_core_header_request_proc(hg_proc_op_t op, void *buf, size_t buf_size,
     HG_CORE_HEADER_PROC(
         hg_core_header, buf_ptr, header->protocol, hg_uint8_t, op);
 
-    /* RPC ID */
-    HG_CORE_HEADER_PROC(hg_core_header, buf_ptr, header->id, hg_uint64_t, op);
+    if (op == HG_DECODE)
+        hg_core_header->compact =
+            (header->protocol == HG_CORE_PROTOCOL_VERSION_COMPACT);
+
+    if (hg_core_header->compact) {
+        /* Flags */
+        if (op == HG_ENCODE && hg_core_header->index)
+            header->flags |= HG_CORE_HEADER_INDEX;
+        if (op == HG_ENCODE && hg_core_header->trace_ctx_size)
+            header->flags |= HG_CORE_HEADER_EXT;
+        HG_CORE_HEADER_PROC(
+            hg_core_header, buf_ptr, header->flags, hg_uint8_t, op);
+
+        /* Cookie */
+        HG_CORE_HEADER_PROC(
+            hg_core_header, buf_ptr, header->cookie, hg_uint8_t, op);
+
+        if (header->flags & HG_CORE_HEADER_INDEX) {
+            hg_uint64_t index = hg_core_header->index;
+            hg_uint8_t id_check = (hg_uint8_t) (header->id & 0xff);
+
+            /* RPC index, followed by low byte of RPC ID to detect tables that
+             * changed (decoded ID is only made of that byte) */
+            ret = hg_core_header_proc_varint(op, &buf_ptr, buf_end, &index);
+            HG_CHECK_HG_ERROR(done, ret, "Could not process RPC index");
+            HG_CHECK_ERROR(index == 0 || index > UINT16_MAX, done, ret,
+                HG_PROTOCOL_ERROR, "Invalid RPC index");
+            HG_CHECK_ERROR(buf_ptr == buf_end, done, ret, HG_OVERFLOW,
+                "Invalid buffer size");
+            HG_CORE_HEADER_PROC(
+                hg_core_header, buf_ptr, id_check, hg_uint8_t, op);
+            if (op == HG_DECODE) {
+                hg_core_header->index = (hg_uint16_t) index;
+                header->id = id_check;
+            }
+        } else {
+            if (op == HG_DECODE)
+                hg_core_header->index = 0;
+
+            /* RPC ID */
+            ret =
+                hg_core_header_proc_varint(op, &buf_ptr, buf_end, &header->id);
+            HG_CHECK_HG_ERROR(done, ret, "Could not process RPC ID");
+        }
+
+        /* Extension fields */
+        if (header->flags & HG_CORE_HEADER_EXT) {
+            ret = hg_core_header_proc_ext(
+                op, &buf_ptr, buf_end, hg_core_header);
+            HG_CHECK_HG_ERROR(done, ret, "Could not process extension fields");
+        } else if (op == HG_DECODE) {
+            hg_core_header->trace_ctx = NULL;
+            hg_core_header->trace_ctx_size = 0;
+        }
+#ifdef HG_HAS_CHECKSUMS
+        HG_CHECK_ERROR((size_t) ((const char *) buf_end - (char *) buf_ptr) <
+                           HG_CORE_HEADER_HASH_SIZE,
+            done, ret, HG_OVERFLOW, "Invalid buffer size");
+#endif
+    } else {
+        HG_CHECK_ERROR(buf_size < sizeof(struct hg_core_header_request), done,
+            ret, HG_INVALID_ARG, "Invalid buffer size");
 
-    /* Flags */
-    HG_CORE_HEADER_PROC(hg_core_header, buf_ptr, header->flags, hg_uint8_t, op);
+        /* RPC ID */
+        HG_CORE_HEADER_PROC(
+            hg_core_header, buf_ptr, header->id, hg_uint64_t, op);
 
-    /* Cookie */
-    HG_CORE_HEADER_PROC(
-        hg_core_header, buf_ptr, header->cookie, hg_uint8_t, op);
+        /* Flags */
+        HG_CORE_HEADER_PROC(
+            hg_core_header, buf_ptr, header->flags, hg_uint8_t, op);
+
+        /* Cookie */
+        HG_CORE_HEADER_PROC(
+            hg_core_header, buf_ptr, header->cookie, hg_uint8_t, op);
+    }
 
 #ifdef HG_HAS_CHECKSUMS
     /* Checksum of header */
+    HG_CORE_HEADER_CHECKSUM_UPDATE(hg_core_header, buf, buf_ptr);
     mchecksum_get(hg_core_header->checksum, &header->hash.header,
         sizeof(hg_uint16_t), MCHECKSUM_FINALIZE);
 
@@ -213,6 +392,12 @@ hg_core_header_request_proc(hg_proc_op_t op, void *buf, size_t buf_size,
     }
 #endif
 
+    /* Payload of full headers starts after reserved size */
+    hg_core_header->size =
+        (hg_core_header->compact)
+            ? (size_t) ((char *) buf_ptr - (char *) buf)
+            : sizeof(struct hg_core_header_request);
+
 done:
     return ret;
 }
@@ -239,14 +424,37 @@ hg_core_header_response_proc(hg_proc_op_t op, void *buf, size_t buf_size,
         hg_core_header, buf_ptr, header->ret_code, hg_int8_t, op);
 
     /* Flags */
+    if (op == HG_ENCODE && hg_core_header->compact && hg_core_header->index)
+        header->flags |= HG_CORE_HEADER_INDEX;
     HG_CORE_HEADER_PROC(hg_core_header, buf_ptr, header->flags, hg_uint8_t, op);
 
     /* Cookie */
     HG_CORE_HEADER_PROC(
         hg_core_header, buf_ptr, header->cookie, hg_uint16_t, op);
 
+    /* Credits */
+    HG_CORE_HEADER_PROC(
+        hg_core_header, buf_ptr, header->credits, hg_uint16_t, op);
+
+    /* Load */
+    HG_CORE_HEADER_PROC(hg_core_header, buf_ptr, header->load, hg_uint16_t, op);
+
+    /* RPC index advertised to origin */
+    if (hg_core_header->compact && (header->flags & HG_CORE_HEADER_INDEX)) {
+        hg_uint64_t index = hg_core_header->index;
+
+        ret = hg_core_header_proc_varint(
+            op, &buf_ptr, (char *) buf + buf_size, &index);
+        HG_CHECK_HG_ERROR(done, ret, "Could not process RPC index");
+        HG_CHECK_ERROR(index == 0 || index > UINT16_MAX, done, ret,
+            HG_PROTOCOL_ERROR, "Invalid RPC index");
+        hg_core_header->index = (hg_uint16_t) index;
+    } else if (op == HG_DECODE)
+        hg_core_header->index = 0;
+
 #ifdef HG_HAS_CHECKSUMS
     /* Checksum of header */
+    HG_CORE_HEADER_CHECKSUM_UPDATE(hg_core_header, buf, buf_ptr);
     mchecksum_get(hg_core_header->checksum, &header->hash.header,
         sizeof(hg_uint16_t), MCHECKSUM_FINALIZE);
 
@@ -262,6 +470,33 @@ hg_core_header_response_proc(hg_proc_op_t op, void *buf, size_t buf_size,
     }
 #endif
 
+    /* Compact headers are not padded */
+    hg_core_header->size =
+        (hg_core_header->compact)
+            ? (size_t) ((char *) buf_ptr - (char *) buf)
+            : sizeof(struct hg_core_header_response);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_core_header_coalesce_proc(hg_proc_op_t op, void *buf, size_t buf_size,
+    struct hg_core_header_coalesce *header)
+{
+    void *buf_ptr = buf;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(buf_size < sizeof(struct hg_core_header_coalesce), done,
+        ret, HG_OVERFLOW, "Invalid buffer size");
+
+    /* Size */
+    HG_CORE_HEADER_PROC_TYPE(buf_ptr, header->size, hg_uint32_t, op);
+
+    /* Tag */
+    HG_CORE_HEADER_PROC_TYPE(buf_ptr, header->tag, hg_uint32_t, op);
+
 done:
     return ret;
 }
@@ -278,8 +513,9 @@ hg_core_header_request_verify(const struct hg_core_header *hg_core_header)
         (((header->hg >> 1) & 'H') != 'H') || (((header->hg) & 'G') != 'G'),
         done, ret, HG_PROTOCOL_ERROR, "Invalid HG byte");
 
-    HG_CHECK_ERROR(header->protocol != HG_CORE_PROTOCOL_VERSION, done, ret,
-        HG_PROTONOSUPPORT, "Invalid protocol version");
+    HG_CHECK_ERROR(header->protocol != HG_CORE_PROTOCOL_VERSION &&
+                       header->protocol != HG_CORE_PROTOCOL_VERSION_COMPACT,
+        done, ret, HG_PROTONOSUPPORT, "Invalid protocol version");
 
 done:
     return ret;
@@ -44,13 +44,22 @@ struct hg_core_header_request {
 };
 
 struct hg_core_header_response {
-    hg_int8_t ret_code; /* Return code */
-    hg_uint8_t flags;   /* Flags */
-    hg_uint16_t cookie; /* Cookie */
+    hg_int8_t ret_code;  /* Return code */
+    hg_uint8_t flags;    /* Flags */
+    hg_uint16_t cookie;  /* Cookie */
+    hg_uint16_t credits; /* Requests origin may keep in flight (0 if none) */
+    hg_uint16_t load;    /* Requests target is processing (0 if none) */
 #ifdef HG_HAS_CHECKSUMS
     union hg_core_header_hash hash; /* Hash */
 #endif
-    /* 64/32 bits here */
+    /* 96/64 bits here */
+};
+
+/* Header preceding each request within a coalesced message */
+struct hg_core_header_coalesce {
+    hg_uint32_t size; /* Size of request (header + payload) */
+    hg_uint32_t tag;  /* Tag used for response */
+    /* 64 bits here */
 };
 #if defined(__GNUC__) || defined(_WIN32)
 #    pragma pack(pop)
@@ -65,6 +74,11 @@ struct hg_core_header {
 #ifdef HG_HAS_CHECKSUMS
     void *checksum; /* Checksum of header */
 #endif
+    size_t size;           /* Size of encoded header */
+    void *trace_ctx;       /* Trace context extension (NULL if none) */
+    size_t trace_ctx_size; /* Size of trace context */
+    hg_uint16_t index;     /* Index of RPC in target table (0 if none) */
+    hg_bool_t compact;     /* Use compact format */
 };
 
 /*
@@ -78,7 +92,25 @@ struct hg_core_header {
  * mercury byte / protocol version number / rpc id / flags / cookie / checksum
  *
  * Response:
- * flags / return code / cookie / checksum
+ * flags / return code / cookie / credits / load / checksum
+ *
+ * Compact request (HG_CORE_PROTOCOL_VERSION_COMPACT):
+ * mercury byte / protocol version number / flags / cookie / varint rpc id
+ * (or varint rpc index + low byte of rpc id) /
+ * [varint length + extension fields] / checksum
+ * Extension fields: type byte / varint length / value (repeated)
+ *
+ * Compact response (sent in reply to a compact request):
+ * flags / return code / cookie / credits / load / [varint rpc index] /
+ * checksum
+ * (no padding)
+ *
+ * Coalesced requests (HG_CORE_COALESCED flag set in request header):
+ * 0        HG_CORE_HEADER_SIZE                                     size
+ * |______________|__________|__________________|__________|_______...
+ * |    Header    | Coalesce |  Request header  | Coalesce |
+ * |              |  header  | + Encoded Data   |  header  |  ...
+ * |______________|__________|__________________|__________|_______...
  */
 
 /*****************/
@@ -89,7 +121,32 @@ struct hg_core_header {
 #define HG_CORE_IDENTIFIER (('H' << 1) | ('G')) /* 0xD7 */
 
 /* Mercury protocol version number */
-#define HG_CORE_PROTOCOL_VERSION 0x04
+#define HG_CORE_PROTOCOL_VERSION 0x07
+
+/* Protocol version number of compact headers */
+#define HG_CORE_PROTOCOL_VERSION_COMPACT 0x08
+
+/* Request flag set when extension fields follow a compact header, receivers
+ * skip extensions that they do not know about */
+#define HG_CORE_HEADER_EXT (1 << 7)
+
+/* Flag set when a compact header carries the index of the RPC in the table of
+ * the target: requests then send it in place of the RPC ID and responses
+ * advertise it so that origins can use it for subsequent requests */
+#define HG_CORE_HEADER_INDEX (1 << 6)
+
+/* Extension field carrying the trace context of the request */
+#define HG_CORE_HEADER_EXT_TRACE_CTX (1)
+
+/* Max size of a varint encoded 64-bit value */
+#define HG_CORE_HEADER_VARINT_MAX (10)
+
+/* Size of encoded checksum */
+#ifdef HG_HAS_CHECKSUMS
+#    define HG_CORE_HEADER_HASH_SIZE sizeof(hg_uint16_t)
+#else
+#    define HG_CORE_HEADER_HASH_SIZE 0
+#endif
 
 /*********************/
 /* Public Prototypes */
@@ -103,6 +160,16 @@ static HG_INLINE size_t
 hg_core_header_request_get_size(void);
 static HG_INLINE size_t
 hg_core_header_response_get_size(void);
+static HG_INLINE size_t
+hg_core_header_coalesce_get_size(void);
+static HG_INLINE size_t
+hg_core_header_varint_get_size(hg_uint64_t value);
+static HG_INLINE size_t
+hg_core_header_request_get_compact_size(hg_uint64_t id, hg_uint16_t index);
+static HG_INLINE size_t
+hg_core_header_response_get_compact_size(hg_uint16_t index);
+static HG_INLINE size_t
+hg_core_header_request_get_ext_size(size_t trace_ctx_size);
 
 /**
  * Get size reserved for request header (separate user data stored in payload).
@@ -126,6 +193,91 @@ hg_core_header_response_get_size(void)
     return sizeof(struct hg_core_header_response);
 }
 
+/**
+ * Get size reserved for each request header within a coalesced message.
+ *
+ * \return Non-negative size value
+ */
+static HG_INLINE size_t
+hg_core_header_coalesce_get_size(void)
+{
+    return sizeof(struct hg_core_header_coalesce);
+}
+
+/**
+ * Get number of bytes needed to encode value as a varint.
+ *
+ * \param value [IN]            value
+ *
+ * \return Non-negative size value
+ */
+static HG_INLINE size_t
+hg_core_header_varint_get_size(hg_uint64_t value)
+{
+    size_t size = 1;
+
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+
+    return size;
+}
+
+/**
+ * Get size of compact request header for a given RPC ID (separate user data
+ * stored in payload).
+ *
+ * \param id [IN]               RPC ID
+ * \param index [IN]            index of RPC in target table (0 if none)
+ *
+ * \return Non-negative size value
+ */
+static HG_INLINE size_t
+hg_core_header_request_get_compact_size(hg_uint64_t id, hg_uint16_t index)
+{
+    return 4 * sizeof(hg_uint8_t) +
+           ((index) ? hg_core_header_varint_get_size(index) + sizeof(hg_uint8_t)
+                    : hg_core_header_varint_get_size(id)) +
+           HG_CORE_HEADER_HASH_SIZE;
+}
+
+/**
+ * Get size of the extension fields of a compact request header.
+ *
+ * \param trace_ctx_size [IN]   size of trace context (0 if none)
+ *
+ * \return Non-negative size value
+ */
+static HG_INLINE size_t
+hg_core_header_request_get_ext_size(size_t trace_ctx_size)
+{
+    size_t ext_size;
+
+    if (trace_ctx_size == 0)
+        return 0;
+
+    ext_size = sizeof(hg_uint8_t) +
+               hg_core_header_varint_get_size(trace_ctx_size) + trace_ctx_size;
+
+    return hg_core_header_varint_get_size(ext_size) + ext_size;
+}
+
+/**
+ * Get size of compact response header (separate user data stored in payload).
+ *
+ * \param index [IN]            index of RPC advertised (0 if none)
+ *
+ * \return Non-negative size value
+ */
+static HG_INLINE size_t
+hg_core_header_response_get_compact_size(hg_uint16_t index)
+{
+    return 2 * sizeof(hg_uint8_t) + 3 * sizeof(hg_uint16_t) +
+           ((index) ? hg_core_header_varint_get_size(index) : 0) +
+           HG_CORE_HEADER_HASH_SIZE;
+}
+
 /**
  * Initialize RPC request header.
  *
@@ -208,6 +360,20 @@ HG_PRIVATE hg_return_t
 hg_core_header_response_proc(hg_proc_op_t op, void *buf, size_t buf_size,
     struct hg_core_header *hg_core_header);
 
+/**
+ * Process header of request within a coalesced message.
+ *
+ * \param op [IN]               operation type: HG_ENCODE / HG_DECODE
+ * \param buf [IN/OUT]          buffer
+ * \param buf_size [IN]         buffer size
+ * \param header [IN/OUT]       pointer to coalesce header structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PRIVATE hg_return_t
+hg_core_header_coalesce_proc(hg_proc_op_t op, void *buf, size_t buf_size,
+    struct hg_core_header_coalesce *header);
+
 /**
  * Verify private information from request header.
  *
@@ -37,6 +37,8 @@ struct hg_init_info {
     /* Controls the initial number of requests that are posted on context
      * creation when the HG class is initialized with listen set to true.
      * A value of zero is equivalent to using the internal default value.
+     * When NA unexpected receives are shared across contexts (see
+     * na_init_info.shared_recv), that count is split across max_contexts.
      * Default value is: 256 */
     hg_uint32_t request_post_init;
 
@@ -66,9 +68,259 @@ struct hg_init_info {
      * Default is: false */
     hg_bool_t no_loopback;
 
-    /* (Debug) Print stats at exit.
+    /* (Debug) Print stats when the class is finalized.
      * Default is: false */
     hg_bool_t stats;
+
+    /* Controls the maximum number of RPC requests to the same target that can
+     * be coalesced into a single NA unexpected message. Requests that do not
+     * fit or that require extra data to be transferred are sent separately.
+     * A value of 0 or 1 disables coalescing.
+     * Default is: 0 */
+    hg_uint32_t request_coalesce_count;
+
+    /* Controls how long (in ms) coalesced requests may be held before being
+     * sent when progress is made. A value of zero means that pending requests
+     * are sent on the next call to progress.
+     * Default is: 0 */
+    hg_uint32_t request_coalesce_time;
+
+    /* Controls how long (in ms) the result of an address lookup is cached so
+     * that subsequent lookups of the same name return the same address
+     * without going through NA. A value of 0 disables the lookup cache.
+     * Default is: 0 */
+    hg_uint32_t addr_cache_ttl;
+
+    /* Controls how long (in ms) a failed address lookup is cached. When set,
+     * lookups of a name that recently failed return the same error right
+     * away. Only used if addr_cache_ttl is set, 0 disables negative caching.
+     * Default is: 0 */
+    hg_uint32_t addr_cache_neg_ttl;
+
+    /* Path to a file that is used to populate the lookup cache at init time
+     * and that is overwritten with the cached addresses at finalize time,
+     * allowing a restarted process to skip address resolution. Only used if
+     * addr_cache_ttl is set.
+     * Default is: NULL */
+    const char *addr_cache_file;
+
+    /* Controls the maximum size (in bytes) of a single NA RMA operation
+     * issued by bulk transfers. When set, larger transfers are split into
+     * chunks that are streamed through a window of in-flight operations so
+     * that they do not monopolize the network. A value of 0 means that
+     * operations are only split at segment boundaries.
+     * Default is: 0 */
+    hg_size_t bulk_chunk_size;
+
+    /* Controls the maximum number of NA RMA operations that a single bulk
+     * transfer may have in flight. When either this or bulk_chunk_size is
+     * set, transfers that require more operations are pipelined. A value of
+     * 0 selects a default window of 8 operations when bulk_chunk_size is set
+     * and disables pipelining otherwise.
+     * Default is: 0 */
+    hg_uint32_t bulk_max_inflight;
+
+    /* Controls the number of threads that are used to copy data of bulk
+     * transfers to self (loopback) addresses. When set, copies that are at
+     * least bulk_self_offload_size bytes are split across these threads and
+     * complete asynchronously instead of blocking the calling thread. A value
+     * of 0 means that copies are always made by the calling thread.
+     * Default is: 0 */
+    hg_uint32_t bulk_self_thread_count;
+
+    /* Controls the minimum size (in bytes) of a self bulk transfer for it to
+     * be offloaded to copy threads. Only used if bulk_self_thread_count is
+     * set, a value of 0 selects a default of 1 MB.
+     * Default is: 0 */
+    hg_size_t bulk_self_offload_size;
+
+    /* Controls whether byte arrays and strings decoded from RPC input and
+     * output point directly into the receive buffer instead of being copied
+     * into new allocations (see hg_proc_bytes_ptr()). Borrowed data remains
+     * valid until HG_Free_input() / HG_Free_output() is called. Not supported
+     * with XDR encoding.
+     * Default is: false */
+    hg_bool_t decode_borrow;
+
+    /* Controls whether memory for data decoded from RPC input and output is
+     * allocated from a per-handle arena (see hg_proc_alloc()). Decoded data
+     * is then released all at once by HG_Free_input() / HG_Free_output()
+     * instead of running procs in HG_FREE mode, user procs that allocate
+     * memory must use hg_proc_alloc() and hg_proc_add_cleanup().
+     * Default is: false */
+    hg_bool_t decode_arena;
+
+    /* Controls the maximum number of keys that are interned per class (see
+     * hg_proc_hg_key_t()). Decoded keys then point to a single interned copy
+     * that remains valid until HG_Finalize() is called. Once that number is
+     * reached, new keys are no longer interned. A value of 0 disables key
+     * interning.
+     * Default is: 0 */
+    hg_uint32_t key_intern_max;
+
+    /* Controls whether NA operations complete directly into the HG context
+     * completion queue instead of going through the NA completion queue
+     * first. The NA callback and the user callback of a completed RPC or
+     * bulk transfer are then both executed by a single HG_Trigger() call,
+     * which saves one queue round-trip and one NA_Trigger() pass per
+     * operation.
+     * Default is: false */
+    hg_bool_t integrated_completion;
+
+    /* Number of contexts that RPC services are sharded across. When
+     * listening, HG_Init_opt() creates one context per shard (context IDs 0
+     * to shard_count - 1), each served by its own thread pinned to one core,
+     * and these contexts can be retrieved with HG_Class_get_shard_context().
+     * On the origin, RPCs whose target ID is left to 0 are steered to a shard
+     * by hashing their RPC ID and shard key (see HG_Set_shard_key()). NA
+     * plugins that limit the number of contexts must be initialized with a
+     * max_contexts value of at least shard_count.
+     * Default is: 0 (no sharding) */
+    hg_uint8_t shard_count;
+
+    /* Controls whether the number of posted requests adapts to the load.
+     * When all posted requests are in use, the increment used to post more
+     * of them doubles for as long as the burst lasts (starting from
+     * request_post_incr). Requests that remained unused over the last
+     * second are released, without going below request_post_init.
+     * Default is: false */
+    hg_bool_t request_post_adaptive;
+
+    /* Controls credit-based flow control of RPC requests. Origins allow at
+     * most that many requests in flight to a given target and queue the
+     * others locally until responses come back. Targets advertise in each
+     * response the number of requests that the origin may keep in flight,
+     * which shrinks as their posted requests run out so that overload
+     * degrades gracefully. A value of 0 disables flow control.
+     * Default is: 0 */
+    hg_uint32_t request_credits;
+
+    /* Controls whether RPCs are timestamped at each stage on the origin and
+     * on the target to collect per-RPC latency histograms (see
+     * HG_Core_class_get_latency()).
+     * Default is: false */
+    hg_bool_t latency_stats;
+
+    /* Prefix of binary trace files. When set, every handle lifecycle event
+     * (see hg_trace_type_t) is recorded with its time, handle, RPC and
+     * context IDs, tag and byte count to per-thread memory-mapped files
+     * named "<prefix>-<pid>-<thread>.hgt", which can be converted to Chrome
+     * trace (Perfetto) JSON with the hg_trace_convert tool.
+     * Default is: NULL */
+    const char *trace_prefix;
+
+    /* Controls whether the class registers the built-in introspection RPC
+     * (see HG_Introspect()), which returns a snapshot of class, context and
+     * NA resource stats to remote tools. Classes that do not listen can only
+     * query themselves through loopback.
+     * Default is: false */
+    hg_bool_t introspect;
+
+    /* Controls whether requests are sent with a compact header (protocol
+     * version 0x06), which encodes the RPC ID as a varint and drops padding
+     * so that more of the unexpected message is left for the RPC input.
+     * Targets answer in the format used by each request, they must however
+     * be recent enough to understand compact headers.
+     * Default is: false */
+    hg_bool_t compact_header;
+
+    /* Controls whether RPCs forwarded to self are executed inline. The RPC
+     * callback then runs directly from HG_Core_forward() and the response
+     * and forward callbacks run directly from HG_Core_respond(), without
+     * going through the completion queue or requiring HG_Core_trigger()
+     * calls. Callbacks must therefore not expect to be executed after the
+     * forward or respond call returns.
+     * Default is: false */
+    hg_bool_t loopback_inline;
+
+    /* Comma-separated list of NA info strings of additional NA classes
+     * (rails), typically one per NIC, up to HG_CORE_RAIL_MAX. Memory of
+     * contiguous bulk handles is also registered on every rail and large
+     * transfers between two such handles are striped across the default NA
+     * class and the rails, the transfer callback being triggered once all
+     * stripes have completed. Rails are always listening and peers must
+     * use the same rails in the same order.
+     * Default is: NULL */
+    const char *na_rails;
+
+    /* Controls whether contexts only post a small base set of requests
+     * when they are posted, instead of request_post_init of them, so that
+     * idle contexts start faster and hold fewer buffers. Implies
+     * request_post_adaptive: more requests are posted as soon as three
+     * quarters of them are in use, and requests that remain unused are
+     * released along with their buffers.
+     * Default is: false */
+    hg_bool_t request_post_lazy;
+
+    /* Soft limit (in bytes) of the memory that each context uses for
+     * handles, msg buffers, overflow payloads and bulk op IDs (see
+     * hg_mem_use_t). Once it is reached, contexts stop posting additional
+     * unexpected receives, leaving incoming requests queued by the NA
+     * transport until memory is released. A value of 0 disables the limit.
+     * Default is: 0 */
+    hg_size_t mem_soft_limit;
+
+    /* Hard limit (in bytes) of the memory that each context uses. Overflow
+     * payloads that would exceed it are not allocated and the corresponding
+     * RPCs fail with HG_NOMEM, additional unexpected receives are not posted
+     * either. A value of 0 disables the limit.
+     * Default is: 0 */
+    hg_size_t mem_hard_limit;
+
+    /* Controls the maximum number of deserialized remote bulk handles that
+     * are cached by the class. When set, decoding a bulk descriptor that was
+     * already decoded returns the same handle with an additional reference
+     * instead of deserializing it again, which benefits targets that receive
+     * repeated RPCs on the same exposed buffers. Descriptors that embed data
+     * (HG_BULK_EAGER) are never cached and cached handles cannot be bound
+     * with HG_Bulk_bind(). A value of 0 disables the cache.
+     * Default is: 0 */
+    hg_uint32_t bulk_cache_size;
+
+    /* Controls whether targets advertise their load (number of requests that
+     * they are processing) in each response. Origins keep the last load of
+     * each target, see HG_Addr_get_load() and HG_Addr_select().
+     * Default is: false */
+    hg_bool_t load_feedback;
+
+    /* Admission thresholds of targets. A request is rejected right away when
+     * admit_queue_max completions are already waiting to be triggered on its
+     * context, or when admitting it would exceed admit_active_max requests
+     * being processed (queued or executing) by the context. The origin then
+     * receives HG_AGAIN, the input is not decoded and the RPC callback is not
+     * executed. Rejected requests that do not expect a response are dropped.
+     * A value of 0 disables the corresponding threshold.
+     * Default is: 0 */
+    hg_uint32_t admit_queue_max;
+    hg_uint32_t admit_active_max;
+
+    /* Controls whether requests received by a context are dispatched fairly
+     * between origins instead of in arrival order. Origins are hashed into
+     * buckets that are served with deficit round-robin on request size, so
+     * that an origin sending many requests cannot delay the requests of
+     * other origins behind its own. Requests that are completed directly by
+     * the trigger (integrated completion) are not rescheduled.
+     * Default is: false */
+    hg_bool_t fair_share;
+
+    /* Number of handles (with their msg buffers) and bulk op IDs that each
+     * context preallocates on creation, the handle pool of the context then
+     * keeps up to that many free handles. Requests posted by the context are
+     * taken from the same handles so the count should cover posted requests
+     * as well as RPCs and bulk transfers in flight. Allocations of the hot
+     * path that are not served from pools once it is exhausted are counted
+     * in hg_context_stats.alloc_fallback_count. A value of 0 disables
+     * preallocation.
+     * Default is: 0 */
+    hg_uint32_t prealloc_count;
+
+    /* Path of a workload capture file. When set, every forward that
+     * completes is recorded with its time, RPC ID, encoded input and output
+     * sizes, size of the bulk memory exposed by its input and a hash of its
+     * target (see mercury_capture.h), so that the workload can be replayed
+     * against a test server with the hg_replay benchmark.
+     * Default is: NULL */
+    const char *capture_file;
 };
 
 /* Error return codes:
@@ -119,6 +371,110 @@ typedef enum hg_cb_type {
     HG_CB_BULK     /*!< bulk transfer callback */
 } hg_cb_type_t;
 
+/* RPC priority classes, completions of RPCs with a higher priority are
+ * triggered first */
+typedef enum hg_priority {
+    HG_PRIORITY_HIGH,   /*!< latency-sensitive RPCs */
+    HG_PRIORITY_NORMAL, /*!< default */
+    HG_PRIORITY_LOW,    /*!< background RPCs */
+    HG_PRIORITY_MAX
+} hg_priority_t;
+
+/* RPC statistics (see HG_Core_class_get_stats()) */
+struct hg_rpc_stats {
+    hg_id_t id;                /* RPC ID */
+    hg_uint64_t forward_count; /* Requests forwarded */
+    hg_uint64_t handle_count;  /* Requests received */
+    hg_uint64_t extra_count;   /* Messages sent/received with extra payload */
+    hg_uint64_t bytes_in;      /* Bytes of requests received */
+    hg_uint64_t bytes_out;     /* Bytes of requests and responses sent */
+    hg_uint64_t reject_count;  /* Requests rejected by admission control */
+};
+
+/* Class statistics, totals over all RPCs */
+struct hg_class_stats {
+    hg_uint64_t forward_count; /* Requests forwarded */
+    hg_uint64_t handle_count;  /* Requests received */
+    hg_uint64_t extra_count;   /* Messages sent/received with extra payload */
+    hg_uint64_t bytes_in;      /* Bytes of requests received */
+    hg_uint64_t bytes_out;     /* Bytes of requests and responses sent */
+    hg_uint64_t bulk_count;    /* Bulk transfers completed */
+    hg_uint64_t reject_count;  /* Requests rejected by admission control */
+};
+
+/* RPC latency stages (see HG_Core_class_get_latency()) */
+typedef enum hg_latency_stage {
+    HG_LATENCY_ORIGIN_SEND,    /*!< forward to request sent */
+    HG_LATENCY_ORIGIN_WAIT,    /*!< request sent to response received */
+    HG_LATENCY_ORIGIN_TRIGGER, /*!< response received to callback triggered */
+    HG_LATENCY_ORIGIN_TOTAL,   /*!< forward to callback triggered */
+    HG_LATENCY_TARGET_QUEUE,   /*!< request received to handler dispatched */
+    HG_LATENCY_TARGET_HANDLER, /*!< handler dispatched to respond */
+    HG_LATENCY_TARGET_TOTAL,   /*!< request received to respond */
+    HG_LATENCY_MAX
+} hg_latency_stage_t;
+
+/* Latency summary of an RPC stage, values are in nanoseconds */
+struct hg_latency_stats {
+    hg_uint64_t count; /* Number of samples */
+    hg_uint64_t min;   /* Min latency */
+    hg_uint64_t max;   /* Max latency */
+    hg_uint64_t mean;  /* Mean latency */
+    hg_uint64_t p50;   /* Median latency */
+    hg_uint64_t p90;   /* 90th percentile */
+    hg_uint64_t p99;   /* 99th percentile */
+    hg_uint64_t p999;  /* 99.9th percentile */
+};
+
+/* Memory accounted per context (see hg_init_info.mem_soft_limit) */
+typedef enum hg_mem_use {
+    HG_MEM_USE_HANDLE,   /*!< handles and their msg buffers */
+    HG_MEM_USE_OVERFLOW, /*!< payloads that did not fit into msg buffers */
+    HG_MEM_USE_BULK,     /*!< bulk op IDs */
+    HG_MEM_USE_MAX
+} hg_mem_use_t;
+
+/* Context statistics, instantaneous levels */
+struct hg_context_stats {
+    hg_uint32_t completion_count;          /* Entries in completion queues */
+    hg_uint32_t handle_count;              /* Handles in use */
+    hg_uint32_t handle_pool_count;         /* Free handles kept for re-use */
+    hg_uint32_t posted_count;              /* Requests owned by the context */
+    hg_uint32_t pending_count;             /* Requests currently posted */
+    hg_uint32_t timer_count;               /* Forwards with an armed deadline */
+    hg_uint64_t mem_bytes[HG_MEM_USE_MAX]; /* Memory used (bytes) per use */
+    hg_uint32_t mem_throttle_count;        /* Posts/overflows denied */
+    hg_uint32_t alloc_fallback_count; /* Allocations not served by pools */
+};
+
+/* Handle events recorded in trace files (see hg_init_info.trace_prefix) */
+typedef enum hg_trace_type {
+    HG_TRACE_CREATE,  /*!< handle created or reposted */
+    HG_TRACE_POST,    /*!< unexpected recv posted */
+    HG_TRACE_FORWARD, /*!< request forwarded */
+    HG_TRACE_RESPOND, /*!< response issued */
+    HG_TRACE_SEND,    /*!< request or response sent */
+    HG_TRACE_RECV,    /*!< request or response received */
+    HG_TRACE_ACK,     /*!< more data ack sent or received */
+    HG_TRACE_TRIGGER, /*!< completion triggered */
+    HG_TRACE_DESTROY, /*!< handle released */
+    HG_TRACE_MAX
+} hg_trace_type_t;
+
+/* Events reported to instrumentation hooks (see HG_Core_class_set_hooks()) */
+typedef enum hg_hook_type {
+    HG_HOOK_FORWARD,          /*!< request about to be forwarded */
+    HG_HOOK_FORWARD_COMPLETE, /*!< forward completed, before its callback */
+    HG_HOOK_REQUEST,          /*!< request received */
+    HG_HOOK_HANDLER_START,    /*!< RPC callback about to be executed */
+    HG_HOOK_HANDLER_END,      /*!< RPC callback returned */
+    HG_HOOK_RESPOND,          /*!< response issued */
+    HG_HOOK_BULK_START,       /*!< bulk transfer started */
+    HG_HOOK_BULK_COMPLETE,    /*!< bulk transfer completed */
+    HG_HOOK_RETRY,            /*!< NA operation retried by plugin */
+    HG_HOOK_MAX
+} hg_hook_type_t;
+
 /* Input / output operation type */
 typedef enum { HG_UNDEF, HG_INPUT, HG_OUTPUT } hg_op_t;
 
@@ -128,8 +484,10 @@ typedef enum { HG_UNDEF, HG_INPUT, HG_OUTPUT } hg_op_t;
 typedef enum {
     HG_ENCODE, /*!< causes the type to be encoded into the stream */
     HG_DECODE, /*!< causes the type to be extracted from the stream */
-    HG_FREE    /*!< can be used to release the space allocated by an HG_DECODE
+    HG_FREE,   /*!< can be used to release the space allocated by an HG_DECODE
                   request */
+    HG_SIZE    /*!< causes the encoded size of the type to be computed without
+                  writing to the stream */
 } hg_proc_op_t;
 
 /**
@@ -144,6 +502,12 @@ typedef enum {
 /* Max timeout */
 #define HG_MAX_IDLE_TIME (3600 * 1000)
 
+/* Max number of NA rails (see hg_init_info.na_rails) */
+#define HG_CORE_RAIL_MAX (4)
+
+/* Max size of trace context carried in request headers (see hg_core_hooks) */
+#define HG_HOOK_TRACE_CTX_MAX (64)
+
 /* HG size max */
 #define HG_SIZE_MAX (UINT64_MAX)
 
@@ -151,7 +515,10 @@ typedef enum {
 #define HG_INIT_INFO_INITIALIZER                                               \
     {                                                                          \
         NA_INIT_INFO_INITIALIZER, NULL, 0, 0, HG_FALSE, HG_FALSE, HG_FALSE,    \
-            HG_FALSE                                                           \
+            HG_FALSE, 0, 0, 0, 0, NULL, 0, 0, 0, 0, HG_FALSE, HG_FALSE, 0,     \
+            HG_FALSE, 0, HG_FALSE, 0, HG_FALSE, NULL, HG_FALSE, HG_FALSE,      \
+            HG_FALSE, NULL, HG_FALSE, 0, 0, 0, HG_FALSE, 0, 0, HG_FALSE, 0,    \
+            NULL                                                               \
     }
 
 #endif /* MERCURY_CORE_TYPES_H */
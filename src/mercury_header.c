@@ -93,6 +93,8 @@ hg_header_proc(
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash *header_hash = NULL;
 #endif
+    struct hg_header_comp *header_comp = NULL;
+    hg_uint32_t *header_extra = NULL;
     hg_return_t ret = HG_SUCCESS;
 
     switch (hg_header->op) {
@@ -102,6 +104,8 @@ hg_header_proc(
 #ifdef HG_HAS_CHECKSUMS
             header_hash = &hg_header->msg.input.hash;
 #endif
+            header_comp = &hg_header->msg.input.comp;
+            header_extra = &hg_header->msg.input.flags;
             break;
         case HG_OUTPUT:
             HG_CHECK_ERROR(buf_size < sizeof(struct hg_header_output), done,
@@ -109,6 +113,8 @@ hg_header_proc(
 #ifdef HG_HAS_CHECKSUMS
             header_hash = &hg_header->msg.output.hash;
 #endif
+            header_comp = &hg_header->msg.output.comp;
+            header_extra = &hg_header->msg.output.resp_size;
             break;
         default:
             HG_GOTO_ERROR(done, ret, HG_INVALID_ARG, "Invalid header op");
@@ -117,12 +123,15 @@ hg_header_proc(
 #ifdef HG_HAS_CHECKSUMS
     /* Checksum of user payload */
     HG_HEADER_PROC_TYPE(buf_ptr, header_hash->payload, hg_uint32_t, op);
-#else
-    (void) hg_header;
-    (void) buf_ptr;
-    (void) op;
 #endif
 
+    /* Compressed payload sizes */
+    HG_HEADER_PROC_TYPE(buf_ptr, header_comp->size, hg_uint32_t, op);
+    HG_HEADER_PROC_TYPE(buf_ptr, header_comp->orig_size, hg_uint32_t, op);
+
+    /* Input flags / size of output written to response buffer */
+    HG_HEADER_PROC_TYPE(buf_ptr, *header_extra, hg_uint32_t, op);
+
 done:
     return ret;
 }
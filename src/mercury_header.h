@@ -29,21 +29,28 @@ struct hg_header_hash {
 };
 #endif
 
+/* Sizes are 0 if payload is not compressed */
+struct hg_header_comp {
+    hg_uint32_t size;      /* Size of compressed payload */
+    hg_uint32_t orig_size; /* Size of payload before compression */
+};
+
 struct hg_header_input {
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash hash; /* Hash */
-#else
-    hg_uint32_t pad;
 #endif
-    /* 160 bits here */
+    struct hg_header_comp comp; /* Compression */
+    hg_uint32_t flags;          /* Input flags */
+    /* 256/192 bits here */
 };
 
 struct hg_header_output {
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash hash; /* Hash */
 #endif
-    hg_uint32_t pad;
-    /* 128/64 bits here */
+    struct hg_header_comp comp; /* Compression */
+    hg_uint32_t resp_size;      /* Payload written to response buffer */
+    /* 192/128 bits here */
 };
 #if defined(__GNUC__) || defined(_WIN32)
 #    pragma pack(pop)
@@ -62,6 +69,9 @@ struct hg_header {
 /* Public Macros */
 /*****************/
 
+/* Input flags */
+#define HG_HEADER_RESP_BULK (1 << 0) /* Response buffer precedes payload */
+
 /*********************/
 /* Public Prototypes */
 /*********************/
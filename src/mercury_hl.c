@@ -8,9 +8,19 @@
  * found at the root of the source code distribution tree.
  */
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#    define _GNU_SOURCE
+#endif
 #include "mercury_hl.h"
 #include "mercury_error.h"
 
+#include "mercury_atomic.h"
+#include "mercury_hash_table.h"
+#include "mercury_queue.h"
+#include "mercury_thread.h"
+#include "mercury_time.h"
+
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************/
@@ -20,6 +30,22 @@
 /* Environment variable names (to be removed) */
 #define HG_PORT_NAME "MERCURY_PORT_NAME"
 
+/* Number of futures waited on without allocating */
+#define HG_HL_FUTURE_WAIT_STACK (64)
+
+/* Engine defaults */
+#define HG_ENGINE_SPIN_MAX_DEFAULT      (50)   /* us */
+#define HG_ENGINE_DRAIN_TIMEOUT_DEFAULT (1000) /* ms */
+
+/* Busy polling never gets shorter than that (us) */
+#define HG_ENGINE_SPIN_MIN (1)
+
+/* Timeout (ms) of blocking calls, threads check for exit at that rate */
+#define HG_ENGINE_PROGRESS_TIMEOUT (100)
+
+/* Max number of callbacks triggered at once */
+#define HG_ENGINE_TRIGGER_COUNT (16)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -28,6 +54,59 @@ struct hg_lookup_request_arg {
     hg_request_t *request;
 };
 
+/* Forwards in flight to a given target */
+struct hg_window_target {
+    hg_addr_t addr;        /* Target address (key) */
+    unsigned int inflight; /* Forwards in flight */
+};
+
+/* Forward issued through a window */
+struct hg_window_entry {
+    HG_QUEUE_ENTRY(hg_window_entry) entry; /* Entry in ordered queue */
+    struct hg_window *window;              /* Window */
+    struct hg_window_target *target;       /* Target */
+    hg_cb_t callback;                      /* User callback */
+    void *arg;                             /* User callback arg */
+    struct hg_cb_info callback_info;       /* Saved completion info */
+    hg_bool_t completed;                   /* Forward completed */
+};
+
+struct hg_window {
+    hg_request_class_t *request_class;      /* Request class */
+    hg_request_t *request;                  /* Signaled on completions */
+    hg_hash_table_t *targets;               /* Targets (addr -> target) */
+    HG_QUEUE_HEAD(hg_window_entry) entries; /* Forwards in issue order */
+    unsigned int max_inflight;              /* Max in flight per target */
+    unsigned int inflight;                  /* Total forwards in flight */
+    hg_bool_t ordered;                      /* Callbacks in issue order */
+};
+
+struct hg_future {
+    hg_request_t *request;           /* Completed with operation */
+    hg_cb_t callback;                /* Continuation */
+    void *arg;                       /* Continuation arg */
+    struct hg_cb_info callback_info; /* Saved completion info */
+    hg_bool_t completed;             /* Operation completed */
+};
+
+/* Context of an engine and its threads */
+struct hg_engine_context {
+    struct hg_engine *engine;  /* Engine */
+    hg_context_t *context;     /* HG context */
+    hg_thread_t *threads;      /* Progress threads, then handler threads */
+    unsigned int thread_count; /* Number of threads started */
+};
+
+struct hg_engine {
+    struct hg_engine_context *contexts; /* Contexts */
+    unsigned int context_count;         /* Number of contexts */
+    unsigned int progress_count;        /* Progress threads per context */
+    unsigned int handler_count;         /* Handler threads per context */
+    double spin_max;                    /* Max busy polling (s) */
+    unsigned int drain_timeout;         /* Max drain time (ms) */
+    hg_atomic_int32_t exit;             /* Threads must exit */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -50,6 +129,41 @@ hg_hl_bulk_transfer_cb(const struct hg_cb_info *callback_info);
 static void
 hg_hl_finalize(void);
 
+static unsigned int
+hg_window_addr_hash(hg_hash_table_key_t key);
+
+static int
+hg_window_addr_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+static hg_return_t
+hg_window_forward_cb(const struct hg_cb_info *callback_info);
+
+static hg_return_t
+hg_window_wait_until(hg_window_t *window, struct hg_window_target *target,
+    unsigned int timeout);
+
+static hg_return_t
+hg_future_cb(const struct hg_cb_info *callback_info);
+
+static hg_return_t
+hg_future_continue(struct hg_future *future);
+
+static HG_THREAD_RETURN_TYPE
+hg_engine_progress_thread(void *arg);
+
+static HG_THREAD_RETURN_TYPE
+hg_engine_handler_thread(void *arg);
+
+static hg_return_t
+hg_engine_threads_start(struct hg_engine_context *engine_context,
+    unsigned int index, const struct hg_engine_info *engine_info);
+
+static hg_bool_t
+hg_engine_idle(struct hg_engine *engine);
+
+static hg_return_t
+hg_engine_free(struct hg_engine *engine);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -133,6 +247,340 @@ hg_hl_finalize(void)
     HG_Hl_finalize();
 }
 
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_window_addr_hash(hg_hash_table_key_t key)
+{
+    uintptr_t value = (uintptr_t) key;
+
+    /* Low bits of heap pointers do not carry much entropy */
+    return (unsigned int) ((value >> 4) ^ (value >> 16));
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_window_addr_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return key1 == key2;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_window_forward_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_window_entry *hg_window_entry =
+        (struct hg_window_entry *) callback_info->arg;
+    struct hg_window *window = hg_window_entry->window;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_window_entry->callback_info = *callback_info;
+    hg_window_entry->callback_info.arg = hg_window_entry->arg;
+    hg_window_entry->completed = HG_TRUE;
+    hg_window_entry->target->inflight--;
+    window->inflight--;
+
+    if (!window->ordered) {
+        if (hg_window_entry->callback)
+            ret = hg_window_entry->callback(&hg_window_entry->callback_info);
+        free(hg_window_entry);
+    } else {
+        /* Execute callbacks of forwards that completed in order */
+        while (!HG_QUEUE_IS_EMPTY(&window->entries)) {
+            hg_return_t cb_ret = HG_SUCCESS;
+
+            hg_window_entry = HG_QUEUE_FIRST(&window->entries);
+            if (!hg_window_entry->completed)
+                break;
+            HG_QUEUE_POP_HEAD(&window->entries, entry);
+
+            if (hg_window_entry->callback)
+                cb_ret =
+                    hg_window_entry->callback(&hg_window_entry->callback_info);
+            if (ret == HG_SUCCESS)
+                ret = cb_ret;
+            free(hg_window_entry);
+        }
+    }
+
+    /* Wake up waiters */
+    hg_request_complete(window->request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_window_wait_until(hg_window_t *window, struct hg_window_target *target,
+    unsigned int timeout)
+{
+    hg_time_t deadline, now;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout));
+
+    /* Wait for room in target window or for all forwards to complete */
+    for (;;) {
+        unsigned int flag = 0, remaining = 0;
+
+        /* Reset before checking so that completions are not missed */
+        hg_request_reset(window->request);
+        if (target ? (target->inflight < window->max_inflight)
+                   : (window->inflight == 0))
+            break;
+
+        if (hg_time_less(now, deadline))
+            remaining = hg_time_to_ms(hg_time_subtract(deadline, now));
+        hg_request_wait(window->request, remaining, &flag);
+        if (flag)
+            continue;
+
+        hg_time_get_current_ms(&now);
+        if (!hg_time_less(now, deadline)) {
+            ret = HG_TIMEOUT;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_future_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_future *future = (struct hg_future *) callback_info->arg;
+    hg_return_t ret;
+
+    future->callback_info = *callback_info;
+    future->completed = HG_TRUE;
+
+    ret = hg_future_continue(future);
+
+    /* Complete after continuation so that waiters observe its result */
+    hg_request_complete(future->request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_future_continue(struct hg_future *future)
+{
+    hg_cb_t callback = future->callback;
+    hg_return_t ret;
+
+    if (!callback)
+        return HG_SUCCESS;
+    future->callback = NULL;
+
+    future->callback_info.arg = future->arg;
+    ret = callback(&future->callback_info);
+    if (future->callback_info.ret == HG_SUCCESS)
+        future->callback_info.ret = ret;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_engine_progress_thread(void *arg)
+{
+    struct hg_engine_context *engine_context =
+        (struct hg_engine_context *) arg;
+    struct hg_engine *engine = engine_context->engine;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+    double spin = engine->spin_max;
+    hg_bool_t idle = HG_FALSE, spinning = HG_TRUE;
+    hg_time_t idle_start = hg_time_from_ms(0);
+
+    while (!hg_atomic_get32(&engine->exit)) {
+        hg_return_t ret;
+
+        if (engine->handler_count == 0) {
+            unsigned int actual_count = 0;
+
+            do {
+                ret = HG_Trigger(engine_context->context, 0,
+                    HG_ENGINE_TRIGGER_COUNT, &actual_count);
+            } while ((ret == HG_SUCCESS) && actual_count);
+            HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
+                "Could not trigger callbacks (%s)", HG_Error_to_string(ret));
+        }
+
+        /* Keep polling without blocking for a while once idle */
+        if (idle && spinning) {
+            hg_time_t now;
+
+            hg_time_get_current(&now);
+            if (hg_time_diff(now, idle_start) >= spin) {
+                /* Busy polling was wasted, block sooner next time */
+                spin = spin / 2;
+                if (spin < HG_ENGINE_SPIN_MIN / 1000000.0)
+                    spin = HG_ENGINE_SPIN_MIN / 1000000.0;
+                spinning = HG_FALSE;
+            }
+        }
+
+        ret = HG_Progress(engine_context->context,
+            spinning ? 0 : HG_ENGINE_PROGRESS_TIMEOUT);
+        HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
+            "Could not make progress (%s)", HG_Error_to_string(ret));
+        if (ret == HG_SUCCESS) {
+            /* Busy polling paid off, poll longer next time */
+            if (idle && spinning) {
+                spin = spin * 2;
+                if (spin > engine->spin_max)
+                    spin = engine->spin_max;
+            }
+            idle = HG_FALSE;
+            spinning = HG_TRUE;
+        } else if (!idle) {
+            idle = HG_TRUE;
+            hg_time_get_current(&idle_start);
+        }
+    }
+
+done:
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_engine_handler_thread(void *arg)
+{
+    struct hg_engine_context *engine_context =
+        (struct hg_engine_context *) arg;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+
+    while (!hg_atomic_get32(&engine_context->engine->exit)) {
+        unsigned int actual_count = 0;
+        hg_return_t ret = HG_Trigger(engine_context->context,
+            HG_ENGINE_PROGRESS_TIMEOUT, HG_ENGINE_TRIGGER_COUNT, &actual_count);
+        HG_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, done,
+            "Could not trigger callbacks (%s)", HG_Error_to_string(ret));
+    }
+
+done:
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_engine_threads_start(struct hg_engine_context *engine_context,
+    unsigned int index, const struct hg_engine_info *engine_info)
+{
+    struct hg_engine *engine = engine_context->engine;
+    unsigned int thread_count = engine->progress_count + engine->handler_count;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    engine_context->threads =
+        (hg_thread_t *) malloc(thread_count * sizeof(hg_thread_t));
+    HG_CHECK_ERROR(engine_context->threads == NULL, done, ret, HG_NOMEM,
+        "Could not allocate engine threads");
+
+    for (i = 0; i < thread_count; i++) {
+        int rc = hg_thread_create(&engine_context->threads[i],
+            (i < engine->progress_count) ? hg_engine_progress_thread
+                                         : hg_engine_handler_thread,
+            engine_context);
+        HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_NOMEM,
+            "Could not create engine thread");
+        engine_context->thread_count++;
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+        /* Progress threads of all contexts use the CPUs in turn, failing is
+         * not fatal */
+        if (i < engine->progress_count && engine_info &&
+            engine_info->cpus && engine_info->cpu_count > 0) {
+            unsigned int n = index * engine->progress_count + i;
+            int cpu = engine_info->cpus[n % engine_info->cpu_count];
+            hg_cpu_set_t cpu_mask;
+
+            CPU_ZERO(&cpu_mask);
+            CPU_SET(cpu, &cpu_mask);
+            rc = hg_thread_setaffinity(engine_context->threads[i], &cpu_mask);
+            HG_CHECK_WARNING(rc != HG_UTIL_SUCCESS,
+                "Could not pin progress thread to CPU %d", cpu);
+        }
+#else
+        (void) index;
+        (void) engine_info;
+#endif
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_engine_idle(struct hg_engine *engine)
+{
+    unsigned int i;
+
+    for (i = 0; i < engine->context_count; i++) {
+        struct hg_context_stats stats;
+
+        if (HG_Context_get_stats(engine->contexts[i].context, &stats) !=
+            HG_SUCCESS)
+            continue;
+
+        /* Handles left are either posted or kept for re-use */
+        if (stats.completion_count > 0 ||
+            stats.handle_count > stats.pending_count + stats.handle_pool_count)
+            return HG_FALSE;
+    }
+
+    return HG_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_engine_free(struct hg_engine *engine)
+{
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i, j;
+
+    if (engine->contexts == NULL)
+        goto out;
+
+    /* Stop threads of all contexts first, callbacks may use other contexts */
+    hg_atomic_set32(&engine->exit, 1);
+    for (i = 0; i < engine->context_count; i++) {
+        struct hg_engine_context *engine_context = &engine->contexts[i];
+
+        for (j = 0; j < engine_context->thread_count; j++) {
+            int rc = hg_thread_join(engine_context->threads[j]);
+            HG_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_PROTOCOL_ERROR,
+                "Could not join engine thread");
+        }
+        engine_context->thread_count = 0;
+    }
+
+    for (i = 0; i < engine->context_count; i++) {
+        struct hg_engine_context *engine_context = &engine->contexts[i];
+
+        if (engine_context->context) {
+            ret = HG_Context_destroy(engine_context->context);
+            HG_CHECK_HG_ERROR(done, ret, "Could not destroy context (%s)",
+                HG_Error_to_string(ret));
+            engine_context->context = NULL;
+        }
+        free(engine_context->threads);
+        engine_context->threads = NULL;
+    }
+
+    free(engine->contexts);
+
+out:
+    free(engine);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Hl_init(const char *na_info_string, hg_bool_t na_listen)
@@ -348,3 +796,440 @@ HG_Hl_bulk_transfer_wait(hg_context_t *context,
 done:
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+hg_window_t *
+HG_Window_create(hg_request_class_t *request_class, unsigned int max_inflight,
+    hg_bool_t ordered)
+{
+    struct hg_window *window = NULL;
+
+    HG_CHECK_ERROR_NORET(
+        request_class == NULL, error, "Uninitialized request class");
+    HG_CHECK_ERROR_NORET(
+        max_inflight == 0, error, "Window must allow one forward in flight");
+
+    window = (struct hg_window *) malloc(sizeof(struct hg_window));
+    HG_CHECK_ERROR_NORET(window == NULL, error, "Could not allocate window");
+    window->request_class = request_class;
+    window->request = NULL;
+    window->targets = NULL;
+    HG_QUEUE_INIT(&window->entries);
+    window->max_inflight = max_inflight;
+    window->inflight = 0;
+    window->ordered = ordered;
+
+    window->request = hg_request_create(request_class);
+    HG_CHECK_ERROR_NORET(
+        window->request == NULL, error, "Could not create request");
+
+    window->targets =
+        hg_hash_table_new(hg_window_addr_hash, hg_window_addr_equal);
+    HG_CHECK_ERROR_NORET(
+        window->targets == NULL, error, "Could not allocate target table");
+    hg_hash_table_register_free_functions(window->targets, NULL, free);
+
+    return window;
+
+error:
+    if (window) {
+        if (window->request)
+            hg_request_destroy(window->request);
+        free(window);
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Window_destroy(hg_window_t *window)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (window == NULL)
+        goto done;
+
+    HG_CHECK_ERROR(window->inflight > 0, done, ret, HG_BUSY,
+        "Window still has %u forwards in flight", window->inflight);
+
+    hg_hash_table_free(window->targets);
+    hg_request_destroy(window->request);
+    free(window);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Forward_window(hg_window_t *window, hg_handle_t handle, hg_cb_t callback,
+    void *arg, void *in_struct, unsigned int timeout)
+{
+    struct hg_window_entry *hg_window_entry = NULL;
+    struct hg_window_target *target;
+    const struct hg_info *hg_info;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(window == NULL, error, ret, HG_INVALID_ARG, "NULL window");
+    HG_CHECK_ERROR(
+        handle == HG_HANDLE_NULL, error, ret, HG_INVALID_ARG, "NULL handle");
+
+    hg_info = HG_Get_info(handle);
+    HG_CHECK_ERROR(hg_info == NULL, error, ret, HG_FAULT, "Could not get info");
+
+    /* Look up or add target */
+    target = (struct hg_window_target *) hg_hash_table_lookup(
+        window->targets, (hg_hash_table_key_t) hg_info->addr);
+    if (target == HG_HASH_TABLE_NULL) {
+        int rc;
+
+        target = (struct hg_window_target *) malloc(
+            sizeof(struct hg_window_target));
+        HG_CHECK_ERROR(target == NULL, error, ret, HG_NOMEM,
+            "Could not allocate window target");
+        target->addr = hg_info->addr;
+        target->inflight = 0;
+
+        rc = hg_hash_table_insert(window->targets,
+            (hg_hash_table_key_t) target->addr, (hg_hash_table_value_t) target);
+        if (rc == 0) {
+            free(target);
+            HG_GOTO_ERROR(
+                error, ret, HG_NOMEM, "Could not insert window target");
+        }
+    }
+
+    /* Back-pressure, wait for room in target window */
+    ret = hg_window_wait_until(window, target, timeout);
+    if (ret != HG_SUCCESS)
+        goto error;
+
+    hg_window_entry =
+        (struct hg_window_entry *) malloc(sizeof(struct hg_window_entry));
+    HG_CHECK_ERROR(hg_window_entry == NULL, error, ret, HG_NOMEM,
+        "Could not allocate window entry");
+    hg_window_entry->window = window;
+    hg_window_entry->target = target;
+    hg_window_entry->callback = callback;
+    hg_window_entry->arg = arg;
+    hg_window_entry->completed = HG_FALSE;
+
+    target->inflight++;
+    window->inflight++;
+    if (window->ordered)
+        HG_QUEUE_PUSH_TAIL(&window->entries, hg_window_entry, entry);
+
+    ret = HG_Forward(handle, hg_window_forward_cb, hg_window_entry, in_struct);
+    if (ret != HG_SUCCESS) {
+        target->inflight--;
+        window->inflight--;
+        if (window->ordered)
+            HG_QUEUE_REMOVE(
+                &window->entries, hg_window_entry, hg_window_entry, entry);
+        HG_GOTO_ERROR(error, ret, ret, "Could not forward call");
+    }
+
+    return HG_SUCCESS;
+
+error:
+    free(hg_window_entry);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Window_wait(hg_window_t *window, unsigned int timeout)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(window == NULL, done, ret, HG_INVALID_ARG, "NULL window");
+
+    ret = hg_window_wait_until(window, NULL, timeout);
+    HG_CHECK_HG_ERROR(done, ret, "Window did not complete");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+unsigned int
+HG_Window_inflight(const hg_window_t *window)
+{
+    return window ? window->inflight : 0;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Hl_forward_async(hg_request_class_t *request_class, hg_handle_t handle,
+    void *in_struct, hg_future_t **future_p)
+{
+    struct hg_future *future = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(request_class == NULL, error, ret, HG_INVALID_ARG,
+        "Uninitialized request class");
+    HG_CHECK_ERROR(
+        handle == HG_HANDLE_NULL, error, ret, HG_INVALID_ARG, "NULL handle");
+    HG_CHECK_ERROR(
+        future_p == NULL, error, ret, HG_INVALID_ARG, "NULL future pointer");
+
+    future = (struct hg_future *) malloc(sizeof(struct hg_future));
+    HG_CHECK_ERROR(
+        future == NULL, error, ret, HG_NOMEM, "Could not allocate future");
+    future->callback = NULL;
+    future->arg = NULL;
+    future->completed = HG_FALSE;
+
+    future->request = hg_request_create(request_class);
+    HG_CHECK_ERROR(future->request == NULL, error, ret, HG_NOMEM,
+        "Could not create request");
+
+    ret = HG_Forward(handle, hg_future_cb, future, in_struct);
+    HG_CHECK_HG_ERROR(error, ret, "Could not forward call");
+
+    *future_p = future;
+
+    return HG_SUCCESS;
+
+error:
+    if (future) {
+        if (future->request)
+            hg_request_destroy(future->request);
+        free(future);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Hl_future_then(hg_future_t *future, hg_cb_t callback, void *arg)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(future == NULL, done, ret, HG_INVALID_ARG, "NULL future");
+    HG_CHECK_ERROR(future->callback != NULL, done, ret, HG_BUSY,
+        "Future already has a continuation");
+
+    future->callback = callback;
+    future->arg = arg;
+
+    /* Continue right away if operation already completed */
+    if (future->completed)
+        ret = hg_future_continue(future);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Hl_future_wait_all(
+    unsigned int count, hg_future_t *futures[], unsigned int timeout)
+{
+    hg_time_t deadline, now;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    HG_CHECK_ERROR(
+        count > 0 && futures == NULL, done, ret, HG_INVALID_ARG, "NULL futures");
+
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout));
+
+    for (i = 0; i < count; i++) {
+        unsigned int flag = 0, remaining = 0;
+
+        if (hg_time_less(now, deadline))
+            remaining = hg_time_to_ms(hg_time_subtract(deadline, now));
+        hg_request_wait(futures[i]->request, remaining, &flag);
+        if (!flag) {
+            ret = HG_TIMEOUT;
+            break;
+        }
+        hg_time_get_current_ms(&now);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Hl_future_wait_any(unsigned int count, hg_future_t *futures[],
+    unsigned int timeout, unsigned int *index)
+{
+    hg_request_t *requests_buf[HG_HL_FUTURE_WAIT_STACK];
+    hg_request_t **requests = requests_buf;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+    int completed = -1;
+
+    HG_CHECK_ERROR(count == 0 || futures == NULL, done, ret, HG_INVALID_ARG,
+        "No futures to wait on");
+
+    if (count > HG_HL_FUTURE_WAIT_STACK) {
+        requests = (hg_request_t **) malloc(count * sizeof(hg_request_t *));
+        HG_CHECK_ERROR(requests == NULL, done, ret, HG_NOMEM,
+            "Could not allocate request array");
+    }
+    for (i = 0; i < count; i++)
+        requests[i] = futures[i]->request;
+
+    hg_request_waitany((int) count, requests, timeout, &completed);
+    if (completed < 0)
+        ret = HG_TIMEOUT;
+    else if (index)
+        *index = (unsigned int) completed;
+
+    if (requests != requests_buf)
+        free(requests);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+HG_Hl_future_completed(const hg_future_t *future)
+{
+    return future ? future->completed : HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Hl_future_get_return(const hg_future_t *future)
+{
+    hg_return_t ret;
+
+    HG_CHECK_ERROR(future == NULL, done, ret, HG_INVALID_ARG, "NULL future");
+
+    ret = future->completed ? future->callback_info.ret : HG_BUSY;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Hl_future_free(hg_future_t *future)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (future == NULL)
+        goto done;
+
+    HG_CHECK_ERROR(!future->completed, done, ret, HG_BUSY,
+        "Future has not completed yet");
+
+    hg_request_destroy(future->request);
+    free(future);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_engine_t *
+HG_Engine_create(
+    hg_class_t *hg_class, const struct hg_engine_info *engine_info)
+{
+    struct hg_engine *engine = NULL;
+    unsigned int context_id = 0, i;
+
+    HG_CHECK_ERROR_NORET(hg_class == NULL, error, "NULL HG class");
+
+    engine = (struct hg_engine *) calloc(1, sizeof(*engine));
+    HG_CHECK_ERROR_NORET(engine == NULL, error, "Could not allocate engine");
+    hg_atomic_init32(&engine->exit, 0);
+    engine->context_count = 1;
+    engine->progress_count = 1;
+    engine->spin_max = HG_ENGINE_SPIN_MAX_DEFAULT / 1000000.0;
+    engine->drain_timeout = HG_ENGINE_DRAIN_TIMEOUT_DEFAULT;
+    if (engine_info) {
+        context_id = engine_info->context_id;
+        if (engine_info->context_count > 0)
+            engine->context_count = engine_info->context_count;
+        if (engine_info->progress_count > 0)
+            engine->progress_count = engine_info->progress_count;
+        engine->handler_count = engine_info->handler_count;
+        if (engine_info->spin_max > 0)
+            engine->spin_max = engine_info->spin_max / 1000000.0;
+        if (engine_info->drain_timeout > 0)
+            engine->drain_timeout = engine_info->drain_timeout;
+    }
+    HG_CHECK_ERROR_NORET(context_id + engine->context_count - 1 > UINT8_MAX,
+        error, "Context IDs exceed %u", UINT8_MAX);
+
+    engine->contexts = (struct hg_engine_context *) calloc(
+        engine->context_count, sizeof(struct hg_engine_context));
+    HG_CHECK_ERROR_NORET(
+        engine->contexts == NULL, error, "Could not allocate contexts");
+
+    /* Create all contexts before threads start */
+    for (i = 0; i < engine->context_count; i++) {
+        struct hg_engine_context *engine_context = &engine->contexts[i];
+
+        engine_context->engine = engine;
+        engine_context->context =
+            HG_Context_create_id(hg_class, (hg_uint8_t) (context_id + i));
+        HG_CHECK_ERROR_NORET(engine_context->context == NULL, error,
+            "Could not create context %u", i);
+    }
+
+    for (i = 0; i < engine->context_count; i++) {
+        hg_return_t ret =
+            hg_engine_threads_start(&engine->contexts[i], i, engine_info);
+        HG_CHECK_HG_ERROR(
+            error, ret, "Could not start threads of context %u", i);
+    }
+
+    return engine;
+
+error:
+    if (engine)
+        (void) hg_engine_free(engine);
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Engine_destroy(hg_engine_t *engine)
+{
+    hg_time_t deadline, now;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (engine == NULL)
+        goto done;
+
+    /* Let threads execute the callbacks of operations in flight */
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(engine->drain_timeout));
+    while (!hg_engine_idle(engine)) {
+        hg_time_get_current_ms(&now);
+        if (!hg_time_less(now, deadline)) {
+            HG_LOG_WARNING("Engine could not be drained within %u ms",
+                engine->drain_timeout);
+            break;
+        }
+        hg_time_sleep(hg_time_from_ms(1));
+    }
+
+    ret = hg_engine_free(engine);
+    HG_CHECK_HG_ERROR(done, ret, "Could not free engine");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_context_t *
+HG_Engine_get_context(const hg_engine_t *engine, unsigned int index)
+{
+    if (engine == NULL || index >= engine->context_count)
+        return NULL;
+
+    return engine->contexts[index].context;
+}
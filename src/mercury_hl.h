@@ -28,6 +28,26 @@
 #define HG_CONTEXT_DEFAULT       hg_context_default_g
 #define HG_REQUEST_CLASS_DEFAULT hg_request_class_default_g
 
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+typedef struct hg_window hg_window_t;
+typedef struct hg_future hg_future_t;
+typedef struct hg_engine hg_engine_t;
+
+/* Engine options, fields left to 0 select default values */
+struct hg_engine_info {
+    unsigned int context_count;  /* Number of contexts (default: 1) */
+    hg_uint8_t context_id;       /* ID of first context, others follow */
+    unsigned int progress_count; /* Progress threads per context (default: 1) */
+    unsigned int handler_count;  /* Handler threads per context */
+    const int *cpus;             /* CPUs progress threads are pinned to */
+    unsigned int cpu_count;      /* Number of CPUs in cpus */
+    unsigned int spin_max;       /* Max busy polling (us) (default: 50) */
+    unsigned int drain_timeout;  /* Max drain time (ms) (default: 1000) */
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -133,6 +153,218 @@ HG_Hl_bulk_transfer_wait(hg_context_t *context,
     hg_bulk_t origin_handle, hg_size_t origin_offset, hg_bulk_t local_handle,
     hg_size_t local_offset, hg_size_t size, unsigned int timeout);
 
+/**
+ * Create a window of pipelined forwards. At most \max_inflight forwards per
+ * target address are kept in flight, progress being made through
+ * \request_class when that limit is reached. If \ordered is set, callbacks
+ * of forwards are executed in the order forwards were issued, otherwise they
+ * are executed as soon as forwards complete.
+ * \remark Windows are not thread-safe and must be used from a single thread.
+ *
+ * \param request_class [IN]    pointer to request class
+ * \param max_inflight [IN]     max number of forwards in flight per target
+ * \param ordered [IN]          execute callbacks in issue order
+ *
+ * \return Pointer to window or NULL in case of failure
+ */
+HG_PUBLIC hg_window_t *
+HG_Window_create(hg_request_class_t *request_class, unsigned int max_inflight,
+    hg_bool_t ordered);
+
+/**
+ * Destroy a window. All forwards issued through the window must have
+ * completed, see HG_Window_wait().
+ *
+ * \param window [IN]           pointer to window
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Window_destroy(hg_window_t *window);
+
+/**
+ * Forward a call through a window. If the window of the handle's target is
+ * full, make progress until one of its forwards completes or \timeout
+ * expires, in which case HG_TIMEOUT is returned and the call is not
+ * forwarded. The handle must not be reused before \callback is executed.
+ *
+ * \param window [IN]           pointer to window
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         callback executed on completion
+ * \param arg [IN]              pointer to data passed to callback
+ * \param in_struct [IN]        pointer to input structure
+ * \param timeout [IN]          timeout (in milliseconds)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_window(hg_window_t *window, hg_handle_t handle, hg_cb_t callback,
+    void *arg, void *in_struct, unsigned int timeout);
+
+/**
+ * Make progress until all forwards issued through the window have completed
+ * and their callbacks have been executed.
+ *
+ * \param window [IN]           pointer to window
+ * \param timeout [IN]          timeout (in milliseconds)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Window_wait(hg_window_t *window, unsigned int timeout);
+
+/**
+ * Return the number of forwards of a window that are in flight.
+ *
+ * \param window [IN]           pointer to window
+ *
+ * \return Number of forwards
+ */
+HG_PUBLIC unsigned int
+HG_Window_inflight(const hg_window_t *window);
+
+/**
+ * Forward a call and return a future that completes with it. Completion is
+ * driven by whichever thread makes progress through \request_class, e.g.,
+ * when waiting on any future of that class. The handle must not be reused
+ * before the future has completed. Output can be queried using
+ * HG_Get_output() once the future has completed.
+ *
+ * \param request_class [IN]    pointer to request class
+ * \param handle [IN]           HG handle
+ * \param in_struct [IN]        pointer to input structure
+ * \param future_p [OUT]        pointer to returned future
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Hl_forward_async(hg_request_class_t *request_class, hg_handle_t handle,
+    void *in_struct, hg_future_t **future_p);
+
+/**
+ * Attach a continuation to a future. \callback is executed with the
+ * completion info of the future, its return value becoming the return value
+ * of the future if the operation itself succeeded. If the future has already
+ * completed, \callback is executed immediately. Continuations may issue new
+ * asynchronous forwards, which allows for chaining operations. Only one
+ * continuation can be attached to a future.
+ * \remark Futures are not thread-safe and must be used from a single thread.
+ *
+ * \param future [IN]           pointer to future
+ * \param callback [IN]         continuation
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Hl_future_then(hg_future_t *future, hg_cb_t callback, void *arg);
+
+/**
+ * Make progress until all futures have completed or \timeout expires.
+ * All futures must have been created from the same request class.
+ *
+ * \param count [IN]            number of futures
+ * \param futures [IN]          array of futures
+ * \param timeout [IN]          timeout (in milliseconds)
+ *
+ * \return HG_SUCCESS or HG_TIMEOUT if some futures did not complete
+ */
+HG_PUBLIC hg_return_t
+HG_Hl_future_wait_all(
+    unsigned int count, hg_future_t *futures[], unsigned int timeout);
+
+/**
+ * Make progress until one of the futures has completed or \timeout expires.
+ * All futures must have been created from the same request class.
+ *
+ * \param count [IN]            number of futures
+ * \param futures [IN]          array of futures
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param index [OUT]           index of a completed future
+ *
+ * \return HG_SUCCESS or HG_TIMEOUT if no future completed
+ */
+HG_PUBLIC hg_return_t
+HG_Hl_future_wait_any(unsigned int count, hg_future_t *futures[],
+    unsigned int timeout, unsigned int *index);
+
+/**
+ * Test whether a future has completed without making progress.
+ *
+ * \param future [IN]           pointer to future
+ *
+ * \return HG_TRUE if completed, HG_FALSE otherwise
+ */
+HG_PUBLIC hg_bool_t
+HG_Hl_future_completed(const hg_future_t *future);
+
+/**
+ * Return the return code of a completed future, which is either the return
+ * code of the operation or, if it succeeded, of its continuation.
+ *
+ * \param future [IN]           pointer to future
+ *
+ * \return HG return code, HG_BUSY if the future has not completed yet
+ */
+HG_PUBLIC hg_return_t
+HG_Hl_future_get_return(const hg_future_t *future);
+
+/**
+ * Free a completed future.
+ *
+ * \param future [IN]           pointer to future
+ *
+ * \return HG_SUCCESS or HG_BUSY if the future has not completed yet
+ */
+HG_PUBLIC hg_return_t
+HG_Hl_future_free(hg_future_t *future);
+
+/**
+ * Create a progress engine on \hg_class. The engine creates
+ * \context_count contexts with consecutive IDs starting at \context_id and
+ * starts \progress_count threads per context that make progress on it. If
+ * \cpus is set, progress threads are pinned to these CPUs in turn. Progress
+ * threads busy poll for up to \spin_max microseconds after they last made
+ * progress before blocking, that time is doubled when polling caught new
+ * work and halved when it did not. If \handler_count is 0, callbacks are
+ * triggered by progress threads, otherwise \handler_count threads per
+ * context trigger them so that RPC callbacks may run concurrently with
+ * progress. In both cases, the application must not call HG_Progress() or
+ * HG_Trigger() on engine contexts.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param engine_info [IN]      (Optional) engine options, NULL if none
+ *
+ * \return Pointer to engine or NULL in case of failure
+ */
+HG_PUBLIC hg_engine_t *
+HG_Engine_create(
+    hg_class_t *hg_class, const struct hg_engine_info *engine_info);
+
+/**
+ * Destroy an engine. Threads keep running for up to \drain_timeout
+ * milliseconds until the callbacks of operations in flight on engine
+ * contexts have been executed and handles other than posted ones have been
+ * released, threads are then stopped and contexts destroyed.
+ *
+ * \param engine [IN]           pointer to engine
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Engine_destroy(hg_engine_t *engine);
+
+/**
+ * Get a context of an engine.
+ *
+ * \param engine [IN]           pointer to engine
+ * \param index [IN]            index of context (ID minus \context_id)
+ *
+ * \return Pointer to HG context or NULL if \index is out of range
+ */
+HG_PUBLIC hg_context_t *
+HG_Engine_get_context(const hg_engine_t *engine, unsigned int index);
+
 #ifdef __cplusplus
 }
 #endif
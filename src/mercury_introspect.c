@@ -0,0 +1,490 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_introspect.h"
+#include "mercury_error.h"
+#include "mercury_private.h"
+#include "mercury_proc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Origin request */
+struct hg_introspect_op {
+    hg_introspect_cb_t callback; /* User callback */
+    void *arg;                   /* User data */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Proc of class stats.
+ */
+static hg_return_t
+hg_proc_introspect_class_stats(hg_proc_t proc, struct hg_class_stats *stats);
+
+/**
+ * Proc of context stats.
+ */
+static hg_return_t
+hg_proc_introspect_context_stats(
+    hg_proc_t proc, struct hg_context_stats *stats);
+
+/**
+ * Proc of RPC stats.
+ */
+static hg_return_t
+hg_proc_introspect_rpc_stats(hg_proc_t proc, struct hg_rpc_stats *stats);
+
+/**
+ * Proc of NA resource stats.
+ */
+static hg_return_t
+hg_proc_introspect_resource(hg_proc_t proc, struct na_resource_stats *stats);
+
+/**
+ * Proc of introspection output.
+ */
+static hg_return_t
+hg_proc_introspect_info(hg_proc_t proc, void *data);
+
+/**
+ * Append resource stats of NA class to snapshot.
+ */
+static hg_return_t
+hg_introspect_get_resources(
+    na_class_t *na_class, struct hg_introspect_info *info);
+
+/**
+ * Take snapshot of class and of context.
+ */
+static hg_return_t
+hg_introspect_get_info(hg_context_t *context, struct hg_introspect_info *info);
+
+/**
+ * Free snapshot taken by hg_introspect_get_info().
+ */
+static void
+hg_introspect_free_info(struct hg_introspect_info *info);
+
+/**
+ * Introspection RPC callback.
+ */
+static hg_return_t
+hg_introspect_rpc_cb(hg_handle_t handle);
+
+/**
+ * Origin forward callback.
+ */
+static hg_return_t
+hg_introspect_forward_cb(const struct hg_cb_info *callback_info);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_introspect_class_stats(hg_proc_t proc, struct hg_class_stats *stats)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint64_t(proc, &stats->forward_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc forward count");
+    ret = hg_proc_hg_uint64_t(proc, &stats->handle_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc handle count");
+    ret = hg_proc_hg_uint64_t(proc, &stats->extra_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc extra count");
+    ret = hg_proc_hg_uint64_t(proc, &stats->bytes_in);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc bytes in");
+    ret = hg_proc_hg_uint64_t(proc, &stats->bytes_out);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc bytes out");
+    ret = hg_proc_hg_uint64_t(proc, &stats->bulk_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc bulk count");
+    ret = hg_proc_hg_uint64_t(proc, &stats->reject_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc reject count");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_introspect_context_stats(hg_proc_t proc, struct hg_context_stats *stats)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint32_t(proc, &stats->completion_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc completion count");
+    ret = hg_proc_hg_uint32_t(proc, &stats->handle_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc handle count");
+    ret = hg_proc_hg_uint32_t(proc, &stats->handle_pool_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc handle pool count");
+    ret = hg_proc_hg_uint32_t(proc, &stats->posted_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc posted count");
+    ret = hg_proc_hg_uint32_t(proc, &stats->pending_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc pending count");
+    ret = hg_proc_hg_uint32_t(proc, &stats->timer_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc timer count");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_introspect_rpc_stats(hg_proc_t proc, struct hg_rpc_stats *stats)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint64_t(proc, &stats->id);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc RPC ID");
+    ret = hg_proc_hg_uint64_t(proc, &stats->forward_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc forward count");
+    ret = hg_proc_hg_uint64_t(proc, &stats->handle_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc handle count");
+    ret = hg_proc_hg_uint64_t(proc, &stats->extra_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc extra count");
+    ret = hg_proc_hg_uint64_t(proc, &stats->bytes_in);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc bytes in");
+    ret = hg_proc_hg_uint64_t(proc, &stats->bytes_out);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc bytes out");
+    ret = hg_proc_hg_uint64_t(proc, &stats->reject_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc reject count");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_introspect_resource(hg_proc_t proc, struct na_resource_stats *stats)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_bytes(proc, stats->name, sizeof(stats->name));
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc resource name");
+    stats->name[sizeof(stats->name) - 1] = '\0';
+    ret = hg_proc_hg_uint64_t(proc, &stats->used);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc resource use");
+    ret = hg_proc_hg_uint64_t(proc, &stats->max);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc resource max");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_introspect_info(hg_proc_t proc, void *data)
+{
+    struct hg_introspect_info *info = (struct hg_introspect_info *) data;
+    hg_uint32_t i;
+    hg_return_t ret;
+
+    ret = hg_proc_introspect_class_stats(proc, &info->class_stats);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc class stats");
+    ret = hg_proc_introspect_context_stats(proc, &info->context_stats);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc context stats");
+    ret = hg_proc_hg_uint32_t(
+        proc, &info->na_context_stats.completion_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc NA completion count");
+    ret = hg_proc_hg_uint32_t(proc, &info->na_context_stats.backfill_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc NA backfill count");
+    ret = hg_proc_hg_uint8_t(proc, &info->context_id);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc context ID");
+    ret = hg_proc_hg_uint32_t(proc, &info->rpc_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc RPC count");
+    ret = hg_proc_hg_uint32_t(proc, &info->resource_count);
+    HG_CHECK_HG_ERROR(done, ret, "Could not proc resource count");
+
+    if (hg_proc_get_op(proc) == HG_DECODE) {
+        info->rpc_stats = NULL;
+        info->resources = NULL;
+        if (info->rpc_count > 0) {
+            info->rpc_stats = (struct hg_rpc_stats *) calloc(
+                info->rpc_count, sizeof(struct hg_rpc_stats));
+            HG_CHECK_ERROR(info->rpc_stats == NULL, done, ret, HG_NOMEM,
+                "Could not allocate RPC stats");
+        }
+        if (info->resource_count > 0) {
+            info->resources = (struct na_resource_stats *) calloc(
+                info->resource_count, sizeof(struct na_resource_stats));
+            HG_CHECK_ERROR(info->resources == NULL, done, ret, HG_NOMEM,
+                "Could not allocate resource stats");
+        }
+    }
+
+    if (hg_proc_get_op(proc) != HG_FREE) {
+        for (i = 0; i < info->rpc_count; i++) {
+            ret = hg_proc_introspect_rpc_stats(proc, &info->rpc_stats[i]);
+            HG_CHECK_HG_ERROR(done, ret, "Could not proc RPC stats");
+        }
+        for (i = 0; i < info->resource_count; i++) {
+            ret = hg_proc_introspect_resource(proc, &info->resources[i]);
+            HG_CHECK_HG_ERROR(done, ret, "Could not proc resource stats");
+        }
+    } else {
+        free(info->rpc_stats);
+        info->rpc_stats = NULL;
+        free(info->resources);
+        info->resources = NULL;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_introspect_get_resources(
+    na_class_t *na_class, struct hg_introspect_info *info)
+{
+    struct na_resource_stats *resources;
+    na_uint32_t count = 0, count_max;
+    na_return_t na_ret;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Get number of resources first, resources may be added in between */
+    na_ret = NA_Get_resource_stats(na_class, NULL, &count);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not get number of NA resources (%s)",
+        NA_Error_to_string(na_ret));
+    if (count == 0)
+        goto done;
+
+    resources = (struct na_resource_stats *) realloc(info->resources,
+        (info->resource_count + count) * sizeof(struct na_resource_stats));
+    HG_CHECK_ERROR(resources == NULL, done, ret, HG_NOMEM,
+        "Could not allocate resource stats");
+    info->resources = resources;
+    count_max = count;
+
+    na_ret = NA_Get_resource_stats(
+        na_class, &info->resources[info->resource_count], &count);
+    HG_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
+        "Could not get NA resources (%s)", NA_Error_to_string(na_ret));
+    info->resource_count += (count < count_max) ? count : count_max;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_introspect_get_info(hg_context_t *context, struct hg_introspect_info *info)
+{
+    hg_core_class_t *core_class = context->hg_class->core_class;
+    na_context_t *na_context = HG_Core_context_get_na(context->core_context);
+    hg_uint32_t rpc_count = 0;
+    hg_return_t ret;
+    na_return_t na_ret;
+
+    memset(info, 0, sizeof(*info));
+    info->context_id = HG_Context_get_id(context);
+
+    ret = HG_Core_class_get_stats(
+        core_class, &info->class_stats, NULL, &rpc_count);
+    HG_CHECK_HG_ERROR(error, ret, "Could not get class stats");
+    if (rpc_count > 0) {
+        hg_uint32_t rpc_max = rpc_count;
+
+        info->rpc_stats = (struct hg_rpc_stats *) malloc(
+            rpc_max * sizeof(struct hg_rpc_stats));
+        HG_CHECK_ERROR(info->rpc_stats == NULL, error, ret, HG_NOMEM,
+            "Could not allocate RPC stats");
+        ret = HG_Core_class_get_stats(
+            core_class, NULL, info->rpc_stats, &rpc_count);
+        HG_CHECK_HG_ERROR(error, ret, "Could not get RPC stats");
+        /* RPCs may have been registered in between */
+        info->rpc_count = (rpc_count < rpc_max) ? rpc_count : rpc_max;
+    }
+
+    ret = HG_Core_context_get_stats(
+        context->core_context, &info->context_stats);
+    HG_CHECK_HG_ERROR(error, ret, "Could not get context stats");
+
+    if (na_context) {
+        na_ret = NA_Context_get_stats(na_context, &info->na_context_stats);
+        HG_CHECK_ERROR(na_ret != NA_SUCCESS, error, ret, (hg_return_t) na_ret,
+            "Could not get NA context stats (%s)", NA_Error_to_string(na_ret));
+    }
+
+    ret = hg_introspect_get_resources(
+        HG_Core_class_get_na(core_class), info);
+    HG_CHECK_HG_ERROR(error, ret, "Could not get NA resources");
+
+#ifdef NA_HAS_SM
+    if (HG_Core_class_get_na_sm(core_class)) {
+        na_context_t *na_sm_context =
+            HG_Core_context_get_na_sm(context->core_context);
+        struct na_context_stats na_sm_context_stats;
+
+        if (na_sm_context &&
+            NA_Context_get_stats(na_sm_context, &na_sm_context_stats) ==
+                NA_SUCCESS) {
+            info->na_context_stats.completion_count +=
+                na_sm_context_stats.completion_count;
+            info->na_context_stats.backfill_count +=
+                na_sm_context_stats.backfill_count;
+        }
+
+        ret = hg_introspect_get_resources(
+            HG_Core_class_get_na_sm(core_class), info);
+        HG_CHECK_HG_ERROR(error, ret, "Could not get NA SM resources");
+    }
+#endif
+
+    return HG_SUCCESS;
+
+error:
+    hg_introspect_free_info(info);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_introspect_free_info(struct hg_introspect_info *info)
+{
+    free(info->rpc_stats);
+    info->rpc_stats = NULL;
+    info->rpc_count = 0;
+    free(info->resources);
+    info->resources = NULL;
+    info->resource_count = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_introspect_rpc_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    struct hg_introspect_info info;
+    hg_return_t ret;
+
+    /* Partial snapshot is still returned if some stats are not available */
+    ret = hg_introspect_get_info(hg_info->context, &info);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not take snapshot (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Respond(handle, NULL, NULL, &info);
+    HG_CHECK_ERROR_DONE(ret != HG_SUCCESS, "Could not respond (%s)",
+        HG_Error_to_string(ret));
+
+    hg_introspect_free_info(&info);
+    HG_Destroy(handle);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_introspect_forward_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_introspect_op *op =
+        (struct hg_introspect_op *) callback_info->arg;
+    hg_handle_t handle = callback_info->info.forward.handle;
+    struct hg_introspect_cb_info introspect_cb_info;
+    struct hg_introspect_info info;
+
+    introspect_cb_info.arg = op->arg;
+    introspect_cb_info.ret = callback_info->ret;
+    introspect_cb_info.info = NULL;
+
+    if (introspect_cb_info.ret == HG_SUCCESS) {
+        introspect_cb_info.ret = HG_Get_output(handle, &info);
+        if (introspect_cb_info.ret == HG_SUCCESS)
+            introspect_cb_info.info = &info;
+    }
+
+    op->callback(&introspect_cb_info);
+
+    if (introspect_cb_info.info)
+        HG_Free_output(handle, &info);
+    HG_Destroy(handle);
+    free(op);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_introspect_register(hg_class_t *hg_class)
+{
+    hg_bool_t registered = HG_FALSE;
+    hg_return_t ret;
+
+    HG_Register_name(hg_class, HG_INTROSPECT_NAME, NULL,
+        hg_proc_introspect_info, hg_introspect_rpc_cb);
+
+    ret = HG_Registered_name(hg_class, HG_INTROSPECT_NAME, NULL, &registered);
+    HG_CHECK_HG_ERROR(done, ret, "Could not check for introspection RPC");
+    HG_CHECK_ERROR(!registered, done, ret, HG_FAULT,
+        "Could not register introspection RPC");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Introspect(hg_context_t *context, hg_introspect_cb_t callback, void *arg,
+    hg_addr_t addr, hg_uint8_t target_id)
+{
+    struct hg_introspect_op *op = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_bool_t registered = HG_FALSE;
+    hg_id_t id;
+    hg_return_t ret;
+
+    HG_CHECK_ERROR(
+        context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    HG_CHECK_ERROR(
+        callback == NULL, error, ret, HG_INVALID_ARG, "NULL callback");
+
+    /* Origins only need to know how to decode the snapshot */
+    ret = HG_Registered_name(
+        context->hg_class, HG_INTROSPECT_NAME, &id, &registered);
+    HG_CHECK_HG_ERROR(error, ret, "Could not check for introspection RPC");
+    if (!registered)
+        id = HG_Register_name(context->hg_class, HG_INTROSPECT_NAME, NULL,
+            hg_proc_introspect_info, NULL);
+
+    op = (struct hg_introspect_op *) malloc(sizeof(*op));
+    HG_CHECK_ERROR(
+        op == NULL, error, ret, HG_NOMEM, "Could not allocate operation");
+    op->callback = callback;
+    op->arg = arg;
+
+    ret = HG_Create(context, addr, id, &handle);
+    HG_CHECK_HG_ERROR(error, ret, "Could not create handle");
+
+    ret = HG_Set_target_id(handle, target_id);
+    HG_CHECK_HG_ERROR(error, ret, "Could not set target ID");
+
+    ret = HG_Forward(handle, hg_introspect_forward_cb, op, NULL);
+    HG_CHECK_HG_ERROR(error, ret, "Could not forward introspection request");
+
+    return HG_SUCCESS;
+
+error:
+    if (handle != HG_HANDLE_NULL)
+        HG_Destroy(handle);
+    free(op);
+
+    return ret;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_INTROSPECT_H
+#define MERCURY_INTROSPECT_H
+
+#include "mercury.h"
+
+/* Introspection returns a snapshot of the state of a remote class over
+ * mercury itself, so that slow or stuck servers can be inspected without
+ * attaching a debugger. Targets must be initialized by HG_Init_opt() with
+ * hg_init_info.introspect set, which registers the internal introspection
+ * RPC. Stats of the context are those of the context that served the
+ * request, NA resources are reported by the NA plugin of the class and, when
+ * NA SM is used for local peers, by NA SM (resource names are prefixed by
+ * the plugin name). */
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/* Snapshot of a remote class */
+struct hg_introspect_info {
+    struct hg_class_stats class_stats;        /* Class stats */
+    struct hg_context_stats context_stats;    /* Serving context stats */
+    struct na_context_stats na_context_stats; /* Serving NA context stats */
+    struct hg_rpc_stats *rpc_stats;           /* Stats of registered RPCs */
+    struct na_resource_stats *resources;      /* NA resource usage */
+    hg_uint32_t rpc_count;                    /* Number of RPC stats */
+    hg_uint32_t resource_count;               /* Number of resources */
+    hg_uint8_t context_id;                    /* Serving context ID */
+};
+
+/* Introspection callback info */
+struct hg_introspect_cb_info {
+    void *arg;                             /* User data */
+    hg_return_t ret;                       /* Return value */
+    const struct hg_introspect_info *info; /* Snapshot (NULL if failed) */
+};
+
+typedef hg_return_t (*hg_introspect_cb_t)(
+    const struct hg_introspect_cb_info *callback_info);
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/* Name of the internal introspection RPC */
+#define HG_INTROSPECT_NAME "__hg_introspect"
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Request a snapshot of the class listening at \addr, served by the context
+ * of ID \target_id. \callback is executed once the snapshot is received,
+ * the snapshot is freed once \callback returns.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param addr [IN]             target address
+ * \param target_id [IN]        target context ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Introspect(hg_context_t *context, hg_introspect_cb_t callback, void *arg,
+    hg_addr_t addr, hg_uint8_t target_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_INTROSPECT_H */
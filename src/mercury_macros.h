@@ -27,6 +27,8 @@
  *   - MERCURY_REGISTER
  *   - MERCURY_GEN_PROC
  *   - MERCURY_GEN_STRUCT_PROC
+ *   - MERCURY_GEN_POD_PROC
+ *   - MERCURY_GEN_POD_STRUCT_PROC
  */
 
 /****************/
@@ -70,6 +72,24 @@
             return ret;                                                        \
         }
 
+/* Generate proc for struct with fixed layout (no pointers), the entire struct
+ * is copied at once unless XDR is used, in which case each field must be
+ * converted separately. Structs copied at once cannot be decoded from a peer
+ * of different byte order */
+#    ifdef HG_HAS_XDR
+#        define HG_GEN_POD_STRUCT_PROC(struct_type_name, fields)               \
+            HG_GEN_STRUCT_PROC(struct_type_name, fields)
+#    else
+#        define HG_GEN_POD_STRUCT_PROC(struct_type_name, fields)               \
+            static HG_INLINE hg_return_t BOOST_PP_CAT(                         \
+                hg_proc_, struct_type_name)(hg_proc_t proc, void *data)        \
+            {                                                                  \
+                if (unlikely(HG_PROC_IS_SWAP(proc)))                           \
+                    return HG_PROTONOSUPPORT;                                  \
+                return hg_proc_bytes(proc, data, sizeof(struct_type_name));    \
+            }
+#    endif
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -98,6 +118,21 @@
 #    define MERCURY_GEN_STRUCT_PROC(struct_type_name, fields)                  \
         HG_GEN_STRUCT_PROC(struct_type_name, fields)
 
+/* Same as MERCURY_GEN_PROC for structs whose fields are all of fixed size
+ * (integers, floats, nested POD structs) so that the struct can be encoded
+ * and decoded with a single copy. Origin and target must share the same
+ * struct layout (padding included), as is the case for all basic types, and
+ * the same byte order (decoding otherwise fails with HG_PROTONOSUPPORT).
+ */
+#    define MERCURY_GEN_POD_PROC(struct_type_name, fields)                     \
+        HG_GEN_STRUCT(struct_type_name, fields)                                \
+        HG_GEN_POD_STRUCT_PROC(struct_type_name, fields)
+
+/* Same as MERCURY_GEN_STRUCT_PROC for user defined structs with a fixed
+ * layout, see MERCURY_GEN_POD_PROC */
+#    define MERCURY_GEN_POD_STRUCT_PROC(struct_type_name, fields)              \
+        HG_GEN_POD_STRUCT_PROC(struct_type_name, fields)
+
 #else /* HG_HAS_BOOST */
 
 /* Register func_name */
@@ -36,11 +36,16 @@ struct hg_completion_entry {
         hg_core_handle_t hg_core_handle;
         struct hg_bulk_op_id *hg_bulk_op_id;
     } op_id;
-    HG_QUEUE_ENTRY(hg_completion_entry) entry;
     hg_op_type_t op_type;
 };
 
 struct hg_bulk_op_pool;
+struct hg_bulk_mem_pool;
+struct hg_bulk_cache;
+struct hg_thread_pool;
+struct hg_class;
+struct hg_capture;
+struct hg_capture_record;
 
 /*****************/
 /* Public Macros */
@@ -60,6 +65,65 @@ extern "C" {
 HG_PRIVATE struct hg_bulk_op_pool *
 hg_core_context_get_bulk_op_pool(struct hg_core_context *core_context);
 
+/**
+ * Account for size bytes of memory used by context for a given use. Overflow
+ * payloads that would exceed the hard memory limit of the context are denied
+ * with HG_NOMEM, other types of memory are always accounted.
+ */
+HG_PRIVATE hg_return_t
+hg_core_context_mem_acquire(
+    struct hg_core_context *core_context, hg_mem_use_t use, hg_size_t size);
+
+/**
+ * Release size bytes of memory previously accounted with
+ * hg_core_context_mem_acquire().
+ */
+HG_PRIVATE void
+hg_core_context_mem_release(
+    struct hg_core_context *core_context, hg_mem_use_t use, hg_size_t size);
+
+/**
+ * Account for an allocation of the hot path that could not be served from a
+ * pool (see hg_context_stats.alloc_fallback_count), \what is only used for
+ * logging.
+ */
+HG_PRIVATE void
+hg_core_context_alloc_fallback(
+    struct hg_core_context *core_context, const char *what);
+
+/**
+ * Get bulk pipelining parameters.
+ */
+HG_PRIVATE void
+hg_core_class_get_bulk_pipeline(struct hg_core_class *core_class,
+    hg_size_t *chunk_size, hg_uint32_t *max_inflight);
+
+/**
+ * Get thread pool used to copy data of self bulk transfers (NULL if copies
+ * are not offloaded), its number of threads and min size of offloaded copies.
+ */
+HG_PRIVATE struct hg_thread_pool *
+hg_core_class_get_bulk_self_pool(struct hg_core_class *core_class,
+    hg_uint32_t *thread_count, hg_size_t *offload_size);
+
+/**
+ * Get pool of registered memory.
+ */
+HG_PRIVATE struct hg_bulk_mem_pool *
+hg_core_class_get_bulk_mem_pool(struct hg_core_class *core_class);
+
+/**
+ * Get instrumentation hooks of class (callbacks are NULL if not set).
+ */
+HG_PRIVATE const struct hg_core_hooks *
+hg_core_class_get_hooks(struct hg_core_class *core_class);
+
+/**
+ * Get cache of remote bulk handles.
+ */
+HG_PRIVATE struct hg_bulk_cache *
+hg_core_class_get_bulk_cache(struct hg_core_class *core_class);
+
 /**
  * Add entry to completion queue.
  */
@@ -86,6 +150,69 @@ hg_bulk_op_pool_create(hg_core_context_t *core_context, unsigned int init_count,
 HG_PRIVATE hg_return_t
 hg_bulk_op_pool_destroy(struct hg_bulk_op_pool *hg_bulk_op_pool);
 
+/**
+ * Create pool of registered memory.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_mem_pool_create(hg_core_class_t *core_class,
+    struct hg_bulk_mem_pool **hg_bulk_mem_pool_ptr);
+
+/**
+ * Destroy pool of registered memory, remaining memory is released.
+ */
+HG_PRIVATE void
+hg_bulk_mem_pool_destroy(struct hg_bulk_mem_pool *hg_bulk_mem_pool);
+
+/**
+ * Create cache of remote bulk handles.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_cache_create(
+    hg_uint32_t max_count, struct hg_bulk_cache **hg_bulk_cache_ptr);
+
+/**
+ * Destroy cache of remote bulk handles, releasing its references.
+ */
+HG_PRIVATE void
+hg_bulk_cache_destroy(struct hg_bulk_cache *hg_bulk_cache);
+
+/**
+ * Register internal RPC used to relay collective operations.
+ */
+HG_PRIVATE hg_return_t
+hg_collective_register(struct hg_class *hg_class);
+
+/**
+ * Register internal RPC used to introspect the class.
+ */
+HG_PRIVATE hg_return_t
+hg_introspect_register(struct hg_class *hg_class);
+
+/**
+ * Create workload capture file at \path and write its header.
+ */
+HG_PRIVATE hg_return_t
+hg_capture_create(const char *path, struct hg_capture **capture_ptr);
+
+/**
+ * Flush and close capture file.
+ */
+HG_PRIVATE void
+hg_capture_destroy(struct hg_capture *capture);
+
+/**
+ * Convert \ticks (see hg_time_get_ticks()) to ns since capture start.
+ */
+HG_PRIVATE hg_uint64_t
+hg_capture_time(struct hg_capture *capture, hg_uint64_t ticks);
+
+/**
+ * Append record to capture file, records are dropped once a write failed.
+ */
+HG_PRIVATE void
+hg_capture_record(
+    struct hg_capture *capture, const struct hg_capture_record *record);
+
 #ifdef __cplusplus
 }
 #endif
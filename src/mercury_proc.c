@@ -15,19 +15,96 @@
 #ifdef HG_HAS_CHECKSUMS
 #    include <mchecksum.h>
 #endif
+#ifdef HG_HAS_XDR
+#    ifdef _WIN32
+#        include <winsock2.h>
+#    else
+#        include <arpa/inet.h>
+#    endif
+#endif
 
 /****************/
 /* Local Macros */
 /****************/
 
+/* Buffer size used for HG_SIZE, large enough to never run out of space */
+#define HG_PROC_SIZE_MAX (HG_SIZE_MAX / 2)
+
+/* Arena chunk size and alignment of arena allocations */
+#define HG_PROC_ARENA_CHUNK_SIZE (4096)
+#define HG_PROC_ARENA_ALIGNMENT  (16)
+#define HG_PROC_ARENA_ALIGN(x)                                                 \
+    (((x) + HG_PROC_ARENA_ALIGNMENT - 1) &                                     \
+        ~((hg_size_t) HG_PROC_ARENA_ALIGNMENT - 1))
+
+/* Allocations larger than this get their own chunk */
+#define HG_PROC_ARENA_LARGE_SIZE (HG_PROC_ARENA_CHUNK_SIZE / 4)
+
+/* Size of chunk header and pointer to chunk data */
+#define HG_PROC_ARENA_CHUNK_HDR_SIZE                                           \
+    HG_PROC_ARENA_ALIGN(sizeof(struct hg_proc_arena_chunk))
+#define HG_PROC_ARENA_CHUNK_DATA(chunk)                                        \
+    ((char *) (chunk) + HG_PROC_ARENA_CHUNK_HDR_SIZE)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
 
+/* Arena chunk */
+struct hg_proc_arena_chunk {
+    struct hg_proc_arena_chunk *next; /* Next chunk */
+    hg_size_t size;                   /* Usable size */
+    hg_size_t used;                   /* Used size */
+};
+
+/* Arena cleanup */
+struct hg_proc_arena_cleanup {
+    void (*cleanup)(void *);            /* Cleanup routine */
+    void *arg;                          /* Cleanup arg */
+    struct hg_proc_arena_cleanup *next; /* Next cleanup */
+};
+
+/* Arena */
+struct hg_proc_arena {
+    struct hg_proc_arena_chunk *chunks;     /* Chunks, current first */
+    struct hg_proc_arena_cleanup *cleanups; /* Cleanups, most recent first */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
 
+/**
+ * Allocate memory from proc arena.
+ */
+static void *
+hg_proc_arena_alloc(struct hg_proc *hg_proc, hg_size_t size);
+
+#ifdef HG_HAS_CHECKSUMS
+/**
+ * Update checksum with the contiguous span of the current buffer that has
+ * been processed since the last update.
+ */
+static int
+hg_proc_checksum_span(struct hg_proc *hg_proc);
+#endif
+
+#ifdef HG_HAS_XDR
+/**
+ * Convert array of 32 or 64-bit types from host to XDR byte order.
+ */
+static void
+hg_proc_xdr_array_enc(
+    void *dst, const void *src, hg_size_t count, hg_size_t type_size);
+
+/**
+ * Convert array of 32 or 64-bit types from XDR to host byte order.
+ */
+static void
+hg_proc_xdr_array_dec(
+    void *dst, const void *src, hg_size_t count, hg_size_t type_size);
+#endif
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -147,6 +224,13 @@ hg_proc_free(hg_proc_t proc)
     if (hg_proc->extra_buf.buf && hg_proc->extra_buf.is_mine)
         hg_mem_aligned_free(hg_proc->extra_buf.buf);
 
+    /* Free arena */
+    if (hg_proc->arena) {
+        hg_proc_arena_reset(proc);
+        free(hg_proc->arena->chunks);
+        free(hg_proc->arena);
+    }
+
     /* Free proc */
     free(hg_proc);
 
@@ -163,8 +247,8 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
 
     HG_CHECK_ERROR(
         proc == HG_PROC_NULL, done, ret, HG_INVALID_ARG, "NULL HG proc");
-    HG_CHECK_ERROR(
-        !buf && op != HG_FREE, done, ret, HG_INVALID_ARG, "NULL buffer");
+    HG_CHECK_ERROR(!buf && op != HG_FREE && op != HG_SIZE, done, ret,
+        HG_INVALID_ARG, "NULL buffer");
 
     hg_proc->op = op;
 #ifdef HG_HAS_XDR
@@ -181,6 +265,9 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
             xdrmem_create(&hg_proc->proc_buf.xdr, (char *) buf,
                 (hg_uint32_t) buf_size, XDR_FREE);
             break;
+        case HG_SIZE:
+            HG_GOTO_ERROR(
+                done, ret, HG_OPNOTSUPPORTED, "HG_SIZE not supported with XDR");
         default:
             HG_GOTO_ERROR(
                 done, ret, HG_INVALID_PARAM, "Unknown proc operation");
@@ -189,10 +276,11 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
 
     /* Reset flags */
     hg_proc->flags = 0;
+    hg_proc->bulk_size = 0;
 
-    /* Reset proc buf */
+    /* Reset proc buf, sizing is not bounded by the buffer size */
     hg_proc->proc_buf.buf = buf;
-    hg_proc->proc_buf.size = buf_size;
+    hg_proc->proc_buf.size = (op == HG_SIZE) ? HG_PROC_SIZE_MAX : buf_size;
     hg_proc->proc_buf.buf_ptr = hg_proc->proc_buf.buf;
     hg_proc->proc_buf.size_left = hg_proc->proc_buf.size;
 
@@ -215,6 +303,7 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
             rc < 0, done, ret, HG_CHECKSUM_ERROR, "Could not reset checksum");
         memset(hg_proc->checksum_hash, 0, hg_proc->checksum_size);
     }
+    hg_proc->checksum_offset = 0;
 #endif
 
 done:
@@ -240,6 +329,17 @@ hg_proc_set_size(hg_proc_t proc, hg_size_t req_buf_size)
     current_pos = (char *) hg_proc->current_buf->buf_ptr -
                   (char *) hg_proc->current_buf->buf;
 
+    /* Rather than growing the buffer one request at a time, only compute the
+     * remaining size and let the caller encode again with the total size */
+    if (hg_proc->op == HG_ENCODE && (hg_proc->flags & HG_PROC_SIZE_PASS) &&
+        !hg_proc->extra_buf.buf) {
+        hg_proc->op = HG_SIZE;
+        hg_proc->current_buf->size = HG_PROC_SIZE_MAX;
+        hg_proc->current_buf->size_left =
+            HG_PROC_SIZE_MAX - (hg_size_t) current_pos;
+        return ret;
+    }
+
     /* Get one more page size buf */
     new_buf_size = ((hg_size_t)(req_buf_size / page_size) + 1) * page_size;
     HG_CHECK_ERROR(new_buf_size <= hg_proc_get_size(proc), error, ret,
@@ -296,6 +396,22 @@ hg_proc_save_ptr(hg_proc_t proc, hg_size_t data_size)
         hg_proc_set_size(
             proc, hg_proc->proc_buf.size + hg_proc->extra_buf.size + data_size);
 
+    if (hg_proc->op == HG_SIZE) {
+        /* Nothing is written to the stream, hand out scratch space so that
+         * manual encoding remains safe */
+        if (hg_proc->extra_buf.size < data_size) {
+            void *new_buf = realloc(hg_proc->extra_buf.buf, data_size);
+            HG_CHECK_ERROR_NORET(new_buf == NULL, done,
+                "Could not allocate scratch buffer of size %zu", data_size);
+            hg_proc->extra_buf.buf = new_buf;
+            hg_proc->extra_buf.size = data_size;
+            hg_proc->extra_buf.is_mine = HG_TRUE;
+        }
+        ptr = hg_proc->extra_buf.buf;
+        HG_PROC_UPDATE(proc, data_size);
+        goto done;
+    }
+
     ptr = hg_proc->current_buf->buf_ptr;
     hg_proc->current_buf->buf_ptr =
         (char *) hg_proc->current_buf->buf_ptr + data_size;
@@ -318,18 +434,299 @@ hg_proc_restore_ptr(hg_proc_t proc, void *data, hg_size_t data_size)
     HG_CHECK_ERROR(proc == HG_PROC_NULL, done, ret, HG_INVALID_ARG,
         "Proc is not initialized");
 
-#ifdef HG_HAS_CHECKSUMS
-    hg_proc_checksum_update(proc, data, data_size);
-#else
-    /* Silent warning */
+    /* Data lives in the proc buffer and is checksummed on flush */
     (void) data;
     (void) data_size;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_HAS_XDR
+static void
+hg_proc_xdr_array_enc(
+    void *dst, const void *src, hg_size_t count, hg_size_t type_size)
+{
+    const char *src_ptr = (const char *) src;
+    char *dst_ptr = (char *) dst;
+    hg_size_t i;
+
+    /* Loops are kept simple so that the compiler can vectorize the swap,
+     * memcpy() is used as buffers are not necessarily aligned */
+    if (type_size == sizeof(hg_uint32_t)) {
+        for (i = 0; i < count; i++) {
+            hg_uint32_t val;
+
+            memcpy(&val, src_ptr + i * sizeof(val), sizeof(val));
+            val = htonl(val);
+            memcpy(dst_ptr + i * sizeof(val), &val, sizeof(val));
+        }
+    } else {
+        for (i = 0; i < count; i++) {
+            hg_uint64_t val;
+            hg_uint32_t words[2];
+
+            /* XDR hyper integers are encoded with the high word first */
+            memcpy(&val, src_ptr + i * sizeof(val), sizeof(val));
+            words[0] = htonl((hg_uint32_t)(val >> 32));
+            words[1] = htonl((hg_uint32_t)(val & 0xffffffff));
+            memcpy(dst_ptr + i * sizeof(val), words, sizeof(val));
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_proc_xdr_array_dec(
+    void *dst, const void *src, hg_size_t count, hg_size_t type_size)
+{
+    const char *src_ptr = (const char *) src;
+    char *dst_ptr = (char *) dst;
+    hg_size_t i;
+
+    if (type_size == sizeof(hg_uint32_t)) {
+        for (i = 0; i < count; i++) {
+            hg_uint32_t val;
+
+            memcpy(&val, src_ptr + i * sizeof(val), sizeof(val));
+            val = ntohl(val);
+            memcpy(dst_ptr + i * sizeof(val), &val, sizeof(val));
+        }
+    } else {
+        for (i = 0; i < count; i++) {
+            hg_uint64_t val;
+            hg_uint32_t words[2];
+
+            memcpy(words, src_ptr + i * sizeof(val), sizeof(val));
+            val = ((hg_uint64_t) ntohl(words[0]) << 32) | ntohl(words[1]);
+            memcpy(dst_ptr + i * sizeof(val), &val, sizeof(val));
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_xdr_array(
+    hg_proc_t proc, void *data, hg_size_t count, hg_size_t type_size)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    hg_size_t data_size = count * type_size;
+    unsigned int cur_pos;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(proc == HG_PROC_NULL, done, ret, HG_INVALID_ARG,
+        "Proc is not initialized");
+    HG_CHECK_ERROR(type_size != sizeof(hg_uint32_t) &&
+                       type_size != sizeof(hg_uint64_t),
+        done, ret, HG_INVALID_ARG, "Unsupported type size (%zu)", type_size);
+
+    /* Nothing to free for fixed-width types */
+    if (hg_proc->op == HG_FREE || data_size == 0)
+        goto done;
+
+    HG_PROC_CHECK_SIZE(proc, data_size, done, ret);
+
+    if (hg_proc->op == HG_ENCODE)
+        hg_proc_xdr_array_enc(
+            hg_proc->current_buf->buf_ptr, data, count, type_size);
+    else
+        hg_proc_xdr_array_dec(
+            data, hg_proc->current_buf->buf_ptr, count, type_size);
+
+    /* Keep XDR stream in sync */
+    cur_pos = xdr_getpos(&hg_proc->current_buf->xdr);
+    HG_CHECK_ERROR(xdr_setpos(&hg_proc->current_buf->xdr,
+                       (hg_uint32_t)(cur_pos + data_size)) == 0,
+        done, ret, HG_PROTOCOL_ERROR, "Could not set XDR position");
+
+    HG_PROC_UPDATE(proc, data_size);
+
+done:
+    return ret;
+}
 #endif
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_bytes_ptr(hg_proc_t proc, void **data, hg_size_t data_size)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(proc == HG_PROC_NULL, done, ret, HG_INVALID_ARG,
+        "Proc is not initialized");
+
+    switch (hg_proc->op) {
+        case HG_ENCODE:
+        case HG_SIZE:
+            ret = hg_proc_bytes(proc, *data, data_size);
+            HG_CHECK_HG_ERROR(done, ret, "Could not encode bytes");
+            break;
+        case HG_DECODE:
+            if (data_size == 0) {
+                *data = NULL;
+                break;
+            }
+            if (HG_PROC_IS_BORROW(proc)) {
+                /* Data must be contiguous within the current buffer */
+                HG_CHECK_ERROR(hg_proc->current_buf->size_left < data_size,
+                    done, ret, HG_OVERFLOW,
+                    "Cannot borrow %zu bytes (%zu left)", data_size,
+                    hg_proc->current_buf->size_left);
+
+                *data = hg_proc->current_buf->buf_ptr;
+                HG_PROC_UPDATE(proc, data_size);
+                break;
+            }
+            *data = hg_proc_alloc(proc, data_size);
+            HG_CHECK_ERROR(*data == NULL, done, ret, HG_NOMEM,
+                "Could not allocate %zu bytes", data_size);
+
+            ret = hg_proc_bytes(proc, *data, data_size);
+            HG_CHECK_HG_ERROR(error, ret, "Could not decode bytes");
+            break;
+        case HG_FREE:
+            if (HG_PROC_IS_OWNED(proc))
+                free(*data);
+            *data = NULL;
+            break;
+        default:
+            HG_GOTO_ERROR(done, ret, HG_INVALID_ARG, "Invalid proc op");
+    }
+
+done:
+    return ret;
+
+error:
+    if (!HG_PROC_IS_ARENA(proc))
+        free(*data);
+    *data = NULL;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_proc_arena_alloc(struct hg_proc *hg_proc, hg_size_t size)
+{
+    struct hg_proc_arena *arena = hg_proc->arena;
+    struct hg_proc_arena_chunk *chunk;
+    void *ptr;
+
+    if (!arena) {
+        arena = (struct hg_proc_arena *) calloc(1, sizeof(*arena));
+        HG_CHECK_ERROR_NORET(arena == NULL, error, "Could not allocate arena");
+        hg_proc->arena = arena;
+    }
+
+    size = HG_PROC_ARENA_ALIGN(size);
+    chunk = arena->chunks;
+    if (!chunk || (chunk->size - chunk->used) < size) {
+        hg_bool_t large = size > HG_PROC_ARENA_LARGE_SIZE;
+        hg_size_t chunk_size = large ? size : HG_PROC_ARENA_CHUNK_SIZE;
+
+        chunk = (struct hg_proc_arena_chunk *) malloc(
+            (size_t)(HG_PROC_ARENA_CHUNK_HDR_SIZE + chunk_size));
+        HG_CHECK_ERROR_NORET(
+            chunk == NULL, error, "Could not allocate arena chunk");
+        chunk->size = chunk_size;
+        chunk->used = 0;
+
+        /* Large allocations are kept behind the current chunk so that its
+         * remaining space can still be used */
+        if (large && arena->chunks) {
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+        } else {
+            chunk->next = arena->chunks;
+            arena->chunks = chunk;
+        }
+    }
+
+    ptr = HG_PROC_ARENA_CHUNK_DATA(chunk) + chunk->used;
+    chunk->used += size;
+
+    return ptr;
+
+error:
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+void *
+hg_proc_alloc(hg_proc_t proc, hg_size_t size)
+{
+    if (HG_PROC_IS_ARENA(proc))
+        return hg_proc_arena_alloc((struct hg_proc *) proc, size);
+    else
+        return malloc((size_t) size);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_add_cleanup(hg_proc_t proc, void (*cleanup)(void *), void *arg)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    struct hg_proc_arena_cleanup *entry;
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_CHECK_ERROR(proc == HG_PROC_NULL, done, ret, HG_INVALID_ARG,
+        "Proc is not initialized");
+    HG_CHECK_ERROR(!HG_PROC_IS_ARENA(proc), done, ret, HG_INVALID_ARG,
+        "Proc is not in arena mode");
+
+    entry = (struct hg_proc_arena_cleanup *) hg_proc_arena_alloc(
+        hg_proc, sizeof(*entry));
+    HG_CHECK_ERROR(
+        entry == NULL, done, ret, HG_NOMEM, "Could not allocate cleanup");
+
+    entry->cleanup = cleanup;
+    entry->arg = arg;
+    entry->next = hg_proc->arena->cleanups;
+    hg_proc->arena->cleanups = entry;
+
 done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+void
+hg_proc_arena_reset(hg_proc_t proc)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    struct hg_proc_arena *arena = hg_proc->arena;
+    struct hg_proc_arena_chunk *chunk, *kept = NULL;
+
+    if (!arena)
+        return;
+
+    /* Cleanups are stored in the arena itself, run them first */
+    while (arena->cleanups) {
+        struct hg_proc_arena_cleanup *entry = arena->cleanups;
+
+        arena->cleanups = entry->next;
+        entry->cleanup(entry->arg);
+    }
+
+    /* Keep one regular chunk for subsequent allocations */
+    chunk = arena->chunks;
+    while (chunk) {
+        struct hg_proc_arena_chunk *next = chunk->next;
+
+        if (!kept && chunk->size == HG_PROC_ARENA_CHUNK_SIZE)
+            kept = chunk;
+        else
+            free(chunk);
+        chunk = next;
+    }
+    if (kept) {
+        kept->next = NULL;
+        kept->used = 0;
+    }
+    arena->chunks = kept;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_proc_set_extra_buf_is_mine(hg_proc_t proc, hg_bool_t theirs)
@@ -362,6 +759,16 @@ hg_proc_flush(hg_proc_t proc)
         "Proc is not initialized");
 
 #ifdef HG_HAS_CHECKSUMS
+    /* Nothing to do if checksum is not used */
+    if (hg_proc->checksum == MCHECKSUM_OBJECT_NULL ||
+        (hg_proc->flags & HG_PROC_NO_CHECKSUM))
+        goto done;
+
+    /* Checksum entire processed buffer at once rather than per type */
+    rc = hg_proc_checksum_span(hg_proc);
+    HG_CHECK_ERROR(
+        rc < 0, done, ret, HG_CHECKSUM_ERROR, "Could not update checksum");
+
     rc = mchecksum_get(hg_proc->checksum, hg_proc->checksum_hash,
         hg_proc->checksum_size, MCHECKSUM_FINALIZE);
     HG_CHECK_ERROR(
@@ -373,14 +780,47 @@ done:
 }
 
 #ifdef HG_HAS_CHECKSUMS
+/*---------------------------------------------------------------------------*/
+static int
+hg_proc_checksum_span(struct hg_proc *hg_proc)
+{
+    hg_size_t size_used;
+    int rc = 0;
+
+#ifdef HG_HAS_XDR
+    size_used = (hg_size_t) xdr_getpos(&hg_proc->current_buf->xdr);
+#else
+    size_used = hg_proc_get_size_used((hg_proc_t) hg_proc);
+#endif
+
+    if (size_used > hg_proc->checksum_offset) {
+        rc = mchecksum_update(hg_proc->checksum,
+            (char *) hg_proc->current_buf->buf + hg_proc->checksum_offset,
+            (size_t)(size_used - hg_proc->checksum_offset));
+        hg_proc->checksum_offset = size_used;
+    }
+
+    return rc;
+}
+
 /*---------------------------------------------------------------------------*/
 void
 hg_proc_checksum_update(hg_proc_t proc, void *data, hg_size_t data_size)
 {
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
     int rc;
 
+    if (hg_proc->checksum == MCHECKSUM_OBJECT_NULL ||
+        (hg_proc->flags & HG_PROC_NO_CHECKSUM) ||
+        (hg_proc->op != HG_ENCODE && hg_proc->op != HG_DECODE))
+        goto done;
+
+    /* Keep ordering with data processed so far */
+    rc = hg_proc_checksum_span(hg_proc);
+    HG_CHECK_ERROR_NORET(rc < 0, done, "Could not update checksum");
+
     /* Update checksum */
-    rc = mchecksum_update(((struct hg_proc *) proc)->checksum, data, data_size);
+    rc = mchecksum_update(hg_proc->checksum, data, data_size);
     HG_CHECK_ERROR_NORET(rc < 0, done, "Could not update checksum");
 
 done:
@@ -59,8 +59,40 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
 /**
  * Operation flags.
  */
-#define HG_PROC_SM         (1 << 0)
-#define HG_PROC_BULK_EAGER (1 << 1)
+#define HG_PROC_SM          (1 << 0)
+#define HG_PROC_BULK_EAGER  (1 << 1)
+#define HG_PROC_BORROW      (1 << 2)
+#define HG_PROC_SIZE_PASS   (1 << 3)
+#define HG_PROC_NO_CHECKSUM (1 << 4)
+#define HG_PROC_ARENA       (1 << 5)
+#define HG_PROC_INTERN      (1 << 6)
+#define HG_PROC_SWAP        (1 << 7)
+
+/* Borrow mode (decoded data points into the proc buffer) requires direct
+ * access to the encoded bytes and is therefore not available with XDR */
+#ifdef HG_HAS_XDR
+#    define HG_PROC_IS_BORROW(proc) (0)
+#else
+#    define HG_PROC_IS_BORROW(proc) (hg_proc_get_flags(proc) & HG_PROC_BORROW)
+#endif
+
+/* Arena mode (decoded data is allocated from the proc arena) */
+#define HG_PROC_IS_ARENA(proc) (hg_proc_get_flags(proc) & HG_PROC_ARENA)
+
+/* Intern mode (decoded keys are looked up in the class intern table) */
+#define HG_PROC_IS_INTERN(proc) (hg_proc_get_flags(proc) & HG_PROC_INTERN)
+
+/* Swap mode (payload was encoded with a different byte order), XDR encoding
+ * is already independent of the byte order */
+#ifdef HG_HAS_XDR
+#    define HG_PROC_IS_SWAP(proc) (0)
+#else
+#    define HG_PROC_IS_SWAP(proc) (hg_proc_get_flags(proc) & HG_PROC_SWAP)
+#endif
+
+/* Decoded data is owned by the caller and must be freed individually */
+#define HG_PROC_IS_OWNED(proc)                                                 \
+    (!HG_PROC_IS_BORROW(proc) && !HG_PROC_IS_ARENA(proc))
 
 /* Branch predictor hints */
 #ifndef _WIN32
@@ -117,14 +149,6 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
         ((struct hg_proc *) proc)->current_buf->size_left -= size;             \
     } while (0)
 
-/* Update checksum */
-#ifdef HG_HAS_CHECKSUMS
-#    define HG_PROC_CHECKSUM_UPDATE(proc, data, size)                          \
-        hg_proc_checksum_update(proc, data, size)
-#else
-#    define HG_PROC_CHECKSUM_UPDATE(proc, data, size)
-#endif
-
 /* Base proc function */
 #ifdef HG_HAS_XDR
 #    define HG_PROC_TYPE(proc, type, data, label, ret)                         \
@@ -137,7 +161,6 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
             }                                                                  \
                                                                                \
             HG_PROC_UPDATE(proc, sizeof(type));                                \
-            HG_PROC_CHECKSUM_UPDATE(proc, data, sizeof(type));                 \
         } while (0)
 #else
 #    define HG_PROC_TYPE(proc, type, data, label, ret)                         \
@@ -150,15 +173,17 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
             /* get extra buffer if decoding */                                 \
             HG_PROC_CHECK_SIZE(proc, sizeof(type), label, ret);                \
                                                                                \
-            /* Encode, decode type */                                          \
+            /* Encode, decode type (nothing to copy in HG_SIZE) */             \
             if (hg_proc_get_op(proc) == HG_ENCODE)                             \
                 HG_PROC_TYPE_ENCODE(proc, data, sizeof(type));                 \
-            else                                                               \
+            else if (hg_proc_get_op(proc) == HG_DECODE) {                      \
                 HG_PROC_TYPE_DECODE(proc, data, sizeof(type));                 \
+                if (unlikely(HG_PROC_IS_SWAP(proc)))                           \
+                    hg_proc_swap(data, 1, sizeof(type));                       \
+            }                                                                  \
                                                                                \
             /* Update proc pointers etc */                                     \
             HG_PROC_UPDATE(proc, sizeof(type));                                \
-            HG_PROC_CHECKSUM_UPDATE(proc, data, sizeof(type));                 \
         } while (0)
 #endif
 
@@ -175,7 +200,6 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
             }                                                                  \
                                                                                \
             HG_PROC_UPDATE(proc, size);                                        \
-            HG_PROC_CHECKSUM_UPDATE(proc, data, size);                         \
         } while (0)
 #else
 #    define HG_PROC_BYTES(proc, data, size, label, ret)                        \
@@ -188,15 +212,34 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
             /* get extra buffer if decoding */                                 \
             HG_PROC_CHECK_SIZE(proc, size, label, ret);                        \
                                                                                \
-            /* Encode, decode type */                                          \
+            /* Encode, decode type (nothing to copy in HG_SIZE) */             \
             if (hg_proc_get_op(proc) == HG_ENCODE)                             \
                 HG_PROC_TYPE_ENCODE(proc, data, size);                         \
-            else                                                               \
+            else if (hg_proc_get_op(proc) == HG_DECODE)                        \
                 HG_PROC_TYPE_DECODE(proc, data, size);                         \
                                                                                \
             /* Update proc pointers etc */                                     \
             HG_PROC_UPDATE(proc, size);                                        \
-            HG_PROC_CHECKSUM_UPDATE(proc, data, size);                         \
+        } while (0)
+#endif
+
+/* Base proc function for arrays of 32 or 64-bit types, the size is checked
+ * once for the entire array */
+#ifdef HG_HAS_XDR
+#    define HG_PROC_ARRAY(proc, type, data, count, label, ret)                 \
+        do {                                                                   \
+            ret = hg_proc_xdr_array(proc, data, count, sizeof(type));          \
+            if (ret != HG_SUCCESS)                                             \
+                goto label;                                                    \
+        } while (0)
+#else
+#    define HG_PROC_ARRAY(proc, type, data, count, label, ret)                 \
+        do {                                                                   \
+            HG_PROC_BYTES(                                                     \
+                proc, data, (hg_size_t)(count) * sizeof(type), label, ret);    \
+            if (unlikely(HG_PROC_IS_SWAP(proc)) &&                             \
+                hg_proc_get_op(proc) == HG_DECODE)                             \
+                hg_proc_swap(data, count, sizeof(type));                       \
         } while (0)
 #endif
 
@@ -259,7 +302,13 @@ hg_proc_free(hg_proc_t proc);
  *                              serialization/deserialization
  * \param buf_size [IN]         buffer size
  * \param op [IN]               operation type: HG_ENCODE / HG_DECODE /
- * HG_FREE
+ * HG_FREE / HG_SIZE
+ *
+ * When the HG_PROC_SIZE_PASS flag is set and an HG_ENCODE operation runs out
+ * of buffer space, the operation is switched to HG_SIZE instead of growing
+ * the buffer, so that the total size can be computed and the caller can
+ * reset the processor and encode again into a buffer allocated once. With
+ * HG_SIZE, nothing is written and buf may be NULL.
  *
  * \return HG_SUCCESS or corresponding HG error code
  */
@@ -327,6 +376,27 @@ hg_proc_get_size(hg_proc_t proc);
 static HG_INLINE hg_size_t
 hg_proc_get_size_used(hg_proc_t proc);
 
+/**
+ * Get total size of the memory exposed by the bulk handles that have been
+ * encoded since the last call to hg_proc_reset().
+ *
+ * \param proc [IN]             abstract processor object
+ *
+ * \return Non-negative size value
+ */
+static HG_INLINE hg_size_t
+hg_proc_get_bulk_size(hg_proc_t proc);
+
+/**
+ * Add \size bytes of bulk memory to the count returned by
+ * hg_proc_get_bulk_size(), used by bulk handle procs when encoding.
+ *
+ * \param proc [IN]             abstract processor object
+ * \param size [IN]             size of bulk memory
+ */
+static HG_INLINE void
+hg_proc_add_bulk_size(hg_proc_t proc, hg_size_t size);
+
 /**
  * Request a new buffer size. This will modify the size of the buffer
  * attached to the processor or create an extra processing buffer.
@@ -351,7 +421,8 @@ hg_proc_get_size_left(hg_proc_t proc);
 
 /**
  * Get pointer to current buffer. Will reserve data_size for manual
- * encoding.
+ * encoding. With HG_SIZE, the pointer refers to scratch space that is not
+ * part of the stream.
  *
  * \param proc [IN]             abstract processor object
  * \param data_size [IN]        data size
@@ -546,7 +617,9 @@ static HG_INLINE hg_return_t
 hg_proc_hg_uint64_t(hg_proc_t proc, void *data);
 
 /* Note: float types are not supported but can be built on top of the existing
- * proc routines; encoding floats using XDR could modify checksum */
+ * proc routines; encoding floats using XDR could modify checksum. Arrays of
+ * floats and doubles can be processed with hg_proc_float_array() and
+ * hg_proc_double_array() */
 
 /**
  * Generic processing routine for encoding stream of bytes.
@@ -560,6 +633,165 @@ hg_proc_hg_uint64_t(hg_proc_t proc, void *data);
 static HG_INLINE hg_return_t
 hg_proc_bytes(hg_proc_t proc, void *data, hg_size_t data_size);
 
+/**
+ * Generic processing routine for arrays of fixed-width types. The array is
+ * processed at once instead of element by element.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of elements
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+hg_proc_hg_int32_array(hg_proc_t proc, void *data, hg_size_t count);
+
+/**
+ * Generic processing routine for arrays of fixed-width types.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of elements
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+hg_proc_hg_uint32_array(hg_proc_t proc, void *data, hg_size_t count);
+
+/**
+ * Generic processing routine for arrays of fixed-width types.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of elements
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+hg_proc_hg_int64_array(hg_proc_t proc, void *data, hg_size_t count);
+
+/**
+ * Generic processing routine for arrays of fixed-width types.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of elements
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+hg_proc_hg_uint64_array(hg_proc_t proc, void *data, hg_size_t count);
+
+/**
+ * Generic processing routine for arrays of floats. With XDR, values are
+ * encoded as IEEE single-precision big-endian.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of elements
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+hg_proc_float_array(hg_proc_t proc, void *data, hg_size_t count);
+
+/**
+ * Generic processing routine for arrays of doubles. With XDR, values are
+ * encoded as IEEE double-precision big-endian.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of elements
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+hg_proc_double_array(hg_proc_t proc, void *data, hg_size_t count);
+
+#ifdef HG_HAS_XDR
+/**
+ * Process array of 32 or 64-bit types using XDR byte order in one pass.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of elements
+ * \param type_size [IN]        size of one element (4 or 8)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_xdr_array(
+    hg_proc_t proc, void *data, hg_size_t count, hg_size_t type_size);
+#endif
+
+/**
+ * Reverse byte order of each element of an array of 16, 32 or 64-bit types.
+ *
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of elements
+ * \param type_size [IN]        size of one element
+ */
+static HG_INLINE void
+hg_proc_swap(void *data, hg_size_t count, hg_size_t type_size);
+
+/**
+ * Processing routine for a pointer to a stream of bytes. When decoding,
+ * *data is set to a newly allocated copy of the bytes, unless the
+ * HG_PROC_BORROW flag is set on the processor, in which case *data points
+ * directly into the proc buffer and remains valid for as long as that buffer
+ * (i.e., until HG_Free_input() / HG_Free_output() is called). The copy is
+ * allocated with hg_proc_alloc(). When freeing, *data is released only if it
+ * is owned (see HG_PROC_IS_OWNED()).
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to data pointer
+ * \param data_size [IN]        data size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_bytes_ptr(hg_proc_t proc, void **data, hg_size_t data_size);
+
+/**
+ * Allocate memory for decoded data. If the HG_PROC_ARENA flag is set on the
+ * processor, memory is taken from the proc arena and must not be freed
+ * individually, it is released all at once by hg_proc_arena_reset().
+ * Otherwise memory is allocated with malloc() and must be released with
+ * free() when the proc is run with HG_FREE.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param size [IN]             size of allocation
+ *
+ * \return Pointer to allocated memory or NULL in case of failure
+ */
+HG_PUBLIC void *
+hg_proc_alloc(hg_proc_t proc, hg_size_t size);
+
+/**
+ * Register a cleanup routine to be called when the proc arena is reset, for
+ * decoded data that holds resources other than memory (e.g., bulk handles).
+ * Cleanup routines are called in reverse order of registration. Only valid
+ * if the HG_PROC_ARENA flag is set on the processor.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param cleanup [IN]          cleanup routine
+ * \param arg [IN]              argument passed to cleanup routine
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_add_cleanup(hg_proc_t proc, void (*cleanup)(void *), void *arg);
+
+/**
+ * Run registered cleanup routines and release all memory allocated from the
+ * proc arena. Arena memory is kept across hg_proc_reset() calls, one chunk is
+ * also kept after this call so that subsequent decodes do not allocate.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ */
+HG_PUBLIC void
+hg_proc_arena_reset(hg_proc_t proc);
+
 /**
  * For convenience map stdint types to hg types
  */
@@ -582,7 +814,8 @@ hg_proc_bytes(hg_proc_t proc, void *data, hg_size_t data_size);
 #define hg_proc_memcpy hg_proc_raw
 #define hg_proc_raw    hg_proc_bytes
 
-/* Update checksum */
+/* Update checksum with data that is not part of the proc buffer, data that
+ * is processed through the proc buffer is checksummed on flush */
 #ifdef HG_HAS_CHECKSUMS
 HG_PUBLIC void
 hg_proc_checksum_update(hg_proc_t proc, void *data, hg_size_t data_size);
@@ -611,10 +844,13 @@ struct hg_proc {
     hg_class_t *hg_class; /* HG class */
     struct hg_proc_buf *current_buf;
 #ifdef HG_HAS_CHECKSUMS
-    void *checksum;       /* Checksum */
-    void *checksum_hash;  /* Base checksum buf */
-    size_t checksum_size; /* Checksum size */
+    void *checksum;            /* Checksum */
+    void *checksum_hash;       /* Base checksum buf */
+    size_t checksum_size;      /* Checksum size */
+    hg_size_t checksum_offset; /* Size of buffer already checksummed */
 #endif
+    struct hg_proc_arena *arena; /* Arena for decoded data */
+    hg_size_t bulk_size;         /* Size of encoded bulk handles */
     hg_proc_op_t op;
     hg_uint8_t flags;
 };
@@ -663,6 +899,20 @@ hg_proc_get_size_used(hg_proc_t proc)
            ((struct hg_proc *) proc)->current_buf->size_left;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_size_t
+hg_proc_get_bulk_size(hg_proc_t proc)
+{
+    return ((struct hg_proc *) proc)->bulk_size;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_proc_add_bulk_size(hg_proc_t proc, hg_size_t size)
+{
+    ((struct hg_proc *) proc)->bulk_size += size;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_size_t
 hg_proc_get_size_left(hg_proc_t proc)
@@ -693,6 +943,55 @@ hg_proc_get_extra_size(hg_proc_t proc)
     return ((struct hg_proc *) proc)->extra_buf.size;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_proc_swap(void *data, hg_size_t count, hg_size_t type_size)
+{
+    char *ptr = (char *) data;
+    hg_size_t i;
+
+    /* Shifts are recognized by compilers as byte swaps, memcpy() is used as
+     * data is not necessarily aligned */
+    switch (type_size) {
+        case sizeof(hg_uint16_t):
+            for (i = 0; i < count; i++, ptr += type_size) {
+                hg_uint16_t val;
+
+                memcpy(&val, ptr, sizeof(val));
+                val = (hg_uint16_t)((val >> 8) | (val << 8));
+                memcpy(ptr, &val, sizeof(val));
+            }
+            break;
+        case sizeof(hg_uint32_t):
+            for (i = 0; i < count; i++, ptr += type_size) {
+                hg_uint32_t val;
+
+                memcpy(&val, ptr, sizeof(val));
+                val = ((val >> 24) & 0xff) | ((val >> 8) & 0xff00) |
+                      ((val << 8) & 0xff0000) | (val << 24);
+                memcpy(ptr, &val, sizeof(val));
+            }
+            break;
+        case sizeof(hg_uint64_t):
+            for (i = 0; i < count; i++, ptr += type_size) {
+                hg_uint64_t val;
+
+                memcpy(&val, ptr, sizeof(val));
+                val = ((val >> 56) & 0xffULL) | ((val >> 40) & 0xff00ULL) |
+                      ((val >> 24) & 0xff0000ULL) |
+                      ((val >> 8) & 0xff000000ULL) |
+                      ((val << 8) & 0xff00000000ULL) |
+                      ((val << 24) & 0xff0000000000ULL) |
+                      ((val << 40) & 0xff000000000000ULL) | (val << 56);
+                memcpy(ptr, &val, sizeof(val));
+            }
+            break;
+        default:
+            /* Nothing to swap for single bytes */
+            break;
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_return_t
 hg_proc_hg_int8_t(hg_proc_t proc, void *data)
@@ -801,6 +1100,78 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_proc_hg_int32_array(hg_proc_t proc, void *data, hg_size_t count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_PROC_ARRAY(proc, hg_int32_t, data, count, done, ret);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_proc_hg_uint32_array(hg_proc_t proc, void *data, hg_size_t count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_PROC_ARRAY(proc, hg_uint32_t, data, count, done, ret);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_proc_hg_int64_array(hg_proc_t proc, void *data, hg_size_t count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_PROC_ARRAY(proc, hg_int64_t, data, count, done, ret);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_proc_hg_uint64_array(hg_proc_t proc, void *data, hg_size_t count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_PROC_ARRAY(proc, hg_uint64_t, data, count, done, ret);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_proc_float_array(hg_proc_t proc, void *data, hg_size_t count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_PROC_ARRAY(proc, float, data, count, done, ret);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_proc_double_array(hg_proc_t proc, void *data, hg_size_t count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    HG_PROC_ARRAY(proc, double, data, count, done, ret);
+
+done:
+    return ret;
+}
+
 #ifdef __cplusplus
 }
 #endif
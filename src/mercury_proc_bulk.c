@@ -24,10 +24,38 @@
 /* Local Prototypes */
 /********************/
 
+/**
+ * Release decoded bulk handle, used as arena cleanup.
+ */
+static void
+hg_proc_hg_bulk_release(void *arg);
+
 /*******************/
 /* Local Variables */
 /*******************/
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_proc_hg_bulk_release(void *arg)
+{
+    hg_bulk_t bulk = (hg_bulk_t) arg;
+    hg_return_t ret;
+
+    /* Proc buffer may be released after that point */
+    ret = hg_bulk_release_eager_ref(bulk);
+    HG_CHECK_HG_ERROR(done, ret, "Could not release eager data");
+
+    /* Set serialize ptr to NULL */
+    hg_bulk_set_serialize_cached_ptr(bulk, NULL, 0);
+
+    /* Decrement refcount on bulk handle */
+    ret = HG_Bulk_free(bulk);
+    HG_CHECK_HG_ERROR(done, ret, "Could not free handle");
+
+done:
+    return;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
@@ -38,7 +66,8 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
     hg_uint64_t buf_size = 0;
 
     switch (hg_proc_get_op(proc)) {
-        case HG_ENCODE: {
+        case HG_ENCODE:
+        case HG_SIZE: {
             hg_uint8_t flags = 0;
             hg_bool_t use_eager = HG_FALSE;
 
@@ -76,6 +105,7 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
                 buf_size = HG_Bulk_get_serialize_size(*bulk_ptr, flags);
 
             HG_LOG_DEBUG("Serialize size for bulk handle is %zu", buf_size);
+            hg_proc_add_bulk_size(proc, HG_Bulk_get_size(*bulk_ptr));
 
             /* Encode size */
             ret = hg_proc_uint64_t(proc, &buf_size);
@@ -87,6 +117,9 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
                 hg_proc_bytes(proc, cached_ptr, buf_size);
             } else {
                 buf = hg_proc_save_ptr(proc, buf_size);
+                /* Only the size is needed in HG_SIZE */
+                if (hg_proc_get_op(proc) == HG_SIZE)
+                    break;
                 ret = HG_Bulk_serialize(buf, buf_size, flags, *bulk_ptr);
                 HG_CHECK_HG_ERROR(done, ret, "Could not serialize handle");
                 hg_proc_restore_ptr(proc, buf, buf_size);
@@ -108,8 +141,15 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
                 break;
             }
 
+            /* Descriptors are serialized in host byte order */
+            HG_CHECK_ERROR(HG_PROC_IS_SWAP(proc), done, ret, HG_PROTONOSUPPORT,
+                "Cannot decode bulk handle from peer of different byte order");
+
+            /* Eager data is used in place, proc buffer remains valid until
+             * parameters are freed */
             buf = hg_proc_save_ptr(proc, buf_size);
-            ret = HG_Bulk_deserialize(hg_class, bulk_ptr, buf, buf_size);
+            ret = hg_bulk_deserialize_eager_ref(
+                hg_class, bulk_ptr, buf, buf_size);
             HG_CHECK_HG_ERROR(done, ret, "Could not deserialize handle");
 
             /* Cache serialize ptr to buf */
@@ -117,6 +157,17 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
                 buf, buf_size);
             hg_bulk_set_serialize_cached_ptr(*bulk_ptr, buf, buf_size);
             hg_proc_restore_ptr(proc, buf, buf_size);
+
+            /* Handle is released when the arena is reset */
+            if (HG_PROC_IS_ARENA(proc)) {
+                ret = hg_proc_add_cleanup(
+                    proc, hg_proc_hg_bulk_release, (void *) *bulk_ptr);
+                if (ret != HG_SUCCESS) {
+                    hg_proc_hg_bulk_release((void *) *bulk_ptr);
+                    *bulk_ptr = HG_BULK_NULL;
+                }
+                HG_CHECK_HG_ERROR(done, ret, "Could not add cleanup");
+            }
             break;
         }
         case HG_FREE:
@@ -126,12 +177,9 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
             if (*bulk_ptr == HG_BULK_NULL)
                 break;
 
-            /* Set serialize ptr to NULL */
-            hg_bulk_set_serialize_cached_ptr(*bulk_ptr, NULL, 0);
-
-            /* Decrement refcount on bulk handle */
-            ret = HG_Bulk_free(*bulk_ptr);
-            HG_CHECK_HG_ERROR(done, ret, "Could not free handle");
+            /* Arena handles are released by their cleanup */
+            if (!HG_PROC_IS_ARENA(proc))
+                hg_proc_hg_bulk_release((void *) *bulk_ptr);
             *bulk_ptr = HG_BULK_NULL;
             break;
         default:
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+/* Convert binary trace files (see hg_init_info.trace_prefix) of one or more
+ * processes to a Chrome trace (Perfetto) JSON file. Each handle lifecycle
+ * is displayed as an async slice from its create to its destroy event, with
+ * other events shown as instants within that slice. Events are timed with
+ * wall-clock time so that traces of several nodes share the same time line,
+ * events of a request and of its response can be matched by tag. */
+
+#include "mercury_core_types.h"
+#include "mercury_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Number of events read at once */
+#define HG_TRACE_CONVERT_BATCH (4096)
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static const char *const hg_trace_convert_names_g[HG_TRACE_MAX] = {"create",
+    "post", "forward", "respond", "send", "recv", "ack", "trigger", "destroy"};
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_trace_convert_file(const char *name, FILE *out, int *first)
+{
+    struct hg_trace_event events[HG_TRACE_CONVERT_BATCH];
+    struct hg_trace_header header;
+    unsigned long long pid;
+    hg_util_uint64_t left;
+    FILE *fp;
+    int ret = EXIT_SUCCESS;
+
+    fp = fopen(name, "rb");
+    if (!fp) {
+        fprintf(stderr, "Error: could not open %s\n", name);
+        return EXIT_FAILURE;
+    }
+
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        strncmp(header.magic, HG_TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != HG_TRACE_VERSION ||
+        header.event_size != sizeof(struct hg_trace_event)) {
+        fprintf(stderr, "Error: %s is not a valid trace file\n", name);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (fseek(fp, (long) header.data_offset, SEEK_SET) != 0) {
+        fprintf(stderr, "Error: could not seek in %s\n", name);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    pid = (unsigned long long) header.pid;
+
+    fprintf(out,
+        "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%llu,"
+        "\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+        *first ? "" : ",", pid, header.thread, header.thread);
+    *first = 0;
+
+    /* If trace was not closed (e.g., process crashed), count is 0 and events
+     * are read until the first empty event of the zero-filled last window */
+    left = header.count;
+    for (;;) {
+        size_t i, n = HG_TRACE_CONVERT_BATCH;
+
+        if (header.count > 0 && left < n)
+            n = (size_t) left;
+        n = fread(events, sizeof(events[0]), n, fp);
+        if (n == 0)
+            break;
+
+        for (i = 0; i < n; i++) {
+            const struct hg_trace_event *event = &events[i];
+            hg_util_uint64_t time;
+            const char *ph;
+
+            if (event->time == 0 || event->type >= HG_TRACE_MAX)
+                goto done;
+            if (event->type == HG_TRACE_CREATE)
+                ph = "b";
+            else if (event->type == HG_TRACE_DESTROY)
+                ph = "e";
+            else
+                ph = "n";
+
+            time = event->time + (hg_util_uint64_t) header.time_offset;
+            fprintf(out,
+                ",\n{\"name\":\"%s\",\"cat\":\"hg\",\"ph\":\"%s\","
+                "\"id\":\"%llu.%llu\",\"ts\":%llu.%03llu,\"pid\":%llu,"
+                "\"tid\":%u,\"args\":{\"rpc_id\":\"0x%llx\","
+                "\"context_id\":%u,\"tag\":%u,\"size\":%u}}",
+                (event->type == HG_TRACE_CREATE ||
+                    event->type == HG_TRACE_DESTROY)
+                    ? "handle"
+                    : hg_trace_convert_names_g[event->type],
+                ph, pid, (unsigned long long) event->id,
+                (unsigned long long) (time / 1000),
+                (unsigned long long) (time % 1000), pid, header.thread,
+                (unsigned long long) event->arg, event->context_id,
+                event->tag, event->size);
+        }
+        if (header.count > 0) {
+            left -= n;
+            if (left == 0)
+                break;
+        }
+    }
+
+done:
+    fclose(fp);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    FILE *out;
+    int i, first = 1, ret = EXIT_SUCCESS;
+
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <output.json> <trace.hgt>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    out = fopen(argv[1], "w");
+    if (!out) {
+        fprintf(stderr, "Error: could not open %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (i = 2; i < argc; i++)
+        if (hg_trace_convert_file(argv[i], out, &first) != EXIT_SUCCESS)
+            ret = EXIT_FAILURE;
+    fprintf(out, "\n]}\n");
+
+    fclose(out);
+
+    return ret;
+}
@@ -42,6 +42,15 @@ typedef enum {
     HG_BULK_PULL  /*!< pull data from origin */
 } hg_bulk_op_t;
 
+/**
+ * Bulk atomic operators (see HG_Bulk_atomic()).
+ */
+typedef enum {
+    HG_BULK_ATOMIC_FETCH_ADD,    /*!< add operand, fetch previous value */
+    HG_BULK_ATOMIC_COMPARE_SWAP, /*!< swap with operand if equal to compare */
+    HG_BULK_ATOMIC_SWAP          /*!< swap with operand */
+} hg_bulk_atomic_op_t;
+
 /* Callback info structs */
 struct hg_cb_info_lookup {
     hg_addr_t addr; /* HG address */
@@ -73,6 +82,13 @@ struct hg_cb_info {
     hg_return_t ret;   /* Return value */
 };
 
+/* Operation awaited by a coroutine RPC callback (see HG_Await()) */
+struct hg_await {
+    struct hg_cb_info info; /* Callback info of completed operation */
+    void *coroutine;        /* Awaiting coroutine (private) */
+    hg_bool_t completed;    /* Operation completed */
+};
+
 /* RPC / HG callbacks */
 typedef hg_return_t (*hg_rpc_cb_t)(hg_handle_t handle);
 typedef hg_return_t (*hg_cb_t)(const struct hg_cb_info *callback_info);
@@ -80,6 +96,15 @@ typedef hg_return_t (*hg_cb_t)(const struct hg_cb_info *callback_info);
 /* Proc callback for serializing/deserializing parameters */
 typedef hg_return_t (*hg_proc_cb_t)(hg_proc_t proc, void *data);
 
+/* Codec for compressing/decompressing serialized parameters. On entry,
+ * dst_size is the space available in dst, on return the size written. */
+struct hg_codec {
+    hg_return_t (*compress)(
+        void *dst, hg_size_t *dst_size, const void *src, hg_size_t src_size);
+    hg_return_t (*decompress)(
+        void *dst, hg_size_t *dst_size, const void *src, hg_size_t src_size);
+};
+
 /*****************/
 /* Public Macros */
 /*****************/
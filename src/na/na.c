@@ -34,9 +34,16 @@
 
 #define NA_ATOMIC_QUEUE_SIZE 1024 /* TODO make it configurable */
 
+/* Max number of completions dequeued at once by NA_Trigger() */
+#define NA_TRIGGER_BATCH 16
+
 /* 32-bit lock value for serial progress */
 #define NA_PROGRESS_LOCK 0x80000000
 
+/* Op ID slabs: objects carved per chunk and free objects cached */
+#define NA_OP_SLAB_CHUNK_COUNT 64
+#define NA_OP_SLAB_CACHE_SIZE  1024
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -61,13 +68,31 @@ struct na_private_context {
     backfill_queue;                           /* Backfill completion queue */
     struct hg_atomic_queue *completion_queue; /* Default completion queue */
     na_class_t *na_class;                     /* Pointer to NA class */
+    na_cb_sink_t completion_sink;             /* Completion sink callback */
+    void *completion_sink_arg;                /* Completion sink argument */
+    na_cb_retry_t retry_callback;             /* Retry callback */
+    void *retry_arg;                          /* Retry callback argument */
     hg_atomic_int32_t
         backfill_queue_count; /* Number of entries in backfill queue */
+    hg_atomic_int32_t
+        completion_queue_waiters; /* Number of threads waiting in trigger */
 #ifdef NA_HAS_MULTI_PROGRESS
     hg_atomic_int32_t progressing; /* Progressing count */
 #endif
 };
 
+/* Slab of op IDs (see na_plugin.h), chunks are linked through their first
+ * cache line and are only released when the slab is destroyed */
+struct na_op_slab {
+    struct hg_atomic_queue *cache; /* Free objects (lock-free)   */
+    hg_thread_mutex_t mutex;       /* Lock for slow path         */
+    void *overflow;                /* Free objects beyond cache  */
+    void *chunks;                  /* List of chunks             */
+    char *next;                    /* Next object of last chunk  */
+    char *end;                     /* End of last chunk          */
+    size_t obj_size;               /* Cache-line aligned size    */
+};
+
 /* NA address */
 struct na_addr;
 
@@ -89,6 +114,15 @@ na_info_parse(const char *host_string, struct na_info **na_info_ptr);
 static void
 na_info_free(struct na_info *na_info);
 
+/* Execute plugin and user callbacks of completed operation */
+static NA_INLINE int
+na_cb_completion_run(struct na_cb_completion_data *na_cb_completion_data);
+
+/* Gather segments into buf after buf_size */
+static na_return_t
+na_msg_gather(void *buf, na_size_t *buf_size, na_size_t max_size,
+    const struct na_segment *segments, na_size_t segment_count);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -109,6 +143,12 @@ static const struct na_class_ops *const na_class_table[] = {
 #endif
 #ifdef NA_HAS_CCI
     &NA_PLUGIN_OPS(cci),
+#endif
+#ifdef NA_HAS_UCX
+    &NA_PLUGIN_OPS(ucx),
+#endif
+#ifdef NA_HAS_TCP
+    &NA_PLUGIN_OPS(tcp),
 #endif
     NULL};
 
@@ -235,6 +275,51 @@ na_info_free(struct na_info *na_info)
     free(na_info);
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_cb_completion_run(struct na_cb_completion_data *na_cb_completion_data)
+{
+    struct na_cb_completion_data completion_data = *na_cb_completion_data;
+    int cb_ret = 0;
+
+    /* Execute plugin callback (free resources etc) first since actual
+     * callback will notify user that operation has completed.
+     * NB. If the NA operation ID is reused by the plugin for another
+     * operation we must be careful that resources are released BEFORE that
+     * operation ID gets re-used.
+     */
+    if (completion_data.plugin_callback)
+        completion_data.plugin_callback(completion_data.plugin_callback_args);
+
+    /* Execute callback */
+    if (completion_data.callback)
+        cb_ret = completion_data.callback(&completion_data.callback_info);
+
+    return cb_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_msg_gather(void *buf, na_size_t *buf_size, na_size_t max_size,
+    const struct na_segment *segments, na_size_t segment_count)
+{
+    na_size_t offset = *buf_size, i;
+    na_return_t ret = NA_SUCCESS;
+
+    for (i = 0; i < segment_count; i++) {
+        NA_CHECK_SUBSYS_ERROR(msg, offset + segments[i].len > max_size, done,
+            ret, NA_OVERFLOW, "Message size exceeds max size (%zu > %zu)",
+            offset + segments[i].len, max_size);
+        memcpy((char *) buf + offset, (const void *) segments[i].base,
+            segments[i].len);
+        offset += segments[i].len;
+    }
+    *buf_size = offset;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 na_class_t *
 NA_Initialize(const char *info_string, na_bool_t listen)
@@ -268,8 +353,12 @@ NA_Initialize_opt(const char *info_string, na_bool_t listen,
     NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not parse host string");
 
     na_info->na_init_info = na_init_info;
-    if (na_init_info)
+    na_private_class->na_class.numa_node = NA_NUMA_NODE_ANY;
+    if (na_init_info) {
         na_private_class->na_class.progress_mode = na_init_info->progress_mode;
+        /* Plugins resolve NA_NUMA_NODE_DEVICE */
+        na_private_class->na_class.numa_node = na_init_info->numa_node;
+    }
 
     /* Print debug info */
     NA_LOG_SUBSYS_DEBUG(cls, "Class: %s, Protocol: %s, Hostname: %s",
@@ -296,12 +385,9 @@ NA_Initialize_opt(const char *info_string, na_bool_t listen,
         /* Check that protocol is supported */
         verified = na_class_table[plugin_index]->check_protocol(
             na_info->protocol_name);
-        if (!verified) {
-            NA_CHECK_SUBSYS_ERROR(fatal, na_info->class_name, error, ret,
-                NA_PROTONOSUPPORT,
-                "Specified class name does not support requested protocol");
+        /* Several plugins may share the same class name */
+        if (!verified)
             continue;
-        }
 
         /* If no class name specified, take the first plugin that supports
          * the protocol */
@@ -333,6 +419,12 @@ NA_Initialize_opt(const char *info_string, na_bool_t listen,
         &na_private_class->na_class, na_info, listen);
     NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not initialize plugin");
 
+    /* Device node is unknown or plugin does not use a network device */
+    if (na_private_class->na_class.numa_node == NA_NUMA_NODE_DEVICE)
+        na_private_class->na_class.numa_node = NA_NUMA_NODE_ANY;
+    NA_LOG_SUBSYS_DEBUG(
+        cls, "NUMA node: %d", (int) na_private_class->na_class.numa_node);
+
     na_private_class->na_class.protocol_name = strdup(na_info->protocol_name);
     NA_CHECK_SUBSYS_ERROR(cls, na_private_class->na_class.protocol_name == NULL,
         error, ret, NA_NOMEM, "Could not duplicate protocol name");
@@ -365,10 +457,10 @@ NA_Finalize(na_class_t *na_class)
 
     NA_CHECK_SUBSYS_ERROR(cls, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(cls, na_class->ops->finalize == NULL, done, ret,
+    NA_CHECK_SUBSYS_ERROR(cls, NA_OPS(na_class)->finalize == NULL, done, ret,
         NA_OPNOTSUPPORTED, "finalize plugin callback is not defined");
 
-    ret = na_class->ops->finalize(&na_private_class->na_class);
+    ret = NA_OPS(na_class)->finalize(&na_private_class->na_class);
 
     free(na_private_class->na_class.protocol_name);
     free(na_private_class);
@@ -409,7 +501,7 @@ NA_Context_create(na_class_t *na_class)
 
 /*---------------------------------------------------------------------------*/
 na_context_t *
-NA_Context_create_id(na_class_t *na_class, na_uint8_t id)
+NA_Context_create_id(na_class_t *na_class, na_uint16_t id)
 {
     na_return_t ret = NA_SUCCESS;
     struct na_private_context *na_private_context = NULL;
@@ -425,8 +517,8 @@ NA_Context_create_id(na_class_t *na_class, na_uint8_t id)
 
     NA_CHECK_SUBSYS_ERROR(ctx, na_class->ops == NULL, error, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    if (na_class->ops->context_create) {
-        ret = na_class->ops->context_create(
+    if (NA_OPS(na_class)->context_create) {
+        ret = NA_OPS(na_class)->context_create(
             na_class, &na_private_context->context.plugin_context, id);
         NA_CHECK_SUBSYS_NA_ERROR(
             ctx, error, ret, "Could not create plugin context");
@@ -439,6 +531,11 @@ NA_Context_create_id(na_class_t *na_class, na_uint8_t id)
         error, ret, NA_NOMEM, "Could not allocate queue");
     HG_QUEUE_INIT(&na_private_context->backfill_queue);
     hg_atomic_init32(&na_private_context->backfill_queue_count, 0);
+    hg_atomic_init32(&na_private_context->completion_queue_waiters, 0);
+    na_private_context->completion_sink = NULL;
+    na_private_context->completion_sink_arg = NULL;
+    na_private_context->retry_callback = NULL;
+    na_private_context->retry_arg = NULL;
 
     /* Initialize completion queue mutex/cond */
     hg_thread_mutex_init(&na_private_context->completion_queue_mutex);
@@ -492,8 +589,8 @@ NA_Context_destroy(na_class_t *na_class, na_context_t *context)
     /* Destroy NA plugin context */
     NA_CHECK_SUBSYS_ERROR(ctx, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    if (na_class->ops->context_destroy) {
-        ret = na_class->ops->context_destroy(
+    if (NA_OPS(na_class)->context_destroy) {
+        ret = NA_OPS(na_class)->context_destroy(
             na_class, na_private_context->context.plugin_context);
         NA_CHECK_SUBSYS_NA_ERROR(
             ctx, done, ret, "Could not destroy plugin context");
@@ -520,10 +617,10 @@ NA_Op_create(na_class_t *na_class)
     NA_CHECK_SUBSYS_ERROR_NORET(op, na_class == NULL, done, "NULL NA class");
     NA_CHECK_SUBSYS_ERROR_NORET(
         op, na_class->ops == NULL, done, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR_NORET(op, na_class->ops->op_create == NULL, done,
+    NA_CHECK_SUBSYS_ERROR_NORET(op, NA_OPS(na_class)->op_create == NULL, done,
         "op_create plugin callback is not defined");
 
-    ret = na_class->ops->op_create(na_class);
+    ret = NA_OPS(na_class)->op_create(na_class);
 
     NA_LOG_SUBSYS_DEBUG(op, "Created new OP ID (%p)", ret);
 
@@ -546,12 +643,12 @@ NA_Op_destroy(na_class_t *na_class, na_op_id_t *op_id)
 
     NA_CHECK_SUBSYS_ERROR(op, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(op, na_class->ops->op_destroy == NULL, done, ret,
+    NA_CHECK_SUBSYS_ERROR(op, NA_OPS(na_class)->op_destroy == NULL, done, ret,
         NA_OPNOTSUPPORTED, "op_destroy plugin callback is not defined");
 
     NA_LOG_SUBSYS_DEBUG(op, "Destroying OP ID (%p)", op_id);
 
-    ret = na_class->ops->op_destroy(na_class, op_id);
+    ret = NA_OPS(na_class)->op_destroy(na_class, op_id);
 
 done:
     return ret;
@@ -574,8 +671,8 @@ NA_Addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr)
 
     NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops->addr_lookup == NULL, done, ret,
-        NA_PROTOCOL_ERROR, "addr_lookup2 plugin callback is not defined");
+    NA_CHECK_SUBSYS_ERROR(addr, NA_OPS(na_class)->addr_lookup == NULL, done,
+        ret, NA_PROTOCOL_ERROR, "addr_lookup2 plugin callback is not defined");
 
     /* Copy name and work from that */
     name_string = strdup(name);
@@ -591,7 +688,7 @@ NA_Addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr)
 
     NA_LOG_SUBSYS_DEBUG(addr, "Looking up addr %s", short_name);
 
-    ret = na_class->ops->addr_lookup(na_class, short_name, addr);
+    ret = NA_OPS(na_class)->addr_lookup(na_class, short_name, addr);
 
     NA_LOG_SUBSYS_DEBUG(addr, "Created new address (%p)", *addr);
 
@@ -600,6 +697,67 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Addr_lookup_batch(na_class_t *na_class, const char *const names[],
+    na_size_t count, na_addr_t addrs[])
+{
+    const char **short_names = NULL;
+    na_size_t i;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(
+        addr, na_class == NULL, done, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(addr, names == NULL, done, ret, NA_INVALID_ARG,
+        "NULL array of lookup names");
+    NA_CHECK_SUBSYS_ERROR(addr, addrs == NULL, done, ret, NA_INVALID_ARG,
+        "NULL array of na_addr_t");
+    if (count == 0)
+        goto done;
+
+    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
+        NA_INVALID_ARG, "NULL NA class ops");
+
+    /* Plugins that cannot resolve names at once use regular lookups */
+    if (NA_OPS(na_class)->addr_lookup_batch == NULL) {
+        for (i = 0; i < count; i++) {
+            ret = NA_Addr_lookup(na_class, names[i], &addrs[i]);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                addr, error, ret, "Could not lookup %s", names[i]);
+        }
+        goto done;
+    }
+
+    /* Strip class names, names are not modified so no copy is needed:
+     * ie. ofi+tcp://hostname:port -> tcp://hostname:port */
+    short_names = (const char **) malloc(count * sizeof(*short_names));
+    NA_CHECK_SUBSYS_ERROR(addr, short_names == NULL, done, ret, NA_NOMEM,
+        "Could not allocate array of names");
+    for (i = 0; i < count; i++) {
+        const char *delim;
+
+        NA_CHECK_SUBSYS_ERROR(addr, names[i] == NULL, done, ret,
+            NA_INVALID_ARG, "Lookup name %zu is NULL", (size_t) i);
+        delim = strstr(names[i], NA_CLASS_DELIMITER);
+        short_names[i] =
+            (delim != NULL) ? delim + strlen(NA_CLASS_DELIMITER) : names[i];
+    }
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Looking up %zu addrs", (size_t) count);
+
+    ret = NA_OPS(na_class)->addr_lookup_batch(
+        na_class, short_names, count, addrs);
+
+done:
+    free(short_names);
+    return ret;
+
+error:
+    while (i-- > 0)
+        NA_Addr_free(na_class, addrs[i]);
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_Addr_free(na_class_t *na_class, na_addr_t addr)
@@ -614,12 +772,12 @@ NA_Addr_free(na_class_t *na_class, na_addr_t addr)
 
     NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops->addr_free == NULL, done, ret,
+    NA_CHECK_SUBSYS_ERROR(addr, NA_OPS(na_class)->addr_free == NULL, done, ret,
         NA_OPNOTSUPPORTED, "addr_free plugin callback is not defined");
 
     NA_LOG_SUBSYS_DEBUG(addr, "Freeing address (%p)", addr);
 
-    ret = na_class->ops->addr_free(na_class, addr);
+    ret = NA_OPS(na_class)->addr_free(na_class, addr);
 
 done:
     return ret;
@@ -639,8 +797,39 @@ NA_Addr_set_remove(na_class_t *na_class, na_addr_t addr)
 
     NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    if (na_class->ops->addr_set_remove)
-        ret = na_class->ops->addr_set_remove(na_class, addr);
+    if (NA_OPS(na_class)->addr_set_remove)
+        ret = NA_OPS(na_class)->addr_set_remove(na_class, addr);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Addr_warmup(na_class_t *na_class, const na_addr_t addrs[], na_size_t count)
+{
+    na_size_t i;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(
+        addr, na_class == NULL, done, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(addr, addrs == NULL && count > 0, done, ret,
+        NA_INVALID_ARG, "NULL array of na_addr_t");
+    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
+        NA_INVALID_ARG, "NULL NA class ops");
+    if (NA_OPS(na_class)->addr_warmup == NULL)
+        /* Nothing to do */
+        goto done;
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Warming up %zu addrs", (size_t) count);
+
+    for (i = 0; i < count; i++) {
+        if (addrs[i] == NA_ADDR_NULL)
+            continue;
+        ret = NA_OPS(na_class)->addr_warmup(na_class, addrs[i]);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            addr, done, ret, "Could not warm up addr %zu", (size_t) i);
+    }
 
 done:
     return ret;
@@ -659,10 +848,10 @@ NA_Addr_self(na_class_t *na_class, na_addr_t *addr)
 
     NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops->addr_self == NULL, done, ret,
+    NA_CHECK_SUBSYS_ERROR(addr, NA_OPS(na_class)->addr_self == NULL, done, ret,
         NA_OPNOTSUPPORTED, "addr_self plugin callback is not defined");
 
-    ret = na_class->ops->addr_self(na_class, addr);
+    ret = NA_OPS(na_class)->addr_self(na_class, addr);
 
     NA_LOG_SUBSYS_DEBUG(addr, "Created new self address (%p)", *addr);
 
@@ -685,10 +874,10 @@ NA_Addr_dup(na_class_t *na_class, na_addr_t addr, na_addr_t *new_addr)
 
     NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops->addr_dup == NULL, done, ret,
+    NA_CHECK_SUBSYS_ERROR(addr, NA_OPS(na_class)->addr_dup == NULL, done, ret,
         NA_OPNOTSUPPORTED, "addr_dup plugin callback is not defined");
 
-    ret = na_class->ops->addr_dup(na_class, addr, new_addr);
+    ret = NA_OPS(na_class)->addr_dup(na_class, addr, new_addr);
 
     NA_LOG_SUBSYS_DEBUG(addr, "Dup'ed address (%p) to (%p)", addr, *new_addr);
 
@@ -712,10 +901,10 @@ NA_Addr_cmp(na_class_t *na_class, na_addr_t addr1, na_addr_t addr2)
 
     NA_CHECK_SUBSYS_ERROR_NORET(
         addr, na_class->ops == NULL, done, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR_NORET(addr, na_class->ops->addr_cmp == NULL, done,
+    NA_CHECK_SUBSYS_ERROR_NORET(addr, NA_OPS(na_class)->addr_cmp == NULL, done,
         "addr_cmp plugin callback is not defined");
 
-    ret = na_class->ops->addr_cmp(na_class, addr1, addr2);
+    ret = NA_OPS(na_class)->addr_cmp(na_class, addr1, addr2);
 
     NA_LOG_SUBSYS_DEBUG(addr, "Compared addresses (%p) and (%p), result: %d",
         addr1, addr2, ret);
@@ -743,22 +932,22 @@ NA_Addr_to_string(
 
     NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops->addr_to_string == NULL, done,
+    NA_CHECK_SUBSYS_ERROR(addr, NA_OPS(na_class)->addr_to_string == NULL, done,
         ret, NA_OPNOTSUPPORTED,
         "addr_to_string plugin callback is not defined");
 
     /* Automatically prepend string by plugin name with class delimiter,
      * except for MPI plugin (special case, because of generated string) */
-    if (strcmp(na_class->ops->class_name, "mpi") == 0) {
+    if (strcmp(NA_OPS(na_class)->class_name, "mpi") == 0) {
         buf_size_used = 0;
         plugin_buf_size = *buf_size;
     } else {
         buf_size_used =
-            strlen(na_class->ops->class_name) + strlen(NA_CLASS_DELIMITER);
+            strlen(NA_OPS(na_class)->class_name) + strlen(NA_CLASS_DELIMITER);
         if (buf_ptr) {
             NA_CHECK_SUBSYS_ERROR(addr, buf_size_used >= *buf_size, done, ret,
                 NA_OVERFLOW, "Buffer size too small to copy addr");
-            strcpy(buf_ptr, na_class->ops->class_name);
+            strcpy(buf_ptr, NA_OPS(na_class)->class_name);
             strcat(buf_ptr, NA_CLASS_DELIMITER);
             buf_ptr += buf_size_used;
             plugin_buf_size = *buf_size - buf_size_used;
@@ -766,7 +955,7 @@ NA_Addr_to_string(
             plugin_buf_size = 0;
     }
 
-    ret = na_class->ops->addr_to_string(
+    ret = NA_OPS(na_class)->addr_to_string(
         na_class, buf_ptr, &plugin_buf_size, addr);
 
     *buf_size = buf_size_used + plugin_buf_size;
@@ -797,13 +986,13 @@ NA_Addr_serialize(
 
     NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops->addr_serialize == NULL, done,
+    NA_CHECK_SUBSYS_ERROR(addr, NA_OPS(na_class)->addr_serialize == NULL, done,
         ret, NA_OPNOTSUPPORTED,
         "addr_serialize plugin callback is not defined");
 
     NA_LOG_SUBSYS_DEBUG(addr, "Serializing address (%p)", addr);
 
-    ret = na_class->ops->addr_serialize(na_class, buf, buf_size, addr);
+    ret = NA_OPS(na_class)->addr_serialize(na_class, buf, buf_size, addr);
 
 done:
     return ret;
@@ -827,11 +1016,12 @@ NA_Addr_deserialize(
 
     NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops->addr_deserialize == NULL, done,
-        ret, NA_OPNOTSUPPORTED,
+    NA_CHECK_SUBSYS_ERROR(addr,
+        NA_OPS(na_class)->addr_deserialize == NULL, done, ret,
+        NA_OPNOTSUPPORTED,
         "addr_deserialize plugin callback is not defined");
 
-    ret = na_class->ops->addr_deserialize(na_class, addr, buf, buf_size);
+    ret = NA_OPS(na_class)->addr_deserialize(na_class, addr, buf, buf_size);
 
     NA_LOG_SUBSYS_DEBUG(addr, "Deserialized into new address (%p)", *addr);
 
@@ -839,6 +1029,54 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Addr_deserialize_batch(na_class_t *na_class, const void *buf,
+    na_size_t entry_size, na_size_t count, na_addr_t addrs[])
+{
+    const char *buf_ptr = (const char *) buf;
+    na_size_t i;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(
+        addr, na_class == NULL, done, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(
+        addr, buf == NULL, done, ret, NA_INVALID_ARG, "NULL buffer");
+    NA_CHECK_SUBSYS_ERROR(
+        addr, entry_size == 0, done, ret, NA_INVALID_ARG, "NULL entry size");
+    NA_CHECK_SUBSYS_ERROR(addr, addrs == NULL, done, ret, NA_INVALID_ARG,
+        "NULL array of na_addr_t");
+    if (count == 0)
+        goto done;
+
+    NA_CHECK_SUBSYS_ERROR(addr, na_class->ops == NULL, done, ret,
+        NA_INVALID_ARG, "NULL NA class ops");
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Deserializing %zu addrs", (size_t) count);
+
+    if (NA_OPS(na_class)->addr_deserialize_batch != NULL) {
+        ret = NA_OPS(na_class)->addr_deserialize_batch(
+            na_class, buf, entry_size, count, addrs);
+        goto done;
+    }
+
+    /* Plugins that cannot insert addrs at once use regular deserialization */
+    for (i = 0; i < count; i++) {
+        ret = NA_Addr_deserialize(
+            na_class, &addrs[i], buf_ptr + i * entry_size, entry_size);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            addr, error, ret, "Could not deserialize addr %zu", (size_t) i);
+    }
+
+done:
+    return ret;
+
+error:
+    while (i-- > 0)
+        NA_Addr_free(na_class, addrs[i]);
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 void *
 NA_Msg_buf_alloc(na_class_t *na_class, na_size_t buf_size, void **plugin_data)
@@ -852,8 +1090,8 @@ NA_Msg_buf_alloc(na_class_t *na_class, na_size_t buf_size, void **plugin_data)
 
     NA_CHECK_SUBSYS_ERROR_NORET(
         msg, na_class->ops == NULL, done, "NULL NA class ops");
-    if (na_class->ops->msg_buf_alloc)
-        ret = na_class->ops->msg_buf_alloc(na_class, buf_size, plugin_data);
+    if (NA_OPS(na_class)->msg_buf_alloc)
+        ret = NA_OPS(na_class)->msg_buf_alloc(na_class, buf_size, plugin_data);
     else {
         na_size_t page_size = (na_size_t) hg_mem_get_page_size();
 
@@ -889,8 +1127,8 @@ NA_Msg_buf_free(na_class_t *na_class, void *buf, void *plugin_data)
     NA_LOG_SUBSYS_DEBUG(
         msg, "Freeing msg buffer (%p), plugin data (%p)", buf, plugin_data);
 
-    if (na_class->ops->msg_buf_free)
-        ret = na_class->ops->msg_buf_free(na_class, buf, plugin_data);
+    if (NA_OPS(na_class)->msg_buf_free)
+        ret = NA_OPS(na_class)->msg_buf_free(na_class, buf, plugin_data);
     else {
         NA_CHECK_SUBSYS_ERROR(msg, plugin_data != (void *) 1, done, ret,
             NA_FAULT, "Invalid plugin data value");
@@ -916,8 +1154,8 @@ NA_Msg_init_unexpected(na_class_t *na_class, void *buf, na_size_t buf_size)
 
     NA_CHECK_SUBSYS_ERROR(msg, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    if (na_class->ops->msg_init_unexpected) {
-        ret = na_class->ops->msg_init_unexpected(na_class, buf, buf_size);
+    if (NA_OPS(na_class)->msg_init_unexpected) {
+        ret = NA_OPS(na_class)->msg_init_unexpected(na_class, buf, buf_size);
 
         NA_LOG_SUBSYS_DEBUG(
             msg, "Init unexpected buf (%p), size (%zu)", buf, buf_size);
@@ -942,8 +1180,8 @@ NA_Msg_init_expected(na_class_t *na_class, void *buf, na_size_t buf_size)
 
     NA_CHECK_SUBSYS_ERROR(msg, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    if (na_class->ops->msg_init_expected) {
-        ret = na_class->ops->msg_init_expected(na_class, buf, buf_size);
+    if (NA_OPS(na_class)->msg_init_expected) {
+        ret = NA_OPS(na_class)->msg_init_expected(na_class, buf, buf_size);
 
         NA_LOG_SUBSYS_DEBUG(
             msg, "Init expected buf (%p), size (%zu)", buf, buf_size);
@@ -953,6 +1191,70 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Msg_send_unexpectedv(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id)
+{
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        msg, na_class == NULL, done, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(msg, segment_count > 0 && segments == NULL, done,
+        ret, NA_INVALID_ARG, "NULL segments");
+
+    if (NA_OPS(na_class)->msg_send_unexpectedv)
+        return NA_OPS(na_class)->msg_send_unexpectedv(na_class, context,
+            callback, arg, buf, buf_size, plugin_data, segments,
+            segment_count, dest_addr, dest_id, tag, op_id);
+
+    /* Plugin cannot send segments directly, gather them into buf */
+    ret = na_msg_gather(buf, &buf_size,
+        NA_Msg_get_max_unexpected_size(na_class), segments, segment_count);
+    NA_CHECK_SUBSYS_NA_ERROR(msg, done, ret, "Could not gather segments");
+
+    ret = NA_OPS(na_class)->msg_send_unexpected(na_class, context, callback,
+        arg, buf, buf_size, plugin_data, dest_addr, dest_id, tag, op_id);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Msg_send_expectedv(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id)
+{
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        msg, na_class == NULL, done, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(msg, segment_count > 0 && segments == NULL, done,
+        ret, NA_INVALID_ARG, "NULL segments");
+
+    if (NA_OPS(na_class)->msg_send_expectedv)
+        return NA_OPS(na_class)->msg_send_expectedv(na_class, context, callback,
+            arg, buf, buf_size, plugin_data, segments, segment_count,
+            dest_addr, dest_id, tag, op_id);
+
+    /* Plugin cannot send segments directly, gather them into buf */
+    ret = na_msg_gather(buf, &buf_size,
+        NA_Msg_get_max_expected_size(na_class), segments, segment_count);
+    NA_CHECK_SUBSYS_NA_ERROR(msg, done, ret, "Could not gather segments");
+
+    ret = NA_OPS(na_class)->msg_send_expected(na_class, context, callback, arg,
+        buf, buf_size, plugin_data, dest_addr, dest_id, tag, op_id);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_Mem_handle_create(na_class_t *na_class, void *buf, na_size_t buf_size,
@@ -969,11 +1271,12 @@ NA_Mem_handle_create(na_class_t *na_class, void *buf, na_size_t buf_size,
 
     NA_CHECK_SUBSYS_ERROR(mem, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(mem, na_class->ops->mem_handle_create == NULL, done,
-        ret, NA_OPNOTSUPPORTED,
+    NA_CHECK_SUBSYS_ERROR(mem,
+        NA_OPS(na_class)->mem_handle_create == NULL, done, ret,
+        NA_OPNOTSUPPORTED,
         "mem_handle_create plugin callback is not defined");
 
-    ret = na_class->ops->mem_handle_create(
+    ret = NA_OPS(na_class)->mem_handle_create(
         na_class, buf, buf_size, flags, mem_handle);
 
     NA_LOG_SUBSYS_DEBUG(mem,
@@ -1001,11 +1304,11 @@ NA_Mem_handle_create_segments(na_class_t *na_class, struct na_segment *segments,
     NA_CHECK_SUBSYS_ERROR(mem, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
     NA_CHECK_SUBSYS_ERROR(mem,
-        na_class->ops->mem_handle_create_segments == NULL, done, ret,
+        NA_OPS(na_class)->mem_handle_create_segments == NULL, done, ret,
         NA_OPNOTSUPPORTED,
         "mem_handle_create_segments plugin callback is not defined");
 
-    ret = na_class->ops->mem_handle_create_segments(
+    ret = NA_OPS(na_class)->mem_handle_create_segments(
         na_class, segments, segment_count, flags, mem_handle);
 
     NA_LOG_SUBSYS_DEBUG(mem,
@@ -1016,6 +1319,43 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Mem_handle_create_sub(na_class_t *na_class, na_mem_handle_t parent_handle,
+    void *buf, na_size_t buf_size, unsigned long flags,
+    na_mem_handle_t *mem_handle)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(
+        mem, na_class == NULL, done, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(mem, parent_handle == NA_MEM_HANDLE_NULL, done, ret,
+        NA_INVALID_ARG, "NULL parent memory handle");
+    NA_CHECK_SUBSYS_ERROR(
+        mem, buf == NULL, done, ret, NA_INVALID_ARG, "NULL buffer");
+    NA_CHECK_SUBSYS_ERROR(
+        mem, buf_size == 0, done, ret, NA_INVALID_ARG, "NULL buffer size");
+
+    NA_CHECK_SUBSYS_ERROR(mem, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
+        "NULL NA class ops");
+    if (NA_OPS(na_class)->mem_handle_create_sub)
+        ret = NA_OPS(na_class)->mem_handle_create_sub(
+            na_class, parent_handle, buf, buf_size, flags, mem_handle);
+    else if (NA_OPS(na_class)->mem_register == NULL)
+        /* Nothing to share if plugin does not register memory */
+        ret = NA_Mem_handle_create(na_class, buf, buf_size, flags, mem_handle);
+    else
+        ret = NA_OPNOTSUPPORTED;
+
+    NA_LOG_SUBSYS_DEBUG(mem,
+        "Created new sub mem handle (%p) of (%p), buf (%p), buf_size (%zu)",
+        (ret == NA_SUCCESS) ? *mem_handle : NA_MEM_HANDLE_NULL, parent_handle,
+        buf, buf_size);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_Mem_handle_free(na_class_t *na_class, na_mem_handle_t mem_handle)
@@ -1029,13 +1369,13 @@ NA_Mem_handle_free(na_class_t *na_class, na_mem_handle_t mem_handle)
 
     NA_CHECK_SUBSYS_ERROR(mem, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(mem, na_class->ops->mem_handle_free == NULL, done,
+    NA_CHECK_SUBSYS_ERROR(mem, NA_OPS(na_class)->mem_handle_free == NULL, done,
         ret, NA_OPNOTSUPPORTED,
         "mem_handle_free plugin callback is not defined");
 
     NA_LOG_SUBSYS_DEBUG(mem, "Freeing mem handle (%p)", mem_handle);
 
-    ret = na_class->ops->mem_handle_free(na_class, mem_handle);
+    ret = NA_OPS(na_class)->mem_handle_free(na_class, mem_handle);
 
 done:
     return ret;
@@ -1054,9 +1394,9 @@ NA_Mem_register(na_class_t *na_class, na_mem_handle_t mem_handle)
 
     NA_CHECK_SUBSYS_ERROR(mem, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    if (na_class->ops->mem_register) {
+    if (NA_OPS(na_class)->mem_register) {
         /* Optional */
-        ret = na_class->ops->mem_register(na_class, mem_handle);
+        ret = NA_OPS(na_class)->mem_register(na_class, mem_handle);
 
         NA_LOG_SUBSYS_DEBUG(mem, "Registered mem handle (%p)", mem_handle);
     }
@@ -1065,6 +1405,40 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Mem_register_attr(na_class_t *na_class, na_mem_handle_t mem_handle,
+    na_mem_type_t mem_type, na_uint64_t device)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    /* Host memory does not require any attribute */
+    if (mem_type == NA_MEM_TYPE_UNKNOWN || mem_type == NA_MEM_TYPE_HOST)
+        return NA_Mem_register(na_class, mem_handle);
+
+    NA_CHECK_SUBSYS_ERROR(
+        mem, na_class == NULL, done, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(mem, mem_handle == NA_MEM_HANDLE_NULL, done, ret,
+        NA_INVALID_ARG, "NULL memory handle");
+
+    NA_CHECK_SUBSYS_ERROR(mem, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
+        "NULL NA class ops");
+    NA_CHECK_SUBSYS_ERROR(mem,
+        NA_OPS(na_class)->mem_register_attr == NULL, done, ret,
+        NA_OPNOTSUPPORTED,
+        "Device memory registration is not supported by this plugin");
+
+    ret = NA_OPS(na_class)->mem_register_attr(
+        na_class, mem_handle, mem_type, device);
+
+    NA_LOG_SUBSYS_DEBUG(mem,
+        "Registered mem handle (%p), mem type (%d), device (%zu)",
+        mem_handle, (int) mem_type, (size_t) device);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_Mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
@@ -1078,9 +1452,9 @@ NA_Mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
 
     NA_CHECK_SUBSYS_ERROR(mem, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    if (na_class->ops->mem_deregister)
+    if (NA_OPS(na_class)->mem_deregister)
         /* Optional */
-        ret = na_class->ops->mem_deregister(na_class, mem_handle);
+        ret = NA_OPS(na_class)->mem_deregister(na_class, mem_handle);
 
 done:
     return ret;
@@ -1104,13 +1478,13 @@ NA_Mem_handle_serialize(na_class_t *na_class, void *buf, na_size_t buf_size,
 
     NA_CHECK_SUBSYS_ERROR(mem, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(mem, na_class->ops->mem_handle_serialize == NULL,
+    NA_CHECK_SUBSYS_ERROR(mem, NA_OPS(na_class)->mem_handle_serialize == NULL,
         done, ret, NA_OPNOTSUPPORTED,
         "mem_handle_serialize plugin callback is not defined");
 
     NA_LOG_SUBSYS_DEBUG(mem, "Serializing mem handle (%p)", mem_handle);
 
-    ret = na_class->ops->mem_handle_serialize(
+    ret = NA_OPS(na_class)->mem_handle_serialize(
         na_class, buf, buf_size, mem_handle);
 
 done:
@@ -1135,11 +1509,11 @@ NA_Mem_handle_deserialize(na_class_t *na_class, na_mem_handle_t *mem_handle,
 
     NA_CHECK_SUBSYS_ERROR(mem, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(mem, na_class->ops->mem_handle_deserialize == NULL,
+    NA_CHECK_SUBSYS_ERROR(mem, NA_OPS(na_class)->mem_handle_deserialize == NULL,
         done, ret, NA_OPNOTSUPPORTED,
         "mem_handle_deserialize plugin callback is not defined");
 
-    ret = na_class->ops->mem_handle_deserialize(
+    ret = NA_OPS(na_class)->mem_handle_deserialize(
         na_class, mem_handle, buf, buf_size);
 
     NA_LOG_SUBSYS_DEBUG(mem, "Deserialized into mem handle (%p)", *mem_handle);
@@ -1170,8 +1544,8 @@ NA_Poll_try_wait(na_class_t *na_class, na_context_t *context)
     /* Check plugin try wait */
     NA_CHECK_SUBSYS_ERROR_NORET(
         poll, na_class->ops == NULL, error, "NULL NA class ops");
-    if (na_class->ops->na_poll_try_wait)
-        return na_class->ops->na_poll_try_wait(na_class, context);
+    if (NA_OPS(na_class)->na_poll_try_wait)
+        return NA_OPS(na_class)->na_poll_try_wait(na_class, context);
 
     NA_LOG_SUBSYS_DEBUG(poll, "Safe to wait on context (%p)", context);
 
@@ -1201,7 +1575,7 @@ NA_Progress(na_class_t *na_class, na_context_t *context, unsigned int timeout)
 
     NA_CHECK_SUBSYS_ERROR(poll, na_class->ops == NULL, done, ret,
         NA_INVALID_ARG, "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(poll, na_class->ops->progress == NULL, done, ret,
+    NA_CHECK_SUBSYS_ERROR(poll, NA_OPS(na_class)->progress == NULL, done, ret,
         NA_OPNOTSUPPORTED, "progress plugin callback is not defined");
 
     NA_LOG_SUBSYS_DEBUG(
@@ -1264,7 +1638,7 @@ NA_Progress(na_class_t *na_class, na_context_t *context, unsigned int timeout)
     }
 
     /* Try to make progress for remaining time */
-    ret = na_class->ops->progress(
+    ret = NA_OPS(na_class)->progress(
         na_class, context, (unsigned int) (remaining * 1000.0));
 
 #ifdef NA_HAS_MULTI_PROGRESS
@@ -1303,11 +1677,16 @@ NA_Trigger(na_context_t *context, unsigned int timeout, unsigned int max_count,
 
     while (count < max_count) {
         struct na_cb_completion_data *completion_data_ptr = NULL;
-        struct na_cb_completion_data completion_data;
-
-        completion_data_ptr =
-            hg_atomic_queue_pop_mc(na_private_context->completion_queue);
-        if (!completion_data_ptr) {
+        void *completions[NA_TRIGGER_BATCH];
+        unsigned int n, i;
+        int cb_ret;
+
+        /* Dequeue a batch of completions at once */
+        n = hg_atomic_queue_pop_mc_n(na_private_context->completion_queue,
+            completions,
+            (max_count - count < NA_TRIGGER_BATCH) ? max_count - count
+                                                   : NA_TRIGGER_BATCH);
+        if (n == 0) {
             /* Check backfill queue */
             if (hg_atomic_get32(&na_private_context->backfill_queue_count)) {
                 hg_thread_mutex_lock(
@@ -1337,6 +1716,7 @@ NA_Trigger(na_context_t *context, unsigned int timeout, unsigned int max_count,
 
                 hg_thread_mutex_lock(
                     &na_private_context->completion_queue_mutex);
+                hg_atomic_incr32(&na_private_context->completion_queue_waiters);
 
                 /* Otherwise wait remaining ms */
                 if (hg_atomic_queue_is_empty(
@@ -1352,6 +1732,7 @@ NA_Trigger(na_context_t *context, unsigned int timeout, unsigned int max_count,
                     ret = NA_TIMEOUT;
                 }
 
+                hg_atomic_decr32(&na_private_context->completion_queue_waiters);
                 hg_thread_mutex_unlock(
                     &na_private_context->completion_queue_mutex);
                 if (ret == NA_TIMEOUT)
@@ -1361,32 +1742,20 @@ NA_Trigger(na_context_t *context, unsigned int timeout, unsigned int max_count,
                 remaining -= hg_time_diff(t2, t1);
                 continue; /* Give another chance to grab it */
             }
+            completions[n++] = completion_data_ptr;
         }
 
-        /* Completion data should be valid */
-        NA_CHECK_SUBSYS_ERROR(op, completion_data_ptr == NULL, done, ret,
-            NA_INVALID_ARG, "NULL completion data");
-        completion_data = *completion_data_ptr;
-
-        /* Execute plugin callback (free resources etc) first since actual
-         * callback will notify user that operation has completed.
-         * NB. If the NA operation ID is reused by the plugin for another
-         * operation we must be careful that resources are released BEFORE that
-         * operation ID gets re-used.
-         */
-        if (completion_data.plugin_callback)
-            completion_data.plugin_callback(
-                completion_data.plugin_callback_args);
-
-        /* Execute callback */
-        if (completion_data.callback) {
-            int cb_ret =
-                completion_data.callback(&completion_data.callback_info);
+        for (i = 0; i < n; i++) {
+            /* Completion data should be valid */
+            NA_CHECK_SUBSYS_ERROR(op, completions[i] == NULL, done, ret,
+                NA_INVALID_ARG, "NULL completion data");
+            cb_ret = na_cb_completion_run(
+                (struct na_cb_completion_data *) completions[i]);
             if (callback_ret)
                 callback_ret[count] = cb_ret;
-        }
 
-        count++;
+            count++;
+        }
     }
 
     if (actual_count)
@@ -1396,6 +1765,98 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+int
+NA_Trigger_completion(void *completion)
+{
+    return na_cb_completion_run((struct na_cb_completion_data *) completion);
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Context_set_completion_sink(
+    na_context_t *context, na_cb_sink_t sink, void *arg)
+{
+    struct na_private_context *na_private_context =
+        (struct na_private_context *) context;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(
+        ctx, context == NULL, done, ret, NA_INVALID_ARG, "NULL context");
+
+    na_private_context->completion_sink_arg = arg;
+    na_private_context->completion_sink = sink;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Context_set_retry_callback(
+    na_context_t *context, na_cb_retry_t callback, void *arg)
+{
+    struct na_private_context *na_private_context =
+        (struct na_private_context *) context;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(
+        ctx, context == NULL, done, ret, NA_INVALID_ARG, "NULL context");
+
+    na_private_context->retry_arg = arg;
+    na_private_context->retry_callback = callback;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Context_get_stats(na_context_t *context, struct na_context_stats *stats)
+{
+    struct na_private_context *na_private_context =
+        (struct na_private_context *) context;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(
+        ctx, context == NULL, done, ret, NA_INVALID_ARG, "NULL context");
+    NA_CHECK_SUBSYS_ERROR(
+        ctx, stats == NULL, done, ret, NA_INVALID_ARG, "NULL stats");
+
+    stats->completion_count =
+        hg_atomic_queue_count(na_private_context->completion_queue);
+    stats->backfill_count =
+        (na_uint32_t) hg_atomic_get32(&na_private_context->backfill_queue_count);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Get_resource_stats(
+    na_class_t *na_class, struct na_resource_stats *stats, na_uint32_t *count)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(
+        cls, na_class == NULL, done, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(
+        cls, count == NULL, done, ret, NA_INVALID_ARG, "NULL count");
+    NA_CHECK_SUBSYS_ERROR(cls, stats == NULL && *count > 0, done, ret,
+        NA_INVALID_ARG, "NULL stats");
+
+    if (na_class->ops == NULL || NA_OPS(na_class)->get_resource_stats == NULL) {
+        *count = 0;
+        goto done;
+    }
+
+    ret = NA_OPS(na_class)->get_resource_stats(na_class, stats, count);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_Cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id)
@@ -1411,12 +1872,12 @@ NA_Cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id)
 
     NA_CHECK_SUBSYS_ERROR(op, na_class->ops == NULL, done, ret, NA_INVALID_ARG,
         "NULL NA class ops");
-    NA_CHECK_SUBSYS_ERROR(op, na_class->ops->cancel == NULL, done, ret,
+    NA_CHECK_SUBSYS_ERROR(op, NA_OPS(na_class)->cancel == NULL, done, ret,
         NA_OPNOTSUPPORTED, "cancel plugin callback is not defined");
 
     NA_LOG_SUBSYS_DEBUG(op, "Canceling op ID (%p)", op_id);
 
-    ret = na_class->ops->cancel(na_class, context, op_id);
+    ret = NA_OPS(na_class)->cancel(na_class, context, op_id);
 
 done:
     return ret;
@@ -1437,6 +1898,15 @@ na_cb_completion_add(
     struct na_private_context *na_private_context =
         (struct na_private_context *) context;
 
+    /* Hand completion over to the sink, canceled operations still go through
+     * the completion queue so that they can be drained with NA_Trigger() */
+    if (na_private_context->completion_sink &&
+        na_cb_completion_data->callback_info.ret != NA_CANCELED) {
+        na_private_context->completion_sink(
+            na_private_context->completion_sink_arg, na_cb_completion_data);
+        return;
+    }
+
     if (hg_atomic_queue_push(na_private_context->completion_queue,
             na_cb_completion_data) != HG_UTIL_SUCCESS) {
         /* Queue is full */
@@ -1448,8 +1918,153 @@ na_cb_completion_add(
     }
 
     /* Callback is pushed to the completion queue when something completes
-     * so wake up anyone waiting in the trigger */
-    hg_thread_mutex_lock(&na_private_context->completion_queue_mutex);
-    hg_thread_cond_signal(&na_private_context->completion_queue_cond);
-    hg_thread_mutex_unlock(&na_private_context->completion_queue_mutex);
+     * so wake up anyone waiting in the trigger. Waiters register themselves
+     * before checking the queues so that the mutex can be skipped when
+     * completions are added in bulk and nobody is waiting */
+    hg_atomic_fence();
+    if (hg_atomic_get32(&na_private_context->completion_queue_waiters)) {
+        hg_thread_mutex_lock(&na_private_context->completion_queue_mutex);
+        hg_thread_cond_signal(&na_private_context->completion_queue_cond);
+        hg_thread_mutex_unlock(&na_private_context->completion_queue_mutex);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+void
+na_cb_retry_notify(na_context_t *context, na_cb_type_t type)
+{
+    struct na_private_context *na_private_context =
+        (struct na_private_context *) context;
+
+    if (na_private_context->retry_callback)
+        na_private_context->retry_callback(na_private_context->retry_arg, type);
+}
+
+/*---------------------------------------------------------------------------*/
+struct na_op_slab *
+na_op_slab_create(size_t obj_size)
+{
+    struct na_op_slab *na_op_slab;
+
+    na_op_slab = (struct na_op_slab *) calloc(1, sizeof(*na_op_slab));
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        op, na_op_slab == NULL, error, "Could not allocate op ID slab");
+    hg_thread_mutex_init(&na_op_slab->mutex);
+    na_op_slab->obj_size = (obj_size + HG_MEM_CACHE_LINE_SIZE - 1) &
+                           ~((size_t) HG_MEM_CACHE_LINE_SIZE - 1);
+
+    na_op_slab->cache = hg_atomic_queue_alloc(NA_OP_SLAB_CACHE_SIZE);
+    NA_CHECK_SUBSYS_ERROR_NORET(op, na_op_slab->cache == NULL, error,
+        "Could not allocate op ID slab cache");
+
+    return na_op_slab;
+
+error:
+    if (na_op_slab) {
+        hg_thread_mutex_destroy(&na_op_slab->mutex);
+        free(na_op_slab);
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+na_op_slab_destroy(struct na_op_slab *na_op_slab)
+{
+    void *chunk;
+
+    if (na_op_slab == NULL)
+        return;
+
+    /* Objects are released along with their chunk */
+    while ((chunk = na_op_slab->chunks) != NULL) {
+        na_op_slab->chunks = *(void **) chunk;
+        hg_mem_aligned_free(chunk);
+    }
+    hg_atomic_queue_free(na_op_slab->cache);
+    hg_thread_mutex_destroy(&na_op_slab->mutex);
+    free(na_op_slab);
+}
+
+/*---------------------------------------------------------------------------*/
+void *
+na_op_slab_alloc(struct na_op_slab *na_op_slab)
+{
+    void *obj;
+
+    /* Fast path */
+    obj = hg_atomic_queue_pop_mc(na_op_slab->cache);
+    if (likely(obj != NULL))
+        return obj;
+
+    hg_thread_mutex_lock(&na_op_slab->mutex);
+    if (na_op_slab->overflow != NULL) {
+        obj = na_op_slab->overflow;
+        na_op_slab->overflow = *(void **) obj;
+    } else {
+        if (na_op_slab->next == na_op_slab->end) {
+            size_t chunk_size = HG_MEM_CACHE_LINE_SIZE +
+                                NA_OP_SLAB_CHUNK_COUNT * na_op_slab->obj_size;
+            char *chunk = (char *) hg_mem_aligned_alloc(
+                HG_MEM_CACHE_LINE_SIZE, chunk_size);
+            NA_CHECK_SUBSYS_ERROR_NORET(op, chunk == NULL, done,
+                "Could not allocate op ID slab chunk");
+
+            *(void **) chunk = na_op_slab->chunks;
+            na_op_slab->chunks = chunk;
+            na_op_slab->next = chunk + HG_MEM_CACHE_LINE_SIZE;
+            na_op_slab->end = chunk + chunk_size;
+        }
+        obj = na_op_slab->next;
+        na_op_slab->next += na_op_slab->obj_size;
+    }
+
+done:
+    hg_thread_mutex_unlock(&na_op_slab->mutex);
+
+    return obj;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+na_op_slab_free(struct na_op_slab *na_op_slab, void *obj)
+{
+    if (likely(hg_atomic_queue_push(na_op_slab->cache, obj) == HG_UTIL_SUCCESS))
+        return;
+
+    /* Cache is full */
+    hg_thread_mutex_lock(&na_op_slab->mutex);
+    *(void **) obj = na_op_slab->overflow;
+    na_op_slab->overflow = obj;
+    hg_thread_mutex_unlock(&na_op_slab->mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+na_uint64_t
+na_atomic_host(
+    void *ptr, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare)
+{
+    hg_atomic_int64_t *value = (hg_atomic_int64_t *) ptr;
+    hg_util_int64_t prev;
+
+    switch (op) {
+        case NA_ATOMIC_FETCH_ADD:
+            prev = hg_atomic_add64(value, (hg_util_int64_t) operand);
+            break;
+        case NA_ATOMIC_COMPARE_SWAP:
+            /* Previous value is returned whether the swap happened or not */
+            do {
+                prev = hg_atomic_get64(value);
+            } while (prev == (hg_util_int64_t) compare &&
+                     !hg_atomic_cas64(value, prev, (hg_util_int64_t) operand));
+            break;
+        case NA_ATOMIC_SWAP:
+        default:
+            do {
+                prev = hg_atomic_get64(value);
+            } while (!hg_atomic_cas64(value, prev, (hg_util_int64_t) operand));
+            break;
+    }
+
+    return (na_uint64_t) prev;
 }
@@ -122,6 +122,18 @@ NA_Get_class_protocol(const na_class_t *na_class) NA_WARN_UNUSED_RESULT;
 static NA_INLINE na_bool_t
 NA_Is_listening(const na_class_t *na_class) NA_WARN_UNUSED_RESULT;
 
+/**
+ * Return the NUMA node that resources of the NA class are placed on. When
+ * NA_NUMA_NODE_DEVICE was requested, this is the node of the network device
+ * if it could be detected.
+ *
+ * \param na_class [IN]         pointer to NA class
+ *
+ * \return NUMA node or NA_NUMA_NODE_ANY
+ */
+static NA_INLINE na_int32_t
+NA_Get_numa_node(const na_class_t *na_class) NA_WARN_UNUSED_RESULT;
+
 /**
  * Create a new context.
  *
@@ -141,7 +153,8 @@ NA_Context_create(na_class_t *na_class) NA_WARN_UNUSED_RESULT;
  * \return Pointer to NA context or NULL in case of failure
  */
 NA_PUBLIC na_context_t *
-NA_Context_create_id(na_class_t *na_class, na_uint8_t id) NA_WARN_UNUSED_RESULT;
+NA_Context_create_id(
+    na_class_t *na_class, na_uint16_t id) NA_WARN_UNUSED_RESULT;
 
 /**
  * Destroy a context created by using NA_Context_create().
@@ -154,6 +167,73 @@ NA_Context_create_id(na_class_t *na_class, na_uint8_t id) NA_WARN_UNUSED_RESULT;
 NA_PUBLIC na_return_t
 NA_Context_destroy(na_class_t *na_class, na_context_t *context);
 
+/**
+ * Register a sink that completed operations of the context are passed to
+ * instead of being added to the context completion queue, allowing an upper
+ * layer to merge NA completions into its own completion queue. The sink is
+ * called from the plugin progress path (and from the posting call for
+ * operations that complete immediately) and must therefore not execute the
+ * completion itself, this is later done by calling NA_Trigger_completion().
+ * Canceled operations are not passed to the sink and must still be triggered
+ * with NA_Trigger(). The sink must be set before any operation is posted on
+ * the context, passing a NULL sink restores default behavior.
+ *
+ * \param context [IN/OUT]      pointer to context of execution
+ * \param sink [IN]             pointer to sink function
+ * \param arg [IN]              pointer to data passed to sink
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Context_set_completion_sink(
+    na_context_t *context, na_cb_sink_t sink, void *arg);
+
+/**
+ * Register a callback that is called each time the plugin attempts again an
+ * operation of the context that could not be posted at first (e.g., because
+ * of transient resource exhaustion). The callback is called from the plugin
+ * progress path and must not call back into NA. Passing a NULL callback
+ * disables notifications.
+ *
+ * \param context [IN/OUT]      pointer to context of execution
+ * \param callback [IN]         pointer to retry callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Context_set_retry_callback(
+    na_context_t *context, na_cb_retry_t callback, void *arg);
+
+/**
+ * Get a snapshot of the completion queues of the context. Entries are only
+ * added to the backfill queue when the completion queue is full.
+ *
+ * \param context [IN]          pointer to context of execution
+ * \param stats [OUT]           pointer to context stats
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Context_get_stats(na_context_t *context, struct na_context_stats *stats);
+
+/**
+ * Get the usage of resources that are specific to the plugin (e.g., shared
+ * queue pairs, registration caches or buffer pools). \count must be set to
+ * the number of entries of \stats on input and is set on output to the
+ * number of resources reported by the plugin (at most that many entries of
+ * \stats are filled). Plugins that do not report resources set \count to 0.
+ *
+ * \param na_class [IN]         pointer to NA class
+ * \param stats [OUT]           array of resource stats (may be NULL)
+ * \param count [IN/OUT]        pointer to number of resource stats
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Get_resource_stats(
+    na_class_t *na_class, struct na_resource_stats *stats, na_uint32_t *count);
+
 /**
  * Allocate an operation ID for the higher level layer to save and
  * pass back to the NA layer rather than have the NA layer allocate operation
@@ -194,6 +274,23 @@ NA_Op_destroy(na_class_t *na_class, na_op_id_t *op_id);
 NA_PUBLIC na_return_t
 NA_Addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr);
 
+/**
+ * Lookup count addrs from an array of peer addresses/names. Plugins may
+ * resolve all the names at once, which is cheaper than calling
+ * NA_Addr_lookup() on each name. Addresses need to be freed by calling
+ * NA_Addr_free(). If an error is returned, no address is returned.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param names [IN]            array of lookup names
+ * \param count [IN]            number of names
+ * \param addrs [OUT]           array of abstract addresses
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Addr_lookup_batch(na_class_t *na_class, const char *const names[],
+    na_size_t count, na_addr_t addrs[]);
+
 /**
  * Free the addr from the list of peers.
  *
@@ -219,6 +316,22 @@ NA_Addr_free(na_class_t *na_class, na_addr_t addr);
 NA_PUBLIC na_return_t
 NA_Addr_set_remove(na_class_t *na_class, na_addr_t addr);
 
+/**
+ * Start establishing connections to count peers so that the first message
+ * sent to each of them does not pay connection setup. Connections are set up
+ * in parallel and complete asynchronously as progress is made; messages may
+ * be sent to these addresses at any time. Plugins that do not need or do not
+ * support it ignore this call.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Addr_warmup(na_class_t *na_class, const na_addr_t addrs[], na_size_t count);
+
 /**
  * Access self address.
  *
@@ -326,6 +439,26 @@ NA_PUBLIC na_return_t
 NA_Addr_deserialize(
     na_class_t *na_class, na_addr_t *addr, const void *buf, na_size_t buf_size);
 
+/**
+ * Deserialize count addresses from a buffer of fixed-width entries. Each
+ * entry holds an address serialized with NA_Addr_serialize(), padded to
+ * entry_size bytes. Plugins may insert all the addresses at once, which is
+ * cheaper than calling NA_Addr_deserialize() on each entry. Addresses need
+ * to be freed by calling NA_Addr_free(). If an error is returned, no address
+ * is returned.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param buf [IN]              pointer to buffer of count entries
+ * \param entry_size [IN]       size of each entry
+ * \param count [IN]            number of entries
+ * \param addrs [OUT]           array of abstract addresses
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Addr_deserialize_batch(na_class_t *na_class, const void *buf,
+    na_size_t entry_size, na_size_t count, na_addr_t addrs[]);
+
 /**
  * Get the maximum size of messages supported by unexpected send/recv.
  * Small message size.
@@ -463,9 +596,41 @@ NA_Msg_init_unexpected(na_class_t *na_class, void *buf, na_size_t buf_size);
 static NA_INLINE na_return_t
 NA_Msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
+/**
+ * Send an unexpected message made of the first buf_size bytes of buf followed
+ * by the segment_count segments described by segments. Plugins that support
+ * it pass the segments directly to the fabric, others gather them into buf
+ * after buf_size, which therefore must be large enough to hold the entire
+ * message. Both buf and the memory referenced by segments must remain valid
+ * until the operation completes. See NA_Msg_send_unexpected() for other
+ * parameters.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param context [IN/OUT]      pointer to context of execution
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param buf [IN]              pointer to send buffer
+ * \param buf_size [IN]         size of data already present in buffer
+ * \param plugin_data [IN]      pointer to internal plugin data
+ * \param segments [IN]         pointer to array of segments
+ * \param segment_count [IN]    number of segments
+ * \param dest_addr [IN]        abstract address of destination
+ * \param dest_id [IN]          destination context ID
+ * \param tag [IN]              tag attached to message
+ * \param op_id [IN/OUT]        pointer to operation ID
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Msg_send_unexpectedv(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id);
+
 /**
  * Receive an unexpected message. Unexpected receives may wait on any tag and
  * any source depending on the implementation. After completion, the user
@@ -540,9 +705,37 @@ NA_Msg_init_expected(na_class_t *na_class, void *buf, na_size_t buf_size);
 static NA_INLINE na_return_t
 NA_Msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
+/**
+ * Send an expected message made of the first buf_size bytes of buf followed
+ * by the segment_count segments described by segments. Same rules as for
+ * NA_Msg_send_unexpectedv() apply.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param context [IN/OUT]      pointer to context of execution
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param buf [IN]              pointer to send buffer
+ * \param buf_size [IN]         size of data already present in buffer
+ * \param plugin_data [IN]      pointer to internal plugin data
+ * \param segments [IN]         pointer to array of segments
+ * \param segment_count [IN]    number of segments
+ * \param dest_addr [IN]        abstract address of destination
+ * \param dest_id [IN]          destination context ID
+ * \param tag [IN]              tag attached to message
+ * \param op_id [IN/OUT]        pointer to operation ID
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Msg_send_expectedv(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id);
+
 /**
  * Receive an expected message from source_addr. After completion, the user
  * callback is placed into the context completion queue and can be triggered
@@ -571,7 +764,7 @@ NA_Msg_send_expected(na_class_t *na_class, na_context_t *context,
 static NA_INLINE na_return_t
 NA_Msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t source_addr, na_uint8_t source_id,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
     na_tag_t tag, na_op_id_t *op_id);
 
 /**
@@ -618,6 +811,29 @@ NA_PUBLIC na_return_t
 NA_Mem_handle_create_segments(na_class_t *na_class, struct na_segment *segments,
     na_size_t segment_count, unsigned long flags, na_mem_handle_t *mem_handle);
 
+/**
+ * Create memory handle for a region that lies within the region of an
+ * already registered memory handle. The new handle shares the registration of
+ * \parent_handle: it must not be registered and \parent_handle must remain
+ * registered until the new handle is freed. Deregistering the new handle has
+ * no effect.
+ * \remark Returns NA_OPNOTSUPPORTED if the plugin needs registration but
+ * cannot share it, NA_Mem_handle_create() must then be used instead.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param parent_handle [IN]    registered memory handle
+ * \param buf [IN]              pointer to buffer within parent region
+ * \param buf_size [IN]         buffer size
+ * \param flags [IN]            permission flag (subset of parent flags)
+ * \param mem_handle [OUT]      pointer to returned abstract memory handle
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Mem_handle_create_sub(na_class_t *na_class, na_mem_handle_t parent_handle,
+    void *buf, na_size_t buf_size, unsigned long flags,
+    na_mem_handle_t *mem_handle);
+
 /**
  * Free memory handle.
  *
@@ -654,6 +870,22 @@ NA_Mem_handle_get_max_segments(
 NA_PUBLIC na_return_t
 NA_Mem_register(na_class_t *na_class, na_mem_handle_t mem_handle);
 
+/**
+ * Register memory that may reside on a device for RMA operations.
+ * Host memory is registered as with NA_Mem_register(). Device memory
+ * requires plugin support (see na_init_info.request_mem_device).
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param mem_handle [IN]       pointer to abstract memory handle
+ * \param mem_type [IN]         memory type
+ * \param device [IN]           device ID (ignored for host memory)
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Mem_register_attr(na_class_t *na_class, na_mem_handle_t mem_handle,
+    na_mem_type_t mem_type, na_uint64_t device);
+
 /**
  * Unregister memory.
  *
@@ -740,7 +972,7 @@ static NA_INLINE na_return_t
 NA_Put(na_class_t *na_class, na_context_t *context, na_cb_t callback, void *arg,
     na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t data_size, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t data_size, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
 /**
@@ -771,9 +1003,74 @@ static NA_INLINE na_return_t
 NA_Get(na_class_t *na_class, na_context_t *context, na_cb_t callback, void *arg,
     na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t data_size, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t data_size, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
+/**
+ * Atomically update a 64-bit value of remote registered memory and fetch its
+ * previous value. The remote value at remote_offset is updated according to
+ * op using operand (and compare for NA_ATOMIC_COMPARE_SWAP) without any
+ * involvement of the remote process, the previous value is written to the
+ * local registered memory at local_offset. Both offsets must be 8-byte
+ * aligned and the remote memory must be registered with read/write
+ * permission. After completion, the user callback is placed into a
+ * completion queue and can be triggered using NA_Trigger().
+ * \remark Plugins that cannot update remote memory atomically return
+ * NA_OPNOTSUPPORTED.
+ *
+ * \param na_class [IN/OUT]      pointer to NA class
+ * \param context [IN/OUT]       pointer to context of execution
+ * \param callback [IN]          pointer to function callback
+ * \param arg [IN]               pointer to data passed to callback
+ * \param op [IN]                atomic operation
+ * \param operand [IN]           operand of operation
+ * \param compare [IN]           value compared against (compare-swap only)
+ * \param local_mem_handle [IN]  abstract local memory handle
+ * \param local_offset [IN]      local offset of previous value
+ * \param remote_mem_handle [IN] abstract remote memory handle
+ * \param remote_offset [IN]     remote offset of value
+ * \param remote_addr [IN]       abstract address of remote target
+ * \param remote_id [IN]         target ID of remote target
+ * \param op_id [IN/OUT]         pointer to operation ID
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+static NA_INLINE na_return_t
+NA_Atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare,
+    na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t remote_addr, na_uint16_t remote_id, na_op_id_t *op_id);
+
+/**
+ * Start a batch of operations on context. Until the matching call to
+ * NA_Op_batch_end(), plugins that support it may hold the operations that
+ * are posted to context so that the whole batch is submitted to the network
+ * at once (e.g., with a single doorbell). Operations of a batch are always
+ * submitted when the batch ends or when context is progressed. Batches may
+ * be nested, operations are submitted when the outermost batch ends.
+ * \remark Errors that occur when a held operation gets submitted are reported
+ * through its callback.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param context [IN/OUT]      pointer to context of execution
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+static NA_INLINE na_return_t
+NA_Op_batch_begin(na_class_t *na_class, na_context_t *context);
+
+/**
+ * End a batch of operations on context, see NA_Op_batch_begin().
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param context [IN/OUT]      pointer to context of execution
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+static NA_INLINE na_return_t
+NA_Op_batch_end(na_class_t *na_class, na_context_t *context);
+
 /**
  * Retrieve file descriptor from NA plugin when supported. The descriptor
  * can be used by upper layers for manual polling through the usual
@@ -834,6 +1131,18 @@ NA_PUBLIC na_return_t
 NA_Trigger(na_context_t *context, unsigned int timeout, unsigned int max_count,
     int callback_ret[], unsigned int *actual_count);
 
+/**
+ * Execute the callbacks of a completion that was passed to a completion sink
+ * (see NA_Context_set_completion_sink()). Completions must be executed
+ * exactly once.
+ *
+ * \param completion [IN]        pointer to completion
+ *
+ * \return Return value of the user callback
+ */
+NA_PUBLIC int
+NA_Trigger_completion(void *completion);
+
 /**
  * Cancel an ongoing operation.
  *
@@ -875,6 +1184,7 @@ struct na_class {
     void *plugin_class;             /* Plugin private class */
     char *protocol_name;            /* Name of protocol */
     na_uint32_t progress_mode;      /* NA progress mode */
+    na_int32_t numa_node;           /* NUMA node (NA_NUMA_NODE_ANY if none) */
     na_bool_t listen;               /* Listen for connections */
 };
 
@@ -892,14 +1202,17 @@ struct na_class_ops {
     na_return_t (*finalize)(na_class_t *na_class);
     void (*cleanup)(void);
     na_return_t (*context_create)(
-        na_class_t *na_class, void **plugin_context, na_uint8_t id);
+        na_class_t *na_class, void **plugin_context, na_uint16_t id);
     na_return_t (*context_destroy)(na_class_t *na_class, void *plugin_context);
     na_op_id_t *(*op_create)(na_class_t *na_class);
     na_return_t (*op_destroy)(na_class_t *na_class, na_op_id_t *op_id);
     na_return_t (*addr_lookup)(
         na_class_t *na_class, const char *name, na_addr_t *addr);
+    na_return_t (*addr_lookup_batch)(na_class_t *na_class,
+        const char *const names[], na_size_t count, na_addr_t addrs[]);
     na_return_t (*addr_free)(na_class_t *na_class, na_addr_t addr);
     na_return_t (*addr_set_remove)(na_class_t *na_class, na_addr_t addr);
+    na_return_t (*addr_warmup)(na_class_t *na_class, na_addr_t addr);
     na_return_t (*addr_self)(na_class_t *na_class, na_addr_t *addr);
     na_return_t (*addr_dup)(
         na_class_t *na_class, na_addr_t addr, na_addr_t *new_addr);
@@ -913,6 +1226,9 @@ struct na_class_ops {
         na_class_t *na_class, void *buf, na_size_t buf_size, na_addr_t addr);
     na_return_t (*addr_deserialize)(na_class_t *na_class, na_addr_t *addr,
         const void *buf, na_size_t buf_size);
+    na_return_t (*addr_deserialize_batch)(na_class_t *na_class,
+        const void *buf, na_size_t entry_size, na_size_t count,
+        na_addr_t addrs[]);
     na_size_t (*msg_get_max_unexpected_size)(const na_class_t *na_class);
     na_size_t (*msg_get_max_expected_size)(const na_class_t *na_class);
     na_size_t (*msg_get_unexpected_header_size)(const na_class_t *na_class);
@@ -927,7 +1243,13 @@ struct na_class_ops {
     na_return_t (*msg_send_unexpected)(na_class_t *na_class,
         na_context_t *context, na_cb_t callback, void *arg, const void *buf,
         na_size_t buf_size, void *plugin_data, na_addr_t dest_addr,
-        na_uint8_t dest_id, na_tag_t tag, na_op_id_t *op_id);
+        na_uint16_t dest_id, na_tag_t tag, na_op_id_t *op_id);
+    na_return_t (*msg_send_unexpectedv)(na_class_t *na_class,
+        na_context_t *context, na_cb_t callback, void *arg, void *buf,
+        na_size_t buf_size, void *plugin_data,
+        const struct na_segment *segments, na_size_t segment_count,
+        na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
+        na_op_id_t *op_id);
     na_return_t (*msg_recv_unexpected)(na_class_t *na_class,
         na_context_t *context, na_cb_t callback, void *arg, void *buf,
         na_size_t buf_size, void *plugin_data, na_op_id_t *op_id);
@@ -936,11 +1258,17 @@ struct na_class_ops {
     na_return_t (*msg_send_expected)(na_class_t *na_class,
         na_context_t *context, na_cb_t callback, void *arg, const void *buf,
         na_size_t buf_size, void *plugin_data, na_addr_t dest_addr,
-        na_uint8_t dest_id, na_tag_t tag, na_op_id_t *op_id);
+        na_uint16_t dest_id, na_tag_t tag, na_op_id_t *op_id);
+    na_return_t (*msg_send_expectedv)(na_class_t *na_class,
+        na_context_t *context, na_cb_t callback, void *arg, void *buf,
+        na_size_t buf_size, void *plugin_data,
+        const struct na_segment *segments, na_size_t segment_count,
+        na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
+        na_op_id_t *op_id);
     na_return_t (*msg_recv_expected)(na_class_t *na_class,
         na_context_t *context, na_cb_t callback, void *arg, void *buf,
         na_size_t buf_size, void *plugin_data, na_addr_t source_addr,
-        na_uint8_t source_id, na_tag_t tag, na_op_id_t *op_id);
+        na_uint16_t source_id, na_tag_t tag, na_op_id_t *op_id);
     na_return_t (*mem_handle_create)(na_class_t *na_class, void *buf,
         na_size_t buf_size, unsigned long flags, na_mem_handle_t *mem_handle);
     na_return_t (*mem_handle_create_segments)(na_class_t *na_class,
@@ -963,25 +1291,54 @@ struct na_class_ops {
         na_cb_t callback, void *arg, na_mem_handle_t local_mem_handle,
         na_offset_t local_offset, na_mem_handle_t remote_mem_handle,
         na_offset_t remote_offset, na_size_t length, na_addr_t remote_addr,
-        na_uint8_t remote_id, na_op_id_t *op_id);
+        na_uint16_t remote_id, na_op_id_t *op_id);
     na_return_t (*get)(na_class_t *na_class, na_context_t *context,
         na_cb_t callback, void *arg, na_mem_handle_t local_mem_handle,
         na_offset_t local_offset, na_mem_handle_t remote_mem_handle,
         na_offset_t remote_offset, na_size_t length, na_addr_t remote_addr,
-        na_uint8_t remote_id, na_op_id_t *op_id);
+        na_uint16_t remote_id, na_op_id_t *op_id);
     int (*na_poll_get_fd)(na_class_t *na_class, na_context_t *context);
     na_bool_t (*na_poll_try_wait)(na_class_t *na_class, na_context_t *context);
     na_return_t (*progress)(
         na_class_t *na_class, na_context_t *context, unsigned int timeout);
     na_return_t (*cancel)(
         na_class_t *na_class, na_context_t *context, na_op_id_t *op_id);
+    na_return_t (*get_resource_stats)(na_class_t *na_class,
+        struct na_resource_stats *stats, na_uint32_t *count);
+    na_return_t (*mem_handle_create_sub)(na_class_t *na_class,
+        na_mem_handle_t parent_handle, void *buf, na_size_t buf_size,
+        unsigned long flags, na_mem_handle_t *mem_handle);
+    na_return_t (*op_batch_begin)(na_class_t *na_class, na_context_t *context);
+    na_return_t (*op_batch_end)(na_class_t *na_class, na_context_t *context);
+    na_return_t (*mem_register_attr)(na_class_t *na_class,
+        na_mem_handle_t mem_handle, na_mem_type_t mem_type, na_uint64_t device);
+    na_return_t (*atomic)(na_class_t *na_class, na_context_t *context,
+        na_cb_t callback, void *arg, na_atomic_op_t op, na_uint64_t operand,
+        na_uint64_t compare, na_mem_handle_t local_mem_handle,
+        na_offset_t local_offset, na_mem_handle_t remote_mem_handle,
+        na_offset_t remote_offset, na_addr_t remote_addr, na_uint16_t remote_id,
+        na_op_id_t *op_id);
 };
 
+/* Ops of a class. When NA is built with a single plugin (NA_STATIC_PLUGIN),
+ * they are bound to the ops of that plugin so that calls do not need to load
+ * them from the class and can be resolved (and inlined with link-time
+ * optimization) at build time. */
+#ifdef NA_STATIC_PLUGIN
+#    define NA_STATIC_OPS_NAME(plugin_name)  NA_STATIC_OPS_NAME_(plugin_name)
+#    define NA_STATIC_OPS_NAME_(plugin_name) na_##plugin_name##_class_ops_g
+extern NA_PUBLIC const struct na_class_ops NA_STATIC_OPS_NAME(NA_STATIC_PLUGIN);
+#    define NA_OPS(na_class)                                                   \
+        ((void) (na_class), &NA_STATIC_OPS_NAME(NA_STATIC_PLUGIN))
+#else
+#    define NA_OPS(na_class) ((na_class)->ops)
+#endif
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE const char *
 NA_Get_class_name(const na_class_t *na_class)
 {
-    return na_class->ops->class_name;
+    return NA_OPS(na_class)->class_name;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -998,19 +1355,26 @@ NA_Is_listening(const na_class_t *na_class)
     return na_class->listen;
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_int32_t
+NA_Get_numa_node(const na_class_t *na_class)
+{
+    return na_class->numa_node;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_bool_t
 NA_Addr_is_self(na_class_t *na_class, na_addr_t addr)
 {
-    return na_class->ops->addr_is_self(na_class, addr);
+    return NA_OPS(na_class)->addr_is_self(na_class, addr);
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_size_t
 NA_Addr_get_serialize_size(na_class_t *na_class, na_addr_t addr)
 {
-    return (na_class->ops->addr_get_serialize_size)
-               ? na_class->ops->addr_get_serialize_size(na_class, addr)
+    return (NA_OPS(na_class)->addr_get_serialize_size)
+               ? NA_OPS(na_class)->addr_get_serialize_size(na_class, addr)
                : 0;
 }
 
@@ -1018,22 +1382,22 @@ NA_Addr_get_serialize_size(na_class_t *na_class, na_addr_t addr)
 static NA_INLINE na_size_t
 NA_Msg_get_max_unexpected_size(const na_class_t *na_class)
 {
-    return na_class->ops->msg_get_max_unexpected_size(na_class);
+    return NA_OPS(na_class)->msg_get_max_unexpected_size(na_class);
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_size_t
 NA_Msg_get_max_expected_size(const na_class_t *na_class)
 {
-    return na_class->ops->msg_get_max_expected_size(na_class);
+    return NA_OPS(na_class)->msg_get_max_expected_size(na_class);
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_size_t
 NA_Msg_get_unexpected_header_size(const na_class_t *na_class)
 {
-    return (na_class->ops->msg_get_unexpected_header_size)
-               ? na_class->ops->msg_get_unexpected_header_size(na_class)
+    return (NA_OPS(na_class)->msg_get_unexpected_header_size)
+               ? NA_OPS(na_class)->msg_get_unexpected_header_size(na_class)
                : 0;
 }
 
@@ -1041,8 +1405,8 @@ NA_Msg_get_unexpected_header_size(const na_class_t *na_class)
 static NA_INLINE na_size_t
 NA_Msg_get_expected_header_size(const na_class_t *na_class)
 {
-    return (na_class->ops->msg_get_expected_header_size)
-               ? na_class->ops->msg_get_expected_header_size(na_class)
+    return (NA_OPS(na_class)->msg_get_expected_header_size)
+               ? NA_OPS(na_class)->msg_get_expected_header_size(na_class)
                : 0;
 }
 
@@ -1050,18 +1414,18 @@ NA_Msg_get_expected_header_size(const na_class_t *na_class)
 static NA_INLINE na_tag_t
 NA_Msg_get_max_tag(const na_class_t *na_class)
 {
-    return na_class->ops->msg_get_max_tag(na_class);
+    return NA_OPS(na_class)->msg_get_max_tag(na_class);
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_return_t
 NA_Msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id)
 {
-    return na_class->ops->msg_send_unexpected(na_class, context, callback, arg,
-        buf, buf_size, plugin_data, dest_addr, dest_id, tag, op_id);
+    return NA_OPS(na_class)->msg_send_unexpected(na_class, context, callback,
+        arg, buf, buf_size, plugin_data, dest_addr, dest_id, tag, op_id);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1070,7 +1434,7 @@ NA_Msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
     void *plugin_data, na_op_id_t *op_id)
 {
-    return na_class->ops->msg_recv_unexpected(
+    return NA_OPS(na_class)->msg_recv_unexpected(
         na_class, context, callback, arg, buf, buf_size, plugin_data, op_id);
 }
 
@@ -1078,10 +1442,10 @@ NA_Msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
 static NA_INLINE na_return_t
 NA_Msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id)
 {
-    return na_class->ops->msg_send_expected(na_class, context, callback, arg,
+    return NA_OPS(na_class)->msg_send_expected(na_class, context, callback, arg,
         buf, buf_size, plugin_data, dest_addr, dest_id, tag, op_id);
 }
 
@@ -1089,10 +1453,10 @@ NA_Msg_send_expected(na_class_t *na_class, na_context_t *context,
 static NA_INLINE na_return_t
 NA_Msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t source_addr, na_uint8_t source_id,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
     na_tag_t tag, na_op_id_t *op_id)
 {
-    return na_class->ops->msg_recv_expected(na_class, context, callback, arg,
+    return NA_OPS(na_class)->msg_recv_expected(na_class, context, callback, arg,
         buf, buf_size, plugin_data, source_addr, source_id, tag, op_id);
 }
 
@@ -1100,8 +1464,8 @@ NA_Msg_recv_expected(na_class_t *na_class, na_context_t *context,
 static NA_INLINE na_size_t
 NA_Mem_handle_get_max_segments(const na_class_t *na_class)
 {
-    return (na_class->ops->mem_handle_get_max_segments)
-               ? na_class->ops->mem_handle_get_max_segments(na_class)
+    return (NA_OPS(na_class)->mem_handle_get_max_segments)
+               ? NA_OPS(na_class)->mem_handle_get_max_segments(na_class)
                : 1;
 }
 
@@ -1110,7 +1474,8 @@ static NA_INLINE na_size_t
 NA_Mem_handle_get_serialize_size(
     na_class_t *na_class, na_mem_handle_t mem_handle)
 {
-    return na_class->ops->mem_handle_get_serialize_size(na_class, mem_handle);
+    return NA_OPS(na_class)->mem_handle_get_serialize_size(
+        na_class, mem_handle);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1118,10 +1483,10 @@ static NA_INLINE na_return_t
 NA_Put(na_class_t *na_class, na_context_t *context, na_cb_t callback, void *arg,
     na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t data_size, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t data_size, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id)
 {
-    return na_class->ops->put(na_class, context, callback, arg,
+    return NA_OPS(na_class)->put(na_class, context, callback, arg,
         local_mem_handle, local_offset, remote_mem_handle, remote_offset,
         data_size, remote_addr, remote_id, op_id);
 }
@@ -1131,20 +1496,54 @@ static NA_INLINE na_return_t
 NA_Get(na_class_t *na_class, na_context_t *context, na_cb_t callback, void *arg,
     na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t data_size, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t data_size, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id)
 {
-    return na_class->ops->get(na_class, context, callback, arg,
+    return NA_OPS(na_class)->get(na_class, context, callback, arg,
         local_mem_handle, local_offset, remote_mem_handle, remote_offset,
         data_size, remote_addr, remote_id, op_id);
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_return_t
+NA_Atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare,
+    na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t remote_addr, na_uint16_t remote_id, na_op_id_t *op_id)
+{
+    return (NA_OPS(na_class)->atomic)
+               ? NA_OPS(na_class)->atomic(na_class, context, callback, arg, op,
+                     operand, compare, local_mem_handle, local_offset,
+                     remote_mem_handle, remote_offset, remote_addr, remote_id,
+                     op_id)
+               : NA_OPNOTSUPPORTED;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_return_t
+NA_Op_batch_begin(na_class_t *na_class, na_context_t *context)
+{
+    return (NA_OPS(na_class)->op_batch_begin)
+               ? NA_OPS(na_class)->op_batch_begin(na_class, context)
+               : NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_return_t
+NA_Op_batch_end(na_class_t *na_class, na_context_t *context)
+{
+    return (NA_OPS(na_class)->op_batch_end)
+               ? NA_OPS(na_class)->op_batch_end(na_class, context)
+               : NA_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE int
 NA_Poll_get_fd(na_class_t *na_class, na_context_t *context)
 {
-    return (na_class->ops->na_poll_get_fd)
-               ? na_class->ops->na_poll_get_fd(na_class, context)
+    return (NA_OPS(na_class)->na_poll_get_fd)
+               ? NA_OPS(na_class)->na_poll_get_fd(na_class, context)
                : -1;
 }
 
@@ -57,6 +57,9 @@
 #define NA_BMI_OP_QUEUED    (1 << 2)
 #define NA_BMI_OP_ERRORED   (1 << 3)
 
+/* Max number of completions harvested per BMI test call */
+#define NA_BMI_MAX_EVENTS (16)
+
 #define NA_BMI_CLASS(na_class)                                                 \
     ((struct na_bmi_class *) (na_class->plugin_class))
 #define NA_BMI_CONTEXT(context)                                                \
@@ -75,6 +78,12 @@ struct na_bmi_addr {
     hg_atomic_int32_t ref_count;       /* Ref count */
 };
 
+/* Msg buffer allocated with BMI_memalloc() */
+struct na_bmi_msg_buf {
+    BMI_addr_t bmi_addr; /* Addr used for allocation */
+    bmi_size_t size;     /* Size of buffer */
+};
+
 struct na_bmi_unexpected_info {
     struct BMI_unexpected_info info;
     struct na_bmi_addr *na_bmi_addr;
@@ -177,6 +186,7 @@ struct na_bmi_class {
     struct na_bmi_op_queue unexpected_op_queue; /* Unexpected op queue */
     struct na_bmi_map addr_map;                 /* Address map */
     struct na_bmi_addr_queue addr_queue;        /* Addr queue */
+    struct na_op_slab *op_slab;                 /* Slab of op IDs */
     hg_thread_mutex_t test_unexpected_mutex;    /* Mutex */
     char pref_anyip[16];                        /* for INADDR_ANY */
     char *protocol_name;                        /* Protocol used */
@@ -186,6 +196,7 @@ struct na_bmi_class {
     na_size_t expected_size_max;                /* Max expected size */
     int port;                                   /* Port used */
     hg_atomic_int32_t rma_tag;                  /* Atomic RMA tag value */
+    hg_atomic_int64_t mem_addr;                 /* Addr for BMI_memalloc */
 };
 
 /********************/
@@ -252,6 +263,13 @@ static na_return_t
 na_bmi_progress_unexpected(na_class_t *na_class, na_context_t *context,
     unsigned int timeout, na_bool_t *progressed);
 
+/**
+ * Process one completed unexpected message.
+ */
+static na_return_t
+na_bmi_process_unexpected(na_class_t *na_class, na_context_t *context,
+    struct BMI_unexpected_info *bmi_unexpected_info);
+
 /**
  * Progress expected messages.
  */
@@ -259,6 +277,13 @@ static na_return_t
 na_bmi_progress_expected(
     na_context_t *context, unsigned int timeout, na_bool_t *progressed);
 
+/**
+ * Process one completed expected operation.
+ */
+static na_return_t
+na_bmi_process_expected(bmi_op_id_t bmi_op_id, bmi_error_code_t error_code,
+    bmi_size_t bmi_actual_size, struct na_bmi_op_id *na_bmi_op_id);
+
 /**
  * Process unexpected messages.
  */
@@ -310,7 +335,7 @@ na_bmi_finalize(na_class_t *na_class);
 
 /* context_create */
 static na_return_t
-na_bmi_context_create(na_class_t *na_class, void **context, na_uint8_t id);
+na_bmi_context_create(na_class_t *na_class, void **context, na_uint16_t id);
 
 /* context_destroy */
 static na_return_t
@@ -365,11 +390,19 @@ na_bmi_msg_get_max_expected_size(const na_class_t *na_class);
 static na_tag_t
 na_bmi_msg_get_max_tag(const na_class_t *na_class);
 
+/* msg_buf_alloc */
+static void *
+na_bmi_msg_buf_alloc(na_class_t *na_class, na_size_t size, void **plugin_data);
+
+/* msg_buf_free */
+static na_return_t
+na_bmi_msg_buf_free(na_class_t *na_class, void *buf, void *plugin_data);
+
 /* msg_send_unexpected */
 static na_return_t
 na_bmi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
 /* msg_recv_unexpected */
@@ -382,14 +415,14 @@ na_bmi_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
 static na_return_t
 na_bmi_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
 /* msg_recv_expected */
 static na_return_t
 na_bmi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t source_addr, na_uint8_t source_id,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
     na_tag_t tag, na_op_id_t *op_id);
 
 /* mem_handle_create */
@@ -421,7 +454,7 @@ static na_return_t
 na_bmi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
 /* get */
@@ -429,7 +462,7 @@ static na_return_t
 na_bmi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
 /* progress */
@@ -456,8 +489,10 @@ const struct na_class_ops NA_PLUGIN_OPS(bmi) = {
     na_bmi_op_create,                     /* op_create */
     na_bmi_op_destroy,                    /* op_destroy */
     na_bmi_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
     na_bmi_addr_free,                     /* addr_free */
     NULL,                                 /* addr_set_remove */
+    NULL,                                 /* addr_warmup */
     na_bmi_addr_self,                     /* addr_self */
     na_bmi_addr_dup,                      /* addr_dup */
     na_bmi_addr_cmp,                      /* addr_cmp */
@@ -466,18 +501,21 @@ const struct na_class_ops NA_PLUGIN_OPS(bmi) = {
     NULL,                                 /* addr_get_serialize_size */
     NULL,                                 /* addr_serialize */
     NULL,                                 /* addr_deserialize */
+    NULL,                                 /* addr_deserialize_batch */
     na_bmi_msg_get_max_unexpected_size,   /* msg_get_max_unexpected_size */
     na_bmi_msg_get_max_expected_size,     /* msg_get_max_expected_size */
     NULL,                                 /* msg_get_unexpected_header_size */
     NULL,                                 /* msg_get_expected_header_size */
     na_bmi_msg_get_max_tag,               /* msg_get_max_tag */
-    NULL,                                 /* msg_buf_alloc */
-    NULL,                                 /* msg_buf_free */
+    na_bmi_msg_buf_alloc,                 /* msg_buf_alloc */
+    na_bmi_msg_buf_free,                  /* msg_buf_free */
     NULL,                                 /* msg_init_unexpected */
     na_bmi_msg_send_unexpected,           /* msg_send_unexpected */
+    NULL,                                 /* msg_send_unexpectedv */
     na_bmi_msg_recv_unexpected,           /* msg_recv_unexpected */
     NULL,                                 /* msg_init_expected */
     na_bmi_msg_send_expected,             /* msg_send_expected */
+    NULL,                                 /* msg_send_expectedv */
     na_bmi_msg_recv_expected,             /* msg_recv_expected */
     na_bmi_mem_handle_create,             /* mem_handle_create */
     NULL,                                 /* mem_handle_create_segment */
@@ -493,7 +531,13 @@ const struct na_class_ops NA_PLUGIN_OPS(bmi) = {
     NULL,                                 /* poll_get_fd */
     NULL,                                 /* poll_try_wait */
     na_bmi_progress,                      /* progress */
-    na_bmi_cancel                         /* cancel */
+    na_bmi_cancel,                        /* cancel */
+    NULL,                                 /* get_resource_stats */
+    NULL,                                 /* mem_handle_create_sub */
+    NULL,                                 /* op_batch_begin */
+    NULL,                                 /* op_batch_end */
+    NULL,                                 /* mem_register_attr */
+    NULL                                  /* atomic */
 };
 
 /********************/
@@ -656,70 +700,85 @@ static na_return_t
 na_bmi_progress_unexpected(na_class_t *na_class, na_context_t *context,
     unsigned int timeout, na_bool_t *progressed)
 {
-    int outcount = 0;
-    struct BMI_unexpected_info bmi_unexpected_info;
-    struct na_bmi_addr *na_bmi_addr = NULL;
+    struct BMI_unexpected_info bmi_unexpected_info[NA_BMI_MAX_EVENTS];
+    int outcount = 0, i;
     na_return_t ret = NA_SUCCESS;
-    na_bool_t queued = NA_FALSE;
     int bmi_ret;
 
     /* Prevent multiple threads from calling BMI_testunexpected concurrently */
     hg_thread_mutex_lock(&NA_BMI_CLASS(na_class)->test_unexpected_mutex);
-    bmi_ret =
-        BMI_testunexpected(1, &outcount, &bmi_unexpected_info, (int) timeout);
+    bmi_ret = BMI_testunexpected(
+        NA_BMI_MAX_EVENTS, &outcount, bmi_unexpected_info, (int) timeout);
     hg_thread_mutex_unlock(&NA_BMI_CLASS(na_class)->test_unexpected_mutex);
     NA_CHECK_ERROR(bmi_ret < 0, done, ret, NA_PROTOCOL_ERROR,
         "BMI_testunexpected() failed");
 
-    if (!outcount) {
-        *progressed = NA_FALSE;
-        return ret;
+    *progressed = (outcount > 0) ? NA_TRUE : NA_FALSE;
+
+    /* Process all harvested messages, even if one of them fails, so that
+     * their BMI buffers are released */
+    for (i = 0; i < outcount; i++) {
+        na_return_t na_ret = na_bmi_process_unexpected(
+            na_class, context, &bmi_unexpected_info[i]);
+        if (na_ret != NA_SUCCESS)
+            ret = na_ret;
     }
+    NA_CHECK_NA_ERROR(done, ret, "Could not process unexpected msg");
 
-    NA_CHECK_ERROR(bmi_unexpected_info.error_code != 0, cleanup, ret,
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_bmi_process_unexpected(na_class_t *na_class, na_context_t *context,
+    struct BMI_unexpected_info *bmi_unexpected_info)
+{
+    struct na_bmi_addr *na_bmi_addr = NULL;
+    na_return_t ret = NA_SUCCESS;
+    na_bool_t queued = NA_FALSE;
+
+    NA_CHECK_ERROR(bmi_unexpected_info->error_code != 0, cleanup, ret,
         NA_PROTOCOL_ERROR, "BMI_testunexpected failed(), error code set");
 
     /* Retrieve source addr */
     na_bmi_addr = na_bmi_addr_map_lookup(
-        &NA_BMI_CLASS(na_class)->addr_map, bmi_unexpected_info.addr);
+        &NA_BMI_CLASS(na_class)->addr_map, bmi_unexpected_info->addr);
     if (!na_bmi_addr) {
         na_return_t na_ret;
 
         NA_LOG_DEBUG("Address was not found, attempting to insert it (key=%ld)",
-            (long int) bmi_unexpected_info.addr);
+            (long int) bmi_unexpected_info->addr);
 
         /* Insert new entry and create new address if needed */
         na_ret = na_bmi_addr_map_insert(&NA_BMI_CLASS(na_class)->addr_map,
-            bmi_unexpected_info.addr, NA_TRUE,
+            bmi_unexpected_info->addr, NA_TRUE,
             &NA_BMI_CLASS(na_class)->addr_queue, &na_bmi_addr);
-        NA_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_EXIST, done, ret,
-            na_ret, "Could not insert new address");
+        NA_CHECK_ERROR(na_ret != NA_SUCCESS && na_ret != NA_EXIST, cleanup,
+            ret, na_ret, "Could not insert new address");
     } else
-        NA_LOG_DEBUG(
-            "Address was found (key=%ld)", (long int) bmi_unexpected_info.addr);
+        NA_LOG_DEBUG("Address was found (key=%ld)",
+            (long int) bmi_unexpected_info->addr);
 
     /* Unexpected RMA msg for RMA emulation */
-    if (bmi_unexpected_info.tag & NA_BMI_RMA_MSG_TAG) {
+    if (bmi_unexpected_info->tag & NA_BMI_RMA_MSG_TAG) {
         /* Make RMA progress */
         ret = na_bmi_process_rma_msg(
-            na_class, context, na_bmi_addr, &bmi_unexpected_info);
+            na_class, context, na_bmi_addr, bmi_unexpected_info);
         NA_CHECK_NA_ERROR(cleanup, ret, "Could not make RMA progress");
     } else {
         ret = na_bmi_process_msg_unexpected(
             &NA_BMI_CLASS(na_class)->unexpected_op_queue, na_bmi_addr,
-            &bmi_unexpected_info, &NA_BMI_CLASS(na_class)->unexpected_msg_queue,
+            bmi_unexpected_info, &NA_BMI_CLASS(na_class)->unexpected_msg_queue,
             &queued);
         NA_CHECK_NA_ERROR(cleanup, ret, "Could not process unexpected msg");
     }
 
-    *progressed = NA_TRUE;
-
 cleanup:
     if (!queued)
         BMI_unexpected_free(
-            bmi_unexpected_info.addr, bmi_unexpected_info.buffer);
+            bmi_unexpected_info->addr, bmi_unexpected_info->buffer);
 
-done:
     return ret;
 }
 
@@ -728,25 +787,43 @@ static na_return_t
 na_bmi_progress_expected(
     na_context_t *context, unsigned int timeout, na_bool_t *progressed)
 {
-    bmi_op_id_t bmi_op_id = 0;
-    int outcount = 0;
-    bmi_error_code_t error_code = 0;
-    bmi_size_t bmi_actual_size = 0;
-    struct na_bmi_op_id *na_bmi_op_id = NULL;
+    bmi_op_id_t bmi_op_ids[NA_BMI_MAX_EVENTS];
+    bmi_error_code_t error_codes[NA_BMI_MAX_EVENTS];
+    bmi_size_t bmi_actual_sizes[NA_BMI_MAX_EVENTS];
+    void *user_ptrs[NA_BMI_MAX_EVENTS];
+    int outcount = 0, i;
     na_return_t ret = NA_SUCCESS;
     int bmi_ret = 0;
 
-    /* Return as soon as something completes or timeout is reached */
-    bmi_ret = BMI_testcontext(1, &bmi_op_id, &outcount, &error_code,
-        &bmi_actual_size, (void **) &na_bmi_op_id, (int) timeout,
+    /* Return as soon as something completes or timeout is reached, harvesting
+     * as many completions as are available */
+    bmi_ret = BMI_testcontext(NA_BMI_MAX_EVENTS, bmi_op_ids, &outcount,
+        error_codes, bmi_actual_sizes, user_ptrs, (int) timeout,
         NA_BMI_CONTEXT(context)->context_id);
-    NA_CHECK_ERROR(bmi_ret < 0 && (error_code != 0), done, ret,
-        NA_PROTOCOL_ERROR, "BMI_testcontext() failed");
+    NA_CHECK_ERROR(bmi_ret < 0 && outcount == 0, done, ret, NA_PROTOCOL_ERROR,
+        "BMI_testcontext() failed");
+
+    *progressed = (outcount > 0) ? NA_TRUE : NA_FALSE;
 
-    if (!outcount) {
-        *progressed = NA_FALSE;
-        return ret;
+    for (i = 0; i < outcount; i++) {
+        na_return_t na_ret = na_bmi_process_expected(bmi_op_ids[i],
+            error_codes[i], bmi_actual_sizes[i],
+            (struct na_bmi_op_id *) user_ptrs[i]);
+        if (na_ret != NA_SUCCESS)
+            ret = na_ret;
     }
+    NA_CHECK_NA_ERROR(done, ret, "Could not process expected operation");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_bmi_process_expected(bmi_op_id_t bmi_op_id, bmi_error_code_t error_code,
+    bmi_size_t bmi_actual_size, struct na_bmi_op_id *na_bmi_op_id)
+{
+    na_return_t ret = NA_SUCCESS;
 
     if (error_code == -BMI_ECANCEL) {
         NA_CHECK_ERROR(
@@ -812,8 +889,6 @@ na_bmi_progress_expected(
                 done, ret, NA_PROTOCOL_ERROR, "Unknown type of operation ID");
     }
 
-    *progressed = NA_TRUE;
-
 done:
     return ret;
 }
@@ -840,7 +915,7 @@ na_bmi_process_msg_unexpected(struct na_bmi_op_queue *unexpected_op_queue,
     if (likely(na_bmi_op_id)) {
         /* Fill info */
         na_bmi_op_id->na_bmi_addr = na_bmi_addr;
-        hg_atomic_incr32(&na_bmi_addr->ref_count);
+        hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
         na_bmi_op_id->info.msg.actual_buf_size = bmi_unexpected_info->size;
         na_bmi_op_id->info.msg.tag = bmi_unexpected_info->tag;
 
@@ -862,7 +937,7 @@ na_bmi_process_msg_unexpected(struct na_bmi_op_queue *unexpected_op_queue,
             "Could not allocate unexpected info");
 
         na_bmi_unexpected_info->na_bmi_addr = na_bmi_addr;
-        hg_atomic_incr32(&na_bmi_addr->ref_count);
+        hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
 
         memcpy(&na_bmi_unexpected_info->info, bmi_unexpected_info,
             sizeof(struct BMI_unexpected_info));
@@ -914,7 +989,7 @@ na_bmi_process_rma_msg(na_class_t *na_class, na_context_t *context,
     na_bmi_op_id->completion_data.callback_info.type = 0;
     na_bmi_op_id->completion_data.callback = NULL;
     na_bmi_op_id->completion_data.callback_info.arg = NULL;
-    hg_atomic_incr32(&na_bmi_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
     na_bmi_op_id->na_bmi_addr = na_bmi_addr;
     hg_atomic_set32(&na_bmi_op_id->status, 0);
 
@@ -1065,7 +1140,7 @@ na_bmi_complete(struct na_bmi_op_id *na_bmi_op_id)
                 callback_info->info.recv_unexpected.tag = 0;
             } else {
                 /* Increment addr ref count */
-                hg_atomic_incr32(&na_bmi_op_id->na_bmi_addr->ref_count);
+                hg_atomic_incr32_relaxed(&na_bmi_op_id->na_bmi_addr->ref_count);
 
                 /* Fill callback info */
                 callback_info->info.recv_unexpected.actual_buf_size =
@@ -1076,9 +1151,12 @@ na_bmi_complete(struct na_bmi_op_id *na_bmi_op_id)
                     (na_tag_t) na_bmi_op_id->info.msg.tag;
             }
             break;
+        case NA_CB_RECV_EXPECTED:
+            callback_info->info.recv_expected.actual_buf_size =
+                (na_size_t) na_bmi_op_id->info.msg.actual_buf_size;
+            break;
         case NA_CB_SEND_UNEXPECTED:
         case NA_CB_SEND_EXPECTED:
-        case NA_CB_RECV_EXPECTED:
             break;
         case NA_CB_PUT:
         case NA_CB_GET:
@@ -1199,6 +1277,11 @@ na_bmi_initialize(
     /* Initialize mutex/cond */
     hg_thread_mutex_init(&NA_BMI_CLASS(na_class)->test_unexpected_mutex);
 
+    NA_BMI_CLASS(na_class)->op_slab =
+        na_op_slab_create(sizeof(struct na_bmi_op_id));
+    NA_CHECK_ERROR(NA_BMI_CLASS(na_class)->op_slab == NULL, error, ret,
+        NA_NOMEM, "Could not create op ID slab");
+
     /* Set msg size limits */
     NA_BMI_CLASS(na_class)->unexpected_size_max =
         (na_info->na_init_info && na_info->na_init_info->max_unexpected_size)
@@ -1302,6 +1385,7 @@ na_bmi_initialize(
 
     /* Initialize atomic op */
     hg_atomic_set32(&NA_BMI_CLASS(na_class)->rma_tag, NA_BMI_RMA_TAG);
+    hg_atomic_init64(&NA_BMI_CLASS(na_class)->mem_addr, 0);
 
     return ret;
 
@@ -1331,6 +1415,7 @@ error:
         }
 
         na_bmi_addr_destroy(NA_BMI_CLASS(na_class)->src_addr);
+        na_op_slab_destroy(NA_BMI_CLASS(na_class)->op_slab);
         free(na_class->plugin_class);
     }
 
@@ -1396,6 +1481,7 @@ na_bmi_finalize(na_class_t *na_class)
     hg_thread_spin_destroy(&NA_BMI_CLASS(na_class)->unexpected_msg_queue.lock);
     hg_thread_spin_destroy(&NA_BMI_CLASS(na_class)->unexpected_op_queue.lock);
 
+    na_op_slab_destroy(NA_BMI_CLASS(na_class)->op_slab);
     free(NA_BMI_CLASS(na_class)->listen_addr);
     free(NA_BMI_CLASS(na_class)->protocol_name);
     free(na_class->plugin_class);
@@ -1407,7 +1493,7 @@ done:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_bmi_context_create(
-    na_class_t NA_UNUSED *na_class, void **context, na_uint8_t NA_UNUSED id)
+    na_class_t NA_UNUSED *na_class, void **context, na_uint16_t NA_UNUSED id)
 {
     struct na_bmi_context *na_bmi_context = NULL;
     na_return_t ret = NA_SUCCESS;
@@ -1449,11 +1535,12 @@ na_bmi_context_destroy(na_class_t NA_UNUSED *na_class, void *context)
 
 /*---------------------------------------------------------------------------*/
 static na_op_id_t *
-na_bmi_op_create(na_class_t NA_UNUSED *na_class)
+na_bmi_op_create(na_class_t *na_class)
 {
     struct na_bmi_op_id *na_bmi_op_id = NULL;
 
-    na_bmi_op_id = (struct na_bmi_op_id *) malloc(sizeof(struct na_bmi_op_id));
+    na_bmi_op_id = (struct na_bmi_op_id *) na_op_slab_alloc(
+        NA_BMI_CLASS(na_class)->op_slab);
     NA_CHECK_ERROR_NORET(
         na_bmi_op_id == NULL, done, "Could not allocate NA BMI operation ID");
     memset(na_bmi_op_id, 0, sizeof(struct na_bmi_op_id));
@@ -1473,7 +1560,7 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_bmi_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+na_bmi_op_destroy(na_class_t *na_class, na_op_id_t *op_id)
 {
     struct na_bmi_op_id *na_bmi_op_id = (struct na_bmi_op_id *) op_id;
     na_return_t ret = NA_SUCCESS;
@@ -1482,7 +1569,7 @@ na_bmi_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
         !(hg_atomic_get32(&na_bmi_op_id->status) & NA_BMI_OP_COMPLETED), done,
         ret, NA_BUSY, "Attempting to free OP ID that was not completed");
 
-    free(na_bmi_op_id);
+    na_op_slab_free(NA_BMI_CLASS(na_class)->op_slab, na_bmi_op_id);
 
 done:
     return ret;
@@ -1520,6 +1607,11 @@ na_bmi_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr)
     } else
         NA_LOG_DEBUG("Address was found (key=%ld)", (long int) bmi_addr);
 
+    /* BMI_memalloc() needs an address to select the BMI method, all addresses
+     * share the same method so keep the first one (BMI never drops them) */
+    hg_atomic_cas64(
+        &NA_BMI_CLASS(na_class)->mem_addr, 0, (hg_util_int64_t) bmi_addr);
+
     *addr = (na_addr_t) na_bmi_addr;
 
 done:
@@ -1533,7 +1625,7 @@ na_bmi_addr_self(na_class_t *na_class, na_addr_t *addr)
     struct na_bmi_addr *na_bmi_addr = NA_BMI_CLASS(na_class)->src_addr;
 
     /* Increment refcount */
-    hg_atomic_incr32(&na_bmi_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
 
     *addr = (na_addr_t) na_bmi_addr;
 
@@ -1548,7 +1640,7 @@ na_bmi_addr_dup(
     struct na_bmi_addr *na_bmi_addr = (struct na_bmi_addr *) addr;
 
     /* Increment refcount */
-    hg_atomic_incr32(&na_bmi_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
 
     *new_addr = (na_addr_t) na_bmi_addr;
 
@@ -1690,12 +1782,76 @@ na_bmi_msg_get_max_tag(const na_class_t NA_UNUSED *na_class)
     return NA_BMI_TAG_MAX;
 }
 
+/*---------------------------------------------------------------------------*/
+static void *
+na_bmi_msg_buf_alloc(na_class_t *na_class, na_size_t size, void **plugin_data)
+{
+    BMI_addr_t bmi_addr =
+        (BMI_addr_t) hg_atomic_get64(&NA_BMI_CLASS(na_class)->mem_addr);
+    struct na_bmi_msg_buf *na_bmi_msg_buf = NULL;
+    void *mem_ptr = NULL;
+
+    /* Until an address is known, fall back to regular allocation and let BMI
+     * use its own buffers */
+    if (bmi_addr == 0) {
+        mem_ptr = malloc(size);
+        NA_CHECK_ERROR_NORET(
+            mem_ptr == NULL, error, "Could not allocate %d bytes", (int) size);
+        *plugin_data = NULL;
+
+        return mem_ptr;
+    }
+
+    na_bmi_msg_buf =
+        (struct na_bmi_msg_buf *) malloc(sizeof(struct na_bmi_msg_buf));
+    NA_CHECK_ERROR_NORET(
+        na_bmi_msg_buf == NULL, error, "Could not allocate msg buf info");
+    na_bmi_msg_buf->bmi_addr = bmi_addr;
+    na_bmi_msg_buf->size = (bmi_size_t) size;
+
+    mem_ptr = BMI_memalloc(bmi_addr, (bmi_size_t) size, BMI_SEND);
+    NA_CHECK_ERROR_NORET(mem_ptr == NULL, error, "BMI_memalloc() failed");
+    *plugin_data = na_bmi_msg_buf;
+
+    return mem_ptr;
+
+error:
+    free(na_bmi_msg_buf);
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_bmi_msg_buf_free(
+    na_class_t NA_UNUSED *na_class, void *buf, void *plugin_data)
+{
+    struct na_bmi_msg_buf *na_bmi_msg_buf =
+        (struct na_bmi_msg_buf *) plugin_data;
+    na_return_t ret = NA_SUCCESS;
+    int bmi_ret;
+
+    if (!na_bmi_msg_buf) {
+        free(buf);
+        goto done;
+    }
+
+    bmi_ret = BMI_memfree(
+        na_bmi_msg_buf->bmi_addr, buf, na_bmi_msg_buf->size, BMI_SEND);
+    free(na_bmi_msg_buf);
+    NA_CHECK_ERROR(
+        bmi_ret < 0, done, ret, NA_PROTOCOL_ERROR, "BMI_memfree() failed");
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_bmi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void NA_UNUSED *plugin_data, na_addr_t dest_addr,
-    na_uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+    void *plugin_data, na_addr_t dest_addr,
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_bmi_op_id *na_bmi_op_id = (struct na_bmi_op_id *) op_id;
     struct na_bmi_addr *na_bmi_addr = (struct na_bmi_addr *) dest_addr;
@@ -1716,7 +1872,7 @@ na_bmi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_bmi_op_id->completion_data.callback_info.type = NA_CB_SEND_UNEXPECTED;
     na_bmi_op_id->completion_data.callback = callback;
     na_bmi_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_bmi_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
     na_bmi_op_id->na_bmi_addr = na_bmi_addr;
     hg_atomic_set32(&na_bmi_op_id->status, 0);
 
@@ -1728,9 +1884,9 @@ na_bmi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
 
     /* Post the BMI unexpected send request */
     bmi_ret = BMI_post_sendunexpected(&na_bmi_op_id->info.msg.op_id,
-        na_bmi_addr->bmi_addr, buf, (bmi_size_t) buf_size, BMI_EXT_ALLOC,
-        (bmi_msg_tag_t) tag, na_bmi_op_id, NA_BMI_CONTEXT(context)->context_id,
-        NULL);
+        na_bmi_addr->bmi_addr, buf, (bmi_size_t) buf_size,
+        (plugin_data) ? BMI_PRE_ALLOC : BMI_EXT_ALLOC, (bmi_msg_tag_t) tag,
+        na_bmi_op_id, NA_BMI_CONTEXT(context)->context_id, NULL);
     NA_CHECK_ERROR(bmi_ret < 0, error, ret, NA_PROTOCOL_ERROR,
         "BMI_post_sendunexpected() failed");
 
@@ -1822,8 +1978,8 @@ done:
 static na_return_t
 na_bmi_msg_send_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void NA_UNUSED *plugin_data, na_addr_t dest_addr,
-    na_uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t NA_UNUSED dest_id,
+    na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_bmi_op_id *na_bmi_op_id = (struct na_bmi_op_id *) op_id;
     struct na_bmi_addr *na_bmi_addr = (struct na_bmi_addr *) dest_addr;
@@ -1844,7 +2000,7 @@ na_bmi_msg_send_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
     na_bmi_op_id->completion_data.callback_info.type = NA_CB_SEND_EXPECTED;
     na_bmi_op_id->completion_data.callback = callback;
     na_bmi_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_bmi_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
     na_bmi_op_id->na_bmi_addr = na_bmi_addr;
     hg_atomic_set32(&na_bmi_op_id->status, 0);
 
@@ -1857,7 +2013,8 @@ na_bmi_msg_send_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
     /* Post the BMI send request */
     bmi_ret =
         BMI_post_send(&na_bmi_op_id->info.msg.op_id, na_bmi_addr->bmi_addr, buf,
-            (bmi_size_t) buf_size, BMI_EXT_ALLOC, (bmi_msg_tag_t) tag,
+            (bmi_size_t) buf_size,
+            (plugin_data) ? BMI_PRE_ALLOC : BMI_EXT_ALLOC, (bmi_msg_tag_t) tag,
             na_bmi_op_id, NA_BMI_CONTEXT(context)->context_id, NULL);
     NA_CHECK_ERROR(
         bmi_ret < 0, error, ret, NA_PROTOCOL_ERROR, "BMI_post_send() failed");
@@ -1881,7 +2038,7 @@ static na_return_t
 na_bmi_msg_recv_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t source_addr,
-    na_uint8_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_bmi_op_id *na_bmi_op_id = (struct na_bmi_op_id *) op_id;
     struct na_bmi_addr *na_bmi_addr = (struct na_bmi_addr *) source_addr;
@@ -1899,7 +2056,7 @@ na_bmi_msg_recv_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
     na_bmi_op_id->completion_data.callback_info.type = NA_CB_RECV_EXPECTED;
     na_bmi_op_id->completion_data.callback = callback;
     na_bmi_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_bmi_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
     na_bmi_op_id->na_bmi_addr = na_bmi_addr;
     hg_atomic_set32(&na_bmi_op_id->status, 0);
 
@@ -2022,7 +2179,7 @@ static na_return_t
 na_bmi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t NA_UNUSED remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
     na_op_id_t *op_id)
 {
     struct na_bmi_op_id *na_bmi_op_id = (struct na_bmi_op_id *) op_id;
@@ -2071,7 +2228,7 @@ na_bmi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_bmi_op_id->completion_data.callback_info.type = NA_CB_PUT;
     na_bmi_op_id->completion_data.callback = callback;
     na_bmi_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_bmi_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
     na_bmi_op_id->na_bmi_addr = na_bmi_addr;
     hg_atomic_set32(&na_bmi_op_id->status, 0);
 
@@ -2154,7 +2311,7 @@ static na_return_t
 na_bmi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t NA_UNUSED remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
     na_op_id_t *op_id)
 {
     struct na_bmi_op_id *na_bmi_op_id = (struct na_bmi_op_id *) op_id;
@@ -2203,7 +2360,7 @@ na_bmi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_bmi_op_id->completion_data.callback_info.type = NA_CB_GET;
     na_bmi_op_id->completion_data.callback = callback;
     na_bmi_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_bmi_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_bmi_addr->ref_count);
     na_bmi_op_id->na_bmi_addr = na_bmi_addr;
     hg_atomic_set32(&na_bmi_op_id->status, 0);
 
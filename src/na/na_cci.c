@@ -36,8 +36,15 @@
 #define NA_PERMISSION_ERROR NA_PERMISSION
 #define NA_ADDRINUSE_ERROR  NA_ADDRINUSE
 
-/* Max tag */
-#define NA_CCI_MAX_TAG ((1 << 30) - 1)
+/* Max tag (last tag is reserved for batches) */
+#define NA_CCI_MAX_TAG   ((1 << 30) - 2)
+#define NA_CCI_BATCH_TAG ((1 << 30) - 1)
+
+/* Max number of msgs coalesced into a single send */
+#define NA_CCI_BATCH_MAX (32)
+
+/* Max number of events processed per progress call */
+#define NA_CCI_MAX_EVENTS (16)
 
 /************************************/
 /* Local Type and Struct Definition */
@@ -60,8 +67,13 @@ struct na_cci_addr {
     HG_QUEUE_HEAD(na_cci_op_id) rxs; /* Posted recvs */
     HG_QUEUE_HEAD(na_cci_info_recv_expected)
     early;                    /* Expected recvs not yet posted */
+    HG_QUEUE_HEAD(na_cci_op_id) tx;  /* Sends not posted yet */
+    HG_QUEUE_ENTRY(na_cci_addr) tx_entry;
     char *uri;                /* Peer's URI */
     hg_atomic_int32_t refcnt; /* Reference counter */
+    na_size_t tx_size;        /* Size of batch to post */
+    unsigned int tx_count;    /* Number of sends not posted yet */
+    na_bool_t tx_pending;     /* Address has sends not posted yet */
     na_bool_t unexpected;     /* Address generated from unexpected recv */
     na_bool_t self;           /* Boolean for self */
     HG_LIST_ENTRY(na_cci_addr) entry;
@@ -79,8 +91,11 @@ typedef enum na_cci_rma_op {
     NA_CCI_RMA_GET  /* Request a get operation */
 } na_cci_rma_op_t;
 
-struct na_cci_info_send_unexpected {
-    cci_op_id_t op_id; /* CCI operation ID */
+struct na_cci_info_send {
+    const void *buf;
+    cci_size_t buf_size;
+    struct na_cci_batch *batch; /* Batch the send was posted with */
+    cci_msg_tag_t tag;
 };
 
 struct na_cci_info_recv_unexpected {
@@ -92,10 +107,6 @@ struct na_cci_info_recv_unexpected {
     HG_QUEUE_ENTRY(na_cci_info_recv_unexpected) entry;
 };
 
-struct na_cci_info_send_expected {
-    cci_op_id_t op_id; /* CCI operation ID */
-};
-
 struct na_cci_info_recv_expected {
     na_cci_addr_t *na_cci_addr;
     HG_QUEUE_ENTRY(na_cci_info_recv_expected)
@@ -136,9 +147,8 @@ struct na_cci_op_id {
     hg_atomic_int32_t completed; /* Operation completed */
     hg_atomic_int32_t canceled;  /* Operation canceled  */
     union {
-        struct na_cci_info_send_unexpected send_unexpected;
+        struct na_cci_info_send send;
         struct na_cci_info_recv_unexpected recv_unexpected;
-        struct na_cci_info_send_expected send_expected;
         struct na_cci_info_recv_expected recv_expected;
         struct na_cci_info_put put;
         struct na_cci_info_get get;
@@ -158,6 +168,9 @@ struct na_cci_class {
     HG_LIST_HEAD(na_cci_addr)
     accept_conn_list;                         /* List of accepted connections */
     hg_thread_mutex_t accept_conn_list_mutex; /* Mutex */
+    HG_QUEUE_HEAD(na_cci_addr) tx_addr_queue; /* Addrs with sends to post */
+    hg_thread_mutex_t tx_mutex;               /* Mutex */
+    struct na_op_slab *op_slab;               /* Slab of operation IDs */
     char *uri;
     int fd;
 };
@@ -179,6 +192,25 @@ typedef union cci_msg {
     uint32_t net;
 } cci_msg_t;
 
+/* Sends posted to the same connection are coalesced into a single msg,
+ * tagged with NA_CCI_BATCH_TAG, which carries each msg header and size
+ * followed by its payload */
+struct na_cci_batch_hdr {
+    cci_msg_t msg;
+    uint32_t count;
+};
+
+struct na_cci_batch_entry {
+    cci_msg_t msg;
+    uint32_t len;
+};
+
+struct na_cci_batch {
+    struct na_cci_batch_hdr hdr;
+    struct na_cci_batch_entry entries[NA_CCI_BATCH_MAX];
+    na_cci_op_id_t *op_ids[NA_CCI_BATCH_MAX];
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -256,7 +288,7 @@ na_cci_msg_get_max_tag(const na_class_t *na_class);
 static na_return_t
 na_cci_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
 /* msg_recv_unexpected */
@@ -269,14 +301,14 @@ na_cci_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
 static na_return_t
 na_cci_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
 /* msg_recv_expected */
 static na_return_t
 na_cci_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t source_addr, na_uint8_t source_id,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
     na_tag_t tag, na_op_id_t *op_id);
 
 static na_return_t
@@ -293,6 +325,19 @@ na_cci_msg_unexpected_op_push(
 static struct na_cci_op_id *
 na_cci_msg_unexpected_op_pop(na_class_t *na_class);
 
+/* Queue send until the next progress call */
+static na_return_t
+na_cci_msg_post(na_class_t *na_class, na_cci_addr_t *na_cci_addr,
+    na_cci_op_id_t *na_cci_op_id);
+
+/* Post sends queued to addr (called with tx_mutex) */
+static void
+na_cci_msg_flush_addr(na_class_t *na_class, na_cci_addr_t *na_cci_addr);
+
+/* Post all queued sends */
+static void
+na_cci_msg_flush(na_class_t *na_class);
+
 /* mem_handle */
 static na_return_t
 na_cci_mem_handle_create(na_class_t *na_class, void *buf, na_size_t buf_size,
@@ -325,7 +370,7 @@ static na_return_t
 na_cci_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
 /* get */
@@ -333,13 +378,17 @@ static na_return_t
 na_cci_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
 /* poll_get_fd */
 static int
 na_cci_poll_get_fd(na_class_t *na_class, na_context_t *context);
 
+/* poll_try_wait */
+static na_bool_t
+na_cci_poll_try_wait(na_class_t *na_class, na_context_t *context);
+
 /* progress */
 static na_return_t
 na_cci_progress(
@@ -371,8 +420,10 @@ const struct na_class_ops NA_PLUGIN_OPS(cci) = {
     na_cci_op_create,                     /* op_create */
     na_cci_op_destroy,                    /* op_destroy */
     na_cci_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
     na_cci_addr_free,                     /* addr_free */
     NULL,                                 /* addr_set_remove */
+    NULL,                                 /* addr_warmup */
     na_cci_addr_self,                     /* addr_self */
     na_cci_addr_dup,                      /* addr_dup */
     NULL,                                 /* addr_cmp */
@@ -381,6 +432,7 @@ const struct na_class_ops NA_PLUGIN_OPS(cci) = {
     NULL,                                 /* addr_get_serialize_size */
     NULL,                                 /* addr_serialize */
     NULL,                                 /* addr_deserialize */
+    NULL,                                 /* addr_deserialize_batch */
     na_cci_msg_get_max_unexpected_size,   /* msg_get_max_unexpected_size */
     na_cci_msg_get_max_expected_size,     /* msg_get_max_expected_size */
     NULL,                                 /* msg_get_unexpected_header_size */
@@ -390,9 +442,11 @@ const struct na_class_ops NA_PLUGIN_OPS(cci) = {
     NULL,                                 /* msg_buf_free */
     NULL,                                 /* msg_init_unexpected */
     na_cci_msg_send_unexpected,           /* msg_send_unexpected */
+    NULL,                                 /* msg_send_unexpectedv */
     na_cci_msg_recv_unexpected,           /* msg_recv_unexpected */
     NULL,                                 /* msg_init_expected */
     na_cci_msg_send_expected,             /* msg_send_expected */
+    NULL,                                 /* msg_send_expectedv */
     na_cci_msg_recv_expected,             /* msg_recv_expected */
     na_cci_mem_handle_create,             /* mem_handle_create */
     NULL,                                 /* mem_handle_create_segment */
@@ -406,9 +460,15 @@ const struct na_class_ops NA_PLUGIN_OPS(cci) = {
     na_cci_put,                           /* put */
     na_cci_get,                           /* get */
     na_cci_poll_get_fd,                   /* poll_get_fd */
-    NULL,                                 /* poll_try_wait */
+    na_cci_poll_try_wait,                 /* poll_try_wait */
     na_cci_progress,                      /* progress */
-    na_cci_cancel                         /* cancel */
+    na_cci_cancel,                        /* cancel */
+    NULL,                                 /* get_resource_stats */
+    NULL,                                 /* mem_handle_create_sub */
+    NULL,                                 /* op_batch_begin */
+    NULL,                                 /* op_batch_end */
+    NULL,                                 /* mem_register_attr */
+    NULL                                  /* atomic */
 };
 
 /********************/
@@ -672,12 +732,21 @@ na_cci_init(na_class_t *na_class)
     HG_QUEUE_INIT(&NA_CCI_CLASS(na_class)->unexpected_msg_queue);
     HG_QUEUE_INIT(&NA_CCI_CLASS(na_class)->unexpected_op_queue);
     HG_LIST_INIT(&NA_CCI_CLASS(na_class)->accept_conn_list);
+    HG_QUEUE_INIT(&NA_CCI_CLASS(na_class)->tx_addr_queue);
 
     /* Initialize mutex/cond */
     hg_thread_mutex_init(&NA_CCI_CLASS(na_class)->test_unexpected_mutex);
     hg_thread_mutex_init(&NA_CCI_CLASS(na_class)->unexpected_msg_queue_mutex);
     hg_thread_mutex_init(&NA_CCI_CLASS(na_class)->unexpected_op_queue_mutex);
     hg_thread_mutex_init(&NA_CCI_CLASS(na_class)->accept_conn_list_mutex);
+    hg_thread_mutex_init(&NA_CCI_CLASS(na_class)->tx_mutex);
+
+    /* Create op ID slab */
+    NA_CCI_CLASS(na_class)->op_slab = na_op_slab_create(sizeof(na_cci_op_id_t));
+    if (!NA_CCI_CLASS(na_class)->op_slab) {
+        NA_LOG_ERROR("Could not create op ID slab");
+        ret = NA_NOMEM_ERROR;
+    }
 
     if (ret != NA_SUCCESS) {
         na_cci_finalize(na_class);
@@ -695,6 +764,9 @@ na_cci_finalize(na_class_t *na_class)
 
     free(priv->uri);
 
+    /* Post remaining sends */
+    na_cci_msg_flush(na_class);
+
     /* Free connections */
     while (!HG_LIST_IS_EMPTY(&priv->accept_conn_list)) {
         na_cci_addr_t *na_cci_addr = HG_LIST_FIRST(&priv->accept_conn_list);
@@ -733,7 +805,9 @@ na_cci_finalize(na_class_t *na_class)
     hg_thread_mutex_destroy(&priv->unexpected_msg_queue_mutex);
     hg_thread_mutex_destroy(&priv->unexpected_op_queue_mutex);
     hg_thread_mutex_destroy(&priv->accept_conn_list_mutex);
+    hg_thread_mutex_destroy(&priv->tx_mutex);
 
+    na_op_slab_destroy(priv->op_slab);
     free(na_class->plugin_class);
 
     return ret;
@@ -741,11 +815,12 @@ na_cci_finalize(na_class_t *na_class)
 
 /*---------------------------------------------------------------------------*/
 static na_op_id_t *
-na_cci_op_create(na_class_t NA_UNUSED *na_class)
+na_cci_op_create(na_class_t *na_class)
 {
     na_cci_op_id_t *na_cci_op_id = NULL;
 
-    na_cci_op_id = (na_cci_op_id_t *) malloc(sizeof(na_cci_op_id_t));
+    na_cci_op_id =
+        (na_cci_op_id_t *) na_op_slab_alloc(NA_CCI_CLASS(na_class)->op_slab);
     if (!na_cci_op_id) {
         NA_LOG_ERROR("Could not allocate NA CCI operation ID");
         goto done;
@@ -761,13 +836,12 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_cci_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+na_cci_op_destroy(na_class_t *na_class, na_op_id_t *op_id)
 {
-    na_cci_op_id_t *na_cci_op_id = (na_cci_op_id_t *) op_id;
     na_return_t ret = NA_SUCCESS;
 
     /* No more references, cleanup */
-    free(na_cci_op_id);
+    na_op_slab_free(NA_CCI_CLASS(na_class)->op_slab, op_id);
 
     return ret;
 }
@@ -792,6 +866,10 @@ na_cci_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr)
     na_cci_addr->cci_addr = NULL;
     HG_QUEUE_INIT(&na_cci_addr->rxs);
     HG_QUEUE_INIT(&na_cci_addr->early);
+    HG_QUEUE_INIT(&na_cci_addr->tx);
+    na_cci_addr->tx_size = 0;
+    na_cci_addr->tx_count = 0;
+    na_cci_addr->tx_pending = NA_FALSE;
     na_cci_addr->uri = strdup(name);
     /* one for the lookup callback and one for the caller to hold until
      * addr_free(). na_cci_complete will decref for the lookup callback.
@@ -838,6 +916,10 @@ na_cci_addr_self(na_class_t *na_class, na_addr_t *addr)
         goto out;
     }
     na_cci_addr->cci_addr = 0;
+    HG_QUEUE_INIT(&na_cci_addr->tx);
+    na_cci_addr->tx_size = 0;
+    na_cci_addr->tx_count = 0;
+    na_cci_addr->tx_pending = NA_FALSE;
     na_cci_addr->uri = strdup(NA_CCI_CLASS(na_class)->uri);
     na_cci_addr->unexpected = NA_FALSE;
     na_cci_addr->self = NA_TRUE;
@@ -981,14 +1063,11 @@ static na_return_t
 na_cci_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t dest_addr,
-    na_uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
 {
     na_cci_addr_t *na_cci_addr = (na_cci_addr_t *) dest_addr;
     na_cci_op_id_t *na_cci_op_id = (na_cci_op_id_t *) op_id;
     na_return_t ret = NA_SUCCESS;
-    int rc;
-    cci_msg_t msg;
-    struct iovec iov[2];
 
     addr_addref(na_cci_addr); /* for na_cci_complete() */
 
@@ -1010,25 +1089,13 @@ na_cci_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cci_op_id->arg = arg;
     hg_atomic_set32(&na_cci_op_id->completed, 0);
     hg_atomic_set32(&na_cci_op_id->canceled, 0);
-    na_cci_op_id->info.send_unexpected.op_id = 0;
-
-    msg.send.expect = 0;
-    msg.send.bye = 0;
-    msg.send.tag = tag;
-
-    iov[0].iov_base = &msg;
-    iov[0].iov_len = sizeof(msg.size);
-    iov[1].iov_base = (void *) buf;
-    iov[1].iov_len = buf_size;
+    na_cci_op_id->info.send.buf = buf;
+    na_cci_op_id->info.send.buf_size = (cci_size_t) buf_size;
+    na_cci_op_id->info.send.batch = NULL;
+    na_cci_op_id->info.send.tag = (cci_msg_tag_t) tag;
 
     /* Post the CCI unexpected send request */
-    rc = cci_sendv(na_cci_addr->cci_addr, iov, 2, na_cci_op_id, 0);
-    if (rc) {
-        cci_endpoint_t *endpoint = NA_CCI_CLASS(na_class)->endpoint;
-        NA_LOG_ERROR("cci_sendv() failed with %s", cci_strerror(endpoint, rc));
-        ret = NA_PROTOCOL_ERROR;
-        goto out;
-    }
+    ret = na_cci_msg_post(na_class, na_cci_addr, na_cci_op_id);
 
 out:
     if (ret != NA_SUCCESS) {
@@ -1178,19 +1245,160 @@ na_cci_msg_unexpected_op_pop(na_class_t *na_class)
     return na_cci_op_id;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_cci_msg_post(na_class_t *na_class, na_cci_addr_t *na_cci_addr,
+    na_cci_op_id_t *na_cci_op_id)
+{
+    na_cci_class_t *priv = NA_CCI_CLASS(na_class);
+    na_size_t size =
+        sizeof(struct na_cci_batch_entry) + na_cci_op_id->info.send.buf_size;
+
+    if (!na_cci_addr->cci_addr) {
+        NA_LOG_ERROR("not connected to peer %s", na_cci_addr->uri);
+        return NA_PROTOCOL_ERROR;
+    }
+
+    hg_thread_mutex_lock(&priv->tx_mutex);
+
+    /* Post what is queued if the send no longer fits into the batch */
+    if (na_cci_addr->tx_count == NA_CCI_BATCH_MAX ||
+        (na_cci_addr->tx_count > 0 &&
+            na_cci_addr->tx_size + size >
+                na_cci_addr->cci_addr->max_send_size))
+        na_cci_msg_flush_addr(na_class, na_cci_addr);
+
+    HG_QUEUE_PUSH_TAIL(&na_cci_addr->tx, na_cci_op_id, entry);
+    if (na_cci_addr->tx_count == 0)
+        na_cci_addr->tx_size = sizeof(struct na_cci_batch_hdr);
+    na_cci_addr->tx_size += size;
+    na_cci_addr->tx_count++;
+    if (!na_cci_addr->tx_pending) {
+        na_cci_addr->tx_pending = NA_TRUE;
+        HG_QUEUE_PUSH_TAIL(&priv->tx_addr_queue, na_cci_addr, tx_entry);
+    }
+
+    hg_thread_mutex_unlock(&priv->tx_mutex);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_cci_msg_flush_addr(na_class_t *na_class, na_cci_addr_t *na_cci_addr)
+{
+    cci_endpoint_t *e = NA_CCI_CLASS(na_class)->endpoint;
+    struct iovec iov[1 + 2 * NA_CCI_BATCH_MAX];
+    struct na_cci_batch *batch = NULL;
+    na_cci_op_id_t *na_cci_op_id;
+    unsigned int count = na_cci_addr->tx_count, i;
+    cci_msg_t msg;
+    int rc;
+
+    if (count == 0)
+        return;
+    na_cci_addr->tx_count = 0;
+    na_cci_addr->tx_size = 0;
+
+    /* Single msgs are sent as is */
+    if (count == 1) {
+        na_cci_op_id = HG_QUEUE_FIRST(&na_cci_addr->tx);
+        HG_QUEUE_POP_HEAD(&na_cci_addr->tx, entry);
+
+        msg.send.expect = (na_cci_op_id->type == NA_CB_SEND_EXPECTED);
+        msg.send.bye = 0;
+        msg.send.tag = na_cci_op_id->info.send.tag;
+
+        iov[0].iov_base = &msg;
+        iov[0].iov_len = sizeof(msg.size);
+        iov[1].iov_base = (void *) na_cci_op_id->info.send.buf;
+        iov[1].iov_len = na_cci_op_id->info.send.buf_size;
+
+        rc = cci_sendv(na_cci_addr->cci_addr, iov, 2, na_cci_op_id, 0);
+        if (rc) {
+            NA_LOG_ERROR("cci_sendv() failed with %s", cci_strerror(e, rc));
+            na_cci_complete(na_cci_addr, na_cci_op_id, NA_PROTOCOL_ERROR);
+        }
+        return;
+    }
+
+    batch = (struct na_cci_batch *) malloc(sizeof(*batch));
+    if (!batch) {
+        NA_LOG_ERROR("Could not allocate batch");
+        goto error;
+    }
+    batch->hdr.msg.send.expect = 0;
+    batch->hdr.msg.send.bye = 0;
+    batch->hdr.msg.send.tag = NA_CCI_BATCH_TAG;
+    batch->hdr.count = count;
+    iov[0].iov_base = &batch->hdr;
+    iov[0].iov_len = sizeof(batch->hdr);
+
+    for (i = 0; i < count; i++) {
+        struct na_cci_batch_entry *entry = &batch->entries[i];
+
+        na_cci_op_id = HG_QUEUE_FIRST(&na_cci_addr->tx);
+        HG_QUEUE_POP_HEAD(&na_cci_addr->tx, entry);
+        na_cci_op_id->info.send.batch = batch;
+        batch->op_ids[i] = na_cci_op_id;
+
+        entry->msg.send.expect = (na_cci_op_id->type == NA_CB_SEND_EXPECTED);
+        entry->msg.send.bye = 0;
+        entry->msg.send.tag = na_cci_op_id->info.send.tag;
+        entry->len = (uint32_t) na_cci_op_id->info.send.buf_size;
+        iov[1 + 2 * i].iov_base = entry;
+        iov[1 + 2 * i].iov_len = sizeof(*entry);
+        iov[2 + 2 * i].iov_base = (void *) na_cci_op_id->info.send.buf;
+        iov[2 + 2 * i].iov_len = na_cci_op_id->info.send.buf_size;
+    }
+
+    /* Batch completes through its first op ID */
+    rc = cci_sendv(na_cci_addr->cci_addr, iov, 1 + 2 * count,
+        batch->op_ids[0], 0);
+    if (rc) {
+        NA_LOG_ERROR("cci_sendv() failed with %s", cci_strerror(e, rc));
+        for (i = 0; i < count; i++)
+            na_cci_complete(na_cci_addr, batch->op_ids[i], NA_PROTOCOL_ERROR);
+        free(batch);
+    }
+    return;
+
+error:
+    while ((na_cci_op_id = HG_QUEUE_FIRST(&na_cci_addr->tx)) != NULL) {
+        HG_QUEUE_POP_HEAD(&na_cci_addr->tx, entry);
+        na_cci_complete(na_cci_addr, na_cci_op_id, NA_NOMEM_ERROR);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_cci_msg_flush(na_class_t *na_class)
+{
+    na_cci_class_t *priv = NA_CCI_CLASS(na_class);
+    na_cci_addr_t *na_cci_addr;
+
+    if (HG_QUEUE_IS_EMPTY(&priv->tx_addr_queue))
+        return;
+
+    hg_thread_mutex_lock(&priv->tx_mutex);
+    while ((na_cci_addr = HG_QUEUE_FIRST(&priv->tx_addr_queue)) != NULL) {
+        HG_QUEUE_POP_HEAD(&priv->tx_addr_queue, tx_entry);
+        na_cci_addr->tx_pending = NA_FALSE;
+        na_cci_msg_flush_addr(na_class, na_cci_addr);
+    }
+    hg_thread_mutex_unlock(&priv->tx_mutex);
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_cci_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t dest_addr,
-    na_uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
 {
     na_cci_addr_t *na_cci_addr = (na_cci_addr_t *) dest_addr;
     na_cci_op_id_t *na_cci_op_id = (na_cci_op_id_t *) op_id;
     na_return_t ret = NA_SUCCESS;
-    int rc;
-    cci_msg_t msg;
-    struct iovec iov[2];
 
     addr_addref(na_cci_addr); /* for na_cci_complete() */
 
@@ -1206,25 +1414,13 @@ na_cci_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cci_op_id->arg = arg;
     hg_atomic_set32(&na_cci_op_id->completed, 0);
     hg_atomic_set32(&na_cci_op_id->canceled, 0);
-    na_cci_op_id->info.send_expected.op_id = 0;
-
-    msg.send.expect = 1;
-    msg.send.bye = 0;
-    msg.send.tag = tag;
-
-    iov[0].iov_base = &msg;
-    iov[0].iov_len = sizeof(msg.size);
-    iov[1].iov_base = (void *) buf;
-    iov[1].iov_len = buf_size;
+    na_cci_op_id->info.send.buf = buf;
+    na_cci_op_id->info.send.buf_size = (cci_size_t) buf_size;
+    na_cci_op_id->info.send.batch = NULL;
+    na_cci_op_id->info.send.tag = (cci_msg_tag_t) tag;
 
     /* Post the CCI send request */
-    rc = cci_sendv(na_cci_addr->cci_addr, iov, 2, na_cci_op_id, 0);
-    if (rc) {
-        cci_endpoint_t *endpoint = NA_CCI_CLASS(na_class)->endpoint;
-        NA_LOG_ERROR("cci_sendv() failed with %s", cci_strerror(endpoint, rc));
-        ret = NA_PROTOCOL_ERROR;
-        goto out;
-    }
+    ret = na_cci_msg_post(na_class, na_cci_addr, na_cci_op_id);
 
 out:
     if (ret != NA_SUCCESS) {
@@ -1239,7 +1435,7 @@ static na_return_t
 na_cci_msg_recv_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t source_addr,
-    na_uint8_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
 {
     cci_size_t cci_buf_size = (cci_size_t) buf_size;
     na_cci_addr_t *na_cci_addr = (na_cci_addr_t *) source_addr;
@@ -1489,7 +1685,7 @@ static na_return_t
 na_cci_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t NA_UNUSED remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
     na_op_id_t *op_id)
 {
     na_cci_mem_handle_t *cci_local_mem_handle =
@@ -1556,7 +1752,7 @@ static na_return_t
 na_cci_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t NA_UNUSED remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
     na_op_id_t *op_id)
 {
     na_cci_mem_handle_t *cci_local_mem_handle =
@@ -1622,6 +1818,16 @@ na_cci_poll_get_fd(na_class_t *na_class, na_context_t NA_UNUSED *context)
     return NA_CCI_CLASS(na_class)->fd;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_cci_poll_try_wait(na_class_t *na_class, na_context_t NA_UNUSED *context)
+{
+    /* Sends are only posted from progress, post them before blocking */
+    na_cci_msg_flush(na_class);
+
+    return NA_TRUE;
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 handle_send(na_class_t NA_UNUSED *class, na_context_t NA_UNUSED *context,
@@ -1639,6 +1845,22 @@ handle_send(na_class_t NA_UNUSED *class, na_context_t NA_UNUSED *context,
         ret = NA_CANCELED;
     }
 
+    /* Complete all the sends that were coalesced */
+    if ((na_cci_op_id->type == NA_CB_SEND_UNEXPECTED ||
+            na_cci_op_id->type == NA_CB_SEND_EXPECTED) &&
+        na_cci_op_id->info.send.batch) {
+        struct na_cci_batch *batch = na_cci_op_id->info.send.batch;
+        na_return_t batch_ret = ret;
+        uint32_t i;
+
+        for (i = 0; i < batch->hdr.count; i++)
+            if (na_cci_complete(na_cci_addr, batch->op_ids[i], batch_ret) !=
+                NA_SUCCESS)
+                NA_LOG_ERROR("Unable to complete send");
+        free(batch);
+        goto out;
+    }
+
     ret = na_cci_complete(na_cci_addr, na_cci_op_id, ret);
     if (ret != NA_SUCCESS)
         NA_LOG_ERROR("Unable to complete send");
@@ -1650,25 +1872,21 @@ out:
 /*---------------------------------------------------------------------------*/
 static void
 handle_recv_expected(na_class_t NA_UNUSED *na_class,
-    na_context_t NA_UNUSED *context, cci_endpoint_t NA_UNUSED *e,
-    cci_event_t *event)
+    na_cci_addr_t *na_cci_addr, cci_msg_tag_t tag, const void *data,
+    na_size_t msg_len)
 {
-    cci_connection_t *c = event->recv.connection;
-    na_cci_addr_t *na_cci_addr = c->context;
-    cci_msg_t *msg = (void *) event->recv.ptr;
-    na_size_t msg_len = event->recv.len - sizeof(msg->size);
     na_cci_op_id_t *na_cci_op_id = NULL;
     struct na_cci_info_recv_expected *rx = NULL;
     int rc = 0;
     na_return_t ret;
 
     HG_QUEUE_FOREACH (na_cci_op_id, &na_cci_addr->rxs, entry) {
-        if (na_cci_op_id->info.recv_expected.tag == msg->send.tag) {
+        if (na_cci_op_id->info.recv_expected.tag == tag) {
             na_size_t len = msg_len;
 
             if (na_cci_op_id->info.recv_expected.buf_size < len)
                 len = na_cci_op_id->info.recv_expected.buf_size;
-            memcpy(na_cci_op_id->info.recv_expected.buf, msg->send.data, len);
+            memcpy(na_cci_op_id->info.recv_expected.buf, data, len);
             na_cci_op_id->info.recv_expected.actual_size = len;
             HG_QUEUE_REMOVE(
                 &na_cci_addr->rxs, na_cci_op_id, na_cci_op_id, entry);
@@ -1693,9 +1911,9 @@ handle_recv_expected(na_class_t NA_UNUSED *na_class,
         goto out;
     }
 
-    memcpy(rx->buf, msg->send.data, msg_len);
+    memcpy(rx->buf, data, msg_len);
     rx->buf_size = rx->actual_size = msg_len;
-    rx->tag = msg->send.tag;
+    rx->tag = tag;
 
     HG_QUEUE_PUSH_TAIL(&na_cci_addr->early, rx, entry);
 
@@ -1710,13 +1928,9 @@ out:
 
 /*---------------------------------------------------------------------------*/
 static void
-handle_recv_unexpected(na_class_t *na_class, na_context_t NA_UNUSED *context,
-    cci_endpoint_t NA_UNUSED *e, cci_event_t *event)
+handle_recv_unexpected(na_class_t *na_class, na_cci_addr_t *na_cci_addr,
+    cci_msg_tag_t tag, const void *data, na_size_t msg_len)
 {
-    cci_connection_t *c = event->recv.connection;
-    na_cci_addr_t *na_cci_addr = c->context;
-    cci_msg_t *msg = (void *) event->recv.ptr;
-    na_size_t msg_len = event->recv.len - sizeof(msg->size);
     na_cci_op_id_t *na_cci_op_id = NULL;
     struct na_cci_info_recv_unexpected *rx = NULL;
     int rc = 0;
@@ -1733,14 +1947,13 @@ handle_recv_unexpected(na_class_t *na_class, na_context_t NA_UNUSED *context,
     na_cci_op_id = na_cci_msg_unexpected_op_pop(na_class);
 
     if (na_cci_op_id) {
-        na_size_t len = na_cci_op_id->info.recv_unexpected.buf_size <
-                                event->recv.len - msg_len
+        na_size_t len = na_cci_op_id->info.recv_unexpected.buf_size < msg_len
                             ? na_cci_op_id->info.recv_unexpected.buf_size
                             : msg_len;
         na_cci_op_id->info.recv_unexpected.na_cci_addr = na_cci_addr;
         na_cci_op_id->info.recv_unexpected.actual_size = len;
-        na_cci_op_id->info.recv_unexpected.tag = msg->send.tag;
-        memcpy(na_cci_op_id->info.recv_unexpected.buf, msg->send.data, len);
+        na_cci_op_id->info.recv_unexpected.tag = tag;
+        memcpy(na_cci_op_id->info.recv_unexpected.buf, data, len);
 
         addr_addref(na_cci_addr); /* for na_cci_addr_free() */
 
@@ -1764,10 +1977,10 @@ handle_recv_unexpected(na_class_t *na_class, na_context_t NA_UNUSED *context,
             rc = CCI_ENOMEM;
             goto out;
         }
-        memcpy(rx->buf, msg->send.data, msg_len);
+        memcpy(rx->buf, data, msg_len);
         rx->buf_size = rx->actual_size = msg_len;
         rx->na_cci_addr = na_cci_addr;
-        rx->tag = msg->send.tag;
+        rx->tag = tag;
 
         ret = na_cci_msg_unexpected_push(na_class, rx);
         if (ret != NA_SUCCESS) {
@@ -1788,18 +2001,61 @@ out:
 
 /*---------------------------------------------------------------------------*/
 static void
-handle_recv(na_class_t *na_class, na_context_t *context, cci_endpoint_t *e,
-    cci_event_t *event)
+handle_recv(na_class_t *na_class, na_context_t NA_UNUSED *context,
+    cci_endpoint_t NA_UNUSED *e, cci_event_t *event)
 {
-    cci_msg_t *msg = (void *) event->recv.ptr;
+    na_cci_addr_t *na_cci_addr = event->recv.connection->context;
+    const char *ptr = (const char *) event->recv.ptr;
+    na_size_t len = event->recv.len;
+    struct na_cci_batch_hdr hdr;
+    cci_msg_t msg;
+    uint32_t i;
 
-    if (msg->send.expect) {
-        handle_recv_expected(na_class, context, e, event);
-    } else {
-        handle_recv_unexpected(na_class, context, e, event);
+    memcpy(&msg, ptr, sizeof(msg.size));
+
+    if (msg.send.expect || msg.send.tag != NA_CCI_BATCH_TAG) {
+        if (msg.send.expect)
+            handle_recv_expected(na_class, na_cci_addr, msg.send.tag,
+                ptr + sizeof(msg.size), len - sizeof(msg.size));
+        else
+            handle_recv_unexpected(na_class, na_cci_addr, msg.send.tag,
+                ptr + sizeof(msg.size), len - sizeof(msg.size));
+        return;
     }
 
-    return;
+    /* Unpack msgs that were coalesced */
+    if (len < sizeof(hdr)) {
+        NA_LOG_ERROR("Truncated batch - dropping msg");
+        return;
+    }
+    memcpy(&hdr, ptr, sizeof(hdr));
+    ptr += sizeof(hdr);
+    len -= sizeof(hdr);
+
+    for (i = 0; i < hdr.count; i++) {
+        struct na_cci_batch_entry entry;
+
+        if (len < sizeof(entry)) {
+            NA_LOG_ERROR("Truncated batch - dropping remaining msgs");
+            return;
+        }
+        memcpy(&entry, ptr, sizeof(entry));
+        ptr += sizeof(entry);
+        len -= sizeof(entry);
+        if (len < entry.len) {
+            NA_LOG_ERROR("Truncated batch - dropping remaining msgs");
+            return;
+        }
+
+        if (entry.msg.send.expect)
+            handle_recv_expected(
+                na_class, na_cci_addr, entry.msg.send.tag, ptr, entry.len);
+        else
+            handle_recv_unexpected(
+                na_class, na_cci_addr, entry.msg.send.tag, ptr, entry.len);
+        ptr += entry.len;
+        len -= entry.len;
+    }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1820,6 +2076,7 @@ handle_connect_request(na_class_t NA_UNUSED *class,
 
     HG_QUEUE_INIT(&na_cci_addr->rxs);
     HG_QUEUE_INIT(&na_cci_addr->early);
+    HG_QUEUE_INIT(&na_cci_addr->tx);
 
     na_cci_addr->uri = strdup(event->request.data_ptr);
     if (!na_cci_addr->uri) {
@@ -1896,10 +2153,14 @@ na_cci_progress(
         int rc;
         hg_time_t t1, t2;
         cci_event_t *event = NULL;
+        unsigned int count = 0;
 
         if (timeout)
             hg_time_get_current_ms(&t1);
 
+        /* Post sends queued since the last call */
+        na_cci_msg_flush(na_class);
+
         rc = cci_get_event(e, &event);
         if (rc) {
             if (rc != CCI_EAGAIN)
@@ -1915,35 +2176,39 @@ na_cci_progress(
             continue;
         }
 
-        /* We got an event, handle it */
-        switch (event->type) {
-            case CCI_EVENT_SEND:
-                handle_send(na_class, context, e, event);
-                break;
-            case CCI_EVENT_RECV:
-                handle_recv(na_class, context, e, event);
-                break;
-            case CCI_EVENT_CONNECT_REQUEST:
-                handle_connect_request(na_class, context, e, event);
-                break;
-            case CCI_EVENT_CONNECT:
-                handle_connect(na_class, context, e, event);
-                break;
-            case CCI_EVENT_ACCEPT:
-                handle_accept(na_class, context, e, event);
-                break;
-            default:
+        /* We got events, handle as many as are available */
+        do {
+            switch (event->type) {
+                case CCI_EVENT_SEND:
+                    handle_send(na_class, context, e, event);
+                    break;
+                case CCI_EVENT_RECV:
+                    handle_recv(na_class, context, e, event);
+                    break;
+                case CCI_EVENT_CONNECT_REQUEST:
+                    handle_connect_request(na_class, context, e, event);
+                    break;
+                case CCI_EVENT_CONNECT:
+                    handle_connect(na_class, context, e, event);
+                    break;
+                case CCI_EVENT_ACCEPT:
+                    handle_accept(na_class, context, e, event);
+                    break;
+                default:
+                    NA_LOG_ERROR(
+                        "unhandled %s event", cci_event_type_str(event->type));
+            }
+
+            rc = cci_return_event(event);
+            if (rc)
                 NA_LOG_ERROR(
-                    "unhandled %s event", cci_event_type_str(event->type));
-        }
+                    "cci_return_event() failed %s", cci_strerror(e, rc));
+        } while (++count < NA_CCI_MAX_EVENTS &&
+                 cci_get_event(e, &event) == CCI_SUCCESS);
 
         /* We progressed, return success */
         ret = NA_SUCCESS;
 
-        rc = cci_return_event(event);
-        if (rc)
-            NA_LOG_ERROR("cci_return_event() failed %s", cci_strerror(e, rc));
-
     } while (remaining > 0 && ret != NA_SUCCESS);
 
     return ret;
@@ -1983,6 +2248,8 @@ na_cci_complete(
                 ret = NA_SIZE_ERROR;
                 goto out;
             }
+            callback_info->info.recv_expected.actual_buf_size =
+                (na_size_t) na_cci_op_id->info.recv_expected.actual_size;
             break;
         case NA_CB_SEND_UNEXPECTED:
         case NA_CB_SEND_EXPECTED:
@@ -49,6 +49,13 @@ static int MPI_MAX_TAG = 32767;
 #define NA_MPI_RMA_TAG         (NA_MPI_RMA_REQUEST_TAG + 1)
 #define NA_MPI_MAX_RMA_TAG     (MPI_MAX_TAG >> 1)
 
+/* Max number of regions attached to dynamic window (implementations
+ * typically limit that number and may not recover from failed attaches) */
+#define NA_MPI_RMA_WIN_ATTACH_MAX (32)
+
+/* Initial number of entries in request set */
+#define NA_MPI_REQUEST_NUM (64)
+
 #define NA_MPI_CLASS(na_class)                                                 \
     ((struct na_mpi_class *) (na_class->plugin_class))
 
@@ -78,9 +85,23 @@ struct na_mpi_addr {
 struct na_mpi_mem_handle {
     na_ptr_t base;   /* Initial address of memory */
     MPI_Aint size;   /* Size of memory */
+#ifdef NA_MPI_HAS_RMA_WIN
+    MPI_Aint disp;      /* Displacement of memory in dynamic window */
+    na_bool_t attached; /* Memory attached to dynamic window */
+    na_bool_t remote;   /* Handle deserialized from remote */
+#endif
     na_uint8_t attr; /* Flag of operation access */
 };
 
+#ifdef NA_MPI_HAS_RMA_WIN
+/* na_mpi_rma_region */
+struct na_mpi_rma_region {
+    na_ptr_t base;         /* Initial address of attached memory */
+    MPI_Aint size;         /* Size of attached memory */
+    unsigned int refcount; /* Number of handles within region */
+};
+#endif
+
 /* na_mpi_rma_op */
 typedef enum na_mpi_rma_op {
     NA_MPI_RMA_PUT, /* Request a put operation */
@@ -128,6 +149,9 @@ struct na_mpi_info_put {
     MPI_Request data_request;
     struct na_mpi_rma_info *rma_info;
     na_bool_t internal_progress; /* Used for internal RMA emulation */
+#ifdef NA_MPI_HAS_RMA_WIN
+    int win_rank; /* Target rank to flush (MPI_UNDEFINED if not one-sided) */
+#endif
 };
 
 /* na_mpi_info_get */
@@ -145,6 +169,7 @@ struct na_mpi_op_id {
     void *arg;
     hg_atomic_int32_t completed; /* Operation completed */
     na_bool_t canceled;          /* Operation canceled */
+    int pending;                 /* Number of requests left in request set */
     union {
         struct na_mpi_info_send_unexpected send_unexpected;
         struct na_mpi_info_recv_unexpected recv_unexpected;
@@ -157,6 +182,18 @@ struct na_mpi_op_id {
     struct na_cb_completion_data completion_data;
 };
 
+/* na_mpi_request_set */
+struct na_mpi_request_set {
+    MPI_Request *requests;           /* Contiguous array of active requests */
+    struct na_mpi_op_id **op_ids;    /* Op ID that owns each request */
+    struct na_mpi_op_id **completed; /* Op IDs of completed requests */
+    MPI_Status *statuses;            /* Statuses of completed requests */
+    int *indices;                    /* Indices of completed requests */
+    int count;                       /* Number of active requests */
+    int max;                         /* Number of allocated entries */
+    hg_thread_mutex_t mutex;         /* Mutex */
+};
+
 struct na_mpi_class {
     na_bool_t listening;               /* Used in server mode */
     na_bool_t mpi_ext_initialized;     /* MPI externally initialized */
@@ -181,8 +218,17 @@ struct na_mpi_class {
 
     hg_atomic_int32_t rma_tag; /* Atomic RMA tag value */
 
-    HG_LIST_HEAD(na_mpi_op_id) op_id_list; /* List of na_mpi_op_ids */
-    hg_thread_mutex_t op_id_list_mutex;    /* Mutex */
+    struct na_op_slab *op_slab; /* Slab of operation IDs */
+
+#ifdef NA_MPI_HAS_RMA_WIN
+    MPI_Win rma_win; /* Dynamic window over MPI_COMM_WORLD */
+    struct na_mpi_rma_region
+        rma_win_regions[NA_MPI_RMA_WIN_ATTACH_MAX]; /* Attached regions */
+    unsigned int rma_win_count;      /* Number of attached regions */
+    hg_thread_mutex_t rma_win_mutex; /* Mutex */
+#endif
+
+    struct na_mpi_request_set request_set; /* Requests of active op IDs */
 };
 
 /********************/
@@ -218,14 +264,25 @@ static na_return_t
 na_mpi_msg_unexpected_op_push(
     na_class_t *na_class, struct na_mpi_op_id *na_mpi_op_id);
 
-/* msg_unexpected_op_pop */
-static struct na_mpi_op_id *
-na_mpi_msg_unexpected_op_pop(na_class_t *na_class);
+/* request_set_grow */
+static na_return_t
+na_mpi_request_set_grow(struct na_mpi_request_set *request_set, int count);
+
+/* request_set_add */
+static na_return_t
+na_mpi_request_set_add(na_class_t *na_class, struct na_mpi_op_id *na_mpi_op_id,
+    const MPI_Request *requests, int count);
 
 /* gen_rma_tag */
 static NA_INLINE na_tag_t
 na_mpi_gen_rma_tag(na_class_t *na_class);
 
+#ifdef NA_MPI_HAS_RMA_WIN
+/* win_rank */
+static int
+na_mpi_win_rank(struct na_mpi_addr *na_mpi_addr);
+#endif
+
 /* verify */
 static na_bool_t
 na_mpi_check_protocol(const char *protocol_name);
@@ -286,7 +343,7 @@ na_mpi_msg_get_max_tag(const na_class_t *na_class);
 static na_return_t
 na_mpi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
 /* msg_recv_unexpected */
@@ -299,14 +356,14 @@ na_mpi_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
 static na_return_t
 na_mpi_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
 /* msg_recv_expected */
 static na_return_t
 na_mpi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t source_addr, na_uint8_t source_id,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
     na_tag_t tag, na_op_id_t *op_id);
 
 /* mem_handle */
@@ -341,7 +398,7 @@ static na_return_t
 na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
 /* get */
@@ -349,7 +406,7 @@ static na_return_t
 na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
 /* progress */
@@ -365,18 +422,24 @@ na_mpi_progress_unexpected(
 /* na_mpi_progress_unexpected_msg */
 static na_return_t
 na_mpi_progress_unexpected_msg(na_class_t *na_class, na_context_t *context,
-    struct na_mpi_addr *na_mpi_addr, const MPI_Status *status);
+    struct na_mpi_addr *na_mpi_addr);
 
 /* na_mpi_progress_unexpected_rma */
 static na_return_t
 na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
-    struct na_mpi_addr *na_mpi_addr, const MPI_Status *status);
+    struct na_mpi_addr *na_mpi_addr, MPI_Message *message,
+    const MPI_Status *status);
 
 /* na_mpi_progress_expected */
 static na_return_t
 na_mpi_progress_expected(
     na_class_t *na_class, na_context_t *context, unsigned int timeout);
 
+/* na_mpi_progress_op_id */
+static na_return_t
+na_mpi_progress_op_id(na_class_t *na_class, struct na_mpi_op_id *na_mpi_op_id,
+    const MPI_Status *status);
+
 /* na_mpi_complete */
 static na_return_t
 na_mpi_complete(struct na_mpi_op_id *na_mpi_op_id);
@@ -404,8 +467,10 @@ const struct na_class_ops NA_PLUGIN_OPS(mpi) = {
     na_mpi_op_create,                     /* op_create */
     na_mpi_op_destroy,                    /* op_destroy */
     na_mpi_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
     na_mpi_addr_free,                     /* addr_free */
     NULL,                                 /* addr_set_remove */
+    NULL,                                 /* addr_warmup */
     na_mpi_addr_self,                     /* addr_self */
     NULL,                                 /* addr_dup */
     na_mpi_addr_cmp,                      /* addr_cmp */
@@ -414,6 +479,7 @@ const struct na_class_ops NA_PLUGIN_OPS(mpi) = {
     NULL,                                 /* addr_get_serialize_size */
     NULL,                                 /* addr_serialize */
     NULL,                                 /* addr_deserialize */
+    NULL,                                 /* addr_deserialize_batch */
     na_mpi_msg_get_max_unexpected_size,   /* msg_get_max_unexpected_size */
     na_mpi_msg_get_max_expected_size,     /* msg_get_max_expected_size */
     NULL,                                 /* msg_get_unexpected_header_size */
@@ -423,9 +489,11 @@ const struct na_class_ops NA_PLUGIN_OPS(mpi) = {
     NULL,                                 /* msg_buf_free */
     NULL,                                 /* msg_init_unexpected */
     na_mpi_msg_send_unexpected,           /* msg_send_unexpected */
+    NULL,                                 /* msg_send_unexpectedv */
     na_mpi_msg_recv_unexpected,           /* msg_recv_unexpected */
     NULL,                                 /* msg_init_expected */
     na_mpi_msg_send_expected,             /* msg_send_expected */
+    NULL,                                 /* msg_send_expectedv */
     na_mpi_msg_recv_expected,             /* msg_recv_expected */
     na_mpi_mem_handle_create,             /* mem_handle_create */
     NULL,                                 /* mem_handle_create_segment */
@@ -441,7 +509,13 @@ const struct na_class_ops NA_PLUGIN_OPS(mpi) = {
     NULL,                                 /* poll_get_fd */
     NULL,                                 /* poll_try_wait */
     na_mpi_progress,                      /* progress */
-    na_mpi_cancel                         /* cancel */
+    na_mpi_cancel,                        /* cancel */
+    NULL,                                 /* get_resource_stats */
+    NULL,                                 /* mem_handle_create_sub */
+    NULL,                                 /* op_batch_begin */
+    NULL,                                 /* op_batch_end */
+    NULL,                                 /* mem_register_attr */
+    NULL                                  /* atomic */
 };
 
 static MPI_Comm na_mpi_init_comm_g = MPI_COMM_NULL; /* MPI comm used at init */
@@ -695,19 +769,87 @@ na_mpi_msg_unexpected_op_push(
 }
 
 /*---------------------------------------------------------------------------*/
-static struct na_mpi_op_id *
-na_mpi_msg_unexpected_op_pop(na_class_t *na_class)
+static na_return_t
+na_mpi_request_set_grow(struct na_mpi_request_set *request_set, int count)
 {
-    struct na_mpi_op_id *na_mpi_op_id;
+    int max = (request_set->max) ? request_set->max : NA_MPI_REQUEST_NUM;
+    void *ptr;
+    na_return_t ret = NA_SUCCESS;
 
-    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
+    while (max < count)
+        max *= 2;
 
-    na_mpi_op_id = HG_QUEUE_FIRST(&NA_MPI_CLASS(na_class)->unexpected_op_queue);
-    HG_QUEUE_POP_HEAD(&NA_MPI_CLASS(na_class)->unexpected_op_queue, entry);
+    ptr = realloc(request_set->requests, (size_t) max * sizeof(MPI_Request));
+    if (!ptr)
+        goto nomem;
+    request_set->requests = (MPI_Request *) ptr;
 
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
+    ptr = realloc(
+        request_set->op_ids, (size_t) max * sizeof(struct na_mpi_op_id *));
+    if (!ptr)
+        goto nomem;
+    request_set->op_ids = (struct na_mpi_op_id **) ptr;
+
+    ptr = realloc(
+        request_set->completed, (size_t) max * sizeof(struct na_mpi_op_id *));
+    if (!ptr)
+        goto nomem;
+    request_set->completed = (struct na_mpi_op_id **) ptr;
+
+    ptr = realloc(request_set->statuses, (size_t) max * sizeof(MPI_Status));
+    if (!ptr)
+        goto nomem;
+    request_set->statuses = (MPI_Status *) ptr;
+
+    ptr = realloc(request_set->indices, (size_t) max * sizeof(int));
+    if (!ptr)
+        goto nomem;
+    request_set->indices = (int *) ptr;
+
+    request_set->max = max;
+
+done:
+    return ret;
+
+nomem:
+    /* Arrays already reallocated are only larger than needed */
+    NA_LOG_ERROR("Could not grow request set");
+    ret = NA_NOMEM_ERROR;
+    goto done;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_request_set_add(na_class_t *na_class, struct na_mpi_op_id *na_mpi_op_id,
+    const MPI_Request *requests, int count)
+{
+    struct na_mpi_request_set *request_set =
+        &NA_MPI_CLASS(na_class)->request_set;
+    na_return_t ret = NA_SUCCESS;
+    int i;
+
+    hg_thread_mutex_lock(&request_set->mutex);
+
+    if (request_set->count + count > request_set->max) {
+        ret = na_mpi_request_set_grow(request_set, request_set->count + count);
+        if (ret != NA_SUCCESS)
+            goto done;
+    }
 
-    return na_mpi_op_id;
+    /* Op ID completes once all of its requests have completed */
+    na_mpi_op_id->pending = 0;
+    for (i = 0; i < count; i++) {
+        if (requests[i] == MPI_REQUEST_NULL)
+            continue;
+        request_set->requests[request_set->count] = requests[i];
+        request_set->op_ids[request_set->count] = na_mpi_op_id;
+        request_set->count++;
+        na_mpi_op_id->pending++;
+    }
+
+done:
+    hg_thread_mutex_unlock(&request_set->mutex);
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -728,6 +870,53 @@ na_mpi_gen_rma_tag(na_class_t *na_class)
     return tag;
 }
 
+/*---------------------------------------------------------------------------*/
+#ifdef NA_MPI_HAS_RMA_WIN
+static int
+na_mpi_win_rank(struct na_mpi_addr *na_mpi_addr)
+{
+    MPI_Group group = MPI_GROUP_NULL, world_group = MPI_GROUP_NULL;
+    int win_rank = MPI_UNDEFINED;
+    int is_inter = 0;
+    int mpi_ret;
+
+    /* Window is created over MPI_COMM_WORLD, translate rank of remote peer */
+    if (na_mpi_addr->rma_comm == MPI_COMM_NULL)
+        goto done;
+
+    mpi_ret = MPI_Comm_test_inter(na_mpi_addr->rma_comm, &is_inter);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Comm_test_inter() failed");
+        goto done;
+    }
+    mpi_ret = (is_inter) ? MPI_Comm_remote_group(na_mpi_addr->rma_comm, &group)
+                         : MPI_Comm_group(na_mpi_addr->rma_comm, &group);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("Could not get group of remote peer");
+        goto done;
+    }
+    mpi_ret = MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Comm_group() failed");
+        goto done;
+    }
+    mpi_ret = MPI_Group_translate_ranks(
+        group, 1, &na_mpi_addr->rank, world_group, &win_rank);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Group_translate_ranks() failed");
+        win_rank = MPI_UNDEFINED;
+        goto done;
+    }
+
+done:
+    if (group != MPI_GROUP_NULL)
+        MPI_Group_free(&group);
+    if (world_group != MPI_GROUP_NULL)
+        MPI_Group_free(&world_group);
+    return win_rank;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_MPI_Set_init_intra_comm(MPI_Comm intra_comm)
@@ -866,10 +1055,25 @@ na_mpi_initialize(
         goto done;
     }
     NA_MPI_CLASS(na_class)->accept_thread = 0;
+#ifdef NA_MPI_HAS_RMA_WIN
+    NA_MPI_CLASS(na_class)->rma_win = MPI_WIN_NULL;
+#endif
     HG_LIST_INIT(&NA_MPI_CLASS(na_class)->remote_list);
-    HG_LIST_INIT(&NA_MPI_CLASS(na_class)->op_id_list);
+    memset(&NA_MPI_CLASS(na_class)->request_set, 0,
+        sizeof(struct na_mpi_request_set));
     HG_QUEUE_INIT(&NA_MPI_CLASS(na_class)->unexpected_op_queue);
 
+    /* Create op ID slab */
+    NA_MPI_CLASS(na_class)->op_slab =
+        na_op_slab_create(sizeof(struct na_mpi_op_id));
+    if (!NA_MPI_CLASS(na_class)->op_slab) {
+        NA_LOG_ERROR("Could not create op ID slab");
+        free(na_class->plugin_class);
+        na_class->plugin_class = NULL;
+        ret = NA_NOMEM_ERROR;
+        goto done;
+    }
+
     /* Check flags */
     if (strcmp(na_info->protocol_name, "static") == 0)
         flags |= MPI_INIT_STATIC;
@@ -967,12 +1171,53 @@ na_mpi_initialize(
         }
     }
 
+#ifdef NA_MPI_HAS_RMA_WIN
+    /* Static inter-communicators already assume that server and client
+     * processes form MPI_COMM_WORLD, so a dynamic window can be created over
+     * it, memory is attached when registered */
+    if (use_static_inter_comm) {
+        mpi_ret = MPI_Win_create_dynamic(
+            MPI_INFO_NULL, MPI_COMM_WORLD, &NA_MPI_CLASS(na_class)->rma_win);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Win_create_dynamic() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+
+        /* Failed attaches must fall back to two-sided emulation instead of
+         * aborting */
+        mpi_ret = MPI_Win_set_errhandler(
+            NA_MPI_CLASS(na_class)->rma_win, MPI_ERRORS_RETURN);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Win_set_errhandler() failed");
+            MPI_Win_free(&NA_MPI_CLASS(na_class)->rma_win);
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+
+        NA_MPI_CLASS(na_class)->rma_win_count = 0;
+
+        /* Passive target epoch for the lifetime of the class */
+        mpi_ret =
+            MPI_Win_lock_all(MPI_MODE_NOCHECK, NA_MPI_CLASS(na_class)->rma_win);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Win_lock_all() failed");
+            MPI_Win_free(&NA_MPI_CLASS(na_class)->rma_win);
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+#endif
+
     /* Initialize mutex/cond */
     hg_thread_mutex_init(&NA_MPI_CLASS(na_class)->accept_mutex);
     hg_thread_cond_init(&NA_MPI_CLASS(na_class)->accept_cond);
     hg_thread_mutex_init(&NA_MPI_CLASS(na_class)->remote_list_mutex);
-    hg_thread_mutex_init(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+    hg_thread_mutex_init(&NA_MPI_CLASS(na_class)->request_set.mutex);
     hg_thread_mutex_init(&NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
+#ifdef NA_MPI_HAS_RMA_WIN
+    hg_thread_mutex_init(&NA_MPI_CLASS(na_class)->rma_win_mutex);
+#endif
 
     /* Initialize atomic op */
     hg_atomic_set32(&NA_MPI_CLASS(na_class)->rma_tag, NA_MPI_RMA_TAG);
@@ -1045,6 +1290,19 @@ na_mpi_finalize(na_class_t *na_class)
         ret = NA_PROTOCOL_ERROR;
     }
 
+#ifdef NA_MPI_HAS_RMA_WIN
+    /* Free dynamic window */
+    if (NA_MPI_CLASS(na_class)->rma_win != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(NA_MPI_CLASS(na_class)->rma_win);
+        mpi_ret = MPI_Win_free(&NA_MPI_CLASS(na_class)->rma_win);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("Could not free dynamic window");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+#endif
+
     /* Free the private dup'ed comm */
     mpi_ret = MPI_Comm_free(&NA_MPI_CLASS(na_class)->intra_comm);
     if (mpi_ret != MPI_SUCCESS) {
@@ -1074,9 +1332,18 @@ na_mpi_finalize(na_class_t *na_class)
     hg_thread_mutex_destroy(&NA_MPI_CLASS(na_class)->accept_mutex);
     hg_thread_cond_destroy(&NA_MPI_CLASS(na_class)->accept_cond);
     hg_thread_mutex_destroy(&NA_MPI_CLASS(na_class)->remote_list_mutex);
-    hg_thread_mutex_destroy(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+    hg_thread_mutex_destroy(&NA_MPI_CLASS(na_class)->request_set.mutex);
     hg_thread_mutex_destroy(&NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
+#ifdef NA_MPI_HAS_RMA_WIN
+    hg_thread_mutex_destroy(&NA_MPI_CLASS(na_class)->rma_win_mutex);
+#endif
 
+    free(NA_MPI_CLASS(na_class)->request_set.requests);
+    free(NA_MPI_CLASS(na_class)->request_set.op_ids);
+    free(NA_MPI_CLASS(na_class)->request_set.completed);
+    free(NA_MPI_CLASS(na_class)->request_set.statuses);
+    free(NA_MPI_CLASS(na_class)->request_set.indices);
+    na_op_slab_destroy(NA_MPI_CLASS(na_class)->op_slab);
     free(na_class->plugin_class);
 
 done:
@@ -1085,11 +1352,12 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_op_id_t *
-na_mpi_op_create(na_class_t NA_UNUSED *na_class)
+na_mpi_op_create(na_class_t *na_class)
 {
     struct na_mpi_op_id *na_mpi_op_id = NULL;
 
-    na_mpi_op_id = (struct na_mpi_op_id *) malloc(sizeof(struct na_mpi_op_id));
+    na_mpi_op_id = (struct na_mpi_op_id *) na_op_slab_alloc(
+        NA_MPI_CLASS(na_class)->op_slab);
     if (!na_mpi_op_id) {
         NA_LOG_ERROR("Could not allocate NA MPI operation ID");
         goto done;
@@ -1105,9 +1373,9 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_mpi_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+na_mpi_op_destroy(na_class_t *na_class, na_op_id_t *op_id)
 {
-    free((struct na_mpi_op_id *) op_id);
+    na_op_slab_free(NA_MPI_CLASS(na_class)->op_slab, op_id);
 
     return NA_SUCCESS;
 }
@@ -1356,7 +1624,7 @@ static na_return_t
 na_mpi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t dest_addr,
-    na_uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
 {
     int mpi_buf_size = (int) buf_size;
     int mpi_tag = (int) tag;
@@ -1382,11 +1650,13 @@ na_mpi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(
-        &NA_MPI_CLASS(na_class)->op_id_list, na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+    /* Add request to request set */
+    ret = na_mpi_request_set_add(na_class, na_mpi_op_id,
+        &na_mpi_op_id->info.send_unexpected.data_request, 1);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request to request set");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1448,7 +1718,7 @@ static na_return_t
 na_mpi_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t dest_addr,
-    na_uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
 {
     int mpi_buf_size = (int) buf_size;
     int mpi_tag = (int) tag;
@@ -1475,11 +1745,13 @@ na_mpi_msg_send_expected(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    /* Append op_id to op_id list assign op_id */
-    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(
-        &NA_MPI_CLASS(na_class)->op_id_list, na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+    /* Add request to request set */
+    ret = na_mpi_request_set_add(na_class, na_mpi_op_id,
+        &na_mpi_op_id->info.send_expected.data_request, 1);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request to request set");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1493,7 +1765,7 @@ static na_return_t
 na_mpi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t source_addr,
-    na_uint8_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
 {
     int mpi_buf_size = (int) buf_size;
     int mpi_tag = (int) tag;
@@ -1522,11 +1794,13 @@ na_mpi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(
-        &NA_MPI_CLASS(na_class)->op_id_list, na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+    /* Add request to request set */
+    ret = na_mpi_request_set_add(na_class, na_mpi_op_id,
+        &na_mpi_op_id->info.recv_expected.data_request, 1);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request to request set");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1578,20 +1852,129 @@ na_mpi_mem_handle_free(
 }
 
 /*---------------------------------------------------------------------------*/
+#ifdef NA_MPI_HAS_RMA_WIN
+static na_return_t
+na_mpi_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_mpi_mem_handle *na_mpi_mem_handle =
+        (struct na_mpi_mem_handle *) mem_handle;
+    struct na_mpi_class *na_mpi_class = NA_MPI_CLASS(na_class);
+    na_ptr_t base = na_mpi_mem_handle->base;
+    MPI_Aint size = na_mpi_mem_handle->size;
+    unsigned int i;
+    int mpi_ret;
+
+    if (na_mpi_class->rma_win == MPI_WIN_NULL || size == 0)
+        return NA_SUCCESS;
+
+    hg_thread_mutex_lock(&na_mpi_class->rma_win_mutex);
+
+    /* Attached regions may not overlap, memory within an attached region is
+     * already exposed while memory that partially overlaps one falls back to
+     * two-sided emulation */
+    for (i = 0; i < na_mpi_class->rma_win_count; i++) {
+        struct na_mpi_rma_region *region = &na_mpi_class->rma_win_regions[i];
+
+        if (base >= region->base &&
+            base + (na_ptr_t) size <= region->base + (na_ptr_t) region->size) {
+            region->refcount++;
+            goto attached;
+        }
+        if (base < region->base + (na_ptr_t) region->size &&
+            region->base < base + (na_ptr_t) size)
+            goto done;
+    }
+
+    /* Past the attach limit, fall back to two-sided emulation */
+    if (na_mpi_class->rma_win_count == NA_MPI_RMA_WIN_ATTACH_MAX)
+        goto done;
+
+    /* Expose memory to remote peers */
+    mpi_ret = MPI_Win_attach(na_mpi_class->rma_win, (void *) base, size);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_WARNING("MPI_Win_attach() failed, using two-sided emulation");
+        goto done;
+    }
+    na_mpi_class->rma_win_regions[i].base = base;
+    na_mpi_class->rma_win_regions[i].size = size;
+    na_mpi_class->rma_win_regions[i].refcount = 1;
+    na_mpi_class->rma_win_count++;
+
+attached:
+    MPI_Get_address((void *) base, &na_mpi_mem_handle->disp);
+    na_mpi_mem_handle->attached = NA_TRUE;
+
+done:
+    hg_thread_mutex_unlock(&na_mpi_class->rma_win_mutex);
+
+    return NA_SUCCESS;
+}
+#else
 static na_return_t
 na_mpi_mem_register(
     na_class_t NA_UNUSED *na_class, na_mem_handle_t NA_UNUSED mem_handle)
 {
     return NA_SUCCESS;
 }
+#endif
 
 /*---------------------------------------------------------------------------*/
+#ifdef NA_MPI_HAS_RMA_WIN
+static na_return_t
+na_mpi_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_mpi_mem_handle *na_mpi_mem_handle =
+        (struct na_mpi_mem_handle *) mem_handle;
+    struct na_mpi_class *na_mpi_class = NA_MPI_CLASS(na_class);
+    struct na_mpi_rma_region *region = NULL;
+    na_return_t ret = NA_SUCCESS;
+    unsigned int i;
+    int mpi_ret;
+
+    if (!na_mpi_mem_handle->attached || na_mpi_mem_handle->remote)
+        return NA_SUCCESS;
+
+    hg_thread_mutex_lock(&na_mpi_class->rma_win_mutex);
+
+    /* Find the region that the handle was registered within */
+    for (i = 0; i < na_mpi_class->rma_win_count; i++) {
+        region = &na_mpi_class->rma_win_regions[i];
+        if (na_mpi_mem_handle->base >= region->base &&
+            na_mpi_mem_handle->base < region->base + (na_ptr_t) region->size)
+            break;
+    }
+    if (i == na_mpi_class->rma_win_count) {
+        NA_LOG_ERROR("Could not find attached region");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    na_mpi_mem_handle->attached = NA_FALSE;
+
+    /* Detach once the last handle within the region is released */
+    if (--region->refcount > 0)
+        goto done;
+
+    mpi_ret = MPI_Win_detach(na_mpi_class->rma_win, (void *) region->base);
+    *region = na_mpi_class->rma_win_regions[--na_mpi_class->rma_win_count];
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_detach() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+done:
+    hg_thread_mutex_unlock(&na_mpi_class->rma_win_mutex);
+
+    return ret;
+}
+#else
 static na_return_t
 na_mpi_mem_deregister(
     na_class_t NA_UNUSED *na_class, na_mem_handle_t NA_UNUSED mem_handle)
 {
     return NA_SUCCESS;
 }
+#endif
 
 /*---------------------------------------------------------------------------*/
 static na_size_t
@@ -1647,6 +2030,9 @@ na_mpi_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
 
     /* Copy struct */
     memcpy(na_mpi_mem_handle, buf, sizeof(struct na_mpi_mem_handle));
+#ifdef NA_MPI_HAS_RMA_WIN
+    na_mpi_mem_handle->remote = NA_TRUE;
+#endif
 
     *mem_handle = (na_mem_handle_t) na_mpi_mem_handle;
 
@@ -1659,7 +2045,7 @@ static na_return_t
 na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t NA_UNUSED remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
     na_op_id_t *op_id)
 {
     struct na_mpi_mem_handle *mpi_local_mem_handle =
@@ -1673,6 +2059,7 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
                                     * than 2GB */
     struct na_mpi_op_id *na_mpi_op_id = NULL;
     struct na_mpi_rma_info *na_mpi_rma_info = NULL;
+    MPI_Request requests[2];
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
@@ -1701,6 +2088,32 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_mpi_op_id->info.put.data_request = MPI_REQUEST_NULL;
     na_mpi_op_id->info.put.internal_progress = NA_FALSE;
     na_mpi_op_id->info.put.rma_info = NULL;
+#ifdef NA_MPI_HAS_RMA_WIN
+    na_mpi_op_id->info.put.win_rank = MPI_UNDEFINED;
+
+    /* Use one-sided put if remote memory is attached to the window, no
+     * progress is then required on the target */
+    if (mpi_remote_mem_handle->attached &&
+        NA_MPI_CLASS(na_class)->rma_win != MPI_WIN_NULL) {
+        int win_rank = na_mpi_win_rank(na_mpi_addr);
+
+        if (win_rank != MPI_UNDEFINED) {
+            mpi_ret = MPI_Rput(
+                (char *) mpi_local_mem_handle->base + mpi_local_offset,
+                mpi_length, MPI_BYTE, win_rank,
+                mpi_remote_mem_handle->disp + mpi_remote_offset, mpi_length,
+                MPI_BYTE, NA_MPI_CLASS(na_class)->rma_win,
+                &na_mpi_op_id->info.put.data_request);
+            if (mpi_ret != MPI_SUCCESS) {
+                NA_LOG_ERROR("MPI_Rput() failed");
+                ret = NA_PROTOCOL_ERROR;
+                goto done;
+            }
+            na_mpi_op_id->info.put.win_rank = win_rank;
+            goto post;
+        }
+    }
+#endif
 
     /* Allocate rma info (use calloc to avoid uninitialized transfer) */
     na_mpi_rma_info =
@@ -1737,11 +2150,17 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(
-        &NA_MPI_CLASS(na_class)->op_id_list, na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+#ifdef NA_MPI_HAS_RMA_WIN
+post:
+#endif
+    /* Add requests to request set, rma_request is only set for emulation */
+    requests[0] = na_mpi_op_id->info.put.rma_request;
+    requests[1] = na_mpi_op_id->info.put.data_request;
+    ret = na_mpi_request_set_add(na_class, na_mpi_op_id, requests, 2);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add requests to request set");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1756,7 +2175,7 @@ static na_return_t
 na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t NA_UNUSED remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
     na_op_id_t *op_id)
 {
     struct na_mpi_mem_handle *mpi_local_mem_handle =
@@ -1770,6 +2189,7 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
                                     * than 2GB */
     struct na_mpi_op_id *na_mpi_op_id = NULL;
     struct na_mpi_rma_info *na_mpi_rma_info = NULL;
+    MPI_Request requests[2];
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
@@ -1798,6 +2218,29 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_mpi_op_id->info.get.data_request = MPI_REQUEST_NULL;
     na_mpi_op_id->info.put.internal_progress = NA_FALSE;
     na_mpi_op_id->info.get.rma_info = NULL;
+#ifdef NA_MPI_HAS_RMA_WIN
+    /* Use one-sided get if remote memory is attached to the window, request
+     * completion implies that data has arrived */
+    if (mpi_remote_mem_handle->attached &&
+        NA_MPI_CLASS(na_class)->rma_win != MPI_WIN_NULL) {
+        int win_rank = na_mpi_win_rank(na_mpi_addr);
+
+        if (win_rank != MPI_UNDEFINED) {
+            mpi_ret = MPI_Rget(
+                (char *) mpi_local_mem_handle->base + mpi_local_offset,
+                mpi_length, MPI_BYTE, win_rank,
+                mpi_remote_mem_handle->disp + mpi_remote_offset, mpi_length,
+                MPI_BYTE, NA_MPI_CLASS(na_class)->rma_win,
+                &na_mpi_op_id->info.get.data_request);
+            if (mpi_ret != MPI_SUCCESS) {
+                NA_LOG_ERROR("MPI_Rget() failed");
+                ret = NA_PROTOCOL_ERROR;
+                goto done;
+            }
+            goto post;
+        }
+    }
+#endif
 
     /* Allocate rma info (use calloc to avoid uninitialized transfer) */
     na_mpi_rma_info =
@@ -1834,11 +2277,17 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(
-        &NA_MPI_CLASS(na_class)->op_id_list, na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+#ifdef NA_MPI_HAS_RMA_WIN
+post:
+#endif
+    /* Add requests to request set, rma_request is only set for emulation */
+    requests[0] = na_mpi_op_id->info.get.rma_request;
+    requests[1] = na_mpi_op_id->info.get.data_request;
+    ret = na_mpi_request_set_add(na_class, na_mpi_op_id, requests, 2);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add requests to request set");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1859,30 +2308,31 @@ na_mpi_progress(
 
     do {
         hg_time_t t1, t2;
+        na_bool_t progressed;
 
         if (timeout)
             hg_time_get_current_ms(&t1);
 
-        /* Try to make unexpected progress */
+        /* Try to make unexpected progress, matched messages are received
+         * through the request set so keep going to expected progress */
         ret = na_mpi_progress_unexpected(na_class, context, 0);
-        if (ret != NA_SUCCESS) {
-            if (ret != NA_TIMEOUT) {
-                NA_LOG_ERROR("Could not make unexpected progress");
-                goto done;
-            }
-        } else
-            break; /* Progressed */
+        if (ret != NA_SUCCESS && ret != NA_TIMEOUT) {
+            NA_LOG_ERROR("Could not make unexpected progress");
+            goto done;
+        }
+        progressed = (ret == NA_SUCCESS);
 
         /* Try to make expected progress */
         ret = na_mpi_progress_expected(
             na_class, context, (unsigned int) (remaining * 1000.0));
-        if (ret != NA_SUCCESS) {
-            if (ret != NA_TIMEOUT) {
-                NA_LOG_ERROR("Could not make expected progress");
-                goto done;
-            }
-        } else
+        if (ret != NA_SUCCESS && ret != NA_TIMEOUT) {
+            NA_LOG_ERROR("Could not make expected progress");
+            goto done;
+        }
+        if (ret == NA_SUCCESS || progressed) {
+            ret = NA_SUCCESS;
             break; /* Progressed */
+        }
 
         if (timeout) {
             hg_time_get_current_ms(&t2);
@@ -1907,42 +2357,32 @@ na_mpi_progress_unexpected(
     hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->remote_list_mutex);
 
     HG_LIST_FOREACH (probe_addr, &NA_MPI_CLASS(na_class)->remote_list, entry) {
-        MPI_Status status1, status2;
+        MPI_Message message;
+        MPI_Status status;
         int flag = 0;
 
         /* First look for user unexpected message */
-        mpi_ret = MPI_Iprobe(
-            MPI_ANY_SOURCE, MPI_ANY_TAG, probe_addr->comm, &flag, &status1);
-        if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Iprobe() failed");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
-
-        if (flag) {
-            ret = na_mpi_progress_unexpected_msg(
-                na_class, context, probe_addr, &status1);
-            if (ret != NA_SUCCESS) {
-                if (ret != NA_TIMEOUT) {
-                    NA_LOG_ERROR("Could not make unexpected MSG progress");
-                    goto done;
-                }
-            } else
-                break; /* Progressed */
-        }
+        ret = na_mpi_progress_unexpected_msg(na_class, context, probe_addr);
+        if (ret != NA_SUCCESS) {
+            if (ret != NA_TIMEOUT) {
+                NA_LOG_ERROR("Could not make unexpected MSG progress");
+                goto done;
+            }
+        } else
+            break; /* Progressed */
 
         /* Look for internal unexpected RMA requests */
-        mpi_ret = MPI_Iprobe(probe_addr->rank, NA_MPI_RMA_REQUEST_TAG,
-            probe_addr->rma_comm, &flag, &status2);
+        mpi_ret = MPI_Improbe(probe_addr->rank, NA_MPI_RMA_REQUEST_TAG,
+            probe_addr->rma_comm, &flag, &message, &status);
         if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Iprobe() failed");
+            NA_LOG_ERROR("MPI_Improbe() failed");
             ret = NA_PROTOCOL_ERROR;
             goto done;
         }
 
         if (flag) {
             ret = na_mpi_progress_unexpected_rma(
-                na_class, context, probe_addr, &status2);
+                na_class, context, probe_addr, &message, &status);
             if (ret != NA_SUCCESS) {
                 NA_LOG_ERROR("Could not make unexpected RMA progress");
                 goto done;
@@ -1951,54 +2391,71 @@ na_mpi_progress_unexpected(
         }
     }
 
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->remote_list_mutex);
-
 done:
+    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->remote_list_mutex);
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_mpi_progress_unexpected_msg(na_class_t *na_class,
-    na_context_t NA_UNUSED *context, struct na_mpi_addr *na_mpi_addr,
-    const MPI_Status *status)
+    na_context_t NA_UNUSED *context, struct na_mpi_addr *na_mpi_addr)
 {
     struct na_mpi_op_id *na_mpi_op_id = NULL;
+    MPI_Request request = MPI_REQUEST_NULL;
+    MPI_Message message;
+    MPI_Status status;
     int unexpected_buf_size = 0;
     na_return_t ret = NA_TIMEOUT;
-    int mpi_ret;
+    int flag = 0, mpi_ret = MPI_SUCCESS;
 
-    MPI_Get_count(status, MPI_BYTE, &unexpected_buf_size);
-    if (unexpected_buf_size >
-        (int) na_mpi_msg_get_max_unexpected_size(na_class)) {
-        NA_LOG_ERROR("Exceeding unexpected MSG size");
-        ret = NA_SIZE_ERROR;
-        goto done;
+    /* A matched probe removes the message from the MPI matching queue, only
+     * probe if an unexpected recv was posted to receive it */
+    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
+    if (!HG_QUEUE_IS_EMPTY(&NA_MPI_CLASS(na_class)->unexpected_op_queue)) {
+        mpi_ret = MPI_Improbe(MPI_ANY_SOURCE, MPI_ANY_TAG, na_mpi_addr->comm,
+            &flag, &message, &status);
+        if (mpi_ret == MPI_SUCCESS && flag) {
+            na_mpi_op_id =
+                HG_QUEUE_FIRST(&NA_MPI_CLASS(na_class)->unexpected_op_queue);
+            HG_QUEUE_POP_HEAD(
+                &NA_MPI_CLASS(na_class)->unexpected_op_queue, entry);
+        }
     }
+    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
 
-    /* Try to pop an unexpected recv op id */
-    na_mpi_op_id = na_mpi_msg_unexpected_op_pop(na_class);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Improbe() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
     if (!na_mpi_op_id) {
-        /* Can't process it since nobody has posted an unexpected recv yet */
+        /* Nothing arrived or nobody has posted an unexpected recv yet */
         goto done;
     }
 
-    mpi_ret = MPI_Recv(na_mpi_op_id->info.recv_unexpected.buf,
-        na_mpi_op_id->info.recv_unexpected.buf_size, MPI_BYTE,
-        status->MPI_SOURCE, status->MPI_TAG, na_mpi_addr->comm,
-        MPI_STATUS_IGNORE);
+    MPI_Get_count(&status, MPI_BYTE, &unexpected_buf_size);
+    if (unexpected_buf_size > na_mpi_op_id->info.recv_unexpected.buf_size) {
+        NA_LOG_ERROR("Exceeding unexpected MSG size");
+        na_mpi_msg_unexpected_op_push(na_class, na_mpi_op_id);
+        ret = NA_SIZE_ERROR;
+        goto done;
+    }
+
+    /* Message is already matched, receive it through the request set */
+    na_mpi_op_id->info.recv_unexpected.remote_addr = na_mpi_addr;
+    mpi_ret = MPI_Imrecv(na_mpi_op_id->info.recv_unexpected.buf,
+        na_mpi_op_id->info.recv_unexpected.buf_size, MPI_BYTE, &message,
+        &request);
     if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Recv() failed");
+        NA_LOG_ERROR("MPI_Imrecv() failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
 
-    na_mpi_op_id->info.recv_unexpected.remote_addr = na_mpi_addr;
-    memcpy(
-        &na_mpi_op_id->info.recv_unexpected.status, status, sizeof(MPI_Status));
-    ret = na_mpi_complete(na_mpi_op_id);
+    ret = na_mpi_request_set_add(na_class, na_mpi_op_id, &request, 1);
     if (ret != NA_SUCCESS) {
-        NA_LOG_ERROR("Could not complete op id");
+        NA_LOG_ERROR("Could not add request to request set");
         goto done;
     }
 
@@ -2009,10 +2466,12 @@ done:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
-    struct na_mpi_addr *na_mpi_addr, const MPI_Status *status)
+    struct na_mpi_addr *na_mpi_addr, MPI_Message *message,
+    const MPI_Status *status)
 {
     struct na_mpi_rma_info *na_mpi_rma_info = NULL;
     struct na_mpi_op_id *na_mpi_op_id = NULL;
+    MPI_Request *data_request = NULL;
     int unexpected_buf_size = 0;
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
@@ -2033,12 +2492,11 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    /* Recv message (already arrived) */
-    mpi_ret = MPI_Recv(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
-        MPI_BYTE, status->MPI_SOURCE, status->MPI_TAG, na_mpi_addr->rma_comm,
-        MPI_STATUS_IGNORE);
+    /* Recv matched message (already arrived) */
+    mpi_ret = MPI_Mrecv(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
+        MPI_BYTE, message, MPI_STATUS_IGNORE);
     if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Recv() failed");
+        NA_LOG_ERROR("MPI_Mrecv() failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
@@ -2065,12 +2523,13 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
             na_mpi_op_id->info.put.data_request = MPI_REQUEST_NULL;
             na_mpi_op_id->info.put.internal_progress = NA_TRUE;
             na_mpi_op_id->info.put.rma_info = na_mpi_rma_info;
+            data_request = &na_mpi_op_id->info.put.data_request;
 
             mpi_ret = MPI_Irecv(
                 (char *) na_mpi_rma_info->base + na_mpi_rma_info->disp,
                 na_mpi_rma_info->count, MPI_BYTE, status->MPI_SOURCE,
                 (int) na_mpi_rma_info->tag, na_mpi_addr->rma_comm,
-                &na_mpi_op_id->info.put.data_request);
+                data_request);
             if (mpi_ret != MPI_SUCCESS) {
                 NA_LOG_ERROR("MPI_Irecv() failed");
                 ret = NA_PROTOCOL_ERROR;
@@ -2085,12 +2544,13 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
             na_mpi_op_id->info.get.data_request = MPI_REQUEST_NULL;
             na_mpi_op_id->info.get.internal_progress = NA_TRUE;
             na_mpi_op_id->info.get.rma_info = na_mpi_rma_info;
+            data_request = &na_mpi_op_id->info.get.data_request;
 
             mpi_ret = MPI_Isend(
                 (char *) na_mpi_rma_info->base + na_mpi_rma_info->disp,
                 na_mpi_rma_info->count, MPI_BYTE, status->MPI_SOURCE,
                 (int) na_mpi_rma_info->tag, na_mpi_addr->rma_comm,
-                &na_mpi_op_id->info.get.data_request);
+                data_request);
             if (mpi_ret != MPI_SUCCESS) {
                 NA_LOG_ERROR("MPI_Isend() failed");
                 ret = NA_PROTOCOL_ERROR;
@@ -2103,11 +2563,12 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
             break;
     }
 
-    /* Add op_id to list */
-    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(
-        &NA_MPI_CLASS(na_class)->op_id_list, na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+    /* Add request to request set */
+    ret = na_mpi_request_set_add(na_class, na_mpi_op_id, data_request, 1);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request to request set");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -2122,125 +2583,130 @@ static na_return_t
 na_mpi_progress_expected(na_class_t *na_class, na_context_t NA_UNUSED *context,
     unsigned int NA_UNUSED timeout)
 {
-    struct na_mpi_op_id *na_mpi_op_id = NULL;
+    struct na_mpi_request_set *request_set =
+        &NA_MPI_CLASS(na_class)->request_set;
     na_return_t ret = NA_TIMEOUT;
+    int outcount = 0, mpi_ret, i, j;
 
-    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+    hg_thread_mutex_lock(&request_set->mutex);
 
-    na_mpi_op_id = HG_LIST_FIRST(&NA_MPI_CLASS(na_class)->op_id_list);
-    while (na_mpi_op_id) {
-        MPI_Request *request = NULL;
-        na_bool_t internal = NA_FALSE; /* Only used to complete internal ops */
-        struct na_mpi_rma_info **rma_info = NULL;
-        na_bool_t complete_op_id = NA_TRUE;
-        int flag = 0, mpi_ret = 0;
-        MPI_Status *status = MPI_STATUS_IGNORE;
+    if (!request_set->count)
+        goto done;
 
-        /* If the op_id is marked as completed, something is wrong */
-        if (hg_atomic_get32(&na_mpi_op_id->completed)) {
-            NA_LOG_ERROR("Op ID should not have completed yet");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
+    /* Test all active requests at once */
+    mpi_ret = MPI_Testsome(request_set->count, request_set->requests,
+        &outcount, request_set->indices, request_set->statuses);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Testsome() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    if (outcount == MPI_UNDEFINED || outcount == 0)
+        goto done;
 
-        switch (na_mpi_op_id->type) {
-            case NA_CB_RECV_UNEXPECTED:
-                NA_LOG_ERROR("Should not complete unexpected recv here");
-                break;
-            case NA_CB_SEND_UNEXPECTED:
-                request = &na_mpi_op_id->info.send_unexpected.data_request;
-                break;
-            case NA_CB_RECV_EXPECTED:
-                status = &na_mpi_op_id->info.recv_expected.status;
-                request = &na_mpi_op_id->info.recv_expected.data_request;
-                break;
-            case NA_CB_SEND_EXPECTED:
-                request = &na_mpi_op_id->info.send_expected.data_request;
-                break;
-            case NA_CB_PUT:
-                if (na_mpi_op_id->info.put.internal_progress) {
-                    request = &na_mpi_op_id->info.put.data_request;
-                    rma_info = &na_mpi_op_id->info.put.rma_info;
-                    internal = NA_TRUE;
-                } else {
-                    request = &na_mpi_op_id->info.put.rma_request;
-                    if (*request != MPI_REQUEST_NULL) {
-                        complete_op_id = NA_FALSE;
-                    } else {
-                        request = &na_mpi_op_id->info.put.data_request;
-                    }
-                }
-                break;
-            case NA_CB_GET:
-                if (na_mpi_op_id->info.get.internal_progress) {
-                    request = &na_mpi_op_id->info.get.data_request;
-                    rma_info = &na_mpi_op_id->info.get.rma_info;
-                    internal = NA_TRUE;
-                } else {
-                    request = &na_mpi_op_id->info.get.rma_request;
-                    if (*request != MPI_REQUEST_NULL) {
-                        complete_op_id = NA_FALSE;
-                    } else {
-                        request = &na_mpi_op_id->info.get.data_request;
-                    }
-                }
-                break;
-            default:
-                NA_LOG_ERROR("Unknown type of operation ID");
-                ret = NA_PROTOCOL_ERROR;
-                goto done;
-        }
+    /* Completed requests are set to MPI_REQUEST_NULL, compact set */
+    for (i = 0; i < outcount; i++)
+        request_set->completed[i] =
+            request_set->op_ids[request_set->indices[i]];
+    for (i = 0, j = 0; i < request_set->count; i++) {
+        if (request_set->requests[i] == MPI_REQUEST_NULL)
+            continue;
+        request_set->requests[j] = request_set->requests[i];
+        request_set->op_ids[j] = request_set->op_ids[i];
+        j++;
+    }
+    request_set->count = j;
 
-        /* If request is MPI_REQUEST_NULL, the operation should be completed */
-        if (!request || (request && (*request == MPI_REQUEST_NULL))) {
-            NA_LOG_ERROR("NULL request found");
-            ret = NA_PROTOCOL_ERROR;
+    for (i = 0; i < outcount; i++) {
+        ret = na_mpi_progress_op_id(
+            na_class, request_set->completed[i], &request_set->statuses[i]);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not progress operation");
             goto done;
         }
+    }
+    ret = NA_SUCCESS; /* progressed */
 
-        mpi_ret = MPI_Test(request, &flag, status);
-        if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Test() failed");
+done:
+    hg_thread_mutex_unlock(&request_set->mutex);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_progress_op_id(na_class_t *na_class, struct na_mpi_op_id *na_mpi_op_id,
+    const MPI_Status *status)
+{
+    struct na_mpi_rma_info **rma_info = NULL;
+    na_return_t ret = NA_SUCCESS;
+
+    /* If the op_id is marked as completed, something is wrong */
+    if (hg_atomic_get32(&na_mpi_op_id->completed)) {
+        NA_LOG_ERROR("Op ID should not have completed yet");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    switch (na_mpi_op_id->type) {
+        case NA_CB_RECV_UNEXPECTED:
+            memcpy(&na_mpi_op_id->info.recv_unexpected.status, status,
+                sizeof(MPI_Status));
+            break;
+        case NA_CB_RECV_EXPECTED:
+            memcpy(&na_mpi_op_id->info.recv_expected.status, status,
+                sizeof(MPI_Status));
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+        case NA_CB_SEND_EXPECTED:
+            break;
+        case NA_CB_PUT:
+            if (na_mpi_op_id->info.put.internal_progress)
+                rma_info = &na_mpi_op_id->info.put.rma_info;
+            break;
+        case NA_CB_GET:
+            if (na_mpi_op_id->info.get.internal_progress)
+                rma_info = &na_mpi_op_id->info.get.rma_info;
+            break;
+        default:
+            NA_LOG_ERROR("Unknown type of operation ID");
             ret = NA_PROTOCOL_ERROR;
             goto done;
-        }
-        if (!flag) {
-            na_mpi_op_id = HG_LIST_NEXT(na_mpi_op_id, entry);
-            continue;
-        }
-
-        *request = MPI_REQUEST_NULL;
+    }
 
-        /* If internal operation call release directly otherwise add callback
-         * to completion queue */
-        if (internal) {
-            hg_atomic_set32(&na_mpi_op_id->completed, 1);
-            /* Remove entry from list */
-            HG_LIST_REMOVE(na_mpi_op_id, entry);
+    /* Wait for remaining requests (e.g., RMA info and data transfer) */
+    if (--na_mpi_op_id->pending > 0)
+        goto done;
 
-            free(*rma_info);
-            *rma_info = NULL;
-            na_mpi_op_destroy(na_class, (na_op_id_t *) na_mpi_op_id);
-        } else {
-            if (!complete_op_id) {
-                na_mpi_op_id = HG_LIST_NEXT(na_mpi_op_id, entry);
-                continue;
-            }
-            /* Remove entry from list */
-            HG_LIST_REMOVE(na_mpi_op_id, entry);
+    /* If internal operation call release directly otherwise add callback
+     * to completion queue */
+    if (rma_info) {
+        hg_atomic_set32(&na_mpi_op_id->completed, 1);
 
-            ret = na_mpi_complete(na_mpi_op_id);
-            if (ret != NA_SUCCESS) {
-                NA_LOG_ERROR("Could not complete operation");
+        free(*rma_info);
+        *rma_info = NULL;
+        na_mpi_op_destroy(na_class, (na_op_id_t *) na_mpi_op_id);
+    } else {
+#ifdef NA_MPI_HAS_RMA_WIN
+        /* Rput completion is only local, make data visible at target */
+        if (na_mpi_op_id->type == NA_CB_PUT &&
+            na_mpi_op_id->info.put.win_rank != MPI_UNDEFINED) {
+            int mpi_ret = MPI_Win_flush(na_mpi_op_id->info.put.win_rank,
+                NA_MPI_CLASS(na_class)->rma_win);
+            if (mpi_ret != MPI_SUCCESS) {
+                NA_LOG_ERROR("MPI_Win_flush() failed");
+                ret = NA_PROTOCOL_ERROR;
                 goto done;
             }
         }
-        ret = NA_SUCCESS; /* progressed */
-        break;
+#endif
+        ret = na_mpi_complete(na_mpi_op_id);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not complete operation");
+            goto done;
+        }
     }
 
 done:
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
     return ret;
 }
 
@@ -2333,6 +2799,8 @@ na_mpi_complete(struct na_mpi_op_id *na_mpi_op_id)
                 ret = NA_SIZE_ERROR;
                 goto done;
             }
+            callback_info->info.recv_expected.actual_buf_size =
+                (na_size_t) na_mpi_op_id->info.recv_expected.actual_size;
             break;
         case NA_CB_PUT:
             /* Transfer is now done so free RMA info */
@@ -2380,6 +2848,9 @@ na_mpi_cancel(
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
+    /* Prevent requests from completing while they get canceled */
+    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->request_set.mutex);
+
     if (hg_atomic_get32(&na_mpi_op_id->completed))
         goto done;
 
@@ -2395,22 +2866,29 @@ na_mpi_cancel(
             na_mpi_op_id->canceled = NA_TRUE;
             break;
         case NA_CB_RECV_UNEXPECTED: {
-            struct na_mpi_op_id *na_mpi_pop_op_id = NULL;
-
-            /* Must remove op_id from unexpected op_id queue */
-            while (na_mpi_pop_op_id != na_mpi_op_id) {
-                na_mpi_pop_op_id = na_mpi_msg_unexpected_op_pop(na_class);
-
-                /* Push back unexpected op_id to queue if it does not match */
-                if (na_mpi_pop_op_id != na_mpi_op_id) {
-                    na_mpi_msg_unexpected_op_push(na_class, na_mpi_pop_op_id);
-                } else {
-                    na_mpi_op_id->canceled = NA_TRUE;
-                    ret = na_mpi_complete(na_mpi_op_id);
-                    if (ret != NA_SUCCESS) {
-                        NA_LOG_ERROR("Could not complete op id");
-                        goto done;
-                    }
+            struct na_mpi_op_id *na_mpi_queue_op_id = NULL;
+
+            /* Must remove op_id from unexpected op_id queue, if it is no
+             * longer there, a message was matched and is being received */
+            hg_thread_mutex_lock(
+                &NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
+            HG_QUEUE_FOREACH (na_mpi_queue_op_id,
+                &NA_MPI_CLASS(na_class)->unexpected_op_queue, entry) {
+                if (na_mpi_queue_op_id == na_mpi_op_id)
+                    break;
+            }
+            if (na_mpi_queue_op_id)
+                HG_QUEUE_REMOVE(&NA_MPI_CLASS(na_class)->unexpected_op_queue,
+                    na_mpi_op_id, na_mpi_op_id, entry);
+            hg_thread_mutex_unlock(
+                &NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
+
+            if (na_mpi_queue_op_id) {
+                na_mpi_op_id->canceled = NA_TRUE;
+                ret = na_mpi_complete(na_mpi_op_id);
+                if (ret != NA_SUCCESS) {
+                    NA_LOG_ERROR("Could not complete op id");
+                    goto done;
                 }
             }
         } break;
@@ -2447,5 +2925,6 @@ na_mpi_cancel(
     }
 
 done:
+    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->request_set.mutex);
     return ret;
 }
@@ -48,14 +48,17 @@
 
 #include "na_plugin.h"
 
+#include "mercury_atomic_queue.h"
 #include "mercury_hash_table.h"
 #include "mercury_list.h"
 #include "mercury_mem.h"
+#include "mercury_probe.h"
 #include "mercury_thread_rwlock.h"
 #include "mercury_thread_spin.h"
 #include "mercury_time.h"
 
 #include <rdma/fabric.h>
+#include <rdma/fi_atomic.h>
 #include <rdma/fi_cm.h>
 #include <rdma/fi_domain.h>
 #include <rdma/fi_endpoint.h>
@@ -90,6 +93,15 @@
  */
 #define NA_OFI_VERSION FI_VERSION(1, 5)
 
+/* Device memory (FI_HMEM) is only reported with more recent versions */
+#ifdef FI_HMEM
+#    define NA_OFI_HMEM_VERSION FI_VERSION(1, 11)
+#    define NA_OFI_GETINFO_VERSION(caps)                                       \
+        (((caps) & FI_HMEM) ? NA_OFI_HMEM_VERSION : NA_OFI_VERSION)
+#else
+#    define NA_OFI_GETINFO_VERSION(caps) NA_OFI_VERSION
+#endif
+
 /* Default basic bits */
 #define NA_OFI_MR_BASIC_REQ (FI_MR_VIRT_ADDR | FI_MR_ALLOCATED | FI_MR_PROV_KEY)
 
@@ -119,21 +131,22 @@
 #define NA_OFI_PROV_TYPES                                                      \
     X(NA_OFI_PROV_NULL, "", "", 0, 0, 0, 0)                                    \
     X(NA_OFI_PROV_SOCKETS, "sockets", "", FI_SOCKADDR_IN, FI_PROGRESS_AUTO,    \
-        FI_SOURCE | FI_DIRECTED_RECV,                                          \
+        FI_SOURCE | FI_DIRECTED_RECV | FI_ATOMIC,                              \
         NA_OFI_VERIFY_PROV_DOM | NA_OFI_WAIT_FD | NA_OFI_SOURCE_MSG |          \
             NA_OFI_SEP)                                                        \
     X(NA_OFI_PROV_TCP, "tcp;ofi_rxm", "tcp", FI_SOCKADDR_IN, FI_PROGRESS_AUTO, \
-        FI_SOURCE | FI_DIRECTED_RECV, NA_OFI_WAIT_FD | NA_OFI_SOURCE_MSG)      \
+        FI_SOURCE | FI_DIRECTED_RECV | FI_ATOMIC,                              \
+        NA_OFI_WAIT_FD | NA_OFI_SOURCE_MSG)                                    \
     X(NA_OFI_PROV_PSM, "psm", "", FI_ADDR_PSMX, FI_PROGRESS_MANUAL, 0,         \
         NA_OFI_WAIT_SET | NA_OFI_SOURCE_MSG)                                   \
     X(NA_OFI_PROV_PSM2, "psm2", "", FI_ADDR_PSMX2, FI_PROGRESS_MANUAL,         \
-        FI_SOURCE | FI_SOURCE_ERR | FI_DIRECTED_RECV,                          \
+        FI_SOURCE | FI_SOURCE_ERR | FI_DIRECTED_RECV | FI_ATOMIC,              \
         NA_OFI_DOMAIN_LOCK | NA_OFI_SIGNAL | NA_OFI_SEP)                       \
     X(NA_OFI_PROV_VERBS, "verbs;ofi_rxm", "verbs", FI_SOCKADDR_IN,             \
-        FI_PROGRESS_MANUAL, FI_SOURCE | FI_DIRECTED_RECV,                      \
+        FI_PROGRESS_MANUAL, FI_SOURCE | FI_DIRECTED_RECV | FI_ATOMIC,          \
         NA_OFI_VERIFY_PROV_DOM | NA_OFI_WAIT_FD | NA_OFI_SOURCE_MSG)           \
     X(NA_OFI_PROV_GNI, "gni", "", FI_ADDR_GNI, FI_PROGRESS_AUTO,               \
-        FI_SOURCE | FI_SOURCE_ERR | FI_DIRECTED_RECV,                          \
+        FI_SOURCE | FI_SOURCE_ERR | FI_DIRECTED_RECV | FI_ATOMIC,              \
         NA_OFI_WAIT_SET | NA_OFI_SIGNAL | NA_OFI_SEP)                          \
     X(NA_OFI_PROV_MAX, "", "", 0, 0, 0, 0)
 
@@ -169,6 +182,22 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
 #define NA_OFI_HAS_MEM_POOL
 #define NA_OFI_MEM_BLOCK_COUNT (256)
 
+/* Min number of blocks per pool (larger size classes use fewer blocks) */
+#define NA_OFI_MEM_BLOCK_COUNT_MIN (16)
+
+/* Max number of block size classes (NA_OFI_MSG_SIZE, 2x, 4x, etc) */
+#define NA_OFI_MEM_POOL_CLASS_MAX (8)
+
+/* Register a new pool once free blocks of a class drop below this count */
+#define NA_OFI_MEM_POOL_LOW_WATERMARK(block_count) ((block_count) / 4)
+
+/* Size of a pool of a given class (header followed by nodes) */
+#define NA_OFI_MEM_POOL_SIZE(pool_class)                                       \
+    (sizeof(struct na_ofi_mem_pool) +                                          \
+        (pool_class)->block_count *                                            \
+            (offsetof(struct na_ofi_mem_node, block) +                         \
+                (pool_class)->block_size))
+
 /* Max tag */
 #define NA_OFI_MAX_TAG UINT32_MAX
 
@@ -177,10 +206,24 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
 #define NA_OFI_UNEXPECTED_TAG (0x100000000ULL)
 #define NA_OFI_TAG_MASK       (0x0FFFFFFFFULL)
 
-/* Number of CQ event provided for fi_cq_read() */
+/* Auto-tuned msg sizes (RxM default buffer size and upper bound) */
+#define NA_OFI_RXM_BUFFER_SIZE   (16384)
+#define NA_OFI_MSG_SIZE_AUTO_MAX (65536)
+
+/* Number of unexpected messages that fit in a multi-recv buffer */
+#define NA_OFI_MULTI_RECV_MSG_COUNT (64)
+
+/* Min number of multi-recv buffers per context when sharing unexpected recvs */
+#define NA_OFI_MULTI_RECV_SHARED_MIN (2)
+
+/* Min/max number of CQ events provided for fi_cq_read() */
 #define NA_OFI_CQ_EVENT_NUM (16)
+#define NA_OFI_CQ_EVENT_MAX (256)
 /* CQ depth (the socket provider's default value is 256 */
 #define NA_OFI_CQ_DEPTH (8192)
+/* Backoff between attempts of retried ops (ns) */
+#define NA_OFI_RETRY_BACKOFF_MIN (1000)
+#define NA_OFI_RETRY_BACKOFF_MAX (1000000)
 /* CQ max err data size (fix to 48 to work around bug in gni provider code) */
 #define NA_OFI_CQ_MAX_ERR_DATA_SIZE (48)
 
@@ -197,14 +240,28 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
 #define NA_OFI_PUT_COMPLETION (FI_COMPLETION | FI_DELIVERY_COMPLETE)
 #define NA_OFI_GET_COMPLETION (FI_COMPLETION)
 
-/* Receive context bits for SEP */
-#define NA_OFI_SEP_RX_CTX_BITS (8)
+/* Transmit CQ binding flags, RMA ops within a batch may not generate
+ * completions if provider can fence operations */
+#define NA_OFI_TX_BIND_FLAGS(fi_prov)                                          \
+    (FI_TRANSMIT | (((fi_prov)->caps & FI_FENCE) ? FI_SELECTIVE_COMPLETION : 0))
+
+/* Receive context bits for SEP (limits the number of contexts) */
+#define NA_OFI_SEP_RX_CTX_BITS (12)
+#define NA_OFI_SEP_RX_CTX_MAX  (1 << NA_OFI_SEP_RX_CTX_BITS)
+
+/* Number of entries in the source address cache (must be a power of 2) */
+#define NA_OFI_ADDR_CACHE_BITS (8)
+#define NA_OFI_ADDR_CACHE_SIZE (1 << NA_OFI_ADDR_CACHE_BITS)
+#define NA_OFI_ADDR_CACHE_IDX(key)                                             \
+    ((unsigned int) (((key) * 0x9E3779B97F4A7C15ULL) >>                        \
+                     (64 - NA_OFI_ADDR_CACHE_BITS)))
 
 /* Op ID status bits */
 #define NA_OFI_OP_COMPLETED (1 << 0)
 #define NA_OFI_OP_CANCELED  (1 << 1)
 #define NA_OFI_OP_QUEUED    (1 << 2)
 #define NA_OFI_OP_ERRORED   (1 << 3)
+#define NA_OFI_OP_UNSIGNALED (1 << 4)
 
 /* Private data access */
 #define NA_OFI_CLASS(na_class)                                                 \
@@ -316,10 +373,32 @@ struct na_ofi_mem_desc {
     } iov;                                     /* Remain last */
 };
 
+/* MR cache entry */
+struct na_ofi_mr_cache_entry {
+    HG_LIST_ENTRY(na_ofi_mr_cache_entry) entry; /* Entry in cache list      */
+    struct fid_mr *fi_mr;                       /* FI MR handle             */
+    char *base;                                 /* Base of region           */
+    size_t len;                                 /* Size of region           */
+    na_uint64_t access;                         /* Access flags             */
+    unsigned int refcount;                      /* Handles using entry      */
+};
+
+/* MR cache (entries are sorted from most to least recently used). Cached
+ * regions stay registered until evicted, buffers must therefore not be freed
+ * or unmapped while the cache is enabled. */
+struct na_ofi_mr_cache {
+    HG_LIST_HEAD(na_ofi_mr_cache_entry) list; /* List of entries          */
+    hg_thread_mutex_t mutex;                  /* Mutex for list           */
+    unsigned int count;                       /* Number of entries        */
+    unsigned int count_max;                   /* Max unused entries kept  */
+};
+
 /* Memory handle */
 struct na_ofi_mem_handle {
-    struct na_ofi_mem_desc desc; /* Memory descriptor        */
-    struct fid_mr *fi_mr;        /* FI MR handle             */
+    struct na_ofi_mem_desc desc;                  /* Memory descriptor   */
+    struct fid_mr *fi_mr;                         /* FI MR handle        */
+    struct na_ofi_mr_cache_entry *mr_cache_entry; /* Cached MR (if any)  */
+    na_bool_t sub; /* MR is owned by parent handle */
 };
 
 /* Msg info */
@@ -333,6 +412,8 @@ struct na_ofi_msg_info {
     na_size_t actual_buf_size;
     fi_addr_t fi_addr;
     na_tag_t tag;
+    struct iovec iov[NA_OFI_IOV_STATIC_MAX]; /* Vector send segments */
+    size_t iovcnt;                           /* 0 if buf is contiguous */
 };
 
 /* RMA info */
@@ -350,6 +431,9 @@ struct na_ofi_rma_info {
     } remote_iov;
     size_t remote_iovcnt;
     void *context;
+    struct na_ofi_op_id *chain; /* Unsignaled ops completed with this one */
+    na_uint64_t operands[2];    /* Atomic operand and compare value */
+    enum fi_op fi_op;           /* Atomic operation */
 };
 
 /* Operation ID */
@@ -370,16 +454,63 @@ struct na_ofi_op_id {
 struct na_ofi_queue {
     hg_thread_mutex_t mutex;
     HG_QUEUE_HEAD(na_ofi_op_id) queue;
+    hg_time_ticks_t retry_ticks;    /* Next attempt (retry queue only) */
+    hg_util_uint64_t retry_backoff; /* Backoff in ns (retry queue only) */
+};
+
+/* Unexpected msg info */
+struct na_ofi_unexpected_info {
+    HG_QUEUE_ENTRY(na_ofi_unexpected_info) entry;
+    struct na_ofi_addr *na_ofi_addr;
+    void *buf;
+    na_size_t buf_size;
+    na_tag_t tag;
+};
+
+/* Unexpected msg queue */
+struct na_ofi_unexpected_msg_queue {
+    HG_QUEUE_HEAD(na_ofi_unexpected_info) queue;
+    hg_thread_spin_t lock;
+};
+
+/* Multi-recv buffer */
+struct na_ofi_mrecv_buf {
+    struct fi_context fi_ctx;             /* Context handle           */
+    struct na_ofi_multi_recv *multi_recv; /* Multi-recv info          */
+    void *buf;                            /* Buffer                   */
+    struct fid_mr *fi_mr;                 /* MR handle                */
+    hg_atomic_int32_t posted;             /* Buffer posted            */
+};
+
+/* Multi-recv info (unexpected messages are copied out of a few large
+ * buffers instead of being received in place) */
+struct na_ofi_multi_recv {
+    struct na_ofi_unexpected_msg_queue unexpected_msg_queue;
+    struct na_ofi_queue unexpected_op_queue;
+    struct na_ofi_multi_recv *queues; /* Queues in use (or self)  */
+    struct na_ofi_mrecv_buf *bufs;    /* Multi-recv buffers       */
+    struct fid_ep *fi_rx;             /* Receive context handle   */
+    na_size_t buf_size;               /* Size of each buffer      */
+    hg_atomic_int32_t unposted_count; /* Buffers to be reposted   */
+    na_uint8_t buf_count;             /* Number of buffers        */
 };
 
 /* Context */
 struct na_ofi_context {
-    struct fid_ep *fi_tx;                /* Transmit context handle  */
-    struct fid_ep *fi_rx;                /* Receive context handle   */
-    struct fid_cq *fi_cq;                /* CQ handle                */
-    struct fid_wait *fi_wait;            /* Wait set handle          */
-    struct na_ofi_queue *retry_op_queue; /* Retry op queue           */
-    na_uint8_t idx;                      /* Context index            */
+    struct fid_ep *fi_tx;                 /* Transmit context handle  */
+    struct fid_ep *fi_rx;                 /* Receive context handle   */
+    struct fid_cq *fi_cq;                 /* CQ handle                */
+    struct fid_ep *fi_rma_tx;             /* RMA transmit context     */
+    struct fid_cq *fi_rma_cq;             /* RMA CQ handle (no wait)  */
+    struct fid_wait *fi_wait;             /* Wait set handle          */
+    struct na_ofi_queue *retry_op_queue;  /* Retry op queue           */
+    struct na_ofi_multi_recv *multi_recv; /* Multi-recv info          */
+    hg_atomic_int32_t cq_event_count;     /* CQ events read at once   */
+    hg_atomic_int32_t rma_count;          /* RMA ops on RMA CQ        */
+    hg_thread_mutex_t batch_mutex;        /* Batch mutex              */
+    struct na_ofi_op_id *batch_op_id;     /* Last op ID held by batch */
+    hg_atomic_int32_t batch_count;        /* Nested batch count       */
+    na_uint16_t idx;                      /* Context index            */
 };
 
 /* Endpoint */
@@ -393,6 +524,16 @@ struct na_ofi_endpoint {
     na_bool_t sep;                       /* Scalable endpoint        */
 };
 
+/* Discovery results shared by processes of a node */
+struct na_ofi_discovery {
+    char key[2 * NA_OFI_MAX_URI_LEN];         /* Init string key          */
+    char path[2 * NA_OFI_MAX_URI_LEN];        /* Cache file path          */
+    char ip[INET_ADDRSTRLEN];                 /* Resolved interface IP    */
+    char domain_name[NA_OFI_MAX_URI_LEN];     /* Resolved domain name     */
+    char fabric_name[NA_OFI_MAX_URI_LEN];     /* Provider fabric name     */
+    char prov_domain_name[NA_OFI_MAX_URI_LEN]; /* Provider domain name    */
+};
+
 /* Domain */
 struct na_ofi_domain {
     hg_thread_mutex_t mutex;            /* Mutex for AV etc         */
@@ -407,11 +548,13 @@ struct na_ofi_domain {
     struct fid_mr *fi_mr;            /* Global MR handle         */
     na_uint64_t fi_mr_key;           /* Global MR key            */
     struct fid_av *fi_av;            /* Address vector handle    */
+    struct na_ofi_mr_cache mr_cache; /* MR cache                 */
     hg_hash_table_t *addr_ht;        /* Address hash_table       */
     char *prov_name;                 /* Provider name            */
     na_size_t context_max;           /* Max contexts available   */
     na_size_t eager_msg_size_max;    /* Max eager msg size       */
     enum na_ofi_prov_type prov_type; /* Provider type            */
+    enum fi_threading threading;     /* Threading model          */
     na_bool_t no_wait;               /* Wait disabled on domain  */
     hg_atomic_int32_t *mr_reg_count; /* Number of MR registered  */
     hg_atomic_int32_t refcount;      /* Refcount of this domain  */
@@ -421,37 +564,58 @@ struct na_ofi_domain {
  * Memory node (points to actual data).
  */
 struct na_ofi_mem_node {
-    HG_QUEUE_ENTRY(na_ofi_mem_node) entry; /* Entry in node_list       */
-    char *block;                           /* Must be last             */
+    struct na_ofi_mem_pool *pool; /* Pool of node (NULL if none) */
+    char *block;                  /* Must be last                */
 };
 
 /**
  * Memory pool. Each pool has a fixed block size, the underlying memory
  * buffer is registered and its MR handle can be passed to fi_tsend/fi_trecv
- * functions.
+ * functions. Free nodes are kept in a lock-free queue.
  */
 struct na_ofi_mem_pool {
-    HG_QUEUE_HEAD(na_ofi_mem_node) node_list; /* Node list               */
-    HG_QUEUE_ENTRY(na_ofi_mem_pool) entry;    /* Entry in pool list      */
+    struct hg_atomic_queue *node_queue;       /* Free nodes              */
+    struct na_ofi_mem_pool *next;             /* Next pool of same class */
+    struct na_ofi_mem_pool_class *pool_class; /* Size class of pool      */
     struct fid_mr *mr_hdl;                    /* MR handle               */
-    na_size_t block_size;                     /* Node block size         */
-    hg_thread_spin_t node_list_lock;          /* Node list lock          */
+};
+
+/**
+ * Pools of a given block size. Pools are only added (at the head of the
+ * list) and are not released until the class is finalized, the list can
+ * therefore be walked without locking.
+ */
+struct na_ofi_mem_pool_class {
+    hg_atomic_int64_t pools;      /* Pool list (struct na_ofi_mem_pool) */
+    hg_atomic_int32_t free_count; /* Free blocks in all pools           */
+    hg_atomic_int32_t growing;    /* A new pool is being registered     */
+    na_size_t block_size;         /* Node block size                    */
+    na_size_t block_count;        /* Number of blocks per pool          */
 };
 
 /* Private data */
 struct na_ofi_class {
+    /* Msg buf pools, one per block size class */
+    struct na_ofi_mem_pool_class buf_pools[NA_OFI_MEM_POOL_CLASS_MAX];
+    /* Source addresses of unexpected messages (each entry holds a ref) */
+    hg_atomic_int64_t addr_cache[NA_OFI_ADDR_CACHE_SIZE];
     hg_thread_mutex_t mutex;                 /* Mutex (for verbs prov)   */
-    HG_QUEUE_HEAD(na_ofi_mem_pool) buf_pool; /* Msg buf pool head        */
     struct na_ofi_domain *domain;            /* Domain pointer           */
     struct na_ofi_endpoint *endpoint;        /* Endpoint pointer         */
-    hg_thread_spin_t buf_pool_lock;          /* Buf pool lock            */
+    struct na_ofi_multi_recv *multi_recv;    /* Multi-recv (shared)      */
+    struct na_op_slab *op_slab;              /* Slab of op IDs           */
     na_size_t unexpected_size_max;           /* Max unexpected size      */
     na_size_t expected_size_max;             /* Max expected size        */
+    na_size_t inject_size_max;               /* Max inject size          */
     na_size_t iov_max;                       /* Max number of IOVs       */
-    na_uint8_t contexts;                     /* Number of context        */
-    na_uint8_t context_max;                  /* Max number of contexts   */
+    na_uint32_t rma_cq_budget;               /* RMA CQ events / progress */
+    na_uint16_t contexts;                    /* Number of context        */
+    na_uint16_t context_max;                 /* Max number of contexts   */
+    na_uint8_t multi_recv_count;             /* Multi-recv buffer count  */
+    na_uint8_t buf_pool_class_count;         /* Number of size classes   */
     na_bool_t no_wait;                       /* Ignore wait object       */
     na_bool_t no_retry;                      /* Do not retry operations  */
+    na_bool_t selective_completion;          /* Unsignaled RMA ops       */
 };
 
 /********************/
@@ -476,6 +640,13 @@ na_ofi_prov_name_to_type(const char *prov_name);
 static NA_INLINE size_t
 na_ofi_prov_addr_size(na_uint32_t addr_format);
 
+/**
+ * Get largest msg size that provider sends without rendezvous.
+ */
+static na_size_t
+na_ofi_prov_msg_size_auto(
+    enum na_ofi_prov_type prov_type, const struct fi_info *fi_info);
+
 /**
  * Domain lock.
  */
@@ -488,6 +659,18 @@ na_ofi_domain_lock(struct na_ofi_domain *domain);
 static NA_INLINE void
 na_ofi_domain_unlock(struct na_ofi_domain *domain);
 
+/**
+ * Lock domain for MR operations (only if domain is not thread safe).
+ */
+static NA_INLINE void
+na_ofi_domain_mr_lock(struct na_ofi_domain *domain);
+
+/**
+ * Unlock domain for MR operations.
+ */
+static NA_INLINE void
+na_ofi_domain_mr_unlock(struct na_ofi_domain *domain);
+
 /**
  * Uses Scalable endpoints (SEP).
  */
@@ -500,6 +683,18 @@ na_ofi_with_sep(const na_class_t *na_class);
 static NA_INLINE na_bool_t
 na_ofi_with_msg_hdr(const na_class_t *na_class);
 
+/**
+ * Unexpected messages are received through multi-recv buffers.
+ */
+static NA_INLINE na_bool_t
+na_ofi_with_multi_recv(const na_class_t *na_class);
+
+/**
+ * Domain can register device memory.
+ */
+static NA_INLINE na_bool_t
+na_ofi_with_hmem(const struct na_ofi_domain *domain);
+
 /**
  * Get provider type encoded in string.
  */
@@ -561,6 +756,15 @@ na_ofi_addr_ht_lookup(struct na_ofi_domain *domain, na_uint32_t addr_format,
     const void *addr, na_size_t addrlen, fi_addr_t *fi_addr,
     na_uint64_t *addr_key);
 
+/**
+ * Lookup count addresses in the hash-table at once. Addresses that do not
+ * already exist are inserted into the AV with a single call.
+ */
+static na_return_t
+na_ofi_addr_ht_lookup_batch(struct na_ofi_domain *domain,
+    na_uint32_t addr_format, struct na_ofi_addr *na_ofi_addrs[],
+    na_size_t count);
+
 /**
  * Remove an addr from the AV and the hash-table.
  */
@@ -576,12 +780,36 @@ na_ofi_av_lookup(struct na_ofi_domain *na_ofi_domain, fi_addr_t fi_addr,
     void **addr_ptr, na_size_t *addrlen_ptr);
 
 /**
- * Get info caps from providers and return matching providers.
+ * Get info caps from providers and return matching providers. Providers can
+ * be narrowed down to the fabric/domain of previous discovery results.
  */
 static na_return_t
-na_ofi_getinfo(enum na_ofi_prov_type prov_type, struct fi_info **providers,
+na_ofi_getinfo(enum na_ofi_prov_type prov_type, na_bool_t multi_recv,
+    na_bool_t mem_device, enum fi_threading threading,
+    const struct na_ofi_discovery *discovery, struct fi_info **providers,
     const char *user_requested_protocol);
 
+/**
+ * Set key and cache file path of discovery results for init parameters.
+ */
+static void
+na_ofi_discovery_init(struct na_ofi_discovery *discovery, const char *dir,
+    const char *protocol_name, const char *host_name, na_bool_t multi_recv,
+    na_bool_t mem_device, enum fi_threading threading);
+
+/**
+ * Load discovery results from node-local cache, return NA_FALSE if there
+ * are none or if they were stored for another key.
+ */
+static na_bool_t
+na_ofi_discovery_load(struct na_ofi_discovery *discovery);
+
+/**
+ * Store discovery results so that other processes can skip discovery.
+ */
+static void
+na_ofi_discovery_store(const struct na_ofi_discovery *discovery);
+
 /**
  * Check and resolve interfaces from hostname.
  */
@@ -617,7 +845,9 @@ na_ofi_gni_get_domain_op_value(
  */
 static na_return_t
 na_ofi_domain_open(enum na_ofi_prov_type prov_type, const char *domain_name,
-    const char *auth_key, na_bool_t no_wait,
+    const char *auth_key, na_bool_t no_wait, na_bool_t multi_recv,
+    na_bool_t mem_device, enum fi_threading threading,
+    unsigned int mr_cache_max, const struct na_ofi_discovery *discovery,
     struct na_ofi_domain **na_ofi_domain_p);
 
 /**
@@ -632,7 +862,8 @@ na_ofi_domain_close(struct na_ofi_domain *na_ofi_domain);
 static na_return_t
 na_ofi_endpoint_open(const struct na_ofi_domain *na_ofi_domain,
     const char *node, void *src_addr, na_size_t src_addrlen, na_bool_t no_wait,
-    na_uint8_t max_contexts, struct na_ofi_endpoint **na_ofi_endpoint_p);
+    na_uint16_t max_contexts, na_bool_t rma_tx,
+    struct na_ofi_endpoint **na_ofi_endpoint_p);
 
 /**
  * Open basic endpoint.
@@ -654,6 +885,48 @@ na_ofi_sep_open(const struct na_ofi_domain *na_ofi_domain,
 static na_return_t
 na_ofi_endpoint_close(struct na_ofi_endpoint *na_ofi_endpoint);
 
+/**
+ * Allocate multi-recv buffers for receive context. If \buf_count is 0, only
+ * unexpected queues are created so that they can be shared.
+ */
+static na_return_t
+na_ofi_multi_recv_create(na_class_t *na_class, struct fid_ep *fi_rx,
+    na_uint8_t buf_count, struct na_ofi_multi_recv **multi_recv_p);
+
+/**
+ * Free multi-recv buffers and drop unexpected messages that were not
+ * consumed. Receive context must have been closed.
+ */
+static void
+na_ofi_multi_recv_destroy(
+    na_class_t *na_class, struct na_ofi_multi_recv *multi_recv);
+
+/**
+ * Post all multi-recv buffers.
+ */
+static na_return_t
+na_ofi_multi_recv_post(struct na_ofi_multi_recv *multi_recv);
+
+/**
+ * Repost multi-recv buffers that could not be posted previously.
+ */
+static na_return_t
+na_ofi_multi_recv_repost(struct na_ofi_multi_recv *multi_recv);
+
+/**
+ * Post multi-recv buffer.
+ */
+static na_return_t
+na_ofi_mrecv_buf_post(struct na_ofi_mrecv_buf *mrecv_buf);
+
+/**
+ * Match unexpected recv op ID against messages already received in
+ * multi-recv buffers, queue it otherwise.
+ */
+static na_return_t
+na_ofi_multi_recv_match(
+    struct na_ofi_multi_recv *multi_recv, struct na_ofi_op_id *na_ofi_op_id);
+
 /**
  * Get EP address.
  */
@@ -700,7 +973,7 @@ na_ofi_addr_decref(struct na_ofi_addr *na_ofi_addr);
  */
 static struct na_ofi_mem_pool *
 na_ofi_mem_pool_create(
-    na_class_t *na_class, na_size_t block_size, na_size_t block_count);
+    na_class_t *na_class, struct na_ofi_mem_pool_class *pool_class);
 
 /**
  * Destroy memory pool.
@@ -709,6 +982,40 @@ static void
 na_ofi_mem_pool_destroy(
     na_class_t *na_class, struct na_ofi_mem_pool *na_ofi_mem_pool);
 
+/**
+ * Fill next resource stats entry (if there is room left) and count it.
+ */
+static void
+na_ofi_resource_stats_set(struct na_resource_stats *stats,
+    na_uint32_t max_count, na_uint32_t *count, const char *name,
+    na_uint64_t used, na_uint64_t max);
+
+/**
+ * Register a new pool for size class (unless another thread already does).
+ */
+static na_return_t
+na_ofi_mem_pool_grow(
+    na_class_t *na_class, struct na_ofi_mem_pool_class *pool_class);
+
+/**
+ * Set up size classes and register initial pools for msg sizes.
+ */
+static na_return_t
+na_ofi_mem_pool_init(na_class_t *na_class, na_size_t unexpected_size,
+    na_size_t expected_size);
+
+/**
+ * Get smallest size class that fits size (NULL if none).
+ */
+static NA_INLINE struct na_ofi_mem_pool_class *
+na_ofi_mem_pool_get_class(struct na_ofi_class *priv, na_size_t size);
+
+/**
+ * Release all pools.
+ */
+static void
+na_ofi_mem_pool_finalize(na_class_t *na_class);
+
 /**
  * Allocate memory pool and register memory.
  */
@@ -726,16 +1033,54 @@ na_ofi_mem_pool_free(
 #endif
 
 /**
- * Allocate memory for transfers.
+ * Allocate memory for transfers. Large long-lived buffers (pools, multi-recv
+ * buffers) set \huge to be backed by huge pages when possible, which reduces
+ * TLB and NIC translation misses.
  */
 static NA_INLINE void *
-na_ofi_mem_alloc(na_class_t *na_class, na_size_t size, struct fid_mr **mr_hdl);
+na_ofi_mem_alloc(na_class_t *na_class, na_size_t size, na_bool_t huge,
+    struct fid_mr **mr_hdl);
 
 /**
- * Free memory.
+ * Free memory. \huge_size is the size that was allocated with \huge set, 0
+ * otherwise.
  */
 static NA_INLINE void
-na_ofi_mem_free(na_class_t *na_class, void *mem_ptr, struct fid_mr *mr_hdl);
+na_ofi_mem_free(na_class_t *na_class, void *mem_ptr, na_size_t huge_size,
+    struct fid_mr *mr_hdl);
+
+/**
+ * Look up cached registration that covers iov or register new one.
+ */
+static na_return_t
+na_ofi_mr_cache_get(struct na_ofi_domain *domain, const struct iovec *iov,
+    na_uint64_t access, struct na_ofi_mr_cache_entry **mr_entry_p);
+
+/**
+ * Release cached registration.
+ */
+static void
+na_ofi_mr_cache_put(
+    struct na_ofi_domain *domain, struct na_ofi_mr_cache_entry *mr_entry);
+
+/**
+ * Remove least recently used entry if cache exceeds its size.
+ */
+static NA_INLINE struct na_ofi_mr_cache_entry *
+na_ofi_mr_cache_evict(struct na_ofi_mr_cache *mr_cache);
+
+/**
+ * Deregister and free cache entry.
+ */
+static void
+na_ofi_mr_cache_entry_free(
+    struct na_ofi_domain *domain, struct na_ofi_mr_cache_entry *mr_entry);
+
+/**
+ * Deregister all cached regions.
+ */
+static void
+na_ofi_mr_cache_purge(struct na_ofi_domain *domain);
 
 /**
  * Get IOV index and offset pair from an absolute offset.
@@ -781,14 +1126,14 @@ na_ofi_rma(na_class_t *na_class, na_context_t *context, na_cb_type_t op,
     na_offset_t local_offset,
     struct na_ofi_mem_handle *na_ofi_mem_handle_remote,
     na_offset_t remote_offset, na_size_t length,
-    struct na_ofi_addr *na_ofi_addr, na_uint8_t remote_id,
+    struct na_ofi_addr *na_ofi_addr, na_uint16_t remote_id,
     struct na_ofi_op_id *na_ofi_op_id);
 
 /**
  * Read from CQ.
  */
 static na_return_t
-na_ofi_cq_read(na_context_t *context, size_t max_count,
+na_ofi_cq_read(na_context_t *context, struct fid_cq *cq_hdl, size_t max_count,
     struct fi_cq_tagged_entry cq_events[], fi_addr_t src_addrs[],
     void **src_err_addr, size_t *src_err_addrlen, size_t *actual_count);
 
@@ -814,6 +1159,73 @@ na_ofi_cq_process_recv_unexpected_event(na_class_t *na_class,
     struct na_ofi_op_id *na_ofi_op_id, fi_addr_t src_addr, void *src_err_addr,
     size_t src_err_addrlen, uint64_t tag, size_t len);
 
+/**
+ * Resolve source address of unexpected message.
+ */
+static na_return_t
+na_ofi_cq_get_src_addr(na_class_t *na_class, fi_addr_t src_addr,
+    void *src_err_addr, size_t src_err_addrlen, const void *msg_buf,
+    struct na_ofi_addr **na_ofi_addr_p);
+
+/**
+ * Get a reference to the cached source address that matches key, either
+ * its fi_addr or its hash-table key. Entries are claimed by swapping them
+ * out of the cache so that no lock is needed.
+ */
+static struct na_ofi_addr *
+na_ofi_addr_cache_get(
+    struct na_ofi_class *priv, na_uint64_t key, na_bool_t by_fi_addr);
+
+/**
+ * Cache source address under key, replacing any previous entry.
+ */
+static void
+na_ofi_addr_cache_put(struct na_ofi_class *priv, na_uint64_t key,
+    struct na_ofi_addr *na_ofi_addr);
+
+/**
+ * Remove address from the cache if present.
+ */
+static void
+na_ofi_addr_cache_evict(
+    struct na_ofi_class *priv, struct na_ofi_addr *na_ofi_addr);
+
+/**
+ * Release all cached addresses.
+ */
+static void
+na_ofi_addr_cache_flush(struct na_ofi_class *priv);
+
+/**
+ * Event on multi-recv buffer.
+ */
+static NA_INLINE na_bool_t
+na_ofi_cq_is_multi_recv_event(uint64_t flags);
+
+/**
+ * Multi-recv buffer events.
+ */
+static na_return_t
+na_ofi_cq_process_multi_recv_event(na_class_t *na_class,
+    const struct fi_cq_tagged_entry *cq_event, fi_addr_t src_addr,
+    void *src_err_addr, size_t src_err_addrlen);
+
+/**
+ * Unexpected message received in multi-recv buffer. Message is copied to the
+ * first posted op ID or queued until an op ID is posted.
+ */
+static na_return_t
+na_ofi_cq_process_multi_recv_msg(na_class_t *na_class,
+    struct na_ofi_multi_recv *multi_recv,
+    const struct fi_cq_tagged_entry *cq_event, fi_addr_t src_addr,
+    void *src_err_addr, size_t src_err_addrlen);
+
+/**
+ * Multi-recv buffer error events.
+ */
+static void
+na_ofi_cq_process_multi_recv_error(const struct fi_cq_err_entry *cq_err);
+
 /**
  * Recv expected operation events.
  */
@@ -828,10 +1240,89 @@ static NA_INLINE na_return_t
 na_ofi_cq_process_rma_event(struct na_ofi_op_id *na_ofi_op_id);
 
 /**
- * Process retries.
+ * Process retries once their backoff has expired.
+ */
+static na_return_t
+na_ofi_cq_process_retries(na_class_t *na_class, na_context_t *context);
+
+/**
+ * Delay next retry, doubling the backoff. Must be called with the retry
+ * queue mutex held.
+ */
+static NA_INLINE void
+na_ofi_retry_backoff(struct na_ofi_queue *retry_op_queue);
+
+/**
+ * Signal CQ to wake up context waiting on it.
+ */
+static na_return_t
+na_ofi_cq_signal(na_class_t *na_class, struct na_ofi_context *ctx);
+
+/**
+ * Post send or RMA operation with flags (used for operations held by
+ * batches). RMA operations that are not signaled do not generate a CQ entry.
+ */
+static ssize_t
+na_ofi_op_post(na_class_t *na_class, struct na_ofi_context *ctx,
+    struct na_ofi_op_id *na_ofi_op_id, na_uint64_t flags, na_bool_t signaled);
+
+/**
+ * Post atomic operation (fetching the previous value into the local IOV).
+ */
+static ssize_t
+na_ofi_atomic_post(
+    struct na_ofi_context *ctx, struct na_ofi_op_id *na_ofi_op_id);
+
+/**
+ * Check whether an RMA op can complete without a CQ entry, the next RMA op
+ * being fenced and completing it.
+ */
+static NA_INLINE na_bool_t
+na_ofi_op_chainable(na_class_t *na_class,
+    const struct na_ofi_op_id *na_ofi_op_id,
+    const struct na_ofi_op_id *next_op_id);
+
+/**
+ * Transmit context that operation is posted to, RMA ops use their own
+ * context when RMA completions are separated from messages.
+ */
+static NA_INLINE struct fid_ep *
+na_ofi_op_tx(
+    const struct na_ofi_context *ctx, const struct na_ofi_op_id *na_ofi_op_id);
+
+/**
+ * Hold operation if a batch is in progress on context, the operation that
+ * was previously held is then posted with FI_MORE.
+ */
+static na_bool_t
+na_ofi_op_batch_hold(na_class_t *na_class, struct na_ofi_context *ctx,
+    struct na_ofi_op_id *na_ofi_op_id);
+
+/**
+ * Send buf followed by segments. Segments are passed to the provider as an
+ * IOV when it does not require local descriptors, otherwise they are gathered
+ * into buf and the message is sent as a contiguous buffer.
  */
 static na_return_t
-na_ofi_cq_process_retries(na_context_t *context);
+na_ofi_msg_sendv(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg, void *buf,
+    na_size_t buf_size, void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id);
+
+/**
+ * Post operation held by batch if any (batch mutex must be held). If
+ * next_op_id is not NULL, it becomes the next held operation.
+ */
+static void
+na_ofi_op_batch_flush(na_class_t *na_class, struct na_ofi_context *ctx,
+    struct na_ofi_op_id *next_op_id);
+
+/**
+ * Complete unsignaled operations that were chained to an operation.
+ */
+static void
+na_ofi_complete_chain(struct na_ofi_op_id *chain, na_return_t cb_ret);
 
 /**
  * Complete operation ID.
@@ -864,7 +1355,7 @@ na_ofi_finalize(na_class_t *na_class);
 
 /* context_create */
 static na_return_t
-na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id);
+na_ofi_context_create(na_class_t *na_class, void **context, na_uint16_t id);
 
 /* context_destroy */
 static na_return_t
@@ -882,6 +1373,11 @@ na_ofi_op_destroy(na_class_t *na_class, na_op_id_t *op_id);
 static na_return_t
 na_ofi_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr);
 
+/* addr_lookup_batch */
+static na_return_t
+na_ofi_addr_lookup_batch(na_class_t *na_class, const char *const names[],
+    na_size_t count, na_addr_t addrs[]);
+
 /* addr_free */
 static NA_INLINE na_return_t
 na_ofi_addr_free(na_class_t *na_class, na_addr_t addr);
@@ -925,6 +1421,11 @@ static na_return_t
 na_ofi_addr_deserialize(
     na_class_t *na_class, na_addr_t *addr, const void *buf, na_size_t buf_size);
 
+/* addr_deserialize_batch */
+static na_return_t
+na_ofi_addr_deserialize_batch(na_class_t *na_class, const void *buf,
+    na_size_t entry_size, na_size_t count, na_addr_t addrs[]);
+
 /* msg_get_max_unexpected_size */
 static NA_INLINE na_size_t
 na_ofi_msg_get_max_unexpected_size(const na_class_t *na_class);
@@ -957,9 +1458,17 @@ na_ofi_msg_init_unexpected(na_class_t *na_class, void *buf, na_size_t buf_size);
 static na_return_t
 na_ofi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
+/* msg_send_unexpectedv */
+static na_return_t
+na_ofi_msg_send_unexpectedv(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id);
+
 /* msg_recv_unexpected */
 static na_return_t
 na_ofi_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
@@ -970,14 +1479,22 @@ na_ofi_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
 static na_return_t
 na_ofi_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
+/* msg_send_expectedv */
+static na_return_t
+na_ofi_msg_send_expectedv(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id);
+
 /* msg_recv_expected */
 static na_return_t
 na_ofi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t source_addr, na_uint8_t source_id,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
     na_tag_t tag, na_op_id_t *op_id);
 
 /* mem_handle */
@@ -1002,6 +1519,10 @@ na_ofi_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle);
 static na_return_t
 na_ofi_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle);
 
+static na_return_t
+na_ofi_mem_register_attr(na_class_t *na_class, na_mem_handle_t mem_handle,
+    na_mem_type_t mem_type, na_uint64_t device);
+
 /* mem_handle serialization */
 static NA_INLINE na_size_t
 na_ofi_mem_handle_get_serialize_size(
@@ -1020,7 +1541,7 @@ static na_return_t
 na_ofi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
 /* get */
@@ -1028,9 +1549,17 @@ static na_return_t
 na_ofi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
+/* atomic */
+static na_return_t
+na_ofi_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare,
+    na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t remote_addr, na_uint16_t remote_id, na_op_id_t *op_id);
+
 /* poll_get_fd */
 static NA_INLINE int
 na_ofi_poll_get_fd(na_class_t *na_class, na_context_t *context);
@@ -1048,6 +1577,25 @@ na_ofi_progress(
 static na_return_t
 na_ofi_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id);
 
+/* get_resource_stats */
+static na_return_t
+na_ofi_get_resource_stats(
+    na_class_t *na_class, struct na_resource_stats *stats, na_uint32_t *count);
+
+/* mem_handle_create_sub */
+static na_return_t
+na_ofi_mem_handle_create_sub(na_class_t *na_class,
+    na_mem_handle_t parent_handle, void *buf, na_size_t buf_size,
+    unsigned long flags, na_mem_handle_t *mem_handle);
+
+/* op_batch_begin */
+static na_return_t
+na_ofi_op_batch_begin(na_class_t *na_class, na_context_t *context);
+
+/* op_batch_end */
+static na_return_t
+na_ofi_op_batch_end(na_class_t *na_class, na_context_t *context);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -1063,8 +1611,10 @@ const struct na_class_ops NA_PLUGIN_OPS(ofi) = {
     na_ofi_op_create,                      /* op_create */
     na_ofi_op_destroy,                     /* op_destroy */
     na_ofi_addr_lookup,                    /* addr_lookup */
+    na_ofi_addr_lookup_batch,              /* addr_lookup_batch */
     na_ofi_addr_free,                      /* addr_free */
     na_ofi_addr_set_remove,                /* addr_set_remove */
+    NULL,                                  /* addr_warmup */
     na_ofi_addr_self,                      /* addr_self */
     na_ofi_addr_dup,                       /* addr_dup */
     na_ofi_addr_cmp,                       /* addr_cmp */
@@ -1073,6 +1623,7 @@ const struct na_class_ops NA_PLUGIN_OPS(ofi) = {
     na_ofi_addr_get_serialize_size,        /* addr_get_serialize_size */
     na_ofi_addr_serialize,                 /* addr_serialize */
     na_ofi_addr_deserialize,               /* addr_deserialize */
+    na_ofi_addr_deserialize_batch,         /* addr_deserialize_batch */
     na_ofi_msg_get_max_unexpected_size,    /* msg_get_max_unexpected_size */
     na_ofi_msg_get_max_expected_size,      /* msg_get_max_expected_size */
     na_ofi_msg_get_unexpected_header_size, /* msg_get_unexpected_header_size */
@@ -1082,9 +1633,11 @@ const struct na_class_ops NA_PLUGIN_OPS(ofi) = {
     na_ofi_msg_buf_free,                   /* msg_buf_free */
     na_ofi_msg_init_unexpected,            /* msg_init_unexpected */
     na_ofi_msg_send_unexpected,            /* msg_send_unexpected */
+    na_ofi_msg_send_unexpectedv,           /* msg_send_unexpectedv */
     na_ofi_msg_recv_unexpected,            /* msg_recv_unexpected */
     NULL,                                  /* msg_init_expected */
     na_ofi_msg_send_expected,              /* msg_send_expected */
+    na_ofi_msg_send_expectedv,             /* msg_send_expectedv */
     na_ofi_msg_recv_expected,              /* msg_recv_expected */
     na_ofi_mem_handle_create,              /* mem_handle_create */
     na_ofi_mem_handle_create_segments,     /* mem_handle_create_segment */
@@ -1100,7 +1653,13 @@ const struct na_class_ops NA_PLUGIN_OPS(ofi) = {
     na_ofi_poll_get_fd,                    /* poll_get_fd */
     na_ofi_poll_try_wait,                  /* poll_try_wait */
     na_ofi_progress,                       /* progress */
-    na_ofi_cancel                          /* cancel */
+    na_ofi_cancel,                         /* cancel */
+    na_ofi_get_resource_stats,             /* get_resource_stats */
+    na_ofi_mem_handle_create_sub,          /* mem_handle_create_sub */
+    na_ofi_op_batch_begin,                 /* op_batch_begin */
+    na_ofi_op_batch_end,                   /* op_batch_end */
+    na_ofi_mem_register_attr,              /* mem_register_attr */
+    na_ofi_atomic                          /* atomic */
 };
 
 /* OFI access domain list */
@@ -1224,11 +1783,34 @@ na_ofi_prov_addr_size(na_uint32_t addr_format)
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static na_size_t
+na_ofi_prov_msg_size_auto(
+    enum na_ofi_prov_type prov_type, const struct fi_info *fi_info)
+{
+    na_size_t msg_size = NA_OFI_MSG_SIZE_AUTO_MAX;
+
+    if (prov_type == NA_OFI_PROV_TCP || prov_type == NA_OFI_PROV_VERBS) {
+        /* RxM switches to rendezvous past its buffer size */
+        const char *env = getenv("FI_OFI_RXM_BUFFER_SIZE");
+
+        msg_size = (env != NULL) ? (na_size_t) strtoul(env, NULL, 10)
+                                 : NA_OFI_RXM_BUFFER_SIZE;
+    }
+    if (fi_info->ep_attr->max_msg_size < msg_size)
+        msg_size = (na_size_t) fi_info->ep_attr->max_msg_size;
+    if (fi_info->tx_attr->inject_size > msg_size)
+        msg_size = (na_size_t) fi_info->tx_attr->inject_size;
+
+    return MAX(msg_size, NA_OFI_MSG_SIZE);
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
 na_ofi_domain_lock(struct na_ofi_domain *domain)
 {
-    if (na_ofi_prov_flags[domain->prov_type] & NA_OFI_DOMAIN_LOCK)
+    if ((na_ofi_prov_flags[domain->prov_type] & NA_OFI_DOMAIN_LOCK) ||
+        domain->threading != FI_THREAD_SAFE)
         hg_thread_mutex_lock(&domain->mutex);
 }
 
@@ -1236,7 +1818,25 @@ na_ofi_domain_lock(struct na_ofi_domain *domain)
 static NA_INLINE void
 na_ofi_domain_unlock(struct na_ofi_domain *domain)
 {
-    if (na_ofi_prov_flags[domain->prov_type] & NA_OFI_DOMAIN_LOCK)
+    if ((na_ofi_prov_flags[domain->prov_type] & NA_OFI_DOMAIN_LOCK) ||
+        domain->threading != FI_THREAD_SAFE)
+        hg_thread_mutex_unlock(&domain->mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ofi_domain_mr_lock(struct na_ofi_domain *domain)
+{
+    /* MRs are domain objects, they can be registered from any thread */
+    if (domain->threading != FI_THREAD_SAFE)
+        hg_thread_mutex_lock(&domain->mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ofi_domain_mr_unlock(struct na_ofi_domain *domain)
+{
+    if (domain->threading != FI_THREAD_SAFE)
         hg_thread_mutex_unlock(&domain->mutex);
 }
 
@@ -1259,7 +1859,26 @@ na_ofi_with_msg_hdr(const na_class_t *na_class)
 }
 
 /*---------------------------------------------------------------------------*/
-static NA_INLINE enum na_ofi_prov_type
+static NA_INLINE na_bool_t
+na_ofi_with_multi_recv(const na_class_t *na_class)
+{
+    return (NA_OFI_CLASS(na_class)->multi_recv_count > 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_bool_t
+na_ofi_with_hmem(const struct na_ofi_domain *domain)
+{
+#ifdef FI_HMEM
+    return (domain->fi_prov->caps & FI_HMEM) ? NA_TRUE : NA_FALSE;
+#else
+    (void) domain;
+    return NA_FALSE;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE enum na_ofi_prov_type
 na_ofi_addr_prov(const char *str)
 {
     char fmt[19];
@@ -1659,6 +2278,133 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_addr_ht_lookup_batch(struct na_ofi_domain *domain,
+    na_uint32_t addr_format, struct na_ofi_addr *na_ofi_addrs[],
+    na_size_t count)
+{
+    na_size_t *misses = NULL;
+    fi_addr_t *fi_addrs = NULL;
+    char *av_buf = NULL;
+    na_size_t addrlen, miss_count = 0, i;
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    /* Generate keys */
+    for (i = 0; i < count; i++) {
+        na_ofi_addrs[i]->ht_key = na_ofi_addr_to_key(
+            addr_format, na_ofi_addrs[i]->addr, na_ofi_addrs[i]->addrlen);
+        NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addrs[i]->ht_key == 0, out, ret,
+            NA_PROTONOSUPPORT, "Could not generate key from addr");
+    }
+
+    misses = (na_size_t *) malloc(count * sizeof(*misses));
+    NA_CHECK_SUBSYS_ERROR(addr, misses == NULL, out, ret, NA_NOMEM,
+        "Could not allocate array of indices");
+
+    /* Lookup keys, only take the read lock once for the whole batch */
+    hg_thread_rwlock_rdlock(&domain->rwlock);
+    for (i = 0; i < count; i++) {
+        hg_hash_table_value_t ht_value = hg_hash_table_lookup(
+            domain->addr_ht, (hg_hash_table_key_t) &na_ofi_addrs[i]->ht_key);
+
+        if (ht_value != HG_HASH_TABLE_NULL)
+            na_ofi_addrs[i]->fi_addr = *(fi_addr_t *) ht_value;
+        else
+            misses[miss_count++] = i;
+    }
+    hg_thread_rwlock_release_rdlock(&domain->rwlock);
+
+    if (miss_count == 0)
+        goto out;
+
+    /* fi_av_insert() takes a contiguous array of native addresses */
+    addrlen = na_ofi_addrs[misses[0]]->addrlen;
+    av_buf = (char *) malloc(miss_count * addrlen);
+    NA_CHECK_SUBSYS_ERROR(addr, av_buf == NULL, out, ret, NA_NOMEM,
+        "Could not allocate AV insert buffer");
+    fi_addrs = (fi_addr_t *) malloc(miss_count * sizeof(*fi_addrs));
+    NA_CHECK_SUBSYS_ERROR(addr, fi_addrs == NULL, out, ret, NA_NOMEM,
+        "Could not allocate array of FI addrs");
+    for (i = 0; i < miss_count; i++) {
+        struct na_ofi_addr *na_ofi_addr = na_ofi_addrs[misses[i]];
+
+        NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addr->addrlen != addrlen, out, ret,
+            NA_PROTOCOL_ERROR, "Addr len (%zu) does not match (%zu)",
+            (size_t) na_ofi_addr->addrlen, (size_t) addrlen);
+        memcpy(av_buf + i * addrlen, na_ofi_addr->addr, addrlen);
+        fi_addrs[i] = FI_ADDR_NOTAVAIL;
+    }
+
+    /* Insert all missing addrs into AV at once */
+    na_ofi_domain_lock(domain);
+    rc = fi_av_insert(
+        domain->fi_av, av_buf, miss_count, fi_addrs, 0 /* flags */, NULL);
+    na_ofi_domain_unlock(domain);
+    NA_CHECK_SUBSYS_ERROR(addr, rc < 0, out, ret, na_ofi_errno_to_na(-rc),
+        "fi_av_insert() failed, rc: %d (%s)", rc, fi_strerror(-rc));
+
+    hg_thread_rwlock_wrlock(&domain->rwlock);
+    for (i = 0; i < miss_count; i++) {
+        struct na_ofi_addr *na_ofi_addr = na_ofi_addrs[misses[i]];
+        hg_hash_table_key_t ht_key = NULL;
+        hg_hash_table_value_t ht_value = NULL;
+
+        /* Keep going so that inserted addrs are not left unpublished */
+        if (fi_addrs[i] == FI_ADDR_NOTAVAIL) {
+            NA_LOG_SUBSYS_ERROR(addr, "fi_av_insert() failed for %s",
+                na_ofi_addr->uri);
+            ret = NA_ADDRNOTAVAIL;
+            continue;
+        }
+        na_ofi_addr->fi_addr = fi_addrs[i];
+
+        /* Same race condition as na_ofi_addr_ht_lookup(), this also covers
+         * duplicate keys within the same batch */
+        ht_value = hg_hash_table_lookup(
+            domain->addr_ht, (hg_hash_table_key_t) &na_ofi_addr->ht_key);
+        if (ht_value != HG_HASH_TABLE_NULL) {
+            if (*(fi_addr_t *) ht_value != fi_addrs[i]) {
+                rc = fi_av_remove(domain->fi_av, &fi_addrs[i], 1, 0);
+                NA_CHECK_SUBSYS_WARNING(addr, rc != 0,
+                    "fi_av_remove() failed, rc: %d (%s)", rc,
+                    fi_strerror(-rc));
+            }
+            na_ofi_addr->fi_addr = *(fi_addr_t *) ht_value;
+            continue;
+        }
+
+        ht_key = malloc(sizeof(na_uint64_t));
+        ht_value = malloc(sizeof(fi_addr_t));
+        if (ht_key == NULL || ht_value == NULL) {
+            NA_LOG_SUBSYS_ERROR(addr, "Cannot allocate memory for ht entry");
+            free(ht_key);
+            free(ht_value);
+            ret = NA_NOMEM;
+            continue;
+        }
+        *((na_uint64_t *) ht_key) = na_ofi_addr->ht_key;
+        *((fi_addr_t *) ht_value) = na_ofi_addr->fi_addr;
+
+        rc = hg_hash_table_insert(domain->addr_ht, ht_key, ht_value);
+        if (rc == 0) {
+            NA_LOG_SUBSYS_ERROR(addr, "hg_hash_table_insert() failed");
+            free(ht_key);
+            free(ht_value);
+            ret = NA_NOMEM;
+        }
+    }
+    hg_thread_rwlock_release_wrlock(&domain->rwlock);
+
+out:
+    free(misses);
+    free(av_buf);
+    free(fi_addrs);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_addr_ht_remove(
@@ -1805,7 +2551,9 @@ na_ofi_provider_check(
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ofi_getinfo(enum na_ofi_prov_type prov_type, struct fi_info **providers,
+na_ofi_getinfo(enum na_ofi_prov_type prov_type, na_bool_t multi_recv,
+    na_bool_t mem_device, enum fi_threading threading,
+    const struct na_ofi_discovery *discovery, struct fi_info **providers,
     const char *user_requested_protocol)
 {
     struct fi_info *hints = NULL;
@@ -1841,6 +2589,23 @@ na_ofi_getinfo(enum na_ofi_prov_type prov_type, struct fi_info **providers,
     /* add any additional caps that are particular to this provider */
     hints->caps |= na_ofi_prov_extra_caps[prov_type];
 
+    /* Multi-recv buffers can only be posted as untagged receives, the tag of
+     * unexpected messages is then passed as remote CQ data */
+    if (multi_recv) {
+        hints->caps |= FI_MSG | FI_MULTI_RECV;
+        hints->domain_attr->cq_data_size = sizeof(na_uint32_t);
+    }
+
+    /* Device memory must be registered with its interface and device */
+    if (mem_device) {
+#ifdef FI_HMEM
+        hints->caps |= FI_HMEM;
+#else
+        NA_GOTO_SUBSYS_ERROR(cls, cleanup, ret, NA_OPNOTSUPPORTED,
+            "Device memory requires libfabric with FI_HMEM support");
+#endif
+    }
+
     /**
      * msg_order: guarantee that messages with same tag are ordered.
      * (FI_ORDER_SAS - Send after send. If set, message send operations,
@@ -1854,8 +2619,9 @@ na_ofi_getinfo(enum na_ofi_prov_type prov_type, struct fi_info **providers,
     hints->tx_attr->op_flags = FI_INJECT_COMPLETE | FI_COMPLETION;
     hints->rx_attr->op_flags = FI_COMPLETION;
 
-    /* all providers should support this */
-    hints->domain_attr->threading = FI_THREAD_SAFE;
+    /* all providers should support FI_THREAD_SAFE, relaxed models let providers
+     * skip internal locking when each context is progressed by one thread */
+    hints->domain_attr->threading = threading;
     hints->domain_attr->av_type = FI_AV_MAP;
     hints->domain_attr->resource_mgmt = FI_RM_ENABLED;
 
@@ -1874,17 +2640,29 @@ na_ofi_getinfo(enum na_ofi_prov_type prov_type, struct fi_info **providers,
     if (prov_type == NA_OFI_PROV_SOCKETS)
         hints->ep_attr->protocol = FI_PROTO_SOCK_TCP;
 
+    /* Only query the fabric/domain that was previously selected */
+    if (discovery && discovery->fabric_name[0] != '\0') {
+        hints->fabric_attr->name = strdup(discovery->fabric_name);
+        NA_CHECK_SUBSYS_ERROR(cls, hints->fabric_attr->name == NULL, cleanup,
+            ret, NA_NOMEM, "Could not duplicate fabric name");
+    }
+    if (discovery && discovery->prov_domain_name[0] != '\0') {
+        hints->domain_attr->name = strdup(discovery->prov_domain_name);
+        NA_CHECK_SUBSYS_ERROR(cls, hints->domain_attr->name == NULL, cleanup,
+            ret, NA_NOMEM, "Could not duplicate domain name");
+    }
+
     /**
      * fi_getinfo:  returns information about fabric services.
      * Pass NULL for name/service to list all providers supported with above
      * requirement hints.
      */
-    rc = fi_getinfo(NA_OFI_VERSION, /* OFI version requested */
-        NULL,                       /* Optional name or fabric to resolve */
-        NULL,                       /* Optional service name to request */
-        0ULL,                       /* Optional flag */
-        hints,                      /* In: Hints to filter providers */
-        providers);                 /* Out: List of matching providers */
+    rc = fi_getinfo(NA_OFI_GETINFO_VERSION(hints->caps), /* OFI version */
+        NULL,       /* Optional name or fabric to resolve */
+        NULL,       /* Optional service name to request */
+        0ULL,       /* Optional flag */
+        hints,      /* In: Hints to filter providers */
+        providers); /* Out: List of matching providers */
     if (rc != 0) {
         /* getinfo failed.  This could be because Mercury was
          * linked against a libfabric library that was not compiled with
@@ -1899,12 +2677,134 @@ na_ofi_getinfo(enum na_ofi_prov_type prov_type, struct fi_info **providers,
 cleanup:
     free(hints->fabric_attr->prov_name);
     hints->fabric_attr->prov_name = NULL;
+    free(hints->fabric_attr->name);
+    hints->fabric_attr->name = NULL;
+    free(hints->domain_attr->name);
+    hints->domain_attr->name = NULL;
     fi_freeinfo(hints);
 
 out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_discovery_init(struct na_ofi_discovery *discovery, const char *dir,
+    const char *protocol_name, const char *host_name, na_bool_t multi_recv,
+    na_bool_t mem_device, enum fi_threading threading)
+{
+    na_uint64_t hash = 14695981039346656037ULL; /* FNV-1a */
+    const char *ptr;
+    int len;
+
+    memset(discovery, 0, sizeof(*discovery));
+
+    /* Port is not part of the key, processes of a node use different ports */
+    len = snprintf(discovery->key, sizeof(discovery->key),
+        "%s;%.*s;%d;%d;%d", protocol_name,
+        (int) strcspn(host_name ? host_name : "", ":"),
+        host_name ? host_name : "", (int) multi_recv, (int) mem_device,
+        (int) threading);
+    if (len < 0 || (size_t) len >= sizeof(discovery->key)) {
+        discovery->key[0] = '\0';
+        return;
+    }
+
+    for (ptr = discovery->key; *ptr != '\0'; ptr++) {
+        hash ^= (unsigned char) *ptr;
+        hash *= 1099511628211ULL;
+    }
+
+    len = snprintf(discovery->path, sizeof(discovery->path),
+        "%s/na_ofi_%d_%016" PRIx64, dir, (int) getuid(), hash);
+    if (len < 0 || (size_t) len >= sizeof(discovery->path))
+        discovery->path[0] = '\0';
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_ofi_discovery_load(struct na_ofi_discovery *discovery)
+{
+    char line[3 * NA_OFI_MAX_URI_LEN];
+    na_bool_t key_match = NA_FALSE;
+    FILE *file;
+
+    if (discovery->path[0] == '\0')
+        return NA_FALSE;
+
+    file = fopen(discovery->path, "r");
+    if (file == NULL)
+        return NA_FALSE;
+
+    while (fgets(line, (int) sizeof(line), file) != NULL) {
+        char *value = strchr(line, '=');
+
+        if (value == NULL)
+            continue;
+        *value++ = '\0';
+        value[strcspn(value, "\n")] = '\0';
+
+        if (!strcmp(line, "key"))
+            key_match = !strcmp(value, discovery->key);
+        else if (!strcmp(line, "ip"))
+            strncpy(discovery->ip, value, sizeof(discovery->ip) - 1);
+        else if (!strcmp(line, "domain"))
+            strncpy(discovery->domain_name, value,
+                sizeof(discovery->domain_name) - 1);
+        else if (!strcmp(line, "fabric"))
+            strncpy(discovery->fabric_name, value,
+                sizeof(discovery->fabric_name) - 1);
+        else if (!strcmp(line, "prov_domain"))
+            strncpy(discovery->prov_domain_name, value,
+                sizeof(discovery->prov_domain_name) - 1);
+    }
+    fclose(file);
+
+    /* Selected provider is required to narrow down fi_getinfo() */
+    if (!key_match || discovery->fabric_name[0] == '\0') {
+        NA_LOG_SUBSYS_DEBUG(
+            cls, "Ignoring discovery cache %s", discovery->path);
+        return NA_FALSE;
+    }
+    NA_LOG_SUBSYS_DEBUG(cls, "Using discovery cache %s", discovery->path);
+
+    return NA_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_discovery_store(const struct na_ofi_discovery *discovery)
+{
+    char tmp_path[2 * NA_OFI_MAX_URI_LEN + 16];
+    FILE *file;
+    int rc;
+
+    if (discovery->path[0] == '\0')
+        return;
+
+    /* Readers must never see a partial file, write it aside and rename */
+    rc = snprintf(
+        tmp_path, sizeof(tmp_path), "%s.%d", discovery->path, (int) getpid());
+    if (rc < 0 || (size_t) rc >= sizeof(tmp_path))
+        return;
+
+    file = fopen(tmp_path, "w");
+    if (file == NULL) {
+        NA_LOG_SUBSYS_WARNING(
+            cls, "Could not create discovery cache %s", tmp_path);
+        return;
+    }
+
+    rc = fprintf(file, "key=%s\nip=%s\ndomain=%s\nfabric=%s\nprov_domain=%s\n",
+        discovery->key, discovery->ip, discovery->domain_name,
+        discovery->fabric_name, discovery->prov_domain_name);
+    if (fclose(file) != 0 || rc < 0 || rename(tmp_path, discovery->path) != 0) {
+        NA_LOG_SUBSYS_WARNING(
+            cls, "Could not write discovery cache %s", discovery->path);
+        (void) remove(tmp_path);
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_check_interface(const char *hostname, unsigned int port, char **ifa_name,
@@ -2073,7 +2973,9 @@ out:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_domain_open(enum na_ofi_prov_type prov_type, const char *domain_name,
-    const char *auth_key, na_bool_t no_wait,
+    const char *auth_key, na_bool_t no_wait, na_bool_t multi_recv,
+    na_bool_t mem_device, enum fi_threading threading,
+    unsigned int mr_cache_max, const struct na_ofi_discovery *discovery,
     struct na_ofi_domain **na_ofi_domain_p)
 {
     struct na_ofi_domain *na_ofi_domain;
@@ -2091,8 +2993,11 @@ na_ofi_domain_open(enum na_ofi_prov_type prov_type, const char *domain_name,
     hg_thread_mutex_lock(&na_ofi_domain_list_mutex_g);
     HG_LIST_FOREACH (na_ofi_domain, &na_ofi_domain_list_g, entry) {
         if (na_ofi_verify_provider(
-                prov_type, domain_name, na_ofi_domain->fi_prov)) {
-            hg_atomic_incr32(&na_ofi_domain->refcount);
+                prov_type, domain_name, na_ofi_domain->fi_prov) &&
+            (!multi_recv || (na_ofi_domain->fi_prov->caps & FI_MULTI_RECV)) &&
+            (!mem_device || na_ofi_with_hmem(na_ofi_domain)) &&
+            na_ofi_domain->threading == threading) {
+            hg_atomic_incr32_relaxed(&na_ofi_domain->refcount);
             domain_found = NA_TRUE;
             break;
         }
@@ -2106,7 +3011,8 @@ na_ofi_domain_open(enum na_ofi_prov_type prov_type, const char *domain_name,
     }
 
     /* If no pre-existing domain, get OFI providers info */
-    ret = na_ofi_getinfo(prov_type, &providers, NULL);
+    ret = na_ofi_getinfo(prov_type, multi_recv, mem_device, threading,
+        discovery, &providers, NULL);
     NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "na_ofi_getinfo() failed");
 
     /* Try to find provider that matches protocol and domain/host name */
@@ -2134,6 +3040,7 @@ na_ofi_domain_open(enum na_ofi_prov_type prov_type, const char *domain_name,
         "Could not allocate na_ofi_domain");
     memset(na_ofi_domain, 0, sizeof(struct na_ofi_domain));
     hg_atomic_init32(&na_ofi_domain->refcount, 1);
+    na_ofi_domain->threading = threading;
 
     HG_LOG_ADD_COUNTER32(
         na, &na_ofi_domain->mr_reg_count, "mr_reg_count", "MR reg count");
@@ -2148,6 +3055,13 @@ na_ofi_domain_open(enum na_ofi_prov_type prov_type, const char *domain_name,
     NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
         "hg_thread_rwlock_init() failed");
 
+    /* Init MR cache */
+    rc = hg_thread_mutex_init(&na_ofi_domain->mr_cache.mutex);
+    NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
+        "hg_thread_mutex_init() failed");
+    HG_LIST_INIT(&na_ofi_domain->mr_cache.list);
+    na_ofi_domain->mr_cache.count_max = mr_cache_max;
+
     /* Keep fi_info */
     na_ofi_domain->fi_prov = fi_dupinfo(prov);
     NA_CHECK_SUBSYS_ERROR(cls, na_ofi_domain->fi_prov == NULL, error, ret,
@@ -2326,6 +3240,9 @@ na_ofi_domain_close(struct na_ofi_domain *na_ofi_domain)
         HG_LIST_REMOVE(na_ofi_domain, entry);
     hg_thread_mutex_unlock(&na_ofi_domain_list_mutex_g);
 
+    /* Release cached MRs */
+    na_ofi_mr_cache_purge(na_ofi_domain);
+
     /* Close MR */
     if (na_ofi_domain->fi_mr) {
         rc = fi_close(&na_ofi_domain->fi_mr->fid);
@@ -2375,6 +3292,7 @@ na_ofi_domain_close(struct na_ofi_domain *na_ofi_domain)
 
     hg_thread_mutex_destroy(&na_ofi_domain->mutex);
     hg_thread_rwlock_destroy(&na_ofi_domain->rwlock);
+    hg_thread_mutex_destroy(&na_ofi_domain->mr_cache.mutex);
 
     free(na_ofi_domain->prov_name);
     free(na_ofi_domain);
@@ -2387,7 +3305,8 @@ out:
 static na_return_t
 na_ofi_endpoint_open(const struct na_ofi_domain *na_ofi_domain,
     const char *node, void *src_addr, na_size_t src_addrlen, na_bool_t no_wait,
-    na_uint8_t max_contexts, struct na_ofi_endpoint **na_ofi_endpoint_p)
+    na_uint16_t max_contexts, na_bool_t rma_tx,
+    struct na_ofi_endpoint **na_ofi_endpoint_p)
 {
     struct na_ofi_endpoint *na_ofi_endpoint;
     struct fi_info *hints = NULL;
@@ -2415,18 +3334,19 @@ na_ofi_endpoint_open(const struct na_ofi_domain *na_ofi_domain,
         hints->src_addrlen = src_addrlen;
     }
 
-    /* Set max contexts to EP attrs */
-    hints->ep_attr->tx_ctx_cnt = max_contexts;
+    /* Set max contexts to EP attrs, each context may have a second transmit
+     * context for RMA ops */
+    hints->ep_attr->tx_ctx_cnt = (rma_tx) ? 2 * max_contexts : max_contexts;
     hints->ep_attr->rx_ctx_cnt = max_contexts;
 
-    rc = fi_getinfo(
-        NA_OFI_VERSION, node, NULL, flags, hints, &na_ofi_endpoint->fi_prov);
+    rc = fi_getinfo(NA_OFI_GETINFO_VERSION(hints->caps), node, NULL, flags,
+        hints, &na_ofi_endpoint->fi_prov);
 
     NA_CHECK_SUBSYS_ERROR(ctx, rc != 0, out, ret, na_ofi_errno_to_na(-rc),
         "fi_getinfo(%s) failed, rc: %d (%s)", node, rc, fi_strerror(-rc));
 
     if ((na_ofi_prov_flags[na_ofi_domain->prov_type] & NA_OFI_SEP) &&
-        max_contexts > 1) {
+        (max_contexts > 1 || rma_tx)) {
         ret = na_ofi_sep_open(na_ofi_domain, na_ofi_endpoint);
         NA_CHECK_SUBSYS_NA_ERROR(ctx, out, ret, "na_ofi_sep_open() failed");
     } else {
@@ -2476,6 +3396,8 @@ na_ofi_basic_ep_open(const struct na_ofi_domain *na_ofi_domain,
         ret, NA_NOMEM, "Could not allocate retry_op_queue");
     HG_QUEUE_INIT(&na_ofi_endpoint->retry_op_queue->queue);
     hg_thread_mutex_init(&na_ofi_endpoint->retry_op_queue->mutex);
+    na_ofi_endpoint->retry_op_queue->retry_ticks = 0;
+    na_ofi_endpoint->retry_op_queue->retry_backoff = 0;
 
     if (!no_wait) {
         if (na_ofi_prov_flags[na_ofi_domain->prov_type] & NA_OFI_WAIT_FD)
@@ -2504,7 +3426,12 @@ na_ofi_basic_ep_open(const struct na_ofi_domain *na_ofi_domain,
 
     /* Bind the CQ and AV to the endpoint */
     rc = fi_ep_bind(na_ofi_endpoint->fi_ep, &na_ofi_endpoint->fi_cq->fid,
-        FI_TRANSMIT | FI_RECV);
+        NA_OFI_TX_BIND_FLAGS(na_ofi_domain->fi_prov));
+    NA_CHECK_SUBSYS_ERROR(ctx, rc != 0, out, ret, na_ofi_errno_to_na(-rc),
+        "fi_ep_bind() failed, rc: %d (%s)", rc, fi_strerror(-rc));
+
+    rc = fi_ep_bind(
+        na_ofi_endpoint->fi_ep, &na_ofi_endpoint->fi_cq->fid, FI_RECV);
     NA_CHECK_SUBSYS_ERROR(ctx, rc != 0, out, ret, na_ofi_errno_to_na(-rc),
         "fi_ep_bind() failed, rc: %d (%s)", rc, fi_strerror(-rc));
 
@@ -2616,6 +3543,258 @@ out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_multi_recv_create(na_class_t *na_class, struct fid_ep *fi_rx,
+    na_uint8_t buf_count, struct na_ofi_multi_recv **multi_recv_p)
+{
+    struct na_ofi_class *priv = NA_OFI_CLASS(na_class);
+    struct na_ofi_multi_recv *multi_recv = NULL;
+    size_t min_multi_recv = (size_t) priv->unexpected_size_max;
+    na_return_t ret = NA_SUCCESS;
+    na_uint8_t i;
+    int rc;
+
+    multi_recv = (struct na_ofi_multi_recv *) calloc(
+        1, sizeof(struct na_ofi_multi_recv));
+    NA_CHECK_SUBSYS_ERROR(ctx, multi_recv == NULL, error, ret, NA_NOMEM,
+        "Could not allocate multi-recv info");
+
+    /* Initialize queues */
+    HG_QUEUE_INIT(&multi_recv->unexpected_msg_queue.queue);
+    hg_thread_spin_init(&multi_recv->unexpected_msg_queue.lock);
+    HG_QUEUE_INIT(&multi_recv->unexpected_op_queue.queue);
+    hg_thread_mutex_init(&multi_recv->unexpected_op_queue.mutex);
+
+    multi_recv->queues = multi_recv;
+    multi_recv->fi_rx = fi_rx;
+    multi_recv->buf_size =
+        priv->unexpected_size_max * NA_OFI_MULTI_RECV_MSG_COUNT;
+    multi_recv->buf_count = buf_count;
+    hg_atomic_init32(&multi_recv->unposted_count, 0);
+
+    if (buf_count == 0)
+        goto done;
+
+    /* Have the provider release a buffer once it can no longer hold a message
+     * of max unexpected size */
+    rc = fi_setopt(&fi_rx->fid, FI_OPT_ENDPOINT, FI_OPT_MIN_MULTI_RECV,
+        &min_multi_recv, sizeof(min_multi_recv));
+    NA_CHECK_SUBSYS_ERROR(ctx, rc != 0, error, ret, na_ofi_errno_to_na(-rc),
+        "fi_setopt() FI_OPT_MIN_MULTI_RECV failed, rc: %d (%s)", rc,
+        fi_strerror(-rc));
+
+    multi_recv->bufs = (struct na_ofi_mrecv_buf *) calloc(
+        multi_recv->buf_count, sizeof(struct na_ofi_mrecv_buf));
+    NA_CHECK_SUBSYS_ERROR(ctx, multi_recv->bufs == NULL, error, ret, NA_NOMEM,
+        "Could not allocate multi-recv buffer array");
+
+    for (i = 0; i < multi_recv->buf_count; i++) {
+        struct na_ofi_mrecv_buf *mrecv_buf = &multi_recv->bufs[i];
+
+        mrecv_buf->multi_recv = multi_recv;
+        hg_atomic_init32(&mrecv_buf->posted, 0);
+        mrecv_buf->buf =
+            na_ofi_mem_alloc(na_class, multi_recv->buf_size, NA_TRUE,
+                &mrecv_buf->fi_mr);
+        NA_CHECK_SUBSYS_ERROR(ctx, mrecv_buf->buf == NULL, error, ret,
+            NA_NOMEM, "Could not allocate multi-recv buffer of size %zu",
+            multi_recv->buf_size);
+    }
+
+done:
+    *multi_recv_p = multi_recv;
+
+    return ret;
+
+error:
+    if (multi_recv)
+        na_ofi_multi_recv_destroy(na_class, multi_recv);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_multi_recv_destroy(
+    na_class_t *na_class, struct na_ofi_multi_recv *multi_recv)
+{
+    struct na_ofi_unexpected_info *na_ofi_unexpected_info;
+    na_uint8_t i;
+
+    /* Drop messages that were never consumed */
+    while ((na_ofi_unexpected_info =
+                   HG_QUEUE_FIRST(&multi_recv->unexpected_msg_queue.queue))) {
+        HG_QUEUE_POP_HEAD(&multi_recv->unexpected_msg_queue.queue, entry);
+        na_ofi_addr_decref(na_ofi_unexpected_info->na_ofi_addr);
+        free(na_ofi_unexpected_info->buf);
+        free(na_ofi_unexpected_info);
+    }
+
+    if (multi_recv->bufs) {
+        for (i = 0; i < multi_recv->buf_count; i++)
+            if (multi_recv->bufs[i].buf)
+                na_ofi_mem_free(na_class, multi_recv->bufs[i].buf,
+                    multi_recv->buf_size, multi_recv->bufs[i].fi_mr);
+        free(multi_recv->bufs);
+    }
+
+    hg_thread_spin_destroy(&multi_recv->unexpected_msg_queue.lock);
+    hg_thread_mutex_destroy(&multi_recv->unexpected_op_queue.mutex);
+    free(multi_recv);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_multi_recv_post(struct na_ofi_multi_recv *multi_recv)
+{
+    na_return_t ret = NA_SUCCESS;
+    na_uint8_t i;
+
+    for (i = 0; i < multi_recv->buf_count; i++) {
+        hg_atomic_set32(&multi_recv->bufs[i].posted, 1);
+
+        ret = na_ofi_mrecv_buf_post(&multi_recv->bufs[i]);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            msg, out, ret, "Could not post multi-recv buffer");
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_multi_recv_repost(struct na_ofi_multi_recv *multi_recv)
+{
+    na_return_t ret = NA_SUCCESS;
+    na_uint8_t i;
+
+    for (i = 0; i < multi_recv->buf_count; i++) {
+        struct na_ofi_mrecv_buf *mrecv_buf = &multi_recv->bufs[i];
+
+        /* Buffer either posted or being reposted */
+        if (!hg_atomic_cas32(&mrecv_buf->posted, 0, 1))
+            continue;
+        hg_atomic_decr32(&multi_recv->unposted_count);
+
+        ret = na_ofi_mrecv_buf_post(mrecv_buf);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            msg, out, ret, "Could not repost multi-recv buffer");
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_mrecv_buf_post(struct na_ofi_mrecv_buf *mrecv_buf)
+{
+    struct na_ofi_multi_recv *multi_recv = mrecv_buf->multi_recv;
+    void *desc = (mrecv_buf->fi_mr) ? fi_mr_desc(mrecv_buf->fi_mr) : NULL;
+    struct iovec msg_iov;
+    struct fi_msg fi_msg;
+    na_return_t ret = NA_SUCCESS;
+    ssize_t rc;
+
+    msg_iov.iov_base = mrecv_buf->buf;
+    msg_iov.iov_len = multi_recv->buf_size;
+    fi_msg.msg_iov = &msg_iov;
+    fi_msg.desc = &desc;
+    fi_msg.iov_count = 1;
+    fi_msg.addr = FI_ADDR_UNSPEC;
+    fi_msg.context = &mrecv_buf->fi_ctx;
+    fi_msg.data = 0;
+
+    NA_LOG_SUBSYS_DEBUG(
+        msg, "Posting multi-recv buffer (buf=%p)", mrecv_buf->buf);
+
+    rc = fi_recvmsg(multi_recv->fi_rx, &fi_msg, FI_MULTI_RECV);
+    if (unlikely(rc == -FI_EAGAIN)) {
+        NA_LOG_SUBSYS_DEBUG(
+            msg, "Deferring post of multi-recv buffer %p", mrecv_buf->buf);
+
+        /* Buffer is reposted on next progress */
+        hg_atomic_set32(&mrecv_buf->posted, 0);
+        hg_atomic_incr32(&multi_recv->unposted_count);
+    } else
+        NA_CHECK_SUBSYS_ERROR(msg, rc != 0, out, ret,
+            na_ofi_errno_to_na((int) -rc),
+            "fi_recvmsg() multi-recv failed, rc: %d (%s)", rc,
+            fi_strerror((int) -rc));
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_multi_recv_match(
+    struct na_ofi_multi_recv *multi_recv, struct na_ofi_op_id *na_ofi_op_id)
+{
+    struct na_ofi_multi_recv *queues = multi_recv->queues;
+    struct na_ofi_unexpected_info *na_ofi_unexpected_info;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Op queue lock is held until op ID is queued so that a message arriving
+     * in the meantime (possibly on another context) cannot be missed */
+    hg_thread_mutex_lock(&queues->unexpected_op_queue.mutex);
+
+    /* Look for an unexpected message already received */
+    hg_thread_spin_lock(&queues->unexpected_msg_queue.lock);
+    na_ofi_unexpected_info =
+        HG_QUEUE_FIRST(&queues->unexpected_msg_queue.queue);
+    HG_QUEUE_POP_HEAD(&queues->unexpected_msg_queue.queue, entry);
+    hg_thread_spin_unlock(&queues->unexpected_msg_queue.lock);
+
+    if (likely(!na_ofi_unexpected_info)) {
+        NA_LOG_SUBSYS_DEBUG(msg,
+            "Queueing unexpected msg recv on multi-recv (op id=%p)",
+            na_ofi_op_id);
+
+        /* Nothing has been received yet so add op_id to queue */
+        HG_QUEUE_PUSH_TAIL(
+            &queues->unexpected_op_queue.queue, na_ofi_op_id, entry);
+        hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_QUEUED);
+    }
+    hg_thread_mutex_unlock(&queues->unexpected_op_queue.mutex);
+
+    if (unlikely(na_ofi_unexpected_info)) {
+        na_size_t buf_size = na_ofi_unexpected_info->buf_size;
+
+        if (unlikely(buf_size > na_ofi_op_id->info.msg.buf_size)) {
+            NA_LOG_SUBSYS_WARNING(msg,
+                "Unexpected msg size too large for buffer (%zu), dropping it",
+                buf_size);
+            na_ofi_addr_decref(na_ofi_unexpected_info->na_ofi_addr);
+            free(na_ofi_unexpected_info->buf);
+            free(na_ofi_unexpected_info);
+
+            ret = na_ofi_complete(na_ofi_op_id, NA_MSGSIZE);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                op, out, ret, "Unable to complete operation");
+            goto out;
+        }
+
+        /* Address reference is transferred to op ID */
+        na_ofi_op_id->addr = na_ofi_unexpected_info->na_ofi_addr;
+        na_ofi_op_id->info.msg.actual_buf_size = buf_size;
+        na_ofi_op_id->info.msg.tag = na_ofi_unexpected_info->tag;
+        memcpy(na_ofi_op_id->info.msg.buf.ptr, na_ofi_unexpected_info->buf,
+            buf_size);
+
+        free(na_ofi_unexpected_info->buf);
+        free(na_ofi_unexpected_info);
+
+        ret = na_ofi_complete(na_ofi_op_id, NA_SUCCESS);
+        NA_CHECK_SUBSYS_NA_ERROR(op, out, ret, "Unable to complete operation");
+    }
+
+out:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_get_ep_addr(struct na_ofi_domain *na_ofi_domain,
@@ -2725,7 +3904,7 @@ na_ofi_addr_alloc(struct na_ofi_domain *na_ofi_domain)
 
     /* Keep reference to domain */
     na_ofi_addr->domain = na_ofi_domain;
-    hg_atomic_incr32(&na_ofi_domain->refcount);
+    hg_atomic_incr32_relaxed(&na_ofi_domain->refcount);
 
     /* One refcount for the caller to hold until addr_free */
     hg_atomic_init32(&na_ofi_addr->refcount, 1);
@@ -2738,7 +3917,7 @@ out:
 static NA_INLINE void
 na_ofi_addr_addref(struct na_ofi_addr *na_ofi_addr)
 {
-    hg_atomic_incr32(&na_ofi_addr->refcount);
+    hg_atomic_incr32_relaxed(&na_ofi_addr->refcount);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -2767,31 +3946,39 @@ na_ofi_addr_decref(struct na_ofi_addr *na_ofi_addr)
 /*---------------------------------------------------------------------------*/
 static struct na_ofi_mem_pool *
 na_ofi_mem_pool_create(
-    na_class_t *na_class, na_size_t block_size, na_size_t block_count)
+    na_class_t *na_class, struct na_ofi_mem_pool_class *pool_class)
 {
     struct na_ofi_mem_pool *na_ofi_mem_pool = NULL;
-    na_size_t pool_size =
-        block_size * block_count + sizeof(struct na_ofi_mem_pool) +
-        block_count * (offsetof(struct na_ofi_mem_node, block));
+    na_size_t node_size =
+        offsetof(struct na_ofi_mem_node, block) + pool_class->block_size;
+    na_size_t pool_size = NA_OFI_MEM_POOL_SIZE(pool_class);
     struct fid_mr *mr_hdl = NULL;
     na_size_t i;
 
     na_ofi_mem_pool = (struct na_ofi_mem_pool *) na_ofi_mem_alloc(
-        na_class, pool_size, &mr_hdl);
+        na_class, pool_size, NA_TRUE, &mr_hdl);
     NA_CHECK_SUBSYS_ERROR_NORET(mem, na_ofi_mem_pool == NULL, out,
         "Could not allocate %d bytes", (int) pool_size);
 
-    HG_QUEUE_INIT(&na_ofi_mem_pool->node_list);
-    hg_thread_spin_init(&na_ofi_mem_pool->node_list_lock);
+    na_ofi_mem_pool->node_queue =
+        hg_atomic_queue_alloc((unsigned int) pool_class->block_count);
+    if (unlikely(na_ofi_mem_pool->node_queue == NULL)) {
+        na_ofi_mem_free(na_class, na_ofi_mem_pool, pool_size, mr_hdl);
+        NA_GOTO_SUBSYS_ERROR(mem, out, na_ofi_mem_pool, NULL,
+            "Could not allocate queue of %zu nodes", pool_class->block_count);
+    }
+    na_ofi_mem_pool->next = NULL;
+    na_ofi_mem_pool->pool_class = pool_class;
     na_ofi_mem_pool->mr_hdl = mr_hdl;
-    na_ofi_mem_pool->block_size = block_size;
 
-    /* Assign nodes and insert them to free list */
-    for (i = 0; i < block_count; i++) {
-        struct na_ofi_mem_node *na_ofi_mem_node = (struct na_ofi_mem_node
-                *) ((char *) na_ofi_mem_pool + sizeof(struct na_ofi_mem_pool) +
-                    i * (offsetof(struct na_ofi_mem_node, block) + block_size));
-        HG_QUEUE_PUSH_TAIL(&na_ofi_mem_pool->node_list, na_ofi_mem_node, entry);
+    /* Assign nodes and insert them to free queue */
+    for (i = 0; i < pool_class->block_count; i++) {
+        struct na_ofi_mem_node *na_ofi_mem_node =
+            (struct na_ofi_mem_node *) ((char *) na_ofi_mem_pool +
+                                        sizeof(struct na_ofi_mem_pool) +
+                                        i * node_size);
+        na_ofi_mem_node->pool = na_ofi_mem_pool;
+        hg_atomic_queue_push(na_ofi_mem_pool->node_queue, na_ofi_mem_node);
     }
 
 out:
@@ -2803,118 +3990,247 @@ static void
 na_ofi_mem_pool_destroy(
     na_class_t *na_class, struct na_ofi_mem_pool *na_ofi_mem_pool)
 {
-    na_ofi_mem_free(na_class, na_ofi_mem_pool, na_ofi_mem_pool->mr_hdl);
-    hg_thread_spin_destroy(&na_ofi_mem_pool->node_list_lock);
+    hg_atomic_queue_free(na_ofi_mem_pool->node_queue);
+    na_ofi_mem_free(na_class, na_ofi_mem_pool,
+        NA_OFI_MEM_POOL_SIZE(na_ofi_mem_pool->pool_class),
+        na_ofi_mem_pool->mr_hdl);
 }
 
 /*---------------------------------------------------------------------------*/
-static void *
-na_ofi_mem_pool_alloc(
-    na_class_t *na_class, na_size_t size, struct fid_mr **mr_hdl)
+static na_return_t
+na_ofi_mem_pool_grow(
+    na_class_t *na_class, struct na_ofi_mem_pool_class *pool_class)
 {
     struct na_ofi_mem_pool *na_ofi_mem_pool;
-    struct na_ofi_mem_node *na_ofi_mem_node;
-    void *mem_ptr = NULL;
-    na_bool_t found = NA_FALSE;
+    hg_util_int64_t head;
+    hg_util_int32_t free_count;
+    na_return_t ret = NA_SUCCESS;
 
-retry:
-    /* Check whether we can get a block from one of the pools */
-    hg_thread_spin_lock(&NA_OFI_CLASS(na_class)->buf_pool_lock);
-    HG_QUEUE_FOREACH (
-        na_ofi_mem_pool, &NA_OFI_CLASS(na_class)->buf_pool, entry) {
-        hg_thread_spin_lock(&na_ofi_mem_pool->node_list_lock);
-        found = !HG_QUEUE_IS_EMPTY(&na_ofi_mem_pool->node_list);
-        hg_thread_spin_unlock(&na_ofi_mem_pool->node_list_lock);
-        if (found)
-            break;
-    }
-    hg_thread_spin_unlock(&NA_OFI_CLASS(na_class)->buf_pool_lock);
+    /* Only one thread registers a new pool at a time */
+    if (!hg_atomic_cas32(&pool_class->growing, 0, 1))
+        goto out;
 
-    /* If not, allocate and register a new pool */
-    if (!found) {
-        na_ofi_mem_pool = na_ofi_mem_pool_create(na_class,
-            na_ofi_msg_get_max_unexpected_size(na_class),
-            NA_OFI_MEM_BLOCK_COUNT);
-        NA_CHECK_SUBSYS_ERROR(mem, na_ofi_mem_pool == NULL, out, mem_ptr, NULL,
-            "Could not create new pool");
-        hg_thread_spin_lock(&NA_OFI_CLASS(na_class)->buf_pool_lock);
-        HG_QUEUE_PUSH_TAIL(
-            &NA_OFI_CLASS(na_class)->buf_pool, na_ofi_mem_pool, entry);
-        hg_thread_spin_unlock(&NA_OFI_CLASS(na_class)->buf_pool_lock);
-    }
+    na_ofi_mem_pool = na_ofi_mem_pool_create(na_class, pool_class);
+    NA_CHECK_SUBSYS_ERROR(mem, na_ofi_mem_pool == NULL, done, ret, NA_NOMEM,
+        "Could not create new pool of %zu bytes blocks",
+        pool_class->block_size);
 
-    NA_CHECK_SUBSYS_ERROR(mem, size > na_ofi_mem_pool->block_size, out, mem_ptr,
-        NULL, "Block size is too small for requested size");
+    /* Publish pool */
+    do {
+        head = hg_atomic_get64(&pool_class->pools);
+        na_ofi_mem_pool->next = (struct na_ofi_mem_pool *) head;
+    } while (!hg_atomic_cas64(
+        &pool_class->pools, head, (hg_util_int64_t) na_ofi_mem_pool));
 
-    /* Pick a node from one of the available pools */
-    hg_thread_spin_lock(&na_ofi_mem_pool->node_list_lock);
-    na_ofi_mem_node = HG_QUEUE_FIRST(&na_ofi_mem_pool->node_list);
-    if (!na_ofi_mem_node) {
-        hg_thread_spin_unlock(&na_ofi_mem_pool->node_list_lock);
-        goto retry;
-    }
-    HG_QUEUE_POP_HEAD(&na_ofi_mem_pool->node_list, entry);
-    hg_thread_spin_unlock(&na_ofi_mem_pool->node_list_lock);
-    mem_ptr = &na_ofi_mem_node->block;
-    *mr_hdl = na_ofi_mem_pool->mr_hdl;
+    do {
+        free_count = hg_atomic_get32(&pool_class->free_count);
+    } while (!hg_atomic_cas32(&pool_class->free_count, free_count,
+        free_count + (hg_util_int32_t) pool_class->block_count));
+
+done:
+    hg_atomic_set32(&pool_class->growing, 0);
 
 out:
-    return mem_ptr;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-na_ofi_mem_pool_free(na_class_t *na_class, void *mem_ptr, struct fid_mr *mr_hdl)
+static na_return_t
+na_ofi_mem_pool_init(na_class_t *na_class, na_size_t unexpected_size,
+    na_size_t expected_size)
 {
-    struct na_ofi_mem_pool *na_ofi_mem_pool;
-    struct na_ofi_mem_node *na_ofi_mem_node =
-        container_of(mem_ptr, struct na_ofi_mem_node, block);
+    struct na_ofi_class *priv = NA_OFI_CLASS(na_class);
+    struct na_ofi_mem_pool_class *unexpected_class, *expected_class;
+    na_size_t size_max = MAX(unexpected_size, expected_size);
+    na_uint8_t i;
+    na_return_t ret = NA_SUCCESS;
 
-    /* Put the node back to the pool */
-    hg_thread_spin_lock(&NA_OFI_CLASS(na_class)->buf_pool_lock);
-    HG_QUEUE_FOREACH (
-        na_ofi_mem_pool, &NA_OFI_CLASS(na_class)->buf_pool, entry) {
-        /* If MR handle is NULL, it does not really matter which pool we push
-         * the node back to.
-         */
-        if (na_ofi_mem_pool->mr_hdl == mr_hdl) {
-            hg_thread_spin_lock(&na_ofi_mem_pool->node_list_lock);
-            HG_QUEUE_PUSH_TAIL(
-                &na_ofi_mem_pool->node_list, na_ofi_mem_node, entry);
-            hg_thread_spin_unlock(&na_ofi_mem_pool->node_list_lock);
-            break;
+    /* Classes double in size until size_max is covered */
+    for (i = 0; i < NA_OFI_MEM_POOL_CLASS_MAX; i++) {
+        struct na_ofi_mem_pool_class *pool_class = &priv->buf_pools[i];
+
+        hg_atomic_init64(&pool_class->pools, 0);
+        hg_atomic_init32(&pool_class->free_count, 0);
+        hg_atomic_init32(&pool_class->growing, 0);
+        pool_class->block_size = (na_size_t) NA_OFI_MSG_SIZE << i;
+        pool_class->block_count =
+            MAX(NA_OFI_MEM_BLOCK_COUNT >> i, NA_OFI_MEM_BLOCK_COUNT_MIN);
+        priv->buf_pool_class_count = (na_uint8_t) (i + 1);
+
+        if (pool_class->block_size >= size_max)
+            break;
+    }
+    NA_CHECK_SUBSYS_WARNING(mem,
+        priv->buf_pools[priv->buf_pool_class_count - 1].block_size < size_max,
+        "Msg buffers larger than %zu bytes will not be pooled",
+        priv->buf_pools[priv->buf_pool_class_count - 1].block_size);
+
+    /* Register initial pools for msg sizes, others are registered on use */
+    unexpected_class = na_ofi_mem_pool_get_class(priv, unexpected_size);
+    if (unexpected_class) {
+        ret = na_ofi_mem_pool_grow(na_class, unexpected_class);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, out, ret, "Could not create memory pool");
+    }
+    expected_class = na_ofi_mem_pool_get_class(priv, expected_size);
+    if (expected_class && expected_class != unexpected_class) {
+        ret = na_ofi_mem_pool_grow(na_class, expected_class);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, out, ret, "Could not create memory pool");
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE struct na_ofi_mem_pool_class *
+na_ofi_mem_pool_get_class(struct na_ofi_class *priv, na_size_t size)
+{
+    na_uint8_t i;
+
+    for (i = 0; i < priv->buf_pool_class_count; i++)
+        if (size <= priv->buf_pools[i].block_size)
+            return &priv->buf_pools[i];
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_mem_pool_finalize(na_class_t *na_class)
+{
+    struct na_ofi_class *priv = NA_OFI_CLASS(na_class);
+    na_uint8_t i;
+
+    for (i = 0; i < priv->buf_pool_class_count; i++) {
+        struct na_ofi_mem_pool *na_ofi_mem_pool =
+            (struct na_ofi_mem_pool *) hg_atomic_get64(
+                &priv->buf_pools[i].pools);
+
+        while (na_ofi_mem_pool) {
+            struct na_ofi_mem_pool *next = na_ofi_mem_pool->next;
+
+            na_ofi_mem_pool_destroy(na_class, na_ofi_mem_pool);
+            na_ofi_mem_pool = next;
+        }
+        hg_atomic_set64(&priv->buf_pools[i].pools, 0);
+    }
+    priv->buf_pool_class_count = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+na_ofi_mem_pool_alloc(
+    na_class_t *na_class, na_size_t size, struct fid_mr **mr_hdl)
+{
+    struct na_ofi_mem_pool_class *pool_class =
+        na_ofi_mem_pool_get_class(NA_OFI_CLASS(na_class), size);
+    struct na_ofi_mem_node *na_ofi_mem_node = NULL;
+    void *mem_ptr = NULL;
+
+    /* Too large for pools, allocate and register separately */
+    if (unlikely(pool_class == NULL)) {
+        na_ofi_mem_node = (struct na_ofi_mem_node *) na_ofi_mem_alloc(
+            na_class, offsetof(struct na_ofi_mem_node, block) + size,
+            NA_FALSE, mr_hdl);
+        NA_CHECK_SUBSYS_ERROR_NORET(mem, na_ofi_mem_node == NULL, out,
+            "Could not allocate %zu bytes", size);
+        na_ofi_mem_node->pool = NULL;
+        mem_ptr = &na_ofi_mem_node->block;
+        goto out;
+    }
+
+    for (;;) {
+        struct na_ofi_mem_pool *na_ofi_mem_pool;
+
+        /* Pick a node from one of the available pools */
+        for (na_ofi_mem_pool = (struct na_ofi_mem_pool *) hg_atomic_get64(
+                 &pool_class->pools);
+             na_ofi_mem_pool != NULL;
+             na_ofi_mem_pool = na_ofi_mem_pool->next) {
+            na_ofi_mem_node = (struct na_ofi_mem_node *) hg_atomic_queue_pop_mc(
+                na_ofi_mem_pool->node_queue);
+            if (na_ofi_mem_node)
+                break;
         }
+        if (na_ofi_mem_node)
+            break;
+
+        /* All pools are exhausted */
+        NA_CHECK_SUBSYS_ERROR(mem,
+            na_ofi_mem_pool_grow(na_class, pool_class) != NA_SUCCESS, out,
+            mem_ptr, NULL, "Could not grow pool");
     }
-    hg_thread_spin_unlock(&NA_OFI_CLASS(na_class)->buf_pool_lock);
+
+    /* Register next pool ahead of demand */
+    if (hg_atomic_decr32(&pool_class->free_count) <
+        (hg_util_int32_t) NA_OFI_MEM_POOL_LOW_WATERMARK(
+            pool_class->block_count))
+        (void) na_ofi_mem_pool_grow(na_class, pool_class);
+
+    mem_ptr = &na_ofi_mem_node->block;
+    *mr_hdl = na_ofi_mem_node->pool->mr_hdl;
+
+out:
+    return mem_ptr;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_mem_pool_free(na_class_t *na_class, void *mem_ptr, struct fid_mr *mr_hdl)
+{
+    struct na_ofi_mem_node *na_ofi_mem_node =
+        container_of(mem_ptr, struct na_ofi_mem_node, block);
+    struct na_ofi_mem_pool *na_ofi_mem_pool = na_ofi_mem_node->pool;
+
+    if (unlikely(na_ofi_mem_pool == NULL)) {
+        na_ofi_mem_free(na_class, na_ofi_mem_node, 0, mr_hdl);
+        return;
+    }
+
+    /* Put the node back to its pool (queue is large enough for all nodes) */
+    hg_atomic_queue_push(na_ofi_mem_pool->node_queue, na_ofi_mem_node);
+    hg_atomic_incr32(&na_ofi_mem_pool->pool_class->free_count);
 }
 
 #endif
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void *
-na_ofi_mem_alloc(na_class_t *na_class, na_size_t size, struct fid_mr **mr_hdl)
+na_ofi_mem_alloc(na_class_t *na_class, na_size_t size, na_bool_t huge,
+    struct fid_mr **mr_hdl)
 {
     struct na_ofi_domain *domain = NA_OFI_CLASS(na_class)->domain;
     na_size_t page_size = (na_size_t) hg_mem_get_page_size();
     void *mem_ptr = NULL;
 
-    /* Allocate backend buffer */
-    mem_ptr = hg_mem_aligned_alloc(page_size, size);
+    /* Allocate backend buffer (huge page memory is already zeroed and placed
+     * on the NUMA node of the class) */
+    if (huge)
+        mem_ptr = hg_mem_huge_alloc(size, (int) na_class->numa_node);
+    else {
+        mem_ptr = hg_mem_aligned_alloc(page_size, size);
+        if (mem_ptr != NULL)
+            memset(mem_ptr, 0, size);
+    }
     NA_CHECK_SUBSYS_ERROR_NORET(
         mem, mem_ptr == NULL, out, "Could not allocate %d bytes", (int) size);
-    memset(mem_ptr, 0, size);
 
     /* Register memory if FI_MR_LOCAL is set and provider uses it */
     if (domain->fi_prov->domain_attr->mr_mode & FI_MR_LOCAL) {
         int rc;
 
+        na_ofi_domain_mr_lock(domain);
         rc = fi_mr_reg(domain->fi_domain, mem_ptr, size,
             FI_REMOTE_READ | FI_REMOTE_WRITE | FI_SEND | FI_RECV | FI_READ |
                 FI_WRITE,
             0 /* offset */, 0 /* requested key */, 0 /* flags */, mr_hdl,
             NULL /* context */);
+        na_ofi_domain_mr_unlock(domain);
         if (unlikely(rc != 0)) {
-            hg_mem_aligned_free(mem_ptr);
+            if (huge)
+                hg_mem_huge_free(mem_ptr, size);
+            else
+                hg_mem_aligned_free(mem_ptr);
             NA_GOTO_SUBSYS_ERROR(mem, out, mem_ptr, NULL,
                 "fi_mr_reg() failed, rc: %d (%s), mr_reg_count: %d", rc,
                 fi_strerror(-rc), hg_atomic_get32(domain->mr_reg_count));
@@ -2928,21 +4244,173 @@ out:
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
-na_ofi_mem_free(na_class_t *na_class, void *mem_ptr, struct fid_mr *mr_hdl)
+na_ofi_mem_free(na_class_t *na_class, void *mem_ptr, na_size_t huge_size,
+    struct fid_mr *mr_hdl)
 {
     /* Release MR handle is there was any */
     if (mr_hdl) {
-        int rc = fi_close(&mr_hdl->fid);
+        struct na_ofi_domain *domain = NA_OFI_CLASS(na_class)->domain;
+        int rc;
+
+        na_ofi_domain_mr_lock(domain);
+        rc = fi_close(&mr_hdl->fid);
+        na_ofi_domain_mr_unlock(domain);
         NA_CHECK_SUBSYS_ERROR_NORET(mem, rc != 0, out,
             "fi_close() mr_hdl failed, rc: %d (%s)", rc, fi_strerror(-rc));
-        hg_atomic_decr32(NA_OFI_CLASS(na_class)->domain->mr_reg_count);
+        hg_atomic_decr32(domain->mr_reg_count);
     }
 
 out:
-    hg_mem_aligned_free(mem_ptr);
+    if (huge_size > 0)
+        hg_mem_huge_free(mem_ptr, huge_size);
+    else
+        hg_mem_aligned_free(mem_ptr);
     return;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_mr_cache_get(struct na_ofi_domain *domain, const struct iovec *iov,
+    na_uint64_t access, struct na_ofi_mr_cache_entry **mr_entry_p)
+{
+    struct na_ofi_mr_cache *mr_cache = &domain->mr_cache;
+    struct na_ofi_mr_cache_entry *mr_entry, *evicted;
+    const char *base = (const char *) iov->iov_base;
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    /* Look for registration that covers region with (at least) same access */
+    hg_thread_mutex_lock(&mr_cache->mutex);
+    HG_LIST_FOREACH (mr_entry, &mr_cache->list, entry) {
+        if (mr_entry->base <= base &&
+            base + iov->iov_len <= mr_entry->base + mr_entry->len &&
+            (mr_entry->access & access) == access) {
+            mr_entry->refcount++;
+            HG_LIST_REMOVE(mr_entry, entry);
+            HG_LIST_INSERT_HEAD(&mr_cache->list, mr_entry, entry);
+            break;
+        }
+    }
+    hg_thread_mutex_unlock(&mr_cache->mutex);
+    if (mr_entry)
+        goto done;
+
+    /* Not found, register new region */
+    mr_entry = (struct na_ofi_mr_cache_entry *) malloc(
+        sizeof(struct na_ofi_mr_cache_entry));
+    NA_CHECK_SUBSYS_ERROR(mem, mr_entry == NULL, out, ret, NA_NOMEM,
+        "Could not allocate MR cache entry");
+    mr_entry->base = (char *) iov->iov_base;
+    mr_entry->len = iov->iov_len;
+    mr_entry->access = access;
+    mr_entry->refcount = 1;
+
+    na_ofi_domain_mr_lock(domain);
+    rc = fi_mr_regv(domain->fi_domain, iov, 1, access, 0 /* offset */,
+        0 /* requested key */, 0 /* flags */, &mr_entry->fi_mr,
+        NULL /* context */);
+    na_ofi_domain_mr_unlock(domain);
+    NA_CHECK_SUBSYS_ERROR(mem, rc != 0, error, ret, na_ofi_errno_to_na(-rc),
+        "fi_mr_regv() failed, rc: %d (%s), mr_reg_count: %d", rc,
+        fi_strerror(-rc), hg_atomic_get32(domain->mr_reg_count));
+    hg_atomic_incr32(domain->mr_reg_count);
+
+    hg_thread_mutex_lock(&mr_cache->mutex);
+    HG_LIST_INSERT_HEAD(&mr_cache->list, mr_entry, entry);
+    mr_cache->count++;
+    evicted = na_ofi_mr_cache_evict(mr_cache);
+    hg_thread_mutex_unlock(&mr_cache->mutex);
+
+    if (evicted)
+        na_ofi_mr_cache_entry_free(domain, evicted);
+
+done:
+    *mr_entry_p = mr_entry;
+
+out:
+    return ret;
+
+error:
+    free(mr_entry);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_mr_cache_put(
+    struct na_ofi_domain *domain, struct na_ofi_mr_cache_entry *mr_entry)
+{
+    struct na_ofi_mr_cache *mr_cache = &domain->mr_cache;
+    struct na_ofi_mr_cache_entry *evicted;
+
+    /* Entry is kept registered until it gets evicted */
+    hg_thread_mutex_lock(&mr_cache->mutex);
+    mr_entry->refcount--;
+    evicted = na_ofi_mr_cache_evict(mr_cache);
+    hg_thread_mutex_unlock(&mr_cache->mutex);
+
+    if (evicted)
+        na_ofi_mr_cache_entry_free(domain, evicted);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE struct na_ofi_mr_cache_entry *
+na_ofi_mr_cache_evict(struct na_ofi_mr_cache *mr_cache)
+{
+    struct na_ofi_mr_cache_entry *mr_entry, *lru_entry = NULL;
+
+    if (mr_cache->count <= mr_cache->count_max)
+        return NULL;
+
+    /* Entries still in use cannot be evicted */
+    HG_LIST_FOREACH (mr_entry, &mr_cache->list, entry)
+        if (mr_entry->refcount == 0)
+            lru_entry = mr_entry;
+
+    if (lru_entry) {
+        HG_LIST_REMOVE(lru_entry, entry);
+        mr_cache->count--;
+    }
+
+    return lru_entry;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_mr_cache_entry_free(
+    struct na_ofi_domain *domain, struct na_ofi_mr_cache_entry *mr_entry)
+{
+    int rc;
+
+    na_ofi_domain_mr_lock(domain);
+    rc = fi_close(&mr_entry->fi_mr->fid);
+    na_ofi_domain_mr_unlock(domain);
+    NA_CHECK_SUBSYS_ERROR_NORET(mem, rc != 0, out,
+        "fi_close() mr_hdl failed, rc: %d (%s)", rc, fi_strerror(-rc));
+    hg_atomic_decr32(domain->mr_reg_count);
+
+out:
+    free(mr_entry);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_mr_cache_purge(struct na_ofi_domain *domain)
+{
+    struct na_ofi_mr_cache *mr_cache = &domain->mr_cache;
+
+    while (!HG_LIST_IS_EMPTY(&mr_cache->list)) {
+        struct na_ofi_mr_cache_entry *mr_entry = HG_LIST_FIRST(&mr_cache->list);
+
+        NA_CHECK_SUBSYS_WARNING(mem, mr_entry->refcount > 0,
+            "Cached MR (%p, %zu) is still in use", (void *) mr_entry->base,
+            mr_entry->len);
+        HG_LIST_REMOVE(mr_entry, entry);
+        mr_cache->count--;
+        na_ofi_mr_cache_entry_free(domain, mr_entry);
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
 na_ofi_iov_get_index_offset(const struct iovec *iov, unsigned long iovcnt,
@@ -3052,7 +4520,7 @@ na_ofi_rma(na_class_t *na_class, na_context_t *context, na_cb_type_t cb_type,
     na_offset_t local_offset,
     struct na_ofi_mem_handle *na_ofi_mem_handle_remote,
     na_offset_t remote_offset, na_size_t length,
-    struct na_ofi_addr *na_ofi_addr, na_uint8_t remote_id,
+    struct na_ofi_addr *na_ofi_addr, na_uint16_t remote_id,
     struct na_ofi_op_id *na_ofi_op_id)
 {
     struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
@@ -3082,6 +4550,8 @@ na_ofi_rma(na_class_t *na_class, na_context_t *context, na_cb_type_t cb_type,
     na_ofi_addr_addref(na_ofi_addr);
     na_ofi_op_id->addr = na_ofi_addr;
     hg_atomic_set32(&na_ofi_op_id->status, 0);
+    if (ctx->fi_rma_cq)
+        hg_atomic_incr32(&ctx->rma_count);
 
     /* Translate local offset */
     if (local_offset > 0)
@@ -3141,14 +4611,19 @@ na_ofi_rma(na_class_t *na_class, na_context_t *context, na_cb_type_t cb_type,
 
     na_ofi_op_id->info.rma.fi_addr =
         fi_rx_addr(na_ofi_addr->fi_addr, remote_id, NA_OFI_SEP_RX_CTX_BITS);
+    na_ofi_op_id->info.rma.chain = NULL;
 
     /* Set RMA msg */
     NA_OFI_MSG_RMA_SET(fi_msg_rma, liov, riov, na_ofi_op_id);
 
+    /* Operations are held while a batch is in progress */
+    if (na_ofi_op_batch_hold(na_class, ctx, na_ofi_op_id))
+        goto out;
+
     NA_LOG_SUBSYS_DEBUG(rma, "Posting RMA op (op id=%p)", na_ofi_op_id);
 
     /* Post the OFI RMA operation */
-    rc = fi_rma_op(ctx->fi_tx, &fi_msg_rma, fi_rma_flags);
+    rc = fi_rma_op(na_ofi_op_tx(ctx, na_ofi_op_id), &fi_msg_rma, fi_rma_flags);
     if (unlikely(rc == -FI_EAGAIN)) {
         if (NA_OFI_CLASS(na_class)->no_retry)
             /* Do not attempt to retry */
@@ -3179,17 +4654,18 @@ error:
 
     na_ofi_addr_decref(na_ofi_addr);
     hg_atomic_set32(&na_ofi_op_id->status, NA_OFI_OP_COMPLETED);
+    if (ctx->fi_rma_cq)
+        hg_atomic_decr32(&ctx->rma_count);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ofi_cq_read(na_context_t *context, size_t max_count,
+na_ofi_cq_read(na_context_t *context, struct fid_cq *cq_hdl, size_t max_count,
     struct fi_cq_tagged_entry cq_events[], fi_addr_t src_addrs[],
     void **src_err_addr, size_t *src_err_addrlen, size_t *actual_count)
 {
-    struct fid_cq *cq_hdl = NA_OFI_CONTEXT(context)->fi_cq;
     struct fi_cq_err_entry cq_err;
     na_return_t ret = NA_SUCCESS;
     ssize_t rc;
@@ -3221,6 +4697,14 @@ na_ofi_cq_read(na_context_t *context, size_t max_count,
         na_ofi_errno_to_na((int) -rc), "fi_cq_readerr() failed, rc: %d (%s)",
         rc, fi_strerror((int) -rc));
 
+    /* Errors on multi-recv buffers are not attached to an operation ID */
+    if (NA_OFI_CONTEXT(context)->multi_recv &&
+        na_ofi_cq_is_multi_recv_event(cq_err.flags) &&
+        cq_err.err != FI_EADDRNOTAVAIL) {
+        na_ofi_cq_process_multi_recv_error(&cq_err);
+        goto out;
+    }
+
     switch (cq_err.err) {
         case FI_ECANCELED: {
             struct na_ofi_op_id *na_ofi_op_id = NULL;
@@ -3238,6 +4722,10 @@ na_ofi_cq_read(na_context_t *context, size_t max_count,
             NA_LOG_SUBSYS_DEBUG(
                 op, "FI_ECANCELED event on operation ID %p", na_ofi_op_id);
 
+            /* Unsignaled ops are completed by the op that they precede */
+            if (hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_UNSIGNALED)
+                break;
+
             /* When tearing down connections, it is possible that operations
             will be canceled by libfabric itself.
 
@@ -3255,6 +4743,7 @@ na_ofi_cq_read(na_context_t *context, size_t max_count,
         case FI_EADDRNOTAVAIL:
             /* Only one error event processed in that case */
             memcpy(&cq_events[0], &cq_err, sizeof(cq_events[0]));
+            src_addrs[0] = FI_ADDR_UNSPEC;
             *src_err_addr = cq_err.err_data;
             *src_err_addrlen = cq_err.err_data_size;
             *actual_count = 1;
@@ -3285,7 +4774,7 @@ na_ofi_cq_read(na_context_t *context, size_t max_count,
                     out, ret, NA_FAULT, "Operation ID was completed");
 
                 if (hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_ERRORED) &
-                    NA_OFI_OP_CANCELED)
+                    (NA_OFI_OP_CANCELED | NA_OFI_OP_UNSIGNALED))
                     break;
 
                 /* Complete operation in error state */
@@ -3307,16 +4796,25 @@ na_ofi_cq_process_event(na_class_t *na_class,
     const struct fi_cq_tagged_entry *cq_event, fi_addr_t src_addr,
     void *src_err_addr, size_t src_err_addrlen)
 {
-    struct na_ofi_op_id *na_ofi_op_id =
-        container_of(cq_event->op_context, struct na_ofi_op_id, fi_ctx);
+    struct na_ofi_op_id *na_ofi_op_id = NULL;
     na_return_t ret = NA_SUCCESS;
 
+    /* Multi-recv buffers are not attached to an operation ID */
+    if (na_ofi_with_multi_recv(na_class) &&
+        na_ofi_cq_is_multi_recv_event(cq_event->flags))
+        return na_ofi_cq_process_multi_recv_event(
+            na_class, cq_event, src_addr, src_err_addr, src_err_addrlen);
+
+    na_ofi_op_id =
+        container_of(cq_event->op_context, struct na_ofi_op_id, fi_ctx);
     NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, out, ret, NA_INVALID_ARG,
         "Invalid operation ID");
     /* Cannot have an already completed operation ID, sanity check */
     NA_CHECK_SUBSYS_ERROR(op,
         hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED, out, ret,
         NA_FAULT, "Operation ID was completed");
+    HG_PROBE4(na, ofi_cq_event, na_ofi_op_id, cq_event->flags, cq_event->tag,
+        cq_event->len);
 
     if (cq_event->flags & FI_SEND) {
         ret = na_ofi_cq_process_send_event(na_ofi_op_id);
@@ -3334,7 +4832,7 @@ na_ofi_cq_process_event(na_class_t *na_class,
             NA_CHECK_SUBSYS_NA_ERROR(
                 msg, out, ret, "Could not process expected recv event");
         }
-    } else if (cq_event->flags & FI_RMA) {
+    } else if (cq_event->flags & (FI_RMA | FI_ATOMIC)) {
         ret = na_ofi_cq_process_rma_event(na_ofi_op_id);
         NA_CHECK_SUBSYS_NA_ERROR(rma, out, ret, "Could not process rma event");
     } else
@@ -3374,7 +4872,6 @@ na_ofi_cq_process_recv_unexpected_event(na_class_t *na_class,
     struct na_ofi_op_id *na_ofi_op_id, fi_addr_t src_addr, void *src_err_addr,
     size_t src_err_addrlen, uint64_t tag, size_t len)
 {
-    struct na_ofi_domain *domain = NA_OFI_CLASS(na_class)->domain;
     na_cb_type_t cb_type = na_ofi_op_id->completion_data.callback_info.type;
     struct na_ofi_addr *na_ofi_addr = NULL;
     na_return_t ret = NA_SUCCESS;
@@ -3385,6 +4882,67 @@ na_ofi_cq_process_recv_unexpected_event(na_class_t *na_class,
     NA_CHECK_SUBSYS_ERROR(msg, (tag & ~NA_OFI_UNEXPECTED_TAG) > NA_OFI_MAX_TAG,
         out, ret, NA_OVERFLOW, "Invalid tag value %llu", tag);
 
+    ret = na_ofi_cq_get_src_addr(na_class, src_addr, src_err_addr,
+        src_err_addrlen, na_ofi_op_id->info.msg.buf.ptr, &na_ofi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, out, ret, "Could not resolve source address");
+
+    na_ofi_op_id->addr = na_ofi_addr;
+    na_ofi_op_id->info.msg.tag = tag & NA_OFI_TAG_MASK;
+    na_ofi_op_id->info.msg.actual_buf_size = len;
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "unexpected recv msg completion event with tag=%llu, len=%zu ",
+        "(op id=%p)", tag, len, na_ofi_op_id);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_cq_get_src_addr(na_class_t *na_class, fi_addr_t src_addr,
+    void *src_err_addr, size_t src_err_addrlen, const void *msg_buf,
+    struct na_ofi_addr **na_ofi_addr_p)
+{
+    struct na_ofi_class *priv = NA_OFI_CLASS(na_class);
+    struct na_ofi_domain *domain = priv->domain;
+    na_uint32_t addr_format = na_ofi_prov_addr_format[domain->prov_type];
+    struct na_ofi_addr *na_ofi_addr = NULL;
+    const void *raw_addr = NULL;
+    na_size_t raw_addrlen = 0;
+    na_uint64_t key;
+    na_bool_t by_fi_addr = NA_FALSE;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Use src_addr when available */
+    if ((na_ofi_prov_extra_caps[domain->prov_type] & FI_SOURCE) &&
+        src_addr != FI_ADDR_UNSPEC) {
+        key = (na_uint64_t) src_addr;
+        by_fi_addr = NA_TRUE;
+    } else {
+        if (src_err_addr && src_err_addrlen) { /* addr from error info */
+            raw_addr = src_err_addr;
+            raw_addrlen = (na_size_t) src_err_addrlen;
+        } else if (na_ofi_with_msg_hdr(na_class)) { /* addr from msg header */
+            raw_addr = msg_buf;
+            raw_addrlen = na_ofi_prov_addr_size(addr_format);
+        } else
+            NA_GOTO_SUBSYS_ERROR(addr, out, ret, NA_PROTONOSUPPORT,
+                "Insufficient address information");
+
+        key = na_ofi_addr_to_key(addr_format, raw_addr, raw_addrlen);
+        NA_CHECK_SUBSYS_ERROR(addr, key == 0, out, ret, NA_PROTONOSUPPORT,
+            "Could not generate key from addr");
+    }
+
+    /* Repeated senders skip the AV hash-table and the allocation */
+    na_ofi_addr = na_ofi_addr_cache_get(priv, key, by_fi_addr);
+    if (na_ofi_addr) {
+        *na_ofi_addr_p = na_ofi_addr;
+        goto out;
+    }
+
     /* Allocate new address */
     na_ofi_addr = na_ofi_addr_alloc(domain);
     NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addr == NULL, out, ret, NA_NOMEM,
@@ -3392,37 +4950,19 @@ na_ofi_cq_process_recv_unexpected_event(na_class_t *na_class,
     /* Unexpected addresses do not need to set addr/addrlen info, fi_av_lookup()
      * can be used when needed. */
 
-    /* Use src_addr when available */
-    if ((na_ofi_prov_extra_caps[domain->prov_type] & FI_SOURCE) &&
-        src_addr != FI_ADDR_UNSPEC)
+    if (by_fi_addr)
         na_ofi_addr->fi_addr = src_addr;
-    else if (src_err_addr && src_err_addrlen) { /* addr from error info */
-        /* We do not need to keep a copy of src_err_addr */
-        ret = na_ofi_addr_ht_lookup(domain,
-            na_ofi_prov_addr_format[domain->prov_type], src_err_addr,
-            src_err_addrlen, &na_ofi_addr->fi_addr, &na_ofi_addr->ht_key);
-        NA_CHECK_SUBSYS_NA_ERROR(
-            addr, error, ret, "na_ofi_addr_ht_lookup() failed");
-    } else if (na_ofi_with_msg_hdr(na_class)) { /* addr from msg header */
-        /* We do not need to keep a copy of msg header */
-        ret = na_ofi_addr_ht_lookup(domain,
-            na_ofi_prov_addr_format[domain->prov_type],
-            na_ofi_op_id->info.msg.buf.ptr,
-            na_ofi_prov_addr_size(na_ofi_prov_addr_format[domain->prov_type]),
+    else {
+        /* We do not need to keep a copy of the raw address */
+        ret = na_ofi_addr_ht_lookup(domain, addr_format, raw_addr, raw_addrlen,
             &na_ofi_addr->fi_addr, &na_ofi_addr->ht_key);
         NA_CHECK_SUBSYS_NA_ERROR(
             addr, error, ret, "na_ofi_addr_ht_lookup() failed");
-    } else
-        NA_GOTO_SUBSYS_ERROR(addr, error, ret, NA_PROTONOSUPPORT,
-            "Insufficient address information");
+    }
 
-    na_ofi_op_id->addr = na_ofi_addr;
-    na_ofi_op_id->info.msg.tag = tag & NA_OFI_TAG_MASK;
-    na_ofi_op_id->info.msg.actual_buf_size = len;
+    na_ofi_addr_cache_put(priv, key, na_ofi_addr);
 
-    NA_LOG_SUBSYS_DEBUG(msg,
-        "unexpected recv msg completion event with tag=%llu, len=%zu ",
-        "(op id=%p)", tag, len, na_ofi_op_id);
+    *na_ofi_addr_p = na_ofi_addr;
 
 out:
     return ret;
@@ -3432,6 +4972,248 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static struct na_ofi_addr *
+na_ofi_addr_cache_get(
+    struct na_ofi_class *priv, na_uint64_t key, na_bool_t by_fi_addr)
+{
+    hg_atomic_int64_t *entry = &priv->addr_cache[NA_OFI_ADDR_CACHE_IDX(key)];
+    struct na_ofi_addr *na_ofi_addr =
+        (struct na_ofi_addr *) hg_atomic_get64(entry);
+    na_bool_t match;
+
+    /* Claim entry, address can no longer be released by another thread */
+    if (na_ofi_addr == NULL ||
+        !hg_atomic_cas64(entry, (hg_util_int64_t) na_ofi_addr, 0))
+        return NULL;
+
+    match = (by_fi_addr ? (na_uint64_t) na_ofi_addr->fi_addr
+                        : na_ofi_addr->ht_key) == key;
+    if (match && na_ofi_addr->remove) {
+        /* Address is being removed from the AV, do not reuse it */
+        na_ofi_addr_decref(na_ofi_addr);
+        return NULL;
+    }
+    if (match)
+        na_ofi_addr_addref(na_ofi_addr); /* for the caller */
+
+    /* Give entry back unless it was replaced meanwhile */
+    if (!hg_atomic_cas64(entry, 0, (hg_util_int64_t) na_ofi_addr))
+        na_ofi_addr_decref(na_ofi_addr);
+
+    return (match) ? na_ofi_addr : NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_addr_cache_put(struct na_ofi_class *priv, na_uint64_t key,
+    struct na_ofi_addr *na_ofi_addr)
+{
+    hg_atomic_int64_t *entry = &priv->addr_cache[NA_OFI_ADDR_CACHE_IDX(key)];
+    hg_util_int64_t old;
+
+    na_ofi_addr_addref(na_ofi_addr); /* for the cache */
+    do {
+        old = hg_atomic_get64(entry);
+    } while (!hg_atomic_cas64(entry, old, (hg_util_int64_t) na_ofi_addr));
+
+    if (old)
+        na_ofi_addr_decref((struct na_ofi_addr *) old);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_addr_cache_evict(
+    struct na_ofi_class *priv, struct na_ofi_addr *na_ofi_addr)
+{
+    na_uint64_t keys[2] = {(na_uint64_t) na_ofi_addr->fi_addr,
+        na_ofi_addr->ht_key};
+    int i;
+
+    /* Address may have been cached under either of its keys */
+    for (i = 0; i < 2; i++) {
+        if (hg_atomic_cas64(&priv->addr_cache[NA_OFI_ADDR_CACHE_IDX(keys[i])],
+                (hg_util_int64_t) na_ofi_addr, 0))
+            na_ofi_addr_decref(na_ofi_addr);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_addr_cache_flush(struct na_ofi_class *priv)
+{
+    unsigned int i;
+
+    for (i = 0; i < NA_OFI_ADDR_CACHE_SIZE; i++) {
+        struct na_ofi_addr *na_ofi_addr =
+            (struct na_ofi_addr *) hg_atomic_get64(&priv->addr_cache[i]);
+
+        if (na_ofi_addr) {
+            hg_atomic_set64(&priv->addr_cache[i], 0);
+            na_ofi_addr_decref(na_ofi_addr);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_bool_t
+na_ofi_cq_is_multi_recv_event(uint64_t flags)
+{
+    /* Last completion of a buffer may only report its release */
+    return (flags & FI_MULTI_RECV) ||
+           ((flags & (FI_MSG | FI_RECV)) == (FI_MSG | FI_RECV));
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_cq_process_multi_recv_event(na_class_t *na_class,
+    const struct fi_cq_tagged_entry *cq_event, fi_addr_t src_addr,
+    void *src_err_addr, size_t src_err_addrlen)
+{
+    struct na_ofi_mrecv_buf *mrecv_buf =
+        container_of(cq_event->op_context, struct na_ofi_mrecv_buf, fi_ctx);
+    na_return_t ret = NA_SUCCESS;
+
+    if (cq_event->flags & FI_RECV) {
+        ret = na_ofi_cq_process_multi_recv_msg(na_class, mrecv_buf->multi_recv,
+            cq_event, src_addr, src_err_addr, src_err_addrlen);
+        NA_CHECK_SUBSYS_ERROR_DONE(
+            msg, ret != NA_SUCCESS, "Could not process multi-recv message");
+    }
+
+    /* Provider releases the buffer once it cannot hold more messages, all
+     * messages have been copied out at this point so it can be reposted */
+    if (cq_event->flags & FI_MULTI_RECV) {
+        na_return_t post_ret;
+
+        NA_LOG_SUBSYS_DEBUG(
+            msg, "Multi-recv buffer %p was released", mrecv_buf->buf);
+
+        post_ret = na_ofi_mrecv_buf_post(mrecv_buf);
+        NA_CHECK_SUBSYS_ERROR_DONE(msg, post_ret != NA_SUCCESS,
+            "Could not repost multi-recv buffer");
+        if (ret == NA_SUCCESS)
+            ret = post_ret;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_cq_process_multi_recv_msg(na_class_t *na_class,
+    struct na_ofi_multi_recv *multi_recv,
+    const struct fi_cq_tagged_entry *cq_event, fi_addr_t src_addr,
+    void *src_err_addr, size_t src_err_addrlen)
+{
+    struct na_ofi_multi_recv *queues = multi_recv->queues;
+    struct na_ofi_unexpected_info *na_ofi_unexpected_info = NULL;
+    struct na_ofi_op_id *na_ofi_op_id = NULL;
+    struct na_ofi_context *op_ctx;
+    struct na_ofi_addr *na_ofi_addr = NULL;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(msg, !(cq_event->flags & FI_REMOTE_CQ_DATA), out,
+        ret, NA_PROTOCOL_ERROR, "No tag attached to unexpected message");
+    NA_CHECK_SUBSYS_ERROR(msg, cq_event->data > NA_OFI_MAX_TAG, out, ret,
+        NA_OVERFLOW, "Invalid tag value %llu", cq_event->data);
+
+    ret = na_ofi_cq_get_src_addr(na_class, src_addr, src_err_addr,
+        src_err_addrlen, cq_event->buf, &na_ofi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, out, ret, "Could not resolve source address");
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "multi-recv unexpected msg with tag=%llu, len=%zu (buf=%p)",
+        cq_event->data, cq_event->len, cq_event->buf);
+
+    /* Pop op ID from queue */
+    hg_thread_mutex_lock(&queues->unexpected_op_queue.mutex);
+    na_ofi_op_id = HG_QUEUE_FIRST(&queues->unexpected_op_queue.queue);
+    if (likely(na_ofi_op_id)) {
+        HG_QUEUE_POP_HEAD(&queues->unexpected_op_queue.queue, entry);
+        hg_atomic_and32(&na_ofi_op_id->status, ~NA_OFI_OP_QUEUED);
+    } else {
+        /* Keep a copy of the message in the unexpected message queue so
+         * that we can treat it later when a recv_unexpected is posted */
+        na_ofi_unexpected_info = (struct na_ofi_unexpected_info *) malloc(
+            sizeof(struct na_ofi_unexpected_info));
+        NA_CHECK_SUBSYS_ERROR(msg, na_ofi_unexpected_info == NULL, unlock,
+            ret, NA_NOMEM, "Could not allocate unexpected info");
+
+        na_ofi_unexpected_info->na_ofi_addr = na_ofi_addr;
+        na_ofi_unexpected_info->buf_size = (na_size_t) cq_event->len;
+        na_ofi_unexpected_info->tag = (na_tag_t) cq_event->data;
+
+        na_ofi_unexpected_info->buf = malloc(cq_event->len);
+        NA_CHECK_SUBSYS_ERROR(msg, na_ofi_unexpected_info->buf == NULL,
+            unlock, ret, NA_NOMEM, "Could not allocate unexpected info buf");
+        memcpy(na_ofi_unexpected_info->buf, cq_event->buf, cq_event->len);
+
+        hg_thread_spin_lock(&queues->unexpected_msg_queue.lock);
+        HG_QUEUE_PUSH_TAIL(&queues->unexpected_msg_queue.queue,
+            na_ofi_unexpected_info, entry);
+        hg_thread_spin_unlock(&queues->unexpected_msg_queue.lock);
+    }
+    hg_thread_mutex_unlock(&queues->unexpected_op_queue.mutex);
+
+    if (!na_ofi_op_id)
+        goto out;
+    op_ctx = NA_OFI_CONTEXT(na_ofi_op_id->context);
+
+    if (unlikely(cq_event->len > na_ofi_op_id->info.msg.buf_size)) {
+        NA_LOG_SUBSYS_WARNING(msg,
+            "Unexpected msg size too large for buffer (%zu), dropping it",
+            cq_event->len);
+        na_ofi_addr_decref(na_ofi_addr);
+        ret = na_ofi_complete(na_ofi_op_id, NA_MSGSIZE);
+        NA_CHECK_SUBSYS_NA_ERROR(op, out, ret, "Unable to complete operation");
+    } else {
+        /* Fill info and copy buffer */
+        na_ofi_op_id->addr = na_ofi_addr;
+        na_ofi_op_id->info.msg.tag = (na_tag_t) cq_event->data;
+        na_ofi_op_id->info.msg.actual_buf_size = cq_event->len;
+        memcpy(na_ofi_op_id->info.msg.buf.ptr, cq_event->buf, cq_event->len);
+
+        ret = na_ofi_complete(na_ofi_op_id, NA_SUCCESS);
+        NA_CHECK_SUBSYS_NA_ERROR(op, out, ret, "Unable to complete operation");
+    }
+
+    /* Op ID may belong to another context that is waiting on its own CQ */
+    if (op_ctx->multi_recv != multi_recv) {
+        ret = na_ofi_cq_signal(na_class, op_ctx);
+        NA_CHECK_SUBSYS_NA_ERROR(op, out, ret, "Could not signal CQ");
+    }
+
+out:
+    return ret;
+
+unlock:
+    hg_thread_mutex_unlock(&queues->unexpected_op_queue.mutex);
+    if (na_ofi_unexpected_info)
+        free(na_ofi_unexpected_info);
+    na_ofi_addr_decref(na_ofi_addr);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_cq_process_multi_recv_error(const struct fi_cq_err_entry *cq_err)
+{
+    struct na_ofi_mrecv_buf *mrecv_buf =
+        container_of(cq_err->op_context, struct na_ofi_mrecv_buf, fi_ctx);
+
+    NA_LOG_SUBSYS_WARNING(poll,
+        "Multi-recv buffer %p got err: %d (%s), prov_errno: %d", mrecv_buf->buf,
+        cq_err->err, fi_strerror(cq_err->err), cq_err->prov_errno);
+
+    /* Buffer is reposted on next progress if it is no longer in use */
+    if ((cq_err->flags & FI_MULTI_RECV) || cq_err->err == FI_ECANCELED) {
+        hg_atomic_set32(&mrecv_buf->posted, 0);
+        hg_atomic_incr32(&mrecv_buf->multi_recv->unposted_count);
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_return_t
 na_ofi_cq_process_recv_expected_event(
@@ -3453,30 +5235,403 @@ na_ofi_cq_process_recv_expected_event(
         "(op id=%p)",
         tag, len, na_ofi_op_id);
 
-out:
-    return ret;
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_return_t
+na_ofi_cq_process_rma_event(struct na_ofi_op_id *na_ofi_op_id)
+{
+    na_cb_type_t cb_type = na_ofi_op_id->completion_data.callback_info.type;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(rma,
+        cb_type != NA_CB_PUT && cb_type != NA_CB_GET && cb_type != NA_CB_ATOMIC,
+        out, ret, NA_INVALID_ARG,
+        "Invalid cb_type %d, expected NA_CB_PUT/GET/ATOMIC", cb_type);
+
+    NA_LOG_SUBSYS_DEBUG(rma, "RMA completion event (op id=%p)", na_ofi_op_id);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_cq_signal(na_class_t *na_class, struct na_ofi_context *ctx)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    /* Work around segfault on fi_cq_signal() in some providers */
+    if (na_ofi_prov_flags[NA_OFI_CLASS(na_class)->domain->prov_type] &
+        NA_OFI_SIGNAL) {
+        /* Signal CQ to wake up and no longer wait on FD */
+        int rc = fi_cq_signal(ctx->fi_cq);
+        NA_CHECK_SUBSYS_ERROR(poll, rc != 0 && rc != -ENOSYS, out, ret,
+            na_ofi_errno_to_na(-rc), "fi_cq_signal() failed, rc: %d (%s)", rc,
+            fi_strerror(-rc));
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static ssize_t
+na_ofi_op_post(na_class_t *na_class, struct na_ofi_context *ctx,
+    struct na_ofi_op_id *na_ofi_op_id, na_uint64_t flags, na_bool_t signaled)
+{
+    na_cb_type_t cb_type = na_ofi_op_id->completion_data.callback_info.type;
+    ssize_t rc;
+
+    switch (cb_type) {
+        case NA_CB_SEND_UNEXPECTED:
+        case NA_CB_SEND_EXPECTED: {
+            void *desc = na_ofi_op_id->info.msg.fi_mr;
+            void **descp = &desc;
+            struct iovec iov, *msg_iov = &iov;
+            size_t iov_count = 1;
+
+            if (na_ofi_op_id->info.msg.iovcnt > 0) {
+                /* Vector sends are only used without FI_MR_LOCAL */
+                msg_iov = na_ofi_op_id->info.msg.iov;
+                iov_count = na_ofi_op_id->info.msg.iovcnt;
+                descp = NULL;
+            } else {
+                iov.iov_base = (void *) na_ofi_op_id->info.msg.buf.const_ptr;
+                iov.iov_len = na_ofi_op_id->info.msg.buf_size;
+            }
+
+            if (cb_type == NA_CB_SEND_UNEXPECTED &&
+                na_ofi_with_multi_recv(na_class)) {
+                struct fi_msg fi_msg;
+
+                fi_msg.msg_iov = msg_iov;
+                fi_msg.desc = descp;
+                fi_msg.iov_count = iov_count;
+                fi_msg.addr = na_ofi_op_id->info.msg.fi_addr;
+                fi_msg.context = &na_ofi_op_id->fi_ctx;
+                fi_msg.data = na_ofi_op_id->info.msg.tag;
+
+                rc = fi_sendmsg(ctx->fi_tx, &fi_msg,
+                    FI_COMPLETION | FI_REMOTE_CQ_DATA | flags);
+            } else {
+                struct fi_msg_tagged fi_msg_tagged;
+
+                fi_msg_tagged.msg_iov = msg_iov;
+                fi_msg_tagged.desc = descp;
+                fi_msg_tagged.iov_count = iov_count;
+                fi_msg_tagged.addr = na_ofi_op_id->info.msg.fi_addr;
+                fi_msg_tagged.tag = (cb_type == NA_CB_SEND_UNEXPECTED)
+                                        ? na_ofi_op_id->info.msg.tag |
+                                              NA_OFI_UNEXPECTED_TAG
+                                        : na_ofi_op_id->info.msg.tag;
+                fi_msg_tagged.ignore = 0;
+                fi_msg_tagged.context = &na_ofi_op_id->fi_ctx;
+                fi_msg_tagged.data = 0;
+
+                rc = fi_tsendmsg(
+                    ctx->fi_tx, &fi_msg_tagged, FI_COMPLETION | flags);
+            }
+            break;
+        }
+        case NA_CB_PUT: {
+            struct fi_msg_rma fi_msg_rma;
+
+            NA_OFI_MSG_RMA_SET(fi_msg_rma, NA_OFI_MSG_IOV(na_ofi_op_id),
+                NA_OFI_RMA_IOV(na_ofi_op_id), na_ofi_op_id);
+            rc = fi_writemsg(na_ofi_op_tx(ctx, na_ofi_op_id), &fi_msg_rma,
+                (signaled ? NA_OFI_PUT_COMPLETION : FI_DELIVERY_COMPLETE) |
+                    flags);
+            break;
+        }
+        case NA_CB_GET: {
+            struct fi_msg_rma fi_msg_rma;
+
+            NA_OFI_MSG_RMA_SET(fi_msg_rma, NA_OFI_MSG_IOV(na_ofi_op_id),
+                NA_OFI_RMA_IOV(na_ofi_op_id), na_ofi_op_id);
+            rc = fi_readmsg(na_ofi_op_tx(ctx, na_ofi_op_id), &fi_msg_rma,
+                (signaled ? NA_OFI_GET_COMPLETION : 0) | flags);
+            break;
+        }
+        default:
+            rc = -FI_EINVAL;
+            break;
+    }
+
+    return rc;
+}
+
+/*---------------------------------------------------------------------------*/
+static ssize_t
+na_ofi_atomic_post(
+    struct na_ofi_context *ctx, struct na_ofi_op_id *na_ofi_op_id)
+{
+    struct na_ofi_rma_info *rma_info = &na_ofi_op_id->info.rma;
+    struct fi_ioc operand_ioc = {&rma_info->operands[0], 1};
+    struct fi_ioc compare_ioc = {&rma_info->operands[1], 1};
+    struct fi_ioc result_ioc = {rma_info->local_iov.s[0].iov_base, 1};
+    struct fi_rma_ioc rma_ioc = {
+        rma_info->remote_iov.s[0].addr, 1, rma_info->remote_iov.s[0].key};
+    struct fi_msg_atomic fi_msg_atomic;
+
+    /* Operands are small enough to be injected and are not registered */
+    fi_msg_atomic.msg_iov = &operand_ioc;
+    fi_msg_atomic.desc = NULL;
+    fi_msg_atomic.iov_count = 1;
+    fi_msg_atomic.addr = rma_info->fi_addr;
+    fi_msg_atomic.rma_iov = &rma_ioc;
+    fi_msg_atomic.rma_iov_count = 1;
+    fi_msg_atomic.datatype = FI_UINT64;
+    fi_msg_atomic.op = rma_info->fi_op;
+    fi_msg_atomic.context = &na_ofi_op_id->fi_ctx;
+    fi_msg_atomic.data = 0;
+
+    if (rma_info->fi_op == FI_CSWAP)
+        return fi_compare_atomicmsg(na_ofi_op_tx(ctx, na_ofi_op_id),
+            &fi_msg_atomic, &compare_ioc, NULL, 1, &result_ioc,
+            &rma_info->local_desc, 1, FI_COMPLETION);
+    else
+        return fi_fetch_atomicmsg(na_ofi_op_tx(ctx, na_ofi_op_id),
+            &fi_msg_atomic, &result_ioc, &rma_info->local_desc, 1,
+            FI_COMPLETION);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_ofi_op_batch_hold(na_class_t *na_class, struct na_ofi_context *ctx,
+    struct na_ofi_op_id *na_ofi_op_id)
+{
+    na_bool_t held = NA_FALSE;
+
+    if (hg_atomic_get32(&ctx->batch_count) == 0)
+        return NA_FALSE;
+
+    hg_thread_mutex_lock(&ctx->batch_mutex);
+    if (hg_atomic_get32(&ctx->batch_count) > 0) {
+        /* Previous op ID is no longer the last one of the batch */
+        na_ofi_op_batch_flush(na_class, ctx, na_ofi_op_id);
+
+        NA_LOG_SUBSYS_DEBUG(op, "Holding %p in batch", na_ofi_op_id);
+        ctx->batch_op_id = na_ofi_op_id;
+        held = NA_TRUE;
+    }
+    hg_thread_mutex_unlock(&ctx->batch_mutex);
+
+    return held;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_bool_t
+na_ofi_op_chainable(na_class_t *na_class,
+    const struct na_ofi_op_id *na_ofi_op_id,
+    const struct na_ofi_op_id *next_op_id)
+{
+    na_cb_type_t cb_type = na_ofi_op_id->completion_data.callback_info.type,
+                 next_cb_type = next_op_id->completion_data.callback_info.type;
+
+    /* Fence only orders operations that target the same peer */
+    return NA_OFI_CLASS(na_class)->selective_completion &&
+           (cb_type == NA_CB_PUT || cb_type == NA_CB_GET) &&
+           (next_cb_type == NA_CB_PUT || next_cb_type == NA_CB_GET) &&
+           na_ofi_op_id->info.rma.fi_addr == next_op_id->info.rma.fi_addr;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE struct fid_ep *
+na_ofi_op_tx(
+    const struct na_ofi_context *ctx, const struct na_ofi_op_id *na_ofi_op_id)
+{
+    na_cb_type_t cb_type = na_ofi_op_id->completion_data.callback_info.type;
+
+    return (ctx->fi_rma_tx && (cb_type == NA_CB_PUT || cb_type == NA_CB_GET ||
+                                  cb_type == NA_CB_ATOMIC))
+               ? ctx->fi_rma_tx
+               : ctx->fi_tx;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_op_batch_flush(na_class_t *na_class, struct na_ofi_context *ctx,
+    struct na_ofi_op_id *next_op_id)
+{
+    struct na_ofi_op_id *na_ofi_op_id = ctx->batch_op_id;
+    na_uint64_t flags = 0;
+    na_bool_t signaled = NA_TRUE;
+    na_return_t cb_ret;
+    ssize_t rc;
+
+    if (na_ofi_op_id == NULL)
+        return;
+    ctx->batch_op_id = NULL;
+
+    /* FI_MORE only defers posting until the next op on the same context */
+    if (next_op_id &&
+        na_ofi_op_tx(ctx, na_ofi_op_id) == na_ofi_op_tx(ctx, next_op_id))
+        flags = FI_MORE;
+
+    /* Intermediate RMA ops of a burst to the same peer do not generate CQ
+     * entries, the next op is fenced and completes them */
+    if (next_op_id && na_ofi_op_chainable(na_class, na_ofi_op_id, next_op_id)) {
+        hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_UNSIGNALED);
+        signaled = NA_FALSE;
+    } else if ((na_ofi_op_id->completion_data.callback_info.type ==
+                       NA_CB_PUT ||
+                   na_ofi_op_id->completion_data.callback_info.type ==
+                       NA_CB_GET) &&
+               na_ofi_op_id->info.rma.chain)
+        flags |= FI_FENCE;
+
+    rc = na_ofi_op_post(na_class, ctx, na_ofi_op_id, flags, signaled);
+    if (likely(rc == 0)) {
+        if (!signaled)
+            next_op_id->info.rma.chain = na_ofi_op_id;
+        return;
+    }
+
+    if (!signaled) {
+        /* Posted ops chained so far are completed by next op instead */
+        hg_atomic_and32(&na_ofi_op_id->status, ~NA_OFI_OP_UNSIGNALED);
+        next_op_id->info.rma.chain = na_ofi_op_id->info.rma.chain;
+        na_ofi_op_id->info.rma.chain = NULL;
+    }
+
+    if (rc == -FI_EAGAIN && !NA_OFI_CLASS(na_class)->no_retry) {
+        NA_LOG_SUBSYS_DEBUG(op, "Pushing %p for retry", na_ofi_op_id);
+
+        /* Push op ID to retry queue, retries do not set FI_MORE */
+        hg_thread_mutex_lock(&ctx->retry_op_queue->mutex);
+        HG_QUEUE_PUSH_TAIL(&ctx->retry_op_queue->queue, na_ofi_op_id, entry);
+        hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_QUEUED);
+        hg_thread_mutex_unlock(&ctx->retry_op_queue->mutex);
+        return;
+    }
+
+    /* Caller already returned, report error through callback */
+    NA_LOG_SUBSYS_ERROR(op, "Could not post held operation, rc: %d (%s)",
+        (int) rc, fi_strerror((int) -rc));
+    cb_ret = (rc == -FI_EAGAIN) ? NA_AGAIN : na_ofi_errno_to_na((int) -rc);
+    hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_ERRORED);
+    if (na_ofi_complete(na_ofi_op_id, cb_ret) != NA_SUCCESS)
+        NA_LOG_SUBSYS_ERROR(op, "Could not complete operation");
 }
 
 /*---------------------------------------------------------------------------*/
-static NA_INLINE na_return_t
-na_ofi_cq_process_rma_event(struct na_ofi_op_id *na_ofi_op_id)
+static na_return_t
+na_ofi_msg_sendv(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg, void *buf,
+    na_size_t buf_size, void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id)
 {
-    na_cb_type_t cb_type = na_ofi_op_id->completion_data.callback_info.type;
+    struct na_ofi_class *priv = NA_OFI_CLASS(na_class);
+    const struct fi_info *fi_prov = priv->domain->fi_prov;
+    struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
+    struct na_ofi_addr *na_ofi_addr = (struct na_ofi_addr *) dest_addr;
+    struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
+    na_size_t msg_size = buf_size, max_size, i;
     na_return_t ret = NA_SUCCESS;
+    ssize_t rc;
 
-    NA_CHECK_SUBSYS_ERROR(rma, cb_type != NA_CB_PUT && cb_type != NA_CB_GET,
-        out, ret, NA_INVALID_ARG, "Invalid cb_type %d, expected NA_CB_PUT/GET",
-        cb_type);
+    for (i = 0; i < segment_count; i++)
+        msg_size += segments[i].len;
+    max_size = (cb_type == NA_CB_SEND_UNEXPECTED) ? priv->unexpected_size_max
+                                                  : priv->expected_size_max;
+    NA_CHECK_SUBSYS_ERROR(msg, msg_size > max_size, out, ret, NA_OVERFLOW,
+        "Message size exceeds max size (%zu > %zu)", msg_size, max_size);
+
+    /* Segments are gathered if they would need local descriptors, if the
+     * provider cannot take that many or if the message can be injected */
+    if ((fi_prov->domain_attr->mr_mode & FI_MR_LOCAL) ||
+        segment_count + 1 > NA_OFI_IOV_STATIC_MAX ||
+        segment_count + 1 > fi_prov->tx_attr->iov_limit ||
+        msg_size <= priv->inject_size_max) {
+        for (i = 0; i < segment_count; i++) {
+            memcpy((char *) buf + buf_size, (const void *) segments[i].base,
+                segments[i].len);
+            buf_size += segments[i].len;
+        }
+        return (cb_type == NA_CB_SEND_UNEXPECTED)
+                   ? na_ofi_msg_send_unexpected(na_class, context, callback,
+                         arg, buf, buf_size, plugin_data, dest_addr, dest_id,
+                         tag, op_id)
+                   : na_ofi_msg_send_expected(na_class, context, callback,
+                         arg, buf, buf_size, plugin_data, dest_addr, dest_id,
+                         tag, op_id);
+    }
 
-    NA_LOG_SUBSYS_DEBUG(rma, "RMA completion event (op id=%p)", na_ofi_op_id);
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, out, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    na_ofi_op_id->context = context;
+    na_ofi_op_id->completion_data.callback_info.type = cb_type;
+    na_ofi_op_id->completion_data.callback = callback;
+    na_ofi_op_id->completion_data.callback_info.arg = arg;
+    na_ofi_addr_addref(na_ofi_addr);
+    na_ofi_op_id->addr = na_ofi_addr;
+    hg_atomic_set32(&na_ofi_op_id->status, 0);
+    na_ofi_op_id->info.msg.buf.const_ptr = buf;
+    na_ofi_op_id->info.msg.buf_size = buf_size;
+    na_ofi_op_id->info.msg.actual_buf_size = msg_size;
+    /* Specify target receive context */
+    na_ofi_op_id->info.msg.fi_addr =
+        fi_rx_addr(na_ofi_addr->fi_addr, dest_id, NA_OFI_SEP_RX_CTX_BITS);
+    na_ofi_op_id->info.msg.fi_mr = plugin_data;
+    na_ofi_op_id->info.msg.tag = tag;
+    na_ofi_op_id->info.msg.iov[0].iov_base = buf;
+    na_ofi_op_id->info.msg.iov[0].iov_len = buf_size;
+    for (i = 0; i < segment_count; i++) {
+        na_ofi_op_id->info.msg.iov[i + 1].iov_base = (void *) segments[i].base;
+        na_ofi_op_id->info.msg.iov[i + 1].iov_len = segments[i].len;
+    }
+    na_ofi_op_id->info.msg.iovcnt = segment_count + 1;
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "Posting msg send of %zu segments with tag=%llu (op id=%p)",
+        na_ofi_op_id->info.msg.iovcnt, tag, na_ofi_op_id);
+
+    /* Operations are held while a batch is in progress */
+    if (na_ofi_op_batch_hold(na_class, ctx, na_ofi_op_id))
+        goto out;
+
+    rc = na_ofi_op_post(na_class, ctx, na_ofi_op_id, 0, NA_TRUE);
+    if (unlikely(rc == -FI_EAGAIN)) {
+        if (priv->no_retry)
+            /* Do not attempt to retry */
+            NA_GOTO_DONE(error, ret, NA_AGAIN);
+        else {
+            NA_LOG_SUBSYS_DEBUG(op, "Pushing %p for retry", na_ofi_op_id);
+
+            /* Push op ID to retry queue */
+            hg_thread_mutex_lock(&ctx->retry_op_queue->mutex);
+            HG_QUEUE_PUSH_TAIL(
+                &ctx->retry_op_queue->queue, na_ofi_op_id, entry);
+            hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_QUEUED);
+            hg_thread_mutex_unlock(&ctx->retry_op_queue->mutex);
+        }
+    } else
+        NA_CHECK_SUBSYS_ERROR(msg, rc != 0, error, ret,
+            na_ofi_errno_to_na((int) -rc),
+            "fi_tsendmsg() failed, rc: %d (%s)", rc, fi_strerror((int) -rc));
 
 out:
     return ret;
+
+error:
+    na_ofi_addr_decref(na_ofi_addr);
+    hg_atomic_set32(&na_ofi_op_id->status, NA_OFI_OP_COMPLETED);
+
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ofi_cq_process_retries(na_context_t *context)
+na_ofi_cq_process_retries(na_class_t *na_class, na_context_t *context)
 {
     struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
     struct na_ofi_op_id *na_ofi_op_id = NULL;
@@ -3491,10 +5646,18 @@ na_ofi_cq_process_retries(na_context_t *context)
         if (!na_ofi_op_id)
             break;
 
+        /* Provider returned FI_EAGAIN recently, wait for the backoff to
+         * expire or for completions to release resources */
+        if (ctx->retry_op_queue->retry_ticks != 0 &&
+            hg_time_get_ticks() < ctx->retry_op_queue->retry_ticks)
+            break;
+
         NA_LOG_SUBSYS_DEBUG(op, "Attempting to retry %p", na_ofi_op_id);
         NA_CHECK_SUBSYS_ERROR(op,
             hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_CANCELED, error,
             ret, NA_FAULT, "Operation ID was canceled");
+        na_cb_retry_notify(
+            context, na_ofi_op_id->completion_data.callback_info.type);
 
         /* Dequeue OP ID */
         HG_QUEUE_POP_HEAD(&ctx->retry_op_queue->queue, entry);
@@ -3503,12 +5666,24 @@ na_ofi_cq_process_retries(na_context_t *context)
         /* Retry operation */
         switch (na_ofi_op_id->completion_data.callback_info.type) {
             case NA_CB_SEND_UNEXPECTED:
-                rc = fi_tsend(ctx->fi_tx, na_ofi_op_id->info.msg.buf.const_ptr,
-                    na_ofi_op_id->info.msg.buf_size,
-                    na_ofi_op_id->info.msg.fi_mr,
-                    na_ofi_op_id->info.msg.fi_addr,
-                    na_ofi_op_id->info.msg.tag | NA_OFI_UNEXPECTED_TAG,
-                    &na_ofi_op_id->fi_ctx);
+                if (na_ofi_op_id->info.msg.iovcnt > 0)
+                    rc = na_ofi_op_post(
+                        na_class, ctx, na_ofi_op_id, 0, NA_TRUE);
+                else if (na_ofi_with_multi_recv(na_class))
+                    rc = fi_senddata(ctx->fi_tx,
+                        na_ofi_op_id->info.msg.buf.const_ptr,
+                        na_ofi_op_id->info.msg.buf_size,
+                        na_ofi_op_id->info.msg.fi_mr,
+                        na_ofi_op_id->info.msg.tag,
+                        na_ofi_op_id->info.msg.fi_addr, &na_ofi_op_id->fi_ctx);
+                else
+                    rc = fi_tsend(ctx->fi_tx,
+                        na_ofi_op_id->info.msg.buf.const_ptr,
+                        na_ofi_op_id->info.msg.buf_size,
+                        na_ofi_op_id->info.msg.fi_mr,
+                        na_ofi_op_id->info.msg.fi_addr,
+                        na_ofi_op_id->info.msg.tag | NA_OFI_UNEXPECTED_TAG,
+                        &na_ofi_op_id->fi_ctx);
                 break;
             case NA_CB_RECV_UNEXPECTED:
                 rc = fi_trecv(ctx->fi_rx, na_ofi_op_id->info.msg.buf.ptr,
@@ -3518,11 +5693,16 @@ na_ofi_cq_process_retries(na_context_t *context)
                     NA_OFI_TAG_MASK, &na_ofi_op_id->fi_ctx);
                 break;
             case NA_CB_SEND_EXPECTED:
-                rc = fi_tsend(ctx->fi_tx, na_ofi_op_id->info.msg.buf.const_ptr,
-                    na_ofi_op_id->info.msg.buf_size,
-                    na_ofi_op_id->info.msg.fi_mr,
-                    na_ofi_op_id->info.msg.fi_addr, na_ofi_op_id->info.msg.tag,
-                    &na_ofi_op_id->fi_ctx);
+                if (na_ofi_op_id->info.msg.iovcnt > 0)
+                    rc = na_ofi_op_post(
+                        na_class, ctx, na_ofi_op_id, 0, NA_TRUE);
+                else
+                    rc = fi_tsend(ctx->fi_tx,
+                        na_ofi_op_id->info.msg.buf.const_ptr,
+                        na_ofi_op_id->info.msg.buf_size,
+                        na_ofi_op_id->info.msg.fi_mr,
+                        na_ofi_op_id->info.msg.fi_addr,
+                        na_ofi_op_id->info.msg.tag, &na_ofi_op_id->fi_ctx);
                 break;
             case NA_CB_RECV_EXPECTED:
                 rc = fi_trecv(ctx->fi_rx, na_ofi_op_id->info.msg.buf.ptr,
@@ -3538,8 +5718,9 @@ na_ofi_cq_process_retries(na_context_t *context)
 
                 /* Set RMA msg */
                 NA_OFI_MSG_RMA_SET(fi_msg_rma, msg_iov, rma_iov, na_ofi_op_id);
-                rc =
-                    fi_writemsg(ctx->fi_tx, &fi_msg_rma, NA_OFI_PUT_COMPLETION);
+                rc = fi_writemsg(na_ofi_op_tx(ctx, na_ofi_op_id), &fi_msg_rma,
+                    NA_OFI_PUT_COMPLETION |
+                        (na_ofi_op_id->info.rma.chain ? FI_FENCE : 0));
                 break;
             }
             case NA_CB_GET: {
@@ -3550,9 +5731,14 @@ na_ofi_cq_process_retries(na_context_t *context)
                 /* Set RMA msg */
                 NA_OFI_MSG_RMA_SET(fi_msg_rma, msg_iov, rma_iov, na_ofi_op_id);
 
-                rc = fi_readmsg(ctx->fi_tx, &fi_msg_rma, NA_OFI_GET_COMPLETION);
+                rc = fi_readmsg(na_ofi_op_tx(ctx, na_ofi_op_id), &fi_msg_rma,
+                    NA_OFI_GET_COMPLETION |
+                        (na_ofi_op_id->info.rma.chain ? FI_FENCE : 0));
                 break;
             }
+            case NA_CB_ATOMIC:
+                rc = na_ofi_atomic_post(ctx, na_ofi_op_id);
+                break;
             default:
                 NA_GOTO_SUBSYS_ERROR(op, error, ret, NA_INVALID_ARG,
                     "Operation type %d not supported",
@@ -3567,6 +5753,9 @@ na_ofi_cq_process_retries(na_context_t *context)
                 na_ofi_op_id, entry);
             hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_QUEUED);
 
+            /* Back off, doubling delay while attempts keep failing */
+            na_ofi_retry_backoff(NA_OFI_CONTEXT(context)->retry_op_queue);
+
             /* Do not attempt to retry again and continue making progress */
             break;
         } else
@@ -3576,6 +5765,9 @@ na_ofi_cq_process_retries(na_context_t *context)
                 na_ofi_op_id->completion_data.callback_info.type, rc,
                 fi_strerror((int) -rc));
 
+        NA_OFI_CONTEXT(context)->retry_op_queue->retry_ticks = 0;
+        NA_OFI_CONTEXT(context)->retry_op_queue->retry_backoff = 0;
+
         hg_thread_mutex_unlock(&NA_OFI_CONTEXT(context)->retry_op_queue->mutex);
 
     } while (1);
@@ -3596,11 +5788,26 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ofi_retry_backoff(struct na_ofi_queue *retry_op_queue)
+{
+    if (retry_op_queue->retry_backoff < NA_OFI_RETRY_BACKOFF_MIN)
+        retry_op_queue->retry_backoff = NA_OFI_RETRY_BACKOFF_MIN;
+    else if (retry_op_queue->retry_backoff < NA_OFI_RETRY_BACKOFF_MAX)
+        retry_op_queue->retry_backoff *= 2;
+
+    retry_op_queue->retry_ticks =
+        hg_time_get_ticks() +
+        hg_time_ticks_from_ns(retry_op_queue->retry_backoff);
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_complete(struct na_ofi_op_id *na_ofi_op_id, na_return_t cb_ret)
 {
     struct na_cb_info *callback_info = NULL;
+    struct na_ofi_op_id *chain = NULL;
     na_return_t ret = NA_SUCCESS;
     hg_util_int32_t status;
 
@@ -3650,12 +5857,23 @@ na_ofi_complete(struct na_ofi_op_id *na_ofi_op_id, na_return_t cb_ret)
                     na_ofi_op_id->info.msg.buf_size,
                 out, ret, NA_MSGSIZE,
                 "Expected recv msg size too large for buffer");
+            callback_info->info.recv_expected.actual_buf_size =
+                na_ofi_op_id->info.msg.actual_buf_size;
             break;
         case NA_CB_SEND_UNEXPECTED:
         case NA_CB_SEND_EXPECTED:
             break;
         case NA_CB_PUT:
         case NA_CB_GET:
+        case NA_CB_ATOMIC:
+            /* Op ID may be re-used as soon as it is added to the queue */
+            chain = na_ofi_op_id->info.rma.chain;
+            na_ofi_op_id->info.rma.chain = NULL;
+
+            if (NA_OFI_CONTEXT(na_ofi_op_id->context)->fi_rma_cq)
+                hg_atomic_decr32(
+                    &NA_OFI_CONTEXT(na_ofi_op_id->context)->rma_count);
+
             /* Can free extra IOVs here */
             if (na_ofi_op_id->info.rma.local_iovcnt > NA_OFI_IOV_STATIC_MAX) {
                 free(na_ofi_op_id->info.rma.local_iov.d);
@@ -3675,10 +5893,33 @@ na_ofi_complete(struct na_ofi_op_id *na_ofi_op_id, na_return_t cb_ret)
     /* Add OP to NA completion queue */
     na_cb_completion_add(na_ofi_op_id->context, &na_ofi_op_id->completion_data);
 
+    /* Fenced op completed, so did the ops that precede it */
+    if (chain)
+        na_ofi_complete_chain(chain, cb_ret);
+
 out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_complete_chain(struct na_ofi_op_id *chain, na_return_t cb_ret)
+{
+    while (chain) {
+        struct na_ofi_op_id *next = chain->info.rma.chain;
+        hg_util_int32_t status =
+            hg_atomic_and32(&chain->status, ~NA_OFI_OP_UNSIGNALED);
+
+        /* Error events of unsignaled ops were deferred until now */
+        chain->info.rma.chain = NULL;
+        if (na_ofi_complete(chain, (status & NA_OFI_OP_ERRORED)
+                                       ? NA_PROTOCOL_ERROR
+                                       : cb_ret) != NA_SUCCESS)
+            NA_LOG_SUBSYS_ERROR(op, "Could not complete chained operation");
+        chain = next;
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
 na_ofi_release(void *arg)
@@ -3721,7 +5962,8 @@ na_ofi_check_protocol(const char *protocol_name)
 #endif
 
     /* Get info from provider */
-    ret = na_ofi_getinfo(type, &providers, protocol_name);
+    ret = na_ofi_getinfo(type, NA_FALSE, NA_FALSE, FI_THREAD_SAFE, NULL,
+        &providers, protocol_name);
     NA_CHECK_SUBSYS_NA_ERROR(cls, out, ret, "na_ofi_getinfo() failed");
 
     prov = providers;
@@ -3749,7 +5991,7 @@ out:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
-    na_bool_t NA_UNUSED listen)
+    na_bool_t listen)
 {
     struct na_ofi_class *priv;
     void *src_addr = NULL;
@@ -3762,14 +6004,22 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
     char *domain_name_ptr = NULL;
     char domain_name[NA_OFI_MAX_URI_LEN] = {'\0'};
     na_bool_t no_wait = NA_FALSE, no_retry = NA_FALSE;
-    na_uint8_t context_max = 1; /* Default */
+    na_uint16_t context_max = 1; /* Default */
+    na_uint32_t rma_cq_budget = 0;
+    na_uint8_t multi_recv_count = 0;
+    na_bool_t shared_recv = NA_FALSE;
+    unsigned int mr_cache_max = 0;
+    na_bool_t mem_device = NA_FALSE;
+    na_uint8_t thread_mode = 0;
+    enum fi_threading threading = FI_THREAD_SAFE;
     const char *auth_key = NULL;
     na_size_t msg_size_max = 0;
+    na_bool_t auto_msg_size = NA_FALSE;
     na_size_t unexpected_size_max = 0;
     na_size_t expected_size_max = 0;
-#ifdef NA_OFI_HAS_MEM_POOL
-    struct na_ofi_mem_pool *na_ofi_mem_pool = NULL;
-#endif
+    struct na_ofi_discovery discovery;
+    struct na_ofi_discovery *discovery_ptr = NULL;
+    na_bool_t discovered = NA_FALSE;
     na_return_t ret = NA_SUCCESS;
     enum na_ofi_prov_type prov_type;
 
@@ -3797,6 +6047,59 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
         "\"export MPICH_GNI_NDREG_ENTRIES=1024\" to ensure compatibility.");
 #endif
 
+    /* Get init info */
+    if (na_info->na_init_info) {
+        /* Progress mode */
+        if (na_info->na_init_info->progress_mode & NA_NO_BLOCK)
+            no_wait = NA_TRUE;
+        if (na_info->na_init_info->progress_mode & NA_NO_RETRY)
+            no_retry = NA_TRUE;
+        /* Max contexts */
+        if (na_info->na_init_info->max_contexts)
+            context_max = na_info->na_init_info->max_contexts;
+        /* Auth key */
+        auth_key = na_info->na_init_info->auth_key;
+        /* Sizes */
+        if (na_info->na_init_info->max_unexpected_size)
+            unexpected_size_max = na_info->na_init_info->max_unexpected_size;
+        if (na_info->na_init_info->max_expected_size)
+            expected_size_max = na_info->na_init_info->max_expected_size;
+        auto_msg_size = na_info->na_init_info->auto_msg_size;
+        /* Multi-recv buffers */
+        multi_recv_count = na_info->na_init_info->multi_recv_count;
+        shared_recv = na_info->na_init_info->shared_recv;
+        /* MR cache */
+        mr_cache_max = na_info->na_init_info->mr_cache_size;
+        mem_device = na_info->na_init_info->request_mem_device;
+        /* Thread mode */
+        thread_mode = na_info->na_init_info->thread_mode;
+        /* Separate RMA CQ */
+        rma_cq_budget = na_info->na_init_info->rma_cq_budget;
+    }
+
+    /* RMA ops need their own transmit context to complete into another CQ */
+    if (rma_cq_budget > 0 && !(na_ofi_prov_flags[prov_type] & NA_OFI_SEP)) {
+        NA_LOG_SUBSYS_WARNING(cls,
+            "Separate RMA CQ requires SEP, using a single CQ per context");
+        rma_cq_budget = 0;
+    }
+
+    /* When each context is only accessed by one thread, each context can own
+     * its TX/RX resources and rely on the provider's relaxed threading model:
+     * FI_THREAD_ENDPOINT with a single endpoint, FI_THREAD_FID with SEP so
+     * that every TX/RX context and CQ can be used concurrently */
+    if (thread_mode & NA_THREAD_MODE_SINGLE_CTX) {
+        if (context_max == 1)
+            threading = FI_THREAD_ENDPOINT;
+        else if (na_ofi_prov_flags[prov_type] & NA_OFI_SEP)
+            threading = FI_THREAD_FID;
+        else
+            NA_LOG_SUBSYS_WARNING(cls,
+                "Single context thread mode with %d contexts requires SEP, "
+                "using FI_THREAD_SAFE",
+                context_max);
+    }
+
     /* Use default interface name if no hostname was passed */
     if (na_info->host_name) {
         host_name = strdup(na_info->host_name);
@@ -3819,8 +6122,43 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
     } else if (na_ofi_prov_addr_format[prov_type] == FI_ADDR_GNI)
         resolve_name = NA_OFI_GNI_IFACE_DEFAULT;
 
-    /* Get hostname/port info if available */
-    if (resolve_name) {
+    /* Processes of a node can skip discovery done by the first one */
+    if (na_info->na_init_info && na_info->na_init_info->discovery_cache) {
+        na_ofi_discovery_init(&discovery,
+            na_info->na_init_info->discovery_cache, na_info->protocol_name,
+            na_info->host_name, multi_recv_count > 0, mem_device, threading);
+        discovery_ptr = &discovery;
+        discovered = na_ofi_discovery_load(&discovery);
+    }
+
+    if (discovered) {
+        if (discovery.domain_name[0] != '\0') {
+            strcpy(domain_name, discovery.domain_name);
+            domain_name_ptr = domain_name;
+        }
+        if (discovery.ip[0] != '\0' &&
+            na_ofi_prov_addr_format[prov_type] == FI_SOCKADDR_IN) {
+            struct na_ofi_sin_addr *na_ofi_sin_addr;
+
+            na_ofi_sin_addr = calloc(1, sizeof(*na_ofi_sin_addr));
+            NA_CHECK_SUBSYS_ERROR(cls, na_ofi_sin_addr == NULL, out, ret,
+                NA_NOMEM, "Could not allocate sin address");
+            src_addr = na_ofi_sin_addr;
+            src_addrlen = sizeof(*na_ofi_sin_addr);
+
+            na_ofi_sin_addr->sin.sin_family = AF_INET;
+            na_ofi_sin_addr->sin.sin_port = htons(port & 0xffff);
+            NA_CHECK_SUBSYS_ERROR(cls,
+                inet_pton(AF_INET, discovery.ip,
+                    &na_ofi_sin_addr->sin.sin_addr) != 1,
+                out, ret, NA_ADDRNOTAVAIL, "Invalid cached IP %s",
+                discovery.ip);
+        } else if (discovery.ip[0] != '\0' &&
+                   na_ofi_prov_addr_format[prov_type] == FI_ADDR_GNI) {
+            strcpy(node, discovery.ip);
+            node_ptr = node;
+        }
+    } else if (resolve_name) { /* Get hostname/port info if available */
         if (na_ofi_prov_addr_format[prov_type] == FI_SOCKADDR_IN) {
             char *ifa_name;
             struct na_ofi_sin_addr *na_ofi_sin_addr = NULL;
@@ -3872,25 +6210,6 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
         }
     }
 
-    /* Get init info */
-    if (na_info->na_init_info) {
-        /* Progress mode */
-        if (na_info->na_init_info->progress_mode & NA_NO_BLOCK)
-            no_wait = NA_TRUE;
-        if (na_info->na_init_info->progress_mode & NA_NO_RETRY)
-            no_retry = NA_TRUE;
-        /* Max contexts */
-        if (na_info->na_init_info->max_contexts)
-            context_max = na_info->na_init_info->max_contexts;
-        /* Auth key */
-        auth_key = na_info->na_init_info->auth_key;
-        /* Sizes */
-        if (na_info->na_init_info->max_unexpected_size)
-            unexpected_size_max = na_info->na_init_info->max_unexpected_size;
-        if (na_info->na_init_info->max_expected_size)
-            expected_size_max = na_info->na_init_info->max_expected_size;
-    }
-
     /* Create private data */
     na_class->plugin_class =
         (struct na_ofi_class *) malloc(sizeof(struct na_ofi_class));
@@ -3903,23 +6222,69 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
     /* Initialize queue / mutex */
     hg_thread_mutex_init(&priv->mutex);
 
-    /* Initialize buf pool */
-    hg_thread_spin_init(&priv->buf_pool_lock);
-    HG_QUEUE_INIT(&priv->buf_pool);
+    priv->op_slab = na_op_slab_create(sizeof(struct na_ofi_op_id));
+    NA_CHECK_SUBSYS_ERROR(cls, priv->op_slab == NULL, out, ret, NA_NOMEM,
+        "Could not create op ID slab");
 
     /* Create/Open domain */
-    ret = na_ofi_domain_open(
-        prov_type, domain_name_ptr, auth_key, no_wait, &priv->domain);
+    ret = na_ofi_domain_open(prov_type, domain_name_ptr, auth_key, no_wait,
+        multi_recv_count > 0, mem_device, threading, mr_cache_max,
+        discovered ? &discovery : NULL, &priv->domain);
+    if (ret != NA_SUCCESS && discovered) {
+        /* Cached provider may no longer be available, do full discovery */
+        NA_LOG_SUBSYS_WARNING(cls, "Ignoring stale discovery cache %s",
+            discovery.path);
+        discovered = NA_FALSE;
+        ret = na_ofi_domain_open(prov_type, domain_name_ptr, auth_key, no_wait,
+            multi_recv_count > 0, mem_device, threading, mr_cache_max, NULL,
+            &priv->domain);
+    }
     NA_CHECK_SUBSYS_NA_ERROR(cls, out, ret, "Could not open domain for %s, %s",
         na_ofi_prov_name[prov_type], domain_name_ptr);
 
+    /* Share results with other processes of the node */
+    if (discovery_ptr && !discovered) {
+        if (src_addr)
+            (void) inet_ntop(AF_INET,
+                &((struct na_ofi_sin_addr *) src_addr)->sin.sin_addr,
+                discovery.ip, sizeof(discovery.ip));
+        else if (node_ptr)
+            strncpy(discovery.ip, node_ptr, sizeof(discovery.ip) - 1);
+        if (domain_name_ptr)
+            strncpy(discovery.domain_name, domain_name_ptr,
+                sizeof(discovery.domain_name) - 1);
+        strncpy(discovery.fabric_name,
+            priv->domain->fi_prov->fabric_attr->name,
+            sizeof(discovery.fabric_name) - 1);
+        strncpy(discovery.prov_domain_name,
+            priv->domain->fi_prov->domain_attr->name,
+            sizeof(discovery.prov_domain_name) - 1);
+        na_ofi_discovery_store(&discovery);
+    }
+
     /* Make sure that domain is configured as no_wait */
     NA_CHECK_SUBSYS_WARNING(cls, no_wait != priv->domain->no_wait,
         "Requested no_wait=%d, domain no_wait=%d", no_wait,
         priv->domain->no_wait);
     priv->no_wait = no_wait;
 
+    /* Place pools next to the NIC, sysfs is keyed by the device name */
+    if (na_class->numa_node == NA_NUMA_NODE_DEVICE) {
+        int numa_node = hg_mem_get_device_numa_node(
+            priv->domain->fi_prov->domain_attr->name);
+        if (numa_node >= 0)
+            na_class->numa_node = (na_int32_t) numa_node;
+        else
+            NA_LOG_SUBSYS_WARNING(cls, "Could not detect NUMA node of %s",
+                priv->domain->fi_prov->domain_attr->name);
+    }
+
     /* Set context limits */
+    NA_CHECK_SUBSYS_ERROR(fatal, context_max > NA_OFI_SEP_RX_CTX_MAX, out, ret,
+        NA_INVALID_ARG,
+        "Maximum number of requested contexts (%d) exceeds SEP addressing "
+        "limit (%d)",
+        context_max, NA_OFI_SEP_RX_CTX_MAX);
     NA_CHECK_SUBSYS_ERROR(fatal, context_max > priv->domain->context_max, out,
         ret, NA_INVALID_ARG,
         "Maximum number of requested contexts (%d) exceeds provider "
@@ -3927,32 +6292,63 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
         context_max, priv->domain->context_max);
     priv->context_max = context_max;
 
+    /* Each context uses a second transmit context for RMA */
+    if (rma_cq_budget > 0) {
+        NA_CHECK_SUBSYS_ERROR(fatal,
+            2 * (size_t) context_max >
+                priv->domain->fi_prov->domain_attr->tx_ctx_cnt,
+            out, ret, NA_INVALID_ARG,
+            "Separate RMA CQ requires %d transmit contexts, provider "
+            "limitation (%zu)",
+            2 * context_max, priv->domain->fi_prov->domain_attr->tx_ctx_cnt);
+        priv->rma_cq_budget = rma_cq_budget;
+    }
+
     /* Set msg size limits */
-    msg_size_max = priv->domain->eager_msg_size_max
-                       ? priv->domain->eager_msg_size_max
-                       : NA_OFI_MSG_SIZE;
+    if (priv->domain->eager_msg_size_max)
+        msg_size_max = priv->domain->eager_msg_size_max;
+    else if (auto_msg_size)
+        msg_size_max =
+            na_ofi_prov_msg_size_auto(prov_type, priv->domain->fi_prov);
+    else
+        msg_size_max = NA_OFI_MSG_SIZE;
     priv->unexpected_size_max =
         unexpected_size_max ? unexpected_size_max : msg_size_max;
     priv->expected_size_max =
         expected_size_max ? expected_size_max : msg_size_max;
 
 #ifdef NA_OFI_HAS_MEM_POOL
-    /* Register initial mempool */
-    na_ofi_mem_pool = na_ofi_mem_pool_create(na_class,
-        na_ofi_msg_get_max_unexpected_size(na_class), NA_OFI_MEM_BLOCK_COUNT);
-    NA_CHECK_SUBSYS_ERROR(cls, na_ofi_mem_pool == NULL, out, ret, NA_NOMEM,
-        "Could not create memory pool with %d blocks", NA_OFI_MEM_BLOCK_COUNT);
-    hg_thread_spin_lock(&priv->buf_pool_lock);
-    HG_QUEUE_PUSH_TAIL(&priv->buf_pool, na_ofi_mem_pool, entry);
-    hg_thread_spin_unlock(&priv->buf_pool_lock);
+    /* Register initial mempools (one size class per power of 2) */
+    ret = na_ofi_mem_pool_init(
+        na_class, priv->unexpected_size_max, priv->expected_size_max);
+    NA_CHECK_SUBSYS_NA_ERROR(cls, out, ret, "Could not create memory pools");
 #endif
 
     /* Cache IOV max */
     priv->iov_max = priv->domain->fi_prov->domain_attr->mr_iov_limit;
 
+    /* Cache inject size, messages up to that size do not need completions */
+    priv->inject_size_max = priv->domain->fi_prov->tx_attr->inject_size;
+
+    /* Endpoints were bound with selective completion if provider can fence */
+    priv->selective_completion =
+        (priv->domain->fi_prov->caps & FI_FENCE) ? NA_TRUE : NA_FALSE;
+
+    /* Tag of unexpected messages must fit in remote CQ data */
+    if (multi_recv_count > 0) {
+        size_t cq_data_size = priv->domain->fi_prov->domain_attr->cq_data_size;
+
+        NA_CHECK_SUBSYS_ERROR(fatal, cq_data_size < sizeof(na_uint32_t), out,
+            ret, NA_PROTONOSUPPORT,
+            "Provider CQ data size (%zu) too small to use multi-recv",
+            cq_data_size);
+        priv->multi_recv_count = multi_recv_count;
+    }
+
     /* Create endpoint */
     ret = na_ofi_endpoint_open(priv->domain, node_ptr, src_addr, src_addrlen,
-        priv->no_wait, priv->context_max, &priv->endpoint);
+        priv->no_wait, priv->context_max, priv->rma_cq_budget > 0,
+        &priv->endpoint);
     NA_CHECK_SUBSYS_NA_ERROR(
         cls, out, ret, "Could not create endpoint for %s", resolve_name);
 
@@ -3962,6 +6358,30 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
     NA_CHECK_SUBSYS_NA_ERROR(
         cls, out, ret, "Could not get address from endpoint");
 
+    /* Without SEP, all contexts share the endpoint's multi-recv buffers */
+    if (na_ofi_with_multi_recv(na_class) && listen &&
+        !na_ofi_with_sep(na_class)) {
+        ret = na_ofi_multi_recv_create(na_class, priv->endpoint->fi_ep,
+            priv->multi_recv_count, &priv->multi_recv);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            cls, out, ret, "Could not create multi-recv buffers");
+
+        ret = na_ofi_multi_recv_post(priv->multi_recv);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            cls, out, ret, "Could not post multi-recv buffers");
+    } else if (shared_recv && listen && na_ofi_with_sep(na_class)) {
+        /* With SEP, receive contexts keep their own buffers but unexpected
+         * messages are matched against a single queue of op IDs */
+        if (na_ofi_with_multi_recv(na_class)) {
+            ret = na_ofi_multi_recv_create(
+                na_class, NULL, 0, &priv->multi_recv);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                cls, out, ret, "Could not create shared unexpected queues");
+        } else
+            NA_LOG_SUBSYS_WARNING(cls,
+                "Shared unexpected recvs require multi-recv, ignoring");
+    }
+
 out:
     if (ret != NA_SUCCESS) {
         if (na_class->plugin_class) {
@@ -3984,6 +6404,14 @@ na_ofi_finalize(na_class_t *na_class)
     if (priv == NULL)
         goto out;
 
+    /* Check that unexpected op queue is empty */
+    if (priv->multi_recv) {
+        na_bool_t empty =
+            HG_QUEUE_IS_EMPTY(&priv->multi_recv->unexpected_op_queue.queue);
+        NA_CHECK_SUBSYS_ERROR(cls, empty == NA_FALSE, out, ret, NA_BUSY,
+            "Unexpected op queue should be empty");
+    }
+
     /* Close endpoint */
     if (priv->endpoint) {
         ret = na_ofi_endpoint_close(priv->endpoint);
@@ -3991,18 +6419,20 @@ na_ofi_finalize(na_class_t *na_class)
         priv->endpoint = NULL;
     }
 
-#ifdef NA_OFI_HAS_MEM_POOL
-    /* Free memory pool (must be done before trying to close the domain as
-     * the pool is holding memory handles) */
-    while (!HG_QUEUE_IS_EMPTY(&priv->buf_pool)) {
-        struct na_ofi_mem_pool *na_ofi_mem_pool =
-            HG_QUEUE_FIRST(&priv->buf_pool);
-        HG_QUEUE_POP_HEAD(&priv->buf_pool, entry);
-
-        na_ofi_mem_pool_destroy(na_class, na_ofi_mem_pool);
+    /* Free multi-recv buffers (endpoint must be closed first) */
+    if (priv->multi_recv) {
+        na_ofi_multi_recv_destroy(na_class, priv->multi_recv);
+        priv->multi_recv = NULL;
     }
+
+    /* Cached addresses hold a reference to the domain */
+    na_ofi_addr_cache_flush(priv);
+
+#ifdef NA_OFI_HAS_MEM_POOL
+    /* Free memory pools (must be done before trying to close the domain as
+     * the pools are holding memory handles) */
+    na_ofi_mem_pool_finalize(na_class);
 #endif
-    hg_thread_spin_destroy(&NA_OFI_CLASS(na_class)->buf_pool_lock);
 
     /* Close domain */
     if (priv->domain) {
@@ -4012,6 +6442,7 @@ na_ofi_finalize(na_class_t *na_class)
     }
 
     /* Close mutex / free private data */
+    na_op_slab_destroy(priv->op_slab);
     hg_thread_mutex_destroy(&priv->mutex);
     free(priv);
     na_class->plugin_class = NULL;
@@ -4022,7 +6453,7 @@ out:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id)
+na_ofi_context_create(na_class_t *na_class, void **context, na_uint16_t id)
 {
     struct na_ofi_class *priv = NA_OFI_CLASS(na_class);
     struct na_ofi_domain *domain = priv->domain;
@@ -4036,6 +6467,10 @@ na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id)
     NA_CHECK_SUBSYS_ERROR(ctx, ctx == NULL, out, ret, NA_NOMEM,
         "Could not allocate na_ofi_context");
     ctx->idx = id;
+    hg_atomic_init32(&ctx->cq_event_count, NA_OFI_CQ_EVENT_NUM);
+    hg_atomic_init32(&ctx->rma_count, 0);
+    hg_thread_mutex_init(&ctx->batch_mutex);
+    hg_atomic_init32(&ctx->batch_count, 0);
 
     /* If not using SEP, just point to endpoint objects */
     hg_thread_mutex_lock(&priv->mutex);
@@ -4046,6 +6481,7 @@ na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id)
         ctx->fi_cq = ep->fi_cq;
         ctx->fi_wait = ep->fi_wait;
         ctx->retry_op_queue = ep->retry_op_queue;
+        ctx->multi_recv = priv->multi_recv;
     } else {
         ctx->retry_op_queue = malloc(sizeof(struct na_ofi_queue));
         NA_CHECK_SUBSYS_ERROR(ctx, ctx->retry_op_queue == NULL, error, ret,
@@ -4054,6 +6490,8 @@ na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id)
         /* Initialize queue / mutex */
         HG_QUEUE_INIT(&ctx->retry_op_queue->queue);
         hg_thread_mutex_init(&ctx->retry_op_queue->mutex);
+        ctx->retry_op_queue->retry_ticks = 0;
+        ctx->retry_op_queue->retry_backoff = 0;
 
         NA_CHECK_SUBSYS_ERROR(fatal,
             priv->contexts >= priv->context_max || id >= priv->context_max,
@@ -4092,7 +6530,8 @@ na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id)
         NA_CHECK_SUBSYS_ERROR(ctx, rc < 0, error, ret, na_ofi_errno_to_na(-rc),
             "fi_rx_context() failed, rc: %d (%s)", rc, fi_strerror(-rc));
 
-        rc = fi_ep_bind(ctx->fi_tx, &ctx->fi_cq->fid, FI_TRANSMIT);
+        rc = fi_ep_bind(ctx->fi_tx, &ctx->fi_cq->fid,
+            NA_OFI_TX_BIND_FLAGS(domain->fi_prov));
         NA_CHECK_SUBSYS_ERROR(ctx, rc < 0, error, ret, na_ofi_errno_to_na(-rc),
             "fi_ep_bind() noc_tx failed, rc: %d (%s)", rc, fi_strerror(-rc));
 
@@ -4107,6 +6546,63 @@ na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id)
         rc = fi_enable(ctx->fi_rx);
         NA_CHECK_SUBSYS_ERROR(ctx, rc < 0, error, ret, na_ofi_errno_to_na(-rc),
             "fi_enable() noc_rx failed, rc: %d (%s)", rc, fi_strerror(-rc));
+
+        /* RMA ops are posted to a second transmit context that completes
+         * into its own CQ, which progress polls after the message CQ */
+        if (priv->rma_cq_budget > 0) {
+            struct fi_cq_attr rma_cq_attr = {0};
+
+            rma_cq_attr.wait_obj = FI_WAIT_NONE;
+            rma_cq_attr.format = FI_CQ_FORMAT_TAGGED;
+            rma_cq_attr.size = NA_OFI_CQ_DEPTH;
+            rc = fi_cq_open(
+                domain->fi_domain, &rma_cq_attr, &ctx->fi_rma_cq, NULL);
+            NA_CHECK_SUBSYS_ERROR(ctx, rc < 0, error, ret,
+                na_ofi_errno_to_na(-rc), "fi_cq_open() RMA failed, rc: %d (%s)",
+                rc, fi_strerror(-rc));
+
+            rc = fi_tx_context(ep->fi_ep, priv->context_max + id, NULL,
+                &ctx->fi_rma_tx, NULL);
+            NA_CHECK_SUBSYS_ERROR(ctx, rc < 0, error, ret,
+                na_ofi_errno_to_na(-rc),
+                "fi_tx_context() RMA failed, rc: %d (%s)", rc,
+                fi_strerror(-rc));
+
+            rc = fi_ep_bind(ctx->fi_rma_tx, &ctx->fi_rma_cq->fid,
+                NA_OFI_TX_BIND_FLAGS(domain->fi_prov));
+            NA_CHECK_SUBSYS_ERROR(ctx, rc < 0, error, ret,
+                na_ofi_errno_to_na(-rc),
+                "fi_ep_bind() RMA tx failed, rc: %d (%s)", rc,
+                fi_strerror(-rc));
+
+            rc = fi_enable(ctx->fi_rma_tx);
+            NA_CHECK_SUBSYS_ERROR(ctx, rc < 0, error, ret,
+                na_ofi_errno_to_na(-rc),
+                "fi_enable() RMA tx failed, rc: %d (%s)", rc, fi_strerror(-rc));
+        }
+
+        /* Each receive context has its own multi-recv buffers, when
+         * unexpected recvs are shared, buffers are split across contexts */
+        if (na_ofi_with_multi_recv(na_class) && na_class->listen) {
+            na_uint8_t buf_count = priv->multi_recv_count;
+
+            if (priv->multi_recv) {
+                buf_count = (na_uint8_t)(buf_count / priv->context_max);
+                if (buf_count < NA_OFI_MULTI_RECV_SHARED_MIN)
+                    buf_count = NA_OFI_MULTI_RECV_SHARED_MIN;
+            }
+
+            ret = na_ofi_multi_recv_create(
+                na_class, ctx->fi_rx, buf_count, &ctx->multi_recv);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                ctx, error, ret, "Could not create multi-recv buffers");
+            if (priv->multi_recv)
+                ctx->multi_recv->queues = priv->multi_recv;
+
+            ret = na_ofi_multi_recv_post(ctx->multi_recv);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                ctx, error, ret, "Could not post multi-recv buffers");
+        }
     }
 
     priv->contexts++;
@@ -4119,10 +6615,20 @@ out:
 
 error:
     hg_thread_mutex_unlock(&priv->mutex);
+    if (ctx->fi_rma_tx)
+        fi_close(&ctx->fi_rma_tx->fid);
+    if (ctx->fi_rma_cq)
+        fi_close(&ctx->fi_rma_cq->fid);
+    if (na_ofi_with_sep(na_class) && ctx->multi_recv) {
+        /* Buffers may have been posted already */
+        fi_close(&ctx->fi_rx->fid);
+        na_ofi_multi_recv_destroy(na_class, ctx->multi_recv);
+    }
     if (na_ofi_with_sep(na_class) && ctx->retry_op_queue) {
         hg_thread_mutex_destroy(&ctx->retry_op_queue->mutex);
         free(ctx->retry_op_queue);
     }
+    hg_thread_mutex_destroy(&ctx->batch_mutex);
     free(ctx);
     return ret;
 }
@@ -4136,6 +6642,9 @@ na_ofi_context_destroy(na_class_t *na_class, void *context)
     na_return_t ret = NA_SUCCESS;
     int rc;
 
+    NA_CHECK_SUBSYS_ERROR(ctx, ctx->batch_op_id != NULL, out, ret, NA_BUSY,
+        "Batch of operations was not ended");
+
     if (na_ofi_with_sep(na_class)) {
         na_bool_t empty;
 
@@ -4144,6 +6653,23 @@ na_ofi_context_destroy(na_class_t *na_class, void *context)
         NA_CHECK_SUBSYS_ERROR(ctx, empty == NA_FALSE, out, ret, NA_BUSY,
             "Retry op queue should be empty");
 
+        /* Check that unexpected op queue has no op ID from that context */
+        if (ctx->multi_recv) {
+            struct na_ofi_queue *op_queue =
+                &ctx->multi_recv->queues->unexpected_op_queue;
+            struct na_ofi_op_id *na_ofi_op_id;
+
+            hg_thread_mutex_lock(&op_queue->mutex);
+            HG_QUEUE_FOREACH (na_ofi_op_id, &op_queue->queue, entry) {
+                if (NA_OFI_CONTEXT(na_ofi_op_id->context) == ctx)
+                    break;
+            }
+            hg_thread_mutex_unlock(&op_queue->mutex);
+            empty = (na_ofi_op_id == NULL);
+            NA_CHECK_SUBSYS_ERROR(ctx, empty == NA_FALSE, out, ret, NA_BUSY,
+                "Unexpected op queue should be empty");
+        }
+
         if (ctx->fi_tx) {
             rc = fi_close(&ctx->fi_tx->fid);
             NA_CHECK_SUBSYS_ERROR(ctx, rc != 0, out, ret,
@@ -4160,6 +6686,20 @@ na_ofi_context_destroy(na_class_t *na_class, void *context)
             ctx->fi_rx = NULL;
         }
 
+        if (ctx->fi_rma_tx) {
+            rc = fi_close(&ctx->fi_rma_tx->fid);
+            NA_CHECK_SUBSYS_ERROR(ctx, rc != 0, out, ret,
+                na_ofi_errno_to_na(-rc),
+                "fi_close() RMA tx failed, rc: %d (%s)", rc, fi_strerror(-rc));
+            ctx->fi_rma_tx = NULL;
+        }
+
+        /* Free multi-recv buffers (receive context must be closed first) */
+        if (ctx->multi_recv) {
+            na_ofi_multi_recv_destroy(na_class, ctx->multi_recv);
+            ctx->multi_recv = NULL;
+        }
+
         /* Close wait set */
         if (ctx->fi_wait) {
             rc = fi_close(&ctx->fi_wait->fid);
@@ -4178,6 +6718,14 @@ na_ofi_context_destroy(na_class_t *na_class, void *context)
             ctx->fi_cq = NULL;
         }
 
+        if (ctx->fi_rma_cq) {
+            rc = fi_close(&ctx->fi_rma_cq->fid);
+            NA_CHECK_SUBSYS_ERROR(ctx, rc != 0, out, ret,
+                na_ofi_errno_to_na(-rc),
+                "fi_close() RMA CQ failed, rc: %d (%s)", rc, fi_strerror(-rc));
+            ctx->fi_rma_cq = NULL;
+        }
+
         hg_thread_mutex_destroy(&ctx->retry_op_queue->mutex);
         free(ctx->retry_op_queue);
     }
@@ -4186,6 +6734,7 @@ na_ofi_context_destroy(na_class_t *na_class, void *context)
     priv->contexts--;
     hg_thread_mutex_unlock(&priv->mutex);
 
+    hg_thread_mutex_destroy(&ctx->batch_mutex);
     free(ctx);
 
 out:
@@ -4194,14 +6743,15 @@ out:
 
 /*---------------------------------------------------------------------------*/
 static na_op_id_t *
-na_ofi_op_create(na_class_t NA_UNUSED *na_class)
+na_ofi_op_create(na_class_t *na_class)
 {
     struct na_ofi_op_id *na_ofi_op_id = NULL;
 
-    na_ofi_op_id =
-        (struct na_ofi_op_id *) calloc(1, sizeof(struct na_ofi_op_id));
+    na_ofi_op_id = (struct na_ofi_op_id *) na_op_slab_alloc(
+        NA_OFI_CLASS(na_class)->op_slab);
     NA_CHECK_SUBSYS_ERROR_NORET(op, na_ofi_op_id == NULL, out,
         "Could not allocate NA OFI operation ID");
+    memset(na_ofi_op_id, 0, sizeof(struct na_ofi_op_id));
 
     /* Completed by default */
     hg_atomic_init32(&na_ofi_op_id->status, NA_OFI_OP_COMPLETED);
@@ -4216,7 +6766,7 @@ out:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ofi_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+na_ofi_op_destroy(na_class_t *na_class, na_op_id_t *op_id)
 {
     struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
     na_return_t ret = NA_SUCCESS;
@@ -4225,7 +6775,7 @@ na_ofi_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
         !(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED), out,
         ret, NA_BUSY, "Attempting to free OP ID that was not completed");
 
-    free(na_ofi_op_id);
+    na_op_slab_free(NA_OFI_CLASS(na_class)->op_slab, na_ofi_op_id);
 
 out:
     return ret;
@@ -4279,6 +6829,61 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_addr_lookup_batch(na_class_t *na_class, const char *const names[],
+    na_size_t count, na_addr_t addrs[])
+{
+    struct na_ofi_domain *domain = NA_OFI_CLASS(na_class)->domain;
+    na_uint32_t addr_format = na_ofi_prov_addr_format[domain->prov_type];
+    struct na_ofi_addr **na_ofi_addrs = NULL;
+    na_size_t i;
+    na_return_t ret = NA_SUCCESS;
+
+    na_ofi_addrs = (struct na_ofi_addr **) calloc(count, sizeof(*na_ofi_addrs));
+    NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addrs == NULL, out, ret, NA_NOMEM,
+        "Could not allocate array of addrs");
+
+    /* Convert all names first */
+    for (i = 0; i < count; i++) {
+        NA_CHECK_SUBSYS_ERROR(fatal,
+            na_ofi_addr_prov(names[i]) != domain->prov_type, error, ret,
+            NA_INVALID_ARG, "Unrecognized provider type found from: %s",
+            names[i]);
+
+        na_ofi_addrs[i] = na_ofi_addr_alloc(domain);
+        NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addrs[i] == NULL, error, ret,
+            NA_NOMEM, "na_ofi_addr_alloc() failed");
+        na_ofi_addrs[i]->uri = strdup(names[i]);
+        NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addrs[i]->uri == NULL, error, ret,
+            NA_NOMEM, "strdup() of URI failed");
+
+        ret = na_ofi_str_to_addr(names[i], addr_format, &na_ofi_addrs[i]->addr,
+            &na_ofi_addrs[i]->addrlen);
+        NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret,
+            "Could not convert string to address (%s)", names[i]);
+    }
+
+    /* Lookup addresses */
+    ret = na_ofi_addr_ht_lookup_batch(domain, addr_format, na_ofi_addrs, count);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret,
+        "na_ofi_addr_ht_lookup_batch() of %zu addrs failed", (size_t) count);
+
+    for (i = 0; i < count; i++)
+        addrs[i] = (na_addr_t) na_ofi_addrs[i];
+
+out:
+    free(na_ofi_addrs);
+    return ret;
+
+error:
+    for (i = 0; i < count; i++)
+        if (na_ofi_addrs[i])
+            na_ofi_addr_decref(na_ofi_addrs[i]);
+    free(na_ofi_addrs);
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_return_t
 na_ofi_addr_free(na_class_t NA_UNUSED *na_class, na_addr_t addr)
@@ -4290,10 +6895,14 @@ na_ofi_addr_free(na_class_t NA_UNUSED *na_class, na_addr_t addr)
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_return_t
-na_ofi_addr_set_remove(na_class_t NA_UNUSED *na_class, na_addr_t addr)
+na_ofi_addr_set_remove(na_class_t *na_class, na_addr_t addr)
 {
     ((struct na_ofi_addr *) addr)->remove = NA_TRUE;
 
+    /* Last reference must not be held by the cache */
+    na_ofi_addr_cache_evict(
+        NA_OFI_CLASS(na_class), (struct na_ofi_addr *) addr);
+
     return NA_SUCCESS;
 }
 
@@ -4501,21 +7110,83 @@ na_ofi_addr_deserialize(na_class_t *na_class, na_addr_t *addr, const void *buf,
 
     /* Skip URI generation, URI will only be generated when needed */
 
-    /* Lookup address */
-    ret = na_ofi_addr_ht_lookup(domain,
-        na_ofi_prov_addr_format[domain->prov_type], na_ofi_addr->addr,
-        na_ofi_addr->addrlen, &na_ofi_addr->fi_addr, &na_ofi_addr->ht_key);
-    NA_CHECK_SUBSYS_NA_ERROR(
-        addr, error, ret, "na_ofi_addr_ht_lookup() failed");
+    /* Lookup address */
+    ret = na_ofi_addr_ht_lookup(domain,
+        na_ofi_prov_addr_format[domain->prov_type], na_ofi_addr->addr,
+        na_ofi_addr->addrlen, &na_ofi_addr->fi_addr, &na_ofi_addr->ht_key);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, error, ret, "na_ofi_addr_ht_lookup() failed");
+
+    *addr = (na_addr_t) na_ofi_addr;
+
+out:
+    return ret;
+
+error:
+    free(na_ofi_addr->addr);
+    free(na_ofi_addr);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_addr_deserialize_batch(na_class_t *na_class, const void *buf,
+    na_size_t entry_size, na_size_t count, na_addr_t addrs[])
+{
+    struct na_ofi_domain *domain = NA_OFI_CLASS(na_class)->domain;
+    struct na_ofi_addr **na_ofi_addrs = NULL;
+    na_size_t i;
+    na_return_t ret = NA_SUCCESS;
+
+    na_ofi_addrs = (struct na_ofi_addr **) calloc(count, sizeof(*na_ofi_addrs));
+    NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addrs == NULL, out, ret, NA_NOMEM,
+        "Could not allocate array of addrs");
+
+    /* Decode all entries first */
+    for (i = 0; i < count; i++) {
+        const na_uint8_t *p = (const na_uint8_t *) buf + i * entry_size;
+
+        na_ofi_addrs[i] = na_ofi_addr_alloc(domain);
+        NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addrs[i] == NULL, error, ret,
+            NA_NOMEM, "na_ofi_addr_alloc() failed");
+
+        NA_CHECK_SUBSYS_ERROR(addr,
+            entry_size < sizeof(na_ofi_addrs[i]->addrlen), error, ret,
+            NA_OVERFLOW, "Entry size too small for deserializing address");
+        memcpy(&na_ofi_addrs[i]->addrlen, p, sizeof(na_ofi_addrs[i]->addrlen));
+        p += sizeof(na_ofi_addrs[i]->addrlen);
+        NA_CHECK_SUBSYS_ERROR(addr,
+            na_ofi_addrs[i]->addrlen >
+                entry_size - sizeof(na_ofi_addrs[i]->addrlen),
+            error, ret, NA_OVERFLOW,
+            "Addr len (%zu) exceeds entry size (%zu)",
+            (size_t) na_ofi_addrs[i]->addrlen, (size_t) entry_size);
+
+        na_ofi_addrs[i]->addr = malloc(na_ofi_addrs[i]->addrlen);
+        NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addrs[i]->addr == NULL, error, ret,
+            NA_NOMEM, "Could not allocate %zu bytes for address",
+            na_ofi_addrs[i]->addrlen);
+        memcpy(na_ofi_addrs[i]->addr, p, na_ofi_addrs[i]->addrlen);
+    }
+
+    /* Lookup addresses, missing ones are inserted into the AV at once */
+    ret = na_ofi_addr_ht_lookup_batch(domain,
+        na_ofi_prov_addr_format[domain->prov_type], na_ofi_addrs, count);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret,
+        "na_ofi_addr_ht_lookup_batch() of %zu addrs failed", (size_t) count);
 
-    *addr = (na_addr_t) na_ofi_addr;
+    for (i = 0; i < count; i++)
+        addrs[i] = (na_addr_t) na_ofi_addrs[i];
 
 out:
+    free(na_ofi_addrs);
     return ret;
 
 error:
-    free(na_ofi_addr->addr);
-    free(na_ofi_addr);
+    for (i = 0; i < count; i++)
+        if (na_ofi_addrs[i])
+            na_ofi_addr_decref(na_ofi_addrs[i]);
+    free(na_ofi_addrs);
     return ret;
 }
 
@@ -4563,7 +7234,7 @@ na_ofi_msg_buf_alloc(na_class_t *na_class, na_size_t size, void **plugin_data)
     NA_CHECK_SUBSYS_ERROR_NORET(
         mem, mem_ptr == NULL, out, "Could not allocate buffer from pool");
 #else
-    mem_ptr = na_ofi_mem_alloc(na_class, size, &mr_hdl);
+    mem_ptr = na_ofi_mem_alloc(na_class, size, NA_FALSE, &mr_hdl);
     NA_CHECK_SUBSYS_ERROR_NORET(
         mem, mem_ptr == NULL, out, "Could not allocate %d bytes", (int) size);
 #endif
@@ -4582,7 +7253,7 @@ na_ofi_msg_buf_free(na_class_t *na_class, void *buf, void *plugin_data)
 #ifdef NA_OFI_HAS_MEM_POOL
     na_ofi_mem_pool_free(na_class, buf, mr_hdl);
 #else
-    na_ofi_mem_free(na_class, buf, mr_hdl);
+    na_ofi_mem_free(na_class, buf, 0, mr_hdl);
 #endif
 
     return NA_SUCCESS;
@@ -4615,7 +7286,7 @@ out:
 static na_return_t
 na_ofi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id)
 {
     struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
@@ -4647,15 +7318,44 @@ na_ofi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
         fi_rx_addr(na_ofi_addr->fi_addr, dest_id, NA_OFI_SEP_RX_CTX_BITS);
     na_ofi_op_id->info.msg.fi_mr = plugin_data;
     na_ofi_op_id->info.msg.tag = tag;
+    na_ofi_op_id->info.msg.iovcnt = 0;
 
     NA_LOG_SUBSYS_DEBUG(msg,
         "Posting unexpected msg send with tag=%llu (op id=%p)",
         tag | NA_OFI_UNEXPECTED_TAG, na_ofi_op_id);
 
-    /* Post the FI unexpected send request */
-    rc = fi_tsend(ctx->fi_tx, buf, buf_size, na_ofi_op_id->info.msg.fi_mr,
-        na_ofi_op_id->info.msg.fi_addr, tag | NA_OFI_UNEXPECTED_TAG,
-        &na_ofi_op_id->fi_ctx);
+    /* Operations are held while a batch is in progress */
+    if (na_ofi_op_batch_hold(na_class, ctx, na_ofi_op_id))
+        goto out;
+
+    /* Small messages are injected, buffer can be re-used immediately and no
+     * CQ entry is generated so complete op ID right away */
+    if (buf_size <= NA_OFI_CLASS(na_class)->inject_size_max) {
+        if (na_ofi_with_multi_recv(na_class))
+            rc = fi_injectdata(
+                ctx->fi_tx, buf, buf_size, tag, na_ofi_op_id->info.msg.fi_addr);
+        else
+            rc = fi_tinject(ctx->fi_tx, buf, buf_size,
+                na_ofi_op_id->info.msg.fi_addr, tag | NA_OFI_UNEXPECTED_TAG);
+        if (likely(rc == 0)) {
+            ret = na_ofi_complete(na_ofi_op_id, NA_SUCCESS);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                op, out, ret, "Could not complete operation");
+            goto out;
+        }
+        /* Otherwise go through regular send path that can be retried */
+    }
+
+    /* Post the FI unexpected send request (multi-recv buffers only match
+     * untagged messages, tag is then passed as remote CQ data) */
+    if (na_ofi_with_multi_recv(na_class))
+        rc = fi_senddata(ctx->fi_tx, buf, buf_size,
+            na_ofi_op_id->info.msg.fi_mr, tag, na_ofi_op_id->info.msg.fi_addr,
+            &na_ofi_op_id->fi_ctx);
+    else
+        rc = fi_tsend(ctx->fi_tx, buf, buf_size, na_ofi_op_id->info.msg.fi_mr,
+            na_ofi_op_id->info.msg.fi_addr, tag | NA_OFI_UNEXPECTED_TAG,
+            &na_ofi_op_id->fi_ctx);
     if (unlikely(rc == -FI_EAGAIN)) {
         if (NA_OFI_CLASS(na_class)->no_retry)
             /* Do not attempt to retry */
@@ -4686,6 +7386,19 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_msg_send_unexpectedv(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id)
+{
+    return na_ofi_msg_sendv(na_class, context, NA_CB_SEND_UNEXPECTED, callback,
+        arg, buf, buf_size, plugin_data, segments, segment_count, dest_addr,
+        dest_id, tag, op_id);
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
@@ -4718,6 +7431,13 @@ na_ofi_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
     na_ofi_op_id->info.msg.fi_mr = plugin_data;
     na_ofi_op_id->info.msg.tag = 0;
 
+    if (ctx->multi_recv) {
+        ret = na_ofi_multi_recv_match(ctx->multi_recv, na_ofi_op_id);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            msg, error, ret, "Could not match unexpected msg recv");
+        goto out;
+    }
+
     NA_LOG_SUBSYS_DEBUG(
         msg, "Posting unexpected msg recv (op id=%p)", na_ofi_op_id);
 
@@ -4758,7 +7478,7 @@ error:
 static na_return_t
 na_ofi_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id)
 {
     struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
@@ -4790,11 +7510,28 @@ na_ofi_msg_send_expected(na_class_t *na_class, na_context_t *context,
         fi_rx_addr(na_ofi_addr->fi_addr, dest_id, NA_OFI_SEP_RX_CTX_BITS);
     na_ofi_op_id->info.msg.fi_mr = plugin_data;
     na_ofi_op_id->info.msg.tag = tag;
+    na_ofi_op_id->info.msg.iovcnt = 0;
 
     NA_LOG_SUBSYS_DEBUG(msg,
         "Posting expected msg send with tag=%llu (op id=%p)", tag,
         na_ofi_op_id);
 
+    /* Operations are held while a batch is in progress */
+    if (na_ofi_op_batch_hold(na_class, ctx, na_ofi_op_id))
+        goto out;
+
+    /* Small messages are injected, see above */
+    if (buf_size <= NA_OFI_CLASS(na_class)->inject_size_max) {
+        rc = fi_tinject(ctx->fi_tx, buf, buf_size,
+            na_ofi_op_id->info.msg.fi_addr, tag);
+        if (likely(rc == 0)) {
+            ret = na_ofi_complete(na_ofi_op_id, NA_SUCCESS);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                op, out, ret, "Could not complete operation");
+            goto out;
+        }
+    }
+
     /* Post the FI expected send request */
     rc = fi_tsend(ctx->fi_tx, buf, buf_size, na_ofi_op_id->info.msg.fi_mr,
         na_ofi_op_id->info.msg.fi_addr, tag, &na_ofi_op_id->fi_ctx);
@@ -4828,11 +7565,24 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_msg_send_expectedv(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, const struct na_segment *segments,
+    na_size_t segment_count, na_addr_t dest_addr, na_uint16_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id)
+{
+    return na_ofi_msg_sendv(na_class, context, NA_CB_SEND_EXPECTED, callback,
+        arg, buf, buf_size, plugin_data, segments, segment_count, dest_addr,
+        dest_id, tag, op_id);
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t source_addr, na_uint8_t source_id,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
     na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
@@ -5061,10 +7811,24 @@ na_ofi_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle)
         iov = &null_iov;
     }
 
+    /* Reuse cached registrations of contiguous regions */
+    if (domain->mr_cache.count_max > 0 && iov != &null_iov && count == 1) {
+        ret = na_ofi_mr_cache_get(
+            domain, iov, access, &na_ofi_mem_handle->mr_cache_entry);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, out, ret, "Could not get cached MR");
+
+        na_ofi_mem_handle->fi_mr = na_ofi_mem_handle->mr_cache_entry->fi_mr;
+        na_ofi_mem_handle->desc.info.fi_mr_key =
+            fi_mr_key(na_ofi_mem_handle->fi_mr);
+        goto out;
+    }
+
     /* Register region */
+    na_ofi_domain_mr_lock(domain);
     rc = fi_mr_regv(domain->fi_domain, iov, count, access, 0 /* offset */,
         0 /* requested key */, 0 /* flags */, &na_ofi_mem_handle->fi_mr,
         NULL /* context */);
+    na_ofi_domain_mr_unlock(domain);
     NA_CHECK_SUBSYS_ERROR(mem, rc != 0, out, ret, na_ofi_errno_to_na(-rc),
         "fi_mr_regv() failed, rc: %d (%s), mr_reg_count: %d", rc,
         fi_strerror(-rc), hg_atomic_get32(domain->mr_reg_count));
@@ -5078,6 +7842,86 @@ out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_mem_register_attr(na_class_t *na_class, na_mem_handle_t mem_handle,
+    na_mem_type_t mem_type, na_uint64_t device)
+{
+#ifdef FI_HMEM
+    struct na_ofi_mem_handle *na_ofi_mem_handle =
+        (struct na_ofi_mem_handle *) mem_handle;
+    struct na_ofi_domain *domain = NA_OFI_CLASS(na_class)->domain;
+    struct fi_mr_attr mr_attr = {0};
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    NA_CHECK_SUBSYS_ERROR(mem, !na_ofi_with_hmem(domain), out, ret,
+        NA_OPNOTSUPPORTED,
+        "Domain was not opened with device memory support "
+        "(see na_init_info.request_mem_device)");
+
+    switch (mem_type) {
+        case NA_MEM_TYPE_CUDA:
+            mr_attr.iface = FI_HMEM_CUDA;
+            mr_attr.device.cuda = (int) device;
+            break;
+        case NA_MEM_TYPE_ROCM:
+            mr_attr.iface = FI_HMEM_ROCR;
+            break;
+        case NA_MEM_TYPE_ZE:
+            mr_attr.iface = FI_HMEM_ZE;
+            mr_attr.device.ze = (int) device;
+            break;
+        default:
+            NA_GOTO_SUBSYS_ERROR(
+                mem, out, ret, NA_INVALID_ARG, "Invalid memory type");
+    }
+
+    switch (na_ofi_mem_handle->desc.info.flags) {
+        case NA_MEM_READ_ONLY:
+            mr_attr.access = FI_REMOTE_READ | FI_WRITE;
+            break;
+        case NA_MEM_WRITE_ONLY:
+            mr_attr.access = FI_REMOTE_WRITE | FI_READ;
+            break;
+        case NA_MEM_READWRITE:
+            mr_attr.access =
+                FI_READ | FI_WRITE | FI_REMOTE_READ | FI_REMOTE_WRITE;
+            break;
+        default:
+            NA_GOTO_SUBSYS_ERROR(
+                mem, out, ret, NA_INVALID_ARG, "Invalid memory access flag");
+    }
+
+    /* Device memory is always registered and never cached (the MR cache
+     * only tracks host regions), even with FI_MR_SCALABLE providers */
+    mr_attr.mr_iov = NA_OFI_IOV(na_ofi_mem_handle);
+    mr_attr.iov_count = na_ofi_mem_handle->desc.info.iovcnt;
+
+    na_ofi_domain_mr_lock(domain);
+    rc = fi_mr_regattr(
+        domain->fi_domain, &mr_attr, 0 /* flags */, &na_ofi_mem_handle->fi_mr);
+    na_ofi_domain_mr_unlock(domain);
+    NA_CHECK_SUBSYS_ERROR(mem, rc != 0, out, ret, na_ofi_errno_to_na(-rc),
+        "fi_mr_regattr() failed, rc: %d (%s), mr_reg_count: %d", rc,
+        fi_strerror(-rc), hg_atomic_get32(domain->mr_reg_count));
+    hg_atomic_incr32(domain->mr_reg_count);
+
+    na_ofi_mem_handle->desc.info.fi_mr_key =
+        fi_mr_key(na_ofi_mem_handle->fi_mr);
+
+out:
+    return ret;
+#else
+    (void) na_class;
+    (void) mem_handle;
+    (void) mem_type;
+    (void) device;
+
+    return NA_OPNOTSUPPORTED;
+#endif
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
@@ -5088,12 +7932,24 @@ na_ofi_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
     na_return_t ret = NA_SUCCESS;
     int rc;
 
-    if (!(domain->fi_prov->domain_attr->mr_mode & FI_MR_ALLOCATED) ||
-        !na_ofi_mem_handle->fi_mr)
+    /* Handles of FI_MR_SCALABLE providers share the global MR, unless they
+     * were registered with device memory */
+    if (!na_ofi_mem_handle->fi_mr || na_ofi_mem_handle->sub ||
+        na_ofi_mem_handle->fi_mr == domain->fi_mr)
         goto out;
 
+    /* Cached MRs are only released */
+    if (na_ofi_mem_handle->mr_cache_entry) {
+        na_ofi_mr_cache_put(domain, na_ofi_mem_handle->mr_cache_entry);
+        na_ofi_mem_handle->mr_cache_entry = NULL;
+        na_ofi_mem_handle->fi_mr = NULL;
+        goto out;
+    }
+
     /* close MR handle */
+    na_ofi_domain_mr_lock(domain);
     rc = fi_close(&na_ofi_mem_handle->fi_mr->fid);
+    na_ofi_domain_mr_unlock(domain);
     NA_CHECK_SUBSYS_ERROR(mem, rc != 0, out, ret, na_ofi_errno_to_na(-rc),
         "fi_close() mr_hdl failed, rc: %d (%s)", rc, fi_strerror(-rc));
     hg_atomic_decr32(domain->mr_reg_count);
@@ -5102,6 +7958,89 @@ out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_mem_handle_create_sub(na_class_t *na_class,
+    na_mem_handle_t parent_handle, void *buf, na_size_t buf_size,
+    unsigned long flags, na_mem_handle_t *mem_handle)
+{
+    struct na_ofi_domain *domain = NA_OFI_CLASS(na_class)->domain;
+    struct na_ofi_mem_handle *parent =
+        (struct na_ofi_mem_handle *) parent_handle;
+    struct na_ofi_mem_handle *na_ofi_mem_handle = NULL;
+    const char *parent_base = (const char *) parent->desc.iov.s[0].iov_base;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Sub-regions can only be addressed with virtual addresses */
+    if (!(domain->fi_prov->domain_attr->mr_mode & FI_MR_VIRT_ADDR)) {
+        ret = NA_OPNOTSUPPORTED;
+        goto done;
+    }
+
+    NA_CHECK_SUBSYS_ERROR(mem, parent->fi_mr == NULL, done, ret,
+        NA_INVALID_ARG, "Parent handle is not registered");
+    NA_CHECK_SUBSYS_ERROR(mem,
+        parent->desc.info.iovcnt != 1 || (const char *) buf < parent_base ||
+            (const char *) buf + buf_size >
+                parent_base + parent->desc.iov.s[0].iov_len,
+        done, ret, NA_INVALID_ARG, "Buffer is not within parent region");
+    NA_CHECK_SUBSYS_ERROR(mem,
+        ((flags & 0xff) & parent->desc.info.flags) != (flags & 0xff), done, ret,
+        NA_PERMISSION, "Access flags are not granted by parent handle");
+
+    na_ofi_mem_handle = (struct na_ofi_mem_handle *) calloc(
+        1, sizeof(struct na_ofi_mem_handle));
+    NA_CHECK_SUBSYS_ERROR(mem, na_ofi_mem_handle == NULL, done, ret, NA_NOMEM,
+        "Could not allocate NA OFI memory handle");
+
+    na_ofi_mem_handle->desc.iov.s[0].iov_base = buf;
+    na_ofi_mem_handle->desc.iov.s[0].iov_len = buf_size;
+    na_ofi_mem_handle->desc.info.iovcnt = 1;
+    na_ofi_mem_handle->desc.info.flags = flags & 0xff;
+    na_ofi_mem_handle->desc.info.len = buf_size;
+
+    /* Registration covers the whole parent region, virtual addresses of the
+     * sub-region can be used with the same key */
+    na_ofi_mem_handle->desc.info.fi_mr_key = parent->desc.info.fi_mr_key;
+    na_ofi_mem_handle->fi_mr = parent->fi_mr;
+    na_ofi_mem_handle->sub = NA_TRUE;
+
+    *mem_handle = (na_mem_handle_t) na_ofi_mem_handle;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_op_batch_begin(na_class_t NA_UNUSED *na_class, na_context_t *context)
+{
+    hg_atomic_incr32(&NA_OFI_CONTEXT(context)->batch_count);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_op_batch_end(na_class_t *na_class, na_context_t *context)
+{
+    struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
+    na_return_t ret = NA_SUCCESS;
+
+    hg_thread_mutex_lock(&ctx->batch_mutex);
+    NA_CHECK_SUBSYS_ERROR(op, hg_atomic_get32(&ctx->batch_count) <= 0, unlock,
+        ret, NA_INVALID_ARG, "No batch of operations was started");
+
+    /* Last operation of outermost batch rings the doorbell */
+    if (hg_atomic_decr32(&ctx->batch_count) == 0)
+        na_ofi_op_batch_flush(na_class, ctx, NULL);
+
+unlock:
+    hg_thread_mutex_unlock(&ctx->batch_mutex);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_size_t
 na_ofi_mem_handle_get_serialize_size(
@@ -5155,6 +8094,7 @@ na_ofi_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
         "Could not allocate NA OFI memory handle");
     na_ofi_mem_handle->desc.iov.d = NULL;
     na_ofi_mem_handle->fi_mr = NULL;
+    na_ofi_mem_handle->mr_cache_entry = NULL;
 
     /* Descriptor info */
     NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_ofi_mem_handle->desc.info,
@@ -5193,7 +8133,7 @@ static na_return_t
 na_ofi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id)
 {
     na_return_t ret = NA_SUCCESS;
@@ -5214,7 +8154,7 @@ static na_return_t
 na_ofi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id)
 {
     na_return_t ret = NA_SUCCESS;
@@ -5230,6 +8170,132 @@ out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare,
+    na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t remote_addr, na_uint16_t remote_id, na_op_id_t *op_id)
+{
+    struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
+    struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
+    struct na_ofi_mem_handle *na_ofi_mem_handle_local =
+        (struct na_ofi_mem_handle *) local_mem_handle;
+    struct na_ofi_mem_handle *na_ofi_mem_handle_remote =
+        (struct na_ofi_mem_handle *) remote_mem_handle;
+    struct na_ofi_addr *na_ofi_addr = (struct na_ofi_addr *) remote_addr;
+    struct iovec *local_iov = NA_OFI_IOV(na_ofi_mem_handle_local),
+                 *remote_iov = NA_OFI_IOV(na_ofi_mem_handle_remote);
+    unsigned long local_iovcnt = na_ofi_mem_handle_local->desc.info.iovcnt,
+                  remote_iovcnt = na_ofi_mem_handle_remote->desc.info.iovcnt;
+    unsigned long local_index = 0, remote_index = 0;
+    na_offset_t local_iov_offset = 0, remote_iov_offset = 0;
+    na_return_t ret = NA_SUCCESS;
+    ssize_t rc;
+
+    NA_CHECK_SUBSYS_ERROR(rma,
+        na_ofi_mem_handle_remote->desc.info.flags != NA_MEM_READWRITE ||
+            na_ofi_mem_handle_local->desc.info.flags == NA_MEM_READ_ONLY,
+        out, ret, NA_PERMISSION,
+        "Registered memory requires read/write permission");
+
+    /* Value must be contained within a single segment on both sides */
+    na_ofi_iov_get_index_offset(local_iov, local_iovcnt, local_offset,
+        &local_index, &local_iov_offset);
+    na_ofi_iov_get_index_offset(remote_iov, remote_iovcnt, remote_offset,
+        &remote_index, &remote_iov_offset);
+    NA_CHECK_SUBSYS_ERROR(rma,
+        local_index >= local_iovcnt || remote_index >= remote_iovcnt ||
+            local_iov[local_index].iov_len - local_iov_offset <
+                sizeof(na_uint64_t) ||
+            remote_iov[remote_index].iov_len - remote_iov_offset <
+                sizeof(na_uint64_t),
+        out, ret, NA_OVERFLOW, "Atomic value must not span segments");
+
+    NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, out, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    na_ofi_op_id->context = context;
+    na_ofi_op_id->completion_data.callback_info.type = NA_CB_ATOMIC;
+    na_ofi_op_id->completion_data.callback = callback;
+    na_ofi_op_id->completion_data.callback_info.arg = arg;
+    na_ofi_addr_addref(na_ofi_addr);
+    na_ofi_op_id->addr = na_ofi_addr;
+    hg_atomic_set32(&na_ofi_op_id->status, 0);
+    if (ctx->fi_rma_cq)
+        hg_atomic_incr32(&ctx->rma_count);
+
+    /* Previous value is fetched into local memory */
+    na_ofi_op_id->info.rma.local_iovcnt = 1;
+    na_ofi_iov_translate(local_iov, local_iovcnt, local_index,
+        local_iov_offset, sizeof(na_uint64_t),
+        na_ofi_op_id->info.rma.local_iov.s, 1);
+    na_ofi_op_id->info.rma.local_desc =
+        fi_mr_desc(na_ofi_mem_handle_local->fi_mr);
+    na_ofi_op_id->info.rma.remote_iovcnt = 1;
+    na_ofi_rma_iov_translate(remote_iov, remote_iovcnt,
+        na_ofi_mem_handle_remote->desc.info.fi_mr_key, remote_index,
+        remote_iov_offset, sizeof(na_uint64_t),
+        na_ofi_op_id->info.rma.remote_iov.s, 1);
+    na_ofi_op_id->info.rma.fi_addr =
+        fi_rx_addr(na_ofi_addr->fi_addr, remote_id, NA_OFI_SEP_RX_CTX_BITS);
+    na_ofi_op_id->info.rma.chain = NULL;
+    na_ofi_op_id->info.rma.operands[0] = operand;
+    na_ofi_op_id->info.rma.operands[1] = compare;
+    switch (op) {
+        case NA_ATOMIC_FETCH_ADD:
+            na_ofi_op_id->info.rma.fi_op = FI_SUM;
+            break;
+        case NA_ATOMIC_COMPARE_SWAP:
+            na_ofi_op_id->info.rma.fi_op = FI_CSWAP;
+            break;
+        case NA_ATOMIC_SWAP:
+            na_ofi_op_id->info.rma.fi_op = FI_ATOMIC_WRITE;
+            break;
+        default:
+            NA_GOTO_SUBSYS_ERROR(
+                rma, error, ret, NA_INVALID_ARG, "Invalid atomic op (%d)", op);
+    }
+
+    NA_LOG_SUBSYS_DEBUG(rma, "Posting atomic op (op id=%p)", na_ofi_op_id);
+
+    /* Atomics are never held by batches, which only fence RMA ops */
+    rc = na_ofi_atomic_post(ctx, na_ofi_op_id);
+    if (unlikely(rc == -FI_EAGAIN)) {
+        if (NA_OFI_CLASS(na_class)->no_retry)
+            /* Do not attempt to retry */
+            NA_GOTO_DONE(error, ret, NA_AGAIN);
+        else {
+            NA_LOG_SUBSYS_DEBUG(op, "Pushing %p for retry", na_ofi_op_id);
+
+            /* Push op ID to retry queue */
+            hg_thread_mutex_lock(&ctx->retry_op_queue->mutex);
+            HG_QUEUE_PUSH_TAIL(
+                &ctx->retry_op_queue->queue, na_ofi_op_id, entry);
+            hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_QUEUED);
+            hg_thread_mutex_unlock(&ctx->retry_op_queue->mutex);
+        }
+    } else
+        NA_CHECK_SUBSYS_ERROR(rma, rc != 0, error, ret,
+            na_ofi_errno_to_na((int) -rc), "fi_atomic op failed, rc: %d (%s)",
+            rc, fi_strerror((int) -rc));
+
+out:
+    return ret;
+
+error:
+    na_ofi_addr_decref(na_ofi_addr);
+    hg_atomic_set32(&na_ofi_op_id->status, NA_OFI_OP_COMPLETED);
+    if (ctx->fi_rma_cq)
+        hg_atomic_decr32(&ctx->rma_count);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE int
 na_ofi_poll_get_fd(na_class_t *na_class, na_context_t *context)
@@ -5264,6 +8330,11 @@ na_ofi_poll_try_wait(na_class_t *na_class, na_context_t *context)
     if (priv->no_wait)
         return NA_FALSE;
 
+    /* RMA CQ has no wait object, keep making progress until RMA ops that
+     * were posted to it complete */
+    if (hg_atomic_get32(&ctx->rma_count) > 0)
+        return NA_FALSE;
+
     /* Keep making progress if retry queue is not empty */
     hg_thread_mutex_lock(&ctx->retry_op_queue->mutex);
     if (!HG_QUEUE_IS_EMPTY(&ctx->retry_op_queue->queue)) {
@@ -5297,17 +8368,26 @@ static na_return_t
 na_ofi_progress(
     na_class_t *na_class, na_context_t *context, unsigned int timeout)
 {
+    struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
+    struct na_ofi_multi_recv *multi_recv = ctx->multi_recv;
     /* Convert timeout in ms into seconds */
     double remaining = timeout / 1000.0;
     na_return_t ret;
 
+    /* Operation held by a batch must not wait for the batch to end */
+    if (hg_atomic_get32(&ctx->batch_count) > 0) {
+        hg_thread_mutex_lock(&ctx->batch_mutex);
+        na_ofi_op_batch_flush(na_class, ctx, NULL);
+        hg_thread_mutex_unlock(&ctx->batch_mutex);
+    }
+
     do {
-        struct fi_cq_tagged_entry cq_events[NA_OFI_CQ_EVENT_NUM];
-        fi_addr_t src_addrs[NA_OFI_CQ_EVENT_NUM] = {FI_ADDR_UNSPEC};
+        struct fi_cq_tagged_entry cq_events[NA_OFI_CQ_EVENT_MAX];
+        fi_addr_t src_addrs[NA_OFI_CQ_EVENT_MAX];
         char src_err_addr[NA_OFI_CQ_MAX_ERR_DATA_SIZE] = {0};
-        void *src_err_addr_ptr = src_err_addr;
-        size_t src_err_addrlen = NA_OFI_CQ_MAX_ERR_DATA_SIZE;
-        size_t i, actual_count = 0;
+        size_t event_count = (size_t) hg_atomic_get32(&ctx->cq_event_count);
+        size_t i, actual_count = 0, total_count = 0;
+        na_bool_t cq_full;
         hg_time_t t1, t2;
 
         if (timeout) {
@@ -5315,7 +8395,8 @@ na_ofi_progress(
 
             hg_time_get_current_ms(&t1);
 
-            if (wait_hdl) {
+            /* RMA CQ has no wait object, poll while RMA ops are pending */
+            if (wait_hdl && hg_atomic_get32(&ctx->rma_count) == 0) {
                 /* Wait in wait set if provider does not support wait on FDs */
                 int rc = fi_wait(wait_hdl, (int) (remaining * 1000.0));
 
@@ -5334,24 +8415,85 @@ na_ofi_progress(
             }
         }
 
-        /* Read from CQ and process events */
-        ret = na_ofi_cq_read(context, NA_OFI_CQ_EVENT_NUM, cq_events, src_addrs,
-            &src_err_addr_ptr, &src_err_addrlen, &actual_count);
-        NA_CHECK_SUBSYS_NA_ERROR(
-            poll, error, ret, "Could not read events from context CQ");
+        /* Read from CQ and process events, keep reading as long as the CQ
+         * returns full batches (bounded by CQ depth). The batch size grows
+         * when the CQ is loaded and shrinks back when it is not */
+        do {
+            void *src_err_addr_ptr = src_err_addr;
+            size_t src_err_addrlen = NA_OFI_CQ_MAX_ERR_DATA_SIZE;
 
-        for (i = 0; i < actual_count; i++) {
-            ret = na_ofi_cq_process_event(na_class, &cq_events[i], src_addrs[i],
-                src_err_addr_ptr, src_err_addrlen);
+            ret = na_ofi_cq_read(context, ctx->fi_cq, event_count, cq_events,
+                src_addrs, &src_err_addr_ptr, &src_err_addrlen, &actual_count);
             NA_CHECK_SUBSYS_NA_ERROR(
-                poll, error, ret, "Could not process event");
+                poll, error, ret, "Could not read events from context CQ");
+
+            for (i = 0; i < actual_count; i++) {
+                ret = na_ofi_cq_process_event(na_class, &cq_events[i],
+                    src_addrs[i], src_err_addr_ptr, src_err_addrlen);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    poll, error, ret, "Could not process event");
+            }
+            total_count += actual_count;
+
+            cq_full = (actual_count == event_count);
+            if (cq_full && event_count < NA_OFI_CQ_EVENT_MAX)
+                event_count <<= 1;
+            else if (actual_count < (event_count >> 2) &&
+                     event_count > NA_OFI_CQ_EVENT_NUM)
+                event_count >>= 1;
+        } while (cq_full && total_count < NA_OFI_CQ_DEPTH);
+        hg_atomic_set32(&ctx->cq_event_count, (hg_util_int32_t) event_count);
+
+        /* RMA completions are only read once messages have been processed
+         * and at most rma_cq_budget of them per call, so that bulk transfers
+         * do not delay RPC messages */
+        if (ctx->fi_rma_cq) {
+            size_t rma_budget = NA_OFI_CLASS(na_class)->rma_cq_budget,
+                   rma_total = 0;
+
+            do {
+                void *src_err_addr_ptr = src_err_addr;
+                size_t src_err_addrlen = NA_OFI_CQ_MAX_ERR_DATA_SIZE;
+                size_t max_count = MIN(NA_OFI_CQ_EVENT_MAX, rma_budget);
+
+                ret = na_ofi_cq_read(context, ctx->fi_rma_cq, max_count,
+                    cq_events, src_addrs, &src_err_addr_ptr, &src_err_addrlen,
+                    &actual_count);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    poll, error, ret, "Could not read events from RMA CQ");
+
+                for (i = 0; i < actual_count; i++) {
+                    ret = na_ofi_cq_process_event(na_class, &cq_events[i],
+                        src_addrs[i], src_err_addr_ptr, src_err_addrlen);
+                    NA_CHECK_SUBSYS_NA_ERROR(
+                        poll, error, ret, "Could not process RMA event");
+                }
+                rma_total += actual_count;
+                rma_budget -= actual_count;
+            } while (actual_count == max_count && rma_budget > 0);
+            total_count += rma_total;
+        }
+
+        /* Completions release provider resources, retry without waiting for
+         * the backoff to expire (backoff keeps growing if that fails) */
+        if (total_count > 0 && ctx->retry_op_queue->retry_ticks != 0) {
+            hg_thread_mutex_lock(&ctx->retry_op_queue->mutex);
+            ctx->retry_op_queue->retry_ticks = 0;
+            hg_thread_mutex_unlock(&ctx->retry_op_queue->mutex);
         }
 
         /* Attempt to process retries */
-        ret = na_ofi_cq_process_retries(context);
+        ret = na_ofi_cq_process_retries(na_class, context);
         NA_CHECK_SUBSYS_NA_ERROR(poll, error, ret, "Could not process retries");
 
-        if (actual_count > 0)
+        /* Repost multi-recv buffers that could not be posted */
+        if (multi_recv && hg_atomic_get32(&multi_recv->unposted_count)) {
+            ret = na_ofi_multi_recv_repost(multi_recv);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                poll, error, ret, "Could not repost multi-recv buffers");
+        }
+
+        if (total_count > 0)
             return NA_SUCCESS;
 
         if (timeout) {
@@ -5375,7 +8517,9 @@ error:
 static na_return_t
 na_ofi_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id)
 {
+    struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
     struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
+    struct na_ofi_queue *op_queue = ctx->retry_op_queue;
     struct fid_ep *fi_ep = NULL;
     na_return_t ret = NA_SUCCESS;
     na_bool_t canceled = NA_FALSE;
@@ -5391,14 +8535,21 @@ na_ofi_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id)
 
     switch (na_ofi_op_id->completion_data.callback_info.type) {
         case NA_CB_RECV_UNEXPECTED:
+            /* Op ID is only queued locally when using multi-recv */
+            if (ctx->multi_recv)
+                op_queue = &ctx->multi_recv->queues->unexpected_op_queue;
+            else
+                fi_ep = ctx->fi_rx;
+            break;
         case NA_CB_RECV_EXPECTED:
-            fi_ep = NA_OFI_CONTEXT(context)->fi_rx;
+            fi_ep = ctx->fi_rx;
             break;
         case NA_CB_SEND_UNEXPECTED:
         case NA_CB_SEND_EXPECTED:
         case NA_CB_PUT:
         case NA_CB_GET:
-            fi_ep = NA_OFI_CONTEXT(context)->fi_tx;
+        case NA_CB_ATOMIC:
+            fi_ep = na_ofi_op_tx(ctx, na_ofi_op_id);
             break;
         default:
             NA_GOTO_SUBSYS_ERROR(op, out, ret, NA_INVALID_ARG,
@@ -5407,20 +8558,30 @@ na_ofi_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id)
             break;
     }
 
-    /* Check if op_id is in retry queue */
-    hg_thread_mutex_lock(&NA_OFI_CONTEXT(context)->retry_op_queue->mutex);
+    /* Check if op_id is in retry queue (or unexpected op queue) */
+    hg_thread_mutex_lock(&op_queue->mutex);
     if (hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_QUEUED) {
-        HG_QUEUE_REMOVE(&NA_OFI_CONTEXT(context)->retry_op_queue->queue,
-            na_ofi_op_id, na_ofi_op_id, entry);
+        HG_QUEUE_REMOVE(&op_queue->queue, na_ofi_op_id, na_ofi_op_id, entry);
         hg_atomic_and32(&na_ofi_op_id->status, ~NA_OFI_OP_QUEUED);
         canceled = NA_TRUE;
     }
-    hg_thread_mutex_unlock(&NA_OFI_CONTEXT(context)->retry_op_queue->mutex);
+    hg_thread_mutex_unlock(&op_queue->mutex);
+
+    /* Check if op_id is held by a batch */
+    if (!canceled && fi_ep == na_ofi_op_tx(ctx, na_ofi_op_id) &&
+        hg_atomic_get32(&ctx->batch_count) > 0) {
+        hg_thread_mutex_lock(&ctx->batch_mutex);
+        if (ctx->batch_op_id == na_ofi_op_id) {
+            ctx->batch_op_id = NULL;
+            canceled = NA_TRUE;
+        }
+        hg_thread_mutex_unlock(&ctx->batch_mutex);
+    }
 
     if (canceled) {
         ret = na_ofi_complete(na_ofi_op_id, NA_CANCELED);
         NA_CHECK_SUBSYS_NA_ERROR(op, out, ret, "Could not complete operation");
-    } else {
+    } else if (fi_ep) {
         /* fi_cancel() is an asynchronous operation, either the operation
          * will be canceled and an FI_ECANCELED event will be generated
          * or it will show up in the regular completion queue.
@@ -5431,18 +8592,74 @@ na_ofi_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id)
         (void) rc;
     }
 
-    /* Work around segfault on fi_cq_signal() in some providers */
-    if (na_ofi_prov_flags[NA_OFI_CLASS(na_class)->domain->prov_type] &
-        NA_OFI_SIGNAL) {
-        /* Signal CQ to wake up and no longer wait on FD */
-        int rc_signal = fi_cq_signal(NA_OFI_CONTEXT(context)->fi_cq);
-        NA_CHECK_SUBSYS_ERROR(op, rc_signal != 0 && rc_signal != -ENOSYS, out,
-            ret, na_ofi_errno_to_na(-rc_signal),
-            "fi_cq_signal (op type %d) failed, rc: %d (%s)",
-            na_ofi_op_id->completion_data.callback_info.type, rc_signal,
-            fi_strerror(-rc_signal));
-    }
+    ret = na_ofi_cq_signal(na_class, ctx);
+    NA_CHECK_SUBSYS_NA_ERROR(op, out, ret, "Could not signal CQ (op type %d)",
+        na_ofi_op_id->completion_data.callback_info.type);
 
 out:
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_resource_stats_set(struct na_resource_stats *stats,
+    na_uint32_t max_count, na_uint32_t *count, const char *name,
+    na_uint64_t used, na_uint64_t max)
+{
+    if (*count < max_count) {
+        strncpy(stats[*count].name, name, NA_RESOURCE_NAME_MAX - 1);
+        stats[*count].name[NA_RESOURCE_NAME_MAX - 1] = '\0';
+        stats[*count].used = used;
+        stats[*count].max = max;
+    }
+    (*count)++;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_get_resource_stats(
+    na_class_t *na_class, struct na_resource_stats *stats, na_uint32_t *count)
+{
+    struct na_ofi_class *priv = NA_OFI_CLASS(na_class);
+    struct na_ofi_domain *domain = priv->domain;
+    na_uint32_t max_count = *count;
+    na_uint64_t used, max;
+    unsigned int i;
+
+    *count = 0;
+
+    /* Regions kept registered by the MR cache */
+    hg_thread_mutex_lock(&domain->mr_cache.mutex);
+    used = domain->mr_cache.count;
+    max = domain->mr_cache.count_max;
+    hg_thread_mutex_unlock(&domain->mr_cache.mutex);
+    na_ofi_resource_stats_set(
+        stats, max_count, count, "ofi_mr_cache", used, max);
+
+    na_ofi_resource_stats_set(stats, max_count, count, "ofi_mr_reg",
+        (na_uint64_t) hg_atomic_get32(domain->mr_reg_count), 0);
+
+    /* Blocks of msg buffer pools in use, pools are never released */
+    for (i = 0; i < priv->buf_pool_class_count; i++) {
+        struct na_ofi_mem_pool_class *pool_class = &priv->buf_pools[i];
+        struct na_ofi_mem_pool *pool =
+            (struct na_ofi_mem_pool *) hg_atomic_get64(&pool_class->pools);
+        hg_util_int32_t free_count = hg_atomic_get32(&pool_class->free_count);
+        char name[NA_RESOURCE_NAME_MAX];
+
+        for (max = 0; pool != NULL; pool = pool->next)
+            max += pool_class->block_count;
+        if (free_count <= 0)
+            used = max;
+        else if ((na_uint64_t) free_count >= max)
+            used = 0;
+        else
+            used = max - (na_uint64_t) free_count;
+
+        snprintf(name, sizeof(name), "ofi_buf_pool_%" PRIu64,
+            (na_uint64_t) pool_class->block_size);
+        na_ofi_resource_stats_set(stats, max_count, count, name, used, max);
+    }
+
+    return NA_SUCCESS;
+}
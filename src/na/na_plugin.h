@@ -26,6 +26,9 @@
 /* Private callback type for NA plugins */
 typedef void (*na_plugin_cb_t)(void *arg);
 
+/* Slab of plugin op IDs */
+struct na_op_slab;
+
 /* Completion data stored in completion queue */
 struct na_cb_completion_data {
     struct na_cb_info callback_info; /* Callback info struct */
@@ -142,10 +145,77 @@ NA_PRIVATE void
 na_cb_completion_add(
     na_context_t *context, struct na_cb_completion_data *na_cb_completion_data);
 
+/**
+ * Notify that an operation of the context is being retried.
+ *
+ * \param context [IN/OUT]              pointer to context of execution
+ * \param type [IN]                     callback type of operation
+ *
+ */
+NA_PRIVATE void
+na_cb_retry_notify(na_context_t *context, na_cb_type_t type);
+
+/**
+ * Create a slab of plugin op IDs of size \obj_size. Op IDs are cache-line
+ * aligned, carved out of chunks and recycled through a lock-free cache, so
+ * that creating and destroying op IDs does not go through the system
+ * allocator once the slab has grown to the number of op IDs in use.
+ *
+ * \param obj_size [IN]                 size of plugin op ID struct
+ *
+ * \return Pointer to slab or NULL in case of failure
+ */
+NA_PRIVATE struct na_op_slab *
+na_op_slab_create(size_t obj_size);
+
+/**
+ * Destroy slab, all op IDs allocated from it are released.
+ *
+ * \param na_op_slab [IN/OUT]           pointer to slab
+ */
+NA_PRIVATE void
+na_op_slab_destroy(struct na_op_slab *na_op_slab);
+
+/**
+ * Allocate an op ID from slab (contents are not initialized).
+ *
+ * \param na_op_slab [IN/OUT]           pointer to slab
+ *
+ * \return Pointer to op ID or NULL in case of failure
+ */
+NA_PRIVATE void *
+na_op_slab_alloc(struct na_op_slab *na_op_slab);
+
+/**
+ * Return an op ID to slab.
+ *
+ * \param na_op_slab [IN/OUT]           pointer to slab
+ * \param obj [IN]                      pointer to op ID
+ */
+NA_PRIVATE void
+na_op_slab_free(struct na_op_slab *na_op_slab, void *obj);
+
+/**
+ * Apply atomic operation to 64-bit value in host memory, used by plugins that
+ * can directly access the memory of their target.
+ *
+ * \param ptr [IN/OUT]                  pointer to 8-byte aligned value
+ * \param op [IN]                       atomic operation
+ * \param operand [IN]                  operand of operation
+ * \param compare [IN]                  value compared against
+ *
+ * \return Previous value
+ */
+NA_PRIVATE na_uint64_t
+na_atomic_host(
+    void *ptr, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare);
+
 /*********************/
 /* Public Variables */
 /*********************/
 
+/* Ops of a single plugin build are declared in na.h */
+#ifndef NA_STATIC_PLUGIN
 #ifdef NA_HAS_SM
 extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(sm);
 #endif
@@ -161,6 +231,13 @@ extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(cci);
 #ifdef NA_HAS_OFI
 extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(ofi);
 #endif
+#ifdef NA_HAS_UCX
+extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(ucx);
+#endif
+#ifdef NA_HAS_TCP
+extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(tcp);
+#endif
+#endif
 
 #ifdef __cplusplus
 }
@@ -19,7 +19,11 @@
 #include "mercury_list.h"
 #include "mercury_mem.h"
 #include "mercury_poll.h"
+#include "mercury_probe.h"
 #include "mercury_queue.h"
+#include "mercury_thread_condition.h"
+#include "mercury_thread_mutex.h"
+#include "mercury_thread_pool.h"
 #include "mercury_thread_rwlock.h"
 #include "mercury_thread_spin.h"
 #include "mercury_time.h"
@@ -33,12 +37,18 @@
 #    include <uuid/uuid.h>
 #endif
 
+#ifdef NA_SM_HAS_XPMEM
+#    include <xpmem.h>
+#endif
+
 #ifdef _WIN32
 #    include <process.h>
 #else
+#    include <dirent.h>
 #    include <fcntl.h>
 #    include <ftw.h>
 #    include <pwd.h>
+#    include <signal.h>
 #    include <sys/mman.h>
 #    include <sys/resource.h>
 #    include <sys/socket.h>
@@ -66,31 +76,68 @@
 #define NA_SM_PAGE_SIZE HG_MEM_PAGE_SIZE
 
 /* Default filenames/paths */
-#define NA_SM_SHM_PATH  "/dev/shm"
 #define NA_SM_SOCK_NAME "/sock"
 
 /* Max filename length used for shared files */
 #define NA_SM_MAX_FILENAME 64
 
-/* Max number of shared-memory buffers (reserved by 64-bit atomic integer) */
-#define NA_SM_NUM_BUFS 64
+/* Size of msg ring per queue (power of 2, records are 8-byte aligned) */
+#define NA_SM_MSG_RING_SIZE (256 * 1024)
+#define NA_SM_MSG_RING_MASK (NA_SM_MSG_RING_SIZE - 1)
+
+/* Max size of a single msg (keep several msgs in flight per queue) */
+#define NA_SM_MSG_SIZE_MAX (NA_SM_MSG_RING_SIZE / 4)
+
+/* Size of msg record (header + payload) */
+#define NA_SM_MSG_RECORD_SIZE(buf_size)                                        \
+    ((hg_util_uint32_t) (sizeof(na_sm_msg_hdr_t) + (((buf_size) + 7) & ~7U)))
 
-/* Size of shared-memory buffer */
-#define NA_SM_COPY_BUF_SIZE NA_SM_PAGE_SIZE
+/* Msgs larger than this are pulled by the receiver through CMA */
+#define NA_SM_MSG_CMA_THRESHOLD (16 * 1024)
+
+/* Size of pool of msg buffers that peers copy msgs from */
+#define NA_SM_MSG_POOL_SIZE (4 * 1024 * 1024)
+
+/* Size of msg payload pushed to msg queue */
+#define NA_SM_MSG_PAYLOAD_SIZE(msg_info)                                       \
+    ((msg_info)->cma    ? sizeof(struct iovec)                                 \
+        : (msg_info)->pool ? sizeof(struct na_sm_msg_pool_desc)                \
+                           : (msg_info)->buf_size)
+
+/* Msg completes once the receiver has released its record */
+#define NA_SM_MSG_DEFERRED(msg_info) ((msg_info)->cma || (msg_info)->pool)
 
 /* Max number of fds used for cleanup */
 #define NA_SM_CLEANUP_NFDS 16
 
-/* Max number of peers */
-#define NA_SM_MAX_PEERS (NA_CONTEXT_ID_MAX + 1)
+/* Default max number of peers */
+#define NA_SM_MAX_PEERS (256)
+
+/* Upper limit of peers per region (multiple of 64) */
+#define NA_SM_MAX_PEERS_LIMIT (4096)
+
+/* Size of shared region (queue pairs are mapped separately) */
+#define NA_SM_REGION_SIZE                                                      \
+    ((sizeof(struct na_sm_region) + NA_SM_PAGE_SIZE - 1) &                     \
+        ~((size_t) NA_SM_PAGE_SIZE - 1))
+
+/* Size of queue pair */
+#define NA_SM_QUEUE_PAIR_SIZE                                                  \
+    ((sizeof(struct na_sm_queue_pair) + NA_SM_PAGE_SIZE - 1) &                 \
+        ~((size_t) NA_SM_PAGE_SIZE - 1))
+
+/* Size of staging rings of a queue pair */
+#define NA_SM_STAGE_PAIR_SIZE                                                  \
+    ((sizeof(struct na_sm_stage_pair) + NA_SM_PAGE_SIZE - 1) &                 \
+        ~((size_t) NA_SM_PAGE_SIZE - 1))
 
 /* Addr status bits */
 #define NA_SM_ADDR_RESERVED   (1 << 0)
 #define NA_SM_ADDR_CMD_PUSHED (1 << 1)
 #define NA_SM_ADDR_RESOLVED   (1 << 2)
 
-/* Msg sizes */
-#define NA_SM_UNEXPECTED_SIZE NA_SM_COPY_BUF_SIZE
+/* Default msg sizes */
+#define NA_SM_UNEXPECTED_SIZE NA_SM_PAGE_SIZE
 #define NA_SM_EXPECTED_SIZE   NA_SM_UNEXPECTED_SIZE
 
 /* Max tag */
@@ -99,9 +146,47 @@
 /* Maximum number of pre-allocated IOV entries */
 #define NA_SM_IOV_STATIC_MAX (8)
 
+/* Max number of IOV entries translated per CMA copy (kept on the stack) */
+#define NA_SM_CMA_IOV_WINDOW (64)
+
+/* Number of helper threads used for large CMA transfers */
+#define NA_SM_CMA_THREADS (4)
+
+/* Transfer size above which CMA transfers are split across helpers */
+#define NA_SM_CMA_PARALLEL_THRESHOLD (1 << 20)
+
+/* Min size of a CMA transfer chunk */
+#define NA_SM_CMA_CHUNK_MIN (1 << 18)
+
+/* Max number of XPMEM attachments cached per peer */
+#define NA_SM_XPMEM_CACHE_MAX (64)
+
+/* Number and size of slots of RMA staging rings (double buffering) */
+#define NA_SM_STAGE_SLOT_COUNT (2)
+#define NA_SM_STAGE_SLOT_SIZE  (64 * 1024)
+
+/* Max number of peer IOV entries described by a staged RMA request */
+#define NA_SM_STAGE_IOV_MAX (64)
+
+/* Number of staging chunks for a given length */
+#define NA_SM_STAGE_CHUNKS(len)                                                \
+    ((hg_util_int32_t) (((len) + NA_SM_STAGE_SLOT_SIZE - 1) /                  \
+                        NA_SM_STAGE_SLOT_SIZE))
+
 /* Max events */
 #define NA_SM_MAX_EVENTS 16
 
+/* Backoff between attempts of retried ops (ns) */
+#define NA_SM_RETRY_BACKOFF_MIN (1000)
+#define NA_SM_RETRY_BACKOFF_MAX (1000000)
+
+/* Poll events of notifications, eventfds may be consumed by the poll set */
+#ifdef HG_UTIL_HAS_SYSEVENTFD_H
+#    define NA_SM_POLL_NOTIFY (HG_POLLIN | HG_POLLEVENT)
+#else
+#    define NA_SM_POLL_NOTIFY (HG_POLLIN)
+#endif
+
 /* Op ID status bits */
 #define NA_SM_OP_COMPLETED (1 << 0)
 #define NA_SM_OP_CANCELED  (1 << 1)
@@ -117,6 +202,26 @@
     snprintf(                                                                  \
         filename, maxlen, "%s_%s-%d-%u", NA_SM_SHM_PREFIX, username, pid, id)
 
+/* Generate SHM file name of queue pair */
+#define NA_SM_GEN_PAIR_NAME(filename, maxlen, username, pid, id, index)        \
+    snprintf(filename, maxlen, "%s_%s-%d-%u-%u", NA_SM_SHM_PREFIX, username,   \
+        pid, id, index)
+
+/* Generate SHM file name of staging rings of queue pair */
+#define NA_SM_GEN_STAGE_NAME(filename, maxlen, username, pid, id, index)       \
+    snprintf(filename, maxlen, "%s_%s-%d-%u-%u-stage", NA_SM_SHM_PREFIX,       \
+        username, pid, id, index)
+
+/* Generate SHM file name of msg pool */
+#define NA_SM_GEN_POOL_NAME(filename, maxlen, username, pid, id)               \
+    snprintf(filename, maxlen, "%s_%s-%d-%u-msg", NA_SM_SHM_PREFIX, username,  \
+        pid, id)
+
+/* Generate path of registry of SHM files created by user */
+#define NA_SM_GEN_SHM_REG_PATH(pathname, maxlen, username)                     \
+    snprintf(pathname, maxlen, "%s/%s_%s/shm", NA_SM_TMP_DIRECTORY,            \
+        NA_SM_SHM_PREFIX, username)
+
 /* Generate socket path */
 #define NA_SM_GEN_SOCK_PATH(pathname, maxlen, username, pid, id)               \
     snprintf(pathname, maxlen, "%s/%s_%s/%d/%u", NA_SM_TMP_DIRECTORY,          \
@@ -142,64 +247,87 @@
 typedef union {
     struct {
         unsigned int tag : 32;      /* Message tag : UINT MAX */
-        unsigned int buf_size : 16; /* Buffer length: 4KB MAX */
-        unsigned int buf_idx : 8;   /* Index reserved: 64 MAX */
-        unsigned int type : 8;      /* Message type */
+        unsigned int buf_size : 23; /* Buffer length: 8MB MAX */
+        unsigned int cma : 1;       /* Payload is sender iovec */
+        unsigned int pool : 1;      /* Payload is sender pool desc */
+        unsigned int type : 7;      /* Message type */
     } hdr;
     na_uint64_t val;
 } na_sm_msg_hdr_t;
 
-/* Make sure this is cache-line aligned */
-typedef union {
-    hg_atomic_int64_t val;
-    char pad[NA_SM_CACHE_LINE_SIZE];
-} na_sm_cacheline_atomic_int64_t;
-
-typedef union {
-    hg_atomic_int64_t val[4];
-    char pad[NA_SM_CACHE_LINE_SIZE];
-} na_sm_cacheline_atomic_int256_t;
-
-/* Msg buffers (page aligned) */
-struct na_sm_copy_buf {
-    hg_thread_spin_t buf_locks[NA_SM_NUM_BUFS];    /* Locks on buffers */
-    char buf[NA_SM_NUM_BUFS][NA_SM_COPY_BUF_SIZE]; /* Array of buffers */
-    na_sm_cacheline_atomic_int64_t available;      /* Available bitmask */
+/* Location of msg in sender pool (payload of pool records) */
+struct na_sm_msg_pool_desc {
+    na_uint32_t offset; /* Offset of msg in pool */
+    na_uint32_t size;   /* Size of msg */
 };
 
-/* Msg queue (allocate queue's flexible array member statically) */
+/* Msg queue (byte ring of variable-size records, each record is a msg
+ * header followed by its payload). Positions are free-running byte offsets,
+ * producers and consumers reserve records with a CAS on their head and
+ * publish them in order by moving their tail. */
 struct na_sm_msg_queue {
     hg_atomic_int32_t prod_head;
     hg_atomic_int32_t prod_tail;
-    unsigned int prod_size;
-    unsigned int prod_mask;
-    hg_util_uint64_t drops;
     hg_atomic_int32_t cons_head
         __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE)));
     hg_atomic_int32_t cons_tail;
-    unsigned int cons_size;
-    unsigned int cons_mask;
-    hg_atomic_int64_t ring[NA_SM_NUM_BUFS]
+    hg_atomic_int32_t cons_polling; /* Consumer does not need notifications */
+    char ring[NA_SM_MSG_RING_SIZE]
         __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE)));
 };
 
+/* RMA staging ring, used when peers cannot access each other's memory
+ * directly. The initiator posts a request that describes peer memory, the
+ * peer copies chunks of it into (get) or out of (put) the slots from its
+ * progress loop while the initiator copies them out of (get) or into (put)
+ * its own memory. Chunk counters are free-running, chunk n uses slot
+ * n % NA_SM_STAGE_SLOT_COUNT. */
+struct na_sm_stage {
+    hg_atomic_int32_t req_seq;             /* Last request posted */
+    hg_atomic_int32_t done_seq;            /* Last request completed */
+    hg_atomic_int32_t status;              /* Status of completed request */
+    na_uint32_t put;                       /* Request writes peer memory */
+    na_uint32_t iovcnt;                    /* Number of peer IOVs */
+    na_uint64_t len;                       /* Length of request */
+    struct iovec iov[NA_SM_STAGE_IOV_MAX]; /* Peer IOVs */
+    /* Chunks filled / drained */
+    hg_atomic_int32_t filled __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE)));
+    hg_atomic_int32_t drained __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE)));
+    char slots[NA_SM_STAGE_SLOT_COUNT][NA_SM_STAGE_SLOT_SIZE]
+        __attribute__((aligned(NA_SM_PAGE_SIZE)));
+};
+
+/* Staged RMA request of a peer, copied out of the ring once validated */
+struct na_sm_stage_req {
+    struct iovec iov[NA_SM_STAGE_IOV_MAX]; /* Local IOVs */
+    na_size_t len;                         /* Length of request */
+    unsigned long iovcnt;                  /* Number of IOVs */
+    hg_util_int32_t seq;                   /* Sequence of request */
+    na_bool_t put;                         /* Request writes local memory */
+};
+
 /* Shared queue pair */
 struct na_sm_queue_pair {
     struct na_sm_msg_queue tx_queue; /* Send queue */
     struct na_sm_msg_queue rx_queue; /* Recv queue */
 };
 
+/* Staging rings of queue pair, only created once RMA is staged on it */
+struct na_sm_stage_pair {
+    struct na_sm_stage tx_stage; /* RMA staging of tx side */
+    struct na_sm_stage rx_stage; /* RMA staging of rx side */
+};
+
 /* Cmd values */
 typedef enum { NA_SM_RESERVED = 1, NA_SM_RELEASED } na_sm_cmd_t;
 
 /* Cmd header */
 typedef union {
     struct {
-        unsigned int pid : 32;     /* PID */
-        unsigned int id : 8;       /* ID */
-        unsigned int pair_idx : 8; /* Index reserved */
-        unsigned int type : 8;     /* Cmd type */
-        unsigned int pad : 8;      /* 8 bits left */
+        unsigned int pid : 32;      /* PID */
+        unsigned int id : 8;        /* ID */
+        unsigned int pair_idx : 16; /* Index reserved */
+        unsigned int type : 8;      /* Cmd type */
     } hdr;
     na_uint64_t val;
 } na_sm_cmd_hdr_t;
@@ -217,17 +345,29 @@ struct na_sm_cmd_queue {
     unsigned int cons_size;
     unsigned int cons_mask;
     /* To be safe, make the queue twice as large */
-    hg_atomic_int64_t ring[NA_SM_MAX_PEERS * 2]
+    hg_atomic_int64_t ring[NA_SM_MAX_PEERS_LIMIT * 2]
         __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE)));
 };
 
+/* Word of available pairs (one word per cache line so that peers that
+ * start their search at different words do not share lines) */
+struct na_sm_pair_word {
+    hg_atomic_int64_t bits __attribute__((aligned(NA_SM_CACHE_LINE_SIZE)));
+};
+
 /* Shared region */
 struct na_sm_region {
-    struct na_sm_copy_buf copy_bufs; /* Pool of msg buffers */
-    struct na_sm_queue_pair queue_pairs[NA_SM_MAX_PEERS]
-        __attribute__((aligned(NA_SM_PAGE_SIZE))); /* Msg queue pairs */
-    struct na_sm_cmd_queue cmd_queue;              /* Cmd queue */
-    na_sm_cacheline_atomic_int256_t available;     /* Available pairs */
+    struct na_sm_cmd_queue cmd_queue; /* Cmd queue */
+    hg_atomic_int64_t available_words
+        __attribute__((aligned(NA_SM_CACHE_LINE_SIZE))); /* Non-empty words */
+    struct na_sm_pair_word
+        available[NA_SM_MAX_PEERS_LIMIT / 64]; /* Available pairs */
+    hg_atomic_int64_t
+        created[NA_SM_MAX_PEERS_LIMIT / 64]; /* Queue pairs created */
+    hg_atomic_int64_t
+        staged[NA_SM_MAX_PEERS_LIMIT / 64]; /* Staging rings created */
+    unsigned int pair_count;                 /* Number of queue pairs */
+    na_int32_t numa_node;                    /* NUMA node of queue pairs */
 };
 
 /* Poll type */
@@ -238,20 +378,50 @@ typedef enum na_sm_poll_type {
 } na_sm_poll_type_t;
 
 /* Address */
+#ifdef NA_SM_HAS_XPMEM
+/* XPMEM attachment of a remote range */
+struct na_sm_xpmem_attach {
+    HG_LIST_ENTRY(na_sm_xpmem_attach) entry; /* Entry in cache list */
+    char *remote_base;                       /* Remote base (page aligned) */
+    char *local_base;                        /* Local mapping of remote base */
+    size_t len;                              /* Length of mapping */
+    hg_atomic_int32_t ref_count;             /* Ref count */
+};
+
+/* XPMEM attachment cache (most recent first) */
+struct na_sm_xpmem_cache {
+    HG_LIST_HEAD(na_sm_xpmem_attach) list; /* List of attachments */
+    hg_thread_rwlock_t lock;                /* Cache lock */
+    xpmem_apid_t apid;                      /* Access permit to peer segment */
+    unsigned int count;                     /* Number of attachments */
+};
+#endif
+
 struct na_sm_addr {
     HG_LIST_ENTRY(na_sm_addr) entry;    /* Entry in poll list */
     struct na_sm_region *shared_region; /* Shared-memory region */
+    struct na_sm_queue_pair *pair;      /* Mapped queue pair */
+    struct na_sm_stage_pair *stage;     /* Mapped staging rings */
     struct na_sm_msg_queue *tx_queue;   /* Pointer to shared tx queue */
     struct na_sm_msg_queue *rx_queue;   /* Pointer to shared rx queue */
+    struct na_sm_stage *tx_stage;       /* Staging of RMA we initiate */
+    struct na_sm_stage *rx_stage;       /* Staging of RMA peer initiates */
+    struct na_sm_op_id *stage_op;       /* Staged RMA in progress */
     int tx_notify;                      /* Notify fd for tx queue */
     int rx_notify;                      /* Notify fd for rx queue */
     na_sm_poll_type_t tx_poll_type;     /* Tx poll type */
     na_sm_poll_type_t rx_poll_type;     /* Rx poll type */
     hg_atomic_int32_t ref_count;        /* Ref count */
     hg_atomic_int32_t status;           /* Status bits */
+    hg_atomic_int32_t stage_busy;       /* Staging is being progressed */
+    struct na_sm_stage_req *stage_req;  /* Peer request being served */
+#ifdef NA_SM_HAS_XPMEM
+    struct na_sm_xpmem_cache xpmem_cache; /* XPMEM attachments */
+#endif
+    char *msg_pool;                     /* Mapping of peer msg pool */
     pid_t pid;                          /* PID */
     na_uint8_t id;                      /* SM ID */
-    na_uint8_t queue_pair_idx;          /* Shared queue pair index */
+    na_uint16_t queue_pair_idx;         /* Shared queue pair index */
     na_bool_t unexpected;               /* Unexpected address */
 };
 
@@ -278,6 +448,9 @@ struct na_sm_mem_desc_info {
     unsigned long iovcnt; /* Segment count */
     size_t len;           /* Size of region */
     na_uint8_t flags;     /* Flag of operation access */
+#ifdef NA_SM_HAS_XPMEM
+    xpmem_segid_t segid; /* XPMEM segment of owner (-1 if none) */
+#endif
 };
 
 /* IOV descriptor */
@@ -288,8 +461,15 @@ typedef union {
 
 /* Memory handle */
 struct na_sm_mem_handle {
-    struct na_sm_mem_desc_info info; /* Segment info */
-    na_sm_iov_t iov;                 /* Remain last */
+    struct na_sm_mem_desc_info info;       /* Segment info */
+    HG_LIST_ENTRY(na_sm_mem_handle) entry; /* Entry in registered list */
+    na_sm_iov_t iov;                       /* Remain last */
+};
+
+/* Registered memory handles */
+struct na_sm_mem_handle_list {
+    HG_LIST_HEAD(na_sm_mem_handle) list;
+    hg_thread_rwlock_t lock;
 };
 
 /* Msg info */
@@ -301,6 +481,24 @@ struct na_sm_msg_info {
     size_t buf_size;
     na_size_t actual_buf_size;
     na_tag_t tag;
+    hg_util_uint32_t cma_end; /* End of deferred record in tx queue */
+    na_bool_t cma;            /* Receiver pulls payload through CMA */
+    na_bool_t pool;           /* Receiver copies payload from msg pool */
+};
+
+/* RMA info of staged transfers */
+struct na_sm_rma_info {
+    struct na_sm_mem_handle *local_handle;  /* Local memory */
+    struct na_sm_mem_handle *remote_handle; /* Peer memory */
+    na_offset_t local_offset;               /* Offset in local memory */
+    na_offset_t remote_offset;              /* Offset in peer memory */
+    na_size_t length;                       /* Length of transfer */
+    na_size_t req_offset;                   /* Offset of current request */
+    na_size_t req_len;                      /* Length of current request */
+    hg_util_int32_t req_seq;                /* Sequence of current request */
+    hg_util_int32_t chunk;                  /* Next chunk to copy */
+    na_return_t ret;                        /* Status returned by peer */
+    na_bool_t put;                          /* Write to peer memory */
 };
 
 /* Unexpected msg info */
@@ -323,6 +521,7 @@ struct na_sm_op_id {
     struct na_cb_completion_data completion_data; /* Completion data */
     union {
         struct na_sm_msg_info msg;
+        struct na_sm_rma_info rma;
     } info;                            /* Op info                  */
     HG_QUEUE_ENTRY(na_sm_op_id) entry; /* Entry in queue           */
     na_class_t *na_class;              /* NA class associated      */
@@ -337,6 +536,17 @@ struct na_sm_op_queue {
     hg_thread_spin_t lock;
 };
 
+/* Pool of msg buffers shared with peers */
+struct na_sm_msg_pool {
+    char name[NA_SM_MAX_FILENAME]; /* SHM file name */
+    char *base;                    /* Base of mapping (NULL if no pool) */
+    unsigned int *free_bufs;       /* Stack of free buffer indices */
+    unsigned int free_count;       /* Number of free buffers */
+    unsigned int count;            /* Number of buffers */
+    na_size_t buf_size;            /* Size of each buffer */
+    hg_thread_spin_t lock;         /* Free stack lock */
+};
+
 /* Endpoint */
 struct na_sm_endpoint {
     struct na_sm_map addr_map; /* Address map */
@@ -345,6 +555,12 @@ struct na_sm_endpoint {
     struct na_sm_op_queue unexpected_op_queue; /* Unexpected op queue */
     struct na_sm_op_queue expected_op_queue;   /* Expected op queue */
     struct na_sm_op_queue retry_op_queue;      /* Retry op queue */
+    hg_time_ticks_t retry_ticks;               /* Next retry attempt */
+    hg_util_uint64_t retry_backoff;            /* Retry backoff (ns) */
+    struct na_sm_op_queue cma_op_queue;        /* Deferred msg op queue */
+    struct na_sm_op_queue stage_op_queue;      /* Staged RMA op queue */
+    struct na_sm_mem_handle_list mem_handles;  /* Registered memory */
+    struct na_sm_msg_pool msg_pool;            /* Pool of msg buffers */
     struct na_sm_addr_list poll_addr_list;     /* List of addresses to poll */
     struct na_sm_addr *source_addr;            /* Source addr */
     hg_poll_set_t *poll_set;                   /* Poll set */
@@ -353,6 +569,7 @@ struct na_sm_endpoint {
     hg_atomic_int32_t nofile;                  /* Number of opened fds */
     na_uint32_t nofile_max;                    /* Max number of fds */
     na_bool_t listen;                          /* Listen on sock */
+    na_bool_t notify_on_wait; /* Only get notified before waiting */
 };
 
 /* Private context */
@@ -360,12 +577,49 @@ struct na_sm_context {
     struct hg_poll_event events[NA_SM_MAX_EVENTS];
 };
 
+#ifdef NA_SM_HAS_CMA
+/* CMA transfer */
+struct na_sm_cma_xfer {
+    const struct iovec *liov; /* Local IOVs */
+    const struct iovec *riov; /* Remote IOVs */
+    unsigned long liovcnt;    /* Local IOV count */
+    unsigned long riovcnt;    /* Remote IOV count */
+    unsigned long iov_max;    /* Max IOVs per call */
+    hg_thread_mutex_t mutex;  /* Completion lock */
+    hg_thread_cond_t cond;    /* Completion cond */
+    unsigned int pending;     /* Chunks left to copy */
+    na_return_t ret;          /* First error of chunks */
+    pid_t pid;                /* Remote PID */
+    na_bool_t put;            /* Write to remote */
+};
+
+/* Chunk of a CMA transfer */
+struct na_sm_cma_chunk {
+    struct hg_thread_work thread_work; /* Thread work */
+    struct na_sm_cma_xfer *xfer;       /* Parent transfer */
+    na_size_t offset;                  /* Offset of chunk */
+    na_size_t len;                     /* Length of chunk */
+};
+#endif
+
 /* Private data */
 struct na_sm_class {
     struct na_sm_endpoint endpoint; /* Endpoint */
+    struct na_op_slab *op_slab;     /* Slab of op IDs */
     char *username;                 /* Username */
     na_size_t iov_max;              /* Max number of IOVs */
-    na_uint8_t context_max;         /* Max number of contexts */
+    na_size_t unexpected_size_max;  /* Max unexpected size */
+    na_size_t expected_size_max;    /* Max expected size */
+    na_uint16_t context_max;        /* Max number of contexts */
+    na_bool_t msg_cma;              /* Send large msgs through CMA */
+    hg_atomic_int32_t rma_stage;    /* Stage RMA through queue pairs */
+#ifdef NA_SM_HAS_CMA
+    hg_thread_pool_t *cma_pool;       /* Helpers for large transfers */
+    hg_thread_mutex_t cma_pool_mutex; /* Pool creation lock */
+#endif
+#ifdef NA_SM_HAS_XPMEM
+    xpmem_segid_t xpmem_segid; /* XPMEM segment (-1 if none) */
+#endif
 };
 
 /********************/
@@ -404,11 +658,18 @@ static na_return_t
 na_sm_shm_unmap(const char *name, void *addr, na_size_t length);
 
 /**
- * Clean up dangling shm segments.
+ * Add SHM file to the registry of user, or remove it from it. The registry is
+ * a directory with an empty entry per SHM file so that cleaning up only walks
+ * our own files and not the entire /dev/shm tree.
  */
-static int
-na_sm_shm_cleanup(
-    const char *fpath, const struct stat *sb, int typeflag, struct FTW *ftwbuf);
+static na_return_t
+na_sm_shm_register(const char *username, const char *name, na_bool_t add);
+
+/**
+ * Clean up dangling shm segments of user.
+ */
+static void
+na_sm_shm_cleanup(const char *username);
 
 /**
  * Initialize queue.
@@ -417,18 +678,39 @@ static void
 na_sm_msg_queue_init(struct na_sm_msg_queue *na_sm_queue);
 
 /**
- * Multi-producer enqueue.
+ * Multi-producer reservation of a record large enough for buf_size bytes.
  */
 static NA_INLINE na_bool_t
-na_sm_msg_queue_push(
-    struct na_sm_msg_queue *na_sm_queue, na_sm_msg_hdr_t msg_hdr);
+na_sm_msg_queue_reserve(struct na_sm_msg_queue *na_sm_queue,
+    na_size_t buf_size, hg_util_uint32_t *pos_ptr);
 
 /**
- * Multi-consumer dequeue.
+ * Copy header and payload to reserved record and publish it.
+ */
+static NA_INLINE void
+na_sm_msg_queue_push(struct na_sm_msg_queue *na_sm_queue,
+    hg_util_uint32_t pos, na_sm_msg_hdr_t msg_hdr, const void *buf);
+
+/**
+ * Multi-consumer dequeue of a record header.
  */
 static NA_INLINE na_bool_t
-na_sm_msg_queue_pop(
-    struct na_sm_msg_queue *na_sm_msg_queue, na_sm_msg_hdr_t *msg_hdr_ptr);
+na_sm_msg_queue_pop(struct na_sm_msg_queue *na_sm_queue,
+    na_sm_msg_hdr_t *msg_hdr_ptr, hg_util_uint32_t *pos_ptr);
+
+/**
+ * Copy payload of dequeued record to dest.
+ */
+static NA_INLINE void
+na_sm_msg_queue_copy_from(struct na_sm_msg_queue *na_sm_queue,
+    hg_util_uint32_t pos, void *dest, size_t n);
+
+/**
+ * Release dequeued record so that its space can be reused.
+ */
+static NA_INLINE void
+na_sm_msg_queue_release(struct na_sm_msg_queue *na_sm_queue,
+    hg_util_uint32_t pos, na_sm_msg_hdr_t msg_hdr);
 
 /**
  * Check whether queue is empty.
@@ -492,7 +774,8 @@ na_sm_string_to_addr(const char *str, pid_t *pid, na_uint8_t *id);
  */
 static na_return_t
 na_sm_region_open(const char *username, pid_t pid, na_uint8_t id,
-    na_bool_t create, struct na_sm_region **region);
+    na_bool_t create, unsigned int pair_count, na_int32_t numa_node,
+    struct na_sm_region **region);
 
 /**
  * Close shared-memory region.
@@ -501,6 +784,54 @@ static na_return_t
 na_sm_region_close(const char *username, pid_t pid, na_uint8_t id,
     na_bool_t remove, struct na_sm_region *region);
 
+/**
+ * Map queue pair of shared region, queue pairs are created by the first peer
+ * that reserves them.
+ */
+static na_return_t
+na_sm_queue_pair_open(const char *username, pid_t pid, na_uint8_t id,
+    struct na_sm_region *region, na_uint16_t index,
+    struct na_sm_queue_pair **queue_pair);
+
+/**
+ * Unmap queue pair.
+ */
+static na_return_t
+na_sm_queue_pair_close(struct na_sm_queue_pair *queue_pair);
+
+/**
+ * Create pool of msg buffers that peers can copy msgs from.
+ */
+static na_return_t
+na_sm_msg_pool_create(const char *username, pid_t pid, na_uint8_t id,
+    na_size_t buf_size, struct na_sm_msg_pool *na_sm_msg_pool);
+
+/**
+ * Destroy pool of msg buffers.
+ */
+static na_return_t
+na_sm_msg_pool_destroy(
+    const char *username, struct na_sm_msg_pool *na_sm_msg_pool);
+
+/**
+ * Map msg pool of peer.
+ */
+static void
+na_sm_msg_pool_attach(const char *username, struct na_sm_addr *na_sm_addr);
+
+/**
+ * Unmap msg pool of peer.
+ */
+static void
+na_sm_msg_pool_detach(struct na_sm_addr *na_sm_addr);
+
+/**
+ * Check whether msg can be read by the receiver from our msg pool.
+ */
+static NA_INLINE na_bool_t
+na_sm_msg_pool_use(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *na_sm_addr, const void *buf, na_size_t buf_size);
+
 /**
  * Open UNIX domain socket.
  */
@@ -539,14 +870,14 @@ na_sm_sock_path_cleanup(
  */
 static na_return_t
 na_sm_event_create(const char *username, pid_t pid, na_uint8_t id,
-    na_uint8_t pair_index, unsigned char pair, int *event);
+    na_uint16_t pair_index, unsigned char pair, int *event);
 
 /**
  * Destroy event.
  */
 static na_return_t
 na_sm_event_destroy(const char *username, pid_t pid, na_uint8_t id,
-    na_uint8_t pair_index, unsigned char pair, na_bool_t remove, int event);
+    na_uint16_t pair_index, unsigned char pair, na_bool_t remove, int event);
 
 /**
  * Set event.
@@ -564,7 +895,8 @@ na_sm_event_get(int event, na_bool_t *signaled);
  * Register addr to poll set.
  */
 static na_return_t
-na_sm_poll_register(hg_poll_set_t *poll_set, int fd, void *ptr);
+na_sm_poll_register(
+    hg_poll_set_t *poll_set, int fd, hg_util_uint32_t events, void *ptr);
 
 /**
  * Deregister addr from poll set.
@@ -578,7 +910,7 @@ na_sm_poll_deregister(hg_poll_set_t *poll_set, int fd);
 static na_return_t
 na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *username,
     pid_t pid, na_uint8_t id, na_bool_t listen, na_bool_t no_wait,
-    na_uint32_t nofile_max);
+    unsigned int peer_max, na_uint32_t nofile_max, na_int32_t numa_node);
 
 /**
  * Close shared-memory endpoint.
@@ -588,16 +920,17 @@ na_sm_endpoint_close(
     struct na_sm_endpoint *na_sm_endpoint, const char *username);
 
 /**
- * Reserve queue pair.
+ * Reserve queue pair, search starts at word \hint (modulo number of words).
  */
 static NA_INLINE na_return_t
-na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, na_uint8_t *index);
+na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, unsigned int hint,
+    na_uint16_t *index);
 
 /**
  * Release queue pair.
  */
 static NA_INLINE void
-na_sm_queue_pair_release(struct na_sm_region *na_sm_region, na_uint8_t index);
+na_sm_queue_pair_release(struct na_sm_region *na_sm_region, na_uint16_t index);
 
 /**
  * Lookup addr key from map.
@@ -663,36 +996,23 @@ na_sm_addr_event_recv(int sock, na_sm_cmd_hdr_t *cmd_hdr, int *tx_notify,
     int *rx_notify, na_bool_t *received);
 
 /**
- * Reserve shared buffer.
+ * Notify peer that msgs were pushed, unless it is polling its rx queue.
  */
 static NA_INLINE na_return_t
-na_sm_buf_reserve(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int *index);
-
-/**
- * Release shared buffer.
- */
-static NA_INLINE void
-na_sm_buf_release(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index);
+na_sm_addr_notify(struct na_sm_addr *na_sm_addr);
 
 /**
- * Copy src to shared buffer.
- */
-static NA_INLINE void
-na_sm_buf_copy_to(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index,
-    const void *src, size_t n);
-
-/**
- * Copy from shared buffer to dest.
+ * Push operation for retry.
  */
 static NA_INLINE void
-na_sm_buf_copy_from(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index,
-    void *dest, size_t n);
+na_sm_op_retry(na_class_t *na_class, struct na_sm_op_id *na_sm_op_id);
 
 /**
- * Push operation for retry.
+ * Fill next resource stats entry (if there is room left) and count it.
  */
-static NA_INLINE void
-na_sm_op_retry(na_class_t *na_class, struct na_sm_op_id *na_sm_op_id);
+static void
+na_sm_resource_stats_set(struct na_resource_stats *stats, na_uint32_t max_count,
+    na_uint32_t *count, const char *name, na_uint64_t used, na_uint64_t max);
 
 /**
  * Get IOV index and offset pair from an absolute offset.
@@ -717,6 +1037,83 @@ na_sm_iov_translate(const struct iovec *iov, unsigned long iovcnt,
     unsigned long iov_start_index, na_offset_t iov_start_offset, na_size_t len,
     struct iovec *new_iov, unsigned long new_iovcnt);
 
+#ifdef NA_SM_HAS_CMA
+/**
+ * Get length of data covered by at most iovcnt_max IOVs.
+ */
+static NA_INLINE na_size_t
+na_sm_iov_get_span(const struct iovec *iov, unsigned long iovcnt,
+    unsigned long iov_start_index, na_offset_t iov_start_offset,
+    unsigned long iovcnt_max);
+
+/**
+ * Read/write remote IOVs with a single CMA call.
+ */
+static na_return_t
+na_sm_cma_rw(pid_t pid, const struct iovec *liov, unsigned long liovcnt,
+    const struct iovec *riov, unsigned long riovcnt, na_size_t len,
+    na_bool_t put);
+
+/**
+ * Copy range of a CMA transfer using as many calls as IOV_MAX requires.
+ */
+static na_return_t
+na_sm_cma_copy_range(
+    struct na_sm_cma_xfer *xfer, na_size_t offset, na_size_t len);
+
+/**
+ * Copy chunk of a CMA transfer (thread pool callback).
+ */
+static HG_THREAD_RETURN_TYPE
+na_sm_cma_copy_chunk(void *arg);
+
+/**
+ * Copy to/from remote process, large transfers are split into chunks that
+ * are copied in parallel by helper threads.
+ */
+static na_return_t
+na_sm_cma_copy(struct na_sm_class *na_sm_class, pid_t pid,
+    const struct iovec *liov, unsigned long liovcnt, const struct iovec *riov,
+    unsigned long riovcnt, na_size_t length, na_bool_t put);
+#endif
+
+#ifdef NA_SM_HAS_XPMEM
+/**
+ * Look up cached attachment that contains remote range.
+ */
+static NA_INLINE struct na_sm_xpmem_attach *
+na_sm_xpmem_cache_lookup(
+    struct na_sm_xpmem_cache *xpmem_cache, const char *ptr, size_t len);
+
+/**
+ * Get attachment for remote range, attach it if not already cached.
+ */
+static na_return_t
+na_sm_xpmem_attach_get(struct na_sm_xpmem_cache *xpmem_cache,
+    xpmem_segid_t segid, void *ptr, size_t len,
+    struct na_sm_xpmem_attach **attach_ptr);
+
+/**
+ * Release attachment and detach it if no longer referenced.
+ */
+static NA_INLINE void
+na_sm_xpmem_attach_release(struct na_sm_xpmem_attach *attach);
+
+/**
+ * Detach all cached attachments and release peer segment.
+ */
+static void
+na_sm_xpmem_cache_destroy(struct na_sm_xpmem_cache *xpmem_cache);
+
+/**
+ * Copy data between local IOV and remote IOV through XPMEM mappings.
+ */
+static na_return_t
+na_sm_xpmem_copy(struct na_sm_xpmem_cache *xpmem_cache, xpmem_segid_t segid,
+    const struct iovec *liov, unsigned long liovcnt, const struct iovec *riov,
+    unsigned long riovcnt, na_bool_t put);
+#endif
+
 /**
  * Poll waiting for timeout milliseconds.
  */
@@ -724,6 +1121,22 @@ static na_return_t
 na_sm_poll_wait(na_context_t *context, struct na_sm_endpoint *na_sm_endpoint,
     const char *username, unsigned int timeout, na_bool_t *progressed_ptr);
 
+/**
+ * Mark rx queues as being polled or not. Peers skip notifications while rx
+ * queues are being polled.
+ */
+static void
+na_sm_poll_set_polling(
+    struct na_sm_endpoint *na_sm_endpoint, na_bool_t polling);
+
+/**
+ * Make progress and only wait once peers have been told to notify us.
+ */
+static na_return_t
+na_sm_poll_notify_on_wait(na_context_t *context,
+    struct na_sm_endpoint *na_sm_endpoint, const char *username,
+    unsigned int timeout, na_bool_t *progressed_ptr);
+
 /**
  * Poll without waiting.
  */
@@ -731,6 +1144,13 @@ static na_return_t
 na_sm_poll(struct na_sm_endpoint *na_sm_endpoint, const char *username,
     na_bool_t *progressed_ptr);
 
+/**
+ * Progress all rx queues without waiting.
+ */
+static na_return_t
+na_sm_poll_rx_queues(struct na_sm_endpoint *na_sm_endpoint,
+    const char *username, na_bool_t *progressed_ptr);
+
 /**
  * Progress on endpoint sock.
  */
@@ -771,12 +1191,35 @@ static na_return_t
 na_sm_progress_rx_queue(struct na_sm_endpoint *na_sm_endpoint,
     struct na_sm_addr *poll_addr, na_bool_t *progressed);
 
+/**
+ * Get size of received msg.
+ */
+static NA_INLINE na_size_t
+na_sm_msg_get_size(struct na_sm_msg_queue *na_sm_queue,
+    na_sm_msg_hdr_t msg_hdr, hg_util_uint32_t msg_pos);
+
+/**
+ * Copy payload of received msg to dest, either from the msg queue, from the
+ * msg pool of the sender or directly from the sender through CMA.
+ */
+static na_return_t
+na_sm_msg_copy_from(struct na_sm_addr *poll_addr, na_sm_msg_hdr_t msg_hdr,
+    hg_util_uint32_t msg_pos, void *dest, na_size_t n);
+
+/**
+ * Post msg to reserved record of tx queue.
+ */
+static void
+na_sm_msg_post(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_op_id *na_sm_op_id, hg_util_uint32_t msg_pos);
+
 /**
  * Process unexpected messages.
  */
 static na_return_t
 na_sm_process_unexpected(struct na_sm_op_queue *unexpected_op_queue,
     struct na_sm_addr *poll_addr, na_sm_msg_hdr_t msg_hdr,
+    hg_util_uint32_t msg_pos,
     struct na_sm_unexpected_msg_queue *unexpected_msg_queue);
 
 /**
@@ -784,71 +1227,202 @@ na_sm_process_unexpected(struct na_sm_op_queue *unexpected_op_queue,
  */
 static na_return_t
 na_sm_process_expected(struct na_sm_op_queue *expected_op_queue,
-    struct na_sm_addr *poll_addr, na_sm_msg_hdr_t msg_hdr);
+    struct na_sm_addr *poll_addr, na_sm_msg_hdr_t msg_hdr,
+    hg_util_uint32_t msg_pos);
 
 /**
- * Process retries.
+ * Process retries once their backoff has expired.
  */
 static na_return_t
 na_sm_process_retries(
     struct na_sm_endpoint *na_sm_endpoint, const char *username);
 
 /**
- * Complete operation.
+ * Delay next retry, doubling the backoff. Must be called with the retry
+ * queue lock held.
  */
-static na_return_t
-na_sm_complete(struct na_sm_op_id *na_sm_op_id, int notify);
+static NA_INLINE void
+na_sm_retry_backoff(struct na_sm_endpoint *na_sm_endpoint);
 
 /**
- * Release memory.
+ * Retry on next progress, resources may have been released.
  */
 static NA_INLINE void
-na_sm_release(void *arg);
-
-/* check_protocol */
-static na_bool_t
-na_sm_check_protocol(const char *protocol_name);
-
-/* initialize */
-static na_return_t
-na_sm_initialize(
-    na_class_t *na_class, const struct na_info *na_info, na_bool_t listen);
+na_sm_retry_wake(struct na_sm_endpoint *na_sm_endpoint);
 
-/* finalize */
+/**
+ * Complete CMA and pool msgs that have been released by the receiver.
+ */
 static na_return_t
-na_sm_finalize(na_class_t *na_class);
+na_sm_process_cma(struct na_sm_endpoint *na_sm_endpoint, na_bool_t *progressed);
 
-/* context_create */
-static na_return_t
-na_sm_context_create(na_class_t *na_class, void **context, na_uint8_t id);
+/**
+ * Check whether the peer process still exists.
+ */
+static NA_INLINE na_bool_t
+na_sm_addr_alive(struct na_sm_addr *na_sm_addr);
 
-/* context_destroy */
+/**
+ * Cancel CMA and pool msgs that will never be released by the receiver.
+ */
 static na_return_t
-na_sm_context_destroy(na_class_t *na_class, void *context);
+na_sm_cma_abort(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *na_sm_addr, int notify, na_bool_t *progressed);
 
-/* cleanup */
-static void
-na_sm_cleanup(void);
+/**
+ * Use staging ring of queue pair for RMA to that peer.
+ */
+static NA_INLINE na_bool_t
+na_sm_stage_use(struct na_sm_class *na_sm_class, struct na_sm_addr *na_sm_addr,
+    struct na_sm_mem_handle *na_sm_mem_handle_remote);
 
-/* op_create */
-static na_op_id_t *
-na_sm_op_create(na_class_t *na_class);
+/**
+ * Switch to staged RMA once CMA has been denied.
+ */
+static NA_INLINE na_bool_t
+na_sm_stage_fallback(struct na_sm_class *na_sm_class,
+    struct na_sm_addr *na_sm_addr,
+    struct na_sm_mem_handle *na_sm_mem_handle_remote);
 
-/* op_destroy */
+/**
+ * Map staging rings of queue pair, they are created by the first peer that
+ * stages RMA on the pair.
+ */
 static na_return_t
-na_sm_op_destroy(na_class_t *na_class, na_op_id_t *op_id);
+na_sm_stage_attach(struct na_sm_endpoint *na_sm_endpoint, const char *username,
+    struct na_sm_addr *na_sm_addr, na_bool_t create);
 
-/* addr_lookup */
+/**
+ * Unmap staging rings of queue pair.
+ */
 static na_return_t
-na_sm_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr);
+na_sm_stage_detach(struct na_sm_addr *na_sm_addr);
 
-/* addr_free */
+/**
+ * Stage RMA operation, it is started once the staging ring is free.
+ */
 static na_return_t
-na_sm_addr_free(na_class_t *na_class, na_addr_t addr);
+na_sm_stage_rma(na_class_t *na_class, struct na_sm_op_id *na_sm_op_id,
+    struct na_sm_mem_handle *na_sm_mem_handle_local, na_offset_t local_offset,
+    struct na_sm_mem_handle *na_sm_mem_handle_remote, na_offset_t remote_offset,
+    na_size_t length, na_bool_t put);
 
-/* addr_self */
+/**
+ * Copy between IOVs and a contiguous buffer.
+ */
+static void
+na_sm_stage_iov_copy(const struct iovec *iov, unsigned long iovcnt,
+    na_offset_t offset, char *buf, na_size_t len, na_bool_t to_iov);
+
+/**
+ * Check that a peer request only targets registered memory with the
+ * required access and copy it out of the ring.
+ */
 static na_return_t
-na_sm_addr_self(na_class_t *na_class, na_addr_t *addr);
+na_sm_stage_req_check(struct na_sm_mem_handle_list *na_sm_mem_handle_list,
+    const struct na_sm_stage *na_sm_stage, struct na_sm_stage_req *req);
+
+/**
+ * Post next request of staged RMA operation.
+ */
+static void
+na_sm_stage_req_post(struct na_sm_addr *na_sm_addr, struct na_sm_rma_info *rma);
+
+/**
+ * Fill or drain slots for the request of a peer.
+ */
+static na_return_t
+na_sm_stage_serve(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *na_sm_addr, na_bool_t *progressed);
+
+/**
+ * Drain or fill slots of staged RMA operation, set completed once done.
+ */
+static na_bool_t
+na_sm_stage_advance(struct na_sm_addr *na_sm_addr,
+    struct na_sm_rma_info *rma, na_bool_t *completed);
+
+/**
+ * Check whether staging of peer can make progress without waiting.
+ */
+static NA_INLINE na_bool_t
+na_sm_stage_ready(struct na_sm_addr *na_sm_addr);
+
+/**
+ * Progress staged RMA of peer (both directions).
+ */
+static na_return_t
+na_sm_progress_stage(struct na_sm_endpoint *na_sm_endpoint,
+    const char *username, struct na_sm_addr *na_sm_addr,
+    na_bool_t *progressed);
+
+/**
+ * Start staged RMA operations once staging rings are free.
+ */
+static na_return_t
+na_sm_process_stage(
+    struct na_sm_endpoint *na_sm_endpoint, na_bool_t *progressed);
+
+/**
+ * Complete operation.
+ */
+static na_return_t
+na_sm_complete(struct na_sm_op_id *na_sm_op_id, int notify);
+
+/**
+ * Release memory.
+ */
+static NA_INLINE void
+na_sm_release(void *arg);
+
+/* check_protocol */
+static na_bool_t
+na_sm_check_protocol(const char *protocol_name);
+
+/* initialize */
+static na_return_t
+na_sm_initialize(
+    na_class_t *na_class, const struct na_info *na_info, na_bool_t listen);
+
+/* finalize */
+static na_return_t
+na_sm_finalize(na_class_t *na_class);
+
+/* context_create */
+static na_return_t
+na_sm_context_create(na_class_t *na_class, void **context, na_uint16_t id);
+
+/* context_destroy */
+static na_return_t
+na_sm_context_destroy(na_class_t *na_class, void *context);
+
+/* cleanup */
+static void
+na_sm_cleanup(void);
+
+/* op_create */
+static na_op_id_t *
+na_sm_op_create(na_class_t *na_class);
+
+/* op_destroy */
+static na_return_t
+na_sm_op_destroy(na_class_t *na_class, na_op_id_t *op_id);
+
+/* addr_lookup */
+static na_return_t
+na_sm_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr);
+
+/* addr_free */
+static na_return_t
+na_sm_addr_free(na_class_t *na_class, na_addr_t addr);
+
+/* addr_warmup */
+static na_return_t
+na_sm_addr_warmup(na_class_t *na_class, na_addr_t addr);
+
+/* addr_self */
+static na_return_t
+na_sm_addr_self(na_class_t *na_class, na_addr_t *addr);
 
 /* addr_dup */
 static na_return_t
@@ -889,6 +1463,14 @@ na_sm_msg_get_max_unexpected_size(const na_class_t *na_class);
 static NA_INLINE na_size_t
 na_sm_msg_get_max_expected_size(const na_class_t *na_class);
 
+/* msg_buf_alloc */
+static void *
+na_sm_msg_buf_alloc(na_class_t *na_class, na_size_t size, void **plugin_data);
+
+/* msg_buf_free */
+static na_return_t
+na_sm_msg_buf_free(na_class_t *na_class, void *buf, void *plugin_data);
+
 /* msg_get_max_tag */
 static NA_INLINE na_tag_t
 na_sm_msg_get_max_tag(const na_class_t *na_class);
@@ -897,7 +1479,7 @@ na_sm_msg_get_max_tag(const na_class_t *na_class);
 static na_return_t
 na_sm_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
 /* msg_recv_unexpected */
@@ -910,14 +1492,14 @@ na_sm_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
 static na_return_t
 na_sm_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t dest_addr, na_uint8_t dest_id, na_tag_t tag,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
 /* msg_recv_expected */
 static na_return_t
 na_sm_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
-    void *plugin_data, na_addr_t source_addr, na_uint8_t source_id,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
     na_tag_t tag, na_op_id_t *op_id);
 
 /* mem_handle_create */
@@ -933,10 +1515,24 @@ na_sm_mem_handle_create_segments(na_class_t *na_class,
     na_mem_handle_t *mem_handle);
 #endif
 
+/* mem_handle_create_sub */
+static na_return_t
+na_sm_mem_handle_create_sub(na_class_t *na_class, na_mem_handle_t parent_handle,
+    void *buf, na_size_t buf_size, unsigned long flags,
+    na_mem_handle_t *mem_handle);
+
 /* mem_handle_free */
 static na_return_t
 na_sm_mem_handle_free(na_class_t *na_class, na_mem_handle_t mem_handle);
 
+/* mem_register */
+static na_return_t
+na_sm_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle);
+
+/* mem_deregister */
+static na_return_t
+na_sm_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle);
+
 /* mem_handle_get_max_segments */
 static na_size_t
 na_sm_mem_handle_get_max_segments(const na_class_t *na_class);
@@ -961,7 +1557,7 @@ static na_return_t
 na_sm_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
 /* get */
@@ -969,9 +1565,17 @@ static na_return_t
 na_sm_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id);
 
+/* atomic */
+static na_return_t
+na_sm_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare,
+    na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t remote_addr, na_uint16_t remote_id, na_op_id_t *op_id);
+
 /* poll_get_fd */
 static NA_INLINE int
 na_sm_poll_get_fd(na_class_t *na_class, na_context_t *context);
@@ -989,6 +1593,11 @@ na_sm_progress(
 static na_return_t
 na_sm_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id);
 
+/* get_resource_stats */
+static na_return_t
+na_sm_get_resource_stats(
+    na_class_t *na_class, struct na_resource_stats *stats, na_uint32_t *count);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -1004,8 +1613,10 @@ const struct na_class_ops NA_PLUGIN_OPS(sm) = {
     na_sm_op_create,                   /* op_create */
     na_sm_op_destroy,                  /* op_destroy */
     na_sm_addr_lookup,                 /* addr_lookup */
+    NULL,                              /* addr_lookup_batch */
     na_sm_addr_free,                   /* addr_free */
     NULL,                              /* addr_set_remove */
+    na_sm_addr_warmup,                 /* addr_warmup */
     na_sm_addr_self,                   /* addr_self */
     na_sm_addr_dup,                    /* addr_dup */
     na_sm_addr_cmp,                    /* addr_cmp */
@@ -1014,18 +1625,21 @@ const struct na_class_ops NA_PLUGIN_OPS(sm) = {
     na_sm_addr_get_serialize_size,     /* addr_get_serialize_size */
     na_sm_addr_serialize,              /* addr_serialize */
     na_sm_addr_deserialize,            /* addr_deserialize */
+    NULL,                              /* addr_deserialize_batch */
     na_sm_msg_get_max_unexpected_size, /* msg_get_max_unexpected_size */
     na_sm_msg_get_max_expected_size,   /* msg_get_max_expected_size */
     NULL,                              /* msg_get_unexpected_header_size */
     NULL,                              /* msg_get_expected_header_size */
     na_sm_msg_get_max_tag,             /* msg_get_max_tag */
-    NULL,                              /* msg_buf_alloc */
-    NULL,                              /* msg_buf_free */
+    na_sm_msg_buf_alloc,               /* msg_buf_alloc */
+    na_sm_msg_buf_free,                /* msg_buf_free */
     NULL,                              /* msg_init_unexpected */
     na_sm_msg_send_unexpected,         /* msg_send_unexpected */
+    NULL,                              /* msg_send_unexpectedv */
     na_sm_msg_recv_unexpected,         /* msg_recv_unexpected */
     NULL,                              /* msg_init_expected */
     na_sm_msg_send_expected,           /* msg_send_expected */
+    NULL,                              /* msg_send_expectedv */
     na_sm_msg_recv_expected,           /* msg_recv_expected */
     na_sm_mem_handle_create,           /* mem_handle_create */
 #ifdef NA_SM_HAS_CMA
@@ -1035,8 +1649,8 @@ const struct na_class_ops NA_PLUGIN_OPS(sm) = {
 #endif
     na_sm_mem_handle_free,               /* mem_handle_free */
     na_sm_mem_handle_get_max_segments,   /* mem_handle_get_max_segments */
-    NULL,                                /* mem_register */
-    NULL,                                /* mem_deregister */
+    na_sm_mem_register,                  /* mem_register */
+    na_sm_mem_deregister,                /* mem_deregister */
     na_sm_mem_handle_get_serialize_size, /* mem_handle_get_serialize_size */
     na_sm_mem_handle_serialize,          /* mem_handle_serialize */
     na_sm_mem_handle_deserialize,        /* mem_handle_deserialize */
@@ -1045,7 +1659,13 @@ const struct na_class_ops NA_PLUGIN_OPS(sm) = {
     na_sm_poll_get_fd,                   /* poll_get_fd */
     na_sm_poll_try_wait,                 /* poll_try_wait */
     na_sm_progress,                      /* progress */
-    na_sm_cancel                         /* cancel */
+    na_sm_cancel,                        /* cancel */
+    na_sm_get_resource_stats,            /* get_resource_stats */
+    na_sm_mem_handle_create_sub,         /* mem_handle_create_sub */
+    NULL,                                /* op_batch_begin */
+    NULL,                                /* op_batch_end */
+    NULL,                                /* mem_register_attr */
+    na_sm_atomic                         /* atomic */
 };
 
 /********************/
@@ -1301,70 +1921,222 @@ na_sm_shm_unmap(const char *name, void *addr, na_size_t length)
 }
 
 /*---------------------------------------------------------------------------*/
-static int
-na_sm_shm_cleanup(const char *fpath, const struct stat NA_UNUSED *sb,
-    int NA_UNUSED typeflag, struct FTW NA_UNUSED *ftwbuf)
+static na_return_t
+na_sm_shm_register(const char *username, const char *name, na_bool_t add)
 {
-    const char *prefix = NA_SM_SHM_PATH "/" NA_SM_SHM_PREFIX "_";
-    int ret = 0;
+    char pathname[NA_SM_MAX_FILENAME] = {'\0'};
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    rc = NA_SM_GEN_SHM_REG_PATH(pathname, NA_SM_MAX_FILENAME, username);
+    NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, done, ret, NA_OVERFLOW,
+        "NA_SM_GEN_SHM_REG_PATH() failed, rc: %d", rc);
 
-    if (strncmp(fpath, prefix, strlen(prefix)) == 0) {
-        const char *shm_name = fpath + strlen(NA_SM_SHM_PATH "/");
-        char *username = getlogin_safe();
+    if (add) {
+        int fd;
 
-        if (strncmp(shm_name + strlen(NA_SM_SHM_PREFIX "_"), username,
-                strlen(username)) == 0) {
-            NA_LOG_DEBUG("shm_unmap() %s", shm_name);
-            ret = hg_mem_shm_unmap(shm_name, NULL, 0);
-        }
+        ret = na_sm_sock_path_create(pathname);
+        NA_CHECK_NA_ERROR(done, ret, "Could not create path (%s)", pathname);
+
+        rc = snprintf(pathname + strlen(pathname),
+            NA_SM_MAX_FILENAME - strlen(pathname), "/%s", name);
+        NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, done, ret,
+            NA_OVERFLOW, "snprintf() failed, rc: %d", rc);
+
+        fd = open(pathname, O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR);
+        NA_CHECK_ERROR(fd == -1, done, ret, na_sm_errno_to_na(errno),
+            "open() of %s failed (%s)", pathname, strerror(errno));
+        close(fd);
+    } else {
+        rc = snprintf(pathname + strlen(pathname),
+            NA_SM_MAX_FILENAME - strlen(pathname), "/%s", name);
+        NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, done, ret,
+            NA_OVERFLOW, "snprintf() failed, rc: %d", rc);
+
+        rc = unlink(pathname);
+        NA_CHECK_ERROR(rc == -1 && errno != ENOENT, done, ret,
+            na_sm_errno_to_na(errno), "unlink() of %s failed (%s)", pathname,
+            strerror(errno));
     }
 
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static void
-na_sm_msg_queue_init(struct na_sm_msg_queue *na_sm_queue)
+na_sm_shm_cleanup(const char *username)
 {
-    struct hg_atomic_queue *hg_atomic_queue =
-        (struct hg_atomic_queue *) na_sm_queue;
-    unsigned int count = NA_SM_NUM_BUFS;
+    char pathname[NA_SM_MAX_FILENAME] = {'\0'};
+    struct dirent *entry;
+    DIR *dir;
+    int rc;
 
-    hg_atomic_queue->prod_size = hg_atomic_queue->cons_size = count;
-    hg_atomic_queue->prod_mask = hg_atomic_queue->cons_mask = count - 1;
-    hg_atomic_init32(&hg_atomic_queue->prod_head, 0);
-    hg_atomic_init32(&hg_atomic_queue->cons_head, 0);
-    hg_atomic_init32(&hg_atomic_queue->prod_tail, 0);
-    hg_atomic_init32(&hg_atomic_queue->cons_tail, 0);
+    rc = NA_SM_GEN_SHM_REG_PATH(pathname, NA_SM_MAX_FILENAME, username);
+    NA_CHECK_ERROR_NORET(rc < 0 || rc > NA_SM_MAX_FILENAME, done,
+        "NA_SM_GEN_SHM_REG_PATH() failed, rc: %d", rc);
+
+    dir = opendir(pathname);
+    if (dir == NULL) /* Nothing was registered */
+        goto done;
+
+    /* Registry entries are named after the SHM files, which are either in
+     * /dev/shm or on hugetlbfs */
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, NA_SM_SHM_PREFIX "_",
+                strlen(NA_SM_SHM_PREFIX "_")) != 0)
+            continue;
+
+        NA_LOG_DEBUG("shm_unmap() %s", entry->d_name);
+        rc = hg_mem_shm_unmap(entry->d_name, NULL, 0);
+        NA_CHECK_WARNING(rc != HG_UTIL_SUCCESS && errno != ENOENT,
+            "Could not remove %s", entry->d_name);
+    }
+    closedir(dir);
+
+done:
+    return;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_msg_queue_init(struct na_sm_msg_queue *na_sm_queue)
+{
+    hg_atomic_init32(&na_sm_queue->prod_head, 0);
+    hg_atomic_init32(&na_sm_queue->cons_head, 0);
+    hg_atomic_init32(&na_sm_queue->prod_tail, 0);
+    hg_atomic_init32(&na_sm_queue->cons_tail, 0);
+    hg_atomic_init32(&na_sm_queue->cons_polling, 0);
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_bool_t
-na_sm_msg_queue_push(
-    struct na_sm_msg_queue *na_sm_queue, na_sm_msg_hdr_t msg_hdr)
+na_sm_msg_queue_reserve(struct na_sm_msg_queue *na_sm_queue,
+    na_size_t buf_size, hg_util_uint32_t *pos_ptr)
 {
-    int rc = hg_atomic_queue_push(
-        (struct hg_atomic_queue *) na_sm_queue, (void *) msg_hdr.val);
+    hg_util_uint32_t len = NA_SM_MSG_RECORD_SIZE(buf_size);
+    hg_util_uint32_t prod_head, cons_tail;
 
-    return (likely(rc == HG_UTIL_SUCCESS)) ? NA_TRUE : NA_FALSE;
+    do {
+        prod_head =
+            (hg_util_uint32_t) hg_atomic_get32_relaxed(&na_sm_queue->prod_head);
+        cons_tail = (hg_util_uint32_t) hg_atomic_get32(&na_sm_queue->cons_tail);
+
+        /* Full, unsigned arithmetic handles wrap-around of positions */
+        if (len > NA_SM_MSG_RING_SIZE - (prod_head - cons_tail))
+            return NA_FALSE;
+    } while (!hg_atomic_cas32_relaxed(&na_sm_queue->prod_head,
+        (hg_util_int32_t) prod_head, (hg_util_int32_t) (prod_head + len)));
+
+    *pos_ptr = prod_head;
+
+    return NA_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_msg_queue_push(struct na_sm_msg_queue *na_sm_queue,
+    hg_util_uint32_t pos, na_sm_msg_hdr_t msg_hdr, const void *buf)
+{
+    hg_util_uint32_t offset = pos & NA_SM_MSG_RING_MASK;
+    size_t n = msg_hdr.hdr.buf_size;
+
+    /* Header is 8-byte aligned and cannot wrap */
+    memcpy(&na_sm_queue->ring[offset], &msg_hdr, sizeof(msg_hdr));
+    offset = (offset + (hg_util_uint32_t) sizeof(msg_hdr)) &
+             NA_SM_MSG_RING_MASK;
+
+    /* Payload may wrap */
+    if (offset + n > NA_SM_MSG_RING_SIZE) {
+        size_t first = NA_SM_MSG_RING_SIZE - offset;
+
+        memcpy(&na_sm_queue->ring[offset], buf, first);
+        memcpy(na_sm_queue->ring, (const char *) buf + first, n - first);
+    } else
+        memcpy(&na_sm_queue->ring[offset], buf, n);
+
+    /* Wait for preceding enqueues to complete */
+    while ((hg_util_uint32_t) hg_atomic_get32(&na_sm_queue->prod_tail) != pos)
+        cpu_spinwait();
+
+    /* Make record visible before publishing it */
+    hg_atomic_fence_release();
+    hg_atomic_set32(&na_sm_queue->prod_tail,
+        (hg_util_int32_t) (pos + NA_SM_MSG_RECORD_SIZE(n)));
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_bool_t
-na_sm_msg_queue_pop(
-    struct na_sm_msg_queue *na_sm_queue, na_sm_msg_hdr_t *msg_hdr_ptr)
+na_sm_msg_queue_pop(struct na_sm_msg_queue *na_sm_queue,
+    na_sm_msg_hdr_t *msg_hdr_ptr, hg_util_uint32_t *pos_ptr)
 {
-    msg_hdr_ptr->val = (na_uint64_t) hg_atomic_queue_pop_mc(
-        (struct hg_atomic_queue *) na_sm_queue);
+    hg_util_uint32_t cons_head, prod_tail;
+
+    do {
+        cons_head =
+            (hg_util_uint32_t) hg_atomic_get32_relaxed(&na_sm_queue->cons_head);
+        prod_tail = (hg_util_uint32_t) hg_atomic_get32(&na_sm_queue->prod_tail);
+
+        /* Empty */
+        if (cons_head == prod_tail)
+            return NA_FALSE;
+
+        /* Read header of published record */
+        hg_atomic_fence_acquire();
+        memcpy(msg_hdr_ptr, &na_sm_queue->ring[cons_head & NA_SM_MSG_RING_MASK],
+            sizeof(*msg_hdr_ptr));
+    } while (!hg_atomic_cas32_relaxed(&na_sm_queue->cons_head,
+        (hg_util_int32_t) cons_head,
+        (hg_util_int32_t) (
+            cons_head + NA_SM_MSG_RECORD_SIZE(msg_hdr_ptr->hdr.buf_size))));
+
+    *pos_ptr = cons_head;
+
+    return NA_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_msg_queue_copy_from(struct na_sm_msg_queue *na_sm_queue,
+    hg_util_uint32_t pos, void *dest, size_t n)
+{
+    hg_util_uint32_t offset =
+        (pos + (hg_util_uint32_t) sizeof(na_sm_msg_hdr_t)) &
+        NA_SM_MSG_RING_MASK;
 
-    return (likely(msg_hdr_ptr->val)) ? NA_TRUE : NA_FALSE;
+    /* Payload may wrap */
+    if (offset + n > NA_SM_MSG_RING_SIZE) {
+        size_t first = NA_SM_MSG_RING_SIZE - offset;
+
+        memcpy(dest, &na_sm_queue->ring[offset], first);
+        memcpy((char *) dest + first, na_sm_queue->ring, n - first);
+    } else
+        memcpy(dest, &na_sm_queue->ring[offset], n);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_msg_queue_release(struct na_sm_msg_queue *na_sm_queue,
+    hg_util_uint32_t pos, na_sm_msg_hdr_t msg_hdr)
+{
+    /* Wait for preceding dequeues to complete */
+    while ((hg_util_uint32_t) hg_atomic_get32(&na_sm_queue->cons_tail) != pos)
+        cpu_spinwait();
+
+    /* Payload must be consumed before space is given back */
+    hg_atomic_fence_release();
+    hg_atomic_set32(&na_sm_queue->cons_tail,
+        (hg_util_int32_t) (pos + NA_SM_MSG_RECORD_SIZE(msg_hdr.hdr.buf_size)));
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_bool_t
 na_sm_msg_queue_is_empty(struct na_sm_msg_queue *na_sm_queue)
 {
-    return hg_atomic_queue_is_empty((struct hg_atomic_queue *) na_sm_queue);
+    return (hg_atomic_get32(&na_sm_queue->cons_head) ==
+               hg_atomic_get32(&na_sm_queue->prod_tail))
+               ? NA_TRUE
+               : NA_FALSE;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1373,7 +2145,7 @@ na_sm_cmd_queue_init(struct na_sm_cmd_queue *na_sm_queue)
 {
     struct hg_atomic_queue *hg_atomic_queue =
         (struct hg_atomic_queue *) na_sm_queue;
-    unsigned int count = NA_SM_MAX_PEERS * 2;
+    unsigned int count = NA_SM_MAX_PEERS_LIMIT * 2;
 
     hg_atomic_queue->prod_size = hg_atomic_queue->cons_size = count;
     hg_atomic_queue->prod_mask = hg_atomic_queue->cons_mask = count - 1;
@@ -1468,7 +2240,8 @@ done:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_region_open(const char *username, pid_t pid, na_uint8_t id,
-    na_bool_t create, struct na_sm_region **region)
+    na_bool_t create, unsigned int pair_count, na_int32_t numa_node,
+    struct na_sm_region **region)
 {
     char shm_name[NA_SM_MAX_FILENAME] = {'\0'};
     struct na_sm_region *na_sm_region = NULL;
@@ -1484,35 +2257,63 @@ na_sm_region_open(const char *username, pid_t pid, na_uint8_t id,
     /* Open SHM object */
     NA_LOG_DEBUG("shm_map() %s", shm_name);
     na_sm_region = (struct na_sm_region *) na_sm_shm_map(
-        shm_name, sizeof(struct na_sm_region), create);
+        shm_name, NA_SM_REGION_SIZE, create);
     NA_CHECK_ERROR(na_sm_region == NULL, done, ret, NA_NODEV,
         "Could not map new SM region (%s)", shm_name);
 
-    if (create) {
-        int i;
+    /* Region layout is set by its creator */
+    if (!create) {
+        pair_count = na_sm_region->pair_count;
+        if (pair_count == 0 || pair_count > NA_SM_MAX_PEERS_LIMIT) {
+            (void) na_sm_shm_unmap(NULL, na_sm_region, NA_SM_REGION_SIZE);
+            NA_GOTO_ERROR(done, ret, NA_PROTOCOL_ERROR,
+                "Invalid number of queue pairs (%u) in SM region (%s)",
+                pair_count, shm_name);
+        }
+    }
 
-        /* Initialize copy buf (all buffers are available by default) */
-        hg_atomic_init64(
-            &na_sm_region->copy_bufs.available.val, ~((hg_util_int64_t) 0));
-        memset(&na_sm_region->copy_bufs.buf, 0,
-            sizeof(na_sm_region->copy_bufs.buf));
+    if (create) {
+        unsigned int i;
+
+        /* Keep track of region so that it can be cleaned up */
+        ret = na_sm_shm_register(username, shm_name, NA_TRUE);
+        if (ret != NA_SUCCESS) {
+            (void) na_sm_shm_unmap(shm_name, na_sm_region, NA_SM_REGION_SIZE);
+            NA_GOTO_ERROR(done, ret, ret, "Could not register SM region (%s)",
+                shm_name);
+        }
 
-        /* Initialize locks */
-        for (i = 0; i < NA_SM_NUM_BUFS; i++)
-            hg_thread_spin_init(&na_sm_region->copy_bufs.buf_locks[i]);
+        /* Place region before it is first touched, failing is not fatal */
+        if (numa_node >= 0) {
+            rc = hg_mem_numa_bind(
+                na_sm_region, NA_SM_REGION_SIZE, (int) numa_node);
+            NA_CHECK_WARNING(rc != HG_UTIL_SUCCESS,
+                "Could not place SM region on NUMA node %d", (int) numa_node);
+        }
 
         /* Initialize queue pairs */
-        for (i = 0; i < 4; i++)
+        for (i = 0; i < pair_count / 64; i++)
             hg_atomic_init64(
-                &na_sm_region->available.val[i], ~((hg_util_int64_t) 0));
-
-        for (i = 0; i < NA_SM_MAX_PEERS; i++) {
-            na_sm_msg_queue_init(&na_sm_region->queue_pairs[i].rx_queue);
-            na_sm_msg_queue_init(&na_sm_region->queue_pairs[i].tx_queue);
+                &na_sm_region->available[i].bits, ~((hg_util_int64_t) 0));
+        if (pair_count % 64)
+            hg_atomic_init64(&na_sm_region->available[i++].bits,
+                (hg_util_int64_t) ((1ULL << (pair_count % 64)) - 1));
+        hg_atomic_init64(&na_sm_region->available_words,
+            (i == 64) ? ~((hg_util_int64_t) 0)
+                      : (hg_util_int64_t) ((1ULL << i) - 1));
+
+        /* Queue pairs are created once reserved, a region left by a previous
+         * process may still name some of them */
+        for (i = 0; i < NA_SM_MAX_PEERS_LIMIT / 64; i++) {
+            hg_atomic_init64(&na_sm_region->created[i], 0);
+            hg_atomic_init64(&na_sm_region->staged[i], 0);
         }
 
         /* Initialize command queue */
         na_sm_cmd_queue_init(&na_sm_region->cmd_queue);
+
+        na_sm_region->pair_count = pair_count;
+        na_sm_region->numa_node = numa_node;
     }
 
     *region = na_sm_region;
@@ -1531,71 +2332,332 @@ na_sm_region_close(const char *username, pid_t pid, na_uint8_t id,
     na_return_t ret = NA_SUCCESS;
 
     if (remove) {
+        unsigned int i;
         int rc = NA_SM_GEN_SHM_NAME(
             shm_name, NA_SM_MAX_FILENAME, username, (int) pid, id);
         NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, done, ret,
             NA_OVERFLOW, "NA_SM_GEN_SHM_NAME() failed, rc: %d", rc);
         shm_name_ptr = shm_name;
+
+        /* Remove queue pairs that peers have created */
+        for (i = 0; i < region->pair_count; i++) {
+            char pair_name[NA_SM_MAX_FILENAME] = {'\0'};
+
+            if (!(hg_atomic_get64(&region->created[i / 64]) &
+                    (hg_util_int64_t) (1ULL << i % 64)))
+                continue;
+
+            rc = NA_SM_GEN_PAIR_NAME(
+                pair_name, NA_SM_MAX_FILENAME, username, (int) pid, id, i);
+            NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, done, ret,
+                NA_OVERFLOW, "NA_SM_GEN_PAIR_NAME() failed, rc: %d", rc);
+
+            NA_LOG_DEBUG("shm_unmap() %s", pair_name);
+            ret = na_sm_shm_unmap(pair_name, NULL, 0);
+            NA_CHECK_NA_ERROR(
+                done, ret, "Could not remove queue pair (%s)", pair_name);
+
+            ret = na_sm_shm_register(username, pair_name, NA_FALSE);
+            NA_CHECK_NA_ERROR(
+                done, ret, "Could not deregister queue pair (%s)", pair_name);
+
+            if (!(hg_atomic_get64(&region->staged[i / 64]) &
+                    (hg_util_int64_t) (1ULL << i % 64)))
+                continue;
+
+            rc = NA_SM_GEN_STAGE_NAME(
+                pair_name, NA_SM_MAX_FILENAME, username, (int) pid, id, i);
+            NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, done, ret,
+                NA_OVERFLOW, "NA_SM_GEN_STAGE_NAME() failed, rc: %d", rc);
+
+            NA_LOG_DEBUG("shm_unmap() %s", pair_name);
+            ret = na_sm_shm_unmap(pair_name, NULL, 0);
+            NA_CHECK_NA_ERROR(
+                done, ret, "Could not remove staging rings (%s)", pair_name);
+
+            ret = na_sm_shm_register(username, pair_name, NA_FALSE);
+            NA_CHECK_NA_ERROR(done, ret,
+                "Could not deregister staging rings (%s)", pair_name);
+        }
     }
 
     NA_LOG_DEBUG("shm_unmap() %s", shm_name_ptr);
-    ret = na_sm_shm_unmap(shm_name_ptr, region, sizeof(struct na_sm_region));
+    ret = na_sm_shm_unmap(shm_name_ptr, region, NA_SM_REGION_SIZE);
     NA_CHECK_NA_ERROR(
         done, ret, "Could not unmap SM region (%s)", shm_name_ptr);
 
+    if (remove) {
+        ret = na_sm_shm_register(username, shm_name, NA_FALSE);
+        NA_CHECK_NA_ERROR(
+            done, ret, "Could not deregister SM region (%s)", shm_name);
+    }
+
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_sock_open(
-    const char *username, pid_t pid, na_uint8_t id, na_bool_t create, int *sock)
+na_sm_queue_pair_open(const char *username, pid_t pid, na_uint8_t id,
+    struct na_sm_region *region, na_uint16_t index,
+    struct na_sm_queue_pair **queue_pair)
 {
-    int socket_type = SOCK_DGRAM, /* reliable with AF_UNIX */
-        fd = -1, rc;
-    char pathname[NA_SM_MAX_FILENAME] = {'\0'};
-    na_bool_t created_sock_path = NA_FALSE;
+    char shm_name[NA_SM_MAX_FILENAME] = {'\0'};
+    struct na_sm_queue_pair *na_sm_queue_pair = NULL;
+    hg_atomic_int64_t *created = &region->created[index / 64];
+    hg_util_int64_t bit = (hg_util_int64_t) (1ULL << index % 64);
+    na_bool_t create = !(hg_atomic_get64(created) & bit);
     na_return_t ret = NA_SUCCESS;
+    int rc;
 
-    /* Create a non-blocking socket so that we can poll for incoming connections
-     */
-#ifdef SOCK_NONBLOCK
-    socket_type |= SOCK_NONBLOCK;
-#endif
-    fd = socket(AF_UNIX, socket_type, 0);
-    NA_CHECK_ERROR(fd == -1, error, ret, na_sm_errno_to_na(errno),
-        "socket() failed (%s)", strerror(errno));
+    rc = NA_SM_GEN_PAIR_NAME(
+        shm_name, NA_SM_MAX_FILENAME, username, (int) pid, id, index);
+    NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, done, ret, NA_OVERFLOW,
+        "NA_SM_GEN_PAIR_NAME() failed, rc: %d", rc);
 
-#ifndef SOCK_NONBLOCK
-    rc = fcntl(fd, F_SETFL, O_NONBLOCK);
-    NA_CHECK_ERROR(rc == -1, error, ret, na_sm_errno_to_na(errno),
-        "fcntl() failed (%s)", strerror(errno));
-#endif
+    /* Only the peer that reserves a pair can see it as not created yet */
+    NA_LOG_DEBUG("shm_map() %s", shm_name);
+    na_sm_queue_pair = (struct na_sm_queue_pair *) na_sm_shm_map(
+        shm_name, NA_SM_QUEUE_PAIR_SIZE, create);
+    NA_CHECK_ERROR(na_sm_queue_pair == NULL, done, ret, NA_NODEV,
+        "Could not map queue pair (%s)", shm_name);
 
     if (create) {
-        struct sockaddr_un addr;
+        /* Keep track of queue pair so that it can be cleaned up */
+        ret = na_sm_shm_register(username, shm_name, NA_TRUE);
+        if (ret != NA_SUCCESS) {
+            (void) na_sm_shm_unmap(
+                shm_name, na_sm_queue_pair, NA_SM_QUEUE_PAIR_SIZE);
+            NA_GOTO_ERROR(done, ret, ret,
+                "Could not register queue pair (%s)", shm_name);
+        }
 
-        /* Generate named socket path */
-        rc = NA_SM_GEN_SOCK_PATH(
-            pathname, NA_SM_MAX_FILENAME, username, pid, id);
-        NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, error, ret,
-            NA_OVERFLOW, "NA_SM_GEN_SOCK_PATH() failed, rc: %d", rc);
+        /* Place queue pair with the region, failing is not fatal */
+        if (region->numa_node >= 0) {
+            rc = hg_mem_numa_bind(na_sm_queue_pair, NA_SM_QUEUE_PAIR_SIZE,
+                (int) region->numa_node);
+            NA_CHECK_WARNING(rc != HG_UTIL_SUCCESS,
+                "Could not place queue pair on NUMA node %d",
+                (int) region->numa_node);
+        }
 
-        memset(&addr, 0, sizeof(struct sockaddr_un));
-        addr.sun_family = AF_UNIX;
-        NA_CHECK_ERROR(strlen(pathname) + strlen(NA_SM_SOCK_NAME) >
-                           sizeof(addr.sun_path) - 1,
-            error, ret, NA_OVERFLOW,
-            "Exceeds maximum AF UNIX socket path length");
-        strcpy(addr.sun_path, pathname);
-        strcat(addr.sun_path, NA_SM_SOCK_NAME);
+        /* Queue pair may have been left by a previous process */
+        na_sm_msg_queue_init(&na_sm_queue_pair->rx_queue);
+        na_sm_msg_queue_init(&na_sm_queue_pair->tx_queue);
 
-        /* Create path */
-        ret = na_sm_sock_path_create(pathname);
-        NA_CHECK_NA_ERROR(
-            error, ret, "Could not create socket path (%s)", pathname);
-        created_sock_path = NA_TRUE;
+        hg_atomic_or64(created, bit);
+    }
+
+    *queue_pair = na_sm_queue_pair;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_queue_pair_close(struct na_sm_queue_pair *queue_pair)
+{
+    return na_sm_shm_unmap(NULL, queue_pair, NA_SM_QUEUE_PAIR_SIZE);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_msg_pool_create(const char *username, pid_t pid, na_uint8_t id,
+    na_size_t buf_size, struct na_sm_msg_pool *na_sm_msg_pool)
+{
+    na_return_t ret = NA_SUCCESS;
+    unsigned int i;
+    int rc;
+
+    /* Keep buffers cache-line aligned */
+    na_sm_msg_pool->buf_size = (buf_size + NA_SM_CACHE_LINE_SIZE - 1) &
+                               ~((na_size_t) NA_SM_CACHE_LINE_SIZE - 1);
+    na_sm_msg_pool->count =
+        (unsigned int) (NA_SM_MSG_POOL_SIZE / na_sm_msg_pool->buf_size);
+    NA_CHECK_ERROR(na_sm_msg_pool->count == 0, error, ret, NA_OVERFLOW,
+        "Msg size exceeds pool size (%zu)", buf_size);
+
+    rc = NA_SM_GEN_POOL_NAME(
+        na_sm_msg_pool->name, NA_SM_MAX_FILENAME, username, (int) pid, id);
+    NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, error, ret, NA_OVERFLOW,
+        "NA_SM_GEN_POOL_NAME() failed, rc: %d", rc);
+
+    na_sm_msg_pool->free_bufs =
+        (unsigned int *) malloc(na_sm_msg_pool->count * sizeof(unsigned int));
+    NA_CHECK_ERROR(na_sm_msg_pool->free_bufs == NULL, error, ret, NA_NOMEM,
+        "Could not allocate free buffer stack");
+    for (i = 0; i < na_sm_msg_pool->count; i++)
+        na_sm_msg_pool->free_bufs[i] = na_sm_msg_pool->count - 1 - i;
+    na_sm_msg_pool->free_count = na_sm_msg_pool->count;
+
+    NA_LOG_DEBUG("shm_map() %s (%u msg buffers)", na_sm_msg_pool->name,
+        na_sm_msg_pool->count);
+    na_sm_msg_pool->base = (char *) na_sm_shm_map(
+        na_sm_msg_pool->name, NA_SM_MSG_POOL_SIZE, NA_TRUE);
+    NA_CHECK_ERROR(na_sm_msg_pool->base == NULL, error, ret, NA_NODEV,
+        "Could not map msg pool (%s)", na_sm_msg_pool->name);
+
+    /* Keep track of pool so that it can be cleaned up */
+    ret = na_sm_shm_register(username, na_sm_msg_pool->name, NA_TRUE);
+    NA_CHECK_NA_ERROR(
+        error, ret, "Could not register msg pool (%s)", na_sm_msg_pool->name);
+
+    hg_thread_spin_init(&na_sm_msg_pool->lock);
+
+    return ret;
+
+error:
+    if (na_sm_msg_pool->base)
+        (void) na_sm_shm_unmap(
+            na_sm_msg_pool->name, na_sm_msg_pool->base, NA_SM_MSG_POOL_SIZE);
+    free(na_sm_msg_pool->free_bufs);
+    memset(na_sm_msg_pool, 0, sizeof(*na_sm_msg_pool));
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_msg_pool_destroy(
+    const char *username, struct na_sm_msg_pool *na_sm_msg_pool)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    if (!na_sm_msg_pool->base)
+        goto done;
+
+    NA_CHECK_WARNING(na_sm_msg_pool->free_count != na_sm_msg_pool->count,
+        "%u msg buffers were not freed",
+        na_sm_msg_pool->count - na_sm_msg_pool->free_count);
+
+    NA_LOG_DEBUG("shm_unmap() %s", na_sm_msg_pool->name);
+    ret = na_sm_shm_unmap(
+        na_sm_msg_pool->name, na_sm_msg_pool->base, NA_SM_MSG_POOL_SIZE);
+    NA_CHECK_NA_ERROR(
+        done, ret, "Could not unmap msg pool (%s)", na_sm_msg_pool->name);
+
+    ret = na_sm_shm_register(username, na_sm_msg_pool->name, NA_FALSE);
+    NA_CHECK_NA_ERROR(
+        done, ret, "Could not deregister msg pool (%s)", na_sm_msg_pool->name);
+
+    hg_thread_spin_destroy(&na_sm_msg_pool->lock);
+    free(na_sm_msg_pool->free_bufs);
+    memset(na_sm_msg_pool, 0, sizeof(*na_sm_msg_pool));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_msg_pool_attach(const char *username, struct na_sm_addr *na_sm_addr)
+{
+    char shm_name[NA_SM_MAX_FILENAME] = {'\0'};
+    int rc;
+
+    if (na_sm_addr->msg_pool)
+        return;
+
+    rc = NA_SM_GEN_POOL_NAME(shm_name, NA_SM_MAX_FILENAME, username,
+        (int) na_sm_addr->pid, na_sm_addr->id);
+    NA_CHECK_ERROR_NORET(rc < 0 || rc > NA_SM_MAX_FILENAME, done,
+        "NA_SM_GEN_POOL_NAME() failed, rc: %d", rc);
+
+    /* Peers that have no pool only send msgs through the msg queue */
+    NA_LOG_DEBUG("shm_map() %s", shm_name);
+    na_sm_addr->msg_pool =
+        (char *) na_sm_shm_map(shm_name, NA_SM_MSG_POOL_SIZE, NA_FALSE);
+    if (na_sm_addr->msg_pool == NULL)
+        NA_LOG_DEBUG("Could not map msg pool (%s)", shm_name);
+
+done:
+    return;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_msg_pool_detach(struct na_sm_addr *na_sm_addr)
+{
+    if (!na_sm_addr->msg_pool)
+        return;
+
+    (void) na_sm_shm_unmap(NULL, na_sm_addr->msg_pool, NA_SM_MSG_POOL_SIZE);
+    na_sm_addr->msg_pool = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_bool_t
+na_sm_msg_pool_use(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *na_sm_addr, const void *buf, na_size_t buf_size)
+{
+    const char *base = na_sm_endpoint->msg_pool.base;
+
+    /* Msg must have been encoded in a pool buffer */
+    if (base == NULL || (const char *) buf < base ||
+        (const char *) buf + buf_size > base + NA_SM_MSG_POOL_SIZE)
+        return NA_FALSE;
+
+    /* Buffer cannot be reused until the receiver has released the record,
+     * only defer completion when the receiver does not need to wake us up
+     * for that, otherwise copying the msg to the queue is cheaper */
+    if (na_sm_endpoint->poll_set &&
+        !(na_sm_addr->rx_queue &&
+            hg_atomic_get32(&na_sm_addr->rx_queue->cons_polling)))
+        return NA_FALSE;
+
+    return NA_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_sock_open(
+    const char *username, pid_t pid, na_uint8_t id, na_bool_t create, int *sock)
+{
+    int socket_type = SOCK_DGRAM, /* reliable with AF_UNIX */
+        fd = -1, rc;
+    char pathname[NA_SM_MAX_FILENAME] = {'\0'};
+    na_bool_t created_sock_path = NA_FALSE;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Create a non-blocking socket so that we can poll for incoming connections
+     */
+#ifdef SOCK_NONBLOCK
+    socket_type |= SOCK_NONBLOCK;
+#endif
+    fd = socket(AF_UNIX, socket_type, 0);
+    NA_CHECK_ERROR(fd == -1, error, ret, na_sm_errno_to_na(errno),
+        "socket() failed (%s)", strerror(errno));
+
+#ifndef SOCK_NONBLOCK
+    rc = fcntl(fd, F_SETFL, O_NONBLOCK);
+    NA_CHECK_ERROR(rc == -1, error, ret, na_sm_errno_to_na(errno),
+        "fcntl() failed (%s)", strerror(errno));
+#endif
+
+    if (create) {
+        struct sockaddr_un addr;
+
+        /* Generate named socket path */
+        rc = NA_SM_GEN_SOCK_PATH(
+            pathname, NA_SM_MAX_FILENAME, username, pid, id);
+        NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, error, ret,
+            NA_OVERFLOW, "NA_SM_GEN_SOCK_PATH() failed, rc: %d", rc);
+
+        memset(&addr, 0, sizeof(struct sockaddr_un));
+        addr.sun_family = AF_UNIX;
+        NA_CHECK_ERROR(strlen(pathname) + strlen(NA_SM_SOCK_NAME) >
+                           sizeof(addr.sun_path) - 1,
+            error, ret, NA_OVERFLOW,
+            "Exceeds maximum AF UNIX socket path length");
+        strcpy(addr.sun_path, pathname);
+        strcat(addr.sun_path, NA_SM_SOCK_NAME);
+
+        /* Create path */
+        ret = na_sm_sock_path_create(pathname);
+        NA_CHECK_NA_ERROR(
+            error, ret, "Could not create socket path (%s)", pathname);
+        created_sock_path = NA_TRUE;
 
         /* Bind and create named socket */
         NA_LOG_DEBUG("bind() %s", addr.sun_path);
@@ -1742,7 +2804,7 @@ na_sm_sock_path_cleanup(const char *fpath, const struct stat NA_UNUSED *sb,
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_event_create(const char NA_UNUSED *username, pid_t NA_UNUSED pid,
-    na_uint8_t NA_UNUSED id, na_uint8_t NA_UNUSED pair_index,
+    na_uint8_t NA_UNUSED id, na_uint16_t NA_UNUSED pair_index,
     unsigned char NA_UNUSED pair, int *event)
 {
     na_return_t ret = NA_SUCCESS;
@@ -1802,7 +2864,7 @@ error:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_event_destroy(const char NA_UNUSED *username, pid_t NA_UNUSED pid,
-    na_uint8_t NA_UNUSED id, na_uint8_t NA_UNUSED pair_index,
+    na_uint8_t NA_UNUSED id, na_uint16_t NA_UNUSED pair_index,
     unsigned char NA_UNUSED pair, na_bool_t NA_UNUSED remove, int event)
 {
     na_return_t ret = NA_SUCCESS;
@@ -1895,9 +2957,10 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_poll_register(hg_poll_set_t *poll_set, int fd, void *ptr)
+na_sm_poll_register(
+    hg_poll_set_t *poll_set, int fd, hg_util_uint32_t events, void *ptr)
 {
-    struct hg_poll_event event = {.events = HG_POLLIN, .data.ptr = ptr};
+    struct hg_poll_event event = {.events = events, .data.ptr = ptr};
     na_return_t ret = NA_SUCCESS;
     int rc;
 
@@ -1928,10 +2991,11 @@ done:
 static na_return_t
 na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *username,
     pid_t pid, na_uint8_t id, na_bool_t listen, na_bool_t no_wait,
-    na_uint32_t nofile_max)
+    unsigned int peer_max, na_uint32_t nofile_max, na_int32_t numa_node)
 {
     struct na_sm_region *shared_region = NULL;
-    na_uint8_t queue_pair_idx = 0;
+    struct na_sm_queue_pair *queue_pair = NULL;
+    na_uint16_t queue_pair_idx = 0;
     na_bool_t queue_pair_reserved = NA_FALSE, sock_registered = NA_FALSE;
     int tx_notify = -1;
     na_return_t ret = NA_SUCCESS, err_ret;
@@ -1950,8 +3014,20 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *username,
     hg_thread_spin_init(&na_sm_endpoint->expected_op_queue.lock);
 
     HG_QUEUE_INIT(&na_sm_endpoint->retry_op_queue.queue);
+    na_sm_endpoint->retry_ticks = 0;
+    na_sm_endpoint->retry_backoff = 0;
     hg_thread_spin_init(&na_sm_endpoint->retry_op_queue.lock);
 
+    HG_QUEUE_INIT(&na_sm_endpoint->cma_op_queue.queue);
+    hg_thread_spin_init(&na_sm_endpoint->cma_op_queue.lock);
+
+    HG_QUEUE_INIT(&na_sm_endpoint->stage_op_queue.queue);
+    hg_thread_spin_init(&na_sm_endpoint->stage_op_queue.lock);
+
+    /* Initialize registered memory list */
+    HG_LIST_INIT(&na_sm_endpoint->mem_handles.list);
+    hg_thread_rwlock_init(&na_sm_endpoint->mem_handles.lock);
+
     /* Initialize number of fds */
     hg_atomic_init32(&na_sm_endpoint->nofile, 0);
     na_sm_endpoint->nofile_max = nofile_max;
@@ -1971,13 +3047,19 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *username,
 
     if (listen) {
         /* If we're listening, create a new shm region */
-        ret = na_sm_region_open(username, pid, id, NA_TRUE, &shared_region);
+        ret = na_sm_region_open(
+            username, pid, id, NA_TRUE, peer_max, numa_node, &shared_region);
         NA_CHECK_NA_ERROR(error, ret, "Could not open shared-memory region");
 
         /* Reserve queue pair for loopback */
-        ret = na_sm_queue_pair_reserve(shared_region, &queue_pair_idx);
+        ret = na_sm_queue_pair_reserve(
+            shared_region, (unsigned int) pid, &queue_pair_idx);
         NA_CHECK_NA_ERROR(error, ret, "Could not reserve queue pair");
         queue_pair_reserved = NA_TRUE;
+
+        ret = na_sm_queue_pair_open(
+            username, pid, id, shared_region, queue_pair_idx, &queue_pair);
+        NA_CHECK_NA_ERROR(error, ret, "Could not open queue pair");
     }
 
     if (!no_wait) {
@@ -1998,7 +3080,8 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *username,
                 "Registering sock %d for polling", na_sm_endpoint->sock);
             /* Add sock to poll set (ony required if we're listening) */
             ret = na_sm_poll_register(na_sm_endpoint->poll_set,
-                na_sm_endpoint->sock, &na_sm_endpoint->sock_poll_type);
+                na_sm_endpoint->sock, HG_POLLIN,
+                &na_sm_endpoint->sock_poll_type);
             NA_CHECK_NA_ERROR(error, ret, "Could not add sock to poll set");
             sock_registered = NA_TRUE;
         }
@@ -2019,11 +3102,10 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *username,
     if (listen) {
         na_sm_endpoint->source_addr->queue_pair_idx = queue_pair_idx;
         na_sm_endpoint->source_addr->shared_region = shared_region;
+        na_sm_endpoint->source_addr->pair = queue_pair;
 
-        na_sm_endpoint->source_addr->tx_queue =
-            &shared_region->queue_pairs[queue_pair_idx].tx_queue;
-        na_sm_endpoint->source_addr->rx_queue =
-            &shared_region->queue_pairs[queue_pair_idx].rx_queue;
+        na_sm_endpoint->source_addr->tx_queue = &queue_pair->tx_queue;
+        na_sm_endpoint->source_addr->rx_queue = &queue_pair->rx_queue;
     }
 
     /* Add source tx notify to poll set for local notifications */
@@ -2032,7 +3114,7 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *username,
         na_sm_endpoint->source_addr->tx_poll_type = NA_SM_POLL_TX_NOTIFY;
         NA_LOG_DEBUG("Registering tx notify %d for polling", tx_notify);
         ret = na_sm_poll_register(na_sm_endpoint->poll_set, tx_notify,
-            &na_sm_endpoint->source_addr->tx_poll_type);
+            NA_SM_POLL_NOTIFY, &na_sm_endpoint->source_addr->tx_poll_type);
         NA_CHECK_NA_ERROR(error, ret, "Could not add tx notify to poll set");
     }
 
@@ -2061,6 +3143,8 @@ error:
         hg_poll_destroy(na_sm_endpoint->poll_set);
         hg_atomic_decr32(&na_sm_endpoint->nofile);
     }
+    if (queue_pair)
+        na_sm_queue_pair_close(queue_pair);
     if (queue_pair_reserved)
         na_sm_queue_pair_release(shared_region, queue_pair_idx);
     if (shared_region)
@@ -2074,6 +3158,9 @@ error:
     hg_thread_spin_destroy(&na_sm_endpoint->unexpected_op_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->expected_op_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->retry_op_queue.lock);
+    hg_thread_spin_destroy(&na_sm_endpoint->cma_op_queue.lock);
+    hg_thread_spin_destroy(&na_sm_endpoint->stage_op_queue.lock);
+    hg_thread_rwlock_destroy(&na_sm_endpoint->mem_handles.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->poll_addr_list.lock);
 
     return ret;
@@ -2143,8 +3230,25 @@ na_sm_endpoint_close(
     NA_CHECK_ERROR(empty == NA_FALSE, done, ret, NA_BUSY,
         "Retry op queue should be empty");
 
+    /* Check that CMA op queue is empty */
+    hg_thread_spin_lock(&na_sm_endpoint->cma_op_queue.lock);
+    empty = HG_QUEUE_IS_EMPTY(&na_sm_endpoint->cma_op_queue.queue);
+    hg_thread_spin_unlock(&na_sm_endpoint->cma_op_queue.lock);
+    NA_CHECK_ERROR(empty == NA_FALSE, done, ret, NA_BUSY,
+        "CMA op queue should be empty");
+
+    /* Check that staged RMA op queue is empty */
+    hg_thread_spin_lock(&na_sm_endpoint->stage_op_queue.lock);
+    empty = HG_QUEUE_IS_EMPTY(&na_sm_endpoint->stage_op_queue.queue);
+    hg_thread_spin_unlock(&na_sm_endpoint->stage_op_queue.lock);
+    NA_CHECK_ERROR(empty == NA_FALSE, done, ret, NA_BUSY,
+        "Staged RMA op queue should be empty");
+
     if (source_addr) {
         if (source_addr->shared_region) {
+            ret = na_sm_queue_pair_close(source_addr->pair);
+            NA_CHECK_NA_ERROR(done, ret, "na_sm_queue_pair_close() failed");
+
             na_sm_queue_pair_release(
                 source_addr->shared_region, source_addr->queue_pair_idx);
 
@@ -2177,6 +3281,7 @@ na_sm_endpoint_close(
 
             na_sm_endpoint->sock = -1;
         }
+        na_sm_msg_pool_detach(source_addr);
         free(source_addr);
         na_sm_endpoint->source_addr = NULL;
     }
@@ -2206,6 +3311,9 @@ na_sm_endpoint_close(
     hg_thread_spin_destroy(&na_sm_endpoint->unexpected_op_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->expected_op_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->retry_op_queue.lock);
+    hg_thread_spin_destroy(&na_sm_endpoint->cma_op_queue.lock);
+    hg_thread_spin_destroy(&na_sm_endpoint->stage_op_queue.lock);
+    hg_thread_rwlock_destroy(&na_sm_endpoint->mem_handles.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->poll_addr_list.lock);
 
 done:
@@ -2214,56 +3322,62 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_return_t
-na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, na_uint8_t *index)
+na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, unsigned int hint,
+    na_uint16_t *index)
 {
-    unsigned int j = 0;
+    unsigned int count = (na_sm_region->pair_count + 63) / 64, k;
 
-    do {
-        hg_util_int64_t bits = 1LL;
-        unsigned int i = 0;
+    for (k = 0; k < count; k++) {
+        unsigned int j = (hint + k) % count;
+        hg_atomic_int64_t *word = &na_sm_region->available[j].bits;
+        hg_util_int64_t available, word_bit = (hg_util_int64_t) (1ULL << j);
 
-        do {
-            hg_util_int64_t available =
-                hg_atomic_get64(&na_sm_region->available.val[j]);
-            if (!available) {
-                j++;
-                break;
-            }
+        /* Skip words that have no pair left without touching them */
+        if (!(hg_atomic_get64(&na_sm_region->available_words) & word_bit))
+            continue;
+
+        /* Can't use atomic XOR directly, if there is a race and the cas
+         * fails, we should be able to pick the next one available */
+        while ((available = hg_atomic_get64(word)) != 0) {
+            unsigned int i = (unsigned int) __builtin_ctzll(
+                (unsigned long long) available);
+            hg_util_int64_t bits = (hg_util_int64_t) (1ULL << i);
 
-            if ((available & bits) != bits) {
-                /* Already reserved */
-                hg_atomic_fence();
-                i++;
-                bits <<= 1;
+            if (!hg_atomic_cas64(word, available, available & ~bits))
                 continue;
-            }
 
-            if (hg_atomic_cas64(&na_sm_region->available.val[j], available,
-                    available & ~bits)) {
+            /* Last pair of word, a concurrent release may have happened
+             * before the word is marked empty so check again */
+            if ((available & ~bits) == 0) {
+                hg_atomic_and64(&na_sm_region->available_words, ~word_bit);
+                if (hg_atomic_get64(word) != 0)
+                    hg_atomic_or64(&na_sm_region->available_words, word_bit);
+            }
 #ifdef NA_HAS_DEBUG
+            {
                 char buf[65] = {'\0'};
-                available = hg_atomic_get64(&na_sm_region->available.val[j]);
+                available = hg_atomic_get64(word);
                 NA_LOG_DEBUG("Reserved pair index %u\n### Available: %s",
                     (i + (j * 64)),
                     lltoa((hg_util_uint64_t) available, buf, 2));
-#endif
-                *index = (na_uint8_t)(i + (j * 64));
-                return NA_SUCCESS;
             }
-
-            /* Can't use atomic XOR directly, if there is a race and the cas
-             * fails, we should be able to pick the next one available */
-        } while (i < 64);
-    } while (j < 4);
+#endif
+            *index = (na_uint16_t) (i + (j * 64));
+            return NA_SUCCESS;
+        }
+    }
 
     return NA_AGAIN;
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
-na_sm_queue_pair_release(struct na_sm_region *na_sm_region, na_uint8_t index)
+na_sm_queue_pair_release(struct na_sm_region *na_sm_region, na_uint16_t index)
 {
-    hg_atomic_or64(&na_sm_region->available.val[index / 64], 1LL << index % 64);
+    hg_atomic_or64(&na_sm_region->available[index / 64].bits,
+        (hg_util_int64_t) (1ULL << index % 64));
+    hg_atomic_or64(&na_sm_region->available_words,
+        (hg_util_int64_t) (1ULL << index / 64));
     NA_LOG_DEBUG("Released pair index %u", index);
 }
 
@@ -2380,6 +3494,7 @@ na_sm_addr_create(
     na_sm_addr->unexpected = unexpected;
     hg_atomic_init32(&na_sm_addr->ref_count, 1);
     hg_atomic_init32(&na_sm_addr->status, 0);
+    hg_atomic_init32(&na_sm_addr->stage_busy, 0);
 
     /* Assign PID/ID */
     na_sm_addr->pid = pid;
@@ -2389,6 +3504,12 @@ na_sm_addr_create(
     na_sm_addr->tx_notify = -1;
     na_sm_addr->rx_notify = -1;
 
+#ifdef NA_SM_HAS_XPMEM
+    HG_LIST_INIT(&na_sm_addr->xpmem_cache.list);
+    hg_thread_rwlock_init(&na_sm_addr->xpmem_cache.lock);
+    na_sm_addr->xpmem_cache.apid = -1;
+#endif
+
     *addr = na_sm_addr;
 
 done:
@@ -2407,6 +3528,11 @@ na_sm_addr_destroy(struct na_sm_endpoint *na_sm_endpoint, const char *username,
         NA_CHECK_NA_ERROR(done, ret, "Could not release NA SM addr");
     }
 
+    na_sm_msg_pool_detach(na_sm_addr);
+#ifdef NA_SM_HAS_XPMEM
+    na_sm_xpmem_cache_destroy(&na_sm_addr->xpmem_cache);
+#endif
+    free(na_sm_addr->stage_req);
     free(na_sm_addr);
 
 done:
@@ -2425,30 +3551,40 @@ na_sm_addr_resolve(struct na_sm_endpoint *na_sm_endpoint, const char *username,
     /* Open shm region */
     if (!na_sm_addr->shared_region) {
         ret = na_sm_region_open(username, na_sm_addr->pid, na_sm_addr->id,
-            NA_FALSE, &na_sm_addr->shared_region);
+            NA_FALSE, 0, NA_NUMA_NODE_ANY, &na_sm_addr->shared_region);
         NA_CHECK_NA_ERROR(error, ret, "Could not open shared-memory region");
     }
 
+    /* Map msg pool of peer */
+    na_sm_msg_pool_attach(username, na_sm_addr);
+
     /* Reserve queue pair */
     if (!(hg_atomic_get32(&na_sm_addr->status) & NA_SM_ADDR_RESERVED)) {
-        ret = na_sm_queue_pair_reserve(
-            na_sm_addr->shared_region, &na_sm_addr->queue_pair_idx);
+        /* Spread peers over words of the pair bitmap */
+        ret = na_sm_queue_pair_reserve(na_sm_addr->shared_region,
+            (unsigned int) getpid(), &na_sm_addr->queue_pair_idx);
         NA_CHECK_NA_ERROR(error, ret, "Could not reserve queue pair");
         hg_atomic_or32(&na_sm_addr->status, NA_SM_ADDR_RESERVED);
 
-        na_sm_addr->tx_queue =
-            &na_sm_addr->shared_region->queue_pairs[na_sm_addr->queue_pair_idx]
-                 .tx_queue;
-        na_sm_addr->rx_queue =
-            &na_sm_addr->shared_region->queue_pairs[na_sm_addr->queue_pair_idx]
-                 .rx_queue;
+        ret = na_sm_queue_pair_open(username, na_sm_addr->pid, na_sm_addr->id,
+            na_sm_addr->shared_region, na_sm_addr->queue_pair_idx,
+            &na_sm_addr->pair);
+        NA_CHECK_NA_ERROR(error, ret, "Could not open queue pair");
+
+        na_sm_addr->tx_queue = &na_sm_addr->pair->tx_queue;
+        na_sm_addr->rx_queue = &na_sm_addr->pair->rx_queue;
+
+        /* Previous user of the pair may have left staging rings */
+        ret = na_sm_stage_attach(
+            na_sm_endpoint, username, na_sm_addr, NA_FALSE);
+        NA_CHECK_NA_ERROR(error, ret, "Could not attach staging rings");
     }
 
     /* Fill cmd header */
     cmd_hdr.hdr.type = NA_SM_RESERVED;
     cmd_hdr.hdr.pid = (unsigned int) na_sm_endpoint->source_addr->pid;
     cmd_hdr.hdr.id = na_sm_endpoint->source_addr->id & 0xff;
-    cmd_hdr.hdr.pair_idx = na_sm_addr->queue_pair_idx & 0xff;
+    cmd_hdr.hdr.pair_idx = na_sm_addr->queue_pair_idx & 0xffff;
 
     NA_LOG_DEBUG("Pushing cmd with %d for %d/%" SCNu8 "/%" SCNu8 " val=%lu",
         cmd_hdr.hdr.type, cmd_hdr.hdr.pid, cmd_hdr.hdr.id, cmd_hdr.hdr.pair_idx,
@@ -2485,7 +3621,8 @@ na_sm_addr_resolve(struct na_sm_endpoint *na_sm_endpoint, const char *username,
 
             /* Add remote rx notify to poll set */
             ret = na_sm_poll_register(na_sm_endpoint->poll_set,
-                na_sm_addr->rx_notify, &na_sm_addr->rx_poll_type);
+                na_sm_addr->rx_notify, NA_SM_POLL_NOTIFY,
+                &na_sm_addr->rx_poll_type);
             NA_CHECK_NA_ERROR(
                 error, ret, "Could not add rx notify to poll set");
         }
@@ -2517,6 +3654,19 @@ error:
         na_return_t err_ret;
 
         if (hg_atomic_get32(&na_sm_addr->status) & NA_SM_ADDR_RESERVED) {
+            if (na_sm_addr->stage) {
+                err_ret = na_sm_stage_detach(na_sm_addr);
+                NA_CHECK_ERROR_DONE(
+                    err_ret != NA_SUCCESS, "na_sm_stage_detach() failed");
+            }
+            if (na_sm_addr->pair) {
+                err_ret = na_sm_queue_pair_close(na_sm_addr->pair);
+                NA_CHECK_ERROR_DONE(
+                    err_ret != NA_SUCCESS, "na_sm_queue_pair_close() failed");
+                na_sm_addr->pair = NULL;
+                na_sm_addr->tx_queue = NULL;
+                na_sm_addr->rx_queue = NULL;
+            }
             na_sm_queue_pair_release(
                 na_sm_addr->shared_region, na_sm_addr->queue_pair_idx);
             hg_atomic_and32(&na_sm_addr->status, ~NA_SM_ADDR_RESERVED);
@@ -2558,6 +3708,21 @@ na_sm_addr_release(struct na_sm_endpoint *na_sm_endpoint, const char *username,
 {
     na_return_t ret = NA_SUCCESS;
 
+    /* Next users of the queue pair may rely on notifications */
+    if (na_sm_addr->rx_queue)
+        hg_atomic_set32(&na_sm_addr->rx_queue->cons_polling, 0);
+
+    if (na_sm_addr->stage) {
+        ret = na_sm_stage_detach(na_sm_addr);
+        NA_CHECK_NA_ERROR(done, ret, "na_sm_stage_detach() failed");
+    }
+
+    if (na_sm_addr->pair) {
+        ret = na_sm_queue_pair_close(na_sm_addr->pair);
+        NA_CHECK_NA_ERROR(done, ret, "na_sm_queue_pair_close() failed");
+        na_sm_addr->pair = NULL;
+    }
+
     if (na_sm_addr->unexpected) {
         /* Release queue pair */
         na_sm_queue_pair_release(
@@ -2569,7 +3734,7 @@ na_sm_addr_release(struct na_sm_endpoint *na_sm_endpoint, const char *username,
         cmd_hdr.hdr.type = NA_SM_RELEASED;
         cmd_hdr.hdr.pid = (unsigned int) na_sm_endpoint->source_addr->pid;
         cmd_hdr.hdr.id = na_sm_endpoint->source_addr->id & 0xff;
-        cmd_hdr.hdr.pair_idx = na_sm_addr->queue_pair_idx & 0xff;
+        cmd_hdr.hdr.pair_idx = na_sm_addr->queue_pair_idx & 0xffff;
 
         if (na_sm_endpoint->poll_set) {
             /* Send events to remote process (silence error as this is best
@@ -2621,6 +3786,23 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_return_t
+na_sm_addr_notify(struct na_sm_addr *na_sm_addr)
+{
+    /* Notifications are disabled */
+    if (na_sm_addr->tx_notify < 0)
+        return NA_SUCCESS;
+
+    /* Pairs with na_sm_poll_set_polling(), peer will find the msg if it is
+     * still polling */
+    hg_atomic_fence();
+    if (hg_atomic_get32(&na_sm_addr->tx_queue->cons_polling))
+        return NA_SUCCESS;
+
+    return na_sm_event_set(na_sm_addr->tx_notify);
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_addr_event_send(int sock, const char *username, pid_t pid, na_uint8_t id,
@@ -2758,74 +3940,6 @@ done:
     return ret;
 }
 
-/*---------------------------------------------------------------------------*/
-static NA_INLINE na_return_t
-na_sm_buf_reserve(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int *index)
-{
-    hg_util_int64_t bits = 1LL;
-    unsigned int i = 0;
-
-    do {
-        hg_util_int64_t available =
-            hg_atomic_get64(&na_sm_copy_buf->available.val);
-        if (!available) {
-            /* Nothing available */
-            break;
-        }
-        if ((available & bits) != bits) {
-            /* Already reserved */
-            hg_atomic_fence();
-            i++;
-            bits <<= 1;
-            continue;
-        }
-
-        if (hg_atomic_cas64(
-                &na_sm_copy_buf->available.val, available, available & ~bits)) {
-#ifdef NA_HAS_DEBUG
-            char buf[65] = {'\0'};
-            available = hg_atomic_get64(&na_sm_copy_buf->available.val);
-            NA_LOG_DEBUG("Reserved bit index %u\n### Available: %s", i,
-                lltoa((hg_util_uint64_t) available, buf, 2));
-#endif
-            *index = i;
-            return NA_SUCCESS;
-        }
-        /* Can't use atomic XOR directly, if there is a race and the cas
-         * fails, we should be able to pick the next one available */
-    } while (i < NA_SM_NUM_BUFS);
-
-    return NA_AGAIN;
-}
-
-/*---------------------------------------------------------------------------*/
-static NA_INLINE void
-na_sm_buf_release(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index)
-{
-    hg_atomic_or64(&na_sm_copy_buf->available.val, 1LL << index);
-    NA_LOG_DEBUG("Released bit index %u", index);
-}
-
-/*---------------------------------------------------------------------------*/
-static NA_INLINE void
-na_sm_buf_copy_to(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index,
-    const void *src, size_t n)
-{
-    hg_thread_spin_lock(&na_sm_copy_buf->buf_locks[index]);
-    memcpy(na_sm_copy_buf->buf[index], src, n);
-    hg_thread_spin_unlock(&na_sm_copy_buf->buf_locks[index]);
-}
-
-/*---------------------------------------------------------------------------*/
-static NA_INLINE void
-na_sm_buf_copy_from(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index,
-    void *dest, size_t n)
-{
-    hg_thread_spin_lock(&na_sm_copy_buf->buf_locks[index]);
-    memcpy(dest, na_sm_copy_buf->buf[index], n);
-    hg_thread_spin_unlock(&na_sm_copy_buf->buf_locks[index]);
-}
-
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
 na_sm_op_retry(na_class_t *na_class, struct na_sm_op_id *na_sm_op_id)
@@ -2834,6 +3948,7 @@ na_sm_op_retry(na_class_t *na_class, struct na_sm_op_id *na_sm_op_id)
         &NA_SM_CLASS(na_class)->endpoint.retry_op_queue;
 
     NA_LOG_DEBUG("Pushing %p for retry", na_sm_op_id);
+    HG_PROBE1(na, sm_retry, na_sm_op_id);
 
     /* Push op ID to retry queue */
     hg_thread_spin_lock(&retry_op_queue->lock);
@@ -2911,36 +4026,428 @@ na_sm_iov_translate(const struct iovec *iov, unsigned long iovcnt,
     }
 }
 
+#ifdef NA_SM_HAS_CMA
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_size_t
+na_sm_iov_get_span(const struct iovec *iov, unsigned long iovcnt,
+    unsigned long iov_start_index, na_offset_t iov_start_offset,
+    unsigned long iovcnt_max)
+{
+    na_size_t span = iov[iov_start_index].iov_len - iov_start_offset;
+    unsigned long i;
+
+    for (i = iov_start_index + 1;
+         i < iovcnt && i - iov_start_index < iovcnt_max; i++)
+        span += iov[i].iov_len;
+
+    return span;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_poll_wait(na_context_t *context, struct na_sm_endpoint *na_sm_endpoint,
-    const char *username, unsigned int timeout, na_bool_t *progressed_ptr)
+na_sm_cma_rw(pid_t pid, const struct iovec *liov, unsigned long liovcnt,
+    const struct iovec *riov, unsigned long riovcnt, na_size_t len,
+    na_bool_t put)
 {
-    struct hg_poll_event *events = NA_SM_CONTEXT(context)->events;
-    unsigned int nevents = 0, i;
-    na_bool_t progressed = NA_FALSE;
+    const char *func_name = put ? "process_vm_writev" : "process_vm_readv";
+    ssize_t nbytes;
     na_return_t ret = NA_SUCCESS;
-    int rc;
 
-    /* Just wait on a single event, anything greater may increase
-     * latency, and slow down progress, we will not wait next round
-     * if something is still in the queues */
-    rc = hg_poll_wait(
-        na_sm_endpoint->poll_set, timeout, NA_SM_MAX_EVENTS, events, &nevents);
-    NA_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, na_sm_errno_to_na(errno),
-        "hg_poll_wait() failed");
+    if (put)
+        nbytes = process_vm_writev(pid, liov, liovcnt, riov, riovcnt, 0);
+    else
+        nbytes = process_vm_readv(pid, liov, liovcnt, riov, riovcnt, 0);
+    if (unlikely(nbytes < 0)) {
+        int errno_save = errno;
 
-    if (nevents == 1 && (events[0].events & HG_POLLINTR)) {
-        NA_LOG_DEBUG("Interrupted");
-        *progressed_ptr = NA_FALSE;
-        return ret;
+        if ((errno_save == EPERM) && na_sm_get_ptrace_scope_value()) {
+            NA_GOTO_SUBSYS_ERROR(fatal, done, ret,
+                na_sm_errno_to_na(errno_save), "%s() failed (%s):\n"
+                "Kernel Yama configuration does not allow cross-memory attach, "
+                "either run as root: \n"
+                "# /usr/sbin/sysctl kernel.yama.ptrace_scope=0\n"
+                "or if set to restricted, add the following call to your "
+                "application:\n"
+                "prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);\n"
+                "See https://www.kernel.org/doc/Documentation/security/Yama.txt"
+                " for more details.",
+                func_name, strerror(errno_save));
+        } else
+            NA_GOTO_ERROR(done, ret, na_sm_errno_to_na(errno_save),
+                "%s() failed (%s)", func_name, strerror(errno_save));
     }
+    NA_CHECK_ERROR((na_size_t) nbytes != len, done, ret, NA_MSGSIZE,
+        "%s %ld bytes, was expecting %lu bytes", put ? "Wrote" : "Read",
+        nbytes, len);
 
-    /* Process events */
-    for (i = 0; i < nevents; i++) {
-        struct na_sm_addr *poll_addr = NULL;
-        na_bool_t progressed_notify = NA_FALSE;
-        na_bool_t progressed_rx = NA_FALSE;
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_cma_copy_range(
+    struct na_sm_cma_xfer *xfer, na_size_t offset, na_size_t len)
+{
+    /* Segments are translated in windows so that no iovec is allocated,
+     * transfers with more segments are issued as several copies */
+    unsigned long liov_max = MIN(
+                      MIN(xfer->liovcnt, xfer->iov_max), NA_SM_CMA_IOV_WINDOW),
+                  riov_max = MIN(
+                      MIN(xfer->riovcnt, xfer->iov_max), NA_SM_CMA_IOV_WINDOW);
+    struct iovec liov[NA_SM_CMA_IOV_WINDOW], riov[NA_SM_CMA_IOV_WINDOW];
+    na_return_t ret = NA_SUCCESS;
+
+    while (len > 0) {
+        unsigned long liov_start_index, riov_start_index, liovcnt, riovcnt;
+        na_offset_t liov_start_offset, riov_start_offset;
+        na_size_t n;
+
+        na_sm_iov_get_index_offset(xfer->liov, xfer->liovcnt, offset,
+            &liov_start_index, &liov_start_offset);
+        na_sm_iov_get_index_offset(xfer->riov, xfer->riovcnt, offset,
+            &riov_start_index, &riov_start_offset);
+
+        /* Copy as much as fits within liov_max/riov_max IOVs */
+        n = MIN(len, na_sm_iov_get_span(xfer->liov, xfer->liovcnt,
+                         liov_start_index, liov_start_offset, liov_max));
+        n = MIN(n, na_sm_iov_get_span(xfer->riov, xfer->riovcnt,
+                       riov_start_index, riov_start_offset, riov_max));
+
+        liovcnt = na_sm_iov_get_count(xfer->liov, xfer->liovcnt,
+            liov_start_index, liov_start_offset, n);
+        na_sm_iov_translate(xfer->liov, xfer->liovcnt, liov_start_index,
+            liov_start_offset, n, liov, liovcnt);
+        riovcnt = na_sm_iov_get_count(xfer->riov, xfer->riovcnt,
+            riov_start_index, riov_start_offset, n);
+        na_sm_iov_translate(xfer->riov, xfer->riovcnt, riov_start_index,
+            riov_start_offset, n, riov, riovcnt);
+
+        ret = na_sm_cma_rw(
+            xfer->pid, liov, liovcnt, riov, riovcnt, n, xfer->put);
+        NA_CHECK_NA_ERROR(done, ret, "Could not copy %zu bytes at offset %zu",
+            n, offset);
+
+        offset += n;
+        len -= n;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+na_sm_cma_copy_chunk(void *arg)
+{
+    struct na_sm_cma_chunk *na_sm_cma_chunk = (struct na_sm_cma_chunk *) arg;
+    struct na_sm_cma_xfer *xfer = na_sm_cma_chunk->xfer;
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    na_return_t ret;
+
+    ret = na_sm_cma_copy_range(
+        xfer, na_sm_cma_chunk->offset, na_sm_cma_chunk->len);
+
+    hg_thread_mutex_lock(&xfer->mutex);
+    if (ret != NA_SUCCESS && xfer->ret == NA_SUCCESS)
+        xfer->ret = ret;
+    if (--xfer->pending == 0)
+        hg_thread_cond_signal(&xfer->cond);
+    hg_thread_mutex_unlock(&xfer->mutex);
+
+    return thread_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_cma_copy(struct na_sm_class *na_sm_class, pid_t pid,
+    const struct iovec *liov, unsigned long liovcnt, const struct iovec *riov,
+    unsigned long riovcnt, na_size_t length, na_bool_t put)
+{
+    struct na_sm_cma_xfer xfer = {.liov = liov,
+        .riov = riov,
+        .liovcnt = liovcnt,
+        .riovcnt = riovcnt,
+        .iov_max = (unsigned long) na_sm_class->iov_max,
+        .pending = 0,
+        .ret = NA_SUCCESS,
+        .pid = pid,
+        .put = put};
+    struct na_sm_cma_chunk chunks[NA_SM_CMA_THREADS + 1];
+    na_size_t chunk_len;
+    unsigned int i, chunk_count;
+    na_return_t ret = NA_SUCCESS;
+
+    if (length < NA_SM_CMA_PARALLEL_THRESHOLD) {
+        /* Common case, single call */
+        if (liovcnt <= xfer.iov_max && riovcnt <= xfer.iov_max)
+            ret = na_sm_cma_rw(pid, liov, liovcnt, riov, riovcnt, length, put);
+        else
+            ret = na_sm_cma_copy_range(&xfer, 0, length);
+        goto done;
+    }
+
+    /* Helpers are only created once a large transfer is seen */
+    hg_thread_mutex_lock(&na_sm_class->cma_pool_mutex);
+    if (na_sm_class->cma_pool == NULL &&
+        hg_thread_pool_init(NA_SM_CMA_THREADS, &na_sm_class->cma_pool) !=
+            HG_UTIL_SUCCESS) {
+        NA_LOG_WARNING("Could not create CMA thread pool");
+        na_sm_class->cma_pool = NULL;
+    }
+    hg_thread_mutex_unlock(&na_sm_class->cma_pool_mutex);
+    if (na_sm_class->cma_pool == NULL) {
+        ret = na_sm_cma_copy_range(&xfer, 0, length);
+        goto done;
+    }
+
+    /* Split into page-aligned chunks, first chunk is copied by caller */
+    chunk_count = (unsigned int) MIN(
+        length / NA_SM_CMA_CHUNK_MIN, NA_SM_CMA_THREADS + 1);
+    chunk_len = (length / chunk_count + NA_SM_PAGE_SIZE - 1) &
+                ~((na_size_t) NA_SM_PAGE_SIZE - 1);
+    chunk_count = (unsigned int) ((length + chunk_len - 1) / chunk_len);
+
+    hg_thread_mutex_init(&xfer.mutex);
+    hg_thread_cond_init(&xfer.cond);
+    xfer.pending = chunk_count - 1;
+
+    for (i = 1; i < chunk_count; i++) {
+        chunks[i].thread_work.func = na_sm_cma_copy_chunk;
+        chunks[i].thread_work.args = &chunks[i];
+        chunks[i].xfer = &xfer;
+        chunks[i].offset = i * chunk_len;
+        chunks[i].len = MIN(chunk_len, length - chunks[i].offset);
+        if (hg_thread_pool_post(
+                na_sm_class->cma_pool, &chunks[i].thread_work) !=
+            HG_UTIL_SUCCESS)
+            na_sm_cma_copy_chunk(&chunks[i]);
+    }
+
+    ret = na_sm_cma_copy_range(&xfer, 0, chunk_len);
+
+    /* Wait for helpers, chunks live on our stack */
+    hg_thread_mutex_lock(&xfer.mutex);
+    while (xfer.pending > 0)
+        hg_thread_cond_wait(&xfer.cond, &xfer.mutex);
+    hg_thread_mutex_unlock(&xfer.mutex);
+
+    hg_thread_cond_destroy(&xfer.cond);
+    hg_thread_mutex_destroy(&xfer.mutex);
+
+    if (ret == NA_SUCCESS)
+        ret = xfer.ret;
+
+done:
+    return ret;
+}
+#endif
+
+#ifdef NA_SM_HAS_XPMEM
+/*---------------------------------------------------------------------------*/
+static NA_INLINE struct na_sm_xpmem_attach *
+na_sm_xpmem_cache_lookup(
+    struct na_sm_xpmem_cache *xpmem_cache, const char *ptr, size_t len)
+{
+    struct na_sm_xpmem_attach *attach;
+
+    HG_LIST_FOREACH (attach, &xpmem_cache->list, entry)
+        if (ptr >= attach->remote_base &&
+            ptr + len <= attach->remote_base + attach->len)
+            break;
+
+    return attach;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_xpmem_attach_get(struct na_sm_xpmem_cache *xpmem_cache,
+    xpmem_segid_t segid, void *ptr, size_t len,
+    struct na_sm_xpmem_attach **attach_ptr)
+{
+    uintptr_t page_mask = (uintptr_t) NA_SM_PAGE_SIZE - 1;
+    char *start = (char *) ((uintptr_t) ptr & ~page_mask);
+    char *end = (char *) (((uintptr_t) ptr + len + page_mask) & ~page_mask);
+    struct na_sm_xpmem_attach *attach, *evicted = NULL;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Fast path, range is already attached */
+    hg_thread_rwlock_rdlock(&xpmem_cache->lock);
+    attach = na_sm_xpmem_cache_lookup(xpmem_cache, (const char *) ptr, len);
+    if (attach)
+        hg_atomic_incr32_relaxed(&attach->ref_count);
+    hg_thread_rwlock_release_rdlock(&xpmem_cache->lock);
+    if (attach) {
+        *attach_ptr = attach;
+        return ret;
+    }
+
+    hg_thread_rwlock_wrlock(&xpmem_cache->lock);
+
+    /* Range may have been attached in the meantime */
+    attach = na_sm_xpmem_cache_lookup(xpmem_cache, (const char *) ptr, len);
+    if (!attach) {
+        struct xpmem_addr xpmem_addr;
+        void *local_base;
+
+        /* Get access to peer segment on first use */
+        if (xpmem_cache->apid == -1) {
+            xpmem_cache->apid =
+                xpmem_get(segid, XPMEM_RDWR, XPMEM_PERMIT_MODE, NULL);
+            NA_CHECK_ERROR(xpmem_cache->apid == -1, unlock, ret,
+                na_sm_errno_to_na(errno), "xpmem_get() failed (%s)",
+                strerror(errno));
+        }
+
+        xpmem_addr.apid = xpmem_cache->apid;
+        xpmem_addr.offset = (off_t) (uintptr_t) start;
+        local_base = xpmem_attach(xpmem_addr, (size_t) (end - start), NULL);
+        NA_CHECK_ERROR(local_base == (void *) -1, unlock, ret,
+            na_sm_errno_to_na(errno), "xpmem_attach() failed (%s)",
+            strerror(errno));
+
+        attach = (struct na_sm_xpmem_attach *) malloc(
+            sizeof(struct na_sm_xpmem_attach));
+        if (attach == NULL) {
+            xpmem_detach(local_base);
+            NA_GOTO_ERROR(
+                unlock, ret, NA_NOMEM, "Could not allocate XPMEM attachment");
+        }
+        attach->remote_base = start;
+        attach->local_base = (char *) local_base;
+        attach->len = (size_t) (end - start);
+        hg_atomic_init32(&attach->ref_count, 1); /* Cache reference */
+        HG_LIST_INSERT_HEAD(&xpmem_cache->list, attach, entry);
+
+        /* Evict oldest attachment, it is detached once no longer in use */
+        if (++xpmem_cache->count > NA_SM_XPMEM_CACHE_MAX) {
+            HG_LIST_FOREACH (evicted, &xpmem_cache->list, entry)
+                if (HG_LIST_NEXT(evicted, entry) == NULL)
+                    break;
+            HG_LIST_REMOVE(evicted, entry);
+            xpmem_cache->count--;
+        }
+    }
+    hg_atomic_incr32_relaxed(&attach->ref_count);
+    *attach_ptr = attach;
+
+unlock:
+    hg_thread_rwlock_release_wrlock(&xpmem_cache->lock);
+
+    if (evicted)
+        na_sm_xpmem_attach_release(evicted);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_xpmem_attach_release(struct na_sm_xpmem_attach *attach)
+{
+    if (hg_atomic_decr32(&attach->ref_count) == 0) {
+        xpmem_detach(attach->local_base);
+        free(attach);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_xpmem_cache_destroy(struct na_sm_xpmem_cache *xpmem_cache)
+{
+    while (!HG_LIST_IS_EMPTY(&xpmem_cache->list)) {
+        struct na_sm_xpmem_attach *attach = HG_LIST_FIRST(&xpmem_cache->list);
+
+        HG_LIST_REMOVE(attach, entry);
+        na_sm_xpmem_attach_release(attach);
+    }
+    xpmem_cache->count = 0;
+
+    if (xpmem_cache->apid != -1)
+        xpmem_release(xpmem_cache->apid);
+
+    hg_thread_rwlock_destroy(&xpmem_cache->lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_xpmem_copy(struct na_sm_xpmem_cache *xpmem_cache, xpmem_segid_t segid,
+    const struct iovec *liov, unsigned long liovcnt, const struct iovec *riov,
+    unsigned long riovcnt, na_bool_t put)
+{
+    unsigned long i, j = 0;
+    size_t loff = 0;
+    na_return_t ret = NA_SUCCESS;
+
+    for (i = 0; i < riovcnt; i++) {
+        struct na_sm_xpmem_attach *attach = NULL;
+        size_t rlen = riov[i].iov_len;
+        char *rptr;
+
+        if (rlen == 0)
+            continue;
+
+        ret = na_sm_xpmem_attach_get(
+            xpmem_cache, segid, riov[i].iov_base, rlen, &attach);
+        NA_CHECK_NA_ERROR(done, ret, "Could not attach remote segment");
+
+        /* Copy from/to local segments until remote segment is filled */
+        rptr = attach->local_base +
+               ((char *) riov[i].iov_base - attach->remote_base);
+        while (rlen > 0 && j < liovcnt) {
+            char *lptr = (char *) liov[j].iov_base + loff;
+            size_t n = MIN(liov[j].iov_len - loff, rlen);
+
+            if (put)
+                memcpy(rptr, lptr, n);
+            else
+                memcpy(lptr, rptr, n);
+            rptr += n;
+            rlen -= n;
+            loff += n;
+            if (loff == liov[j].iov_len) {
+                j++;
+                loff = 0;
+            }
+        }
+
+        na_sm_xpmem_attach_release(attach);
+    }
+
+done:
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_poll_wait(na_context_t *context, struct na_sm_endpoint *na_sm_endpoint,
+    const char *username, unsigned int timeout, na_bool_t *progressed_ptr)
+{
+    struct hg_poll_event *events = NA_SM_CONTEXT(context)->events;
+    unsigned int nevents = 0, i;
+    na_bool_t progressed = NA_FALSE;
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    /* Just wait on a single event, anything greater may increase
+     * latency, and slow down progress, we will not wait next round
+     * if something is still in the queues */
+    rc = hg_poll_wait(
+        na_sm_endpoint->poll_set, timeout, NA_SM_MAX_EVENTS, events, &nevents);
+    NA_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, na_sm_errno_to_na(errno),
+        "hg_poll_wait() failed");
+
+    if (nevents == 1 && (events[0].events & HG_POLLINTR)) {
+        NA_LOG_DEBUG("Interrupted");
+        *progressed_ptr = NA_FALSE;
+        return ret;
+    }
+
+    /* Process events */
+    for (i = 0; i < nevents; i++) {
+        struct na_sm_addr *poll_addr = NULL;
+        na_bool_t progressed_notify = NA_FALSE;
+        na_bool_t progressed_rx = NA_FALSE;
 
         switch (*(na_sm_poll_type_t *) events[i].data.ptr) {
             case NA_SM_POLL_SOCK:
@@ -2953,6 +4460,11 @@ na_sm_poll_wait(na_context_t *context, struct na_sm_endpoint *na_sm_endpoint,
                 NA_LOG_DEBUG("NA_SM_POLL_TX_NOTIFY event");
                 poll_addr = container_of(
                     events[i].data.ptr, struct na_sm_addr, tx_poll_type);
+                if (events[i].events & HG_POLLEVENT) {
+                    /* Notification was already consumed */
+                    progressed_notify = NA_TRUE;
+                    break;
+                }
                 ret = na_sm_progress_tx_notify(poll_addr, &progressed_notify);
                 NA_CHECK_NA_ERROR(done, ret, "Could not progress tx notify");
                 break;
@@ -2961,13 +4473,25 @@ na_sm_poll_wait(na_context_t *context, struct na_sm_endpoint *na_sm_endpoint,
                 poll_addr = container_of(
                     events[i].data.ptr, struct na_sm_addr, rx_poll_type);
 
-                ret = na_sm_progress_rx_notify(poll_addr, &progressed_notify);
-                NA_CHECK_NA_ERROR(done, ret, "Could not progress rx notify");
+                if (events[i].events & HG_POLLEVENT)
+                    /* Notification was already consumed */
+                    progressed_notify = NA_TRUE;
+                else {
+                    ret = na_sm_progress_rx_notify(
+                        poll_addr, &progressed_notify);
+                    NA_CHECK_NA_ERROR(
+                        done, ret, "Could not progress rx notify");
+                }
 
                 ret = na_sm_progress_rx_queue(
                     na_sm_endpoint, poll_addr, &progressed_rx);
                 NA_CHECK_NA_ERROR(done, ret, "Could not progress rx queue");
 
+                /* Peer also notifies when staging slots change */
+                ret = na_sm_progress_stage(
+                    na_sm_endpoint, username, poll_addr, &progressed_rx);
+                NA_CHECK_NA_ERROR(done, ret, "Could not progress staged RMA");
+
                 break;
             default:
                 NA_GOTO_ERROR(done, ret, NA_INVALID_ARG,
@@ -2983,17 +4507,98 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_poll_set_polling(
+    struct na_sm_endpoint *na_sm_endpoint, na_bool_t polling)
+{
+    struct na_sm_addr_list *poll_addr_list = &na_sm_endpoint->poll_addr_list;
+    struct na_sm_addr *poll_addr;
+
+    hg_thread_spin_lock(&poll_addr_list->lock);
+    HG_LIST_FOREACH (poll_addr, &poll_addr_list->list, entry)
+        hg_atomic_set32(&poll_addr->rx_queue->cons_polling, (int) polling);
+    hg_thread_spin_unlock(&poll_addr_list->lock);
+
+    /* Pairs with na_sm_addr_notify(), msgs that were pushed without
+     * notification must be seen when checking rx queues again */
+    if (!polling)
+        hg_atomic_fence();
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_poll_notify_on_wait(na_context_t *context,
+    struct na_sm_endpoint *na_sm_endpoint, const char *username,
+    unsigned int timeout, na_bool_t *progressed_ptr)
+{
+    na_bool_t progressed = NA_FALSE;
+    na_return_t ret;
+
+    /* Peers do not notify us while we are polling */
+    na_sm_poll_set_polling(na_sm_endpoint, NA_TRUE);
+
+    ret = na_sm_poll_rx_queues(na_sm_endpoint, username, &progressed);
+    NA_CHECK_NA_ERROR(done, ret, "Could not poll rx queues");
+    if (progressed)
+        goto done;
+
+    /* About to wait, check again once peers know they must notify us */
+    na_sm_poll_set_polling(na_sm_endpoint, NA_FALSE);
+
+    ret = na_sm_poll_rx_queues(na_sm_endpoint, username, &progressed);
+    NA_CHECK_NA_ERROR(done, ret, "Could not poll rx queues");
+    if (progressed)
+        goto done;
+
+    ret = na_sm_poll_wait(
+        context, na_sm_endpoint, username, timeout, &progressed);
+    NA_CHECK_NA_ERROR(done, ret, "Could not wait on poll set");
+
+done:
+    *progressed_ptr = progressed;
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_poll(struct na_sm_endpoint *na_sm_endpoint, const char *username,
     na_bool_t *progressed_ptr)
+{
+    na_bool_t progressed = NA_FALSE;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Check whether something is in one of the rx queues */
+    ret = na_sm_poll_rx_queues(na_sm_endpoint, username, &progressed);
+    NA_CHECK_NA_ERROR(done, ret, "Could not poll rx queues");
+
+    /* Look for message in cmd queue (if listening) */
+    if (na_sm_endpoint->source_addr->shared_region) {
+        na_bool_t progressed_cmd = NA_FALSE;
+
+        ret =
+            na_sm_progress_cmd_queue(na_sm_endpoint, username, &progressed_cmd);
+        NA_CHECK_NA_ERROR(done, ret, "Could not progress cmd queue");
+        progressed |= progressed_cmd;
+    }
+
+    *progressed_ptr = progressed;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_poll_rx_queues(struct na_sm_endpoint *na_sm_endpoint,
+    const char *username, na_bool_t *progressed_ptr)
 {
     struct na_sm_addr_list *poll_addr_list = &na_sm_endpoint->poll_addr_list;
     struct na_sm_addr *poll_addr;
     na_bool_t progressed = NA_FALSE;
     na_return_t ret = NA_SUCCESS;
 
-    /* Check whether something is in one of the rx queues */
     hg_thread_spin_lock(&poll_addr_list->lock);
     HG_LIST_FOREACH (poll_addr, &poll_addr_list->list, entry) {
         na_bool_t progressed_rx = NA_FALSE;
@@ -3005,20 +4610,14 @@ na_sm_poll(struct na_sm_endpoint *na_sm_endpoint, const char *username,
         NA_CHECK_NA_ERROR(done, ret, "Could not progress rx queue");
         progressed |= progressed_rx;
 
+        ret = na_sm_progress_stage(
+            na_sm_endpoint, username, poll_addr, &progressed);
+        NA_CHECK_NA_ERROR(done, ret, "Could not progress staged RMA");
+
         hg_thread_spin_lock(&poll_addr_list->lock);
     }
     hg_thread_spin_unlock(&poll_addr_list->lock);
 
-    /* Look for message in cmd queue (if listening) */
-    if (na_sm_endpoint->source_addr->shared_region) {
-        na_bool_t progressed_cmd = NA_FALSE;
-
-        ret =
-            na_sm_progress_cmd_queue(na_sm_endpoint, username, &progressed_cmd);
-        NA_CHECK_NA_ERROR(done, ret, "Could not progress cmd queue");
-        progressed |= progressed_cmd;
-    }
-
     *progressed_ptr = progressed;
 
 done:
@@ -3087,7 +4686,7 @@ na_sm_process_cmd(struct na_sm_endpoint *na_sm_endpoint, const char *username,
 
     NA_LOG_DEBUG("Processing cmd with %d from %d/%" SCNu8 "/%" SCNu8 " val=%lu",
         cmd_hdr.hdr.type, cmd_hdr.hdr.pid, cmd_hdr.hdr.id & 0xff,
-        cmd_hdr.hdr.pair_idx & 0xff, cmd_hdr.val);
+        cmd_hdr.hdr.pair_idx, cmd_hdr.val);
 
     switch (cmd_hdr.hdr.type) {
         case NA_SM_RESERVED: {
@@ -3101,17 +4700,22 @@ na_sm_process_cmd(struct na_sm_endpoint *na_sm_endpoint, const char *username,
 
             na_sm_addr->shared_region =
                 na_sm_endpoint->source_addr->shared_region;
-            na_sm_addr->queue_pair_idx = cmd_hdr.hdr.pair_idx;
+            na_sm_addr->queue_pair_idx = (na_uint16_t) cmd_hdr.hdr.pair_idx;
+
+            ret = na_sm_queue_pair_open(username,
+                na_sm_endpoint->source_addr->pid,
+                na_sm_endpoint->source_addr->id, na_sm_addr->shared_region,
+                na_sm_addr->queue_pair_idx, &na_sm_addr->pair);
+            NA_CHECK_NA_ERROR(done, ret, "Could not open queue pair");
 
             /* Invert queues so that local rx is remote tx */
-            na_sm_addr->tx_queue =
-                &na_sm_addr->shared_region
-                     ->queue_pairs[na_sm_addr->queue_pair_idx]
-                     .rx_queue;
-            na_sm_addr->rx_queue =
-                &na_sm_addr->shared_region
-                     ->queue_pairs[na_sm_addr->queue_pair_idx]
-                     .tx_queue;
+            na_sm_addr->tx_queue = &na_sm_addr->pair->rx_queue;
+            na_sm_addr->rx_queue = &na_sm_addr->pair->tx_queue;
+
+            /* Previous peer may have left staging rings */
+            ret = na_sm_stage_attach(
+                na_sm_endpoint, username, na_sm_addr, NA_FALSE);
+            NA_CHECK_NA_ERROR(done, ret, "Could not attach staging rings");
 
             /* Invert descriptors so that local rx is remote tx */
             na_sm_addr->tx_notify = rx_notify;
@@ -3123,11 +4727,15 @@ na_sm_process_cmd(struct na_sm_endpoint *na_sm_endpoint, const char *username,
                     na_sm_addr->rx_notify);
                 /* Add remote rx notify to poll set */
                 ret = na_sm_poll_register(na_sm_endpoint->poll_set,
-                    na_sm_addr->rx_notify, &na_sm_addr->rx_poll_type);
+                    na_sm_addr->rx_notify, NA_SM_POLL_NOTIFY,
+                    &na_sm_addr->rx_poll_type);
                 NA_CHECK_NA_ERROR(
                     done, ret, "Could not add rx notify to poll set");
             }
 
+            /* Map msg pool of peer */
+            na_sm_msg_pool_attach(username, na_sm_addr);
+
             /* Unexpected addresses are always resolved */
             hg_atomic_or32(&na_sm_addr->status, NA_SM_ADDR_RESOLVED);
 
@@ -3140,7 +4748,7 @@ na_sm_process_cmd(struct na_sm_endpoint *na_sm_endpoint, const char *username,
         }
         case NA_SM_RELEASED: {
             struct na_sm_addr *na_sm_addr = NULL;
-            na_bool_t found = NA_FALSE;
+            na_bool_t found = NA_FALSE, progressed = NA_FALSE;
 
             /* Find address from list of addresses to poll */
             hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
@@ -3163,6 +4771,10 @@ na_sm_process_cmd(struct na_sm_endpoint *na_sm_endpoint, const char *username,
                 break;
             }
 
+            /* Peer no longer reads records that we have sent to it */
+            ret = na_sm_cma_abort(na_sm_endpoint, na_sm_addr, 0, &progressed);
+            NA_CHECK_NA_ERROR(done, ret, "Could not abort CMA msgs");
+
             if (hg_atomic_decr32(&na_sm_addr->ref_count))
                 /* Cannot free yet */
                 break;
@@ -3233,92 +4845,247 @@ na_sm_progress_rx_queue(struct na_sm_endpoint *na_sm_endpoint,
     struct na_sm_addr *poll_addr, na_bool_t *progressed)
 {
     na_sm_msg_hdr_t msg_hdr = {.val = 0};
+    hg_util_uint32_t msg_pos;
     na_return_t ret = NA_SUCCESS;
 
     /* Look for message in rx queue */
-    if (!na_sm_msg_queue_pop(poll_addr->rx_queue, &msg_hdr)) {
+    if (!na_sm_msg_queue_pop(poll_addr->rx_queue, &msg_hdr, &msg_pos)) {
         *progressed = NA_FALSE;
         goto done;
     }
 
     NA_LOG_DEBUG("Found msg in queue");
+    HG_PROBE4(na, sm_rx, poll_addr, (unsigned int) msg_hdr.hdr.type,
+        (unsigned int) msg_hdr.hdr.tag, (unsigned int) msg_hdr.hdr.buf_size);
 
     /* Process expected and unexpected messages */
     switch (msg_hdr.hdr.type) {
         case NA_CB_SEND_UNEXPECTED:
             ret = na_sm_process_unexpected(&na_sm_endpoint->unexpected_op_queue,
-                poll_addr, msg_hdr, &na_sm_endpoint->unexpected_msg_queue);
+                poll_addr, msg_hdr, msg_pos,
+                &na_sm_endpoint->unexpected_msg_queue);
             NA_CHECK_NA_ERROR(
-                done, ret, "Could not make progress on unexpected msg");
+                release, ret, "Could not make progress on unexpected msg");
             break;
         case NA_CB_SEND_EXPECTED:
-            ret = na_sm_process_expected(
-                &na_sm_endpoint->expected_op_queue, poll_addr, msg_hdr);
+            ret = na_sm_process_expected(&na_sm_endpoint->expected_op_queue,
+                poll_addr, msg_hdr, msg_pos);
             NA_CHECK_NA_ERROR(
-                done, ret, "Could not make progress on expected msg");
+                release, ret, "Could not make progress on expected msg");
             break;
         default:
             NA_GOTO_ERROR(
-                done, ret, NA_INVALID_ARG, "Unknown type of operation");
+                release, ret, NA_INVALID_ARG, "Unknown type of operation");
     }
 
     *progressed = NA_TRUE;
 
+release:
+    /* Payload has been copied out, give space back to the sender */
+    na_sm_msg_queue_release(poll_addr->rx_queue, msg_pos, msg_hdr);
+
+    /* Sender is waiting for the release to complete CMA and pool msgs */
+    if (msg_hdr.hdr.cma || msg_hdr.hdr.pool) {
+        na_return_t err_ret = na_sm_addr_notify(poll_addr);
+        NA_CHECK_ERROR_DONE(err_ret != NA_SUCCESS,
+            "Could not send release notification");
+    }
+
 done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static na_return_t
-na_sm_process_unexpected(struct na_sm_op_queue *unexpected_op_queue,
-    struct na_sm_addr *poll_addr, na_sm_msg_hdr_t msg_hdr,
-    struct na_sm_unexpected_msg_queue *unexpected_msg_queue)
+static NA_INLINE na_size_t
+na_sm_msg_get_size(struct na_sm_msg_queue *na_sm_queue,
+    na_sm_msg_hdr_t msg_hdr, hg_util_uint32_t msg_pos)
 {
-    struct na_sm_unexpected_info *na_sm_unexpected_info = NULL;
-    struct na_sm_op_id *na_sm_op_id = NULL;
-    na_return_t ret = NA_SUCCESS;
+    struct iovec iov;
 
-    NA_LOG_DEBUG("Processing unexpected msg");
+    if (msg_hdr.hdr.pool) {
+        struct na_sm_msg_pool_desc desc;
 
-    /* Pop op ID from queue */
-    hg_thread_spin_lock(&unexpected_op_queue->lock);
-    na_sm_op_id = HG_QUEUE_FIRST(&unexpected_op_queue->queue);
-    if (likely(na_sm_op_id)) {
-        HG_QUEUE_POP_HEAD(&unexpected_op_queue->queue, entry);
-        hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_QUEUED);
-    }
-    hg_thread_spin_unlock(&unexpected_op_queue->lock);
+        /* Payload is the location of msg in sender pool */
+        na_sm_msg_queue_copy_from(na_sm_queue, msg_pos, &desc, sizeof(desc));
 
-    if (likely(na_sm_op_id)) {
-        /* Fill info */
-        na_sm_op_id->na_sm_addr = poll_addr;
-        hg_atomic_incr32(&na_sm_op_id->na_sm_addr->ref_count);
-        na_sm_op_id->info.msg.actual_buf_size =
-            (na_size_t) msg_hdr.hdr.buf_size;
-        na_sm_op_id->info.msg.tag = (na_tag_t) msg_hdr.hdr.tag;
+        return (na_size_t) desc.size;
+    }
 
-        /* Copy buffer */
-        na_sm_buf_copy_from(&poll_addr->shared_region->copy_bufs,
-            msg_hdr.hdr.buf_idx, na_sm_op_id->info.msg.buf.ptr,
-            msg_hdr.hdr.buf_size);
+    if (!msg_hdr.hdr.cma)
+        return (na_size_t) msg_hdr.hdr.buf_size;
 
-        /* Release buffer */
-        na_sm_buf_release(
-            &poll_addr->shared_region->copy_bufs, msg_hdr.hdr.buf_idx);
+    /* Payload is the sender iovec */
+    na_sm_msg_queue_copy_from(na_sm_queue, msg_pos, &iov, sizeof(iov));
 
-        /* Complete operation (no need to notify) */
-        ret = na_sm_complete(na_sm_op_id, 0);
-        NA_CHECK_NA_ERROR(done, ret, "Could not complete operation");
-    } else {
-        /* If no error and message arrived, keep a copy of the struct in
-         * the unexpected message queue (should rarely happen) */
-        na_sm_unexpected_info = (struct na_sm_unexpected_info *) malloc(
-            sizeof(struct na_sm_unexpected_info));
-        NA_CHECK_ERROR(na_sm_unexpected_info == NULL, done, ret, NA_NOMEM,
-            "Could not allocate unexpected info");
+    return (na_size_t) iov.iov_len;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_msg_copy_from(struct na_sm_addr *poll_addr, na_sm_msg_hdr_t msg_hdr,
+    hg_util_uint32_t msg_pos, void *dest, na_size_t n)
+{
+#if defined(NA_SM_HAS_CMA)
+    struct iovec liov, riov;
+    ssize_t nread;
+#endif
+    na_return_t ret = NA_SUCCESS;
+
+    if (msg_hdr.hdr.pool) {
+        struct na_sm_msg_pool_desc desc;
+
+        /* Copy payload directly from the sender pool */
+        na_sm_msg_queue_copy_from(
+            poll_addr->rx_queue, msg_pos, &desc, sizeof(desc));
+        NA_CHECK_ERROR(poll_addr->msg_pool == NULL ||
+                           desc.offset + n > NA_SM_MSG_POOL_SIZE,
+            done, ret, NA_PROTOCOL_ERROR, "Invalid pool msg (offset %u)",
+            desc.offset);
+        memcpy(dest, poll_addr->msg_pool + desc.offset, n);
+        goto done;
+    }
+
+    if (!msg_hdr.hdr.cma) {
+        na_sm_msg_queue_copy_from(poll_addr->rx_queue, msg_pos, dest, n);
+        goto done;
+    }
+
+#if defined(NA_SM_HAS_CMA)
+    /* Pull payload directly from the sender buffer */
+    na_sm_msg_queue_copy_from(
+        poll_addr->rx_queue, msg_pos, &riov, sizeof(riov));
+    riov.iov_len = n;
+    liov.iov_base = dest;
+    liov.iov_len = n;
+
+    nread = process_vm_readv(poll_addr->pid, &liov, 1, &riov, 1, 0);
+    NA_CHECK_ERROR(nread < 0, done, ret, na_sm_errno_to_na(errno),
+        "process_vm_readv() failed (%s)", strerror(errno));
+    NA_CHECK_ERROR((na_size_t) nread != n, done, ret, NA_MSGSIZE,
+        "Read %ld bytes, was expecting %lu bytes", nread, n);
+#else
+    NA_GOTO_ERROR(
+        done, ret, NA_OPNOTSUPPORTED, "CMA msgs are not supported");
+#endif
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_msg_post(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_op_id *na_sm_op_id, hg_util_uint32_t msg_pos)
+{
+    struct na_sm_msg_queue *tx_queue = na_sm_op_id->na_sm_addr->tx_queue;
+    na_sm_msg_hdr_t msg_hdr;
+
+    msg_hdr.hdr.type = na_sm_op_id->completion_data.callback_info.type;
+    msg_hdr.hdr.tag = na_sm_op_id->info.msg.tag;
+
+    if (na_sm_op_id->info.msg.cma) {
+        struct iovec iov = {.iov_base = (void *) na_sm_op_id->info.msg.buf.ptr,
+            .iov_len = na_sm_op_id->info.msg.buf_size};
+
+        msg_hdr.hdr.buf_size = sizeof(iov) & 0x7fffff;
+        msg_hdr.hdr.cma = 1;
+        msg_hdr.hdr.pool = 0;
+
+        /* Buffer must remain valid until the receiver has released the
+         * record, queue op before it becomes visible to the receiver */
+        na_sm_op_id->info.msg.cma_end =
+            msg_pos + NA_SM_MSG_RECORD_SIZE(sizeof(iov));
+        hg_thread_spin_lock(&na_sm_endpoint->cma_op_queue.lock);
+        HG_QUEUE_PUSH_TAIL(
+            &na_sm_endpoint->cma_op_queue.queue, na_sm_op_id, entry);
+        hg_thread_spin_unlock(&na_sm_endpoint->cma_op_queue.lock);
+
+        na_sm_msg_queue_push(tx_queue, msg_pos, msg_hdr, &iov);
+    } else if (na_sm_op_id->info.msg.pool) {
+        struct na_sm_msg_pool_desc desc = {
+            .offset = (na_uint32_t) ((const char *)
+                                          na_sm_op_id->info.msg.buf.const_ptr -
+                                      na_sm_endpoint->msg_pool.base),
+            .size = (na_uint32_t) na_sm_op_id->info.msg.buf_size};
+
+        msg_hdr.hdr.buf_size = sizeof(desc) & 0x7fffff;
+        msg_hdr.hdr.cma = 0;
+        msg_hdr.hdr.pool = 1;
+
+        /* Pool buffer must remain valid until the receiver has released the
+         * record, same as CMA msgs */
+        na_sm_op_id->info.msg.cma_end =
+            msg_pos + NA_SM_MSG_RECORD_SIZE(sizeof(desc));
+        hg_thread_spin_lock(&na_sm_endpoint->cma_op_queue.lock);
+        HG_QUEUE_PUSH_TAIL(
+            &na_sm_endpoint->cma_op_queue.queue, na_sm_op_id, entry);
+        hg_thread_spin_unlock(&na_sm_endpoint->cma_op_queue.lock);
+
+        na_sm_msg_queue_push(tx_queue, msg_pos, msg_hdr, &desc);
+    } else {
+        msg_hdr.hdr.buf_size = na_sm_op_id->info.msg.buf_size & 0x7fffff;
+        msg_hdr.hdr.cma = 0;
+        msg_hdr.hdr.pool = 0;
+
+        na_sm_msg_queue_push(
+            tx_queue, msg_pos, msg_hdr, na_sm_op_id->info.msg.buf.const_ptr);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_process_unexpected(struct na_sm_op_queue *unexpected_op_queue,
+    struct na_sm_addr *poll_addr, na_sm_msg_hdr_t msg_hdr,
+    hg_util_uint32_t msg_pos,
+    struct na_sm_unexpected_msg_queue *unexpected_msg_queue)
+{
+    struct na_sm_unexpected_info *na_sm_unexpected_info = NULL;
+    struct na_sm_op_id *na_sm_op_id = NULL;
+    na_size_t msg_size =
+        na_sm_msg_get_size(poll_addr->rx_queue, msg_hdr, msg_pos);
+    na_return_t ret = NA_SUCCESS;
+
+    NA_LOG_DEBUG("Processing unexpected msg");
+
+    /* Pop op ID from queue */
+    hg_thread_spin_lock(&unexpected_op_queue->lock);
+    na_sm_op_id = HG_QUEUE_FIRST(&unexpected_op_queue->queue);
+    if (likely(na_sm_op_id)) {
+        HG_QUEUE_POP_HEAD(&unexpected_op_queue->queue, entry);
+        hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_QUEUED);
+    }
+    hg_thread_spin_unlock(&unexpected_op_queue->lock);
+
+    if (likely(na_sm_op_id)) {
+        /* Fill info */
+        na_sm_op_id->na_sm_addr = poll_addr;
+        hg_atomic_incr32_relaxed(&na_sm_op_id->na_sm_addr->ref_count);
+        na_sm_op_id->info.msg.actual_buf_size =
+            MIN(msg_size, na_sm_op_id->info.msg.buf_size);
+        na_sm_op_id->info.msg.tag = (na_tag_t) msg_hdr.hdr.tag;
+        NA_CHECK_WARNING(msg_size > na_sm_op_id->info.msg.buf_size,
+            "Unexpected msg truncated (%zu > %zu)", msg_size,
+            na_sm_op_id->info.msg.buf_size);
+
+        /* Copy buffer */
+        ret = na_sm_msg_copy_from(poll_addr, msg_hdr, msg_pos,
+            na_sm_op_id->info.msg.buf.ptr,
+            na_sm_op_id->info.msg.actual_buf_size);
+        NA_CHECK_NA_ERROR(done, ret, "Could not copy unexpected msg");
+
+        /* Complete operation (no need to notify) */
+        ret = na_sm_complete(na_sm_op_id, 0);
+        NA_CHECK_NA_ERROR(done, ret, "Could not complete operation");
+    } else {
+        /* If no error and message arrived, keep a copy of the struct in
+         * the unexpected message queue (should rarely happen) */
+        na_sm_unexpected_info = (struct na_sm_unexpected_info *) malloc(
+            sizeof(struct na_sm_unexpected_info));
+        NA_CHECK_ERROR(na_sm_unexpected_info == NULL, done, ret, NA_NOMEM,
+            "Could not allocate unexpected info");
 
         na_sm_unexpected_info->na_sm_addr = poll_addr;
-        na_sm_unexpected_info->buf_size = (na_size_t) msg_hdr.hdr.buf_size;
+        na_sm_unexpected_info->buf_size = msg_size;
         na_sm_unexpected_info->tag = (na_tag_t) msg_hdr.hdr.tag;
 
         /* Allocate buf */
@@ -3327,13 +5094,9 @@ na_sm_process_unexpected(struct na_sm_op_queue *unexpected_op_queue,
             "Could not allocate na_sm_unexpected_info buf");
 
         /* Copy buffer */
-        na_sm_buf_copy_from(&poll_addr->shared_region->copy_bufs,
-            msg_hdr.hdr.buf_idx, na_sm_unexpected_info->buf,
-            msg_hdr.hdr.buf_size);
-
-        /* Release buffer */
-        na_sm_buf_release(
-            &poll_addr->shared_region->copy_bufs, msg_hdr.hdr.buf_idx);
+        ret = na_sm_msg_copy_from(poll_addr, msg_hdr, msg_pos,
+            na_sm_unexpected_info->buf, na_sm_unexpected_info->buf_size);
+        NA_CHECK_NA_ERROR(error, ret, "Could not copy unexpected msg");
 
         /* Otherwise push the unexpected message into our unexpected queue so
          * that we can treat it later when a recv_unexpected is posted */
@@ -3354,9 +5117,11 @@ error:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_process_expected(struct na_sm_op_queue *expected_op_queue,
-    struct na_sm_addr *poll_addr, na_sm_msg_hdr_t msg_hdr)
+    struct na_sm_addr *poll_addr, na_sm_msg_hdr_t msg_hdr,
+    hg_util_uint32_t msg_pos)
 {
     struct na_sm_op_id *na_sm_op_id = NULL;
+    na_size_t msg_size;
     na_return_t ret = NA_SUCCESS;
 
     NA_LOG_DEBUG("Processing expected msg");
@@ -3378,16 +5143,17 @@ na_sm_process_expected(struct na_sm_op_queue *expected_op_queue,
         na_sm_op_id == NULL, done, ret, NA_INVALID_ARG, "Invalid operation ID");
     /* Cannot have an already completed operation ID, TODO add sanity check */
 
-    na_sm_op_id->info.msg.actual_buf_size = msg_hdr.hdr.buf_size;
+    msg_size = na_sm_msg_get_size(poll_addr->rx_queue, msg_hdr, msg_pos);
+    na_sm_op_id->info.msg.actual_buf_size =
+        MIN(msg_size, na_sm_op_id->info.msg.buf_size);
+    NA_CHECK_WARNING(msg_size > na_sm_op_id->info.msg.buf_size,
+        "Expected msg truncated (%zu > %zu)", msg_size,
+        na_sm_op_id->info.msg.buf_size);
 
     /* Copy buffer */
-    na_sm_buf_copy_from(&poll_addr->shared_region->copy_bufs,
-        msg_hdr.hdr.buf_idx, na_sm_op_id->info.msg.buf.ptr,
-        msg_hdr.hdr.buf_size);
-
-    /* Release buffer */
-    na_sm_buf_release(
-        &poll_addr->shared_region->copy_bufs, msg_hdr.hdr.buf_idx);
+    ret = na_sm_msg_copy_from(poll_addr, msg_hdr, msg_pos,
+        na_sm_op_id->info.msg.buf.ptr, na_sm_op_id->info.msg.actual_buf_size);
+    NA_CHECK_NA_ERROR(done, ret, "Could not copy expected msg");
 
     /* Complete operation */
     ret = na_sm_complete(na_sm_op_id, 0);
@@ -3404,12 +5170,20 @@ na_sm_process_retries(
 {
     struct na_sm_op_queue *retry_op_queue = &na_sm_endpoint->retry_op_queue;
     struct na_sm_op_id *na_sm_op_id = NULL;
-    unsigned int buf_idx;
     na_return_t ret = NA_SUCCESS;
 
+    /* Nothing to retry or still backing off */
+    hg_thread_spin_lock(&retry_op_queue->lock);
+    if (HG_QUEUE_IS_EMPTY(&retry_op_queue->queue) ||
+        (na_sm_endpoint->retry_ticks != 0 &&
+            hg_time_get_ticks() < na_sm_endpoint->retry_ticks)) {
+        hg_thread_spin_unlock(&retry_op_queue->lock);
+        return NA_SUCCESS;
+    }
+    hg_thread_spin_unlock(&retry_op_queue->lock);
+
     do {
-        na_sm_msg_hdr_t msg_hdr;
-        na_bool_t rc;
+        hg_util_uint32_t msg_pos;
 
         hg_thread_spin_lock(&retry_op_queue->lock);
         na_sm_op_id = HG_QUEUE_FIRST(&retry_op_queue->queue);
@@ -3419,74 +5193,828 @@ na_sm_process_retries(
             break;
 
         NA_LOG_DEBUG("Attempting to retry %p", na_sm_op_id);
+        na_cb_retry_notify(na_sm_op_id->context,
+            na_sm_op_id->completion_data.callback_info.type);
 
         /* Attempt to resolve address first */
         if (!(hg_atomic_get32(&na_sm_op_id->na_sm_addr->status) &
                 NA_SM_ADDR_RESOLVED)) {
             ret = na_sm_addr_resolve(
                 na_sm_endpoint, username, na_sm_op_id->na_sm_addr);
-            if (unlikely(ret == NA_AGAIN))
+            if (unlikely(ret == NA_AGAIN)) {
+                hg_thread_spin_lock(&retry_op_queue->lock);
+                na_sm_retry_backoff(na_sm_endpoint);
+                hg_thread_spin_unlock(&retry_op_queue->lock);
                 return NA_SUCCESS;
+            }
         }
 
-        /* Try to reserve buffer atomically */
-        ret = na_sm_buf_reserve(
-            &na_sm_op_id->na_sm_addr->shared_region->copy_bufs, &buf_idx);
-        if (unlikely(ret == NA_AGAIN))
-            return NA_SUCCESS;
-
-        /* Successfully reserved a buffer, check that the operation has not
-         * been canceled in the meantime so that we can dequeue the op from
-         * the queue properly. */
+        /* Check that the operation has not been canceled in the meantime
+         * and reserve space in the queue while holding the lock so that a
+         * reserved record is always pushed. */
         hg_thread_spin_lock(&retry_op_queue->lock);
 
         if ((hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_CANCELED)) {
             hg_thread_spin_unlock(&retry_op_queue->lock);
-            na_sm_buf_release(
-                &na_sm_op_id->na_sm_addr->shared_region->copy_bufs, buf_idx);
             continue;
         }
 
+        /* Try to reserve space atomically */
+        if (!na_sm_msg_queue_reserve(na_sm_op_id->na_sm_addr->tx_queue,
+                NA_SM_MSG_PAYLOAD_SIZE(&na_sm_op_id->info.msg), &msg_pos)) {
+            na_sm_retry_backoff(na_sm_endpoint);
+            hg_thread_spin_unlock(&retry_op_queue->lock);
+            return NA_SUCCESS;
+        }
+
+        /* Backoff only grows while attempts keep failing */
+        na_sm_endpoint->retry_ticks = 0;
+        na_sm_endpoint->retry_backoff = 0;
+
         HG_QUEUE_REMOVE(
             &retry_op_queue->queue, na_sm_op_id, na_sm_op_id, entry);
         hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_QUEUED);
 
         hg_thread_spin_unlock(&retry_op_queue->lock);
 
-        /* Copy buffer */
-        na_sm_buf_copy_to(&na_sm_op_id->na_sm_addr->shared_region->copy_bufs,
-            buf_idx, na_sm_op_id->info.msg.buf.const_ptr,
-            na_sm_op_id->info.msg.buf_size);
-
         /* Post message to queue */
-        msg_hdr.hdr.type = na_sm_op_id->completion_data.callback_info.type;
-        msg_hdr.hdr.buf_idx = buf_idx & 0xff;
-        msg_hdr.hdr.buf_size = na_sm_op_id->info.msg.buf_size & 0xffff;
-        msg_hdr.hdr.tag = na_sm_op_id->info.msg.tag;
-
-        rc = na_sm_msg_queue_push(na_sm_op_id->na_sm_addr->tx_queue, msg_hdr);
-        NA_CHECK_ERROR(rc == NA_FALSE, error, ret, NA_AGAIN, "Full queue");
+        na_sm_msg_post(na_sm_endpoint, na_sm_op_id, msg_pos);
 
         /* Notify remote if notifications are enabled */
-        if (na_sm_op_id->na_sm_addr->tx_notify > 0) {
-            ret = na_sm_event_set(na_sm_op_id->na_sm_addr->tx_notify);
-            NA_CHECK_NA_ERROR(
-                error, ret, "Could not send completion notification");
-        }
+        ret = na_sm_addr_notify(na_sm_op_id->na_sm_addr);
+        NA_CHECK_NA_ERROR(error, ret, "Could not send completion notification");
+
+        /* CMA and pool msgs complete once the receiver has copied the
+         * payload */
+        if (NA_SM_MSG_DEFERRED(&na_sm_op_id->info.msg))
+            continue;
 
         /* Immediate completion, add directly to completion queue. */
         ret = na_sm_complete(na_sm_op_id, 0);
         NA_CHECK_NA_ERROR(error, ret, "Could not complete operation");
     } while (1);
 
-    return ret;
+    return ret;
+
+error:
+    hg_atomic_decr32(&na_sm_op_id->na_sm_addr->ref_count);
+    hg_atomic_set32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_retry_backoff(struct na_sm_endpoint *na_sm_endpoint)
+{
+    if (na_sm_endpoint->retry_backoff < NA_SM_RETRY_BACKOFF_MIN)
+        na_sm_endpoint->retry_backoff = NA_SM_RETRY_BACKOFF_MIN;
+    else if (na_sm_endpoint->retry_backoff < NA_SM_RETRY_BACKOFF_MAX)
+        na_sm_endpoint->retry_backoff *= 2;
+
+    na_sm_endpoint->retry_ticks =
+        hg_time_get_ticks() +
+        hg_time_ticks_from_ns(na_sm_endpoint->retry_backoff);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_retry_wake(struct na_sm_endpoint *na_sm_endpoint)
+{
+    struct na_sm_op_queue *retry_op_queue = &na_sm_endpoint->retry_op_queue;
+
+    /* Backoff is kept so that it keeps growing if nothing was freed */
+    hg_thread_spin_lock(&retry_op_queue->lock);
+    na_sm_endpoint->retry_ticks = 0;
+    hg_thread_spin_unlock(&retry_op_queue->lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_process_cma(struct na_sm_endpoint *na_sm_endpoint, na_bool_t *progressed)
+{
+    struct na_sm_op_queue *cma_op_queue = &na_sm_endpoint->cma_op_queue;
+    na_return_t ret = NA_SUCCESS;
+
+    do {
+        struct na_sm_op_id *na_sm_op_id = NULL, *op_id;
+
+        /* Look for an op whose record has been released by the receiver */
+        hg_thread_spin_lock(&cma_op_queue->lock);
+        HG_QUEUE_FOREACH (op_id, &cma_op_queue->queue, entry) {
+            hg_util_uint32_t cons_tail = (hg_util_uint32_t) hg_atomic_get32(
+                &op_id->na_sm_addr->tx_queue->cons_tail);
+
+            if ((hg_util_int32_t) (cons_tail - op_id->info.msg.cma_end) >= 0) {
+                HG_QUEUE_REMOVE(
+                    &cma_op_queue->queue, op_id, na_sm_op_id, entry);
+                na_sm_op_id = op_id;
+                break;
+            }
+        }
+        hg_thread_spin_unlock(&cma_op_queue->lock);
+
+        if (!na_sm_op_id)
+            break;
+
+        NA_LOG_DEBUG("Msg %p was released", na_sm_op_id);
+
+        ret = na_sm_complete(na_sm_op_id, 0);
+        NA_CHECK_NA_ERROR(done, ret, "Could not complete operation");
+
+        *progressed = NA_TRUE;
+    } while (1);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_bool_t
+na_sm_addr_alive(struct na_sm_addr *na_sm_addr)
+{
+#ifdef _WIN32
+    (void) na_sm_addr;
+    return NA_TRUE;
+#else
+    return !(kill(na_sm_addr->pid, 0) == -1 && errno == ESRCH);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_cma_abort(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *na_sm_addr, int notify, na_bool_t *progressed)
+{
+    struct na_sm_op_queue *cma_op_queue = &na_sm_endpoint->cma_op_queue;
+    na_return_t ret = NA_SUCCESS;
+
+    do {
+        struct na_sm_op_id *na_sm_op_id = NULL, *op_id;
+
+        /* Records sent to a released address or to a peer that has exited
+         * are never released, buffers can be reused once we know it */
+        hg_thread_spin_lock(&cma_op_queue->lock);
+        HG_QUEUE_FOREACH (op_id, &cma_op_queue->queue, entry) {
+            if ((na_sm_addr && op_id->na_sm_addr == na_sm_addr) ||
+                (!na_sm_addr &&
+                    (hg_atomic_get32(&op_id->status) & NA_SM_OP_CANCELED) &&
+                    !na_sm_addr_alive(op_id->na_sm_addr))) {
+                HG_QUEUE_REMOVE(
+                    &cma_op_queue->queue, op_id, na_sm_op_id, entry);
+                na_sm_op_id = op_id;
+                break;
+            }
+        }
+        hg_thread_spin_unlock(&cma_op_queue->lock);
+
+        if (!na_sm_op_id)
+            break;
+
+        NA_LOG_DEBUG("Msg %p was not released", na_sm_op_id);
+
+        hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_CANCELED);
+        ret = na_sm_complete(na_sm_op_id, notify);
+        NA_CHECK_NA_ERROR(done, ret, "Could not complete operation");
+
+        *progressed = NA_TRUE;
+    } while (1);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_bool_t
+na_sm_stage_use(struct na_sm_class *na_sm_class, struct na_sm_addr *na_sm_addr,
+    struct na_sm_mem_handle NA_UNUSED *na_sm_mem_handle_remote)
+{
+#ifdef NA_SM_HAS_XPMEM
+    /* Attaching peer memory does not require ptrace permission */
+    if (na_sm_class->xpmem_segid != -1 &&
+        na_sm_mem_handle_remote->info.segid != -1)
+        return NA_FALSE;
+#endif
+
+    /* Own memory can always be accessed directly */
+    return hg_atomic_get32(&na_sm_class->rma_stage) &&
+           na_sm_addr->pid != na_sm_class->endpoint.source_addr->pid;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_bool_t
+na_sm_stage_fallback(struct na_sm_class *na_sm_class,
+    struct na_sm_addr *na_sm_addr,
+    struct na_sm_mem_handle *na_sm_mem_handle_remote)
+{
+    /* Only the first denial retries, staged RMA is never retried */
+    if (!hg_atomic_cas32(&na_sm_class->rma_stage, 0, 1))
+        return NA_FALSE;
+
+    NA_LOG_WARNING(
+        "CMA is not permitted, staging RMA through shared memory from now on");
+
+    return na_sm_stage_use(na_sm_class, na_sm_addr, na_sm_mem_handle_remote);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_stage_attach(struct na_sm_endpoint *na_sm_endpoint, const char *username,
+    struct na_sm_addr *na_sm_addr, na_bool_t create)
+{
+    char shm_name[NA_SM_MAX_FILENAME] = {'\0'};
+    struct na_sm_region *region = na_sm_addr->shared_region;
+    na_uint16_t index = na_sm_addr->queue_pair_idx;
+    hg_atomic_int64_t *staged = &region->staged[index / 64];
+    hg_util_int64_t bit = (hg_util_int64_t) (1ULL << index % 64);
+    /* Pairs are named after the owner of the region */
+    struct na_sm_addr *owner_addr =
+        na_sm_addr->unexpected ? na_sm_endpoint->source_addr : na_sm_addr;
+    struct na_sm_stage_pair *na_sm_stage_pair = NULL;
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    if (hg_atomic_get64(staged) & bit)
+        create = NA_FALSE;
+    else if (!create)
+        goto done; /* Nothing was ever staged on that pair */
+
+    rc = NA_SM_GEN_STAGE_NAME(shm_name, NA_SM_MAX_FILENAME, username,
+        (int) owner_addr->pid, owner_addr->id, index);
+    NA_CHECK_ERROR(rc < 0 || rc > NA_SM_MAX_FILENAME, done, ret, NA_OVERFLOW,
+        "NA_SM_GEN_STAGE_NAME() failed, rc: %d", rc);
+
+    /* Both peers may create them at once, mapping is not exclusive */
+    NA_LOG_DEBUG("shm_map() %s", shm_name);
+    na_sm_stage_pair = (struct na_sm_stage_pair *) na_sm_shm_map(
+        shm_name, NA_SM_STAGE_PAIR_SIZE, create);
+    NA_CHECK_ERROR(na_sm_stage_pair == NULL, done, ret, NA_NODEV,
+        "Could not map staging rings (%s)", shm_name);
+
+    if (create) {
+        /* Keep track of staging rings so that they can be cleaned up */
+        ret = na_sm_shm_register(username, shm_name, NA_TRUE);
+        if (ret != NA_SUCCESS) {
+            (void) na_sm_shm_unmap(
+                NULL, na_sm_stage_pair, NA_SM_STAGE_PAIR_SIZE);
+            NA_GOTO_ERROR(done, ret, ret,
+                "Could not register staging rings (%s)", shm_name);
+        }
+
+        /* Place staging rings with the region, failing is not fatal */
+        if (region->numa_node >= 0) {
+            rc = hg_mem_numa_bind(na_sm_stage_pair, NA_SM_STAGE_PAIR_SIZE,
+                (int) region->numa_node);
+            NA_CHECK_WARNING(rc != HG_UTIL_SUCCESS,
+                "Could not place staging rings on NUMA node %d",
+                (int) region->numa_node);
+        }
+
+        hg_atomic_or64(staged, bit);
+    }
+
+    /* Invert rings of unexpected addresses so that local rx is remote tx */
+    na_sm_addr->stage = na_sm_stage_pair;
+    if (na_sm_addr->unexpected) {
+        na_sm_addr->tx_stage = &na_sm_stage_pair->rx_stage;
+        na_sm_addr->rx_stage = &na_sm_stage_pair->tx_stage;
+    } else {
+        na_sm_addr->tx_stage = &na_sm_stage_pair->tx_stage;
+        na_sm_addr->rx_stage = &na_sm_stage_pair->rx_stage;
+    }
+
+    /* Drop staged requests left by a previous user of the pair */
+    hg_atomic_set32(&na_sm_addr->tx_stage->done_seq,
+        hg_atomic_get32(&na_sm_addr->tx_stage->req_seq));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_stage_detach(struct na_sm_addr *na_sm_addr)
+{
+    na_return_t ret;
+
+    ret = na_sm_shm_unmap(NULL, na_sm_addr->stage, NA_SM_STAGE_PAIR_SIZE);
+    na_sm_addr->stage = NULL;
+    na_sm_addr->tx_stage = NULL;
+    na_sm_addr->rx_stage = NULL;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_stage_rma(na_class_t *na_class, struct na_sm_op_id *na_sm_op_id,
+    struct na_sm_mem_handle *na_sm_mem_handle_local, na_offset_t local_offset,
+    struct na_sm_mem_handle *na_sm_mem_handle_remote, na_offset_t remote_offset,
+    na_size_t length, na_bool_t put)
+{
+    struct na_sm_endpoint *na_sm_endpoint = &NA_SM_CLASS(na_class)->endpoint;
+    struct na_sm_op_queue *stage_op_queue = &na_sm_endpoint->stage_op_queue;
+    struct na_sm_addr *na_sm_addr = na_sm_op_id->na_sm_addr;
+    struct na_sm_rma_info *rma = &na_sm_op_id->info.rma;
+    na_bool_t progressed = NA_FALSE;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Staging rings belong to the queue pair */
+    if (!(hg_atomic_get32(&na_sm_addr->status) & NA_SM_ADDR_RESOLVED) &&
+        !na_sm_addr->pair) {
+        ret = na_sm_addr_resolve(
+            na_sm_endpoint, NA_SM_CLASS(na_class)->username, na_sm_addr);
+        NA_CHECK_NA_ERROR(done, ret, "Could not resolve address");
+    }
+
+    /* First staged RMA on the pair creates its staging rings */
+    if (!na_sm_addr->tx_stage) {
+        while (!hg_atomic_cas32(&na_sm_addr->stage_busy, 0, 1))
+            cpu_spinwait();
+        if (!na_sm_addr->tx_stage)
+            ret = na_sm_stage_attach(na_sm_endpoint,
+                NA_SM_CLASS(na_class)->username, na_sm_addr, NA_TRUE);
+        hg_atomic_set32(&na_sm_addr->stage_busy, 0);
+        NA_CHECK_NA_ERROR(done, ret, "Could not attach staging rings");
+    }
+
+    rma->local_handle = na_sm_mem_handle_local;
+    rma->remote_handle = na_sm_mem_handle_remote;
+    rma->local_offset = local_offset;
+    rma->remote_offset = remote_offset;
+    rma->length = length;
+    rma->req_offset = 0;
+    rma->put = put;
+
+    /* Nothing to transfer */
+    if (length == 0)
+        return na_sm_complete(
+            na_sm_op_id, na_sm_endpoint->source_addr->tx_notify);
+
+    hg_thread_spin_lock(&stage_op_queue->lock);
+    HG_QUEUE_PUSH_TAIL(&stage_op_queue->queue, na_sm_op_id, entry);
+    hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_QUEUED);
+    hg_thread_spin_unlock(&stage_op_queue->lock);
+
+    /* Start right away if the ring is free, op remains queued otherwise */
+    ret = na_sm_process_stage(na_sm_endpoint, &progressed);
+    NA_CHECK_WARNING(ret != NA_SUCCESS, "Could not start staged RMA");
+
+    return NA_SUCCESS;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_stage_iov_copy(const struct iovec *iov, unsigned long iovcnt,
+    na_offset_t offset, char *buf, na_size_t len, na_bool_t to_iov)
+{
+    unsigned long i = 0;
+    na_offset_t iov_offset = 0;
+
+    na_sm_iov_get_index_offset(iov, iovcnt, offset, &i, &iov_offset);
+
+    for (; i < iovcnt && len > 0; i++) {
+        char *ptr = (char *) iov[i].iov_base + iov_offset;
+        na_size_t n = MIN(len, iov[i].iov_len - iov_offset);
+
+        if (to_iov)
+            memcpy(ptr, buf, n);
+        else
+            memcpy(buf, ptr, n);
+        buf += n;
+        len -= n;
+        iov_offset = 0;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_stage_req_check(struct na_sm_mem_handle_list *na_sm_mem_handle_list,
+    const struct na_sm_stage *na_sm_stage, struct na_sm_stage_req *req)
+{
+    unsigned long flags_denied;
+    na_size_t len = 0;
+    na_return_t ret = NA_SUCCESS;
+    unsigned long i;
+
+    /* Copy request first so that the peer cannot change it once checked */
+    req->put = (na_bool_t) na_sm_stage->put;
+    req->iovcnt = na_sm_stage->iovcnt;
+    req->len = (na_size_t) na_sm_stage->len;
+    NA_CHECK_ERROR(req->iovcnt == 0 || req->iovcnt > NA_SM_STAGE_IOV_MAX,
+        done, ret, NA_PROTOCOL_ERROR, "Invalid number of staged IOVs (%lu)",
+        req->iovcnt);
+    memcpy(req->iov, na_sm_stage->iov, req->iovcnt * sizeof(struct iovec));
+
+    /* Writes are denied on read-only memory and reads on write-only */
+    flags_denied = req->put ? NA_MEM_READ_ONLY : NA_MEM_WRITE_ONLY;
+
+    hg_thread_rwlock_rdlock(&na_sm_mem_handle_list->lock);
+    for (i = 0; i < req->iovcnt; i++) {
+        char *base = (char *) req->iov[i].iov_base;
+        struct na_sm_mem_handle *na_sm_mem_handle;
+        na_bool_t found = NA_FALSE;
+
+        /* Each IOV must be within a single registered segment */
+        HG_LIST_FOREACH (na_sm_mem_handle, &na_sm_mem_handle_list->list,
+            entry) {
+            const struct iovec *iov = NA_SM_IOV(na_sm_mem_handle);
+            unsigned long j;
+
+            if (na_sm_mem_handle->info.flags == flags_denied)
+                continue;
+
+            for (j = 0; j < na_sm_mem_handle->info.iovcnt; j++) {
+                char *seg = (char *) iov[j].iov_base;
+
+                if (base >= seg &&
+                    req->iov[i].iov_len <= iov[j].iov_len &&
+                    (na_size_t) (base - seg) <=
+                        iov[j].iov_len - req->iov[i].iov_len) {
+                    found = NA_TRUE;
+                    break;
+                }
+            }
+            if (found)
+                break;
+        }
+        if (!found)
+            break;
+        len += req->iov[i].iov_len;
+    }
+    hg_thread_rwlock_release_rdlock(&na_sm_mem_handle_list->lock);
+
+    NA_CHECK_ERROR(i != req->iovcnt, done, ret, NA_PERMISSION,
+        "Staged %s of unregistered memory (%p, %zu)",
+        req->put ? "write" : "read", req->iov[i].iov_base,
+        req->iov[i].iov_len);
+    NA_CHECK_ERROR(len != req->len || len == 0, done, ret, NA_PROTOCOL_ERROR,
+        "Invalid length of staged request (%zu)", req->len);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_stage_req_post(struct na_sm_addr *na_sm_addr, struct na_sm_rma_info *rma)
+{
+    struct na_sm_stage *na_sm_stage = na_sm_addr->tx_stage;
+    const struct iovec *remote_iov = NA_SM_IOV(rma->remote_handle);
+    unsigned long remote_iovcnt = rma->remote_handle->info.iovcnt;
+    unsigned long index = 0, iovcnt;
+    na_offset_t offset = 0;
+    na_size_t len = 0, remaining = rma->length - rma->req_offset;
+
+    /* Describe as many peer segments as a request can hold */
+    na_sm_iov_get_index_offset(remote_iov, remote_iovcnt,
+        rma->remote_offset + rma->req_offset, &index, &offset);
+    for (iovcnt = 0; iovcnt < NA_SM_STAGE_IOV_MAX && index < remote_iovcnt &&
+                     len < remaining;
+         iovcnt++, index++) {
+        na_size_t n = MIN(remaining - len, remote_iov[index].iov_len - offset);
+
+        na_sm_stage->iov[iovcnt].iov_base =
+            (char *) remote_iov[index].iov_base + offset;
+        na_sm_stage->iov[iovcnt].iov_len = n;
+        len += n;
+        offset = 0;
+    }
+    na_sm_stage->iovcnt = (na_uint32_t) iovcnt;
+    na_sm_stage->len = (na_uint64_t) len;
+    na_sm_stage->put = (na_uint32_t) rma->put;
+    hg_atomic_set32(&na_sm_stage->filled, 0);
+    hg_atomic_set32(&na_sm_stage->drained, 0);
+
+    rma->req_len = len;
+    rma->chunk = 0;
+    rma->req_seq = (hg_util_int32_t) (
+        (hg_util_uint32_t) hg_atomic_get32(&na_sm_stage->req_seq) + 1);
+
+    /* Publish request once it is described */
+    hg_atomic_set32(&na_sm_stage->req_seq, rma->req_seq);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_stage_serve(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *na_sm_addr, na_bool_t *progressed)
+{
+    struct na_sm_stage *na_sm_stage = na_sm_addr->rx_stage;
+    hg_util_int32_t req_seq = hg_atomic_get32(&na_sm_stage->req_seq);
+    struct na_sm_stage_req *req = na_sm_addr->stage_req;
+    hg_util_int32_t chunk_count, filled, drained;
+    na_return_t ret = NA_SUCCESS;
+
+    if (req_seq == hg_atomic_get32(&na_sm_stage->done_seq))
+        return NA_SUCCESS;
+
+    /* Check new request before touching local memory */
+    if (!req || req->seq != req_seq) {
+        if (!req) {
+            req = (struct na_sm_stage_req *) malloc(sizeof(*req));
+            NA_CHECK_ERROR(req == NULL, done, ret, NA_NOMEM,
+                "Could not allocate staged request");
+            na_sm_addr->stage_req = req;
+        }
+        req->seq = req_seq - 1;
+
+        ret = na_sm_stage_req_check(&na_sm_endpoint->mem_handles, na_sm_stage,
+            req);
+        if (ret != NA_SUCCESS) {
+            /* Report failure to peer, request is not served */
+            hg_atomic_set32(&na_sm_stage->status, (hg_util_int32_t) ret);
+            hg_atomic_set32(&na_sm_stage->done_seq, req_seq);
+            *progressed = NA_TRUE;
+            return NA_SUCCESS;
+        }
+        req->seq = req_seq;
+    }
+
+    chunk_count = NA_SM_STAGE_CHUNKS(req->len);
+    filled = hg_atomic_get32(&na_sm_stage->filled);
+    drained = hg_atomic_get32(&na_sm_stage->drained);
+
+    if (req->put) {
+        /* Write chunks filled by peer to local memory */
+        for (; drained < filled; drained++) {
+            na_size_t offset = (na_size_t) drained * NA_SM_STAGE_SLOT_SIZE;
+
+            na_sm_stage_iov_copy(req->iov, req->iovcnt, offset,
+                na_sm_stage->slots[drained % NA_SM_STAGE_SLOT_COUNT],
+                MIN(NA_SM_STAGE_SLOT_SIZE, req->len - offset), NA_TRUE);
+            hg_atomic_set32(&na_sm_stage->drained, drained + 1);
+            *progressed = NA_TRUE;
+        }
+        if (drained < chunk_count)
+            goto done;
+    } else {
+        /* Fill slots released by peer with local memory */
+        for (; filled < chunk_count &&
+               filled - drained < NA_SM_STAGE_SLOT_COUNT;
+             filled++) {
+            na_size_t offset = (na_size_t) filled * NA_SM_STAGE_SLOT_SIZE;
+
+            na_sm_stage_iov_copy(req->iov, req->iovcnt, offset,
+                na_sm_stage->slots[filled % NA_SM_STAGE_SLOT_COUNT],
+                MIN(NA_SM_STAGE_SLOT_SIZE, req->len - offset), NA_FALSE);
+            hg_atomic_set32(&na_sm_stage->filled, filled + 1);
+            *progressed = NA_TRUE;
+        }
+        if (filled < chunk_count)
+            goto done;
+    }
+
+    /* All chunks have been handed over */
+    hg_atomic_set32(&na_sm_stage->status, NA_SUCCESS);
+    hg_atomic_set32(&na_sm_stage->done_seq, req_seq);
+    *progressed = NA_TRUE;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_sm_stage_advance(struct na_sm_addr *na_sm_addr,
+    struct na_sm_rma_info *rma, na_bool_t *completed)
+{
+    struct na_sm_stage *na_sm_stage = na_sm_addr->tx_stage;
+    const struct iovec *local_iov = NA_SM_IOV(rma->local_handle);
+    unsigned long local_iovcnt = rma->local_handle->info.iovcnt;
+    hg_util_int32_t chunk_count = NA_SM_STAGE_CHUNKS(rma->req_len);
+    na_bool_t progressed = NA_FALSE;
+
+    if (rma->put) {
+        hg_util_int32_t drained = hg_atomic_get32(&na_sm_stage->drained);
+
+        /* Fill slots released by peer with local memory */
+        for (; rma->chunk < chunk_count &&
+               rma->chunk - drained < NA_SM_STAGE_SLOT_COUNT;
+             rma->chunk++) {
+            na_size_t offset = (na_size_t) rma->chunk * NA_SM_STAGE_SLOT_SIZE;
+
+            na_sm_stage_iov_copy(local_iov, local_iovcnt,
+                rma->local_offset + rma->req_offset + offset,
+                na_sm_stage->slots[rma->chunk % NA_SM_STAGE_SLOT_COUNT],
+                MIN(NA_SM_STAGE_SLOT_SIZE, rma->req_len - offset), NA_FALSE);
+            hg_atomic_set32(&na_sm_stage->filled, rma->chunk + 1);
+            progressed = NA_TRUE;
+        }
+    } else {
+        hg_util_int32_t filled = hg_atomic_get32(&na_sm_stage->filled);
+
+        /* Copy chunks filled by peer to local memory */
+        for (; rma->chunk < filled; rma->chunk++) {
+            na_size_t offset = (na_size_t) rma->chunk * NA_SM_STAGE_SLOT_SIZE;
+
+            na_sm_stage_iov_copy(local_iov, local_iovcnt,
+                rma->local_offset + rma->req_offset + offset,
+                na_sm_stage->slots[rma->chunk % NA_SM_STAGE_SLOT_COUNT],
+                MIN(NA_SM_STAGE_SLOT_SIZE, rma->req_len - offset), NA_TRUE);
+            hg_atomic_set32(&na_sm_stage->drained, rma->chunk + 1);
+            progressed = NA_TRUE;
+        }
+    }
+
+    /* Wait for peer to complete request */
+    if (hg_atomic_get32(&na_sm_stage->done_seq) != rma->req_seq)
+        return progressed;
+
+    rma->ret = (na_return_t) hg_atomic_get32(&na_sm_stage->status);
+    if (rma->ret != NA_SUCCESS) {
+        *completed = NA_TRUE;
+        return NA_TRUE;
+    }
+    if (rma->chunk < chunk_count)
+        return progressed;
+
+    /* Post next request if segments did not fit */
+    rma->req_offset += rma->req_len;
+    if (rma->req_offset < rma->length)
+        na_sm_stage_req_post(na_sm_addr, rma);
+    else
+        *completed = NA_TRUE;
+
+    return NA_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_bool_t
+na_sm_stage_ready(struct na_sm_addr *na_sm_addr)
+{
+    struct na_sm_stage *na_sm_stage = na_sm_addr->rx_stage;
+    struct na_sm_op_id *na_sm_op_id = na_sm_addr->stage_op;
+
+    if (!na_sm_stage)
+        return NA_FALSE;
+
+    /* Request of peer can be checked or served */
+    if (hg_atomic_get32(&na_sm_stage->req_seq) !=
+        hg_atomic_get32(&na_sm_stage->done_seq)) {
+        struct na_sm_stage_req *req = na_sm_addr->stage_req;
+        hg_util_int32_t filled = hg_atomic_get32(&na_sm_stage->filled),
+                        drained = hg_atomic_get32(&na_sm_stage->drained);
+
+        if (!req || req->seq != hg_atomic_get32(&na_sm_stage->req_seq))
+            return NA_TRUE;
+        if (req->put ? (drained < filled)
+                     : (filled < NA_SM_STAGE_CHUNKS(req->len) &&
+                           filled - drained < NA_SM_STAGE_SLOT_COUNT))
+            return NA_TRUE;
+    }
+
+    /* Own request can advance */
+    if (na_sm_op_id) {
+        struct na_sm_rma_info *rma = &na_sm_op_id->info.rma;
+
+        na_sm_stage = na_sm_addr->tx_stage;
+        if (hg_atomic_get32(&na_sm_stage->done_seq) == rma->req_seq)
+            return NA_TRUE;
+        if (rma->put ? (rma->chunk < NA_SM_STAGE_CHUNKS(rma->req_len) &&
+                           rma->chunk - hg_atomic_get32(&na_sm_stage->drained) <
+                               NA_SM_STAGE_SLOT_COUNT)
+                     : (rma->chunk < hg_atomic_get32(&na_sm_stage->filled)))
+            return NA_TRUE;
+    }
+
+    return NA_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_progress_stage(struct na_sm_endpoint *na_sm_endpoint,
+    const char *username, struct na_sm_addr *na_sm_addr,
+    na_bool_t *progressed)
+{
+    struct na_sm_op_id *na_sm_op_id = NULL;
+    na_bool_t stage_progressed = NA_FALSE, completed = NA_FALSE;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Peer may have created staging rings since the pair was reserved */
+    if (!na_sm_addr->rx_stage) {
+        na_uint16_t index = na_sm_addr->queue_pair_idx;
+
+        if (!na_sm_addr->pair ||
+            !(hg_atomic_get64(&na_sm_addr->shared_region->staged[index / 64]) &
+                (hg_util_int64_t) (1ULL << index % 64)))
+            return NA_SUCCESS;
+        if (!hg_atomic_cas32(&na_sm_addr->stage_busy, 0, 1))
+            return NA_SUCCESS;
+        if (!na_sm_addr->rx_stage)
+            ret = na_sm_stage_attach(
+                na_sm_endpoint, username, na_sm_addr, NA_FALSE);
+        hg_atomic_set32(&na_sm_addr->stage_busy, 0);
+        NA_CHECK_NA_ERROR(done, ret, "Could not attach staging rings");
+    }
+
+    /* Nothing staged in either direction */
+    if (!na_sm_addr->rx_stage ||
+        (!na_sm_addr->stage_op &&
+            hg_atomic_get32(&na_sm_addr->rx_stage->req_seq) ==
+                hg_atomic_get32(&na_sm_addr->rx_stage->done_seq)))
+        return NA_SUCCESS;
+
+    /* Another thread is already copying chunks of that peer */
+    if (!hg_atomic_cas32(&na_sm_addr->stage_busy, 0, 1))
+        return NA_SUCCESS;
+
+    ret = na_sm_stage_serve(na_sm_endpoint, na_sm_addr, &stage_progressed);
+
+    if (na_sm_addr->stage_op) {
+        stage_progressed |= na_sm_stage_advance(
+            na_sm_addr, &na_sm_addr->stage_op->info.rma, &completed);
+        if (completed) {
+            na_sm_op_id = na_sm_addr->stage_op;
+            na_sm_addr->stage_op = NULL;
+        }
+    }
+
+    hg_atomic_set32(&na_sm_addr->stage_busy, 0);
+    NA_CHECK_NA_ERROR(done, ret, "Could not serve staged request");
+
+    if (!stage_progressed)
+        goto done;
+    *progressed = NA_TRUE;
+
+    /* Peer may be waiting for slots */
+    ret = na_sm_addr_notify(na_sm_addr);
+    NA_CHECK_NA_ERROR(done, ret, "Could not send staging notification");
+
+    if (na_sm_op_id) {
+        /* Ring is free for next op */
+        ret = na_sm_process_stage(na_sm_endpoint, progressed);
+        NA_CHECK_NA_ERROR(done, ret, "Could not start staged RMA");
+
+        ret = na_sm_complete(na_sm_op_id, 0);
+        NA_CHECK_NA_ERROR(done, ret, "Could not complete operation");
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_process_stage(
+    struct na_sm_endpoint *na_sm_endpoint, na_bool_t *progressed)
+{
+    struct na_sm_op_queue *stage_op_queue = &na_sm_endpoint->stage_op_queue;
+    na_return_t ret = NA_SUCCESS;
+
+    do {
+        struct na_sm_op_id *na_sm_op_id = NULL, *op_id;
+        struct na_sm_addr *na_sm_addr;
+        na_bool_t completed = NA_FALSE;
+
+        /* Look for an op whose peer ring is free */
+        hg_thread_spin_lock(&stage_op_queue->lock);
+        HG_QUEUE_FOREACH (op_id, &stage_op_queue->queue, entry) {
+            na_sm_addr = op_id->na_sm_addr;
+            if (na_sm_addr->stage_op ||
+                !hg_atomic_cas32(&na_sm_addr->stage_busy, 0, 1))
+                continue;
+            if (na_sm_addr->stage_op) {
+                hg_atomic_set32(&na_sm_addr->stage_busy, 0);
+                continue;
+            }
+            HG_QUEUE_REMOVE(&stage_op_queue->queue, op_id, na_sm_op_id, entry);
+            hg_atomic_and32(&op_id->status, ~NA_SM_OP_QUEUED);
+            na_sm_addr->stage_op = op_id;
+            na_sm_op_id = op_id;
+            break;
+        }
+        hg_thread_spin_unlock(&stage_op_queue->lock);
+
+        if (!na_sm_op_id)
+            break;
+
+        NA_LOG_DEBUG("Starting staged RMA %p", na_sm_op_id);
 
-error:
-    na_sm_buf_release(
-        &na_sm_op_id->na_sm_addr->shared_region->copy_bufs, buf_idx);
-    hg_atomic_decr32(&na_sm_op_id->na_sm_addr->ref_count);
-    hg_atomic_set32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
+        na_sm_addr = na_sm_op_id->na_sm_addr;
+        na_sm_stage_req_post(na_sm_addr, &na_sm_op_id->info.rma);
+        (void) na_sm_stage_advance(
+            na_sm_addr, &na_sm_op_id->info.rma, &completed);
+        if (completed)
+            na_sm_addr->stage_op = NULL;
+        hg_atomic_set32(&na_sm_addr->stage_busy, 0);
+        *progressed = NA_TRUE;
+
+        ret = na_sm_addr_notify(na_sm_addr);
+        NA_CHECK_NA_ERROR(done, ret, "Could not send staging notification");
+
+        /* Peer may have served a small get already */
+        if (completed) {
+            ret = na_sm_complete(
+                na_sm_op_id, na_sm_endpoint->source_addr->tx_notify);
+            NA_CHECK_NA_ERROR(done, ret, "Could not complete operation");
+        }
+    } while (1);
 
+done:
     return ret;
 }
 
@@ -3522,7 +6050,7 @@ na_sm_complete(struct na_sm_op_id *na_sm_op_id, int notify)
                 callback_info->info.recv_unexpected.tag = 0;
             } else {
                 /* Increment addr ref count */
-                hg_atomic_incr32(&na_sm_op_id->na_sm_addr->ref_count);
+                hg_atomic_incr32_relaxed(&na_sm_op_id->na_sm_addr->ref_count);
 
                 /* Fill callback info */
                 callback_info->info.recv_unexpected.actual_buf_size =
@@ -3533,11 +6061,21 @@ na_sm_complete(struct na_sm_op_id *na_sm_op_id, int notify)
                     na_sm_op_id->info.msg.tag;
             }
             break;
-        case NA_CB_SEND_UNEXPECTED:
-        case NA_CB_SEND_EXPECTED:
         case NA_CB_RECV_EXPECTED:
+            callback_info->info.recv_expected.actual_buf_size =
+                (callback_info->ret == NA_SUCCESS)
+                    ? na_sm_op_id->info.msg.actual_buf_size
+                    : 0;
+            break;
         case NA_CB_PUT:
         case NA_CB_GET:
+            /* Staged RMA may have been denied by peer */
+            if (callback_info->ret == NA_SUCCESS)
+                callback_info->ret = na_sm_op_id->info.rma.ret;
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+        case NA_CB_SEND_EXPECTED:
+        case NA_CB_ATOMIC:
             break;
         default:
             NA_GOTO_ERROR(done, ret, NA_INVALID_ARG,
@@ -3600,18 +6138,45 @@ na_sm_initialize(na_class_t *na_class, const struct na_info NA_UNUSED *na_info,
     unsigned int id;
     char *username = NULL;
     struct rlimit rlimit;
-    na_bool_t no_wait = NA_FALSE;
-    na_uint8_t context_max = 1; /* Default */
+    na_bool_t no_wait = NA_FALSE, notify_on_wait = NA_FALSE;
+    na_bool_t stage_rma = NA_FALSE;
+    na_uint16_t context_max = 1; /* Default */
+    unsigned int peer_max = NA_SM_MAX_PEERS;
+    na_size_t unexpected_size_max = NA_SM_UNEXPECTED_SIZE,
+              expected_size_max = NA_SM_EXPECTED_SIZE;
     na_return_t ret = NA_SUCCESS;
     int rc;
 
     /* Get init info */
     if (na_info->na_init_info) {
+        /* Msg size hints (up to the size that fits in msg queues) */
+        if (na_info->na_init_info->max_unexpected_size)
+            unexpected_size_max = MIN(
+                na_info->na_init_info->max_unexpected_size, NA_SM_MSG_SIZE_MAX);
+        if (na_info->na_init_info->max_expected_size)
+            expected_size_max = MIN(
+                na_info->na_init_info->max_expected_size, NA_SM_MSG_SIZE_MAX);
+        /* Msgs above the CMA threshold are already single-copy so that eager
+         * msgs only cost less than a bulk round-trip up to the max msg size */
+        if (na_info->na_init_info->auto_msg_size) {
+            if (!na_info->na_init_info->max_unexpected_size)
+                unexpected_size_max = NA_SM_MSG_SIZE_MAX;
+            if (!na_info->na_init_info->max_expected_size)
+                expected_size_max = NA_SM_MSG_SIZE_MAX;
+        }
         /* Progress mode */
         if (na_info->na_init_info->progress_mode & NA_NO_BLOCK)
             no_wait = NA_TRUE;
+        else if (na_info->na_init_info->progress_mode & NA_NOTIFY_ON_WAIT)
+            notify_on_wait = NA_TRUE;
         /* Max contexts */
         context_max = na_info->na_init_info->max_contexts;
+        /* Max peers (size of shared region) */
+        if (na_info->na_init_info->max_peers)
+            peer_max = MIN(
+                na_info->na_init_info->max_peers, NA_SM_MAX_PEERS_LIMIT);
+        /* Never access peer memory directly */
+        stage_rma = na_info->na_init_info->stage_rma;
     }
 
     /* Get PID */
@@ -3645,29 +6210,72 @@ na_sm_initialize(na_class_t *na_class, const struct na_info NA_UNUSED *na_info,
     memset(na_class->plugin_class, 0, sizeof(struct na_sm_class));
 #ifdef NA_SM_HAS_CMA
     NA_SM_CLASS(na_class)->iov_max = (na_size_t) sysconf(_SC_IOV_MAX);
+    hg_thread_mutex_init(&NA_SM_CLASS(na_class)->cma_pool_mutex);
 #else
     NA_SM_CLASS(na_class)->iov_max = 1;
 #endif
+    NA_SM_CLASS(na_class)->unexpected_size_max = unexpected_size_max;
+    NA_SM_CLASS(na_class)->expected_size_max = expected_size_max;
     NA_SM_CLASS(na_class)->context_max = context_max;
+#ifdef NA_SM_HAS_CMA
+    /* Large msgs are pulled through CMA unless restricted by Yama */
+    NA_SM_CLASS(na_class)->msg_cma =
+        (na_sm_get_ptrace_scope_value() == 0) ? NA_TRUE : NA_FALSE;
+    /* RMA is then staged through queue pairs */
+    if (!NA_SM_CLASS(na_class)->msg_cma)
+        stage_rma = NA_TRUE;
+#endif
+    hg_atomic_init32(&NA_SM_CLASS(na_class)->rma_stage, (int) stage_rma);
+#ifdef NA_SM_HAS_XPMEM
+    /* Expose our address space to peers, fall back to CMA on failure */
+    NA_SM_CLASS(na_class)->xpmem_segid =
+        xpmem_make(0, XPMEM_MAXADDR_SIZE, XPMEM_PERMIT_MODE, (void *) 0600);
+    if (NA_SM_CLASS(na_class)->xpmem_segid == -1)
+        NA_LOG_WARNING(
+            "xpmem_make() failed (%s), using CMA instead", strerror(errno));
+#endif
 
     /* Copy username */
     NA_SM_CLASS(na_class)->username = strdup(username);
     NA_CHECK_ERROR(NA_SM_CLASS(na_class)->username == NULL, error, ret,
         NA_NOMEM, "Could not dup username");
 
+    NA_SM_CLASS(na_class)->op_slab =
+        na_op_slab_create(sizeof(struct na_sm_op_id));
+    NA_CHECK_ERROR(NA_SM_CLASS(na_class)->op_slab == NULL, error, ret,
+        NA_NOMEM, "Could not create op ID slab");
+
     NA_LOG_DEBUG(
         "Opening new endpoint for %s with PID=%d, ID=%u", username, pid, id);
 
     /* Open endpoint */
     ret = na_sm_endpoint_open(&NA_SM_CLASS(na_class)->endpoint, username, pid,
-        id & 0xff, listen, no_wait, (na_uint32_t) rlimit.rlim_cur);
+        id & 0xff, listen, no_wait, peer_max, (na_uint32_t) rlimit.rlim_cur,
+        na_class->numa_node);
     NA_CHECK_NA_ERROR(
         error, ret, "Could not open endpoint for PID=%d, ID=%u", pid, id);
+    NA_SM_CLASS(na_class)->endpoint.notify_on_wait = notify_on_wait;
+
+    /* Hand out msg buffers from a pool that peers can copy msgs from, msgs
+     * then go through the msg queue if the pool cannot be created */
+    ret = na_sm_msg_pool_create(username, pid, id & 0xff,
+        MAX(unexpected_size_max, expected_size_max),
+        &NA_SM_CLASS(na_class)->endpoint.msg_pool);
+    NA_CHECK_WARNING(ret != NA_SUCCESS, "Could not create msg pool");
+    ret = NA_SUCCESS;
 
     return ret;
 
 error:
     if (na_class->plugin_class) {
+#ifdef NA_SM_HAS_XPMEM
+        if (NA_SM_CLASS(na_class)->xpmem_segid != -1)
+            xpmem_remove(NA_SM_CLASS(na_class)->xpmem_segid);
+#endif
+#ifdef NA_SM_HAS_CMA
+        hg_thread_mutex_destroy(&NA_SM_CLASS(na_class)->cma_pool_mutex);
+#endif
+        na_op_slab_destroy(NA_SM_CLASS(na_class)->op_slab);
         free(NA_SM_CLASS(na_class)->username);
         free(na_class->plugin_class);
         na_class->plugin_class = NULL;
@@ -3692,6 +6300,20 @@ na_sm_finalize(na_class_t *na_class)
         &NA_SM_CLASS(na_class)->endpoint, NA_SM_CLASS(na_class)->username);
     NA_CHECK_NA_ERROR(done, ret, "Could not close endpoint");
 
+    ret = na_sm_msg_pool_destroy(NA_SM_CLASS(na_class)->username,
+        &NA_SM_CLASS(na_class)->endpoint.msg_pool);
+    NA_CHECK_NA_ERROR(done, ret, "Could not destroy msg pool");
+
+#ifdef NA_SM_HAS_CMA
+    if (NA_SM_CLASS(na_class)->cma_pool)
+        hg_thread_pool_destroy(NA_SM_CLASS(na_class)->cma_pool);
+    hg_thread_mutex_destroy(&NA_SM_CLASS(na_class)->cma_pool_mutex);
+#endif
+#ifdef NA_SM_HAS_XPMEM
+    if (NA_SM_CLASS(na_class)->xpmem_segid != -1)
+        xpmem_remove(NA_SM_CLASS(na_class)->xpmem_segid);
+#endif
+    na_op_slab_destroy(NA_SM_CLASS(na_class)->op_slab);
     free(NA_SM_CLASS(na_class)->username);
     free(na_class->plugin_class);
     na_class->plugin_class = NULL;
@@ -3703,7 +6325,7 @@ done:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_context_create(
-    na_class_t NA_UNUSED *na_class, void **context, na_uint8_t NA_UNUSED id)
+    na_class_t NA_UNUSED *na_class, void **context, na_uint16_t NA_UNUSED id)
 {
     na_return_t ret = NA_SUCCESS;
 
@@ -3737,6 +6359,9 @@ na_sm_cleanup(void)
     NA_CHECK_ERROR_NORET(rc < 0 || rc > NA_SM_MAX_FILENAME, done,
         "snprintf() failed, rc: %d", rc);
 
+    /* Remove registered SHM files before the registry itself is removed */
+    na_sm_shm_cleanup(username);
+
     /* We need to remove all files first before being able to remove the
      * directories */
     rc = nftw(pathname, na_sm_sock_path_cleanup, NA_SM_CLEANUP_NFDS,
@@ -3744,10 +6369,6 @@ na_sm_cleanup(void)
     NA_CHECK_WARNING(
         rc != 0 && errno != ENOENT, "nftw() failed (%s)", strerror(errno));
 
-    rc = nftw(NA_SM_SHM_PATH, na_sm_shm_cleanup, NA_SM_CLEANUP_NFDS, FTW_PHYS);
-    NA_CHECK_WARNING(
-        rc != 0 && errno != ENOENT, "nftw() failed (%s)", strerror(errno));
-
 done:
     return;
 }
@@ -3758,7 +6379,8 @@ na_sm_op_create(na_class_t *na_class)
 {
     struct na_sm_op_id *na_sm_op_id = NULL;
 
-    na_sm_op_id = (struct na_sm_op_id *) malloc(sizeof(struct na_sm_op_id));
+    na_sm_op_id =
+        (struct na_sm_op_id *) na_op_slab_alloc(NA_SM_CLASS(na_class)->op_slab);
     NA_CHECK_ERROR_NORET(
         na_sm_op_id == NULL, done, "Could not allocate NA SM operation ID");
     memset(na_sm_op_id, 0, sizeof(struct na_sm_op_id));
@@ -3778,7 +6400,7 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+na_sm_op_destroy(na_class_t *na_class, na_op_id_t *op_id)
 {
     struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
     na_return_t ret = NA_SUCCESS;
@@ -3787,7 +6409,7 @@ na_sm_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
         !(hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_COMPLETED), done,
         ret, NA_BUSY, "Attempting to free OP ID that was not completed");
 
-    free(na_sm_op_id);
+    na_op_slab_free(NA_SM_CLASS(na_class)->op_slab, na_sm_op_id);
 
 done:
     return ret;
@@ -3833,7 +6455,7 @@ na_sm_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr)
     }
 
     /* Increment refcount */
-    hg_atomic_incr32(&na_sm_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
 
     *addr = (na_addr_t) na_sm_addr;
 
@@ -3872,6 +6494,29 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_addr_warmup(na_class_t *na_class, na_addr_t addr)
+{
+    struct na_sm_addr *na_sm_addr = (struct na_sm_addr *) addr;
+    na_return_t ret = NA_SUCCESS;
+
+    if (hg_atomic_get32(&na_sm_addr->status) & NA_SM_ADDR_RESOLVED)
+        goto done;
+
+    /* Reserve queue pair and push cmd to peer ahead of the first msg */
+    ret = na_sm_addr_resolve(&NA_SM_CLASS(na_class)->endpoint,
+        NA_SM_CLASS(na_class)->username, na_sm_addr);
+    if (ret == NA_AGAIN)
+        /* First msg completes resolution once the peer has room */
+        ret = NA_SUCCESS;
+    else
+        NA_CHECK_NA_ERROR(done, ret, "Could not resolve address");
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_addr_self(na_class_t *na_class, na_addr_t *addr)
@@ -3880,7 +6525,7 @@ na_sm_addr_self(na_class_t *na_class, na_addr_t *addr)
     na_return_t ret = NA_SUCCESS;
 
     /* Increment refcount */
-    hg_atomic_incr32(&na_sm_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
 
     *addr = (na_addr_t) na_sm_addr;
 
@@ -3896,7 +6541,7 @@ na_sm_addr_dup(
     na_return_t ret = NA_SUCCESS;
 
     /* Increment refcount */
-    hg_atomic_incr32(&na_sm_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
 
     *new_addr = (na_addr_t) na_sm_addr;
 
@@ -4009,14 +6654,23 @@ na_sm_addr_deserialize(
     /* Generate key */
     addr_key = na_sm_addr_to_key(pid, id);
 
-    /* Lookup addr from hash table */
+    /* Lookup addr from hash table, addresses may have been serialized by
+     * another process (e.g., forwarded by a relay) and must then be
+     * inserted as if they had been looked up */
     na_sm_addr = na_sm_addr_map_lookup(
         &NA_SM_CLASS(na_class)->endpoint.addr_map, addr_key);
-    NA_CHECK_ERROR(
-        na_sm_addr == NULL, done, ret, NA_NOENTRY, "Could not find address");
+    if (!na_sm_addr) {
+        struct na_sm_lookup_args args = {.pid = pid, .id = id};
+
+        ret = na_sm_addr_map_insert(&NA_SM_CLASS(na_class)->endpoint.addr_map,
+            addr_key, na_sm_addr_lookup_insert_cb, &args, &na_sm_addr);
+        NA_CHECK_ERROR(ret != NA_SUCCESS && ret != NA_EXIST, done, ret, ret,
+            "Could not insert new address");
+        ret = NA_SUCCESS;
+    }
 
     /* Increment refcount */
-    hg_atomic_incr32(&na_sm_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
 
     *addr = (na_addr_t) na_sm_addr;
 
@@ -4026,16 +6680,16 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_size_t
-na_sm_msg_get_max_unexpected_size(const na_class_t NA_UNUSED *na_class)
+na_sm_msg_get_max_unexpected_size(const na_class_t *na_class)
 {
-    return NA_SM_UNEXPECTED_SIZE;
+    return NA_SM_CLASS(na_class)->unexpected_size_max;
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE na_size_t
-na_sm_msg_get_max_expected_size(const na_class_t NA_UNUSED *na_class)
+na_sm_msg_get_max_expected_size(const na_class_t *na_class)
 {
-    return NA_SM_EXPECTED_SIZE;
+    return NA_SM_CLASS(na_class)->expected_size_max;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -4045,23 +6699,73 @@ na_sm_msg_get_max_tag(const na_class_t NA_UNUSED *na_class)
     return NA_SM_MAX_TAG;
 }
 
+/*---------------------------------------------------------------------------*/
+static void *
+na_sm_msg_buf_alloc(na_class_t *na_class, na_size_t size, void **plugin_data)
+{
+    struct na_sm_msg_pool *na_sm_msg_pool =
+        &NA_SM_CLASS(na_class)->endpoint.msg_pool;
+    void *buf = NULL;
+
+    /* Msgs encoded in pool buffers are copied by receivers from the pool */
+    if (na_sm_msg_pool->base && size <= na_sm_msg_pool->buf_size) {
+        hg_thread_spin_lock(&na_sm_msg_pool->lock);
+        if (na_sm_msg_pool->free_count > 0)
+            buf = na_sm_msg_pool->base +
+                  (na_size_t) na_sm_msg_pool
+                          ->free_bufs[--na_sm_msg_pool->free_count] *
+                      na_sm_msg_pool->buf_size;
+        hg_thread_spin_unlock(&na_sm_msg_pool->lock);
+    }
+
+    if (buf) {
+        *plugin_data = na_sm_msg_pool;
+    } else {
+        /* Pool is exhausted or msg is too large, use private memory */
+        buf = hg_mem_aligned_alloc((size_t) hg_mem_get_page_size(), size);
+        NA_CHECK_ERROR_NORET(
+            buf == NULL, done, "Could not allocate %zu bytes", size);
+        *plugin_data = NULL;
+    }
+    memset(buf, 0, size);
+
+done:
+    return buf;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_msg_buf_free(na_class_t *na_class, void *buf, void *plugin_data)
+{
+    struct na_sm_msg_pool *na_sm_msg_pool =
+        &NA_SM_CLASS(na_class)->endpoint.msg_pool;
+
+    if (plugin_data == na_sm_msg_pool) {
+        hg_thread_spin_lock(&na_sm_msg_pool->lock);
+        na_sm_msg_pool->free_bufs[na_sm_msg_pool->free_count++] =
+            (unsigned int) ((size_t) ((char *) buf - na_sm_msg_pool->base) /
+                            na_sm_msg_pool->buf_size);
+        hg_thread_spin_unlock(&na_sm_msg_pool->lock);
+    } else
+        hg_mem_aligned_free(buf);
+
+    return NA_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t dest_addr,
-    na_uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
     struct na_sm_addr *na_sm_addr = (struct na_sm_addr *) dest_addr;
-    unsigned int buf_idx;
-    na_bool_t reserved = NA_FALSE;
-    na_sm_msg_hdr_t msg_hdr;
+    hg_util_uint32_t msg_pos;
     na_return_t ret = NA_SUCCESS;
-    na_bool_t rc;
 
-    NA_CHECK_ERROR(buf_size > NA_SM_UNEXPECTED_SIZE, done, ret, NA_OVERFLOW,
-        "Exceeds unexpected size, %d", buf_size);
+    NA_CHECK_ERROR(buf_size > NA_SM_CLASS(na_class)->unexpected_size_max, done,
+        ret, NA_OVERFLOW, "Exceeds unexpected size, %d", buf_size);
 
     /* Check op_id */
     NA_CHECK_ERROR(
@@ -4074,7 +6778,7 @@ na_sm_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_sm_op_id->completion_data.callback_info.type = NA_CB_SEND_UNEXPECTED;
     na_sm_op_id->completion_data.callback = callback;
     na_sm_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_sm_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
     na_sm_op_id->na_sm_addr = na_sm_addr;
     hg_atomic_set32(&na_sm_op_id->status, 0);
 
@@ -4084,6 +6788,12 @@ na_sm_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_sm_op_id->info.msg.buf_size = buf_size;
     na_sm_op_id->info.msg.actual_buf_size = buf_size;
     na_sm_op_id->info.msg.tag = tag;
+    na_sm_op_id->info.msg.cma =
+        NA_SM_CLASS(na_class)->msg_cma && buf_size > NA_SM_MSG_CMA_THRESHOLD;
+    na_sm_op_id->info.msg.pool =
+        !na_sm_op_id->info.msg.cma &&
+        na_sm_msg_pool_use(
+            &NA_SM_CLASS(na_class)->endpoint, na_sm_addr, buf, buf_size);
 
     /* Attempt to resolve address first if not resolved */
     if (!(hg_atomic_get32(&na_sm_addr->status) & NA_SM_ADDR_RESOLVED)) {
@@ -4096,34 +6806,23 @@ na_sm_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
             NA_CHECK_NA_ERROR(error, ret, "Could not resolve address");
     }
 
-    /* Try to reserve buffer atomically */
-    ret = na_sm_buf_reserve(&na_sm_addr->shared_region->copy_bufs, &buf_idx);
-    if (unlikely(ret == NA_AGAIN)) {
+    /* Try to reserve space atomically */
+    if (unlikely(!na_sm_msg_queue_reserve(na_sm_addr->tx_queue,
+            NA_SM_MSG_PAYLOAD_SIZE(&na_sm_op_id->info.msg), &msg_pos))) {
         na_sm_op_retry(na_class, na_sm_op_id);
         return NA_SUCCESS;
     }
 
-    /* Successfully reserved a buffer */
-    reserved = NA_TRUE;
-
-    /* Reservation succeeded, copy buffer */
-    na_sm_buf_copy_to(
-        &na_sm_addr->shared_region->copy_bufs, buf_idx, buf, buf_size);
-
-    /* Post message to queue */
-    msg_hdr.hdr.type = na_sm_op_id->completion_data.callback_info.type;
-    msg_hdr.hdr.buf_idx = buf_idx & 0xff;
-    msg_hdr.hdr.buf_size = buf_size & 0xffff;
-    msg_hdr.hdr.tag = tag;
-
-    rc = na_sm_msg_queue_push(na_sm_addr->tx_queue, msg_hdr);
-    NA_CHECK_ERROR(rc == NA_FALSE, error, ret, NA_AGAIN, "Full queue");
+    /* Reservation succeeded, copy buffer and post message to queue */
+    na_sm_msg_post(&NA_SM_CLASS(na_class)->endpoint, na_sm_op_id, msg_pos);
 
     /* Notify remote if notifications are enabled */
-    if (na_sm_addr->tx_notify > 0) {
-        ret = na_sm_event_set(na_sm_addr->tx_notify);
-        NA_CHECK_NA_ERROR(error, ret, "Could not send completion notification");
-    }
+    ret = na_sm_addr_notify(na_sm_addr);
+    NA_CHECK_NA_ERROR(error, ret, "Could not send completion notification");
+
+    /* CMA and pool msgs complete once the receiver has copied the payload */
+    if (NA_SM_MSG_DEFERRED(&na_sm_op_id->info.msg))
+        goto done;
 
     /* Immediate completion, add directly to completion queue. */
     ret = na_sm_complete(
@@ -4134,8 +6833,6 @@ done:
     return ret;
 
 error:
-    if (reserved)
-        na_sm_buf_release(&na_sm_addr->shared_region->copy_bufs, buf_idx);
     hg_atomic_decr32(&na_sm_addr->ref_count);
     hg_atomic_set32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
 
@@ -4154,8 +6851,8 @@ na_sm_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
     struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
     na_return_t ret = NA_SUCCESS;
 
-    NA_CHECK_ERROR(buf_size > NA_SM_UNEXPECTED_SIZE, done, ret, NA_OVERFLOW,
-        "Exceeds unexpected size, %d", buf_size);
+    NA_CHECK_ERROR(buf_size > NA_SM_CLASS(na_class)->unexpected_size_max, done,
+        ret, NA_OVERFLOW, "Exceeds unexpected size, %d", buf_size);
 
     /* Check op_id */
     NA_CHECK_ERROR(
@@ -4181,13 +6878,14 @@ na_sm_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
     hg_thread_spin_unlock(&unexpected_msg_queue->lock);
     if (unlikely(na_sm_unexpected_info)) {
         na_sm_op_id->na_sm_addr = na_sm_unexpected_info->na_sm_addr;
-        hg_atomic_incr32(&na_sm_op_id->na_sm_addr->ref_count);
-        na_sm_op_id->info.msg.actual_buf_size = na_sm_unexpected_info->buf_size;
+        hg_atomic_incr32_relaxed(&na_sm_op_id->na_sm_addr->ref_count);
+        na_sm_op_id->info.msg.actual_buf_size =
+            MIN(na_sm_unexpected_info->buf_size, buf_size);
         na_sm_op_id->info.msg.tag = na_sm_unexpected_info->tag;
 
         /* Copy buffers */
         memcpy(na_sm_op_id->info.msg.buf.ptr, na_sm_unexpected_info->buf,
-            na_sm_unexpected_info->buf_size);
+            na_sm_op_id->info.msg.actual_buf_size);
 
         free(na_sm_unexpected_info->buf);
         free(na_sm_unexpected_info);
@@ -4224,18 +6922,15 @@ static na_return_t
 na_sm_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t dest_addr,
-    na_uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
     struct na_sm_addr *na_sm_addr = (struct na_sm_addr *) dest_addr;
-    unsigned int buf_idx;
-    na_bool_t reserved = NA_FALSE;
-    na_sm_msg_hdr_t msg_hdr;
+    hg_util_uint32_t msg_pos;
     na_return_t ret = NA_SUCCESS;
-    na_bool_t rc;
 
-    NA_CHECK_ERROR(buf_size > NA_SM_EXPECTED_SIZE, done, ret, NA_OVERFLOW,
-        "Exceeds expected size, %d", buf_size);
+    NA_CHECK_ERROR(buf_size > NA_SM_CLASS(na_class)->expected_size_max, done,
+        ret, NA_OVERFLOW, "Exceeds expected size, %d", buf_size);
 
     /* Check op_id */
     NA_CHECK_ERROR(
@@ -4248,7 +6943,7 @@ na_sm_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_sm_op_id->completion_data.callback_info.type = NA_CB_SEND_EXPECTED;
     na_sm_op_id->completion_data.callback = callback;
     na_sm_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_sm_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
     na_sm_op_id->na_sm_addr = na_sm_addr;
     hg_atomic_set32(&na_sm_op_id->status, 0);
 
@@ -4258,6 +6953,12 @@ na_sm_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_sm_op_id->info.msg.buf_size = buf_size;
     na_sm_op_id->info.msg.actual_buf_size = buf_size;
     na_sm_op_id->info.msg.tag = tag;
+    na_sm_op_id->info.msg.cma =
+        NA_SM_CLASS(na_class)->msg_cma && buf_size > NA_SM_MSG_CMA_THRESHOLD;
+    na_sm_op_id->info.msg.pool =
+        !na_sm_op_id->info.msg.cma &&
+        na_sm_msg_pool_use(
+            &NA_SM_CLASS(na_class)->endpoint, na_sm_addr, buf, buf_size);
 
     /* Attempt to resolve address first if not resolved */
     if (!(hg_atomic_get32(&na_sm_addr->status) & NA_SM_ADDR_RESOLVED)) {
@@ -4270,34 +6971,23 @@ na_sm_msg_send_expected(na_class_t *na_class, na_context_t *context,
             NA_CHECK_NA_ERROR(error, ret, "Could not resolve address");
     }
 
-    /* Try to reserve buffer atomically */
-    ret = na_sm_buf_reserve(&na_sm_addr->shared_region->copy_bufs, &buf_idx);
-    if (unlikely(ret == NA_AGAIN)) {
+    /* Try to reserve space atomically */
+    if (unlikely(!na_sm_msg_queue_reserve(na_sm_addr->tx_queue,
+            NA_SM_MSG_PAYLOAD_SIZE(&na_sm_op_id->info.msg), &msg_pos))) {
         na_sm_op_retry(na_class, na_sm_op_id);
         return NA_SUCCESS;
     }
 
-    /* Successfully reserved a buffer */
-    reserved = NA_TRUE;
-
-    /* Reservation succeeded, copy buffer */
-    na_sm_buf_copy_to(
-        &na_sm_addr->shared_region->copy_bufs, buf_idx, buf, buf_size);
-
-    /* Post message to queue */
-    msg_hdr.hdr.type = na_sm_op_id->completion_data.callback_info.type;
-    msg_hdr.hdr.buf_idx = buf_idx & 0xff;
-    msg_hdr.hdr.buf_size = buf_size & 0xffff;
-    msg_hdr.hdr.tag = tag;
-
-    rc = na_sm_msg_queue_push(na_sm_addr->tx_queue, msg_hdr);
-    NA_CHECK_ERROR(rc == NA_FALSE, error, ret, NA_AGAIN, "Full queue");
+    /* Reservation succeeded, copy buffer and post message to queue */
+    na_sm_msg_post(&NA_SM_CLASS(na_class)->endpoint, na_sm_op_id, msg_pos);
 
     /* Notify remote if notifications are enabled */
-    if (na_sm_addr->tx_notify > 0) {
-        ret = na_sm_event_set(na_sm_addr->tx_notify);
-        NA_CHECK_NA_ERROR(error, ret, "Could not send completion notification");
-    }
+    ret = na_sm_addr_notify(na_sm_addr);
+    NA_CHECK_NA_ERROR(error, ret, "Could not send completion notification");
+
+    /* CMA and pool msgs complete once the receiver has copied the payload */
+    if (NA_SM_MSG_DEFERRED(&na_sm_op_id->info.msg))
+        goto done;
 
     /* Immediate completion, add directly to completion queue. */
     ret = na_sm_complete(
@@ -4308,8 +6998,6 @@ done:
     return ret;
 
 error:
-    if (reserved)
-        na_sm_buf_release(&na_sm_addr->shared_region->copy_bufs, buf_idx);
     hg_atomic_decr32(&na_sm_op_id->na_sm_addr->ref_count);
     hg_atomic_set32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
 
@@ -4321,7 +7009,7 @@ static na_return_t
 na_sm_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
     void NA_UNUSED *plugin_data, na_addr_t source_addr,
-    na_uint8_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
+    na_uint16_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_sm_op_queue *expected_op_queue =
         &NA_SM_CLASS(na_class)->endpoint.expected_op_queue;
@@ -4329,8 +7017,8 @@ na_sm_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     struct na_sm_addr *na_sm_addr = (struct na_sm_addr *) source_addr;
     na_return_t ret = NA_SUCCESS;
 
-    NA_CHECK_ERROR(buf_size > NA_SM_EXPECTED_SIZE, done, ret, NA_OVERFLOW,
-        "Exceeds expected size, %d", buf_size);
+    NA_CHECK_ERROR(buf_size > NA_SM_CLASS(na_class)->expected_size_max, done,
+        ret, NA_OVERFLOW, "Exceeds expected size, %d", buf_size);
 
     /* Check op_id */
     NA_CHECK_ERROR(
@@ -4343,7 +7031,7 @@ na_sm_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_sm_op_id->completion_data.callback_info.type = NA_CB_RECV_EXPECTED;
     na_sm_op_id->completion_data.callback = callback;
     na_sm_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_sm_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
     na_sm_op_id->na_sm_addr = na_sm_addr;
     hg_atomic_set32(&na_sm_op_id->status, 0);
 
@@ -4383,6 +7071,9 @@ na_sm_mem_handle_create(na_class_t NA_UNUSED *na_class, void *buf,
     na_sm_mem_handle->info.iovcnt = 1;
     na_sm_mem_handle->info.flags = flags & 0xff;
     na_sm_mem_handle->info.len = buf_size;
+#ifdef NA_SM_HAS_XPMEM
+    na_sm_mem_handle->info.segid = NA_SM_CLASS(na_class)->xpmem_segid;
+#endif
 
     *mem_handle = (na_mem_handle_t) na_sm_mem_handle;
 
@@ -4400,12 +7091,17 @@ na_sm_mem_handle_create_segments(na_class_t *na_class,
     struct na_sm_mem_handle *na_sm_mem_handle = NULL;
     struct iovec *iov = NULL;
     na_return_t ret = NA_SUCCESS;
-    na_size_t i;
+    na_size_t i, iovcnt;
 
     NA_CHECK_WARNING(segment_count == 1, "Segment count is 1");
 
+    /* Contiguous segments are merged into a single IOV */
+    for (i = 1, iovcnt = 1; i < segment_count; i++)
+        if (segments[i].base != segments[i - 1].base + segments[i - 1].len)
+            iovcnt++;
+
     /* Check that we do not exceed IOV_MAX */
-    NA_CHECK_SUBSYS_ERROR(fatal, segment_count > NA_SM_CLASS(na_class)->iov_max,
+    NA_CHECK_SUBSYS_ERROR(fatal, iovcnt > NA_SM_CLASS(na_class)->iov_max,
         error, ret, NA_INVALID_ARG, "Segment count exceeds IOV_MAX limit (%zu)",
         NA_SM_CLASS(na_class)->iov_max);
 
@@ -4415,10 +7111,10 @@ na_sm_mem_handle_create_segments(na_class_t *na_class,
     NA_CHECK_ERROR(na_sm_mem_handle == NULL, error, ret, NA_NOMEM,
         "Could not allocate NA SM memory handle");
 
-    if (segment_count > NA_SM_IOV_STATIC_MAX) {
+    if (iovcnt > NA_SM_IOV_STATIC_MAX) {
         /* Allocate IOVs */
         na_sm_mem_handle->iov.d =
-            (struct iovec *) calloc(segment_count, sizeof(struct iovec));
+            (struct iovec *) calloc(iovcnt, sizeof(struct iovec));
         NA_CHECK_ERROR(na_sm_mem_handle->iov.d == NULL, error, ret, NA_NOMEM,
             "Could not allocate iovec");
 
@@ -4426,14 +7122,23 @@ na_sm_mem_handle_create_segments(na_class_t *na_class,
     } else
         iov = na_sm_mem_handle->iov.s;
 
-    na_sm_mem_handle->info.len = 0;
-    for (i = 0; i < segment_count; i++) {
-        iov[i].iov_base = (void *) segments[i].base;
-        iov[i].iov_len = segments[i].len;
-        na_sm_mem_handle->info.len += iov[i].iov_len;
+    iov[0].iov_base = (void *) segments[0].base;
+    iov[0].iov_len = segments[0].len;
+    na_sm_mem_handle->info.len = segments[0].len;
+    for (i = 1, iovcnt = 0; i < segment_count; i++) {
+        if (segments[i].base != segments[i - 1].base + segments[i - 1].len) {
+            iovcnt++;
+            iov[iovcnt].iov_base = (void *) segments[i].base;
+            iov[iovcnt].iov_len = 0;
+        }
+        iov[iovcnt].iov_len += segments[i].len;
+        na_sm_mem_handle->info.len += segments[i].len;
     }
-    na_sm_mem_handle->info.iovcnt = segment_count;
+    na_sm_mem_handle->info.iovcnt = iovcnt + 1;
     na_sm_mem_handle->info.flags = flags & 0xff;
+#ifdef NA_SM_HAS_XPMEM
+    na_sm_mem_handle->info.segid = NA_SM_CLASS(na_class)->xpmem_segid;
+#endif
 
     *mem_handle = (na_mem_handle_t) na_sm_mem_handle;
 
@@ -4441,7 +7146,7 @@ na_sm_mem_handle_create_segments(na_class_t *na_class,
 
 error:
     if (na_sm_mem_handle) {
-        if (segment_count > NA_SM_IOV_STATIC_MAX)
+        if (iovcnt > NA_SM_IOV_STATIC_MAX)
             free(na_sm_mem_handle->iov.d);
         free(na_sm_mem_handle);
     }
@@ -4464,6 +7169,52 @@ na_sm_mem_handle_free(
     return NA_SUCCESS;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_mem_handle_create_sub(na_class_t *na_class,
+    na_mem_handle_t NA_UNUSED parent_handle, void *buf, na_size_t buf_size,
+    unsigned long flags, na_mem_handle_t *mem_handle)
+{
+    /* Sub-regions are covered by the registration of their parent */
+    return na_sm_mem_handle_create(na_class, buf, buf_size, flags, mem_handle);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_sm_mem_handle_list *na_sm_mem_handle_list =
+        &NA_SM_CLASS(na_class)->endpoint.mem_handles;
+
+    /* Keep track of memory that peers may access through staged RMA */
+    hg_thread_rwlock_wrlock(&na_sm_mem_handle_list->lock);
+    HG_LIST_INSERT_HEAD(&na_sm_mem_handle_list->list,
+        (struct na_sm_mem_handle *) mem_handle, entry);
+    hg_thread_rwlock_release_wrlock(&na_sm_mem_handle_list->lock);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_sm_mem_handle_list *na_sm_mem_handle_list =
+        &NA_SM_CLASS(na_class)->endpoint.mem_handles;
+    struct na_sm_mem_handle *na_sm_mem_handle =
+        (struct na_sm_mem_handle *) mem_handle;
+
+    /* Handles may be deregistered without having been registered */
+    hg_thread_rwlock_wrlock(&na_sm_mem_handle_list->lock);
+    if (na_sm_mem_handle->entry.prev) {
+        HG_LIST_REMOVE(na_sm_mem_handle, entry);
+        na_sm_mem_handle->entry.prev = NULL;
+    }
+    hg_thread_rwlock_release_wrlock(&na_sm_mem_handle_list->lock);
+
+    return NA_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_size_t
 na_sm_mem_handle_get_max_segments(const na_class_t *na_class)
@@ -4522,6 +7273,7 @@ na_sm_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
         (struct na_sm_mem_handle *) malloc(sizeof(struct na_sm_mem_handle));
     NA_CHECK_ERROR(na_sm_mem_handle == NULL, error, ret, NA_NOMEM,
         "Could not allocate NA SM memory handle");
+    na_sm_mem_handle->entry.prev = NULL;
     na_sm_mem_handle->iov.d = NULL;
 
     /* Descriptor info */
@@ -4561,7 +7313,7 @@ static na_return_t
 na_sm_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t NA_UNUSED remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id)
 {
     struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
@@ -4580,9 +7332,7 @@ na_sm_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     struct iovec *liov, *riov;
     unsigned long liovcnt = 0, riovcnt = 0;
     na_return_t ret = NA_SUCCESS;
-#if defined(NA_SM_HAS_CMA)
-    ssize_t nwrite;
-#elif defined(__APPLE__)
+#if defined(__APPLE__)
     kern_return_t kret;
     mach_port_name_t remote_task;
 #endif
@@ -4616,9 +7366,21 @@ na_sm_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_sm_op_id->completion_data.callback_info.type = NA_CB_PUT;
     na_sm_op_id->completion_data.callback = callback;
     na_sm_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_sm_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
     na_sm_op_id->na_sm_addr = na_sm_addr;
     hg_atomic_set32(&na_sm_op_id->status, 0);
+    HG_PROBE3(na, sm_put, na_sm_op_id, length, na_sm_addr->pid);
+    na_sm_op_id->info.rma.ret = NA_SUCCESS;
+
+    /* Peer memory cannot be accessed directly, copy through queue pair */
+    if (na_sm_stage_use(
+            NA_SM_CLASS(na_class), na_sm_addr, na_sm_mem_handle_remote)) {
+        ret = na_sm_stage_rma(na_class, na_sm_op_id, na_sm_mem_handle_local,
+            local_offset, na_sm_mem_handle_remote, remote_offset, length,
+            NA_TRUE);
+        NA_CHECK_NA_ERROR(error, ret, "Could not stage remote write");
+        goto done;
+    }
 
     /* Translate local offset */
     if (local_offset > 0)
@@ -4672,28 +7434,24 @@ na_sm_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         riovcnt = remote_iovcnt;
     }
 
-#if defined(NA_SM_HAS_CMA)
-    nwrite =
-        process_vm_writev(na_sm_addr->pid, liov, liovcnt, riov, riovcnt, 0);
-    if (unlikely(nwrite < 0)) {
-        if ((errno == EPERM) && na_sm_get_ptrace_scope_value()) {
-            NA_GOTO_SUBSYS_ERROR(fatal, error, ret, na_sm_errno_to_na(errno),
-                "process_vm_writev() failed (%s):\n",
-                "Kernel Yama configuration does not allow cross-memory attach, "
-                "either run as root: \n"
-                "# /usr/sbin/sysctl kernel.yama.ptrace_scope=0\n"
-                "or if set to restricted, add the following call to your "
-                "application:\n"
-                "prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);\n"
-                "See https://www.kernel.org/doc/Documentation/security/Yama.txt"
-                " for more details.",
-                strerror(errno));
-        } else
-            NA_GOTO_ERROR(error, ret, na_sm_errno_to_na(errno),
-                "process_vm_writev() failed (%s)", strerror(errno));
+#ifdef NA_SM_HAS_XPMEM
+    /* Copy directly from/to attached peer memory when it is exposed */
+    if (NA_SM_CLASS(na_class)->xpmem_segid != -1 &&
+        na_sm_mem_handle_remote->info.segid != -1) {
+        ret = na_sm_xpmem_copy(&na_sm_addr->xpmem_cache,
+            na_sm_mem_handle_remote->info.segid, liov, liovcnt, riov, riovcnt,
+            NA_TRUE);
+        if (ret == NA_SUCCESS)
+            goto complete;
+        NA_LOG_WARNING("XPMEM copy failed, falling back to CMA");
+        ret = NA_SUCCESS;
     }
-    NA_CHECK_ERROR((na_size_t) nwrite != length, error, ret, NA_MSGSIZE,
-        "Wrote %ld bytes, was expecting %lu bytes", nwrite, length);
+#endif
+
+#if defined(NA_SM_HAS_CMA)
+    ret = na_sm_cma_copy(NA_SM_CLASS(na_class), na_sm_addr->pid, liov, liovcnt,
+        riov, riovcnt, length, NA_TRUE);
+    NA_CHECK_NA_ERROR(error, ret, "Could not write remote data");
 #elif defined(__APPLE__)
     kret = task_for_pid(mach_task_self(), na_sm_addr->pid, &remote_task);
     NA_CHECK_SUBSYS_ERROR(fatal, kret != KERN_SUCCESS, error, ret,
@@ -4711,6 +7469,9 @@ na_sm_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         "mach_vm_write() failed (%s)", mach_error_string(kret));
 #endif
 
+#ifdef NA_SM_HAS_XPMEM
+complete:
+#endif
     /* Free before adding to completion queue */
     if (liovcnt > NA_SM_IOV_STATIC_MAX &&
         (length != na_sm_mem_handle_local->info.len))
@@ -4738,6 +7499,14 @@ error:
     hg_atomic_decr32(&na_sm_op_id->na_sm_addr->ref_count);
     hg_atomic_set32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
 
+    /* CMA may also be denied without Yama (e.g., seccomp), stage instead */
+    if (ret == NA_PERMISSION &&
+        na_sm_stage_fallback(
+            NA_SM_CLASS(na_class), na_sm_addr, na_sm_mem_handle_remote))
+        return na_sm_put(na_class, context, callback, arg, local_mem_handle,
+            local_offset, remote_mem_handle, remote_offset, length,
+            remote_addr, remote_id, op_id);
+
     return ret;
 }
 
@@ -4746,7 +7515,7 @@ static na_return_t
 na_sm_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
-    na_size_t length, na_addr_t remote_addr, na_uint8_t NA_UNUSED remote_id,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
     na_op_id_t *op_id)
 {
     struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
@@ -4765,9 +7534,7 @@ na_sm_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     struct iovec *liov, *riov;
     unsigned long liovcnt = 0, riovcnt = 0;
     na_return_t ret = NA_SUCCESS;
-#if defined(NA_SM_HAS_CMA)
-    ssize_t nread;
-#elif defined(__APPLE__)
+#if defined(__APPLE__)
     mach_vm_size_t nread;
     kern_return_t kret;
     mach_port_name_t remote_task;
@@ -4802,9 +7569,21 @@ na_sm_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_sm_op_id->completion_data.callback_info.type = NA_CB_GET;
     na_sm_op_id->completion_data.callback = callback;
     na_sm_op_id->completion_data.callback_info.arg = arg;
-    hg_atomic_incr32(&na_sm_addr->ref_count);
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
     na_sm_op_id->na_sm_addr = na_sm_addr;
     hg_atomic_set32(&na_sm_op_id->status, 0);
+    HG_PROBE3(na, sm_get, na_sm_op_id, length, na_sm_addr->pid);
+    na_sm_op_id->info.rma.ret = NA_SUCCESS;
+
+    /* Peer memory cannot be accessed directly, copy through queue pair */
+    if (na_sm_stage_use(
+            NA_SM_CLASS(na_class), na_sm_addr, na_sm_mem_handle_remote)) {
+        ret = na_sm_stage_rma(na_class, na_sm_op_id, na_sm_mem_handle_local,
+            local_offset, na_sm_mem_handle_remote, remote_offset, length,
+            NA_FALSE);
+        NA_CHECK_NA_ERROR(error, ret, "Could not stage remote read");
+        goto done;
+    }
 
     /* Translate local offset */
     if (local_offset > 0)
@@ -4858,25 +7637,24 @@ na_sm_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         riovcnt = remote_iovcnt;
     }
 
-#if defined(NA_SM_HAS_CMA)
-    nread = process_vm_readv(na_sm_addr->pid, liov, liovcnt, riov, riovcnt, 0);
-    if (unlikely(nread < 0)) {
-        if ((errno == EPERM) && na_sm_get_ptrace_scope_value()) {
-            NA_GOTO_SUBSYS_ERROR(fatal, error, ret, na_sm_errno_to_na(errno),
-                "process_vm_readv() failed (%s):\n",
-                "Kernel Yama configuration does not allow cross-memory attach, "
-                "either run as root: \n"
-                "# /usr/sbin/sysctl kernel.yama.ptrace_scope=0\n"
-                "or if set to restricted, add the following call to your "
-                "application:\n"
-                "prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);\n"
-                "See https://www.kernel.org/doc/Documentation/security/Yama.txt"
-                " for more details.",
-                strerror(errno));
-        } else
-            NA_CHECK_ERROR(nread < 0, error, ret, na_sm_errno_to_na(errno),
-                "process_vm_readv() failed (%s)", strerror(errno));
+#ifdef NA_SM_HAS_XPMEM
+    /* Copy directly from/to attached peer memory when it is exposed */
+    if (NA_SM_CLASS(na_class)->xpmem_segid != -1 &&
+        na_sm_mem_handle_remote->info.segid != -1) {
+        ret = na_sm_xpmem_copy(&na_sm_addr->xpmem_cache,
+            na_sm_mem_handle_remote->info.segid, liov, liovcnt, riov, riovcnt,
+            NA_FALSE);
+        if (ret == NA_SUCCESS)
+            goto complete;
+        NA_LOG_WARNING("XPMEM copy failed, falling back to CMA");
+        ret = NA_SUCCESS;
     }
+#endif
+
+#if defined(NA_SM_HAS_CMA)
+    ret = na_sm_cma_copy(NA_SM_CLASS(na_class), na_sm_addr->pid, liov, liovcnt,
+        riov, riovcnt, length, NA_FALSE);
+    NA_CHECK_NA_ERROR(error, ret, "Could not read remote data");
 #elif defined(__APPLE__)
     kret = task_for_pid(mach_task_self(), na_sm_addr->pid, &remote_task);
     NA_CHECK_SUBSYS_ERROR(fatal, kret != KERN_SUCCESS, error, ret,
@@ -4893,12 +7671,13 @@ na_sm_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         (mach_vm_address_t) liov[0].iov_base, &nread);
     NA_CHECK_ERROR(kret != KERN_SUCCESS, error, ret, NA_PROTOCOL_ERROR,
         "mach_vm_read_overwrite() failed (%s)", mach_error_string(kret));
-#endif
-#if defined(NA_SM_HAS_CMA) || defined(__APPLE__)
     NA_CHECK_ERROR((na_size_t) nread != length, error, ret, NA_MSGSIZE,
         "Read %ld bytes, was expecting %lu bytes", nread, length);
 #endif
 
+#ifdef NA_SM_HAS_XPMEM
+complete:
+#endif
     /* Free before adding to completion queue */
     if (liovcnt > NA_SM_IOV_STATIC_MAX &&
         (length != na_sm_mem_handle_local->info.len))
@@ -4926,6 +7705,120 @@ error:
     hg_atomic_decr32(&na_sm_op_id->na_sm_addr->ref_count);
     hg_atomic_set32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
 
+    /* CMA may also be denied without Yama (e.g., seccomp), stage instead */
+    if (ret == NA_PERMISSION &&
+        na_sm_stage_fallback(
+            NA_SM_CLASS(na_class), na_sm_addr, na_sm_mem_handle_remote))
+        return na_sm_get(na_class, context, callback, arg, local_mem_handle,
+            local_offset, remote_mem_handle, remote_offset, length,
+            remote_addr, remote_id, op_id);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare,
+    na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id, na_op_id_t *op_id)
+{
+    struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
+    struct na_sm_mem_handle *na_sm_mem_handle_local =
+        (struct na_sm_mem_handle *) local_mem_handle;
+    struct na_sm_mem_handle *na_sm_mem_handle_remote =
+        (struct na_sm_mem_handle *) remote_mem_handle;
+    struct na_sm_addr *na_sm_addr = (struct na_sm_addr *) remote_addr;
+    struct iovec *local_iov = NA_SM_IOV(na_sm_mem_handle_local),
+                 *remote_iov = NA_SM_IOV(na_sm_mem_handle_remote);
+    unsigned long local_index = 0, remote_index = 0;
+    na_offset_t local_iov_offset = 0, remote_iov_offset = 0;
+    char *local_ptr, *remote_ptr;
+    na_uint64_t prev;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_ERROR(na_sm_mem_handle_remote->info.flags != NA_MEM_READWRITE ||
+                       na_sm_mem_handle_local->info.flags == NA_MEM_READ_ONLY,
+        done, ret, NA_PERMISSION,
+        "Registered memory requires read/write permission");
+
+    /* Value must be contained within a single segment on both sides */
+    na_sm_iov_get_index_offset(local_iov,
+        na_sm_mem_handle_local->info.iovcnt, local_offset, &local_index,
+        &local_iov_offset);
+    na_sm_iov_get_index_offset(remote_iov,
+        na_sm_mem_handle_remote->info.iovcnt, remote_offset, &remote_index,
+        &remote_iov_offset);
+    NA_CHECK_ERROR(
+        local_index >= na_sm_mem_handle_local->info.iovcnt ||
+            remote_index >= na_sm_mem_handle_remote->info.iovcnt ||
+            local_iov[local_index].iov_len - local_iov_offset <
+                sizeof(na_uint64_t) ||
+            remote_iov[remote_index].iov_len - remote_iov_offset <
+                sizeof(na_uint64_t),
+        done, ret, NA_OVERFLOW, "Atomic value must not span segments");
+    local_ptr = (char *) local_iov[local_index].iov_base + local_iov_offset;
+    remote_ptr = (char *) remote_iov[remote_index].iov_base + remote_iov_offset;
+    NA_CHECK_ERROR(((na_ptr_t) remote_ptr & 7) != 0, done, ret,
+        NA_INVALID_ARG, "Atomic value is not 8-byte aligned");
+
+    /* Check op_id */
+    NA_CHECK_ERROR(
+        na_sm_op_id == NULL, done, ret, NA_INVALID_ARG, "Invalid operation ID");
+    NA_CHECK_ERROR(
+        !(hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_COMPLETED), done,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    if (na_sm_addr->pid == getpid()) {
+        /* Memory of self is directly accessible */
+        prev = na_atomic_host(remote_ptr, op, operand, compare);
+    } else {
+#ifdef NA_SM_HAS_XPMEM
+        struct na_sm_xpmem_attach *attach = NULL;
+
+        /* Copies through CMA are not atomic, peer memory must be attached */
+        NA_CHECK_ERROR(NA_SM_CLASS(na_class)->xpmem_segid == -1 ||
+                           na_sm_mem_handle_remote->info.segid == -1,
+            done, ret, NA_OPNOTSUPPORTED,
+            "Atomics require peer memory to be exposed through XPMEM");
+        ret = na_sm_xpmem_attach_get(&na_sm_addr->xpmem_cache,
+            na_sm_mem_handle_remote->info.segid, remote_ptr,
+            sizeof(na_uint64_t), &attach);
+        NA_CHECK_NA_ERROR(done, ret, "Could not attach remote segment");
+        prev = na_atomic_host(
+            attach->local_base + (remote_ptr - attach->remote_base), op,
+            operand, compare);
+        na_sm_xpmem_attach_release(attach);
+#else
+        (void) operand;
+        (void) compare;
+        NA_GOTO_ERROR(done, ret, NA_OPNOTSUPPORTED,
+            "Atomics to other processes require XPMEM");
+#endif
+    }
+    memcpy(local_ptr, &prev, sizeof(prev));
+
+    na_sm_op_id->context = context;
+    na_sm_op_id->completion_data.callback_info.type = NA_CB_ATOMIC;
+    na_sm_op_id->completion_data.callback = callback;
+    na_sm_op_id->completion_data.callback_info.arg = arg;
+    hg_atomic_incr32_relaxed(&na_sm_addr->ref_count);
+    na_sm_op_id->na_sm_addr = na_sm_addr;
+    hg_atomic_set32(&na_sm_op_id->status, 0);
+
+    /* Immediate completion */
+    ret = na_sm_complete(
+        na_sm_op_id, NA_SM_CLASS(na_class)->endpoint.source_addr->tx_notify);
+    NA_CHECK_NA_ERROR(error, ret, "Could not complete operation");
+
+done:
+    return ret;
+
+error:
+    hg_atomic_decr32(&na_sm_op_id->na_sm_addr->ref_count);
+    hg_atomic_set32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
+
     return ret;
 }
 
@@ -4951,12 +7844,18 @@ na_sm_poll_try_wait(na_class_t *na_class, na_context_t NA_UNUSED *context)
 {
     struct na_sm_endpoint *na_sm_endpoint = &NA_SM_CLASS(na_class)->endpoint;
     struct na_sm_addr *na_sm_addr;
+    struct na_sm_op_id *na_sm_op_id;
     na_bool_t empty = NA_FALSE;
 
-    /* Check whether something is in one of the rx queues */
+    /* Peers must notify us from now on */
+    if (na_sm_endpoint->notify_on_wait)
+        na_sm_poll_set_polling(na_sm_endpoint, NA_FALSE);
+
+    /* Check whether something is in one of the rx queues or staged */
     hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
     HG_LIST_FOREACH (na_sm_addr, &na_sm_endpoint->poll_addr_list.list, entry) {
-        if (!na_sm_msg_queue_is_empty(na_sm_addr->rx_queue)) {
+        if (!na_sm_msg_queue_is_empty(na_sm_addr->rx_queue) ||
+            na_sm_stage_ready(na_sm_addr)) {
             hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
             return NA_FALSE;
         }
@@ -4970,6 +7869,17 @@ na_sm_poll_try_wait(na_class_t *na_class, na_context_t NA_UNUSED *context)
     if (!empty)
         return NA_FALSE;
 
+    /* Check whether a staged RMA can be started */
+    hg_thread_spin_lock(&na_sm_endpoint->stage_op_queue.lock);
+    HG_QUEUE_FOREACH (na_sm_op_id, &na_sm_endpoint->stage_op_queue.queue,
+        entry) {
+        if (!na_sm_op_id->na_sm_addr->stage_op) {
+            hg_thread_spin_unlock(&na_sm_endpoint->stage_op_queue.lock);
+            return NA_FALSE;
+        }
+    }
+    hg_thread_spin_unlock(&na_sm_endpoint->stage_op_queue.lock);
+
     return NA_TRUE;
 }
 
@@ -4991,7 +7901,13 @@ na_sm_progress(
         if (timeout)
             hg_time_get_current_ms(&t1);
 
-        if (na_sm_endpoint->poll_set) {
+        if (na_sm_endpoint->poll_set && na_sm_endpoint->notify_on_wait) {
+            /* Make blocking progress, only wait when rx queues are empty */
+            ret = na_sm_poll_notify_on_wait(context, na_sm_endpoint, username,
+                (unsigned int) (remaining * 1000.0), &progressed);
+            NA_CHECK_NA_ERROR(
+                error, ret, "Could not make blocking progress on context");
+        } else if (na_sm_endpoint->poll_set) {
             /* Make blocking progress */
             ret = na_sm_poll_wait(context, na_sm_endpoint, username,
                 (unsigned int) (remaining * 1000.0), &progressed);
@@ -5004,10 +7920,27 @@ na_sm_progress(
                 error, ret, "Could not make non-blocking progress on context");
         }
 
+        /* Peers that sent us something or released msgs are making progress
+         * and may have freed space in their queues */
+        if (progressed && na_sm_endpoint->retry_ticks != 0)
+            na_sm_retry_wake(na_sm_endpoint);
+
         /* Process retries */
         ret = na_sm_process_retries(na_sm_endpoint, username);
         NA_CHECK_NA_ERROR(error, ret, "Could not process retried msgs");
 
+        /* Complete CMA and pool msgs */
+        ret = na_sm_process_cma(na_sm_endpoint, &progressed);
+        NA_CHECK_NA_ERROR(error, ret, "Could not process CMA msgs");
+
+        /* Complete canceled CMA and pool msgs whose receiver has exited */
+        ret = na_sm_cma_abort(na_sm_endpoint, NULL, 0, &progressed);
+        NA_CHECK_NA_ERROR(error, ret, "Could not abort CMA msgs");
+
+        /* Start staged RMA ops whose peer ring has been freed */
+        ret = na_sm_process_stage(na_sm_endpoint, &progressed);
+        NA_CHECK_NA_ERROR(error, ret, "Could not process staged RMA");
+
         if (progressed)
             return NA_SUCCESS;
 
@@ -5030,6 +7963,7 @@ na_sm_cancel(
 {
     struct na_sm_op_queue *op_queue = NULL;
     struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
+    na_bool_t deferred = NA_FALSE;
     na_return_t ret = NA_SUCCESS;
 
     /* Exit if op has already completed */
@@ -5050,13 +7984,17 @@ na_sm_cancel(
             break;
         case NA_CB_SEND_UNEXPECTED:
         case NA_CB_SEND_EXPECTED:
-            /* Must remove op_id from retry op queue */
+            /* Must remove op_id from retry op queue, or CMA op queue once
+             * posted */
             op_queue = &NA_SM_CLASS(na_class)->endpoint.retry_op_queue;
+            deferred = NA_TRUE;
             break;
         case NA_CB_PUT:
-            /* Nothing */
-            break;
         case NA_CB_GET:
+            /* Staged RMA ops can be removed until they are started */
+            op_queue = &NA_SM_CLASS(na_class)->endpoint.stage_op_queue;
+            break;
+        case NA_CB_ATOMIC:
             /* Nothing */
             break;
         default:
@@ -5082,9 +8020,113 @@ na_sm_cancel(
             ret = na_sm_complete(na_sm_op_id,
                 NA_SM_CLASS(na_class)->endpoint.source_addr->tx_notify);
             NA_CHECK_NA_ERROR(done, ret, "Could not complete operation");
+        } else if (deferred) {
+            na_bool_t progressed = NA_FALSE;
+
+            /* CMA and pool msgs complete as canceled once released, unless
+             * the receiver has exited */
+            ret = na_sm_cma_abort(&NA_SM_CLASS(na_class)->endpoint, NULL,
+                NA_SM_CLASS(na_class)->endpoint.source_addr->tx_notify,
+                &progressed);
+            NA_CHECK_NA_ERROR(done, ret, "Could not abort CMA msgs");
         }
     }
 
 done:
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_resource_stats_set(struct na_resource_stats *stats, na_uint32_t max_count,
+    na_uint32_t *count, const char *name, na_uint64_t used, na_uint64_t max)
+{
+    if (*count < max_count) {
+        strncpy(stats[*count].name, name, NA_RESOURCE_NAME_MAX - 1);
+        stats[*count].name[NA_RESOURCE_NAME_MAX - 1] = '\0';
+        stats[*count].used = used;
+        stats[*count].max = max;
+    }
+    (*count)++;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_get_resource_stats(
+    na_class_t *na_class, struct na_resource_stats *stats, na_uint32_t *count)
+{
+    struct na_sm_endpoint *na_sm_endpoint = &NA_SM_CLASS(na_class)->endpoint;
+    struct na_sm_region *shared_region =
+        na_sm_endpoint->source_addr->shared_region;
+    na_uint32_t max_count = *count;
+    na_uint64_t used;
+    struct na_sm_op_id *na_sm_op_id;
+    struct na_sm_unexpected_info *na_sm_unexpected_info;
+
+    *count = 0;
+
+    /* Queue pairs that peers reserved in the shared region */
+    if (shared_region) {
+        unsigned int i, available = 0;
+
+        for (i = 0; i < shared_region->pair_count; i++)
+            if (hg_atomic_get64(&shared_region->available[i / 64].bits) &
+                (hg_util_int64_t) (1ULL << i % 64))
+                available++;
+        na_sm_resource_stats_set(stats, max_count, count, "sm_queue_pairs",
+            shared_region->pair_count - available, shared_region->pair_count);
+
+        /* Memory mapped for the shared region and the queue pairs and staging
+         * rings that peers have created in it */
+        used = 0;
+        for (i = 0; i < shared_region->pair_count; i++)
+            if (hg_atomic_get64(&shared_region->created[i / 64]) &
+                (hg_util_int64_t) (1ULL << i % 64))
+                used++;
+        used *= NA_SM_QUEUE_PAIR_SIZE;
+        for (i = 0; i < shared_region->pair_count; i++)
+            if (hg_atomic_get64(&shared_region->staged[i / 64]) &
+                (hg_util_int64_t) (1ULL << i % 64))
+                used += NA_SM_STAGE_PAIR_SIZE;
+        na_sm_resource_stats_set(stats, max_count, count, "sm_region_bytes",
+            (na_uint64_t) NA_SM_REGION_SIZE + used, 0);
+    }
+
+    na_sm_resource_stats_set(stats, max_count, count, "sm_open_files",
+        (na_uint64_t) hg_atomic_get32(&na_sm_endpoint->nofile),
+        na_sm_endpoint->nofile_max);
+
+    /* Msg buffers handed out from the msg pool */
+    if (na_sm_endpoint->msg_pool.base) {
+        hg_thread_spin_lock(&na_sm_endpoint->msg_pool.lock);
+        used = na_sm_endpoint->msg_pool.count -
+               na_sm_endpoint->msg_pool.free_count;
+        hg_thread_spin_unlock(&na_sm_endpoint->msg_pool.lock);
+        na_sm_resource_stats_set(stats, max_count, count, "sm_msg_pool_bufs",
+            used, na_sm_endpoint->msg_pool.count);
+        na_sm_resource_stats_set(stats, max_count, count, "sm_msg_pool_bytes",
+            (na_uint64_t) (used * na_sm_endpoint->msg_pool.buf_size),
+            (na_uint64_t) na_sm_endpoint->msg_pool.count *
+                na_sm_endpoint->msg_pool.buf_size);
+    }
+
+    /* Sends waiting for space in a full tx queue */
+    used = 0;
+    hg_thread_spin_lock(&na_sm_endpoint->retry_op_queue.lock);
+    HG_QUEUE_FOREACH (na_sm_op_id, &na_sm_endpoint->retry_op_queue.queue, entry)
+        used++;
+    hg_thread_spin_unlock(&na_sm_endpoint->retry_op_queue.lock);
+    na_sm_resource_stats_set(stats, max_count, count, "sm_retry_ops", used, 0);
+
+    /* Unexpected messages received with no posted receive */
+    used = 0;
+    hg_thread_spin_lock(&na_sm_endpoint->unexpected_msg_queue.lock);
+    HG_QUEUE_FOREACH (na_sm_unexpected_info,
+        &na_sm_endpoint->unexpected_msg_queue.queue, entry)
+        used++;
+    hg_thread_spin_unlock(&na_sm_endpoint->unexpected_msg_queue.lock);
+    na_sm_resource_stats_set(
+        stats, max_count, count, "sm_unexpected_msgs", used, 0);
+
+    return NA_SUCCESS;
+}
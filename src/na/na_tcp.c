@@ -0,0 +1,3192 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#    define _GNU_SOURCE
+#endif
+#include "na_plugin.h"
+
+#include "mercury_hash_table.h"
+#include "mercury_list.h"
+#include "mercury_poll.h"
+#include "mercury_thread_mutex.h"
+#include "mercury_thread_rwlock.h"
+#include "mercury_thread_spin.h"
+#include "mercury_time.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Default msg sizes */
+#define NA_TCP_UNEXPECTED_SIZE (4096)
+#define NA_TCP_EXPECTED_SIZE   NA_TCP_UNEXPECTED_SIZE
+
+/* Max tag */
+#define NA_TCP_MAX_TAG NA_TAG_MAX
+
+/* Max events processed per poll */
+#define NA_TCP_MAX_EVENTS 16
+
+/* Size of the per-connection receive buffer, payloads that do not fit are
+ * read directly into their destination */
+#define NA_TCP_RX_BUF_SIZE (65536)
+
+/* Max reads per connection and per poll event */
+#define NA_TCP_RX_MAX (16)
+
+/* Max number of iovecs gathered into a single sendmsg() */
+#define NA_TCP_IOV_MAX (64)
+
+/* RMA payloads from that size on are sent with MSG_ZEROCOPY */
+#define NA_TCP_ZCOPY_SIZE (32768)
+
+/* Op ID status bits */
+#define NA_TCP_OP_COMPLETED (1 << 0)
+#define NA_TCP_OP_CANCELED  (1 << 1)
+#define NA_TCP_OP_QUEUED    (1 << 2)
+
+/* Connection state */
+#define NA_TCP_CONN_CONNECTING (1)
+#define NA_TCP_CONN_CONNECTED  (2)
+#define NA_TCP_CONN_CLOSED     (3)
+
+#define NA_TCP_CLASS(na_class)                                                 \
+    ((struct na_tcp_class *) (na_class->plugin_class))
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Msg types */
+typedef enum {
+    NA_TCP_MSG_HELLO,      /* Listening address of connecting peer */
+    NA_TCP_MSG_UNEXPECTED, /* Unexpected msg */
+    NA_TCP_MSG_EXPECTED,   /* Expected msg */
+    NA_TCP_MSG_PUT,        /* Put request followed by data */
+    NA_TCP_MSG_PUT_ACK,    /* Put completion */
+    NA_TCP_MSG_GET,        /* Get request */
+    NA_TCP_MSG_GET_ACK,    /* Get completion followed by data */
+    NA_TCP_MSG_ATOMIC,     /* Atomic request followed by operands */
+    NA_TCP_MSG_ATOMIC_ACK  /* Atomic completion with previous value */
+} na_tcp_msg_type_t;
+
+/* Msg header (peers are expected to share the same byte order) */
+struct na_tcp_hdr {
+    na_uint8_t type;    /* Msg type */
+    na_uint8_t status;  /* Status of RMA requests (na_return_t) */
+    na_uint16_t port;   /* Listening port (HELLO) */
+    na_uint32_t tag;    /* NA tag / IPv4 address (HELLO) / Atomic op */
+    na_uint64_t len;    /* Payload / RMA length */
+    na_uint64_t handle; /* Remote memory handle ID */
+    na_uint64_t offset; /* Offset into remote memory handle / Atomic value */
+    na_uint64_t cookie; /* RMA op ID cookie */
+};
+
+/* Poll type */
+typedef enum { NA_TCP_POLL_LISTEN, NA_TCP_POLL_CONN } na_tcp_poll_type_t;
+
+/* Queued send (msg, RMA request or RMA completion) */
+struct na_tcp_send {
+    HG_QUEUE_ENTRY(na_tcp_send) entry; /* Entry in send queue */
+    struct na_tcp_hdr hdr;             /* Header */
+    struct iovec iov[2];               /* Header and payload */
+    struct na_tcp_op_id *op_id;        /* Op ID that owns entry */
+    size_t size;                       /* Total size */
+    size_t offset;                     /* Size already written */
+    na_bool_t queued;                  /* Entry in send queue */
+    na_bool_t allocated;               /* Free once written */
+};
+
+/* Receive state of a connection */
+struct na_tcp_rx {
+    struct na_tcp_hdr hdr;                       /* Header received */
+    struct na_tcp_op_id *op_id;                  /* Op ID receiving payload */
+    struct na_tcp_unexpected_info *unexpected;   /* Unexpected msg copy */
+    char *buf;                                   /* Payload destination */
+    na_uint64_t operands[2];                     /* Atomic operands */
+    size_t hdr_len;                              /* Header size received */
+    size_t buf_len;                              /* Payload size kept */
+    size_t len;                                  /* Payload size received */
+    na_return_t status;                          /* Status of RMA request */
+    na_bool_t payload;                           /* Header was received */
+};
+
+/* Connection */
+struct na_tcp_conn {
+    na_tcp_poll_type_t poll_type;          /* Type of poll data */
+    HG_QUEUE_HEAD(na_tcp_send) send_queue; /* Sends not written yet */
+    HG_QUEUE_HEAD(na_tcp_op_id) rma_queue; /* RMA ops waiting for ack */
+    struct na_tcp_send hello;              /* HELLO msg */
+    struct na_tcp_rx rx;                   /* Receive state */
+    HG_LIST_ENTRY(na_tcp_conn) entry;      /* Entry in conn list */
+    HG_QUEUE_ENTRY(na_tcp_conn) free_entry; /* Entry in free conn queue */
+    struct na_tcp_addr *addr;              /* Peer address */
+    char *rx_buf;                          /* Receive buffer */
+    size_t rx_start;                       /* Start of buffered data */
+    size_t rx_end;                         /* End of buffered data */
+    hg_thread_mutex_t send_lock;           /* Lock of send state */
+    hg_thread_mutex_t recv_lock;           /* Lock of receive state */
+    int fd;                                /* Socket */
+    int state;                             /* Connection state */
+    na_bool_t pollout;                     /* Polling for POLLOUT */
+    na_bool_t zcopy;                       /* MSG_ZEROCOPY enabled */
+};
+
+/* Address */
+struct na_tcp_addr {
+    struct sockaddr_in sin;      /* Listening address of peer */
+    na_uint64_t key;             /* Key in address map */
+    struct na_tcp_conn *conn;    /* Connection used for sends */
+    hg_thread_mutex_t lock;      /* Lock of conn */
+    hg_atomic_int32_t ref_count; /* Ref count */
+    na_bool_t self;              /* Boolean for self */
+};
+
+/* Unexpected msg received before a recv was posted */
+struct na_tcp_unexpected_info {
+    HG_QUEUE_ENTRY(na_tcp_unexpected_info) entry;
+    struct na_tcp_addr *addr;
+    na_size_t buf_size;
+    na_tag_t tag;
+    char buf[];
+};
+
+/* Memory handle */
+struct na_tcp_mem_handle {
+    na_ptr_t base;   /* Base address of region */
+    na_uint64_t len; /* Size of region */
+    na_uint64_t id;  /* ID of registered region */
+    na_uint8_t flags; /* Flag of operation access */
+};
+
+/* Msg info */
+struct na_tcp_msg_info {
+    union {
+        const void *const_ptr;
+        void *ptr;
+    } buf;
+    na_size_t buf_size;
+    na_size_t actual_buf_size;
+    na_tag_t tag;
+};
+
+/* RMA info */
+struct na_tcp_rma_info {
+    void *buf;          /* Local buffer */
+    na_size_t len;      /* Length */
+    na_uint64_t cookie; /* Cookie matched against acks */
+    na_uint64_t operands[2]; /* Atomic operand and compare value */
+};
+
+/* Operation ID */
+struct na_tcp_op_id {
+    struct na_cb_completion_data completion_data; /* Completion data */
+    struct na_tcp_send send;                      /* Send entry */
+    union {
+        struct na_tcp_msg_info msg;
+        struct na_tcp_rma_info rma;
+    } info;                              /* Op info */
+    HG_QUEUE_ENTRY(na_tcp_op_id) entry;  /* Entry in queue */
+    na_context_t *context;               /* NA context associated */
+    struct na_tcp_addr *addr;            /* Address associated */
+    struct na_tcp_conn *conn;            /* Connection used */
+    hg_atomic_int32_t status;            /* Operation status */
+};
+
+/* Op ID queue */
+struct na_tcp_op_queue {
+    HG_QUEUE_HEAD(na_tcp_op_id) queue;
+    hg_thread_spin_t lock;
+};
+
+/* Unexpected queues (posted recvs and msgs received before a recv) */
+struct na_tcp_unexpected_queue {
+    HG_QUEUE_HEAD(na_tcp_op_id) op_queue;
+    HG_QUEUE_HEAD(na_tcp_unexpected_info) msg_queue;
+    hg_thread_spin_t lock;
+};
+
+/* Map */
+struct na_tcp_map {
+    hg_thread_rwlock_t lock;
+    hg_hash_table_t *map;
+};
+
+/* Connection list */
+struct na_tcp_conn_list {
+    HG_LIST_HEAD(na_tcp_conn) list;            /* All connections */
+    HG_QUEUE_HEAD(na_tcp_conn) free_queue;     /* Closed connections */
+    hg_thread_mutex_t lock;
+};
+
+/* Class */
+struct na_tcp_class {
+    struct na_tcp_unexpected_queue unexpected_queue; /* Unexpected queues */
+    struct na_tcp_op_queue expected_op_queue;        /* Expected op queue */
+    struct na_tcp_map addr_map;                      /* Address map */
+    struct na_tcp_map mem_map;                       /* Registered regions */
+    struct na_tcp_conn_list conn_list;               /* Connections */
+    struct na_op_slab *op_slab;                      /* Slab of op IDs */
+    hg_poll_set_t *poll_set;                         /* Poll set */
+    struct na_tcp_addr *self_addr;                   /* Self address */
+    na_size_t unexpected_size_max;                   /* Max unexpected size */
+    na_size_t expected_size_max;                     /* Max expected size */
+    hg_atomic_int64_t mem_id;                        /* Next region ID */
+    hg_atomic_int64_t cookie;                        /* Next RMA cookie */
+    na_tcp_poll_type_t listen_poll_type;             /* Type of poll data */
+    int listen_fd;                                   /* Listening socket */
+    na_bool_t no_wait;                               /* Busy-spin progress */
+    na_bool_t zcopy;                                 /* Use MSG_ZEROCOPY */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Convert errno to NA return values.
+ */
+static na_return_t
+na_tcp_errno_to_na(int rc);
+
+/**
+ * Key hash for hash tables.
+ */
+static NA_INLINE unsigned int
+na_tcp_key_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare keys.
+ */
+static NA_INLINE int
+na_tcp_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Set socket options shared by accepted and connected sockets.
+ */
+static na_return_t
+na_tcp_sock_setup(struct na_tcp_class *priv, int fd, na_bool_t *zcopy);
+
+/**
+ * Resolve IPv4 address of host name.
+ */
+static na_return_t
+na_tcp_host_resolve(const char *host, struct in_addr *in_addr);
+
+/**
+ * Resolve address from IPv4 address and port (network order), address is
+ * created and inserted into the map if it does not exist yet (returned
+ * address is ref counted).
+ */
+static na_return_t
+na_tcp_addr_resolve(struct na_tcp_class *priv, na_uint32_t ip,
+    na_uint16_t port, struct na_tcp_addr **addr);
+
+/**
+ * Decrement ref count and free address once it reaches 0.
+ */
+static void
+na_tcp_addr_decref(struct na_tcp_addr *na_tcp_addr);
+
+/**
+ * Get a new connection (closed connections are reused).
+ */
+static na_return_t
+na_tcp_conn_get(struct na_tcp_class *priv, struct na_tcp_conn **conn);
+
+/**
+ * Connect to peer, HELLO is queued as first msg (called with addr lock).
+ */
+static na_return_t
+na_tcp_conn_connect(struct na_tcp_class *priv, struct na_tcp_addr *na_tcp_addr,
+    struct na_tcp_conn **conn);
+
+/**
+ * Update events polled for connection (called with send lock).
+ */
+static void
+na_tcp_conn_poll_set(
+    struct na_tcp_class *priv, struct na_tcp_conn *conn, na_bool_t pollout);
+
+/**
+ * Close connection and fail operations that were using it (called with
+ * recv lock).
+ */
+static void
+na_tcp_conn_close(struct na_tcp_class *priv, struct na_tcp_conn *conn);
+
+/**
+ * Queue send to peer, RMA op IDs are also queued until acknowledged.
+ */
+static na_return_t
+na_tcp_conn_post(struct na_tcp_class *priv, struct na_tcp_addr *na_tcp_addr,
+    struct na_tcp_send *send, struct na_tcp_op_id *rma_op_id);
+
+/**
+ * Write as many queued sends as possible with a single sendmsg(), sends
+ * that are fully written are moved to the done queue (called with send
+ * lock).
+ */
+static void
+na_tcp_conn_flush(struct na_tcp_class *priv, struct na_tcp_conn *conn,
+    struct na_tcp_send **done);
+
+/**
+ * Complete sends that were written.
+ */
+static void
+na_tcp_send_done(struct na_tcp_send *done);
+
+/**
+ * Remove RMA op ID matching cookie.
+ */
+static struct na_tcp_op_id *
+na_tcp_conn_rma_remove(struct na_tcp_conn *conn, na_uint64_t cookie);
+
+/**
+ * Queue RMA completion.
+ */
+static na_return_t
+na_tcp_rma_ack(struct na_tcp_class *priv, struct na_tcp_conn *conn,
+    na_tcp_msg_type_t type, na_return_t status, na_uint64_t cookie, void *buf,
+    na_size_t len, na_uint64_t value);
+
+/**
+ * Find registered region matching RMA request.
+ */
+static na_return_t
+na_tcp_mem_lookup(struct na_tcp_class *priv, const struct na_tcp_hdr *hdr,
+    na_bool_t write, void **buf);
+
+/**
+ * Read from connection.
+ */
+static na_return_t
+na_tcp_conn_recv(
+    struct na_tcp_class *priv, struct na_tcp_conn *conn, na_bool_t *progressed);
+
+/**
+ * Process data buffered by connection.
+ */
+static na_return_t
+na_tcp_conn_rx_process(struct na_tcp_class *priv, struct na_tcp_conn *conn);
+
+/**
+ * Process msg header.
+ */
+static na_return_t
+na_tcp_rx_hdr(struct na_tcp_class *priv, struct na_tcp_conn *conn);
+
+/**
+ * Process msg once payload was received.
+ */
+static na_return_t
+na_tcp_rx_done(struct na_tcp_class *priv, struct na_tcp_conn *conn);
+
+/**
+ * Write to connection.
+ */
+static void
+na_tcp_conn_send(
+    struct na_tcp_class *priv, struct na_tcp_conn *conn, na_bool_t *progressed);
+
+/**
+ * Accept new connections.
+ */
+static void
+na_tcp_accept(struct na_tcp_class *priv, na_bool_t *progressed);
+
+/**
+ * Post msg send.
+ */
+static na_return_t
+na_tcp_msg_send(struct na_tcp_class *priv, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg, const void *buf,
+    na_size_t buf_size, struct na_tcp_addr *na_tcp_addr, na_tag_t tag,
+    struct na_tcp_op_id *na_tcp_op_id);
+
+/**
+ * Post put / get.
+ */
+static na_return_t
+na_tcp_rma(struct na_tcp_class *priv, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg,
+    struct na_tcp_mem_handle *local_mem_handle, na_offset_t local_offset,
+    struct na_tcp_mem_handle *remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, struct na_tcp_addr *na_tcp_addr,
+    struct na_tcp_op_id *na_tcp_op_id);
+
+/**
+ * Post atomic.
+ */
+static na_return_t
+na_tcp_atomic_post(struct na_tcp_class *priv, na_context_t *context,
+    na_cb_t callback, void *arg, na_atomic_op_t op, na_uint64_t operand,
+    na_uint64_t compare, struct na_tcp_mem_handle *local_mem_handle,
+    na_offset_t local_offset, struct na_tcp_mem_handle *remote_mem_handle,
+    na_offset_t remote_offset, struct na_tcp_addr *na_tcp_addr,
+    struct na_tcp_op_id *na_tcp_op_id);
+
+/**
+ * Complete operation.
+ */
+static void
+na_tcp_complete(struct na_tcp_op_id *na_tcp_op_id, na_return_t cb_ret);
+
+/**
+ * Release memory.
+ */
+static void
+na_tcp_release(void *arg);
+
+/* check_protocol */
+static na_bool_t
+na_tcp_check_protocol(const char *protocol_name);
+
+/* initialize */
+static na_return_t
+na_tcp_initialize(
+    na_class_t *na_class, const struct na_info *na_info, na_bool_t listening);
+
+/* finalize */
+static na_return_t
+na_tcp_finalize(na_class_t *na_class);
+
+/* op_create */
+static na_op_id_t *
+na_tcp_op_create(na_class_t *na_class);
+
+/* op_destroy */
+static na_return_t
+na_tcp_op_destroy(na_class_t *na_class, na_op_id_t *op_id);
+
+/* addr_lookup */
+static na_return_t
+na_tcp_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr);
+
+/* addr_free */
+static na_return_t
+na_tcp_addr_free(na_class_t *na_class, na_addr_t addr);
+
+/* addr_set_remove */
+static na_return_t
+na_tcp_addr_set_remove(na_class_t *na_class, na_addr_t addr);
+
+/* addr_warmup */
+static na_return_t
+na_tcp_addr_warmup(na_class_t *na_class, na_addr_t addr);
+
+/* addr_self */
+static na_return_t
+na_tcp_addr_self(na_class_t *na_class, na_addr_t *addr);
+
+/* addr_dup */
+static na_return_t
+na_tcp_addr_dup(na_class_t *na_class, na_addr_t addr, na_addr_t *new_addr);
+
+/* addr_cmp */
+static na_bool_t
+na_tcp_addr_cmp(na_class_t *na_class, na_addr_t addr1, na_addr_t addr2);
+
+/* addr_is_self */
+static na_bool_t
+na_tcp_addr_is_self(na_class_t *na_class, na_addr_t addr);
+
+/* addr_to_string */
+static na_return_t
+na_tcp_addr_to_string(
+    na_class_t *na_class, char *buf, na_size_t *buf_size, na_addr_t addr);
+
+/* addr_get_serialize_size */
+static na_size_t
+na_tcp_addr_get_serialize_size(na_class_t *na_class, na_addr_t addr);
+
+/* addr_serialize */
+static na_return_t
+na_tcp_addr_serialize(
+    na_class_t *na_class, void *buf, na_size_t buf_size, na_addr_t addr);
+
+/* addr_deserialize */
+static na_return_t
+na_tcp_addr_deserialize(na_class_t *na_class, na_addr_t *addr,
+    const void *buf, na_size_t buf_size);
+
+/* msg_get_max_unexpected_size */
+static na_size_t
+na_tcp_msg_get_max_unexpected_size(const na_class_t *na_class);
+
+/* msg_get_max_expected_size */
+static na_size_t
+na_tcp_msg_get_max_expected_size(const na_class_t *na_class);
+
+/* msg_get_max_tag */
+static na_tag_t
+na_tcp_msg_get_max_tag(const na_class_t *na_class);
+
+/* msg_send_unexpected */
+static na_return_t
+na_tcp_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
+    na_op_id_t *op_id);
+
+/* msg_recv_unexpected */
+static na_return_t
+na_tcp_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, na_op_id_t *op_id);
+
+/* msg_send_expected */
+static na_return_t
+na_tcp_msg_send_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
+    na_op_id_t *op_id);
+
+/* msg_recv_expected */
+static na_return_t
+na_tcp_msg_recv_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
+    na_tag_t tag, na_op_id_t *op_id);
+
+/* mem_handle_create */
+static na_return_t
+na_tcp_mem_handle_create(na_class_t *na_class, void *buf, na_size_t buf_size,
+    unsigned long flags, na_mem_handle_t *mem_handle);
+
+/* mem_handle_free */
+static na_return_t
+na_tcp_mem_handle_free(na_class_t *na_class, na_mem_handle_t mem_handle);
+
+/* mem_register */
+static na_return_t
+na_tcp_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle);
+
+/* mem_deregister */
+static na_return_t
+na_tcp_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle);
+
+/* mem_handle_get_serialize_size */
+static na_size_t
+na_tcp_mem_handle_get_serialize_size(
+    na_class_t *na_class, na_mem_handle_t mem_handle);
+
+/* mem_handle_serialize */
+static na_return_t
+na_tcp_mem_handle_serialize(na_class_t *na_class, void *buf, na_size_t buf_size,
+    na_mem_handle_t mem_handle);
+
+/* mem_handle_deserialize */
+static na_return_t
+na_tcp_mem_handle_deserialize(na_class_t *na_class, na_mem_handle_t *mem_handle,
+    const void *buf, na_size_t buf_size);
+
+/* put */
+static na_return_t
+na_tcp_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
+    na_op_id_t *op_id);
+
+/* get */
+static na_return_t
+na_tcp_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
+    na_op_id_t *op_id);
+
+/* atomic */
+static na_return_t
+na_tcp_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare,
+    na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t remote_addr, na_uint16_t remote_id, na_op_id_t *op_id);
+
+/* poll_get_fd */
+static int
+na_tcp_poll_get_fd(na_class_t *na_class, na_context_t *context);
+
+/* poll_try_wait */
+static na_bool_t
+na_tcp_poll_try_wait(na_class_t *na_class, na_context_t *context);
+
+/* progress */
+static na_return_t
+na_tcp_progress(
+    na_class_t *na_class, na_context_t *context, unsigned int timeout);
+
+/* cancel */
+static na_return_t
+na_tcp_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+const struct na_class_ops NA_PLUGIN_OPS(tcp) = {
+    "na",                                 /* name */
+    na_tcp_check_protocol,                /* check_protocol */
+    na_tcp_initialize,                    /* initialize */
+    na_tcp_finalize,                      /* finalize */
+    NULL,                                 /* cleanup */
+    NULL,                                 /* context_create */
+    NULL,                                 /* context_destroy */
+    na_tcp_op_create,                     /* op_create */
+    na_tcp_op_destroy,                    /* op_destroy */
+    na_tcp_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
+    na_tcp_addr_free,                     /* addr_free */
+    na_tcp_addr_set_remove,               /* addr_set_remove */
+    na_tcp_addr_warmup,                   /* addr_warmup */
+    na_tcp_addr_self,                     /* addr_self */
+    na_tcp_addr_dup,                      /* addr_dup */
+    na_tcp_addr_cmp,                      /* addr_cmp */
+    na_tcp_addr_is_self,                  /* addr_is_self */
+    na_tcp_addr_to_string,                /* addr_to_string */
+    na_tcp_addr_get_serialize_size,       /* addr_get_serialize_size */
+    na_tcp_addr_serialize,                /* addr_serialize */
+    na_tcp_addr_deserialize,              /* addr_deserialize */
+    NULL,                                 /* addr_deserialize_batch */
+    na_tcp_msg_get_max_unexpected_size,   /* msg_get_max_unexpected_size */
+    na_tcp_msg_get_max_expected_size,     /* msg_get_max_expected_size */
+    NULL,                                 /* msg_get_unexpected_header_size */
+    NULL,                                 /* msg_get_expected_header_size */
+    na_tcp_msg_get_max_tag,               /* msg_get_max_tag */
+    NULL,                                 /* msg_buf_alloc */
+    NULL,                                 /* msg_buf_free */
+    NULL,                                 /* msg_init_unexpected */
+    na_tcp_msg_send_unexpected,           /* msg_send_unexpected */
+    NULL,                                 /* msg_send_unexpectedv */
+    na_tcp_msg_recv_unexpected,           /* msg_recv_unexpected */
+    NULL,                                 /* msg_init_expected */
+    na_tcp_msg_send_expected,             /* msg_send_expected */
+    NULL,                                 /* msg_send_expectedv */
+    na_tcp_msg_recv_expected,             /* msg_recv_expected */
+    na_tcp_mem_handle_create,             /* mem_handle_create */
+    NULL,                                 /* mem_handle_create_segment */
+    na_tcp_mem_handle_free,               /* mem_handle_free */
+    NULL,                                 /* mem_handle_get_max_segments */
+    na_tcp_mem_register,                  /* mem_register */
+    na_tcp_mem_deregister,                /* mem_deregister */
+    na_tcp_mem_handle_get_serialize_size, /* mem_handle_get_serialize_size */
+    na_tcp_mem_handle_serialize,          /* mem_handle_serialize */
+    na_tcp_mem_handle_deserialize,        /* mem_handle_deserialize */
+    na_tcp_put,                           /* put */
+    na_tcp_get,                           /* get */
+    na_tcp_poll_get_fd,                   /* poll_get_fd */
+    na_tcp_poll_try_wait,                 /* poll_try_wait */
+    na_tcp_progress,                      /* progress */
+    na_tcp_cancel,                        /* cancel */
+    NULL,                                 /* get_resource_stats */
+    NULL,                                 /* mem_handle_create_sub */
+    NULL,                                 /* op_batch_begin */
+    NULL,                                 /* op_batch_end */
+    NULL,                                 /* mem_register_attr */
+    na_tcp_atomic                         /* atomic */
+};
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_errno_to_na(int rc)
+{
+    switch (rc) {
+        case EPERM:
+            return NA_PERMISSION;
+        case EINTR:
+            return NA_INTERRUPT;
+        case EAGAIN:
+            return NA_AGAIN;
+        case ENOMEM:
+        case ENOBUFS:
+            return NA_NOMEM;
+        case EACCES:
+            return NA_ACCESS;
+        case EFAULT:
+            return NA_FAULT;
+        case EINVAL:
+            return NA_INVALID_ARG;
+        case EMSGSIZE:
+            return NA_MSGSIZE;
+        case EADDRINUSE:
+            return NA_ADDRINUSE;
+        case EADDRNOTAVAIL:
+            return NA_ADDRNOTAVAIL;
+        case ECONNREFUSED:
+        case ECONNRESET:
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+        case EPIPE:
+            return NA_HOSTUNREACH;
+        case ETIMEDOUT:
+            return NA_TIMEOUT;
+        case ECANCELED:
+            return NA_CANCELED;
+        default:
+            return NA_PROTOCOL_ERROR;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE unsigned int
+na_tcp_key_hash(hg_hash_table_key_t key)
+{
+    na_uint64_t k = *((na_uint64_t *) key);
+
+    return (unsigned int) (k ^ (k >> 32));
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_tcp_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return *((na_uint64_t *) key1) == *((na_uint64_t *) key2);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_sock_setup(struct na_tcp_class *priv, int fd, na_bool_t *zcopy)
+{
+    na_return_t ret = NA_SUCCESS;
+    int flags, one = 1, rc;
+
+    flags = fcntl(fd, F_GETFL, 0);
+    NA_CHECK_SUBSYS_ERROR(addr, flags == -1, out, ret,
+        na_tcp_errno_to_na(errno), "fcntl() failed (%s)", strerror(errno));
+    rc = fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    NA_CHECK_SUBSYS_ERROR(addr, rc == -1, out, ret, na_tcp_errno_to_na(errno),
+        "fcntl() failed (%s)", strerror(errno));
+    (void) fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    /* Msgs are batched by the plugin itself */
+    rc = setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    NA_CHECK_SUBSYS_ERROR(addr, rc == -1, out, ret, na_tcp_errno_to_na(errno),
+        "setsockopt() failed (%s)", strerror(errno));
+
+    *zcopy = NA_FALSE;
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    if (priv->zcopy)
+        *zcopy = (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) ==
+                  0);
+#else
+    (void) priv;
+#endif
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_host_resolve(const char *host, struct in_addr *in_addr)
+{
+    struct addrinfo hints, *res = NULL;
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    rc = getaddrinfo(host, NULL, &hints, &res);
+    NA_CHECK_SUBSYS_ERROR(addr, rc != 0, out, ret, NA_ADDRNOTAVAIL,
+        "getaddrinfo() failed for %s (%s)", host, gai_strerror(rc));
+
+    *in_addr = ((struct sockaddr_in *) res->ai_addr)->sin_addr;
+    freeaddrinfo(res);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_resolve(struct na_tcp_class *priv, na_uint32_t ip,
+    na_uint16_t port, struct na_tcp_addr **addr)
+{
+    struct na_tcp_map *na_tcp_map = &priv->addr_map;
+    struct na_tcp_addr *na_tcp_addr;
+    na_uint64_t key = ((na_uint64_t) ntohl(ip) << 16) | ntohs(port);
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    hg_thread_rwlock_rdlock(&na_tcp_map->lock);
+    na_tcp_addr = (struct na_tcp_addr *) hg_hash_table_lookup(
+        na_tcp_map->map, (hg_hash_table_key_t) &key);
+    if (na_tcp_addr)
+        hg_atomic_incr32_relaxed(&na_tcp_addr->ref_count);
+    hg_thread_rwlock_release_rdlock(&na_tcp_map->lock);
+    if (na_tcp_addr)
+        goto done;
+
+    hg_thread_rwlock_wrlock(&na_tcp_map->lock);
+
+    /* Look up again to prevent race between lock release/acquire */
+    na_tcp_addr = (struct na_tcp_addr *) hg_hash_table_lookup(
+        na_tcp_map->map, (hg_hash_table_key_t) &key);
+    if (na_tcp_addr) {
+        hg_atomic_incr32_relaxed(&na_tcp_addr->ref_count);
+        hg_thread_rwlock_release_wrlock(&na_tcp_map->lock);
+        goto done;
+    }
+
+    na_tcp_addr = (struct na_tcp_addr *) calloc(1, sizeof(*na_tcp_addr));
+    NA_CHECK_SUBSYS_ERROR(addr, na_tcp_addr == NULL, unlock, ret, NA_NOMEM,
+        "Could not allocate TCP addr");
+    na_tcp_addr->sin.sin_family = AF_INET;
+    na_tcp_addr->sin.sin_addr.s_addr = ip;
+    na_tcp_addr->sin.sin_port = port;
+    na_tcp_addr->key = key;
+    hg_thread_mutex_init(&na_tcp_addr->lock);
+    /* One reference for the map and one for the caller */
+    hg_atomic_init32(&na_tcp_addr->ref_count, 2);
+
+    rc = hg_hash_table_insert(na_tcp_map->map,
+        (hg_hash_table_key_t) &na_tcp_addr->key,
+        (hg_hash_table_value_t) na_tcp_addr);
+    if (rc == 0) {
+        hg_thread_mutex_destroy(&na_tcp_addr->lock);
+        free(na_tcp_addr);
+        NA_GOTO_SUBSYS_ERROR(
+            addr, unlock, ret, NA_NOMEM, "hg_hash_table_insert() failed");
+    }
+
+    hg_thread_rwlock_release_wrlock(&na_tcp_map->lock);
+
+done:
+    *addr = na_tcp_addr;
+
+    return NA_SUCCESS;
+
+unlock:
+    hg_thread_rwlock_release_wrlock(&na_tcp_map->lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_addr_decref(struct na_tcp_addr *na_tcp_addr)
+{
+    /* Connections hold a reference, no connection is attached anymore */
+    if (hg_atomic_decr32(&na_tcp_addr->ref_count) > 0)
+        return;
+
+    hg_thread_mutex_destroy(&na_tcp_addr->lock);
+    free(na_tcp_addr);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_get(struct na_tcp_class *priv, struct na_tcp_conn **conn)
+{
+    struct na_tcp_conn_list *conn_list = &priv->conn_list;
+    struct na_tcp_conn *na_tcp_conn;
+    na_return_t ret = NA_SUCCESS;
+
+    hg_thread_mutex_lock(&conn_list->lock);
+    na_tcp_conn = HG_QUEUE_FIRST(&conn_list->free_queue);
+    if (na_tcp_conn) {
+        HG_QUEUE_POP_HEAD(&conn_list->free_queue, free_entry);
+        hg_thread_mutex_unlock(&conn_list->lock);
+        goto done;
+    }
+    hg_thread_mutex_unlock(&conn_list->lock);
+
+    na_tcp_conn = (struct na_tcp_conn *) calloc(1, sizeof(*na_tcp_conn));
+    NA_CHECK_SUBSYS_ERROR(addr, na_tcp_conn == NULL, out, ret, NA_NOMEM,
+        "Could not allocate TCP connection");
+    na_tcp_conn->rx_buf = (char *) malloc(NA_TCP_RX_BUF_SIZE);
+    if (na_tcp_conn->rx_buf == NULL) {
+        free(na_tcp_conn);
+        NA_GOTO_SUBSYS_ERROR(
+            addr, out, ret, NA_NOMEM, "Could not allocate receive buffer");
+    }
+    na_tcp_conn->poll_type = NA_TCP_POLL_CONN;
+    HG_QUEUE_INIT(&na_tcp_conn->send_queue);
+    HG_QUEUE_INIT(&na_tcp_conn->rma_queue);
+    hg_thread_mutex_init(&na_tcp_conn->send_lock);
+    hg_thread_mutex_init(&na_tcp_conn->recv_lock);
+    na_tcp_conn->fd = -1;
+    na_tcp_conn->state = NA_TCP_CONN_CLOSED;
+
+    hg_thread_mutex_lock(&conn_list->lock);
+    HG_LIST_INSERT_HEAD(&conn_list->list, na_tcp_conn, entry);
+    hg_thread_mutex_unlock(&conn_list->lock);
+
+done:
+    *conn = na_tcp_conn;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_connect(struct na_tcp_class *priv, struct na_tcp_addr *na_tcp_addr,
+    struct na_tcp_conn **conn)
+{
+    struct na_tcp_conn *na_tcp_conn = NULL;
+    struct na_tcp_addr *self_addr = priv->self_addr;
+    struct hg_poll_event event = {.events = HG_POLLIN | HG_POLLOUT};
+    na_return_t ret;
+    int fd, rc;
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    NA_CHECK_SUBSYS_ERROR(addr, fd == -1, out, ret, na_tcp_errno_to_na(errno),
+        "socket() failed (%s)", strerror(errno));
+
+    ret = na_tcp_conn_get(priv, &na_tcp_conn);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not get connection");
+
+    ret = na_tcp_sock_setup(priv, fd, &na_tcp_conn->zcopy);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not set up socket");
+
+    rc = connect(
+        fd, (struct sockaddr *) &na_tcp_addr->sin, sizeof(na_tcp_addr->sin));
+    NA_CHECK_SUBSYS_ERROR(addr, rc == -1 && errno != EINPROGRESS, error, ret,
+        na_tcp_errno_to_na(errno), "connect() failed (%s)", strerror(errno));
+
+    hg_thread_mutex_lock(&na_tcp_conn->send_lock);
+    na_tcp_conn->fd = fd;
+    na_tcp_conn->state =
+        (rc == 0) ? NA_TCP_CONN_CONNECTED : NA_TCP_CONN_CONNECTING;
+    na_tcp_conn->pollout = NA_TRUE;
+    hg_atomic_incr32_relaxed(&na_tcp_addr->ref_count);
+    na_tcp_conn->addr = na_tcp_addr;
+
+    /* Peer identifies us with our listening address, which must be the
+     * first msg it receives */
+    memset(&na_tcp_conn->hello, 0, sizeof(na_tcp_conn->hello));
+    na_tcp_conn->hello.hdr.type = NA_TCP_MSG_HELLO;
+    na_tcp_conn->hello.hdr.tag = self_addr->sin.sin_addr.s_addr;
+    na_tcp_conn->hello.hdr.port = self_addr->sin.sin_port;
+    na_tcp_conn->hello.iov[0].iov_base = &na_tcp_conn->hello.hdr;
+    na_tcp_conn->hello.iov[0].iov_len = sizeof(struct na_tcp_hdr);
+    na_tcp_conn->hello.size = sizeof(struct na_tcp_hdr);
+    na_tcp_conn->hello.queued = NA_TRUE;
+    HG_QUEUE_PUSH_TAIL(&na_tcp_conn->send_queue, &na_tcp_conn->hello, entry);
+
+    /* Poll for POLLOUT until queued msgs are written */
+    event.data.ptr = na_tcp_conn;
+    rc = hg_poll_add(priv->poll_set, fd, &event);
+    hg_thread_mutex_unlock(&na_tcp_conn->send_lock);
+    NA_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error_conn, ret,
+        NA_PROTOCOL_ERROR, "hg_poll_add() failed");
+
+    na_tcp_addr->conn = na_tcp_conn;
+    *conn = na_tcp_conn;
+
+    return NA_SUCCESS;
+
+error_conn:
+    /* Nothing was sent yet, release connection */
+    hg_thread_mutex_lock(&na_tcp_conn->recv_lock);
+    na_tcp_conn_close(priv, na_tcp_conn);
+    hg_thread_mutex_unlock(&na_tcp_conn->recv_lock);
+
+    return ret;
+
+error:
+    close(fd);
+    if (na_tcp_conn) {
+        hg_thread_mutex_lock(&priv->conn_list.lock);
+        HG_QUEUE_PUSH_TAIL(
+            &priv->conn_list.free_queue, na_tcp_conn, free_entry);
+        hg_thread_mutex_unlock(&priv->conn_list.lock);
+    }
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_conn_poll_set(
+    struct na_tcp_class *priv, struct na_tcp_conn *conn, na_bool_t pollout)
+{
+    struct hg_poll_event event = {.events = HG_POLLIN, .data.ptr = conn};
+    int rc;
+
+    if (conn->pollout == pollout || conn->state == NA_TCP_CONN_CLOSED)
+        return;
+
+    /* Poll sets cannot modify events, remove and add again */
+    if (pollout)
+        event.events |= HG_POLLOUT;
+    (void) hg_poll_remove(priv->poll_set, conn->fd);
+    rc = hg_poll_add(priv->poll_set, conn->fd, &event);
+    if (rc != HG_UTIL_SUCCESS) {
+        /* Peer can no longer be polled, close connection */
+        NA_LOG_SUBSYS_ERROR(poll, "hg_poll_add() failed");
+        (void) shutdown(conn->fd, SHUT_RDWR);
+        return;
+    }
+    conn->pollout = pollout;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_conn_close(struct na_tcp_class *priv, struct na_tcp_conn *conn)
+{
+    struct na_tcp_send *sends;
+    struct na_tcp_op_id *rma_ops;
+    struct na_tcp_rx *rx = &conn->rx;
+    struct na_tcp_addr *na_tcp_addr;
+    struct na_tcp_send *send;
+    struct na_tcp_op_id *na_tcp_op_id;
+
+    hg_thread_mutex_lock(&conn->send_lock);
+    if (conn->state == NA_TCP_CONN_CLOSED) {
+        hg_thread_mutex_unlock(&conn->send_lock);
+        return;
+    }
+    NA_LOG_SUBSYS_DEBUG(addr, "Closing connection %p (fd %d)", conn, conn->fd);
+    conn->state = NA_TCP_CONN_CLOSED;
+    (void) hg_poll_remove(priv->poll_set, conn->fd);
+    close(conn->fd);
+    conn->fd = -1;
+    conn->pollout = NA_FALSE;
+    sends = HG_QUEUE_FIRST(&conn->send_queue);
+    HG_QUEUE_INIT(&conn->send_queue);
+    rma_ops = HG_QUEUE_FIRST(&conn->rma_queue);
+    HG_QUEUE_INIT(&conn->rma_queue);
+    na_tcp_addr = conn->addr;
+    conn->addr = NULL;
+    hg_thread_mutex_unlock(&conn->send_lock);
+
+    /* Senders must connect again */
+    if (na_tcp_addr) {
+        hg_thread_mutex_lock(&na_tcp_addr->lock);
+        if (na_tcp_addr->conn == conn)
+            na_tcp_addr->conn = NULL;
+        hg_thread_mutex_unlock(&na_tcp_addr->lock);
+    }
+
+    /* Give back op ID being received into */
+    if (rx->op_id) {
+        if (rx->hdr.type == NA_TCP_MSG_UNEXPECTED) {
+            struct na_tcp_unexpected_queue *unexpected_queue =
+                &priv->unexpected_queue;
+
+            hg_atomic_decr32(&rx->op_id->addr->ref_count);
+            rx->op_id->addr = NULL;
+            hg_thread_spin_lock(&unexpected_queue->lock);
+            HG_QUEUE_PUSH_TAIL(&unexpected_queue->op_queue, rx->op_id, entry);
+            hg_atomic_or32(&rx->op_id->status, NA_TCP_OP_QUEUED);
+            hg_thread_spin_unlock(&unexpected_queue->lock);
+        } else
+            na_tcp_complete(rx->op_id, NA_HOSTUNREACH);
+    }
+    if (rx->unexpected) {
+        na_tcp_addr_decref(rx->unexpected->addr);
+        free(rx->unexpected);
+    }
+    memset(rx, 0, sizeof(*rx));
+    conn->rx_start = conn->rx_end = 0;
+
+    /* Fail operations */
+    while ((send = sends) != NULL) {
+        sends = HG_QUEUE_NEXT(send, entry);
+        send->queued = NA_FALSE;
+        if (send->allocated)
+            free(send);
+        else if (send->op_id && (send->hdr.type == NA_TCP_MSG_UNEXPECTED ||
+                                    send->hdr.type == NA_TCP_MSG_EXPECTED))
+            na_tcp_complete(send->op_id, NA_HOSTUNREACH);
+    }
+    while ((na_tcp_op_id = rma_ops) != NULL) {
+        rma_ops = HG_QUEUE_NEXT(na_tcp_op_id, entry);
+        hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+        na_tcp_complete(na_tcp_op_id, NA_HOSTUNREACH);
+    }
+
+    /* Connection can be reused */
+    hg_thread_mutex_lock(&priv->conn_list.lock);
+    HG_QUEUE_PUSH_TAIL(&priv->conn_list.free_queue, conn, free_entry);
+    hg_thread_mutex_unlock(&priv->conn_list.lock);
+
+    if (na_tcp_addr)
+        na_tcp_addr_decref(na_tcp_addr);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_post(struct na_tcp_class *priv, struct na_tcp_addr *na_tcp_addr,
+    struct na_tcp_send *send, struct na_tcp_op_id *rma_op_id)
+{
+    struct na_tcp_send *done = NULL;
+    struct na_tcp_conn *conn;
+    na_return_t ret = NA_SUCCESS;
+
+    for (;;) {
+        hg_thread_mutex_lock(&na_tcp_addr->lock);
+        conn = na_tcp_addr->conn;
+        if (conn == NULL)
+            ret = na_tcp_conn_connect(priv, na_tcp_addr, &conn);
+        hg_thread_mutex_unlock(&na_tcp_addr->lock);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            msg, out, ret, "Could not connect to peer");
+
+        /* Connection may have been closed and reused concurrently */
+        hg_thread_mutex_lock(&conn->send_lock);
+        if (conn->addr == na_tcp_addr && conn->state != NA_TCP_CONN_CLOSED)
+            break;
+        hg_thread_mutex_unlock(&conn->send_lock);
+
+        hg_thread_mutex_lock(&na_tcp_addr->lock);
+        if (na_tcp_addr->conn == conn)
+            na_tcp_addr->conn = NULL;
+        hg_thread_mutex_unlock(&na_tcp_addr->lock);
+    }
+
+    if (rma_op_id) {
+        rma_op_id->conn = conn;
+        HG_QUEUE_PUSH_TAIL(&conn->rma_queue, rma_op_id, entry);
+        hg_atomic_or32(&rma_op_id->status, NA_TCP_OP_QUEUED);
+    }
+    if (send->op_id)
+        send->op_id->conn = conn;
+    send->offset = 0;
+    send->queued = NA_TRUE;
+    HG_QUEUE_PUSH_TAIL(&conn->send_queue, send, entry);
+
+    /* Write right away unless previous sends are still pending */
+    if (conn->state == NA_TCP_CONN_CONNECTED &&
+        HG_QUEUE_FIRST(&conn->send_queue) == send)
+        na_tcp_conn_flush(priv, conn, &done);
+    hg_thread_mutex_unlock(&conn->send_lock);
+
+    na_tcp_send_done(done);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_conn_flush(struct na_tcp_class *priv, struct na_tcp_conn *conn,
+    struct na_tcp_send **done)
+{
+    struct na_tcp_send **done_tail = done;
+
+    while (*done_tail)
+        done_tail = &(*done_tail)->entry.next;
+
+    while (!HG_QUEUE_IS_EMPTY(&conn->send_queue)) {
+        struct iovec iov[NA_TCP_IOV_MAX];
+        struct msghdr msg;
+        struct na_tcp_send *send;
+        size_t iovcnt = 0;
+        ssize_t nwrite;
+        int flags = MSG_NOSIGNAL;
+
+        /* Gather queued sends, including sends from other handles */
+        HG_QUEUE_FOREACH (send, &conn->send_queue, entry) {
+            size_t skip = send->offset;
+            int i;
+
+            for (i = 0; i < 2 && iovcnt < NA_TCP_IOV_MAX; i++) {
+                if (send->iov[i].iov_len <= skip) {
+                    skip -= send->iov[i].iov_len;
+                    continue;
+                }
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+                /* Only RMA payloads, whose completion requires an ack from
+                 * the peer, can be sent without copy. The kernel keeps
+                 * referencing every iov of a zero-copy send, headers and
+                 * buffers of other sends may be released or reused before
+                 * that, send the payload on its own */
+                if (conn->zcopy && i == 1 &&
+                    send->iov[i].iov_len - skip >= NA_TCP_ZCOPY_SIZE &&
+                    (send->hdr.type == NA_TCP_MSG_PUT ||
+                        send->hdr.type == NA_TCP_MSG_GET_ACK)) {
+                    if (iovcnt == 0) {
+                        iov[0].iov_base = (char *) send->iov[i].iov_base + skip;
+                        iov[0].iov_len = send->iov[i].iov_len - skip;
+                        iovcnt++;
+                        flags |= MSG_ZEROCOPY;
+                    }
+                    break;
+                }
+#endif
+                iov[iovcnt].iov_base = (char *) send->iov[i].iov_base + skip;
+                iov[iovcnt].iov_len = send->iov[i].iov_len - skip;
+                skip = 0;
+                iovcnt++;
+            }
+            if (iovcnt == NA_TCP_IOV_MAX || i < 2)
+                break;
+        }
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovcnt;
+        nwrite = sendmsg(conn->fd, &msg, flags);
+        if (nwrite < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+            if (errno == ENOBUFS && (flags & MSG_ZEROCOPY)) {
+                /* Out of locked memory, fall back to copies */
+                conn->zcopy = NA_FALSE;
+                continue;
+            }
+#endif
+            /* Operations are failed once the connection is closed */
+            NA_LOG_SUBSYS_ERROR(
+                msg, "sendmsg() failed (%s)", strerror(errno));
+            (void) shutdown(conn->fd, SHUT_RDWR);
+            break;
+        }
+
+        /* Pop sends that were fully written */
+        while (nwrite > 0) {
+            size_t len;
+
+            send = HG_QUEUE_FIRST(&conn->send_queue);
+            len = MIN((size_t) nwrite, send->size - send->offset);
+            send->offset += len;
+            nwrite -= (ssize_t) len;
+            if (send->offset < send->size)
+                break;
+
+            HG_QUEUE_POP_HEAD(&conn->send_queue, entry);
+            send->queued = NA_FALSE;
+
+            /* RMA op IDs complete once acknowledged and may be reused as
+             * soon as the lock is released, do not keep them */
+            if (send->allocated ||
+                (send->op_id && (send->hdr.type == NA_TCP_MSG_UNEXPECTED ||
+                                    send->hdr.type == NA_TCP_MSG_EXPECTED))) {
+                send->entry.next = NULL;
+                *done_tail = send;
+                done_tail = &send->entry.next;
+            }
+        }
+    }
+
+    na_tcp_conn_poll_set(
+        priv, conn, (na_bool_t) !HG_QUEUE_IS_EMPTY(&conn->send_queue));
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_send_done(struct na_tcp_send *done)
+{
+    while (done) {
+        struct na_tcp_send *send = done;
+
+        done = send->entry.next;
+        if (send->allocated)
+            free(send);
+        else
+            na_tcp_complete(send->op_id, NA_SUCCESS);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_tcp_op_id *
+na_tcp_conn_rma_remove(struct na_tcp_conn *conn, na_uint64_t cookie)
+{
+    struct na_tcp_op_id *na_tcp_op_id;
+
+    hg_thread_mutex_lock(&conn->send_lock);
+    HG_QUEUE_FOREACH (na_tcp_op_id, &conn->rma_queue, entry) {
+        if (na_tcp_op_id->info.rma.cookie == cookie) {
+            HG_QUEUE_REMOVE(
+                &conn->rma_queue, na_tcp_op_id, na_tcp_op_id, entry);
+            hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+            break;
+        }
+    }
+    hg_thread_mutex_unlock(&conn->send_lock);
+
+    return na_tcp_op_id;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rma_ack(struct na_tcp_class *priv, struct na_tcp_conn *conn,
+    na_tcp_msg_type_t type, na_return_t status, na_uint64_t cookie, void *buf,
+    na_size_t len, na_uint64_t value)
+{
+    struct na_tcp_send *send;
+    na_return_t ret;
+
+    send = (struct na_tcp_send *) calloc(1, sizeof(*send));
+    NA_CHECK_SUBSYS_ERROR(rma, send == NULL, out, ret, NA_NOMEM,
+        "Could not allocate RMA ack");
+    send->hdr.type = (na_uint8_t) type;
+    send->hdr.status = (na_uint8_t) status;
+    send->hdr.len = (status == NA_SUCCESS) ? len : 0;
+    send->hdr.offset = value;
+    send->hdr.cookie = cookie;
+    send->iov[0].iov_base = &send->hdr;
+    send->iov[0].iov_len = sizeof(send->hdr);
+    send->iov[1].iov_base = buf;
+    send->iov[1].iov_len = (size_t) send->hdr.len;
+    send->size = sizeof(send->hdr) + (size_t) send->hdr.len;
+    send->allocated = NA_TRUE;
+
+    /* Reply on the connection the request came from */
+    hg_thread_mutex_lock(&conn->send_lock);
+    if (conn->state == NA_TCP_CONN_CLOSED) {
+        hg_thread_mutex_unlock(&conn->send_lock);
+        free(send);
+        NA_GOTO_SUBSYS_ERROR(
+            rma, out, ret, NA_HOSTUNREACH, "Connection was closed");
+    }
+    send->queued = NA_TRUE;
+    HG_QUEUE_PUSH_TAIL(&conn->send_queue, send, entry);
+    if (conn->state == NA_TCP_CONN_CONNECTED &&
+        HG_QUEUE_FIRST(&conn->send_queue) == send) {
+        struct na_tcp_send *done = NULL;
+
+        na_tcp_conn_flush(priv, conn, &done);
+        hg_thread_mutex_unlock(&conn->send_lock);
+        na_tcp_send_done(done);
+    } else
+        hg_thread_mutex_unlock(&conn->send_lock);
+
+    ret = NA_SUCCESS;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_lookup(struct na_tcp_class *priv, const struct na_tcp_hdr *hdr,
+    na_bool_t write, void **buf)
+{
+    struct na_tcp_mem_handle *na_tcp_mem_handle;
+    na_uint64_t id = hdr->handle;
+    na_return_t ret = NA_SUCCESS;
+
+    hg_thread_rwlock_rdlock(&priv->mem_map.lock);
+    na_tcp_mem_handle = (struct na_tcp_mem_handle *) hg_hash_table_lookup(
+        priv->mem_map.map, (hg_hash_table_key_t) &id);
+    NA_CHECK_SUBSYS_ERROR(rma, na_tcp_mem_handle == NULL, unlock, ret,
+        NA_INVALID_ARG, "Memory handle %" PRIu64 " is not registered", id);
+    NA_CHECK_SUBSYS_ERROR(rma,
+        hdr->offset > na_tcp_mem_handle->len ||
+            hdr->len > na_tcp_mem_handle->len - hdr->offset,
+        unlock, ret, NA_OVERFLOW, "RMA exceeds registered region");
+    NA_CHECK_SUBSYS_ERROR(rma,
+        write && na_tcp_mem_handle->flags == NA_MEM_READ_ONLY, unlock, ret,
+        NA_PERMISSION, "Registered memory requires write permission");
+
+    *buf = (char *) na_tcp_mem_handle->base + hdr->offset;
+
+unlock:
+    hg_thread_rwlock_release_rdlock(&priv->mem_map.lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_recv(
+    struct na_tcp_class *priv, struct na_tcp_conn *conn, na_bool_t *progressed)
+{
+    struct na_tcp_rx *rx = &conn->rx;
+    na_return_t ret = NA_SUCCESS;
+    int i;
+
+    /* Another thread is already reading */
+    if (hg_thread_mutex_try_lock(&conn->recv_lock) != HG_UTIL_SUCCESS)
+        return NA_SUCCESS;
+    if (conn->state == NA_TCP_CONN_CLOSED)
+        goto unlock;
+
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    /* Discard zero-copy completions, RMA completion is acknowledged by the
+     * peer once it received the data */
+    if (conn->zcopy) {
+        char control[128];
+        struct msghdr msg;
+
+        do {
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+        } while (recvmsg(conn->fd, &msg, MSG_ERRQUEUE) >= 0);
+    }
+#endif
+
+    for (i = 0; i < NA_TCP_RX_MAX; i++) {
+        struct iovec iov[2];
+        int iovcnt = 0;
+        ssize_t nread;
+
+        ret = na_tcp_conn_rx_process(priv, conn);
+        if (ret != NA_SUCCESS)
+            goto close;
+
+        /* Large payloads are read directly into their destination, data
+         * that follows goes into the receive buffer */
+        if (rx->payload && rx->len < rx->buf_len &&
+            conn->rx_start == conn->rx_end) {
+            iov[iovcnt].iov_base = rx->buf + rx->len;
+            iov[iovcnt].iov_len = rx->buf_len - rx->len;
+            iovcnt++;
+        }
+        if (conn->rx_start > 0) {
+            memmove(conn->rx_buf, conn->rx_buf + conn->rx_start,
+                conn->rx_end - conn->rx_start);
+            conn->rx_end -= conn->rx_start;
+            conn->rx_start = 0;
+        }
+        iov[iovcnt].iov_base = conn->rx_buf + conn->rx_end;
+        iov[iovcnt].iov_len = NA_TCP_RX_BUF_SIZE - conn->rx_end;
+        iovcnt++;
+
+        nread = readv(conn->fd, iov, iovcnt);
+        if (nread < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            NA_LOG_SUBSYS_WARNING(addr, "readv() failed (%s), closing "
+                "connection", strerror(errno));
+            goto close;
+        }
+        if (nread == 0) {
+            NA_LOG_SUBSYS_DEBUG(addr, "Connection closed by peer");
+            goto close;
+        }
+        *progressed = NA_TRUE;
+
+        if (iovcnt == 2) {
+            size_t len = MIN((size_t) nread, iov[0].iov_len);
+
+            rx->len += len;
+            nread -= (ssize_t) len;
+        }
+        conn->rx_end += (size_t) nread;
+    }
+
+    ret = na_tcp_conn_rx_process(priv, conn);
+    if (ret != NA_SUCCESS)
+        goto close;
+
+unlock:
+    hg_thread_mutex_unlock(&conn->recv_lock);
+
+    return NA_SUCCESS;
+
+close:
+    na_tcp_conn_close(priv, conn);
+    hg_thread_mutex_unlock(&conn->recv_lock);
+    *progressed = NA_TRUE;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_rx_process(struct na_tcp_class *priv, struct na_tcp_conn *conn)
+{
+    struct na_tcp_rx *rx = &conn->rx;
+    na_return_t ret = NA_SUCCESS;
+
+    for (;;) {
+        size_t avail = conn->rx_end - conn->rx_start;
+
+        if (!rx->payload) {
+            size_t len = MIN(avail, sizeof(rx->hdr) - rx->hdr_len);
+
+            memcpy((char *) &rx->hdr + rx->hdr_len,
+                conn->rx_buf + conn->rx_start, len);
+            rx->hdr_len += len;
+            conn->rx_start += len;
+            avail -= len;
+            if (rx->hdr_len < sizeof(rx->hdr))
+                break;
+
+            ret = na_tcp_rx_hdr(priv, conn);
+            NA_CHECK_SUBSYS_NA_ERROR(msg, out, ret, "Could not process header");
+            rx->payload = NA_TRUE;
+        }
+
+        if (rx->len < rx->hdr.len) {
+            size_t len = MIN(avail, (size_t) (rx->hdr.len - rx->len));
+
+            if (len == 0)
+                break;
+
+            /* Keep what fits into the destination, drop the rest */
+            if (rx->len < rx->buf_len)
+                memcpy(rx->buf + rx->len, conn->rx_buf + conn->rx_start,
+                    MIN(len, rx->buf_len - rx->len));
+            rx->len += len;
+            conn->rx_start += len;
+        }
+
+        if (rx->len == rx->hdr.len) {
+            ret = na_tcp_rx_done(priv, conn);
+            NA_CHECK_SUBSYS_NA_ERROR(msg, out, ret, "Could not process msg");
+        }
+    }
+
+    if (conn->rx_start == conn->rx_end)
+        conn->rx_start = conn->rx_end = 0;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rx_hdr(struct na_tcp_class *priv, struct na_tcp_conn *conn)
+{
+    struct na_tcp_rx *rx = &conn->rx;
+    struct na_tcp_hdr *hdr = &rx->hdr;
+    struct na_tcp_op_id *na_tcp_op_id = NULL;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(msg,
+        hdr->type != NA_TCP_MSG_HELLO && conn->addr == NULL, out, ret,
+        NA_PROTOCOL_ERROR, "Peer did not send its address");
+
+    switch (hdr->type) {
+        case NA_TCP_MSG_HELLO: {
+            struct na_tcp_addr *na_tcp_addr = NULL;
+
+            NA_CHECK_SUBSYS_ERROR(msg, conn->addr != NULL || hdr->len != 0,
+                out, ret, NA_PROTOCOL_ERROR, "Unexpected HELLO msg");
+
+            ret = na_tcp_addr_resolve(priv, hdr->tag, hdr->port, &na_tcp_addr);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                addr, out, ret, "Could not resolve peer address");
+
+            hg_thread_mutex_lock(&conn->send_lock);
+            conn->addr = na_tcp_addr;
+            hg_thread_mutex_unlock(&conn->send_lock);
+
+            /* Reply on that connection unless we already connected to peer */
+            hg_thread_mutex_lock(&na_tcp_addr->lock);
+            if (na_tcp_addr->conn == NULL)
+                na_tcp_addr->conn = conn;
+            hg_thread_mutex_unlock(&na_tcp_addr->lock);
+            break;
+        }
+        case NA_TCP_MSG_UNEXPECTED: {
+            struct na_tcp_unexpected_queue *unexpected_queue =
+                &priv->unexpected_queue;
+
+            NA_CHECK_SUBSYS_ERROR(msg, hdr->len > priv->unexpected_size_max,
+                out, ret, NA_PROTOCOL_ERROR,
+                "Unexpected msg exceeds max size (%" PRIu64 ")", hdr->len);
+
+            hg_thread_spin_lock(&unexpected_queue->lock);
+            na_tcp_op_id = HG_QUEUE_FIRST(&unexpected_queue->op_queue);
+            if (na_tcp_op_id) {
+                HG_QUEUE_POP_HEAD(&unexpected_queue->op_queue, entry);
+                hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+            }
+            hg_thread_spin_unlock(&unexpected_queue->lock);
+
+            if (na_tcp_op_id) {
+                hg_atomic_incr32_relaxed(&conn->addr->ref_count);
+                na_tcp_op_id->addr = conn->addr;
+                rx->op_id = na_tcp_op_id;
+                rx->buf = na_tcp_op_id->info.msg.buf.ptr;
+                rx->buf_len =
+                    MIN((size_t) hdr->len, na_tcp_op_id->info.msg.buf_size);
+            } else {
+                /* Keep a copy until a recv is posted */
+                rx->unexpected = (struct na_tcp_unexpected_info *) malloc(
+                    sizeof(struct na_tcp_unexpected_info) + hdr->len);
+                NA_CHECK_SUBSYS_ERROR(msg, rx->unexpected == NULL, out, ret,
+                    NA_NOMEM, "Could not allocate unexpected info");
+                hg_atomic_incr32_relaxed(&conn->addr->ref_count);
+                rx->unexpected->addr = conn->addr;
+                rx->unexpected->buf_size = (na_size_t) hdr->len;
+                rx->unexpected->tag = (na_tag_t) hdr->tag;
+                rx->buf = rx->unexpected->buf;
+                rx->buf_len = (size_t) hdr->len;
+            }
+            break;
+        }
+        case NA_TCP_MSG_EXPECTED: {
+            struct na_tcp_op_queue *expected_op_queue =
+                &priv->expected_op_queue;
+
+            /* Try to match addr/tag, addresses removed from the map may
+             * have been looked up again and use a different object */
+            hg_thread_spin_lock(&expected_op_queue->lock);
+            HG_QUEUE_FOREACH (na_tcp_op_id, &expected_op_queue->queue, entry) {
+                if (na_tcp_op_id->addr->key == conn->addr->key &&
+                    na_tcp_op_id->info.msg.tag == hdr->tag) {
+                    HG_QUEUE_REMOVE(&expected_op_queue->queue, na_tcp_op_id,
+                        na_tcp_op_id, entry);
+                    hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+                    break;
+                }
+            }
+            hg_thread_spin_unlock(&expected_op_queue->lock);
+
+            if (na_tcp_op_id == NULL) {
+                /* Payload is dropped */
+                NA_LOG_SUBSYS_ERROR(msg,
+                    "No expected recv posted for tag %" PRIu32, hdr->tag);
+                break;
+            }
+            NA_CHECK_SUBSYS_WARNING(msg,
+                hdr->len > na_tcp_op_id->info.msg.buf_size,
+                "Expected msg truncated (%" PRIu64 " > %zu)", hdr->len,
+                na_tcp_op_id->info.msg.buf_size);
+            rx->op_id = na_tcp_op_id;
+            rx->buf = na_tcp_op_id->info.msg.buf.ptr;
+            rx->buf_len =
+                MIN((size_t) hdr->len, na_tcp_op_id->info.msg.buf_size);
+            break;
+        }
+        case NA_TCP_MSG_PUT: {
+            void *buf = NULL;
+
+            /* Payload is dropped on error, status is sent back */
+            rx->status = na_tcp_mem_lookup(priv, hdr, NA_TRUE, &buf);
+            if (rx->status == NA_SUCCESS) {
+                rx->buf = (char *) buf;
+                rx->buf_len = (size_t) hdr->len;
+            }
+            break;
+        }
+        case NA_TCP_MSG_GET: {
+            void *buf = NULL;
+            na_return_t status = na_tcp_mem_lookup(priv, hdr, NA_FALSE, &buf);
+
+            ret = na_tcp_rma_ack(priv, conn, NA_TCP_MSG_GET_ACK, status,
+                hdr->cookie, buf, (na_size_t) hdr->len, 0);
+            NA_CHECK_SUBSYS_NA_ERROR(rma, out, ret, "Could not send GET ack");
+            /* Request carries no payload */
+            hdr->len = 0;
+            break;
+        }
+        case NA_TCP_MSG_ATOMIC:
+            NA_CHECK_SUBSYS_ERROR(rma, hdr->len != sizeof(rx->operands), out,
+                ret, NA_PROTOCOL_ERROR, "Invalid atomic request length");
+            rx->buf = (char *) rx->operands;
+            rx->buf_len = sizeof(rx->operands);
+            break;
+        case NA_TCP_MSG_PUT_ACK:
+        case NA_TCP_MSG_GET_ACK:
+        case NA_TCP_MSG_ATOMIC_ACK:
+            /* Op ID was canceled if not found, payload is then dropped */
+            na_tcp_op_id = na_tcp_conn_rma_remove(conn, hdr->cookie);
+            if (na_tcp_op_id == NULL)
+                break;
+            rx->op_id = na_tcp_op_id;
+            rx->status = (na_return_t) hdr->status;
+            if (hdr->type == NA_TCP_MSG_GET_ACK) {
+                rx->buf = (char *) na_tcp_op_id->info.rma.buf;
+                rx->buf_len =
+                    MIN((size_t) hdr->len, na_tcp_op_id->info.rma.len);
+            }
+            break;
+        default:
+            NA_GOTO_SUBSYS_ERROR(msg, out, ret, NA_PROTOCOL_ERROR,
+                "Invalid msg type (%d)", hdr->type);
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rx_done(struct na_tcp_class *priv, struct na_tcp_conn *conn)
+{
+    struct na_tcp_rx *rx = &conn->rx;
+    struct na_tcp_op_id *na_tcp_op_id = rx->op_id;
+    na_return_t ret = NA_SUCCESS;
+
+    switch (rx->hdr.type) {
+        case NA_TCP_MSG_UNEXPECTED:
+            if (na_tcp_op_id) {
+                na_tcp_op_id->info.msg.actual_buf_size = rx->buf_len;
+                na_tcp_op_id->info.msg.tag = (na_tag_t) rx->hdr.tag;
+                na_tcp_complete(na_tcp_op_id, NA_SUCCESS);
+            } else {
+                struct na_tcp_unexpected_queue *unexpected_queue =
+                    &priv->unexpected_queue;
+                struct na_tcp_unexpected_info *unexpected = rx->unexpected;
+
+                /* A recv may have been posted in the meantime */
+                hg_thread_spin_lock(&unexpected_queue->lock);
+                na_tcp_op_id = HG_QUEUE_FIRST(&unexpected_queue->op_queue);
+                if (na_tcp_op_id) {
+                    HG_QUEUE_POP_HEAD(&unexpected_queue->op_queue, entry);
+                    hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+                } else
+                    HG_QUEUE_PUSH_TAIL(
+                        &unexpected_queue->msg_queue, unexpected, entry);
+                hg_thread_spin_unlock(&unexpected_queue->lock);
+
+                if (na_tcp_op_id) {
+                    na_tcp_op_id->addr = unexpected->addr;
+                    na_tcp_op_id->info.msg.actual_buf_size =
+                        MIN(unexpected->buf_size,
+                            na_tcp_op_id->info.msg.buf_size);
+                    na_tcp_op_id->info.msg.tag = unexpected->tag;
+                    memcpy(na_tcp_op_id->info.msg.buf.ptr, unexpected->buf,
+                        na_tcp_op_id->info.msg.actual_buf_size);
+                    free(unexpected);
+                    na_tcp_complete(na_tcp_op_id, NA_SUCCESS);
+                }
+            }
+            break;
+        case NA_TCP_MSG_EXPECTED:
+            if (na_tcp_op_id) {
+                na_tcp_op_id->info.msg.actual_buf_size = rx->buf_len;
+                na_tcp_complete(na_tcp_op_id, NA_SUCCESS);
+            }
+            break;
+        case NA_TCP_MSG_PUT:
+            ret = na_tcp_rma_ack(priv, conn, NA_TCP_MSG_PUT_ACK, rx->status,
+                rx->hdr.cookie, NULL, 0, 0);
+            NA_CHECK_SUBSYS_NA_ERROR(rma, out, ret, "Could not send PUT ack");
+            break;
+        case NA_TCP_MSG_ATOMIC: {
+            struct na_tcp_hdr hdr = rx->hdr;
+            na_uint64_t prev = 0;
+            void *buf = NULL;
+            na_return_t status;
+
+            /* Operation is applied by the target on behalf of the origin */
+            hdr.len = sizeof(na_uint64_t);
+            status = na_tcp_mem_lookup(priv, &hdr, NA_TRUE, &buf);
+            if (status == NA_SUCCESS && ((na_ptr_t) buf & 7) != 0) {
+                NA_LOG_SUBSYS_ERROR(rma, "Atomic value is not 8-byte aligned");
+                status = NA_INVALID_ARG;
+            }
+            if (status == NA_SUCCESS)
+                prev = na_atomic_host(buf, (na_atomic_op_t) hdr.tag,
+                    rx->operands[0], rx->operands[1]);
+            ret = na_tcp_rma_ack(priv, conn, NA_TCP_MSG_ATOMIC_ACK, status,
+                hdr.cookie, NULL, 0, prev);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                rma, out, ret, "Could not send ATOMIC ack");
+            break;
+        }
+        case NA_TCP_MSG_PUT_ACK:
+        case NA_TCP_MSG_GET_ACK:
+            if (na_tcp_op_id)
+                na_tcp_complete(na_tcp_op_id, rx->status);
+            break;
+        case NA_TCP_MSG_ATOMIC_ACK:
+            if (na_tcp_op_id) {
+                if (rx->status == NA_SUCCESS)
+                    memcpy(na_tcp_op_id->info.rma.buf, &rx->hdr.offset,
+                        sizeof(na_uint64_t));
+                na_tcp_complete(na_tcp_op_id, rx->status);
+            }
+            break;
+        default:
+            break;
+    }
+
+out:
+    memset(rx, 0, sizeof(*rx));
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_conn_send(
+    struct na_tcp_class *priv, struct na_tcp_conn *conn, na_bool_t *progressed)
+{
+    struct na_tcp_send *done = NULL;
+
+    hg_thread_mutex_lock(&conn->send_lock);
+    if (conn->state == NA_TCP_CONN_CONNECTING) {
+        socklen_t len = sizeof(int);
+        int err = 0;
+
+        /* Errors are reported to readers, which close the connection */
+        if (getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &err, &len) == -1 ||
+            err != 0) {
+            hg_thread_mutex_unlock(&conn->send_lock);
+            return;
+        }
+        conn->state = NA_TCP_CONN_CONNECTED;
+    }
+    if (conn->state == NA_TCP_CONN_CONNECTED) {
+        na_tcp_conn_flush(priv, conn, &done);
+        *progressed = NA_TRUE;
+    }
+    hg_thread_mutex_unlock(&conn->send_lock);
+
+    na_tcp_send_done(done);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_accept(struct na_tcp_class *priv, na_bool_t *progressed)
+{
+    for (;;) {
+        struct hg_poll_event event = {.events = HG_POLLIN};
+        struct na_tcp_conn *conn = NULL;
+        na_bool_t zcopy;
+        na_return_t ret;
+        int fd, rc;
+
+        fd = accept(priv->listen_fd, NULL, NULL);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            NA_CHECK_SUBSYS_WARNING(addr,
+                errno != EAGAIN && errno != EWOULDBLOCK,
+                "accept() failed (%s)", strerror(errno));
+            break;
+        }
+        *progressed = NA_TRUE;
+
+        ret = na_tcp_sock_setup(priv, fd, &zcopy);
+        NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not set up socket");
+        ret = na_tcp_conn_get(priv, &conn);
+        NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not get connection");
+
+        /* Peer is identified once its HELLO msg is received */
+        hg_thread_mutex_lock(&conn->send_lock);
+        conn->fd = fd;
+        conn->state = NA_TCP_CONN_CONNECTED;
+        conn->pollout = NA_FALSE;
+        conn->zcopy = zcopy;
+        conn->addr = NULL;
+        event.data.ptr = conn;
+        rc = hg_poll_add(priv->poll_set, fd, &event);
+        if (rc != HG_UTIL_SUCCESS) {
+            conn->state = NA_TCP_CONN_CLOSED;
+            conn->fd = -1;
+            hg_thread_mutex_unlock(&conn->send_lock);
+            NA_GOTO_SUBSYS_ERROR(
+                poll, error, ret, NA_PROTOCOL_ERROR, "hg_poll_add() failed");
+        }
+        hg_thread_mutex_unlock(&conn->send_lock);
+        continue;
+
+error:
+        close(fd);
+        if (conn) {
+            hg_thread_mutex_lock(&priv->conn_list.lock);
+            HG_QUEUE_PUSH_TAIL(&priv->conn_list.free_queue, conn, free_entry);
+            hg_thread_mutex_unlock(&priv->conn_list.lock);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_send(struct na_tcp_class *priv, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg, const void *buf,
+    na_size_t buf_size, struct na_tcp_addr *na_tcp_addr, na_tag_t tag,
+    struct na_tcp_op_id *na_tcp_op_id)
+{
+    na_return_t ret;
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_tcp_op_id == NULL, out, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    na_tcp_op_id->context = context;
+    na_tcp_op_id->completion_data.callback_info.type = cb_type;
+    na_tcp_op_id->completion_data.callback = callback;
+    na_tcp_op_id->completion_data.callback_info.arg = arg;
+    hg_atomic_incr32_relaxed(&na_tcp_addr->ref_count);
+    na_tcp_op_id->addr = na_tcp_addr;
+    hg_atomic_set32(&na_tcp_op_id->status, 0);
+
+    memset(&na_tcp_op_id->send.hdr, 0, sizeof(na_tcp_op_id->send.hdr));
+    na_tcp_op_id->send.hdr.type = (cb_type == NA_CB_SEND_UNEXPECTED)
+                                      ? NA_TCP_MSG_UNEXPECTED
+                                      : NA_TCP_MSG_EXPECTED;
+    na_tcp_op_id->send.hdr.tag = tag;
+    na_tcp_op_id->send.hdr.len = buf_size;
+    na_tcp_op_id->info.msg.buf.const_ptr = buf;
+    na_tcp_op_id->send.iov[1].iov_base = na_tcp_op_id->info.msg.buf.ptr;
+    na_tcp_op_id->send.iov[1].iov_len = buf_size;
+    na_tcp_op_id->send.size = sizeof(struct na_tcp_hdr) + buf_size;
+
+    ret = na_tcp_conn_post(priv, na_tcp_addr, &na_tcp_op_id->send, NULL);
+    NA_CHECK_SUBSYS_NA_ERROR(msg, error, ret, "Could not post msg");
+
+out:
+    return ret;
+
+error:
+    na_tcp_addr_decref(na_tcp_addr);
+    na_tcp_op_id->addr = NULL;
+    hg_atomic_set32(&na_tcp_op_id->status, NA_TCP_OP_COMPLETED);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rma(struct na_tcp_class *priv, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg,
+    struct na_tcp_mem_handle *local_mem_handle, na_offset_t local_offset,
+    struct na_tcp_mem_handle *remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, struct na_tcp_addr *na_tcp_addr,
+    struct na_tcp_op_id *na_tcp_op_id)
+{
+    struct na_tcp_hdr *hdr;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(rma,
+        (cb_type == NA_CB_PUT &&
+            remote_mem_handle->flags == NA_MEM_READ_ONLY) ||
+            (cb_type == NA_CB_GET &&
+                local_mem_handle->flags == NA_MEM_READ_ONLY),
+        out, ret, NA_PERMISSION, "Registered memory requires write permission");
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_tcp_op_id == NULL, out, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    na_tcp_op_id->context = context;
+    na_tcp_op_id->completion_data.callback_info.type = cb_type;
+    na_tcp_op_id->completion_data.callback = callback;
+    na_tcp_op_id->completion_data.callback_info.arg = arg;
+    hg_atomic_incr32_relaxed(&na_tcp_addr->ref_count);
+    na_tcp_op_id->addr = na_tcp_addr;
+    na_tcp_op_id->info.rma.buf = (char *) local_mem_handle->base + local_offset;
+    na_tcp_op_id->info.rma.len = length;
+    na_tcp_op_id->info.rma.cookie =
+        (na_uint64_t) hg_atomic_incr64(&priv->cookie);
+    hg_atomic_set32(&na_tcp_op_id->status, 0);
+
+    /* Data is emulated over the connection, the target completes the
+     * request against its registered region and acknowledges it */
+    hdr = &na_tcp_op_id->send.hdr;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->type = (cb_type == NA_CB_PUT) ? NA_TCP_MSG_PUT : NA_TCP_MSG_GET;
+    hdr->len = length;
+    hdr->handle = remote_mem_handle->id;
+    hdr->offset = remote_offset;
+    hdr->cookie = na_tcp_op_id->info.rma.cookie;
+    if (cb_type == NA_CB_PUT) {
+        na_tcp_op_id->send.iov[1].iov_base = na_tcp_op_id->info.rma.buf;
+        na_tcp_op_id->send.iov[1].iov_len = length;
+        na_tcp_op_id->send.size = sizeof(*hdr) + length;
+    } else {
+        na_tcp_op_id->send.iov[1].iov_base = NULL;
+        na_tcp_op_id->send.iov[1].iov_len = 0;
+        na_tcp_op_id->send.size = sizeof(*hdr);
+    }
+
+    ret = na_tcp_conn_post(
+        priv, na_tcp_addr, &na_tcp_op_id->send, na_tcp_op_id);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, error, ret, "Could not post RMA request");
+
+out:
+    return ret;
+
+error:
+    na_tcp_addr_decref(na_tcp_addr);
+    na_tcp_op_id->addr = NULL;
+    hg_atomic_set32(&na_tcp_op_id->status, NA_TCP_OP_COMPLETED);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_atomic_post(struct na_tcp_class *priv, na_context_t *context,
+    na_cb_t callback, void *arg, na_atomic_op_t op, na_uint64_t operand,
+    na_uint64_t compare, struct na_tcp_mem_handle *local_mem_handle,
+    na_offset_t local_offset, struct na_tcp_mem_handle *remote_mem_handle,
+    na_offset_t remote_offset, struct na_tcp_addr *na_tcp_addr,
+    struct na_tcp_op_id *na_tcp_op_id)
+{
+    struct na_tcp_hdr *hdr;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(rma,
+        remote_mem_handle->flags == NA_MEM_READ_ONLY ||
+            local_mem_handle->flags == NA_MEM_READ_ONLY,
+        out, ret, NA_PERMISSION, "Registered memory requires write permission");
+    NA_CHECK_SUBSYS_ERROR(rma,
+        local_offset > local_mem_handle->len ||
+            sizeof(na_uint64_t) > local_mem_handle->len - local_offset,
+        out, ret, NA_OVERFLOW, "Atomic exceeds local registered region");
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_tcp_op_id == NULL, out, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    na_tcp_op_id->context = context;
+    na_tcp_op_id->completion_data.callback_info.type = NA_CB_ATOMIC;
+    na_tcp_op_id->completion_data.callback = callback;
+    na_tcp_op_id->completion_data.callback_info.arg = arg;
+    hg_atomic_incr32_relaxed(&na_tcp_addr->ref_count);
+    na_tcp_op_id->addr = na_tcp_addr;
+    na_tcp_op_id->info.rma.buf = (char *) local_mem_handle->base + local_offset;
+    na_tcp_op_id->info.rma.len = sizeof(na_uint64_t);
+    na_tcp_op_id->info.rma.cookie =
+        (na_uint64_t) hg_atomic_incr64(&priv->cookie);
+    na_tcp_op_id->info.rma.operands[0] = operand;
+    na_tcp_op_id->info.rma.operands[1] = compare;
+    hg_atomic_set32(&na_tcp_op_id->status, 0);
+
+    /* Target applies the operation to its registered region and sends the
+     * previous value back in the ack */
+    hdr = &na_tcp_op_id->send.hdr;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->type = NA_TCP_MSG_ATOMIC;
+    hdr->tag = (na_uint32_t) op;
+    hdr->len = sizeof(na_tcp_op_id->info.rma.operands);
+    hdr->handle = remote_mem_handle->id;
+    hdr->offset = remote_offset;
+    hdr->cookie = na_tcp_op_id->info.rma.cookie;
+    na_tcp_op_id->send.iov[1].iov_base = na_tcp_op_id->info.rma.operands;
+    na_tcp_op_id->send.iov[1].iov_len = sizeof(na_tcp_op_id->info.rma.operands);
+    na_tcp_op_id->send.size = sizeof(*hdr) + (size_t) hdr->len;
+
+    ret = na_tcp_conn_post(
+        priv, na_tcp_addr, &na_tcp_op_id->send, na_tcp_op_id);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, error, ret, "Could not post atomic request");
+
+out:
+    return ret;
+
+error:
+    na_tcp_addr_decref(na_tcp_addr);
+    na_tcp_op_id->addr = NULL;
+    hg_atomic_set32(&na_tcp_op_id->status, NA_TCP_OP_COMPLETED);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_complete(struct na_tcp_op_id *na_tcp_op_id, na_return_t cb_ret)
+{
+    struct na_cb_info *callback_info = NULL;
+    hg_util_int32_t status;
+
+    /* Mark op id as completed before checking for cancelation */
+    status = hg_atomic_or32(&na_tcp_op_id->status, NA_TCP_OP_COMPLETED);
+
+    /* Init callback info */
+    callback_info = &na_tcp_op_id->completion_data.callback_info;
+    callback_info->ret = cb_ret;
+
+    if (status & NA_TCP_OP_CANCELED)
+        NA_LOG_SUBSYS_DEBUG(op, "Operation ID %p is canceled", na_tcp_op_id);
+
+    switch (callback_info->type) {
+        case NA_CB_RECV_UNEXPECTED:
+            if (callback_info->ret != NA_SUCCESS) {
+                /* In case of cancellation where no recv'd data */
+                callback_info->info.recv_unexpected.actual_buf_size = 0;
+                callback_info->info.recv_unexpected.source = NA_ADDR_NULL;
+                callback_info->info.recv_unexpected.tag = 0;
+            } else {
+                /* Increment addr ref count */
+                hg_atomic_incr32_relaxed(&na_tcp_op_id->addr->ref_count);
+
+                /* Fill callback info */
+                callback_info->info.recv_unexpected.actual_buf_size =
+                    na_tcp_op_id->info.msg.actual_buf_size;
+                callback_info->info.recv_unexpected.source =
+                    (na_addr_t) na_tcp_op_id->addr;
+                callback_info->info.recv_unexpected.tag =
+                    na_tcp_op_id->info.msg.tag;
+            }
+            break;
+        case NA_CB_RECV_EXPECTED:
+            callback_info->info.recv_expected.actual_buf_size =
+                (callback_info->ret == NA_SUCCESS)
+                    ? na_tcp_op_id->info.msg.actual_buf_size
+                    : 0;
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+        case NA_CB_SEND_EXPECTED:
+        case NA_CB_PUT:
+        case NA_CB_GET:
+        case NA_CB_ATOMIC:
+            break;
+        default:
+            NA_LOG_SUBSYS_ERROR(
+                op, "Operation type %d not supported", callback_info->type);
+            break;
+    }
+
+    /* Add OP to NA completion queue */
+    na_cb_completion_add(na_tcp_op_id->context, &na_tcp_op_id->completion_data);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_release(void *arg)
+{
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) arg;
+
+    NA_CHECK_SUBSYS_WARNING(op,
+        na_tcp_op_id &&
+            (!(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED)),
+        "Releasing resources from an uncompleted operation");
+
+    if (na_tcp_op_id->addr) {
+        na_tcp_addr_decref(na_tcp_op_id->addr);
+        na_tcp_op_id->addr = NULL;
+    }
+}
+
+/********************/
+/* Plugin callbacks */
+/********************/
+
+static na_bool_t
+na_tcp_check_protocol(const char *protocol_name)
+{
+    return (strcmp(protocol_name, "tcp") == 0) ? NA_TRUE : NA_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_initialize(na_class_t *na_class, const struct na_info *na_info,
+    na_bool_t NA_UNUSED listening)
+{
+    struct na_tcp_class *priv = NULL;
+    struct sockaddr_in sin;
+    socklen_t sin_len = sizeof(sin);
+    struct hg_poll_event event = {.events = HG_POLLIN};
+    struct in_addr self_ip;
+    na_uint16_t port = 0;
+    char *host = NULL;
+    na_bool_t auto_msg_size;
+    na_return_t ret = NA_SUCCESS;
+    int one = 1, rc;
+
+    priv = (struct na_tcp_class *) calloc(1, sizeof(struct na_tcp_class));
+    NA_CHECK_SUBSYS_ERROR(cls, priv == NULL, error, ret, NA_NOMEM,
+        "Could not allocate NA private data class");
+    na_class->plugin_class = priv;
+    priv->listen_fd = -1;
+    priv->listen_poll_type = NA_TCP_POLL_LISTEN;
+    priv->no_wait = (na_class->progress_mode & NA_NO_BLOCK) ? NA_TRUE
+                                                            : NA_FALSE;
+    priv->zcopy = NA_TRUE;
+    hg_atomic_init64(&priv->mem_id, 0);
+    hg_atomic_init64(&priv->cookie, 0);
+
+    /* Init locks and queues */
+    HG_QUEUE_INIT(&priv->unexpected_queue.op_queue);
+    HG_QUEUE_INIT(&priv->unexpected_queue.msg_queue);
+    hg_thread_spin_init(&priv->unexpected_queue.lock);
+    HG_QUEUE_INIT(&priv->expected_op_queue.queue);
+    hg_thread_spin_init(&priv->expected_op_queue.lock);
+    hg_thread_rwlock_init(&priv->addr_map.lock);
+    hg_thread_rwlock_init(&priv->mem_map.lock);
+    HG_LIST_INIT(&priv->conn_list.list);
+    HG_QUEUE_INIT(&priv->conn_list.free_queue);
+    hg_thread_mutex_init(&priv->conn_list.lock);
+
+    /* Msg sizes (when auto-tuned, msgs are eager until RMA is zero-copy) */
+    auto_msg_size =
+        na_info->na_init_info && na_info->na_init_info->auto_msg_size;
+    priv->unexpected_size_max =
+        (na_info->na_init_info && na_info->na_init_info->max_unexpected_size)
+            ? na_info->na_init_info->max_unexpected_size
+            : (auto_msg_size ? NA_TCP_ZCOPY_SIZE : NA_TCP_UNEXPECTED_SIZE);
+    priv->expected_size_max =
+        (na_info->na_init_info && na_info->na_init_info->max_expected_size)
+            ? na_info->na_init_info->max_expected_size
+            : (auto_msg_size ? NA_TCP_ZCOPY_SIZE : NA_TCP_EXPECTED_SIZE);
+
+    priv->op_slab = na_op_slab_create(sizeof(struct na_tcp_op_id));
+    NA_CHECK_SUBSYS_ERROR(cls, priv->op_slab == NULL, error, ret, NA_NOMEM,
+        "Could not create op ID slab");
+
+    priv->addr_map.map = hg_hash_table_new(na_tcp_key_hash, na_tcp_key_equal);
+    NA_CHECK_SUBSYS_ERROR(cls, priv->addr_map.map == NULL, error, ret,
+        NA_NOMEM, "Could not allocate address map");
+    priv->mem_map.map = hg_hash_table_new(na_tcp_key_hash, na_tcp_key_equal);
+    NA_CHECK_SUBSYS_ERROR(cls, priv->mem_map.map == NULL, error, ret,
+        NA_NOMEM, "Could not allocate memory handle map");
+
+    priv->poll_set = hg_poll_create();
+    NA_CHECK_SUBSYS_ERROR(cls, priv->poll_set == NULL, error, ret,
+        NA_PROTOCOL_ERROR, "Could not create poll set");
+
+    /* Host name is [host][:port], listen on all interfaces otherwise */
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (na_info->host_name && *na_info->host_name != '\0') {
+        char *port_str;
+
+        host = strdup(na_info->host_name);
+        NA_CHECK_SUBSYS_ERROR(cls, host == NULL, error, ret, NA_NOMEM,
+            "Could not duplicate host name");
+        port_str = strrchr(host, ':');
+        if (port_str) {
+            *port_str++ = '\0';
+            port = (na_uint16_t) atoi(port_str);
+        }
+        if (*host != '\0') {
+            ret = na_tcp_host_resolve(host, &sin.sin_addr);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                cls, error, ret, "Could not resolve %s", host);
+        }
+    }
+    sin.sin_port = htons(port);
+
+    /* Always listen, peers reply to and reconnect to that address */
+    priv->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    NA_CHECK_SUBSYS_ERROR(cls, priv->listen_fd == -1, error, ret,
+        na_tcp_errno_to_na(errno), "socket() failed (%s)", strerror(errno));
+    (void) setsockopt(
+        priv->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    rc = fcntl(priv->listen_fd, F_SETFL,
+        fcntl(priv->listen_fd, F_GETFL, 0) | O_NONBLOCK);
+    NA_CHECK_SUBSYS_ERROR(cls, rc == -1, error, ret, na_tcp_errno_to_na(errno),
+        "fcntl() failed (%s)", strerror(errno));
+    (void) fcntl(priv->listen_fd, F_SETFD, FD_CLOEXEC);
+
+    rc = bind(priv->listen_fd, (struct sockaddr *) &sin, sizeof(sin));
+    NA_CHECK_SUBSYS_ERROR(cls, rc == -1, error, ret, na_tcp_errno_to_na(errno),
+        "bind() failed (%s)", strerror(errno));
+    rc = listen(priv->listen_fd, SOMAXCONN);
+    NA_CHECK_SUBSYS_ERROR(cls, rc == -1, error, ret, na_tcp_errno_to_na(errno),
+        "listen() failed (%s)", strerror(errno));
+    rc = getsockname(priv->listen_fd, (struct sockaddr *) &sin, &sin_len);
+    NA_CHECK_SUBSYS_ERROR(cls, rc == -1, error, ret, na_tcp_errno_to_na(errno),
+        "getsockname() failed (%s)", strerror(errno));
+
+    event.data.ptr = &priv->listen_poll_type;
+    rc = hg_poll_add(priv->poll_set, priv->listen_fd, &event);
+    NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret,
+        NA_PROTOCOL_ERROR, "hg_poll_add() failed");
+
+    /* Advertise address of local host when listening on all interfaces */
+    self_ip = sin.sin_addr;
+    if (self_ip.s_addr == htonl(INADDR_ANY)) {
+        char hostname[256];
+
+        if (gethostname(hostname, sizeof(hostname)) != 0 ||
+            na_tcp_host_resolve(hostname, &self_ip) != NA_SUCCESS)
+            self_ip.s_addr = htonl(INADDR_LOOPBACK);
+    }
+
+    ret = na_tcp_addr_resolve(
+        priv, self_ip.s_addr, sin.sin_port, &priv->self_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not create self address");
+    priv->self_addr->self = NA_TRUE;
+
+    free(host);
+
+    return ret;
+
+error:
+    free(host);
+    if (priv)
+        na_tcp_finalize(na_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_finalize(na_class_t *na_class)
+{
+    struct na_tcp_class *priv = NA_TCP_CLASS(na_class);
+    struct na_tcp_unexpected_info *unexpected;
+    struct na_tcp_conn *conn;
+    na_return_t ret = NA_SUCCESS;
+
+    if (!priv)
+        goto out;
+
+    NA_CHECK_SUBSYS_ERROR(cls,
+        !HG_QUEUE_IS_EMPTY(&priv->unexpected_queue.op_queue), out, ret,
+        NA_BUSY, "Unexpected op queue should be empty");
+    NA_CHECK_SUBSYS_ERROR(cls,
+        !HG_QUEUE_IS_EMPTY(&priv->expected_op_queue.queue), out, ret, NA_BUSY,
+        "Expected op queue should be empty");
+
+    /* Close connections, which release their addresses */
+    HG_LIST_FOREACH (conn, &priv->conn_list.list, entry) {
+        hg_thread_mutex_lock(&conn->recv_lock);
+        na_tcp_conn_close(priv, conn);
+        hg_thread_mutex_unlock(&conn->recv_lock);
+    }
+    while ((conn = HG_LIST_FIRST(&priv->conn_list.list))) {
+        HG_LIST_REMOVE(conn, entry);
+        hg_thread_mutex_destroy(&conn->send_lock);
+        hg_thread_mutex_destroy(&conn->recv_lock);
+        free(conn->rx_buf);
+        free(conn);
+    }
+
+    while ((unexpected = HG_QUEUE_FIRST(&priv->unexpected_queue.msg_queue))) {
+        HG_QUEUE_POP_HEAD(&priv->unexpected_queue.msg_queue, entry);
+        na_tcp_addr_decref(unexpected->addr);
+        free(unexpected);
+    }
+
+    /* Release addresses held by map */
+    if (priv->addr_map.map) {
+        hg_hash_table_iter_t iter;
+
+        hg_hash_table_iterate(priv->addr_map.map, &iter);
+        while (hg_hash_table_iter_has_more(&iter))
+            na_tcp_addr_decref(
+                (struct na_tcp_addr *) hg_hash_table_iter_next(&iter));
+        hg_hash_table_free(priv->addr_map.map);
+    }
+    if (priv->self_addr)
+        na_tcp_addr_decref(priv->self_addr);
+    if (priv->mem_map.map)
+        hg_hash_table_free(priv->mem_map.map);
+
+    if (priv->listen_fd != -1) {
+        if (priv->poll_set)
+            (void) hg_poll_remove(priv->poll_set, priv->listen_fd);
+        close(priv->listen_fd);
+    }
+    if (priv->poll_set)
+        hg_poll_destroy(priv->poll_set);
+    if (priv->op_slab)
+        na_op_slab_destroy(priv->op_slab);
+
+    hg_thread_spin_destroy(&priv->unexpected_queue.lock);
+    hg_thread_spin_destroy(&priv->expected_op_queue.lock);
+    hg_thread_rwlock_destroy(&priv->addr_map.lock);
+    hg_thread_rwlock_destroy(&priv->mem_map.lock);
+    hg_thread_mutex_destroy(&priv->conn_list.lock);
+    free(priv);
+    na_class->plugin_class = NULL;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_op_id_t *
+na_tcp_op_create(na_class_t *na_class)
+{
+    struct na_tcp_op_id *na_tcp_op_id = NULL;
+
+    na_tcp_op_id = (struct na_tcp_op_id *) na_op_slab_alloc(
+        NA_TCP_CLASS(na_class)->op_slab);
+    NA_CHECK_SUBSYS_ERROR_NORET(op, na_tcp_op_id == NULL, out,
+        "Could not allocate NA TCP operation ID");
+    memset(na_tcp_op_id, 0, sizeof(struct na_tcp_op_id));
+
+    na_tcp_op_id->send.op_id = na_tcp_op_id;
+    na_tcp_op_id->send.iov[0].iov_base = &na_tcp_op_id->send.hdr;
+    na_tcp_op_id->send.iov[0].iov_len = sizeof(struct na_tcp_hdr);
+
+    /* Completed by default */
+    hg_atomic_init32(&na_tcp_op_id->status, NA_TCP_OP_COMPLETED);
+
+    /* Set op ID release callbacks */
+    na_tcp_op_id->completion_data.plugin_callback = na_tcp_release;
+    na_tcp_op_id->completion_data.plugin_callback_args = na_tcp_op_id;
+
+out:
+    return (na_op_id_t *) na_tcp_op_id;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_op_destroy(na_class_t *na_class, na_op_id_t *op_id)
+{
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to free OP ID that was not completed");
+
+    na_op_slab_free(NA_TCP_CLASS(na_class)->op_slab, na_tcp_op_id);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr)
+{
+    struct na_tcp_addr *na_tcp_addr = NULL;
+    struct in_addr in_addr;
+    char *host = NULL, *port_str;
+    const char *ptr = strstr(name, "://");
+    na_return_t ret = NA_SUCCESS;
+    long port;
+
+    /* Name is [tcp://]host:port */
+    host = strdup((ptr) ? ptr + strlen("://") : name);
+    NA_CHECK_SUBSYS_ERROR(addr, host == NULL, out, ret, NA_NOMEM,
+        "Could not duplicate name");
+    port_str = strrchr(host, ':');
+    NA_CHECK_SUBSYS_ERROR(addr, port_str == NULL, out, ret, NA_INVALID_ARG,
+        "Malformed address %s", name);
+    *port_str++ = '\0';
+    port = strtol(port_str, NULL, 10);
+    NA_CHECK_SUBSYS_ERROR(addr, port <= 0 || port > UINT16_MAX, out, ret,
+        NA_INVALID_ARG, "Invalid port in %s", name);
+
+    ret = na_tcp_host_resolve(host, &in_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, out, ret, "Could not resolve %s", name);
+
+    ret = na_tcp_addr_resolve(NA_TCP_CLASS(na_class), in_addr.s_addr,
+        htons((na_uint16_t) port), &na_tcp_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, out, ret, "Could not resolve %s", name);
+
+    *addr = (na_addr_t) na_tcp_addr;
+
+out:
+    free(host);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_free(na_class_t NA_UNUSED *na_class, na_addr_t addr)
+{
+    if (addr)
+        na_tcp_addr_decref((struct na_tcp_addr *) addr);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_set_remove(na_class_t *na_class, na_addr_t addr)
+{
+    struct na_tcp_map *na_tcp_map = &NA_TCP_CLASS(na_class)->addr_map;
+    struct na_tcp_addr *na_tcp_addr = (struct na_tcp_addr *) addr;
+    na_bool_t removed = NA_FALSE;
+
+    if (na_tcp_addr->self)
+        return NA_SUCCESS;
+
+    hg_thread_rwlock_wrlock(&na_tcp_map->lock);
+    if (hg_hash_table_lookup(na_tcp_map->map,
+            (hg_hash_table_key_t) &na_tcp_addr->key) == na_tcp_addr)
+        removed = (hg_hash_table_remove(na_tcp_map->map,
+                       (hg_hash_table_key_t) &na_tcp_addr->key) != 0);
+    hg_thread_rwlock_release_wrlock(&na_tcp_map->lock);
+
+    /* Release reference held by map */
+    if (removed)
+        na_tcp_addr_decref(na_tcp_addr);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_warmup(na_class_t *na_class, na_addr_t addr)
+{
+    struct na_tcp_addr *na_tcp_addr = (struct na_tcp_addr *) addr;
+    struct na_tcp_conn *conn;
+    na_return_t ret = NA_SUCCESS;
+
+    if (na_tcp_addr->self)
+        return NA_SUCCESS;
+
+    /* Connect is non-blocking, hello is sent once connection completes */
+    hg_thread_mutex_lock(&na_tcp_addr->lock);
+    if (na_tcp_addr->conn == NULL)
+        ret = na_tcp_conn_connect(NA_TCP_CLASS(na_class), na_tcp_addr, &conn);
+    hg_thread_mutex_unlock(&na_tcp_addr->lock);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, done, ret, "Could not connect to peer");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_self(na_class_t *na_class, na_addr_t *addr)
+{
+    struct na_tcp_addr *self_addr = NA_TCP_CLASS(na_class)->self_addr;
+
+    hg_atomic_incr32_relaxed(&self_addr->ref_count);
+    *addr = (na_addr_t) self_addr;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_dup(
+    na_class_t NA_UNUSED *na_class, na_addr_t addr, na_addr_t *new_addr)
+{
+    hg_atomic_incr32_relaxed(&((struct na_tcp_addr *) addr)->ref_count);
+    *new_addr = addr;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_tcp_addr_cmp(
+    na_class_t NA_UNUSED *na_class, na_addr_t addr1, na_addr_t addr2)
+{
+    return ((struct na_tcp_addr *) addr1)->key ==
+           ((struct na_tcp_addr *) addr2)->key;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_tcp_addr_is_self(na_class_t NA_UNUSED *na_class, na_addr_t addr)
+{
+    return ((struct na_tcp_addr *) addr)->self;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_to_string(na_class_t NA_UNUSED *na_class, char *buf,
+    na_size_t *buf_size, na_addr_t addr)
+{
+    struct na_tcp_addr *na_tcp_addr = (struct na_tcp_addr *) addr;
+    char ip[INET_ADDRSTRLEN], addr_string[INET_ADDRSTRLEN + 16];
+    na_size_t string_len;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(addr,
+        inet_ntop(AF_INET, &na_tcp_addr->sin.sin_addr, ip, sizeof(ip)) == NULL,
+        out, ret, NA_PROTOCOL_ERROR, "inet_ntop() failed (%s)",
+        strerror(errno));
+    snprintf(addr_string, sizeof(addr_string), "tcp://%s:%u", ip,
+        (unsigned int) ntohs(na_tcp_addr->sin.sin_port));
+
+    string_len = strlen(addr_string);
+    if (buf) {
+        NA_CHECK_SUBSYS_ERROR(addr, string_len >= *buf_size, out, ret,
+            NA_OVERFLOW, "Buffer size too small to copy addr");
+        strcpy(buf, addr_string);
+    }
+    *buf_size = string_len + 1;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_size_t
+na_tcp_addr_get_serialize_size(
+    na_class_t NA_UNUSED *na_class, na_addr_t NA_UNUSED addr)
+{
+    return sizeof(na_uint32_t) + sizeof(na_uint16_t);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_serialize(na_class_t NA_UNUSED *na_class, void *buf,
+    na_size_t buf_size, na_addr_t addr)
+{
+    struct na_tcp_addr *na_tcp_addr = (struct na_tcp_addr *) addr;
+    char *buf_ptr = (char *) buf;
+    na_size_t buf_size_left = buf_size;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left,
+        &na_tcp_addr->sin.sin_addr.s_addr, na_uint32_t);
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left, &na_tcp_addr->sin.sin_port,
+        na_uint16_t);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_deserialize(na_class_t *na_class, na_addr_t *addr,
+    const void *buf, na_size_t buf_size)
+{
+    struct na_tcp_addr *na_tcp_addr = NULL;
+    const char *buf_ptr = (const char *) buf;
+    na_size_t buf_size_left = buf_size;
+    na_uint32_t ip;
+    na_uint16_t port;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_DECODE(out, ret, buf_ptr, buf_size_left, &ip, na_uint32_t);
+    NA_DECODE(out, ret, buf_ptr, buf_size_left, &port, na_uint16_t);
+
+    ret = na_tcp_addr_resolve(NA_TCP_CLASS(na_class), ip, port, &na_tcp_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, out, ret, "Could not resolve address");
+
+    *addr = (na_addr_t) na_tcp_addr;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_size_t
+na_tcp_msg_get_max_unexpected_size(const na_class_t *na_class)
+{
+    return NA_TCP_CLASS(na_class)->unexpected_size_max;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_size_t
+na_tcp_msg_get_max_expected_size(const na_class_t *na_class)
+{
+    return NA_TCP_CLASS(na_class)->expected_size_max;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_tag_t
+na_tcp_msg_get_max_tag(const na_class_t NA_UNUSED *na_class)
+{
+    return NA_TCP_MAX_TAG;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t dest_addr,
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+{
+    struct na_tcp_class *priv = NA_TCP_CLASS(na_class);
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size > priv->unexpected_size_max, out, ret,
+        NA_OVERFLOW, "Exceeds unexpected size, %zu", buf_size);
+
+    ret = na_tcp_msg_send(priv, context, NA_CB_SEND_UNEXPECTED, callback, arg,
+        buf, buf_size, (struct na_tcp_addr *) dest_addr, tag,
+        (struct na_tcp_op_id *) op_id);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void NA_UNUSED *plugin_data, na_op_id_t *op_id)
+{
+    struct na_tcp_unexpected_queue *unexpected_queue =
+        &NA_TCP_CLASS(na_class)->unexpected_queue;
+    struct na_tcp_unexpected_info *unexpected;
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(msg,
+        buf_size > NA_TCP_CLASS(na_class)->unexpected_size_max, out, ret,
+        NA_OVERFLOW, "Exceeds unexpected size, %zu", buf_size);
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_tcp_op_id == NULL, out, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    na_tcp_op_id->context = context;
+    na_tcp_op_id->completion_data.callback_info.type = NA_CB_RECV_UNEXPECTED;
+    na_tcp_op_id->completion_data.callback = callback;
+    na_tcp_op_id->completion_data.callback_info.arg = arg;
+    na_tcp_op_id->addr = NULL;
+    na_tcp_op_id->info.msg.buf.ptr = buf;
+    na_tcp_op_id->info.msg.buf_size = buf_size;
+    na_tcp_op_id->info.msg.actual_buf_size = 0;
+    na_tcp_op_id->info.msg.tag = 0;
+    hg_atomic_set32(&na_tcp_op_id->status, 0);
+
+    /* Look for an unexpected message already received */
+    hg_thread_spin_lock(&unexpected_queue->lock);
+    unexpected = HG_QUEUE_FIRST(&unexpected_queue->msg_queue);
+    if (unexpected)
+        HG_QUEUE_POP_HEAD(&unexpected_queue->msg_queue, entry);
+    else {
+        HG_QUEUE_PUSH_TAIL(&unexpected_queue->op_queue, na_tcp_op_id, entry);
+        hg_atomic_or32(&na_tcp_op_id->status, NA_TCP_OP_QUEUED);
+    }
+    hg_thread_spin_unlock(&unexpected_queue->lock);
+
+    if (unexpected) {
+        na_tcp_op_id->addr = unexpected->addr;
+        na_tcp_op_id->info.msg.actual_buf_size =
+            MIN(unexpected->buf_size, buf_size);
+        na_tcp_op_id->info.msg.tag = unexpected->tag;
+        memcpy(buf, unexpected->buf, na_tcp_op_id->info.msg.actual_buf_size);
+        free(unexpected);
+
+        na_tcp_complete(na_tcp_op_id, NA_SUCCESS);
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_send_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t dest_addr,
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+{
+    struct na_tcp_class *priv = NA_TCP_CLASS(na_class);
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size > priv->expected_size_max, out, ret,
+        NA_OVERFLOW, "Exceeds expected size, %zu", buf_size);
+
+    ret = na_tcp_msg_send(priv, context, NA_CB_SEND_EXPECTED, callback, arg,
+        buf, buf_size, (struct na_tcp_addr *) dest_addr, tag,
+        (struct na_tcp_op_id *) op_id);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_recv_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t source_addr,
+    na_uint16_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
+{
+    struct na_tcp_op_queue *expected_op_queue =
+        &NA_TCP_CLASS(na_class)->expected_op_queue;
+    struct na_tcp_addr *na_tcp_addr = (struct na_tcp_addr *) source_addr;
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(msg,
+        buf_size > NA_TCP_CLASS(na_class)->expected_size_max, out, ret,
+        NA_OVERFLOW, "Exceeds expected size, %zu", buf_size);
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_tcp_op_id == NULL, out, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    na_tcp_op_id->context = context;
+    na_tcp_op_id->completion_data.callback_info.type = NA_CB_RECV_EXPECTED;
+    na_tcp_op_id->completion_data.callback = callback;
+    na_tcp_op_id->completion_data.callback_info.arg = arg;
+    hg_atomic_incr32_relaxed(&na_tcp_addr->ref_count);
+    na_tcp_op_id->addr = na_tcp_addr;
+    na_tcp_op_id->info.msg.buf.ptr = buf;
+    na_tcp_op_id->info.msg.buf_size = buf_size;
+    na_tcp_op_id->info.msg.actual_buf_size = 0;
+    na_tcp_op_id->info.msg.tag = tag;
+    hg_atomic_set32(&na_tcp_op_id->status, 0);
+
+    /* Expected msgs must be posted before the peer sends them */
+    hg_thread_spin_lock(&expected_op_queue->lock);
+    HG_QUEUE_PUSH_TAIL(&expected_op_queue->queue, na_tcp_op_id, entry);
+    hg_atomic_or32(&na_tcp_op_id->status, NA_TCP_OP_QUEUED);
+    hg_thread_spin_unlock(&expected_op_queue->lock);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_handle_create(na_class_t NA_UNUSED *na_class, void *buf,
+    na_size_t buf_size, unsigned long flags, na_mem_handle_t *mem_handle)
+{
+    struct na_tcp_mem_handle *na_tcp_mem_handle = NULL;
+    na_return_t ret = NA_SUCCESS;
+
+    na_tcp_mem_handle = (struct na_tcp_mem_handle *) calloc(
+        1, sizeof(struct na_tcp_mem_handle));
+    NA_CHECK_SUBSYS_ERROR(mem, na_tcp_mem_handle == NULL, out, ret, NA_NOMEM,
+        "Could not allocate NA TCP memory handle");
+
+    na_tcp_mem_handle->base = (na_ptr_t) buf;
+    na_tcp_mem_handle->len = (na_uint64_t) buf_size;
+    na_tcp_mem_handle->flags = (na_uint8_t) (flags & 0xff);
+
+    *mem_handle = (na_mem_handle_t) na_tcp_mem_handle;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_handle_free(
+    na_class_t NA_UNUSED *na_class, na_mem_handle_t mem_handle)
+{
+    free(mem_handle);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_tcp_map *mem_map = &NA_TCP_CLASS(na_class)->mem_map;
+    struct na_tcp_mem_handle *na_tcp_mem_handle =
+        (struct na_tcp_mem_handle *) mem_handle;
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    /* Peers address registered regions by ID */
+    na_tcp_mem_handle->id =
+        (na_uint64_t) hg_atomic_incr64(&NA_TCP_CLASS(na_class)->mem_id);
+
+    hg_thread_rwlock_wrlock(&mem_map->lock);
+    rc = hg_hash_table_insert(mem_map->map,
+        (hg_hash_table_key_t) &na_tcp_mem_handle->id,
+        (hg_hash_table_value_t) na_tcp_mem_handle);
+    hg_thread_rwlock_release_wrlock(&mem_map->lock);
+    NA_CHECK_SUBSYS_ERROR(mem, rc == 0, out, ret, NA_NOMEM,
+        "hg_hash_table_insert() failed");
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_tcp_map *mem_map = &NA_TCP_CLASS(na_class)->mem_map;
+    struct na_tcp_mem_handle *na_tcp_mem_handle =
+        (struct na_tcp_mem_handle *) mem_handle;
+
+    hg_thread_rwlock_wrlock(&mem_map->lock);
+    (void) hg_hash_table_remove(
+        mem_map->map, (hg_hash_table_key_t) &na_tcp_mem_handle->id);
+    hg_thread_rwlock_release_wrlock(&mem_map->lock);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_size_t
+na_tcp_mem_handle_get_serialize_size(
+    na_class_t NA_UNUSED *na_class, na_mem_handle_t NA_UNUSED mem_handle)
+{
+    return sizeof(na_ptr_t) + 2 * sizeof(na_uint64_t) + sizeof(na_uint8_t);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_handle_serialize(na_class_t NA_UNUSED *na_class, void *buf,
+    na_size_t buf_size, na_mem_handle_t mem_handle)
+{
+    struct na_tcp_mem_handle *na_tcp_mem_handle =
+        (struct na_tcp_mem_handle *) mem_handle;
+    char *buf_ptr = (char *) buf;
+    na_size_t buf_size_left = buf_size;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->base,
+        na_ptr_t);
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->len,
+        na_uint64_t);
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->id,
+        na_uint64_t);
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->flags,
+        na_uint8_t);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
+    na_mem_handle_t *mem_handle, const void *buf, na_size_t buf_size)
+{
+    struct na_tcp_mem_handle *na_tcp_mem_handle = NULL;
+    const char *buf_ptr = (const char *) buf;
+    na_size_t buf_size_left = buf_size;
+    na_return_t ret = NA_SUCCESS;
+
+    na_tcp_mem_handle = (struct na_tcp_mem_handle *) malloc(
+        sizeof(struct na_tcp_mem_handle));
+    NA_CHECK_SUBSYS_ERROR(mem, na_tcp_mem_handle == NULL, error, ret,
+        NA_NOMEM, "Could not allocate NA TCP memory handle");
+
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->base,
+        na_ptr_t);
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->len,
+        na_uint64_t);
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->id,
+        na_uint64_t);
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->flags,
+        na_uint8_t);
+
+    *mem_handle = (na_mem_handle_t) na_tcp_mem_handle;
+
+    return ret;
+
+error:
+    free(na_tcp_mem_handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
+    na_op_id_t *op_id)
+{
+    return na_tcp_rma(NA_TCP_CLASS(na_class), context, NA_CB_PUT, callback,
+        arg, (struct na_tcp_mem_handle *) local_mem_handle, local_offset,
+        (struct na_tcp_mem_handle *) remote_mem_handle, remote_offset, length,
+        (struct na_tcp_addr *) remote_addr, (struct na_tcp_op_id *) op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
+    na_op_id_t *op_id)
+{
+    return na_tcp_rma(NA_TCP_CLASS(na_class), context, NA_CB_GET, callback,
+        arg, (struct na_tcp_mem_handle *) local_mem_handle, local_offset,
+        (struct na_tcp_mem_handle *) remote_mem_handle, remote_offset, length,
+        (struct na_tcp_addr *) remote_addr, (struct na_tcp_op_id *) op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, na_uint64_t operand, na_uint64_t compare,
+    na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id, na_op_id_t *op_id)
+{
+    return na_tcp_atomic_post(NA_TCP_CLASS(na_class), context, callback, arg,
+        op, operand, compare, (struct na_tcp_mem_handle *) local_mem_handle,
+        local_offset, (struct na_tcp_mem_handle *) remote_mem_handle,
+        remote_offset, (struct na_tcp_addr *) remote_addr,
+        (struct na_tcp_op_id *) op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+na_tcp_poll_get_fd(na_class_t *na_class, na_context_t NA_UNUSED *context)
+{
+    struct na_tcp_class *priv = NA_TCP_CLASS(na_class);
+    int fd;
+
+    if (priv->no_wait)
+        return -1;
+
+    fd = hg_poll_get_fd(priv->poll_set);
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        poll, fd == -1, out, "Could not get poll fd from poll set");
+
+out:
+    return fd;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_tcp_poll_try_wait(
+    na_class_t NA_UNUSED *na_class, na_context_t NA_UNUSED *context)
+{
+    /* Buffered data is always processed before returning from progress,
+     * anything left is a partial msg that requires more data */
+    return NA_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_progress(
+    na_class_t *na_class, na_context_t NA_UNUSED *context, unsigned int timeout)
+{
+    struct na_tcp_class *priv = NA_TCP_CLASS(na_class);
+    /* Convert timeout in ms into seconds */
+    double remaining = timeout / 1000.0;
+    na_return_t ret;
+
+    do {
+        struct hg_poll_event events[NA_TCP_MAX_EVENTS];
+        unsigned int nevents = 0, i;
+        na_bool_t progressed = NA_FALSE;
+        hg_time_t t1, t2;
+        int rc;
+
+        if (timeout)
+            hg_time_get_current_ms(&t1);
+
+        rc = hg_poll_wait(priv->poll_set,
+            (priv->no_wait) ? 0 : (unsigned int) (remaining * 1000.0),
+            NA_TCP_MAX_EVENTS, events, &nevents);
+        NA_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
+            na_tcp_errno_to_na(errno), "hg_poll_wait() failed");
+
+        for (i = 0; i < nevents; i++) {
+            struct na_tcp_conn *conn;
+
+            if (events[i].events & HG_POLLINTR)
+                continue;
+
+            if (*(na_tcp_poll_type_t *) events[i].data.ptr ==
+                NA_TCP_POLL_LISTEN) {
+                na_tcp_accept(priv, &progressed);
+                continue;
+            }
+
+            conn = (struct na_tcp_conn *) events[i].data.ptr;
+            if (events[i].events & HG_POLLOUT)
+                na_tcp_conn_send(priv, conn, &progressed);
+            if (events[i].events & (HG_POLLIN | HG_POLLERR | HG_POLLHUP)) {
+                ret = na_tcp_conn_recv(priv, conn, &progressed);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    poll, error, ret, "Could not receive from connection");
+            }
+        }
+
+        if (progressed)
+            return NA_SUCCESS;
+
+        if (timeout) {
+            hg_time_get_current_ms(&t2);
+            remaining -= hg_time_diff(t2, t1);
+        }
+    } while ((int) (remaining * 1000.0) > 0);
+
+    return NA_TIMEOUT;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_cancel(
+    na_class_t *na_class, na_context_t NA_UNUSED *context, na_op_id_t *op_id)
+{
+    struct na_tcp_class *priv = NA_TCP_CLASS(na_class);
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+    na_bool_t canceled = NA_FALSE;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Exit if op has already completed */
+    if (hg_atomic_or32(&na_tcp_op_id->status, NA_TCP_OP_CANCELED) &
+        NA_TCP_OP_COMPLETED)
+        goto out;
+
+    NA_LOG_SUBSYS_DEBUG(op, "Canceling operation ID %p", na_tcp_op_id);
+
+    switch (na_tcp_op_id->completion_data.callback_info.type) {
+        case NA_CB_RECV_UNEXPECTED:
+            hg_thread_spin_lock(&priv->unexpected_queue.lock);
+            if (hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_QUEUED) {
+                HG_QUEUE_REMOVE(&priv->unexpected_queue.op_queue, na_tcp_op_id,
+                    na_tcp_op_id, entry);
+                hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+                canceled = NA_TRUE;
+            }
+            hg_thread_spin_unlock(&priv->unexpected_queue.lock);
+            break;
+        case NA_CB_RECV_EXPECTED:
+            hg_thread_spin_lock(&priv->expected_op_queue.lock);
+            if (hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_QUEUED) {
+                HG_QUEUE_REMOVE(&priv->expected_op_queue.queue, na_tcp_op_id,
+                    na_tcp_op_id, entry);
+                hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+                canceled = NA_TRUE;
+            }
+            hg_thread_spin_unlock(&priv->expected_op_queue.lock);
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+        case NA_CB_SEND_EXPECTED:
+        case NA_CB_PUT:
+        case NA_CB_GET:
+        case NA_CB_ATOMIC: {
+            struct na_tcp_conn *conn = na_tcp_op_id->conn;
+            struct na_tcp_send *send = &na_tcp_op_id->send;
+
+            if (conn == NULL)
+                break;
+
+            /* Sends that were partially written cannot be canceled, RMA ops
+             * can be canceled once their request was written */
+            hg_thread_mutex_lock(&conn->send_lock);
+            if (send->queued && send->offset == 0) {
+                HG_QUEUE_REMOVE(
+                    &conn->send_queue, send, na_tcp_send, entry);
+                send->queued = NA_FALSE;
+            }
+            if (!send->queued) {
+                if (hg_atomic_get32(&na_tcp_op_id->status) &
+                    NA_TCP_OP_QUEUED) {
+                    HG_QUEUE_REMOVE(
+                        &conn->rma_queue, na_tcp_op_id, na_tcp_op_id, entry);
+                    hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+                    canceled = NA_TRUE;
+                } else if (send->hdr.type == NA_TCP_MSG_UNEXPECTED ||
+                           send->hdr.type == NA_TCP_MSG_EXPECTED)
+                    canceled = !(hg_atomic_get32(&na_tcp_op_id->status) &
+                                 NA_TCP_OP_COMPLETED);
+            }
+            hg_thread_mutex_unlock(&conn->send_lock);
+            break;
+        }
+        default:
+            NA_GOTO_SUBSYS_ERROR(op, out, ret, NA_INVALID_ARG,
+                "Operation type %d not supported",
+                na_tcp_op_id->completion_data.callback_info.type);
+    }
+
+    if (canceled)
+        na_tcp_complete(na_tcp_op_id, NA_CANCELED);
+
+out:
+    return ret;
+}
@@ -36,15 +36,51 @@ struct na_init_info {
     na_size_t max_unexpected_size; /* Max unexpected size hint */
     na_size_t max_expected_size;   /* Max expected size hint */
     na_uint32_t progress_mode;     /* Progress mode */
-    na_uint8_t max_contexts;       /* Max contexts */
+    na_uint16_t max_contexts;      /* Max contexts */
+    na_uint8_t multi_recv_count;   /* Multi-recv buffers (0 to disable) */
+    na_bool_t shared_recv;         /* Share unexpected recvs across contexts */
+    na_uint32_t max_peers;         /* Max number of peers hint (SM only) */
+    na_uint32_t mr_cache_size;     /* Max unused cached MRs (OFI only) */
+    na_uint8_t thread_mode;        /* Thread mode */
+    na_int32_t numa_node;          /* NUMA node of resources and threads */
+    const char *discovery_cache;   /* Node-local discovery cache dir (OFI) */
+    na_bool_t request_mem_device;  /* Request support for device memory */
+    na_bool_t auto_msg_size;       /* Derive msg sizes from transport */
+    na_uint32_t rma_cq_budget;     /* RMA events per progress on separate CQ
+                                      (OFI only, 0 to share CQ) */
+    na_bool_t stage_rma;           /* Stage RMA through shared memory instead
+                                      of accessing peers (SM only) */
 };
 
+/* Memory types */
+typedef enum na_mem_type {
+    NA_MEM_TYPE_UNKNOWN, /*!< unknown memory type (host) */
+    NA_MEM_TYPE_HOST,    /*!< host memory */
+    NA_MEM_TYPE_CUDA,    /*!< NVIDIA CUDA device memory */
+    NA_MEM_TYPE_ROCM,    /*!< AMD ROCm device memory */
+    NA_MEM_TYPE_ZE       /*!< Intel Level Zero device memory */
+} na_mem_type_t;
+
 /* Segment */
 struct na_segment {
     na_ptr_t base; /* Address of the segment */
     na_size_t len; /* Size of the segment in bytes */
 };
 
+/* Context statistics */
+struct na_context_stats {
+    na_uint32_t completion_count; /* Entries in completion queue */
+    na_uint32_t backfill_count;   /* Entries in backfill queue */
+};
+
+/* Usage of a plugin resource (see NA_Get_resource_stats()) */
+#define NA_RESOURCE_NAME_MAX (32)
+struct na_resource_stats {
+    char name[NA_RESOURCE_NAME_MAX]; /* Resource name */
+    na_uint64_t used;                /* Resources in use */
+    na_uint64_t max;                 /* Resource limit (0 if unknown) */
+};
+
 /* Return codes:
  * Functions return 0 for success or corresponding return code */
 #define NA_RETURN_VALUES                                                       \
@@ -83,9 +119,17 @@ typedef enum na_cb_type {
     NA_CB_SEND_EXPECTED,   /*!< expected send callback */
     NA_CB_RECV_EXPECTED,   /*!< expected recv callback */
     NA_CB_PUT,             /*!< put callback */
-    NA_CB_GET              /*!< get callback */
+    NA_CB_GET,             /*!< get callback */
+    NA_CB_ATOMIC           /*!< atomic callback */
 } na_cb_type_t;
 
+/* Atomic operation on 64-bit remote memory (see NA_Atomic()) */
+typedef enum na_atomic_op {
+    NA_ATOMIC_FETCH_ADD,    /*!< add operand, fetch previous value */
+    NA_ATOMIC_COMPARE_SWAP, /*!< swap with operand if equal to compare */
+    NA_ATOMIC_SWAP          /*!< swap with operand */
+} na_atomic_op_t;
+
 /* Callback info structs */
 struct na_cb_info_recv_unexpected {
     na_size_t actual_buf_size;
@@ -93,10 +137,15 @@ struct na_cb_info_recv_unexpected {
     na_tag_t tag;
 };
 
+struct na_cb_info_recv_expected {
+    na_size_t actual_buf_size;
+};
+
 /* Callback info struct */
 struct na_cb_info {
     union { /* Union of callback info structures */
         struct na_cb_info_recv_unexpected recv_unexpected;
+        struct na_cb_info_recv_expected recv_expected;
     } info;
     void *arg;         /* User data */
     na_cb_type_t type; /* Callback type */
@@ -106,6 +155,12 @@ struct na_cb_info {
 /* Callback type */
 typedef int (*na_cb_t)(const struct na_cb_info *callback_info);
 
+/* Completion sink type (see NA_Context_set_completion_sink()) */
+typedef void (*na_cb_sink_t)(void *arg, void *completion);
+
+/* Retry callback type (see NA_Context_set_retry_callback()) */
+typedef void (*na_cb_retry_t)(void *arg, na_cb_type_t type);
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -119,7 +174,7 @@ typedef int (*na_cb_t)(const struct na_cb_info *callback_info);
 
 /* Context ID max value
  * \remark This is not the user limit but only the limit imposed by the type */
-#define NA_CONTEXT_ID_MAX UINT8_MAX
+#define NA_CONTEXT_ID_MAX UINT16_MAX
 
 /* Tag max value
  * \remark This is not the user limit but only the limit imposed by the type */
@@ -132,13 +187,22 @@ typedef int (*na_cb_t)(const struct na_cb_info *callback_info);
 #define NA_MEM_READWRITE  0x03
 
 /* Progress modes */
-#define NA_NO_BLOCK 0x01 /*!< no blocking progress */
-#define NA_NO_RETRY 0x02 /*!< no retry of operations in progress */
+#define NA_NO_BLOCK       0x01 /*!< no blocking progress */
+#define NA_NO_RETRY       0x02 /*!< no retry of operations in progress */
+#define NA_NOTIFY_ON_WAIT 0x04 /*!< only notify waiting peers (SM only) */
+
+/* Thread modes */
+#define NA_THREAD_MODE_SINGLE_CTX 0x01 /*!< one thread per context (OFI only) */
+
+/* NUMA nodes (see na_init_info.numa_node) */
+#define NA_NUMA_NODE_ANY    (-1) /*!< no NUMA placement */
+#define NA_NUMA_NODE_DEVICE (-2) /*!< node of the network device */
 
 /* NA init info initializer */
 #define NA_INIT_INFO_INITIALIZER                                               \
     {                                                                          \
-        NULL, NULL, 0, 0, 0, 1                                                 \
+        NULL, NULL, 0, 0, 0, 1, 0, NA_FALSE, 0, 0, 0, NA_NUMA_NODE_ANY, NULL,  \
+            NA_FALSE, NA_FALSE, 0, NA_FALSE                                    \
     }
 
 #endif /* NA_TYPES_H */
@@ -0,0 +1,2377 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "na_plugin.h"
+
+#include "mercury_hash_table.h"
+#include "mercury_thread_rwlock.h"
+#include "mercury_thread_spin.h"
+#include "mercury_time.h"
+
+#include <ucp/api/ucp.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Default msg sizes (UCX has no limit, messages switch to rendezvous) */
+#define NA_UCX_UNEXPECTED_SIZE (4096)
+#define NA_UCX_EXPECTED_SIZE   NA_UCX_UNEXPECTED_SIZE
+
+/* Max size of a worker address carried by a connection message */
+#define NA_UCX_CONN_SIZE_MAX (4096)
+
+/* Tag layout (64 bits):
+ * unexpected (1) - connection (1) - sender ID (30) - NA tag (32)
+ * UCP tag matching does not filter on the source, the sender ID, derived
+ * from the sender's worker address, is used for that purpose and to
+ * retrieve the source address of unexpected messages. */
+#define NA_UCX_TAG_UNEXPECTED (1ULL << 63)
+#define NA_UCX_TAG_CONN       (1ULL << 62)
+#define NA_UCX_TAG_FLAGS      (NA_UCX_TAG_UNEXPECTED | NA_UCX_TAG_CONN)
+#define NA_UCX_ID_SHIFT       (32)
+#define NA_UCX_ID_MASK        (0x3fffffffULL)
+#define NA_UCX_TAG_MASK       (0xffffffffULL)
+#define NA_UCX_TAG_ALL        (~0ULL)
+#define NA_UCX_TAG(flags, id, tag)                                             \
+    ((ucp_tag_t) (flags) |                                                     \
+        (((ucp_tag_t) (id) &NA_UCX_ID_MASK) << NA_UCX_ID_SHIFT) |              \
+        ((ucp_tag_t) (tag) &NA_UCX_TAG_MASK))
+#define NA_UCX_TAG_ID(ucp_tag)                                                 \
+    ((na_uint32_t) (((ucp_tag) >> NA_UCX_ID_SHIFT) & NA_UCX_ID_MASK))
+
+/* Max tag */
+#define NA_UCX_MAX_TAG ((na_tag_t) NA_UCX_TAG_MASK)
+
+/* Op ID status bits */
+#define NA_UCX_OP_COMPLETED (1 << 0)
+#define NA_UCX_OP_CANCELED  (1 << 1)
+#define NA_UCX_OP_QUEUED    (1 << 2)
+
+#define NA_UCX_CLASS(na_class)                                                 \
+    ((struct na_ucx_class *) (na_class->plugin_class))
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Address */
+struct na_ucx_addr {
+    ucp_ep_h ucp_ep;                  /* Endpoint to peer */
+    ucp_worker_h ucp_worker;          /* Worker of endpoint */
+    void *worker_addr;                /* Worker address of peer */
+    size_t worker_addr_len;           /* Worker address length */
+    na_uint32_t id;                   /* Sender ID of peer */
+    hg_atomic_int32_t ref_count;      /* Ref count */
+    hg_atomic_int32_t conn_sent;      /* Our worker address was sent */
+    na_bool_t self;                   /* Boolean for self */
+};
+
+/* Remote key unpacked for a given endpoint */
+struct na_ucx_rkey {
+    struct na_ucx_rkey *next; /* Next rkey */
+    ucp_ep_h ucp_ep;          /* Endpoint used to unpack rkey */
+    ucp_rkey_h ucp_rkey;      /* Remote key */
+};
+
+/* Memory handle */
+struct na_ucx_mem_handle {
+    na_ptr_t base;             /* Base address of region */
+    na_uint64_t len;           /* Size of region */
+    ucp_mem_h ucp_memh;        /* Local registration */
+    void *rkey_buf;            /* Packed remote key */
+    na_uint64_t rkey_buf_size; /* Packed remote key size */
+    struct na_ucx_rkey *rkeys; /* Cache of unpacked remote keys */
+    hg_thread_spin_t rkey_lock; /* Lock of rkey cache */
+    na_uint8_t flags;          /* Flag of operation access */
+    na_bool_t remote;          /* Deserialized from a peer */
+};
+
+/* Msg info */
+struct na_ucx_msg_info {
+    union {
+        const void *const_ptr;
+        void *ptr;
+    } buf;
+    na_size_t buf_size;
+    na_size_t actual_buf_size;
+    na_tag_t tag;
+    ucp_tag_recv_info_t tag_info; /* Info of immediate recv completion */
+};
+
+/* Operation ID */
+struct na_ucx_op_id {
+    struct na_cb_completion_data completion_data; /* Completion data */
+    struct na_ucx_msg_info msg;                   /* Msg info */
+    HG_QUEUE_ENTRY(na_ucx_op_id) entry;           /* Entry in queue */
+    struct na_ucx_class *priv;                    /* NA UCX class */
+    na_context_t *context;                        /* NA context associated */
+    struct na_ucx_addr *addr;                     /* Address associated */
+    void *request;                                /* UCP request */
+    hg_thread_spin_t lock;                        /* Lock of UCP request */
+    hg_atomic_int32_t status;                     /* Operation status */
+    na_bool_t released;                           /* Resources released */
+};
+
+/* Worker address received from a peer */
+struct na_ucx_conn {
+    HG_QUEUE_ENTRY(na_ucx_conn) entry; /* Entry in queue */
+    na_uint32_t id;                    /* Sender ID of peer */
+    size_t worker_addr_len;            /* Worker address length */
+    char worker_addr[];                /* Worker address */
+};
+
+/* Op ID queue */
+struct na_ucx_op_queue {
+    HG_QUEUE_HEAD(na_ucx_op_id) queue;
+    hg_thread_spin_t lock;
+};
+
+/* Connection queue */
+struct na_ucx_conn_queue {
+    HG_QUEUE_HEAD(na_ucx_conn) queue;
+    hg_thread_spin_t lock;
+};
+
+/* Map (used to cache addresses) */
+struct na_ucx_map {
+    hg_thread_rwlock_t lock;
+    hg_hash_table_t *map;
+};
+
+/* Context */
+struct na_ucx_context {
+    na_uint16_t id; /* Context ID */
+};
+
+/* Class */
+struct na_ucx_class {
+    struct na_ucx_map addr_map;               /* Address map */
+    struct na_ucx_op_queue pending_op_queue;  /* Recvs from unknown peers */
+    struct na_ucx_conn_queue conn_queue;      /* Received worker addresses */
+    ucp_tag_recv_info_t conn_tag_info;        /* Conn recv info */
+    struct na_op_slab *op_slab;               /* Slab of op IDs */
+    ucp_context_h ucp_context;                /* UCP context */
+    ucp_worker_h ucp_worker;                  /* UCP worker */
+    struct na_ucx_addr *src_addr;             /* Source address */
+    void *conn_buf;                           /* Conn recv buffer */
+    void *conn_request;                       /* Conn recv request */
+    char *protocol_name;                      /* Protocol used */
+    na_size_t unexpected_size_max;            /* Max unexpected size */
+    na_size_t expected_size_max;              /* Max expected size */
+    hg_atomic_int32_t conn_repost;            /* Conn recv must be reposted */
+    int efd;                                  /* Worker event fd */
+    na_bool_t no_wait;                        /* Busy-spin progress */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Convert UCS status to NA return value.
+ */
+static na_return_t
+na_ucx_status_to_na(ucs_status_t status);
+
+/**
+ * Compute sender ID of a worker address.
+ */
+static na_uint32_t
+na_ucx_addr_id(const void *worker_addr, size_t worker_addr_len);
+
+/**
+ * Key hash for hash table.
+ */
+static NA_INLINE unsigned int
+na_ucx_addr_key_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare key.
+ */
+static NA_INLINE int
+na_ucx_addr_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Lookup addr from map (returned addr is ref counted).
+ */
+static NA_INLINE struct na_ucx_addr *
+na_ucx_addr_map_lookup(struct na_ucx_map *na_ucx_map, na_uint32_t id);
+
+/**
+ * Resolve worker address into addr, addr is created and inserted into map
+ * if it does not exist yet (returned addr is ref counted).
+ */
+static na_return_t
+na_ucx_addr_resolve(struct na_ucx_class *priv, const void *worker_addr,
+    size_t worker_addr_len, struct na_ucx_addr **addr);
+
+/**
+ * Create new address and endpoint.
+ */
+static na_return_t
+na_ucx_addr_create(struct na_ucx_class *priv, const void *worker_addr,
+    size_t worker_addr_len, na_bool_t self, struct na_ucx_addr **addr);
+
+/**
+ * Decrement ref count and destroy address once it reaches 0.
+ */
+static void
+na_ucx_addr_decref(struct na_ucx_addr *na_ucx_addr);
+
+/**
+ * Endpoint error handler.
+ */
+static void
+na_ucx_ep_err_cb(void *arg, ucp_ep_h ep, ucs_status_t status);
+
+/**
+ * Send our worker address to peer before the first message sent to it.
+ */
+static na_return_t
+na_ucx_addr_connect(struct na_ucx_class *priv, struct na_ucx_addr *na_ucx_addr);
+
+/**
+ * Post recv of connection messages.
+ */
+static na_return_t
+na_ucx_conn_post(struct na_ucx_class *priv);
+
+/**
+ * Queue worker address received from a peer.
+ */
+static void
+na_ucx_conn_recv(struct na_ucx_class *priv, ucs_status_t status,
+    const ucp_tag_recv_info_t *tag_info);
+
+/**
+ * Process worker addresses received from peers.
+ */
+static na_return_t
+na_ucx_conn_process(struct na_ucx_class *priv, na_bool_t *progressed);
+
+/**
+ * Conn recv callback.
+ */
+static void
+na_ucx_conn_recv_cb(void *request, ucs_status_t status,
+    const ucp_tag_recv_info_t *tag_info, void *user_data);
+
+/**
+ * Send / RMA callback.
+ */
+static void
+na_ucx_send_cb(void *request, ucs_status_t status, void *user_data);
+
+/**
+ * Recv callback.
+ */
+static void
+na_ucx_recv_cb(void *request, ucs_status_t status,
+    const ucp_tag_recv_info_t *tag_info, void *user_data);
+
+/**
+ * Process completed recv.
+ */
+static void
+na_ucx_recv_process(struct na_ucx_op_id *na_ucx_op_id, ucs_status_t status,
+    const ucp_tag_recv_info_t *tag_info);
+
+/**
+ * Attach UCP request to op ID, request is freed once op ID is released.
+ */
+static NA_INLINE void
+na_ucx_op_set_request(struct na_ucx_op_id *na_ucx_op_id, void *request);
+
+/**
+ * Get remote key of memory handle for a given endpoint.
+ */
+static na_return_t
+na_ucx_rkey_get(struct na_ucx_mem_handle *na_ucx_mem_handle, ucp_ep_h ucp_ep,
+    ucp_rkey_h *ucp_rkey);
+
+/**
+ * Post put / get.
+ */
+static na_return_t
+na_ucx_rma(struct na_ucx_class *priv, na_context_t *context, na_cb_type_t type,
+    na_cb_t callback, void *arg, struct na_ucx_mem_handle *local_mem_handle,
+    na_offset_t local_offset, struct na_ucx_mem_handle *remote_mem_handle,
+    na_offset_t remote_offset, na_size_t length, struct na_ucx_addr *addr,
+    struct na_ucx_op_id *na_ucx_op_id);
+
+/**
+ * Post tagged send.
+ */
+static na_return_t
+na_ucx_msg_send(struct na_ucx_class *priv, na_context_t *context,
+    na_cb_type_t type, na_cb_t callback, void *arg, const void *buf,
+    na_size_t buf_size, struct na_ucx_addr *na_ucx_addr, ucp_tag_t ucp_tag,
+    struct na_ucx_op_id *na_ucx_op_id);
+
+/**
+ * Post tagged recv.
+ */
+static na_return_t
+na_ucx_msg_recv(struct na_ucx_class *priv, na_context_t *context,
+    na_cb_type_t type, na_cb_t callback, void *arg, void *buf,
+    na_size_t buf_size, ucp_tag_t ucp_tag, ucp_tag_t ucp_tag_mask,
+    struct na_ucx_op_id *na_ucx_op_id);
+
+/**
+ * Complete operation.
+ */
+static void
+na_ucx_complete(struct na_ucx_op_id *na_ucx_op_id, na_return_t cb_ret);
+
+/**
+ * Release memory.
+ */
+static void
+na_ucx_release(void *arg);
+
+/* check_protocol */
+static na_bool_t
+na_ucx_check_protocol(const char *protocol_name);
+
+/* initialize */
+static na_return_t
+na_ucx_initialize(
+    na_class_t *na_class, const struct na_info *na_info, na_bool_t listen);
+
+/* finalize */
+static na_return_t
+na_ucx_finalize(na_class_t *na_class);
+
+/* context_create */
+static na_return_t
+na_ucx_context_create(na_class_t *na_class, void **context, na_uint16_t id);
+
+/* context_destroy */
+static na_return_t
+na_ucx_context_destroy(na_class_t *na_class, void *context);
+
+/* op_create */
+static na_op_id_t *
+na_ucx_op_create(na_class_t *na_class);
+
+/* op_destroy */
+static na_return_t
+na_ucx_op_destroy(na_class_t *na_class, na_op_id_t *op_id);
+
+/* addr_lookup */
+static na_return_t
+na_ucx_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr);
+
+/* addr_free */
+static na_return_t
+na_ucx_addr_free(na_class_t *na_class, na_addr_t addr);
+
+/* addr_set_remove */
+static na_return_t
+na_ucx_addr_set_remove(na_class_t *na_class, na_addr_t addr);
+
+/* addr_self */
+static na_return_t
+na_ucx_addr_self(na_class_t *na_class, na_addr_t *addr);
+
+/* addr_dup */
+static na_return_t
+na_ucx_addr_dup(na_class_t *na_class, na_addr_t addr, na_addr_t *new_addr);
+
+/* addr_cmp */
+static na_bool_t
+na_ucx_addr_cmp(na_class_t *na_class, na_addr_t addr1, na_addr_t addr2);
+
+/* addr_is_self */
+static na_bool_t
+na_ucx_addr_is_self(na_class_t *na_class, na_addr_t addr);
+
+/* addr_to_string */
+static na_return_t
+na_ucx_addr_to_string(
+    na_class_t *na_class, char *buf, na_size_t *buf_size, na_addr_t addr);
+
+/* addr_get_serialize_size */
+static na_size_t
+na_ucx_addr_get_serialize_size(na_class_t *na_class, na_addr_t addr);
+
+/* addr_serialize */
+static na_return_t
+na_ucx_addr_serialize(
+    na_class_t *na_class, void *buf, na_size_t buf_size, na_addr_t addr);
+
+/* addr_deserialize */
+static na_return_t
+na_ucx_addr_deserialize(na_class_t *na_class, na_addr_t *addr,
+    const void *buf, na_size_t buf_size);
+
+/* msg_get_max_unexpected_size */
+static na_size_t
+na_ucx_msg_get_max_unexpected_size(const na_class_t *na_class);
+
+/* msg_get_max_expected_size */
+static na_size_t
+na_ucx_msg_get_max_expected_size(const na_class_t *na_class);
+
+/* msg_get_max_tag */
+static na_tag_t
+na_ucx_msg_get_max_tag(const na_class_t *na_class);
+
+/* msg_send_unexpected */
+static na_return_t
+na_ucx_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
+    na_op_id_t *op_id);
+
+/* msg_recv_unexpected */
+static na_return_t
+na_ucx_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, na_op_id_t *op_id);
+
+/* msg_send_expected */
+static na_return_t
+na_ucx_msg_send_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
+    void *plugin_data, na_addr_t dest_addr, na_uint16_t dest_id, na_tag_t tag,
+    na_op_id_t *op_id);
+
+/* msg_recv_expected */
+static na_return_t
+na_ucx_msg_recv_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void *plugin_data, na_addr_t source_addr, na_uint16_t source_id,
+    na_tag_t tag, na_op_id_t *op_id);
+
+/* mem_handle_create */
+static na_return_t
+na_ucx_mem_handle_create(na_class_t *na_class, void *buf, na_size_t buf_size,
+    unsigned long flags, na_mem_handle_t *mem_handle);
+
+/* mem_handle_free */
+static na_return_t
+na_ucx_mem_handle_free(na_class_t *na_class, na_mem_handle_t mem_handle);
+
+/* mem_register */
+static na_return_t
+na_ucx_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle);
+
+/* mem_deregister */
+static na_return_t
+na_ucx_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle);
+
+/* mem_handle_get_serialize_size */
+static na_size_t
+na_ucx_mem_handle_get_serialize_size(
+    na_class_t *na_class, na_mem_handle_t mem_handle);
+
+/* mem_handle_serialize */
+static na_return_t
+na_ucx_mem_handle_serialize(na_class_t *na_class, void *buf, na_size_t buf_size,
+    na_mem_handle_t mem_handle);
+
+/* mem_handle_deserialize */
+static na_return_t
+na_ucx_mem_handle_deserialize(na_class_t *na_class, na_mem_handle_t *mem_handle,
+    const void *buf, na_size_t buf_size);
+
+/* put */
+static na_return_t
+na_ucx_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
+    na_op_id_t *op_id);
+
+/* get */
+static na_return_t
+na_ucx_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t remote_id,
+    na_op_id_t *op_id);
+
+/* poll_get_fd */
+static int
+na_ucx_poll_get_fd(na_class_t *na_class, na_context_t *context);
+
+/* poll_try_wait */
+static na_bool_t
+na_ucx_poll_try_wait(na_class_t *na_class, na_context_t *context);
+
+/* progress */
+static na_return_t
+na_ucx_progress(
+    na_class_t *na_class, na_context_t *context, unsigned int timeout);
+
+/* cancel */
+static na_return_t
+na_ucx_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+const struct na_class_ops NA_PLUGIN_OPS(ucx) = {
+    "ucx",                                /* name */
+    na_ucx_check_protocol,                /* check_protocol */
+    na_ucx_initialize,                    /* initialize */
+    na_ucx_finalize,                      /* finalize */
+    NULL,                                 /* cleanup */
+    na_ucx_context_create,                /* context_create */
+    na_ucx_context_destroy,               /* context_destroy */
+    na_ucx_op_create,                     /* op_create */
+    na_ucx_op_destroy,                    /* op_destroy */
+    na_ucx_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
+    na_ucx_addr_free,                     /* addr_free */
+    na_ucx_addr_set_remove,               /* addr_set_remove */
+    NULL,                                 /* addr_warmup */
+    na_ucx_addr_self,                     /* addr_self */
+    na_ucx_addr_dup,                      /* addr_dup */
+    na_ucx_addr_cmp,                      /* addr_cmp */
+    na_ucx_addr_is_self,                  /* addr_is_self */
+    na_ucx_addr_to_string,                /* addr_to_string */
+    na_ucx_addr_get_serialize_size,       /* addr_get_serialize_size */
+    na_ucx_addr_serialize,                /* addr_serialize */
+    na_ucx_addr_deserialize,              /* addr_deserialize */
+    NULL,                                 /* addr_deserialize_batch */
+    na_ucx_msg_get_max_unexpected_size,   /* msg_get_max_unexpected_size */
+    na_ucx_msg_get_max_expected_size,     /* msg_get_max_expected_size */
+    NULL,                                 /* msg_get_unexpected_header_size */
+    NULL,                                 /* msg_get_expected_header_size */
+    na_ucx_msg_get_max_tag,               /* msg_get_max_tag */
+    NULL,                                 /* msg_buf_alloc */
+    NULL,                                 /* msg_buf_free */
+    NULL,                                 /* msg_init_unexpected */
+    na_ucx_msg_send_unexpected,           /* msg_send_unexpected */
+    NULL,                                 /* msg_send_unexpectedv */
+    na_ucx_msg_recv_unexpected,           /* msg_recv_unexpected */
+    NULL,                                 /* msg_init_expected */
+    na_ucx_msg_send_expected,             /* msg_send_expected */
+    NULL,                                 /* msg_send_expectedv */
+    na_ucx_msg_recv_expected,             /* msg_recv_expected */
+    na_ucx_mem_handle_create,             /* mem_handle_create */
+    NULL,                                 /* mem_handle_create_segment */
+    na_ucx_mem_handle_free,               /* mem_handle_free */
+    NULL,                                 /* mem_handle_get_max_segments */
+    na_ucx_mem_register,                  /* mem_register */
+    na_ucx_mem_deregister,                /* mem_deregister */
+    na_ucx_mem_handle_get_serialize_size, /* mem_handle_get_serialize_size */
+    na_ucx_mem_handle_serialize,          /* mem_handle_serialize */
+    na_ucx_mem_handle_deserialize,        /* mem_handle_deserialize */
+    na_ucx_put,                           /* put */
+    na_ucx_get,                           /* get */
+    na_ucx_poll_get_fd,                   /* poll_get_fd */
+    na_ucx_poll_try_wait,                 /* poll_try_wait */
+    na_ucx_progress,                      /* progress */
+    na_ucx_cancel,                        /* cancel */
+    NULL,                                 /* get_resource_stats */
+    NULL,                                 /* mem_handle_create_sub */
+    NULL,                                 /* op_batch_begin */
+    NULL,                                 /* op_batch_end */
+    NULL,                                 /* mem_register_attr */
+    NULL                                  /* atomic */
+};
+
+/* Protocols accepted, passed to UCX as UCX_TLS ("all" keeps UCX default) */
+static const char *const na_ucx_protocols[] = {"all", "tcp", "ib", "rc",
+    "rc_x", "rc_verbs", "ud", "ud_x", "ud_verbs", "dc", "dc_x", NULL};
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_status_to_na(ucs_status_t status)
+{
+    switch (status) {
+        case UCS_OK:
+            return NA_SUCCESS;
+        case UCS_ERR_CANCELED:
+            return NA_CANCELED;
+        case UCS_ERR_MESSAGE_TRUNCATED:
+            return NA_MSGSIZE;
+        case UCS_ERR_NO_MEMORY:
+            return NA_NOMEM;
+        case UCS_ERR_INVALID_PARAM:
+            return NA_INVALID_ARG;
+        case UCS_ERR_TIMED_OUT:
+            return NA_TIMEOUT;
+        case UCS_ERR_UNREACHABLE:
+        case UCS_ERR_ENDPOINT_TIMEOUT:
+        case UCS_ERR_CONNECTION_RESET:
+            return NA_HOSTUNREACH;
+        case UCS_ERR_UNSUPPORTED:
+            return NA_OPNOTSUPPORTED;
+        default:
+            return NA_PROTOCOL_ERROR;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_uint32_t
+na_ucx_addr_id(const void *worker_addr, size_t worker_addr_len)
+{
+    const unsigned char *p = (const unsigned char *) worker_addr;
+    na_uint32_t hash = 2166136261U; /* FNV-1a */
+    size_t i;
+
+    for (i = 0; i < worker_addr_len; i++) {
+        hash ^= p[i];
+        hash *= 16777619U;
+    }
+
+    return (na_uint32_t) (hash & NA_UCX_ID_MASK);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE unsigned int
+na_ucx_addr_key_hash(hg_hash_table_key_t key)
+{
+    return (unsigned int) *((na_uint32_t *) key);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_ucx_addr_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return *((na_uint32_t *) key1) == *((na_uint32_t *) key2);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE struct na_ucx_addr *
+na_ucx_addr_map_lookup(struct na_ucx_map *na_ucx_map, na_uint32_t id)
+{
+    struct na_ucx_addr *na_ucx_addr;
+
+    hg_thread_rwlock_rdlock(&na_ucx_map->lock);
+    na_ucx_addr = (struct na_ucx_addr *) hg_hash_table_lookup(
+        na_ucx_map->map, (hg_hash_table_key_t) &id);
+    if (na_ucx_addr)
+        hg_atomic_incr32_relaxed(&na_ucx_addr->ref_count);
+    hg_thread_rwlock_release_rdlock(&na_ucx_map->lock);
+
+    return na_ucx_addr;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_resolve(struct na_ucx_class *priv, const void *worker_addr,
+    size_t worker_addr_len, struct na_ucx_addr **addr)
+{
+    struct na_ucx_map *na_ucx_map = &priv->addr_map;
+    struct na_ucx_addr *na_ucx_addr = NULL;
+    na_uint32_t id = na_ucx_addr_id(worker_addr, worker_addr_len);
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    na_ucx_addr = na_ucx_addr_map_lookup(na_ucx_map, id);
+    if (na_ucx_addr)
+        goto check;
+
+    hg_thread_rwlock_wrlock(&na_ucx_map->lock);
+
+    /* Look up again to prevent race between lock release/acquire */
+    na_ucx_addr = (struct na_ucx_addr *) hg_hash_table_lookup(
+        na_ucx_map->map, (hg_hash_table_key_t) &id);
+    if (na_ucx_addr) {
+        hg_atomic_incr32_relaxed(&na_ucx_addr->ref_count);
+        hg_thread_rwlock_release_wrlock(&na_ucx_map->lock);
+        goto check;
+    }
+
+    ret = na_ucx_addr_create(
+        priv, worker_addr, worker_addr_len, NA_FALSE, &na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, unlock, ret, "Could not create address");
+
+    /* Map holds one reference */
+    rc = hg_hash_table_insert(na_ucx_map->map,
+        (hg_hash_table_key_t) &na_ucx_addr->id,
+        (hg_hash_table_value_t) na_ucx_addr);
+    NA_CHECK_SUBSYS_ERROR(addr, rc == 0, destroy, ret, NA_NOMEM,
+        "hg_hash_table_insert() failed");
+    hg_atomic_incr32_relaxed(&na_ucx_addr->ref_count);
+
+    hg_thread_rwlock_release_wrlock(&na_ucx_map->lock);
+
+    *addr = na_ucx_addr;
+
+    return NA_SUCCESS;
+
+check:
+    /* Sender IDs are hashes of worker addresses */
+    NA_CHECK_SUBSYS_ERROR(addr,
+        na_ucx_addr->worker_addr_len != worker_addr_len ||
+            memcmp(na_ucx_addr->worker_addr, worker_addr, worker_addr_len),
+        release, ret, NA_EXIST, "Sender ID %u is already used by another peer",
+        id);
+
+    *addr = na_ucx_addr;
+
+    return NA_SUCCESS;
+
+destroy:
+    na_ucx_addr_decref(na_ucx_addr);
+unlock:
+    hg_thread_rwlock_release_wrlock(&na_ucx_map->lock);
+
+    return ret;
+
+release:
+    na_ucx_addr_decref(na_ucx_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_create(struct na_ucx_class *priv, const void *worker_addr,
+    size_t worker_addr_len, na_bool_t self, struct na_ucx_addr **addr)
+{
+    struct na_ucx_addr *na_ucx_addr = NULL;
+    ucp_ep_params_t ep_params;
+    ucs_status_t status;
+    na_return_t ret = NA_SUCCESS;
+
+    na_ucx_addr = (struct na_ucx_addr *) calloc(1, sizeof(*na_ucx_addr));
+    NA_CHECK_SUBSYS_ERROR(addr, na_ucx_addr == NULL, error, ret, NA_NOMEM,
+        "Could not allocate UCX addr");
+
+    na_ucx_addr->worker_addr = malloc(worker_addr_len);
+    NA_CHECK_SUBSYS_ERROR(addr, na_ucx_addr->worker_addr == NULL, error, ret,
+        NA_NOMEM, "Could not allocate worker address");
+    memcpy(na_ucx_addr->worker_addr, worker_addr, worker_addr_len);
+    na_ucx_addr->worker_addr_len = worker_addr_len;
+    na_ucx_addr->id = na_ucx_addr_id(worker_addr, worker_addr_len);
+    na_ucx_addr->ucp_worker = priv->ucp_worker;
+    na_ucx_addr->self = self;
+    hg_atomic_init32(&na_ucx_addr->ref_count, 1);
+    /* Peers already know our address when sending to self */
+    hg_atomic_init32(&na_ucx_addr->conn_sent, (self) ? 1 : 0);
+
+    memset(&ep_params, 0, sizeof(ep_params));
+    ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS |
+                           UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE |
+                           UCP_EP_PARAM_FIELD_ERR_HANDLER;
+    ep_params.address = (const ucp_address_t *) na_ucx_addr->worker_addr;
+    ep_params.err_mode = UCP_ERR_HANDLING_MODE_PEER;
+    ep_params.err_handler.cb = na_ucx_ep_err_cb;
+    ep_params.err_handler.arg = na_ucx_addr;
+
+    status = ucp_ep_create(priv->ucp_worker, &ep_params, &na_ucx_addr->ucp_ep);
+    NA_CHECK_SUBSYS_ERROR(addr, status != UCS_OK, error, ret,
+        na_ucx_status_to_na(status), "ucp_ep_create() failed (%s)",
+        ucs_status_string(status));
+
+    *addr = na_ucx_addr;
+
+    return ret;
+
+error:
+    if (na_ucx_addr) {
+        free(na_ucx_addr->worker_addr);
+        free(na_ucx_addr);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_addr_decref(struct na_ucx_addr *na_ucx_addr)
+{
+    ucp_request_param_t param;
+    ucs_status_ptr_t request;
+
+    if (hg_atomic_decr32(&na_ucx_addr->ref_count) > 0)
+        return;
+
+    /* Force close without waiting, request is released once completed */
+    memset(&param, 0, sizeof(param));
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags = UCP_EP_CLOSE_FLAG_FORCE;
+    request = ucp_ep_close_nbx(na_ucx_addr->ucp_ep, &param);
+    if (UCS_PTR_IS_PTR(request))
+        ucp_request_free(request);
+    else
+        NA_CHECK_SUBSYS_ERROR_DONE(addr, UCS_PTR_IS_ERR(request),
+            "ucp_ep_close_nbx() failed (%s)",
+            ucs_status_string(UCS_PTR_STATUS(request)));
+
+    free(na_ucx_addr->worker_addr);
+    free(na_ucx_addr);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_ep_err_cb(void *arg, ucp_ep_h NA_UNUSED ep, ucs_status_t status)
+{
+    struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) arg;
+
+    /* Operations on endpoint complete with error */
+    NA_LOG_SUBSYS_WARNING(addr, "Endpoint of peer %u failed (%s)",
+        na_ucx_addr->id, ucs_status_string(status));
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_connect(struct na_ucx_class *priv, struct na_ucx_addr *na_ucx_addr)
+{
+    struct na_ucx_addr *src_addr = priv->src_addr;
+    ucp_request_param_t param;
+    ucs_status_ptr_t request;
+    na_return_t ret = NA_SUCCESS;
+
+    if (hg_atomic_get32(&na_ucx_addr->conn_sent) ||
+        !hg_atomic_cas32(&na_ucx_addr->conn_sent, 0, 1))
+        goto out;
+
+    /* Messages are matched in order, the peer therefore gets our address
+     * before the message that follows. Source buffer is the worker address
+     * held by our own address, no completion is needed. */
+    memset(&param, 0, sizeof(param));
+    request = ucp_tag_send_nbx(na_ucx_addr->ucp_ep, src_addr->worker_addr,
+        src_addr->worker_addr_len, NA_UCX_TAG(NA_UCX_TAG_CONN, src_addr->id, 0),
+        &param);
+    if (UCS_PTR_IS_PTR(request))
+        ucp_request_free(request);
+    else if (UCS_PTR_IS_ERR(request)) {
+        hg_atomic_set32(&na_ucx_addr->conn_sent, 0);
+        NA_GOTO_SUBSYS_ERROR(addr, out, ret,
+            na_ucx_status_to_na(UCS_PTR_STATUS(request)),
+            "ucp_tag_send_nbx() failed (%s)",
+            ucs_status_string(UCS_PTR_STATUS(request)));
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_conn_post(struct na_ucx_class *priv)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    /* Loop while messages are already there */
+    for (;;) {
+        ucp_request_param_t param;
+        ucs_status_ptr_t request;
+
+        memset(&param, 0, sizeof(param));
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                             UCP_OP_ATTR_FIELD_USER_DATA |
+                             UCP_OP_ATTR_FIELD_RECV_INFO;
+        param.cb.recv = na_ucx_conn_recv_cb;
+        param.user_data = priv;
+        param.recv_info.tag_info = &priv->conn_tag_info;
+
+        request = ucp_tag_recv_nbx(priv->ucp_worker, priv->conn_buf,
+            NA_UCX_CONN_SIZE_MAX, NA_UCX_TAG_CONN, NA_UCX_TAG_FLAGS, &param);
+        NA_CHECK_SUBSYS_ERROR(addr, UCS_PTR_IS_ERR(request), out, ret,
+            na_ucx_status_to_na(UCS_PTR_STATUS(request)),
+            "ucp_tag_recv_nbx() failed (%s)",
+            ucs_status_string(UCS_PTR_STATUS(request)));
+        if (request != NULL) {
+            priv->conn_request = request;
+            break;
+        }
+
+        /* Completed immediately */
+        na_ucx_conn_recv(priv, UCS_OK, &priv->conn_tag_info);
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_conn_recv(struct na_ucx_class *priv, ucs_status_t status,
+    const ucp_tag_recv_info_t *tag_info)
+{
+    struct na_ucx_conn *na_ucx_conn;
+
+    NA_CHECK_SUBSYS_ERROR_NORET(addr, status != UCS_OK, out,
+        "Could not receive worker address (%s)", ucs_status_string(status));
+
+    na_ucx_conn = (struct na_ucx_conn *) malloc(
+        sizeof(struct na_ucx_conn) + tag_info->length);
+    NA_CHECK_SUBSYS_ERROR_NORET(addr, na_ucx_conn == NULL, out,
+        "Could not allocate conn entry");
+    na_ucx_conn->id = NA_UCX_TAG_ID(tag_info->sender_tag);
+    na_ucx_conn->worker_addr_len = tag_info->length;
+    memcpy(na_ucx_conn->worker_addr, priv->conn_buf, tag_info->length);
+
+    hg_thread_spin_lock(&priv->conn_queue.lock);
+    HG_QUEUE_PUSH_TAIL(&priv->conn_queue.queue, na_ucx_conn, entry);
+    hg_thread_spin_unlock(&priv->conn_queue.lock);
+
+out:
+    return;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_conn_recv_cb(void *request, ucs_status_t status,
+    const ucp_tag_recv_info_t *tag_info, void *user_data)
+{
+    struct na_ucx_class *priv = (struct na_ucx_class *) user_data;
+
+    if (status != UCS_ERR_CANCELED) {
+        na_ucx_conn_recv(priv, status, tag_info);
+        /* Endpoints cannot be created from callbacks, repost from progress */
+        hg_atomic_set32(&priv->conn_repost, 1);
+    }
+    priv->conn_request = NULL;
+    ucp_request_free(request);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_conn_process(struct na_ucx_class *priv, na_bool_t *progressed)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    for (;;) {
+        HG_QUEUE_HEAD(na_ucx_op_id) pending_ops;
+        struct na_ucx_op_id *na_ucx_op_id;
+        struct na_ucx_addr *na_ucx_addr = NULL;
+        struct na_ucx_conn *na_ucx_conn;
+
+        hg_thread_spin_lock(&priv->conn_queue.lock);
+        na_ucx_conn = HG_QUEUE_FIRST(&priv->conn_queue.queue);
+        if (na_ucx_conn)
+            HG_QUEUE_POP_HEAD(&priv->conn_queue.queue, entry);
+        hg_thread_spin_unlock(&priv->conn_queue.lock);
+        if (!na_ucx_conn)
+            break;
+
+        *progressed = NA_TRUE;
+
+        ret = na_ucx_addr_resolve(priv, na_ucx_conn->worker_addr,
+            na_ucx_conn->worker_addr_len, &na_ucx_addr);
+        free(na_ucx_conn);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            addr, out, ret, "Could not resolve worker address of peer");
+
+        /* Peer knows our address if it sent its own */
+        hg_atomic_set32(&na_ucx_addr->conn_sent, 1);
+
+        /* Complete recvs that were waiting for the address */
+        HG_QUEUE_INIT(&pending_ops);
+        hg_thread_spin_lock(&priv->pending_op_queue.lock);
+        while ((na_ucx_op_id = HG_QUEUE_FIRST(&priv->pending_op_queue.queue))) {
+            HG_QUEUE_POP_HEAD(&priv->pending_op_queue.queue, entry);
+            HG_QUEUE_PUSH_TAIL(&pending_ops, na_ucx_op_id, entry);
+        }
+        while ((na_ucx_op_id = HG_QUEUE_FIRST(&pending_ops))) {
+            HG_QUEUE_POP_HEAD(&pending_ops, entry);
+            if (NA_UCX_TAG_ID(na_ucx_op_id->msg.tag_info.sender_tag) ==
+                na_ucx_addr->id) {
+                hg_atomic_and32(&na_ucx_op_id->status, ~NA_UCX_OP_QUEUED);
+                hg_atomic_incr32_relaxed(&na_ucx_addr->ref_count);
+                na_ucx_op_id->addr = na_ucx_addr;
+                na_ucx_complete(na_ucx_op_id, NA_SUCCESS);
+            } else
+                HG_QUEUE_PUSH_TAIL(
+                    &priv->pending_op_queue.queue, na_ucx_op_id, entry);
+        }
+        hg_thread_spin_unlock(&priv->pending_op_queue.lock);
+
+        na_ucx_addr_decref(na_ucx_addr);
+    }
+
+    if (hg_atomic_cas32(&priv->conn_repost, 1, 0)) {
+        ret = na_ucx_conn_post(priv);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            addr, out, ret, "Could not repost conn recv");
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_send_cb(void NA_UNUSED *request, ucs_status_t status, void *user_data)
+{
+    na_ucx_complete(
+        (struct na_ucx_op_id *) user_data, na_ucx_status_to_na(status));
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_recv_cb(void NA_UNUSED *request, ucs_status_t status,
+    const ucp_tag_recv_info_t *tag_info, void *user_data)
+{
+    na_ucx_recv_process((struct na_ucx_op_id *) user_data, status, tag_info);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_recv_process(struct na_ucx_op_id *na_ucx_op_id, ucs_status_t status,
+    const ucp_tag_recv_info_t *tag_info)
+{
+    struct na_ucx_class *priv = na_ucx_op_id->priv;
+
+    if (status != UCS_OK) {
+        na_ucx_complete(na_ucx_op_id, na_ucx_status_to_na(status));
+        return;
+    }
+
+    na_ucx_op_id->msg.tag_info = *tag_info;
+    na_ucx_op_id->msg.actual_buf_size = (na_size_t) tag_info->length;
+    na_ucx_op_id->msg.tag = (na_tag_t) (tag_info->sender_tag & NA_UCX_TAG_MASK);
+
+    if (na_ucx_op_id->completion_data.callback_info.type !=
+        NA_CB_RECV_UNEXPECTED) {
+        na_ucx_complete(na_ucx_op_id, NA_SUCCESS);
+        return;
+    }
+
+    /* Source must be known to complete unexpected recvs, otherwise wait
+     * for its worker address (lookup under queue lock, see conn_process) */
+    hg_thread_spin_lock(&priv->pending_op_queue.lock);
+    na_ucx_op_id->addr = na_ucx_addr_map_lookup(
+        &priv->addr_map, NA_UCX_TAG_ID(tag_info->sender_tag));
+    if (na_ucx_op_id->addr == NULL) {
+        HG_QUEUE_PUSH_TAIL(
+            &priv->pending_op_queue.queue, na_ucx_op_id, entry);
+        hg_atomic_or32(&na_ucx_op_id->status, NA_UCX_OP_QUEUED);
+    }
+    hg_thread_spin_unlock(&priv->pending_op_queue.lock);
+
+    if (na_ucx_op_id->addr)
+        na_ucx_complete(na_ucx_op_id, NA_SUCCESS);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ucx_op_set_request(struct na_ucx_op_id *na_ucx_op_id, void *request)
+{
+    na_bool_t released;
+
+    /* Op ID may already have completed and been released from another
+     * thread, in which case the request is no longer needed */
+    hg_thread_spin_lock(&na_ucx_op_id->lock);
+    released = na_ucx_op_id->released;
+    if (!released)
+        na_ucx_op_id->request = request;
+    hg_thread_spin_unlock(&na_ucx_op_id->lock);
+
+    if (released)
+        ucp_request_free(request);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_rkey_get(struct na_ucx_mem_handle *na_ucx_mem_handle, ucp_ep_h ucp_ep,
+    ucp_rkey_h *ucp_rkey)
+{
+    struct na_ucx_rkey *na_ucx_rkey;
+    ucs_status_t status;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Remote keys are unpacked once per endpoint and kept with the handle */
+    hg_thread_spin_lock(&na_ucx_mem_handle->rkey_lock);
+    for (na_ucx_rkey = na_ucx_mem_handle->rkeys; na_ucx_rkey != NULL;
+         na_ucx_rkey = na_ucx_rkey->next)
+        if (na_ucx_rkey->ucp_ep == ucp_ep)
+            break;
+    if (na_ucx_rkey) {
+        *ucp_rkey = na_ucx_rkey->ucp_rkey;
+        goto unlock;
+    }
+
+    na_ucx_rkey = (struct na_ucx_rkey *) malloc(sizeof(*na_ucx_rkey));
+    NA_CHECK_SUBSYS_ERROR(rma, na_ucx_rkey == NULL, unlock, ret, NA_NOMEM,
+        "Could not allocate rkey");
+
+    status = ucp_ep_rkey_unpack(
+        ucp_ep, na_ucx_mem_handle->rkey_buf, &na_ucx_rkey->ucp_rkey);
+    if (status != UCS_OK) {
+        free(na_ucx_rkey);
+        NA_GOTO_SUBSYS_ERROR(rma, unlock, ret, na_ucx_status_to_na(status),
+            "ucp_ep_rkey_unpack() failed (%s)", ucs_status_string(status));
+    }
+    na_ucx_rkey->ucp_ep = ucp_ep;
+    na_ucx_rkey->next = na_ucx_mem_handle->rkeys;
+    na_ucx_mem_handle->rkeys = na_ucx_rkey;
+
+    *ucp_rkey = na_ucx_rkey->ucp_rkey;
+
+unlock:
+    hg_thread_spin_unlock(&na_ucx_mem_handle->rkey_lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_rma(struct na_ucx_class NA_UNUSED *priv, na_context_t *context,
+    na_cb_type_t type, na_cb_t callback, void *arg,
+    struct na_ucx_mem_handle *local_mem_handle, na_offset_t local_offset,
+    struct na_ucx_mem_handle *remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, struct na_ucx_addr *na_ucx_addr,
+    struct na_ucx_op_id *na_ucx_op_id)
+{
+    void *local_buf = (char *) local_mem_handle->base + local_offset;
+    na_uint64_t remote_buf = remote_mem_handle->base + remote_offset;
+    ucp_request_param_t param;
+    ucs_status_ptr_t request;
+    ucp_rkey_h ucp_rkey;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(rma, remote_mem_handle->rkey_buf == NULL, out, ret,
+        NA_INVALID_ARG, "Remote memory handle is not registered");
+    NA_CHECK_SUBSYS_ERROR(rma,
+        (type == NA_CB_PUT &&
+            remote_mem_handle->flags == NA_MEM_READ_ONLY) ||
+            (type == NA_CB_GET &&
+                local_mem_handle->flags == NA_MEM_READ_ONLY),
+        out, ret, NA_PERMISSION, "Registered memory requires write permission");
+
+    ret = na_ucx_rkey_get(remote_mem_handle, na_ucx_addr->ucp_ep, &ucp_rkey);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, out, ret, "Could not get remote key");
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    na_ucx_op_id->context = context;
+    na_ucx_op_id->completion_data.callback_info.type = type;
+    na_ucx_op_id->completion_data.callback = callback;
+    na_ucx_op_id->completion_data.callback_info.arg = arg;
+    hg_atomic_incr32_relaxed(&na_ucx_addr->ref_count);
+    na_ucx_op_id->addr = na_ucx_addr;
+    na_ucx_op_id->request = NULL;
+    na_ucx_op_id->released = NA_FALSE;
+    hg_atomic_set32(&na_ucx_op_id->status, 0);
+
+    memset(&param, 0, sizeof(param));
+    if (type == NA_CB_PUT) {
+        /* Put completes locally, flush the endpoint to complete once data
+         * is visible at the target */
+        request = ucp_put_nbx(na_ucx_addr->ucp_ep, local_buf, length,
+            remote_buf, ucp_rkey, &param);
+        if (UCS_PTR_IS_PTR(request))
+            ucp_request_free(request);
+        NA_CHECK_SUBSYS_ERROR(rma, UCS_PTR_IS_ERR(request), error, ret,
+            na_ucx_status_to_na(UCS_PTR_STATUS(request)),
+            "ucp_put_nbx() failed (%s)",
+            ucs_status_string(UCS_PTR_STATUS(request)));
+
+        param.op_attr_mask =
+            UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+        param.cb.send = na_ucx_send_cb;
+        param.user_data = na_ucx_op_id;
+        request = ucp_ep_flush_nbx(na_ucx_addr->ucp_ep, &param);
+    } else {
+        param.op_attr_mask =
+            UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+        param.cb.send = na_ucx_send_cb;
+        param.user_data = na_ucx_op_id;
+        request = ucp_get_nbx(na_ucx_addr->ucp_ep, local_buf, length,
+            remote_buf, ucp_rkey, &param);
+    }
+    NA_CHECK_SUBSYS_ERROR(rma, UCS_PTR_IS_ERR(request), error, ret,
+        na_ucx_status_to_na(UCS_PTR_STATUS(request)), "RMA failed (%s)",
+        ucs_status_string(UCS_PTR_STATUS(request)));
+
+    if (request == NULL)
+        na_ucx_complete(na_ucx_op_id, NA_SUCCESS);
+    else
+        na_ucx_op_set_request(na_ucx_op_id, request);
+
+out:
+    return ret;
+
+error:
+    na_ucx_addr_decref(na_ucx_addr);
+    na_ucx_op_id->addr = NULL;
+    hg_atomic_set32(&na_ucx_op_id->status, NA_UCX_OP_COMPLETED);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_complete(struct na_ucx_op_id *na_ucx_op_id, na_return_t cb_ret)
+{
+    struct na_cb_info *callback_info = NULL;
+    hg_util_int32_t status;
+
+    /* Mark op id as completed before checking for cancelation */
+    status = hg_atomic_or32(&na_ucx_op_id->status, NA_UCX_OP_COMPLETED);
+
+    /* Init callback info */
+    callback_info = &na_ucx_op_id->completion_data.callback_info;
+    callback_info->ret = cb_ret;
+
+    if (status & NA_UCX_OP_CANCELED)
+        NA_LOG_SUBSYS_DEBUG(op, "Operation ID %p is canceled", na_ucx_op_id);
+
+    switch (callback_info->type) {
+        case NA_CB_RECV_UNEXPECTED:
+            if (callback_info->ret != NA_SUCCESS) {
+                /* In case of cancellation where no recv'd data */
+                callback_info->info.recv_unexpected.actual_buf_size = 0;
+                callback_info->info.recv_unexpected.source = NA_ADDR_NULL;
+                callback_info->info.recv_unexpected.tag = 0;
+            } else {
+                /* Increment addr ref count */
+                hg_atomic_incr32_relaxed(&na_ucx_op_id->addr->ref_count);
+
+                /* Fill callback info */
+                callback_info->info.recv_unexpected.actual_buf_size =
+                    na_ucx_op_id->msg.actual_buf_size;
+                callback_info->info.recv_unexpected.source =
+                    (na_addr_t) na_ucx_op_id->addr;
+                callback_info->info.recv_unexpected.tag =
+                    na_ucx_op_id->msg.tag;
+            }
+            break;
+        case NA_CB_RECV_EXPECTED:
+            callback_info->info.recv_expected.actual_buf_size =
+                (callback_info->ret == NA_SUCCESS)
+                    ? na_ucx_op_id->msg.actual_buf_size
+                    : 0;
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+        case NA_CB_SEND_EXPECTED:
+        case NA_CB_PUT:
+        case NA_CB_GET:
+            break;
+        default:
+            NA_LOG_SUBSYS_ERROR(
+                op, "Operation type %d not supported", callback_info->type);
+            break;
+    }
+
+    /* Add OP to NA completion queue */
+    na_cb_completion_add(na_ucx_op_id->context, &na_ucx_op_id->completion_data);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_release(void *arg)
+{
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) arg;
+    void *request;
+
+    NA_CHECK_SUBSYS_WARNING(op,
+        na_ucx_op_id &&
+            (!(hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_COMPLETED)),
+        "Releasing resources from an uncompleted operation");
+
+    hg_thread_spin_lock(&na_ucx_op_id->lock);
+    request = na_ucx_op_id->request;
+    na_ucx_op_id->request = NULL;
+    na_ucx_op_id->released = NA_TRUE;
+    hg_thread_spin_unlock(&na_ucx_op_id->lock);
+
+    if (request)
+        ucp_request_free(request);
+
+    if (na_ucx_op_id->addr) {
+        na_ucx_addr_decref(na_ucx_op_id->addr);
+        na_ucx_op_id->addr = NULL;
+    }
+}
+
+/********************/
+/* Plugin callbacks */
+/********************/
+
+static na_bool_t
+na_ucx_check_protocol(const char *protocol_name)
+{
+    const char *const *protocol;
+
+    for (protocol = na_ucx_protocols; *protocol != NULL; protocol++)
+        if (strcmp(protocol_name, *protocol) == 0)
+            return NA_TRUE;
+
+    return NA_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_initialize(na_class_t *na_class, const struct na_info *na_info,
+    na_bool_t NA_UNUSED listen)
+{
+    struct na_ucx_class *priv = NULL;
+    ucp_config_t *ucp_config = NULL;
+    ucp_params_t ucp_params;
+    ucp_worker_params_t worker_params;
+    ucp_address_t *worker_addr = NULL;
+    size_t worker_addr_len = 0;
+    ucs_status_t status;
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    priv = (struct na_ucx_class *) calloc(1, sizeof(struct na_ucx_class));
+    NA_CHECK_SUBSYS_ERROR(cls, priv == NULL, error, ret, NA_NOMEM,
+        "Could not allocate NA private data class");
+    na_class->plugin_class = priv;
+    priv->efd = -1;
+
+    /* Init locks and queues */
+    hg_thread_rwlock_init(&priv->addr_map.lock);
+    HG_QUEUE_INIT(&priv->pending_op_queue.queue);
+    hg_thread_spin_init(&priv->pending_op_queue.lock);
+    HG_QUEUE_INIT(&priv->conn_queue.queue);
+    hg_thread_spin_init(&priv->conn_queue.lock);
+    hg_atomic_init32(&priv->conn_repost, 0);
+
+    priv->protocol_name = strdup(na_info->protocol_name);
+    NA_CHECK_SUBSYS_ERROR(cls, priv->protocol_name == NULL, error, ret,
+        NA_NOMEM, "Could not duplicate protocol name");
+
+    /* Msg sizes */
+    priv->unexpected_size_max =
+        (na_info->na_init_info && na_info->na_init_info->max_unexpected_size)
+            ? na_info->na_init_info->max_unexpected_size
+            : NA_UCX_UNEXPECTED_SIZE;
+    priv->expected_size_max =
+        (na_info->na_init_info && na_info->na_init_info->max_expected_size)
+            ? na_info->na_init_info->max_expected_size
+            : NA_UCX_EXPECTED_SIZE;
+    priv->no_wait = (na_class->progress_mode & NA_NO_BLOCK) ? NA_TRUE
+                                                            : NA_FALSE;
+
+    /* Create slab of op IDs */
+    priv->op_slab = na_op_slab_create(sizeof(struct na_ucx_op_id));
+    NA_CHECK_SUBSYS_ERROR(cls, priv->op_slab == NULL, error, ret, NA_NOMEM,
+        "Could not create op ID slab");
+
+    priv->conn_buf = malloc(NA_UCX_CONN_SIZE_MAX);
+    NA_CHECK_SUBSYS_ERROR(cls, priv->conn_buf == NULL, error, ret, NA_NOMEM,
+        "Could not allocate conn recv buffer");
+
+    /* Create address map */
+    priv->addr_map.map =
+        hg_hash_table_new(na_ucx_addr_key_hash, na_ucx_addr_key_equal);
+    NA_CHECK_SUBSYS_ERROR(cls, priv->addr_map.map == NULL, error, ret,
+        NA_NOMEM, "Could not allocate address map");
+
+    /* Restrict transports to requested protocol (self is needed for
+     * loopback) */
+    status = ucp_config_read(NULL, NULL, &ucp_config);
+    NA_CHECK_SUBSYS_ERROR(cls, status != UCS_OK, error, ret,
+        na_ucx_status_to_na(status), "ucp_config_read() failed (%s)",
+        ucs_status_string(status));
+    if (strcmp(priv->protocol_name, "all") != 0) {
+        char tls[64];
+
+        rc = snprintf(tls, sizeof(tls), "%s,self", priv->protocol_name);
+        NA_CHECK_SUBSYS_ERROR(cls, rc < 0 || rc >= (int) sizeof(tls), error,
+            ret, NA_OVERFLOW, "Protocol name too long");
+        status = ucp_config_modify(ucp_config, "TLS", tls);
+        NA_CHECK_SUBSYS_ERROR(cls, status != UCS_OK, error, ret,
+            na_ucx_status_to_na(status), "ucp_config_modify() failed (%s)",
+            ucs_status_string(status));
+    }
+
+    memset(&ucp_params, 0, sizeof(ucp_params));
+    ucp_params.field_mask =
+        UCP_PARAM_FIELD_FEATURES | UCP_PARAM_FIELD_MT_WORKERS_SHARED;
+    ucp_params.features = UCP_FEATURE_TAG | UCP_FEATURE_RMA;
+    if (!priv->no_wait)
+        ucp_params.features |= UCP_FEATURE_WAKEUP;
+    ucp_params.mt_workers_shared = 1;
+
+    status = ucp_init(&ucp_params, ucp_config, &priv->ucp_context);
+    ucp_config_release(ucp_config);
+    NA_CHECK_SUBSYS_ERROR(cls, status != UCS_OK, error, ret,
+        na_ucx_status_to_na(status), "ucp_init() failed (%s)",
+        ucs_status_string(status));
+
+    /* Single worker shared by all contexts */
+    memset(&worker_params, 0, sizeof(worker_params));
+    worker_params.field_mask = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+    worker_params.thread_mode = UCS_THREAD_MODE_MULTI;
+
+    status = ucp_worker_create(
+        priv->ucp_context, &worker_params, &priv->ucp_worker);
+    NA_CHECK_SUBSYS_ERROR(cls, status != UCS_OK, error, ret,
+        na_ucx_status_to_na(status), "ucp_worker_create() failed (%s)",
+        ucs_status_string(status));
+
+    if (!priv->no_wait) {
+        status = ucp_worker_get_efd(priv->ucp_worker, &priv->efd);
+        NA_CHECK_SUBSYS_ERROR(cls, status != UCS_OK, error, ret,
+            na_ucx_status_to_na(status), "ucp_worker_get_efd() failed (%s)",
+            ucs_status_string(status));
+    }
+
+    /* Create self address, which peers use to reach us */
+    status = ucp_worker_get_address(
+        priv->ucp_worker, &worker_addr, &worker_addr_len);
+    NA_CHECK_SUBSYS_ERROR(cls, status != UCS_OK, error, ret,
+        na_ucx_status_to_na(status), "ucp_worker_get_address() failed (%s)",
+        ucs_status_string(status));
+    NA_CHECK_SUBSYS_ERROR(cls, worker_addr_len > NA_UCX_CONN_SIZE_MAX, error,
+        ret, NA_OVERFLOW, "Worker address too large (%zu)", worker_addr_len);
+
+    ret = na_ucx_addr_create(
+        priv, worker_addr, worker_addr_len, NA_TRUE, &priv->src_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not create self address");
+    ucp_worker_release_address(priv->ucp_worker, worker_addr);
+    worker_addr = NULL;
+
+    /* Messages sent to self are resolved through the map as well */
+    rc = hg_hash_table_insert(priv->addr_map.map,
+        (hg_hash_table_key_t) &priv->src_addr->id,
+        (hg_hash_table_value_t) priv->src_addr);
+    NA_CHECK_SUBSYS_ERROR(
+        cls, rc == 0, error, ret, NA_NOMEM, "hg_hash_table_insert() failed");
+    hg_atomic_incr32_relaxed(&priv->src_addr->ref_count);
+
+    /* Receive worker addresses of peers */
+    ret = na_ucx_conn_post(priv);
+    NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not post conn recv");
+
+    return ret;
+
+error:
+    if (worker_addr)
+        ucp_worker_release_address(priv->ucp_worker, worker_addr);
+    if (priv)
+        na_ucx_finalize(na_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_finalize(na_class_t *na_class)
+{
+    struct na_ucx_class *priv = NA_UCX_CLASS(na_class);
+    na_return_t ret = NA_SUCCESS;
+
+    if (!priv)
+        goto out;
+
+    NA_CHECK_SUBSYS_ERROR(cls,
+        !HG_QUEUE_IS_EMPTY(&priv->pending_op_queue.queue), out, ret, NA_BUSY,
+        "Unexpected op queue should be empty");
+
+    /* Cancel conn recv */
+    if (priv->conn_request) {
+        ucp_request_cancel(priv->ucp_worker, priv->conn_request);
+        while (priv->conn_request)
+            (void) ucp_worker_progress(priv->ucp_worker);
+    }
+    while (!HG_QUEUE_IS_EMPTY(&priv->conn_queue.queue)) {
+        struct na_ucx_conn *na_ucx_conn =
+            HG_QUEUE_FIRST(&priv->conn_queue.queue);
+
+        HG_QUEUE_POP_HEAD(&priv->conn_queue.queue, entry);
+        free(na_ucx_conn);
+    }
+
+    /* Release addresses held by map */
+    if (priv->addr_map.map) {
+        hg_hash_table_iter_t iter;
+
+        hg_hash_table_iterate(priv->addr_map.map, &iter);
+        while (hg_hash_table_iter_has_more(&iter))
+            na_ucx_addr_decref(
+                (struct na_ucx_addr *) hg_hash_table_iter_next(&iter));
+        hg_hash_table_free(priv->addr_map.map);
+    }
+    if (priv->src_addr)
+        na_ucx_addr_decref(priv->src_addr);
+
+    if (priv->ucp_worker) {
+        /* Let endpoints close */
+        while (ucp_worker_progress(priv->ucp_worker) != 0)
+            ;
+        ucp_worker_destroy(priv->ucp_worker);
+    }
+    if (priv->ucp_context)
+        ucp_cleanup(priv->ucp_context);
+
+    hg_thread_rwlock_destroy(&priv->addr_map.lock);
+    hg_thread_spin_destroy(&priv->pending_op_queue.lock);
+    hg_thread_spin_destroy(&priv->conn_queue.lock);
+
+    if (priv->op_slab)
+        na_op_slab_destroy(priv->op_slab);
+    free(priv->conn_buf);
+    free(priv->protocol_name);
+    free(priv);
+    na_class->plugin_class = NULL;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_context_create(
+    na_class_t NA_UNUSED *na_class, void **context, na_uint16_t id)
+{
+    struct na_ucx_context *na_ucx_context = NULL;
+    na_return_t ret = NA_SUCCESS;
+
+    na_ucx_context =
+        (struct na_ucx_context *) malloc(sizeof(struct na_ucx_context));
+    NA_CHECK_SUBSYS_ERROR(ctx, na_ucx_context == NULL, out, ret, NA_NOMEM,
+        "Could not allocate UCX context");
+    na_ucx_context->id = id;
+
+    *context = na_ucx_context;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_context_destroy(na_class_t NA_UNUSED *na_class, void *context)
+{
+    free(context);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_op_id_t *
+na_ucx_op_create(na_class_t *na_class)
+{
+    struct na_ucx_op_id *na_ucx_op_id = NULL;
+
+    na_ucx_op_id = (struct na_ucx_op_id *) na_op_slab_alloc(
+        NA_UCX_CLASS(na_class)->op_slab);
+    NA_CHECK_SUBSYS_ERROR_NORET(op, na_ucx_op_id == NULL, out,
+        "Could not allocate NA UCX operation ID");
+    memset(na_ucx_op_id, 0, sizeof(struct na_ucx_op_id));
+
+    na_ucx_op_id->priv = NA_UCX_CLASS(na_class);
+    hg_thread_spin_init(&na_ucx_op_id->lock);
+
+    /* Completed by default */
+    hg_atomic_init32(&na_ucx_op_id->status, NA_UCX_OP_COMPLETED);
+
+    /* Set op ID release callbacks */
+    na_ucx_op_id->completion_data.plugin_callback = na_ucx_release;
+    na_ucx_op_id->completion_data.plugin_callback_args = na_ucx_op_id;
+
+out:
+    return (na_op_id_t *) na_ucx_op_id;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_op_destroy(na_class_t *na_class, na_op_id_t *op_id)
+{
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) op_id;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to free OP ID that was not completed");
+
+    hg_thread_spin_destroy(&na_ucx_op_id->lock);
+    na_op_slab_free(NA_UCX_CLASS(na_class)->op_slab, na_ucx_op_id);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_lookup(na_class_t *na_class, const char *name, na_addr_t *addr)
+{
+    struct na_ucx_addr *na_ucx_addr = NULL;
+    const char *hex = strstr(name, "://");
+    unsigned char *worker_addr = NULL;
+    size_t worker_addr_len, i;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Name is <protocol>://<hex encoded worker address> */
+    hex = (hex) ? hex + strlen("://") : name;
+    worker_addr_len = strlen(hex) / 2;
+    NA_CHECK_SUBSYS_ERROR(addr, worker_addr_len == 0 || strlen(hex) % 2, out,
+        ret, NA_INVALID_ARG, "Malformed address %s", name);
+
+    worker_addr = (unsigned char *) malloc(worker_addr_len);
+    NA_CHECK_SUBSYS_ERROR(addr, worker_addr == NULL, out, ret, NA_NOMEM,
+        "Could not allocate worker address");
+    for (i = 0; i < worker_addr_len; i++) {
+        unsigned int byte;
+
+        NA_CHECK_SUBSYS_ERROR(addr, sscanf(hex + 2 * i, "%2x", &byte) != 1,
+            out, ret, NA_INVALID_ARG, "Malformed address %s", name);
+        worker_addr[i] = (unsigned char) byte;
+    }
+
+    ret = na_ucx_addr_resolve(
+        NA_UCX_CLASS(na_class), worker_addr, worker_addr_len, &na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, out, ret, "Could not resolve %s", name);
+
+    *addr = (na_addr_t) na_ucx_addr;
+
+out:
+    free(worker_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_free(na_class_t NA_UNUSED *na_class, na_addr_t addr)
+{
+    if (addr)
+        na_ucx_addr_decref((struct na_ucx_addr *) addr);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_set_remove(na_class_t *na_class, na_addr_t addr)
+{
+    struct na_ucx_map *na_ucx_map = &NA_UCX_CLASS(na_class)->addr_map;
+    struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) addr;
+    na_bool_t removed = NA_FALSE;
+
+    if (na_ucx_addr->self)
+        return NA_SUCCESS;
+
+    hg_thread_rwlock_wrlock(&na_ucx_map->lock);
+    if (hg_hash_table_lookup(na_ucx_map->map,
+            (hg_hash_table_key_t) &na_ucx_addr->id) == na_ucx_addr)
+        removed = (hg_hash_table_remove(na_ucx_map->map,
+                       (hg_hash_table_key_t) &na_ucx_addr->id) != 0);
+    hg_thread_rwlock_release_wrlock(&na_ucx_map->lock);
+
+    /* Release reference held by map, peer address is sent again if looked
+     * up again */
+    if (removed)
+        na_ucx_addr_decref(na_ucx_addr);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_self(na_class_t *na_class, na_addr_t *addr)
+{
+    struct na_ucx_addr *src_addr = NA_UCX_CLASS(na_class)->src_addr;
+
+    hg_atomic_incr32_relaxed(&src_addr->ref_count);
+    *addr = (na_addr_t) src_addr;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_dup(
+    na_class_t NA_UNUSED *na_class, na_addr_t addr, na_addr_t *new_addr)
+{
+    hg_atomic_incr32_relaxed(&((struct na_ucx_addr *) addr)->ref_count);
+    *new_addr = addr;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_ucx_addr_cmp(
+    na_class_t NA_UNUSED *na_class, na_addr_t addr1, na_addr_t addr2)
+{
+    struct na_ucx_addr *na_ucx_addr1 = (struct na_ucx_addr *) addr1;
+    struct na_ucx_addr *na_ucx_addr2 = (struct na_ucx_addr *) addr2;
+
+    return (na_ucx_addr1 == na_ucx_addr2) ||
+           (na_ucx_addr1->worker_addr_len == na_ucx_addr2->worker_addr_len &&
+               memcmp(na_ucx_addr1->worker_addr, na_ucx_addr2->worker_addr,
+                   na_ucx_addr1->worker_addr_len) == 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_ucx_addr_is_self(na_class_t NA_UNUSED *na_class, na_addr_t addr)
+{
+    return ((struct na_ucx_addr *) addr)->self;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_to_string(
+    na_class_t *na_class, char *buf, na_size_t *buf_size, na_addr_t addr)
+{
+    struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) addr;
+    const char *protocol_name = NA_UCX_CLASS(na_class)->protocol_name;
+    const unsigned char *worker_addr =
+        (const unsigned char *) na_ucx_addr->worker_addr;
+    na_size_t string_len;
+    na_return_t ret = NA_SUCCESS;
+    size_t i;
+
+    string_len = strlen(protocol_name) + strlen("://") +
+                 2 * na_ucx_addr->worker_addr_len;
+    if (buf) {
+        char *buf_ptr = buf;
+
+        NA_CHECK_SUBSYS_ERROR(addr, string_len >= *buf_size, out, ret,
+            NA_OVERFLOW, "Buffer size too small to copy addr");
+        buf_ptr += sprintf(buf_ptr, "%s://", protocol_name);
+        for (i = 0; i < na_ucx_addr->worker_addr_len; i++)
+            buf_ptr += sprintf(buf_ptr, "%02x", worker_addr[i]);
+    }
+    *buf_size = string_len + 1;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_size_t
+na_ucx_addr_get_serialize_size(na_class_t NA_UNUSED *na_class, na_addr_t addr)
+{
+    return sizeof(na_uint64_t) + ((struct na_ucx_addr *) addr)->worker_addr_len;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_serialize(na_class_t NA_UNUSED *na_class, void *buf,
+    na_size_t buf_size, na_addr_t addr)
+{
+    struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) addr;
+    na_uint64_t len = (na_uint64_t) na_ucx_addr->worker_addr_len;
+    char *buf_ptr = (char *) buf;
+    na_size_t buf_size_left = buf_size;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left, &len, na_uint64_t);
+    NA_ENCODE_ARRAY(out, ret, buf_ptr, buf_size_left, na_ucx_addr->worker_addr,
+        char, na_ucx_addr->worker_addr_len);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_deserialize(na_class_t *na_class, na_addr_t *addr,
+    const void *buf, na_size_t buf_size)
+{
+    struct na_ucx_addr *na_ucx_addr = NULL;
+    const char *buf_ptr = (const char *) buf;
+    na_size_t buf_size_left = buf_size;
+    na_uint64_t len;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_DECODE(out, ret, buf_ptr, buf_size_left, &len, na_uint64_t);
+    NA_CHECK_SUBSYS_ERROR(addr, len == 0 || len > buf_size_left, out, ret,
+        NA_OVERFLOW, "Invalid worker address length (%" PRIu64 ")", len);
+
+    ret = na_ucx_addr_resolve(
+        NA_UCX_CLASS(na_class), buf_ptr, (size_t) len, &na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, out, ret, "Could not resolve address");
+
+    *addr = (na_addr_t) na_ucx_addr;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_size_t
+na_ucx_msg_get_max_unexpected_size(const na_class_t *na_class)
+{
+    return NA_UCX_CLASS(na_class)->unexpected_size_max;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_size_t
+na_ucx_msg_get_max_expected_size(const na_class_t *na_class)
+{
+    return NA_UCX_CLASS(na_class)->expected_size_max;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_tag_t
+na_ucx_msg_get_max_tag(const na_class_t NA_UNUSED *na_class)
+{
+    return NA_UCX_MAX_TAG;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_msg_send(struct na_ucx_class *priv, na_context_t *context,
+    na_cb_type_t type, na_cb_t callback, void *arg, const void *buf,
+    na_size_t buf_size, struct na_ucx_addr *na_ucx_addr, ucp_tag_t ucp_tag,
+    struct na_ucx_op_id *na_ucx_op_id)
+{
+    ucp_request_param_t param;
+    ucs_status_ptr_t request;
+    na_return_t ret;
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_ucx_op_id == NULL, out, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    ret = na_ucx_addr_connect(priv, na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(msg, out, ret, "Could not send address to peer");
+
+    na_ucx_op_id->context = context;
+    na_ucx_op_id->completion_data.callback_info.type = type;
+    na_ucx_op_id->completion_data.callback = callback;
+    na_ucx_op_id->completion_data.callback_info.arg = arg;
+    hg_atomic_incr32_relaxed(&na_ucx_addr->ref_count);
+    na_ucx_op_id->addr = na_ucx_addr;
+    na_ucx_op_id->request = NULL;
+    na_ucx_op_id->released = NA_FALSE;
+    hg_atomic_set32(&na_ucx_op_id->status, 0);
+
+    memset(&param, 0, sizeof(param));
+    param.op_attr_mask =
+        UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+    param.cb.send = na_ucx_send_cb;
+    param.user_data = na_ucx_op_id;
+
+    request =
+        ucp_tag_send_nbx(na_ucx_addr->ucp_ep, buf, buf_size, ucp_tag, &param);
+    NA_CHECK_SUBSYS_ERROR(msg, UCS_PTR_IS_ERR(request), error, ret,
+        na_ucx_status_to_na(UCS_PTR_STATUS(request)),
+        "ucp_tag_send_nbx() failed (%s)",
+        ucs_status_string(UCS_PTR_STATUS(request)));
+
+    if (request == NULL)
+        na_ucx_complete(na_ucx_op_id, NA_SUCCESS);
+    else
+        na_ucx_op_set_request(na_ucx_op_id, request);
+
+out:
+    return ret;
+
+error:
+    na_ucx_addr_decref(na_ucx_addr);
+    na_ucx_op_id->addr = NULL;
+    hg_atomic_set32(&na_ucx_op_id->status, NA_UCX_OP_COMPLETED);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_msg_recv(struct na_ucx_class *priv, na_context_t *context,
+    na_cb_type_t type, na_cb_t callback, void *arg, void *buf,
+    na_size_t buf_size, ucp_tag_t ucp_tag, ucp_tag_t ucp_tag_mask,
+    struct na_ucx_op_id *na_ucx_op_id)
+{
+    ucp_request_param_t param;
+    ucs_status_ptr_t request;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_ucx_op_id == NULL, out, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_COMPLETED), out,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed");
+
+    na_ucx_op_id->context = context;
+    na_ucx_op_id->completion_data.callback_info.type = type;
+    na_ucx_op_id->completion_data.callback = callback;
+    na_ucx_op_id->completion_data.callback_info.arg = arg;
+    na_ucx_op_id->addr = NULL;
+    na_ucx_op_id->request = NULL;
+    na_ucx_op_id->released = NA_FALSE;
+    na_ucx_op_id->msg.buf.ptr = buf;
+    na_ucx_op_id->msg.buf_size = buf_size;
+    na_ucx_op_id->msg.actual_buf_size = 0;
+    na_ucx_op_id->msg.tag = 0;
+    hg_atomic_set32(&na_ucx_op_id->status, 0);
+
+    memset(&param, 0, sizeof(param));
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                         UCP_OP_ATTR_FIELD_USER_DATA |
+                         UCP_OP_ATTR_FIELD_RECV_INFO;
+    param.cb.recv = na_ucx_recv_cb;
+    param.user_data = na_ucx_op_id;
+    param.recv_info.tag_info = &na_ucx_op_id->msg.tag_info;
+
+    request = ucp_tag_recv_nbx(
+        priv->ucp_worker, buf, buf_size, ucp_tag, ucp_tag_mask, &param);
+    NA_CHECK_SUBSYS_ERROR(msg, UCS_PTR_IS_ERR(request), error, ret,
+        na_ucx_status_to_na(UCS_PTR_STATUS(request)),
+        "ucp_tag_recv_nbx() failed (%s)",
+        ucs_status_string(UCS_PTR_STATUS(request)));
+
+    if (request == NULL)
+        na_ucx_recv_process(
+            na_ucx_op_id, UCS_OK, &na_ucx_op_id->msg.tag_info);
+    else
+        na_ucx_op_set_request(na_ucx_op_id, request);
+
+out:
+    return ret;
+
+error:
+    hg_atomic_set32(&na_ucx_op_id->status, NA_UCX_OP_COMPLETED);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t dest_addr,
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+{
+    struct na_ucx_class *priv = NA_UCX_CLASS(na_class);
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size > priv->unexpected_size_max, out, ret,
+        NA_OVERFLOW, "Exceeds unexpected size, %zu", buf_size);
+
+    ret = na_ucx_msg_send(priv, context, NA_CB_SEND_UNEXPECTED, callback, arg,
+        buf, buf_size, (struct na_ucx_addr *) dest_addr,
+        NA_UCX_TAG(NA_UCX_TAG_UNEXPECTED, priv->src_addr->id, tag),
+        (struct na_ucx_op_id *) op_id);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void NA_UNUSED *plugin_data, na_op_id_t *op_id)
+{
+    return na_ucx_msg_recv(NA_UCX_CLASS(na_class), context,
+        NA_CB_RECV_UNEXPECTED, callback, arg, buf, buf_size,
+        NA_UCX_TAG_UNEXPECTED, NA_UCX_TAG_FLAGS,
+        (struct na_ucx_op_id *) op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_msg_send_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, na_size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t dest_addr,
+    na_uint16_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+{
+    struct na_ucx_class *priv = NA_UCX_CLASS(na_class);
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size > priv->expected_size_max, out, ret,
+        NA_OVERFLOW, "Exceeds expected size, %zu", buf_size);
+
+    ret = na_ucx_msg_send(priv, context, NA_CB_SEND_EXPECTED, callback, arg,
+        buf, buf_size, (struct na_ucx_addr *) dest_addr,
+        NA_UCX_TAG(0, priv->src_addr->id, tag), (struct na_ucx_op_id *) op_id);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_msg_recv_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, na_size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t source_addr,
+    na_uint16_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
+{
+    struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) source_addr;
+
+    return na_ucx_msg_recv(NA_UCX_CLASS(na_class), context,
+        NA_CB_RECV_EXPECTED, callback, arg, buf, buf_size,
+        NA_UCX_TAG(0, na_ucx_addr->id, tag), NA_UCX_TAG_ALL,
+        (struct na_ucx_op_id *) op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_mem_handle_create(na_class_t NA_UNUSED *na_class, void *buf,
+    na_size_t buf_size, unsigned long flags, na_mem_handle_t *mem_handle)
+{
+    struct na_ucx_mem_handle *na_ucx_mem_handle = NULL;
+    na_return_t ret = NA_SUCCESS;
+
+    na_ucx_mem_handle = (struct na_ucx_mem_handle *) calloc(
+        1, sizeof(struct na_ucx_mem_handle));
+    NA_CHECK_SUBSYS_ERROR(mem, na_ucx_mem_handle == NULL, out, ret, NA_NOMEM,
+        "Could not allocate NA UCX memory handle");
+
+    na_ucx_mem_handle->base = (na_ptr_t) buf;
+    na_ucx_mem_handle->len = (na_uint64_t) buf_size;
+    na_ucx_mem_handle->flags = (na_uint8_t) (flags & 0xff);
+    hg_thread_spin_init(&na_ucx_mem_handle->rkey_lock);
+
+    *mem_handle = (na_mem_handle_t) na_ucx_mem_handle;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_mem_handle_free(
+    na_class_t NA_UNUSED *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_ucx_mem_handle *na_ucx_mem_handle =
+        (struct na_ucx_mem_handle *) mem_handle;
+
+    while (na_ucx_mem_handle->rkeys) {
+        struct na_ucx_rkey *na_ucx_rkey = na_ucx_mem_handle->rkeys;
+
+        na_ucx_mem_handle->rkeys = na_ucx_rkey->next;
+        ucp_rkey_destroy(na_ucx_rkey->ucp_rkey);
+        free(na_ucx_rkey);
+    }
+    if (na_ucx_mem_handle->remote)
+        free(na_ucx_mem_handle->rkey_buf);
+    hg_thread_spin_destroy(&na_ucx_mem_handle->rkey_lock);
+    free(na_ucx_mem_handle);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_ucx_class *priv = NA_UCX_CLASS(na_class);
+    struct na_ucx_mem_handle *na_ucx_mem_handle =
+        (struct na_ucx_mem_handle *) mem_handle;
+    ucp_mem_map_params_t mem_map_params;
+    size_t rkey_buf_size = 0;
+    ucs_status_t status;
+    na_return_t ret = NA_SUCCESS;
+
+    memset(&mem_map_params, 0, sizeof(mem_map_params));
+    mem_map_params.field_mask =
+        UCP_MEM_MAP_PARAM_FIELD_ADDRESS | UCP_MEM_MAP_PARAM_FIELD_LENGTH;
+    mem_map_params.address = (void *) na_ucx_mem_handle->base;
+    mem_map_params.length = (size_t) na_ucx_mem_handle->len;
+
+    status = ucp_mem_map(
+        priv->ucp_context, &mem_map_params, &na_ucx_mem_handle->ucp_memh);
+    NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, out, ret,
+        na_ucx_status_to_na(status), "ucp_mem_map() failed (%s)",
+        ucs_status_string(status));
+
+    status = ucp_rkey_pack(priv->ucp_context, na_ucx_mem_handle->ucp_memh,
+        &na_ucx_mem_handle->rkey_buf, &rkey_buf_size);
+    if (status != UCS_OK) {
+        (void) ucp_mem_unmap(priv->ucp_context, na_ucx_mem_handle->ucp_memh);
+        na_ucx_mem_handle->ucp_memh = NULL;
+        NA_GOTO_SUBSYS_ERROR(mem, out, ret, na_ucx_status_to_na(status),
+            "ucp_rkey_pack() failed (%s)", ucs_status_string(status));
+    }
+    na_ucx_mem_handle->rkey_buf_size = (na_uint64_t) rkey_buf_size;
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_ucx_class *priv = NA_UCX_CLASS(na_class);
+    struct na_ucx_mem_handle *na_ucx_mem_handle =
+        (struct na_ucx_mem_handle *) mem_handle;
+    ucs_status_t status;
+    na_return_t ret = NA_SUCCESS;
+
+    if (na_ucx_mem_handle->ucp_memh == NULL)
+        goto out;
+
+    ucp_rkey_buffer_release(na_ucx_mem_handle->rkey_buf);
+    na_ucx_mem_handle->rkey_buf = NULL;
+    na_ucx_mem_handle->rkey_buf_size = 0;
+
+    status = ucp_mem_unmap(priv->ucp_context, na_ucx_mem_handle->ucp_memh);
+    na_ucx_mem_handle->ucp_memh = NULL;
+    NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, out, ret,
+        na_ucx_status_to_na(status), "ucp_mem_unmap() failed (%s)",
+        ucs_status_string(status));
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_size_t
+na_ucx_mem_handle_get_serialize_size(
+    na_class_t NA_UNUSED *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_ucx_mem_handle *na_ucx_mem_handle =
+        (struct na_ucx_mem_handle *) mem_handle;
+
+    return sizeof(na_ptr_t) + 2 * sizeof(na_uint64_t) + sizeof(na_uint8_t) +
+           (na_size_t) na_ucx_mem_handle->rkey_buf_size;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_mem_handle_serialize(na_class_t NA_UNUSED *na_class, void *buf,
+    na_size_t buf_size, na_mem_handle_t mem_handle)
+{
+    struct na_ucx_mem_handle *na_ucx_mem_handle =
+        (struct na_ucx_mem_handle *) mem_handle;
+    char *buf_ptr = (char *) buf;
+    na_size_t buf_size_left = buf_size;
+    na_return_t ret = NA_SUCCESS;
+
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left, &na_ucx_mem_handle->base,
+        na_ptr_t);
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left, &na_ucx_mem_handle->len,
+        na_uint64_t);
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left, &na_ucx_mem_handle->flags,
+        na_uint8_t);
+    NA_ENCODE(out, ret, buf_ptr, buf_size_left,
+        &na_ucx_mem_handle->rkey_buf_size, na_uint64_t);
+    NA_ENCODE_ARRAY(out, ret, buf_ptr, buf_size_left,
+        na_ucx_mem_handle->rkey_buf, char, na_ucx_mem_handle->rkey_buf_size);
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
+    na_mem_handle_t *mem_handle, const void *buf, na_size_t buf_size)
+{
+    struct na_ucx_mem_handle *na_ucx_mem_handle = NULL;
+    const char *buf_ptr = (const char *) buf;
+    na_size_t buf_size_left = buf_size;
+    na_return_t ret = NA_SUCCESS;
+
+    na_ucx_mem_handle = (struct na_ucx_mem_handle *) calloc(
+        1, sizeof(struct na_ucx_mem_handle));
+    NA_CHECK_SUBSYS_ERROR(mem, na_ucx_mem_handle == NULL, error, ret,
+        NA_NOMEM, "Could not allocate NA UCX memory handle");
+    na_ucx_mem_handle->remote = NA_TRUE;
+    hg_thread_spin_init(&na_ucx_mem_handle->rkey_lock);
+
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_ucx_mem_handle->base,
+        na_ptr_t);
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_ucx_mem_handle->len,
+        na_uint64_t);
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_ucx_mem_handle->flags,
+        na_uint8_t);
+    NA_DECODE(error, ret, buf_ptr, buf_size_left,
+        &na_ucx_mem_handle->rkey_buf_size, na_uint64_t);
+    NA_CHECK_SUBSYS_ERROR(mem,
+        na_ucx_mem_handle->rkey_buf_size == 0 ||
+            na_ucx_mem_handle->rkey_buf_size > buf_size_left,
+        error, ret, NA_OVERFLOW, "Invalid remote key size");
+
+    na_ucx_mem_handle->rkey_buf =
+        malloc((size_t) na_ucx_mem_handle->rkey_buf_size);
+    NA_CHECK_SUBSYS_ERROR(mem, na_ucx_mem_handle->rkey_buf == NULL, error, ret,
+        NA_NOMEM, "Could not allocate remote key");
+    NA_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left,
+        na_ucx_mem_handle->rkey_buf, char, na_ucx_mem_handle->rkey_buf_size);
+
+    *mem_handle = (na_mem_handle_t) na_ucx_mem_handle;
+
+    return ret;
+
+error:
+    if (na_ucx_mem_handle) {
+        free(na_ucx_mem_handle->rkey_buf);
+        hg_thread_spin_destroy(&na_ucx_mem_handle->rkey_lock);
+        free(na_ucx_mem_handle);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
+    na_op_id_t *op_id)
+{
+    return na_ucx_rma(NA_UCX_CLASS(na_class), context, NA_CB_PUT, callback,
+        arg, (struct na_ucx_mem_handle *) local_mem_handle, local_offset,
+        (struct na_ucx_mem_handle *) remote_mem_handle, remote_offset, length,
+        (struct na_ucx_addr *) remote_addr, (struct na_ucx_op_id *) op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_offset_t remote_offset,
+    na_size_t length, na_addr_t remote_addr, na_uint16_t NA_UNUSED remote_id,
+    na_op_id_t *op_id)
+{
+    return na_ucx_rma(NA_UCX_CLASS(na_class), context, NA_CB_GET, callback,
+        arg, (struct na_ucx_mem_handle *) local_mem_handle, local_offset,
+        (struct na_ucx_mem_handle *) remote_mem_handle, remote_offset, length,
+        (struct na_ucx_addr *) remote_addr, (struct na_ucx_op_id *) op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+na_ucx_poll_get_fd(na_class_t *na_class, na_context_t NA_UNUSED *context)
+{
+    return NA_UCX_CLASS(na_class)->efd;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_ucx_poll_try_wait(na_class_t *na_class, na_context_t NA_UNUSED *context)
+{
+    struct na_ucx_class *priv = NA_UCX_CLASS(na_class);
+    ucs_status_t status;
+
+    if (priv->no_wait)
+        return NA_FALSE;
+
+    /* Addresses received must be processed first */
+    if (!HG_QUEUE_IS_EMPTY(&priv->conn_queue.queue) ||
+        hg_atomic_get32(&priv->conn_repost))
+        return NA_FALSE;
+
+    /* Safe to block only once worker is armed */
+    status = ucp_worker_arm(priv->ucp_worker);
+    if (status == UCS_OK)
+        return NA_TRUE;
+
+    NA_CHECK_SUBSYS_ERROR_DONE(poll, status != UCS_ERR_BUSY,
+        "ucp_worker_arm() failed (%s)", ucs_status_string(status));
+
+    return NA_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_progress(
+    na_class_t *na_class, na_context_t NA_UNUSED *context, unsigned int timeout)
+{
+    struct na_ucx_class *priv = NA_UCX_CLASS(na_class);
+    /* Convert timeout in ms into seconds */
+    double remaining = timeout / 1000.0;
+    na_return_t ret;
+
+    do {
+        na_bool_t progressed = NA_FALSE;
+        hg_time_t t1, t2;
+
+        if (timeout)
+            hg_time_get_current_ms(&t1);
+
+        if (ucp_worker_progress(priv->ucp_worker) > 0)
+            progressed = NA_TRUE;
+
+        ret = na_ucx_conn_process(priv, &progressed);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            poll, error, ret, "Could not process peer addresses");
+
+        if (progressed)
+            return NA_SUCCESS;
+
+        /* Block on event fd until worker has events */
+        if (timeout && na_ucx_poll_try_wait(na_class, context)) {
+            struct pollfd fds = {.fd = priv->efd, .events = POLLIN};
+            int rc = poll(&fds, 1, (int) (remaining * 1000.0));
+
+            NA_CHECK_SUBSYS_ERROR(poll, rc < 0 && errno != EINTR, error, ret,
+                NA_PROTOCOL_ERROR, "poll() failed (%s)", strerror(errno));
+        }
+
+        if (timeout) {
+            hg_time_get_current_ms(&t2);
+            remaining -= hg_time_diff(t2, t1);
+        }
+    } while ((int) (remaining * 1000.0) > 0);
+
+    return NA_TIMEOUT;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_cancel(na_class_t *na_class, na_context_t NA_UNUSED *context,
+    na_op_id_t *op_id)
+{
+    struct na_ucx_class *priv = NA_UCX_CLASS(na_class);
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) op_id;
+    na_bool_t canceled = NA_FALSE;
+    hg_util_int32_t status;
+
+    /* Exit if op has already completed */
+    status = hg_atomic_or32(&na_ucx_op_id->status, NA_UCX_OP_CANCELED);
+    if (status & NA_UCX_OP_COMPLETED)
+        goto out;
+
+    NA_LOG_SUBSYS_DEBUG(op, "Canceling operation ID %p", na_ucx_op_id);
+
+    switch (na_ucx_op_id->completion_data.callback_info.type) {
+        case NA_CB_RECV_UNEXPECTED:
+            /* Received but waiting for address of peer */
+            hg_thread_spin_lock(&priv->pending_op_queue.lock);
+            if (hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_QUEUED) {
+                HG_QUEUE_REMOVE(&priv->pending_op_queue.queue, na_ucx_op_id,
+                    na_ucx_op_id, entry);
+                hg_atomic_and32(&na_ucx_op_id->status, ~NA_UCX_OP_QUEUED);
+                canceled = NA_TRUE;
+            }
+            hg_thread_spin_unlock(&priv->pending_op_queue.lock);
+            if (canceled) {
+                na_ucx_complete(na_ucx_op_id, NA_CANCELED);
+                break;
+            }
+            /* fall through */
+        case NA_CB_RECV_EXPECTED:
+            /* Request completes with UCS_ERR_CANCELED if not matched yet */
+            hg_thread_spin_lock(&na_ucx_op_id->lock);
+            if (na_ucx_op_id->request)
+                ucp_request_cancel(priv->ucp_worker, na_ucx_op_id->request);
+            hg_thread_spin_unlock(&na_ucx_op_id->lock);
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+        case NA_CB_SEND_EXPECTED:
+        case NA_CB_PUT:
+        case NA_CB_GET:
+            /* UCP cannot cancel sends and RMA operations, they complete or
+             * fail once the endpoint fails */
+            break;
+        default:
+            NA_LOG_SUBSYS_ERROR(op, "Operation type %d not supported",
+                na_ucx_op_id->completion_data.callback_info.type);
+            break;
+    }
+
+out:
+    return NA_SUCCESS;
+}
@@ -9,6 +9,8 @@
  */
 
 #include "mercury_proc_string.h"
+#include "mercury_class_proc.h"
+#include "mercury_error.h"
 
 /****************/
 /* Local Macros */
@@ -36,6 +38,7 @@ hg_proc_hg_string_object_t(hg_proc_t proc, void *string)
 
     switch (hg_proc_get_op(proc)) {
         case HG_ENCODE:
+        case HG_SIZE:
             string_len = (strobj->data) ? strlen(strobj->data) + 1 : 0;
             ret = hg_proc_uint64_t(proc, &string_len);
             if (ret != HG_SUCCESS)
@@ -59,31 +62,22 @@ hg_proc_hg_string_object_t(hg_proc_t proc, void *string)
             if (ret != HG_SUCCESS)
                 goto done;
             if (string_len) {
-                strobj->data = (char *) malloc(string_len);
-                if (strobj->data == NULL) {
-                    ret = HG_NOMEM;
-                    goto done;
-                }
-                ret = hg_proc_bytes(proc, strobj->data, string_len);
-                if (ret != HG_SUCCESS) {
-                    free(strobj->data);
-                    strobj->data = NULL;
+                /* In borrow mode, data points into the proc buffer, in arena
+                 * mode, it is allocated from the proc arena */
+                ret = hg_proc_bytes_ptr(
+                    proc, (void **) &strobj->data, (hg_size_t) string_len);
+                if (ret != HG_SUCCESS)
                     goto done;
-                }
                 ret =
                     hg_proc_hg_uint8_t(proc, (hg_uint8_t *) &strobj->is_const);
-                if (ret != HG_SUCCESS) {
-                    free(strobj->data);
-                    strobj->data = NULL;
-                    goto done;
-                }
+                if (ret != HG_SUCCESS)
+                    goto error;
                 ret =
                     hg_proc_hg_uint8_t(proc, (hg_uint8_t *) &strobj->is_owned);
-                if (ret != HG_SUCCESS) {
-                    free(strobj->data);
-                    strobj->data = NULL;
-                    goto done;
-                }
+                if (ret != HG_SUCCESS)
+                    goto error;
+                if (!HG_PROC_IS_OWNED(proc))
+                    strobj->is_owned = HG_FALSE;
             } else
                 strobj->data = NULL;
             break;
@@ -96,6 +90,104 @@ hg_proc_hg_string_object_t(hg_proc_t proc, void *string)
             break;
     }
 
+done:
+    return ret;
+
+error:
+    if (HG_PROC_IS_OWNED(proc))
+        free(strobj->data);
+    strobj->data = NULL;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#if defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__ >= 406) &&           \
+    !defined(__INTEL_COMPILER)
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wcast-qual"
+#endif
+hg_return_t
+hg_proc_hg_key_t(hg_proc_t proc, void *data)
+{
+    hg_key_t *key = (hg_key_t *) data;
+    hg_uint32_t size = 0;
+    char *buf;
+    hg_return_t ret = HG_SUCCESS;
+
+    switch (hg_proc_get_op(proc)) {
+        case HG_ENCODE:
+        case HG_SIZE:
+            size = (key->data) ? key->len + 1 : 0;
+            ret = hg_proc_hg_uint64_t(proc, &key->hash);
+            HG_CHECK_HG_ERROR(done, ret, "Could not proc key hash");
+            ret = hg_proc_hg_uint32_t(proc, &size);
+            HG_CHECK_HG_ERROR(done, ret, "Could not proc key size");
+            if (size == 0)
+                break;
+
+            buf = (char *) hg_proc_save_ptr(proc, size);
+            HG_CHECK_ERROR(buf == NULL, done, ret, HG_NOMEM,
+                "Could not get pointer to proc buffer");
+            memcpy(buf, key->data, key->len);
+            buf[key->len] = '\0';
+            hg_proc_restore_ptr(proc, buf, size);
+            break;
+        case HG_DECODE: {
+            const char *interned = NULL;
+
+            ret = hg_proc_hg_uint64_t(proc, &key->hash);
+            HG_CHECK_HG_ERROR(done, ret, "Could not proc key hash");
+            ret = hg_proc_hg_uint32_t(proc, &size);
+            HG_CHECK_HG_ERROR(done, ret, "Could not proc key size");
+            key->is_owned = HG_FALSE;
+            if (size == 0) {
+                key->data = NULL;
+                key->len = 0;
+                break;
+            }
+
+            HG_CHECK_ERROR(hg_proc_get_size_left(proc) < size, done, ret,
+                HG_OVERFLOW, "Key size exceeds buffer size (%u)", size);
+            buf = (char *) hg_proc_save_ptr(proc, size);
+            HG_CHECK_ERROR(buf == NULL, done, ret, HG_NOMEM,
+                "Could not get pointer to proc buffer");
+            HG_CHECK_ERROR(buf[size - 1] != '\0', done, ret,
+                HG_PROTOCOL_ERROR, "Key is not NUL-terminated");
+            key->len = size - 1;
+
+            if (HG_PROC_IS_INTERN(proc))
+                interned = hg_class_intern_key(
+                    hg_proc_get_class(proc), buf, key->len, key->hash);
+            if (interned)
+                key->data = interned;
+            else if (HG_PROC_IS_BORROW(proc))
+                key->data = buf;
+            else {
+                char *copy = (char *) hg_proc_alloc(proc, size);
+                HG_CHECK_ERROR(copy == NULL, done, ret, HG_NOMEM,
+                    "Could not allocate key");
+                memcpy(copy, buf, size);
+                key->data = copy;
+                key->is_owned = (hg_bool_t) HG_PROC_IS_OWNED(proc);
+            }
+            hg_proc_restore_ptr(proc, buf, size);
+            break;
+        }
+        case HG_FREE:
+            if (key->is_owned)
+                free((void *) key->data);
+            key->data = NULL;
+            key->is_owned = HG_FALSE;
+            break;
+        default:
+            break;
+    }
+
 done:
     return ret;
 }
+#if defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__ >= 406) &&           \
+    !defined(__INTEL_COMPILER)
+#    pragma GCC diagnostic pop
+#endif
@@ -68,6 +68,21 @@ hg_proc_hg_string_t(hg_proc_t proc, void *data);
 HG_PUBLIC hg_return_t
 hg_proc_hg_string_object_t(hg_proc_t proc, void *string);
 
+/**
+ * Processing routine for keys. The hash and length of the key are sent along
+ * with the key string and are not recomputed when decoding. When decoding,
+ * the key string is looked up in the class intern table if the HG_PROC_INTERN
+ * flag is set, in which case it remains valid until HG_Finalize() is called.
+ * Otherwise it is borrowed or copied as described in hg_proc_bytes_ptr().
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param key [IN/OUT]          pointer to hg_key_t
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_hg_key_t(hg_proc_t proc, void *key);
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -82,6 +97,7 @@ hg_proc_hg_const_string_t(hg_proc_t proc, void *data)
 
     switch (hg_proc_get_op(proc)) {
         case HG_ENCODE:
+        case HG_SIZE:
             hg_string_object_init_const_char(&string, *strdata, 0);
             ret = hg_proc_hg_string_object_t(proc, &string);
             if (ret != HG_SUCCESS)
@@ -96,7 +112,9 @@ hg_proc_hg_const_string_t(hg_proc_t proc, void *data)
             hg_string_object_free(&string);
             break;
         case HG_FREE:
-            hg_string_object_init_const_char(&string, *strdata, 1);
+            /* Borrowed and arena strings are not owned */
+            hg_string_object_init_const_char(
+                &string, *strdata, (hg_bool_t) HG_PROC_IS_OWNED(proc));
             ret = hg_proc_hg_string_object_t(proc, &string);
             if (ret != HG_SUCCESS)
                 goto done;
@@ -119,6 +137,7 @@ hg_proc_hg_string_t(hg_proc_t proc, void *data)
 
     switch (hg_proc_get_op(proc)) {
         case HG_ENCODE:
+        case HG_SIZE:
             hg_string_object_init_char(&string, *strdata, 0);
             ret = hg_proc_hg_string_object_t(proc, &string);
             if (ret != HG_SUCCESS)
@@ -133,7 +152,9 @@ hg_proc_hg_string_t(hg_proc_t proc, void *data)
             hg_string_object_free(&string);
             break;
         case HG_FREE:
-            hg_string_object_init_char(&string, *strdata, 1);
+            /* Borrowed and arena strings are not owned */
+            hg_string_object_init_char(
+                &string, *strdata, (hg_bool_t) HG_PROC_IS_OWNED(proc));
             ret = hg_proc_hg_string_object_t(proc, &string);
             if (ret != HG_SUCCESS)
                 goto done;
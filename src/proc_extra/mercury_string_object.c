@@ -11,6 +11,8 @@
 #include "mercury_string_object.h"
 #include "mercury_error.h"
 
+#include "mercury_hash_string.h"
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -125,3 +127,22 @@ hg_string_object_swap(hg_string_object_t *string, char *s)
 
     return old;
 }
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_key_init(hg_key_t *key, const char *s)
+{
+    hg_return_t ret = HG_SUCCESS;
+    size_t len = (s) ? strlen(s) : 0;
+
+    HG_CHECK_ERROR(len > UINT32_MAX - 1, done, ret, HG_OVERFLOW,
+        "Key length exceeds maximum (%zu)", len);
+
+    key->data = s;
+    key->len = (hg_uint32_t) len;
+    key->hash = (s) ? hg_hash_string64(s, len) : 0;
+    key->is_owned = HG_FALSE;
+
+done:
+    return ret;
+}
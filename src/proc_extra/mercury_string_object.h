@@ -13,6 +13,8 @@
 
 #include "mercury_types.h"
 
+#include <string.h>
+
 /*************************************/
 /* Public Type and Struct Definition */
 /*************************************/
@@ -23,6 +25,15 @@ typedef struct hg_string_object {
     hg_bool_t is_owned;
 } hg_string_object_t;
 
+/* String key that carries its length and a precomputed hash, so that
+ * lookups on decoded keys do not need to rehash the string */
+typedef struct hg_key {
+    const char *data;   /* NUL-terminated key string */
+    hg_uint64_t hash;   /* Hash of key string */
+    hg_uint32_t len;    /* Length of key string (without NUL) */
+    hg_bool_t is_owned; /* Key string must be freed */
+} hg_key_t;
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -102,6 +113,44 @@ hg_string_object_dup(hg_string_object_t string, hg_string_object_t *new_string);
 HG_PUBLIC char *
 hg_string_object_swap(hg_string_object_t *string, char *s);
 
+/**
+ * Initialize a key from the string pointed to by s, the key does not own
+ * that string.
+ *
+ * \param key [OUT]             pointer to key structure
+ * \param s [IN]                pointer to string
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_key_init(hg_key_t *key, const char *s);
+
+/**
+ * Compare two keys.
+ *
+ * \param key1 [IN]             pointer to key structure
+ * \param key2 [IN]             pointer to key structure
+ *
+ * \return HG_TRUE if keys are equal, HG_FALSE otherwise
+ */
+static HG_INLINE hg_bool_t
+hg_key_equal(const hg_key_t *key1, const hg_key_t *key2);
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_key_equal(const hg_key_t *key1, const hg_key_t *key2)
+{
+    if (key1->hash != key2->hash || key1->len != key2->len)
+        return HG_FALSE;
+    if (key1->data == key2->data)
+        return HG_TRUE;
+
+    return (key1->data && key2->data &&
+               memcmp(key1->data, key2->data, key1->len) == 0)
+               ? HG_TRUE
+               : HG_FALSE;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -55,10 +55,34 @@ typedef struct {
 #    error "Not supported on this platform."
 #endif
 
+/* For busy loop spinning */
+#ifndef cpu_spinwait
+#    if defined(_WIN32)
+#        define cpu_spinwait YieldProcessor
+#    elif defined(__x86_64__) || defined(__i386__)
+#        include <immintrin.h>
+#        define cpu_spinwait _mm_pause
+#    elif defined(__arm__) || defined(__aarch64__)
+#        define cpu_spinwait() __asm__ __volatile__("yield")
+#    else
+#        warning "Processor yield is not supported on this architecture."
+#        define cpu_spinwait(x)
+#    endif
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * Unless stated otherwise, loads have acquire semantics, stores have release
+ * semantics and read-modify-write operations have acquire-release semantics.
+ * The _relaxed variants below only guarantee atomicity and may be used where
+ * ordering is already provided by another operation (e.g., a counter or an
+ * index that is published through a release store). Backends that do not
+ * support explicit orderings fall back to the default operations.
+ */
+
 /**
  * Init atomic value (32-bit integer).
  *
@@ -202,6 +226,17 @@ hg_atomic_incr64(hg_atomic_int64_t *ptr);
 static HG_UTIL_INLINE hg_util_int64_t
 hg_atomic_decr64(hg_atomic_int64_t *ptr);
 
+/**
+ * Add value to atomic value (64-bit integer).
+ *
+ * \param ptr [IN/OUT]          pointer to an atomic64 integer
+ * \param value [IN]            value to add
+ *
+ * \return Original value
+ */
+static HG_UTIL_INLINE hg_util_int64_t
+hg_atomic_add64(hg_atomic_int64_t *ptr, hg_util_int64_t value);
+
 /**
  * OR atomic value (64-bit integer).
  *
@@ -250,12 +285,111 @@ hg_atomic_cas64(hg_atomic_int64_t *ptr, hg_util_int64_t compare_value,
     hg_util_int64_t swap_value);
 
 /**
- * Memory barrier.
+ * Memory barrier (full barrier, also orders stores with subsequent loads).
  *
  */
 static HG_UTIL_INLINE void
 hg_atomic_fence(void);
 
+/**
+ * Acquire memory barrier, prevents loads preceding the barrier from being
+ * reordered with loads and stores that follow it.
+ *
+ */
+static HG_UTIL_INLINE void
+hg_atomic_fence_acquire(void);
+
+/**
+ * Release memory barrier, prevents loads and stores preceding the barrier
+ * from being reordered with stores that follow it.
+ *
+ */
+static HG_UTIL_INLINE void
+hg_atomic_fence_release(void);
+
+/**
+ * Set atomic value (32-bit integer) with relaxed ordering.
+ *
+ * \param ptr [OUT]             pointer to an atomic32 integer
+ * \param value [IN]            value
+ */
+static HG_UTIL_INLINE void
+hg_atomic_set32_relaxed(hg_atomic_int32_t *ptr, hg_util_int32_t value);
+
+/**
+ * Get atomic value (32-bit integer) with relaxed ordering.
+ *
+ * \param ptr [OUT]             pointer to an atomic32 integer
+ *
+ * \return Value of the atomic integer
+ */
+static HG_UTIL_INLINE hg_util_int32_t
+hg_atomic_get32_relaxed(hg_atomic_int32_t *ptr);
+
+/**
+ * Increment atomic value (32-bit integer) with relaxed ordering.
+ *
+ * \param ptr [IN/OUT]          pointer to an atomic32 integer
+ *
+ * \return Incremented value
+ */
+static HG_UTIL_INLINE hg_util_int32_t
+hg_atomic_incr32_relaxed(hg_atomic_int32_t *ptr);
+
+/**
+ * Compare and swap values (32-bit integer) with relaxed ordering.
+ *
+ * \param ptr [IN/OUT]          pointer to an atomic32 integer
+ * \param compare_value [IN]    value to compare to
+ * \param swap_value [IN]       value to swap with if ptr value is equal to
+ *                              compare value
+ *
+ * \return HG_UTIL_TRUE if swapped or HG_UTIL_FALSE
+ */
+static HG_UTIL_INLINE hg_util_bool_t
+hg_atomic_cas32_relaxed(hg_atomic_int32_t *ptr, hg_util_int32_t compare_value,
+    hg_util_int32_t swap_value);
+
+/**
+ * Set atomic value (64-bit integer) with relaxed ordering.
+ *
+ * \param ptr [OUT]             pointer to an atomic64 integer
+ * \param value [IN]            value
+ */
+static HG_UTIL_INLINE void
+hg_atomic_set64_relaxed(hg_atomic_int64_t *ptr, hg_util_int64_t value);
+
+/**
+ * Get atomic value (64-bit integer) with relaxed ordering.
+ *
+ * \param ptr [OUT]             pointer to an atomic64 integer
+ *
+ * \return Value of the atomic integer
+ */
+static HG_UTIL_INLINE hg_util_int64_t
+hg_atomic_get64_relaxed(hg_atomic_int64_t *ptr);
+
+/**
+ * Increment atomic value (64-bit integer) with relaxed ordering.
+ *
+ * \param ptr [IN/OUT]          pointer to an atomic64 integer
+ *
+ * \return Incremented value
+ */
+static HG_UTIL_INLINE hg_util_int64_t
+hg_atomic_incr64_relaxed(hg_atomic_int64_t *ptr);
+
+/**
+ * Add atomic value (64-bit integer) with relaxed ordering.
+ *
+ * \param ptr [IN/OUT]          pointer to an atomic64 integer
+ * \param value [IN]            value to add
+ *
+ * \return Original value
+ */
+static HG_UTIL_INLINE hg_util_int64_t
+hg_atomic_add64_relaxed(hg_atomic_int64_t *ptr, hg_util_int64_t value);
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void
 hg_atomic_init32(hg_atomic_int32_t *ptr, hg_util_int32_t value)
@@ -478,7 +612,7 @@ hg_atomic_get64(hg_atomic_int64_t *ptr)
 #elif defined(HG_UTIL_HAS_STDATOMIC_H)
     ret = atomic_load_explicit(ptr, memory_order_acquire);
 #elif defined(__APPLE__)
-    ptr->value = value;
+    ret = ptr->value;
 #else
 #    error "Not supported on this platform."
 #endif
@@ -530,6 +664,27 @@ hg_atomic_decr64(hg_atomic_int64_t *ptr)
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_int64_t
+hg_atomic_add64(hg_atomic_int64_t *ptr, hg_util_int64_t value)
+{
+    hg_util_int64_t ret;
+
+#if defined(_WIN32)
+    ret = InterlockedExchangeAddNoFence64(&ptr->value, value);
+#elif defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    ret = atomic_fetch_add_explicit(ptr, value, memory_order_acq_rel);
+#elif defined(__APPLE__)
+    ret = OSAtomicAdd64(value, &ptr->value) - value;
+#else
+    do {
+        ret = hg_atomic_get64(ptr);
+    } while (!hg_atomic_cas64(ptr, ret, ret + value));
+#endif
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE hg_util_int64_t
 hg_atomic_or64(hg_atomic_int64_t *ptr, hg_util_int64_t value)
@@ -622,7 +777,7 @@ hg_atomic_fence()
 #elif defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
     OPA_read_write_barrier();
 #elif defined(HG_UTIL_HAS_STDATOMIC_H)
-    atomic_thread_fence(memory_order_acq_rel);
+    atomic_thread_fence(memory_order_seq_cst);
 #elif defined(__APPLE__)
     OSMemoryBarrier();
 #else
@@ -630,6 +785,118 @@ hg_atomic_fence()
 #endif
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_atomic_fence_acquire(void)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    atomic_thread_fence(memory_order_acquire);
+#else
+    hg_atomic_fence();
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_atomic_fence_release(void)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    atomic_thread_fence(memory_order_release);
+#else
+    hg_atomic_fence();
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_atomic_set32_relaxed(hg_atomic_int32_t *ptr, hg_util_int32_t value)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    atomic_store_explicit(ptr, value, memory_order_relaxed);
+#else
+    hg_atomic_set32(ptr, value);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_int32_t
+hg_atomic_get32_relaxed(hg_atomic_int32_t *ptr)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    return atomic_load_explicit(ptr, memory_order_relaxed);
+#else
+    return hg_atomic_get32(ptr);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_int32_t
+hg_atomic_incr32_relaxed(hg_atomic_int32_t *ptr)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    return atomic_fetch_add_explicit(ptr, 1, memory_order_relaxed) + 1;
+#else
+    return hg_atomic_incr32(ptr);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_bool_t
+hg_atomic_cas32_relaxed(hg_atomic_int32_t *ptr, hg_util_int32_t compare_value,
+    hg_util_int32_t swap_value)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    return atomic_compare_exchange_strong_explicit(ptr, &compare_value,
+        swap_value, memory_order_relaxed, memory_order_relaxed);
+#else
+    return hg_atomic_cas32(ptr, compare_value, swap_value);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_atomic_set64_relaxed(hg_atomic_int64_t *ptr, hg_util_int64_t value)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    atomic_store_explicit(ptr, value, memory_order_relaxed);
+#else
+    hg_atomic_set64(ptr, value);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_int64_t
+hg_atomic_get64_relaxed(hg_atomic_int64_t *ptr)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    return atomic_load_explicit(ptr, memory_order_relaxed);
+#else
+    return hg_atomic_get64(ptr);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_int64_t
+hg_atomic_incr64_relaxed(hg_atomic_int64_t *ptr)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    return atomic_fetch_add_explicit(ptr, 1, memory_order_relaxed) + 1;
+#else
+    return hg_atomic_incr64(ptr);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_int64_t
+hg_atomic_add64_relaxed(hg_atomic_int64_t *ptr, hg_util_int64_t value)
+{
+#if defined(HG_UTIL_HAS_STDATOMIC_H) && !defined(HG_UTIL_HAS_OPA_PRIMITIVES_H)
+    return atomic_fetch_add_explicit(ptr, value, memory_order_relaxed);
+#else
+    return hg_atomic_add64(ptr, value);
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -58,6 +58,8 @@ hg_atomic_queue_alloc(unsigned int count)
 
     HG_UTIL_CHECK_ERROR_NORET(
         !powerof2(count), done, "atomic queue size must be power of 2");
+    HG_UTIL_CHECK_ERROR_NORET(count > HG_ATOMIC_QUEUE_CLOSED, done,
+        "atomic queue size must not exceed %d", HG_ATOMIC_QUEUE_CLOSED);
 
     hg_atomic_queue = hg_mem_aligned_alloc(HG_MEM_CACHE_LINE_SIZE,
         sizeof(struct hg_atomic_queue) + count * sizeof(hg_atomic_int64_t));
@@ -44,21 +44,6 @@
 #include "mercury_atomic.h"
 #include "mercury_mem.h"
 
-/* For busy loop spinning */
-#ifndef cpu_spinwait
-#    if defined(_WIN32)
-#        define cpu_spinwait YieldProcessor
-#    elif defined(__x86_64__) || defined(__i386__)
-#        include <immintrin.h>
-#        define cpu_spinwait _mm_pause
-#    elif defined(__arm__)
-#        define cpu_spinwait() __asm__ __volatile__("yield")
-#    else
-#        warning "Processor yield is not supported on this architecture."
-#        define cpu_spinwait(x)
-#    endif
-#endif
-
 /*************************************/
 /* Public Type and Struct Definition */
 /*************************************/
@@ -81,6 +66,10 @@ struct hg_atomic_queue {
 /* Public Macros */
 /*****************/
 
+/* Flag set on prod_head once a queue has been closed, indices being masked
+ * by prod_mask, that bit is never used by a valid index */
+#define HG_ATOMIC_QUEUE_CLOSED (1 << 30)
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -118,6 +107,20 @@ hg_atomic_queue_free(struct hg_atomic_queue *hg_atomic_queue);
 static HG_UTIL_INLINE int
 hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry);
 
+/**
+ * Push up to \count entries to the queue at once, entries are pushed in order
+ * and take a contiguous range of the queue.
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ * \param entries [IN]              array of objects
+ * \param count [IN]                number of entries to push
+ *
+ * \return Number of entries pushed or 0 if queue is full or closed
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_push_n(struct hg_atomic_queue *hg_atomic_queue,
+    void *const *entries, unsigned int count);
+
 /**
  * Pop an entry from the queue (multi-consumer).
  *
@@ -128,6 +131,19 @@ hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry);
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue);
 
+/**
+ * Pop up to \count entries from the queue at once (multi-consumer).
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ * \param entries [OUT]             array of popped objects
+ * \param count [IN]                maximum number of entries to pop
+ *
+ * \return Number of entries popped or 0 if queue is empty
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_pop_mc_n(
+    struct hg_atomic_queue *hg_atomic_queue, void **entries, unsigned int count);
+
 /**
  * Pop an entry from the queue (single consumer).
  *
@@ -158,6 +174,26 @@ hg_atomic_queue_is_empty(struct hg_atomic_queue *hg_atomic_queue);
 static HG_UTIL_INLINE unsigned int
 hg_atomic_queue_count(struct hg_atomic_queue *hg_atomic_queue);
 
+/**
+ * Close the queue so that no further entries can be pushed to it. Entries
+ * that are already in the queue can still be popped.
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ */
+static HG_UTIL_INLINE void
+hg_atomic_queue_close(struct hg_atomic_queue *hg_atomic_queue);
+
+/**
+ * Determine whether queue has been closed and all pushes that were in progress
+ * when it was closed have completed.
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ *
+ * \return HG_UTIL_TRUE if closed, HG_UTIL_FALSE if not
+ */
+static HG_UTIL_INLINE hg_util_bool_t
+hg_atomic_queue_is_closed(struct hg_atomic_queue *hg_atomic_queue);
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE int
 hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry)
@@ -165,7 +201,10 @@ hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry)
     hg_util_int32_t prod_head, prod_next, cons_tail;
 
     do {
-        prod_head = hg_atomic_get32(&hg_atomic_queue->prod_head);
+        prod_head = hg_atomic_get32_relaxed(&hg_atomic_queue->prod_head);
+        if (prod_head & HG_ATOMIC_QUEUE_CLOSED)
+            /* Closed */
+            return HG_UTIL_FAIL;
         prod_next = (prod_head + 1) & (int) hg_atomic_queue->prod_mask;
         cons_tail = hg_atomic_get32(&hg_atomic_queue->cons_tail);
 
@@ -179,10 +218,12 @@ hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry)
             }
             continue;
         }
-    } while (
-        !hg_atomic_cas32(&hg_atomic_queue->prod_head, prod_head, prod_next));
+    } while (!hg_atomic_cas32_relaxed(
+        &hg_atomic_queue->prod_head, prod_head, prod_next));
 
-    hg_atomic_set64(&hg_atomic_queue->ring[prod_head], (hg_util_int64_t) entry);
+    /* Entry is published by the release store of prod_tail */
+    hg_atomic_set64_relaxed(
+        &hg_atomic_queue->ring[prod_head], (hg_util_int64_t) entry);
 
     /*
      * If there are other enqueues in progress
@@ -197,6 +238,63 @@ hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry)
     return HG_UTIL_SUCCESS;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_push_n(struct hg_atomic_queue *hg_atomic_queue,
+    void *const *entries, unsigned int count)
+{
+    hg_util_int32_t prod_head, prod_next, cons_tail;
+    unsigned int n, i;
+
+    for (;;) {
+        prod_head = hg_atomic_get32_relaxed(&hg_atomic_queue->prod_head);
+        if (prod_head & HG_ATOMIC_QUEUE_CLOSED)
+            /* Closed */
+            return 0;
+        cons_tail = hg_atomic_get32(&hg_atomic_queue->cons_tail);
+
+        /* One slot is always left empty */
+        n = ((unsigned int) cons_tail - (unsigned int) prod_head - 1) &
+            hg_atomic_queue->prod_mask;
+        if (n == 0) {
+            hg_atomic_fence();
+            if (prod_head == hg_atomic_get32(&hg_atomic_queue->prod_head) &&
+                cons_tail == hg_atomic_get32(&hg_atomic_queue->cons_tail)) {
+                hg_atomic_queue->drops++;
+                /* Full */
+                return 0;
+            }
+            continue;
+        }
+        if (n > count)
+            n = count;
+        prod_next = (prod_head + (hg_util_int32_t) n) &
+                    (int) hg_atomic_queue->prod_mask;
+        if (hg_atomic_cas32_relaxed(
+                &hg_atomic_queue->prod_head, prod_head, prod_next))
+            break;
+    }
+
+    /* Range is now ours */
+    for (i = 0; i < n; i++)
+        hg_atomic_set64_relaxed(
+            &hg_atomic_queue->ring[(prod_head + (hg_util_int32_t) i) &
+                                   (int) hg_atomic_queue->prod_mask],
+            (hg_util_int64_t) entries[i]);
+
+    /*
+     * If there are other enqueues in progress
+     * that preceded us, we need to wait for them
+     * to complete
+     */
+    while (hg_atomic_get32(&hg_atomic_queue->prod_tail) != prod_head)
+        cpu_spinwait();
+
+    hg_atomic_set32(&hg_atomic_queue->prod_tail, prod_next);
+
+    return n;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue)
@@ -205,15 +303,16 @@ hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue)
     void *entry = NULL;
 
     do {
-        cons_head = hg_atomic_get32(&hg_atomic_queue->cons_head);
+        cons_head = hg_atomic_get32_relaxed(&hg_atomic_queue->cons_head);
         cons_next = (cons_head + 1) & (int) hg_atomic_queue->cons_mask;
 
         if (cons_head == hg_atomic_get32(&hg_atomic_queue->prod_tail))
             return NULL;
-    } while (
-        !hg_atomic_cas32(&hg_atomic_queue->cons_head, cons_head, cons_next));
+    } while (!hg_atomic_cas32_relaxed(
+        &hg_atomic_queue->cons_head, cons_head, cons_next));
 
-    entry = (void *) hg_atomic_get64(&hg_atomic_queue->ring[cons_head]);
+    /* Entry was published by the acquire load of prod_tail */
+    entry = (void *) hg_atomic_get64_relaxed(&hg_atomic_queue->ring[cons_head]);
 
     /*
      * If there are other dequeues in progress
@@ -228,6 +327,48 @@ hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue)
     return entry;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_pop_mc_n(
+    struct hg_atomic_queue *hg_atomic_queue, void **entries, unsigned int count)
+{
+    hg_util_int32_t cons_head, cons_next;
+    unsigned int n, i;
+
+    do {
+        cons_head = hg_atomic_get32_relaxed(&hg_atomic_queue->cons_head);
+        n = ((unsigned int) hg_atomic_get32(&hg_atomic_queue->prod_tail) -
+                (unsigned int) cons_head) &
+            hg_atomic_queue->cons_mask;
+        if (n == 0)
+            return 0;
+        if (n > count)
+            n = count;
+        cons_next = (cons_head + (hg_util_int32_t) n) &
+                    (int) hg_atomic_queue->cons_mask;
+    } while (!hg_atomic_cas32_relaxed(
+        &hg_atomic_queue->cons_head, cons_head, cons_next));
+
+    /* Range is now ours */
+    for (i = 0; i < n; i++)
+        entries[i] = (void *) hg_atomic_get64_relaxed(
+            &hg_atomic_queue
+                 ->ring[(cons_head + (hg_util_int32_t) i) &
+                        (int) hg_atomic_queue->cons_mask]);
+
+    /*
+     * If there are other dequeues in progress
+     * that preceded us, we need to wait for them
+     * to complete
+     */
+    while (hg_atomic_get32(&hg_atomic_queue->cons_tail) != cons_head)
+        cpu_spinwait();
+
+    hg_atomic_set32(&hg_atomic_queue->cons_tail, cons_next);
+
+    return n;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_sc(struct hg_atomic_queue *hg_atomic_queue)
@@ -236,7 +377,7 @@ hg_atomic_queue_pop_sc(struct hg_atomic_queue *hg_atomic_queue)
     hg_util_int32_t prod_tail;
     void *entry = NULL;
 
-    cons_head = hg_atomic_get32(&hg_atomic_queue->cons_head);
+    cons_head = hg_atomic_get32_relaxed(&hg_atomic_queue->cons_head);
     prod_tail = hg_atomic_get32(&hg_atomic_queue->prod_tail);
     cons_next = (cons_head + 1) & (int) hg_atomic_queue->cons_mask;
 
@@ -244,9 +385,9 @@ hg_atomic_queue_pop_sc(struct hg_atomic_queue *hg_atomic_queue)
         /* Empty */
         return NULL;
 
-    hg_atomic_set32(&hg_atomic_queue->cons_head, cons_next);
+    hg_atomic_set32_relaxed(&hg_atomic_queue->cons_head, cons_next);
 
-    entry = (void *) hg_atomic_get64(&hg_atomic_queue->ring[cons_head]);
+    entry = (void *) hg_atomic_get64_relaxed(&hg_atomic_queue->ring[cons_head]);
 
     hg_atomic_set32(&hg_atomic_queue->cons_tail, cons_next);
 
@@ -271,6 +412,31 @@ hg_atomic_queue_count(struct hg_atomic_queue *hg_atomic_queue)
             hg_atomic_queue->prod_mask);
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_atomic_queue_close(struct hg_atomic_queue *hg_atomic_queue)
+{
+    hg_util_int32_t prod_head;
+
+    do {
+        prod_head = hg_atomic_get32(&hg_atomic_queue->prod_head);
+        if (prod_head & HG_ATOMIC_QUEUE_CLOSED)
+            return;
+    } while (!hg_atomic_cas32(&hg_atomic_queue->prod_head, prod_head,
+        prod_head | HG_ATOMIC_QUEUE_CLOSED));
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_bool_t
+hg_atomic_queue_is_closed(struct hg_atomic_queue *hg_atomic_queue)
+{
+    hg_util_int32_t prod_head = hg_atomic_get32(&hg_atomic_queue->prod_head);
+
+    return ((prod_head & HG_ATOMIC_QUEUE_CLOSED) &&
+            (prod_head & ~HG_ATOMIC_QUEUE_CLOSED) ==
+                hg_atomic_get32(&hg_atomic_queue->prod_tail));
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_atomic_seg_queue.h"
+#include "mercury_util_error.h"
+
+#include <stdlib.h>
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Allocate new segment.
+ */
+static struct hg_atomic_seg *
+hg_atomic_seg_alloc(unsigned int count);
+
+/**
+ * Free segment.
+ */
+static void
+hg_atomic_seg_free(struct hg_atomic_seg *hg_atomic_seg);
+
+/**
+ * Free list of retired segments.
+ */
+static void
+hg_atomic_seg_free_retired(struct hg_atomic_seg *hg_atomic_seg);
+
+/*---------------------------------------------------------------------------*/
+static struct hg_atomic_seg *
+hg_atomic_seg_alloc(unsigned int count)
+{
+    struct hg_atomic_seg *hg_atomic_seg = NULL;
+
+    hg_atomic_seg =
+        (struct hg_atomic_seg *) malloc(sizeof(struct hg_atomic_seg));
+    HG_UTIL_CHECK_ERROR_NORET(
+        hg_atomic_seg == NULL, error, "Could not allocate atomic segment");
+
+    hg_atomic_seg->queue = hg_atomic_queue_alloc(count);
+    HG_UTIL_CHECK_ERROR_NORET(
+        hg_atomic_seg->queue == NULL, error, "Could not allocate atomic queue");
+    hg_atomic_init64(&hg_atomic_seg->next, 0);
+    hg_atomic_seg->retired_next = NULL;
+
+    return hg_atomic_seg;
+
+error:
+    free(hg_atomic_seg);
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_atomic_seg_free(struct hg_atomic_seg *hg_atomic_seg)
+{
+    hg_atomic_queue_free(hg_atomic_seg->queue);
+    free(hg_atomic_seg);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_atomic_seg_free_retired(struct hg_atomic_seg *hg_atomic_seg)
+{
+    while (hg_atomic_seg) {
+        struct hg_atomic_seg *next = hg_atomic_seg->retired_next;
+
+        hg_atomic_seg_free(hg_atomic_seg);
+        hg_atomic_seg = next;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_atomic_seg_queue *
+hg_atomic_seg_queue_alloc(unsigned int seg_count)
+{
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue = NULL;
+    struct hg_atomic_seg *hg_atomic_seg = NULL;
+
+    hg_atomic_seg_queue = hg_mem_aligned_alloc(
+        HG_MEM_CACHE_LINE_SIZE, sizeof(struct hg_atomic_seg_queue));
+    HG_UTIL_CHECK_ERROR_NORET(hg_atomic_seg_queue == NULL, error,
+        "Could not allocate atomic segmented queue");
+
+    hg_atomic_seg = hg_atomic_seg_alloc(seg_count);
+    HG_UTIL_CHECK_ERROR_NORET(
+        hg_atomic_seg == NULL, error, "Could not allocate first segment");
+
+    hg_atomic_seg_queue->seg_count = seg_count;
+    hg_atomic_init64(&hg_atomic_seg_queue->head, (hg_util_int64_t) hg_atomic_seg);
+    hg_atomic_init64(&hg_atomic_seg_queue->tail, (hg_util_int64_t) hg_atomic_seg);
+    hg_atomic_init32(&hg_atomic_seg_queue->users, 0);
+    hg_atomic_init64(&hg_atomic_seg_queue->retired, 0);
+
+    return hg_atomic_seg_queue;
+
+error:
+    hg_mem_aligned_free(hg_atomic_seg_queue);
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_atomic_seg_queue_free(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    struct hg_atomic_seg *hg_atomic_seg;
+
+    if (!hg_atomic_seg_queue)
+        return;
+
+    hg_atomic_seg = (struct hg_atomic_seg *) hg_atomic_get64(
+        &hg_atomic_seg_queue->head);
+    while (hg_atomic_seg) {
+        struct hg_atomic_seg *next =
+            (struct hg_atomic_seg *) hg_atomic_get64(&hg_atomic_seg->next);
+
+        hg_atomic_seg_free(hg_atomic_seg);
+        hg_atomic_seg = next;
+    }
+
+    hg_atomic_seg_free_retired((struct hg_atomic_seg *) hg_atomic_get64(
+        &hg_atomic_seg_queue->retired));
+
+    hg_mem_aligned_free(hg_atomic_seg_queue);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_atomic_seg_queue_grow(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, struct hg_atomic_seg *tail)
+{
+    struct hg_atomic_seg *next;
+    int ret = HG_UTIL_SUCCESS;
+
+    /* Prevent further pushes to that segment, it is either full or already
+     * closed */
+    hg_atomic_queue_close(tail->queue);
+
+    next = (struct hg_atomic_seg *) hg_atomic_get64(&tail->next);
+    if (!next) {
+        struct hg_atomic_seg *new_seg =
+            hg_atomic_seg_alloc(hg_atomic_seg_queue->seg_count);
+        HG_UTIL_CHECK_ERROR(new_seg == NULL, done, ret, HG_UTIL_FAIL,
+            "Could not allocate new segment");
+
+        if (hg_atomic_cas64(&tail->next, 0, (hg_util_int64_t) new_seg))
+            next = new_seg;
+        else {
+            /* Someone else appended a segment, new one was never visible */
+            hg_atomic_seg_free(new_seg);
+            next = (struct hg_atomic_seg *) hg_atomic_get64(&tail->next);
+        }
+    }
+
+    /* Help moving tail forward */
+    hg_atomic_cas64(&hg_atomic_seg_queue->tail, (hg_util_int64_t) tail,
+        (hg_util_int64_t) next);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_util_bool_t
+hg_atomic_seg_queue_advance(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, struct hg_atomic_seg *head)
+{
+    struct hg_atomic_seg *next;
+    hg_util_int64_t retired;
+
+    /* A segment is only followed by another one once it has been closed,
+     * pushes that were in progress may however not have completed yet */
+    if (!hg_atomic_queue_is_closed(head->queue))
+        return HG_UTIL_FALSE;
+
+    /* Entries may have been published in the meantime */
+    if (!hg_atomic_queue_is_empty(head->queue))
+        return HG_UTIL_TRUE;
+
+    next = (struct hg_atomic_seg *) hg_atomic_get64(&head->next);
+
+    /* Tail must never lag behind head */
+    hg_atomic_cas64(&hg_atomic_seg_queue->tail, (hg_util_int64_t) head,
+        (hg_util_int64_t) next);
+
+    if (!hg_atomic_cas64(&hg_atomic_seg_queue->head, (hg_util_int64_t) head,
+            (hg_util_int64_t) next))
+        return HG_UTIL_TRUE; /* Someone else moved head */
+
+    /* Segment is no longer reachable but other threads may still be accessing
+     * it, defer free */
+    do {
+        retired = hg_atomic_get64(&hg_atomic_seg_queue->retired);
+        head->retired_next = (struct hg_atomic_seg *) retired;
+    } while (!hg_atomic_cas64(
+        &hg_atomic_seg_queue->retired, retired, (hg_util_int64_t) head));
+
+    return HG_UTIL_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_atomic_seg_queue_reclaim(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    struct hg_atomic_seg *list, *last;
+    hg_util_int64_t retired;
+
+    /* Take ownership of retired segments */
+    do {
+        retired = hg_atomic_get64(&hg_atomic_seg_queue->retired);
+    } while (
+        retired && !hg_atomic_cas64(&hg_atomic_seg_queue->retired, retired, 0));
+    list = (struct hg_atomic_seg *) retired;
+
+    /* If we were the last ones accessing the queue, threads that were
+     * accessing the retired segments have all left and new ones can no longer
+     * reach them */
+    if (hg_atomic_decr32(&hg_atomic_seg_queue->users) == 0) {
+        hg_atomic_seg_free_retired(list);
+        return;
+    }
+
+    if (!list)
+        return;
+
+    /* Give retired segments back */
+    for (last = list; last->retired_next != NULL; last = last->retired_next)
+        continue;
+    do {
+        retired = hg_atomic_get64(&hg_atomic_seg_queue->retired);
+        last->retired_next = (struct hg_atomic_seg *) retired;
+    } while (!hg_atomic_cas64(
+        &hg_atomic_seg_queue->retired, retired, (hg_util_int64_t) list));
+}
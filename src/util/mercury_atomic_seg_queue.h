@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_ATOMIC_SEG_QUEUE_H
+#define MERCURY_ATOMIC_SEG_QUEUE_H
+
+#include "mercury_atomic_queue.h"
+
+/* Unbounded lock-free MPMC queue made of a linked list of fixed-size
+ * hg_atomic_queue segments. When the tail segment is full, it is closed and a
+ * new segment is appended. Segments that have been drained are retired and
+ * only freed once no thread is accessing the queue anymore. */
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+struct hg_atomic_seg {
+    struct hg_atomic_queue *queue;     /* Segment ring */
+    hg_atomic_int64_t next;            /* Next segment (struct hg_atomic_seg) */
+    struct hg_atomic_seg *retired_next; /* Next retired segment */
+};
+
+struct hg_atomic_seg_queue {
+    hg_atomic_int64_t head
+        __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE))); /* Head segment */
+    hg_atomic_int64_t tail
+        __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE))); /* Tail segment */
+    hg_atomic_int32_t users
+        __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE))); /* Active threads */
+    hg_atomic_int64_t retired; /* Retired segments (struct hg_atomic_seg) */
+    unsigned int seg_count;    /* Number of entries per segment */
+};
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocate a new queue made of segments that can each hold \seg_count
+ * elements.
+ *
+ * \param seg_count [IN]            number of elements per segment
+ *
+ * \return pointer to allocated queue or NULL on failure
+ */
+HG_UTIL_PUBLIC struct hg_atomic_seg_queue *
+hg_atomic_seg_queue_alloc(unsigned int seg_count);
+
+/**
+ * Free an existing queue.
+ *
+ * \param hg_atomic_seg_queue [IN]  pointer to queue
+ */
+HG_UTIL_PUBLIC void
+hg_atomic_seg_queue_free(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/**
+ * Append a new segment after the (full) tail segment. This is the slow path
+ * of hg_atomic_seg_queue_push() and should not be called directly.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param tail [IN/OUT]                 pointer to tail segment
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_atomic_seg_queue_grow(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, struct hg_atomic_seg *tail);
+
+/**
+ * Move head past a drained segment. This is the slow path of
+ * hg_atomic_seg_queue_pop_mc() and should not be called directly.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param head [IN/OUT]                 pointer to head segment
+ *
+ * \return HG_UTIL_TRUE if pop should be retried, HG_UTIL_FALSE if queue is
+ * empty
+ */
+HG_UTIL_PUBLIC hg_util_bool_t
+hg_atomic_seg_queue_advance(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, struct hg_atomic_seg *head);
+
+/**
+ * Free retired segments if no other thread is accessing the queue. This is
+ * the slow path of queue accesses and should not be called directly.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ */
+HG_UTIL_PUBLIC void
+hg_atomic_seg_queue_reclaim(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/**
+ * Push an entry to the queue. The queue grows if needed.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param entry [IN]                    pointer to object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+static HG_UTIL_INLINE int
+hg_atomic_seg_queue_push(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, void *entry);
+
+/**
+ * Push \count entries to the queue. Entries are claimed with a single CAS per
+ * segment and the queue grows if needed.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param entries [IN]                  array of objects
+ * \param count [IN]                    number of entries to push
+ *
+ * \return Number of entries pushed, less than \count only on failure
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_seg_queue_push_n(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void *const *entries, unsigned int count);
+
+/**
+ * Pop an entry from the queue (multi-consumer).
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ *
+ * \return Pointer to popped object or NULL if queue is empty
+ */
+static HG_UTIL_INLINE void *
+hg_atomic_seg_queue_pop_mc(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/**
+ * Pop up to \count entries from the queue (multi-consumer). Entries are
+ * claimed with a single CAS per segment.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param entries [OUT]                 array of popped objects
+ * \param count [IN]                    maximum number of entries to pop
+ *
+ * \return Number of entries popped or 0 if queue is empty
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_seg_queue_pop_mc_n(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void **entries, unsigned int count);
+
+/**
+ * Determine whether queue is empty.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ *
+ * \return HG_UTIL_TRUE if empty, HG_UTIL_FALSE if not
+ */
+static HG_UTIL_INLINE hg_util_bool_t
+hg_atomic_seg_queue_is_empty(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/**
+ * Determine number of entries in a queue.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ *
+ * \return Number of entries queued or 0 if none
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_seg_queue_count(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_atomic_seg_queue_enter(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    hg_atomic_incr32(&hg_atomic_seg_queue->users);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_atomic_seg_queue_leave(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    if (hg_atomic_get64(&hg_atomic_seg_queue->retired))
+        hg_atomic_seg_queue_reclaim(hg_atomic_seg_queue);
+    else
+        hg_atomic_decr32(&hg_atomic_seg_queue->users);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE int
+hg_atomic_seg_queue_push(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, void *entry)
+{
+    int ret;
+
+    hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+
+    for (;;) {
+        struct hg_atomic_seg *tail = (struct hg_atomic_seg *) hg_atomic_get64(
+            &hg_atomic_seg_queue->tail);
+
+        ret = hg_atomic_queue_push(tail->queue, entry);
+        if (ret == HG_UTIL_SUCCESS)
+            break;
+
+        /* Tail segment is full */
+        ret = hg_atomic_seg_queue_grow(hg_atomic_seg_queue, tail);
+        if (ret != HG_UTIL_SUCCESS)
+            break;
+    }
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_seg_queue_push_n(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void *const *entries, unsigned int count)
+{
+    unsigned int n = 0;
+
+    hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+
+    while (n < count) {
+        struct hg_atomic_seg *tail = (struct hg_atomic_seg *) hg_atomic_get64(
+            &hg_atomic_seg_queue->tail);
+
+        n += hg_atomic_queue_push_n(tail->queue, entries + n, count - n);
+        if (n == count)
+            break;
+
+        /* Tail segment is full */
+        if (hg_atomic_seg_queue_grow(hg_atomic_seg_queue, tail) !=
+            HG_UTIL_SUCCESS)
+            break;
+    }
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue);
+
+    return n;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void *
+hg_atomic_seg_queue_pop_mc(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    void *entry;
+
+    hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+
+    for (;;) {
+        struct hg_atomic_seg *head = (struct hg_atomic_seg *) hg_atomic_get64(
+            &hg_atomic_seg_queue->head);
+
+        entry = hg_atomic_queue_pop_mc(head->queue);
+        if (entry)
+            break;
+
+        /* Head segment is empty, if it is the last one, leave */
+        if (!hg_atomic_get64(&head->next) ||
+            !hg_atomic_seg_queue_advance(hg_atomic_seg_queue, head))
+            break;
+    }
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue);
+
+    return entry;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_seg_queue_pop_mc_n(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void **entries, unsigned int count)
+{
+    unsigned int n = 0;
+
+    hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+
+    while (n < count) {
+        struct hg_atomic_seg *head = (struct hg_atomic_seg *) hg_atomic_get64(
+            &hg_atomic_seg_queue->head);
+
+        n += hg_atomic_queue_pop_mc_n(head->queue, entries + n, count - n);
+        if (n == count)
+            break;
+
+        /* Head segment is empty, if it is the last one, leave */
+        if (!hg_atomic_get64(&head->next) ||
+            !hg_atomic_seg_queue_advance(hg_atomic_seg_queue, head))
+            break;
+    }
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue);
+
+    return n;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_bool_t
+hg_atomic_seg_queue_is_empty(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    struct hg_atomic_seg *seg;
+    hg_util_bool_t ret = HG_UTIL_TRUE;
+
+    hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+
+    for (seg = (struct hg_atomic_seg *) hg_atomic_get64(
+             &hg_atomic_seg_queue->head);
+         seg != NULL;
+         seg = (struct hg_atomic_seg *) hg_atomic_get64(&seg->next)) {
+        if (!hg_atomic_queue_is_empty(seg->queue)) {
+            ret = HG_UTIL_FALSE;
+            break;
+        }
+    }
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_seg_queue_count(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    struct hg_atomic_seg *seg;
+    unsigned int count = 0;
+
+    hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+
+    for (seg = (struct hg_atomic_seg *) hg_atomic_get64(
+             &hg_atomic_seg_queue->head);
+         seg != NULL;
+         seg = (struct hg_atomic_seg *) hg_atomic_get64(&seg->next))
+        count += hg_atomic_queue_count(seg->queue);
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue);
+
+    return count;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_ATOMIC_SEG_QUEUE_H */
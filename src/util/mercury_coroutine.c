@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_coroutine.h"
+#include "mercury_mem.h"
+#include "mercury_thread.h"
+#include "mercury_util_error.h"
+
+#include <stdlib.h>
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+#    include <sys/mman.h>
+#    include <ucontext.h>
+#endif
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+struct hg_coroutine {
+    ucontext_t context;       /* Context of coroutine */
+    ucontext_t caller;        /* Context of last resumer */
+    hg_coroutine_func_t func; /* Function */
+    void *arg;                /* Function argument */
+    char *stack;              /* Stack (guard page first) */
+    size_t stack_size;        /* Size of stack mapping */
+    hg_util_bool_t done;      /* Function has returned */
+};
+#endif
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+/**
+ * Entry point of coroutines.
+ */
+static void
+hg_coroutine_entry(void);
+
+/**
+ * Create key of running coroutine when the library is loaded.
+ */
+static void
+hg_coroutine_key_init(void) HG_UTIL_CONSTRUCTOR;
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Coroutine running on the thread */
+static hg_thread_key_t hg_coroutine_key_g;
+static hg_util_bool_t hg_coroutine_key_valid_g = HG_UTIL_FALSE;
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_coroutine_key_init(void)
+{
+    hg_coroutine_key_valid_g =
+        (hg_thread_key_create(&hg_coroutine_key_g) == HG_UTIL_SUCCESS);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_coroutine_entry(void)
+{
+    hg_coroutine_t *coroutine = hg_coroutine_self();
+
+    coroutine->func(coroutine->arg);
+    coroutine->done = HG_UTIL_TRUE;
+
+    /* Returning switches to uc_link (last resumer) */
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+hg_coroutine_t *
+hg_coroutine_create(size_t stack_size)
+{
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+    hg_coroutine_t *coroutine = NULL;
+    size_t page_size = (size_t) hg_mem_get_page_size();
+    void *stack;
+
+    HG_UTIL_CHECK_ERROR_NORET(!hg_coroutine_key_valid_g, error,
+        "Coroutine key was not created");
+
+    if (stack_size == 0)
+        stack_size = HG_COROUTINE_STACK_SIZE;
+    stack_size = ((stack_size + page_size - 1) / page_size + 1) * page_size;
+
+    coroutine = (hg_coroutine_t *) calloc(1, sizeof(*coroutine));
+    HG_UTIL_CHECK_ERROR_NORET(
+        coroutine == NULL, error, "Could not allocate coroutine");
+    coroutine->done = HG_UTIL_TRUE;
+
+    stack = mmap(NULL, stack_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    HG_UTIL_CHECK_ERROR_NORET(stack == MAP_FAILED, error,
+        "Could not map coroutine stack of %zu bytes", stack_size);
+    coroutine->stack = (char *) stack;
+    coroutine->stack_size = stack_size;
+
+    /* Overflows fault on guard page instead of corrupting memory */
+    HG_UTIL_CHECK_ERROR_NORET(
+        mprotect(coroutine->stack, page_size, PROT_NONE) != 0, error,
+        "Could not protect coroutine guard page");
+
+    return coroutine;
+
+error:
+    hg_coroutine_destroy(coroutine);
+    return NULL;
+#else
+    (void) stack_size;
+    return NULL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_coroutine_destroy(hg_coroutine_t *coroutine)
+{
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+    if (coroutine == NULL)
+        return;
+    if (coroutine->stack)
+        (void) munmap(coroutine->stack, coroutine->stack_size);
+    free(coroutine);
+#else
+    (void) coroutine;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_coroutine_start(
+    hg_coroutine_t *coroutine, hg_coroutine_func_t func, void *arg)
+{
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+    size_t page_size = (size_t) hg_mem_get_page_size();
+    int ret = HG_UTIL_SUCCESS;
+
+    HG_UTIL_CHECK_ERROR(!coroutine->done, done, ret, HG_UTIL_FAIL,
+        "Coroutine is still running");
+
+    HG_UTIL_CHECK_ERROR(getcontext(&coroutine->context) != 0, done, ret,
+        HG_UTIL_FAIL, "getcontext() failed");
+    coroutine->context.uc_stack.ss_sp = coroutine->stack + page_size;
+    coroutine->context.uc_stack.ss_size = coroutine->stack_size - page_size;
+    coroutine->context.uc_link = &coroutine->caller;
+    makecontext(&coroutine->context, hg_coroutine_entry, 0);
+
+    coroutine->func = func;
+    coroutine->arg = arg;
+    coroutine->done = HG_UTIL_FALSE;
+
+done:
+    return ret;
+#else
+    (void) coroutine;
+    (void) func;
+    (void) arg;
+    return HG_UTIL_FAIL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_coroutine_resume(hg_coroutine_t *coroutine)
+{
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+    /* Coroutines may resume other coroutines */
+    void *prev = hg_thread_getspecific(hg_coroutine_key_g);
+    int ret = HG_UTIL_SUCCESS;
+
+    HG_UTIL_CHECK_ERROR(coroutine->done, done, ret, HG_UTIL_FAIL,
+        "Coroutine has returned");
+
+    hg_thread_setspecific(hg_coroutine_key_g, coroutine);
+    HG_UTIL_CHECK_ERROR(
+        swapcontext(&coroutine->caller, &coroutine->context) != 0, restore,
+        ret, HG_UTIL_FAIL, "swapcontext() failed");
+
+restore:
+    hg_thread_setspecific(hg_coroutine_key_g, prev);
+
+done:
+    return ret;
+#else
+    (void) coroutine;
+    return HG_UTIL_FAIL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_coroutine_yield(void)
+{
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+    hg_coroutine_t *coroutine = hg_coroutine_self();
+    int ret = HG_UTIL_SUCCESS;
+
+    HG_UTIL_CHECK_ERROR(coroutine == NULL, done, ret, HG_UTIL_FAIL,
+        "Not called from a coroutine");
+
+    HG_UTIL_CHECK_ERROR(
+        swapcontext(&coroutine->context, &coroutine->caller) != 0, done, ret,
+        HG_UTIL_FAIL, "swapcontext() failed");
+
+done:
+    return ret;
+#else
+    return HG_UTIL_FAIL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+hg_coroutine_t *
+hg_coroutine_self(void)
+{
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+    if (!hg_coroutine_key_valid_g)
+        return NULL;
+    return (hg_coroutine_t *) hg_thread_getspecific(hg_coroutine_key_g);
+#else
+    return NULL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+void *
+hg_coroutine_get_arg(const hg_coroutine_t *coroutine)
+{
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+    return coroutine->arg;
+#else
+    (void) coroutine;
+    return NULL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+hg_util_bool_t
+hg_coroutine_done(const hg_coroutine_t *coroutine)
+{
+#ifdef HG_UTIL_HAS_UCONTEXT_H
+    return coroutine->done;
+#else
+    (void) coroutine;
+    return HG_UTIL_TRUE;
+#endif
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_COROUTINE_H
+#define MERCURY_COROUTINE_H
+
+#include "mercury_util_config.h"
+
+/* Stackful coroutines on top of ucontext. A coroutine runs on its own stack
+ * when it is resumed and returns to the resumer when it yields or when its
+ * function returns. A suspended coroutine may be resumed from a different
+ * thread than the one it yielded from, but a coroutine must never be resumed
+ * while it is running. Coroutines can be re-started once their function has
+ * returned so that stacks can be re-used. */
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+typedef struct hg_coroutine hg_coroutine_t;
+
+typedef void (*hg_coroutine_func_t)(void *arg);
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/* Default stack size */
+#define HG_COROUTINE_STACK_SIZE (256 * 1024)
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a new coroutine with a stack of \stack_size bytes (rounded up to
+ * the page size, a guard page is added below the stack).
+ *
+ * \param stack_size [IN]       stack size (HG_COROUTINE_STACK_SIZE if 0)
+ *
+ * \return pointer to coroutine or NULL on failure (or if not supported)
+ */
+HG_UTIL_PUBLIC hg_coroutine_t *
+hg_coroutine_create(size_t stack_size);
+
+/**
+ * Destroy coroutine, coroutine must not be suspended.
+ *
+ * \param coroutine [IN/OUT]    pointer to coroutine
+ */
+HG_UTIL_PUBLIC void
+hg_coroutine_destroy(hg_coroutine_t *coroutine);
+
+/**
+ * Prepare coroutine to execute \func(\arg) on its next resume. Coroutine
+ * must be new or its previous function must have returned.
+ *
+ * \param coroutine [IN/OUT]    pointer to coroutine
+ * \param func [IN]             function
+ * \param arg [IN]              function argument
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_coroutine_start(
+    hg_coroutine_t *coroutine, hg_coroutine_func_t func, void *arg);
+
+/**
+ * Run coroutine until it yields or until its function returns.
+ *
+ * \param coroutine [IN/OUT]    pointer to coroutine
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_coroutine_resume(hg_coroutine_t *coroutine);
+
+/**
+ * Suspend calling coroutine and return to its resumer.
+ *
+ * \return Non-negative on success or negative on failure (not called from
+ * a coroutine)
+ */
+HG_UTIL_PUBLIC int
+hg_coroutine_yield(void);
+
+/**
+ * Get coroutine that is running on the calling thread.
+ *
+ * \return pointer to coroutine or NULL if not called from a coroutine
+ */
+HG_UTIL_PUBLIC hg_coroutine_t *
+hg_coroutine_self(void);
+
+/**
+ * Get argument passed to hg_coroutine_start().
+ *
+ * \param coroutine [IN]        pointer to coroutine
+ *
+ * \return argument
+ */
+HG_UTIL_PUBLIC void *
+hg_coroutine_get_arg(const hg_coroutine_t *coroutine);
+
+/**
+ * Check whether the function of coroutine has returned.
+ *
+ * \param coroutine [IN]        pointer to coroutine
+ *
+ * \return HG_UTIL_TRUE if returned, HG_UTIL_FALSE otherwise
+ */
+HG_UTIL_PUBLIC hg_util_bool_t
+hg_coroutine_done(const hg_coroutine_t *coroutine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_COROUTINE_H */
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_crc32c.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#    include <nmmintrin.h>
+#    define HG_CRC32C_SSE42
+#elif defined(__ARM_FEATURE_CRC32)
+#    include <arm_acle.h>
+#    define HG_CRC32C_ARM
+#endif
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Software CRC, processes 4 bits at a time.
+ */
+static hg_util_uint32_t
+hg_crc32c_sw(hg_util_uint32_t crc, const unsigned char *buf, size_t size);
+
+#ifdef HG_CRC32C_SSE42
+/**
+ * CRC using the SSE4.2 crc32 instruction.
+ */
+static hg_util_uint32_t
+hg_crc32c_sse42(hg_util_uint32_t crc, const unsigned char *buf, size_t size)
+    __attribute__((target("sse4.2")));
+#endif
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* CRCs of nibbles for reflected polynomial 0x82F63B78 */
+static const hg_util_uint32_t hg_crc32c_table_g[16] = {0x00000000, 0x105ec76f,
+    0x20bd8ede, 0x30e349b1, 0x417b1dbc, 0x5125dad3, 0x61c69362, 0x7198540d,
+    0x82f63b78, 0x92a8fc17, 0xa24bb5a6, 0xb21572c9, 0xc38d26c4, 0xd3d3e1ab,
+    0xe330a81a, 0xf36e6f75};
+
+/*---------------------------------------------------------------------------*/
+static hg_util_uint32_t
+hg_crc32c_sw(hg_util_uint32_t crc, const unsigned char *buf, size_t size)
+{
+    while (size--) {
+        crc ^= *buf++;
+        crc = (crc >> 4) ^ hg_crc32c_table_g[crc & 0xf];
+        crc = (crc >> 4) ^ hg_crc32c_table_g[crc & 0xf];
+    }
+
+    return crc;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_CRC32C_SSE42
+static hg_util_uint32_t
+hg_crc32c_sse42(hg_util_uint32_t crc, const unsigned char *buf, size_t size)
+{
+#    ifdef __x86_64__
+    hg_util_uint64_t crc64 = crc;
+
+    for (; size >= sizeof(hg_util_uint64_t);
+         size -= sizeof(hg_util_uint64_t), buf += sizeof(hg_util_uint64_t)) {
+        hg_util_uint64_t word;
+
+        memcpy(&word, buf, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = (hg_util_uint32_t) crc64;
+#    endif
+    for (; size >= sizeof(hg_util_uint32_t);
+         size -= sizeof(hg_util_uint32_t), buf += sizeof(hg_util_uint32_t)) {
+        hg_util_uint32_t word;
+
+        memcpy(&word, buf, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+    while (size--)
+        crc = _mm_crc32_u8(crc, *buf++);
+
+    return crc;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+hg_util_uint32_t
+hg_crc32c_update(hg_util_uint32_t crc, const void *buf, size_t size)
+{
+    const unsigned char *ptr = (const unsigned char *) buf;
+
+    crc = ~crc;
+#if defined(HG_CRC32C_SSE42)
+    if (__builtin_cpu_supports("sse4.2"))
+        crc = hg_crc32c_sse42(crc, ptr, size);
+    else
+        crc = hg_crc32c_sw(crc, ptr, size);
+#elif defined(HG_CRC32C_ARM)
+    for (; size >= sizeof(hg_util_uint64_t);
+         size -= sizeof(hg_util_uint64_t), ptr += sizeof(hg_util_uint64_t)) {
+        hg_util_uint64_t word;
+
+        memcpy(&word, ptr, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+    while (size--)
+        crc = __crc32cb(crc, *ptr++);
+#else
+    crc = hg_crc32c_sw(crc, ptr, size);
+#endif
+
+    return ~crc;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_crc32c_hw(void)
+{
+#if defined(HG_CRC32C_SSE42)
+    return __builtin_cpu_supports("sse4.2");
+#elif defined(HG_CRC32C_ARM)
+    return 1;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_CRC32C_H
+#define MERCURY_CRC32C_H
+
+#include "mercury_util_config.h"
+
+#include <stddef.h>
+
+/* CRC32C (Castagnoli) checksums. The SSE4.2 crc32 instruction is used on x86
+ * processors that support it and the CRC32 extension on ARMv8 when the
+ * compiler targets it, a software implementation is used otherwise. */
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Update CRC \crc with \size bytes of \buf. Checksums of a buffer can be
+ * computed in several steps, the first update being passed a crc of 0.
+ *
+ * \param crc [IN]              current CRC
+ * \param buf [IN]              pointer to data
+ * \param size [IN]             size of data
+ *
+ * \return updated CRC
+ */
+HG_UTIL_PUBLIC hg_util_uint32_t
+hg_crc32c_update(hg_util_uint32_t crc, const void *buf, size_t size);
+
+/**
+ * Return whether CRCs are computed with hardware instructions.
+ *
+ * \return non-zero if hardware accelerated
+ */
+HG_UTIL_PUBLIC int
+hg_crc32c_hw(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_CRC32C_H */
@@ -28,6 +28,14 @@
 /* Local Prototypes */
 /********************/
 
+/* Prepare merging of all thread buffers, return number of entries */
+static unsigned int
+hg_dlog_merge_start(struct hg_dlog *d);
+
+/* Return next (oldest) entry of all thread buffers */
+static struct hg_dlog_entry *
+hg_dlog_merge_next(struct hg_dlog *d);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -58,6 +66,9 @@ hg_dlog_alloc(char *name, unsigned int lesize, int leloop)
     d->le = le;
     d->lesize = lesize;
     d->leloop = leloop;
+    HG_LIST_INIT(&d->rings);
+    hg_atomic_init32(&d->lekey_init, 0);
+    hg_atomic_init32(&d->legen, 0);
     d->mallocd = 1;
 
     return d;
@@ -79,6 +90,17 @@ hg_dlog_free(struct hg_dlog *d)
         free(cp);
     }
 
+    while (!HG_LIST_IS_EMPTY(&d->rings)) {
+        struct hg_dlog_ring *ring = HG_LIST_FIRST(&d->rings);
+        HG_LIST_REMOVE(ring, l);
+        free(ring);
+    }
+
+    if (hg_atomic_get32(&d->lekey_init)) {
+        hg_thread_key_delete(d->lekey);
+        hg_atomic_set32(&d->lekey_init, 0);
+    }
+
     if (d->mallocd) {
         free(d->le);
         free(d);
@@ -131,6 +153,49 @@ hg_dlog_mkcount64(struct hg_dlog *d, hg_atomic_int64_t **cptr, const char *name,
     hg_thread_mutex_unlock(&d->dlock);
 }
 
+/*---------------------------------------------------------------------------*/
+struct hg_dlog_ring *
+hg_dlog_getring(struct hg_dlog *d)
+{
+    struct hg_dlog_ring *ring = NULL;
+
+    hg_thread_mutex_lock(&d->dlock);
+    if (!hg_atomic_get32(&d->lekey_init)) {
+        if (hg_thread_key_create(&d->lekey) < 0)
+            goto done;
+        hg_atomic_set32(&d->lekey_init, 1);
+    }
+
+    /* first thread uses the dlog's le[] */
+    if (HG_LIST_IS_EMPTY(&d->rings) && d->le) {
+        ring = malloc(sizeof(*ring));
+        if (!ring)
+            goto done;
+        ring->le = d->le;
+    } else {
+        ring = malloc(sizeof(*ring) + sizeof(*ring->le) * d->lesize);
+        if (!ring)
+            goto done;
+        ring->le = (struct hg_dlog_entry *) (ring + 1);
+    }
+    ring->lefree = 0;
+    ring->leadds = 0;
+    ring->legen = hg_atomic_get32(&d->legen);
+    ring->dumpidx = 0;
+    ring->dumpleft = 0;
+
+    if (hg_thread_setspecific(d->lekey, ring) < 0) {
+        free(ring);
+        ring = NULL;
+        goto done;
+    }
+    HG_LIST_INSERT_HEAD(&d->rings, ring, l);
+
+done:
+    hg_thread_mutex_unlock(&d->dlock);
+    return ring;
+}
+
 /*---------------------------------------------------------------------------*/
 void
 hg_dlog_setlogstop(struct hg_dlog *d, int stop)
@@ -142,10 +207,56 @@ hg_dlog_setlogstop(struct hg_dlog *d, int stop)
 void
 hg_dlog_resetlog(struct hg_dlog *d)
 {
-    hg_thread_mutex_lock(&d->dlock);
-    d->lefree = 0;
-    d->leadds = 0;
-    hg_thread_mutex_unlock(&d->dlock);
+    /* threads reset their own buffer on their next add */
+    hg_atomic_incr32(&d->legen);
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_dlog_merge_start(struct hg_dlog *d)
+{
+    hg_util_int32_t gen = hg_atomic_get32(&d->legen);
+    struct hg_dlog_ring *ring;
+    unsigned int total = 0;
+
+    HG_LIST_FOREACH (ring, &d->rings, l) {
+        unsigned int leadds = ring->leadds, lefree = ring->lefree;
+
+        if (ring->legen != gen) {
+            ring->dumpleft = 0;
+            continue;
+        }
+        ring->dumpidx = (lefree < leadds) ? d->lesize + lefree - leadds
+                                          : lefree - leadds;
+        ring->dumpleft = leadds;
+        total += leadds;
+    }
+
+    return total;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_dlog_entry *
+hg_dlog_merge_next(struct hg_dlog *d)
+{
+    struct hg_dlog_ring *ring, *oldest = NULL;
+    struct hg_dlog_entry *le;
+
+    HG_LIST_FOREACH (ring, &d->rings, l) {
+        if (ring->dumpleft == 0)
+            continue;
+        if (!oldest ||
+            ring->le[ring->dumpidx].time < oldest->le[oldest->dumpidx].time)
+            oldest = ring;
+    }
+    if (!oldest)
+        return NULL;
+
+    le = &oldest->le[oldest->dumpidx];
+    oldest->dumpidx = (oldest->dumpidx + 1) % d->lesize;
+    oldest->dumpleft--;
+
+    return le;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -154,7 +265,8 @@ hg_dlog_dump(struct hg_dlog *d, int (*log_func)(FILE *, const char *, ...),
     FILE *stream, int trylock)
 {
     int try_ret;
-    unsigned int left, idx;
+    unsigned int nlogs;
+    struct hg_dlog_entry *le;
     struct hg_dlog_dcount32 *dc32;
     struct hg_dlog_dcount64 *dc64;
 
@@ -167,7 +279,8 @@ hg_dlog_dump(struct hg_dlog *d, int (*log_func)(FILE *, const char *, ...),
         try_ret = 0;
     }
 
-    if (d->leadds > 0) {
+    nlogs = hg_dlog_merge_start(d);
+    if (nlogs > 0) {
         log_func(stream,
             "### ----------------------\n"
             "### (%s) debug log summary\n"
@@ -186,17 +299,12 @@ hg_dlog_dump(struct hg_dlog *d, int (*log_func)(FILE *, const char *, ...),
             log_func(stream, "# -\n");
         }
 
-        log_func(stream, "# Number of log entries: %d\n", d->leadds);
+        log_func(stream, "# Number of log entries: %u\n", nlogs);
 
-        idx = (d->lefree < d->leadds) ? d->lesize + d->lefree - d->leadds
-                                      : d->lefree - d->leadds;
-        left = d->leadds;
-        while (left--) {
+        while ((le = hg_dlog_merge_next(d)) != NULL)
             log_func(stream, "# [%lf] %s:%d\n## %s()\n",
-                hg_time_to_double(d->le[idx].time), d->le[idx].file,
-                d->le[idx].line, d->le[idx].func);
-            idx = (idx + 1) % d->lesize;
-        }
+                (double) hg_time_ticks_to_ns(le->time) * 1e-9, le->file,
+                le->line, le->func);
     }
 
     if (try_ret >= 0)
@@ -211,7 +319,8 @@ hg_dlog_dump_file(struct hg_dlog *d, const char *base, int addpid, int trylock)
     int pid = getpid();
     FILE *fp;
     int try_ret;
-    unsigned int left, idx;
+    unsigned int nlogs;
+    struct hg_dlog_entry *le;
     struct hg_dlog_dcount32 *dc32;
     struct hg_dlog_dcount64 *dc64;
 
@@ -247,17 +356,13 @@ hg_dlog_dump_file(struct hg_dlog *d, const char *base, int addpid, int trylock)
     }
     fprintf(fp, "# END COUNTERS\n\n");
 
-    fprintf(fp, "# NLOGS %d FOR %d\n", d->leadds, pid);
+    nlogs = hg_dlog_merge_start(d);
+    fprintf(fp, "# NLOGS %u FOR %d\n", nlogs, pid);
 
-    idx = (d->lefree < d->leadds) ? d->lesize + d->lefree - d->leadds
-                                  : d->lefree - d->leadds;
-    left = d->leadds;
-    while (left--) {
+    while ((le = hg_dlog_merge_next(d)) != NULL)
         fprintf(fp, "%lf %d %s %u %s %s %p\n",
-            hg_time_to_double(d->le[idx].time), pid, d->le[idx].file,
-            d->le[idx].line, d->le[idx].func, d->le[idx].msg, d->le[idx].data);
-        idx = (idx + 1) % d->lesize;
-    }
+            (double) hg_time_ticks_to_ns(le->time) * 1e-9, pid, le->file,
+            le->line, le->func, le->msg, le->data);
 
     if (try_ret >= 0)
         hg_thread_mutex_unlock(&d->dlock);
@@ -15,6 +15,7 @@
 
 #include "mercury_atomic.h"
 #include "mercury_list.h"
+#include "mercury_thread.h"
 #include "mercury_thread_mutex.h"
 #include "mercury_time.h"
 
@@ -33,7 +34,9 @@
 
 /*
  * HG_DLOG_INITIALIZER: initializer for a dlog in a global variable.
- * LESIZE is the number of entries in the LE array.  use it like this:
+ * LESIZE is the number of entries in the LE array, LE is used by the first
+ * thread that adds a log entry, other threads get their own malloc'd array
+ * of LESIZE entries.  use it like this:
  *
  * #define FOO_NENTS 128
  * struct hg_dlog_entry foo_le[FOO_NENTS];
@@ -43,7 +46,9 @@
     {                                                                          \
         HG_DLOG_STDMAGIC NAME, HG_THREAD_MUTEX_INITIALIZER,                    \
             HG_LIST_HEAD_INITIALIZER(cnts32),                                  \
-            HG_LIST_HEAD_INITIALIZER(cnts64), LE, LESIZE, LELOOP, 0, 0, 0, 0   \
+            HG_LIST_HEAD_INITIALIZER(cnts64), LE, LESIZE, LELOOP, 0,           \
+            HG_LIST_HEAD_INITIALIZER(rings), 0, HG_ATOMIC_VAR_INIT(0),         \
+            HG_ATOMIC_VAR_INIT(0), 0                                           \
     }
 
 /*************************************/
@@ -54,12 +59,27 @@
  * hg_dlog_entry: an entry in the dlog
  */
 struct hg_dlog_entry {
-    const char *file;  /* file name */
-    unsigned int line; /* line number */
-    const char *func;  /* function name */
-    const char *msg;   /* entry message (optional) */
-    const void *data;  /* user data (optional) */
-    hg_time_t time;    /* time added to log */
+    const char *file;     /* file name */
+    unsigned int line;    /* line number */
+    const char *func;     /* function name */
+    const char *msg;      /* entry message (optional) */
+    const void *data;     /* user data (optional) */
+    hg_time_ticks_t time; /* time added to log (fast clock ticks) */
+};
+
+/*
+ * hg_dlog_ring: per-thread circular buffer of log entries.  only the
+ * owning thread adds entries so that adding a log does not need to take
+ * the dlog lock.  entries of all rings are merged by time when dumped.
+ */
+struct hg_dlog_ring {
+    struct hg_dlog_entry *le;      /* array of log entries */
+    unsigned int lefree;           /* next free entry in le[] */
+    unsigned int leadds;           /* #adds done if < lesize */
+    hg_util_int32_t legen;         /* log generation of entries */
+    unsigned int dumpidx;          /* next entry to dump */
+    unsigned int dumpleft;         /* #entries left to dump */
+    HG_LIST_ENTRY(hg_dlog_ring) l; /* linkage */
 };
 
 /*
@@ -94,12 +114,14 @@ struct hg_dlog {
     HG_LIST_HEAD(hg_dlog_dcount64) cnts64; /* counter list */
 
     /* log */
-    struct hg_dlog_entry *le; /* array of log entries */
-    unsigned int lesize;      /* size of le[] array */
-    int leloop;               /* circular buffer? */
-    unsigned int lefree;      /* next free entry in le[] */
-    unsigned int leadds;      /* #adds done if < lesize */
-    int lestop;               /* stop taking new logs */
+    struct hg_dlog_entry *le;         /* array of log entries (1st thread) */
+    unsigned int lesize;              /* size of le[] array (per thread) */
+    int leloop;                       /* circular buffer? */
+    int lestop;                       /* stop taking new logs */
+    HG_LIST_HEAD(hg_dlog_ring) rings; /* per-thread log buffers */
+    hg_thread_key_t lekey;            /* key to thread's log buffer */
+    hg_atomic_int32_t lekey_init;     /* lekey created? */
+    hg_atomic_int32_t legen;          /* log generation (bumped by reset) */
 
     int mallocd; /* allocated with malloc? */
 };
@@ -181,10 +203,23 @@ HG_UTIL_PUBLIC void
 hg_dlog_mkcount64(struct hg_dlog *d, hg_atomic_int64_t **cptr, const char *name,
     const char *descr);
 
+/**
+ * get the log buffer of the calling thread, creating it if needed.  this
+ * is the slow path of hg_dlog_addlog(), only taken the first time a
+ * thread adds a log record.  buffers are kept until the dlog is freed.
+ *
+ * \param d [IN]                dlog to get the buffer from
+ *
+ * \return the buffer or NULL on malloc error
+ */
+HG_UTIL_PUBLIC struct hg_dlog_ring *
+hg_dlog_getring(struct hg_dlog *d);
+
 /**
  * attempt to add a log record to a dlog.  the id and msg should point
  * to static strings that are valid throughout the life of the program
- * (not something that is is on the stack).
+ * (not something that is is on the stack).  the record is added to the
+ * calling thread's buffer without taking the dlog lock.
  *
  * \param d [IN]                the dlog to add the log record to
  * \param file [IN]             file entry
@@ -209,7 +244,8 @@ HG_UTIL_PUBLIC void
 hg_dlog_setlogstop(struct hg_dlog *d, int stop);
 
 /**
- * reset the log.  this does not change the counters (since users
+ * reset the log (of all threads).  this does not change the counters
+ * (since users
  * have direct access to the hg_atomic_int64_t's, we don't need
  * an API to change them here).
  *
@@ -251,29 +287,43 @@ static HG_UTIL_INLINE unsigned int
 hg_dlog_addlog(struct hg_dlog *d, const char *file, unsigned int line,
     const char *func, const char *msg, const void *data)
 {
-    unsigned int rv = 0;
+    struct hg_dlog_ring *ring = NULL;
+    hg_util_int32_t gen;
     unsigned int idx;
 
-    hg_thread_mutex_lock(&d->dlock);
     if (d->lestop)
-        goto done;
-    if (d->leloop == 0 && d->leadds >= d->lesize)
-        goto done;
-    idx = d->lefree;
-    d->lefree = (d->lefree + 1) % d->lesize;
-    if (d->leadds < d->lesize)
-        d->leadds++;
-    d->le[idx].file = file;
-    d->le[idx].line = line;
-    d->le[idx].func = func;
-    d->le[idx].msg = msg;
-    d->le[idx].data = data;
-    hg_time_get_current(&d->le[idx].time);
-    rv = 1;
-
-done:
-    hg_thread_mutex_unlock(&d->dlock);
-    return rv;
+        return 0;
+
+    if (hg_atomic_get32(&d->lekey_init))
+        ring = (struct hg_dlog_ring *) hg_thread_getspecific(d->lekey);
+    if (!ring) {
+        ring = hg_dlog_getring(d);
+        if (!ring)
+            return 0;
+    }
+
+    /* log was reset since last add */
+    gen = hg_atomic_get32(&d->legen);
+    if (ring->legen != gen) {
+        ring->lefree = 0;
+        ring->leadds = 0;
+        ring->legen = gen;
+    }
+
+    if (d->leloop == 0 && ring->leadds >= d->lesize)
+        return 0;
+    idx = ring->lefree;
+    ring->le[idx].file = file;
+    ring->le[idx].line = line;
+    ring->le[idx].func = func;
+    ring->le[idx].msg = msg;
+    ring->le[idx].data = data;
+    ring->le[idx].time = hg_time_get_ticks();
+    ring->lefree = (idx + 1) % d->lesize;
+    if (ring->leadds < d->lesize)
+        ring->leadds++;
+
+    return 1;
 }
 
 #ifdef __cplusplus
@@ -41,6 +41,30 @@ hg_hash_string(const char *string)
     return result;
 }
 
+/**
+ * 64-bit hash of a string of known length.
+ *
+ * \param string [IN]           string
+ * \param len [IN]              string length
+ *
+ * \return 64-bit hash value
+ */
+static HG_UTIL_INLINE hg_util_uint64_t
+hg_hash_string64(const char *string, size_t len)
+{
+    /* This is the 64-bit FNV-1a string hash function */
+
+    hg_util_uint64_t result = 14695981039346656037ULL;
+    const unsigned char *p = (const unsigned char *) string;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        result ^= p[i];
+        result *= 1099511628211ULL;
+    }
+    return result;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,415 +18,606 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 
  */
 
-/* Hash table implementation */
+/* Hash table implementation
+ *
+ * Open addressing table in the style of Swiss tables: slots store keys and
+ * values inline and each slot has a control byte holding 7 bits of the hash
+ * of its key (or whether it is empty or deleted). Lookups compare control
+ * bytes of a group of slots at once (SSE2 when available, 64-bit words
+ * otherwise) and only call the equal function on candidates. The table size
+ * is a power of two and groups are probed quadratically. */
 
 #include "mercury_hash_table.h"
+#include "mercury_atomic.h"
+#include "mercury_thread.h"
 
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+/* Number of control bytes compared at once */
+#ifdef __SSE2__
+#    define HASH_TABLE_GROUP_WIDTH 16
+#else
+#    define HASH_TABLE_GROUP_WIDTH 8
+#endif
+
+/* Initial size (must be a power of two, at least one group) */
+#define HASH_TABLE_MIN_SIZE 16
+
+/* Control bytes, full slots store the 7 high bits of the hash */
+#define HASH_TABLE_EMPTY   ((hg_util_uint8_t) 0x80)
+#define HASH_TABLE_DELETED ((hg_util_uint8_t) 0xFE)
+
+/* Hash bits used for the position (H1) and the control byte (H2) */
+#define HASH_TABLE_H1(hash) ((unsigned int) ((hash) >> 25))
+#define HASH_TABLE_H2(hash) ((hg_util_uint8_t) ((hash) >> 57))
+
+/* Max number of used (full or deleted) slots, 7/8 of the table */
+#define HASH_TABLE_MAX_USED(size) ((size) - (size) / 8)
+
+#ifdef __SSE2__
+typedef unsigned int hash_table_mask_t;
+#else
+typedef hg_util_uint64_t hash_table_mask_t;
+#    define HASH_TABLE_LSBS (0x0101010101010101ULL)
+#    define HASH_TABLE_MSBS (0x8080808080808080ULL)
+#endif
+
 struct hg_hash_table_entry {
     hg_hash_table_key_t key;
     hg_hash_table_value_t value;
-    hg_hash_table_entry_t *next;
+};
+
+/* Slots and control bytes of a table (allocated together). The last
+ * group width - 1 control bytes mirror the first ones so that groups
+ * can be loaded at any position. */
+struct hash_table_array {
+    hg_hash_table_entry_t *slots;
+    hg_util_uint8_t *ctrl;
+    unsigned int mask;               /* Size - 1 */
+    struct hash_table_array *retired; /* Previous array (concurrent) */
 };
 
 struct hg_hash_table {
-    hg_hash_table_entry_t **table;
-    unsigned int table_size;
+    hg_atomic_int64_t array; /* Current array */
     hg_hash_table_hash_func_t hash_func;
     hg_hash_table_equal_func_t equal_func;
     hg_hash_table_key_free_func_t key_free_func;
     hg_hash_table_value_free_func_t value_free_func;
     unsigned int entries;
-    unsigned int prime_index;
+    unsigned int deleted;
+    hg_atomic_int32_t seq; /* Odd while modified (concurrent) */
+    int concurrent;
 };
 
-/* This is a set of good hash table prime numbers, from:
- *   http://planetmath.org/goodhashtableprimes
- * Each prime is roughly double the previous value, and as far as
- * possible from the nearest powers of two. */
-
-static const unsigned int hash_table_primes[] = {
-    193,
-    389,
-    769,
-    1543,
-    3079,
-    6151,
-    12289,
-    24593,
-    49157,
-    98317,
-    196613,
-    393241,
-    786433,
-    1572869,
-    3145739,
-    6291469,
-    12582917,
-    25165843,
-    50331653,
-    100663319,
-    201326611,
-    402653189,
-    805306457,
-    1610612741,
-};
+/* Get current array */
 
-static const unsigned int hash_table_num_primes =
-    sizeof(hash_table_primes) / sizeof(int);
+static HG_UTIL_INLINE struct hash_table_array *
+hash_table_array_get(hg_hash_table_t *hash_table)
+{
+    return (struct hash_table_array *) hg_atomic_get64(&hash_table->array);
+}
 
-/* Internal function used to allocate the table on hash table creation
- * and when enlarging the table */
+/* Hash of a key, mixed so that both H1 and H2 depend on all bits of the
+ * user hash (user hashes are often identity functions) */
 
-static int
-hash_table_allocate_table(hg_hash_table_t *hash_table)
+static HG_UTIL_INLINE hg_util_uint64_t
+hash_table_hash(hg_hash_table_t *hash_table, hg_hash_table_key_t key)
 {
-    unsigned int new_table_size;
+    return (hg_util_uint64_t) hash_table->hash_func(key) *
+           0x9E3779B97F4A7C15ULL;
+}
 
-    /* Determine the table size based on the current prime index.
-     * An attempt is made here to ensure sensible behavior if the
-     * maximum prime is exceeded, but in practice other things are
-     * likely to break long before that happens. */
+/* Group operations: masks have one bit (resp. byte) set per matching
+ * slot of the group */
 
-    if (hash_table->prime_index < hash_table_num_primes) {
-        new_table_size = hash_table_primes[hash_table->prime_index];
-    } else {
-        new_table_size = hash_table->entries * 10;
-    }
+static HG_UTIL_INLINE hash_table_mask_t
+hash_table_group_match(const hg_util_uint8_t *ctrl, hg_util_uint8_t h2)
+{
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i *) ctrl);
+
+    return (hash_table_mask_t) _mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8((char) h2), group));
+#else
+    hg_util_uint64_t group, x;
+
+    memcpy(&group, ctrl, sizeof(group));
+#    if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    group = __builtin_bswap64(group);
+#    endif
+    /* May have false positives, candidates are compared anyway */
+    x = group ^ (HASH_TABLE_LSBS * h2);
+
+    return (x - HASH_TABLE_LSBS) & ~x & HASH_TABLE_MSBS;
+#endif
+}
 
-    hash_table->table_size = new_table_size;
+static HG_UTIL_INLINE hash_table_mask_t
+hash_table_group_match_empty(const hg_util_uint8_t *ctrl)
+{
+#ifdef __SSE2__
+    return hash_table_group_match(ctrl, HASH_TABLE_EMPTY);
+#else
+    hg_util_uint64_t group;
+
+    memcpy(&group, ctrl, sizeof(group));
+#    if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    group = __builtin_bswap64(group);
+#    endif
+    /* Empty is the only control byte with bit 7 set and bit 1 unset */
+    return group & (~group << 6) & HASH_TABLE_MSBS;
+#endif
+}
 
-    /* Allocate the table and initialise to NULL for all entries */
+static HG_UTIL_INLINE hash_table_mask_t
+hash_table_group_match_free(const hg_util_uint8_t *ctrl)
+{
+#ifdef __SSE2__
+    /* Empty and deleted are the only control bytes with bit 7 set */
+    return (hash_table_mask_t) _mm_movemask_epi8(
+        _mm_loadu_si128((const __m128i *) ctrl));
+#else
+    hg_util_uint64_t group;
+
+    memcpy(&group, ctrl, sizeof(group));
+#    if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    group = __builtin_bswap64(group);
+#    endif
+    return group & HASH_TABLE_MSBS;
+#endif
+}
 
-    hash_table->table = (hg_hash_table_entry_t **) calloc(
-        hash_table->table_size, sizeof(hg_hash_table_entry_t *));
+/* Index in group of first match */
 
-    return hash_table->table != NULL;
+static HG_UTIL_INLINE unsigned int
+hash_table_mask_first(hash_table_mask_t mask)
+{
+#if defined(__GNUC__)
+#    ifdef __SSE2__
+    return (unsigned int) __builtin_ctz(mask);
+#    else
+    return (unsigned int) __builtin_ctzll(mask) >> 3;
+#    endif
+#else
+    unsigned int i = 0;
+
+    while (!(mask & 1)) {
+        mask >>= 1;
+        i++;
+    }
+#    ifdef __SSE2__
+    return i;
+#    else
+    return i >> 3;
+#    endif
+#endif
 }
 
-/* Free an entry, calling the free functions if there are any registered */
+/* Number of slots of a group before its first match (resp. after its last
+ * match) */
 
-static void
-hash_table_free_entry(hg_hash_table_t *hash_table, hg_hash_table_entry_t *entry)
+static HG_UTIL_INLINE unsigned int
+hash_table_mask_trailing(hash_table_mask_t mask)
 {
-    /* If there is a function registered for freeing keys, use it to free
-     * the key */
+    return mask ? hash_table_mask_first(mask) : HASH_TABLE_GROUP_WIDTH;
+}
 
-    if (hash_table->key_free_func != NULL) {
-        hash_table->key_free_func(entry->key);
+static HG_UTIL_INLINE unsigned int
+hash_table_mask_leading(hash_table_mask_t mask)
+{
+    if (!mask) {
+        return HASH_TABLE_GROUP_WIDTH;
     }
+#if defined(__GNUC__)
+#    ifdef __SSE2__
+    return (unsigned int) __builtin_clz(mask) - (32 - HASH_TABLE_GROUP_WIDTH);
+#    else
+    return (unsigned int) __builtin_clzll(mask) >> 3;
+#    endif
+#else
+    {
+        unsigned int i = 0;
+
+#    ifdef __SSE2__
+        while (!(mask & (1U << (HASH_TABLE_GROUP_WIDTH - 1)))) {
+            mask <<= 1;
+            i++;
+        }
+        return i;
+#    else
+        while (!(mask & (1ULL << 63))) {
+            mask <<= 1;
+            i++;
+        }
+        return i >> 3;
+#    endif
+    }
+#endif
+}
 
-    /* Likewise with the value */
+/* Allocate an empty array of given size (power of two) */
 
-    if (hash_table->value_free_func != NULL) {
-        hash_table->value_free_func(entry->value);
+static struct hash_table_array *
+hash_table_array_alloc(unsigned int size)
+{
+    struct hash_table_array *array;
+
+    /* Slots are zeroed so that concurrent lookups never see garbage keys */
+    array = (struct hash_table_array *) calloc(1,
+        sizeof(*array) + size * sizeof(hg_hash_table_entry_t) + size +
+            HASH_TABLE_GROUP_WIDTH);
+    if (array == NULL) {
+        return NULL;
     }
 
-    /* Free the data structure */
+    array->slots = (hg_hash_table_entry_t *) (array + 1);
+    array->ctrl = (hg_util_uint8_t *) (array->slots + size);
+    array->mask = size - 1;
+    memset(array->ctrl, HASH_TABLE_EMPTY, size + HASH_TABLE_GROUP_WIDTH);
 
-    free(entry);
+    return array;
 }
 
-hg_hash_table_t *
-hg_hash_table_new(
-    hg_hash_table_hash_func_t hash_func, hg_hash_table_equal_func_t equal_func)
-{
-    hg_hash_table_t *hash_table;
-
-    /* Allocate a new hash table structure */
+/* Set control byte of slot, mirrored bytes included */
 
-    hash_table = (hg_hash_table_t *) malloc(sizeof(hg_hash_table_t));
-
-    if (hash_table == NULL) {
-        return NULL;
+static HG_UTIL_INLINE void
+hash_table_set_ctrl(
+    struct hash_table_array *array, unsigned int index, hg_util_uint8_t ctrl)
+{
+    array->ctrl[index] = ctrl;
+    if (index < HASH_TABLE_GROUP_WIDTH - 1) {
+        array->ctrl[array->mask + 1 + index] = ctrl;
     }
+}
 
-    hash_table->hash_func = hash_func;
-    hash_table->equal_func = equal_func;
-    hash_table->key_free_func = NULL;
-    hash_table->value_free_func = NULL;
-    hash_table->entries = 0;
-    hash_table->prime_index = 0;
+/* Find slot of key, returns non-zero if found (concurrent is expected to be
+ * a constant so that each flavor gets its own probe loop) */
 
-    /* Allocate the table */
+static HG_UTIL_INLINE int
+hash_table_find(hg_hash_table_t *hash_table, struct hash_table_array *array,
+    hg_hash_table_key_t key, hg_util_uint64_t hash, int concurrent,
+    unsigned int *index)
+{
+    unsigned int pos = HASH_TABLE_H1(hash) & array->mask, step = 0;
+    hg_util_uint8_t h2 = HASH_TABLE_H2(hash);
+
+    for (;;) {
+        hash_table_mask_t match =
+            hash_table_group_match(&array->ctrl[pos], h2);
+
+        while (match) {
+            unsigned int i = (pos + hash_table_mask_first(match)) & array->mask;
+            hg_hash_table_key_t slot_key = array->slots[i].key;
+
+            /* Keys of concurrent tables may not be set yet */
+            if ((!concurrent || slot_key != NULL) &&
+                hash_table->equal_func(key, slot_key) != 0) {
+                *index = i;
+                return 1;
+            }
+            match &= match - 1;
+        }
 
-    if (!hash_table_allocate_table(hash_table)) {
-        free(hash_table);
+        /* Key would have been inserted in that group */
+        if (hash_table_group_match_empty(&array->ctrl[pos])) {
+            return 0;
+        }
 
-        return NULL;
+        step += HASH_TABLE_GROUP_WIDTH;
+        pos = (pos + step) & array->mask;
     }
-
-    return hash_table;
 }
 
-void
-hg_hash_table_free(hg_hash_table_t *hash_table)
+/* Find first free slot on probe sequence of hash */
+
+static HG_UTIL_INLINE unsigned int
+hash_table_find_free(struct hash_table_array *array, hg_util_uint64_t hash)
 {
-    hg_hash_table_entry_t *rover;
-    hg_hash_table_entry_t *next;
-    unsigned int i;
+    unsigned int pos = HASH_TABLE_H1(hash) & array->mask, step = 0;
 
-    /* Free all entries in all chains */
+    for (;;) {
+        hash_table_mask_t match =
+            hash_table_group_match_free(&array->ctrl[pos]);
 
-    for (i = 0; i < hash_table->table_size; ++i) {
-        rover = hash_table->table[i];
-        while (rover != NULL) {
-            next = rover->next;
-            hash_table_free_entry(hash_table, rover);
-            rover = next;
+        if (match) {
+            return (pos + hash_table_mask_first(match)) & array->mask;
         }
-    }
-
-    /* Free the table */
 
-    free(hash_table->table);
+        step += HASH_TABLE_GROUP_WIDTH;
+        pos = (pos + step) & array->mask;
+    }
+}
 
-    /* Free the hash table structure */
+/* Concurrent tables: modifications are enclosed by an odd sequence number,
+ * lookups are retried if the sequence number changed */
 
-    free(hash_table);
+static HG_UTIL_INLINE void
+hash_table_write_begin(hg_hash_table_t *hash_table)
+{
+    if (hash_table->concurrent) {
+        hg_atomic_incr32(&hash_table->seq);
+        hg_atomic_fence_release();
+    }
 }
 
-void
-hg_hash_table_register_free_functions(hg_hash_table_t *hash_table,
-    hg_hash_table_key_free_func_t key_free_func,
-    hg_hash_table_value_free_func_t value_free_func)
+static HG_UTIL_INLINE void
+hash_table_write_end(hg_hash_table_t *hash_table)
 {
-    hash_table->key_free_func = key_free_func;
-    hash_table->value_free_func = value_free_func;
+    if (hash_table->concurrent) {
+        hg_atomic_fence_release();
+        hg_atomic_incr32(&hash_table->seq);
+    }
 }
 
+/* Move entries into a new array of given size, also drops deleted slots */
+
 static int
-hash_table_enlarge(hg_hash_table_t *hash_table)
+hash_table_resize(hg_hash_table_t *hash_table, unsigned int new_size)
 {
-    hg_hash_table_entry_t **old_table;
-    unsigned int old_table_size;
-    unsigned int old_prime_index;
-    hg_hash_table_entry_t *rover;
-    hg_hash_table_entry_t *next;
-    unsigned int entry_index;
+    struct hash_table_array *old_array = hash_table_array_get(hash_table);
+    struct hash_table_array *new_array;
     unsigned int i;
 
-    /* Store a copy of the old table */
+    new_array = hash_table_array_alloc(new_size);
+    if (new_array == NULL) {
+        return 0;
+    }
 
-    old_table = hash_table->table;
-    old_table_size = hash_table->table_size;
-    old_prime_index = hash_table->prime_index;
+    for (i = 0; i <= old_array->mask; ++i) {
+        hg_util_uint64_t hash;
+        unsigned int index;
 
-    /* Allocate a new, larger table */
+        if (old_array->ctrl[i] & 0x80) {
+            continue;
+        }
 
-    ++hash_table->prime_index;
+        hash = hash_table_hash(hash_table, old_array->slots[i].key);
+        index = hash_table_find_free(new_array, hash);
+        new_array->slots[index] = old_array->slots[i];
+        hash_table_set_ctrl(new_array, index, HASH_TABLE_H2(hash));
+    }
 
-    if (!hash_table_allocate_table(hash_table)) {
+    /* Concurrent lookups may still read the old array */
+    if (hash_table->concurrent) {
+        new_array->retired = old_array;
+    } else {
+        free(old_array);
+    }
+    hg_atomic_set64(&hash_table->array, (hg_util_int64_t) new_array);
+    hash_table->deleted = 0;
 
-        /* Failed to allocate the new table */
+    return 1;
+}
 
-        hash_table->table = old_table;
-        hash_table->table_size = old_table_size;
-        hash_table->prime_index = old_prime_index;
+/* Free an entry, calling the free functions if there are any registered */
 
-        return 0;
+static void
+hash_table_free_entry(hg_hash_table_t *hash_table, hg_hash_table_entry_t *entry)
+{
+    if (hash_table->key_free_func != NULL) {
+        hash_table->key_free_func(entry->key);
+    }
+    if (hash_table->value_free_func != NULL) {
+        hash_table->value_free_func(entry->value);
     }
+}
 
-    /* Link all entries from all chains into the new table */
+static hg_hash_table_t *
+hash_table_new(hg_hash_table_hash_func_t hash_func,
+    hg_hash_table_equal_func_t equal_func, int concurrent)
+{
+    struct hash_table_array *array;
+    hg_hash_table_t *hash_table;
 
-    for (i = 0; i < old_table_size; ++i) {
-        rover = old_table[i];
+    hash_table = (hg_hash_table_t *) malloc(sizeof(hg_hash_table_t));
+    if (hash_table == NULL) {
+        return NULL;
+    }
 
-        while (rover != NULL) {
-            next = rover->next;
+    array = hash_table_array_alloc(HASH_TABLE_MIN_SIZE);
+    if (array == NULL) {
+        free(hash_table);
+        return NULL;
+    }
 
-            /* Find the index into the new table */
+    hg_atomic_init64(&hash_table->array, (hg_util_int64_t) array);
+    hash_table->hash_func = hash_func;
+    hash_table->equal_func = equal_func;
+    hash_table->key_free_func = NULL;
+    hash_table->value_free_func = NULL;
+    hash_table->entries = 0;
+    hash_table->deleted = 0;
+    hg_atomic_init32(&hash_table->seq, 0);
+    hash_table->concurrent = concurrent;
 
-            entry_index =
-                hash_table->hash_func(rover->key) % hash_table->table_size;
+    return hash_table;
+}
 
-            /* Link this entry into the chain */
+hg_hash_table_t *
+hg_hash_table_new(
+    hg_hash_table_hash_func_t hash_func, hg_hash_table_equal_func_t equal_func)
+{
+    return hash_table_new(hash_func, equal_func, 0);
+}
 
-            rover->next = hash_table->table[entry_index];
-            hash_table->table[entry_index] = rover;
+hg_hash_table_t *
+hg_hash_table_new_concurrent(
+    hg_hash_table_hash_func_t hash_func, hg_hash_table_equal_func_t equal_func)
+{
+    return hash_table_new(hash_func, equal_func, 1);
+}
 
-            /* Advance to next in the chain */
+void
+hg_hash_table_free(hg_hash_table_t *hash_table)
+{
+    struct hash_table_array *array = hash_table_array_get(hash_table);
+    unsigned int i;
 
-            rover = next;
+    /* Free all entries */
+    for (i = 0; i <= array->mask; ++i) {
+        if (!(array->ctrl[i] & 0x80)) {
+            hash_table_free_entry(hash_table, &array->slots[i]);
         }
     }
 
-    /* Free the old table */
+    /* Free current and retired arrays */
+    while (array != NULL) {
+        struct hash_table_array *retired = array->retired;
 
-    free(old_table);
+        free(array);
+        array = retired;
+    }
 
-    return 1;
+    free(hash_table);
+}
+
+void
+hg_hash_table_register_free_functions(hg_hash_table_t *hash_table,
+    hg_hash_table_key_free_func_t key_free_func,
+    hg_hash_table_value_free_func_t value_free_func)
+{
+    hash_table->key_free_func = key_free_func;
+    hash_table->value_free_func = value_free_func;
 }
 
 int
 hg_hash_table_insert(hg_hash_table_t *hash_table, hg_hash_table_key_t key,
     hg_hash_table_value_t value)
 {
-    hg_hash_table_entry_t *rover;
-    hg_hash_table_entry_t *newentry;
-    unsigned int entry_index;
-
-    /* If there are too many items in the table with respect to the table
-     * size, the number of hash collisions increases and performance
-     * decreases. Enlarge the table size to prevent this happening */
-
-    if ((hash_table->entries * 3) / hash_table->table_size > 0) {
-
-        /* Table is more than 1/3 full */
-
-        if (!hash_table_enlarge(hash_table)) {
+    struct hash_table_array *array = hash_table_array_get(hash_table);
+    hg_util_uint64_t hash = hash_table_hash(hash_table, key);
+    unsigned int index;
+    int ret = 1;
+
+    hash_table_write_begin(hash_table);
+
+    if (hash_table_find(hash_table, array, key, hash, 0, &index)) {
+        /* Same key: free the old key and data and overwrite the entry */
+        hash_table_free_entry(hash_table, &array->slots[index]);
+        array->slots[index].key = key;
+        array->slots[index].value = value;
+        goto done;
+    }
 
-            /* Failed to enlarge the table */
+    /* Keep enough empty slots for lookups to terminate early, grow the
+     * table unless most used slots are deleted ones */
+    if (hash_table->entries + hash_table->deleted + 1 >
+        HASH_TABLE_MAX_USED(array->mask + 1)) {
+        unsigned int new_size = array->mask + 1;
 
-            return 0;
+        if (hash_table->entries + 1 > HASH_TABLE_MAX_USED(new_size) / 2) {
+            new_size *= 2;
+        }
+        if (!hash_table_resize(hash_table, new_size)) {
+            ret = 0;
+            goto done;
         }
+        array = hash_table_array_get(hash_table);
     }
 
-    /* Generate the hash of the key and hence the index into the table */
-
-    entry_index = hash_table->hash_func(key) % hash_table->table_size;
-
-    /* Traverse the chain at this location and look for an existing
-     * entry with the same key */
-
-    rover = hash_table->table[entry_index];
-
-    while (rover != NULL) {
-        if (hash_table->equal_func(rover->key, key) != 0) {
-
-            /* Same key: overwrite this entry with new data */
-
-            /* If there is a value free function, free the old data
-             * before adding in the new data */
+    index = hash_table_find_free(array, hash);
+    if (array->ctrl[index] == HASH_TABLE_DELETED) {
+        --hash_table->deleted;
+    }
+    array->slots[index].key = key;
+    array->slots[index].value = value;
+    hash_table_set_ctrl(array, index, HASH_TABLE_H2(hash));
+    ++hash_table->entries;
 
-            if (hash_table->value_free_func != NULL) {
-                hash_table->value_free_func(rover->value);
-            }
+done:
+    hash_table_write_end(hash_table);
 
-            /* Same with the key: use the new key value and free
-             * the old one */
+    return ret;
+}
 
-            if (hash_table->key_free_func != NULL) {
-                hash_table->key_free_func(rover->key);
-            }
+/* Lookup of concurrent tables, kept out of line so that regular lookups
+ * remain short */
 
-            rover->key = key;
-            rover->value = value;
+static hg_hash_table_value_t
+hash_table_lookup_concurrent(
+    hg_hash_table_t *hash_table, hg_hash_table_key_t key, hg_util_uint64_t hash)
+{
+    hg_hash_table_value_t value;
+    unsigned int index;
 
-            /* Finished */
+    for (;;) {
+        hg_util_int32_t seq = hg_atomic_get32(&hash_table->seq);
+        struct hash_table_array *array;
 
-            return 1;
+        if (seq & 1) {
+            /* Table is being modified */
+            hg_thread_yield();
+            continue;
         }
-        rover = rover->next;
-    }
-
-    /* Not in the hash table yet.  Create a new entry */
 
-    newentry = (hg_hash_table_entry_t *) malloc(sizeof(hg_hash_table_entry_t));
+        array = hash_table_array_get(hash_table);
+        value = hash_table_find(hash_table, array, key, hash, 1, &index)
+                    ? array->slots[index].value
+                    : HG_HASH_TABLE_NULL;
 
-    if (newentry == NULL) {
-        return 0;
+        hg_atomic_fence_acquire();
+        if (hg_atomic_get32(&hash_table->seq) == seq) {
+            return value;
+        }
     }
-
-    newentry->key = key;
-    newentry->value = value;
-
-    /* Link into the list */
-
-    newentry->next = hash_table->table[entry_index];
-    hash_table->table[entry_index] = newentry;
-
-    /* Maintain the count of the number of entries */
-
-    ++hash_table->entries;
-
-    /* Added successfully */
-
-    return 1;
 }
 
 hg_hash_table_value_t
 hg_hash_table_lookup(hg_hash_table_t *hash_table, hg_hash_table_key_t key)
 {
-    hg_hash_table_entry_t *rover;
-    unsigned int entry_index;
-
-    /* Generate the hash of the key and hence the index into the table */
+    hg_util_uint64_t hash = hash_table_hash(hash_table, key);
+    struct hash_table_array *array;
+    unsigned int index;
 
-    entry_index = hash_table->hash_func(key) % hash_table->table_size;
-
-    /* Walk the chain at this index until the corresponding entry is
-     * found */
-
-    rover = hash_table->table[entry_index];
-
-    while (rover != NULL) {
-        if (hash_table->equal_func(key, rover->key) != 0) {
-
-            /* Found the entry.  Return the data. */
-
-            return rover->value;
-        }
-        rover = rover->next;
+    if (hash_table->concurrent) {
+        return hash_table_lookup_concurrent(hash_table, key, hash);
     }
 
-    /* Not found */
+    array = hash_table_array_get(hash_table);
 
-    return HG_HASH_TABLE_NULL;
+    return hash_table_find(hash_table, array, key, hash, 0, &index)
+               ? array->slots[index].value
+               : HG_HASH_TABLE_NULL;
 }
 
 int
 hg_hash_table_remove(hg_hash_table_t *hash_table, hg_hash_table_key_t key)
 {
-    hg_hash_table_entry_t **rover;
-    hg_hash_table_entry_t *entry;
-    unsigned int entry_index;
-    int result;
-
-    /* Generate the hash of the key and hence the index into the table */
-
-    entry_index = hash_table->hash_func(key) % hash_table->table_size;
-
-    /* Rover points at the pointer which points at the current entry
-     * in the chain being inspected.  ie. the entry in the table, or
-     * the "next" pointer of the previous entry in the chain.  This
-     * allows us to unlink the entry when we find it. */
-
-    result = 0;
-    rover = &hash_table->table[entry_index];
-
-    while (*rover != NULL) {
-
-        if (hash_table->equal_func(key, (*rover)->key) != 0) {
-
-            /* This is the entry to remove */
-
-            entry = *rover;
-
-            /* Unlink from the list */
-
-            *rover = entry->next;
-
-            /* Destroy the entry structure */
-
-            hash_table_free_entry(hash_table, entry);
-
-            /* Track count of entries */
-
-            --hash_table->entries;
-
-            result = 1;
-
-            break;
+    struct hash_table_array *array = hash_table_array_get(hash_table);
+    hg_util_uint64_t hash = hash_table_hash(hash_table, key);
+    unsigned int index;
+    int result = 0;
+
+    hash_table_write_begin(hash_table);
+
+    if (hash_table_find(hash_table, array, key, hash, 0, &index)) {
+        hash_table_mask_t empty_before = hash_table_group_match_empty(
+            &array->ctrl[(index - HASH_TABLE_GROUP_WIDTH) & array->mask]);
+        hash_table_mask_t empty_after =
+            hash_table_group_match_empty(&array->ctrl[index]);
+
+        /* Slot must remain used if a probe may have continued past it, i.e.,
+         * if it has ever been part of a group without empty slots */
+        if (hash_table_mask_leading(empty_before) +
+                hash_table_mask_trailing(empty_after) <
+            HASH_TABLE_GROUP_WIDTH) {
+            hash_table_set_ctrl(array, index, HASH_TABLE_EMPTY);
+        } else {
+            hash_table_set_ctrl(array, index, HASH_TABLE_DELETED);
+            ++hash_table->deleted;
         }
-
-        /* Advance to the next entry */
-
-        rover = &((*rover)->next);
+        hash_table_free_entry(hash_table, &array->slots[index]);
+        --hash_table->entries;
+        result = 1;
     }
 
+    hash_table_write_end(hash_table);
+
     return result;
 }
 
@@ -436,91 +627,52 @@ hg_hash_table_num_entries(hg_hash_table_t *hash_table)
     return hash_table->entries;
 }
 
-void
-hg_hash_table_iterate(
-    hg_hash_table_t *hash_table, hg_hash_table_iter_t *iterator)
-{
-    unsigned int chain;
+/* Index of first full slot from index start (size if none) */
 
-    iterator->hash_table = hash_table;
-
-    /* Default value of next if no entries are found. */
-
-    iterator->next_entry = NULL;
-
-    /* Find the first entry */
-
-    for (chain = 0; chain < hash_table->table_size; ++chain) {
+static unsigned int
+hash_table_iter_seek(struct hash_table_array *array, unsigned int start)
+{
+    unsigned int i;
 
-        if (hash_table->table[chain] != NULL) {
-            iterator->next_entry = hash_table->table[chain];
-            iterator->next_chain = chain;
+    for (i = start; i <= array->mask; ++i) {
+        if (!(array->ctrl[i] & 0x80)) {
             break;
         }
     }
+
+    return i;
+}
+
+void
+hg_hash_table_iterate(
+    hg_hash_table_t *hash_table, hg_hash_table_iter_t *iterator)
+{
+    iterator->hash_table = hash_table;
+    iterator->next_slot =
+        hash_table_iter_seek(hash_table_array_get(hash_table), 0);
 }
 
 int
 hg_hash_table_iter_has_more(hg_hash_table_iter_t *iterator)
 {
-    return iterator->next_entry != NULL;
+    return iterator->next_slot <=
+           hash_table_array_get(iterator->hash_table)->mask;
 }
 
 hg_hash_table_value_t
 hg_hash_table_iter_next(hg_hash_table_iter_t *iterator)
 {
-    hg_hash_table_entry_t *current_entry;
-    hg_hash_table_t *hash_table;
+    struct hash_table_array *array =
+        hash_table_array_get(iterator->hash_table);
     hg_hash_table_value_t result;
-    unsigned int chain;
-
-    hash_table = iterator->hash_table;
 
     /* No more entries? */
-
-    if (iterator->next_entry == NULL) {
+    if (iterator->next_slot > array->mask) {
         return HG_HASH_TABLE_NULL;
     }
 
-    /* Result is immediately available */
-
-    current_entry = iterator->next_entry;
-    result = current_entry->value;
-
-    /* Find the next entry */
-
-    if (current_entry->next != NULL) {
-
-        /* Next entry in current chain */
-
-        iterator->next_entry = current_entry->next;
-
-    } else {
-
-        /* None left in this chain, so advance to the next chain */
-
-        chain = iterator->next_chain + 1;
-
-        /* Default value if no next chain found */
-
-        iterator->next_entry = NULL;
-
-        while (chain < hash_table->table_size) {
-
-            /* Is there anything in this chain? */
-
-            if (hash_table->table[chain] != NULL) {
-                iterator->next_entry = hash_table->table[chain];
-                break;
-            }
-
-            /* Try the next chain */
-
-            ++chain;
-        }
-
-        iterator->next_chain = chain;
-    }
+    result = array->slots[iterator->next_slot].value;
+    iterator->next_slot = hash_table_iter_seek(array, iterator->next_slot + 1);
 
     return result;
 }
@@ -40,6 +40,10 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  * \ref hg_hash_table_iterate to initialize a \ref hg_hash_table_iter
  * structure.  Each value can then be read in turn using
  * \ref hg_hash_table_iter_next and \ref hg_hash_table_iter_has_more.
+ *
+ * Keys and values are stored inline in an open addressing table, inserting
+ * a new key only allocates memory when the table grows. Entries may move
+ * when the table grows, pointers to internal entries must not be kept.
  */
 
 #ifndef HG_HASH_TABLE_H
@@ -87,8 +91,7 @@ typedef void *hg_hash_table_value_t;
 
 struct hg_hash_table_iter {
     hg_hash_table_t *hash_table;
-    hg_hash_table_entry_t *next_entry;
-    unsigned int next_chain;
+    unsigned int next_slot;
 };
 
 /**
@@ -146,6 +149,28 @@ HG_UTIL_PUBLIC hg_hash_table_t *
 hg_hash_table_new(
     hg_hash_table_hash_func_t hash_func, hg_hash_table_equal_func_t equal_func);
 
+/**
+ * Create a new hash table for read-mostly data. Lookups on that table do not
+ * take any lock and may run concurrently with one insertion or removal
+ * (modifications must still be serialized by the caller); they are retried
+ * if the table was modified in between. Keys and values that are replaced
+ * or removed may still be compared by concurrent lookups, they must remain
+ * valid until no lookup can observe them anymore (e.g., no free functions
+ * if entries are removed while lookups are in flight). Memory used by the
+ * table before it grew is released by \ref hg_hash_table_free.
+ *
+ * \param hash_func            Function used to generate hash keys for the
+ *                             keys used in the table.
+ * \param equal_func           Function used to test keys used in the table
+ *                             for equality.
+ * \return                     A new hash table structure, or NULL if it
+ *                             was not possible to allocate the new hash
+ *                             table.
+ */
+HG_UTIL_PUBLIC hg_hash_table_t *
+hg_hash_table_new_concurrent(
+    hg_hash_table_hash_func_t hash_func, hg_hash_table_equal_func_t equal_func);
+
 /**
  * Destroy a hash table.
  *
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_histogram.h"
+
+/****************/
+/* Local Macros */
+/****************/
+
+#define HG_HISTOGRAM_SUB_MASK (HG_HISTOGRAM_SUB_COUNT - 1)
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Return the position of the most significant bit set (value must not be 0).
+ */
+static unsigned int
+hg_histogram_msb(hg_util_uint64_t value);
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_histogram_msb(hg_util_uint64_t value)
+{
+#if defined(__GNUC__)
+    return 63 - (unsigned int) __builtin_clzll((unsigned long long) value);
+#else
+    unsigned int msb = 0;
+
+    while (value >>= 1)
+        msb++;
+
+    return msb;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_histogram_init(struct hg_histogram *histogram)
+{
+    unsigned int i;
+
+    for (i = 0; i < HG_HISTOGRAM_BUCKETS; i++)
+        hg_atomic_init64(&histogram->buckets[i], 0);
+    hg_atomic_init64(&histogram->count, 0);
+    hg_atomic_init64(&histogram->sum, 0);
+    hg_atomic_init64(&histogram->min, (hg_util_int64_t) HG_HISTOGRAM_MAX);
+    hg_atomic_init64(&histogram->max, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_histogram_record(struct hg_histogram *histogram, hg_util_uint64_t value)
+{
+    hg_util_int64_t bound;
+
+    if (value > HG_HISTOGRAM_MAX)
+        value = HG_HISTOGRAM_MAX;
+
+    hg_atomic_incr64_relaxed(&histogram->buckets[hg_histogram_bucket(value)]);
+    hg_atomic_add64_relaxed(&histogram->sum, (hg_util_int64_t) value);
+
+    /* Bounds rarely change once enough values are recorded */
+    bound = hg_atomic_get64(&histogram->min);
+    while ((hg_util_int64_t) value < bound &&
+           !hg_atomic_cas64(&histogram->min, bound, (hg_util_int64_t) value))
+        bound = hg_atomic_get64(&histogram->min);
+    bound = hg_atomic_get64(&histogram->max);
+    while ((hg_util_int64_t) value > bound &&
+           !hg_atomic_cas64(&histogram->max, bound, (hg_util_int64_t) value))
+        bound = hg_atomic_get64(&histogram->max);
+
+    /* Increment count last so that readers see a consistent sum */
+    hg_atomic_incr64(&histogram->count);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_util_uint64_t
+hg_histogram_percentile(struct hg_histogram *histogram, double percentile)
+{
+    hg_util_uint64_t count = hg_histogram_count(histogram), target, seen = 0;
+    unsigned int i;
+
+    if (count == 0)
+        return 0;
+
+    if (percentile < 0.0)
+        percentile = 0.0;
+    else if (percentile > 100.0)
+        percentile = 100.0;
+
+    target = (hg_util_uint64_t)((double) count * percentile / 100.0 + 0.5);
+    if (target == 0)
+        target = 1;
+
+    for (i = 0; i < HG_HISTOGRAM_BUCKETS; i++) {
+        seen += (hg_util_uint64_t) hg_atomic_get64(&histogram->buckets[i]);
+        if (seen >= target)
+            break;
+    }
+    if (i == HG_HISTOGRAM_BUCKETS)
+        return hg_histogram_max(histogram);
+
+    /* Highest value of bucket, not above max recorded value */
+    if (i + 1 < HG_HISTOGRAM_BUCKETS) {
+        hg_util_uint64_t value = hg_histogram_bucket_value(i + 1) - 1;
+        hg_util_uint64_t max = hg_histogram_max(histogram);
+
+        return (value < max) ? value : max;
+    }
+
+    return HG_HISTOGRAM_MAX;
+}
+
+/*---------------------------------------------------------------------------*/
+unsigned int
+hg_histogram_bucket(hg_util_uint64_t value)
+{
+    unsigned int msb, group;
+
+    if (value < HG_HISTOGRAM_SUB_COUNT)
+        return (unsigned int) value;
+    if (value > HG_HISTOGRAM_MAX)
+        value = HG_HISTOGRAM_MAX;
+
+    /* Values of [2^msb, 2^(msb + 1)) are split into linear sub-buckets */
+    msb = hg_histogram_msb(value);
+    group = msb - HG_HISTOGRAM_SUB_BITS + 1;
+
+    return group * HG_HISTOGRAM_SUB_COUNT +
+           ((unsigned int) (value >> (msb - HG_HISTOGRAM_SUB_BITS)) &
+               HG_HISTOGRAM_SUB_MASK);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_util_uint64_t
+hg_histogram_bucket_value(unsigned int index)
+{
+    unsigned int group = index / HG_HISTOGRAM_SUB_COUNT;
+
+    if (group == 0)
+        return index;
+
+    return (hg_util_uint64_t)(
+               HG_HISTOGRAM_SUB_COUNT + (index & HG_HISTOGRAM_SUB_MASK))
+           << (group - 1);
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_HISTOGRAM_H
+#define MERCURY_HISTOGRAM_H
+
+#include "mercury_atomic.h"
+#include "mercury_util_config.h"
+
+/* Log-linear histogram of unsigned values (HDR-style). Values below
+ * HG_HISTOGRAM_SUB_COUNT have their own bucket, larger values are grouped by
+ * power of two, each power of two being split into HG_HISTOGRAM_SUB_COUNT
+ * linear buckets, which bounds the relative error of a bucket to
+ * 1 / HG_HISTOGRAM_SUB_COUNT. Buckets are atomic counters so that several
+ * threads can record values concurrently without locking. */
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+#define HG_HISTOGRAM_SUB_BITS  3
+#define HG_HISTOGRAM_SUB_COUNT (1 << HG_HISTOGRAM_SUB_BITS)
+
+/* Values above 2^HG_HISTOGRAM_MAX_BITS - 1 are clamped to that value */
+#define HG_HISTOGRAM_MAX_BITS 40
+#define HG_HISTOGRAM_MAX                                                       \
+    (((hg_util_uint64_t) 1 << HG_HISTOGRAM_MAX_BITS) - 1)
+
+#define HG_HISTOGRAM_BUCKETS                                                   \
+    ((HG_HISTOGRAM_MAX_BITS - HG_HISTOGRAM_SUB_BITS + 1) *                     \
+        HG_HISTOGRAM_SUB_COUNT)
+
+struct hg_histogram {
+    hg_atomic_int64_t buckets[HG_HISTOGRAM_BUCKETS]; /* Bucket counts */
+    hg_atomic_int64_t count;                         /* Number of values */
+    hg_atomic_int64_t sum;                           /* Sum of values */
+    hg_atomic_int64_t min;                           /* Min value */
+    hg_atomic_int64_t max;                           /* Max value */
+};
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize an empty histogram.
+ *
+ * \param histogram [OUT]       pointer to histogram
+ */
+HG_UTIL_PUBLIC void
+hg_histogram_init(struct hg_histogram *histogram);
+
+/**
+ * Record value \value.
+ *
+ * \param histogram [IN/OUT]    pointer to histogram
+ * \param value [IN]            value
+ */
+HG_UTIL_PUBLIC void
+hg_histogram_record(struct hg_histogram *histogram, hg_util_uint64_t value);
+
+/**
+ * Return the value below which \percentile percent of the recorded values
+ * fall, within the precision of the buckets (highest value of the bucket).
+ *
+ * \param histogram [IN]        pointer to histogram
+ * \param percentile [IN]       percentile (between 0 and 100)
+ *
+ * \return value or 0 if histogram is empty
+ */
+HG_UTIL_PUBLIC hg_util_uint64_t
+hg_histogram_percentile(struct hg_histogram *histogram, double percentile);
+
+/**
+ * Return the index of the bucket that value \value falls into.
+ *
+ * \param value [IN]            value
+ *
+ * \return bucket index
+ */
+HG_UTIL_PUBLIC unsigned int
+hg_histogram_bucket(hg_util_uint64_t value);
+
+/**
+ * Return the lowest value of bucket \index.
+ *
+ * \param index [IN]            bucket index
+ *
+ * \return value
+ */
+HG_UTIL_PUBLIC hg_util_uint64_t
+hg_histogram_bucket_value(unsigned int index);
+
+/**
+ * Return the number of recorded values.
+ *
+ * \param histogram [IN]        pointer to histogram
+ *
+ * \return number of values
+ */
+static HG_UTIL_INLINE hg_util_uint64_t
+hg_histogram_count(struct hg_histogram *histogram);
+
+/**
+ * Return the min recorded value.
+ *
+ * \param histogram [IN]        pointer to histogram
+ *
+ * \return min value or 0 if histogram is empty
+ */
+static HG_UTIL_INLINE hg_util_uint64_t
+hg_histogram_min(struct hg_histogram *histogram);
+
+/**
+ * Return the max recorded value.
+ *
+ * \param histogram [IN]        pointer to histogram
+ *
+ * \return max value or 0 if histogram is empty
+ */
+static HG_UTIL_INLINE hg_util_uint64_t
+hg_histogram_max(struct hg_histogram *histogram);
+
+/**
+ * Return the mean of recorded values.
+ *
+ * \param histogram [IN]        pointer to histogram
+ *
+ * \return mean or 0 if histogram is empty
+ */
+static HG_UTIL_INLINE double
+hg_histogram_mean(struct hg_histogram *histogram);
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_uint64_t
+hg_histogram_count(struct hg_histogram *histogram)
+{
+    return (hg_util_uint64_t) hg_atomic_get64(&histogram->count);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_uint64_t
+hg_histogram_min(struct hg_histogram *histogram)
+{
+    return (hg_histogram_count(histogram) > 0)
+               ? (hg_util_uint64_t) hg_atomic_get64(&histogram->min)
+               : 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_uint64_t
+hg_histogram_max(struct hg_histogram *histogram)
+{
+    return (hg_util_uint64_t) hg_atomic_get64(&histogram->max);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE double
+hg_histogram_mean(struct hg_histogram *histogram)
+{
+    hg_util_uint64_t count = hg_histogram_count(histogram);
+
+    return (count > 0) ? (double) hg_atomic_get64(&histogram->sum) /
+                             (double) count
+                       : 0.0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_HISTOGRAM_H */
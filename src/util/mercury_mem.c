@@ -23,8 +23,205 @@
 #    include <sys/types.h>
 #    include <unistd.h>
 #endif
+#ifdef __linux__
+#    include <mntent.h>
+#    include <stdio.h>
+#    include <sys/syscall.h>
+#    include <sys/vfs.h>
+#endif
 #include <stdlib.h>
 
+/****************/
+/* Local Macros */
+/****************/
+
+/* Round size up to a multiple of align (power of 2) */
+#define HG_MEM_ROUND_UP(size, align)                                           \
+    (((size) + (align) - 1) & ~((size_t) (align) - 1))
+
+/* 1 GB huge pages */
+#define HG_MEM_HUGE_PAGE_SIZE_1GB (1UL << 30)
+#ifdef MAP_HUGETLB
+#    ifndef MAP_HUGE_SHIFT
+#        define MAP_HUGE_SHIFT 26
+#    endif
+#    define HG_MEM_MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+/* Max length of hugetlbfs paths */
+#define HG_MEM_HUGE_PATH_MAX 256
+
+/* NUMA memory policy (see mbind(2), avoid a dependency on libnuma) */
+#define HG_MEM_MPOL_PREFERRED 1
+#define HG_MEM_NUMA_NODE_MAX  1024
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Detect huge page size and hugetlbfs mount when the library is loaded.
+ */
+static void
+hg_mem_huge_init(void) HG_UTIL_CONSTRUCTOR;
+
+/**
+ * Length actually mapped by hg_mem_huge_alloc().
+ */
+static size_t
+hg_mem_huge_length(size_t size);
+
+#ifdef __linux__
+/**
+ * Generate path of shm file \name on hugetlbfs.
+ */
+static int
+hg_mem_huge_path(const char *name, char *path, size_t len);
+#endif
+
+#ifndef _WIN32
+/**
+ * Size file if it was just created and map it.
+ */
+static void *
+hg_mem_shm_map_fd(int fd, size_t size, size_t align);
+#endif
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static long hg_mem_huge_page_size_g = HG_MEM_HUGE_PAGE_SIZE;
+static char hg_mem_huge_path_g[HG_MEM_HUGE_PATH_MAX] = {'\0'};
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_mem_huge_init(void)
+{
+#if defined(_WIN32)
+    SIZE_T large_page_size = GetLargePageMinimum();
+
+    if (large_page_size > 0)
+        hg_mem_huge_page_size_g = (long) large_page_size;
+#elif defined(__linux__)
+    struct mntent *mnt;
+    char line[128];
+    FILE *file;
+
+    /* Default huge page size is reported in kB */
+    file = fopen("/proc/meminfo", "r");
+    if (file != NULL) {
+        while (fgets(line, (int) sizeof(line), file) != NULL) {
+            long huge_page_size_kb;
+
+            if (sscanf(line, "Hugepagesize: %ld kB", &huge_page_size_kb) == 1 &&
+                huge_page_size_kb > 0) {
+                hg_mem_huge_page_size_g = huge_page_size_kb * 1024;
+                break;
+            }
+        }
+        fclose(file);
+    }
+
+    /* Only use a writable mount of the default huge page size so that
+     * mappings can be released without knowing where they come from */
+    file = setmntent("/proc/mounts", "r");
+    if (file == NULL)
+        return;
+    while ((mnt = getmntent(file)) != NULL) {
+        struct statfs fs_stat;
+
+        if (strcmp(mnt->mnt_type, "hugetlbfs") != 0 ||
+            strlen(mnt->mnt_dir) >= HG_MEM_HUGE_PATH_MAX / 2)
+            continue;
+        if (statfs(mnt->mnt_dir, &fs_stat) != 0 ||
+            (long) fs_stat.f_bsize != hg_mem_huge_page_size_g ||
+            access(mnt->mnt_dir, W_OK) != 0)
+            continue;
+
+        strcpy(hg_mem_huge_path_g, mnt->mnt_dir);
+        HG_UTIL_LOG_DEBUG("Using hugetlbfs mount %s (%ld bytes pages)",
+            hg_mem_huge_path_g, hg_mem_huge_page_size_g);
+        break;
+    }
+    endmntent(file);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static size_t
+hg_mem_huge_length(size_t size)
+{
+    size_t huge_page_size = (size_t) hg_mem_huge_page_size_g;
+
+    return (size >= huge_page_size)
+               ? HG_MEM_ROUND_UP(size, huge_page_size)
+               : HG_MEM_ROUND_UP(size, (size_t) hg_mem_get_page_size());
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef __linux__
+static int
+hg_mem_huge_path(const char *name, char *path, size_t len)
+{
+    int rc;
+
+    if (hg_mem_huge_path_g[0] == '\0')
+        return HG_UTIL_FAIL;
+
+    rc = snprintf(path, len, "%s/%s", hg_mem_huge_path_g,
+        (name[0] == '/') ? name + 1 : name);
+
+    return (rc < 0 || (size_t) rc >= len) ? HG_UTIL_FAIL : HG_UTIL_SUCCESS;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+#ifndef _WIN32
+static void *
+hg_mem_shm_map_fd(int fd, size_t size, size_t align)
+{
+    struct stat shm_stat;
+    void *mem_ptr;
+    int rc;
+
+    rc = fstat(fd, &shm_stat);
+    HG_UTIL_CHECK_ERROR_NORET(
+        rc != 0, error, "fstat() failed (%s)", strerror(errno));
+
+    if (shm_stat.st_size == 0) {
+        rc = ftruncate(fd, (off_t) HG_MEM_ROUND_UP(size, align));
+        HG_UTIL_CHECK_ERROR_NORET(
+            rc != 0, error, "ftruncate() failed (%s)", strerror(errno));
+    } else
+        HG_UTIL_CHECK_ERROR_NORET(
+            shm_stat.st_size < (off_t) size, error, "shm file size too small");
+
+    mem_ptr = mmap(NULL, size, PROT_WRITE | PROT_READ, MAP_SHARED, fd, 0);
+    if (mem_ptr == MAP_FAILED)
+        return NULL;
+
+    return mem_ptr;
+
+error:
+    return NULL;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+long
+hg_mem_get_huge_page_size(void)
+{
+    return hg_mem_huge_page_size_g;
+}
+
+/*---------------------------------------------------------------------------*/
+const char *
+hg_mem_get_huge_page_path(void)
+{
+    return (hg_mem_huge_path_g[0] != '\0') ? hg_mem_huge_path_g : NULL;
+}
+
 /*---------------------------------------------------------------------------*/
 long
 hg_mem_get_page_size(void)
@@ -76,6 +273,169 @@ hg_mem_aligned_free(void *mem_ptr)
 #endif
 }
 
+/*---------------------------------------------------------------------------*/
+void *
+hg_mem_huge_alloc(size_t size, int numa_node)
+{
+    size_t length = hg_mem_huge_length(size);
+#ifdef _WIN32
+    void *mem_ptr =
+        hg_mem_aligned_alloc((size_t) hg_mem_get_page_size(), length);
+
+    (void) numa_node;
+    if (mem_ptr != NULL)
+        memset(mem_ptr, 0, length);
+
+    return mem_ptr;
+#else
+    size_t huge_page_size = (size_t) hg_mem_huge_page_size_g;
+    void *mem_ptr = MAP_FAILED;
+    char *raw_ptr, *aligned_ptr;
+
+    if (size < huge_page_size)
+        goto fallback;
+
+#    ifdef MAP_HUGETLB
+    /* Reserved huge pages */
+    if (length % HG_MEM_HUGE_PAGE_SIZE_1GB == 0)
+        mem_ptr = mmap(NULL, length, PROT_WRITE | PROT_READ,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | HG_MEM_MAP_HUGE_1GB, -1,
+            0);
+    if (mem_ptr == MAP_FAILED)
+        mem_ptr = mmap(NULL, length, PROT_WRITE | PROT_READ,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mem_ptr != MAP_FAILED)
+        goto done;
+    HG_UTIL_LOG_DEBUG("Could not map %zu bytes from huge page pool (%s)",
+        length, strerror(errno));
+#    endif
+
+    /* Transparent huge pages can only back huge page aligned ranges, over-map
+     * and trim both ends */
+    raw_ptr = mmap(NULL, length + huge_page_size, PROT_WRITE | PROT_READ,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    HG_UTIL_CHECK_ERROR_NORET(raw_ptr == MAP_FAILED, error,
+        "mmap() failed (%s)", strerror(errno));
+    aligned_ptr = (char *) HG_MEM_ROUND_UP((size_t) raw_ptr, huge_page_size);
+    if (aligned_ptr > raw_ptr)
+        (void) munmap(raw_ptr, (size_t) (aligned_ptr - raw_ptr));
+    (void) munmap(aligned_ptr + length,
+        (size_t) (raw_ptr + huge_page_size - aligned_ptr));
+#    ifdef MADV_HUGEPAGE
+    (void) madvise(aligned_ptr, length, MADV_HUGEPAGE);
+#    endif
+    mem_ptr = aligned_ptr;
+    goto done;
+
+fallback:
+    mem_ptr = mmap(NULL, length, PROT_WRITE | PROT_READ,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    HG_UTIL_CHECK_ERROR_NORET(mem_ptr == MAP_FAILED, error,
+        "mmap() failed (%s)", strerror(errno));
+
+done:
+    /* Pages are not touched yet, placement applies to all of them */
+    if (numa_node >= 0 &&
+        hg_mem_numa_bind(mem_ptr, length, numa_node) != HG_UTIL_SUCCESS)
+        HG_UTIL_LOG_DEBUG("Could not place memory on NUMA node %d", numa_node);
+
+    return mem_ptr;
+
+error:
+    return NULL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_mem_huge_free(void *mem_ptr, size_t size)
+{
+    if (mem_ptr == NULL)
+        return;
+#ifdef _WIN32
+    (void) size;
+    hg_mem_aligned_free(mem_ptr);
+#else
+    {
+        int rc = munmap(mem_ptr, hg_mem_huge_length(size));
+        HG_UTIL_CHECK_WARNING(rc != 0, "munmap() failed (%s)", strerror(errno));
+    }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_mem_numa_bind(void *mem_ptr, size_t size, int node)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    unsigned long
+        node_mask[HG_MEM_NUMA_NODE_MAX / (8 * sizeof(unsigned long))] = {0};
+    int ret = HG_UTIL_SUCCESS;
+    long rc;
+
+    HG_UTIL_CHECK_ERROR(node < 0 || node >= HG_MEM_NUMA_NODE_MAX, done, ret,
+        HG_UTIL_FAIL, "Invalid NUMA node (%d)", node);
+    node_mask[node / (8 * sizeof(unsigned long))] |=
+        1UL << (node % (8 * sizeof(unsigned long)));
+
+    /* Preferred rather than bound so that allocations can still succeed once
+     * the node is full */
+    rc = syscall(SYS_mbind, mem_ptr, size, HG_MEM_MPOL_PREFERRED, node_mask,
+        (unsigned long) HG_MEM_NUMA_NODE_MAX + 1, 0);
+    HG_UTIL_CHECK_ERROR(rc != 0, done, ret, HG_UTIL_FAIL,
+        "mbind() failed (%s)", strerror(errno));
+
+done:
+    return ret;
+#else
+    (void) mem_ptr;
+    (void) size;
+    (void) node;
+
+    return HG_UTIL_FAIL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_mem_get_device_numa_node(const char *device)
+{
+#ifdef __linux__
+    static const char *const device_paths[] = {
+        "/sys/class/infiniband/%s/device/numa_node",
+        "/sys/class/net/%s/device/numa_node"};
+    unsigned int i;
+
+    if (device == NULL)
+        return -1;
+
+    for (i = 0; i < sizeof(device_paths) / sizeof(device_paths[0]); i++) {
+        char path[128];
+        FILE *file;
+        int node = -1, rc;
+
+        rc = snprintf(path, sizeof(path), device_paths[i], device);
+        if (rc < 0 || (size_t) rc >= sizeof(path))
+            return -1;
+
+        file = fopen(path, "r");
+        if (file == NULL)
+            continue;
+        rc = fscanf(file, "%d", &node);
+        fclose(file);
+
+        /* Devices of single node systems report -1 */
+        return (rc == 1) ? node : -1;
+    }
+
+    return -1;
+#else
+    (void) device;
+
+    return -1;
+#endif
+}
+
 /*---------------------------------------------------------------------------*/
 void *
 hg_mem_shm_map(const char *name, size_t size, hg_util_bool_t create)
@@ -103,30 +463,52 @@ hg_mem_shm_map(const char *name, size_t size, hg_util_bool_t create)
     rc = CloseHandle(fd);
     HG_UTIL_CHECK_ERROR_NORET(!rc, error, "CloseHandle() failed");
 #else
-    int fd = 0;
+    int fd = -1;
     int flags = O_RDWR | (create ? O_CREAT : 0);
-    struct stat shm_stat;
     int rc;
 
-    fd = shm_open(name, flags, S_IRUSR | S_IWUSR);
-    HG_UTIL_CHECK_ERROR_NORET(
-        fd < 0, error, "shm_open() failed (%s)", strerror(errno));
+#    ifdef __linux__
+    char path[HG_MEM_HUGE_PATH_MAX];
 
-    rc = fstat(fd, &shm_stat);
-    HG_UTIL_CHECK_ERROR_NORET(
-        rc != 0, error, "fstat() failed (%s)", strerror(errno));
+    /* Existing files may have been created on hugetlbfs, new files are only
+     * created there if they span at least one huge page */
+    if ((!create || size >= (size_t) hg_mem_huge_page_size_g) &&
+        hg_mem_huge_path(name, path, sizeof(path)) == HG_UTIL_SUCCESS) {
+        fd = open(path, flags, S_IRUSR | S_IWUSR);
+        if (fd >= 0) {
+            mem_ptr =
+                hg_mem_shm_map_fd(fd, size, (size_t) hg_mem_huge_page_size_g);
+            if (mem_ptr == NULL && !create)
+                goto error;
+            if (mem_ptr == NULL) {
+                /* Not enough huge pages reserved */
+                HG_UTIL_LOG_DEBUG("Could not map %s from hugetlbfs (%s)", path,
+                    strerror(errno));
+                (void) close(fd);
+                (void) unlink(path);
+                fd = -1;
+            }
+        }
+    }
 
-    if (shm_stat.st_size == 0) {
-        rc = ftruncate(fd, (off_t) size);
-        HG_UTIL_CHECK_ERROR_NORET(
-            rc != 0, error, "ftruncate() failed (%s)", strerror(errno));
-    } else
+    if (mem_ptr == NULL) {
+#    endif
+        fd = shm_open(name, flags, S_IRUSR | S_IWUSR);
         HG_UTIL_CHECK_ERROR_NORET(
-            shm_stat.st_size < (off_t) size, error, "shm file size too small");
+            fd < 0, error, "shm_open() failed (%s)", strerror(errno));
 
-    mem_ptr = mmap(NULL, size, PROT_WRITE | PROT_READ, MAP_SHARED, fd, 0);
-    HG_UTIL_CHECK_ERROR_NORET(
-        mem_ptr == MAP_FAILED, error, "mmap() failed (%s)", strerror(errno));
+        mem_ptr = hg_mem_shm_map_fd(fd, size, 1);
+        HG_UTIL_CHECK_ERROR_NORET(mem_ptr == NULL, error,
+            "Could not map shm file (%s)", strerror(errno));
+
+#    ifdef MADV_HUGEPAGE
+        /* Let shmem merge large regions into transparent huge pages */
+        if (size >= (size_t) hg_mem_huge_page_size_g)
+            (void) madvise(mem_ptr, size, MADV_HUGEPAGE);
+#    endif
+#    ifdef __linux__
+    }
+#    endif
 
     /* The file descriptor can be closed without affecting the memory mapping */
     rc = close(fd);
@@ -141,7 +523,7 @@ error:
     if (fd)
         CloseHandle(fd);
 #else
-    if (fd > 0)
+    if (fd >= 0)
         close(fd);
 #endif
 
@@ -163,12 +545,29 @@ hg_mem_shm_unmap(const char *name, void *mem_ptr, size_t size)
 #else
     if (mem_ptr && mem_ptr != MAP_FAILED) {
         int rc = munmap(mem_ptr, size);
+#    ifdef __linux__
+        /* hugetlbfs mappings can only be unmapped in huge page units */
+        if (rc != 0 && errno == EINVAL && hg_mem_huge_path_g[0] != '\0')
+            rc = munmap(mem_ptr,
+                HG_MEM_ROUND_UP(size, (size_t) hg_mem_huge_page_size_g));
+#    endif
         HG_UTIL_CHECK_ERROR(rc != 0, done, ret, HG_UTIL_FAIL,
             "munmap() failed (%s)", strerror(errno));
     }
 
     if (name) {
-        int rc = shm_unlink(name);
+        int rc = -1;
+#    ifdef __linux__
+        char path[HG_MEM_HUGE_PATH_MAX];
+
+        if (hg_mem_huge_path(name, path, sizeof(path)) == HG_UTIL_SUCCESS) {
+            rc = unlink(path);
+            HG_UTIL_CHECK_ERROR(rc != 0 && errno != ENOENT, done, ret,
+                HG_UTIL_FAIL, "unlink() failed (%s)", strerror(errno));
+        }
+        if (rc != 0)
+#    endif
+            rc = shm_unlink(name);
         HG_UTIL_CHECK_ERROR(rc != 0, done, ret, HG_UTIL_FAIL,
             "shm_unlink() failed (%s)", strerror(errno));
     }
@@ -24,6 +24,9 @@
 #define HG_MEM_CACHE_LINE_SIZE 64
 #define HG_MEM_PAGE_SIZE       4096
 
+/* Default huge page size (used if the system does not report one) */
+#define HG_MEM_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -40,6 +43,23 @@ extern "C" {
 HG_UTIL_PUBLIC long
 hg_mem_get_page_size(void);
 
+/**
+ * Get system default huge page size (2 MB or 1 GB on most systems).
+ *
+ * \return huge page size on success or negative on failure
+ */
+HG_UTIL_PUBLIC long
+hg_mem_get_huge_page_size(void);
+
+/**
+ * Get path to the hugetlbfs mount point used to back shared-memory regions.
+ *
+ * \return path or NULL if no hugetlbfs mount of the default huge page size
+ * is available
+ */
+HG_UTIL_PUBLIC const char *
+hg_mem_get_huge_page_path(void);
+
 /**
  * Allocate size bytes and return a pointer to the allocated memory.
  * The memory address will be a multiple of alignment, which must be a power of
@@ -61,8 +81,60 @@ hg_mem_aligned_alloc(size_t alignment, size_t size);
 HG_UTIL_PUBLIC void
 hg_mem_aligned_free(void *mem_ptr);
 
+/**
+ * Allocate size bytes of zeroed memory, backed by huge pages if possible.
+ * Allocations of at least one huge page are first mapped from the reserved
+ * huge page pool (1 GB pages are used when size is a multiple of 1 GB), then
+ * fall back to normal pages that are advised to be merged into transparent
+ * huge pages. Smaller allocations are page-aligned.
+ *
+ * \param size [IN]             total requested size
+ * \param numa_node [IN]        preferred NUMA node (negative for none)
+ *
+ * \return a pointer to the allocated memory, or NULL in case of failure
+ */
+HG_UTIL_PUBLIC void *
+hg_mem_huge_alloc(size_t size, int numa_node);
+
+/**
+ * Free memory allocated from hg_mem_huge_alloc().
+ *
+ * \param mem_ptr [IN]          pointer to allocated memory
+ * \param size [IN]             size passed to hg_mem_huge_alloc()
+ */
+HG_UTIL_PUBLIC void
+hg_mem_huge_free(void *mem_ptr, size_t size);
+
+/**
+ * Set preferred NUMA node of the pages of [\mem_ptr, \mem_ptr + \size), which
+ * must be page-aligned. Pages that are already touched are not moved, this
+ * should be called right after mapping memory.
+ *
+ * \param mem_ptr [IN]          pointer to memory
+ * \param size [IN]             size of memory range
+ * \param node [IN]             NUMA node
+ *
+ * \return non-negative on success, or negative in case of failure
+ */
+HG_UTIL_PUBLIC int
+hg_mem_numa_bind(void *mem_ptr, size_t size, int node);
+
+/**
+ * Get NUMA node that a network device is attached to.
+ *
+ * \param device [IN]           RDMA device (e.g., mlx5_0) or interface name
+ *
+ * \return NUMA node or negative if unknown
+ */
+HG_UTIL_PUBLIC int
+hg_mem_get_device_numa_node(const char *device);
+
 /**
  * Create/open a shared-memory mapped file of size \size with name \name.
+ * Files of at least one huge page are created on hugetlbfs when a mount is
+ * available and huge pages can be reserved, and fall back to regular
+ * shared memory otherwise. Opening an existing file maps it from wherever it
+ * was created.
  *
  * \param name [IN]             name of mapped file
  * \param size [IN]             total requested size
@@ -74,7 +146,7 @@ HG_UTIL_PUBLIC void *
 hg_mem_shm_map(const char *name, size_t size, hg_util_bool_t create);
 
 /**
- * Unmap a previously mapped region and close the file.
+ * Unmap a previously mapped region and remove the file if \name is not NULL.
  *
  * \param name [IN]             name of mapped file
  * \param mem_ptr [IN]          pointer to mapped memory region
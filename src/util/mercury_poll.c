@@ -10,6 +10,7 @@
 
 #include "mercury_poll.h"
 #include "mercury_event.h"
+#include "mercury_list.h"
 #include "mercury_thread_mutex.h"
 #include "mercury_util_error.h"
 
@@ -29,6 +30,13 @@
 #    else
 #        include <poll.h>
 #    endif
+#    if defined(HG_UTIL_HAS_IO_URING)
+#        include <linux/io_uring.h>
+#        include <poll.h>
+#        include <signal.h>
+#        include <sys/mman.h>
+#        include <sys/syscall.h>
+#    endif
 #endif /* defined(_WIN32) */
 
 /****************/
@@ -41,13 +49,64 @@
 #ifndef MIN
 #    define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #endif
+#ifndef MAX
+#    define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+#ifdef HG_UTIL_HAS_IO_URING
+/* Size of submission queue */
+#    define HG_POLL_URING_ENTRIES 256
+
+/* Poll requests that are linked to event reads are tagged with that bit */
+#    define HG_POLL_URING_LINK 1ULL
+
+/* Features that are required, older kernels fall back to epoll */
+#    define HG_POLL_URING_FEATURES                                             \
+        (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_EXT_ARG | IORING_FEAT_CQE_SKIP)
+#endif
 
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
 
+#ifdef HG_UTIL_HAS_IO_URING
+/* File descriptor polled by an io_uring poll set. Regular file descriptors
+ * are polled with a multishot poll request, events are read directly by a
+ * poll request linked to a read request, so that notifications are consumed
+ * without an additional system call. */
+struct hg_poll_uring_fd {
+    HG_LIST_ENTRY(hg_poll_uring_fd) entry; /* Entry in fd list */
+    hg_poll_data_t data;                   /* User data */
+    hg_util_uint64_t count;                /* Event read buffer */
+    hg_util_uint32_t events;               /* Poll events */
+    int fd;                                /* File descriptor */
+    int removed;                           /* Removed, wait for last CQE */
+};
+
+/* Mapped rings of an io_uring instance */
+struct hg_poll_uring {
+    HG_LIST_HEAD(hg_poll_uring_fd) fds; /* Polled fds (incl. removed ones) */
+    void *ring;                         /* SQ and CQ rings */
+    struct io_uring_sqe *sqes;          /* SQ entries */
+    struct io_uring_cqe *cqes;          /* CQ entries */
+    unsigned int *sq_head;
+    unsigned int *sq_tail;
+    unsigned int *sq_array;
+    unsigned int *cq_head;
+    unsigned int *cq_tail;
+    size_t ring_size;
+    unsigned int sq_mask;
+    unsigned int sq_entries;
+    unsigned int cq_mask;
+    unsigned int pending; /* Queued SQEs that are not submitted yet */
+};
+#endif
+
 struct hg_poll_set {
     hg_thread_mutex_t lock;
+#ifdef HG_UTIL_HAS_IO_URING
+    struct hg_poll_uring *uring; /* NULL if not using io_uring */
+#endif
 #if defined(HG_UTIL_HAS_SYSEPOLL_H)
     struct epoll_event *events;
 #elif defined(HG_UTIL_HAS_SYSEVENT_H)
@@ -65,10 +124,504 @@ struct hg_poll_set {
 /* Local Prototypes */
 /********************/
 
+#ifdef HG_UTIL_HAS_IO_URING
+/**
+ * Create io_uring instance, fails if not supported.
+ */
+static int
+hg_poll_uring_create(struct hg_poll_set *poll_set);
+
+/**
+ * Destroy io_uring instance.
+ */
+static void
+hg_poll_uring_destroy(struct hg_poll_set *poll_set);
+
+/**
+ * Submit queued SQEs.
+ */
+static int
+hg_poll_uring_submit(struct hg_poll_set *poll_set);
+
+/**
+ * Get a free SQE, submit queued SQEs if the SQ is full.
+ */
+static struct io_uring_sqe *
+hg_poll_uring_get_sqe(struct hg_poll_set *poll_set);
+
+/**
+ * Queue requests that poll fd.
+ */
+static int
+hg_poll_uring_arm(
+    struct hg_poll_set *poll_set, struct hg_poll_uring_fd *uring_fd);
+
+/**
+ * Add fd to io_uring poll set.
+ */
+static int
+hg_poll_uring_add(hg_poll_set_t *poll_set, int fd, struct hg_poll_event *event);
+
+/**
+ * Remove fd from io_uring poll set.
+ */
+static int
+hg_poll_uring_remove(hg_poll_set_t *poll_set, int fd);
+
+/**
+ * Convert CQEs to events.
+ */
+static unsigned int
+hg_poll_uring_reap(struct hg_poll_set *poll_set, unsigned int max_events,
+    struct hg_poll_event *events);
+
+/**
+ * Wait on io_uring poll set.
+ */
+static int
+hg_poll_uring_wait(hg_poll_set_t *poll_set, unsigned int timeout,
+    unsigned int max_events, struct hg_poll_event events[],
+    unsigned int *actual_events);
+#endif
+
 /*******************/
 /* Local Variables */
 /*******************/
 
+#ifdef HG_UTIL_HAS_IO_URING
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_create(struct hg_poll_set *poll_set)
+{
+    struct hg_poll_uring *uring = NULL;
+    struct io_uring_params params;
+    size_t sq_ring_size, cq_ring_size;
+    int fd;
+
+    memset(&params, 0, sizeof(params));
+    fd = (int) syscall(__NR_io_uring_setup, HG_POLL_URING_ENTRIES, &params);
+    if (fd < 0) {
+        HG_UTIL_LOG_DEBUG("io_uring_setup() failed (%s)", strerror(errno));
+        return HG_UTIL_FAIL;
+    }
+    if ((params.features & HG_POLL_URING_FEATURES) != HG_POLL_URING_FEATURES) {
+        HG_UTIL_LOG_DEBUG("io_uring features not supported (%#x)",
+            (unsigned int) params.features);
+        goto error;
+    }
+
+    uring = (struct hg_poll_uring *) calloc(1, sizeof(*uring));
+    HG_UTIL_CHECK_ERROR_NORET(
+        uring == NULL, error, "calloc() failed (%s)", strerror(errno));
+    HG_LIST_INIT(&uring->fds);
+    uring->ring = MAP_FAILED;
+    uring->sqes = MAP_FAILED;
+    poll_set->uring = uring;
+    poll_set->fd = fd;
+
+    /* SQ and CQ rings share a single mapping */
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    uring->ring_size = MAX(sq_ring_size, cq_ring_size);
+    uring->ring = mmap(NULL, uring->ring_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    HG_UTIL_CHECK_ERROR_NORET(uring->ring == MAP_FAILED, error,
+        "mmap() failed (%s)", strerror(errno));
+
+    uring->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+        IORING_OFF_SQES);
+    HG_UTIL_CHECK_ERROR_NORET(uring->sqes == MAP_FAILED, error,
+        "mmap() failed (%s)", strerror(errno));
+
+    uring->sq_head = (unsigned int *) ((char *) uring->ring +
+                                       params.sq_off.head);
+    uring->sq_tail = (unsigned int *) ((char *) uring->ring +
+                                       params.sq_off.tail);
+    uring->sq_array = (unsigned int *) ((char *) uring->ring +
+                                        params.sq_off.array);
+    uring->sq_mask =
+        *(unsigned int *) ((char *) uring->ring + params.sq_off.ring_mask);
+    uring->sq_entries = params.sq_entries;
+    uring->cq_head = (unsigned int *) ((char *) uring->ring +
+                                       params.cq_off.head);
+    uring->cq_tail = (unsigned int *) ((char *) uring->ring +
+                                       params.cq_off.tail);
+    uring->cqes = (struct io_uring_cqe *) ((char *) uring->ring +
+                                           params.cq_off.cqes);
+    uring->cq_mask =
+        *(unsigned int *) ((char *) uring->ring + params.cq_off.ring_mask);
+
+    return HG_UTIL_SUCCESS;
+
+error:
+    if (uring) {
+        hg_poll_uring_destroy(poll_set);
+        poll_set->uring = NULL;
+        poll_set->fd = -1;
+    } else
+        close(fd);
+
+    return HG_UTIL_FAIL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_poll_uring_destroy(struct hg_poll_set *poll_set)
+{
+    struct hg_poll_uring *uring = poll_set->uring;
+    struct hg_poll_uring_fd *uring_fd;
+    struct hg_poll_event event;
+
+    /* Wait for removed fds to be canceled so that the kernel no longer
+     * references them */
+    while (!HG_LIST_IS_EMPTY(&uring->fds)) {
+        struct io_uring_getevents_arg arg;
+        struct __kernel_timespec ts = {0, 100000000LL};
+        long rc;
+
+        memset(&arg, 0, sizeof(arg));
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = (__u64) &ts;
+        rc = syscall(__NR_io_uring_enter, poll_set->fd, uring->pending, 1,
+            IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+        if (rc < 0 && errno != EINTR)
+            break;
+        if (rc > 0)
+            uring->pending -= (unsigned int) rc;
+        (void) hg_poll_uring_reap(poll_set, 1, &event);
+    }
+    close(poll_set->fd);
+
+    if (uring->sqes != MAP_FAILED)
+        munmap(uring->sqes, uring->sq_entries * sizeof(struct io_uring_sqe));
+    if (uring->ring != MAP_FAILED)
+        munmap(uring->ring, uring->ring_size);
+
+    /* Free removed fds whose last CQE was never reaped */
+    while ((uring_fd = HG_LIST_FIRST(&uring->fds)) != NULL) {
+        HG_LIST_REMOVE(uring_fd, entry);
+        free(uring_fd);
+    }
+    free(uring);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_submit(struct hg_poll_set *poll_set)
+{
+    struct hg_poll_uring *uring = poll_set->uring;
+    int ret = HG_UTIL_SUCCESS;
+    long rc;
+
+    while (uring->pending > 0) {
+        rc = syscall(
+            __NR_io_uring_enter, poll_set->fd, uring->pending, 0, 0, NULL, 0);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        HG_UTIL_CHECK_ERROR(rc < 0, done, ret, HG_UTIL_FAIL,
+            "io_uring_enter() failed (%s)", strerror(errno));
+        uring->pending -= (unsigned int) rc;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct io_uring_sqe *
+hg_poll_uring_get_sqe(struct hg_poll_set *poll_set)
+{
+    struct hg_poll_uring *uring = poll_set->uring;
+    struct io_uring_sqe *sqe;
+    unsigned int tail = *uring->sq_tail, index;
+
+    /* SQ is full, flush it */
+    if (tail - __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE) ==
+        uring->sq_entries) {
+        if (hg_poll_uring_submit(poll_set) != HG_UTIL_SUCCESS)
+            return NULL;
+    }
+
+    index = tail & uring->sq_mask;
+    sqe = &uring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    uring->sq_array[index] = index;
+
+    /* SQE is visible to the kernel once it is submitted */
+    __atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    uring->pending++;
+
+    return sqe;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_arm(
+    struct hg_poll_set *poll_set, struct hg_poll_uring_fd *uring_fd)
+{
+    struct io_uring_sqe *sqe;
+    int ret = HG_UTIL_SUCCESS;
+
+    /* Linked requests must be queued together */
+    if ((uring_fd->events & HG_POLLEVENT) &&
+        *poll_set->uring->sq_tail -
+                __atomic_load_n(poll_set->uring->sq_head, __ATOMIC_ACQUIRE) >=
+            poll_set->uring->sq_entries - 1) {
+        ret = hg_poll_uring_submit(poll_set);
+        HG_UTIL_CHECK_ERROR(ret != HG_UTIL_SUCCESS, done, ret, HG_UTIL_FAIL,
+            "Could not flush SQ");
+    }
+
+    sqe = hg_poll_uring_get_sqe(poll_set);
+    HG_UTIL_CHECK_ERROR(
+        sqe == NULL, done, ret, HG_UTIL_FAIL, "Could not get SQE");
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = uring_fd->fd;
+
+    if (uring_fd->events & HG_POLLEVENT) {
+        /* Poll request only completes if it fails, the read then completes
+         * with -ECANCELED */
+        sqe->poll32_events = POLLIN;
+        sqe->flags = IOSQE_IO_LINK | IOSQE_CQE_SKIP_SUCCESS;
+        sqe->user_data = (__u64) uring_fd | HG_POLL_URING_LINK;
+
+        sqe = hg_poll_uring_get_sqe(poll_set);
+        HG_UTIL_CHECK_ERROR(
+            sqe == NULL, done, ret, HG_UTIL_FAIL, "Could not get SQE");
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = uring_fd->fd;
+        sqe->addr = (__u64) &uring_fd->count;
+        sqe->len = sizeof(uring_fd->count);
+        sqe->off = (__u64) -1;
+        sqe->user_data = (__u64) uring_fd;
+    } else {
+        if (uring_fd->events & HG_POLLIN)
+            sqe->poll32_events |= POLLIN;
+        if (uring_fd->events & HG_POLLOUT)
+            sqe->poll32_events |= POLLOUT;
+        sqe->len = IORING_POLL_ADD_MULTI;
+        sqe->user_data = (__u64) uring_fd;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_add(hg_poll_set_t *poll_set, int fd, struct hg_poll_event *event)
+{
+    struct hg_poll_uring_fd *uring_fd;
+    int ret = HG_UTIL_SUCCESS;
+
+    uring_fd = (struct hg_poll_uring_fd *) calloc(1, sizeof(*uring_fd));
+    HG_UTIL_CHECK_ERROR(uring_fd == NULL, done, ret, HG_UTIL_FAIL,
+        "calloc() failed (%s)", strerror(errno));
+    uring_fd->fd = fd;
+    uring_fd->data = event->data;
+    uring_fd->events = event->events;
+
+    hg_thread_mutex_lock(&poll_set->lock);
+
+    /* Requests are submitted right away so that errors are reported */
+    ret = hg_poll_uring_arm(poll_set, uring_fd);
+    if (ret == HG_UTIL_SUCCESS)
+        ret = hg_poll_uring_submit(poll_set);
+    if (ret != HG_UTIL_SUCCESS) {
+        hg_thread_mutex_unlock(&poll_set->lock);
+        free(uring_fd);
+        goto done;
+    }
+    HG_LIST_INSERT_HEAD(&poll_set->uring->fds, uring_fd, entry);
+    poll_set->nfds++;
+
+    hg_thread_mutex_unlock(&poll_set->lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_remove(hg_poll_set_t *poll_set, int fd)
+{
+    struct hg_poll_uring_fd *uring_fd;
+    struct io_uring_sqe *sqe;
+    int ret = HG_UTIL_SUCCESS;
+
+    hg_thread_mutex_lock(&poll_set->lock);
+
+    HG_LIST_FOREACH (uring_fd, &poll_set->uring->fds, entry)
+        if (uring_fd->fd == fd && !uring_fd->removed)
+            break;
+    HG_UTIL_CHECK_ERROR(uring_fd == NULL, unlock, ret, HG_UTIL_FAIL,
+        "Could not find fd in poll_set");
+
+    /* Fd is freed once its last CQE is reaped */
+    sqe = hg_poll_uring_get_sqe(poll_set);
+    HG_UTIL_CHECK_ERROR(
+        sqe == NULL, unlock, ret, HG_UTIL_FAIL, "Could not get SQE");
+    if (uring_fd->events & HG_POLLEVENT) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = (__u64) uring_fd | HG_POLL_URING_LINK;
+    } else {
+        sqe->opcode = IORING_OP_POLL_REMOVE;
+        sqe->addr = (__u64) uring_fd;
+    }
+    sqe->user_data = 0;
+
+    ret = hg_poll_uring_submit(poll_set);
+    HG_UTIL_CHECK_ERROR_DONE(ret != HG_UTIL_SUCCESS, "Could not submit SQE");
+
+    uring_fd->removed = 1;
+    poll_set->nfds--;
+
+unlock:
+    hg_thread_mutex_unlock(&poll_set->lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_poll_uring_reap(struct hg_poll_set *poll_set, unsigned int max_events,
+    struct hg_poll_event *events)
+{
+    struct hg_poll_uring *uring = poll_set->uring;
+    unsigned int head = *uring->cq_head, nevents = 0;
+    unsigned int tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+
+    while (head != tail && nevents < max_events) {
+        struct io_uring_cqe *cqe = &uring->cqes[head & uring->cq_mask];
+        struct hg_poll_uring_fd *uring_fd =
+            (struct hg_poll_uring_fd *) cqe->user_data;
+        hg_util_int32_t res = cqe->res;
+        hg_util_uint32_t revents = 0;
+        hg_util_bool_t last;
+
+        head++;
+
+        /* Cancel requests and failed linked poll requests */
+        if (cqe->user_data == 0 || (cqe->user_data & HG_POLL_URING_LINK))
+            continue;
+
+        /* Read requests complete once, multishot poll requests complete for
+         * the last time when they are removed or have failed */
+        last = (uring_fd->events & HG_POLLEVENT) ||
+               !(cqe->flags & IORING_CQE_F_MORE);
+
+        if (uring_fd->removed) {
+            if (last) {
+                HG_LIST_REMOVE(uring_fd, entry);
+                free(uring_fd);
+            }
+            continue;
+        }
+
+        if (uring_fd->events & HG_POLLEVENT) {
+            /* Event was read, -EAGAIN if someone else read it first */
+            if (res == (hg_util_int32_t) sizeof(uring_fd->count))
+                revents = HG_POLLIN | HG_POLLEVENT;
+            else if (res != -EAGAIN)
+                revents = HG_POLLERR;
+        } else if (res >= 0) {
+            if (res & POLLIN)
+                revents |= HG_POLLIN;
+            if (res & POLLOUT)
+                revents |= HG_POLLOUT;
+
+            /* Don't change the if/else order */
+            if (res & POLLERR)
+                revents |= HG_POLLERR;
+            else if (res & POLLHUP)
+                revents |= HG_POLLHUP;
+        } else
+            revents = HG_POLLERR;
+
+        /* Re-arm unless the fd is in error, requests are submitted with the
+         * next wait */
+        if (last && !(revents & HG_POLLERR) &&
+            hg_poll_uring_arm(poll_set, uring_fd) != HG_UTIL_SUCCESS)
+            revents |= HG_POLLERR;
+
+        if (revents != 0) {
+            events[nevents].events = revents;
+            events[nevents].data = uring_fd->data;
+            nevents++;
+        }
+    }
+
+    __atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+
+    return nevents;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_wait(hg_poll_set_t *poll_set, unsigned int timeout,
+    unsigned int max_events, struct hg_poll_event events[],
+    unsigned int *actual_events)
+{
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+    unsigned int nevents, to_submit;
+    int ret = HG_UTIL_SUCCESS;
+    long rc;
+
+    hg_thread_mutex_lock(&poll_set->lock);
+    nevents = hg_poll_uring_reap(poll_set, max_events, events);
+    if (nevents > 0 || timeout == 0) {
+        ret = hg_poll_uring_submit(poll_set);
+        hg_thread_mutex_unlock(&poll_set->lock);
+        goto done;
+    }
+    to_submit = poll_set->uring->pending;
+    poll_set->uring->pending = 0;
+    hg_thread_mutex_unlock(&poll_set->lock);
+
+    /* Submit queued requests and wait in a single call */
+    ts.tv_sec = timeout / 1000;
+    ts.tv_nsec = (long long) (timeout % 1000) * 1000000LL;
+    memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = (__u64) &ts;
+    rc = syscall(__NR_io_uring_enter, poll_set->fd, to_submit, 1,
+        IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+
+    hg_thread_mutex_lock(&poll_set->lock);
+    if (rc < 0) {
+        /* Nothing was submitted */
+        poll_set->uring->pending += to_submit;
+        if (errno == EINTR) {
+            hg_thread_mutex_unlock(&poll_set->lock);
+            events[0].events |= HG_POLLINTR;
+            *actual_events = 1;
+
+            /* Reset errno */
+            errno = 0;
+
+            return HG_UTIL_SUCCESS;
+        }
+        HG_UTIL_CHECK_ERROR(errno != ETIME, unlock, ret, HG_UTIL_FAIL,
+            "io_uring_enter() failed (%s)", strerror(errno));
+    } else
+        poll_set->uring->pending += to_submit - (unsigned int) rc;
+    nevents = hg_poll_uring_reap(poll_set, max_events, events);
+    if (poll_set->uring->pending > 0)
+        ret = hg_poll_uring_submit(poll_set);
+
+unlock:
+    hg_thread_mutex_unlock(&poll_set->lock);
+
+done:
+    *actual_events = nevents;
+
+    return ret;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 hg_poll_set_t *
 hg_poll_create(void)
@@ -80,6 +633,9 @@ hg_poll_create(void)
         hg_poll_set == NULL, error, "malloc() failed (%s)", strerror(errno));
 
     hg_thread_mutex_init(&hg_poll_set->lock);
+#ifdef HG_UTIL_HAS_IO_URING
+    hg_poll_set->uring = NULL;
+#endif
     hg_poll_set->nfds = 0;
     hg_poll_set->max_events = HG_POLL_INIT_NEVENTS;
 
@@ -92,7 +648,11 @@ hg_poll_create(void)
 #if defined(_WIN32)
     /* TODO */
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H)
-    hg_poll_set->fd = epoll_create1(0);
+#    ifdef HG_UTIL_HAS_IO_URING
+    /* Fall back to epoll if io_uring is not supported */
+    if (hg_poll_uring_create(hg_poll_set) != HG_UTIL_SUCCESS)
+#    endif
+        hg_poll_set->fd = epoll_create1(0);
     HG_UTIL_CHECK_ERROR_NORET(hg_poll_set->fd == -1, error,
         "epoll_create1() failed (%s)", strerror(errno));
 #elif defined(HG_UTIL_HAS_SYSEVENT_H)
@@ -141,10 +701,18 @@ hg_poll_destroy(hg_poll_set_t *poll_set)
 #if defined(_WIN32)
     /* TODO */
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H) || defined(HG_UTIL_HAS_SYSEVENT_H)
-    /* Close poll descriptor */
-    rc = close(poll_set->fd);
-    HG_UTIL_CHECK_ERROR(rc == -1, done, ret, HG_UTIL_FAIL,
-        "close() failed (%s)", strerror(errno));
+#    ifdef HG_UTIL_HAS_IO_URING
+    if (poll_set->uring)
+        hg_poll_uring_destroy(poll_set);
+    else {
+#    endif
+        /* Close poll descriptor */
+        rc = close(poll_set->fd);
+        HG_UTIL_CHECK_ERROR(rc == -1, done, ret, HG_UTIL_FAIL,
+            "close() failed (%s)", strerror(errno));
+#    ifdef HG_UTIL_HAS_IO_URING
+    }
+#    endif
 #else
     rc = hg_event_destroy(poll_set->fd);
     HG_UTIL_CHECK_ERROR(rc == HG_UTIL_FAIL, done, ret, HG_UTIL_FAIL,
@@ -198,6 +766,11 @@ hg_poll_add(hg_poll_set_t *poll_set, int fd, struct hg_poll_event *event)
 
     HG_UTIL_LOG_DEBUG("Adding fd=%d to poll set (fd=%d)", fd, poll_set->fd);
 
+#ifdef HG_UTIL_HAS_IO_URING
+    if (poll_set->uring)
+        return hg_poll_uring_add(poll_set, fd, event);
+#endif
+
 #if defined(_WIN32)
     /* TODO */
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H)
@@ -294,6 +867,11 @@ hg_poll_remove(hg_poll_set_t *poll_set, int fd)
 
     HG_UTIL_LOG_DEBUG("Removing fd=%d from poll set (fd=%d)", fd, poll_set->fd);
 
+#ifdef HG_UTIL_HAS_IO_URING
+    if (poll_set->uring)
+        return hg_poll_uring_remove(poll_set, fd);
+#endif
+
 #if defined(_WIN32)
     /* TODO */
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H)
@@ -350,6 +928,12 @@ hg_poll_wait(hg_poll_set_t *poll_set, unsigned int timeout,
     int nfds = 0, i;
     int ret = HG_UTIL_SUCCESS;
 
+#ifdef HG_UTIL_HAS_IO_URING
+    if (poll_set->uring)
+        return hg_poll_uring_wait(
+            poll_set, timeout, max_events, events, actual_events);
+#endif
+
 #if defined(_WIN32)
 
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H)
@@ -44,6 +44,14 @@ struct hg_poll_event {
 #define HG_POLLHUP  (1 << 3) /* Hung up. */
 #define HG_POLLINTR (1 << 4) /* Interrupted. */
 
+/**
+ * When adding a file descriptor, HG_POLLEVENT indicates that it is an event
+ * from mercury_event.h, which the poll set may then consume itself. When set
+ * on a returned event, the notification was already consumed and
+ * hg_event_get() should not be called.
+ */
+#define HG_POLLEVENT (1 << 5)
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -53,7 +61,9 @@ extern "C" {
 #endif
 
 /**
- * Create a new poll set.
+ * Create a new poll set. If mercury was built with io_uring support and the
+ * running kernel supports it, the poll set is backed by an io_uring instance,
+ * otherwise by the default system poll mechanism.
  *
  * \return Pointer to poll set or NULL in case of failure
  */
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_PROBE_H
+#define MERCURY_PROBE_H
+
+#include "mercury_util_config.h"
+
+/* Static user-space probes (USDT) that tools such as bpftrace or SystemTap
+ * can attach to at runtime, e.g.:
+ *   bpftrace -e 'usdt:libmercury.so:mercury:forward { @[arg3] = count(); }'
+ * A probe is a single nop instruction while no tool is attached, probes are
+ * compiled out unless MERCURY_ENABLE_PROBES is ON. Probe arguments must be
+ * integers or pointers. */
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+#ifdef HG_UTIL_HAS_PROBES
+#    include <sys/sdt.h>
+
+#    define HG_PROBE1(provider, name, a1) DTRACE_PROBE1(provider, name, a1)
+#    define HG_PROBE2(provider, name, a1, a2)                                  \
+        DTRACE_PROBE2(provider, name, a1, a2)
+#    define HG_PROBE3(provider, name, a1, a2, a3)                              \
+        DTRACE_PROBE3(provider, name, a1, a2, a3)
+#    define HG_PROBE4(provider, name, a1, a2, a3, a4)                          \
+        DTRACE_PROBE4(provider, name, a1, a2, a3, a4)
+#else
+#    define HG_PROBE1(provider, name, a1)             (void) 0
+#    define HG_PROBE2(provider, name, a1, a2)         (void) 0
+#    define HG_PROBE3(provider, name, a1, a2, a3)     (void) 0
+#    define HG_PROBE4(provider, name, a1, a2, a3, a4) (void) 0
+#endif
+
+#endif /* MERCURY_PROBE_H */
@@ -20,6 +20,10 @@
 /* Local Macros */
 /****************/
 
+/* Time spent making non-blocking progress before blocking (ns), short round
+ * trips complete within it without sleeping in progress */
+#define HG_REQUEST_SPIN_TIME (20000)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -28,7 +32,8 @@ struct hg_request_class {
     hg_request_progress_func_t progress_func;
     hg_request_trigger_func_t trigger_func;
     void *arg;
-    hg_util_bool_t progressing;
+    hg_atomic_int32_t progressing; /* A thread is making progress */
+    hg_atomic_int32_t waiters;     /* Threads waiting on progress cond */
     hg_thread_mutex_t progress_mutex;
     hg_thread_cond_t progress_cond;
 };
@@ -37,6 +42,24 @@ struct hg_request_class {
 /* Local Prototypes */
 /********************/
 
+/**
+ * Trigger callbacks until none is left.
+ */
+static HG_UTIL_INLINE void
+hg_request_trigger(hg_request_class_t *request_class);
+
+/**
+ * Return index of first completed request, -1 if none completed.
+ */
+static HG_UTIL_INLINE int
+hg_request_completed(int count, hg_request_t *request[]);
+
+/**
+ * Make progress if no other thread does, return HG_UTIL_FALSE otherwise.
+ */
+static HG_UTIL_INLINE hg_util_bool_t
+hg_request_progress(hg_request_class_t *request_class, unsigned int timeout);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -56,7 +79,8 @@ hg_request_init(hg_request_progress_func_t progress_func,
     hg_request_class->progress_func = progress_func;
     hg_request_class->trigger_func = trigger_func;
     hg_request_class->arg = arg;
-    hg_request_class->progressing = HG_UTIL_FALSE;
+    hg_atomic_init32(&hg_request_class->progressing, HG_UTIL_FALSE);
+    hg_atomic_init32(&hg_request_class->waiters, 0);
     hg_thread_mutex_init(&hg_request_class->progress_mutex);
     hg_thread_cond_init(&hg_request_class->progress_cond);
 
@@ -103,59 +127,137 @@ hg_request_destroy(hg_request_t *request)
     free(request);
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_request_trigger(hg_request_class_t *request_class)
+{
+    unsigned int trigger_flag = 0;
+    int trigger_ret;
+
+    do {
+        trigger_ret =
+            request_class->trigger_func(0, &trigger_flag, request_class->arg);
+    } while ((trigger_ret == HG_UTIL_SUCCESS) && trigger_flag);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE int
+hg_request_completed(int count, hg_request_t *request[])
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+        if (hg_atomic_get32(&request[i]->completed) == HG_UTIL_TRUE)
+            return i;
+
+    return -1;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_bool_t
+hg_request_progress(hg_request_class_t *request_class, unsigned int timeout)
+{
+    if (!hg_atomic_cas32(&request_class->progressing, HG_UTIL_FALSE,
+            HG_UTIL_TRUE))
+        return HG_UTIL_FALSE;
+
+    request_class->progress_func(timeout, request_class->arg);
+
+    hg_atomic_set32(&request_class->progressing, HG_UTIL_FALSE);
+    hg_atomic_fence();
+
+    /* Only take the lock if threads wait for progress to be done */
+    if (hg_atomic_get32(&request_class->waiters) > 0) {
+        hg_thread_mutex_lock(&request_class->progress_mutex);
+        hg_thread_cond_broadcast(&request_class->progress_cond);
+        hg_thread_mutex_unlock(&request_class->progress_mutex);
+    }
+
+    return HG_UTIL_TRUE;
+}
+
 /*---------------------------------------------------------------------------*/
 int
 hg_request_wait(
     hg_request_t *request, unsigned int timeout_ms, unsigned int *flag)
 {
+    int index;
+    int ret;
+
+    ret = hg_request_waitany(1, &request, timeout_ms, &index);
+
+    if (flag)
+        *flag = (unsigned int) (index == 0);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_request_waitany(
+    int count, hg_request_t *request[], unsigned int timeout_ms, int *index)
+{
+    hg_request_class_t *request_class = request[0]->request_class;
     hg_time_t deadline, now, remaining = hg_time_from_ms(timeout_ms);
-    hg_util_int32_t completed = HG_UTIL_FALSE;
-    int ret = HG_UTIL_SUCCESS;
+    hg_time_ticks_t spin_end;
+    int completed = -1;
 
     hg_time_get_current_ms(&now);
     deadline = hg_time_add(now, remaining);
 
+    /* Spin first without blocking in progress or taking locks */
+    spin_end =
+        hg_time_get_ticks() + hg_time_ticks_from_ns(HG_REQUEST_SPIN_TIME);
     do {
-        unsigned int trigger_flag = 0;
-        int trigger_ret;
-
-        do {
-            trigger_ret = request->request_class->trigger_func(
-                0, &trigger_flag, request->request_class->arg);
-        } while ((trigger_ret == HG_UTIL_SUCCESS) && trigger_flag);
-
-        if ((completed = hg_atomic_get32(&request->completed)) == HG_UTIL_TRUE)
-            break;
-
-        hg_thread_mutex_lock(&request->request_class->progress_mutex);
-        if (request->request_class->progressing) {
-            if (hg_thread_cond_timedwait(&request->request_class->progress_cond,
-                    &request->request_class->progress_mutex,
-                    hg_time_to_ms(remaining)) != HG_UTIL_SUCCESS) {
-                /* Timeout occurred so leave */
-                break;
-            }
-            /* Continue as request may have completed in the meantime */
-            goto next;
-        }
-        request->request_class->progressing = HG_UTIL_TRUE;
-        hg_thread_mutex_unlock(&request->request_class->progress_mutex);
+        hg_request_trigger(request_class);
 
-        request->request_class->progress_func(
-            hg_time_to_ms(remaining), request->request_class->arg);
+        completed = hg_request_completed(count, request);
+        if (completed >= 0)
+            goto done;
 
-        hg_thread_mutex_lock(&request->request_class->progress_mutex);
-        request->request_class->progressing = HG_UTIL_FALSE;
-        hg_thread_cond_broadcast(&request->request_class->progress_cond);
-        hg_thread_mutex_unlock(&request->request_class->progress_mutex);
+        if (!hg_request_progress(request_class, 0))
+            cpu_spinwait();
+    } while (timeout_ms > 0 && hg_time_get_ticks() < spin_end);
 
-next:
-        hg_time_get_current(&now);
+    /* Then block in progress until deadline */
+    hg_time_get_current(&now);
+    while (hg_time_less(now, deadline)) {
         remaining = hg_time_subtract(deadline, now);
-    } while (hg_time_less(now, deadline));
 
-    if (flag)
-        *flag = (unsigned int) completed;
+        hg_request_trigger(request_class);
 
-    return ret;
+        completed = hg_request_completed(count, request);
+        if (completed >= 0)
+            goto done;
+
+        if (!hg_request_progress(request_class, hg_time_to_ms(remaining))) {
+            int rc = HG_UTIL_SUCCESS;
+
+            /* Wait for the thread making progress, requests may have
+             * completed in the meantime */
+            hg_thread_mutex_lock(&request_class->progress_mutex);
+            hg_atomic_incr32(&request_class->waiters);
+            if (hg_atomic_get32(&request_class->progressing))
+                rc = hg_thread_cond_timedwait(&request_class->progress_cond,
+                    &request_class->progress_mutex, hg_time_to_ms(remaining));
+            hg_atomic_decr32(&request_class->waiters);
+            hg_thread_mutex_unlock(&request_class->progress_mutex);
+
+            /* Timeout occurred so leave */
+            if (rc != HG_UTIL_SUCCESS)
+                break;
+        }
+
+        hg_time_get_current(&now);
+    }
+
+    /* Last check, progress may have completed requests */
+    hg_request_trigger(request_class);
+    completed = hg_request_completed(count, request);
+
+done:
+    if (index)
+        *index = completed;
+
+    return HG_UTIL_SUCCESS;
 }
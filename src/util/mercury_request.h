@@ -124,7 +124,10 @@ static HG_UTIL_INLINE void
 hg_request_complete(hg_request_t *request);
 
 /**
- * Wait timeout ms for the specified request to complete.
+ * Wait timeout ms for the specified request to complete. Progress is first
+ * made without blocking for a short time so that short round trips complete
+ * without sleeping, blocking progress is then made by only one thread at a
+ * time while other threads wait for it.
  *
  * \param request [IN/OUT]      pointer to request
  * \param timeout [IN]          timeout (in milliseconds)
@@ -136,6 +139,24 @@ HG_UTIL_PUBLIC int
 hg_request_wait(
     hg_request_t *request, unsigned int timeout, unsigned int *flag);
 
+/**
+ * Wait timeout ms for any of the specified requests to complete. All requests
+ * must belong to the same request class. Like hg_request_wait(), progress is
+ * first made without blocking for a short time before blocking progress is
+ * made.
+ *
+ * \param count [IN]            number of requests
+ * \param request [IN/OUT]      arrays of requests
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param index [OUT]           index of first completed request, -1 if none
+ *                              has completed
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_request_waitany(
+    int count, hg_request_t *request[], unsigned int timeout, int *index);
+
 /**
  * Wait timeout ms for all the specified request to complete.
  *
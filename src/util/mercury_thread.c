@@ -10,6 +10,10 @@
 
 #include "mercury_thread.h"
 
+#if !defined(_WIN32) && !defined(__APPLE__)
+#    include <stdio.h>
+#endif
+
 /*---------------------------------------------------------------------------*/
 void
 hg_thread_init(hg_thread_t *thread)
@@ -160,3 +164,44 @@ hg_thread_setaffinity(hg_thread_t thread, const hg_cpu_set_t *cpu_mask)
     return HG_UTIL_SUCCESS;
 #endif
 }
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_get_numa_cpus(int node, hg_cpu_set_t *cpu_mask)
+{
+#if defined(_WIN32) || defined(__APPLE__)
+    (void) node;
+    (void) cpu_mask;
+    return HG_UTIL_FAIL;
+#else
+    char path[64];
+    int first, last, cpu_count = 0;
+    FILE *file;
+
+    /* CPU list is a comma separated list of ranges, e.g. 0-7,16-23 */
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+        node);
+    file = fopen(path, "r");
+    if (file == NULL)
+        return HG_UTIL_FAIL;
+
+    CPU_ZERO(cpu_mask);
+    while (fscanf(file, "%d", &first) == 1) {
+        int c = fgetc(file);
+
+        last = first;
+        if (c == '-') {
+            if (fscanf(file, "%d", &last) != 1)
+                break;
+            c = fgetc(file);
+        }
+        for (; first <= last && first < CPU_SETSIZE; first++, cpu_count++)
+            CPU_SET(first, cpu_mask);
+        if (c != ',')
+            break;
+    }
+    fclose(file);
+
+    return (cpu_count > 0) ? HG_UTIL_SUCCESS : HG_UTIL_FAIL;
+#endif
+}
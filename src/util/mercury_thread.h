@@ -187,6 +187,18 @@ hg_thread_getaffinity(hg_thread_t thread, hg_cpu_set_t *cpu_mask);
 HG_UTIL_PUBLIC int
 hg_thread_setaffinity(hg_thread_t thread, const hg_cpu_set_t *cpu_mask);
 
+/**
+ * Get mask of the CPUs that belong to NUMA node \node, which can be passed
+ * to hg_thread_setaffinity().
+ *
+ * \param node [IN]             NUMA node
+ * \param cpu_mask [OUT]        cpu mask
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_get_numa_cpus(int node, hg_cpu_set_t *cpu_mask);
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE hg_thread_t
 hg_thread_self(void)
@@ -16,6 +16,9 @@ hg_thread_cond_init(hg_thread_cond_t *cond)
 {
 #ifdef _WIN32
     InitializeConditionVariable(cond);
+#elif defined(HG_UTIL_HAS_FUTEX)
+    hg_atomic_init32(&cond->seq, 0);
+    hg_atomic_init32(&cond->waiters, 0);
 #else
     pthread_condattr_t attr;
 
@@ -38,10 +41,33 @@ hg_thread_cond_init(hg_thread_cond_t *cond)
 int
 hg_thread_cond_destroy(hg_thread_cond_t *cond)
 {
-#ifndef _WIN32
+#if defined(HG_UTIL_HAS_FUTEX)
+    if (hg_atomic_get32(&cond->waiters) != 0)
+        return HG_UTIL_FAIL;
+#elif !defined(_WIN32)
     if (pthread_cond_destroy(cond))
         return HG_UTIL_FAIL;
 #endif
 
     return HG_UTIL_SUCCESS;
 }
+
+#ifdef HG_UTIL_HAS_FUTEX
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_cond_futex_wait(
+    hg_thread_cond_t *cond, hg_thread_mutex_t *mutex, unsigned int timeout)
+{
+    hg_util_int32_t seq = hg_atomic_get32(&cond->seq);
+    int ret;
+
+    /* Any wake-up issued after the mutex is released changes seq */
+    hg_atomic_incr32(&cond->waiters);
+    hg_thread_mutex_unlock(mutex);
+    ret = hg_thread_futex_wait(&cond->seq, seq, timeout);
+    hg_atomic_decr32(&cond->waiters);
+    hg_thread_mutex_lock(mutex);
+
+    return ret;
+}
+#endif
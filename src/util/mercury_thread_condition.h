@@ -15,6 +15,12 @@
 
 #ifdef _WIN32
 typedef CONDITION_VARIABLE hg_thread_cond_t;
+#elif defined(HG_UTIL_HAS_FUTEX)
+/* Waiters sleep on the sequence number, which is bumped on every wake-up */
+typedef struct {
+    hg_atomic_int32_t seq;     /* Sequence number */
+    hg_atomic_int32_t waiters; /* Number of waiters */
+} hg_thread_cond_t;
 #else
 #    if defined(HG_UTIL_HAS_PTHREAD_CONDATTR_SETCLOCK) &&                      \
         defined(HG_UTIL_HAS_CLOCK_MONOTONIC_COARSE)
@@ -94,12 +100,33 @@ static HG_UTIL_INLINE int
 hg_thread_cond_timedwait(
     hg_thread_cond_t *cond, hg_thread_mutex_t *mutex, unsigned int timeout);
 
+#ifdef HG_UTIL_HAS_FUTEX
+/**
+ * Wait timeout ms for the condition to change (futex implementation).
+ *
+ * \param cond [IN/OUT]         pointer to condition object
+ * \param mutex [IN/OUT]        pointer to mutex object
+ * \param timeout [IN]          timeout (in milliseconds) or
+ *                              HG_THREAD_FUTEX_INFINITE
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_cond_futex_wait(
+    hg_thread_cond_t *cond, hg_thread_mutex_t *mutex, unsigned int timeout);
+#endif
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE int
 hg_thread_cond_signal(hg_thread_cond_t *cond)
 {
 #ifdef _WIN32
     WakeConditionVariable(cond);
+#elif defined(HG_UTIL_HAS_FUTEX)
+    /* Waiters are registered with the mutex held, no syscall if none */
+    hg_atomic_incr32(&cond->seq);
+    if (hg_atomic_get32(&cond->waiters) > 0)
+        return hg_thread_futex_wake(&cond->seq, 1);
 #else
     if (pthread_cond_signal(cond))
         return HG_UTIL_FAIL;
@@ -114,6 +141,10 @@ hg_thread_cond_broadcast(hg_thread_cond_t *cond)
 {
 #ifdef _WIN32
     WakeAllConditionVariable(cond);
+#elif defined(HG_UTIL_HAS_FUTEX)
+    hg_atomic_incr32(&cond->seq);
+    if (hg_atomic_get32(&cond->waiters) > 0)
+        return hg_thread_futex_wake(&cond->seq, INT_MAX);
 #else
     if (pthread_cond_broadcast(cond))
         return HG_UTIL_FAIL;
@@ -129,6 +160,8 @@ hg_thread_cond_wait(hg_thread_cond_t *cond, hg_thread_mutex_t *mutex)
 #ifdef _WIN32
     if (!SleepConditionVariableCS(cond, mutex, INFINITE))
         return HG_UTIL_FAIL;
+#elif defined(HG_UTIL_HAS_FUTEX)
+    return hg_thread_cond_futex_wait(cond, mutex, HG_THREAD_FUTEX_INFINITE);
 #else
     if (pthread_cond_wait(cond, mutex))
         return HG_UTIL_FAIL;
@@ -145,6 +178,8 @@ hg_thread_cond_timedwait(
 #ifdef _WIN32
     if (!SleepConditionVariableCS(cond, mutex, timeout))
         return HG_UTIL_FAIL;
+#elif defined(HG_UTIL_HAS_FUTEX)
+    return hg_thread_cond_futex_wait(cond, mutex, timeout);
 #else
 #    if defined(HG_UTIL_HAS_PTHREAD_CONDATTR_SETCLOCK) &&                      \
         defined(HG_UTIL_HAS_CLOCK_MONOTONIC_COARSE)
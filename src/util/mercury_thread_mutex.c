@@ -10,12 +10,30 @@
 
 #include "mercury_thread_mutex.h"
 
+#ifdef HG_UTIL_HAS_FUTEX
+#    include <errno.h>
+#    include <linux/futex.h>
+#    include <stdint.h>
+#    include <sys/syscall.h>
+#    include <time.h>
+#    include <unistd.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Number of spins before sleeping on a contended mutex */
+#define HG_THREAD_MUTEX_SPIN_COUNT (100)
+
 /*---------------------------------------------------------------------------*/
 int
 hg_thread_mutex_init(hg_thread_mutex_t *mutex)
 {
 #ifdef _WIN32
     InitializeCriticalSection(mutex);
+#elif defined(HG_UTIL_HAS_FUTEX)
+    hg_atomic_init32(&mutex->state, 0);
 #else
     pthread_mutexattr_t mutex_attr;
 
@@ -41,6 +59,9 @@ hg_thread_mutex_destroy(hg_thread_mutex_t *mutex)
 {
 #ifdef _WIN32
     DeleteCriticalSection(mutex);
+#elif defined(HG_UTIL_HAS_FUTEX)
+    if (hg_atomic_get32(&mutex->state) != 0)
+        return HG_UTIL_FAIL;
 #else
     if (pthread_mutex_destroy(mutex))
         return HG_UTIL_FAIL;
@@ -48,3 +69,80 @@ hg_thread_mutex_destroy(hg_thread_mutex_t *mutex)
 
     return HG_UTIL_SUCCESS;
 }
+
+#ifdef HG_UTIL_HAS_FUTEX
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_mutex_lock_contended(hg_thread_mutex_t *mutex)
+{
+    int i;
+
+    /* Critical sections are short, the owner is likely to release the lock
+     * before a sleep would even be scheduled */
+    for (i = 0; i < HG_THREAD_MUTEX_SPIN_COUNT; i++) {
+        cpu_spinwait();
+        if (hg_atomic_get32(&mutex->state) == 0 &&
+            hg_atomic_cas32(&mutex->state, 0, 1))
+            return HG_UTIL_SUCCESS;
+    }
+
+    /* Mark the mutex as contended so that unlock wakes us up, the lock is
+     * then taken as contended since other threads may be sleeping */
+    for (;;) {
+        hg_util_int32_t state = hg_atomic_get32(&mutex->state);
+
+        if (state == 0) {
+            if (hg_atomic_cas32(&mutex->state, 0, 2))
+                return HG_UTIL_SUCCESS;
+            continue;
+        }
+        if (state == 1 && !hg_atomic_cas32(&mutex->state, 1, 2))
+            continue;
+        if (hg_thread_futex_wait(&mutex->state, 2, HG_THREAD_FUTEX_INFINITE) !=
+            HG_UTIL_SUCCESS)
+            return HG_UTIL_FAIL;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_mutex_unlock_contended(hg_thread_mutex_t *mutex)
+{
+    hg_atomic_set32(&mutex->state, 0);
+
+    return hg_thread_futex_wake(&mutex->state, 1);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_futex_wait(
+    hg_atomic_int32_t *addr, hg_util_int32_t value, unsigned int timeout)
+{
+    struct timespec ts, *ts_p = NULL;
+
+    if (timeout != HG_THREAD_FUTEX_INFINITE) {
+        ts.tv_sec = (time_t) (timeout / 1000);
+        ts.tv_nsec = (long) (timeout % 1000) * 1000000L;
+        ts_p = &ts;
+    }
+
+    /* Value already changed or interrupted are not errors */
+    if (syscall(SYS_futex, (int *) (uintptr_t) addr, FUTEX_WAIT_PRIVATE, value,
+            ts_p, NULL, 0) == -1 &&
+        errno != EAGAIN && errno != EINTR)
+        return HG_UTIL_FAIL;
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_futex_wake(hg_atomic_int32_t *addr, int count)
+{
+    if (syscall(SYS_futex, (int *) (uintptr_t) addr, FUTEX_WAKE_PRIVATE, count,
+            NULL, NULL, 0) == -1)
+        return HG_UTIL_FAIL;
+
+    return HG_UTIL_SUCCESS;
+}
+#endif
@@ -17,6 +17,20 @@
 #    include <windows.h>
 #    define HG_THREAD_MUTEX_INITIALIZER NULL
 typedef CRITICAL_SECTION hg_thread_mutex_t;
+#elif defined(HG_UTIL_HAS_FUTEX)
+#    include "mercury_atomic.h"
+#    include <limits.h>
+#    define HG_THREAD_MUTEX_INITIALIZER                                        \
+        {                                                                      \
+            HG_ATOMIC_VAR_INIT(0)                                              \
+        }
+/* Adaptive mutex, spins for a short while before sleeping on a futex
+ * (0: unlocked, 1: locked, 2: locked and contended) */
+typedef struct {
+    hg_atomic_int32_t state;
+} hg_thread_mutex_t;
+/* Wait forever on futex */
+#    define HG_THREAD_FUTEX_INFINITE UINT_MAX
 #else
 #    include <pthread.h>
 #    define HG_THREAD_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
@@ -77,12 +91,64 @@ hg_thread_mutex_try_lock(hg_thread_mutex_t *mutex);
 static HG_UTIL_INLINE int
 hg_thread_mutex_unlock(hg_thread_mutex_t *mutex);
 
+#ifdef HG_UTIL_HAS_FUTEX
+/**
+ * Lock a mutex that is already locked (slow path of hg_thread_mutex_lock()),
+ * spin first and then sleep until the mutex is released.
+ *
+ * \param mutex [IN/OUT]        pointer to mutex object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_mutex_lock_contended(hg_thread_mutex_t *mutex);
+
+/**
+ * Unlock a mutex that has waiters (slow path of hg_thread_mutex_unlock()).
+ *
+ * \param mutex [IN/OUT]        pointer to mutex object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_mutex_unlock_contended(hg_thread_mutex_t *mutex);
+
+/**
+ * Sleep as long as \addr contains \value, for at most \timeout ms. Spurious
+ * wake-ups may occur.
+ *
+ * \param addr [IN/OUT]         pointer to atomic integer
+ * \param value [IN]            expected value
+ * \param timeout [IN]          timeout (in milliseconds) or
+ *                              HG_THREAD_FUTEX_INFINITE
+ *
+ * \return Non-negative on success or negative on timeout / failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_futex_wait(
+    hg_atomic_int32_t *addr, hg_util_int32_t value, unsigned int timeout);
+
+/**
+ * Wake at most \count threads sleeping on \addr.
+ *
+ * \param addr [IN/OUT]         pointer to atomic integer
+ * \param count [IN]            number of threads to wake
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_futex_wake(hg_atomic_int32_t *addr, int count);
+#endif
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE int
 hg_thread_mutex_lock(hg_thread_mutex_t *mutex)
 {
 #ifdef _WIN32
     EnterCriticalSection(mutex);
+#elif defined(HG_UTIL_HAS_FUTEX)
+    if (!hg_atomic_cas32(&mutex->state, 0, 1))
+        return hg_thread_mutex_lock_contended(mutex);
 #else
     if (pthread_mutex_lock(mutex))
         return HG_UTIL_FAIL;
@@ -98,6 +164,9 @@ hg_thread_mutex_try_lock(hg_thread_mutex_t *mutex)
 #ifdef _WIN32
     if (!TryEnterCriticalSection(mutex))
         return HG_UTIL_FAIL;
+#elif defined(HG_UTIL_HAS_FUTEX)
+    if (!hg_atomic_cas32(&mutex->state, 0, 1))
+        return HG_UTIL_FAIL;
 #else
     if (pthread_mutex_trylock(mutex))
         return HG_UTIL_FAIL;
@@ -112,6 +181,10 @@ hg_thread_mutex_unlock(hg_thread_mutex_t *mutex)
 {
 #ifdef _WIN32
     LeaveCriticalSection(mutex);
+#elif defined(HG_UTIL_HAS_FUTEX)
+    /* Only wake up a waiter if the mutex was contended */
+    if (!hg_atomic_cas32(&mutex->state, 1, 0))
+        return hg_thread_mutex_unlock_contended(mutex);
 #else
     if (pthread_mutex_unlock(mutex))
         return HG_UTIL_FAIL;
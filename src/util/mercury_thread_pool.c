@@ -10,28 +10,101 @@
 
 #include "mercury_thread_pool.h"
 
+#include "mercury_atomic.h"
+#include "mercury_atomic_seg_queue.h"
+#include "mercury_mem.h"
+#include "mercury_thread_condition.h"
+#include "mercury_thread_mutex.h"
 #include "mercury_util_error.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 /****************/
 /* Local Macros */
 /****************/
 
+/* Number of entries of worker deques (must be a power of 2), work posted by a
+ * worker whose deque is full goes to the submission queue */
+#define HG_THREAD_POOL_DEQUE_SIZE (256)
+#define HG_THREAD_POOL_DEQUE_MASK (HG_THREAD_POOL_DEQUE_SIZE - 1)
+
+/* Number of entries per segment of the submission queue */
+#define HG_THREAD_POOL_QUEUE_SIZE (1024)
+
+/* Number of times an idle worker looks for work before going to sleep */
+#define HG_THREAD_POOL_SPIN_COUNT (64)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
 
-struct hg_thread_pool_private {
-    struct hg_thread_pool pool;
-    unsigned int thread_count;
-    hg_thread_t *threads;
+/* Chase-Lev deque, the owner pushes and pops at the bottom while other
+ * workers steal from the top */
+struct hg_thread_pool_deque {
+    hg_atomic_int64_t top
+        __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE))); /* Steal end */
+    hg_atomic_int64_t bottom
+        __attribute__((aligned(HG_MEM_CACHE_LINE_SIZE))); /* Owner end */
+    hg_atomic_int64_t entries[HG_THREAD_POOL_DEQUE_SIZE]; /* Work pointers */
+};
+
+struct hg_thread_pool_worker {
+    struct hg_thread_pool_deque deque; /* Work posted by this worker */
+    struct hg_thread_pool *pool;       /* Pool of worker */
+    hg_thread_t thread;                /* Worker thread */
+    unsigned int id;                   /* Index of worker in pool */
+};
+
+struct hg_thread_pool {
+    struct hg_thread_pool_worker *workers;   /* Array of workers */
+    struct hg_atomic_seg_queue *queue;       /* Submission queue */
+    hg_thread_key_t worker_key;              /* Worker of calling thread */
+    hg_thread_mutex_t mutex;                 /* Sleeping mutex */
+    hg_thread_cond_t cond;                   /* Sleeping cond */
+    hg_atomic_int32_t sleeping_worker_count; /* Workers waiting on cond */
+    hg_atomic_int32_t shutdown;              /* Pool is being destroyed */
+    unsigned int thread_count;               /* Number of workers */
+    unsigned int started_count;              /* Number of started workers */
+    hg_util_bool_t key_created;              /* Worker key was created */
 };
 
 /********************/
 /* Local Prototypes */
 /********************/
 
+/**
+ * Push work to the bottom of the deque (owner only).
+ */
+static HG_UTIL_INLINE int
+hg_thread_pool_deque_push(
+    struct hg_thread_pool_deque *deque, struct hg_thread_work *work);
+
+/**
+ * Pop work from the bottom of the deque (owner only).
+ */
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_deque_pop(struct hg_thread_pool_deque *deque);
+
+/**
+ * Steal work from the top of the deque.
+ */
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_deque_steal(struct hg_thread_pool_deque *deque);
+
+/**
+ * Check whether the pool has no work left.
+ */
+static hg_util_bool_t
+hg_thread_pool_is_empty(struct hg_thread_pool *pool);
+
+/**
+ * Get work for worker, busy polls for a while if there is none.
+ */
+static struct hg_thread_work *
+hg_thread_pool_get_work(
+    struct hg_thread_pool *pool, struct hg_thread_pool_worker *worker);
+
 /**
  * Worker thread run by the thread pool
  */
@@ -42,45 +115,182 @@ hg_thread_pool_worker(void *args);
 /* Local Variables */
 /*******************/
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE int
+hg_thread_pool_deque_push(
+    struct hg_thread_pool_deque *deque, struct hg_thread_work *work)
+{
+    hg_util_int64_t bottom = hg_atomic_get64(&deque->bottom),
+                    top = hg_atomic_get64(&deque->top);
+
+    if (bottom - top >= HG_THREAD_POOL_DEQUE_SIZE)
+        return HG_UTIL_FAIL;
+
+    hg_atomic_set64(&deque->entries[bottom & HG_THREAD_POOL_DEQUE_MASK],
+        (hg_util_int64_t) work);
+
+    /* Only the owner modifies bottom, use an atomic increment so that the new
+     * entry is visible before the sleeping worker count gets checked */
+    hg_atomic_incr64(&deque->bottom);
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_deque_pop(struct hg_thread_pool_deque *deque)
+{
+    struct hg_thread_work *work;
+    hg_util_int64_t bottom, top;
+
+    /* Reserve bottom entry before reading top, thieves that read the old
+     * bottom race for the last entry through top */
+    bottom = hg_atomic_decr64(&deque->bottom);
+    top = hg_atomic_get64(&deque->top);
+
+    if (top > bottom) {
+        /* Empty */
+        hg_atomic_set64(&deque->bottom, bottom + 1);
+        return NULL;
+    }
+
+    work = (struct hg_thread_work *) hg_atomic_get64(
+        &deque->entries[bottom & HG_THREAD_POOL_DEQUE_MASK]);
+    if (top == bottom) {
+        /* Last entry, make sure that it was not stolen */
+        if (!hg_atomic_cas64(&deque->top, top, top + 1))
+            work = NULL;
+        hg_atomic_set64(&deque->bottom, bottom + 1);
+    }
+
+    return work;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_deque_steal(struct hg_thread_pool_deque *deque)
+{
+    struct hg_thread_work *work;
+    hg_util_int64_t top = hg_atomic_get64(&deque->top),
+                    bottom = hg_atomic_get64(&deque->bottom);
+
+    if (top >= bottom)
+        return NULL;
+
+    /* Entry may be overwritten once top moves, in which case the CAS fails */
+    work = (struct hg_thread_work *) hg_atomic_get64(
+        &deque->entries[top & HG_THREAD_POOL_DEQUE_MASK]);
+    if (!hg_atomic_cas64(&deque->top, top, top + 1))
+        return NULL;
+
+    return work;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_util_bool_t
+hg_thread_pool_is_empty(struct hg_thread_pool *pool)
+{
+    unsigned int i;
+
+    if (!hg_atomic_seg_queue_is_empty(pool->queue))
+        return HG_UTIL_FALSE;
+
+    for (i = 0; i < pool->thread_count; i++) {
+        struct hg_thread_pool_deque *deque = &pool->workers[i].deque;
+
+        if (hg_atomic_get64(&deque->bottom) > hg_atomic_get64(&deque->top))
+            return HG_UTIL_FALSE;
+    }
+
+    return HG_UTIL_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_thread_work *
+hg_thread_pool_get_work(
+    struct hg_thread_pool *pool, struct hg_thread_pool_worker *worker)
+{
+    unsigned int spin;
+
+    for (spin = 0; spin < HG_THREAD_POOL_SPIN_COUNT; spin++) {
+        struct hg_thread_work *work;
+        unsigned int i;
+
+        /* Own work first, then submitted work */
+        work = hg_thread_pool_deque_pop(&worker->deque);
+        if (work)
+            return work;
+
+        work = (struct hg_thread_work *) hg_atomic_seg_queue_pop_mc(
+            pool->queue);
+        if (work)
+            return work;
+
+        /* Steal from other workers, starting with the next one */
+        for (i = 1; i < pool->thread_count; i++) {
+            work = hg_thread_pool_deque_steal(
+                &pool->workers[(worker->id + i) % pool->thread_count].deque);
+            if (work)
+                return work;
+        }
+    }
+
+    return NULL;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_THREAD_RETURN_TYPE
 hg_thread_pool_worker(void *args)
 {
     hg_thread_ret_t ret = 0;
-    hg_thread_pool_t *pool = (hg_thread_pool_t *) args;
-    struct hg_thread_work *work;
+    struct hg_thread_pool_worker *worker =
+        (struct hg_thread_pool_worker *) args;
+    struct hg_thread_pool *pool = worker->pool;
+    int rc;
+
+    /* Work posted from this thread goes to its own deque */
+    rc = hg_thread_setspecific(pool->worker_key, worker);
+    HG_UTIL_CHECK_WARNING(
+        rc != HG_UTIL_SUCCESS, "Could not set worker thread key");
 
     while (1) {
-        hg_thread_mutex_lock(&pool->mutex);
+        struct hg_thread_work *work;
+        hg_util_bool_t done;
+
+        work = hg_thread_pool_get_work(pool, worker);
+        if (work) {
+            /* Get to work */
+            (*work->func)(work->args);
+            continue;
+        }
 
-        /* If not shutting down and nothing to do, worker sleeps */
-        while (!pool->shutdown && HG_QUEUE_IS_EMPTY(&pool->queue)) {
-            int rc;
+        hg_thread_mutex_lock(&pool->mutex);
 
-            pool->sleeping_worker_count++;
+        /* Register as sleeping before checking for work again so that
+         * posters either see the work or wake us up */
+        hg_atomic_incr32(&pool->sleeping_worker_count);
 
+        /* If not shutting down and nothing to do, worker sleeps */
+        while (!hg_atomic_get32(&pool->shutdown) &&
+               hg_thread_pool_is_empty(pool)) {
             rc = hg_thread_cond_wait(&pool->cond, &pool->mutex);
             HG_UTIL_CHECK_ERROR_NORET(rc != HG_UTIL_SUCCESS, unlock,
                 "Thread cannot wait on condition variable");
-
-            pool->sleeping_worker_count--;
         }
 
-        if (pool->shutdown && HG_QUEUE_IS_EMPTY(&pool->queue))
-            goto unlock;
-
-        /* Grab our task */
-        work = HG_QUEUE_FIRST(&pool->queue);
-        HG_QUEUE_POP_HEAD(&pool->queue, entry);
+        hg_atomic_decr32(&pool->sleeping_worker_count);
+        done = hg_atomic_get32(&pool->shutdown) && hg_thread_pool_is_empty(pool);
 
-        /* Unlock */
         hg_thread_mutex_unlock(&pool->mutex);
 
-        /* Get to work */
-        (*work->func)(work->args);
+        if (done)
+            break;
     }
 
+    return ret;
+
 unlock:
+    hg_atomic_decr32(&pool->sleeping_worker_count);
     hg_thread_mutex_unlock(&pool->mutex);
 
     return ret;
@@ -89,53 +299,86 @@ unlock:
 /*---------------------------------------------------------------------------*/
 int
 hg_thread_pool_init(unsigned int thread_count, hg_thread_pool_t **pool_ptr)
+{
+    return hg_thread_pool_init_opt(thread_count, NULL, pool_ptr);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_pool_init_opt(unsigned int thread_count,
+    const hg_cpu_set_t *cpu_masks, hg_thread_pool_t **pool_ptr)
 {
     int ret = HG_UTIL_SUCCESS, rc;
-    struct hg_thread_pool_private *priv_pool = NULL;
+    struct hg_thread_pool *pool = NULL;
     unsigned int i;
 
     HG_UTIL_CHECK_ERROR(
         pool_ptr == NULL, error, ret, HG_UTIL_FAIL, "NULL pointer");
 
-    priv_pool = (struct hg_thread_pool_private *) malloc(
-        sizeof(struct hg_thread_pool_private));
-    HG_UTIL_CHECK_ERROR(priv_pool == NULL, error, ret, HG_UTIL_FAIL,
+    pool = (struct hg_thread_pool *) malloc(sizeof(struct hg_thread_pool));
+    HG_UTIL_CHECK_ERROR(pool == NULL, error, ret, HG_UTIL_FAIL,
         "Could not allocate thread pool");
+    memset(pool, 0, sizeof(struct hg_thread_pool));
 
-    priv_pool->pool.sleeping_worker_count = 0;
-    priv_pool->thread_count = thread_count;
-    priv_pool->threads = NULL;
-    HG_QUEUE_INIT(&priv_pool->pool.queue);
-    priv_pool->pool.shutdown = 0;
+    pool->thread_count = thread_count;
+    hg_atomic_init32(&pool->sleeping_worker_count, 0);
+    hg_atomic_init32(&pool->shutdown, 0);
 
-    rc = hg_thread_mutex_init(&priv_pool->pool.mutex);
+    rc = hg_thread_mutex_init(&pool->mutex);
     HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_UTIL_FAIL,
         "Could not initialize mutex");
 
-    rc = hg_thread_cond_init(&priv_pool->pool.cond);
+    rc = hg_thread_cond_init(&pool->cond);
     HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_UTIL_FAIL,
         "Could not initialize thread condition");
 
-    priv_pool->threads =
-        (hg_thread_t *) malloc(thread_count * sizeof(hg_thread_t));
-    HG_UTIL_CHECK_ERROR(!priv_pool->threads, error, ret, HG_UTIL_FAIL,
-        "Could not allocate thread pool array");
+    rc = hg_thread_key_create(&pool->worker_key);
+    HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_UTIL_FAIL,
+        "Could not create worker thread key");
+    pool->key_created = HG_UTIL_TRUE;
+
+    pool->queue = hg_atomic_seg_queue_alloc(HG_THREAD_POOL_QUEUE_SIZE);
+    HG_UTIL_CHECK_ERROR(pool->queue == NULL, error, ret, HG_UTIL_FAIL,
+        "Could not allocate submission queue");
+
+    /* Deques are cache-line aligned */
+    pool->workers = (struct hg_thread_pool_worker *) hg_mem_aligned_alloc(
+        HG_MEM_CACHE_LINE_SIZE,
+        thread_count * sizeof(struct hg_thread_pool_worker));
+    HG_UTIL_CHECK_ERROR(pool->workers == NULL, error, ret, HG_UTIL_FAIL,
+        "Could not allocate thread pool workers");
+    memset(pool->workers, 0,
+        thread_count * sizeof(struct hg_thread_pool_worker));
+
+    for (i = 0; i < thread_count; i++) {
+        hg_atomic_init64(&pool->workers[i].deque.top, 0);
+        hg_atomic_init64(&pool->workers[i].deque.bottom, 0);
+        pool->workers[i].pool = pool;
+        pool->workers[i].id = i;
+    }
 
     /* Start worker threads */
     for (i = 0; i < thread_count; i++) {
-        rc = hg_thread_create(
-            &priv_pool->threads[i], hg_thread_pool_worker, (void *) priv_pool);
+        rc = hg_thread_create(&pool->workers[i].thread, hg_thread_pool_worker,
+            (void *) &pool->workers[i]);
         HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_UTIL_FAIL,
             "Could not create thread");
+        pool->started_count++;
+
+        if (cpu_masks) {
+            rc = hg_thread_setaffinity(pool->workers[i].thread, &cpu_masks[i]);
+            HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret,
+                HG_UTIL_FAIL, "Could not set affinity of thread %u", i);
+        }
     }
 
-    *pool_ptr = (struct hg_thread_pool *) priv_pool;
+    *pool_ptr = pool;
 
     return ret;
 
 error:
-    if (priv_pool)
-        hg_thread_pool_destroy((struct hg_thread_pool *) priv_pool);
+    if (pool)
+        hg_thread_pool_destroy(pool);
 
     return ret;
 }
@@ -144,48 +387,91 @@ error:
 int
 hg_thread_pool_destroy(hg_thread_pool_t *pool)
 {
-    struct hg_thread_pool_private *priv_pool =
-        (struct hg_thread_pool_private *) pool;
     int ret = HG_UTIL_SUCCESS, rc;
     unsigned int i;
 
-    if (!priv_pool)
+    if (!pool)
         goto done;
 
-    if (priv_pool->threads) {
-        hg_thread_mutex_lock(&priv_pool->pool.mutex);
+    if (pool->started_count) {
+        hg_thread_mutex_lock(&pool->mutex);
 
-        priv_pool->pool.shutdown = 1;
+        hg_atomic_set32(&pool->shutdown, 1);
 
-        rc = hg_thread_cond_broadcast(&priv_pool->pool.cond);
+        rc = hg_thread_cond_broadcast(&pool->cond);
         HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_UTIL_FAIL,
             "Could not broadcast condition signal");
 
-        hg_thread_mutex_unlock(&priv_pool->pool.mutex);
+        hg_thread_mutex_unlock(&pool->mutex);
 
-        for (i = 0; i < priv_pool->thread_count; i++) {
-            rc = hg_thread_join(priv_pool->threads[i]);
+        for (i = 0; i < pool->started_count; i++) {
+            rc = hg_thread_join(pool->workers[i].thread);
             HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_UTIL_FAIL,
                 "Could not join thread");
         }
     }
 
-    rc = hg_thread_mutex_destroy(&priv_pool->pool.mutex);
+    rc = hg_thread_mutex_destroy(&pool->mutex);
     HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_UTIL_FAIL,
         "Could not destroy mutex");
 
-    rc = hg_thread_cond_destroy(&priv_pool->pool.cond);
+    rc = hg_thread_cond_destroy(&pool->cond);
     HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_UTIL_FAIL,
         "Could not destroy thread condition");
 
-    free(priv_pool->threads);
-    free(priv_pool);
+    if (pool->key_created)
+        hg_thread_key_delete(pool->worker_key);
+    if (pool->queue)
+        hg_atomic_seg_queue_free(pool->queue);
+    hg_mem_aligned_free(pool->workers);
+    free(pool);
 
 done:
     return ret;
 
 error:
-    hg_thread_mutex_unlock(&priv_pool->pool.mutex);
+    hg_thread_mutex_unlock(&pool->mutex);
 
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_pool_post(hg_thread_pool_t *pool, struct hg_thread_work *work)
+{
+    struct hg_thread_pool_worker *worker;
+    int ret = HG_UTIL_SUCCESS;
+
+    if (!pool || !work)
+        return HG_UTIL_FAIL;
+
+    if (!work->func)
+        return HG_UTIL_FAIL;
+
+    /* Workers keep the work they post (others may steal it), other threads
+     * go through the submission queue */
+    worker = (struct hg_thread_pool_worker *) hg_thread_getspecific(
+        pool->worker_key);
+
+    /* Are we shutting down ? Workers may still post while draining */
+    if (!worker && hg_atomic_get32(&pool->shutdown))
+        return HG_UTIL_FAIL;
+
+    if (!worker ||
+        hg_thread_pool_deque_push(&worker->deque, work) != HG_UTIL_SUCCESS) {
+        ret = hg_atomic_seg_queue_push(pool->queue, work);
+        HG_UTIL_CHECK_ERROR(ret != HG_UTIL_SUCCESS, done, ret, HG_UTIL_FAIL,
+            "Could not push work to submission queue");
+    }
+
+    /* Wake up sleeping worker */
+    if (hg_atomic_get32(&pool->sleeping_worker_count)) {
+        hg_thread_mutex_lock(&pool->mutex);
+        if (hg_thread_cond_signal(&pool->cond) != HG_UTIL_SUCCESS)
+            ret = HG_UTIL_FAIL;
+        hg_thread_mutex_unlock(&pool->mutex);
+    }
+
+done:
+    return ret;
+}
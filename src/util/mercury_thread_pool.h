@@ -11,9 +11,12 @@
 #ifndef MERCURY_THREAD_POOL_H
 #define MERCURY_THREAD_POOL_H
 
-#include "mercury_queue.h"
 #include "mercury_thread.h"
-#include "mercury_thread_condition.h"
+
+/* Work-stealing thread pool. Work posted from outside the pool goes through a
+ * lock-free submission queue, work posted by a worker goes to that worker's
+ * own deque. Idle workers first drain their deque, then the submission queue,
+ * then steal from other workers before going to sleep. */
 
 /*************************************/
 /* Public Type and Struct Definition */
@@ -21,18 +24,9 @@
 
 typedef struct hg_thread_pool hg_thread_pool_t;
 
-struct hg_thread_pool {
-    unsigned int sleeping_worker_count;
-    HG_QUEUE_HEAD(hg_thread_work) queue;
-    int shutdown;
-    hg_thread_mutex_t mutex;
-    hg_thread_cond_t cond;
-};
-
 struct hg_thread_work {
     hg_thread_func_t func;
     void *args;
-    HG_QUEUE_ENTRY(hg_thread_work) entry; /* Internal */
 };
 
 /*****************/
@@ -60,7 +54,23 @@ HG_UTIL_PUBLIC int
 hg_thread_pool_init(unsigned int thread_count, hg_thread_pool_t **pool);
 
 /**
- * Destroy the thread pool.
+ * Initialize the thread pool and pin its threads.
+ *
+ * \param thread_count [IN]     number of threads that will be created at
+ *                              initialization
+ * \param cpu_masks [IN]        array of thread_count cpu masks, thread i is
+ *                              pinned to cpu_masks[i] (may be NULL)
+ * \param pool [OUT]            pointer to pool object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_pool_init_opt(unsigned int thread_count,
+    const hg_cpu_set_t *cpu_masks, hg_thread_pool_t **pool);
+
+/**
+ * Destroy the thread pool. Work that was already posted is executed before
+ * the threads exit.
  *
  * \param pool [IN/OUT]         pointer to pool object
  *
@@ -71,50 +81,17 @@ hg_thread_pool_destroy(hg_thread_pool_t *pool);
 
 /**
  * Post work to the pool. Note that the operation may be queued depending on
- * the number of threads and number of tasks already running.
+ * the number of threads and number of tasks already running. The work struct
+ * must remain valid until its function is executed.
  *
  * \param pool [IN/OUT]         pointer to pool object
  * \param work [IN]             pointer to work struct
  *
  * \return Non-negative on success or negative on failure
  */
-static HG_UTIL_INLINE int
+HG_UTIL_PUBLIC int
 hg_thread_pool_post(hg_thread_pool_t *pool, struct hg_thread_work *work);
 
-/*---------------------------------------------------------------------------*/
-static HG_UTIL_INLINE int
-hg_thread_pool_post(hg_thread_pool_t *pool, struct hg_thread_work *work)
-{
-    int ret = HG_UTIL_SUCCESS;
-
-    if (!pool || !work)
-        return HG_UTIL_FAIL;
-
-    if (!work->func)
-        return HG_UTIL_FAIL;
-
-    hg_thread_mutex_lock(&pool->mutex);
-
-    /* Are we shutting down ? */
-    if (pool->shutdown) {
-        ret = HG_UTIL_FAIL;
-        goto unlock;
-    }
-
-    /* Add task to task queue */
-    HG_QUEUE_PUSH_TAIL(&pool->queue, work, entry);
-
-    /* Wake up sleeping worker */
-    if (pool->sleeping_worker_count &&
-        (hg_thread_cond_signal(&pool->cond) != HG_UTIL_SUCCESS))
-        ret = HG_UTIL_FAIL;
-
-unlock:
-    hg_thread_mutex_unlock(&pool->mutex);
-
-    return ret;
-}
-
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_time.h"
+#include "mercury_util_error.h"
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Calibration period of the TSC (ns) */
+#define HG_TIME_TICKS_CALIBRATE_NS (2000000)
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+#ifdef HG_TIME_TICKS_TSC
+/**
+ * Read the TSC and the monotonic clock together (ticks are averaged over
+ * the read of the monotonic clock).
+ */
+static void
+hg_time_ticks_sample(hg_time_ticks_t *ticks, hg_util_uint64_t *ns);
+#endif
+
+/**
+ * Calibrate the fast clock when the library is loaded.
+ */
+static void
+hg_time_ticks_init(void) HG_UTIL_CONSTRUCTOR;
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Ticks are in ns until calibrated */
+hg_util_uint64_t hg_time_ticks_to_ns_g = 1ULL << HG_TIME_TICKS_SHIFT;
+hg_util_uint64_t hg_time_ns_to_ticks_g = 1ULL << HG_TIME_TICKS_SHIFT;
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_TIME_TICKS_TSC
+static void
+hg_time_ticks_sample(hg_time_ticks_t *ticks, hg_util_uint64_t *ns)
+{
+    hg_time_ticks_t t1, t2;
+    hg_time_t tv;
+
+    t1 = hg_time_get_ticks();
+    hg_time_get_current(&tv);
+    t2 = hg_time_get_ticks();
+
+    *ticks = t1 + (t2 - t1) / 2;
+#    if defined(HG_UTIL_HAS_TIME_H) && defined(HG_UTIL_HAS_CLOCK_GETTIME)
+    *ns = (hg_util_uint64_t) tv.tv_sec * 1000000000ULL +
+          (hg_util_uint64_t) tv.tv_nsec;
+#    else
+    *ns = (hg_util_uint64_t) tv.tv_sec * 1000000000ULL +
+          (hg_util_uint64_t) tv.tv_usec * 1000ULL;
+#    endif
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_time_ticks_init(void)
+{
+    (void) hg_time_ticks_calibrate();
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_time_ticks_calibrate(void)
+{
+#if defined(HG_TIME_TICKS_TSC)
+    hg_time_ticks_t ticks1, ticks2;
+    hg_util_uint64_t ns1, ns2;
+    hg_time_t period = {0};
+    int ret = HG_UTIL_SUCCESS;
+
+#    if defined(HG_UTIL_HAS_TIME_H) && defined(HG_UTIL_HAS_CLOCK_GETTIME)
+    period.tv_nsec = HG_TIME_TICKS_CALIBRATE_NS;
+#    else
+    period.tv_usec = HG_TIME_TICKS_CALIBRATE_NS / 1000;
+#    endif
+
+    hg_time_ticks_sample(&ticks1, &ns1);
+    hg_time_sleep(period);
+    hg_time_ticks_sample(&ticks2, &ns2);
+    HG_UTIL_CHECK_ERROR(ticks2 <= ticks1 || ns2 <= ns1, done, ret,
+        HG_UTIL_FAIL, "Could not calibrate TSC, counter is not monotonic");
+
+    hg_time_ticks_to_ns_g = ((ns2 - ns1) << HG_TIME_TICKS_SHIFT) /
+                            (ticks2 - ticks1);
+    hg_time_ns_to_ticks_g = ((ticks2 - ticks1) << HG_TIME_TICKS_SHIFT) /
+                            (ns2 - ns1);
+
+done:
+    return ret;
+#elif defined(HG_TIME_TICKS_CNTVCT)
+    hg_util_uint64_t freq;
+    int ret = HG_UTIL_SUCCESS;
+
+    /* Counter frequency is exposed by the system */
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(freq));
+    HG_UTIL_CHECK_ERROR(freq == 0, done, ret, HG_UTIL_FAIL,
+        "Could not calibrate virtual counter, frequency is not set");
+
+    hg_time_ticks_to_ns_g = (1000000000ULL << HG_TIME_TICKS_SHIFT) / freq;
+    hg_time_ns_to_ticks_g = (freq << HG_TIME_TICKS_SHIFT) / 1000000000ULL;
+
+done:
+    return ret;
+#else
+    /* Ticks are already in ns */
+    return HG_UTIL_SUCCESS;
+#endif
+}
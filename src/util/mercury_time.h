@@ -30,6 +30,13 @@
 #    endif
 #endif
 
+/* Fast clock source */
+#if defined(HG_UTIL_HAS_TSC) && (defined(__x86_64__) || defined(__i386__))
+#    define HG_TIME_TICKS_TSC
+#elif defined(HG_UTIL_HAS_TSC) && defined(__aarch64__)
+#    define HG_TIME_TICKS_CNTVCT
+#endif
+
 /*************************************/
 /* Public Type and Struct Definition */
 /*************************************/
@@ -45,10 +52,16 @@ struct hg_time {
 };
 #endif
 
+/* Ticks of the fast clock (see hg_time_get_ticks()) */
+typedef hg_util_uint64_t hg_time_ticks_t;
+
 /*****************/
 /* Public Macros */
 /*****************/
 
+/* Fixed-point shift of tick/ns conversion factors */
+#define HG_TIME_TICKS_SHIFT (32)
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -57,6 +70,10 @@ struct hg_time {
 extern "C" {
 #endif
 
+/* Conversion factors of the fast clock, set by hg_time_ticks_calibrate() */
+extern HG_UTIL_PUBLIC hg_util_uint64_t hg_time_ticks_to_ns_g;
+extern HG_UTIL_PUBLIC hg_util_uint64_t hg_time_ns_to_ticks_g;
+
 /**
  * Get an elapsed time on the calling processor.
  *
@@ -180,6 +197,48 @@ hg_time_sleep(const hg_time_t rqt);
 static HG_UTIL_INLINE char *
 hg_time_stamp(void);
 
+/**
+ * Get the current value of the fast clock. Ticks are read from the
+ * invariant TSC on x86 and from the virtual counter on AArch64 (when
+ * MERCURY_ENABLE_TSC is set), from the monotonic clock in nanoseconds
+ * otherwise. Ticks are only meaningful relative to each other, durations
+ * are converted through hg_time_ticks_to_ns(), which does not divide.
+ *
+ * \return Current ticks
+ */
+static HG_UTIL_INLINE hg_time_ticks_t
+hg_time_get_ticks(void);
+
+/**
+ * Convert a number of ticks to nanoseconds.
+ *
+ * \param ticks [IN]            number of ticks
+ *
+ * \return Nanoseconds
+ */
+static HG_UTIL_INLINE hg_util_uint64_t
+hg_time_ticks_to_ns(hg_time_ticks_t ticks);
+
+/**
+ * Convert a number of nanoseconds to ticks (e.g., to compute deadlines).
+ *
+ * \param ns [IN]               nanoseconds
+ *
+ * \return Number of ticks
+ */
+static HG_UTIL_INLINE hg_time_ticks_t
+hg_time_ticks_from_ns(hg_util_uint64_t ns);
+
+/**
+ * Calibrate the fast clock against the monotonic clock. Calibration is done
+ * automatically when the library is loaded, it may be repeated to refine
+ * factors (e.g., once the CPU frequency has settled).
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_time_ticks_calibrate(void);
+
 /*---------------------------------------------------------------------------*/
 #ifdef _WIN32
 static HG_UTIL_INLINE LARGE_INTEGER
@@ -506,6 +565,65 @@ hg_time_stamp(void)
     return buf;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_time_ticks_t
+hg_time_get_ticks(void)
+{
+#if defined(HG_TIME_TICKS_TSC)
+    hg_util_uint32_t lo, hi;
+
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+
+    return ((hg_time_ticks_t) hi << 32) | lo;
+#elif defined(HG_TIME_TICKS_CNTVCT)
+    hg_time_ticks_t ticks;
+
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+
+    return ticks;
+#else
+    hg_time_t tv;
+
+    hg_time_get_current(&tv);
+#    if defined(HG_UTIL_HAS_TIME_H) && defined(HG_UTIL_HAS_CLOCK_GETTIME)
+    return (hg_time_ticks_t) tv.tv_sec * 1000000000ULL +
+           (hg_time_ticks_t) tv.tv_nsec;
+#    else
+    return (hg_time_ticks_t) tv.tv_sec * 1000000000ULL +
+           (hg_time_ticks_t) tv.tv_usec * 1000ULL;
+#    endif
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_uint64_t
+hg_time_ticks_to_ns(hg_time_ticks_t ticks)
+{
+#ifdef __SIZEOF_INT128__
+    return (hg_util_uint64_t) (((unsigned __int128) ticks *
+                                   hg_time_ticks_to_ns_g) >>
+                               HG_TIME_TICKS_SHIFT);
+#else
+    return (hg_util_uint64_t) ((double) ticks *
+                               (double) hg_time_ticks_to_ns_g /
+                               (double) (1ULL << HG_TIME_TICKS_SHIFT));
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_time_ticks_t
+hg_time_ticks_from_ns(hg_util_uint64_t ns)
+{
+#ifdef __SIZEOF_INT128__
+    return (hg_time_ticks_t) (((unsigned __int128) ns *
+                                  hg_time_ns_to_ticks_g) >>
+                              HG_TIME_TICKS_SHIFT);
+#else
+    return (hg_time_ticks_t) ((double) ns * (double) hg_time_ns_to_ticks_g /
+                              (double) (1ULL << HG_TIME_TICKS_SHIFT));
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
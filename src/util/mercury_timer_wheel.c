@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_timer_wheel.h"
+#include "mercury_util_error.h"
+
+#include <stdlib.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+#define HG_TIMER_WHEEL_MASK (HG_TIMER_WHEEL_SLOTS - 1)
+
+/* Index of slot at level \level for tick \tick */
+#define HG_TIMER_WHEEL_INDEX(tick, level)                                      \
+    ((unsigned int) ((tick) >> (HG_TIMER_WHEEL_BITS * (level))) &              \
+        HG_TIMER_WHEEL_MASK)
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Insert armed timer into the slot that matches its expiration tick.
+ */
+static void
+hg_timer_wheel_insert(struct hg_timer_wheel *wheel, struct hg_timer *timer);
+
+/**
+ * Move timers of slot \index at level \level down to lower levels. Return
+ * \index so that the caller knows whether the next level must be cascaded.
+ */
+static unsigned int
+hg_timer_wheel_cascade(
+    struct hg_timer_wheel *wheel, unsigned int level, unsigned int index);
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_timer_wheel_insert(struct hg_timer_wheel *wheel, struct hg_timer *timer)
+{
+    hg_util_uint64_t delta = timer->expire - wheel->now;
+    unsigned int level;
+
+    for (level = 0; level < HG_TIMER_WHEEL_LEVELS - 1; level++)
+        if (delta <
+            ((hg_util_uint64_t) 1 << (HG_TIMER_WHEEL_BITS * (level + 1))))
+            break;
+
+    HG_LIST_INSERT_HEAD(
+        &wheel->slots[level][HG_TIMER_WHEEL_INDEX(timer->expire, level)], timer,
+        entry);
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_timer_wheel_cascade(
+    struct hg_timer_wheel *wheel, unsigned int level, unsigned int index)
+{
+    struct hg_timer *timer;
+
+    while ((timer = HG_LIST_FIRST(&wheel->slots[level][index])) != NULL) {
+        HG_LIST_REMOVE(timer, entry);
+        hg_timer_wheel_insert(wheel, timer);
+    }
+
+    return index;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_timer_wheel *
+hg_timer_wheel_create(hg_util_uint64_t now)
+{
+    struct hg_timer_wheel *wheel = NULL;
+    unsigned int i, j;
+
+    wheel = (struct hg_timer_wheel *) malloc(sizeof(struct hg_timer_wheel));
+    HG_UTIL_CHECK_ERROR_NORET(wheel == NULL, done, "Could not allocate wheel");
+
+    for (i = 0; i < HG_TIMER_WHEEL_LEVELS; i++)
+        for (j = 0; j < HG_TIMER_WHEEL_SLOTS; j++)
+            HG_LIST_INIT(&wheel->slots[i][j]);
+    wheel->now = now;
+    wheel->count = 0;
+
+done:
+    return wheel;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_timer_wheel_destroy(struct hg_timer_wheel *wheel)
+{
+    free(wheel);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_timer_wheel_add(struct hg_timer_wheel *wheel, struct hg_timer *timer,
+    hg_util_uint64_t timeout)
+{
+    if (timeout == 0)
+        timeout = 1;
+    else if (timeout > HG_TIMER_WHEEL_MAX)
+        timeout = HG_TIMER_WHEEL_MAX;
+
+    timer->expire = wheel->now + timeout;
+    timer->armed = 1;
+    wheel->count++;
+    hg_timer_wheel_insert(wheel, timer);
+}
+
+/*---------------------------------------------------------------------------*/
+unsigned int
+hg_timer_wheel_advance(struct hg_timer_wheel *wheel, hg_util_uint64_t now)
+{
+    unsigned int expired = 0;
+
+    /* Nothing to expire, skip ticks */
+    if (wheel->count == 0) {
+        if (now > wheel->now)
+            wheel->now = now;
+        return 0;
+    }
+
+    while (wheel->now < now) {
+        struct hg_timer *timer;
+        unsigned int index, level;
+
+        index = HG_TIMER_WHEEL_INDEX(++wheel->now, 0);
+
+        /* Cascade higher levels when level below wraps around */
+        for (level = 1; index == 0 && level < HG_TIMER_WHEEL_LEVELS; level++)
+            index = hg_timer_wheel_cascade(
+                wheel, level, HG_TIMER_WHEEL_INDEX(wheel->now, level));
+
+        /* Expire timers, one at a time as callbacks may modify the wheel */
+        index = HG_TIMER_WHEEL_INDEX(wheel->now, 0);
+        while ((timer = HG_LIST_FIRST(&wheel->slots[0][index])) != NULL) {
+            HG_LIST_REMOVE(timer, entry);
+            timer->armed = 0;
+            wheel->count--;
+            expired++;
+            timer->callback(timer, timer->arg);
+        }
+
+        if (wheel->count == 0) {
+            wheel->now = now;
+            break;
+        }
+    }
+
+    return expired;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_util_uint64_t
+hg_timer_wheel_next(const struct hg_timer_wheel *wheel)
+{
+    unsigned int index, i;
+
+    if (wheel->count == 0)
+        return HG_TIMER_WHEEL_MAX;
+
+    /* Look for next non-empty slot before level 0 wraps around */
+    index = HG_TIMER_WHEEL_INDEX(wheel->now, 0);
+    for (i = 1; index + i < HG_TIMER_WHEEL_SLOTS; i++)
+        if (!HG_LIST_IS_EMPTY(&wheel->slots[0][index + i]))
+            return i;
+
+    return HG_TIMER_WHEEL_SLOTS - index;
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_TIMER_WHEEL_H
+#define MERCURY_TIMER_WHEEL_H
+
+#include "mercury_list.h"
+#include "mercury_util_config.h"
+
+/* Hierarchical timer wheel with a resolution of 1 ms. Each level is made of
+ * HG_TIMER_WHEEL_SLOTS slots, a slot of level N covering
+ * HG_TIMER_WHEEL_SLOTS^N ticks. Timers are kept in intrusive lists so that
+ * adding and removing a timer is O(1), timers of higher levels are cascaded
+ * down one level each time the level below wraps around.
+ * The wheel itself is not thread-safe, callers must serialize accesses. */
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+struct hg_timer;
+
+typedef void (*hg_timer_cb_t)(struct hg_timer *timer, void *arg);
+
+struct hg_timer {
+    HG_LIST_ENTRY(hg_timer) entry; /* Entry in wheel slot */
+    hg_util_uint64_t expire;       /* Expiration tick */
+    hg_timer_cb_t callback;        /* Callback */
+    void *arg;                     /* Callback arg */
+    hg_util_bool_t armed;          /* Timer is in a wheel */
+};
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+#define HG_TIMER_WHEEL_BITS   6
+#define HG_TIMER_WHEEL_SLOTS  (1 << HG_TIMER_WHEEL_BITS)
+#define HG_TIMER_WHEEL_LEVELS 4
+
+/* Max timeout that can be represented (~4.6 hours), larger timeouts are
+ * clamped to that value */
+#define HG_TIMER_WHEEL_RANGE                                                   \
+    ((hg_util_uint64_t) 1 << (HG_TIMER_WHEEL_BITS * HG_TIMER_WHEEL_LEVELS))
+#define HG_TIMER_WHEEL_MAX (HG_TIMER_WHEEL_RANGE - 1)
+
+struct hg_timer_wheel {
+    HG_LIST_HEAD(hg_timer)
+    slots[HG_TIMER_WHEEL_LEVELS][HG_TIMER_WHEEL_SLOTS]; /* Timer lists */
+    hg_util_uint64_t now;                               /* Current tick */
+    unsigned int count;                                 /* Armed timers */
+};
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocate a new timer wheel whose current time is \now.
+ *
+ * \param now [IN]              current time (in ms)
+ *
+ * \return pointer to allocated wheel or NULL on failure
+ */
+HG_UTIL_PUBLIC struct hg_timer_wheel *
+hg_timer_wheel_create(hg_util_uint64_t now);
+
+/**
+ * Free an existing timer wheel. Timers that are still armed are not fired.
+ *
+ * \param wheel [IN]            pointer to wheel
+ */
+HG_UTIL_PUBLIC void
+hg_timer_wheel_destroy(struct hg_timer_wheel *wheel);
+
+/**
+ * Initialize a timer with callback \callback and argument \arg.
+ *
+ * \param timer [OUT]           pointer to timer
+ * \param callback [IN]         callback executed on expiration
+ * \param arg [IN]              callback argument
+ */
+static HG_UTIL_INLINE void
+hg_timer_init(struct hg_timer *timer, hg_timer_cb_t callback, void *arg);
+
+/**
+ * Arm timer so that it expires \timeout ms after the current time of the
+ * wheel. A timeout of 0 makes the timer expire on the next tick.
+ *
+ * \param wheel [IN/OUT]        pointer to wheel
+ * \param timer [IN/OUT]        pointer to (unarmed) timer
+ * \param timeout [IN]          timeout (in ms)
+ */
+HG_UTIL_PUBLIC void
+hg_timer_wheel_add(struct hg_timer_wheel *wheel, struct hg_timer *timer,
+    hg_util_uint64_t timeout);
+
+/**
+ * Disarm timer if it is armed.
+ *
+ * \param wheel [IN/OUT]        pointer to wheel
+ * \param timer [IN/OUT]        pointer to timer
+ */
+static HG_UTIL_INLINE void
+hg_timer_wheel_del(struct hg_timer_wheel *wheel, struct hg_timer *timer);
+
+/**
+ * Advance wheel up to time \now and execute the callbacks of the timers that
+ * expired. Callbacks may add and remove timers.
+ *
+ * \param wheel [IN/OUT]        pointer to wheel
+ * \param now [IN]              current time (in ms)
+ *
+ * \return number of expired timers
+ */
+HG_UTIL_PUBLIC unsigned int
+hg_timer_wheel_advance(struct hg_timer_wheel *wheel, hg_util_uint64_t now);
+
+/**
+ * Return an upper bound of the time left (in ms) before the next call to
+ * hg_timer_wheel_advance() may have to expire or cascade timers, or
+ * HG_TIMER_WHEEL_MAX if no timer is armed.
+ *
+ * \param wheel [IN]            pointer to wheel
+ *
+ * \return time left (in ms)
+ */
+HG_UTIL_PUBLIC hg_util_uint64_t
+hg_timer_wheel_next(const struct hg_timer_wheel *wheel);
+
+/**
+ * Return the number of armed timers.
+ *
+ * \param wheel [IN]            pointer to wheel
+ *
+ * \return number of timers
+ */
+static HG_UTIL_INLINE unsigned int
+hg_timer_wheel_count(const struct hg_timer_wheel *wheel);
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_timer_init(struct hg_timer *timer, hg_timer_cb_t callback, void *arg)
+{
+    timer->entry.next = NULL;
+    timer->entry.prev = NULL;
+    timer->expire = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->armed = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_timer_wheel_del(struct hg_timer_wheel *wheel, struct hg_timer *timer)
+{
+    if (!timer->armed)
+        return;
+
+    HG_LIST_REMOVE(timer, entry);
+    timer->armed = 0;
+    wheel->count--;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_timer_wheel_count(const struct hg_timer_wheel *wheel)
+{
+    return wheel->count;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_TIMER_WHEEL_H */
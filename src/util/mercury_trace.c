@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_trace.h"
+
+#include "mercury_list.h"
+#include "mercury_mem.h"
+#include "mercury_thread.h"
+#include "mercury_thread_mutex.h"
+#include "mercury_time.h"
+#include "mercury_util_error.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <sys/types.h>
+#    include <unistd.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Number of pages of events mapped at once (window size is a multiple of the
+ * page size since it is page_size * HG_TRACE_WINDOW_PAGES events) */
+#define HG_TRACE_WINDOW_PAGES (16)
+
+/* Max length of trace file names */
+#define HG_TRACE_NAME_MAX (1024)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Trace file of a thread */
+struct hg_trace_buf {
+    HG_LIST_ENTRY(hg_trace_buf) entry; /* Trace list entry */
+    struct hg_trace_event *events;     /* Mapped window (NULL if unmapped) */
+    hg_util_uint64_t window_start;     /* Index of first event of window */
+    unsigned int next;                 /* Next free event in window */
+    int fd;                            /* Trace file */
+};
+
+struct hg_trace {
+    HG_LIST_HEAD(hg_trace_buf) bufs; /* Trace files */
+    hg_thread_mutex_t mutex;         /* Trace file list mutex */
+    hg_thread_key_t key;             /* Trace file of thread */
+    char *prefix;                    /* Trace file prefix */
+    hg_util_int64_t time_offset;     /* Wall-clock time - event time */
+    size_t page_size;                /* Page size (offset of events) */
+    unsigned int window_count;       /* Number of events per window */
+    unsigned int thread_count;       /* Number of trace files */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Current time in ns.
+ */
+static hg_util_uint64_t
+hg_trace_now(void);
+
+/**
+ * Create trace file of calling thread.
+ */
+static struct hg_trace_buf *
+hg_trace_buf_create(struct hg_trace *trace);
+
+/**
+ * Close trace file.
+ */
+static void
+hg_trace_buf_destroy(struct hg_trace *trace, struct hg_trace_buf *buf);
+
+/**
+ * Map window of events starting at event index window_start.
+ */
+static int
+hg_trace_buf_map(struct hg_trace *trace, struct hg_trace_buf *buf,
+    hg_util_uint64_t window_start);
+
+/*---------------------------------------------------------------------------*/
+static hg_util_uint64_t
+hg_trace_now(void)
+{
+    /* Events are mapped to wall-clock time through time_offset */
+    return hg_time_ticks_to_ns(hg_time_get_ticks());
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_trace *
+hg_trace_create(const char *prefix)
+{
+    struct hg_trace *trace = NULL;
+#if defined(HG_UTIL_HAS_TIME_H) && defined(HG_UTIL_HAS_CLOCK_GETTIME)
+    struct timespec wall;
+#endif
+    hg_util_int64_t wall_time;
+    int rc;
+
+#ifdef _WIN32
+    (void) prefix;
+    HG_UTIL_LOG_ERROR("Traces are not supported on this platform");
+    goto error;
+#endif
+
+    trace = (struct hg_trace *) malloc(sizeof(*trace));
+    HG_UTIL_CHECK_ERROR_NORET(trace == NULL, error, "Could not allocate trace");
+    memset(trace, 0, sizeof(*trace));
+    HG_LIST_INIT(&trace->bufs);
+
+    trace->prefix = strdup(prefix);
+    HG_UTIL_CHECK_ERROR_NORET(
+        trace->prefix == NULL, error_free, "Could not duplicate prefix");
+
+    rc = hg_thread_key_create(&trace->key);
+    HG_UTIL_CHECK_ERROR_NORET(
+        rc != HG_UTIL_SUCCESS, error_free, "Could not create thread key");
+
+    rc = hg_thread_mutex_init(&trace->mutex);
+    HG_UTIL_CHECK_ERROR_NORET(
+        rc != HG_UTIL_SUCCESS, error_key, "Could not initialize mutex");
+
+    trace->page_size = (size_t) hg_mem_get_page_size();
+    trace->window_count = (unsigned int) trace->page_size *
+                          HG_TRACE_WINDOW_PAGES;
+
+#if defined(HG_UTIL_HAS_TIME_H) && defined(HG_UTIL_HAS_CLOCK_GETTIME)
+    clock_gettime(CLOCK_REALTIME, &wall);
+    wall_time = (hg_util_int64_t) wall.tv_sec * 1000000000LL +
+                (hg_util_int64_t) wall.tv_nsec;
+#else
+    wall_time = (hg_util_int64_t) time(NULL) * 1000000000LL;
+#endif
+    trace->time_offset = wall_time - (hg_util_int64_t) hg_trace_now();
+
+    return trace;
+
+error_key:
+    hg_thread_key_delete(trace->key);
+error_free:
+    free(trace->prefix);
+    free(trace);
+error:
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_trace_destroy(struct hg_trace *trace)
+{
+    if (!trace)
+        return;
+
+    while (!HG_LIST_IS_EMPTY(&trace->bufs)) {
+        struct hg_trace_buf *buf = HG_LIST_FIRST(&trace->bufs);
+
+        HG_LIST_REMOVE(buf, entry);
+        hg_trace_buf_destroy(trace, buf);
+    }
+
+    hg_thread_mutex_destroy(&trace->mutex);
+    hg_thread_key_delete(trace->key);
+    free(trace->prefix);
+    free(trace);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_trace_record(struct hg_trace *trace, unsigned int type,
+    hg_util_uint64_t id, hg_util_uint64_t arg, hg_util_uint8_t context_id,
+    hg_util_uint32_t tag, hg_util_uint32_t size)
+{
+    struct hg_trace_buf *buf =
+        (struct hg_trace_buf *) hg_thread_getspecific(trace->key);
+    struct hg_trace_event *event;
+
+    if (unlikely(buf == NULL)) {
+        buf = hg_trace_buf_create(trace);
+        if (buf == NULL)
+            return;
+    }
+
+    /* Move to next window (or retry a window that could not be mapped) */
+    if (unlikely(buf->next == trace->window_count)) {
+        hg_util_uint64_t window_start = buf->window_start;
+
+        if (buf->events)
+            window_start += trace->window_count;
+        if (hg_trace_buf_map(trace, buf, window_start) != HG_UTIL_SUCCESS)
+            return;
+    }
+
+    event = &buf->events[buf->next++];
+    event->time = hg_trace_now();
+    event->id = id;
+    event->arg = arg;
+    event->size = size;
+    event->tag = tag;
+    event->type = (hg_util_uint16_t) type;
+    event->context_id = context_id;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_trace_buf *
+hg_trace_buf_create(struct hg_trace *trace)
+{
+#ifdef _WIN32
+    (void) trace;
+    return NULL;
+#else
+    struct hg_trace_buf *buf = NULL;
+    struct hg_trace_header header;
+    char name[HG_TRACE_NAME_MAX];
+    ssize_t written;
+    int rc;
+
+    buf = (struct hg_trace_buf *) malloc(sizeof(*buf));
+    HG_UTIL_CHECK_ERROR_NORET(buf == NULL, error, "Could not allocate buffer");
+    buf->events = NULL;
+    buf->window_start = 0;
+    buf->next = trace->window_count;
+
+    hg_thread_mutex_lock(&trace->mutex);
+
+    snprintf(name, sizeof(name), "%s-%d-%u.hgt", trace->prefix, (int) getpid(),
+        trace->thread_count);
+    buf->fd = open(name, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    HG_UTIL_CHECK_ERROR_NORET(
+        buf->fd < 0, error_unlock, "open() failed for %s", name);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HG_TRACE_MAGIC, sizeof(HG_TRACE_MAGIC));
+    header.version = HG_TRACE_VERSION;
+    header.event_size = (hg_util_uint32_t) sizeof(struct hg_trace_event);
+    header.data_offset = (hg_util_uint32_t) trace->page_size;
+    header.thread = trace->thread_count;
+    header.pid = (hg_util_uint64_t) getpid();
+    header.time_offset = trace->time_offset;
+    written = pwrite(buf->fd, &header, sizeof(header), 0);
+    HG_UTIL_CHECK_ERROR_NORET(written != (ssize_t) sizeof(header), error_close,
+        "Could not write header to %s", name);
+
+    rc = hg_thread_setspecific(trace->key, buf);
+    HG_UTIL_CHECK_ERROR_NORET(
+        rc != HG_UTIL_SUCCESS, error_close, "Could not set thread buffer");
+
+    HG_LIST_INSERT_HEAD(&trace->bufs, buf, entry);
+    trace->thread_count++;
+
+    hg_thread_mutex_unlock(&trace->mutex);
+
+    return buf;
+
+error_close:
+    close(buf->fd);
+    unlink(name);
+error_unlock:
+    hg_thread_mutex_unlock(&trace->mutex);
+    free(buf);
+error:
+    return NULL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_trace_buf_destroy(struct hg_trace *trace, struct hg_trace_buf *buf)
+{
+#ifdef _WIN32
+    (void) trace;
+    (void) buf;
+#else
+    hg_util_uint64_t count = buf->window_start;
+    ssize_t written;
+    int rc;
+
+    if (buf->events) {
+        count += buf->next;
+        munmap(buf->events, trace->window_count * sizeof(*buf->events));
+    }
+
+    /* Drop unused part of last window and set number of events */
+    rc = ftruncate(buf->fd,
+        (off_t)(trace->page_size + count * sizeof(struct hg_trace_event)));
+    HG_UTIL_CHECK_ERROR_DONE(rc != 0, "Could not truncate trace file");
+
+    written = pwrite(buf->fd, &count, sizeof(count),
+        offsetof(struct hg_trace_header, count));
+    HG_UTIL_CHECK_ERROR_DONE(written != (ssize_t) sizeof(count),
+        "Could not write number of events");
+
+    close(buf->fd);
+    free(buf);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_trace_buf_map(struct hg_trace *trace, struct hg_trace_buf *buf,
+    hg_util_uint64_t window_start)
+{
+#ifdef _WIN32
+    (void) trace;
+    (void) buf;
+    (void) window_start;
+    return HG_UTIL_FAIL;
+#else
+    size_t window_size = trace->window_count * sizeof(struct hg_trace_event);
+    off_t offset = (off_t)(
+        trace->page_size + window_start * sizeof(struct hg_trace_event));
+    int flags = MAP_SHARED;
+    void *events;
+    int rc, ret = HG_UTIL_SUCCESS;
+
+    if (buf->events) {
+        munmap(buf->events, window_size);
+        buf->events = NULL;
+    }
+    buf->window_start = window_start;
+    buf->next = trace->window_count;
+
+    rc = ftruncate(buf->fd, offset + (off_t) window_size);
+    HG_UTIL_CHECK_ERROR(
+        rc != 0, done, ret, HG_UTIL_FAIL, "Could not extend trace file");
+
+#    ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#    endif
+    events = mmap(NULL, window_size, PROT_READ | PROT_WRITE, flags, buf->fd,
+        offset);
+    HG_UTIL_CHECK_ERROR(events == MAP_FAILED, done, ret, HG_UTIL_FAIL,
+        "Could not map trace file");
+
+    buf->events = (struct hg_trace_event *) events;
+    buf->next = 0;
+
+done:
+    return ret;
+#endif
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2013-2020 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_TRACE_H
+#define MERCURY_TRACE_H
+
+#include "mercury_util_config.h"
+
+/* Binary traces of fixed-size events. Each thread that records events gets
+ * its own trace file "<prefix>-<pid>-<thread>.hgt", which is mapped in
+ * memory by windows of events so that recording an event does not take any
+ * lock nor make any system call other than when moving to the next window.
+ * Event times are monotonic times in nanoseconds, the file header gives the
+ * offset to wall-clock time so that traces of several nodes can be merged.
+ * Events are written in host byte order. */
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+#define HG_TRACE_MAGIC   "HGTRACE"
+#define HG_TRACE_VERSION (1)
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/* Trace file header, events start at data_offset */
+struct hg_trace_header {
+    char magic[8];                /* HG_TRACE_MAGIC */
+    hg_util_uint32_t version;     /* HG_TRACE_VERSION */
+    hg_util_uint32_t event_size;  /* Size of an event */
+    hg_util_uint32_t data_offset; /* Offset of first event */
+    hg_util_uint32_t thread;      /* Thread index */
+    hg_util_uint64_t pid;         /* Process ID */
+    hg_util_uint64_t count;       /* Number of events (0 if not closed) */
+    hg_util_int64_t time_offset;  /* Wall-clock time - event time (ns) */
+};
+
+/* Trace event */
+struct hg_trace_event {
+    hg_util_uint64_t time;      /* Time (ns) */
+    hg_util_uint64_t id;        /* Object ID (e.g., handle) */
+    hg_util_uint64_t arg;       /* Event argument (e.g., RPC ID) */
+    hg_util_uint32_t size;      /* Byte count */
+    hg_util_uint32_t tag;       /* Tag used to match remote events */
+    hg_util_uint16_t type;      /* Event type (defined by caller) */
+    hg_util_uint8_t context_id; /* Context ID */
+    hg_util_uint8_t reserved[5];
+};
+
+struct hg_trace;
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a new trace, trace files are created when threads record their
+ * first event.
+ *
+ * \param prefix [IN]           prefix of trace files (may include path)
+ *
+ * \return pointer to trace or NULL in case of failure
+ */
+HG_UTIL_PUBLIC struct hg_trace *
+hg_trace_create(const char *prefix);
+
+/**
+ * Destroy the trace, unmap and close trace files. No events must be recorded
+ * concurrently.
+ *
+ * \param trace [IN/OUT]        pointer to trace
+ */
+HG_UTIL_PUBLIC void
+hg_trace_destroy(struct hg_trace *trace);
+
+/**
+ * Record an event to the trace file of the calling thread. Events that
+ * cannot be recorded (e.g., file system is full) are dropped.
+ *
+ * \param trace [IN/OUT]        pointer to trace
+ * \param type [IN]             event type
+ * \param id [IN]               object ID
+ * \param arg [IN]              event argument
+ * \param context_id [IN]       context ID
+ * \param tag [IN]              tag
+ * \param size [IN]             byte count
+ */
+HG_UTIL_PUBLIC void
+hg_trace_record(struct hg_trace *trace, unsigned int type,
+    hg_util_uint64_t id, hg_util_uint64_t arg, hg_util_uint8_t context_id,
+    hg_util_uint32_t tag, hg_util_uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_TRACE_H */